@@ -0,0 +1,417 @@
+// Runs the benchmarks in this directory under controlled conditions, and compares them with a
+// stored baseline so that a release can be checked before it is rolled out:
+//
+//   bun run.mjs [options] [suite...]
+//
+//   --runtime <name>    which bench:<name> script of each suite to run: bun, node or deno (default: bun)
+//   --runs <n>          measured runs of every suite (default: 10)
+//   --warmup <n>        runs of every suite before those, which are not measured (default: 2)
+//   --cpu <list>        pin every run to these CPUs, as given to taskset -c (Linux only)
+//   --no-setup          do not run the deps and build scripts of the suites first
+//   --save <name>       store the results as baselines/<name>.json
+//   --compare <name>    compare with baselines/<name>.json, exiting with 1 on a significant regression
+//   --alpha <p>         p-value below which a difference is significant (default: 0.05)
+//   --threshold <pct>   smallest change in percent that is reported as one (default: 2)
+//   --json              print the results as JSON instead of a table
+//
+// A suite is a directory with a bench:<runtime> script in its package.json, and "startup" is
+// the runtime running an empty script. Every run records its wall time and peak RSS, and any
+// line it prints that is a JSON object with a "benchmark" name adds its *_per_second fields as
+// throughput. Runs of the suites are interleaved, so that drift in the machine spreads over all
+// of them instead of landing on one.
+//
+// Differences are tested with a Mann-Whitney U test, which does not assume the times to be
+// normally distributed; they rarely are. Baselines keep every sample so that they can be
+// tested against, and record the machine they were taken on, as they only compare on that one.
+
+import { spawn } from "node:child_process";
+import { existsSync, mkdirSync, readFileSync, readdirSync, writeFileSync } from "node:fs";
+import { cpus, platform, arch, release } from "node:os";
+import { join } from "node:path";
+
+const benchDir = import.meta.dirname ?? new URL(".", import.meta.url).pathname;
+const baselinesDir = join(benchDir, "baselines");
+
+function parseOptions(argv) {
+  const options = {
+    runtime: "bun",
+    runs: 10,
+    warmup: 2,
+    cpu: null,
+    setup: true,
+    save: null,
+    compare: null,
+    alpha: 0.05,
+    threshold: 2,
+    json: false,
+    suites: [],
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`Missing value for ${arg}`);
+      return argv[++i];
+    };
+
+    switch (arg) {
+      case "--runtime":
+        options.runtime = value();
+        break;
+      case "--runs":
+        options.runs = parseInt(value(), 10);
+        break;
+      case "--warmup":
+        options.warmup = parseInt(value(), 10);
+        break;
+      case "--cpu":
+        options.cpu = value();
+        break;
+      case "--no-setup":
+        options.setup = false;
+        break;
+      case "--save":
+        options.save = value();
+        break;
+      case "--compare":
+        options.compare = value();
+        break;
+      case "--alpha":
+        options.alpha = parseFloat(value());
+        break;
+      case "--threshold":
+        options.threshold = parseFloat(value());
+        break;
+      case "--json":
+        options.json = true;
+        break;
+      default:
+        if (arg.startsWith("--")) throw new Error(`Unknown option ${arg}`);
+        options.suites.push(arg);
+    }
+  }
+
+  if (!(options.runs >= 2)) throw new Error("--runs must be at least 2");
+  if (!(options.warmup >= 0)) throw new Error("--warmup must not be negative");
+  if (!["bun", "node", "deno"].includes(options.runtime)) throw new Error(`Unknown runtime ${options.runtime}`);
+  return options;
+}
+
+// The executables the bench:* scripts refer to as $BUN, $NODE and $DENO
+function runtimeEnv() {
+  return {
+    ...process.env,
+    BUN: process.env.BUN || (process.versions.bun ? process.execPath : "bun"),
+    NODE: process.env.NODE || (process.versions.bun ? "node" : process.execPath),
+    DENO: process.env.DENO || "deno",
+    // Keep suites from printing colors into what we parse
+    NO_COLOR: "1",
+    FORCE_COLOR: "0",
+  };
+}
+
+function findSuites(options, env) {
+  const script = `bench:${options.runtime}`;
+  const suites = [];
+
+  const startup = {
+    bun: `exec "$BUN" -e ""`,
+    node: `exec "$NODE" -e ""`,
+    deno: `exec "$DENO" eval ""`,
+  }[options.runtime];
+  suites.push({ name: "startup", cwd: benchDir, command: startup, setup: [] });
+
+  const visit = (dir, name) => {
+    const packageJson = join(dir, "package.json");
+    if (name && existsSync(packageJson)) {
+      const { scripts = {} } = JSON.parse(readFileSync(packageJson, "utf8"));
+      if (scripts[script]) {
+        const setup = ["deps", "build"].filter(s => scripts[s]).map(s => `"$BUN" run ${s}`);
+        // exec, so that the process we measure is the benchmark and not the shell
+        const command = /[;&|]/.test(scripts[script]) ? scripts[script] : `exec ${scripts[script]}`;
+        suites.push({ name, cwd: dir, command, setup });
+        return;
+      }
+    }
+
+    for (const entry of readdirSync(dir, { withFileTypes: true })) {
+      if (entry.isDirectory() && entry.name !== "node_modules" && entry.name !== "baselines") {
+        visit(join(dir, entry.name), name ? `${name}/${entry.name}` : entry.name);
+      }
+    }
+  };
+  visit(benchDir, "");
+
+  if (!options.suites.length) return suites;
+  for (const name of options.suites) {
+    if (!suites.some(suite => suite.name === name)) {
+      throw new Error(`No suite ${name} with a ${script} script, the suites are: ${suites.map(s => s.name).join(", ")}`);
+    }
+  }
+  return suites.filter(suite => options.suites.includes(suite.name));
+}
+
+// Peak RSS of a process, polled from /proc when the runtime cannot tell us once it exits
+function readPeakRss(pid) {
+  try {
+    const match = /^VmHWM:\s+(\d+) kB$/m.exec(readFileSync(`/proc/${pid}/status`, "utf8"));
+    return match ? parseInt(match[1], 10) * 1024 : 0;
+  } catch {
+    return 0;
+  }
+}
+
+async function runOnce(suite, options, env) {
+  const argv = ["sh", "-c", suite.command];
+  if (options.cpu !== null && platform() === "linux") argv.unshift("taskset", "-c", options.cpu);
+
+  const start = process.hrtime.bigint();
+  let stdout, exitCode, peakRss;
+
+  if (typeof Bun !== "undefined") {
+    const proc = Bun.spawn(argv, { cwd: suite.cwd, env, stdout: "pipe", stderr: "inherit" });
+    [stdout, exitCode] = await Promise.all([new Response(proc.stdout).text(), proc.exited]);
+    peakRss = proc.resourceUsage()?.maxRSS ?? 0;
+  } else {
+    const proc = spawn(argv[0], argv.slice(1), { cwd: suite.cwd, env, stdio: ["ignore", "pipe", "inherit"] });
+    const chunks = [];
+    peakRss = 0;
+    const poll = setInterval(() => {
+      peakRss = Math.max(peakRss, readPeakRss(proc.pid));
+    }, 5);
+    proc.stdout.on("data", chunk => {
+      chunks.push(chunk);
+      peakRss = Math.max(peakRss, readPeakRss(proc.pid));
+    });
+    exitCode = await new Promise(resolve => proc.on("close", code => resolve(code)));
+    clearInterval(poll);
+    stdout = Buffer.concat(chunks).toString();
+  }
+
+  const wallMs = Number(process.hrtime.bigint() - start) / 1e6;
+  if (exitCode !== 0) throw new Error(`${suite.name} exited with code ${exitCode}`);
+
+  const metrics = { "wall_ms": wallMs };
+  if (peakRss) metrics["peak_rss_mb"] = peakRss / (1024 * 1024);
+  for (const line of stdout.split("\n")) {
+    if (!line.startsWith("{")) continue;
+    let result;
+    try {
+      result = JSON.parse(line);
+    } catch {
+      continue;
+    }
+    if (typeof result?.benchmark !== "string") continue;
+    for (const [key, value] of Object.entries(result)) {
+      if (key.endsWith("_per_second") && typeof value === "number") metrics[`${result.benchmark}.${key}`] = value;
+    }
+  }
+  return metrics;
+}
+
+// Throughput is better higher, everything else lower
+const higherIsBetter = metric => metric.endsWith("_per_second");
+
+function median(samples) {
+  const sorted = [...samples].sort((a, b) => a - b);
+  const mid = sorted.length >> 1;
+  return sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+function stddev(samples) {
+  const mean = samples.reduce((a, b) => a + b, 0) / samples.length;
+  return Math.sqrt(samples.reduce((sum, x) => sum + (x - mean) ** 2, 0) / (samples.length - 1));
+}
+
+// Abramowitz and Stegun 7.1.26, to within 1.5e-7
+function normalCdf(z) {
+  const x = Math.abs(z) / Math.SQRT2;
+  const t = 1 / (1 + 0.3275911 * x);
+  const erf = 1 - ((((1.061405429 * t - 1.453152027) * t + 1.421413741) * t - 0.284496736) * t + 0.254829592) * t * Math.exp(-x * x);
+  return z >= 0 ? (1 + erf) / 2 : (1 - erf) / 2;
+}
+
+// Two-sided p-value of the Mann-Whitney U test, by the normal approximation with tie and continuity correction
+function mannWhitneyU(a, b) {
+  const all = [...a.map(value => ({ value, first: true })), ...b.map(value => ({ value, first: false }))];
+  all.sort((x, y) => x.value - y.value);
+
+  const n1 = a.length;
+  const n2 = b.length;
+  const n = n1 + n2;
+  let rankSum = 0;
+  let ties = 0;
+  for (let i = 0; i < n; ) {
+    let j = i;
+    while (j < n && all[j].value === all[i].value) j++;
+    // Tied values share the mean of the ranks they span
+    const rank = (i + 1 + j) / 2;
+    for (let k = i; k < j; k++) if (all[k].first) rankSum += rank;
+    ties += (j - i) ** 3 - (j - i);
+    i = j;
+  }
+
+  const u = rankSum - (n1 * (n1 + 1)) / 2;
+  const mean = (n1 * n2) / 2;
+  const sigma = Math.sqrt(((n1 * n2) / 12) * (n + 1 - ties / (n * (n - 1))));
+  if (!sigma) return 1;
+  const z = Math.max(0, Math.abs(u - mean) - 0.5) / sigma;
+  return Math.min(1, 2 * (1 - normalCdf(z)));
+}
+
+function machine() {
+  const cpuList = cpus();
+  return {
+    platform: platform(),
+    arch: arch(),
+    kernel: release(),
+    cpu: cpuList[0]?.model ?? "unknown",
+    cpus: cpuList.length,
+  };
+}
+
+function sameMachine(a, b) {
+  return a.platform === b.platform && a.arch === b.arch && a.cpu === b.cpu && a.cpus === b.cpus;
+}
+
+function runtimeVersion(options, env) {
+  const executable = { bun: env.BUN, node: env.NODE, deno: env.DENO }[options.runtime];
+  return new Promise(resolve => {
+    const proc = spawn(executable, ["--version"], { env, stdio: ["ignore", "pipe", "ignore"] });
+    let out = "";
+    proc.stdout.on("data", chunk => (out += chunk));
+    proc.on("error", () => resolve("unknown"));
+    proc.on("close", () => resolve(out.trim().split("\n")[0] || "unknown"));
+  });
+}
+
+// Conditions that make results noisy, which are worth knowing about but not worth refusing to run over
+function warnAboutConditions(options) {
+  if (platform() !== "linux") return;
+  try {
+    const governor = readFileSync("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", "utf8").trim();
+    if (governor !== "performance") console.error(`warning: the CPU frequency governor is "${governor}", not "performance"`);
+  } catch {}
+  try {
+    if (readFileSync("/sys/devices/system/cpu/intel_pstate/no_turbo", "utf8").trim() === "0") {
+      console.error("warning: turbo boost is enabled, which makes results depend on temperature");
+    }
+  } catch {}
+  if (options.cpu === null) console.error("warning: runs are not pinned to a CPU, use --cpu");
+}
+
+function compare(results, baseline, options) {
+  const comparisons = [];
+  for (const [suite, { metrics }] of Object.entries(results.suites)) {
+    for (const [metric, { samples }] of Object.entries(metrics)) {
+      const base = baseline.suites[suite]?.metrics[metric]?.samples;
+      if (!base) continue;
+
+      const now = median(samples);
+      const before = median(base);
+      const change = before ? ((now - before) / before) * 100 : 0;
+      const p = mannWhitneyU(samples, base);
+      let verdict = "same";
+      if (p < options.alpha && Math.abs(change) >= options.threshold) {
+        verdict = change > 0 === higherIsBetter(metric) ? "faster" : "slower";
+      }
+      comparisons.push({ suite, metric, median: now, baseline: before, change, p, verdict });
+    }
+  }
+  return comparisons;
+}
+
+function format(value) {
+  return value >= 100 ? value.toFixed(0) : value >= 1 ? value.toFixed(2) : value.toPrecision(3);
+}
+
+function printTable(results, comparisons) {
+  const rows = [["suite", "metric", "median", "stddev", "baseline", "change", "p", ""]];
+  for (const [suite, { metrics }] of Object.entries(results.suites)) {
+    for (const [metric, { samples }] of Object.entries(metrics)) {
+      const comparison = comparisons?.find(c => c.suite === suite && c.metric === metric);
+      rows.push([
+        suite,
+        metric,
+        format(median(samples)),
+        format(stddev(samples)),
+        comparison ? format(comparison.baseline) : "",
+        comparison ? `${comparison.change >= 0 ? "+" : ""}${comparison.change.toFixed(1)}%` : "",
+        comparison ? comparison.p.toFixed(3) : "",
+        comparison && comparison.verdict !== "same" ? comparison.verdict : "",
+      ]);
+    }
+  }
+
+  if (!comparisons) rows.forEach(row => row.splice(4));
+  const widths = rows[0].map((_, i) => Math.max(...rows.map(row => row[i].length)));
+  for (const row of rows) {
+    console.log(row.map((cell, i) => (i < 2 ? cell.padEnd(widths[i]) : cell.padStart(widths[i]))).join("  ").trimEnd());
+  }
+}
+
+async function main() {
+  const options = parseOptions(process.argv.slice(2));
+  const env = runtimeEnv();
+  const suites = findSuites(options, env);
+
+  let baseline = null;
+  if (options.compare) {
+    const path = join(baselinesDir, `${options.compare}.json`);
+    if (!existsSync(path)) throw new Error(`No baseline at ${path}`);
+    baseline = JSON.parse(readFileSync(path, "utf8"));
+    if (!sameMachine(baseline.machine, machine())) {
+      console.error(`warning: ${options.compare} was taken on ${baseline.machine.cpu} (${baseline.machine.cpus} CPUs), not this machine`);
+    }
+  }
+
+  warnAboutConditions(options);
+
+  if (options.setup) {
+    for (const suite of suites) {
+      for (const command of suite.setup) {
+        await runOnce({ ...suite, command }, { ...options, cpu: null }, env);
+      }
+    }
+  }
+
+  const results = {
+    version: 1,
+    date: new Date().toISOString(),
+    runtime: { name: options.runtime, version: await runtimeVersion(options, env) },
+    machine: machine(),
+    options: { runs: options.runs, warmup: options.warmup, cpu: options.cpu },
+    suites: Object.fromEntries(suites.map(suite => [suite.name, { metrics: {} }])),
+  };
+
+  for (let run = -options.warmup; run < options.runs; run++) {
+    for (const suite of suites) {
+      const metrics = await runOnce(suite, options, env);
+      if (run < 0) continue;
+      for (const [metric, value] of Object.entries(metrics)) {
+        (results.suites[suite.name].metrics[metric] ??= { samples: [] }).samples.push(value);
+      }
+    }
+    if (!options.json) console.error(run < 0 ? `warmup ${run + options.warmup + 1}/${options.warmup}` : `run ${run + 1}/${options.runs}`);
+  }
+
+  const comparisons = baseline ? compare(results, baseline, options) : null;
+  if (options.json) {
+    console.log(JSON.stringify({ ...results, baseline: options.compare, comparisons }, null, 2));
+  } else {
+    printTable(results, comparisons);
+  }
+
+  if (options.save) {
+    mkdirSync(baselinesDir, { recursive: true });
+    writeFileSync(join(baselinesDir, `${options.save}.json`), JSON.stringify(results, null, 2) + "\n");
+    if (!options.json) console.error(`saved baselines/${options.save}.json`);
+  }
+
+  if (comparisons?.some(c => c.verdict === "slower")) process.exit(1);
+}
+
+main().catch(error => {
+  console.error(error.message);
+  process.exit(2);
+});
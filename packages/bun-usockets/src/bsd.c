@@ -38,6 +38,24 @@
 #include <mstcpip.h>
 #endif
 
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
+#ifdef LIBUS_UDP_HAS_GSO
+#include <netinet/udp.h>
+/* Older libc headers may not know about these yet */
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 #if defined(__APPLE__) && defined(__aarch64__)
 #define HAS_MSGX
 #endif
@@ -242,6 +260,101 @@ int bsd_udp_packet_buffer_local_ip(struct udp_recvbuf *msgvec, int index, char *
 #endif
 }
 
+// with UDP_GRO enabled one received packet can hold several datagrams of this size (the last one may be shorter)
+// returns 0 if the packet was not coalesced
+int bsd_udp_packet_buffer_segment_size(struct udp_recvbuf *msgvec, int index) {
+#ifndef LIBUS_UDP_HAS_GSO
+    return 0;
+#else
+    struct msghdr *mh = &((struct mmsghdr *) msgvec)[index].msg_hdr;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(mh); cmsg != NULL; cmsg = CMSG_NXTHDR(mh, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segment_size;
+            memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+            /* A single datagram is never reported as coalesced */
+            if (segment_size >= ((struct mmsghdr *) msgvec)[index].msg_len) {
+                return 0;
+            }
+            return segment_size;
+        }
+    }
+
+    return 0;
+#endif
+}
+
+// returns 0 if the kernel can segment our sends (UDP_SEGMENT), -1 otherwise
+int bsd_udp_enable_gso(LIBUS_SOCKET_DESCRIPTOR fd) {
+#ifndef LIBUS_UDP_HAS_GSO
+    return -1;
+#else
+    /* The option is set per send as a control message, here we only probe for support */
+    int segment_size = 0;
+    socklen_t len = sizeof(segment_size);
+    return getsockopt(fd, SOL_UDP, UDP_SEGMENT, &segment_size, &len) == 0 ? 0 : -1;
+#endif
+}
+
+int bsd_udp_enable_gro(LIBUS_SOCKET_DESCRIPTOR fd, int enabled) {
+#ifndef LIBUS_UDP_HAS_GSO
+    return -1;
+#else
+    return setsockopt(fd, SOL_UDP, UDP_GRO, &enabled, sizeof(enabled)) == 0 ? 0 : -1;
+#endif
+}
+
+// sends num datagrams of segment_size bytes (the last one may be shorter) to the same address in one syscall
+// returns num or -1 on error, in which case nothing was sent
+int bsd_udp_send_segments(LIBUS_SOCKET_DESCRIPTOR fd, void **payloads, size_t *lengths, int num, void *address, size_t segment_size, int flags) {
+#ifndef LIBUS_UDP_HAS_GSO
+    errno = ENOTSUP;
+    return -1;
+#else
+    struct iovec iov[LIBUS_UDP_MAX_SEGMENTS];
+    if (num > LIBUS_UDP_MAX_SEGMENTS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (int i = 0; i < num; i++) {
+        iov[i].iov_base = payloads[i];
+        iov[i].iov_len = lengths[i];
+    }
+
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct sockaddr *addr = (struct sockaddr *) address;
+    struct msghdr mh = {0};
+    if (addr) {
+        mh.msg_name = addr;
+        mh.msg_namelen = addr->sa_family == AF_INET ? sizeof(struct sockaddr_in)
+                       : addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6)
+                       : 0;
+    }
+    mh.msg_iov = iov;
+    mh.msg_iovlen = num;
+    mh.msg_control = control.buf;
+    mh.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&mh);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t gso_size = (uint16_t) segment_size;
+    memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+    while (1) {
+        ssize_t ret = sendmsg(fd, &mh, flags | MSG_NOSIGNAL);
+        if (ret >= 0) return num;
+        if (errno != EINTR) return -1;
+    }
+#endif
+}
+
 char *bsd_udp_packet_buffer_peer(struct udp_recvbuf *msgvec, int index) {
 #if defined(_WIN32)
     return (char *)&msgvec->addr;
@@ -305,6 +418,116 @@ void bsd_socket_nodelay(LIBUS_SOCKET_DESCRIPTOR fd, int enabled) {
     setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (void *) &enabled, sizeof(enabled));
 }
 
+int bsd_socket_incoming_cpu(LIBUS_SOCKET_DESCRIPTOR fd, int cpu) {
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+    return setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, (void *) &cpu, sizeof(cpu)) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+}
+
+int bsd_send_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, const LIBUS_SOCKET_DESCRIPTOR *fds, int count) {
+#ifdef _WIN32
+    return -1;
+#else
+    if (count <= 0 || count > LIBUS_MAX_PASSED_FDS) {
+        return -1;
+    }
+
+    /* At least one byte of real data has to go with the descriptors */
+    char byte = 0;
+    struct iovec iov = {&byte, 1};
+    union {
+        struct cmsghdr header;
+        char buf[CMSG_SPACE(sizeof(int) * LIBUS_MAX_PASSED_FDS)];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr msg = {0};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(unix_fd, &msg, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+
+    return sent == 1 ? 0 : -1;
+#endif
+}
+
+int bsd_recv_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, LIBUS_SOCKET_DESCRIPTOR *fds, int max_count) {
+#ifdef _WIN32
+    return -1;
+#else
+    char byte;
+    struct iovec iov = {&byte, 1};
+    union {
+        struct cmsghdr header;
+        char buf[CMSG_SPACE(sizeof(int) * LIBUS_MAX_PASSED_FDS)];
+    } control;
+
+    struct msghdr msg = {0};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t received;
+    do {
+#ifdef MSG_CMSG_CLOEXEC
+        received = recvmsg(unix_fd, &msg, MSG_CMSG_CLOEXEC);
+#else
+        received = recvmsg(unix_fd, &msg, 0);
+#endif
+    } while (received == -1 && errno == EINTR);
+
+    if (received <= 0) {
+        return -1;
+    }
+
+    int count = 0;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+
+        int *passed = (int *) CMSG_DATA(cmsg);
+        int passed_count = (int) ((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        for (int i = 0; i < passed_count; i++) {
+            /* Whatever does not fit is not leaked */
+            if (count < max_count) {
+                fds[count++] = passed[i];
+            } else {
+                close(passed[i]);
+            }
+        }
+    }
+
+    return count;
+#endif
+}
+
+void bsd_socket_cork(LIBUS_SOCKET_DESCRIPTOR fd) {
+    // Hold back partial segments until bsd_socket_flush
+#ifdef TCP_CORK
+    int enabled = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_CORK, (void *) &enabled, sizeof(int));
+#endif
+}
+
 void bsd_socket_flush(LIBUS_SOCKET_DESCRIPTOR fd) {
     // Linux TCP_CORK has the same underlying corking mechanism as with MSG_MORE
 #ifdef TCP_CORK
@@ -453,6 +676,91 @@ int bsd_write2(LIBUS_SOCKET_DESCRIPTOR fd, const char *header, int header_length
 }
 #endif
 
+#ifndef _WIN32
+#include <limits.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+/* Returns bytes written or -1, like send. Gives up at the first chunk the kernel could not take entirely */
+int bsd_writev(LIBUS_SOCKET_DESCRIPTOR fd, const struct us_iovec_t *iov, int iovcnt) {
+    int total = 0;
+    while (iovcnt > 0) {
+#ifdef _WIN32
+        /* WSABUF has its own layout */
+        WSABUF chunks[64];
+        int count = iovcnt < 64 ? iovcnt : 64;
+        size_t length = 0;
+        for (int i = 0; i < count; i++) {
+            chunks[i].buf = (char *) iov[i].data;
+            chunks[i].len = (ULONG) iov[i].length;
+            length += iov[i].length;
+        }
+        DWORD sent = 0;
+        if (WSASend(fd, chunks, count, &sent, 0, NULL, NULL) == SOCKET_ERROR) {
+            return total ? total : -1;
+        }
+#else
+        int count = iovcnt < IOV_MAX ? iovcnt : IOV_MAX;
+        size_t length = 0;
+        for (int i = 0; i < count; i++) {
+            length += iov[i].length;
+        }
+        struct msghdr mh = {0};
+        mh.msg_iov = (struct iovec *) iov;
+        mh.msg_iovlen = count;
+        ssize_t sent = sendmsg(fd, &mh, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return total ? total : -1;
+        }
+#endif
+        total += (int) sent;
+        if ((size_t) sent < length) {
+            break;
+        }
+        iov += count;
+        iovcnt -= count;
+    }
+    return total;
+}
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/uio.h>
+#endif
+
+/* Returns bytes sent, or -1 with errno set. Partial sends are reported as bytes sent, like send */
+int bsd_sendfile(LIBUS_SOCKET_DESCRIPTOR fd, int file_fd, long long offset, int length) {
+#if defined(__linux__)
+    off_t off = (off_t) offset;
+    while (1) {
+        ssize_t ret = sendfile(fd, file_fd, &off, (size_t) length);
+        if (ret >= 0 || errno != EINTR) return (int) ret;
+    }
+#elif defined(__APPLE__)
+    off_t len = length;
+    int ret = sendfile(file_fd, fd, (off_t) offset, &len, NULL, 0);
+    /* A partial send still fails with EAGAIN but reports what it did send */
+    if (ret == -1 && len > 0 && (errno == EAGAIN || errno == EINTR)) {
+        return (int) len;
+    }
+    return ret == -1 ? -1 : (int) len;
+#elif defined(__FreeBSD__)
+    off_t sbytes = 0;
+    int ret = sendfile(file_fd, fd, (off_t) offset, (size_t) length, NULL, &sbytes, 0);
+    if (ret == -1 && sbytes > 0 && (errno == EAGAIN || errno == EINTR)) {
+        return (int) sbytes;
+    }
+    return ret == -1 ? -1 : (int) sbytes;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
 int bsd_send(LIBUS_SOCKET_DESCRIPTOR fd, const char *buf, int length, int msg_more) {
 
     // MSG_MORE (Linux), MSG_PARTIAL (Windows), TCP_NOPUSH (BSD)
@@ -725,7 +1033,7 @@ LIBUS_SOCKET_DESCRIPTOR bsd_create_listen_socket_unix(const char *path, size_t l
     return listenFd;
 }
 
-LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port) {
+LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port, int options) {
     struct addrinfo hints, *result;
     memset(&hints, 0, sizeof(struct addrinfo));
 
@@ -766,6 +1074,13 @@ LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port) {
         int enabled = 1;
         setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, (void *) &enabled, sizeof(enabled));
     }
+
+#if defined(SO_REUSEPORT)
+    if (options & LIBUS_LISTEN_REUSE_PORT) {
+        int enabled = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEPORT, (void *) &enabled, sizeof(enabled));
+    }
+#endif
     
 #ifdef IPV6_V6ONLY
     int disabled = 0;
@@ -812,6 +1127,35 @@ LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port) {
     return listenFd;
 }
 
+int bsd_udp_steer_by_connection_id(LIBUS_SOCKET_DESCRIPTOR fd, int group_size) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    if (group_size < 1 || group_size > 256) {
+        return -1;
+    }
+
+    /* Reuseport programs see the datagram from the UDP payload on. The destination connection id
+     * follows the first byte of short header packets, and the first byte, version and length byte
+     * of long header packets. Its first byte picks the socket; out of range loads return index 0 */
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x80, 0, 2),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),
+        BPF_STMT(BPF_JMP | BPF_JA, 1),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 1),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (unsigned int) group_size),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_fprog prog = {
+        .len = sizeof(code) / sizeof(code[0]),
+        .filter = code,
+    };
+
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+}
+
 int bsd_connect_udp_socket(LIBUS_SOCKET_DESCRIPTOR fd, const char *host, int port) {
     struct addrinfo hints, *result;
     memset(&hints, 0, sizeof(struct addrinfo));
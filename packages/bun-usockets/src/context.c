@@ -25,7 +25,9 @@
 #include <arpa/inet.h>
 #endif
 
-#define CONCURRENT_CONNECTIONS 2
+/* RFC 8305's Connection Attempt Delay: how long an attempt gets before the
+ * next address is tried alongside it */
+#define CONNECTION_ATTEMPT_DELAY_MS 250
 
 int default_is_low_prio_handler(struct us_socket_t *s) {
     return 0;
@@ -59,6 +61,32 @@ void us_listen_socket_close(int ssl, struct us_listen_socket_t *ls) {
     /* We cannot immediately free a listen socket as we can be inside an accept loop */
 }
 
+int us_listen_socket_set_incoming_cpu(int ssl, struct us_listen_socket_t *ls, int cpu) {
+    return bsd_socket_incoming_cpu(us_poll_fd((struct us_poll_t *) &ls->s), cpu);
+}
+
+LIBUS_SOCKET_DESCRIPTOR us_listen_socket_get_fd(int ssl, struct us_listen_socket_t *ls) {
+    return us_poll_fd((struct us_poll_t *) &ls->s);
+}
+
+int us_listen_socket_send_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, const LIBUS_SOCKET_DESCRIPTOR *fds, int count) {
+    return bsd_send_fds(unix_fd, fds, count);
+}
+
+int us_listen_socket_recv_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, LIBUS_SOCKET_DESCRIPTOR *fds, int max_count) {
+    return bsd_recv_fds(unix_fd, fds, max_count);
+}
+
+void us_socket_context_for_each_socket(int ssl, struct us_socket_context_t *context, void (*cb)(struct us_socket_t *s, void *user_data), void *user_data) {
+    /* The callback may close the socket it is given, which relinks it into the closed list */
+    struct us_socket_t *s = context->head_sockets;
+    while (s) {
+        struct us_socket_t *nextS = s->next;
+        cb(s, user_data);
+        s = nextS;
+    }
+}
+
 void us_socket_context_close(int ssl, struct us_socket_context_t *context) {
     /* Begin by closing all listen sockets */
     struct us_listen_socket_t *ls = context->head_listen_sockets;
@@ -83,6 +111,8 @@ void us_internal_socket_context_unlink_listen_socket(struct us_socket_context_t
         context->iterator = ls->s.next;
     }
 
+    us_internal_timer_wheel_unlink(context, &ls->s);
+
     if (ls->s.prev == ls->s.next) {
         context->head_listen_sockets = 0;
     } else {
@@ -103,6 +133,8 @@ void us_internal_socket_context_unlink_socket(struct us_socket_context_t *contex
         context->iterator = s->next;
     }
 
+    us_internal_timer_wheel_unlink(context, s);
+
     if (s->prev == s->next) {
         context->head_sockets = 0;
     } else {
@@ -122,6 +154,7 @@ void us_internal_socket_context_link_listen_socket(struct us_socket_context_t *c
     ls->s.context = context;
     ls->s.next = (struct us_socket_t *) context->head_listen_sockets;
     ls->s.prev = 0;
+    ls->s.timer_slot = LIBUS_TIMER_WHEEL_NONE;
     if (context->head_listen_sockets) {
         context->head_listen_sockets->s.prev = &ls->s;
     }
@@ -137,6 +170,232 @@ void us_internal_socket_context_link_socket(struct us_socket_context_t *context,
         context->head_sockets->prev = s;
     }
     context->head_sockets = s;
+
+    s->pool_state = 0;
+    s->timer_slot = LIBUS_TIMER_WHEEL_NONE;
+    if (context->timer_wheel) {
+        us_internal_timer_wheel_link(context, s);
+    }
+}
+
+/* Number of sweep ticks until the short timeout of this socket fires (1-240) */
+static unsigned int us_internal_ticks_until_timeout(struct us_socket_context_t *context, struct us_socket_t *s) {
+    unsigned int ticks = ((unsigned int) s->timeout + 240 - context->timestamp) % 240;
+    return ticks ? ticks : 240;
+}
+
+/* Number of sweep ticks until the long timeout of this socket fires. Long ticks
+ * last 15 short ticks and a long timeout fires on the first sweep of its long tick,
+ * or on the next sweep if the current long tick already matches */
+static unsigned int us_internal_ticks_until_long_timeout(struct us_socket_context_t *context, struct us_socket_t *s) {
+    unsigned int long_ticks = ((unsigned int) s->long_timeout + 240 - context->long_timestamp) % 240;
+    unsigned int phase = context->global_tick % 15;
+    if (long_ticks == 0) {
+        if (phase != 14) {
+            return 1;
+        }
+        long_ticks = 240;
+    }
+    return long_ticks * 15 - phase;
+}
+
+void us_internal_timer_wheel_unlink(struct us_socket_context_t *context, struct us_socket_t *s) {
+    if (s->timer_slot == LIBUS_TIMER_WHEEL_NONE) {
+        return;
+    }
+
+    if (s->timer_prev) {
+        s->timer_prev->timer_next = s->timer_next;
+    } else {
+        context->timer_wheel[s->timer_slot] = s->timer_next;
+    }
+    if (s->timer_next) {
+        s->timer_next->timer_prev = s->timer_prev;
+    }
+    s->timer_slot = LIBUS_TIMER_WHEEL_NONE;
+}
+
+/* (Re)links the socket into the bucket of whichever of its two timeouts fires first.
+ * The sweep checks both timeouts and relinks, so being in one bucket is enough */
+void us_internal_timer_wheel_link(struct us_socket_context_t *context, struct us_socket_t *s) {
+    us_internal_timer_wheel_unlink(context, s);
+
+    if (us_socket_is_closed(0, s)) {
+        return;
+    }
+
+    /* Anything outside of 0-239 means no timeout (usually 255) */
+    int has_timeout = s->timeout < 240, has_long_timeout = s->long_timeout < 240;
+    unsigned short slot;
+    if (has_timeout && has_long_timeout) {
+        slot = us_internal_ticks_until_timeout(context, s) <= us_internal_ticks_until_long_timeout(context, s) ? s->timeout : 240 + s->long_timeout;
+    } else if (has_timeout) {
+        slot = s->timeout;
+    } else if (has_long_timeout) {
+        slot = 240 + s->long_timeout;
+    } else {
+        return;
+    }
+
+    s->timer_slot = slot;
+    s->timer_prev = 0;
+    s->timer_next = context->timer_wheel[slot];
+    if (s->timer_next) {
+        s->timer_next->timer_prev = s;
+    }
+    context->timer_wheel[slot] = s;
+}
+
+void us_socket_context_enable_timer_wheel(int ssl, struct us_socket_context_t *context) {
+    /* SSL contexts begin with their non-SSL context so this works for both */
+    if (context->timer_wheel) {
+        return;
+    }
+
+    context->timer_wheel = us_calloc(LIBUS_TIMER_WHEEL_BUCKETS + 1, sizeof(struct us_socket_t *));
+
+    /* Sockets linked before the wheel existed need their buckets too */
+    for (struct us_socket_t *s = context->head_sockets; s; s = s->next) {
+        s->timer_slot = LIBUS_TIMER_WHEEL_NONE;
+        us_internal_timer_wheel_link(context, s);
+    }
+}
+
+static void us_internal_socket_pool_unlink(struct us_socket_pool_t *pool, struct us_pooled_socket_t *entry) {
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        pool->head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        pool->tail = entry->prev;
+    }
+    pool->stats.idle--;
+    entry->s->pool_state = 0;
+    us_free(entry);
+}
+
+static struct us_pooled_socket_t *us_internal_socket_pool_find(struct us_socket_t *s) {
+    struct us_pooled_socket_t *entry = s->context->pool->head;
+    while (entry && entry->s != s) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+/* Closes a pooled socket, which runs on_close like for any other socket */
+static void us_internal_socket_pool_close(struct us_socket_pool_t *pool, struct us_pooled_socket_t *entry, unsigned long long *counter) {
+    struct us_socket_t *s = entry->s;
+    int ssl = entry->ssl;
+    us_internal_socket_pool_unlink(pool, entry);
+    (*counter)++;
+    us_socket_close(ssl, s, 0, NULL);
+}
+
+void us_internal_socket_pool_remove(struct us_socket_t *s) {
+    struct us_pooled_socket_t *entry = us_internal_socket_pool_find(s);
+    if (entry) {
+        us_internal_socket_pool_unlink(s->context->pool, entry);
+    }
+}
+
+void us_internal_socket_pool_expire(struct us_socket_t *s, int timed_out) {
+    struct us_socket_pool_t *pool = s->context->pool;
+    struct us_pooled_socket_t *entry = us_internal_socket_pool_find(s);
+    if (entry) {
+        us_internal_socket_pool_close(pool, entry, timed_out ? &pool->stats.expirations : &pool->stats.closed);
+    }
+}
+
+void us_socket_context_set_pool_limits(int ssl, struct us_socket_context_t *context, unsigned int max_idle, unsigned int max_idle_per_host, unsigned int idle_timeout) {
+    /* SSL contexts begin with their non-SSL context so this works for both */
+    if (!context->pool) {
+        context->pool = us_calloc(1, sizeof(struct us_socket_pool_t));
+    }
+    struct us_socket_pool_t *pool = context->pool;
+    pool->max_idle = max_idle;
+    pool->max_idle_per_host = max_idle_per_host;
+    pool->idle_timeout = idle_timeout;
+
+    while (pool->stats.idle > pool->max_idle) {
+        us_internal_socket_pool_close(pool, pool->tail, &pool->stats.evictions);
+    }
+}
+
+int us_socket_pool_put(int ssl, struct us_socket_t *s, const char *host, int port) {
+    struct us_socket_pool_t *pool = s->context->pool;
+    if (!pool || !pool->max_idle || !pool->max_idle_per_host || s->pool_state || s->low_prio_state ||
+        us_socket_is_closed(ssl, s) || us_socket_is_shut_down(ssl, s)) {
+        return 0;
+    }
+
+    /* Make room, among the sockets to this host first */
+    unsigned int same_host = 0;
+    struct us_pooled_socket_t *oldest_same_host = 0;
+    for (struct us_pooled_socket_t *entry = pool->head; entry; entry = entry->next) {
+        if (entry->port == port && !strcmp(entry->host, host)) {
+            same_host++;
+            oldest_same_host = entry;
+        }
+    }
+    if (same_host >= pool->max_idle_per_host) {
+        us_internal_socket_pool_close(pool, oldest_same_host, &pool->stats.evictions);
+    } else if (pool->stats.idle >= pool->max_idle) {
+        us_internal_socket_pool_close(pool, pool->tail, &pool->stats.evictions);
+    }
+
+    size_t host_length = strlen(host);
+    struct us_pooled_socket_t *entry = us_malloc(sizeof(struct us_pooled_socket_t) + host_length + 1);
+    entry->s = s;
+    entry->ssl = ssl;
+    entry->port = port;
+    memcpy(entry->host, host, host_length + 1);
+
+    entry->prev = 0;
+    entry->next = pool->head;
+    if (pool->head) {
+        pool->head->prev = entry;
+    } else {
+        pool->tail = entry;
+    }
+    pool->head = entry;
+    pool->stats.idle++;
+
+    s->pool_state = 1;
+    us_socket_timeout(ssl, s, pool->idle_timeout);
+    us_socket_long_timeout(ssl, s, 0);
+    us_poll_change(&s->p, s->context->loop, LIBUS_SOCKET_READABLE);
+    return 1;
+}
+
+struct us_socket_t *us_socket_pool_take(int ssl, struct us_socket_context_t *context, const char *host, int port) {
+    struct us_socket_pool_t *pool = context->pool;
+    if (!pool) {
+        return 0;
+    }
+
+    for (struct us_pooled_socket_t *entry = pool->head; entry; entry = entry->next) {
+        if (entry->port == port && !strcmp(entry->host, host)) {
+            struct us_socket_t *s = entry->s;
+            us_internal_socket_pool_unlink(pool, entry);
+            us_socket_timeout(ssl, s, 0);
+            pool->stats.hits++;
+            return s;
+        }
+    }
+
+    pool->stats.misses++;
+    return 0;
+}
+
+void us_socket_context_pool_stats(int ssl, struct us_socket_context_t *context, struct us_socket_pool_stats_t *stats) {
+    if (context->pool) {
+        *stats = context->pool->stats;
+    } else {
+        memset(stats, 0, sizeof(*stats));
+    }
 }
 
 struct us_loop_t *us_socket_context_loop(int ssl, struct us_socket_context_t *context) {
@@ -181,6 +440,15 @@ void us_bun_socket_context_add_server_name(int ssl, struct us_socket_context_t *
 #endif
 }
 
+int us_bun_socket_context_replace_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern, struct us_bun_socket_context_options_t options) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        return us_bun_internal_ssl_socket_context_replace_server_name((struct us_internal_ssl_socket_context_t *) context, hostname_pattern, options);
+    }
+#endif
+    return 0;
+}
+
 /* Remove SNI context */
 void us_socket_context_remove_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern) {
 #ifndef LIBUS_NO_SSL
@@ -216,6 +484,56 @@ void *us_socket_context_get_native_handle(int ssl, struct us_socket_context_t *c
     return 0;
 }
 
+void us_socket_context_enable_ktls(int ssl, struct us_socket_context_t *context) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_enable_ktls((struct us_internal_ssl_socket_context_t *) context);
+    }
+#endif
+}
+
+void us_socket_context_set_session_store(int ssl, struct us_socket_context_t *context, const struct us_ssl_session_store_t *store) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_set_session_store((struct us_internal_ssl_socket_context_t *) context, store);
+    }
+#endif
+}
+
+void us_socket_context_set_ticket_key_ring(int ssl, struct us_socket_context_t *context, struct us_ssl_ticket_key_ring_t *ring) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_set_ticket_key_ring((struct us_internal_ssl_socket_context_t *) context, ring);
+    }
+#endif
+}
+
+void us_socket_context_enable_async_handshake(int ssl, struct us_socket_context_t *context) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_enable_async_handshake((struct us_internal_ssl_socket_context_t *) context);
+    }
+#endif
+}
+
+void us_socket_context_enable_client_session_cache(int ssl, struct us_socket_context_t *context, unsigned int max_sessions) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_enable_client_session_cache((struct us_internal_ssl_socket_context_t *) context, max_sessions);
+    }
+#endif
+}
+
+void us_socket_context_session_stats(int ssl, struct us_socket_context_t *context, struct us_ssl_session_stats_t *stats) {
+    stats->hits = 0;
+    stats->misses = 0;
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        us_internal_ssl_socket_context_session_stats((struct us_internal_ssl_socket_context_t *) context, stats);
+    }
+#endif
+}
+
 /* Options is currently only applicable for SSL - this will change with time (prefer_low_memory is one example) */
 struct us_socket_context_t *us_create_socket_context(int ssl, struct us_loop_t *loop, int context_ext_size, struct us_socket_context_options_t options) {
 #ifndef LIBUS_NO_SSL
@@ -285,6 +603,11 @@ void us_socket_context_free(int ssl, struct us_socket_context_t *context) {
      * This is the opposite order compared to when creating the context - SSL code is cleaning up before non-SSL */
 
     us_internal_loop_unlink(context->loop, context);
+    us_free(context->timer_wheel);
+    if (context->pool) {
+        /* Any socket still pooled is closed by now, so no entries are left */
+        us_free(context->pool);
+    }
     us_free(context);
 }
 
@@ -301,7 +624,7 @@ struct us_listen_socket_t *us_socket_context_listen(int ssl, struct us_socket_co
         return 0;
     }
 
-    struct us_poll_t *p = us_create_poll(context->loop, 0, sizeof(struct us_listen_socket_t));
+    struct us_poll_t *p = us_internal_create_socket_poll(context->loop, sizeof(struct us_listen_socket_t));
     us_poll_init(p, listen_socket_fd, POLL_TYPE_SEMI_SOCKET);
     us_poll_start(p, context->loop, LIBUS_SOCKET_READABLE);
 
@@ -319,6 +642,34 @@ struct us_listen_socket_t *us_socket_context_listen(int ssl, struct us_socket_co
     return ls;
 }
 
+struct us_listen_socket_t *us_socket_context_listen_fd(int ssl, struct us_socket_context_t *context, LIBUS_SOCKET_DESCRIPTOR fd, int socket_ext_size) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        return us_internal_ssl_socket_context_listen_fd((struct us_internal_ssl_socket_context_t *) context, fd, socket_ext_size);
+    }
+#endif
+
+    /* Descriptors passed from another process keep whatever blocking mode they had there */
+    bsd_set_nonblocking(fd);
+
+    struct us_poll_t *p = us_internal_create_socket_poll(context->loop, sizeof(struct us_listen_socket_t));
+    us_poll_init(p, fd, POLL_TYPE_SEMI_SOCKET);
+    us_poll_start(p, context->loop, LIBUS_SOCKET_READABLE);
+
+    struct us_listen_socket_t *ls = (struct us_listen_socket_t *) p;
+    ls->s.connect_state = NULL;
+    ls->s.context = context;
+    ls->s.timeout = 255;
+    ls->s.long_timeout = 255;
+    ls->s.low_prio_state = 0;
+    ls->s.next = 0;
+    us_internal_socket_context_link_listen_socket(context, ls);
+
+    ls->socket_ext_size = socket_ext_size;
+
+    return ls;
+}
+
 struct us_listen_socket_t *us_socket_context_listen_unix(int ssl, struct us_socket_context_t *context, const char *path, size_t pathlen, int options, int socket_ext_size) {
 #ifndef LIBUS_NO_SSL
     if (ssl) {
@@ -332,7 +683,7 @@ struct us_listen_socket_t *us_socket_context_listen_unix(int ssl, struct us_sock
         return 0;
     }
 
-    struct us_poll_t *p = us_create_poll(context->loop, 0, sizeof(struct us_listen_socket_t));
+    struct us_poll_t *p = us_internal_create_socket_poll(context->loop, sizeof(struct us_listen_socket_t));
     us_poll_init(p, listen_socket_fd, POLL_TYPE_SEMI_SOCKET);
     us_poll_start(p, context->loop, LIBUS_SOCKET_READABLE);
 
@@ -360,7 +711,7 @@ struct us_socket_t* us_socket_context_connect_resolved_dns(struct us_socket_cont
     bsd_socket_nodelay(connect_socket_fd, 1);
 
     /* Connect sockets are semi-sockets just like listen sockets */
-    struct us_poll_t *p = us_create_poll(context->loop, 0, sizeof(struct us_socket_t) + socket_ext_size);
+    struct us_poll_t *p = us_internal_create_socket_poll(context->loop, sizeof(struct us_socket_t) + socket_ext_size);
     us_poll_init(p, connect_socket_fd, POLL_TYPE_SEMI_SOCKET);
     us_poll_start(p, context->loop, LIBUS_SOCKET_WRITABLE);
 
@@ -476,11 +827,53 @@ void *us_socket_context_connect(int ssl, struct us_socket_context_t *context, co
     return c;
 }
 
+/* Orders the addresses as RFC 8305 section 4 asks, alternating between the
+ * address families and starting with the family the resolver put first. The
+ * list itself may be shared through the DNS cache, so it is left alone */
+static int order_addresses(struct us_connecting_socket_t *c, struct addrinfo *head) {
+    int count = 0;
+    for (struct addrinfo *a = head; a; a = a->ai_next) {
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    c->addrinfo_order = us_malloc(count * sizeof(struct addrinfo *));
+    if (!c->addrinfo_order) {
+        return 0;
+    }
+
+    int family = head->ai_family;
+    struct addrinfo *same = head;
+    struct addrinfo *different = head;
+    int n = 0;
+    while (n < count) {
+        while (same && same->ai_family != family) {
+            same = same->ai_next;
+        }
+        if (same) {
+            c->addrinfo_order[n++] = same;
+            same = same->ai_next;
+        }
+        while (different && different->ai_family == family) {
+            different = different->ai_next;
+        }
+        if (different) {
+            c->addrinfo_order[n++] = different;
+            different = different->ai_next;
+        }
+    }
+    c->addrinfo_count = count;
+    c->addrinfo_next = 0;
+    return count;
+}
+
 int start_connections(struct us_connecting_socket_t *c, int count) {
     int opened = 0;
-    for (; c->addrinfo_head != NULL && opened < count; c->addrinfo_head = c->addrinfo_head->ai_next) {
+    for (; c->addrinfo_next < c->addrinfo_count && opened < count; c->addrinfo_next++) {
         struct sockaddr_storage addr;
-        init_addr_with_port(c->addrinfo_head, c->port, &addr);
+        init_addr_with_port(c->addrinfo_order[c->addrinfo_next], c->port, &addr);
         LIBUS_SOCKET_DESCRIPTOR connect_socket_fd = bsd_create_connect_socket(&addr, c->options);
         if (connect_socket_fd == LIBUS_SOCKET_ERROR) {
             continue;
@@ -488,7 +881,7 @@ int start_connections(struct us_connecting_socket_t *c, int count) {
         ++opened;
         bsd_socket_nodelay(connect_socket_fd, 1);
 
-        struct us_socket_t *s = (struct us_socket_t *)us_create_poll(c->context->loop, 0, sizeof(struct us_socket_t) + c->socket_ext_size);
+        struct us_socket_t *s = (struct us_socket_t *)us_internal_create_socket_poll(c->context->loop, sizeof(struct us_socket_t) + c->socket_ext_size);
         s->context = c->context;
         s->timeout = c->timeout;
         s->long_timeout = c->long_timeout;
@@ -514,6 +907,53 @@ int start_connections(struct us_connecting_socket_t *c, int count) {
     return opened;
 }
 
+static void fail_connecting_socket(struct us_connecting_socket_t *c, int error) {
+    c->error = ECONNREFUSED;
+    c->context->on_connect_error(c, error);
+    Bun__addrinfo_freeRequest(c->addrinfo_req, ECONNREFUSED);
+    us_connecting_socket_close(0, c);
+}
+
+static void schedule_next_attempt(struct us_connecting_socket_t *c);
+
+static void attempt_timer_cb(struct us_timer_t *t) {
+    struct us_connecting_socket_t *c = *(struct us_connecting_socket_t **) us_timer_ext(t);
+    if (start_connections(c, 1) == 0 && c->connecting_head == NULL) {
+        fail_connecting_socket(c, ECONNREFUSED);
+        return;
+    }
+    schedule_next_attempt(c);
+}
+
+/* Arms the attempt timer while there are addresses left to try. It is never
+ * disarmed, as kqueue would fire a zero timer right away; once every address
+ * was tried, firing it starts nothing */
+static void schedule_next_attempt(struct us_connecting_socket_t *c) {
+    if (c->addrinfo_next >= c->addrinfo_count) {
+        return;
+    }
+
+    if (!c->attempt_timer) {
+        /* The sockets it starts keep the loop alive, the timer need not */
+        c->attempt_timer = us_create_timer(c->context->loop, 1, sizeof(struct us_connecting_socket_t *));
+        *(struct us_connecting_socket_t **) us_timer_ext(c->attempt_timer) = c;
+    }
+    us_timer_set(c->attempt_timer, attempt_timer_cb, CONNECTION_ATTEMPT_DELAY_MS, 0);
+}
+
+void us_internal_connecting_socket_release_attempts(struct us_connecting_socket_t *c) {
+    if (c->attempt_timer) {
+        us_timer_close(c->attempt_timer, 1);
+        c->attempt_timer = NULL;
+    }
+    if (c->addrinfo_order) {
+        us_free(c->addrinfo_order);
+        c->addrinfo_order = NULL;
+    }
+    c->addrinfo_count = 0;
+    c->addrinfo_next = 0;
+}
+
 void us_internal_socket_after_resolve(struct us_connecting_socket_t *c) {
     // make sure to decrement the active_handles counter, no matter what
 #ifdef _WIN32
@@ -537,9 +977,15 @@ void us_internal_socket_after_resolve(struct us_connecting_socket_t *c) {
         return;
     }
 
-    c->addrinfo_head = &result->entries->info;
+    /* Happy Eyeballs (RFC 8305): one attempt at a time, the next starting
+     * when one fails or after CONNECTION_ATTEMPT_DELAY_MS, whichever is first.
+     * An address that never answers, like a dead AAAA record, then costs 250ms
+     * instead of a connect timeout */
+    if (result->entries) {
+        order_addresses(c, &result->entries->info);
+    }
 
-    int opened = start_connections(c, CONCURRENT_CONNECTIONS);
+    int opened = start_connections(c, 1);
     if (opened == 0) {
         c->error = ECONNREFUSED;
         c->context->on_connect_error(c, ECONNREFUSED);
@@ -547,6 +993,7 @@ void us_internal_socket_after_resolve(struct us_connecting_socket_t *c) {
         us_connecting_socket_close(0, c);
         return;
     }
+    schedule_next_attempt(c);
 }
 
 void us_internal_socket_after_open(struct us_socket_t *s, int error) {
@@ -599,24 +1046,14 @@ void us_internal_socket_after_open(struct us_socket_t *s, int error) {
             }
             us_socket_close(0, s, LIBUS_SOCKET_CLOSE_CODE_CONNECTION_RESET, 0);
 
-            // Since CONCURRENT_CONNECTIONS is 2, we know there is room for at least 1 more active connection
-            // now that we've closed the current socket.
-            //
-            // Three possible cases:
-            // 1. The list of addresses to try is now empty -> throw an error
-            // 2. There is a next address to try -> start the next one
-            // 3. There are 2 or more addresses to try -> start the next two.
-            if (c->connecting_head == NULL || c->connecting_head->connect_next == NULL) {
-                // start opening the next batch of connections
-                int opened = start_connections(c, c->connecting_head == NULL ? CONCURRENT_CONNECTIONS : 1);
-                // we have run out of addresses to attempt, signal the connection error
-                // but only if there are no other sockets in the list
-                if (opened == 0 && c->connecting_head == NULL) {
-                    c->error = ECONNREFUSED;
-                    c->context->on_connect_error(c, error);
-                    Bun__addrinfo_freeRequest(c->addrinfo_req, ECONNREFUSED);
-                    us_connecting_socket_close(0, c);
-                }
+            // A failed attempt starts the next one right away, and restarts the delay
+            // for the one after. We have run out of addresses once nothing could be
+            // started and no other attempt is still in flight.
+            int opened = start_connections(c, 1);
+            if (opened == 0 && c->connecting_head == NULL) {
+                fail_connecting_socket(c, error);
+            } else {
+                schedule_next_attempt(c);
             }
         } else {
             s->context->on_socket_connect_error(s, error);
@@ -665,7 +1102,7 @@ struct us_socket_t *us_socket_context_connect_unix(int ssl, struct us_socket_con
     }
 
     /* Connect sockets are semi-sockets just like listen sockets */
-    struct us_poll_t *p = us_create_poll(context->loop, 0, sizeof(struct us_socket_t) + socket_ext_size);
+    struct us_poll_t *p = us_internal_create_socket_poll(context->loop, sizeof(struct us_socket_t) + socket_ext_size);
     us_poll_init(p, connect_socket_fd, POLL_TYPE_SEMI_SOCKET);
     us_poll_start(p, context->loop, LIBUS_SOCKET_WRITABLE);
 
@@ -683,15 +1120,24 @@ struct us_socket_t *us_socket_context_connect_unix(int ssl, struct us_socket_con
 }
 
 struct us_socket_context_t *us_create_child_socket_context(int ssl, struct us_socket_context_t *context, int context_ext_size) {
+    struct us_socket_context_t *child_context;
 #ifndef LIBUS_NO_SSL
     if (ssl) {
-        return (struct us_socket_context_t *) us_internal_create_child_ssl_socket_context((struct us_internal_ssl_socket_context_t *) context, context_ext_size);
-    }
+        child_context = (struct us_socket_context_t *) us_internal_create_child_ssl_socket_context((struct us_internal_ssl_socket_context_t *) context, context_ext_size);
+    } else
 #endif
+    {
+        /* For TCP we simply create a new context as nothing is shared */
+        struct us_socket_context_options_t options = {0};
+        child_context = us_create_socket_context(ssl, context->loop, context_ext_size, options);
+    }
 
-    /* For TCP we simply create a new context as nothing is shared */
-    struct us_socket_context_options_t options = {0};
-    return us_create_socket_context(ssl, context->loop, context_ext_size, options);
+    /* Adopted sockets keep their timeout mode */
+    if (child_context && context->timer_wheel) {
+        us_socket_context_enable_timer_wheel(ssl, child_context);
+    }
+
+    return child_context;
 }
 
 /* Note: This will set timeout to 0 */
@@ -707,6 +1153,10 @@ struct us_socket_t *us_socket_context_adopt_socket(int ssl, struct us_socket_con
         return s;
     }
 
+    if (s->pool_state) {
+        us_internal_socket_pool_remove(s);
+    }
+
     if (s->low_prio_state != 1) {
         /* This properly updates the iterator if in on_timeout */
         us_internal_socket_context_unlink_socket(s->context, s);
@@ -717,7 +1167,7 @@ struct us_socket_t *us_socket_context_adopt_socket(int ssl, struct us_socket_con
 
     struct us_socket_t *new_s = s;
     if (ext_size != -1) {
-        new_s = (struct us_socket_t *) us_poll_resize(&s->p, s->context->loop, sizeof(struct us_socket_t) + ext_size);
+        new_s = (struct us_socket_t *) us_internal_resize_socket_poll(&s->p, s->context->loop, sizeof(struct us_socket_t) + ext_size);
         if (c) {
             c->connecting_head = new_s;
             c->context = context;
@@ -817,6 +1267,12 @@ void us_socket_context_on_end(int ssl, struct us_socket_context_t *context, stru
     context->on_end = on_end;
 }
 
+void us_socket_context_on_batch(int ssl, struct us_socket_context_t *context, void (*on_batch_begin)(struct us_socket_context_t *), void (*on_batch_end)(struct us_socket_context_t *)) {
+    /* SSL contexts embed the plain context first and the batch wraps their on_data the same way */
+    context->on_batch_begin = on_batch_begin;
+    context->on_batch_end = on_batch_end;
+}
+
 void us_socket_context_on_connect_error(int ssl, struct us_socket_context_t *context, struct us_connecting_socket_t *(*on_connect_error)(struct us_connecting_socket_t *s, int code)) {
 #ifndef LIBUS_NO_SSL
     if (ssl) {
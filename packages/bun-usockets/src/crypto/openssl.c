@@ -21,6 +21,7 @@ void *sni_new();
 void sni_free(void *sni, void (*cb)(void *));
 int sni_add(void *sni, const char *hostname, void *user);
 void *sni_remove(void *sni, const char *hostname);
+void *sni_replace(void *sni, const char *hostname, void *user);
 void *sni_find(void *sni, const char *hostname);
 
 #include "internal/internal.h"
@@ -33,6 +34,8 @@ void *sni_find(void *sni, const char *hostname);
 #include <openssl/bio.h>
 #include <openssl/dh.h>
 #include <openssl/err.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #elif LIBUS_USE_WOLFSSL
 #include <wolfssl/openssl/bio.h>
@@ -44,8 +47,43 @@ void *sni_find(void *sni, const char *hostname);
 
 #include "./root_certs.h"
 
+/* Private key operations of handshakes can run on a thread pool through
+ * BoringSSL's private key method */
+#if defined(LIBUS_USE_BORINGSSL) && !defined(_WIN32)
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <pthread.h>
+#include <unistd.h>
+#define LIBUS_HAS_ASYNC_HANDSHAKE 1
+
+/* Workers of the shared pool are started on first use */
+#define LIBUS_ASYNC_HANDSHAKE_MAX_THREADS 8
+
+struct us_internal_ssl_key_op_t;
+#endif
+
+/* Largest serialized session we pass to and from external session stores */
+#define LIBUS_SSL_SESSION_MAX_LENGTH 8192
+
+/* Kernel TLS needs the raw session keys, which only BoringSSL lets us export */
+#if defined(LIBUS_USE_BORINGSSL) && defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#define LIBUS_HAS_KTLS 1
+#endif
+
 /* These are in root_certs.cpp */
 extern X509_STORE *us_get_default_ca_store();
+extern X509_STORE *us_get_shared_default_ca_store();
+extern int us_verify_cert_chain_cached(X509_STORE_CTX *ctx, void *arg);
 
 struct loop_ssl_data {
   char *ssl_read_input, *ssl_read_output;
@@ -60,6 +98,17 @@ struct loop_ssl_data {
   BIO *shared_rbio;
   BIO *shared_wbio;
   BIO_METHOD *shared_biom;
+
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+  /* Finished private key operations, pushed by workers under loop->data.mutex */
+  struct us_internal_ssl_key_op_t *key_ops_done;
+#endif
+};
+
+struct us_internal_ssl_client_session_t {
+  struct us_internal_ssl_client_session_t *prev, *next;
+  SSL_SESSION *session;
+  char server_name[];
 };
 
 struct us_internal_ssl_socket_context_t {
@@ -71,6 +120,25 @@ struct us_internal_ssl_socket_context_t {
   // socket context
   SSL_CTX *ssl_context;
   int is_parent;
+  /* Set by us_socket_context_enable_ktls */
+  int enable_ktls;
+
+  /* External session id cache and ticket keys, shared with SSL through ex data */
+  struct us_ssl_session_store_t session_store;
+  int has_session_store;
+  struct us_ssl_ticket_key_ring_t *ticket_key_ring;
+  struct us_ssl_session_stats_t session_stats;
+
+  /* Sessions of this client context by server name, most recently issued
+   * first. Capped at client_session_max, 0 unless
+   * us_socket_context_enable_client_session_cache was called */
+  struct us_internal_ssl_client_session_t *client_sessions;
+  struct us_internal_ssl_client_session_t *client_sessions_tail;
+  unsigned int client_session_count;
+  unsigned int client_session_max;
+
+  /* Set by us_socket_context_enable_async_handshake */
+  int async_handshake;
 #if ALLOW_SERVER_RENEGOTIATION
   unsigned int client_renegotiation_limit;
   unsigned int client_renegotiation_window;
@@ -117,6 +185,8 @@ struct us_internal_ssl_socket_t {
   unsigned int ssl_read_wants_write : 1;
   unsigned int handshake_state : 2;
   unsigned int received_ssl_shutdown : 1;
+  /* The kernel encrypts everything we write, SSL_write must not be used anymore */
+  unsigned int ktls_tx : 1;
 };
 
 int passphrase_cb(char *buf, int size, int rwflag, void *u) {
@@ -182,6 +252,286 @@ int BIO_s_custom_read(BIO *bio, char *dst, int length) {
   return length;
 }
 
+/* Lazily allocated indices under which SSLs and SSL_CTXs point to their
+ * socket context (index 0 of SSL_CTX is taken by SNI user data) */
+static int us_internal_ssl_ex_data_index() {
+  static int index = -1;
+  if (index == -1) {
+    index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+  }
+  return index;
+}
+
+static int us_internal_ssl_ctx_ex_data_index() {
+  static int index = -1;
+  if (index == -1) {
+    index = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+  }
+  return index;
+}
+
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+struct us_internal_ssl_key_op_t {
+  struct us_internal_ssl_key_op_t *next;
+  struct us_loop_t *loop;
+  /* Null once the socket closed or took the result, only touched on the loop */
+  struct us_internal_ssl_socket_t *socket;
+
+  EVP_PKEY *key;
+  uint16_t signature_algorithm;
+  int is_decrypt;
+  uint8_t *in;
+  size_t in_length;
+
+  /* Written by the worker before it hands the operation back */
+  int finished;
+  int success;
+  size_t out_length;
+  uint8_t out[];
+};
+
+static struct {
+  pthread_once_t once;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct us_internal_ssl_key_op_t *head, *tail;
+} us_internal_ssl_key_op_pool = {PTHREAD_ONCE_INIT, PTHREAD_MUTEX_INITIALIZER,
+                                 PTHREAD_COND_INITIALIZER, NULL, NULL};
+
+static int us_internal_ssl_key_op_ex_data_index() {
+  static int index = -1;
+  if (index == -1) {
+    index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+  }
+  return index;
+}
+
+static void us_internal_ssl_run_key_op(struct us_internal_ssl_key_op_t *op) {
+  size_t max_out = (size_t)EVP_PKEY_size(op->key);
+
+  if (op->is_decrypt) {
+    // BoringSSL wants the raw RSA operation and checks the padding itself
+    RSA *rsa = EVP_PKEY_get0_RSA(op->key);
+    op->success = rsa && RSA_decrypt(rsa, &op->out_length, op->out, max_out,
+                                     op->in, op->in_length, RSA_NO_PADDING);
+    return;
+  }
+
+  EVP_MD_CTX md_context;
+  EVP_MD_CTX_init(&md_context);
+  EVP_PKEY_CTX *pkey_context;
+  const EVP_MD *md = SSL_get_signature_algorithm_digest(op->signature_algorithm);
+  op->out_length = max_out;
+  op->success =
+      EVP_DigestSignInit(&md_context, &pkey_context, md, NULL, op->key) &&
+      (!SSL_is_signature_algorithm_rsa_pss(op->signature_algorithm) ||
+       (EVP_PKEY_CTX_set_rsa_padding(pkey_context, RSA_PKCS1_PSS_PADDING) &&
+        EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_context, -1))) &&
+      EVP_DigestSign(&md_context, op->out, &op->out_length, op->in,
+                     op->in_length);
+  EVP_MD_CTX_cleanup(&md_context);
+}
+
+static void *us_internal_ssl_key_op_worker(void *arg) {
+  for (;;) {
+    pthread_mutex_lock(&us_internal_ssl_key_op_pool.mutex);
+    while (!us_internal_ssl_key_op_pool.head) {
+      pthread_cond_wait(&us_internal_ssl_key_op_pool.cond,
+                        &us_internal_ssl_key_op_pool.mutex);
+    }
+    struct us_internal_ssl_key_op_t *op = us_internal_ssl_key_op_pool.head;
+    us_internal_ssl_key_op_pool.head = op->next;
+    if (!us_internal_ssl_key_op_pool.head) {
+      us_internal_ssl_key_op_pool.tail = NULL;
+    }
+    pthread_mutex_unlock(&us_internal_ssl_key_op_pool.mutex);
+
+    us_internal_ssl_run_key_op(op);
+    ERR_clear_error();
+
+    // hand it back, the loop owns it from here on
+    struct us_loop_t *loop = op->loop;
+    struct loop_ssl_data *loop_ssl_data =
+        (struct loop_ssl_data *)loop->data.ssl_data;
+    Bun__lock(&loop->data.mutex);
+    __atomic_store_n(&op->finished, 1, __ATOMIC_RELEASE);
+    op->next = loop_ssl_data->key_ops_done;
+    loop_ssl_data->key_ops_done = op;
+    Bun__unlock(&loop->data.mutex);
+    us_wakeup_loop(loop);
+  }
+  return NULL;
+}
+
+static void us_internal_ssl_start_key_op_pool() {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  // leave a core to the loop
+  int threads = cpus > 2 ? (int)cpus - 1 : 1;
+  if (threads > LIBUS_ASYNC_HANDSHAKE_MAX_THREADS) {
+    threads = LIBUS_ASYNC_HANDSHAKE_MAX_THREADS;
+  }
+
+  for (int i = 0; i < threads; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, us_internal_ssl_key_op_worker, NULL) == 0) {
+      pthread_detach(thread);
+    }
+  }
+}
+
+// moves a pending operation to a socket that was reallocated, or detaches it
+// from a socket that is closing
+static void us_internal_ssl_detach_key_op(struct us_internal_ssl_socket_t *s,
+                                          struct us_internal_ssl_socket_t *new_s) {
+  struct us_internal_ssl_key_op_t *op =
+      SSL_get_ex_data(s->ssl, us_internal_ssl_key_op_ex_data_index());
+  if (op) {
+    op->socket = new_s;
+    if (!new_s) {
+      SSL_set_ex_data(s->ssl, us_internal_ssl_key_op_ex_data_index(), NULL);
+    }
+  }
+}
+
+static enum ssl_private_key_result_t
+us_internal_ssl_submit_key_op(SSL *ssl, uint16_t signature_algorithm,
+                              int is_decrypt, const uint8_t *in,
+                              size_t in_length) {
+  struct us_internal_ssl_socket_context_t *context =
+      SSL_get_ex_data(ssl, us_internal_ssl_ex_data_index());
+  EVP_PKEY *key = SSL_get_privatekey(ssl);
+  if (!context || !key) {
+    return ssl_private_key_failure;
+  }
+
+  struct us_loop_t *loop = us_socket_context_loop(0, &context->sc);
+  struct loop_ssl_data *loop_ssl_data =
+      (struct loop_ssl_data *)loop->data.ssl_data;
+
+  struct us_internal_ssl_key_op_t *op = us_malloc(
+      sizeof(struct us_internal_ssl_key_op_t) + EVP_PKEY_size(key) + in_length);
+  if (!op) {
+    return ssl_private_key_failure;
+  }
+  op->next = NULL;
+  op->loop = loop;
+  // every SSL call is made with the current socket set
+  op->socket = (struct us_internal_ssl_socket_t *)loop_ssl_data->ssl_socket;
+  op->key = key;
+  EVP_PKEY_up_ref(key);
+  op->signature_algorithm = signature_algorithm;
+  op->is_decrypt = is_decrypt;
+  op->in = op->out + EVP_PKEY_size(key);
+  memcpy(op->in, in, in_length);
+  op->in_length = in_length;
+  op->finished = 0;
+  op->success = 0;
+  op->out_length = 0;
+  SSL_set_ex_data(ssl, us_internal_ssl_key_op_ex_data_index(), op);
+
+  pthread_mutex_lock(&us_internal_ssl_key_op_pool.mutex);
+  if (us_internal_ssl_key_op_pool.tail) {
+    us_internal_ssl_key_op_pool.tail->next = op;
+  } else {
+    us_internal_ssl_key_op_pool.head = op;
+  }
+  us_internal_ssl_key_op_pool.tail = op;
+  pthread_cond_signal(&us_internal_ssl_key_op_pool.cond);
+  pthread_mutex_unlock(&us_internal_ssl_key_op_pool.mutex);
+
+  return ssl_private_key_retry;
+}
+
+static enum ssl_private_key_result_t
+us_internal_ssl_key_op_sign(SSL *ssl, uint8_t *out, size_t *out_len,
+                            size_t max_out, uint16_t signature_algorithm,
+                            const uint8_t *in, size_t in_len) {
+  return us_internal_ssl_submit_key_op(ssl, signature_algorithm, 0, in, in_len);
+}
+
+static enum ssl_private_key_result_t
+us_internal_ssl_key_op_decrypt(SSL *ssl, uint8_t *out, size_t *out_len,
+                               size_t max_out, const uint8_t *in,
+                               size_t in_len) {
+  return us_internal_ssl_submit_key_op(ssl, 0, 1, in, in_len);
+}
+
+static enum ssl_private_key_result_t
+us_internal_ssl_key_op_complete(SSL *ssl, uint8_t *out, size_t *out_len,
+                                size_t max_out) {
+  struct us_internal_ssl_key_op_t *op =
+      SSL_get_ex_data(ssl, us_internal_ssl_key_op_ex_data_index());
+  if (!op) {
+    return ssl_private_key_failure;
+  }
+  if (!__atomic_load_n(&op->finished, __ATOMIC_ACQUIRE)) {
+    return ssl_private_key_retry;
+  }
+
+  // the loop frees it when it gets to its completion
+  SSL_set_ex_data(ssl, us_internal_ssl_key_op_ex_data_index(), NULL);
+  op->socket = NULL;
+
+  if (!op->success || op->out_length > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, op->out, op->out_length);
+  *out_len = op->out_length;
+  return ssl_private_key_success;
+}
+
+static const SSL_PRIVATE_KEY_METHOD us_internal_ssl_key_method = {
+    us_internal_ssl_key_op_sign,
+    us_internal_ssl_key_op_decrypt,
+    us_internal_ssl_key_op_complete,
+};
+
+/* Resumes handshakes whose private key operation finished */
+void us_internal_ssl_handle_key_ops(struct us_loop_t *loop) {
+  struct loop_ssl_data *loop_ssl_data =
+      (struct loop_ssl_data *)loop->data.ssl_data;
+  if (!loop_ssl_data || !__atomic_load_n(&loop_ssl_data->key_ops_done, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+
+  Bun__lock(&loop->data.mutex);
+  struct us_internal_ssl_key_op_t *op = loop_ssl_data->key_ops_done;
+  loop_ssl_data->key_ops_done = NULL;
+  Bun__unlock(&loop->data.mutex);
+
+  while (op) {
+    struct us_internal_ssl_key_op_t *next = op->next;
+    struct us_internal_ssl_socket_t *s = op->socket;
+    if (s && !us_socket_is_closed(0, &s->s)) {
+      // both take the result through the complete callback
+      if (s->handshake_state == HANDSHAKE_PENDING) {
+        us_internal_update_handshake(s);
+      } else {
+        // renegotiations are driven by SSL_read
+        struct us_internal_ssl_socket_context_t *context =
+            (struct us_internal_ssl_socket_context_t *)us_socket_context(
+                0, &s->s);
+        context->sc.on_data(&s->s, 0, 0);
+      }
+    }
+    EVP_PKEY_free(op->key);
+    us_free(op);
+    op = next;
+  }
+}
+
+static int ssl_is_low_prio_async(struct us_internal_ssl_socket_t *s) {
+  // the expensive part of the handshake does not run on the loop
+  return 0;
+}
+#else
+void us_internal_ssl_handle_key_ops(struct us_loop_t *loop) {}
+#endif
+
+static void
+us_internal_ssl_resume_client_session(struct us_internal_ssl_socket_context_t *context,
+                                      SSL *ssl);
+
 struct us_internal_ssl_socket_t *ssl_on_open(struct us_internal_ssl_socket_t *s,
                                              int is_client, char *ip,
                                              int ip_length) {
@@ -204,6 +554,13 @@ struct us_internal_ssl_socket_t *ssl_on_open(struct us_internal_ssl_socket_t *s,
   s->ssl_read_wants_write = 0;
   s->handshake_state = HANDSHAKE_PENDING;
   s->received_ssl_shutdown = 0;
+  s->ktls_tx = 0;
+
+  // session and private key callbacks only get to see the SSL
+  if (context->has_session_store || context->ticket_key_ring ||
+      context->async_handshake || context->client_session_max) {
+    SSL_set_ex_data(s->ssl, us_internal_ssl_ex_data_index(), context);
+  }
 
   SSL_set_bio(s->ssl, loop_ssl_data->shared_rbio, loop_ssl_data->shared_wbio);
 // if we allow renegotiation, we need to set the mode here
@@ -237,6 +594,13 @@ struct us_internal_ssl_socket_t *ssl_on_open(struct us_internal_ssl_socket_t *s,
       (struct us_internal_ssl_socket_t *)context->on_open(s, is_client, ip,
                                                           ip_length);
 
+  // on_open is where the server name is set, so only now do we know which
+  // session to offer
+  if (is_client && context->client_session_max &&
+      !us_socket_is_closed(0, &s->s)) {
+    us_internal_ssl_resume_client_session(context, s->ssl);
+  }
+
   // Hello Message!
   // always handshake after open
   // this is important because some servers/clients can get stuck waiting for
@@ -281,6 +645,14 @@ void us_internal_trigger_handshake_callback(struct us_internal_ssl_socket_t *s,
   // always set the handshake state to completed
   s->handshake_state = HANDSHAKE_COMPLETED;
 
+  if (s->ssl && SSL_is_init_finished(s->ssl)) {
+    if (SSL_session_reused(s->ssl)) {
+      context->session_stats.hits++;
+    } else {
+      context->session_stats.misses++;
+    }
+  }
+
   if (context->on_handshake != NULL) {
     struct us_bun_verify_error_t verify_error = us_internal_verify_error(s);
     context->on_handshake(s, success, verify_error, context->handshake_data);
@@ -289,6 +661,12 @@ void us_internal_trigger_handshake_callback(struct us_internal_ssl_socket_t *s,
 int us_internal_ssl_renegotiate(struct us_internal_ssl_socket_t *s) {
   // handle renegotation here since we are using ssl_renegotiate_explicit
 
+  // the kernel owns our write keys and sequence, a new handshake cannot be
+  // written through SSL anymore
+  if (s->ktls_tx) {
+    return 0;
+  }
+
   // if is a server and we have no pending renegotiation we can check
   // the limits
   s->handshake_state = HANDSHAKE_RENEGOTIATION_PENDING;
@@ -320,6 +698,143 @@ int us_internal_ssl_renegotiate(struct us_internal_ssl_socket_t *s) {
   return 1;
 }
 
+#ifdef LIBUS_HAS_KTLS
+// hands the write direction of an established session over to the kernel.
+// only TLS 1.2 AEAD ciphers are supported since BoringSSL does not export
+// TLS 1.3 traffic secrets, reading stays with SSL_read so alerts and
+// everything else the peer sends is still handled here
+static int us_internal_ssl_socket_enable_ktls_tx(struct us_internal_ssl_socket_t *s) {
+  SSL *ssl = s->ssl;
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    return 0;
+  }
+
+  const SSL_CIPHER *cipher = SSL_get_current_cipher(ssl);
+  if (!cipher) {
+    return 0;
+  }
+
+  size_t key_length, iv_length;
+  unsigned short cipher_type;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_length = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+    iv_length = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+    cipher_type = TLS_CIPHER_AES_GCM_128;
+    break;
+  case NID_aes_256_gcm:
+    key_length = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+    iv_length = TLS_CIPHER_AES_GCM_256_SALT_SIZE;
+    cipher_type = TLS_CIPHER_AES_GCM_256;
+    break;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  case NID_chacha20_poly1305:
+    key_length = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+    iv_length = TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE;
+    cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+    break;
+#endif
+  default:
+    return 0;
+  }
+
+  // AEAD key blocks have no MAC keys: client key, server key, client iv,
+  // server iv
+  uint8_t key_block[2 * (32 + 12)];
+  size_t key_block_length = SSL_get_key_block_len(ssl);
+  if (key_block_length != 2 * (key_length + iv_length) ||
+      !SSL_generate_key_block(ssl, key_block, key_block_length)) {
+    return 0;
+  }
+
+  int is_server = SSL_is_server(ssl);
+  const uint8_t *key = key_block + (is_server ? key_length : 0);
+  const uint8_t *iv = key_block + 2 * key_length + (is_server ? iv_length : 0);
+
+  // BoringSSL uses the sequence number as explicit nonce, and so does the
+  // kernel
+  uint8_t rec_seq[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE];
+  uint64_t sequence = SSL_get_write_sequence(ssl);
+  for (int i = sizeof(rec_seq) - 1; i >= 0; i--) {
+    rec_seq[i] = (uint8_t)sequence;
+    sequence >>= 8;
+  }
+
+  union {
+    struct tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+    struct tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    struct tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+  } crypto_info;
+  socklen_t crypto_info_length;
+  memset(&crypto_info, 0, sizeof(crypto_info));
+
+  switch (cipher_type) {
+  case TLS_CIPHER_AES_GCM_128:
+    crypto_info_length = sizeof(crypto_info.aes_gcm_128);
+    memcpy(crypto_info.aes_gcm_128.key, key, key_length);
+    memcpy(crypto_info.aes_gcm_128.salt, iv, iv_length);
+    memcpy(crypto_info.aes_gcm_128.iv, rec_seq, sizeof(rec_seq));
+    memcpy(crypto_info.aes_gcm_128.rec_seq, rec_seq, sizeof(rec_seq));
+    break;
+  case TLS_CIPHER_AES_GCM_256:
+    crypto_info_length = sizeof(crypto_info.aes_gcm_256);
+    memcpy(crypto_info.aes_gcm_256.key, key, key_length);
+    memcpy(crypto_info.aes_gcm_256.salt, iv, iv_length);
+    memcpy(crypto_info.aes_gcm_256.iv, rec_seq, sizeof(rec_seq));
+    memcpy(crypto_info.aes_gcm_256.rec_seq, rec_seq, sizeof(rec_seq));
+    break;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  default:
+    // the whole 12 byte nonce is derived from the key block here
+    crypto_info_length = sizeof(crypto_info.chacha20_poly1305);
+    memcpy(crypto_info.chacha20_poly1305.key, key, key_length);
+    memcpy(crypto_info.chacha20_poly1305.iv, iv, iv_length);
+    memcpy(crypto_info.chacha20_poly1305.rec_seq, rec_seq, sizeof(rec_seq));
+    break;
+#endif
+  }
+  // every variant starts with the same header
+  crypto_info.aes_gcm_128.info.version = TLS_1_2_VERSION;
+  crypto_info.aes_gcm_128.info.cipher_type = cipher_type;
+
+  int fd = us_poll_fd((struct us_poll_t *)s);
+  // the ULP does nothing on its own, so failing after attaching it is harmless
+  int ok = setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0 &&
+           setsockopt(fd, SOL_TLS, TLS_TX, &crypto_info, crypto_info_length) == 0;
+
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  return ok;
+}
+
+// sends close_notify as an alert record through the kernel
+static void us_internal_ssl_socket_ktls_shutdown(struct us_internal_ssl_socket_t *s) {
+  char alert[2] = {1 /* warning */, 0 /* close_notify */};
+  char control[CMSG_SPACE(sizeof(unsigned char))];
+  struct iovec iov = {.iov_base = alert, .iov_len = sizeof(alert)};
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  memset(control, 0, sizeof(control));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+  *CMSG_DATA(cmsg) = 21; // alert
+
+  sendmsg(us_poll_fd((struct us_poll_t *)s), &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+  // nothing else may be written through SSL from now on either way
+  SSL_set_shutdown(s->ssl, SSL_get_shutdown(s->ssl) | SSL_SENT_SHUTDOWN);
+}
+#endif
+
 void us_internal_update_handshake(struct us_internal_ssl_socket_t *s) {
   struct us_internal_ssl_socket_context_t *context =
       (struct us_internal_ssl_socket_context_t *)us_socket_context(0, &s->s);
@@ -354,6 +869,12 @@ void us_internal_update_handshake(struct us_internal_ssl_socket_t *s) {
 
   if (result <= 0) {
     int err = SSL_get_error(s->ssl, result);
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+    // a worker is signing for us, we continue once it is done
+    if (err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+      return;
+    }
+#endif
     // as far as I know these are the only errors we want to handle
     if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
       us_internal_trigger_handshake_callback(s, 1);
@@ -374,6 +895,13 @@ void us_internal_update_handshake(struct us_internal_ssl_socket_t *s) {
     return;
   }
   // success
+#ifdef LIBUS_HAS_KTLS
+  // the handshake flushed everything it wrote, so from here on the kernel can
+  // take over the write sequence
+  if (context->enable_ktls && !s->ktls_tx) {
+    s->ktls_tx = us_internal_ssl_socket_enable_ktls_tx(s);
+  }
+#endif
   us_internal_trigger_handshake_callback(s, 1);
   // Ensure that we'll cycle through internal openssl's state
   if (!us_socket_is_closed(0, &s->s) &&
@@ -387,6 +915,9 @@ ssl_on_close(struct us_internal_ssl_socket_t *s, int code, void *reason) {
   struct us_internal_ssl_socket_context_t *context =
       (struct us_internal_ssl_socket_context_t *)us_socket_context(0, &s->s);
 
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+  us_internal_ssl_detach_key_op(s, NULL);
+#endif
   SSL_free(s->ssl);
 
   return context->on_close(s, code, reason);
@@ -465,6 +996,13 @@ restart:
 
     if (just_read <= 0) {
       int err = SSL_get_error(s->ssl, just_read);
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+      // the handshake continues once the worker is done, until then this is
+      // no different from waiting for more data
+      if (err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+        err = SSL_ERROR_WANT_READ;
+      }
+#endif
       // as far as I know these are the only errors we want to handle
       if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
         if (err == SSL_ERROR_WANT_RENEGOTIATE) {
@@ -694,6 +1232,11 @@ us_internal_create_child_ssl_socket_context(
   /* The only thing we share is SSL_CTX */
   child_context->ssl_context = context->ssl_context;
   child_context->is_parent = 0;
+  child_context->enable_ktls = context->enable_ktls;
+  child_context->session_store = context->session_store;
+  child_context->has_session_store = context->has_session_store;
+  child_context->ticket_key_ring = context->ticket_key_ring;
+  child_context->async_handshake = context->async_handshake;
 
   return child_context;
 }
@@ -1184,7 +1727,11 @@ SSL_CTX *create_ssl_context_from_bun_options(
     }
   } else {
     if (options.request_cert) {
-      SSL_CTX_set_cert_store(ssl_context, us_get_default_ca_store());
+      /* Nothing is added to the store here, so it can be the shared one,
+       * along with the chains already verified against it */
+      SSL_CTX_set_cert_store(ssl_context, us_get_shared_default_ca_store());
+      SSL_CTX_set_cert_verify_callback(ssl_context, us_verify_cert_chain_cached,
+                                       NULL);
 
       if (options.reject_unauthorized) {
         SSL_CTX_set_verify(ssl_context,
@@ -1328,6 +1875,30 @@ void us_bun_internal_ssl_socket_context_add_server_name(
   }
 }
 
+int us_bun_internal_ssl_socket_context_replace_server_name(
+    struct us_internal_ssl_socket_context_t *context,
+    const char *hostname_pattern,
+    struct us_bun_socket_context_options_t options) {
+
+  SSL_CTX *ssl_context = create_ssl_context_from_bun_options(options);
+  if (!ssl_context) {
+    return 0;
+  }
+
+  SSL_CTX *previous = sni_replace(context->sni, hostname_pattern, ssl_context);
+  if (!previous) {
+    free_ssl_context(ssl_context);
+    return 0;
+  }
+
+  /* The name keeps its user data. Connections that already selected the
+   * previous SSL_CTX hold a reference to it and finish with the old
+   * certificate */
+  SSL_CTX_set_ex_data(ssl_context, 0, SSL_CTX_get_ex_data(previous, 0));
+  free_ssl_context(previous);
+  return 1;
+}
+
 void us_internal_ssl_socket_context_on_server_name(
     struct us_internal_ssl_socket_context_t *context,
     void (*cb)(struct us_internal_ssl_socket_context_t *,
@@ -1503,6 +2074,14 @@ void us_internal_ssl_socket_context_free(
     sni_free(context->sni, sni_hostname_destructor);
   }
 
+  struct us_internal_ssl_client_session_t *entry = context->client_sessions;
+  while (entry) {
+    struct us_internal_ssl_client_session_t *next = entry->next;
+    SSL_SESSION_free(entry->session);
+    us_free(entry);
+    entry = next;
+  }
+
   us_socket_context_free(0, &context->sc);
 }
 
@@ -1524,6 +2103,15 @@ struct us_listen_socket_t *us_internal_ssl_socket_context_listen_unix(
                                            socket_ext_size);
 }
 
+struct us_listen_socket_t *us_internal_ssl_socket_context_listen_fd(
+    struct us_internal_ssl_socket_context_t *context,
+    LIBUS_SOCKET_DESCRIPTOR fd, int socket_ext_size) {
+  return us_socket_context_listen_fd(0, &context->sc, fd,
+                                     sizeof(struct us_internal_ssl_socket_t) -
+                                         sizeof(struct us_socket_t) +
+                                         socket_ext_size);
+}
+
 // TODO does this need more changes?
 struct us_connecting_socket_t *us_internal_ssl_socket_context_connect(
     struct us_internal_ssl_socket_context_t *context, const char *host,
@@ -1638,7 +2226,313 @@ void *us_internal_ssl_socket_context_ext(
   return context + 1;
 }
 
+void us_internal_ssl_socket_context_enable_ktls(
+    struct us_internal_ssl_socket_context_t *context) {
+#ifdef LIBUS_HAS_KTLS
+  context->enable_ktls = 1;
+#endif
+}
+
+static void us_internal_ssl_unlink_client_session(
+    struct us_internal_ssl_socket_context_t *context,
+    struct us_internal_ssl_client_session_t *entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    context->client_sessions = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    context->client_sessions_tail = entry->prev;
+  }
+  context->client_session_count--;
+}
+
+static struct us_internal_ssl_client_session_t *
+us_internal_ssl_find_client_session(
+    struct us_internal_ssl_socket_context_t *context, const char *server_name) {
+  for (struct us_internal_ssl_client_session_t *entry =
+           context->client_sessions;
+       entry; entry = entry->next) {
+    if (!strcmp(entry->server_name, server_name)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// keeps the newest session per server name, taking over the reference SSL gave
+// us. Returns whether it did
+static int us_internal_ssl_put_client_session(
+    struct us_internal_ssl_socket_context_t *context, SSL *ssl,
+    SSL_SESSION *session) {
+  const char *server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  if (!server_name || !SSL_SESSION_is_resumable(session)) {
+    return 0;
+  }
+
+  struct us_internal_ssl_client_session_t *entry =
+      us_internal_ssl_find_client_session(context, server_name);
+  if (entry) {
+    us_internal_ssl_unlink_client_session(context, entry);
+    SSL_SESSION_free(entry->session);
+  } else {
+    if (context->client_session_count >= context->client_session_max) {
+      struct us_internal_ssl_client_session_t *oldest =
+          context->client_sessions_tail;
+      us_internal_ssl_unlink_client_session(context, oldest);
+      SSL_SESSION_free(oldest->session);
+      us_free(oldest);
+    }
+    size_t length = strlen(server_name);
+    entry = us_malloc(sizeof(struct us_internal_ssl_client_session_t) +
+                      length + 1);
+    memcpy(entry->server_name, server_name, length + 1);
+  }
+
+  entry->session = session;
+  entry->prev = NULL;
+  entry->next = context->client_sessions;
+  if (entry->next) {
+    entry->next->prev = entry;
+  } else {
+    context->client_sessions_tail = entry;
+  }
+  context->client_sessions = entry;
+  context->client_session_count++;
+  return 1;
+}
+
+static void
+us_internal_ssl_resume_client_session(struct us_internal_ssl_socket_context_t *context,
+                                      SSL *ssl) {
+  const char *server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  if (!server_name) {
+    return;
+  }
+
+  struct us_internal_ssl_client_session_t *entry =
+      us_internal_ssl_find_client_session(context, server_name);
+  if (!entry) {
+    return;
+  }
+
+  // TLS 1.3 tickets are meant to be used once, the server sends a fresh one
+  // on every connection and new_session_cb puts it back
+  us_internal_ssl_unlink_client_session(context, entry);
+  SSL_set_session(ssl, entry->session);
+  SSL_SESSION_free(entry->session);
+  us_free(entry);
+}
+
+static int us_internal_ssl_new_session_cb(SSL *ssl, SSL_SESSION *session) {
+  struct us_internal_ssl_socket_context_t *context =
+      SSL_get_ex_data(ssl, us_internal_ssl_ex_data_index());
+  if (!context) {
+    return 0;
+  }
+
+  if (!SSL_is_server(ssl)) {
+    return context->client_session_max
+               ? us_internal_ssl_put_client_session(context, ssl, session)
+               : 0;
+  }
+
+  if (!context->has_session_store) {
+    return 0;
+  }
+
+  unsigned int id_length;
+  const unsigned char *id = SSL_SESSION_get_id(session, &id_length);
+
+  int length = i2d_SSL_SESSION(session, NULL);
+  if (length <= 0 || length > LIBUS_SSL_SESSION_MAX_LENGTH) {
+    return 0;
+  }
+  unsigned char buffer[LIBUS_SSL_SESSION_MAX_LENGTH];
+  unsigned char *p = buffer;
+  i2d_SSL_SESSION(session, &p);
+
+  context->session_store.put(context->session_store.user, id, id_length,
+                             buffer, (unsigned int)length);
+
+  // we did not keep a reference
+  return 0;
+}
+
+static SSL_SESSION *us_internal_ssl_get_session_cb(SSL *ssl,
+                                                   const unsigned char *id,
+                                                   int id_length,
+                                                   int *copy) {
+  *copy = 0;
+  struct us_internal_ssl_socket_context_t *context =
+      SSL_get_ex_data(ssl, us_internal_ssl_ex_data_index());
+  if (!context || !context->has_session_store) {
+    return NULL;
+  }
+
+  unsigned char buffer[LIBUS_SSL_SESSION_MAX_LENGTH];
+  unsigned int length =
+      context->session_store.get(context->session_store.user, id,
+                                 (unsigned int)id_length, buffer, sizeof(buffer));
+  if (!length || length > sizeof(buffer)) {
+    return NULL;
+  }
+
+  const unsigned char *p = buffer;
+  return d2i_SSL_SESSION(NULL, &p, (long)length);
+}
+
+static void us_internal_ssl_remove_session_cb(SSL_CTX *ssl_context,
+                                              SSL_SESSION *session) {
+  // there is no SSL here, so we keep the context on the SSL_CTX instead
+  struct us_internal_ssl_socket_context_t *context =
+      SSL_CTX_get_ex_data(ssl_context, us_internal_ssl_ctx_ex_data_index());
+  if (!context || !context->has_session_store ||
+      !context->session_store.remove) {
+    return;
+  }
+
+  unsigned int id_length;
+  const unsigned char *id = SSL_SESSION_get_id(session, &id_length);
+  context->session_store.remove(context->session_store.user, id, id_length);
+}
+
+void us_internal_ssl_socket_context_set_session_store(
+    struct us_internal_ssl_socket_context_t *context,
+    const struct us_ssl_session_store_t *store) {
+  if (store) {
+    context->session_store = *store;
+    context->has_session_store = 1;
+
+    // the store is the cache, there is no point in also keeping sessions here
+    SSL_CTX_set_ex_data(context->ssl_context,
+                        us_internal_ssl_ctx_ex_data_index(), context);
+    SSL_CTX_set_session_cache_mode(context->ssl_context,
+                                   (context->client_session_max
+                                        ? SSL_SESS_CACHE_BOTH
+                                        : SSL_SESS_CACHE_SERVER) |
+                                       SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(context->ssl_context, us_internal_ssl_new_session_cb);
+    SSL_CTX_sess_set_get_cb(context->ssl_context, us_internal_ssl_get_session_cb);
+    SSL_CTX_sess_set_remove_cb(context->ssl_context,
+                               us_internal_ssl_remove_session_cb);
+  } else {
+    context->has_session_store = 0;
+    SSL_CTX_set_session_cache_mode(context->ssl_context,
+                                   context->client_session_max
+                                       ? SSL_SESS_CACHE_BOTH
+                                       : SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_new_cb(context->ssl_context,
+                            context->client_session_max
+                                ? us_internal_ssl_new_session_cb
+                                : NULL);
+    SSL_CTX_sess_set_get_cb(context->ssl_context, NULL);
+    SSL_CTX_sess_set_remove_cb(context->ssl_context, NULL);
+  }
+}
+
+void us_internal_ssl_socket_context_enable_client_session_cache(
+    struct us_internal_ssl_socket_context_t *context,
+    unsigned int max_sessions) {
+  if (!max_sessions || context->client_session_max) {
+    return;
+  }
+  context->client_session_max = max_sessions;
+
+  // clients only hand sessions to new_session_cb, they never look them up in
+  // the internal cache
+  SSL_CTX_set_session_cache_mode(
+      context->ssl_context,
+      SSL_SESS_CACHE_BOTH |
+          (context->has_session_store ? SSL_SESS_CACHE_NO_INTERNAL : 0));
+  SSL_CTX_sess_set_new_cb(context->ssl_context, us_internal_ssl_new_session_cb);
+}
+
+static int us_internal_ssl_ticket_key_cb(SSL *ssl, uint8_t *key_name,
+                                         uint8_t *iv,
+                                         EVP_CIPHER_CTX *cipher_context,
+                                         HMAC_CTX *hmac_context, int encrypt) {
+  struct us_internal_ssl_socket_context_t *context =
+      SSL_get_ex_data(ssl, us_internal_ssl_ex_data_index());
+  struct us_ssl_ticket_key_ring_t *ring =
+      context ? context->ticket_key_ring : NULL;
+  if (!ring || !ring->count || ring->count > LIBUS_SSL_TICKET_KEY_RING_SIZE) {
+    // no ticket for this one, or a full handshake
+    return encrypt ? -1 : 0;
+  }
+
+  // the ring may be rotated by another process at any time
+  unsigned int current =
+      __atomic_load_n(&ring->current, __ATOMIC_ACQUIRE) % ring->count;
+
+  if (encrypt) {
+    struct us_ssl_ticket_key_t *key = &ring->keys[current];
+    if (!RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_128_cbc()))) {
+      return -1;
+    }
+    memcpy(key_name, key->name, sizeof(key->name));
+    if (!EVP_EncryptInit_ex(cipher_context, EVP_aes_128_cbc(), NULL,
+                            key->aes_key, iv) ||
+        !HMAC_Init_ex(hmac_context, key->hmac_key, sizeof(key->hmac_key),
+                      EVP_sha256(), NULL)) {
+      return -1;
+    }
+    return 1;
+  }
+
+  for (unsigned int i = 0; i < ring->count; i++) {
+    struct us_ssl_ticket_key_t *key = &ring->keys[i];
+    if (memcmp(key_name, key->name, sizeof(key->name))) {
+      continue;
+    }
+
+    if (!HMAC_Init_ex(hmac_context, key->hmac_key, sizeof(key->hmac_key),
+                      EVP_sha256(), NULL) ||
+        !EVP_DecryptInit_ex(cipher_context, EVP_aes_128_cbc(), NULL,
+                            key->aes_key, iv)) {
+      return -1;
+    }
+
+    // accepted, but ask for the ticket to be renewed with the current key
+    return i == current ? 1 : 2;
+  }
+
+  return 0;
+}
+
+void us_internal_ssl_socket_context_set_ticket_key_ring(
+    struct us_internal_ssl_socket_context_t *context,
+    struct us_ssl_ticket_key_ring_t *ring) {
+  context->ticket_key_ring = ring;
+  SSL_CTX_set_tlsext_ticket_key_cb(context->ssl_context,
+                                   ring ? us_internal_ssl_ticket_key_cb : NULL);
+}
+
+void us_internal_ssl_socket_context_enable_async_handshake(
+    struct us_internal_ssl_socket_context_t *context) {
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+  pthread_once(&us_internal_ssl_key_op_pool.once,
+               us_internal_ssl_start_key_op_pool);
+  context->async_handshake = 1;
+  SSL_CTX_set_private_key_method(context->ssl_context,
+                                 &us_internal_ssl_key_method);
+  context->sc.is_low_prio = (int (*)(struct us_socket_t *))ssl_is_low_prio_async;
+#endif
+}
+
+void us_internal_ssl_socket_context_session_stats(
+    struct us_internal_ssl_socket_context_t *context,
+    struct us_ssl_session_stats_t *stats) {
+  *stats = context->session_stats;
+}
+
 /* Per socket functions */
+int us_internal_ssl_socket_is_ktls(struct us_internal_ssl_socket_t *s) {
+  return s->ktls_tx;
+}
+
 void *
 us_internal_ssl_socket_get_native_handle(struct us_internal_ssl_socket_t *s) {
   return s->ssl;
@@ -1661,6 +2555,11 @@ int us_internal_ssl_socket_write(struct us_internal_ssl_socket_t *s,
     return 0;
   }
 
+  // plain writes, the kernel encrypts them
+  if (s->ktls_tx) {
+    return us_socket_write(0, &s->s, data, length, msg_more);
+  }
+
   struct us_internal_ssl_socket_context_t *context =
       (struct us_internal_ssl_socket_context_t *)us_socket_context(0, &s->s);
 
@@ -1705,6 +2604,64 @@ int us_internal_ssl_socket_write(struct us_internal_ssl_socket_t *s,
   return 0;
 }
 
+int us_internal_ssl_socket_writev(struct us_internal_ssl_socket_t *s,
+                                  const struct us_iovec_t *iov, int iovcnt) {
+
+  if (us_socket_is_closed(0, &s->s) || us_internal_ssl_socket_is_shut_down(s)) {
+    return 0;
+  }
+
+  // the kernel encrypts, so this is a plain writev
+  if (s->ktls_tx) {
+    return us_socket_writev(0, &s->s, iov, iovcnt);
+  }
+
+  // small chunks are packed into the loop send buffer so that they go out as
+  // full records instead of one record (and header) each, larger chunks are
+  // written as they are
+  struct us_loop_t *loop = us_socket_context_loop(0, us_socket_context(0, &s->s));
+  char *staging = loop->data.send_buf;
+  int staged = 0;
+  int written = 0;
+
+  for (int i = 0; i < iovcnt; i++) {
+    int length = (int)iov[i].length;
+    if (staged + length <= LIBUS_SEND_BUFFER_LENGTH) {
+      memcpy(staging + staged, iov[i].data, length);
+      staged += length;
+      continue;
+    }
+
+    if (staged) {
+      int ret = us_internal_ssl_socket_write(s, staging, staged, 1);
+      written += ret;
+      if (ret < staged) {
+        return written;
+      }
+      staged = 0;
+    }
+
+    if (length < LIBUS_SEND_BUFFER_LENGTH) {
+      memcpy(staging, iov[i].data, length);
+      staged = length;
+      continue;
+    }
+
+    int ret = us_internal_ssl_socket_write(s, iov[i].data, length,
+                                           i + 1 < iovcnt);
+    written += ret;
+    if (ret < length) {
+      return written;
+    }
+  }
+
+  if (staged) {
+    written += us_internal_ssl_socket_write(s, staging, staged, 0);
+  }
+
+  return written;
+}
+
 void *us_internal_ssl_socket_ext(struct us_internal_ssl_socket_t *s) {
   return s + 1;
 }
@@ -1721,6 +2678,12 @@ int us_internal_ssl_socket_is_shut_down(struct us_internal_ssl_socket_t *s) {
 void us_internal_ssl_socket_shutdown(struct us_internal_ssl_socket_t *s) {
   if (!us_socket_is_closed(0, &s->s) &&
       !us_internal_ssl_socket_is_shut_down(s)) {
+#ifdef LIBUS_HAS_KTLS
+    if (s->ktls_tx) {
+      us_internal_ssl_socket_ktls_shutdown(s);
+      return;
+    }
+#endif
     struct us_internal_ssl_socket_context_t *context =
         (struct us_internal_ssl_socket_context_t *)us_socket_context(0, &s->s);
     struct us_loop_t *loop = us_socket_context_loop(0, &context->sc);
@@ -1769,9 +2732,16 @@ struct us_internal_ssl_socket_t *us_internal_ssl_socket_context_adopt_socket(
   if (ext_size != -1) {
     new_ext_size = sizeof(struct us_internal_ssl_socket_t) - sizeof(struct us_socket_t) + ext_size;
   }
-  return (struct us_internal_ssl_socket_t *)us_socket_context_adopt_socket(
-      0, &context->sc, &s->s,
-      new_ext_size);
+  struct us_internal_ssl_socket_t *new_s =
+      (struct us_internal_ssl_socket_t *)us_socket_context_adopt_socket(
+          0, &context->sc, &s->s, new_ext_size);
+#ifdef LIBUS_HAS_ASYNC_HANDSHAKE
+  // the socket may have moved while a worker is signing for it
+  if (new_s && new_s->ssl) {
+    us_internal_ssl_detach_key_op(new_s, new_s);
+  }
+#endif
+  return new_s;
 }
 
 struct us_internal_ssl_socket_t *
@@ -2045,6 +3015,7 @@ us_socket_context_on_socket_connect_error(
   socket->ssl_read_wants_write = 0;
   socket->handshake_state = HANDSHAKE_PENDING;
   socket->received_ssl_shutdown = 0;
+  socket->ktls_tx = 0;
   return socket;
 }
 
@@ -4,7 +4,15 @@
 #include "./root_certs.h"
 #include <openssl/x509.h>
 #include <openssl/pem.h>
+#include <openssl/sha.h>
 #include <atomic>
+#include <ctime>
+#include <list>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 static const int root_certs_size = sizeof(root_certs) / sizeof(root_certs[0]);
 static X509* root_cert_instances[sizeof(root_certs) / sizeof(root_certs[0])]  = {NULL};
@@ -46,6 +54,130 @@ end:
   return NULL;
 }
 
+// The roots are kept as PEM, and most processes never need more than the
+// one or two of them their connections chain up to. So the first time any
+// root is needed, each is only base64-decoded and indexed by the DER of
+// its subject, which takes a small part of the time parsing them all would.
+// A root is parsed when it is first asked for, from the DER.
+static std::once_flag root_cert_index_once;
+static std::string root_cert_ders[sizeof(root_certs) / sizeof(root_certs[0])];
+static std::unordered_multimap<std::string, size_t> root_certs_by_subject;
+static std::once_flag root_cert_instance_once[sizeof(root_certs) / sizeof(root_certs[0])];
+
+static int us_base64_value(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// The DER inside the first PEM block of content.
+static std::string us_pem_to_der(struct us_cert_string_t content) {
+    std::string pem(content.str, content.len);
+    size_t begin = pem.find("-----BEGIN CERTIFICATE-----");
+    size_t end = pem.find("-----END CERTIFICATE-----");
+    if (begin == std::string::npos || end == std::string::npos || end < begin) {
+        return std::string();
+    }
+    begin += sizeof("-----BEGIN CERTIFICATE-----") - 1;
+
+    std::string der;
+    der.reserve((end - begin) * 3 / 4);
+    unsigned int bits = 0;
+    int bit_count = 0;
+    for (size_t i = begin; i < end; i++) {
+        int value = us_base64_value(pem[i]);
+        if (value < 0) continue;
+        bits = (bits << 6) | value;
+        bit_count += 6;
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            der.push_back((char)((bits >> bit_count) & 0xff));
+        }
+    }
+    return der;
+}
+
+// Reads the DER element at *p, moving *p past it. contents and length are
+// what is inside of it.
+static bool us_der_next(const unsigned char **p, const unsigned char *end,
+                        unsigned char *tag, const unsigned char **contents,
+                        size_t *length) {
+    const unsigned char *at = *p;
+    if (end - at < 2) return false;
+    *tag = *at++;
+    size_t len = *at++;
+    if (len & 0x80) {
+        size_t bytes = len & 0x7f;
+        if (bytes == 0 || bytes > 3 || (size_t)(end - at) < bytes) return false;
+        len = 0;
+        while (bytes--) len = (len << 8) | *at++;
+    }
+    if ((size_t)(end - at) < len) return false;
+    *contents = at;
+    *length = len;
+    *p = at + len;
+    return true;
+}
+
+// The subject Name of a certificate, tag and length included, as
+// i2d_X509_NAME() would give the issuer of a certificate it issued.
+static std::string us_der_certificate_subject(const std::string &der) {
+    const unsigned char *p = (const unsigned char *)der.data();
+    const unsigned char *end = p + der.size();
+    const unsigned char *contents;
+    size_t length;
+    unsigned char tag;
+
+    // Certificate, then tbsCertificate
+    if (!us_der_next(&p, end, &tag, &contents, &length) || tag != 0x30) return std::string();
+    p = contents;
+    end = contents + length;
+    if (!us_der_next(&p, end, &tag, &contents, &length) || tag != 0x30) return std::string();
+    p = contents;
+    end = contents + length;
+
+    // [0] version, serialNumber, signature, issuer, validity, subject
+    const unsigned char *element = p;
+    if (!us_der_next(&p, end, &tag, &contents, &length)) return std::string();
+    if (tag == 0xa0) {
+        element = p;
+        if (!us_der_next(&p, end, &tag, &contents, &length)) return std::string();
+    }
+    for (int i = 0; i < 4; i++) {
+        element = p;
+        if (!us_der_next(&p, end, &tag, &contents, &length)) return std::string();
+    }
+    if (tag != 0x30) return std::string();
+    return std::string((const char *)element, p - element);
+}
+
+static void us_internal_index_root_certs() {
+    std::call_once(root_cert_index_once, [] {
+        for (size_t i = 0; i < root_certs_size; i++) {
+            root_cert_ders[i] = us_pem_to_der(root_certs[i]);
+            std::string subject = us_der_certificate_subject(root_cert_ders[i]);
+            if (!subject.empty()) {
+                root_certs_by_subject.emplace(std::move(subject), i);
+            }
+        }
+    });
+}
+
+static X509 *us_internal_root_cert(size_t i) {
+    us_internal_index_root_certs();
+    std::call_once(root_cert_instance_once[i], [i] {
+        const std::string &der = root_cert_ders[i];
+        const unsigned char *p = (const unsigned char *)der.data();
+        X509 *x = der.empty() ? NULL : d2i_X509(NULL, &p, der.size());
+        // Not the DER we thought it was: go the long way round.
+        root_cert_instances[i] = x ? x : us_ssl_ctx_get_X509_without_callback_from(root_certs[i]);
+    });
+    return root_cert_instances[i];
+}
+
 static void us_internal_init_root_certs() {
     if(std::atomic_load(&root_cert_instances_initialized) == 1) return;
 
@@ -53,7 +185,7 @@ static void us_internal_init_root_certs() {
 
     if(!atomic_exchange(&root_cert_instances_initialized, 1)) {
         for (size_t i = 0; i < root_certs_size; i++) {
-            root_cert_instances[i] = us_ssl_ctx_get_X509_without_callback_from(root_certs[i]);
+            us_internal_root_cert(i);
         }        
     }
 
@@ -87,4 +219,194 @@ extern "C" X509_STORE* us_get_default_ca_store() {
     }
     
     return store;
-}
\ No newline at end of file
+}
+// Contexts that trust only the default roots share one store, so the roots
+// are loaded into it once per process rather than once per SSL_CTX. Only the
+// bundled roots are ever added to it. Returns a new reference.
+static X509_STORE* shared_store = NULL;
+static std::once_flag shared_store_root_once[sizeof(root_certs) / sizeof(root_certs[0])];
+static std::once_flag shared_store_all_roots_once;
+static std::atomic_bool shared_store_has_all_roots = false;
+
+extern "C" X509_STORE* us_get_shared_default_ca_store() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        // The bundled roots go in as verification asks for them, see
+        // us_add_roots_for_chain().
+        shared_store = X509_STORE_new();
+        if (shared_store != NULL && !X509_STORE_set_default_paths(shared_store)) {
+            X509_STORE_free(shared_store);
+            shared_store = NULL;
+        }
+    });
+
+    if (shared_store == NULL || !X509_STORE_up_ref(shared_store)) {
+        return NULL;
+    }
+    return shared_store;
+}
+
+// Chains that verified against the shared default store, by a fingerprint
+// of the leaf and the certificates the peer sent with it. A client that
+// keeps connecting to the same hosts gets the same chains over and over,
+// and finding one here skips checking its signatures again. An entry lasts
+// until the first certificate in the chain expires, or an hour at most.
+#define US_VERIFIED_CHAIN_CACHE_SIZE 256
+#define US_VERIFIED_CHAIN_MAX_AGE (60 * 60)
+
+struct us_verified_chain_t {
+    std::string fingerprint;
+    time_t expires;
+};
+
+static std::mutex verified_chains_lock;
+static std::list<us_verified_chain_t> verified_chains;
+static std::unordered_map<std::string, std::list<us_verified_chain_t>::iterator> verified_chains_by_fingerprint;
+
+static bool us_chain_fingerprint(X509_STORE_CTX *ctx, std::string &out) {
+    SHA256_CTX sha;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+
+    SHA256_Init(&sha);
+    X509 *leaf = X509_STORE_CTX_get0_cert(ctx);
+    if (leaf == NULL || !X509_digest(leaf, EVP_sha256(), digest, &digest_length)) {
+        return false;
+    }
+    SHA256_Update(&sha, digest, digest_length);
+
+    STACK_OF(X509) *untrusted = X509_STORE_CTX_get0_untrusted(ctx);
+    for (size_t i = 0, count = untrusted ? sk_X509_num(untrusted) : 0; i < count; i++) {
+        if (!X509_digest(sk_X509_value(untrusted, i), EVP_sha256(), digest, &digest_length)) {
+            return false;
+        }
+        SHA256_Update(&sha, digest, digest_length);
+    }
+
+    unsigned char fingerprint[SHA256_DIGEST_LENGTH];
+    SHA256_Final(fingerprint, &sha);
+    out.assign(reinterpret_cast<const char *>(fingerprint), sizeof(fingerprint));
+    return true;
+}
+
+// When the verified chain stops being valid, capped at now + max_age.
+static time_t us_chain_expiry(X509_STORE_CTX *ctx, time_t now, time_t max_age) {
+    time_t expires = now + max_age;
+    STACK_OF(X509) *chain = X509_STORE_CTX_get0_chain(ctx);
+    for (size_t i = 0, count = chain ? sk_X509_num(chain) : 0; i < count; i++) {
+        int days = 0, seconds = 0;
+        if (!ASN1_TIME_diff(&days, &seconds, NULL, X509_get0_notAfter(sk_X509_value(chain, i)))) {
+            return now;
+        }
+        time_t left = (time_t)days * 24 * 60 * 60 + seconds;
+        if (now + left < expires) {
+            expires = now + left;
+        }
+    }
+    return expires;
+}
+
+static void us_add_shared_root(size_t i) {
+    std::call_once(shared_store_root_once[i], [i] {
+        X509 *cert = us_internal_root_cert(i);
+        if (cert != NULL) {
+            X509_STORE_add_cert(shared_store, cert);
+        }
+    });
+}
+
+static std::string us_name_der(X509_NAME *name) {
+    unsigned char *der = NULL;
+    int length = i2d_X509_NAME(name, &der);
+    if (length <= 0) return std::string();
+    std::string out((const char *)der, length);
+    OPENSSL_free(der);
+    return out;
+}
+
+// Adds the bundled roots that could issue a certificate of the chain being
+// verified to the shared store. Any issuer that is neither in the chain
+// nor a bundled root by the same name could still be one by an equivalent
+// name, so then all of them go in, as a store would have had them before.
+static void us_add_roots_for_chain(X509_STORE_CTX *ctx) {
+    if (shared_store_has_all_roots.load() || X509_STORE_CTX_get0_store(ctx) != shared_store) return;
+    us_internal_index_root_certs();
+
+    std::vector<X509 *> certs;
+    certs.push_back(X509_STORE_CTX_get0_cert(ctx));
+    STACK_OF(X509) *untrusted = X509_STORE_CTX_get0_untrusted(ctx);
+    for (size_t i = 0, count = untrusted ? sk_X509_num(untrusted) : 0; i < count; i++) {
+        certs.push_back(sk_X509_value(untrusted, i));
+    }
+
+    std::vector<std::string> subjects;
+    for (X509 *cert : certs) {
+        if (cert != NULL) subjects.push_back(us_name_der(X509_get_subject_name(cert)));
+    }
+
+    bool unresolved = false;
+    for (X509 *cert : certs) {
+        if (cert == NULL) continue;
+        std::string issuer = us_name_der(X509_get_issuer_name(cert));
+        auto range = root_certs_by_subject.equal_range(issuer);
+        for (auto it = range.first; it != range.second; ++it) {
+            us_add_shared_root(it->second);
+        }
+        if (range.first == range.second && std::find(subjects.begin(), subjects.end(), issuer) == subjects.end()) {
+            unresolved = true;
+        }
+    }
+
+    if (unresolved) {
+        std::call_once(shared_store_all_roots_once, [] {
+            for (size_t i = 0; i < root_certs_size; i++) {
+                us_add_shared_root(i);
+            }
+            shared_store_has_all_roots.store(true);
+        });
+    }
+}
+
+// SSL_CTX_set_cert_verify_callback() for contexts on the shared default
+// store, in place of X509_verify_cert().
+extern "C" int us_verify_cert_chain_cached(X509_STORE_CTX *ctx, void *arg) {
+    std::string fingerprint;
+    bool has_fingerprint = us_chain_fingerprint(ctx, fingerprint);
+    time_t now = time(NULL);
+
+    if (has_fingerprint) {
+        std::lock_guard<std::mutex> locker(verified_chains_lock);
+        auto found = verified_chains_by_fingerprint.find(fingerprint);
+        if (found != verified_chains_by_fingerprint.end()) {
+            if (now < found->second->expires) {
+                verified_chains.splice(verified_chains.begin(), verified_chains, found->second);
+                X509_STORE_CTX_set_error(ctx, X509_V_OK);
+                return 1;
+            }
+            verified_chains.erase(found->second);
+            verified_chains_by_fingerprint.erase(found);
+        }
+    }
+
+    us_add_roots_for_chain(ctx);
+    int ok = X509_verify_cert(ctx);
+
+    // us_verify_callback lets every error through, so only a chain that
+    // ended with no error at all is one worth remembering.
+    if (has_fingerprint && ok == 1 && X509_STORE_CTX_get_error(ctx) == X509_V_OK) {
+        time_t expires = us_chain_expiry(ctx, now, US_VERIFIED_CHAIN_MAX_AGE);
+        if (expires > now) {
+            std::lock_guard<std::mutex> locker(verified_chains_lock);
+            if (verified_chains_by_fingerprint.find(fingerprint) == verified_chains_by_fingerprint.end()) {
+                if (verified_chains.size() >= US_VERIFIED_CHAIN_CACHE_SIZE) {
+                    verified_chains_by_fingerprint.erase(verified_chains.back().fingerprint);
+                    verified_chains.pop_back();
+                }
+                verified_chains.push_front({fingerprint, expires});
+                verified_chains_by_fingerprint.emplace(fingerprint, verified_chains.begin());
+            }
+        }
+    }
+
+    return ok;
+}
@@ -16,16 +16,18 @@
  */
 
 /* This Server Name Indication hostname tree is written in C++ but could be ported to C.
- * Overall it looks like crap, but has no memory allocations in fast path and is O(log n). */
+ * Exact names and *.domain wildcards are found by hash, anything else walks the label tree. */
 
 #ifndef SNI_TREE_H
 #define SNI_TREE_H
 
 #ifndef LIBUS_NO_SSL
 
+#include <list>
 #include <map>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
 #include <cstring>
 #include <cstdlib>
 #include <algorithm>
@@ -116,99 +118,240 @@ void *getUser(struct sni_node *root, unsigned int label, std::string_view *label
     return getUser(it->second.get(), label + 1, labels, numLabels);
 }
 
+/* Splits hostname into at most MAX_LABELS labels, returns the count or -1 if there are more */
+static int splitLabels(const char *hostname, std::string_view *labels) {
+    int numLabels = 0;
+    for (std::string_view view(hostname, strlen(hostname)), label;
+        view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
+        /* Label is the token separated by dot */
+        label = view.substr(0, view.find('.', 0));
+
+        if (numLabels == MAX_LABELS) {
+            return -1;
+        }
+
+        labels[numLabels++] = label;
+    }
+    return numLabels;
+}
+
+struct sni_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
+using sni_map = std::unordered_map<std::string, void *, sni_hash, std::equal_to<>>;
+
+/* How many names resolved through a wildcard we remember */
+#define SNI_RECENT_CAPACITY 1024
+
+/* Most names are added verbatim or as *.domain, so those are looked up by hash. The tree only
+ * holds the rest, like api.*.example.com */
+struct sni_index {
+    /* Names without a wildcard label */
+    sni_map exact;
+    /* *.example.com is kept as example.com */
+    sni_map leadingWildcards;
+    struct sni_node tree;
+
+    /* Names that missed the exact lookup and what they resolved to, if anything, most recent first.
+     * Cleared whenever names are added or removed */
+    std::list<std::pair<std::string, void *>> recent;
+    std::unordered_map<std::string_view, std::list<std::pair<std::string, void *>>::iterator> recentIndex;
+
+    void forgetRecent() {
+        recentIndex.clear();
+        recent.clear();
+    }
+
+    void remember(std::string_view hostname, void *user) {
+        if (recent.size() == SNI_RECENT_CAPACITY) {
+            recentIndex.erase(recent.back().first);
+            recent.pop_back();
+        }
+        recent.emplace_front(std::string(hostname), user);
+        recentIndex.emplace(recent.front().first, recent.begin());
+    }
+
+    /* A more specific kind of pattern wins: exact names, then *.domain, then the tree */
+    void *resolve(const char *hostname) {
+        std::string_view name(hostname);
+        size_t dot = name.find('.');
+        std::string_view suffix = dot == std::string_view::npos ? std::string_view() : name.substr(dot + 1);
+
+        auto it = leadingWildcards.find(suffix);
+        if (it != leadingWildcards.end()) {
+            return it->second;
+        }
+
+        if (tree.children.empty()) {
+            return nullptr;
+        }
+
+        std::string_view labels[MAX_LABELS];
+        int numLabels = splitLabels(hostname, labels);
+        if (numLabels < 0) {
+            return nullptr;
+        }
+        return getUser(&tree, 0, labels, numLabels);
+    }
+};
+
+enum sni_pattern_kind { SNI_EXACT, SNI_LEADING_WILDCARD, SNI_TREE };
+
+static sni_pattern_kind patternKind(std::string_view pattern) {
+    bool leading = pattern == "*" || pattern.starts_with("*.");
+    std::string_view rest = leading ? pattern.substr(std::min<size_t>(2, pattern.length())) : pattern;
+    for (std::string_view view = rest, label; view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
+        label = view.substr(0, view.find('.', 0));
+        if (label == "*") {
+            return SNI_TREE;
+        }
+    }
+    return leading ? SNI_LEADING_WILDCARD : SNI_EXACT;
+}
+
 extern "C" {
 
     void *sni_new() {
-        return new sni_node;
+        return new sni_index;
     }
 
     void sni_free(void *sni, void (*cb)(void *)) {
+        struct sni_index *index = (struct sni_index *) sni;
+
         /* We want to run this callback for every remaining name */
         sni_free_cb = cb;
 
-        delete (sni_node *) sni;
+        for (auto &p : index->exact) {
+            cb(p.second);
+        }
+        for (auto &p : index->leadingWildcards) {
+            cb(p.second);
+        }
+
+        delete index;
     }
 
     /* Returns non-null if this name already exists */
     int sni_add(void *sni, const char *hostname, void *user) {
-        struct sni_node *root = (struct sni_node *) sni;
-
-        /* Traverse all labels in hostname */
-        for (std::string_view view(hostname, strlen(hostname)), label;
-            view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
-            /* Label is the token separated by dot */
-            label = view.substr(0, view.find('.', 0));
-
-            auto it = root->children.find(label);
-            if (it == root->children.end()) {
-                /* Duplicate this label for our kept string_view of it */
-                void *labelString = malloc(label.length());
-                memcpy(labelString, label.data(), label.length());
-
-                it = root->children.emplace(std::string_view((char *) labelString, label.length()),
-                                            std::make_unique<sni_node>()).first; // NOLINT(clang-analyzer-unix.Malloc)
+        struct sni_index *index = (struct sni_index *) sni;
+        std::string_view pattern(hostname);
+
+        switch (patternKind(pattern)) {
+        case SNI_EXACT:
+            /* We must never add multiple contexts for the same name, as that would overwrite and leak */
+            if (!index->exact.emplace(std::string(pattern), user).second) {
+                return 1;
+            }
+            break;
+        case SNI_LEADING_WILDCARD:
+            if (!index->leadingWildcards.emplace(std::string(pattern.substr(std::min<size_t>(2, pattern.length()))), user).second) {
+                return 1;
+            }
+            break;
+        case SNI_TREE: {
+            struct sni_node *root = &index->tree;
+
+            /* Traverse all labels in hostname */
+            for (std::string_view view = pattern, label;
+                view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
+                /* Label is the token separated by dot */
+                label = view.substr(0, view.find('.', 0));
+
+                auto it = root->children.find(label);
+                if (it == root->children.end()) {
+                    /* Duplicate this label for our kept string_view of it */
+                    void *labelString = malloc(label.length());
+                    memcpy(labelString, label.data(), label.length());
+
+                    it = root->children.emplace(std::string_view((char *) labelString, label.length()),
+                                                std::make_unique<sni_node>()).first; // NOLINT(clang-analyzer-unix.Malloc)
+                }
+
+                root = it->second.get();
             }
 
-            root = it->second.get();
-        }
+            if (root->user) {
+                return 1;
+            }
 
-        /* We must never add multiple contexts for the same name, as that would overwrite and leak */
-        if (root->user) {
-            return 1;
+            root->user = user;
+            break;
+        }
         }
 
-        root->user = user;
-
+        index->forgetRecent();
         return 0;
     }
 
     /* Removes the exact match. Wildcards are treated as the verbatim asterisk char, not as an actual wildcard */
     void *sni_remove(void *sni, const char *hostname) {
-        struct sni_node *root = (struct sni_node *) sni;
-
-        /* I guess 10 labels is an okay limit */
-        std::string_view labels[10];
-        unsigned int numLabels = 0;
-
-        /* We traverse all labels first of all */
-        for (std::string_view view(hostname, strlen(hostname)), label;
-            view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
-            /* Label is the token separated by dot */
-            label = view.substr(0, view.find('.', 0));
-
-            /* Anything longer than 10 labels is forbidden */
-            if (numLabels == 10) {
-                return nullptr;
+        struct sni_index *index = (struct sni_index *) sni;
+        std::string_view pattern(hostname);
+
+        void *user = nullptr;
+        sni_pattern_kind kind = patternKind(pattern);
+        switch (kind) {
+        case SNI_EXACT:
+        case SNI_LEADING_WILDCARD: {
+            sni_map &map = kind == SNI_EXACT ? index->exact : index->leadingWildcards;
+            auto it = map.find(kind == SNI_EXACT ? pattern : pattern.substr(std::min<size_t>(2, pattern.length())));
+            if (it != map.end()) {
+                user = it->second;
+                map.erase(it);
             }
-
-            labels[numLabels++] = label;
+            break;
+        }
+        case SNI_TREE: {
+            std::string_view labels[MAX_LABELS];
+            int numLabels = splitLabels(hostname, labels);
+            if (numLabels >= 0) {
+                user = removeUser(&index->tree, 0, labels, numLabels);
+            }
+            break;
+        }
         }
 
-        return removeUser(root, 0, labels, numLabels);
+        index->forgetRecent();
+        return user;
     }
 
-    void *sni_find(void *sni, const char *hostname) {
-        struct sni_node *root = (struct sni_node *) sni;
+    /* Swaps what an existing name resolves to and returns the previous user, or null (and does nothing) if
+     * the name does not exist. Like sni_remove this takes wildcards verbatim */
+    void *sni_replace(void *sni, const char *hostname, void *user) {
+        void *previous = sni_remove(sni, hostname);
+        if (previous) {
+            sni_add(sni, hostname, user);
+        }
+        return previous;
+    }
 
-        /* I guess 10 labels is an okay limit */
-        std::string_view labels[10];
-        unsigned int numLabels = 0;
+    void *sni_find(void *sni, const char *hostname) {
+        struct sni_index *index = (struct sni_index *) sni;
 
-        /* We traverse all labels first of all */
-        for (std::string_view view(hostname, strlen(hostname)), label;
-            view.length(); view.remove_prefix(std::min(view.length(), label.length() + 1))) {
-            /* Label is the token separated by dot */
-            label = view.substr(0, view.find('.', 0));
+        /* The fast path, no allocations and a single hash */
+        auto exact = index->exact.find(std::string_view(hostname));
+        if (exact != index->exact.end()) {
+            return exact->second;
+        }
 
-            /* Anything longer than 10 labels is forbidden */
-            if (numLabels == 10) {
-                return nullptr;
-            }
+        /* Nothing else to match by */
+        if (index->leadingWildcards.empty() && index->tree.children.empty()) {
+            return nullptr;
+        }
 
-            labels[numLabels++] = label;
+        auto recent = index->recentIndex.find(std::string_view(hostname));
+        if (recent != index->recentIndex.end()) {
+            index->recent.splice(index->recent.begin(), index->recent, recent->second);
+            return recent->second->second;
         }
 
-        return getUser(root, 0, labels, numLabels);
+        void *user = index->resolve(hostname);
+        index->remember(hostname, user);
+        return user;
     }
 
 }
@@ -42,16 +42,32 @@ void us_loop_run_bun_tick(struct us_loop_t *loop, const struct timespec* timeout
 #define UNLIKELY(cond) __builtin_expect((_Bool)(cond), 0)
 
 #ifdef LIBUS_USE_EPOLL
-#define GET_READY_POLL(loop, index) (struct us_poll_t *) loop->ready_polls[index].data.ptr
-#define SET_READY_POLL(loop, index, poll) loop->ready_polls[index].data.ptr = (void*)poll
+#define GET_READY_POLL(loop, index) (struct us_poll_t *) loop->ready_list[index].data.ptr
+#define SET_READY_POLL(loop, index, poll) loop->ready_list[index].data.ptr = (void*)poll
 #else
-#define GET_READY_POLL(loop, index) (struct us_poll_t *) loop->ready_polls[index].udata
-#define SET_READY_POLL(loop, index, poll) loop->ready_polls[index].udata = (uint64_t)poll
+#define GET_READY_POLL(loop, index) (struct us_poll_t *) loop->ready_list[index].udata
+#define SET_READY_POLL(loop, index, poll) loop->ready_list[index].udata = (uint64_t)poll
 #endif
 
+static uint64_t us_internal_monotonic_time_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+unsigned long long us_loop_idle_time(struct us_loop_t *loop) {
+    return loop->data.idle_time_ns;
+}
+
 /* Loop */
 void us_loop_free(struct us_loop_t *loop) {
     us_internal_loop_data_free(loop);
+#ifdef LIBUS_USE_IO_URING
+    us_internal_io_uring_free(loop);
+#endif
+    if (loop->ready_list != loop->ready_polls) {
+        us_free(loop->ready_list);
+    }
     close(loop->fd);
     us_free(loop);
 }
@@ -116,11 +132,19 @@ struct us_loop_t *us_create_loop(void *hint, void (*wakeup_cb)(struct us_loop_t
     /* These could be accessed if we close a poll before starting the loop */
     loop->num_ready_polls = 0;
     loop->current_ready_poll = 0;
+    loop->ready_list = loop->ready_polls;
+    loop->ready_list_capacity = LIBUS_MAX_READY_POLLS;
 
     loop->bun_polls = 0;
 
 #ifdef LIBUS_USE_EPOLL
     loop->fd = epoll_create1(EPOLL_CLOEXEC);
+#ifdef LIBUS_USE_IO_URING
+    /* Falls back to plain epoll if io_uring is unavailable or disabled */
+    if (us_internal_io_uring_init(loop)) {
+        loop->ring = NULL;
+    }
+#endif
 #else
     loop->fd = kqueue();
 #endif
@@ -129,6 +153,104 @@ struct us_loop_t *us_create_loop(void *hint, void (*wakeup_cb)(struct us_loop_t
     return loop;
 }
 
+/* Dispatches one entry of the ready list by type */
+static void us_internal_loop_dispatch_ready_poll_at(struct us_loop_t *loop, int index) {
+    struct us_poll_t *poll = GET_READY_POLL(loop, index);
+    /* Any ready poll marked with nullptr will be ignored */
+    if (LIKELY(poll)) {
+        if (CLEAR_POINTER_TAG(poll) != poll) {
+            Bun__internal_dispatch_ready_poll(loop, poll);
+            return;
+        }
+#ifdef LIBUS_USE_EPOLL
+        int events = loop->ready_list[index].events;
+        const int error = events & (EPOLLERR | EPOLLHUP);
+#else
+        const struct kevent64_s* current_kevent = &loop->ready_list[index];
+        const int16_t filter = current_kevent->filter;
+        const uint16_t flags = current_kevent->flags;
+        const uint32_t fflags = current_kevent->fflags;
+
+        // > Multiple events which trigger the filter do not result in multiple kevents being placed on the kqueue
+        // > Instead, the filter will aggregate the events into a single kevent struct
+        int events = 0
+            | ((filter & EVFILT_READ) ? LIBUS_SOCKET_READABLE : 0)
+            | ((filter & EVFILT_WRITE) ? LIBUS_SOCKET_WRITABLE : 0);
+
+        // Note: EV_ERROR only sets the error in data as part of changelist. Not in this call!
+        const int error = (flags & (EV_ERROR | EV_EOF)) ? ((int)fflags || 1) : 0;
+#endif
+        /* Always filter all polls by what they actually poll for (callback polls always poll for readable) */
+        events &= us_poll_events(poll);
+        if (events || error) {
+            us_internal_dispatch_ready_poll(poll, error, events);
+        }
+    }
+}
+
+/* Returns the context of a ready uSockets socket if it wants batched dispatch */
+static struct us_socket_context_t *us_internal_ready_poll_batch_context(struct us_poll_t *poll) {
+    if (!poll || CLEAR_POINTER_TAG(poll) != poll) {
+        return NULL;
+    }
+
+    int poll_type = us_internal_poll_type(poll);
+    if (poll_type != POLL_TYPE_SOCKET && poll_type != POLL_TYPE_SOCKET_SHUT_DOWN) {
+        return NULL;
+    }
+
+    struct us_socket_context_t *context = ((struct us_socket_t *) poll)->context;
+    return context->on_batch_begin ? context : NULL;
+}
+
+/* Dispatches every remaining ready socket of this context in one go, starting with the current one */
+static void us_internal_loop_dispatch_context_batch(struct us_loop_t *loop, struct us_socket_context_t *context) {
+    context->on_batch_begin(context);
+
+    for (int i = loop->current_ready_poll; i < loop->num_ready_polls; i++) {
+        if (us_internal_ready_poll_batch_context(GET_READY_POLL(loop, i)) == context) {
+            us_internal_loop_dispatch_ready_poll_at(loop, i);
+
+            /* Handled out of order, make sure the outer iteration skips it */
+            if (i != loop->current_ready_poll) {
+                SET_READY_POLL(loop, i, NULL);
+            }
+        }
+    }
+
+    context->on_batch_end(context);
+}
+
+/* Moves the ready list to the heap (or grows it there) after an iteration that filled it up */
+static void us_internal_loop_grow_ready_list(struct us_loop_t *loop) {
+    if (loop->num_ready_polls < loop->ready_list_capacity || loop->ready_list_capacity >= LIBUS_MAX_READY_POLLS_LIMIT) {
+        return;
+    }
+
+    int capacity = loop->ready_list_capacity * 2;
+    void *ready_list = loop->ready_list == loop->ready_polls ? us_malloc(capacity * sizeof(loop->ready_polls[0]))
+                                                             : us_realloc(loop->ready_list, capacity * sizeof(loop->ready_polls[0]));
+    if (ready_list) {
+        loop->ready_list = ready_list;
+        loop->ready_list_capacity = capacity;
+    }
+}
+
+static void us_internal_loop_dispatch_ready_polls(struct us_loop_t *loop) {
+    /* Iterate ready polls, dispatching them by type */
+    for (loop->current_ready_poll = 0; loop->current_ready_poll < loop->num_ready_polls; loop->current_ready_poll++) {
+        struct us_socket_context_t *batch_context = us_internal_ready_poll_batch_context(GET_READY_POLL(loop, loop->current_ready_poll));
+        if (UNLIKELY(batch_context != NULL)) {
+            us_internal_loop_dispatch_context_batch(loop, batch_context);
+        } else {
+            us_internal_loop_dispatch_ready_poll_at(loop, loop->current_ready_poll);
+        }
+    }
+
+    /* Connection storms should not need more than one iteration to be noticed */
+    us_internal_loop_grow_ready_list(loop);
+}
+
 void us_loop_run(struct us_loop_t *loop) {
     us_loop_integrate(loop);
 
@@ -137,46 +259,25 @@ void us_loop_run(struct us_loop_t *loop) {
         /* Emit pre callback */
         us_internal_loop_pre(loop);
 
+        if (loop->data.idle_cb) {
+            loop->data.idle_cb(loop);
+        }
+
         /* Fetch ready polls */
+        uint64_t wait_start = us_internal_monotonic_time_ns();
 #ifdef LIBUS_USE_EPOLL
-        loop->num_ready_polls = epoll_wait(loop->fd, loop->ready_polls, 1024, -1);
-#else
-        loop->num_ready_polls = kevent64(loop->fd, NULL, 0, loop->ready_polls, 1024, 0, NULL);
+#ifdef LIBUS_USE_IO_URING
+        if (loop->ring) {
+            loop->num_ready_polls = us_internal_io_uring_wait(loop, NULL);
+        } else
 #endif
-
-        /* Iterate ready polls, dispatching them by type */
-        for (loop->current_ready_poll = 0; loop->current_ready_poll < loop->num_ready_polls; loop->current_ready_poll++) {
-            struct us_poll_t *poll = GET_READY_POLL(loop, loop->current_ready_poll);
-            /* Any ready poll marked with nullptr will be ignored */
-            if (LIKELY(poll)) {
-                if (CLEAR_POINTER_TAG(poll) != poll) {
-                    Bun__internal_dispatch_ready_poll(loop, poll);
-                    continue;
-                }
-#ifdef LIBUS_USE_EPOLL
-                int events = loop->ready_polls[loop->current_ready_poll].events;
-                const int error = events & (EPOLLERR | EPOLLHUP);
+        loop->num_ready_polls = epoll_wait(loop->fd, loop->ready_list, loop->ready_list_capacity, -1);
 #else
-                const struct kevent64_s* current_kevent = &loop->ready_polls[loop->current_ready_poll];
-                const int16_t filter = current_kevent->filter;
-                const uint16_t flags = current_kevent->flags;
-                const uint32_t fflags = current_kevent->fflags;
-
-                // > Multiple events which trigger the filter do not result in multiple kevents being placed on the kqueue
-                // > Instead, the filter will aggregate the events into a single kevent struct
-                // Note: EV_ERROR only sets the error in data as part of changelist. Not in this call!
-                int events = 0
-                    | ((filter & EVFILT_READ) ? LIBUS_SOCKET_READABLE : 0)
-                    | ((filter & EVFILT_WRITE) ? LIBUS_SOCKET_WRITABLE : 0);
-                const int error = (flags & (EV_ERROR | EV_EOF)) ? ((int)fflags || 1) : 0;
+        loop->num_ready_polls = kevent64(loop->fd, NULL, 0, loop->ready_list, loop->ready_list_capacity, 0, NULL);
 #endif
-                /* Always filter all polls by what they actually poll for (callback polls always poll for readable) */
-                events &= us_poll_events(poll);
-                if (events || error) {
-                    us_internal_dispatch_ready_poll(poll, error, events);
-                }
-            }
-        }
+        loop->data.idle_time_ns += us_internal_monotonic_time_ns() - wait_start;
+
+        us_internal_loop_dispatch_ready_polls(loop);
 
         /* Emit post callback */
         us_internal_loop_post(loop);
@@ -205,51 +306,32 @@ void us_loop_run_bun_tick(struct us_loop_t *loop, const struct timespec* timeout
     /* Emit pre callback */
     us_internal_loop_pre(loop);
 
-    /* Fetch ready polls */
-#ifdef LIBUS_USE_EPOLL
-    int timeoutMs = -1; 
-    if (timeout) {
-        timeoutMs = timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000;
+    /* A zero timeout is a poll between ticks, not the loop going idle */
+    if (loop->data.idle_cb && (!timeout || timeout->tv_sec || timeout->tv_nsec)) {
+        loop->data.idle_cb(loop);
     }
-    loop->num_ready_polls = epoll_wait(loop->fd, loop->ready_polls, 1024, timeoutMs);
-#else
-    loop->num_ready_polls = kevent64(loop->fd, NULL, 0, loop->ready_polls, 1024, 0, timeout);
-#endif
 
-    /* Iterate ready polls, dispatching them by type */
-    for (loop->current_ready_poll = 0; loop->current_ready_poll < loop->num_ready_polls; loop->current_ready_poll++) {
-        struct us_poll_t *poll = GET_READY_POLL(loop, loop->current_ready_poll);
-        /* Any ready poll marked with nullptr will be ignored */
-        if (LIKELY(poll)) {
-            if (CLEAR_POINTER_TAG(poll) != poll) {
-                Bun__internal_dispatch_ready_poll(loop, poll);
-                continue;
-            }
+    /* Fetch ready polls */
+    uint64_t wait_start = us_internal_monotonic_time_ns();
 #ifdef LIBUS_USE_EPOLL
-            int events = loop->ready_polls[loop->current_ready_poll].events;
-            const int error = events & (EPOLLERR | EPOLLHUP);
-#else
-            const struct kevent64_s* current_kevent = &loop->ready_polls[loop->current_ready_poll];
-            const int16_t filter = current_kevent->filter;
-            const uint16_t flags = current_kevent->flags;
-            const uint32_t fflags = current_kevent->fflags;
-
-            // > Multiple events which trigger the filter do not result in multiple kevents being placed on the kqueue
-            // > Instead, the filter will aggregate the events into a single kevent struct
-            int events = 0
-                | ((filter & EVFILT_READ) ? LIBUS_SOCKET_READABLE : 0)
-                | ((filter & EVFILT_WRITE) ? LIBUS_SOCKET_WRITABLE : 0);
-
-            // Note: EV_ERROR only sets the error in data as part of changelist. Not in this call!
-            const int error = (flags & (EV_ERROR | EV_EOF)) ? ((int)fflags || 1) : 0;
+#ifdef LIBUS_USE_IO_URING
+    if (loop->ring) {
+        loop->num_ready_polls = us_internal_io_uring_wait(loop, timeout);
+    } else
 #endif
-            /* Always filter all polls by what they actually poll for (callback polls always poll for readable) */
-            events &= us_poll_events(poll);
-            if (events || error) {
-                us_internal_dispatch_ready_poll(poll, error, events);
-            }
+    {
+        int timeoutMs = -1; 
+        if (timeout) {
+            timeoutMs = timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000;
         }
+        loop->num_ready_polls = epoll_wait(loop->fd, loop->ready_list, loop->ready_list_capacity, timeoutMs);
     }
+#else
+    loop->num_ready_polls = kevent64(loop->fd, NULL, 0, loop->ready_list, loop->ready_list_capacity, 0, timeout);
+#endif
+    loop->data.idle_time_ns += us_internal_monotonic_time_ns() - wait_start;
+
+    us_internal_loop_dispatch_ready_polls(loop);
 
     /* Emit post callback */
     us_internal_loop_post(loop);
@@ -308,7 +390,26 @@ struct us_poll_t *us_poll_resize(struct us_poll_t *p, struct us_loop_t *loop, un
     int events = us_poll_events(p);
 
     struct us_poll_t *new_p = us_realloc(p, sizeof(struct us_poll_t) + ext_size);
-    if (p != new_p && events) {
+    if (p != new_p) {
+        us_internal_poll_moved(loop, p, new_p, events);
+    }
+
+    return new_p;
+}
+
+/* Points the registration of a poll at its new address. The old address is only used as a key */
+void us_internal_poll_moved(struct us_loop_t *loop, struct us_poll_t *p, struct us_poll_t *new_p, int events) {
+#ifdef LIBUS_USE_IO_URING
+    if (loop->ring) {
+        /* Ring requests are keyed by fd so only the registration needs to learn the new address */
+        us_internal_io_uring_poll_resize(loop, p, new_p);
+        if (events) {
+            us_internal_loop_update_pending_ready_polls(loop, p, new_p, events, events);
+        }
+        return;
+    }
+#endif
+    if (events) {
 #ifdef LIBUS_USE_EPOLL
         /* Hack: forcefully update poll by stripping away already set events */
         new_p->state.poll_type = us_internal_poll_type(new_p);
@@ -321,14 +422,18 @@ struct us_poll_t *us_poll_resize(struct us_poll_t *p, struct us_loop_t *loop, un
         /* This is needed for epoll also (us_change_poll doesn't update the old poll) */
         us_internal_loop_update_pending_ready_polls(loop, p, new_p, events, events);
     }
-
-    return new_p;
 }
 
 void us_poll_start(struct us_poll_t *p, struct us_loop_t *loop, int events) {
     p->state.poll_type = us_internal_poll_type(p) | ((events & LIBUS_SOCKET_READABLE) ? POLL_TYPE_POLLING_IN : 0) | ((events & LIBUS_SOCKET_WRITABLE) ? POLL_TYPE_POLLING_OUT : 0);
 
 #ifdef LIBUS_USE_EPOLL
+#ifdef LIBUS_USE_IO_URING
+    if (loop->ring) {
+        us_internal_io_uring_poll_start(loop, p, events);
+        return;
+    }
+#endif
     struct epoll_event event;
     event.events = events;
     event.data.ptr = p;
@@ -345,6 +450,12 @@ void us_poll_change(struct us_poll_t *p, struct us_loop_t *loop, int events) {
         p->state.poll_type = us_internal_poll_type(p) | ((events & LIBUS_SOCKET_READABLE) ? POLL_TYPE_POLLING_IN : 0) | ((events & LIBUS_SOCKET_WRITABLE) ? POLL_TYPE_POLLING_OUT : 0);
 
 #ifdef LIBUS_USE_EPOLL
+#ifdef LIBUS_USE_IO_URING
+        if (loop->ring) {
+            us_internal_io_uring_poll_change(loop, p, events);
+            return;
+        }
+#endif
         struct epoll_event event;
         event.events = events;
         event.data.ptr = p;
@@ -361,8 +472,15 @@ void us_poll_stop(struct us_poll_t *p, struct us_loop_t *loop) {
     int old_events = us_poll_events(p);
     int new_events = 0;
 #ifdef LIBUS_USE_EPOLL
-    struct epoll_event event;
-    epoll_ctl(loop->fd, EPOLL_CTL_DEL, p->state.fd, &event);
+#ifdef LIBUS_USE_IO_URING
+    if (loop->ring) {
+        us_internal_io_uring_poll_stop(loop, p);
+    } else
+#endif
+    {
+        struct epoll_event event;
+        epoll_ctl(loop->fd, EPOLL_CTL_DEL, p->state.fd, &event);
+    }
 #else
     if (old_events) {
         kqueue_change(loop->fd, p->state.fd, old_events, new_events, NULL);
@@ -490,6 +608,53 @@ void us_timer_set(struct us_timer_t *t, void (*cb)(struct us_timer_t *t), int ms
 }
 #endif
 
+#ifdef LIBUS_USE_EPOLL
+/* Process polls: a pidfd becomes readable once its process exits, so child
+ * exits arrive as ordinary poll events instead of SIGCHLD plus waitpid */
+struct us_process_poll_t *us_create_process_poll(struct us_loop_t *loop, int fallthrough, int pidfd, unsigned int ext_size) {
+    struct us_poll_t *p = us_create_poll(loop, fallthrough, sizeof(struct us_internal_callback_t) + ext_size);
+    memset(p, 0, sizeof(struct us_internal_callback_t) + ext_size);
+    us_poll_init(p, pidfd, POLL_TYPE_CALLBACK);
+
+    struct us_internal_callback_t *cb = (struct us_internal_callback_t *) p;
+    cb->loop = loop;
+    cb->cb_expects_the_loop = 0;
+    /* A pidfd cannot be read, it stays readable until it is closed */
+    cb->leave_poll_ready = 1;
+
+    return (struct us_process_poll_t *) cb;
+}
+
+void *us_process_poll_ext(struct us_process_poll_t *p) {
+    return ((struct us_internal_callback_t *) p) + 1;
+}
+
+int us_process_poll_pidfd(struct us_process_poll_t *p) {
+    return us_poll_fd((struct us_poll_t *) p);
+}
+
+void us_process_poll_set(struct us_process_poll_t *p, void (*cb)(struct us_process_poll_t *p)) {
+    struct us_internal_callback_t *internal_cb = (struct us_internal_callback_t *) p;
+
+    internal_cb->cb = (void (*)(struct us_internal_callback_t *)) cb;
+
+    us_poll_start((struct us_poll_t *) p, internal_cb->loop, LIBUS_SOCKET_READABLE);
+}
+
+void us_process_poll_close(struct us_process_poll_t *p, int fallthrough) {
+    struct us_internal_callback_t *cb = (struct us_internal_callback_t *) p;
+
+    us_poll_stop(&cb->p, cb->loop);
+    close(us_poll_fd(&cb->p));
+
+    if (fallthrough) {
+        us_free(p);
+    } else {
+        us_poll_free((struct us_poll_t *) p, cb->loop);
+    }
+}
+#endif
+
 /* Async (internal helper for loop's wakeup feature) */
 #ifdef LIBUS_USE_EPOLL
 struct us_internal_async *us_internal_create_async(struct us_loop_t *loop, int fallthrough, unsigned int ext_size) {
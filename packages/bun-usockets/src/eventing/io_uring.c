@@ -0,0 +1,435 @@
+/*
+ * Authored by Alex Hultman, 2018-2019.
+ * Intellectual property of third-party.
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libusockets.h"
+#include "internal/internal.h"
+#include <stdlib.h>
+
+#ifdef LIBUS_USE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+/* Size of the submission queue, the completion queue is twice as large */
+#define LIBUS_IO_URING_ENTRIES 4096
+
+/* Poll requests are tagged with (generation << 32 | fd) so that completions of polls that have been
+ * stopped (and maybe freed) since they were queued can be recognized and dropped */
+#define USER_DATA(fd, generation) (((uint64_t) (generation) << 32) | (uint32_t) (fd))
+#define USER_DATA_FD(user_data) ((int) (uint32_t) (user_data))
+#define USER_DATA_GENERATION(user_data) ((uint32_t) ((user_data) >> 32))
+
+/* Completions we never look at (poll removals) and the poll on loop->fd itself */
+#define USER_DATA_IGNORED UINT64_MAX
+#define USER_DATA_EPOLL (UINT64_MAX - 1)
+
+struct us_io_uring_slot_t {
+    struct us_poll_t *poll;
+    uint32_t generation;
+    /* Events of the oneshot poll request currently in the kernel, 0 if none */
+    int armed;
+};
+
+struct us_io_uring_t {
+    int fd;
+
+    unsigned int *sq_head, *sq_tail, *sq_mask;
+    struct io_uring_sqe *sqes;
+    unsigned int sq_entries;
+    unsigned int to_submit;
+
+    unsigned int *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void *rings;
+    size_t rings_size;
+    size_t sqes_size;
+
+    /* Indexed by fd, one registration per fd at a time */
+    struct us_io_uring_slot_t *slots;
+    unsigned int num_slots;
+
+    /* Fds whose oneshot poll fired this iteration and may need to be armed again */
+    int *rearm;
+    unsigned int num_rearm, rearm_capacity;
+
+    int epoll_armed;
+};
+
+static int io_uring_setup(unsigned int entries, struct io_uring_params *params) {
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags, void *arg, size_t arg_size) {
+    return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static void us_internal_io_uring_submit(struct us_io_uring_t *ring) {
+    while (ring->to_submit) {
+        int submitted = io_uring_enter(ring->fd, ring->to_submit, 0, 0, NULL, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            /* Completion queue is backed up, we will try again when waiting */
+            return;
+        }
+        ring->to_submit -= submitted;
+    }
+}
+
+static struct io_uring_sqe *us_internal_io_uring_get_sqe(struct us_io_uring_t *ring) {
+    unsigned int tail = *ring->sq_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        /* Full, flush what we have so far */
+        us_internal_io_uring_submit(ring);
+        if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+            return NULL;
+        }
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[tail & *ring->sq_mask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    return sqe;
+}
+
+static void us_internal_io_uring_queue_sqe(struct us_io_uring_t *ring) {
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+    ring->to_submit++;
+}
+
+static void us_internal_io_uring_poll_add(struct us_io_uring_t *ring, int fd, int events, uint64_t user_data) {
+    struct io_uring_sqe *sqe = us_internal_io_uring_get_sqe(ring);
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = (uint32_t) events;
+    sqe->user_data = user_data;
+    us_internal_io_uring_queue_sqe(ring);
+}
+
+static void us_internal_io_uring_poll_remove(struct us_io_uring_t *ring, uint64_t user_data) {
+    struct io_uring_sqe *sqe = us_internal_io_uring_get_sqe(ring);
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = USER_DATA_IGNORED;
+    us_internal_io_uring_queue_sqe(ring);
+}
+
+static struct us_io_uring_slot_t *us_internal_io_uring_slot(struct us_io_uring_t *ring, int fd) {
+    if ((unsigned int) fd >= ring->num_slots) {
+        unsigned int num_slots = ring->num_slots * 2;
+        while (num_slots <= (unsigned int) fd) {
+            num_slots *= 2;
+        }
+        struct us_io_uring_slot_t *slots = us_realloc(ring->slots, num_slots * sizeof(struct us_io_uring_slot_t));
+        if (!slots) {
+            return NULL;
+        }
+        memset(slots + ring->num_slots, 0, (num_slots - ring->num_slots) * sizeof(struct us_io_uring_slot_t));
+        ring->slots = slots;
+        ring->num_slots = num_slots;
+    }
+    return &ring->slots[fd];
+}
+
+int us_internal_io_uring_init(struct us_loop_t *loop) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    /* We are the only ones submitting and we only care about completions when we wait */
+    params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+
+    int fd = io_uring_setup(LIBUS_IO_URING_ENTRIES, &params);
+    if (fd < 0 && errno == EINVAL) {
+        /* Older kernel, try again without the optional flags */
+        memset(&params, 0, sizeof(params));
+        fd = io_uring_setup(LIBUS_IO_URING_ENTRIES, &params);
+    }
+    if (fd < 0) {
+        return -1;
+    }
+
+    /* We need timeouts passed to io_uring_enter and a single mmap for both rings (5.11+) */
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    size_t rings_size = sq_size > cq_size ? sq_size : cq_size;
+
+    char *rings = mmap(NULL, rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (rings == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    size_t sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    struct io_uring_sqe *sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(rings, rings_size);
+        close(fd);
+        return -1;
+    }
+
+    struct us_io_uring_t *ring = us_calloc(1, sizeof(struct us_io_uring_t));
+    ring->fd = fd;
+    ring->rings = rings;
+    ring->rings_size = rings_size;
+    ring->sqes = sqes;
+    ring->sqes_size = sqes_size;
+
+    ring->sq_head = (unsigned int *) (rings + params.sq_off.head);
+    ring->sq_tail = (unsigned int *) (rings + params.sq_off.tail);
+    ring->sq_mask = (unsigned int *) (rings + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+
+    /* We always submit in order, so the indirection array can be the identity */
+    unsigned int *sq_array = (unsigned int *) (rings + params.sq_off.array);
+    for (unsigned int i = 0; i < params.sq_entries; i++) {
+        sq_array[i] = i;
+    }
+
+    ring->cq_head = (unsigned int *) (rings + params.cq_off.head);
+    ring->cq_tail = (unsigned int *) (rings + params.cq_off.tail);
+    ring->cq_mask = (unsigned int *) (rings + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (rings + params.cq_off.cqes);
+
+    ring->num_slots = 1024;
+    ring->slots = us_calloc(ring->num_slots, sizeof(struct us_io_uring_slot_t));
+    ring->rearm_capacity = LIBUS_MAX_READY_POLLS;
+    ring->rearm = us_malloc(ring->rearm_capacity * sizeof(int));
+
+    /* Everything registered directly with the epoll fd is picked up when it polls readable */
+    us_internal_io_uring_poll_add(ring, loop->fd, POLLIN, USER_DATA_EPOLL);
+    ring->epoll_armed = 1;
+
+    loop->ring = ring;
+    return 0;
+}
+
+void us_internal_io_uring_free(struct us_loop_t *loop) {
+    struct us_io_uring_t *ring = loop->ring;
+    if (!ring) {
+        return;
+    }
+
+    munmap(ring->sqes, ring->sqes_size);
+    munmap(ring->rings, ring->rings_size);
+    close(ring->fd);
+    us_free(ring->slots);
+    us_free(ring->rearm);
+    us_free(ring);
+    loop->ring = NULL;
+}
+
+void us_internal_io_uring_poll_start(struct us_loop_t *loop, struct us_poll_t *p, int events) {
+    struct us_io_uring_t *ring = loop->ring;
+    struct us_io_uring_slot_t *slot = us_internal_io_uring_slot(ring, us_poll_fd(p));
+    if (!slot) {
+        return;
+    }
+
+    /* Like EPOLL_CTL_ADD this replaces nothing, but be safe against a stale registration */
+    if (slot->armed) {
+        us_internal_io_uring_poll_remove(ring, USER_DATA(us_poll_fd(p), slot->generation));
+    }
+
+    slot->poll = p;
+    slot->generation++;
+    slot->armed = events;
+    if (events) {
+        us_internal_io_uring_poll_add(ring, us_poll_fd(p), events, USER_DATA(us_poll_fd(p), slot->generation));
+    }
+}
+
+void us_internal_io_uring_poll_change(struct us_loop_t *loop, struct us_poll_t *p, int events) {
+    struct us_io_uring_t *ring = loop->ring;
+    int fd = us_poll_fd(p);
+    if ((unsigned int) fd >= ring->num_slots) {
+        return;
+    }
+
+    struct us_io_uring_slot_t *slot = &ring->slots[fd];
+    if (slot->armed == events) {
+        return;
+    }
+
+    /* Replace the request in the kernel, a fired request gets rearmed directly with the new events */
+    if (slot->armed) {
+        us_internal_io_uring_poll_remove(ring, USER_DATA(fd, slot->generation));
+        slot->generation++;
+    }
+    slot->armed = events;
+    if (events) {
+        us_internal_io_uring_poll_add(ring, fd, events, USER_DATA(fd, slot->generation));
+    }
+}
+
+void us_internal_io_uring_poll_stop(struct us_loop_t *loop, struct us_poll_t *p) {
+    struct us_io_uring_t *ring = loop->ring;
+    int fd = us_poll_fd(p);
+    if ((unsigned int) fd >= ring->num_slots || ring->slots[fd].poll != p) {
+        return;
+    }
+
+    struct us_io_uring_slot_t *slot = &ring->slots[fd];
+    if (slot->armed) {
+        us_internal_io_uring_poll_remove(ring, USER_DATA(fd, slot->generation));
+    }
+
+    /* Anything still in flight for this poll now has an old generation and gets dropped */
+    slot->poll = NULL;
+    slot->generation++;
+    slot->armed = 0;
+}
+
+void us_internal_io_uring_poll_resize(struct us_loop_t *loop, struct us_poll_t *old_p, struct us_poll_t *new_p) {
+    struct us_io_uring_t *ring = loop->ring;
+    int fd = us_poll_fd(new_p);
+    if ((unsigned int) fd < ring->num_slots && ring->slots[fd].poll == old_p) {
+        /* The request in the kernel is keyed by fd, so it stays valid */
+        ring->slots[fd].poll = new_p;
+    }
+}
+
+/* Oneshot polls are level triggered at the time they are armed, so rearming whatever fired
+ * (and is still wanted) right before the next wait gives us the same semantics as epoll */
+static void us_internal_io_uring_rearm(struct us_loop_t *loop, struct us_io_uring_t *ring) {
+    for (unsigned int i = 0; i < ring->num_rearm; i++) {
+        int fd = ring->rearm[i];
+        struct us_io_uring_slot_t *slot = &ring->slots[fd];
+        if (!slot->poll || slot->armed) {
+            continue;
+        }
+
+        int events = us_poll_events(slot->poll);
+        if (events) {
+            slot->armed = events;
+            us_internal_io_uring_poll_add(ring, fd, events, USER_DATA(fd, slot->generation));
+        }
+    }
+    ring->num_rearm = 0;
+
+    if (!ring->epoll_armed) {
+        ring->epoll_armed = 1;
+        us_internal_io_uring_poll_add(ring, loop->fd, POLLIN, USER_DATA_EPOLL);
+    }
+}
+
+int us_internal_io_uring_wait(struct us_loop_t *loop, const struct timespec *timeout) {
+    struct us_io_uring_t *ring = loop->ring;
+
+    us_internal_io_uring_rearm(loop, ring);
+
+    /* Submitting and waiting is one and the same syscall */
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    unsigned int min_complete = 1;
+    unsigned int flags = IORING_ENTER_GETEVENTS;
+    void *arg_ptr = NULL;
+    size_t arg_size = 0;
+    if (timeout) {
+        ts.tv_sec = timeout->tv_sec;
+        ts.tv_nsec = timeout->tv_nsec;
+        if (!ts.tv_sec && !ts.tv_nsec) {
+            min_complete = 0;
+        } else {
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts = (uint64_t) (uintptr_t) &ts;
+            flags |= IORING_ENTER_EXT_ARG;
+            arg_ptr = &arg;
+            arg_size = sizeof(arg);
+        }
+    }
+
+    int ret = io_uring_enter(ring->fd, ring->to_submit, min_complete, flags, arg_ptr, arg_size);
+    if (ret >= 0) {
+        ring->to_submit -= ret;
+    } else if (errno == EBUSY) {
+        /* We have to reap completions before the kernel accepts more submissions */
+        io_uring_enter(ring->fd, 0, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+
+    /* Translate completions into epoll events so dispatch need not know about the ring */
+    int num_ready_polls = 0;
+    int epoll_ready = 0;
+    unsigned int head = *ring->cq_head;
+    unsigned int tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail && num_ready_polls < loop->ready_list_capacity; head++) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        uint64_t user_data = cqe->user_data;
+
+        if (user_data == USER_DATA_IGNORED) {
+            continue;
+        }
+
+        if (user_data == USER_DATA_EPOLL) {
+            ring->epoll_armed = 0;
+            epoll_ready = 1;
+            continue;
+        }
+
+        int fd = USER_DATA_FD(user_data);
+        if ((unsigned int) fd >= ring->num_slots) {
+            continue;
+        }
+
+        struct us_io_uring_slot_t *slot = &ring->slots[fd];
+        if (!slot->poll || slot->generation != USER_DATA_GENERATION(user_data)) {
+            continue;
+        }
+
+        slot->armed = 0;
+        if (ring->num_rearm == ring->rearm_capacity) {
+            ring->rearm_capacity *= 2;
+            ring->rearm = us_realloc(ring->rearm, ring->rearm_capacity * sizeof(int));
+        }
+        ring->rearm[ring->num_rearm++] = fd;
+
+        loop->ready_list[num_ready_polls].events = cqe->res < 0 ? EPOLLERR : (uint32_t) cqe->res;
+        loop->ready_list[num_ready_polls].data.ptr = slot->poll;
+        num_ready_polls++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+    if (epoll_ready && num_ready_polls < loop->ready_list_capacity) {
+        int num_epoll_polls = epoll_wait(loop->fd, loop->ready_list + num_ready_polls, loop->ready_list_capacity - num_ready_polls, 0);
+        if (num_epoll_polls > 0) {
+            num_ready_polls += num_epoll_polls;
+        }
+    }
+
+    return num_ready_polls;
+}
+
+#endif
@@ -31,6 +31,10 @@ static void poll_cb(uv_poll_t *p, int status, int events) {
 static void prepare_cb(uv_prepare_t *p) {
   struct us_loop_t *loop = p->data;
   us_internal_loop_pre(loop);
+  /* Prepare handles run right before libuv blocks for I/O */
+  if (loop->data.idle_cb) {
+    loop->data.idle_cb(loop);
+  }
 }
 
 /* Note: libuv timers execute AFTER the post callback */
@@ -149,6 +153,7 @@ struct us_loop_t *us_create_loop(void *hint,
 
   loop->uv_loop = hint ? hint : uv_loop_new();
   loop->is_default = hint != 0;
+  uv_loop_configure(loop->uv_loop, UV_METRICS_IDLE_TIME);
 
   loop->uv_pre = malloc(sizeof(uv_prepare_t));
   uv_prepare_init(loop->uv_loop, loop->uv_pre);
@@ -199,6 +204,10 @@ void us_loop_free(struct us_loop_t *loop) {
   free(loop);
 }
 
+unsigned long long us_loop_idle_time(struct us_loop_t *loop) {
+  return uv_metrics_idle_time(loop->uv_loop);
+}
+
 void us_loop_run(struct us_loop_t *loop) {
   us_loop_integrate(loop);
   uv_update_time(loop->uv_loop);
@@ -26,6 +26,7 @@
 #include <sys/eventfd.h>
 #define LIBUS_SOCKET_READABLE EPOLLIN
 #define LIBUS_SOCKET_WRITABLE EPOLLOUT
+#include "internal/eventing/io_uring.h"
 #else
 #include <sys/event.h>
 /* Kqueue's EVFILT_ is NOT a bitfield, you cannot OR together them.
@@ -60,6 +61,20 @@ struct us_loop_t {
 #else
     alignas(LIBUS_EXT_ALIGNMENT) struct kevent64_s ready_polls[1024];
 #endif
+
+    /* Where ready polls are actually fetched into. Starts out as ready_polls and is
+     * moved to a larger heap allocation whenever an iteration fills it up completely */
+#ifdef LIBUS_USE_EPOLL
+    struct epoll_event *ready_list;
+#else
+    struct kevent64_s *ready_list;
+#endif
+    int ready_list_capacity;
+
+#ifdef LIBUS_USE_IO_URING
+    /* Null if the ring could not be set up and we are using plain epoll */
+    struct us_io_uring_t *ring;
+#endif
 };
 
 struct us_poll_t {
@@ -0,0 +1,50 @@
+/*
+ * Authored by Alex Hultman, 2018-2019.
+ * Intellectual property of third-party.
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IO_URING_H
+#define IO_URING_H
+
+/* The io_uring mode is an extension of the epoll backend. Polls owned by uSockets are armed
+ * through the ring so that every poll change of an iteration goes out in the same syscall as
+ * the wait, while loop->fd stays a regular epoll fd (itself polled by the ring) for everyone
+ * else registering with it directly. Ready events are translated into loop->ready_list
+ * so dispatching stays exactly the same as with plain epoll. */
+
+#ifdef LIBUS_USE_IO_URING
+
+#include <time.h>
+
+struct us_loop_t;
+struct us_poll_t;
+struct us_io_uring_t;
+
+/* Returns 0 if the ring could be set up, otherwise the loop should keep using plain epoll */
+int us_internal_io_uring_init(struct us_loop_t *loop);
+void us_internal_io_uring_free(struct us_loop_t *loop);
+
+void us_internal_io_uring_poll_start(struct us_loop_t *loop, struct us_poll_t *p, int events);
+void us_internal_io_uring_poll_change(struct us_loop_t *loop, struct us_poll_t *p, int events);
+void us_internal_io_uring_poll_stop(struct us_loop_t *loop, struct us_poll_t *p);
+void us_internal_io_uring_poll_resize(struct us_loop_t *loop, struct us_poll_t *old_p, struct us_poll_t *new_p);
+
+/* Submits all queued poll changes, waits for events and fills loop->ready_list.
+ * A null timeout waits indefinitely. Returns the number of ready polls */
+int us_internal_io_uring_wait(struct us_loop_t *loop, const struct timespec *timeout);
+
+#endif
+
+#endif // IO_URING_H
@@ -32,14 +32,24 @@
 
 #if defined(LIBUS_USE_EPOLL) || defined(LIBUS_USE_KQUEUE)
 #define LIBUS_MAX_READY_POLLS 1024
+/* The ready list starts out at LIBUS_MAX_READY_POLLS and doubles up to this when full */
+#define LIBUS_MAX_READY_POLLS_LIMIT 65536
 
 void us_internal_loop_update_pending_ready_polls(struct us_loop_t *loop,
                                                  struct us_poll_t *old_poll,
                                                  struct us_poll_t *new_poll,
                                                  int old_events,
                                                  int new_events);
+void us_internal_poll_moved(struct us_loop_t *loop, struct us_poll_t *p,
+                            struct us_poll_t *new_p, int events);
 #endif
 
+/* Allocation of us_socket_t and us_listen_socket_t polls. Like us_create_poll, us_poll_free and
+ * us_poll_resize but the memory is recycled within the loop */
+struct us_poll_t *us_internal_create_socket_poll(struct us_loop_t *loop, unsigned int ext_size);
+void us_internal_free_socket_poll(struct us_poll_t *p, struct us_loop_t *loop);
+struct us_poll_t *us_internal_resize_socket_poll(struct us_poll_t *p, struct us_loop_t *loop, unsigned int ext_size);
+
 /* We only have one networking implementation so far */
 #include "internal/networking/bsd.h"
 
@@ -125,6 +135,7 @@ void us_internal_poll_set_type(struct us_poll_t *p, int poll_type);
 /* SSL loop data */
 void us_internal_init_loop_ssl_data(struct us_loop_t *loop);
 void us_internal_free_loop_ssl_data(struct us_loop_t *loop);
+void us_internal_ssl_handle_key_ops(struct us_loop_t *loop);
 
 /* Socket context related */
 void us_internal_socket_context_link_socket(struct us_socket_context_t *context,
@@ -132,7 +143,20 @@ void us_internal_socket_context_link_socket(struct us_socket_context_t *context,
 void us_internal_socket_context_unlink_socket(
     struct us_socket_context_t *context, struct us_socket_t *s);
 
+/* Timer wheel related. Short timeouts live in buckets 0-239 and long timeouts
+ * in buckets 240-479, indexed by the tick they expire on. The last bucket holds
+ * the sockets currently being swept */
+#define LIBUS_TIMER_WHEEL_BUCKETS 480
+#define LIBUS_TIMER_WHEEL_EXPIRING LIBUS_TIMER_WHEEL_BUCKETS
+#define LIBUS_TIMER_WHEEL_NONE 0xFFFF
+void us_internal_timer_wheel_link(struct us_socket_context_t *context,
+                                  struct us_socket_t *s);
+void us_internal_timer_wheel_unlink(struct us_socket_context_t *context,
+                                    struct us_socket_t *s);
+
 void us_internal_socket_after_resolve(struct us_connecting_socket_t *s);
+/* Closes the attempt timer and frees the address order, before freeing s */
+void us_internal_connecting_socket_release_attempts(struct us_connecting_socket_t *s);
 void us_internal_socket_after_open(struct us_socket_t *s, int error);
 int us_internal_handle_dns_results(struct us_loop_t *loop);
 
@@ -144,8 +168,12 @@ struct us_socket_t {
   unsigned short
       low_prio_state; /* 0 = not in low-prio queue, 1 = is in low-prio queue, 2
                          = was in low-prio queue in this iteration */
+  unsigned short timer_slot; /* Timer wheel bucket, or LIBUS_TIMER_WHEEL_NONE */
+  unsigned char pool_state; /* 1 while idle in the pool of its context */
+  unsigned char size_class; /* Of its memory, 0 if it came from the general allocator */
   struct us_socket_context_t *context;
   struct us_socket_t *prev, *next;
+  struct us_socket_t *timer_prev, *timer_next;
   struct us_socket_t *connect_next;
   struct us_connecting_socket_t *connect_state;
 };
@@ -162,7 +190,12 @@ struct us_connecting_socket_t {
     unsigned char long_timeout;
     uint16_t port;
     int error;
-    struct addrinfo *addrinfo_head;
+    /* The resolved addresses in the order to try them, see order_addresses() */
+    struct addrinfo **addrinfo_order;
+    int addrinfo_count;
+    int addrinfo_next;
+    /* Starts the next attempt if the ones in flight take too long */
+    struct us_timer_t *attempt_timer;
 };
 
 struct us_wrapped_socket_context_t {
@@ -183,6 +216,8 @@ struct us_udp_socket_t {
     uint16_t port;
     uint16_t closed : 1;
     uint16_t connected : 1;
+    /* Runs of same-sized datagrams to one peer are sent as a single segmented (UDP_SEGMENT) send */
+    uint16_t gso : 1;
     struct us_udp_socket_t *next;
 };
 
@@ -232,6 +267,30 @@ void us_internal_socket_context_link_listen_socket(
 void us_internal_socket_context_unlink_listen_socket(
     struct us_socket_context_t *context, struct us_listen_socket_t *s);
 
+/* An idle connection kept for reuse, see us_socket_pool_put */
+struct us_pooled_socket_t {
+  struct us_pooled_socket_t *prev, *next;
+  struct us_socket_t *s;
+  int ssl;
+  int port;
+  char host[];
+};
+
+struct us_socket_pool_t {
+  /* Most recently parked first, evictions take from the tail */
+  struct us_pooled_socket_t *head, *tail;
+  unsigned int max_idle;
+  unsigned int max_idle_per_host;
+  unsigned int idle_timeout;
+  struct us_socket_pool_stats_t stats;
+};
+
+/* Forgets a pooled socket that is closing or changing context */
+void us_internal_socket_pool_remove(struct us_socket_t *s);
+/* Closes a pooled socket for having timed out, or for being readable: the peer either hung up or sent
+ * something nobody asked for */
+void us_internal_socket_pool_expire(struct us_socket_t *s, int timed_out);
+
 struct us_socket_context_t {
   alignas(LIBUS_EXT_ALIGNMENT) struct us_loop_t *loop;
   uint32_t global_tick;
@@ -241,6 +300,10 @@ struct us_socket_context_t {
   struct us_listen_socket_t *head_listen_sockets;
   struct us_socket_t *iterator;
   struct us_socket_context_t *prev, *next;
+  /* Null unless us_socket_context_enable_timer_wheel was called */
+  struct us_socket_t **timer_wheel;
+  /* Null unless us_socket_context_set_pool_limits was called */
+  struct us_socket_pool_t *pool;
 
   struct us_socket_t *(*on_open)(struct us_socket_t *, int is_client, char *ip,
                                  int ip_length);
@@ -254,6 +317,9 @@ struct us_socket_context_t {
   struct us_connecting_socket_t *(*on_connect_error)(struct us_connecting_socket_t *, int code);
   struct us_socket_t *(*on_socket_connect_error)(struct us_socket_t *, int code);
   int (*is_low_prio)(struct us_socket_t *);
+  /* Null unless us_socket_context_on_batch was called */
+  void (*on_batch_begin)(struct us_socket_context_t *);
+  void (*on_batch_end)(struct us_socket_context_t *);
   
 };
 
@@ -278,6 +344,10 @@ void us_bun_internal_ssl_socket_context_add_server_name(
 void us_internal_ssl_socket_context_remove_server_name(
     struct us_internal_ssl_socket_context_t *context,
     const char *hostname_pattern);
+int us_bun_internal_ssl_socket_context_replace_server_name(
+    struct us_internal_ssl_socket_context_t *context,
+    const char *hostname_pattern,
+    struct us_bun_socket_context_options_t options);
 void us_internal_ssl_socket_context_on_server_name(
     struct us_internal_ssl_socket_context_t *context,
     void (*cb)(struct us_internal_ssl_socket_context_t *, const char *));
@@ -289,6 +359,23 @@ void *us_internal_ssl_socket_context_find_server_name_userdata(
 
 void *
 us_internal_ssl_socket_get_native_handle(struct us_internal_ssl_socket_t *s);
+int us_internal_ssl_socket_is_ktls(struct us_internal_ssl_socket_t *s);
+void us_internal_ssl_socket_context_enable_ktls(
+    struct us_internal_ssl_socket_context_t *context);
+void us_internal_ssl_socket_context_set_session_store(
+    struct us_internal_ssl_socket_context_t *context,
+    const struct us_ssl_session_store_t *store);
+void us_internal_ssl_socket_context_set_ticket_key_ring(
+    struct us_internal_ssl_socket_context_t *context,
+    struct us_ssl_ticket_key_ring_t *ring);
+void us_internal_ssl_socket_context_enable_async_handshake(
+    struct us_internal_ssl_socket_context_t *context);
+void us_internal_ssl_socket_context_enable_client_session_cache(
+    struct us_internal_ssl_socket_context_t *context,
+    unsigned int max_sessions);
+void us_internal_ssl_socket_context_session_stats(
+    struct us_internal_ssl_socket_context_t *context,
+    struct us_ssl_session_stats_t *stats);
 void *us_internal_ssl_socket_context_get_native_handle(
     struct us_internal_ssl_socket_context_t *context);
 struct us_bun_verify_error_t
@@ -365,6 +452,10 @@ struct us_listen_socket_t *us_internal_ssl_socket_context_listen_unix(
     struct us_internal_ssl_socket_context_t *context, const char *path,
     size_t pathlen, int options, int socket_ext_size);
 
+struct us_listen_socket_t *us_internal_ssl_socket_context_listen_fd(
+    struct us_internal_ssl_socket_context_t *context,
+    LIBUS_SOCKET_DESCRIPTOR fd, int socket_ext_size);
+
 struct us_connecting_socket_t *us_internal_ssl_socket_context_connect(
     struct us_internal_ssl_socket_context_t *context, const char *host,
     int port, int options, int socket_ext_size, int* is_resolved);
@@ -375,6 +466,8 @@ struct us_internal_ssl_socket_t *us_internal_ssl_socket_context_connect_unix(
 
 int us_internal_ssl_socket_write(struct us_internal_ssl_socket_t *s,
                                  const char *data, int length, int msg_more);
+int us_internal_ssl_socket_writev(struct us_internal_ssl_socket_t *s,
+                                  const struct us_iovec_t *iov, int iovcnt);
 int us_internal_ssl_socket_raw_write(struct us_internal_ssl_socket_t *s,
                                      const char *data, int length,
                                      int msg_more);
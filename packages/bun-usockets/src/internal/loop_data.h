@@ -21,6 +21,12 @@
 #include <stdint.h>
 
 // IMPORTANT: When changing this, don't forget to update the zig version in uws.zig as well!
+/* Sockets of up to LIBUS_SOCKET_SIZE_CLASSES * LIBUS_SOCKET_SIZE_CLASS_STEP bytes are recycled per loop,
+ * keeping at most LIBUS_SOCKET_FREE_LIST_LENGTH of each size */
+#define LIBUS_SOCKET_SIZE_CLASS_STEP 64
+#define LIBUS_SOCKET_SIZE_CLASSES 16
+#define LIBUS_SOCKET_FREE_LIST_LENGTH 512
+
 struct us_internal_loop_data_t {
     struct us_timer_t *sweep_timer;
     struct us_internal_async *wakeup_async;
@@ -43,6 +49,13 @@ struct us_internal_loop_data_t {
     char parent_tag;
     /* We do not care if this flips or not, it doesn't matter */
     size_t iteration_nr;
+    /* Nanoseconds spent waiting for polls, for event loop utilization */
+    uint64_t idle_time_ns;
+    /* Called before the loop blocks waiting for polls */
+    void (*idle_cb)(struct us_loop_t *);
+    /* Memory of freed sockets by size class, see us_internal_create_socket_poll */
+    void *socket_free_lists[LIBUS_SOCKET_SIZE_CLASSES];
+    unsigned int socket_free_counts[LIBUS_SOCKET_SIZE_CLASSES];
 };
 
 #endif // LOOP_DATA_H
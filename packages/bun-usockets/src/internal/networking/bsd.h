@@ -47,6 +47,16 @@
 
 #define LIBUS_UDP_MAX_SIZE (64 * 1024)
 
+#ifdef __linux__
+/* Linux can segment (UDP_SEGMENT) and coalesce (UDP_GRO) runs of same-sized datagrams */
+#define LIBUS_UDP_HAS_GSO
+#endif
+
+/* The kernel refuses more segments than this per send */
+#define LIBUS_UDP_MAX_SEGMENTS 64
+/* A segmented send still has to fit in one IPv6 datagram */
+#define LIBUS_UDP_MAX_SEGMENTED_SIZE (65535 - 40 - 8)
+
 struct bsd_addr_t {
     struct sockaddr_storage mem;
     socklen_t len;
@@ -109,11 +119,21 @@ int bsd_udp_packet_buffer_payload_length(struct udp_recvbuf *msgvec, int index);
 char *bsd_udp_packet_buffer_payload(struct udp_recvbuf *msgvec, int index);
 char *bsd_udp_packet_buffer_peer(struct udp_recvbuf *msgvec, int index);
 int bsd_udp_packet_buffer_local_ip(struct udp_recvbuf *msgvec, int index, char *ip);
+int bsd_udp_packet_buffer_segment_size(struct udp_recvbuf *msgvec, int index);
+int bsd_udp_enable_gso(LIBUS_SOCKET_DESCRIPTOR fd);
+int bsd_udp_enable_gro(LIBUS_SOCKET_DESCRIPTOR fd, int enabled);
+int bsd_udp_send_segments(LIBUS_SOCKET_DESCRIPTOR fd, void **payloads, size_t *lengths, int num, void *address, size_t segment_size, int flags);
 // int bsd_udp_packet_buffer_ecn(struct udp_recvbuf *msgvec, int index);
 
 LIBUS_SOCKET_DESCRIPTOR apple_no_sigpipe(LIBUS_SOCKET_DESCRIPTOR fd);
 LIBUS_SOCKET_DESCRIPTOR bsd_set_nonblocking(LIBUS_SOCKET_DESCRIPTOR fd);
 void bsd_socket_nodelay(LIBUS_SOCKET_DESCRIPTOR fd, int enabled);
+int bsd_socket_incoming_cpu(LIBUS_SOCKET_DESCRIPTOR fd, int cpu);
+/* Passing descriptors over a unix socket (SCM_RIGHTS) */
+#define LIBUS_MAX_PASSED_FDS 64
+int bsd_send_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, const LIBUS_SOCKET_DESCRIPTOR *fds, int count);
+int bsd_recv_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, LIBUS_SOCKET_DESCRIPTOR *fds, int max_count);
+void bsd_socket_cork(LIBUS_SOCKET_DESCRIPTOR fd);
 void bsd_socket_flush(LIBUS_SOCKET_DESCRIPTOR fd);
 LIBUS_SOCKET_DESCRIPTOR bsd_create_socket(int domain, int type, int protocol);
 
@@ -137,6 +157,8 @@ LIBUS_SOCKET_DESCRIPTOR bsd_accept_socket(LIBUS_SOCKET_DESCRIPTOR fd, struct bsd
 int bsd_recv(LIBUS_SOCKET_DESCRIPTOR fd, void *buf, int length, int flags);
 int bsd_send(LIBUS_SOCKET_DESCRIPTOR fd, const char *buf, int length, int msg_more);
 int bsd_write2(LIBUS_SOCKET_DESCRIPTOR fd, const char *header, int header_length, const char *payload, int payload_length);
+int bsd_writev(LIBUS_SOCKET_DESCRIPTOR fd, const struct us_iovec_t *iov, int iovcnt);
+int bsd_sendfile(LIBUS_SOCKET_DESCRIPTOR fd, int file_fd, long long offset, int length);
 int bsd_would_block();
 
 // return LIBUS_SOCKET_ERROR or the fd that represents listen socket
@@ -146,7 +168,8 @@ LIBUS_SOCKET_DESCRIPTOR bsd_create_listen_socket(const char *host, int port, int
 LIBUS_SOCKET_DESCRIPTOR bsd_create_listen_socket_unix(const char *path, size_t pathlen, int options);
 
 /* Creates an UDP socket bound to the hostname and port */
-LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port);
+LIBUS_SOCKET_DESCRIPTOR bsd_create_udp_socket(const char *host, int port, int options);
+int bsd_udp_steer_by_connection_id(LIBUS_SOCKET_DESCRIPTOR fd, int group_size);
 int bsd_connect_udp_socket(LIBUS_SOCKET_DESCRIPTOR fd, const char *host, int port);
 int bsd_disconnect_udp_socket(LIBUS_SOCKET_DESCRIPTOR fd);
 
@@ -73,13 +73,17 @@ enum {
     /* No meaning, default listen option */
     LIBUS_LISTEN_DEFAULT,
     /* We exclusively own this port, do not share it */
-    LIBUS_LISTEN_EXCLUSIVE_PORT
+    LIBUS_LISTEN_EXCLUSIVE_PORT,
+    /* Share this UDP port with other sockets (SO_REUSEPORT), incoming datagrams are spread between them. TCP
+     * listen sockets always do unless LIBUS_LISTEN_EXCLUSIVE_PORT is given */
+    LIBUS_LISTEN_REUSE_PORT
 };
 
 /* Library types publicly available */
 struct us_socket_t;
 struct us_connecting_socket_t;
 struct us_timer_t;
+struct us_process_poll_t;
 struct us_socket_context_t;
 struct us_loop_t;
 struct us_poll_t;
@@ -92,6 +96,12 @@ struct us_cert_string_t {
     size_t len;
 };
 
+/* One chunk of a scatter-gather write. Same layout as struct iovec on POSIX */
+struct us_iovec_t {
+    const char *data;
+    size_t length;
+};
+
 /* Public interface for UDP sockets */
 
 /* Peeks data and length of UDP payload */
@@ -107,6 +117,10 @@ int us_udp_socket_bound_port(struct us_udp_socket_t *s);
 /* Peeks peer addr (sockaddr) of received packet */
 char *us_udp_packet_buffer_peer(struct us_udp_packet_buffer_t *buf, int index);
 
+/* Returns the datagram size of a received packet that was coalesced by UDP_GRO, 0 if it holds a single datagram.
+ * Every datagram in the payload but the last one is exactly this long */
+int us_udp_packet_buffer_segment_size(struct us_udp_packet_buffer_t *buf, int index);
+
 /* Peeks ECN of received packet */
 // int us_udp_packet_buffer_ecn(struct us_udp_packet_buffer_t *buf, int index);
 
@@ -117,6 +131,14 @@ void us_udp_buffer_set_packet_payload(struct us_udp_packet_buffer_t *send_buf, i
 
 int us_udp_socket_send(struct us_udp_socket_t *s, void** payloads, size_t* lengths, void** addresses, int num);
 
+/* Lets us_udp_socket_send coalesce runs of same-sized datagrams to one peer into single segmented sends (UDP_SEGMENT).
+ * Returns 0 on success, -1 if the platform or kernel does not support it */
+int us_udp_socket_set_gso(struct us_udp_socket_t *s, int enabled);
+
+/* Lets the kernel coalesce received same-sized datagrams from one peer (UDP_GRO), see us_udp_packet_buffer_segment_size.
+ * Returns 0 on success, -1 if the platform or kernel does not support it */
+int us_udp_socket_set_gro(struct us_udp_socket_t *s, int enabled);
+
 /* Allocates a packet buffer that is reuable per thread. Mutated by us_udp_socket_receive. */
 struct us_udp_packet_buffer_t *us_create_udp_packet_buffer();
 
@@ -129,6 +151,14 @@ struct us_udp_packet_buffer_t *us_create_udp_packet_buffer();
 
 struct us_udp_socket_t *us_create_udp_socket(struct us_loop_t *loop, void (*data_cb)(struct us_udp_socket_t *, void *, int), void (*drain_cb)(struct us_udp_socket_t *), void (*close_cb)(struct us_udp_socket_t *), const char *host, unsigned short port, void *user);
 
+/* Same as above but takes LIBUS_LISTEN_* options, like LIBUS_LISTEN_REUSE_PORT to let one UDP socket per loop share the port */
+struct us_udp_socket_t *us_create_udp_socket_with_options(struct us_loop_t *loop, void (*data_cb)(struct us_udp_socket_t *, void *, int), void (*drain_cb)(struct us_udp_socket_t *), void (*close_cb)(struct us_udp_socket_t *), const char *host, unsigned short port, int options, void *user);
+
+/* Steers QUIC datagrams within the SO_REUSEPORT group of this socket by the first byte of their destination
+ * connection id, modulo group_size. Sockets must join the group in worker order, and worker i must hand out
+ * connection ids starting with a byte b where b % group_size == i. Returns 0 on success, -1 if unsupported */
+int us_udp_socket_steer_by_connection_id(struct us_udp_socket_t *s, int group_size);
+
 void us_udp_socket_close(struct us_udp_socket_t *s);
 
 /* This one is ugly, should be ext! not user */
@@ -155,6 +185,23 @@ void us_timer_set(struct us_timer_t *timer, void (*cb)(struct us_timer_t *t), in
 /* Returns the loop for this timer */
 struct us_loop_t *us_timer_loop(struct us_timer_t *t);
 
+/* Public interfaces for process polls (epoll only) */
+
+/* Watch a pidfd for its process exiting. Takes ownership of the pidfd */
+struct us_process_poll_t *us_create_process_poll(struct us_loop_t *loop, int fallthrough, int pidfd, unsigned int ext_size);
+
+/* Returns user data extension for this process poll */
+void *us_process_poll_ext(struct us_process_poll_t *p);
+
+/* Returns the pidfd, to be passed to waitid(P_PIDFD) */
+int us_process_poll_pidfd(struct us_process_poll_t *p);
+
+/* Start watching. The callback keeps firing until the poll is closed */
+void us_process_poll_set(struct us_process_poll_t *p, void (*cb)(struct us_process_poll_t *p));
+
+/* Stops watching and closes the pidfd */
+void us_process_poll_close(struct us_process_poll_t *p, int fallthrough);
+
 /* Public interfaces for contexts */
 
 struct us_socket_context_options_t {
@@ -209,12 +256,105 @@ struct us_bun_socket_context_options_t {
     unsigned int client_renegotiation_window;
 };
 
+/* External store for TLS 1.2 session ids, e.g. backed by shared memory so that resumption works across
+ * processes sharing a port. Sessions are serialized in DER. get returns the length written to out, or 0 */
+struct us_ssl_session_store_t {
+    void *user;
+    void (*put)(void *user, const unsigned char *id, unsigned int id_length, const unsigned char *session, unsigned int session_length);
+    unsigned int (*get)(void *user, const unsigned char *id, unsigned int id_length, unsigned char *out, unsigned int out_capacity);
+    void (*remove)(void *user, const unsigned char *id, unsigned int id_length);
+};
+
+/* Session ticket keys in OpenSSL's 48 byte layout */
+struct us_ssl_ticket_key_t {
+    unsigned char name[16];
+    unsigned char aes_key[16];
+    unsigned char hmac_key[16];
+};
+
+#define LIBUS_SSL_TICKET_KEY_RING_SIZE 4
+
+/* A ring of ticket keys which may live in shared memory. New tickets are issued with keys[current % count],
+ * tickets of any other key in the ring are accepted and renewed. Rotate by filling the slot after current
+ * and only then advancing current */
+struct us_ssl_ticket_key_ring_t {
+    unsigned int current;
+    unsigned int count; /* At most LIBUS_SSL_TICKET_KEY_RING_SIZE */
+    struct us_ssl_ticket_key_t keys[LIBUS_SSL_TICKET_KEY_RING_SIZE];
+};
+
+struct us_ssl_session_stats_t {
+    unsigned long long hits;
+    unsigned long long misses;
+};
+
 /* Return 15-bit timestamp for this context */
 unsigned short us_socket_context_timestamp(int ssl, struct us_socket_context_t *context);
 
+/* Links sockets of this context into per-tick buckets so that the timeout sweep only touches sockets
+ * that expire, instead of walking every socket every tick. Child contexts inherit this mode. */
+void us_socket_context_enable_timer_wheel(int ssl, struct us_socket_context_t *context);
+
+/* Hands encryption of outgoing data to kernel TLS once the handshake of a socket in this SSL context
+ * completes, where supported (Linux, BoringSSL, TLS 1.2 with an AEAD cipher). Reading stays in user space.
+ * Child contexts inherit this. No-op for non-SSL contexts */
+void us_socket_context_enable_ktls(int ssl, struct us_socket_context_t *context);
+
+/* Replaces the session id cache of this SSL context with an external store (copied), null restores the default.
+ * Applies to the default certificate, child contexts inherit it. No-op for non-SSL contexts */
+void us_socket_context_set_session_store(int ssl, struct us_socket_context_t *context, const struct us_ssl_session_store_t *store);
+
+/* Issues and accepts session tickets using a caller owned key ring, null restores the default. The ring must
+ * outlive the context. Applies to the default certificate, child contexts inherit it. No-op for non-SSL contexts */
+void us_socket_context_set_ticket_key_ring(int ssl, struct us_socket_context_t *context, struct us_ssl_ticket_key_ring_t *ring);
+
+/* Runs the private key operations of handshakes in this SSL context on a shared worker pool and resumes the
+ * handshake on the loop once done, so handshake bursts no longer stall the loop nor need the low priority queue.
+ * Applies to the default certificate, child contexts inherit it. Requires BoringSSL, no-op otherwise */
+void us_socket_context_enable_async_handshake(int ssl, struct us_socket_context_t *context);
+
+/* Remembers the last session each server name issued to clients of this SSL context, up to max_sessions
+ * names, and offers it when the next connection to that name opens. The name is the one set with
+ * SSL_set_tlsext_host_name in on_open; connections without one always do a full handshake. No-op for
+ * non-SSL contexts */
+void us_socket_context_enable_client_session_cache(int ssl, struct us_socket_context_t *context, unsigned int max_sessions);
+
+/* Counts completed handshakes that did (hits) or did not (misses) resume a session */
+void us_socket_context_session_stats(int ssl, struct us_socket_context_t *context, struct us_ssl_session_stats_t *stats);
+
+struct us_socket_pool_stats_t {
+    unsigned long long hits;        /* Takes that found a socket */
+    unsigned long long misses;      /* Takes that did not */
+    unsigned long long evictions;   /* Closed to make room for a newer socket */
+    unsigned long long expirations; /* Closed after idle_timeout seconds */
+    unsigned long long closed;      /* Closed because the peer hung up (or sent data) while idle */
+    unsigned int idle;              /* Sockets in the pool right now */
+};
+
+/* Keeps up to max_idle idle client sockets of this context for reuse, at most max_idle_per_host of them per
+ * host and port, each for at most idle_timeout seconds (0 for no limit). Lowering the limits evicts the least
+ * recently parked sockets */
+void us_socket_context_set_pool_limits(int ssl, struct us_socket_context_t *context, unsigned int max_idle, unsigned int max_idle_per_host, unsigned int idle_timeout);
+
+/* Parks an idle socket in the pool of its context, evicting the least recently parked one of the same host or
+ * of the whole pool if full. The socket stays open and linked but belongs to the pool: its timeouts are
+ * replaced and it only polls for readable, which closes it. Closing it yourself is fine. Returns 0 if the
+ * socket was not taken (no pool, closed, shut down), in which case the caller should close it */
+int us_socket_pool_put(int ssl, struct us_socket_t *s, const char *host, int port);
+
+/* Takes the most recently parked socket to host and port out of the pool, or returns null. The socket has no
+ * timeouts and polls for readable */
+struct us_socket_t *us_socket_pool_take(int ssl, struct us_socket_context_t *context, const char *host, int port);
+
+void us_socket_context_pool_stats(int ssl, struct us_socket_context_t *context, struct us_socket_pool_stats_t *stats);
+
 /* Adds SNI domain and cert in asn1 format */
 void us_socket_context_add_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern, struct us_socket_context_options_t options, void *user);
 void us_bun_socket_context_add_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern, struct us_bun_socket_context_options_t options, void *user);
+/* Swaps the certificate of an existing SNI name for one built from options, keeping its user data. New handshakes
+ * use it right away, established connections are left alone. Returns 0 if the name does not exist (taken verbatim,
+ * like for remove) or the certificate failed to load */
+int us_bun_socket_context_replace_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern, struct us_bun_socket_context_options_t options);
 void us_socket_context_remove_server_name(int ssl, struct us_socket_context_t *context, const char *hostname_pattern);
 void us_socket_context_on_server_name(int ssl, struct us_socket_context_t *context, void (*cb)(struct us_socket_context_t *, const char *hostname));
 void *us_socket_server_name_userdata(int ssl, struct us_socket_t *s);
@@ -256,6 +396,12 @@ void us_socket_context_on_handshake(int ssl, struct us_socket_context_t *context
 /* Emitted when a socket has been half-closed */
 void us_socket_context_on_end(int ssl, struct us_socket_context_t *context, struct us_socket_t *(*on_end)(struct us_socket_t *s));
 
+/* Makes the epoll/kqueue loop dispatch all ready sockets of this context back to back, wrapped in
+ * one on_batch_begin/on_batch_end pair per iteration, e.g. to cork everything written in between.
+ * The context must not be freed from within the batch. Pass nulls to go back to regular dispatch */
+void us_socket_context_on_batch(int ssl, struct us_socket_context_t *context,
+    void (*on_batch_begin)(struct us_socket_context_t *context), void (*on_batch_end)(struct us_socket_context_t *context));
+
 /* Returns user data extension for this socket context */
 void *us_socket_context_ext(int ssl, struct us_socket_context_t *context);
 
@@ -269,9 +415,31 @@ struct us_listen_socket_t *us_socket_context_listen(int ssl, struct us_socket_co
 struct us_listen_socket_t *us_socket_context_listen_unix(int ssl, struct us_socket_context_t *context,
     const char *path, size_t pathlen, int options, int socket_ext_size);
 
+/* Listens on a descriptor that is already bound and listening, such as one handed over by another process */
+struct us_listen_socket_t *us_socket_context_listen_fd(int ssl, struct us_socket_context_t *context,
+    LIBUS_SOCKET_DESCRIPTOR fd, int socket_ext_size);
+
+/* Calls cb with every socket of the context, listen sockets excluded. The callback may close the socket */
+void us_socket_context_for_each_socket(int ssl, struct us_socket_context_t *context,
+    void (*cb)(struct us_socket_t *s, void *user_data), void *user_data);
+
 /* listen_socket.c/.h */
 void us_listen_socket_close(int ssl, struct us_listen_socket_t *ls);
 
+/* TCP listen sockets share their port through SO_REUSEPORT unless LIBUS_LISTEN_EXCLUSIVE_PORT is given, so every
+ * loop thread can listen on its own socket and have the kernel spread connections between them. Setting cpu to the
+ * one the listening thread is pinned to makes the kernel prefer this socket for connections it handled on that
+ * cpu (SO_INCOMING_CPU). Returns 0 on success, -1 if unsupported (Linux only) */
+int us_listen_socket_set_incoming_cpu(int ssl, struct us_listen_socket_t *ls, int cpu);
+
+/* Handing listeners over to a new process without dropping connections: the old process sends the descriptors of
+ * its listen sockets over a connected unix socket, the new one receives them and passes each to
+ * us_socket_context_listen_fd, and the old one then closes its own listen sockets and drains. Both return -1 on
+ * failure (unsupported on Windows), send returns 0 and receive the number of descriptors stored in fds */
+LIBUS_SOCKET_DESCRIPTOR us_listen_socket_get_fd(int ssl, struct us_listen_socket_t *ls);
+int us_listen_socket_send_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, const LIBUS_SOCKET_DESCRIPTOR *fds, int count);
+int us_listen_socket_recv_fds(LIBUS_SOCKET_DESCRIPTOR unix_fd, LIBUS_SOCKET_DESCRIPTOR *fds, int max_count);
+
 /*
     Returns one of 
     - struct us_socket_t * - indicated by the value at on_connecting being set to 1
@@ -335,6 +503,18 @@ void us_loop_integrate(struct us_loop_t *loop);
 /* Returns the loop iteration number */
 long long us_loop_iteration_number(struct us_loop_t *loop);
 
+/* Returns the nanoseconds this loop has spent waiting for polls */
+unsigned long long us_loop_idle_time(struct us_loop_t *loop);
+
+/* Returns the bytes of the receive and send buffers this loop shares between its sockets, and of the freed
+ * socket memory it keeps for reuse */
+unsigned long long us_loop_buffer_memory(struct us_loop_t *loop);
+
+/* Sets a callback for when the loop is about to block waiting for polls, with
+ * nothing left to do. Runs on the loop thread and may do slow work, such as
+ * collecting garbage. Pass null to remove it */
+void us_loop_on_idle(struct us_loop_t *loop, void (*cb)(struct us_loop_t *loop));
+
 /* Public interfaces for polls */
 
 /* A fallthrough poll does not keep the loop running, it falls through */
@@ -369,6 +549,10 @@ struct us_poll_t *us_poll_resize(struct us_poll_t *p, struct us_loop_t *loop, un
  * In the case of file descriptor, the value of pointer is fd. */
 void *us_socket_get_native_handle(int ssl, struct us_socket_t *s);
 
+/* Returns 1 if the kernel encrypts whatever is written to the file descriptor of this SSL socket,
+ * meaning plain writes (and sendfile) on it are valid TLS. Also applies to us_socket_raw_write */
+int us_socket_is_ktls(int ssl, struct us_socket_t *s);
+
 /* Write up to length bytes of data. Returns actual bytes written.
  * Will call the on_writable callback of active socket context on failure to write everything off in one go.
  * Set hint msg_more if you have more immediate data to write. */
@@ -377,6 +561,15 @@ int us_socket_write(int ssl, struct us_socket_t *s, const char *data, int length
 /* Special path for non-SSL sockets. Used to send header and payload in one go. Works like us_socket_write. */
 int us_socket_write2(int ssl, struct us_socket_t *s, const char *header, int header_length, const char *payload, int payload_length);
 
+/* Writes iovcnt chunks in as few syscalls (plaintext) or TLS records (SSL) as possible. Works like us_socket_write,
+ * returning the total amount of bytes written across all chunks. */
+int us_socket_writev(int ssl, struct us_socket_t *s, const struct us_iovec_t *iov, int iovcnt);
+
+/* Sends up to length bytes of file_fd starting at offset without copying them through user space. Works like
+ * us_socket_write. Returns -1 without sending anything if this socket cannot send files (TLS without kTLS,
+ * unsupported platform or file), in which case the caller should fall back to regular writes. */
+int us_socket_sendfile(int ssl, struct us_socket_t *s, int file_fd, long long offset, int length);
+
 /* Set a low precision, high performance timer on a socket. A socket can only have one single active timer
  * at any given point in time. Will remove any such pre set timer */
 void us_socket_timeout(int ssl, struct us_socket_t *s, unsigned int seconds);
@@ -394,6 +587,20 @@ struct us_socket_context_t *us_socket_context(int ssl, struct us_socket_t *s);
 /* Withdraw any msg_more status and flush any pending data */
 void us_socket_flush(int ssl, struct us_socket_t *s);
 
+/* Coalesces everything written to the descriptor into full segments (TCP_CORK where available) until
+ * uncorked again. For sockets written to outside of uWS, where there is no user space cork buffer */
+void us_socket_descriptor_cork(LIBUS_SOCKET_DESCRIPTOR fd, int enabled);
+
+/* Stops reading from the socket (no more on_data, EOF or errors are noticed) until resumed, used
+ * to push backpressure onto the peer when the application cannot keep up */
+void us_socket_pause(int ssl, struct us_socket_t *s);
+
+/* Starts reading from a paused socket again */
+void us_socket_resume(int ssl, struct us_socket_t *s);
+
+/* Returns whether the socket is paused */
+int us_socket_is_paused(int ssl, struct us_socket_t *s);
+
 /* Shuts down the connection by sending FIN and/or close_notify */
 void us_socket_shutdown(int ssl, struct us_socket_t *s);
 
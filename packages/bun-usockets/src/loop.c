@@ -18,6 +18,7 @@
 #include "libusockets.h"
 #include "internal/internal.h"
 #include <stdlib.h>
+#include <string.h>
 #ifndef WIN32
 #include <sys/ioctl.h>
 #endif
@@ -39,6 +40,8 @@ void us_internal_loop_data_init(struct us_loop_t *loop, void (*wakeup_cb)(struct
     loop->data.pre_cb = pre_cb;
     loop->data.post_cb = post_cb;
     loop->data.iteration_nr = 0;
+    loop->data.idle_time_ns = 0;
+    loop->data.idle_cb = 0;
 
     loop->data.closed_connecting_head = 0;
     loop->data.dns_ready_head = 0;
@@ -47,6 +50,9 @@ void us_internal_loop_data_init(struct us_loop_t *loop, void (*wakeup_cb)(struct
     loop->data.parent_ptr = 0;
     loop->data.parent_tag = 0;
 
+    memset(loop->data.socket_free_lists, 0, sizeof(loop->data.socket_free_lists));
+    memset(loop->data.socket_free_counts, 0, sizeof(loop->data.socket_free_counts));
+
     loop->data.wakeup_async = us_internal_create_async(loop, 1, 0);
     us_internal_async_set(loop->data.wakeup_async, (void (*)(struct us_internal_async *)) wakeup_cb);
 }
@@ -61,8 +67,107 @@ void us_internal_loop_data_free(struct us_loop_t *loop) {
 
     us_timer_close(loop->data.sweep_timer, 0);
     us_internal_async_close(loop->data.wakeup_async);
+
+    for (int i = 0; i < LIBUS_SOCKET_SIZE_CLASSES; i++) {
+        for (void *block = loop->data.socket_free_lists[i]; block; ) {
+            void *next = *(void **) block;
+            us_free(block);
+            block = next;
+        }
+    }
+}
+
+#ifndef LIBUS_USE_LIBUV
+/* Size class 0 is for sockets too big to recycle */
+static unsigned int us_internal_socket_size_class(unsigned int size) {
+    unsigned int size_class = (size + LIBUS_SOCKET_SIZE_CLASS_STEP - 1) / LIBUS_SOCKET_SIZE_CLASS_STEP;
+    return size_class <= LIBUS_SOCKET_SIZE_CLASSES ? size_class : 0;
+}
+
+static struct us_poll_t *us_internal_socket_alloc(struct us_loop_t *loop, unsigned int size_class) {
+    void **head = &loop->data.socket_free_lists[size_class - 1];
+    void *block = *head;
+    if (block) {
+        *head = *(void **) block;
+        loop->data.socket_free_counts[size_class - 1]--;
+    } else {
+        block = us_malloc(size_class * LIBUS_SOCKET_SIZE_CLASS_STEP);
+    }
+    ((struct us_socket_t *) block)->size_class = size_class;
+    return block;
+}
+
+static void us_internal_socket_release(struct us_loop_t *loop, struct us_poll_t *p) {
+    unsigned int size_class = ((struct us_socket_t *) p)->size_class;
+    if (!size_class || loop->data.socket_free_counts[size_class - 1] == LIBUS_SOCKET_FREE_LIST_LENGTH) {
+        us_free(p);
+        return;
+    }
+    *(void **) p = loop->data.socket_free_lists[size_class - 1];
+    loop->data.socket_free_lists[size_class - 1] = p;
+    loop->data.socket_free_counts[size_class - 1]++;
+}
+
+/* Accepting and closing sockets at high rates made malloc and free stand out in profiles */
+struct us_poll_t *us_internal_create_socket_poll(struct us_loop_t *loop, unsigned int ext_size) {
+    unsigned int size_class = us_internal_socket_size_class(sizeof(struct us_poll_t) + ext_size);
+    if (!size_class) {
+        struct us_poll_t *p = us_create_poll(loop, 0, ext_size);
+        ((struct us_socket_t *) p)->size_class = 0;
+        return p;
+    }
+
+    loop->num_polls++;
+    return us_internal_socket_alloc(loop, size_class);
+}
+
+void us_internal_free_socket_poll(struct us_poll_t *p, struct us_loop_t *loop) {
+    loop->num_polls--;
+    us_internal_socket_release(loop, p);
+}
+
+struct us_poll_t *us_internal_resize_socket_poll(struct us_poll_t *p, struct us_loop_t *loop, unsigned int ext_size) {
+    unsigned int old_class = ((struct us_socket_t *) p)->size_class;
+    unsigned int new_class = us_internal_socket_size_class(sizeof(struct us_poll_t) + ext_size);
+
+    /* Still fits where it is */
+    if (old_class && old_class == new_class) {
+        return p;
+    }
+
+    if (!old_class && !new_class) {
+        struct us_poll_t *new_p = us_poll_resize(p, loop, ext_size);
+        ((struct us_socket_t *) new_p)->size_class = 0;
+        return new_p;
+    }
+
+    /* Where we do not know the size we only know that the new one is at least as large */
+    unsigned int new_size = sizeof(struct us_poll_t) + ext_size;
+    unsigned int copy_size = old_class ? old_class * LIBUS_SOCKET_SIZE_CLASS_STEP : new_size;
+    struct us_poll_t *new_p = new_class ? us_internal_socket_alloc(loop, new_class) : us_malloc(new_size);
+    memcpy(new_p, p, copy_size < new_size ? copy_size : new_size);
+    ((struct us_socket_t *) new_p)->size_class = new_class;
+
+    us_internal_poll_moved(loop, p, new_p, us_poll_events(p));
+    us_internal_socket_release(loop, p);
+    return new_p;
+}
+#else
+struct us_poll_t *us_internal_create_socket_poll(struct us_loop_t *loop, unsigned int ext_size) {
+    struct us_poll_t *p = us_create_poll(loop, 0, ext_size);
+    ((struct us_socket_t *) p)->size_class = 0;
+    return p;
 }
 
+void us_internal_free_socket_poll(struct us_poll_t *p, struct us_loop_t *loop) {
+    us_poll_free(p, loop);
+}
+
+struct us_poll_t *us_internal_resize_socket_poll(struct us_poll_t *p, struct us_loop_t *loop, unsigned int ext_size) {
+    return us_poll_resize(p, loop, ext_size);
+}
+#endif
+
 void us_wakeup_loop(struct us_loop_t *loop) {
     us_internal_async_wakeup(loop->data.wakeup_async);
 }
@@ -92,6 +197,53 @@ void us_internal_loop_unlink(struct us_loop_t *loop, struct us_socket_context_t
     }
 }
 
+/* Pooled sockets time out into the pool, not to the user */
+static void us_internal_emit_socket_timeout(struct us_socket_context_t *context, struct us_socket_t *s) {
+    if (s->pool_state) {
+        us_internal_socket_pool_expire(s, 1);
+    } else if (context->on_socket_timeout != NULL) {
+        context->on_socket_timeout(s);
+    }
+}
+
+/* Sweeps only the buckets expiring this tick. Sockets are moved to the expiring bucket first
+ * so that handlers re-arming their timeout to this very tick don't get swept twice */
+static void us_internal_timer_wheel_sweep(struct us_socket_context_t *context, unsigned char short_ticks, unsigned char long_ticks) {
+    struct us_socket_t **wheel = context->timer_wheel;
+    unsigned int slots[2] = {short_ticks, 240 + (unsigned int) long_ticks};
+
+    for (int i = 0; i < 2; i++) {
+        struct us_socket_t *s = wheel[slots[i]];
+        wheel[slots[i]] = 0;
+        wheel[LIBUS_TIMER_WHEEL_EXPIRING] = s;
+        for (; s; s = s->timer_next) {
+            s->timer_slot = LIBUS_TIMER_WHEEL_EXPIRING;
+        }
+
+        /* Handlers may close or relink any socket, so always continue from the head */
+        while ((s = wheel[LIBUS_TIMER_WHEEL_EXPIRING])) {
+            us_internal_timer_wheel_unlink(context, s);
+            context->iterator = s;
+
+            if (short_ticks == s->timeout) {
+                s->timeout = 255;
+                us_internal_emit_socket_timeout(context, s);
+            }
+
+            if (context->iterator == s && long_ticks == s->long_timeout) {
+                s->long_timeout = 255;
+                if (context->on_socket_long_timeout != NULL) context->on_socket_long_timeout(s);
+            }
+
+            /* Unless unlinked by the handlers, put it in the bucket of its next timeout (if any) */
+            if (context->iterator == s) {
+                us_internal_timer_wheel_link(context, s);
+            }
+        }
+    }
+    context->iterator = 0;
+}
+
 /* This functions should never run recursively */
 void us_internal_timer_sweep(struct us_loop_t *loop) {
     struct us_internal_loop_data_t *loop_data = &loop->data;
@@ -105,6 +257,11 @@ void us_internal_timer_sweep(struct us_loop_t *loop) {
         unsigned char short_ticks = context->timestamp = context->global_tick % 240;
         unsigned char long_ticks = context->long_timestamp = (context->global_tick / 15) % 240;
 
+        if (context->timer_wheel) {
+            us_internal_timer_wheel_sweep(context, short_ticks, long_ticks);
+            continue;
+        }
+
         /* Begin at head */
         struct us_socket_t *s = context->head_sockets;
         while (s) {
@@ -126,7 +283,7 @@ void us_internal_timer_sweep(struct us_loop_t *loop) {
 
             if (short_ticks == s->timeout) {
                 s->timeout = 255;
-                if (context->on_socket_timeout != NULL) context->on_socket_timeout(s);
+                us_internal_emit_socket_timeout(context, s);
             }
 
             if (context->iterator == s && long_ticks == s->long_timeout) {
@@ -214,7 +371,7 @@ void us_internal_free_closed_sockets(struct us_loop_t *loop) {
     /* Free all closed sockets (maybe it is better to reverse order?) */
     for (struct us_socket_t *s = loop->data.closed_head; s; ) {
         struct us_socket_t *next = s->next;
-        us_poll_free((struct us_poll_t *) s, loop);
+        us_internal_free_socket_poll((struct us_poll_t *) s, loop);
         s = next;
     }
     loop->data.closed_head = 0;
@@ -242,16 +399,40 @@ long long us_loop_iteration_number(struct us_loop_t *loop) {
     return loop->data.iteration_nr;
 }
 
+unsigned long long us_loop_buffer_memory(struct us_loop_t *loop) {
+    unsigned long long bytes = LIBUS_RECV_BUFFER_LENGTH + LIBUS_RECV_BUFFER_PADDING * 2 + LIBUS_SEND_BUFFER_LENGTH;
+#ifndef LIBUS_NO_SSL
+    /* The SSL loop data has a decrypted read buffer of the same size */
+    if (loop->data.ssl_data) {
+        bytes += LIBUS_RECV_BUFFER_LENGTH + LIBUS_RECV_BUFFER_PADDING * 2;
+    }
+#endif
+    for (int i = 0; i < LIBUS_SOCKET_SIZE_CLASSES; i++) {
+        bytes += (unsigned long long) loop->data.socket_free_counts[i] * (i + 1) * LIBUS_SOCKET_SIZE_CLASS_STEP;
+    }
+    return bytes;
+}
+
+void us_loop_on_idle(struct us_loop_t *loop, void (*cb)(struct us_loop_t *loop)) {
+    loop->data.idle_cb = cb;
+}
+
 /* These may have somewhat different meaning depending on the underlying event library */
 void us_internal_loop_pre(struct us_loop_t *loop) {
     loop->data.iteration_nr++;
     us_internal_handle_dns_results(loop);
+#ifndef LIBUS_NO_SSL
+    us_internal_ssl_handle_key_ops(loop);
+#endif
     us_internal_handle_low_priority_sockets(loop);
     loop->data.pre_cb(loop);
 }
 
 void us_internal_loop_post(struct us_loop_t *loop) {
     us_internal_handle_dns_results(loop);
+#ifndef LIBUS_NO_SSL
+    us_internal_ssl_handle_key_ops(loop);
+#endif
     us_internal_free_closed_sockets(loop);
     loop->data.post_cb(loop);
 }
@@ -262,6 +443,32 @@ void us_internal_loop_post(struct us_loop_t *loop) {
 #define us_ioctl ioctl
 #endif
 
+/* How many bytes a readable socket may read in one go before the other ready polls get their turn. The
+ * fewer are waiting the more it gets, and when it is (nearly) alone it reads until the kernel runs dry.
+ * Bulk transfers then take one wakeup per burst instead of one per buffer */
+static size_t us_internal_recv_budget(struct us_loop_t *loop) {
+#ifdef LIBUS_USE_LIBUV
+    /* libuv hands us one poll at a time, so there is no count to go by. Every readiness event costs it a
+     * loop iteration and a new poll request (an AFD poll on Windows), so reading a few buffers per event
+     * still saves most of them */
+    (void) loop;
+    return 4 * (size_t) LIBUS_RECV_BUFFER_LENGTH;
+#else
+    int num_ready_polls = loop->num_ready_polls;
+    if (num_ready_polls <= 2) {
+        return SIZE_MAX;
+    }
+    if (num_ready_polls < 25) {
+        return 16 * (size_t) LIBUS_RECV_BUFFER_LENGTH;
+    }
+    return 2 * (size_t) LIBUS_RECV_BUFFER_LENGTH;
+#endif
+}
+
+/* At most this many connections are accepted per readable event of a listen socket, so that a connection storm
+ * cannot keep the loop from serving the connections it already has */
+#define LIBUS_ACCEPT_BUDGET 64
+
 void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events) {
     switch (us_internal_poll_type(p)) {
     case POLL_TYPE_CALLBACK: {
@@ -284,6 +491,8 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
             } else {
                 struct us_listen_socket_t *listen_socket = (struct us_listen_socket_t *) p;
                 struct bsd_addr_t addr;
+                /* Level triggered polling brings us back for whatever is left past the budget */
+                int budget = LIBUS_ACCEPT_BUDGET;
 
                 LIBUS_SOCKET_DESCRIPTOR client_fd = bsd_accept_socket(us_poll_fd(p), &addr);
                 if (client_fd == LIBUS_SOCKET_ERROR) {
@@ -294,7 +503,7 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
                     /* Todo: stop timer if any */
 
                     do {
-                        struct us_poll_t *accepted_p = us_create_poll(us_socket_context(0, &listen_socket->s)->loop, 0, sizeof(struct us_socket_t) - sizeof(struct us_poll_t) + listen_socket->socket_ext_size);
+                        struct us_poll_t *accepted_p = us_internal_create_socket_poll(us_socket_context(0, &listen_socket->s)->loop, sizeof(struct us_socket_t) - sizeof(struct us_poll_t) + listen_socket->socket_ext_size);
                         us_poll_init(accepted_p, client_fd, POLL_TYPE_SOCKET);
                         us_poll_start(accepted_p, listen_socket->s.context->loop, LIBUS_SOCKET_READABLE);
 
@@ -318,7 +527,7 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
                             break;
                         }
 
-                    } while ((client_fd = bsd_accept_socket(us_poll_fd(p), &addr)) != LIBUS_SOCKET_ERROR);
+                    } while (--budget && (client_fd = bsd_accept_socket(us_poll_fd(p), &addr)) != LIBUS_SOCKET_ERROR);
                 }
             }
         break;
@@ -328,6 +537,11 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
             /* We should only use s, no p after this point */
             struct us_socket_t *s = (struct us_socket_t *) p;
 
+            if (s->pool_state) {
+                us_internal_socket_pool_expire(s, 0);
+                return;
+            }
+
             if (events & LIBUS_SOCKET_WRITABLE && !error) {
                 /* Note: if we failed a write as a socket of one loop then adopted
                  * to another loop, this will be wrong. Absurd case though */
@@ -372,7 +586,7 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
                     }
                 }
 
-                size_t repeat_recv_count = 0;
+                size_t recv_budget = us_internal_recv_budget(s->context->loop);
 
                 do {
                     const struct us_loop_t* loop = s->context->loop;
@@ -386,27 +600,20 @@ void us_internal_dispatch_ready_poll(struct us_poll_t *p, int error, int events)
 
                     if (length > 0) {
                         s = s->context->on_data(s, loop->data.recv_buf + LIBUS_RECV_BUFFER_PADDING, length);
-                        // loop->num_ready_polls isn't accessible on Windows.
-                        #ifndef WIN32
-                        // rare case: we're reading a lot of data, there's more to be read, and either:
-                        // - the socket has hung up, so we will never get more data from it (only applies to macOS, as macOS will send the event the same tick but Linux will not.)
-                        // - the event loop isn't very busy, so we can read multiple times in a row
-                        #define LOOP_ISNT_VERY_BUSY_THRESHOLD 25
-                        if (
-                            s && length >= (LIBUS_RECV_BUFFER_LENGTH - 24 * 1024) && length <= LIBUS_RECV_BUFFER_LENGTH && 
-                            (error || loop->num_ready_polls < LOOP_ISNT_VERY_BUSY_THRESHOLD) && 
-                            !us_socket_is_closed(0, s)
-                        ) {
-                            repeat_recv_count += error == 0;
-
-                            // When not hung up, read a maximum of 10 times to avoid starving other sockets
-                            // We don't bother with ioctl(FIONREAD) because we've set MSG_DONTWAIT 
-                            if (!(repeat_recv_count > 10 && loop->num_ready_polls > 2)) {
+                        // a (nearly) full buffer means there is likely more to read right away, a short read that
+                        // the kernel had nothing more for us, so we skip the recv that would only say EAGAIN
+                        if (s && length >= (LIBUS_RECV_BUFFER_LENGTH - 24 * 1024) && !us_socket_is_closed(0, s)) {
+                            // the socket has hung up, so we will never get another event for the rest (only
+                            // applies to macOS, as macOS will send the event the same tick but Linux will not)
+                            if (error) {
+                                continue;
+                            }
+
+                            if (recv_budget > (size_t) length) {
+                                recv_budget -= length;
                                 continue;
                             }
                         }
-                        #undef LOOP_ISNT_VERY_BUSY_THRESHOLD
-                        #endif
                     } else if (!length) {
                         if (us_socket_is_shut_down(0, s)) {
                             /* We got FIN back after sending it */
@@ -1,8 +1,5 @@
 #ifdef LIBUS_USE_QUIC
 
-/* Todo: quic layer should not use bsd layer directly (sendmmsg) */
-#include "internal/networking/bsd.h"
-
 #include "quic.h"
 
 
@@ -21,6 +18,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <openssl/rand.h>
+
+/* Datagrams handed to us_udp_socket_send at once */
+#define LIBUS_QUIC_MAX_RUN 1024
+#define LIBUS_QUIC_SEND_SCRATCH_SIZE (64 * 1024)
+
 void leave_all();
 
 /*
@@ -36,10 +39,6 @@ struct sockaddr_in server_addr = {
     2
 };*/
 
-    // used in process_quic
-    lsquic_engine_t *global_engine;
-    lsquic_engine_t *global_client_engine;
-
 /* Socket context */
 struct us_quic_socket_context_s {
 
@@ -49,6 +48,9 @@ struct us_quic_socket_context_s {
 
     //struct us_udp_socket_t *udp_socket;
     struct us_loop_t *loop;
+    /* Drives the engines of this context (and thus loop) only */
+    struct us_timer_t *timer;
+    char *send_scratch;
     lsquic_engine_t *engine;
     lsquic_engine_t *client_engine;
 
@@ -101,7 +103,7 @@ void on_udp_socket_writable(struct us_udp_socket_t *s) {
 }
 
 // we need two differetn handlers to know to put it in client or servcer context
-void on_udp_socket_data_client(struct us_udp_socket_t *s, struct us_udp_packet_buffer_t *buf, int packets) {
+void on_udp_socket_data_client(struct us_udp_socket_t *s, void *buf, int packets) {
     
     int fd = us_poll_fd((struct us_poll_t *) s);
     //printf("Reading on fd: %d\n", fd);
@@ -118,7 +120,6 @@ void on_udp_socket_data_client(struct us_udp_socket_t *s, struct us_udp_packet_b
     for (int i = 0; i < packets; i++) {
         char *payload = us_udp_packet_buffer_payload(buf, i);
         int length = us_udp_packet_buffer_payload_length(buf, i);
-        int ecn = us_udp_packet_buffer_ecn(buf, i);
         void *peer_addr = us_udp_packet_buffer_peer(buf, i);
 
         //printf("Reading UDP of size %d\n", length);
@@ -162,7 +163,7 @@ void on_udp_socket_data_client(struct us_udp_socket_t *s, struct us_udp_packet_b
 
 }
 
-void on_udp_socket_data(struct us_udp_socket_t *s, struct us_udp_packet_buffer_t *buf, int packets) {
+void on_udp_socket_data(struct us_udp_socket_t *s, void *buf, int packets) {
     
 
     //printf("UDP socket got data: %p\n", s);
@@ -180,7 +181,6 @@ void on_udp_socket_data(struct us_udp_socket_t *s, struct us_udp_packet_buffer_t
     for (int i = 0; i < packets; i++) {
         char *payload = us_udp_packet_buffer_payload(buf, i);
         int length = us_udp_packet_buffer_payload_length(buf, i);
-        int ecn = us_udp_packet_buffer_ecn(buf, i);
         void *peer_addr = us_udp_packet_buffer_peer(buf, i);
 
         //printf("Reading UDP of size %d\n", length);
@@ -225,87 +225,81 @@ void on_udp_socket_data(struct us_udp_socket_t *s, struct us_udp_packet_buffer_t
 
 }
 
-/* Let's use this on Windows and macOS where it is not defined (todo: put in bsd.h) */
-#ifndef UIO_MAXIOV
-#define UIO_MAXIOV 1024
-
-#ifndef _WIN32
-struct mmsghdr {
-    struct msghdr msg_hdr;  /* Message header */
-    unsigned int  msg_len;  /* Number of bytes transmitted */
-};
-#endif
-#endif
-
 /* Server and client packet out is identical */
 int send_packets_out(void *ctx, const struct lsquic_out_spec *specs, unsigned n_specs) {
-#ifndef _WIN32
     us_quic_socket_context_t *context = ctx;
 
-    /* A run is at most UIO_MAXIOV datagrams long */
-    struct mmsghdr hdrs[UIO_MAXIOV];
+    /* A run is a set of datagrams going out the same UDP socket */
+    void *payloads[LIBUS_QUIC_MAX_RUN];
+    size_t lengths[LIBUS_QUIC_MAX_RUN];
+    void *addresses[LIBUS_QUIC_MAX_RUN];
     int run_length = 0;
+    /* Datagrams spread over several iovecs are flattened into this scratch buffer */
+    size_t coalesced = 0;
 
     /* We assume that thiss whole cb will never be called with 0 specs */
     struct us_udp_socket_t *last_socket = (struct us_udp_socket_t *) specs[0].peer_ctx;
 
     int sent = 0;
     for (int i = 0; i < n_specs; i++) {
+        size_t length = 0;
+        for (int j = 0; j < specs[i].iovlen; j++) {
+            length += specs[i].iov[j].iov_len;
+        }
+
         /* Send this run if we need to */
-        if (run_length == UIO_MAXIOV || specs[i].peer_ctx != last_socket) {
-            int ret = bsd_sendmmsg(us_poll_fd((struct us_poll_t *) last_socket), hdrs, run_length, 0);
-            if (ret != run_length) {
-                if (ret == -1) {
-                    printf("unhandled udp backpressure!\n");
-                    return sent;
-                } else {
-                    printf("unhandled udp backpressure!\n");
-                    errno = EAGAIN;
-                    return sent + ret;
-                }
+        if (run_length == LIBUS_QUIC_MAX_RUN || specs[i].peer_ctx != last_socket || (specs[i].iovlen > 1 && coalesced + length > LIBUS_QUIC_SEND_SCRATCH_SIZE)) {
+            int ret = us_udp_socket_send(last_socket, payloads, lengths, addresses, run_length);
+            if (ret < 0) {
+                return sent ? sent : -1;
             }
             sent += ret;
+            if (ret != run_length) {
+                /* The udp socket will tell us when it drains, see on_udp_socket_writable */
+                errno = EAGAIN;
+                return sent;
+            }
             run_length = 0;
+            coalesced = 0;
             last_socket = specs[i].peer_ctx;
-            //printf("different socket breask run!\n");
         }
 
         /* Continue existing run or start a new one */
-        //memset(&hdrs[i].msg_hdr, 0, sizeof(hdrs[i].msg_hdr));
-        memset(&hdrs[run_length], 0, sizeof(hdrs[run_length]));
-
-        hdrs[run_length].msg_hdr.msg_name       = (void *) specs[i].dest_sa;
-        hdrs[run_length].msg_hdr.msg_namelen    = (AF_INET == specs[i].dest_sa->sa_family ?
-                                            sizeof(struct sockaddr_in) :
-                                            sizeof(struct sockaddr_in6)),
-        hdrs[run_length].msg_hdr.msg_iov        = specs[i].iov;
-        hdrs[run_length].msg_hdr.msg_iovlen     = specs[i].iovlen;
-        hdrs[run_length].msg_hdr.msg_flags      = 0;
-
+        if (specs[i].iovlen == 1) {
+            payloads[run_length] = specs[i].iov[0].iov_base;
+        } else {
+            payloads[run_length] = context->send_scratch + coalesced;
+            for (int j = 0; j < specs[i].iovlen; j++) {
+                memcpy(context->send_scratch + coalesced, specs[i].iov[j].iov_base, specs[i].iov[j].iov_len);
+                coalesced += specs[i].iov[j].iov_len;
+            }
+        }
+        lengths[run_length] = length;
+        addresses[run_length] = (void *) specs[i].dest_sa;
         run_length++;
     }
 
     /* Send last run */
-    if (run_length) {
-        int ret = bsd_sendmmsg(us_poll_fd((struct us_poll_t *) last_socket), hdrs, run_length, 0);
-        if (ret == -1) {
-            printf("backpressure! A\n");
-            return sent;
-        }
-        if (sent + ret != n_specs) {
-            printf("backpressure! B\n");
-            printf("errno is: %d\n", errno);
-            errno = EAGAIN;
-        }
-        //printf("Returning %d of %d\n", sent + ret, n_specs);
-        return sent + ret;
+    int ret = us_udp_socket_send(last_socket, payloads, lengths, addresses, run_length);
+    if (ret < 0) {
+        return sent ? sent : -1;
     }
+    if (sent + ret != n_specs) {
+        errno = EAGAIN;
+    }
+    return sent + ret;
+}
 
-    //printf("Returning %d\n", n_specs);
-
-#endif
+/* Connection ids handed out by a worker start with a byte that steers their datagrams back to it,
+ * see us_udp_socket_steer_by_connection_id */
+void generate_scid(void *ctx, lsquic_conn_t *c, uint8_t *scid, unsigned len) {
+    us_quic_socket_context_t *context = ctx;
 
-    return n_specs;
+    RAND_bytes(scid, len);
+    if (context->options.worker_count > 1 && len) {
+        unsigned int spread = 256 / context->options.worker_count;
+        scid[0] = (uint8_t) ((scid[0] % spread) * context->options.worker_count + context->options.worker_index);
+    }
 }
 
 lsquic_conn_ctx_t *on_new_conn(void *stream_if_ctx, lsquic_conn_t *c) {
@@ -874,13 +868,19 @@ int hsi_process_header(void *hdr_set, struct lsxpack_header *hdr) {
 //extern us_quic_socket_context_t *context;
 
 void timer_cb(struct us_timer_t *t) {
+    us_quic_socket_context_t *context = *(us_quic_socket_context_t **) us_timer_ext(t);
+
     //printf("Processing conns from timer\n");
-    lsquic_engine_process_conns(global_engine);
-    lsquic_engine_process_conns(global_client_engine);
+    lsquic_engine_process_conns(context->engine);
+    lsquic_engine_process_conns(context->client_engine);
 
     // these are handled by this timer, should be polling for udp writable
-    lsquic_engine_send_unsent_packets(global_engine);
-    lsquic_engine_send_unsent_packets(global_client_engine);
+    lsquic_engine_send_unsent_packets(context->engine);
+    lsquic_engine_send_unsent_packets(context->client_engine);
+}
+
+void on_udp_socket_close(struct us_udp_socket_t *s) {
+
 }
 
 // lsquic_conn
@@ -912,6 +912,7 @@ us_quic_socket_context_t *us_create_quic_socket_context(struct us_loop_t *loop,
 
     context->loop = loop;
     //context->udp_socket = 0;
+    context->send_scratch = malloc(LIBUS_QUIC_SEND_SCRATCH_SIZE);
 
     /* Allocate per thread, UDP packet buffers */
     context->recv_buf = us_create_udp_packet_buffer();
@@ -949,6 +950,9 @@ us_quic_socket_context_t *us_create_quic_socket_context(struct us_loop_t *loop,
         .ea_stream_if       = &stream_callbacks,
         .ea_stream_if_ctx   = context,
 
+        .ea_generate_scid = generate_scid,
+        .ea_gen_scid_ctx = context,
+
         .ea_get_ssl_ctx = get_ssl_ctx,
         
         // lookup certificate
@@ -996,20 +1000,30 @@ us_quic_socket_context_t *us_create_quic_socket_context(struct us_loop_t *loop,
     printf("Client Engine: %p\n", context->client_engine);
 
     // start a timer to handle connections
-    struct us_timer_t *delayTimer = us_create_timer(loop, 0, 0);
-    us_timer_set(delayTimer, timer_cb, 50, 50);
-
-    // used by process_quic
-    global_engine = context->engine;
-    global_client_engine = context->client_engine;
+    context->timer = us_create_timer(loop, 0, sizeof(us_quic_socket_context_t *));
+    *(us_quic_socket_context_t **) us_timer_ext(context->timer) = context;
+    us_timer_set(context->timer, timer_cb, 50, 50);
 
     return context;
 }
 
 us_quic_listen_socket_t *us_quic_socket_context_listen(us_quic_socket_context_t *context, const char *host, int port, int ext_size) {
+    /* One listen socket per worker, all sharing the port and steered by connection id */
+    int workers = context->options.worker_count > 1;
+
     /* We literally do create a listen socket */
-    return (us_quic_listen_socket_t *) us_create_udp_socket(context->loop, /*context->recv_buf*/ NULL, on_udp_socket_data, on_udp_socket_writable, host, port, context);
-    //return NULL;
+    struct us_udp_socket_t *udp_socket = us_create_udp_socket_with_options(context->loop, on_udp_socket_data, on_udp_socket_writable, on_udp_socket_close, host, port, workers ? LIBUS_LISTEN_REUSE_PORT : LIBUS_LISTEN_DEFAULT, context);
+    if (!udp_socket) {
+        return NULL;
+    }
+
+    /* The program is shared by the whole group, the first worker attaches it */
+    if (workers && context->options.worker_index == 0) {
+        us_udp_socket_steer_by_connection_id(udp_socket, context->options.worker_count);
+    }
+    us_udp_socket_set_gso(udp_socket, 1);
+
+    return (us_quic_listen_socket_t *) udp_socket;
 }
 
 /* A client connection is its own UDP socket, while a server connection makes use of the shared listen UDP socket */
@@ -1030,7 +1044,7 @@ us_quic_socket_t *us_quic_socket_context_connect(us_quic_socket_context_t *conte
     addr->sin6_family = AF_INET6;
 
     // Create the UDP socket binding to ephemeral port
-    struct us_udp_socket_t *udp_socket = us_create_udp_socket(context->loop, /*context->recv_buf*/ NULL, on_udp_socket_data_client, on_udp_socket_writable, 0, 0, context);
+    struct us_udp_socket_t *udp_socket = us_create_udp_socket(context->loop, on_udp_socket_data_client, on_udp_socket_writable, on_udp_socket_close, 0, 0, context);
 
     // Determine what port we got, creating the local sockaddr
     int ephemeral = us_udp_socket_bound_port(udp_socket);
@@ -11,6 +11,10 @@ typedef struct {
     const char *cert_file_name;
     const char *key_file_name;
     const char *passphrase;
+    /* With more than one worker, every loop listens with its own UDP socket on the same port
+     * and connections stay pinned to the worker (loop) that accepted them */
+    unsigned int worker_index;
+    unsigned int worker_count;
 } us_quic_socket_context_options_t;
 
 
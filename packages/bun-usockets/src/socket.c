@@ -80,6 +80,11 @@ void us_socket_timeout(int ssl, struct us_socket_t *s, unsigned int seconds) {
     } else {
         s->timeout = 255;
     }
+
+    /* Sockets in the low-priority queue are relinked when they leave it */
+    if (s->context->timer_wheel && s->low_prio_state != 1) {
+        us_internal_timer_wheel_link(s->context, s);
+    }
 }
 
 void us_connecting_socket_timeout(int ssl, struct us_connecting_socket_t *c, unsigned int seconds) {
@@ -96,6 +101,10 @@ void us_socket_long_timeout(int ssl, struct us_socket_t *s, unsigned int minutes
     } else {
         s->long_timeout = 255;
     }
+
+    if (s->context->timer_wheel && s->low_prio_state != 1) {
+        us_internal_timer_wheel_link(s->context, s);
+    }
 }
 
 void us_connecting_socket_long_timeout(int ssl, struct us_connecting_socket_t *c, unsigned int minutes) {
@@ -112,6 +121,14 @@ void us_socket_flush(int ssl, struct us_socket_t *s) {
     }
 }
 
+void us_socket_descriptor_cork(LIBUS_SOCKET_DESCRIPTOR fd, int enabled) {
+    if (enabled) {
+        bsd_socket_cork(fd);
+    } else {
+        bsd_socket_flush(fd);
+    }
+}
+
 int us_socket_is_closed(int ssl, struct us_socket_t *s) {
     return s->prev == (struct us_socket_t *) s->context;
 }
@@ -126,6 +143,7 @@ int us_socket_is_established(int ssl, struct us_socket_t *s) {
 }
 
 void us_connecting_socket_free(struct us_connecting_socket_t *c) {
+    us_internal_connecting_socket_release_attempts(c);
     // we can't just free c immediately, as it may be enqueued in the dns_ready_head list
     // instead, we move it to a close list and free it after the iteration
     c->next = c->context->loop->data.closed_connecting_head;
@@ -158,6 +176,10 @@ void us_connecting_socket_close(int ssl, struct us_connecting_socket_t *c) {
 
 struct us_socket_t *us_socket_close(int ssl, struct us_socket_t *s, int code, void *reason) {
     if (!us_socket_is_closed(0, s)) {
+        if (s->pool_state) {
+            us_internal_socket_pool_remove(s);
+        }
+
         if (s->low_prio_state == 1) {
             /* Unlink this socket from the low-priority queue */
             if (!s->prev) s->context->loop->data.low_prio_head = s->next;
@@ -237,7 +259,7 @@ struct us_socket_t *us_socket_detach(int ssl, struct us_socket_t *s) {
 
 // This function is used for moving a socket between two different event loops
 struct us_socket_t *us_socket_attach(int ssl, LIBUS_SOCKET_DESCRIPTOR client_fd, struct us_socket_context_t *ctx, int flags, int socket_ext_size) {
-    struct us_poll_t *accepted_p = us_create_poll(ctx->loop, 0, sizeof(struct us_socket_t) - sizeof(struct us_poll_t) + socket_ext_size);
+    struct us_poll_t *accepted_p = us_internal_create_socket_poll(ctx->loop, sizeof(struct us_socket_t) - sizeof(struct us_poll_t) + socket_ext_size);
     us_poll_init(accepted_p, client_fd, POLL_TYPE_SOCKET);
     us_poll_start(accepted_p, ctx->loop, flags);
 
@@ -276,7 +298,53 @@ int us_socket_write2(int ssl, struct us_socket_t *s, const char *header, int hea
 
     int written = bsd_write2(us_poll_fd(&s->p), header, header_length, payload, payload_length);
     if (written != header_length + payload_length) {
-        us_poll_change(&s->p, s->context->loop, LIBUS_SOCKET_READABLE | LIBUS_SOCKET_WRITABLE);
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) | LIBUS_SOCKET_WRITABLE);
+    }
+
+    return written < 0 ? 0 : written;
+}
+
+int us_socket_writev(int ssl, struct us_socket_t *s, const struct us_iovec_t *iov, int iovcnt) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        return us_internal_ssl_socket_writev((struct us_internal_ssl_socket_t *) s, iov, iovcnt);
+    }
+#endif
+    if (us_socket_is_closed(ssl, s) || us_socket_is_shut_down(ssl, s)) {
+        return 0;
+    }
+
+    size_t length = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        length += iov[i].length;
+    }
+
+    int written = bsd_writev(us_poll_fd(&s->p), iov, iovcnt);
+    if (written < 0 || (size_t) written != length) {
+        s->context->loop->data.last_write_failed = 1;
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) | LIBUS_SOCKET_WRITABLE);
+    }
+
+    return written < 0 ? 0 : written;
+}
+
+int us_socket_sendfile(int ssl, struct us_socket_t *s, int file_fd, long long offset, int length) {
+    /* With kTLS the kernel encrypts whatever we send on the socket, files included */
+    if (ssl && !us_socket_is_ktls(ssl, s)) {
+        return -1;
+    }
+    if (us_socket_is_closed(ssl, s) || us_socket_is_shut_down(ssl, s)) {
+        return 0;
+    }
+
+    int written = bsd_sendfile(us_poll_fd(&s->p), file_fd, offset, length);
+    if (written < 0 && !bsd_would_block()) {
+        /* Files that cannot be sent like this (pipes and such) go through regular writes */
+        return -1;
+    }
+    if (written != length) {
+        s->context->loop->data.last_write_failed = 1;
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) | LIBUS_SOCKET_WRITABLE);
     }
 
     return written < 0 ? 0 : written;
@@ -286,7 +354,7 @@ struct us_socket_t *us_socket_from_fd(struct us_socket_context_t *ctx, int socke
 #if defined(LIBUS_USE_LIBUV) || defined(WIN32)
     return 0;
 #else
-    struct us_poll_t *p1 = us_create_poll(ctx->loop, 0, sizeof(struct us_socket_t) + socket_ext_size);
+    struct us_poll_t *p1 = us_internal_create_socket_poll(ctx->loop, sizeof(struct us_socket_t) + socket_ext_size);
     us_poll_init(p1, fd, POLL_TYPE_SOCKET);
     us_poll_start(p1, ctx->loop, LIBUS_SOCKET_READABLE | LIBUS_SOCKET_WRITABLE);
 
@@ -323,6 +391,15 @@ void *us_socket_get_native_handle(int ssl, struct us_socket_t *s) {
     return (void *) (uintptr_t) us_poll_fd((struct us_poll_t *) s);
 }
 
+int us_socket_is_ktls(int ssl, struct us_socket_t *s) {
+#ifndef LIBUS_NO_SSL
+    if (ssl) {
+        return us_internal_ssl_socket_is_ktls((struct us_internal_ssl_socket_t *) s);
+    }
+#endif
+    return 0;
+}
+
 void *us_connecting_socket_get_native_handle(int ssl, struct us_connecting_socket_t *c) {
 #ifndef LIBUS_NO_SSL
     // returns the ssl context
@@ -346,7 +423,7 @@ int us_socket_write(int ssl, struct us_socket_t *s, const char *data, int length
     int written = bsd_send(us_poll_fd(&s->p), data, length, msg_more);
     if (written != length) {
         s->context->loop->data.last_write_failed = 1;
-        us_poll_change(&s->p, s->context->loop, LIBUS_SOCKET_READABLE | LIBUS_SOCKET_WRITABLE);
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) | LIBUS_SOCKET_WRITABLE);
     }
 
     return written < 0 ? 0 : written;
@@ -402,6 +479,24 @@ void us_socket_shutdown(int ssl, struct us_socket_t *s) {
     }
 }
 
+/* Paused sockets keep polling for writable (if they have to) but are not read from. Writes leave
+ * the readable state as is, so a paused socket stays paused until resumed */
+void us_socket_pause(int ssl, struct us_socket_t *s) {
+    if (!us_socket_is_closed(ssl, s)) {
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) & LIBUS_SOCKET_WRITABLE);
+    }
+}
+
+void us_socket_resume(int ssl, struct us_socket_t *s) {
+    if (!us_socket_is_closed(ssl, s)) {
+        us_poll_change(&s->p, s->context->loop, us_poll_events(&s->p) | LIBUS_SOCKET_READABLE);
+    }
+}
+
+int us_socket_is_paused(int ssl, struct us_socket_t *s) {
+    return !us_socket_is_closed(ssl, s) && !(us_poll_events(&s->p) & LIBUS_SOCKET_READABLE);
+}
+
 void us_connecting_socket_shutdown(int ssl, struct us_connecting_socket_t *c) {
     c->shutdown = 1;
 }
@@ -40,10 +40,11 @@ int us_udp_packet_buffer_payload_length(struct us_udp_packet_buffer_t *buf, int
     return bsd_udp_packet_buffer_payload_length((struct udp_recvbuf *)buf, index);
 }
 
-int us_udp_socket_send(struct us_udp_socket_t *s, void** payloads, size_t* lengths, void** addresses, int num) {
-    if (num == 0) return 0;
-    int fd = us_poll_fd((struct us_poll_t *) s);
+int us_udp_packet_buffer_segment_size(struct us_udp_packet_buffer_t *buf, int index) {
+    return bsd_udp_packet_buffer_segment_size((struct udp_recvbuf *)buf, index);
+}
 
+static int us_internal_udp_socket_send_batch(struct us_udp_socket_t *s, int fd, void** payloads, size_t* lengths, void** addresses, int num) {
     struct udp_sendbuf *buf = (struct udp_sendbuf *)s->loop->data.send_buf;
 
     int total_sent = 0;
@@ -67,6 +68,108 @@ int us_udp_socket_send(struct us_udp_socket_t *s, void** payloads, size_t* lengt
     return total_sent;
 }
 
+#ifdef LIBUS_UDP_HAS_GSO
+static int us_internal_udp_same_address(void *a, void *b) {
+    if (a == b) return 1;
+    if (!a || !b) return 0;
+    struct sockaddr *sa = (struct sockaddr *) a, *sb = (struct sockaddr *) b;
+    if (sa->sa_family != sb->sa_family) return 0;
+    if (sa->sa_family == AF_INET) return !memcmp(a, b, sizeof(struct sockaddr_in));
+    if (sa->sa_family == AF_INET6) return !memcmp(a, b, sizeof(struct sockaddr_in6));
+    return 0;
+}
+
+/* Returns how many datagrams from the start can go out as one segmented send: same peer,
+ * same non-zero length, except for the last one which may be shorter */
+static int us_internal_udp_segment_run(void** payloads, size_t* lengths, void** addresses, int num) {
+    size_t segment_size = lengths[0];
+    if (segment_size == 0 || num < 2) return 1;
+
+    int run = 1;
+    size_t total = segment_size;
+    while (run < num && run < LIBUS_UDP_MAX_SEGMENTS) {
+        if (!lengths[run] || lengths[run] > segment_size || total + lengths[run] > LIBUS_UDP_MAX_SEGMENTED_SIZE) break;
+        if (!us_internal_udp_same_address(addresses[0], addresses[run])) break;
+        total += lengths[run];
+        run++;
+        if (lengths[run - 1] < segment_size) break;
+    }
+    return run;
+}
+
+static int us_internal_udp_socket_send_segmented(struct us_udp_socket_t *s, int fd, void** payloads, size_t* lengths, void** addresses, int num) {
+    int total_sent = 0;
+    while (total_sent < num && s->gso) {
+        int run = us_internal_udp_segment_run(payloads + total_sent, lengths + total_sent, addresses + total_sent, num - total_sent);
+        if (run == 1) {
+            /* Batch everything up to the next run through sendmmsg */
+            int batch = 1;
+            while (total_sent + batch < num && us_internal_udp_segment_run(payloads + total_sent + batch, lengths + total_sent + batch, addresses + total_sent + batch, num - total_sent - batch) == 1) {
+                batch++;
+            }
+            int sent = us_internal_udp_socket_send_batch(s, fd, payloads + total_sent, lengths + total_sent, addresses + total_sent, batch);
+            if (sent < 0) {
+                return total_sent ? total_sent : sent;
+            }
+            total_sent += sent;
+            if (sent < batch) {
+                return total_sent;
+            }
+            continue;
+        }
+
+        if (bsd_udp_send_segments(fd, payloads + total_sent, lengths + total_sent, run, addresses[total_sent], lengths[total_sent], MSG_DONTWAIT) < 0) {
+            if (bsd_would_block()) {
+                us_poll_change((struct us_poll_t *) s, s->loop, LIBUS_SOCKET_READABLE | LIBUS_SOCKET_WRITABLE);
+                return total_sent;
+            }
+            /* No checksum offload, segments larger than the path MTU and such: keep sending one by one */
+            s->gso = 0;
+            break;
+        }
+        total_sent += run;
+    }
+
+    if (total_sent < num) {
+        int sent = us_internal_udp_socket_send_batch(s, fd, payloads + total_sent, lengths + total_sent, addresses + total_sent, num - total_sent);
+        if (sent < 0) {
+            return total_sent ? total_sent : sent;
+        }
+        total_sent += sent;
+    }
+    return total_sent;
+}
+#endif
+
+int us_udp_socket_send(struct us_udp_socket_t *s, void** payloads, size_t* lengths, void** addresses, int num) {
+    if (num == 0) return 0;
+    int fd = us_poll_fd((struct us_poll_t *) s);
+
+#ifdef LIBUS_UDP_HAS_GSO
+    if (s->gso) {
+        return us_internal_udp_socket_send_segmented(s, fd, payloads, lengths, addresses, num);
+    }
+#endif
+
+    return us_internal_udp_socket_send_batch(s, fd, payloads, lengths, addresses, num);
+}
+
+int us_udp_socket_set_gso(struct us_udp_socket_t *s, int enabled) {
+    if (!enabled) {
+        s->gso = 0;
+        return 0;
+    }
+    if (bsd_udp_enable_gso(us_poll_fd((struct us_poll_t *) s))) {
+        return -1;
+    }
+    s->gso = 1;
+    return 0;
+}
+
+int us_udp_socket_set_gro(struct us_udp_socket_t *s, int enabled) {
+    return bsd_udp_enable_gro(us_poll_fd((struct us_poll_t *) s), enabled);
+}
+
 int us_udp_socket_bound_port(struct us_udp_socket_t *s) {
     return ((struct us_udp_socket_t *) s)->port;
 }
@@ -116,6 +219,10 @@ int us_udp_socket_disconnect(struct us_udp_socket_t *s) {
     return bsd_disconnect_udp_socket(us_poll_fd((struct us_poll_t *)s));
 }
 
+int us_udp_socket_steer_by_connection_id(struct us_udp_socket_t *s, int group_size) {
+    return bsd_udp_steer_by_connection_id(us_poll_fd((struct us_poll_t *) s), group_size);
+}
+
 struct us_udp_socket_t *us_create_udp_socket(
     struct us_loop_t *loop, 
     void (*data_cb)(struct us_udp_socket_t *, void *, int), 
@@ -125,8 +232,21 @@ struct us_udp_socket_t *us_create_udp_socket(
     unsigned short port, 
     void *user
 ) {
+    return us_create_udp_socket_with_options(loop, data_cb, drain_cb, close_cb, host, port, LIBUS_LISTEN_DEFAULT, user);
+}
+
+struct us_udp_socket_t *us_create_udp_socket_with_options(
+    struct us_loop_t *loop, 
+    void (*data_cb)(struct us_udp_socket_t *, void *, int), 
+    void (*drain_cb)(struct us_udp_socket_t *), 
+    void (*close_cb)(struct us_udp_socket_t *),
+    const char *host, 
+    unsigned short port, 
+    int options,
+    void *user
+) {
 
-    LIBUS_SOCKET_DESCRIPTOR fd = bsd_create_udp_socket(host, port);
+    LIBUS_SOCKET_DESCRIPTOR fd = bsd_create_udp_socket(host, port, options);
     if (fd == LIBUS_SOCKET_ERROR) {
         return 0;
     }
@@ -151,6 +271,7 @@ struct us_udp_socket_t *us_create_udp_socket(
 
     udp->closed = 0;
     udp->connected = 0;
+    udp->gso = 0;
     udp->on_data = data_cb;
     udp->on_drain = drain_cb;
     udp->on_close = close_cb;
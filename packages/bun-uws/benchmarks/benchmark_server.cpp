@@ -0,0 +1,60 @@
+/* The server the benchmark clients are run against. Every GET is answered with "Hello world!"
+ * and every WebSocket subscribes to one topic, to which whatever it sends is published:
+ *
+ *   benchmark_server port [key.pem cert.pem]
+ *
+ * With a key and certificate it serves TLS */
+
+#include "App.h"
+
+#include <cstdlib>
+#include <iostream>
+
+template <bool SSL>
+static void serve(uWS::TemplatedApp<SSL> &&app, int port) {
+    struct PerSocketData {};
+
+    /* WebSocket routes go first, as plain GETs to them fall through to the next route */
+    app.template ws<PerSocketData>("/*", {
+        .compression = uWS::DISABLED,
+        .maxPayloadLength = 16 * 1024,
+        /* Idle connections are what the memory benchmark measures */
+        .idleTimeout = 960,
+        .maxBackpressure = 16 * 1024 * 1024,
+        .closeOnBackpressureLimit = false,
+        .resetIdleTimeoutOnSend = false,
+        .sendPingsAutomatically = false,
+        .open = [](auto *ws) {
+            ws->subscribe("fanout");
+        },
+        .message = [&app](auto */*ws*/, std::string_view message, uWS::OpCode opCode) {
+            app.publish("fanout", message, opCode);
+        }
+    }).get("/*", [](auto *res, auto */*req*/) {
+        res->end("Hello world!");
+    }).listen(port, [port](auto *listen_socket) {
+        if (listen_socket) {
+            std::cout << "Listening on port " << port << std::endl;
+        } else {
+            std::cout << "Failed to listen on port " << port << std::endl;
+            exit(1);
+        }
+    }).run();
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2 && argc != 4) {
+        std::cout << "Usage: port [key.pem cert.pem]" << std::endl;
+        return 0;
+    }
+
+    int port = atoi(argv[1]);
+    if (argc == 4) {
+        serve(uWS::SSLApp({
+            .key_file_name = argv[2],
+            .cert_file_name = argv[3]
+        }), port);
+    } else {
+        serve(uWS::App(), port);
+    }
+}
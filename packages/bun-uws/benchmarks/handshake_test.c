@@ -0,0 +1,160 @@
+/* This benchmark keeps _connections_ TLS connections handshaking: every connection is
+   closed as soon as its handshake completes and replaced by a new one. It reports the
+   handshakes per second and the distribution of the time from connect to a completed
+   handshake, which includes the TCP handshake.
+
+   Host has to be an address, so that connecting starts right away and the time it takes
+   does not include a lookup. The first second is warm-up and is not recorded. */
+
+#include <libusockets.h>
+
+#include "latency.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NS_PER_SECOND 1000000000ull
+
+char *host;
+int port;
+int connections;
+int seconds;
+
+struct us_socket_context_t *context;
+
+uint64_t started_at, recording_from, recording_until;
+uint64_t handshakes, failures;
+struct latency_histogram histogram;
+
+struct handshake_socket {
+    uint64_t connected_at;
+};
+
+/* We don't need any of these */
+void noop(struct us_loop_t *loop) {
+
+}
+
+void print_results() {
+    uint64_t recorded_ns = recording_until - recording_from;
+
+    printf("{\"benchmark\": \"tls_handshake\", \"connections\": %d, \"seconds\": %d, ", connections, seconds);
+    printf("\"handshakes\": %llu, \"handshakes_per_second\": %.1f, \"failures\": %llu, \"latency\": ",
+        (unsigned long long) handshakes, (double) handshakes * NS_PER_SECOND / (double) recorded_ns, (unsigned long long) failures);
+    latency_print_json(stdout, &histogram);
+    printf("}\n");
+}
+
+void start_connection() {
+    int is_connecting = 0;
+    struct us_socket_t *s = (struct us_socket_t *) us_socket_context_connect(1, context, host, port, 0, sizeof(struct handshake_socket), &is_connecting);
+    if (!s || !is_connecting) {
+        printf("Error: connecting did not start right away, is the host an address?\n");
+        exit(-1);
+    }
+
+    struct handshake_socket *handshake_socket = (struct handshake_socket *) us_socket_ext(1, s);
+    handshake_socket->connected_at = latency_now();
+}
+
+void on_tick(struct us_timer_t *t) {
+    if (latency_now() >= recording_until) {
+        print_results();
+        exit(0);
+    }
+}
+
+void on_handshake(struct us_socket_t *s, int success, struct us_bun_verify_error_t verify_error, void *custom_data) {
+    struct handshake_socket *handshake_socket = (struct handshake_socket *) us_socket_ext(1, s);
+    uint64_t now = latency_now();
+
+    if (now >= recording_from) {
+        if (success) {
+            latency_record(&histogram, now - handshake_socket->connected_at);
+            handshakes++;
+        } else {
+            failures++;
+        }
+    }
+
+    /* The replacement is made once this one is closed */
+    us_socket_close(1, s, 0, NULL);
+}
+
+struct us_socket_t *on_handshake_socket_open(struct us_socket_t *s, int is_client, char *ip, int ip_length) {
+    return s;
+}
+
+struct us_socket_t *on_handshake_socket_data(struct us_socket_t *s, char *data, int length) {
+    return s;
+}
+
+struct us_socket_t *on_handshake_socket_writable(struct us_socket_t *s) {
+    return s;
+}
+
+struct us_socket_t *on_handshake_socket_close(struct us_socket_t *s, int code, void *reason) {
+    start_connection();
+    return s;
+}
+
+struct us_socket_t *on_handshake_socket_end(struct us_socket_t *s) {
+    return us_socket_close(1, s, 0, NULL);
+}
+
+struct us_connecting_socket_t *on_handshake_socket_connect_error(struct us_connecting_socket_t *c, int code) {
+    printf("Connection failed!\n");
+    exit(-1);
+    return c;
+}
+
+int main(int argc, char **argv) {
+
+    /* Parse host and port */
+    if (argc != 5) {
+        printf("Usage: connections host port seconds\n");
+        return 0;
+    }
+
+    connections = atoi(argv[1]);
+    host = argv[2];
+    port = atoi(argv[3]);
+    seconds = atoi(argv[4]);
+
+    if (connections < 1 || seconds < 1) {
+        printf("Error: need at least one connection and second\n");
+        return 0;
+    }
+
+    latency_reset(&histogram);
+
+    /* Create the event loop */
+    struct us_loop_t *loop = us_create_loop(0, noop, noop, noop, 0);
+
+    /* Certificates are not verified, only the handshake is measured */
+    struct us_socket_context_options_t options = {};
+    context = us_create_socket_context(1, loop, 0, options);
+
+    /* Set up event handlers */
+    us_socket_context_on_open(1, context, on_handshake_socket_open);
+    us_socket_context_on_data(1, context, on_handshake_socket_data);
+    us_socket_context_on_writable(1, context, on_handshake_socket_writable);
+    us_socket_context_on_close(1, context, on_handshake_socket_close);
+    us_socket_context_on_end(1, context, on_handshake_socket_end);
+    us_socket_context_on_connect_error(1, context, on_handshake_socket_connect_error);
+    us_socket_context_on_handshake(1, context, on_handshake, NULL);
+
+    started_at = latency_now();
+    recording_from = started_at + NS_PER_SECOND;
+    recording_until = recording_from + (uint64_t) seconds * NS_PER_SECOND;
+
+    for (int i = 0; i < connections; i++) {
+        start_connection();
+    }
+
+    struct us_timer_t *timer = us_create_timer(loop, 0, 0);
+    us_timer_set(timer, on_tick, 10, 10);
+
+    us_loop_run(loop);
+}
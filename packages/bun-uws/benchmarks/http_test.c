@@ -0,0 +1,353 @@
+/* This benchmark keeps _connections_ HTTP/1.1 keep-alive connections, each with up to
+   _pipeline_ requests in flight, and reports the latency distribution as JSON.
+
+   With a _rate_ (requests per second over all connections) requests are scheduled open
+   loop and their latency is measured from when they were due to be sent, so a stall in
+   the server counts against every request it held up (see latency.h). A rate of 0 runs
+   closed loop, sending the next request as soon as a response arrives.
+
+   The first second is warm-up and is not recorded. */
+
+#define _GNU_SOURCE
+
+#include <libusockets.h>
+int SSL;
+
+#include "latency.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define MAX_PIPELINE 64
+#define MAX_HEADER_SIZE 4096
+#define NS_PER_SECOND 1000000000ull
+
+char *host;
+int port;
+int connections;
+int pipeline;
+double rate;
+int seconds;
+
+char *request;
+int request_length;
+/* MAX_PIPELINE requests back to back, so a number of them can be written at once */
+char *request_batch;
+int request_batch_length;
+
+/* Nanoseconds between the requests of each connection when open loop */
+uint64_t interval;
+
+struct us_socket_t **sockets;
+int opened_connections;
+
+uint64_t started_at, recording_from, recording_until;
+uint64_t requests, errors;
+struct latency_histogram histogram;
+
+struct http_socket {
+    /* When the next request of this connection is due, open loop only */
+    uint64_t next_due;
+
+    /* When each request in flight was due (or sent, closed loop), oldest first */
+    uint64_t due[MAX_PIPELINE];
+    unsigned int first;
+    unsigned int in_flight;
+
+    /* Bytes of queued requests not yet taken by the socket */
+    int unwritten;
+
+    /* The headers of the response being read, and then how much of its body is left */
+    char header[MAX_HEADER_SIZE];
+    int header_length;
+    long body_remaining;
+};
+
+/* We don't need any of these */
+void noop(struct us_loop_t *loop) {
+
+}
+
+void flush(struct us_socket_t *s) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+
+    /* Requests are all the same, so where we are in one is all we need to know */
+    while (http_socket->unwritten) {
+        int offset = (request_length - http_socket->unwritten % request_length) % request_length;
+        int length = request_batch_length - offset;
+        if (length > http_socket->unwritten) {
+            length = http_socket->unwritten;
+        }
+
+        int written = us_socket_write(SSL, s, request_batch + offset, length, 0);
+        http_socket->unwritten -= written;
+        if (written < length) {
+            break;
+        }
+    }
+}
+
+void send_request(struct us_socket_t *s, uint64_t due) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+
+    http_socket->due[(http_socket->first + http_socket->in_flight++) % MAX_PIPELINE] = due;
+    http_socket->unwritten += request_length;
+}
+
+/* Sends whatever requests are due and fit in the pipeline */
+void send_due(struct us_socket_t *s, uint64_t now) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+
+    if (interval) {
+        /* Requests that do not fit stay due, and their wait counts towards their latency */
+        while (http_socket->next_due <= now && http_socket->in_flight < (unsigned int) pipeline) {
+            send_request(s, http_socket->next_due);
+            http_socket->next_due += interval;
+        }
+    } else {
+        while (http_socket->in_flight < (unsigned int) pipeline) {
+            send_request(s, now);
+        }
+    }
+
+    flush(s);
+}
+
+void print_results() {
+    uint64_t recorded_ns = recording_until - recording_from;
+
+    printf("{\"benchmark\": \"http\", \"connections\": %d, \"pipeline\": %d, \"rate\": %.0f, \"open_loop\": %s, \"seconds\": %d, ",
+        connections, pipeline, rate, interval ? "true" : "false", seconds);
+    printf("\"requests\": %llu, \"requests_per_second\": %.1f, \"errors\": %llu, \"latency\": ",
+        (unsigned long long) requests, (double) requests * NS_PER_SECOND / (double) recorded_ns, (unsigned long long) errors);
+    latency_print_json(stdout, &histogram);
+    printf("}\n");
+}
+
+void on_tick(struct us_timer_t *t) {
+    uint64_t now = latency_now();
+
+    if (now >= recording_until) {
+        print_results();
+        exit(0);
+    }
+
+    if (interval) {
+        for (int i = 0; i < connections; i++) {
+            send_due(sockets[i], now);
+        }
+    }
+}
+
+void start_benchmark(struct us_loop_t *loop) {
+    started_at = latency_now();
+    recording_from = started_at + NS_PER_SECOND;
+    recording_until = recording_from + (uint64_t) seconds * NS_PER_SECOND;
+
+    for (int i = 0; i < connections; i++) {
+        struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, sockets[i]);
+
+        /* Spread the connections out over the interval */
+        http_socket->next_due = started_at + interval * (uint64_t) i / (uint64_t) connections;
+        send_due(sockets[i], started_at);
+    }
+
+    struct us_timer_t *timer = us_create_timer(loop, 0, 0);
+    us_timer_set(timer, on_tick, 1, 1);
+}
+
+void on_response(struct us_socket_t *s, uint64_t now) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+
+    if (!http_socket->in_flight) {
+        printf("ERROR: response without a request!\n");
+        exit(-1);
+    }
+
+    uint64_t due = http_socket->due[http_socket->first];
+    http_socket->first = (http_socket->first + 1) % MAX_PIPELINE;
+    http_socket->in_flight--;
+
+    if (now >= recording_from) {
+        latency_record(&histogram, now - due);
+        requests++;
+    }
+}
+
+/* Takes the status and Content-Length from a complete set of response headers */
+void parse_headers(struct http_socket *http_socket, const char *headers, int length) {
+    if (length < 10 || memcmp(headers, "HTTP/1.1 2", 10)) {
+        errors++;
+    }
+
+    http_socket->body_remaining = -1;
+    for (const char *line = memmem(headers, length, "\r\n", 2); line; line = memmem(line + 2, headers + length - line - 2, "\r\n", 2)) {
+        if (headers + length - line > 17 && !strncasecmp(line + 2, "content-length:", 15)) {
+            http_socket->body_remaining = strtol(line + 17, NULL, 10);
+            break;
+        }
+    }
+    if (http_socket->body_remaining < 0) {
+        printf("ERROR: response without Content-Length!\n");
+        exit(-1);
+    }
+}
+
+/* Reads as many whole responses as there are in data. Every response needs a Content-Length */
+void consume(struct us_socket_t *s, char *data, int length) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+    uint64_t now = latency_now();
+
+    while (length) {
+        if (http_socket->body_remaining < 0) {
+            char *end;
+            if (!http_socket->header_length && (end = memmem(data, length, "\r\n\r\n", 4))) {
+                /* Headers are rarely split, so they are mostly read where they are */
+                int header_length = (int) (end - data) + 4;
+                parse_headers(http_socket, data, header_length);
+                data += header_length;
+                length -= header_length;
+            } else {
+                /* Gather split headers, looking for their end where the previous chunk left off */
+                int searched = http_socket->header_length > 3 ? http_socket->header_length - 3 : 0;
+                int taken = MAX_HEADER_SIZE - http_socket->header_length;
+                if (taken > length) {
+                    taken = length;
+                }
+                memcpy(http_socket->header + http_socket->header_length, data, taken);
+                http_socket->header_length += taken;
+
+                end = memmem(http_socket->header + searched, http_socket->header_length - searched, "\r\n\r\n", 4);
+                if (!end) {
+                    if (http_socket->header_length == MAX_HEADER_SIZE) {
+                        printf("ERROR: response headers are too large!\n");
+                        exit(-1);
+                    }
+                    return;
+                }
+
+                int header_length = (int) (end - http_socket->header) + 4;
+                parse_headers(http_socket, http_socket->header, header_length);
+                data += header_length - (http_socket->header_length - taken);
+                length -= header_length - (http_socket->header_length - taken);
+                http_socket->header_length = 0;
+            }
+        }
+
+        long taken = http_socket->body_remaining < length ? http_socket->body_remaining : length;
+        http_socket->body_remaining -= taken;
+        data += taken;
+        length -= (int) taken;
+
+        if (http_socket->body_remaining == 0) {
+            http_socket->body_remaining = -1;
+            on_response(s, now);
+        }
+    }
+}
+
+struct us_socket_t *on_http_socket_data(struct us_socket_t *s, char *data, int length) {
+    consume(s, data, length);
+    if (started_at) {
+        send_due(s, latency_now());
+    }
+    return s;
+}
+
+struct us_socket_t *on_http_socket_writable(struct us_socket_t *s) {
+    flush(s);
+    return s;
+}
+
+struct us_socket_t *on_http_socket_open(struct us_socket_t *s, int is_client, char *ip, int ip_length) {
+    struct http_socket *http_socket = (struct http_socket *) us_socket_ext(SSL, s);
+    memset(http_socket, 0, sizeof(struct http_socket));
+    http_socket->body_remaining = -1;
+
+    sockets[opened_connections++] = s;
+    if (opened_connections == connections) {
+        start_benchmark(us_socket_context_loop(SSL, us_socket_context(SSL, s)));
+    }
+
+    return s;
+}
+
+struct us_socket_t *on_http_socket_close(struct us_socket_t *s, int code, void *reason) {
+    printf("Client was disconnected, exiting!\n");
+    exit(-1);
+    return s;
+}
+
+struct us_socket_t *on_http_socket_end(struct us_socket_t *s) {
+    return us_socket_close(SSL, s, 0, NULL);
+}
+
+struct us_connecting_socket_t *on_http_socket_connect_error(struct us_connecting_socket_t *c, int code) {
+    printf("Connection failed!\n");
+    exit(-1);
+    return c;
+}
+
+int main(int argc, char **argv) {
+
+    /* Parse host and port */
+    if (argc != 8 && argc != 9) {
+        printf("Usage: connections host port ssl pipeline rate seconds [path]\n");
+        return 0;
+    }
+
+    connections = atoi(argv[1]);
+    host = argv[2];
+    port = atoi(argv[3]);
+    SSL = atoi(argv[4]);
+    pipeline = atoi(argv[5]);
+    rate = atof(argv[6]);
+    seconds = atoi(argv[7]);
+    const char *path = argc == 9 ? argv[8] : "/";
+
+    if (connections < 1 || pipeline < 1 || pipeline > MAX_PIPELINE || seconds < 1) {
+        printf("Error: need at least one connection and second, and a pipeline of 1 to %d\n", MAX_PIPELINE);
+        return 0;
+    }
+    interval = rate > 0 ? (uint64_t) ((double) connections * NS_PER_SECOND / rate) : 0;
+
+    /* Every request is the same */
+    request = malloc(strlen(path) + strlen(host) + 64);
+    request_length = sprintf(request, "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", path, host);
+    request_batch_length = request_length * MAX_PIPELINE;
+    request_batch = malloc(request_batch_length);
+    for (int i = 0; i < MAX_PIPELINE; i++) {
+        memcpy(request_batch + i * request_length, request, request_length);
+    }
+
+    sockets = calloc(connections, sizeof(struct us_socket_t *));
+    latency_reset(&histogram);
+
+    /* Create the event loop */
+    struct us_loop_t *loop = us_create_loop(0, noop, noop, noop, 0);
+
+    /* Create a socket context for HTTP */
+    struct us_socket_context_options_t options = {};
+    struct us_socket_context_t *http_context = us_create_socket_context(SSL, loop, 0, options);
+
+    /* Set up event handlers */
+    us_socket_context_on_open(SSL, http_context, on_http_socket_open);
+    us_socket_context_on_data(SSL, http_context, on_http_socket_data);
+    us_socket_context_on_writable(SSL, http_context, on_http_socket_writable);
+    us_socket_context_on_close(SSL, http_context, on_http_socket_close);
+    us_socket_context_on_end(SSL, http_context, on_http_socket_end);
+    us_socket_context_on_connect_error(SSL, http_context, on_http_socket_connect_error);
+
+    /* Start making HTTP connections */
+    for (int i = 0; i < connections; i++) {
+        int is_connecting = 0;
+        if (!us_socket_context_connect(SSL, http_context, host, port, 0, sizeof(struct http_socket), &is_connecting)) {
+            printf("Connection failed immediately\n");
+            return 0;
+        }
+    }
+
+    us_loop_run(loop);
+}
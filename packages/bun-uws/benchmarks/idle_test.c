@@ -0,0 +1,187 @@
+/* This benchmark opens _connections_ WebSockets to benchmark_server and leaves them idle,
+   reporting how much the resident memory of the server (given its pid) grew per socket.
+
+   Connections are made at most BATCH at a time so that the listen backlog does not
+   overflow. Every connection from one address needs its own ephemeral port, so going beyond
+   about 28000 needs a wider ip_local_port_range or more than one address to connect to. */
+
+#include <libusockets.h>
+int SSL;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH 256
+/* How long to wait after the last upgrade, for the server to settle */
+#define SETTLE_MS 2000
+
+char request[] = "GET / HTTP/1.1\r\n"
+                 "Upgrade: websocket\r\n"
+                 "Connection: Upgrade\r\n"
+                 "Sec-WebSocket-Key: x3JJHMbDL1EzLkh9GBhXDw==\r\n"
+                 "Host: server.example.com\r\n"
+                 "Sec-WebSocket-Version: 13\r\n\r\n";
+char *host;
+int port;
+int connections;
+int server_pid;
+
+struct us_socket_context_t *context;
+int started_connections;
+int upgraded_connections;
+long rss_before_kb;
+
+struct idle_socket {
+    /* Bytes of the upgrade request not yet taken by the socket */
+    int upgrade_offset;
+
+    /* Bytes of the end of the upgrade response seen */
+    int response_matched;
+};
+
+/* We don't need any of these */
+void noop(struct us_loop_t *loop) {
+
+}
+
+/* VmRSS of the server, in kilobytes */
+long read_rss_kb() {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", server_pid);
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("Error: cannot read %s\n", path);
+        exit(-1);
+    }
+
+    char line[256];
+    long rss = -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (!strncmp(line, "VmRSS:", 6)) {
+            rss = strtol(line + 6, NULL, 10);
+            break;
+        }
+    }
+    fclose(f);
+    return rss;
+}
+
+void start_connection() {
+    int is_connecting = 0;
+    started_connections++;
+    if (!us_socket_context_connect(SSL, context, host, port, 0, sizeof(struct idle_socket), &is_connecting)) {
+        printf("Connection failed immediately\n");
+        exit(-1);
+    }
+}
+
+void on_settled(struct us_timer_t *t) {
+    long rss_after_kb = read_rss_kb();
+
+    printf("{\"benchmark\": \"idle\", \"connections\": %d, \"rss_before_kb\": %ld, \"rss_after_kb\": %ld, \"bytes_per_connection\": %.1f}\n",
+        connections, rss_before_kb, rss_after_kb, (double) (rss_after_kb - rss_before_kb) * 1024.0 / (double) connections);
+    exit(0);
+}
+
+struct us_socket_t *on_idle_socket_data(struct us_socket_t *s, char *data, int length) {
+    struct idle_socket *idle_socket = (struct idle_socket *) us_socket_ext(SSL, s);
+    static const char end[] = "\r\n\r\n";
+
+    if (idle_socket->response_matched == 4) {
+        return s;
+    }
+    while (length && idle_socket->response_matched < 4) {
+        idle_socket->response_matched = *data == end[idle_socket->response_matched] ? idle_socket->response_matched + 1 : (*data == '\r');
+        data++;
+        length--;
+    }
+    if (idle_socket->response_matched < 4) {
+        return s;
+    }
+
+    /* One upgrade done, one more connection */
+    if (++upgraded_connections == connections) {
+        struct us_timer_t *timer = us_create_timer(us_socket_context_loop(SSL, context), 0, 0);
+        us_timer_set(timer, on_settled, SETTLE_MS, 0);
+    } else if (started_connections < connections) {
+        start_connection();
+    }
+    return s;
+}
+
+struct us_socket_t *on_idle_socket_writable(struct us_socket_t *s) {
+    struct idle_socket *idle_socket = (struct idle_socket *) us_socket_ext(SSL, s);
+
+    if (idle_socket->upgrade_offset < (int) sizeof(request) - 1) {
+        idle_socket->upgrade_offset += us_socket_write(SSL, s, request + idle_socket->upgrade_offset, sizeof(request) - 1 - idle_socket->upgrade_offset, 0);
+    }
+    return s;
+}
+
+struct us_socket_t *on_idle_socket_open(struct us_socket_t *s, int is_client, char *ip, int ip_length) {
+    struct idle_socket *idle_socket = (struct idle_socket *) us_socket_ext(SSL, s);
+    memset(idle_socket, 0, sizeof(struct idle_socket));
+
+    idle_socket->upgrade_offset = us_socket_write(SSL, s, request, sizeof(request) - 1, 0);
+    return s;
+}
+
+struct us_socket_t *on_idle_socket_close(struct us_socket_t *s, int code, void *reason) {
+    printf("Client was disconnected, exiting!\n");
+    exit(-1);
+    return s;
+}
+
+struct us_socket_t *on_idle_socket_end(struct us_socket_t *s) {
+    return us_socket_close(SSL, s, 0, NULL);
+}
+
+struct us_connecting_socket_t *on_idle_socket_connect_error(struct us_connecting_socket_t *c, int code) {
+    printf("Connection failed after %d connections!\n", upgraded_connections);
+    exit(-1);
+    return c;
+}
+
+int main(int argc, char **argv) {
+
+    /* Parse host and port */
+    if (argc != 6) {
+        printf("Usage: connections host port ssl server_pid\n");
+        return 0;
+    }
+
+    connections = atoi(argv[1]);
+    host = argv[2];
+    port = atoi(argv[3]);
+    SSL = atoi(argv[4]);
+    server_pid = atoi(argv[5]);
+
+    if (connections < 1) {
+        printf("Error: need at least one connection\n");
+        return 0;
+    }
+
+    rss_before_kb = read_rss_kb();
+
+    /* Create the event loop */
+    struct us_loop_t *loop = us_create_loop(0, noop, noop, noop, 0);
+
+    /* Create a socket context for the WebSockets */
+    struct us_socket_context_options_t options = {};
+    context = us_create_socket_context(SSL, loop, 0, options);
+
+    /* Set up event handlers */
+    us_socket_context_on_open(SSL, context, on_idle_socket_open);
+    us_socket_context_on_data(SSL, context, on_idle_socket_data);
+    us_socket_context_on_writable(SSL, context, on_idle_socket_writable);
+    us_socket_context_on_close(SSL, context, on_idle_socket_close);
+    us_socket_context_on_end(SSL, context, on_idle_socket_end);
+    us_socket_context_on_connect_error(SSL, context, on_idle_socket_connect_error);
+
+    for (int i = 0; i < BATCH && i < connections; i++) {
+        start_connection();
+    }
+
+    us_loop_run(loop);
+}
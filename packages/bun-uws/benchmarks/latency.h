@@ -0,0 +1,150 @@
+/* Latency histograms shared by the benchmarks, in C so that both the C clients and the C++
+ * micro benchmarks can use them.
+ *
+ * Values are nanoseconds in log-linear (HDR style) buckets: every power of two is split
+ * in 128 linear buckets, so a reported percentile is never more than 1/128 (0.8%) above
+ * the true value. Everything up to 2^40 ns (about 18 minutes) fits in 36KB.
+ *
+ * Closed loop clients wait for a response before sending the next request, so a stall
+ * holds back the requests that would have been sent during it and they never get to see
+ * it (coordinated omission). There are two ways around that here:
+ *
+ * - Open loop: requests are scheduled at a fixed rate and latency is measured from when
+ *   a request was meant to be sent, not from when it was, like wrk2 does.
+ * - latency_record_corrected: for a value larger than the expected interval between
+ *   requests, also records the values the requests that could not be sent would have
+ *   seen, like HdrHistogram's recordCorrectedValue. */
+
+#ifndef BENCHMARKS_LATENCY_H
+#define BENCHMARKS_LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define LATENCY_SUB_BUCKET_BITS 7
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_MAGNITUDE 40
+#define LATENCY_BUCKET_COUNT ((LATENCY_MAX_MAGNITUDE - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+struct latency_histogram {
+    uint64_t buckets[LATENCY_BUCKET_COUNT];
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+};
+
+static inline uint64_t latency_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline void latency_reset(struct latency_histogram *h) {
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+static inline unsigned int latency_bucket_index(uint64_t value) {
+    /* Values below two full sub bucket ranges are stored exactly */
+    if (value < 2 * LATENCY_SUB_BUCKETS) {
+        return (unsigned int) value;
+    }
+    if (value >= (1ull << LATENCY_MAX_MAGNITUDE)) {
+        return LATENCY_BUCKET_COUNT - 1;
+    }
+    unsigned int magnitude = 63 - (unsigned int) __builtin_clzll(value);
+    unsigned int shift = magnitude - LATENCY_SUB_BUCKET_BITS;
+    return (shift + 1) * LATENCY_SUB_BUCKETS + (unsigned int) (value >> shift) - LATENCY_SUB_BUCKETS;
+}
+
+/* Highest value that maps to given bucket */
+static inline uint64_t latency_bucket_upper_bound(unsigned int index) {
+    if (index < 2 * LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+    unsigned int shift = index / LATENCY_SUB_BUCKETS - 1;
+    uint64_t lower = (uint64_t) (LATENCY_SUB_BUCKETS + index % LATENCY_SUB_BUCKETS) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+static inline void latency_record_n(struct latency_histogram *h, uint64_t value, uint64_t n) {
+    h->buckets[latency_bucket_index(value)] += n;
+    h->count += n;
+    h->sum += (double) value * (double) n;
+    if (value < h->min) {
+        h->min = value;
+    }
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+static inline void latency_record(struct latency_histogram *h, uint64_t value) {
+    latency_record_n(h, value, 1);
+}
+
+/* Records value, and if it exceeds expected_interval, the values value - expected_interval,
+ * value - 2 * expected_interval and so on down to expected_interval */
+static inline void latency_record_corrected(struct latency_histogram *h, uint64_t value, uint64_t expected_interval) {
+    latency_record(h, value);
+    if (!expected_interval) {
+        return;
+    }
+    for (uint64_t missing = value > expected_interval ? value - expected_interval : 0; missing >= expected_interval; missing -= expected_interval) {
+        latency_record(h, missing);
+    }
+}
+
+static inline void latency_merge(struct latency_histogram *into, const struct latency_histogram *from) {
+    for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+    into->count += from->count;
+    into->sum += from->sum;
+    if (from->min < into->min) {
+        into->min = from->min;
+    }
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+/* Value at given percentile (0 - 100), never above the recorded max */
+static inline uint64_t latency_percentile(const struct latency_histogram *h, double p) {
+    if (!h->count) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t) (p / 100.0 * (double) h->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = latency_bucket_upper_bound(i);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
+
+/* Prints the histogram as a JSON object, in microseconds, without a trailing newline */
+static inline void latency_print_json(FILE *f, const struct latency_histogram *h) {
+    fprintf(f, "{\"count\": %llu, \"min_us\": %.3f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f}",
+        (unsigned long long) h->count,
+        h->count ? (double) h->min / 1000.0 : 0.0,
+        h->count ? h->sum / (double) h->count / 1000.0 : 0.0,
+        (double) latency_percentile(h, 50) / 1000.0,
+        (double) latency_percentile(h, 90) / 1000.0,
+        (double) latency_percentile(h, 99) / 1000.0,
+        (double) latency_percentile(h, 99.9) / 1000.0,
+        (double) h->max / 1000.0);
+}
+
+#endif // BENCHMARKS_LATENCY_H
@@ -28,6 +28,8 @@
 
 #include <libusockets.h>
 int SSL;
+/* Where us_socket_context_connect says whether it connected right away, which we do not need */
+int is_connecting;
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -143,7 +145,7 @@ void on_post(struct us_loop_t *loop) {
 void next_connection(struct us_socket_t *s) {
     /* We could wait with this until properly upgraded */
     if (--connections) {
-        us_socket_context_connect(SSL, us_socket_context(SSL, s), host, port, NULL, 0, sizeof(struct http_socket));
+        us_socket_context_connect(SSL, us_socket_context(SSL, s), host, port, 0, sizeof(struct http_socket), &is_connecting);
     } else {
         printf("Running benchmark now...\n");
 
@@ -301,7 +303,7 @@ int main(int argc, char **argv) {
     us_socket_context_on_end(SSL, http_context, on_http_socket_end);
 
     /* Start making HTTP connections */
-    us_socket_context_connect(SSL, http_context, host, port, NULL, 0, sizeof(struct http_socket));
+    us_socket_context_connect(SSL, http_context, host, port, 0, sizeof(struct http_socket), &is_connecting);
 
     us_loop_run(loop);
 }
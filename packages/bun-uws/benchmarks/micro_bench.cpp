@@ -0,0 +1,167 @@
+/* In-process benchmarks of HttpParser and TopicTree, so that a regression in either shows
+ * without the noise of the network or a second process. Prints one JSON object per line:
+ * operations per second, and the distribution of the time per operation, taken as the
+ * mean of each batch of operations */
+
+#include "../src/HttpParser.h"
+#include "../src/TopicTree.h"
+
+#include "latency.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const int SAMPLES = 2000;
+
+/* Runs batch SAMPLES times, each doing operationsPerBatch operations, after one batch of warm-up */
+template <typename F>
+static void run(const char *name, int operationsPerBatch, F batch) {
+    struct latency_histogram *histogram = (struct latency_histogram *) malloc(sizeof(struct latency_histogram));
+    latency_reset(histogram);
+
+    batch();
+    uint64_t total = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        uint64_t start = latency_now();
+        batch();
+        uint64_t elapsed = latency_now() - start;
+        total += elapsed;
+        latency_record(histogram, elapsed / (uint64_t) operationsPerBatch);
+    }
+
+    uint64_t operations = (uint64_t) SAMPLES * (uint64_t) operationsPerBatch;
+    printf("{\"benchmark\": \"%s\", \"operations\": %llu, \"ops_per_second\": %.1f, \"latency\": ",
+        name, (unsigned long long) operations, (double) operations * 1e9 / (double) total);
+    latency_print_json(stdout, histogram);
+    printf("}\n");
+    fflush(stdout);
+    free(histogram);
+}
+
+static const std::string request = "GET /api/v1/users/12345?fields=name,email HTTP/1.1\r\n"
+                                   "Host: localhost:3000\r\n"
+                                   "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+                                   "Accept: application/json, text/plain, */*\r\n"
+                                   "Accept-Language: en-US,en;q=0.9\r\n"
+                                   "Accept-Encoding: gzip, deflate, br\r\n"
+                                   "Cookie: session=5f2b8c1e9a7d4e3f; theme=dark\r\n"
+                                   "Connection: keep-alive\r\n"
+                                   "\r\n";
+
+/* Parses count back to back requests per batch, like a pipelining client sends them */
+static void benchmarkHttpParser(const char *name, int count, int batches) {
+    std::string buffer;
+    for (int i = 0; i < count; i++) {
+        buffer += request;
+    }
+    unsigned int length = (unsigned int) buffer.length();
+    buffer.append(uWS::MINIMUM_HTTP_POST_PADDING, '\0');
+
+    uWS::HttpParser parser;
+    int parsed = 0;
+    run(name, count * batches, [&]() {
+        for (int i = 0; i < batches; i++) {
+            parser.consumePostPadded(buffer.data(), length, &parsed, nullptr, [](void *user, uWS::HttpRequest *req) -> void * {
+                (*(int *) user) += !req->getHeader("host").empty();
+                return user;
+            }, [](void *user, std::string_view, bool) -> void * {
+                return user;
+            }, [](void *) -> void * {
+                fprintf(stderr, "HttpParser rejected the benchmark request\n");
+                exit(1);
+                return nullptr;
+            });
+        }
+    });
+
+    if (parsed != count * batches * (SAMPLES + 1)) {
+        fprintf(stderr, "HttpParser parsed %d requests, not %d\n", parsed, count * batches * (SAMPLES + 1));
+        exit(1);
+    }
+}
+
+/* Publishes to topics of subscribersPerTopic subscribers each, draining every drainEvery publishes */
+static void benchmarkTopicTree(const char *name, int topics, int subscribersPerTopic, int topicsPerSubscriber, int drainEvery) {
+    uint64_t delivered = 0;
+    uWS::TopicTree<std::string, std::string_view> topicTree([&delivered](uWS::Subscriber *, std::string &message, auto) {
+        delivered += message.length();
+        return false;
+    });
+
+    std::vector<std::string> topicNames;
+    for (int i = 0; i < topics; i++) {
+        topicNames.push_back("room/" + std::to_string(i));
+    }
+
+    /* Every subscriber is in topicsPerSubscriber topics spread out over all of them */
+    int subscribers = topics * subscribersPerTopic / topicsPerSubscriber;
+    std::vector<uWS::Subscriber *> all;
+    for (int i = 0; i < subscribers; i++) {
+        uWS::Subscriber *s = topicTree.createSubscriber();
+        for (int j = 0; j < topicsPerSubscriber; j++) {
+            topicTree.subscribe(s, topicNames[(size_t) ((i + j * subscribers / topicsPerSubscriber) % topics)]);
+        }
+        all.push_back(s);
+    }
+
+    unsigned int next = 0;
+    run(name, drainEvery, [&]() {
+        for (int i = 0; i < drainEvery; i++) {
+            topicTree.publish(nullptr, topicNames[next++ % (unsigned int) topics], std::string("{\"type\":\"message\",\"body\":\"hello\"}"));
+        }
+        topicTree.drain();
+    });
+
+    for (uWS::Subscriber *s : all) {
+        topicTree.freeSubscriber(s);
+    }
+
+    if (!delivered) {
+        fprintf(stderr, "TopicTree delivered nothing\n");
+        exit(1);
+    }
+}
+
+/* Subscribing and unsubscribing, as sockets join and leave rooms */
+static void benchmarkTopicTreeChurn(const char *name, int topics, int subscribers) {
+    uWS::TopicTree<std::string, std::string_view> topicTree([](uWS::Subscriber *, std::string &, auto) {
+        return false;
+    });
+
+    std::vector<std::string> topicNames;
+    for (int i = 0; i < topics; i++) {
+        topicNames.push_back("room/" + std::to_string(i));
+    }
+
+    std::vector<uWS::Subscriber *> all;
+    for (int i = 0; i < subscribers; i++) {
+        all.push_back(topicTree.createSubscriber());
+        topicTree.subscribe(all.back(), topicNames[(size_t) (i % topics)]);
+    }
+
+    unsigned int next = 0;
+    run(name, 1000, [&]() {
+        for (int i = 0; i < 1000; i++, next++) {
+            /* Never the topic the subscriber is in already */
+            unsigned int index = next % (unsigned int) all.size();
+            uWS::Subscriber *s = all[index];
+            const std::string &topic = topicNames[(index + 1 + next % (unsigned int) (topics - 1)) % (unsigned int) topics];
+            topicTree.subscribe(s, topic);
+            topicTree.unsubscribe(s, topic);
+        }
+    });
+
+    for (uWS::Subscriber *s : all) {
+        topicTree.freeSubscriber(s);
+    }
+}
+
+int main() {
+    benchmarkHttpParser("http_parser_request", 1, 256);
+    benchmarkHttpParser("http_parser_pipelined_16", 16, 16);
+    benchmarkTopicTree("topic_tree_fanout_1000", 1, 1000, 1, 1);
+    benchmarkTopicTree("topic_tree_rooms_1000x100", 1000, 100, 10, 100);
+    benchmarkTopicTreeChurn("topic_tree_subscribe_unsubscribe", 1000, 10000);
+}
@@ -0,0 +1,299 @@
+/* This benchmark connects _subscribers_ WebSockets to benchmark_server, which subscribes
+   every one of them to the same topic and publishes to it whatever it is sent. The first
+   socket publishes _rate_ messages per second, so every message fans out to all sockets.
+
+   Every message carries the time it was due to be sent, and its latency is measured from
+   then until each socket receives it, so a publisher held up by backpressure or a slow
+   fan-out counts against every message it delays (see latency.h).
+
+   The first second is warm-up and is not recorded. */
+
+#include <libusockets.h>
+int SSL;
+
+#include "latency.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NS_PER_SECOND 1000000000ull
+/* Most messages published at once, when the publisher has fallen behind */
+#define MAX_BATCH 256
+
+/* A masked binary frame of 8 bytes, with a zero mask so the payload goes as is */
+#define CLIENT_FRAME_SIZE 14
+/* And how the server sends it */
+#define SERVER_FRAME_SIZE 10
+
+char request[] = "GET / HTTP/1.1\r\n"
+                 "Upgrade: websocket\r\n"
+                 "Connection: Upgrade\r\n"
+                 "Sec-WebSocket-Key: x3JJHMbDL1EzLkh9GBhXDw==\r\n"
+                 "Host: server.example.com\r\n"
+                 "Sec-WebSocket-Version: 13\r\n\r\n";
+char *host;
+int port;
+int subscribers;
+double rate;
+int seconds;
+
+uint64_t interval;
+
+struct us_socket_t *publisher;
+int upgraded_sockets;
+
+uint64_t started_at, recording_from, recording_until;
+uint64_t messages, deliveries;
+struct latency_histogram histogram;
+
+struct pubsub_socket {
+    /* Bytes of the upgrade request not yet taken by the socket */
+    int upgrade_offset;
+
+    /* Bytes of the upgrade response seen, up to and including its end */
+    int response_matched;
+    int is_upgraded;
+
+    /* The start of a frame split over reads */
+    char carry[SERVER_FRAME_SIZE];
+    int carry_length;
+};
+
+/* The publisher's frames, and how far they have been written */
+char batch[MAX_BATCH * CLIENT_FRAME_SIZE];
+int batch_length;
+int batch_offset;
+uint64_t next_due;
+
+/* We don't need any of these */
+void noop(struct us_loop_t *loop) {
+
+}
+
+void print_results() {
+    uint64_t recorded_ns = recording_until - recording_from;
+
+    printf("{\"benchmark\": \"pubsub\", \"subscribers\": %d, \"rate\": %.0f, \"seconds\": %d, ", subscribers, rate, seconds);
+    printf("\"messages\": %llu, \"deliveries\": %llu, \"deliveries_per_second\": %.1f, \"latency\": ",
+        (unsigned long long) messages, (unsigned long long) deliveries, (double) deliveries * NS_PER_SECOND / (double) recorded_ns);
+    latency_print_json(stdout, &histogram);
+    printf("}\n");
+}
+
+/* Writes what is left of the batch, and then the messages that are due, if that went through */
+void publish_due(uint64_t now) {
+    while (1) {
+        if (batch_offset < batch_length) {
+            batch_offset += us_socket_write(SSL, publisher, batch + batch_offset, batch_length - batch_offset, 0);
+            if (batch_offset < batch_length) {
+                return;
+            }
+        }
+
+        /* Messages that could not be sent stay due, keeping the time they were due at */
+        batch_length = batch_offset = 0;
+        while (next_due <= now && batch_length < MAX_BATCH * CLIENT_FRAME_SIZE) {
+            unsigned char *frame = (unsigned char *) batch + batch_length;
+            frame[0] = 130;
+            frame[1] = 128 | 8;
+            memset(frame + 2, 0, 4);
+            memcpy(frame + 6, &next_due, 8);
+            batch_length += CLIENT_FRAME_SIZE;
+
+            if (next_due >= recording_from && next_due < recording_until) {
+                messages++;
+            }
+            next_due += interval;
+        }
+
+        if (!batch_length) {
+            return;
+        }
+    }
+}
+
+void on_tick(struct us_timer_t *t) {
+    uint64_t now = latency_now();
+
+    /* Give the last messages a moment to arrive */
+    if (now >= recording_until + NS_PER_SECOND / 10) {
+        print_results();
+        exit(0);
+    }
+
+    if (now < recording_until) {
+        publish_due(now);
+    }
+}
+
+void start_benchmark(struct us_loop_t *loop) {
+    started_at = latency_now();
+    recording_from = started_at + NS_PER_SECOND;
+    recording_until = recording_from + (uint64_t) seconds * NS_PER_SECOND;
+    next_due = started_at;
+
+    struct us_timer_t *timer = us_create_timer(loop, 0, 0);
+    us_timer_set(timer, on_tick, 1, 1);
+}
+
+void on_message(uint64_t due, uint64_t now) {
+    if (due >= recording_from && due < recording_until) {
+        latency_record(&histogram, now - due);
+        deliveries++;
+    }
+}
+
+/* Reads the frames in data, all of them binary and 8 bytes */
+void consume(struct pubsub_socket *pubsub_socket, char *data, int length) {
+    uint64_t now = latency_now();
+    uint64_t due;
+
+    if (pubsub_socket->carry_length) {
+        int taken = SERVER_FRAME_SIZE - pubsub_socket->carry_length;
+        if (taken > length) {
+            taken = length;
+        }
+        memcpy(pubsub_socket->carry + pubsub_socket->carry_length, data, taken);
+        pubsub_socket->carry_length += taken;
+        data += taken;
+        length -= taken;
+
+        if (pubsub_socket->carry_length < SERVER_FRAME_SIZE) {
+            return;
+        }
+        memcpy(&due, pubsub_socket->carry + 2, 8);
+        on_message(due, now);
+        pubsub_socket->carry_length = 0;
+    }
+
+    for (; length >= SERVER_FRAME_SIZE; data += SERVER_FRAME_SIZE, length -= SERVER_FRAME_SIZE) {
+        if ((unsigned char) data[0] != 130 || data[1] != 8) {
+            printf("ERROR: unexpected frame from the server!\n");
+            exit(-1);
+        }
+        memcpy(&due, data + 2, 8);
+        on_message(due, now);
+    }
+
+    memcpy(pubsub_socket->carry, data, length);
+    pubsub_socket->carry_length = length;
+}
+
+struct us_socket_t *on_pubsub_socket_data(struct us_socket_t *s, char *data, int length) {
+    struct pubsub_socket *pubsub_socket = (struct pubsub_socket *) us_socket_ext(SSL, s);
+
+    if (!pubsub_socket->is_upgraded) {
+        /* The response ends with the first empty line, and the server says nothing before we publish */
+        static const char end[] = "\r\n\r\n";
+        while (length && pubsub_socket->response_matched < 4) {
+            pubsub_socket->response_matched = *data == end[pubsub_socket->response_matched] ? pubsub_socket->response_matched + 1 : (*data == '\r');
+            data++;
+            length--;
+        }
+
+        if (pubsub_socket->response_matched < 4) {
+            return s;
+        }
+
+        pubsub_socket->is_upgraded = 1;
+        if (++upgraded_sockets == subscribers) {
+            start_benchmark(us_socket_context_loop(SSL, us_socket_context(SSL, s)));
+        }
+    }
+
+    consume(pubsub_socket, data, length);
+    return s;
+}
+
+struct us_socket_t *on_pubsub_socket_writable(struct us_socket_t *s) {
+    struct pubsub_socket *pubsub_socket = (struct pubsub_socket *) us_socket_ext(SSL, s);
+
+    if (pubsub_socket->upgrade_offset < (int) sizeof(request) - 1) {
+        pubsub_socket->upgrade_offset += us_socket_write(SSL, s, request + pubsub_socket->upgrade_offset, sizeof(request) - 1 - pubsub_socket->upgrade_offset, 0);
+    } else if (s == publisher && started_at) {
+        publish_due(latency_now());
+    }
+    return s;
+}
+
+struct us_socket_t *on_pubsub_socket_open(struct us_socket_t *s, int is_client, char *ip, int ip_length) {
+    struct pubsub_socket *pubsub_socket = (struct pubsub_socket *) us_socket_ext(SSL, s);
+    memset(pubsub_socket, 0, sizeof(struct pubsub_socket));
+
+    if (!publisher) {
+        publisher = s;
+    }
+
+    pubsub_socket->upgrade_offset = us_socket_write(SSL, s, request, sizeof(request) - 1, 0);
+    return s;
+}
+
+struct us_socket_t *on_pubsub_socket_close(struct us_socket_t *s, int code, void *reason) {
+    printf("Client was disconnected, exiting!\n");
+    exit(-1);
+    return s;
+}
+
+struct us_socket_t *on_pubsub_socket_end(struct us_socket_t *s) {
+    return us_socket_close(SSL, s, 0, NULL);
+}
+
+struct us_connecting_socket_t *on_pubsub_socket_connect_error(struct us_connecting_socket_t *c, int code) {
+    printf("Connection failed!\n");
+    exit(-1);
+    return c;
+}
+
+int main(int argc, char **argv) {
+
+    /* Parse host and port */
+    if (argc != 7) {
+        printf("Usage: subscribers host port ssl rate seconds\n");
+        return 0;
+    }
+
+    subscribers = atoi(argv[1]);
+    host = argv[2];
+    port = atoi(argv[3]);
+    SSL = atoi(argv[4]);
+    rate = atof(argv[5]);
+    seconds = atoi(argv[6]);
+
+    if (subscribers < 1 || rate <= 0 || seconds < 1) {
+        printf("Error: need at least one subscriber and second, and a rate\n");
+        return 0;
+    }
+    interval = (uint64_t) (NS_PER_SECOND / rate);
+    if (!interval) {
+        interval = 1;
+    }
+
+    latency_reset(&histogram);
+
+    /* Create the event loop */
+    struct us_loop_t *loop = us_create_loop(0, noop, noop, noop, 0);
+
+    /* Create a socket context for the WebSockets */
+    struct us_socket_context_options_t options = {};
+    struct us_socket_context_t *context = us_create_socket_context(SSL, loop, 0, options);
+
+    /* Set up event handlers */
+    us_socket_context_on_open(SSL, context, on_pubsub_socket_open);
+    us_socket_context_on_data(SSL, context, on_pubsub_socket_data);
+    us_socket_context_on_writable(SSL, context, on_pubsub_socket_writable);
+    us_socket_context_on_close(SSL, context, on_pubsub_socket_close);
+    us_socket_context_on_end(SSL, context, on_pubsub_socket_end);
+    us_socket_context_on_connect_error(SSL, context, on_pubsub_socket_connect_error);
+
+    /* Start connecting */
+    for (int i = 0; i < subscribers; i++) {
+        int is_connecting = 0;
+        if (!us_socket_context_connect(SSL, context, host, port, 0, sizeof(struct pubsub_socket), &is_connecting)) {
+            printf("Connection failed immediately\n");
+            return 0;
+        }
+    }
+
+    us_loop_run(loop);
+}
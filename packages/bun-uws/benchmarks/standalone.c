@@ -0,0 +1,89 @@
+/* Our usockets leaves locking, DNS and the dispatch of non-socket polls to Bun. This provides
+ * just enough of those for the benchmark clients and server to link without Bun: lookups
+ * are done synchronously and only their first address is used */
+
+#include "internal/internal.h"
+
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+void Bun__lock(uint32_t *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+void Bun__unlock(uint32_t *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/* Loop.h asks before freeing the loop of a thread that goes away */
+int bun_is_exiting(void) {
+    return 0;
+}
+
+void Bun__internal_dispatch_ready_poll(void *loop, void *poll) {
+    fprintf(stderr, "Bun__internal_dispatch_ready_poll: benchmarks only use usockets polls\n");
+    abort();
+}
+
+struct addrinfo_request {
+    struct addrinfo_result result;
+    struct addrinfo_result_entry entry;
+};
+
+int Bun__addrinfo_get(struct us_loop_t *loop, const char *host, struct addrinfo_request **ptr) {
+    struct addrinfo_request *req = calloc(1, sizeof(struct addrinfo_request));
+    *ptr = req;
+
+    struct addrinfo hints = {0}, *list;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int error = getaddrinfo(host, NULL, &hints, &list);
+    if (error) {
+        req->result.error = error == EAI_SYSTEM ? errno : ECONNREFUSED;
+        return 0;
+    }
+
+    /* A single entry so that usockets always takes its synchronous path */
+    memcpy(&req->entry._storage, list->ai_addr, list->ai_addrlen);
+    req->entry.info = *list;
+    req->entry.info.ai_addr = (struct sockaddr *) &req->entry._storage;
+    req->entry.info.ai_canonname = NULL;
+    req->entry.info.ai_next = NULL;
+    req->result.entries = &req->entry;
+    freeaddrinfo(list);
+    return 0;
+}
+
+int Bun__addrinfo_set(struct addrinfo_request *ptr, struct us_connecting_socket_t *socket) {
+    fprintf(stderr, "Bun__addrinfo_set: lookups are synchronous in benchmarks\n");
+    abort();
+}
+
+void Bun__addrinfo_freeRequest(struct addrinfo_request *addrinfo_req, int error) {
+    free(addrinfo_req);
+}
+
+struct addrinfo_result *Bun__addrinfo_getRequestResult(struct addrinfo_request *addrinfo_req) {
+    return &addrinfo_req->result;
+}
+
+#ifdef LIBUS_NO_SSL
+/* Referenced by usockets even when it is built without TLS, and never reached then */
+int us_internal_raw_root_certs(struct us_cert_string_t **out) {
+    return 0;
+}
+
+void *us_internal_ssl_socket_open(void *s, int is_client, char *ip, int ip_length) {
+    return NULL;
+}
+
+void *us_internal_ssl_socket_wrap_with_tls(struct us_socket_t *s, struct us_bun_socket_context_options_t options, struct us_socket_events_t events, int socket_ext_size) {
+    return NULL;
+}
+#endif
@@ -26,6 +26,31 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
 
     std::string_view body((char *) mutableMemory + 1 + contentType.length(), size);
 
+    /* The streaming parser must not care for how the body is split up (it runs first since
+     * the other parser modifies the body) */
+    std::string events[2];
+    for (int pass = 0; pass < 2; pass++) {
+        size_t chunkSize = pass ? (size_t) 1 + contentTypeLength % 7 : body.length();
+        uWS::StreamingMultipartParser smp(contentType);
+        for (size_t offset = 0; offset < body.length() && smp.isValid(); offset += chunkSize) {
+            smp.write(body.substr(offset, chunkSize), [&events = events[pass]](std::pair<std::string_view, std::string_view> *headers) {
+                events += "<part>";
+                for (int i = 0; headers[i].first.length(); i++) {
+                    events.append(headers[i].first).append(":").append(headers[i].second).append(";");
+                }
+            }, [&events = events[pass]](std::string_view data, bool last) {
+                events.append(data);
+                if (last) {
+                    events += "</part>";
+                }
+            });
+        }
+        events[pass] += smp.isValid() ? (smp.isDone() ? "done" : "partial") : "error";
+    }
+    if (events[0] != events[1]) {
+        abort();
+    }
+
     uWS::MultipartParser mp(contentType);
     if (mp.isValid()) {
         mp.setBody(body);
@@ -22,6 +22,8 @@
 #include <string>
 #include <charconv>
 #include <string_view>
+#include <memory>
+#include <vector>
 
 namespace uWS {
     /* Safari 15.0 - 15.3 has a completely broken compression implementation (client_no_context_takeover not
@@ -119,6 +121,16 @@ public:
         return std::move(*this);
     }
 
+    /* Swaps the certificate of a server name added before, keeping its router */
+    TemplatedApp &&replaceServerName(std::string hostname_pattern, SocketContextOptions options = {}) {
+
+        if constexpr (SSL) {
+            us_bun_socket_context_replace_server_name(SSL, (struct us_socket_context_t *) httpContext, hostname_pattern.c_str(), options);
+        }
+
+        return std::move(*this);
+    }
+
     TemplatedApp &&removeServerName(std::string hostname_pattern) {
     
         /* This will do for now, would be better if us_socket_context_remove_server_name returned the user data */
@@ -176,7 +188,7 @@ public:
                 auto *ws = (WebSocket<SSL, true, int> *) s->user;
 
                 /* Send will drain if needed */
-                ws->send(message.message, (OpCode)message.opCode, message.compress);
+                ws->sendPublished(message);
             });
         } else {
             return topicTree->publish(nullptr, topic, {std::string(message), opCode, compress});
@@ -267,6 +279,8 @@ public:
         MoveOnlyFunction<void(WebSocket<SSL, true, UserData> *, std::string_view)> pong = nullptr;
         MoveOnlyFunction<void(WebSocket<SSL, true, UserData> *, std::string_view, int, int)> subscription = nullptr;
         MoveOnlyFunction<void(WebSocket<SSL, true, UserData> *, int, std::string_view)> close = nullptr;
+        /* Opt-in batching of message: all messages completed by one read, in one call */
+        MoveOnlyFunction<void(WebSocket<SSL, true, UserData> *, WebSocketMessageBatch &)> messages = nullptr;
     };
 
     /* Closes all sockets including listen sockets. */
@@ -327,7 +341,7 @@ public:
                 }
 
                 /* If we ever overstep maxBackpresure, exit immediately */
-                if (WebSocket<SSL, true, int>::SendStatus::DROPPED == ws->send(message.message, (OpCode)message.opCode, message.compress)) {
+                if (WebSocket<SSL, true, int>::SendStatus::DROPPED == ws->sendPublished(message)) {
                     if (needsUncork) {
                         ((AsyncSocket<SSL> *)ws)->uncork();
                         needsUncork = false;
@@ -387,11 +401,16 @@ public:
                 loopData->inflationStream = new InflationStream(CompressOptions::DEDICATED_DECOMPRESSOR);
                 loopData->deflationStream = new DeflationStream(CompressOptions::DEDICATED_COMPRESSOR);
             }
+
+            if ((behavior.compression & CompressOptions::POOLED_COMPRESSOR) && !loopData->deflationStreamPool) {
+                loopData->deflationStreamPool = new DeflationStreamPool(UWS_MAX_POOLED_COMPRESSORS);
+            }
         }
 
         /* Copy all handlers */
         webSocketContext->getExt()->openHandler = std::move(behavior.open);
         webSocketContext->getExt()->messageHandler = std::move(behavior.message);
+        webSocketContext->getExt()->messagesHandler = std::move(behavior.messages);
         webSocketContext->getExt()->drainHandler = std::move(behavior.drain);
         webSocketContext->getExt()->subscriptionHandler = std::move(behavior.subscription);
         webSocketContext->getExt()->closeHandler = std::move([closeHandler = std::move(behavior.close)](WebSocket<SSL, true, UserData> *ws, int code, std::string_view message) mutable {
@@ -472,6 +491,64 @@ public:
         return std::move(*this);
     }
 
+    /* Compiles the routes of the currently browsed-to router into their flat form, for faster matching.
+     * Adding or removing routes afterwards is still allowed but undoes it until frozen again */
+    TemplatedApp &&freezeRoutes() {
+        if (httpContext) {
+            httpContext->getSocketContextData()->currentRouter->freeze();
+        }
+        return std::move(*this);
+    }
+
+    /* Starts collecting per stage latency histograms of every request (or stops and frees them) */
+    TemplatedApp &&setLatencyStatsEnabled(bool enabled) {
+        if (httpContext) {
+            auto &latencyStats = httpContext->getSocketContextData()->latencyStats;
+            if (!enabled) {
+                latencyStats.reset();
+            } else if (!latencyStats) {
+                latencyStats = std::make_unique<HttpLatencyStats>();
+            }
+        }
+        return std::move(*this);
+    }
+
+    /* Histograms collected so far, nullptr unless enabled */
+    HttpLatencyStats *getLatencyStats() {
+        return httpContext ? httpContext->getSocketContextData()->latencyStats.get() : nullptr;
+    }
+
+    /* Serves GET and HEAD of pattern with a response serialized once, up front. Only its Date header is
+     * patched, whenever the loop's date has changed (once a second), so every request is a single write */
+    TemplatedApp &&staticRoute(std::string pattern, std::vector<std::pair<std::string, std::string>> headers, std::string_view body) {
+        if (httpContext) {
+            std::string response = "HTTP/1.1 200 OK\r\nDate: ";
+            size_t dateOffset = response.length();
+            response.append(29, ' ');
+            response.append("\r\n");
+            for (auto &[key, value] : headers) {
+                response.append(key).append(": ").append(value).append("\r\n");
+            }
+            response.append("Content-Length: ").append(std::to_string(body.length())).append("\r\n\r\n");
+
+            /* HEAD gets the very same response, without the body */
+            size_t headLength = response.length();
+            response.append(body);
+
+            auto serialized = std::make_shared<std::string>(std::move(response));
+            for (std::string method : {"GET", "HEAD"}) {
+                httpContext->onHttp(method, pattern, [serialized, dateOffset, headLength, isHead = method == "HEAD"](HttpResponse<SSL> *res, HttpRequest */*req*/) {
+                    char *date = res->getLoopData()->date;
+                    if (memcmp(serialized->data() + dateOffset, date, 29)) {
+                        memcpy(serialized->data() + dateOffset, date, 29);
+                    }
+                    res->endSerialized(std::string_view(serialized->data(), isHead ? headLength : serialized->length()));
+                });
+            }
+        }
+        return std::move(*this);
+    }
+
     TemplatedApp &&get(std::string pattern, MoveOnlyFunction<void(HttpResponse<SSL> *, HttpRequest *)> &&handler) {
         if (httpContext) {
             httpContext->onHttp("GET", pattern, std::move(handler));
@@ -543,6 +620,24 @@ public:
         return std::move(*this);
     }
 
+    /* Any method by name, such as an uppercase "GET", or "*" for all of them */
+    TemplatedApp &&route(std::string method, std::string pattern, MoveOnlyFunction<void(HttpResponse<SSL> *, HttpRequest *)> &&handler) {
+        if (httpContext) {
+            httpContext->onHttp(method, pattern, std::move(handler));
+        }
+        return std::move(*this);
+    }
+
+    /* Advertises an HTTP/3 listener on this port (of the same host) in an Alt-Svc header on every response,
+     * for maxAge seconds. A port of 0 stops advertising */
+    TemplatedApp &&advertiseHttp3(int port, unsigned int maxAge = 86400) {
+        if (httpContext) {
+            HttpContextData<SSL> *httpContextData = httpContext->getSocketContextData();
+            httpContextData->altSvc = port ? "h3=\":" + std::to_string(port) + "\"; ma=" + std::to_string(maxAge) : std::string();
+        }
+        return std::move(*this);
+    }
+
     /* Host, port, callback */
     TemplatedApp &&listen(std::string host, int port, MoveOnlyFunction<void(us_listen_socket_t *)> &&handler) {
         if (!host.length()) {
@@ -585,6 +680,20 @@ public:
         return std::move(*this);
     }
 
+    /* Inherited descriptor of a listen socket, such as one handed over by us_listen_socket_recv_fds, callback */
+    TemplatedApp &&listenFd(LIBUS_SOCKET_DESCRIPTOR fd, MoveOnlyFunction<void(us_listen_socket_t *)> &&handler) {
+        handler(httpContext ? httpContext->listen_fd(fd) : nullptr);
+        return std::move(*this);
+    }
+
+    /* Graceful shutdown of HTTP connections, see HttpContext::drain. WebSockets are not affected */
+    TemplatedApp &&drain(unsigned int timeoutMs = 0) {
+        if (httpContext) {
+            httpContext->drain(timeoutMs);
+        }
+        return std::move(*this);
+    }
+
     TemplatedApp &&run() {
         uWS::run();
         return std::move(*this);
@@ -252,6 +252,33 @@ public:
         AsyncSocketData<SSL> *asyncSocketData = getAsyncSocketData();
 
         /* We are limited if we have a per-socket buffer */
+        if (asyncSocketData->buffer.length() && length && loopData->corkedSocket != this) {
+            /* Drain the buffer and write the new data in one go (corked data would have to go in between) */
+            size_t bufferLength = asyncSocketData->buffer.length();
+            us_iovec_t chunks[2] = {{asyncSocketData->buffer.data(), bufferLength}, {src, (size_t) length}};
+            int written = us_socket_writev(SSL, (us_socket_t *) this, chunks, 2);
+
+            if ((size_t) written < bufferLength) {
+                asyncSocketData->buffer.erase((unsigned int) written);
+                if (optionally) {
+                    return {0, true};
+                }
+                asyncSocketData->buffer.append(src, (unsigned int) length);
+                return {length, true};
+            }
+            asyncSocketData->buffer.clear();
+
+            int srcWritten = written - (int) bufferLength;
+            if (srcWritten < length) {
+                if (optionally) {
+                    return {srcWritten, true};
+                }
+                asyncSocketData->buffer.append(src + srcWritten, (size_t) (length - srcWritten));
+                return {length, true};
+            }
+            return {length, false};
+        }
+
         if (asyncSocketData->buffer.length()) {
             /* Write off as much as we can */
             int written = us_socket_write(SSL, (us_socket_t *) this, asyncSocketData->buffer.data(), (int) asyncSocketData->buffer.length(), /*nextLength != 0 | */length);
@@ -327,6 +354,41 @@ public:
         return {length, false};
     }
 
+    /* Writes the cork buffer followed by src in one scatter-gather write, buffering what did not make it.
+     * Same return as uncork: the cork buffer is already accounted for by the writes that filled it. */
+    std::pair<int, bool> uncorkv(const char *src, int length, bool optionally) {
+        LoopData *loopData = getLoopData();
+        AsyncSocketData<SSL> *asyncSocketData = getAsyncSocketData();
+
+        int corkLength = (int) loopData->corkOffset;
+        loopData->corkOffset = 0;
+
+        us_iovec_t chunks[2] = {{loopData->corkBuffer, (size_t) corkLength}, {src, (size_t) length}};
+        int written = us_socket_writev(SSL, (us_socket_t *) this, chunks, 2);
+
+        if (written >= corkLength + length) {
+            return {length, false};
+        }
+
+        if (written < corkLength) {
+            /* Corked data must never be dropped */
+            asyncSocketData->buffer.append(loopData->corkBuffer + written, (size_t) (corkLength - written));
+            if (optionally) {
+                return {0, true};
+            }
+            asyncSocketData->buffer.append(src, (size_t) length);
+            return {length, true};
+        }
+
+        /* All of the cork buffer but only parts of src went out */
+        int srcWritten = written - corkLength;
+        if (optionally) {
+            return {srcWritten, true};
+        }
+        asyncSocketData->buffer.append(src + srcWritten, (size_t) (length - srcWritten));
+        return {length, true};
+    }
+
     /* Uncork this socket and flush or buffer any corked and/or passed data. It is essential to remember doing this. */
     /* It does NOT count bytes written from cork buffer (they are already accounted for in the write call responsible for its corking)! */
     std::pair<int, bool> uncork(const char *src = nullptr, int length = 0, bool optionally = false) {
@@ -335,6 +397,11 @@ public:
         if (loopData->corkedSocket == this) {
             loopData->corkedSocket = nullptr;
 
+            /* Cork buffer and new data go out together, without copying either */
+            if (loopData->corkOffset && length && !getAsyncSocketData()->buffer.length() && !us_socket_is_closed(SSL, (us_socket_t *) this)) {
+                return uncorkv(src, length, optionally);
+            }
+
             if (loopData->corkOffset) {
                 /* Corked data is already accounted for via its write call */
                 auto [written, failed] = write(loopData->corkBuffer, (int) loopData->corkOffset, false, length);
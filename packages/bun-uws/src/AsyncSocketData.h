@@ -20,19 +20,108 @@
 #define UWS_ASYNCSOCKETDATA_H
 
 #include <string>
+#include <vector>
 
 namespace uWS {
 
+/* Drained and closed sockets give their backpressure buffer back here instead of freeing it, so that
+ * short lived sockets do not allocate a fresh one each. There is one loop per thread, so per thread is per loop */
+struct BackPressurePool {
+    /* Buffers start out with this capacity, and are only kept if they did not grow past MAX_BUFFER_SIZE */
+    static const size_t BUFFER_SIZE = 16 * 1024;
+    static const size_t MAX_BUFFER_SIZE = 64 * 1024;
+    static const size_t MAX_BUFFERS = 32;
+
+    std::vector<std::string> buffers;
+
+    ~BackPressurePool() {
+        destroyed() = true;
+    }
+
+    /* Sockets may outlive the pool at thread exit, those simply free their buffers */
+    static bool &destroyed() {
+        static thread_local bool isDestroyed = false;
+        return isDestroyed;
+    }
+
+    /* Capacity held by the backpressure buffers of live sockets on this thread */
+    static size_t &liveBytes() {
+        static thread_local size_t bytes = 0;
+        return bytes;
+    }
+
+    /* Capacity held by live sockets and by the pool, for memory reports */
+    static size_t heldBytes() {
+        size_t bytes = liveBytes();
+        if (BackPressurePool *pool = get()) {
+            for (std::string &buffer : pool->buffers) {
+                bytes += buffer.capacity();
+            }
+        }
+        return bytes;
+    }
+
+    static BackPressurePool *get() {
+        if (destroyed()) {
+            return nullptr;
+        }
+        static thread_local BackPressurePool pool;
+        return &pool;
+    }
+
+    static void take(std::string &buffer) {
+        BackPressurePool *pool = get();
+        if (pool && pool->buffers.size()) {
+            buffer = std::move(pool->buffers.back());
+            pool->buffers.pop_back();
+        } else {
+            buffer.reserve(BUFFER_SIZE);
+        }
+    }
+
+    static void give(std::string &buffer) {
+        BackPressurePool *pool = get();
+        if (pool && buffer.capacity() >= BUFFER_SIZE && buffer.capacity() <= MAX_BUFFER_SIZE && pool->buffers.size() < MAX_BUFFERS) {
+            buffer.clear();
+            pool->buffers.emplace_back(std::move(buffer));
+        }
+        buffer = std::string();
+    }
+};
+
 struct BackPressure {
     std::string buffer;
     unsigned int pendingRemoval = 0;
+    /* The capacity this buffer last added to BackPressurePool::liveBytes() */
+    size_t accountedCapacity = 0;
     BackPressure(BackPressure &&other) {
         buffer = std::move(other.buffer);
         pendingRemoval = other.pendingRemoval;
+        accountedCapacity = other.accountedCapacity;
+        other.accountedCapacity = 0;
     }
     BackPressure() = default;
+    ~BackPressure() {
+        if (buffer.capacity() >= BackPressurePool::BUFFER_SIZE) {
+            BackPressurePool::give(buffer);
+        }
+        BackPressurePool::liveBytes() -= accountedCapacity;
+    }
+    /* Keeps liveBytes() in step after anything that may have reallocated */
+    void account() {
+        BackPressurePool::liveBytes() += buffer.capacity() - accountedCapacity;
+        accountedCapacity = buffer.capacity();
+    }
+    /* Takes a pooled buffer when first needing one */
+    void prepare(size_t length) {
+        if (buffer.capacity() < BackPressurePool::BUFFER_SIZE && !buffer.length() && length) {
+            BackPressurePool::take(buffer);
+        }
+    }
     void append(const char *data, size_t length) {
+        prepare(length);
         buffer.append(data, length);
+        account();
     }
     void erase(unsigned int length) {
         pendingRemoval += length;
@@ -47,13 +136,23 @@ struct BackPressure {
     }
     void clear() {
         pendingRemoval = 0;
-        buffer.clear();
+        /* Fully drained, so let someone else use the buffer */
+        if (buffer.capacity() >= BackPressurePool::BUFFER_SIZE) {
+            BackPressurePool::give(buffer);
+        } else {
+            buffer.clear();
+        }
+        account();
     }
     void reserve(size_t length) {
+        prepare(length);
         buffer.reserve(length + pendingRemoval);
+        account();
     }
     void resize(size_t length) {
+        prepare(length);
         buffer.resize(length + pendingRemoval);
+        account();
     }
     const char *data() {
         return buffer.data() + pendingRemoval;
@@ -34,26 +34,38 @@ namespace uWS {
     constexpr uint64_t STATE_SIZE_MASK = ~(3ull << (sizeof(uint64_t) * 8 - 2));//0x3FFFFFFF;
     constexpr uint64_t STATE_IS_ERROR = ~0ull;//0xFFFFFFFF;
     constexpr uint64_t STATE_SIZE_OVERFLOW = 0x0Full << (sizeof(uint64_t) * 8 - 8);//0x0F000000;
+    /* Set while skipping the rest of a chunk size line (extensions), so that it can continue in later data */
+    constexpr uint64_t STATE_IS_SKIPPING_LINE = 1ull << (sizeof(uint64_t) * 8 - 3);
 
     inline unsigned int chunkSize(uint64_t state) {
         return state & STATE_SIZE_MASK;
     }
 
+    /* Values of hex digits, 0xFF for anything else */
+    struct HexDigits {
+        unsigned char values[256] = {};
+        constexpr HexDigits() {
+            for (int i = 0; i < 256; i++) {
+                values[i] = 0xFF;
+            }
+            for (int i = 0; i < 10; i++) {
+                values['0' + i] = (unsigned char) i;
+            }
+            for (int i = 0; i < 6; i++) {
+                values['a' + i] = values['A' + i] = (unsigned char) (10 + i);
+            }
+        }
+    };
+    inline constexpr HexDigits hexDigits;
+
     /* Reads hex number until CR or out of data to consume. Updates state. Returns bytes consumed. */
     inline void consumeHexNumber(std::string_view &data, uint64_t &state) {
-        /* Consume everything higher than 32 */
-        while (data.length() && data.data()[0] > 32) {
-
-            unsigned char digit = (unsigned char)data.data()[0];
-            if (digit >= 'a') {
-                digit = (unsigned char) (digit - ('a' - ':'));
-            } else if (digit >= 'A') {
-                digit = (unsigned char) (digit - ('A' - ':'));
-            }
+        /* Consume everything higher than 32, up until any chunk extension */
+        while (!(state & STATE_IS_SKIPPING_LINE) && data.length() && (unsigned char) data.data()[0] > 32 && data.data()[0] != ';') {
 
-            unsigned int number = ((unsigned int) digit - (unsigned int) '0');
+            unsigned int number = hexDigits.values[(unsigned char) data.data()[0]];
 
-            if (number > 16 || (chunkSize(state) & STATE_SIZE_OVERFLOW)) {
+            if (number == 0xFF || (chunkSize(state) & STATE_SIZE_OVERFLOW)) {
                 state = STATE_IS_ERROR;
                 return;
             }
@@ -66,16 +78,21 @@ namespace uWS {
             state |= bits;
             data.remove_prefix(1);
         }
-        /* Consume everything not /n */
-        while (data.length() && data.data()[0] != '\n') {
-            data.remove_prefix(1);
+        /* Consume everything not /n (extensions and the CR) */
+        const char *lineFeed = data.length() ? (const char *) memchr(data.data(), '\n', data.length()) : nullptr;
+        if (!lineFeed) {
+            if (data.length()) {
+                state |= STATE_IS_SKIPPING_LINE;
+            }
+            data.remove_prefix(data.length());
+            return;
         }
+        data.remove_prefix((size_t) (lineFeed - data.data()));
         /* Now we stand on \n so consume it and enable size */
-        if (data.length()) {
-            state += 2; // include the two last /r/n
-            state |= STATE_HAS_SIZE | STATE_IS_CHUNKED;
-            data.remove_prefix(1);
-        }
+        state &= ~STATE_IS_SKIPPING_LINE;
+        state += 2; // include the two last /r/n
+        state |= STATE_HAS_SIZE | STATE_IS_CHUNKED;
+        data.remove_prefix(1);
     }
 
     inline void decChunkSize(uint64_t &state, unsigned int by) {
@@ -189,6 +206,40 @@ namespace uWS {
         return std::nullopt;
     }
 
+    /* Same as iterating with ChunkIterator, except that the data of consecutive chunks is moved together
+     * in place, over the framing in between, so that cb(chunk) gets as much contiguous data as possible.
+     * Chunks are passed on once data runs out or the terminating empty chunk is reached, which is passed on
+     * by itself as always. Data is modified, only use this on buffers that may be (like post padded ones). */
+    template <class F>
+    static void forEachCoalescedChunk(std::string_view &data, uint64_t &state, F &&cb, bool trailer = false) {
+        char *joined = nullptr;
+        size_t joinedLength = 0;
+
+        std::optional<std::string_view> chunk;
+        while ((chunk = getNextChunk(data, state, trailer)).has_value()) {
+            if (!chunk->length()) {
+                if (joinedLength) {
+                    cb(std::string_view(joined, joinedLength));
+                    joinedLength = 0;
+                }
+                cb(*chunk);
+                continue;
+            }
+
+            if (!joinedLength) {
+                joined = (char *) chunk->data();
+            } else if (chunk->data() != joined + joinedLength) {
+                /* Everything in between has already been parsed */
+                memmove(joined + joinedLength, chunk->data(), chunk->length());
+            }
+            joinedLength += chunk->length();
+        }
+
+        if (joinedLength) {
+            cb(std::string_view(joined, joinedLength));
+        }
+    }
+
     /* This is really just a wrapper for convenience */
     struct ChunkIterator {
 
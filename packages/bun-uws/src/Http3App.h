@@ -9,13 +9,17 @@ namespace uWS {
     struct H3App {
         Http3Context *http3Context;
 
-        H3App(SocketContextOptions options = {}) {
+        /* To scale one listener over several threads, construct one H3App per thread with
+         * its worker index and the total worker count, then listen on the same port from each */
+        H3App(SocketContextOptions options = {}, unsigned int workerIndex = 0, unsigned int workerCount = 1) {
             /* This conversion should not be needed */
             us_quic_socket_context_options_t h3options = {};
 
             h3options.key_file_name = strdup(options.key_file_name);
             h3options.cert_file_name = strdup(options.cert_file_name);
             h3options.passphrase = strdup(options.passphrase);
+            h3options.worker_index = workerIndex;
+            h3options.worker_count = workerCount;
 
             /* Create the http3 context */
             http3Context = Http3Context::create((us_loop_t *)Loop::get(), h3options);
@@ -133,6 +137,18 @@ namespace uWS {
             return std::move(*this);
         }
 
+        /* Adds one handler to an HTTP/1.1 app and to this one, so that both listeners serve the same routes. The
+         * handler is copied for each and gets either kind of response and request, so it has to be generic over
+         * them, like a lambda taking auto *. Pair with app.advertiseHttp3(port) so clients find this listener */
+        template <bool SSL, typename Handler>
+        H3App &&route(TemplatedApp<SSL> &app, std::string method, std::string pattern, Handler handler) {
+            app.route(method, pattern, handler);
+            if (http3Context) {
+                http3Context->onHttp(method, pattern, std::move(handler));
+            }
+            return std::move(*this);
+        }
+
         void run() {
             uWS::Loop::get()->run();
         }
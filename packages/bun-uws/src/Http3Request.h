@@ -18,5 +18,27 @@ namespace uWS {
             }
             return {nullptr, 0};
         }
+
+        /* Like HttpRequest, without the query */
+        std::string_view getUrl() {
+            std::string_view path = getHeader(":path");
+            return path.substr(0, path.find('?'));
+        }
+
+        std::string_view getFullUrl() {
+            return getHeader(":path");
+        }
+
+        /* Without the leading '?' */
+        std::string_view getQuery() {
+            std::string_view path = getHeader(":path");
+            size_t querySeparator = path.find('?');
+            return querySeparator == std::string_view::npos ? std::string_view() : path.substr(querySeparator + 1);
+        }
+
+        /* Upper case, as sent */
+        std::string_view getCaseSensitiveMethod() {
+            return getHeader(":method");
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,464 @@
+/*
+ * Authored by Alex Hultman, 2018-2020.
+ * Intellectual property of third-party.
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// clang-format off
+#ifndef UWS_HTTPCOMPRESSION_H
+#define UWS_HTTPCOMPRESSION_H
+
+/* Compression of HTTP response bodies: Accept-Encoding negotiation, streaming compressors lent
+ * from a per loop pool, and a per loop cache of the compressed forms of bodies sent over and over.
+ * gzip and deflate come with zlib, br and zstd with UWS_WITH_BROTLI and UWS_WITH_ZSTD */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+#include <zlib.h>
+#endif
+
+#ifdef UWS_WITH_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef UWS_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+/* Upper bound of idle response compressors kept per loop */
+#ifndef UWS_MAX_POOLED_HTTP_COMPRESSORS
+#define UWS_MAX_POOLED_HTTP_COMPRESSORS 64
+#endif
+
+/* Bytes of compressed bodies kept per loop by endCached */
+#ifndef UWS_HTTP_COMPRESSION_CACHE_SIZE
+#define UWS_HTTP_COMPRESSION_CACHE_SIZE 32 * 1024 * 1024
+#endif
+
+namespace uWS {
+
+/* Bits, so that a set of them can be allowed */
+enum HttpContentEncoding : unsigned int {
+    HTTP_ENCODING_IDENTITY = 0,
+    HTTP_ENCODING_DEFLATE = 1,
+    HTTP_ENCODING_GZIP = 2,
+    HTTP_ENCODING_BROTLI = 4,
+    HTTP_ENCODING_ZSTD = 8
+};
+
+/* The ones compiled in */
+static const unsigned int HTTP_ENCODINGS_SUPPORTED = 0
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+    | HTTP_ENCODING_DEFLATE | HTTP_ENCODING_GZIP
+#endif
+#ifdef UWS_WITH_BROTLI
+    | HTTP_ENCODING_BROTLI
+#endif
+#ifdef UWS_WITH_ZSTD
+    | HTTP_ENCODING_ZSTD
+#endif
+    ;
+
+/* Bodies smaller than this are not worth the header */
+static const size_t HTTP_COMPRESSION_MIN_SIZE = 1024;
+
+/* As written in Content-Encoding */
+inline std::string_view contentEncodingName(HttpContentEncoding encoding) {
+    switch (encoding) {
+    case HTTP_ENCODING_DEFLATE: return "deflate";
+    case HTTP_ENCODING_GZIP: return "gzip";
+    case HTTP_ENCODING_BROTLI: return "br";
+    case HTTP_ENCODING_ZSTD: return "zstd";
+    default: return "identity";
+    }
+}
+
+/* Picks, of the allowed codings, the one the client gives the highest q-value in its Accept-Encoding.
+ * Ties go to the better ratio: zstd, br, gzip and then deflate. Returns identity if none is acceptable */
+inline HttpContentEncoding negotiateContentEncoding(std::string_view acceptEncoding, unsigned int allowed = HTTP_ENCODINGS_SUPPORTED) {
+    static const HttpContentEncoding preference[] = {HTTP_ENCODING_ZSTD, HTTP_ENCODING_BROTLI, HTTP_ENCODING_GZIP, HTTP_ENCODING_DEFLATE};
+
+    /* In thousandths, -1 when not mentioned */
+    int quality[4] = {-1, -1, -1, -1};
+    int wildcard = -1;
+
+    auto trim = [](std::string_view s) {
+        while (s.length() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (s.length() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    };
+
+    while (acceptEncoding.length()) {
+        size_t comma = acceptEncoding.find(',');
+        std::string_view item = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view name = trim(item.substr(0, semicolon));
+        int q = 1000;
+        while (semicolon != std::string_view::npos) {
+            item = item.substr(semicolon + 1);
+            semicolon = item.find(';');
+            std::string_view param = trim(item.substr(0, semicolon));
+            if (param.length() < 3 || (param[0] != 'q' && param[0] != 'Q') || param[1] != '=') {
+                continue;
+            }
+
+            /* 0, 1 or a fraction of up to three digits */
+            q = param[2] == '1' ? 1000 : 0;
+            if (param.length() > 4 && param[3] == '.' && param[2] == '0') {
+                int scale = 100;
+                for (size_t i = 4; i < param.length() && i < 7 && param[i] >= '0' && param[i] <= '9'; i++, scale /= 10) {
+                    q += (param[i] - '0') * scale;
+                }
+            }
+        }
+
+        auto is = [name](std::string_view token) {
+            if (name.length() != token.length()) {
+                return false;
+            }
+            for (size_t i = 0; i < token.length(); i++) {
+                if ((name[i] | 0x20) != token[i]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        if (is("zstd")) {
+            quality[0] = q;
+        } else if (is("br")) {
+            quality[1] = q;
+        } else if (is("gzip") || is("x-gzip")) {
+            quality[2] = q;
+        } else if (is("deflate")) {
+            quality[3] = q;
+        } else if (name == "*") {
+            wildcard = q;
+        }
+    }
+
+    HttpContentEncoding best = HTTP_ENCODING_IDENTITY;
+    int bestQuality = 0;
+    for (int i = 0; i < 4; i++) {
+        int q = quality[i] == -1 ? wildcard : quality[i];
+        if ((allowed & preference[i]) && q > bestQuality) {
+            best = preference[i];
+            bestQuality = q;
+        }
+    }
+    return best;
+}
+
+/* One streaming compressor of one coding. Output is valid until the next call */
+struct HttpCompressor {
+private:
+    HttpContentEncoding encoding;
+    int level;
+    std::string buffer;
+
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+    z_stream zlibStream = {};
+#endif
+#ifdef UWS_WITH_BROTLI
+    BrotliEncoderState *brotliState = nullptr;
+#endif
+#ifdef UWS_WITH_ZSTD
+    ZSTD_CCtx *zstdContext = nullptr;
+#endif
+
+    static const size_t OUTPUT_CHUNK = 16 * 1024;
+
+#ifdef UWS_WITH_BROTLI
+    void createBrotli() {
+        brotliState = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+        BrotliEncoderSetParameter(brotliState, BROTLI_PARAM_QUALITY, (uint32_t) level);
+    }
+#endif
+
+public:
+    /* The level is that of the coding's own scale, -1 is a default fit for compressing on the fly */
+    HttpCompressor(HttpContentEncoding encoding, int level = -1) : encoding(encoding), level(level) {
+        switch (encoding) {
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+        case HTTP_ENCODING_DEFLATE:
+        case HTTP_ENCODING_GZIP:
+            if (this->level == -1) {
+                this->level = 6;
+            }
+            /* HTTP deflate is the zlib format, gzip adds 16 to the window bits */
+            deflateInit2(&zlibStream, this->level, Z_DEFLATED, encoding == HTTP_ENCODING_GZIP ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY);
+            break;
+#endif
+#ifdef UWS_WITH_BROTLI
+        case HTTP_ENCODING_BROTLI:
+            if (this->level == -1) {
+                this->level = 4;
+            }
+            createBrotli();
+            break;
+#endif
+#ifdef UWS_WITH_ZSTD
+        case HTTP_ENCODING_ZSTD:
+            if (this->level == -1) {
+                this->level = 3;
+            }
+            zstdContext = ZSTD_createCCtx();
+            ZSTD_CCtx_setParameter(zstdContext, ZSTD_c_compressionLevel, this->level);
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+
+    ~HttpCompressor() {
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+        if (encoding == HTTP_ENCODING_DEFLATE || encoding == HTTP_ENCODING_GZIP) {
+            deflateEnd(&zlibStream);
+        }
+#endif
+#ifdef UWS_WITH_BROTLI
+        if (brotliState) {
+            BrotliEncoderDestroyInstance(brotliState);
+        }
+#endif
+#ifdef UWS_WITH_ZSTD
+        if (zstdContext) {
+            ZSTD_freeCCtx(zstdContext);
+        }
+#endif
+    }
+
+    HttpCompressor(const HttpCompressor &) = delete;
+    HttpCompressor &operator=(const HttpCompressor &) = delete;
+
+    HttpContentEncoding getEncoding() {
+        return encoding;
+    }
+
+    /* Everything given so far comes out, so that a streamed response can be read as it arrives.
+     * Finishing ends the stream, after which only reset makes it usable again */
+    std::string_view compress(std::string_view input, bool finish) {
+        buffer.clear();
+
+        switch (encoding) {
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+        case HTTP_ENCODING_DEFLATE:
+        case HTTP_ENCODING_GZIP: {
+            zlibStream.next_in = (Bytef *) input.data();
+            zlibStream.avail_in = (unsigned int) input.length();
+            int err;
+            do {
+                size_t had = buffer.length();
+                buffer.resize(had + OUTPUT_CHUNK);
+                zlibStream.next_out = (Bytef *) buffer.data() + had;
+                zlibStream.avail_out = (unsigned int) OUTPUT_CHUNK;
+                err = deflate(&zlibStream, finish ? Z_FINISH : Z_SYNC_FLUSH);
+                buffer.resize(had + OUTPUT_CHUNK - zlibStream.avail_out);
+            } while (err == Z_OK && (finish || zlibStream.avail_out == 0));
+            break;
+        }
+#endif
+#ifdef UWS_WITH_BROTLI
+        case HTTP_ENCODING_BROTLI: {
+            size_t availableIn = input.length();
+            const uint8_t *nextIn = (const uint8_t *) input.data();
+            do {
+                size_t had = buffer.length();
+                buffer.resize(had + OUTPUT_CHUNK);
+                size_t availableOut = OUTPUT_CHUNK;
+                uint8_t *nextOut = (uint8_t *) buffer.data() + had;
+                if (!BrotliEncoderCompressStream(brotliState, finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH, &availableIn, &nextIn, &availableOut, &nextOut, nullptr)) {
+                    buffer.resize(had);
+                    break;
+                }
+                buffer.resize(had + OUTPUT_CHUNK - availableOut);
+            } while (availableIn || BrotliEncoderHasMoreOutput(brotliState) || (finish && !BrotliEncoderIsFinished(brotliState)));
+            break;
+        }
+#endif
+#ifdef UWS_WITH_ZSTD
+        case HTTP_ENCODING_ZSTD: {
+            ZSTD_inBuffer in = {input.data(), input.length(), 0};
+            size_t remaining;
+            do {
+                size_t had = buffer.length();
+                buffer.resize(had + OUTPUT_CHUNK);
+                ZSTD_outBuffer out = {buffer.data() + had, OUTPUT_CHUNK, 0};
+                remaining = ZSTD_compressStream2(zstdContext, &out, &in, finish ? ZSTD_e_end : ZSTD_e_flush);
+                buffer.resize(had + out.pos);
+            } while (!ZSTD_isError(remaining) && remaining);
+            break;
+        }
+#endif
+        default:
+            return input;
+        }
+
+        return buffer;
+    }
+
+    /* Starts a new stream with the same settings */
+    void reset() {
+        switch (encoding) {
+#if !defined(UWS_NO_ZLIB) && !defined(UWS_MOCK_ZLIB)
+        case HTTP_ENCODING_DEFLATE:
+        case HTTP_ENCODING_GZIP:
+            deflateReset(&zlibStream);
+            break;
+#endif
+#ifdef UWS_WITH_BROTLI
+        case HTTP_ENCODING_BROTLI:
+            /* Brotli has no reset */
+            BrotliEncoderDestroyInstance(brotliState);
+            createBrotli();
+            break;
+#endif
+#ifdef UWS_WITH_ZSTD
+        case HTTP_ENCODING_ZSTD:
+            ZSTD_CCtx_reset(zstdContext, ZSTD_reset_session_only);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        /* Keep the memory of the usual response, not that of the biggest one */
+        if (buffer.capacity() > OUTPUT_CHUNK * 4) {
+            std::string().swap(buffer);
+        }
+    }
+};
+
+/* Compressors are lent to responses while they are written and taken back reset, so a loop
+ * compressing many responses only ever sets up about as many as it streams at once */
+struct HttpCompressorPool {
+private:
+    std::vector<std::unique_ptr<HttpCompressor>> idle;
+    unsigned int maxIdle;
+
+public:
+    HttpCompressorPool(unsigned int maxIdle) : maxIdle(maxIdle) {}
+
+    std::unique_ptr<HttpCompressor> get(HttpContentEncoding encoding) {
+        for (size_t i = idle.size(); i--; ) {
+            if (idle[i]->getEncoding() == encoding) {
+                std::unique_ptr<HttpCompressor> compressor = std::move(idle[i]);
+                idle[i] = std::move(idle.back());
+                idle.pop_back();
+                return compressor;
+            }
+        }
+        return std::make_unique<HttpCompressor>(encoding);
+    }
+
+    void release(std::unique_ptr<HttpCompressor> &&compressor) {
+        if (idle.size() < maxIdle) {
+            compressor->reset();
+            idle.push_back(std::move(compressor));
+        }
+    }
+};
+
+/* The compressed forms of bodies that are sent again and again, such as static routes and reused
+ * Response objects. Each is compressed once, at the best level of its coding, and kept until the
+ * least recently used ones make room for others */
+struct HttpCompressionCache {
+private:
+    struct Entry {
+        std::string compressed;
+        size_t rawLength;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    /* Most recently used first */
+    std::list<std::string> lru;
+    size_t size = 0;
+    size_t maxSize;
+    /* Holds what get returned for a body too big to keep */
+    std::string lastUncached;
+
+    static int bestLevel(HttpContentEncoding encoding) {
+        switch (encoding) {
+        case HTTP_ENCODING_BROTLI: return 11;
+        case HTTP_ENCODING_ZSTD: return 19;
+        default: return 9;
+        }
+    }
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it) {
+        size -= it->second.compressed.length();
+        lru.erase(it->second.lru);
+        entries.erase(it);
+    }
+
+public:
+    HttpCompressionCache(size_t maxSize) : maxSize(maxSize) {}
+
+    /* Returns body compressed with encoding, valid until the next call. The key stands for the body,
+     * so it has to change when the body does (a body of another length is compressed again) */
+    std::string_view get(std::string_view key, std::string_view body, HttpContentEncoding encoding) {
+        std::string entryKey;
+        entryKey.reserve(key.length() + 1);
+        entryKey.append(key);
+        entryKey.push_back((char) encoding);
+
+        auto it = entries.find(entryKey);
+        if (it != entries.end()) {
+            if (it->second.rawLength == body.length()) {
+                lru.splice(lru.begin(), lru, it->second.lru);
+                return it->second.compressed;
+            }
+            erase(it);
+        }
+
+        HttpCompressor compressor(encoding, bestLevel(encoding));
+        std::string compressed(compressor.compress(body, true));
+
+        /* Bodies that would push most of the others out are not worth keeping */
+        if (compressed.length() > maxSize / 4) {
+            lastUncached = std::move(compressed);
+            return lastUncached;
+        }
+
+        while (size + compressed.length() > maxSize && lru.size()) {
+            erase(entries.find(lru.back()));
+        }
+
+        lru.push_front(entryKey);
+        size += compressed.length();
+        Entry &entry = entries[std::move(entryKey)];
+        entry = {std::move(compressed), body.length(), lru.begin()};
+        return entry.compressed;
+    }
+
+    void clear() {
+        entries.clear();
+        lru.clear();
+        size = 0;
+    }
+};
+
+}
+
+#endif // UWS_HTTPCOMPRESSION_H
@@ -156,6 +156,12 @@ private:
             /* Cork this socket */
             ((AsyncSocket<SSL> *) s)->cork();
 
+            /* Remember when the first bytes of a request came in (per iteration clock) */
+            if (httpContextData->latencyStats && !httpResponseData->receivedAt) {
+                struct us_loop_t *loop = us_socket_context_loop(SSL, us_socket_context(SSL, s));
+                httpResponseData->receivedAt = ((LoopData *) us_loop_ext(loop))->getIterationTime(us_loop_iteration_number(loop));
+            }
+
             /* Mark that we are inside the parser now */
             httpContextData->isParsingHttp = true;
 
@@ -186,6 +192,19 @@ private:
                 /* Mark pending request and emit it */
                 httpResponseData->state = HttpResponseData<SSL>::HTTP_RESPONSE_PENDING;
 
+                /* Headers are parsed, pipelined requests after the first count from this iteration */
+                if (httpContextData->latencyStats) {
+                    uint64_t now = LatencyHistogram::now();
+                    if (!httpResponseData->receivedAt) {
+                        struct us_loop_t *loop = us_socket_context_loop(SSL, us_socket_context(SSL, (us_socket_t *) s));
+                        httpResponseData->receivedAt = ((LoopData *) us_loop_ext(loop))->getIterationTime(us_loop_iteration_number(loop));
+                    }
+                    httpContextData->latencyStats->histograms[HttpLatencyStats::STAGE_PARSE].record(now - httpResponseData->receivedAt);
+                    httpContextData->latencyStats->routeStartedAt = now;
+                    httpResponseData->respondingSince = httpResponseData->receivedAt;
+                    httpResponseData->receivedAt = 0;
+                }
+
                 /* Mark this response as connectionClose if ancient or connection: close */
                 if (httpRequest->isAncient() || httpRequest->getHeader("connection").length() == 5) {
                     httpResponseData->state |= HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE;
@@ -236,6 +255,13 @@ private:
                     us_socket_timeout(SSL, (us_socket_t *) s, HTTP_IDLE_TIMEOUT_S);
                 }
 
+                /* Pipelined requests all go out in the one write made when we uncork after parsing. A response
+                 * overflowing the cork buffer flushes and uncorks early, so cork again for the ones that follow
+                 * (unless that flush left backpressure, where the rest is buffered and sent on writable anyways) */
+                if (((AsyncSocket<SSL> *) s)->canCork() && !((AsyncSocket<SSL> *) s)->getBufferedAmount()) {
+                    ((AsyncSocket<SSL> *) s)->cork();
+                }
+
                 /* Continue parsing */
                 return s;
 
@@ -359,6 +385,12 @@ private:
             AsyncSocket<SSL> *asyncSocket = (AsyncSocket<SSL> *) s;
             HttpResponseData<SSL> *httpResponseData = (HttpResponseData<SSL> *) asyncSocket->getAsyncSocketData();
 
+            /* A file body takes precedence, it completes (closing if we should) or waits for the next writable */
+            if (httpResponseData->fileRemaining) {
+                ((HttpResponse<SSL> *) s)->internalSendFile();
+                return s;
+            }
+
             /* Ask the developer to write data and return success (true) or failure (false), OR skip sending anything and return success (true). */
             if (httpResponseData->onWritable) {
                 /* We are now writable, so hang timeout again, the user does not have to do anything so we should hang until end or tryEnd rearms timeout */
@@ -443,6 +475,9 @@ public:
     void free() {
         /* Destruct socket context data */
         HttpContextData<SSL> *httpContextData = getSocketContextData();
+        if (httpContextData->drainTimer) {
+            us_timer_close(httpContextData->drainTimer, 1);
+        }
         httpContextData->~HttpContextData<SSL>();
 
         /* Free the socket context in whole */
@@ -473,7 +508,7 @@ public:
             return;
         }
 
-        httpContextData->currentRouter->add(methods, pattern, [handler = std::move(handler)](auto *r) mutable {
+        httpContextData->currentRouter->add(methods, pattern, [handler = std::move(handler), httpContextData](auto *r) mutable {
             auto user = r->getUserData();
             user.httpRequest->setYield(false);
             user.httpRequest->setParameters(r->getParameters());
@@ -484,7 +519,26 @@ public:
                 user.httpResponse->writeContinue();
             }
 
-            handler(user.httpResponse, user.httpRequest);
+            HttpLatencyStats *latencyStats = httpContextData->latencyStats.get();
+            if (latencyStats) {
+                uint64_t now = LatencyHistogram::now();
+                /* Yielding handlers before us count as routing (zero if enabled mid request) */
+                if (latencyStats->routeStartedAt) {
+                    latencyStats->histograms[HttpLatencyStats::STAGE_ROUTE].record(now - latencyStats->routeStartedAt);
+                }
+
+                handler(user.httpResponse, user.httpRequest);
+
+                /* The handler may have disabled stats */
+                latencyStats = httpContextData->latencyStats.get();
+                if (latencyStats) {
+                    uint64_t done = LatencyHistogram::now();
+                    latencyStats->histograms[HttpLatencyStats::STAGE_HANDLER].record(done - now);
+                    latencyStats->routeStartedAt = user.httpRequest->getYield() ? done : 0;
+                }
+            } else {
+                handler(user.httpResponse, user.httpRequest);
+            }
 
             /* If any handler yielded, the router will keep looking for a suitable handler. */
             if (user.httpRequest->getYield()) {
@@ -504,6 +558,59 @@ public:
         return socket;
     }
 
+    /* Listen on an inherited, already listening descriptor using this HttpContext */
+    us_listen_socket_t *listen_fd(LIBUS_SOCKET_DESCRIPTOR fd) {
+        auto *socket = us_socket_context_listen_fd(SSL, getSocketContext(), fd, sizeof(HttpResponseData<SSL>));
+        // we dont depend on libuv ref for keeping it alive
+        if (socket) {
+            us_socket_unref(&socket->s);
+        }
+
+        return socket;
+    }
+
+    /* Graceful shutdown. Connections between requests are closed now, the others once their response is done,
+     * and each response from now on says Connection: close. Whatever is left after timeoutMs is force closed,
+     * a timeoutMs of 0 waits for as long as it takes. Listen sockets are left alone, close them first */
+    void drain(unsigned int timeoutMs) {
+        HttpContextData<SSL> *httpContextData = getSocketContextData();
+        httpContextData->draining = true;
+
+        us_socket_context_for_each_socket(SSL, getSocketContext(), [](us_socket_t *s, void *) {
+            AsyncSocket<SSL> *asyncSocket = (AsyncSocket<SSL> *) s;
+            HttpResponseData<SSL> *httpResponseData = (HttpResponseData<SSL> *) us_socket_ext(SSL, s);
+
+            if ((httpResponseData->state & HttpResponseData<SSL>::HTTP_RESPONSE_PENDING) == 0) {
+                if (httpResponseData->isBetweenRequests() && asyncSocket->getBufferedAmount() == 0) {
+                    asyncSocket->close();
+                } else {
+                    /* Closed once drained of backpressure, a partial request gets its Connection: close with its response */
+                    httpResponseData->state |= HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE;
+                }
+            } else if (httpResponseData->state & (HttpResponseData<SSL>::HTTP_WRITE_CALLED | HttpResponseData<SSL>::HTTP_END_CALLED)) {
+                /* Headers already went out, so just close when this response is done */
+                httpResponseData->state |= HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE;
+            }
+        }, nullptr);
+
+        if (!timeoutMs) {
+            return;
+        }
+
+        if (!httpContextData->drainTimer) {
+            httpContextData->drainTimer = us_create_timer(us_socket_context_loop(SSL, getSocketContext()), 1, sizeof(HttpContext<SSL> *));
+            HttpContext<SSL> *httpContext = this;
+            memcpy(us_timer_ext(httpContextData->drainTimer), &httpContext, sizeof(HttpContext<SSL> *));
+        }
+        us_timer_set(httpContextData->drainTimer, [](struct us_timer_t *t) {
+            HttpContext<SSL> *httpContext;
+            memcpy(&httpContext, us_timer_ext(t), sizeof(HttpContext<SSL> *));
+            us_socket_context_for_each_socket(SSL, httpContext->getSocketContext(), [](us_socket_t *s, void *) {
+                ((AsyncSocket<SSL> *) s)->close();
+            }, nullptr);
+        }, (int) timeoutMs, 0);
+    }
+
     /* Listen to unix domain socket using this HttpContext */
     us_listen_socket_t *listen_unix(const char *path, size_t pathlen, int options) {
         auto* socket =  us_socket_context_listen_unix(SSL, getSocketContext(), path, pathlen, options, sizeof(HttpResponseData<SSL>));
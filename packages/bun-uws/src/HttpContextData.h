@@ -19,8 +19,10 @@
 #define UWS_HTTPCONTEXTDATA_H
 
 #include "HttpRouter.h"
+#include "LatencyHistogram.h"
 
 #include <vector>
+#include <memory>
 #include "MoveOnlyFunction.h"
 
 namespace uWS {
@@ -50,6 +52,16 @@ private:
     void *upgradedWebSocket = nullptr;
     bool isParsingHttp = false;
     bool rejectUnauthorized = false;
+
+    /* Set by drain, every response from then on closes its connection */
+    bool draining = false;
+    us_timer_t *drainTimer = nullptr;
+
+    /* Alt-Svc value written with every response, set by advertiseHttp3 */
+    std::string altSvc;
+
+    /* Per stage request latency histograms, only allocated when enabled */
+    std::unique_ptr<HttpLatencyStats> latencyStats;
 };
 
 }
@@ -22,6 +22,11 @@
 #define UWS_HTTP_MAX_HEADERS_COUNT 100
 #endif
 
+/* Slots of the per-request header name index, a power of two of at least twice the max header count */
+#ifndef UWS_HTTP_HEADER_INDEX_SIZE
+#define UWS_HTTP_HEADER_INDEX_SIZE 256
+#endif
+
 // todo: HttpParser is in need of a few clean-ups and refactorings
 
 /* The HTTP parser is an independent module subject to unit testing / fuzz testing */
@@ -32,13 +37,26 @@
 #include <climits>
 #include <string_view>
 #include <map>
+#include <cstdint>
+#include <type_traits>
 #include "MoveOnlyFunction.h"
 #include "ChunkedEncoding.h"
 
-#include "BloomFilter.h"
 #include "ProxyParser.h"
 #include "QueryParser.h"
 
+/* Vector widths follow the target we are compiled for (baseline and haswell builds differ) */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UWS_HTTP_SIMD_WIDTH 32
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define UWS_HTTP_SIMD_WIDTH 16
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define UWS_HTTP_SIMD_WIDTH 16
+#endif
+
 namespace uWS
 {
 
@@ -58,8 +76,59 @@ namespace uWS
         } headers[UWS_HTTP_MAX_HEADERS_COUNT];
         bool ancientHttp;
         unsigned int querySeparator;
+        QueryIndex queryIndex;
         bool didYield;
-        BloomFilter bf;
+        unsigned int headerCount;
+
+        /* Open addressed (linear probing) index of header names, 0 marks an empty slot.
+         * Filled in once per request when all headers are parsed */
+        static_assert((UWS_HTTP_HEADER_INDEX_SIZE & (UWS_HTTP_HEADER_INDEX_SIZE - 1)) == 0, "UWS_HTTP_HEADER_INDEX_SIZE must be a power of two");
+        static_assert(UWS_HTTP_HEADER_INDEX_SIZE >= 2 * UWS_HTTP_MAX_HEADERS_COUNT, "UWS_HTTP_HEADER_INDEX_SIZE must be at least twice UWS_HTTP_MAX_HEADERS_COUNT");
+        typedef std::conditional_t<(UWS_HTTP_MAX_HEADERS_COUNT <= 256), uint8_t, uint16_t> HeaderIndexSlot;
+        HeaderIndexSlot headerIndex[UWS_HTTP_HEADER_INDEX_SIZE];
+
+        /* Length and the first and last 4 bytes set apart all common header names */
+        static inline uint32_t hashHeaderName(std::string_view key)
+        {
+            uint32_t h = (uint32_t) key.length() * 0x9e3779b1u;
+            if (key.length() >= 4)
+            {
+                uint32_t first, last;
+                memcpy(&first, key.data(), 4);
+                memcpy(&last, key.data() + key.length() - 4, 4);
+                h = (h ^ first) * 0x85ebca6bu;
+                h = (h ^ last) * 0xc2b2ae35u;
+            }
+            else
+            {
+                for (unsigned char c : key)
+                {
+                    h = (h ^ c) * 16777619u;
+                }
+            }
+            return h ^ (h >> 16);
+        }
+
+        void indexHeaders()
+        {
+            memset(headerIndex, 0, sizeof(headerIndex));
+            unsigned int i = 1;
+            for (; headers[i].key.length(); i++)
+            {
+                unsigned int slot = hashHeaderName(headers[i].key) & (UWS_HTTP_HEADER_INDEX_SIZE - 1);
+                while (headerIndex[slot] && headers[headerIndex[slot]].key != headers[i].key)
+                {
+                    slot = (slot + 1) & (UWS_HTTP_HEADER_INDEX_SIZE - 1);
+                }
+                /* Repeated headers keep pointing to the first one */
+                if (!headerIndex[slot])
+                {
+                    headerIndex[slot] = (HeaderIndexSlot) i;
+                }
+            }
+            headerCount = i - 1;
+        }
+
         std::pair<int, std::string_view *> currentParameters;
 
     public:
@@ -118,19 +187,24 @@ namespace uWS
 
         std::string_view getHeader(std::string_view lowerCasedHeader)
         {
-            if (bf.mightHave(lowerCasedHeader))
+            unsigned int slot = hashHeaderName(lowerCasedHeader) & (UWS_HTTP_HEADER_INDEX_SIZE - 1);
+            while (unsigned int h = headerIndex[slot])
             {
-                for (Header *h = headers; (++h)->key.length();)
+                if (headers[h].key == lowerCasedHeader)
                 {
-                    if (h->key.length() == lowerCasedHeader.length() && !strncmp(h->key.data(), lowerCasedHeader.data(), lowerCasedHeader.length()))
-                    {
-                        return h->value;
-                    }
+                    return headers[h].value;
                 }
+                slot = (slot + 1) & (UWS_HTTP_HEADER_INDEX_SIZE - 1);
             }
             return std::string_view(nullptr, 0);
         }
 
+        /* Number of headers, not counting the request line */
+        unsigned int getHeaderCount()
+        {
+            return headerCount;
+        }
+
         std::string_view getUrl()
         {
             return std::string_view(headers->value.data(), querySeparator);
@@ -175,10 +249,18 @@ namespace uWS
         /* Finds and decodes the URI component. */
         std::string_view getQuery(std::string_view key)
         {
-            /* Raw querystring including initial '?' sign */
-            std::string_view queryString = std::string_view(headers->value.data() + querySeparator, headers->value.length() - querySeparator);
+            return getQueryIndex().get(key);
+        }
 
-            return getDecodedQueryValue(key, queryString);
+        /* Key, value spans of the querystring, built on first use. Values are only decoded once fetched by key */
+        QueryIndex &getQueryIndex()
+        {
+            if (!queryIndex.isBuilt())
+            {
+                /* Raw querystring including initial '?' sign */
+                queryIndex.build(std::string_view(headers->value.data() + querySeparator, headers->value.length() - querySeparator));
+            }
+            return queryIndex;
         }
 
         void setParameters(std::pair<int, std::string_view *> parameters)
@@ -275,7 +357,97 @@ namespace uWS
             return false;
         }
         
-        static inline void *consumeFieldName(char *p) {
+#ifdef UWS_HTTP_SIMD_WIDTH
+        /* One bit per byte, for the first W bytes at p. Bytes whose bit is set stop the scan */
+#if defined(__AVX2__)
+        typedef __m256i Vector;
+        static inline Vector load(const char *p) { return _mm256_loadu_si256((const __m256i *) p); }
+        static inline void store(char *p, Vector v) { _mm256_storeu_si256((__m256i *) p, v); }
+        static inline Vector splat(char c) { return _mm256_set1_epi8(c); }
+        static inline Vector orVector(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+        static inline Vector andVector(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+        static inline Vector equals(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+        /* Unsigned a >= b */
+        static inline Vector atLeast(Vector a, Vector b) { return _mm256_cmpeq_epi8(_mm256_max_epu8(a, b), a); }
+        static inline Vector select(Vector mask, Vector a, Vector b) { return _mm256_blendv_epi8(b, a, mask); }
+        static inline Vector indices() { return _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31); }
+        static inline uint64_t missing(Vector matches) { return (uint32_t) ~_mm256_movemask_epi8(matches); }
+        static inline unsigned int firstMissing(uint64_t bits) { return (unsigned int) __builtin_ctz((uint32_t) bits); }
+#elif defined(__SSE2__) || defined(_M_X64)
+        typedef __m128i Vector;
+        static inline Vector load(const char *p) { return _mm_loadu_si128((const __m128i *) p); }
+        static inline void store(char *p, Vector v) { _mm_storeu_si128((__m128i *) p, v); }
+        static inline Vector splat(char c) { return _mm_set1_epi8(c); }
+        static inline Vector orVector(Vector a, Vector b) { return _mm_or_si128(a, b); }
+        static inline Vector andVector(Vector a, Vector b) { return _mm_and_si128(a, b); }
+        static inline Vector equals(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+        static inline Vector atLeast(Vector a, Vector b) { return _mm_cmpeq_epi8(_mm_max_epu8(a, b), a); }
+        static inline Vector select(Vector mask, Vector a, Vector b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+        static inline Vector indices() { return _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+        static inline uint64_t missing(Vector matches) { return (uint16_t) ~_mm_movemask_epi8(matches); }
+        static inline unsigned int firstMissing(uint64_t bits) { return (unsigned int) __builtin_ctz((uint32_t) bits); }
+#else
+        typedef uint8x16_t Vector;
+        static inline Vector load(const char *p) { return vld1q_u8((const uint8_t *) p); }
+        static inline void store(char *p, Vector v) { vst1q_u8((uint8_t *) p, v); }
+        static inline Vector splat(char c) { return vdupq_n_u8((uint8_t) c); }
+        static inline Vector orVector(Vector a, Vector b) { return vorrq_u8(a, b); }
+        static inline Vector andVector(Vector a, Vector b) { return vandq_u8(a, b); }
+        static inline Vector equals(Vector a, Vector b) { return vceqq_u8(a, b); }
+        static inline Vector atLeast(Vector a, Vector b) { return vcgeq_u8(a, b); }
+        static inline Vector select(Vector mask, Vector a, Vector b) { return vbslq_u8(mask, a, b); }
+        static inline Vector indices() { static const uint8_t i[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}; return vld1q_u8(i); }
+        /* No movemask on NEON, narrowing leaves 4 bits per byte */
+        static inline uint64_t missing(Vector matches) { return ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0); }
+        static inline unsigned int firstMissing(uint64_t bits) { return (unsigned int) __builtin_ctzll(bits) >> 2; }
+#endif
+
+        /* Skips bytes that are (unsigned) at least bound, W at a time as long as we stay before end */
+        static inline char *skipAtLeast(char *p, char *end, char bound) {
+            Vector b = splat(bound);
+            while (p + UWS_HTTP_SIMD_WIDTH <= end) {
+                uint64_t stops = missing(atLeast(load(p), b));
+                if (stops) {
+                    return p + firstMissing(stops);
+                }
+                p += UWS_HTTP_SIMD_WIDTH;
+            }
+            return p;
+        }
+
+        /* Lower cases and skips [A-Za-z-], W at a time as long as we stay before end */
+        static inline char *skipFieldNameLowercased(char *p, char *end) {
+            while (p + UWS_HTTP_SIMD_WIDTH <= end) {
+                Vector v = load(p);
+                /* Upper case letters are the only bytes that are at least 'A' but not above 'Z' */
+                Vector upper = andVector(atLeast(v, splat('A')), ~atLeast(v, splat('Z' + 1)));
+                Vector lowered = orVector(v, andVector(upper, splat(0x20)));
+                Vector valid = orVector(andVector(atLeast(lowered, splat('a')), ~atLeast(lowered, splat('z' + 1))), equals(lowered, splat('-')));
+                uint64_t stops = missing(valid);
+                if (!stops) {
+                    store(p, lowered);
+                    p += UWS_HTTP_SIMD_WIDTH;
+                    continue;
+                }
+                /* Only the name itself is lower cased, never whatever follows the colon */
+                unsigned int length = firstMissing(stops);
+                Vector prefix = ~atLeast(indices(), splat((char) length));
+                store(p, select(prefix, lowered, v));
+                return p + length;
+            }
+            return p;
+        }
+#endif
+
+        static inline void *consumeFieldName(char *p, char *end) {
+#ifdef UWS_HTTP_SIMD_WIDTH
+            p = skipFieldNameLowercased(p, end);
+            if (*p == ':') {
+                return (void *)p;
+            }
+#else
+            (void)end;
+#endif
             /* Best case fast path (particularly useful with clang) */
             while (true) {
                 while ((*p >= 65) & (*p <= 90)) [[likely]] {
@@ -304,7 +476,7 @@ namespace uWS
         }
 
         /* Puts method as key, target as value and returns non-null (or nullptr on error). */
-        static inline char *consumeRequestLine(char *data, HttpRequest::Header &header, bool *isAncientHttp)
+        static inline char *consumeRequestLine(char *data, char *end, HttpRequest::Header &header, bool *isAncientHttp)
         {
             /* Scan until single SP, assume next is not SP (origin request) */
             char *start = data;
@@ -317,6 +489,11 @@ namespace uWS
                 data++;
                 /* Scan for less than 33 (catches post padded CR and fails) */
                 start = data;
+#ifdef UWS_HTTP_SIMD_WIDTH
+                data = skipAtLeast(data, end, 33);
+#else
+                (void)end;
+#endif
                 for (; true; data += 8)
                 {
                     uint64_t word;
@@ -350,8 +527,13 @@ namespace uWS
          * Field values are usually constrained to the range of US-ASCII characters [...]
          * Field values containing CR, LF, or NUL characters are invalid and dangerous [...]
          * Field values containing other CTL characters are also invalid. */
-        static inline void *tryConsumeFieldValue(char *p)
+        static inline void *tryConsumeFieldValue(char *p, char *end)
         {
+#ifdef UWS_HTTP_SIMD_WIDTH
+            p = skipAtLeast(p, end, 32);
+#else
+            (void)end;
+#endif
             for (; true; p += 8)
             {
                 uint64_t word;
@@ -391,7 +573,6 @@ namespace uWS
 #else
             /* This one is unused */
             (void)reserved;
-            (void)end;
 #endif
 
             /* It is critical for fallback buffering logic that we only return with success
@@ -400,7 +581,7 @@ namespace uWS
              * which is then removed, and our counters to flip due to overflow and we end up with a crash */
 
             /* The request line is different from the field names / field values */
-            if (!(postPaddedBuffer = consumeRequestLine(postPaddedBuffer, headers[0], isAncientHttp)))
+            if (!(postPaddedBuffer = consumeRequestLine(postPaddedBuffer, end, headers[0], isAncientHttp)))
             {
                 /* Error - invalid request line */
 
@@ -412,7 +593,7 @@ namespace uWS
             {
                 /* Lower case and consume the field name */
                 preliminaryKey = postPaddedBuffer;
-                postPaddedBuffer = (char *)consumeFieldName(postPaddedBuffer);
+                postPaddedBuffer = (char *)consumeFieldName(postPaddedBuffer, end);
                 headers->key = std::string_view(preliminaryKey, (size_t)(postPaddedBuffer - preliminaryKey));
 
                 /* We should not accept whitespace between key and colon, so colon must foloow immediately */
@@ -427,7 +608,7 @@ namespace uWS
                 /* The goal of this call is to find next "\r\n", or any invalid field value chars, fast */
                 while (true)
                 {
-                    postPaddedBuffer = (char *)tryConsumeFieldValue(postPaddedBuffer);
+                    postPaddedBuffer = (char *)tryConsumeFieldValue(postPaddedBuffer, end);
                     /* If this is not CR then we caught some stinky invalid char on the way */
                     if (postPaddedBuffer[0] != '\r')
                     {
@@ -521,12 +702,8 @@ namespace uWS
                 /* Store HTTP version (ancient 1.0 or 1.1) */
                 req->ancientHttp = isAncientHttp;
 
-                /* Add all headers to bloom filter */
-                req->bf.reset();
-                for (HttpRequest::Header *h = req->headers; (++h)->key.length();)
-                {
-                    req->bf.add(h->key);
-                }
+                /* Index all headers by name */
+                req->indexHeaders();
 
                 /* Break if no host header (but we can have empty string which is different from nullptr) */
                 if (!req->getHeader("host").data())
@@ -552,6 +729,7 @@ namespace uWS
                 /* Parse query */
                 const char *querySeparatorPtr = (const char *)memchr(req->headers->value.data(), '?', req->headers->value.length());
                 req->querySeparator = (unsigned int)((querySeparatorPtr ? querySeparatorPtr : req->headers->value.data() + req->headers->value.length()) - req->headers->value.data());
+                req->queryIndex.reset();
 
                 /* If returned socket is not what we put in we need
                  * to break here as we either have upgraded to
@@ -593,10 +771,9 @@ namespace uWS
                     {
                         /* Go ahead and parse it (todo: better heuristics for emitting FIN to the app level) */
                         std::string_view dataToConsume(data, length);
-                        for (auto chunk : uWS::ChunkIterator(&dataToConsume, &remainingStreamingBytes))
-                        {
+                        uWS::forEachCoalescedChunk(dataToConsume, remainingStreamingBytes, [&](std::string_view chunk) {
                             dataHandler(user, chunk, chunk.length() == 0);
-                        }
+                        });
                         if (isParsingInvalidChunkedEncoding(remainingStreamingBytes))
                         {
                             return {0, FULLPTR};
@@ -643,10 +820,14 @@ namespace uWS
         }
 
     public:
+        /* Nothing of a next request has been read, so the connection can be closed without losing one */
+        bool isBetweenRequests() {
+            return fallback.empty() && !remainingStreamingBytes;
+        }
+
         void *consumePostPadded(char *data, unsigned int length, void *user, void *reserved, MoveOnlyFunction<void *(void *, HttpRequest *)> &&requestHandler, MoveOnlyFunction<void *(void *, std::string_view, bool)> &&dataHandler, MoveOnlyFunction<void *(void *)> &&errorHandler)
         {
-            /* This resets BloomFilter by construction, but later we also reset it again.
-             * Optimize this to skip resetting twice (req could be made global) */
+            /* The header index is filled in per request, once its headers are parsed */
             HttpRequest req;
 
             if (remainingStreamingBytes)
@@ -656,10 +837,9 @@ namespace uWS
                 if (isParsingChunkedEncoding(remainingStreamingBytes))
                 {
                     std::string_view dataToConsume(data, length);
-                    for (auto chunk : uWS::ChunkIterator(&dataToConsume, &remainingStreamingBytes))
-                    {
+                    uWS::forEachCoalescedChunk(dataToConsume, remainingStreamingBytes, [&](std::string_view chunk) {
                         dataHandler(user, chunk, chunk.length() == 0);
-                    }
+                    });
                     if (isParsingInvalidChunkedEncoding(remainingStreamingBytes))
                     {
                         return FULLPTR;
@@ -737,10 +917,9 @@ namespace uWS
                         if (isParsingChunkedEncoding(remainingStreamingBytes))
                         {
                             std::string_view dataToConsume(data, length);
-                            for (auto chunk : uWS::ChunkIterator(&dataToConsume, &remainingStreamingBytes))
-                            {
+                            uWS::forEachCoalescedChunk(dataToConsume, remainingStreamingBytes, [&](std::string_view chunk) {
                                 dataHandler(user, chunk, chunk.length() == 0);
-                            }
+                            });
                             if (isParsingInvalidChunkedEncoding(remainingStreamingBytes))
                             {
                                 return FULLPTR;
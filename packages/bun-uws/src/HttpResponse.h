@@ -33,6 +33,12 @@
 
 #include "MoveOnlyFunction.h"
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 /* todo: tryWrite is missing currently, only send smaller segments with write */
 
 namespace uWS {
@@ -71,11 +77,37 @@ public:
         Super::write(buf, length);
     }
 
+    /* Latency stats: the first response byte of the current request is about to be written */
+    void recordFirstByte(HttpResponseData<SSL> *httpResponseData) {
+        if (httpResponseData->respondingSince) {
+            HttpContextData<SSL> *httpContextData = (HttpContextData<SSL> *) us_socket_context_ext(SSL, us_socket_context(SSL, (us_socket_t *) this));
+            if (httpContextData->latencyStats) {
+                httpContextData->latencyStats->histograms[HttpLatencyStats::STAGE_FIRST_BYTE].record(LatencyHistogram::now() - httpResponseData->respondingSince);
+            }
+            httpResponseData->respondingSince = 0;
+        }
+    }
+
     /* Called only once per request */
     void writeMark() {
         /* Date is always written */
         writeHeader("Date", std::string_view(((LoopData *) us_loop_ext(us_socket_context_loop(SSL, (us_socket_context(SSL, (us_socket_t *) this)))))->date, 29));
 
+        /* Tells clients they may switch to HTTP/3 */
+        HttpContextData<SSL> *httpContextData = (HttpContextData<SSL> *) us_socket_context_ext(SSL, us_socket_context(SSL, (us_socket_t *) this));
+        if (!httpContextData->altSvc.empty()) {
+            writeHeader("Alt-Svc", httpContextData->altSvc);
+        }
+
+        /* While draining, tell the client to take its next request elsewhere */
+        if (httpContextData->draining) {
+            HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+            if ((httpResponseData->state & HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE) == 0) {
+                writeHeader("Connection", "close");
+                httpResponseData->state |= HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE;
+            }
+        }
+
         /* You can disable this altogether */
 // #ifndef UWS_HTTPRESPONSE_NO_WRITEMARK
 //         if (!Super::getLoopData()->noMark) {
@@ -91,13 +123,29 @@ public:
         /* Write status if not already done */
         writeStatus(HTTP_200_OK);
 
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+
+        /* The total size counts uncompressed bytes, only the last of them finish the compressed stream.
+         * What comes before is sent as chunks, so there is never any backpressure to report */
+        if (httpResponseData->compressor) {
+            if (totalSize && httpResponseData->compressedInput + data.length() < totalSize) {
+                write(data);
+                return true;
+            }
+
+            std::unique_ptr<HttpCompressor> compressor = std::move(httpResponseData->compressor);
+            LoopData *loopData = Super::getLoopData();
+            std::string_view compressed = compressor->compress(data, true);
+            bool success = internalEnd(compressed, compressed.length(), optional, allowContentLength, closeConnection);
+            loopData->getHttpCompressorPool()->release(std::move(compressor));
+            return success;
+        }
+
         /* If no total size given then assume this chunk is everything */
         if (!totalSize) {
             totalSize = data.length();
         }
 
-        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
-
         /* In some cases, such as when refusing huge data we want to close the connection when drained */
         if (closeConnection) {
 
@@ -217,6 +265,86 @@ public:
         }
     }
 
+    /* Reads a file chunk for when the socket cannot send files itself (TLS without kTLS) */
+    static int readFileChunk(int fd, uint64_t offset, char *buf, int length) {
+#ifdef _WIN32
+        if (_lseeki64(fd, (long long) offset, SEEK_SET) < 0) {
+            return -1;
+        }
+        return _read(fd, buf, (unsigned int) length);
+#else
+        return (int) pread(fd, buf, (size_t) length, (off_t) offset);
+#endif
+    }
+
+    /* Continues sending the file body set up by sendFile. Returns true when it has been sent completely,
+     * false on backpressure in which case we continue on writable. */
+    bool internalSendFile() {
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+
+        /* Headers (and anything else buffered) go out before the file */
+        if (Super::isCorked()) {
+            Super::uncork();
+        }
+
+        while (httpResponseData->fileRemaining) {
+            if (Super::getBufferedAmount()) {
+                /* Drain what we can, the rest on writable */
+                Super::write(nullptr, 0, true, 0);
+                if (Super::getBufferedAmount()) {
+                    Super::timeout(HTTP_TIMEOUT_S);
+                    return false;
+                }
+            }
+
+            /* uSockets only deals with int sizes */
+            int length = (int) std::min<uint64_t>(httpResponseData->fileRemaining, INT_MAX);
+            int sent = us_socket_sendfile(SSL, (us_socket_t *) this, httpResponseData->fileFd, (long long) httpResponseData->fileOffset, length);
+            bool failed;
+            if (sent < 0) {
+                /* No zero-copy path for this socket or file, copy through a chunk at a time */
+                char buf[16 * 1024];
+                int read = readFileChunk(httpResponseData->fileFd, httpResponseData->fileOffset, buf, std::min<int>(length, (int) sizeof(buf)));
+                if (read <= 0) {
+                    /* The file ended before its announced length, this response can never complete */
+                    httpResponseData->fileRemaining = 0;
+                    Super::close();
+                    return false;
+                }
+                auto [written, writeFailed] = Super::write(buf, read, true);
+                sent = written;
+                failed = writeFailed || written < read;
+            } else {
+                failed = sent < length;
+            }
+
+            httpResponseData->fileOffset += (uint64_t) sent;
+            httpResponseData->fileRemaining -= (uint64_t) sent;
+            httpResponseData->offset += (uint64_t) sent;
+
+            if (failed && httpResponseData->fileRemaining) {
+                Super::timeout(HTTP_TIMEOUT_S);
+                return false;
+            }
+        }
+
+        httpResponseData->markDone();
+        Super::timeout(HTTP_TIMEOUT_S);
+
+        /* We need to check if we should close this socket here now */
+        if (httpResponseData->state & HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE) {
+            if ((httpResponseData->state & HttpResponseData<SSL>::HTTP_RESPONSE_PENDING) == 0) {
+                if (((AsyncSocket<SSL> *) this)->getBufferedAmount() == 0) {
+                    ((AsyncSocket<SSL> *) this)->shutdown();
+                    /* We need to force close after sending FIN since we want to hinder
+                     * clients from keeping to send their huge data */
+                    ((AsyncSocket<SSL> *) this)->close();
+                }
+            }
+        }
+        return true;
+    }
+
 public:
     /* If we have proxy support; returns the proxed source address as reported by the proxy. */
 #ifdef UWS_WITH_PROXY
@@ -228,6 +356,24 @@ public:
         return Super::addressAsText(getProxiedRemoteAddress());
     }
 
+    unsigned int getProxiedRemotePort() {
+        return getHttpResponseData()->proxyParser.getSourcePort();
+    }
+
+    /* The TLVs of the PROXY header, e.g. PP2_TYPE_AUTHORITY or PP2_TYPE_UNIQUE_ID. Empty if it had none */
+    std::string_view getProxyTlv(uint8_t type) {
+        return getHttpResponseData()->proxyParser.getTlv(type);
+    }
+
+    /* TLS details the proxy terminated, e.g. PP2_SUBTYPE_SSL_CN for the client certificate */
+    std::string_view getProxySslTlv(uint8_t subtype) {
+        return getHttpResponseData()->proxyParser.getSslTlv(subtype);
+    }
+
+    std::string_view getProxiedAwsVpceId() {
+        return getHttpResponseData()->proxyParser.getAwsVpceId();
+    }
+
 
 #endif
 
@@ -288,6 +434,11 @@ public:
                     if (webSocketContextData->compression & DEDICATED_COMPRESSOR_3KB) {
                         compressOptions = DEDICATED_COMPRESSOR_3KB;
                     }
+
+                    /* Dedicated compressors may be lent from the loop's pool */
+                    if (webSocketContextData->compression & CompressOptions::POOLED_COMPRESSOR) {
+                        compressOptions = CompressOptions(compressOptions | CompressOptions::POOLED_COMPRESSOR);
+                    }
                 }
 
                 /* Here we modify the above compression with negotiated decompressor */
@@ -390,6 +541,7 @@ public:
 
         /* Update status */
         httpResponseData->state |= HttpResponseData<SSL>::HTTP_STATUS_CALLED;
+        recordFirstByte(httpResponseData);
 
         Super::write("HTTP/1.1 ", 9);
         Super::write(status.data(), (int) status.length());
@@ -421,6 +573,12 @@ public:
 
     /* End without a body (no content-length) or end with a spoofed content-length. */
     void endWithoutBody(std::optional<size_t> reportedContentLength = std::nullopt, bool closeConnection = false) {
+        /* Such as for HEAD, there is nothing to compress */
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+        if (httpResponseData->compressor) {
+            Super::getLoopData()->getHttpCompressorPool()->release(std::move(httpResponseData->compressor));
+        }
+
         if (reportedContentLength.has_value()) {
             internalEnd({nullptr, 0}, reportedContentLength.value(), false, true, closeConnection);
         } else {
@@ -433,12 +591,103 @@ public:
         internalEnd(data, data.length(), false, true, closeConnection);
     }
 
+    /* Compresses the body of this response with the coding of allowed that the client prefers, given its
+     * Accept-Encoding header. Call after writeStatus and before any body, then write, end and tryEnd as
+     * usual; a compressed response is buffered rather than reporting backpressure. Not for sendFile.
+     * Returns false, and changes nothing, if the client accepts none of them */
+    bool compress(std::string_view acceptEncoding, unsigned int allowed = HTTP_ENCODINGS_SUPPORTED) {
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+        if (httpResponseData->compressor || (httpResponseData->state & (HttpResponseData<SSL>::HTTP_WRITE_CALLED | HttpResponseData<SSL>::HTTP_END_CALLED))) {
+            return false;
+        }
+
+        HttpContentEncoding encoding = negotiateContentEncoding(acceptEncoding, allowed);
+        if (encoding == HTTP_ENCODING_IDENTITY) {
+            return false;
+        }
+
+        writeHeader("Content-Encoding", contentEncodingName(encoding));
+        writeHeader("Vary", "Accept-Encoding");
+        httpResponseData->compressor = Super::getLoopData()->getHttpCompressorPool()->get(encoding);
+        httpResponseData->compressedInput = 0;
+        return true;
+    }
+
+    /* End the response with a body that is sent over and over, such as that of a static route or a reused
+     * Response. Its compressed forms are made once per loop, at the best level of their coding, and are kept
+     * under key, which has to change when the body does. Small bodies and clients accepting none of the
+     * allowed codings get the body as is */
+    void endCached(std::string_view key, std::string_view body, std::string_view acceptEncoding, unsigned int allowed = HTTP_ENCODINGS_SUPPORTED, bool closeConnection = false) {
+        if (body.length() < HTTP_COMPRESSION_MIN_SIZE || getHttpResponseData()->compressor) {
+            end(body, closeConnection);
+            return;
+        }
+
+        /* Shared caches have to tell the forms apart, identity included */
+        writeHeader("Vary", "Accept-Encoding");
+        HttpContentEncoding encoding = negotiateContentEncoding(acceptEncoding, allowed);
+        if (encoding == HTTP_ENCODING_IDENTITY) {
+            end(body, closeConnection);
+            return;
+        }
+
+        writeHeader("Content-Encoding", contentEncodingName(encoding));
+        end(Super::getLoopData()->getHttpCompressionCache()->get(key, body, encoding), closeConnection);
+    }
+
+    /* End the response with a complete, already serialized response (status line, headers and body) written as is.
+     * Nothing may have been written on this response before. Always starts a timeout. */
+    bool endSerialized(std::string_view response) {
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+        httpResponseData->state |= HttpResponseData<SSL>::HTTP_STATUS_CALLED | HttpResponseData<SSL>::HTTP_END_CALLED;
+        recordFirstByte(httpResponseData);
+
+        auto [written, failed] = Super::write(response.data(), (int) response.length());
+        httpResponseData->markDone();
+        Super::timeout(HTTP_TIMEOUT_S);
+
+        /* We need to check if we should close this socket here now */
+        if (!Super::isCorked()) {
+            if (httpResponseData->state & HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE) {
+                if ((httpResponseData->state & HttpResponseData<SSL>::HTTP_RESPONSE_PENDING) == 0) {
+                    if (((AsyncSocket<SSL> *) this)->getBufferedAmount() == 0) {
+                        ((AsyncSocket<SSL> *) this)->shutdown();
+                        /* We need to force close after sending FIN since we want to hinder
+                         * clients from keeping to send their huge data */
+                        ((AsyncSocket<SSL> *) this)->close();
+                    }
+                }
+            }
+        }
+
+        return !failed;
+    }
+
     /* Try and end the response. Returns [true, true] on success.
      * Starts a timeout in some cases. Returns [ok, hasResponded] */
     std::pair<bool, bool> tryEnd(std::string_view data, uint64_t totalSize = 0, bool closeConnection = false) {
         return {internalEnd(data, totalSize, true, true, closeConnection), hasResponded()};
     }
 
+    /* End the response with length bytes of fd starting at offset as body, sent with sendfile on plaintext
+     * and kTLS sockets. Whatever cannot be sent right away continues on writable, before any onWritable
+     * handler is called. The fd must stay open until the response is done or aborted. Returns true if the
+     * entire body was sent. */
+    bool sendFile(int fd, uint64_t offset, uint64_t length, bool closeConnection = false) {
+        /* Writes status and headers with the right content-length, but no body */
+        internalEnd({nullptr, 0}, length, true, true, closeConnection);
+        if (!length) {
+            return true;
+        }
+
+        HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
+        httpResponseData->fileFd = fd;
+        httpResponseData->fileOffset = offset;
+        httpResponseData->fileRemaining = length;
+
+        return internalSendFile();
+    }
+
     /* Write the end of chunked encoded stream */
     bool sendTerminatingChunk(bool closeConnection = false) {
         writeStatus(HTTP_200_OK);
@@ -469,6 +718,14 @@ public:
 
         HttpResponseData<SSL> *httpResponseData = getHttpResponseData();
 
+        if (httpResponseData->compressor) {
+            httpResponseData->compressedInput += data.length();
+            data = httpResponseData->compressor->compress(data, false);
+            if (!data.length()) {
+                return true;
+            }
+        }
+
         if (!(httpResponseData->state & HttpResponseData<SSL>::HTTP_WRITE_CALLED)) {
             /* Write mark on first call to write */
             writeMark();
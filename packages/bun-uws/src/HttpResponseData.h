@@ -23,6 +23,7 @@
 #include "HttpParser.h"
 #include "AsyncSocketData.h"
 #include "ProxyParser.h"
+#include "HttpCompression.h"
 
 #include "MoveOnlyFunction.h"
 
@@ -40,6 +41,9 @@ struct HttpResponseData : AsyncSocketData<SSL>, HttpParser {
         onWritable = nullptr;
         /* Ignore data after this point */
         inStream = nullptr;
+        /* Any file body is done as well */
+        fileFd = -1;
+        fileRemaining = 0;
 
         /* We are done with this request */
         this->state &= ~HttpResponseData<SSL>::HTTP_RESPONSE_PENDING;
@@ -81,12 +85,34 @@ struct HttpResponseData : AsyncSocketData<SSL>, HttpParser {
     /* Outgoing offset */
     uint64_t offset = 0;
 
+    /* File body being sent by sendFile, continued on writable */
+    int fileFd = -1;
+    uint64_t fileOffset = 0;
+    uint64_t fileRemaining = 0;
+
+    /* Lent from the loop while this response is compressed, along with how much of its body it has taken */
+    std::unique_ptr<HttpCompressor> compressor;
+    uint64_t compressedInput = 0;
+
     /* Let's track number of bytes since last timeout reset in data handler */
     unsigned int received_bytes_per_timeout = 0;
 
     /* Current state (content-length sent, status sent, write called, etc */
     int state = 0;
 
+    /* Latency stats: when the first bytes of the next request were read, and when the
+     * current request (still without any response bytes written) was read */
+    uint64_t receivedAt = 0;
+    uint64_t respondingSince = 0;
+
+    /* The peer's address as text and its port, formatted the first time they are asked for.
+     * They cannot change for the life of the connection, so keep-alive requests share them */
+    char remoteAddress[46]; // INET6_ADDRSTRLEN
+    uint8_t remoteAddressLength = 0;
+    bool remoteAddressIsIPv6 = false;
+    bool remoteAddressCached = false;
+    int remotePort = 0;
+
 #ifdef UWS_WITH_PROXY
     ProxyParser proxyParser;
 #endif
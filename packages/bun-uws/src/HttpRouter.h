@@ -137,6 +137,192 @@ private:
         }), std::move(newNode))->get();
     }
 
+    /* Frozen copy of the matching tree. Everything lives in a few contiguous arrays
+     * and refers to everything else by index, so a lookup touches a handful of cache lines */
+    enum : uint32_t {
+        FLAT_STATIC_RUN,
+        FLAT_PARAMETER,
+        FLAT_WILDCARD
+    };
+
+    struct FlatNode {
+        uint32_t edgesBegin, edgesEnd;
+        uint32_t handlersBegin, handlersEnd;
+        uint32_t nameBegin, nameLength;
+    };
+
+    /* Children in tree order. Consecutive static children become one run looked up by hash,
+     * since at most one of them can equal the segment */
+    struct FlatEdge {
+        uint32_t type;
+        /* Index into flatRuns for FLAT_STATIC_RUN, otherwise into flatNodes */
+        uint32_t index;
+    };
+
+    /* Perfect hash of the names in a run (hash and displace). A first hash picks the bucket,
+     * the bucket's seed then gives each name its own slot in flatSlots[slotsBegin, slotsBegin + slotsMask] */
+    struct FlatRun {
+        uint32_t seedsBegin, bucketMask;
+        uint32_t slotsBegin, slotsMask;
+    };
+
+    bool frozen = false;
+    std::vector<FlatNode> flatNodes;
+    std::vector<FlatEdge> flatEdges;
+    std::vector<FlatRun> flatRuns;
+    std::vector<uint32_t> flatSeeds;
+    std::vector<uint32_t> flatSlots;
+    std::vector<uint32_t> flatHandlers;
+    std::string flatNames;
+
+    static inline uint32_t hashSegment(std::string_view segment, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+        for (unsigned char c : segment) {
+            h = (h ^ c) * 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    inline std::string_view flatName(uint32_t node) {
+        return {flatNames.data() + flatNodes[node].nameBegin, flatNodes[node].nameLength};
+    }
+
+    /* Returns the node of the run named segment, or UINT32_MAX */
+    inline uint32_t findInRun(uint32_t run, std::string_view segment) {
+        FlatRun &r = flatRuns[run];
+        uint32_t seed = flatSeeds[r.seedsBegin + (hashSegment(segment, 0) & r.bucketMask)];
+        uint32_t node = flatSlots[r.slotsBegin + (hashSegment(segment, seed) & r.slotsMask)];
+        if (node != UINT32_MAX && flatName(node) == segment) {
+            return node;
+        }
+        return UINT32_MAX;
+    }
+
+    /* Places the biggest buckets first, each with the first seed that lands all its names in free slots */
+    void addRun(std::vector<uint32_t> &nodes) {
+        uint32_t bucketCount = 1;
+        while (bucketCount * 2 < nodes.size()) {
+            bucketCount *= 2;
+        }
+        uint32_t size = 2;
+        while (size < nodes.size() * 2) {
+            size *= 2;
+        }
+
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t node : nodes) {
+            buckets[hashSegment(flatName(node), 0) & (bucketCount - 1)].push_back(node);
+        }
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<uint32_t> slots, seeds;
+        std::vector<uint32_t> placed;
+        bool complete = false;
+        while (!complete) {
+            slots.assign(size, UINT32_MAX);
+            seeds.assign(bucketCount, 0);
+            complete = true;
+
+            for (uint32_t bucket : order) {
+                bool fits = false;
+                /* Names in a run are unique so some seed fits, but a sparser table is cheaper than searching forever */
+                for (uint32_t seed = 1; !fits && seed < 4096; seed++) {
+                    placed.clear();
+                    fits = true;
+                    for (uint32_t node : buckets[bucket]) {
+                        uint32_t slot = hashSegment(flatName(node), seed) & (size - 1);
+                        if (slots[slot] != UINT32_MAX) {
+                            fits = false;
+                            break;
+                        }
+                        slots[slot] = node;
+                        placed.push_back(slot);
+                    }
+                    if (fits) {
+                        seeds[bucket] = seed;
+                    } else {
+                        for (uint32_t slot : placed) {
+                            slots[slot] = UINT32_MAX;
+                        }
+                    }
+                }
+                if (!fits) {
+                    size *= 2;
+                    complete = false;
+                    break;
+                }
+            }
+        }
+
+        flatRuns.push_back({(uint32_t) flatSeeds.size(), bucketCount - 1, (uint32_t) flatSlots.size(), size - 1});
+        flatSeeds.insert(flatSeeds.end(), seeds.begin(), seeds.end());
+        flatSlots.insert(flatSlots.end(), slots.begin(), slots.end());
+    }
+
+    /* Depth first, children before their parent's edges so that every node's edges are contiguous */
+    uint32_t flatten(Node *node) {
+        uint32_t index = (uint32_t) flatNodes.size();
+        flatNodes.push_back({0, 0, (uint32_t) flatHandlers.size(), 0, (uint32_t) flatNames.length(), (uint32_t) node->name.length()});
+        flatNames.append(node->name);
+        flatHandlers.insert(flatHandlers.end(), node->handlers.begin(), node->handlers.end());
+        flatNodes[index].handlersEnd = (uint32_t) flatHandlers.size();
+
+        std::vector<uint32_t> children;
+        for (std::unique_ptr<Node> &child : node->children) {
+            children.push_back(flatten(child.get()));
+        }
+
+        flatNodes[index].edgesBegin = (uint32_t) flatEdges.size();
+        std::vector<uint32_t> run;
+        for (unsigned int i = 0; i < children.size(); i++) {
+            Node *child = node->children[i].get();
+            bool isParameter = child->name.length() && child->name[0] == ':';
+            bool isWildcard = child->name.length() && child->name[0] == '*';
+
+            /* A run ends at anything non-static and where priority changes (names may repeat across priorities) */
+            if (run.size() && (isParameter || isWildcard || child->isHighPriority != node->children[i - 1]->isHighPriority)) {
+                flatEdges.push_back({FLAT_STATIC_RUN, (uint32_t) flatRuns.size()});
+                addRun(run);
+                run.clear();
+            }
+
+            if (isParameter) {
+                flatEdges.push_back({FLAT_PARAMETER, children[i]});
+            } else if (isWildcard) {
+                flatEdges.push_back({FLAT_WILDCARD, children[i]});
+            } else {
+                run.push_back(children[i]);
+            }
+        }
+        if (run.size()) {
+            flatEdges.push_back({FLAT_STATIC_RUN, (uint32_t) flatRuns.size()});
+            addRun(run);
+        }
+        flatNodes[index].edgesEnd = (uint32_t) flatEdges.size();
+
+        return index;
+    }
+
+    /* Any change to the tree goes back to routing by the tree until frozen again */
+    void thaw() {
+        if (frozen) {
+            frozen = false;
+            flatNodes = {};
+            flatEdges = {};
+            flatRuns = {};
+            flatSeeds = {};
+            flatSlots = {};
+            flatHandlers = {};
+            flatNames = {};
+        }
+    }
+
     /* Basically a pre-allocated stack */
     struct RouteParameters {
         friend struct HttpRouter;
@@ -245,6 +431,46 @@ private:
         return false;
     }
 
+    /* Same as executeHandlers, on the frozen tree */
+    bool executeFlatHandlers(uint32_t parent, int urlSegment) {
+
+        auto [segment, isStop] = getUrlSegment(urlSegment);
+
+        if (isStop) {
+            for (uint32_t i = flatNodes[parent].handlersBegin; i < flatNodes[parent].handlersEnd; i++) {
+                if (handlers[flatHandlers[i] & HANDLER_MASK](this)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        for (uint32_t e = flatNodes[parent].edgesBegin; e < flatNodes[parent].edgesEnd; e++) {
+            FlatEdge edge = flatEdges[e];
+            if (edge.type == FLAT_WILDCARD) {
+                for (uint32_t i = flatNodes[edge.index].handlersBegin; i < flatNodes[edge.index].handlersEnd; i++) {
+                    if (handlers[flatHandlers[i] & HANDLER_MASK](this)) {
+                        return true;
+                    }
+                }
+            } else if (edge.type == FLAT_PARAMETER) {
+                if (segment.length()) {
+                    routeParameters.push(segment);
+                    if (executeFlatHandlers(edge.index, urlSegment + 1)) {
+                        return true;
+                    }
+                    routeParameters.pop();
+                }
+            } else {
+                uint32_t child = findInRun(edge.index, segment);
+                if (child != UINT32_MAX && executeFlatHandlers(child, urlSegment + 1)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     /* Scans for one matching handler, returning the handler and its priority or UINT32_MAX for not found */
     uint32_t findHandler(std::string method, std::string pattern, uint32_t priority) {
         for (std::unique_ptr<Node> &node : root.children) {
@@ -300,6 +526,17 @@ public:
         setUrl(url);
         routeParameters.reset();
 
+        if (frozen) {
+            /* Root only holds method nodes, all of them static */
+            for (uint32_t e = flatNodes[0].edgesBegin; e < flatNodes[0].edgesEnd; e++) {
+                uint32_t methodNode = findInRun(flatEdges[e].index, method);
+                if (methodNode != UINT32_MAX) {
+                    return executeFlatHandlers(methodNode, 0);
+                }
+            }
+            return false;
+        }
+
         /* Begin by finding the method node */
         for (auto &p : root.children) {
             if (p->name == method) {
@@ -312,8 +549,22 @@ public:
         return false;
     }
 
+    /* Compiles the matching tree into its flat form. Call once all routes are added,
+     * adding or removing a route afterwards falls back to the tree until frozen again */
+    void freeze() {
+        thaw();
+        flatten(&root);
+        frozen = true;
+    }
+
+    bool isFrozen() {
+        return frozen;
+    }
+
     /* Adds the corresponding entires in matching tree and handler list */
     void add(std::vector<std::string> methods, std::string pattern, MoveOnlyFunction<bool(HttpRouter *)> &&handler, uint32_t priority = MEDIUM_PRIORITY) {
+        thaw();
+
         /* First remove existing handler */
         remove(methods[0], pattern, priority);
 
@@ -380,6 +631,8 @@ public:
      * Removing a wildcard is done by removing ONE OF the methods the wildcard would match with.
      * Example: If wildcard includes POST, GET, PUT, you can remove ALL THREE by removing GET. */
     void remove(std::string method, std::string pattern, uint32_t priority) {
+        thaw();
+
         uint32_t handler = findHandler(method, pattern, priority);
         if (handler == UINT32_MAX) {
             /* Not found or already removed, do nothing */
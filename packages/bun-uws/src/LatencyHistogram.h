@@ -0,0 +1,163 @@
+/*
+ * Authored by Alex Hultman, 2018-2020.
+ * Intellectual property of third-party.
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This module implements fixed size, log-linear (HDR style) latency histograms
+ * used to break down where time is spent in the HTTP request pipeline */
+
+#ifndef UWS_LATENCYHISTOGRAM_H
+#define UWS_LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+
+namespace uWS {
+
+struct LatencyHistogram {
+    /* Every power of two range is split in 2^SUB_BUCKET_BITS linear buckets, giving
+     * a worst case relative error of 1/8 (12.5%) for any recorded value */
+    static const unsigned int SUB_BUCKET_BITS = 3;
+    static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    /* Values are nanoseconds, anything above 2^40 (about 18 minutes) is clamped */
+    static const unsigned int MAX_MAGNITUDE = 40;
+    static const unsigned int BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    uint64_t buckets[BUCKET_COUNT] = {};
+    uint64_t totalCount = 0;
+    uint64_t totalSum = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+
+    static unsigned int bucketIndex(uint64_t value) {
+        /* Values below two full sub bucket ranges are stored exactly */
+        if (value < 2 * SUB_BUCKETS) {
+            return (unsigned int) value;
+        }
+        if (value >= (1ull << MAX_MAGNITUDE)) {
+            return BUCKET_COUNT - 1;
+        }
+        unsigned int magnitude = 63 - (unsigned int) __builtin_clzll(value);
+        unsigned int shift = magnitude - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + (unsigned int) (value >> shift) - SUB_BUCKETS;
+    }
+
+    /* Highest value that maps to given bucket */
+    static uint64_t bucketUpperBound(unsigned int index) {
+        if (index < 2 * SUB_BUCKETS) {
+            return index;
+        }
+        unsigned int shift = index / SUB_BUCKETS - 1;
+        uint64_t lower = (uint64_t) (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + (1ull << shift) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        buckets[bucketIndex(value)]++;
+        totalCount++;
+        totalSum += value;
+        if (value < minValue) {
+            minValue = value;
+        }
+        if (value > maxValue) {
+            maxValue = value;
+        }
+    }
+
+    void reset() {
+        memset(buckets, 0, sizeof(buckets));
+        totalCount = 0;
+        totalSum = 0;
+        minValue = UINT64_MAX;
+        maxValue = 0;
+    }
+
+    uint64_t count() {
+        return totalCount;
+    }
+
+    uint64_t min() {
+        return totalCount ? minValue : 0;
+    }
+
+    uint64_t max() {
+        return maxValue;
+    }
+
+    uint64_t mean() {
+        return totalCount ? totalSum / totalCount : 0;
+    }
+
+    /* Value at given percentile (0 - 100), never above the recorded max */
+    uint64_t percentile(double p) {
+        if (!totalCount) {
+            return 0;
+        }
+
+        uint64_t rank = (uint64_t) (p / 100.0 * (double) totalCount + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+
+        uint64_t seen = 0;
+        for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint64_t upper = bucketUpperBound(i);
+                return upper < maxValue ? upper : maxValue;
+            }
+        }
+        return maxValue;
+    }
+
+    /* Monotonic nanoseconds */
+    static uint64_t now() {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/* Histograms of every stage an HTTP request passes through, kept per HttpContext when enabled */
+struct HttpLatencyStats {
+    enum Stage : unsigned int {
+        /* First bytes of the request read until all headers are parsed */
+        STAGE_PARSE,
+        /* Headers parsed until the matched handler is called */
+        STAGE_ROUTE,
+        /* Time spent inside the (synchronous part of the) handler */
+        STAGE_HANDLER,
+        /* First bytes of the request read until the first byte of the response is written */
+        STAGE_FIRST_BYTE,
+        STAGE_COUNT
+    };
+
+    LatencyHistogram histograms[STAGE_COUNT];
+
+    /* Set when headers are parsed, consumed when routing reaches the handler */
+    uint64_t routeStartedAt = 0;
+
+    void reset() {
+        for (auto &h : histograms) {
+            h.reset();
+        }
+    }
+};
+
+}
+
+#endif // UWS_LATENCYHISTOGRAM_H
@@ -0,0 +1,95 @@
+#pragma once
+/*
+ * Authored by Alex Hultman, 2018-2020.
+ * Intellectual property of third-party.
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ *     http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// clang-format off
+#ifndef UWS_LOCALCLUSTER_H
+#define UWS_LOCALCLUSTER_H
+
+/* Runs one app per thread, each with its own loop and its own SO_REUSEPORT listen socket on the same port.
+ * The kernel spreads connections over the threads and the threads share nothing */
+
+#include "App.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace uWS {
+
+template <bool SSL>
+struct TemplatedLocalCluster {
+private:
+    SocketContextOptions options;
+    std::function<void(TemplatedApp<SSL> &)> setup;
+    unsigned int threadCount;
+
+public:
+    /* The setup function is called on every thread with the app of that thread, to add its routes.
+     * A threadCount of 0 means one thread per hardware thread */
+    TemplatedLocalCluster(SocketContextOptions options, std::function<void(TemplatedApp<SSL> &)> setup, unsigned int threadCount = 0)
+        : options(options), setup(std::move(setup)), threadCount(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    /* Listens on every thread and runs until all of the apps are done. The handler is called on every thread
+     * with its listen socket, or null if that one failed */
+    void listen(std::string host, int port, std::function<void(us_listen_socket_t *, unsigned int thread)> handler) {
+        unsigned int cpus = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, host, port, handler, i, cpus]() {
+                int cpu = (int) (i % cpus);
+#ifdef __linux__
+                /* Pinned, a thread gets the connections the kernel handled on its own cpu */
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+                    cpu = -1;
+                }
+#endif
+
+                TemplatedApp<SSL> app(options);
+                setup(app);
+                app.listen(host, port, [&](us_listen_socket_t *listenSocket) {
+                    if (listenSocket && cpu != -1) {
+                        us_listen_socket_set_incoming_cpu(SSL, listenSocket, cpu);
+                    }
+                    handler(listenSocket, i);
+                });
+                app.run();
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+typedef TemplatedLocalCluster<false> LocalCluster;
+typedef TemplatedLocalCluster<true> SSLLocalCluster;
+
+}
+
+#endif // UWS_LOCALCLUSTER_H
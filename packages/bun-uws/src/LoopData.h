@@ -27,7 +27,9 @@
 #include <cstdint>
 
 #include "PerMessageDeflate.h"
+#include "HttpCompression.h"
 #include "MoveOnlyFunction.h"
+#include "LatencyHistogram.h"
 
 struct us_timer_t;
 
@@ -57,6 +59,9 @@ public:
             delete inflationStream;
             delete deflationStream;
         }
+        delete deflationStreamPool;
+        delete httpCompressorPool;
+        delete httpCompressionCache;
         delete [] corkBuffer;
     }
 
@@ -88,6 +93,17 @@ public:
 
     char date[32];
 
+    /* Monotonic nanoseconds, read at most once per loop iteration (only used by latency stats) */
+    uint64_t getIterationTime(long long iteration) {
+        if (iteration != clockIteration) {
+            clockIteration = iteration;
+            clockTime = LatencyHistogram::now();
+        }
+        return clockTime;
+    }
+    long long clockIteration = -1;
+    uint64_t clockTime = 0;
+
     /* Be silent */
     bool noMark = false;
 
@@ -104,6 +120,24 @@ public:
     ZlibContext *zlibContext = nullptr;
     InflationStream *inflationStream = nullptr;
     DeflationStream *deflationStream = nullptr;
+    /* Dedicated compressors lent to sockets using CompressOptions::POOLED_COMPRESSOR */
+    DeflationStreamPool *deflationStreamPool = nullptr;
+
+    /* Response compression, set up by the first response to need it */
+    HttpCompressorPool *getHttpCompressorPool() {
+        if (!httpCompressorPool) {
+            httpCompressorPool = new HttpCompressorPool(UWS_MAX_POOLED_HTTP_COMPRESSORS);
+        }
+        return httpCompressorPool;
+    }
+    HttpCompressionCache *getHttpCompressionCache() {
+        if (!httpCompressionCache) {
+            httpCompressionCache = new HttpCompressionCache(UWS_HTTP_COMPRESSION_CACHE_SIZE);
+        }
+        return httpCompressionCache;
+    }
+    HttpCompressorPool *httpCompressorPool = nullptr;
+    HttpCompressionCache *httpCompressionCache = nullptr;
 
     us_timer_t *dateTimer;
 };
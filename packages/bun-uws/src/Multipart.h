@@ -24,6 +24,7 @@
 #include "MessageParser.h"
 
 #include <string_view>
+#include <string>
 #include <optional>
 #include <cstring>
 #include <utility>
@@ -226,6 +227,210 @@ namespace uWS {
         }
     };
 
+    /* Incremental variant of MultipartParser, for bodies arriving in chunks (like from HttpResponse::onData).
+     * Part data is handed on as views into the chunks given, so the body is never accumulated. The only
+     * thing buffered is the headers of a part and, when a chunk ends in what could be the start of a
+     * boundary, up to one boundary length of data held back until the next chunk tells */
+    struct StreamingMultipartParser {
+
+        /* Headers of a single part are limited to this */
+        static const unsigned int MAX_PART_HEADERS_SIZE = 8 * 1024;
+
+    private:
+        enum State {
+            PREAMBLE,
+            AFTER_BOUNDARY,
+            HEADERS,
+            DATA,
+            DONE,
+            ERROR
+        } state = PREAMBLE;
+
+        /* Boundaries are delimited as CRLF, two hyphens and the boundary itself */
+        char delimiterBuffer[74];
+        std::string_view delimiter;
+
+        /* Headers, or data held back at the end of the previous chunk */
+        std::string held;
+
+        /* Returns the length of the longest suffix of data that is a prefix of the delimiter */
+        size_t partialDelimiterLength(std::string_view data) {
+            for (size_t length = std::min<size_t>(data.length(), delimiter.length() - 1); length; length--) {
+                if (!memcmp(data.data() + data.length() - length, delimiter.data(), length)) {
+                    return length;
+                }
+            }
+            return 0;
+        }
+
+        /* Consumes part data (or preamble, which is dropped) up to and including the next delimiter */
+        template <class PartData>
+        void consumeData(std::string_view &chunk, PartData &onPartData) {
+            bool emit = state == DATA;
+
+            /* A delimiter may have started in what we held back */
+            if (held.length()) {
+                std::string_view head = chunk.substr(0, delimiter.length() - 1);
+                std::string combined = held + std::string(head);
+                size_t found = combined.find(delimiter);
+
+                if (found != std::string::npos) {
+                    if (emit) {
+                        onPartData(std::string_view(combined.data(), found), true);
+                    }
+                    chunk.remove_prefix(found + delimiter.length() - held.length());
+                    held.clear();
+                    state = AFTER_BOUNDARY;
+                    return;
+                }
+
+                if (head.length() == delimiter.length() - 1) {
+                    /* Any delimiter starting in what we held would have been found, so it is all data */
+                    if (emit) {
+                        onPartData(held, false);
+                    }
+                    held.clear();
+                } else {
+                    /* The whole chunk is too short to tell, hold on to what could still be a delimiter */
+                    size_t partial = partialDelimiterLength(combined);
+                    if (emit && combined.length() > partial) {
+                        onPartData(std::string_view(combined.data(), combined.length() - partial), false);
+                    }
+                    held = combined.substr(combined.length() - partial);
+                    chunk = {};
+                    return;
+                }
+            }
+
+            size_t found = chunk.find(delimiter);
+            if (found != std::string_view::npos) {
+                if (emit) {
+                    onPartData(chunk.substr(0, found), true);
+                }
+                chunk.remove_prefix(found + delimiter.length());
+                state = AFTER_BOUNDARY;
+                return;
+            }
+
+            size_t partial = partialDelimiterLength(chunk);
+            if (emit && chunk.length() > partial) {
+                onPartData(chunk.substr(0, chunk.length() - partial), false);
+            }
+            held.assign(chunk.data() + chunk.length() - partial, partial);
+            chunk = {};
+        }
+
+        /* Either two hyphens (the end) or CRLF (another part) follow a boundary, after optional padding */
+        void consumeAfterBoundary(std::string_view &chunk) {
+            while (chunk.length() && state == AFTER_BOUNDARY) {
+                char c = chunk[0];
+                chunk.remove_prefix(1);
+
+                if (!held.length()) {
+                    if (c != ' ' && c != '\t') {
+                        held.push_back(c);
+                    }
+                } else {
+                    if (held[0] == '-' && c == '-') {
+                        state = DONE;
+                    } else if (held[0] == '\r' && c == '\n') {
+                        state = HEADERS;
+                    } else {
+                        state = ERROR;
+                    }
+                    held.clear();
+                }
+            }
+        }
+
+        template <class PartBegin>
+        void consumeHeaders(std::string_view &chunk, PartBegin &onPartBegin) {
+            size_t searchFrom = held.length() > 3 ? held.length() - 3 : 0;
+            size_t heldBefore = held.length();
+            held.append(chunk.substr(0, MAX_PART_HEADERS_SIZE + 1 - held.length()));
+
+            /* A part may have no headers at all */
+            size_t headersLength;
+            if (held.length() >= 2 && held[0] == '\r' && held[1] == '\n') {
+                headersLength = 2;
+            } else {
+                size_t found = held.find("\r\n\r\n", searchFrom);
+                if (found == std::string::npos) {
+                    if (held.length() > MAX_PART_HEADERS_SIZE) {
+                        state = ERROR;
+                    }
+                    chunk = {};
+                    return;
+                }
+                headersLength = found + 4;
+            }
+
+            chunk.remove_prefix(headersLength - heldBefore);
+            held.resize(headersLength);
+
+            std::pair<std::string_view, std::string_view> headers[MAX_HEADERS];
+            if (!getHeaders(held.data(), held.data() + held.length(), headers)) {
+                state = ERROR;
+                return;
+            }
+
+            /* Headers point into our buffer, so they are only valid for the duration of the callback */
+            onPartBegin(headers);
+            held.clear();
+            state = DATA;
+        }
+
+    public:
+        /* Construct the parser based on contentType (reads boundary, same as MultipartParser) */
+        StreamingMultipartParser(std::string_view contentType) {
+            MultipartParser boundaryParser(contentType);
+            if (!boundaryParser.isValid()) {
+                state = ERROR;
+                return;
+            }
+
+            delimiterBuffer[0] = '\r';
+            delimiterBuffer[1] = '\n';
+            memcpy(&delimiterBuffer[2], boundaryParser.prependedBoundary.data(), boundaryParser.prependedBoundary.length());
+            delimiter = {delimiterBuffer, boundaryParser.prependedBoundary.length() + 2};
+
+            /* The first boundary may come without CRLF in front, so pretend there was one */
+            held = "\r\n";
+        }
+
+        bool isValid() {
+            return state != ERROR;
+        }
+
+        /* Whether the closing boundary has been seen (anything after it is ignored) */
+        bool isDone() {
+            return state == DONE;
+        }
+
+        /* Feeds the next chunk of the body. Calls onPartBegin(headers) as a part starts and onPartData(data, last)
+         * with its data, where the last call for a part (possibly with empty data) has last set. Returns false on error */
+        template <class PartBegin, class PartData>
+        bool write(std::string_view chunk, PartBegin &&onPartBegin, PartData &&onPartData) {
+            while (chunk.length() && state != DONE && state != ERROR) {
+                switch (state) {
+                case PREAMBLE:
+                case DATA:
+                    consumeData(chunk, onPartData);
+                    break;
+                case AFTER_BOUNDARY:
+                    consumeAfterBoundary(chunk);
+                    break;
+                case HEADERS:
+                    consumeHeaders(chunk, onPartBegin);
+                    break;
+                default:
+                    break;
+                }
+            }
+            return state != ERROR;
+        }
+    };
+
 }
 
 #endif
@@ -58,7 +58,10 @@ namespace uWS {
         DEDICATED_COMPRESSOR_128KB = 14 << 4 | 7,
         DEDICATED_COMPRESSOR_256KB = 15 << 4 | 8,
         /* Same as 256kb */
-        DEDICATED_COMPRESSOR = 15 << 4 | 8
+        DEDICATED_COMPRESSOR = 15 << 4 | 8,
+
+        /* Bit 12 lends dedicated compressors from a bounded per loop pool instead of keeping one per socket */
+        POOLED_COMPRESSOR = 1 << 12
     };
 }
 
@@ -68,6 +71,13 @@ namespace uWS {
 
 #include <string>
 #include <optional>
+#include <vector>
+#include <memory>
+
+/* Upper bound of dedicated compressors kept per loop for CompressOptions::POOLED_COMPRESSOR */
+#ifndef UWS_MAX_POOLED_COMPRESSORS
+#define UWS_MAX_POOLED_COMPRESSORS 1024
+#endif
 
 #ifdef UWS_USE_LIBDEFLATE
 #include "libdeflate.h"
@@ -90,6 +100,8 @@ struct DeflationStream {
     std::string_view deflate(ZlibContext * /*zlibContext*/, std::string_view raw, bool /*reset*/) {
         return raw;
     }
+    void reset() {
+    }
     DeflationStream(CompressOptions /*compressOptions*/) {
     }
 };
@@ -207,6 +219,11 @@ struct DeflationStream {
         };
     }
 
+    /* Forget the sliding window, the next message will not refer back to earlier ones */
+    void reset() {
+        deflateReset(&deflationStream);
+    }
+
     ~DeflationStream() {
         deflateEnd(&deflationStream);
     }
@@ -310,6 +327,100 @@ struct InflationStream {
 
 #endif
 
+/* Dedicated compressors are big (up to 256kb each) and most sockets are idle most of the time.
+ * This pool keeps a bounded number of them, lent to whichever sockets are sending. When the pool
+ * is full, the least recently used stream is reset and taken over. Losing its sliding window only
+ * costs the previous owner some compression ratio: a message deflated from a fresh window never
+ * refers back to earlier messages, so the peer inflates it fine with or without context takeover */
+struct DeflationStreamPool {
+    /* What a socket holds on to. Stays valid until the stream is taken over, which bumps its leaseId */
+    struct Lease {
+        unsigned int index = 0;
+        uint64_t id = 0;
+    };
+
+private:
+    struct Entry {
+        std::unique_ptr<DeflationStream> stream;
+        CompressOptions compressOptions;
+        /* Zero when not lent */
+        uint64_t leaseId;
+        uint64_t lastUse;
+    };
+
+    std::vector<Entry> entries;
+    unsigned int maxStreams;
+    uint64_t clock = 0;
+
+    bool holds(Lease &lease) {
+        return lease.id && entries[lease.index].leaseId == lease.id;
+    }
+
+    DeflationStream *lend(Lease &lease, unsigned int index) {
+        entries[index].leaseId = lease.id = ++clock;
+        entries[index].lastUse = clock;
+        lease.index = index;
+        return entries[index].stream.get();
+    }
+
+public:
+    DeflationStreamPool(unsigned int maxStreams) : maxStreams(maxStreams ? maxStreams : 1) {}
+
+    /* Returns the stream lent to this lease, lending a new one if it was lost or never held */
+    DeflationStream *get(Lease &lease, CompressOptions compressOptions) {
+        compressOptions = (CompressOptions) (compressOptions & _COMPRESSOR_MASK);
+        if (holds(lease)) {
+            entries[lease.index].lastUse = ++clock;
+            return entries[lease.index].stream.get();
+        }
+
+        /* Prefer an idle stream of the same kind, otherwise grow, otherwise take over the least recently used */
+        unsigned int victim = 0;
+        for (unsigned int i = 0; i < entries.size(); i++) {
+            if (!entries[i].leaseId && entries[i].compressOptions == compressOptions) {
+                return lend(lease, i);
+            }
+            if (entries[i].lastUse < entries[victim].lastUse) {
+                victim = i;
+            }
+        }
+
+        if (entries.size() < maxStreams) {
+            entries.push_back({std::make_unique<DeflationStream>(compressOptions), compressOptions, 0, 0});
+            return lend(lease, (unsigned int) entries.size() - 1);
+        }
+
+        if (entries[victim].compressOptions == compressOptions) {
+            entries[victim].stream->reset();
+        } else {
+            entries[victim].stream = std::make_unique<DeflationStream>(compressOptions);
+            entries[victim].compressOptions = compressOptions;
+        }
+        return lend(lease, victim);
+    }
+
+    /* Give the stream back (if still held), it starts over for its next owner */
+    void release(Lease &lease) {
+        if (holds(lease)) {
+            entries[lease.index].leaseId = 0;
+            entries[lease.index].stream->reset();
+        }
+        lease = {};
+    }
+
+    /* Only shrinks as streams become idle */
+    void setMaxStreams(unsigned int max) {
+        maxStreams = max ? max : 1;
+        while (entries.size() > maxStreams && !entries.back().leaseId) {
+            entries.pop_back();
+        }
+    }
+
+    unsigned int size() {
+        return (unsigned int) entries.size();
+    }
+};
+
 }
 
 #endif // UWS_PERMESSAGEDEFLATE_H
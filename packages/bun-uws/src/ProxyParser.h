@@ -66,6 +66,36 @@ T _cond_byte_swap(T value) {
     return value;
 }
 
+/* TLV types of the spec, and the ones AWS and Azure add */
+enum ProxyTlvType : uint8_t {
+    PP2_TYPE_ALPN = 0x01,
+    PP2_TYPE_AUTHORITY = 0x02,
+    PP2_TYPE_CRC32C = 0x03,
+    PP2_TYPE_NOOP = 0x04,
+    PP2_TYPE_UNIQUE_ID = 0x05,
+    PP2_TYPE_SSL = 0x20,
+    PP2_TYPE_NETNS = 0x30,
+    PP2_TYPE_AWS = 0xEA,
+    PP2_TYPE_AZURE = 0xEE
+};
+
+/* Sub-TLVs within the value of PP2_TYPE_SSL */
+enum ProxySslTlvType : uint8_t {
+    PP2_SUBTYPE_SSL_VERSION = 0x21,
+    PP2_SUBTYPE_SSL_CN = 0x22,
+    PP2_SUBTYPE_SSL_CIPHER = 0x23,
+    PP2_SUBTYPE_SSL_SIG_ALG = 0x24,
+    PP2_SUBTYPE_SSL_KEY_ALG = 0x25
+};
+
+/* The first byte of a PP2_TYPE_AWS value */
+static constexpr uint8_t PP2_SUBTYPE_AWS_VPCE_ID = 0x01;
+
+/* TLVs are copied into the parser as whole, up to this many bytes in total. Any that do not fit are skipped */
+#ifndef UWS_PROXY_TLV_CAPACITY
+#define UWS_PROXY_TLV_CAPACITY 256
+#endif
+
 struct ProxyParser {
 private:
     union proxy_addr addr;
@@ -73,12 +103,35 @@ private:
     /* Default family of 0 signals no proxy address */
     uint8_t family = 0;
 
+    uint16_t tlvsLength = 0;
+    uint8_t tlvs[UWS_PROXY_TLV_CAPACITY];
+
+    /* Finds the value of the first TLV of this type in a run of TLVs */
+    static std::string_view findTlv(const uint8_t *data, size_t length, uint8_t type) {
+        while (length >= 3) {
+            size_t valueLength = ((size_t) data[1] << 8) | data[2];
+            if (valueLength > length - 3) {
+                break;
+            }
+            if (data[0] == type) {
+                return {(const char *) data + 3, valueLength};
+            }
+            data += 3 + valueLength;
+            length -= 3 + valueLength;
+        }
+        return {};
+    }
+
+    bool isInet() {
+        return (family & 0xf0) >> 4 == 1 || (family & 0xf0) >> 4 == 2;
+    }
+
 public:
     /* Returns 4 or 16 bytes source address */
     std::string_view getSourceAddress() {
 
-        // UNSPEC family and protocol
-        if (family == 0) {
+        // UNSPEC family and protocol, or a unix socket
+        if (!isInet()) {
             return {};
         }
 
@@ -91,6 +144,65 @@ public:
         }
     }
 
+    /* Returns 4 or 16 bytes destination address */
+    std::string_view getDestinationAddress() {
+        if (!isInet()) {
+            return {};
+        }
+
+        if ((family & 0xf0) >> 4 == 1) {
+            return {(char *) &addr.ipv4_addr.dst_addr, 4};
+        } else {
+            return {(char *) &addr.ipv6_addr.dst_addr, 16};
+        }
+    }
+
+    /* Returns 0 if there is no proxy address */
+    unsigned int getSourcePort() {
+        if (!isInet()) {
+            return 0;
+        }
+        return _cond_byte_swap<uint16_t>((family & 0xf0) >> 4 == 1 ? addr.ipv4_addr.src_port : addr.ipv6_addr.src_port);
+    }
+
+    unsigned int getDestinationPort() {
+        if (!isInet()) {
+            return 0;
+        }
+        return _cond_byte_swap<uint16_t>((family & 0xf0) >> 4 == 1 ? addr.ipv4_addr.dst_port : addr.ipv6_addr.dst_port);
+    }
+
+    /* Returns the value of a TLV the proxy sent, or an empty view. Views stay valid until the next PROXY
+     * header, which in practice means for the lifetime of the connection */
+    std::string_view getTlv(uint8_t type) {
+        return findTlv(tlvs, tlvsLength, type);
+    }
+
+    /* Returns a sub-TLV of PP2_TYPE_SSL, such as the client certificate's common name */
+    std::string_view getSslTlv(uint8_t subtype) {
+        std::string_view ssl = getTlv(PP2_TYPE_SSL);
+        /* One byte of client flags and four of verify result come first */
+        if (ssl.length() < 5) {
+            return {};
+        }
+        return findTlv((const uint8_t *) ssl.data() + 5, ssl.length() - 5, subtype);
+    }
+
+    /* Returns whether the client connected to the proxy over TLS (PP2_CLIENT_SSL) */
+    bool isSsl() {
+        std::string_view ssl = getTlv(PP2_TYPE_SSL);
+        return ssl.length() >= 5 && (ssl[0] & 0x01);
+    }
+
+    /* Returns the VPC endpoint id an AWS network load balancer saw the connection come through */
+    std::string_view getAwsVpceId() {
+        std::string_view aws = getTlv(PP2_TYPE_AWS);
+        if (aws.empty() || (uint8_t) aws[0] != PP2_SUBTYPE_AWS_VPCE_ID) {
+            return {};
+        }
+        return aws.substr(1);
+    }
+
     /* Returns [done, consumed] where done = false on failure */
     std::pair<bool, unsigned int> parse(std::string_view data) {
 
@@ -126,9 +238,6 @@ public:
             return {false, 0};
         }
 
-        //printf("Version: %d\n", (header.ver_cmd & 0xf0) >> 4);
-        //printf("Command: %d\n", (header.ver_cmd & 0x0f));
-
         /* We get length in network byte order (todo: share this function with the rest) */
         uint16_t hostLength = _cond_byte_swap<uint16_t>(header.len);
 
@@ -137,22 +246,57 @@ public:
             return {false, 0};
         }
 
-        /* Payload cannot be more than sizeof proxy_addr */
-        if (sizeof(proxy_addr) < hostLength) {
+        /* The addresses come first, their size follows from the family */
+        unsigned int addressLength;
+        switch ((header.fam & 0xf0) >> 4) {
+        case 1: addressLength = 12; break;
+        case 2: addressLength = 36; break;
+        case 3: addressLength = 216; break;
+        default: addressLength = 0; break;
+        }
+
+        if (hostLength < addressLength) {
             return {false, 0};
         }
 
-        //printf("Family: %d\n", (header.fam & 0xf0) >> 4);
-        //printf("Transport: %d\n", (header.fam & 0x0f));
+        /* Make sure the TLVs are well formed before taking any of them */
+        const uint8_t *tlv = (const uint8_t *) data.data() + 16 + addressLength;
+        size_t remaining = hostLength - addressLength;
+        for (const uint8_t *p = tlv; remaining; ) {
+            if (remaining < 3) {
+                return {false, 0};
+            }
+            size_t length = 3 + (((size_t) p[1] << 8) | p[2]);
+            if (length > remaining) {
+                return {false, 0};
+            }
+            p += length;
+            remaining -= length;
+        }
 
-        /* We have 0 family by default, and UNSPEC is 0 as well */
-        family = header.fam;
+        /* LOCAL connections (command 0) come from the proxy itself, so there is no address to report */
+        family = (header.ver_cmd & 0x0f) ? header.fam : 0;
 
-        /* Copy payload */
-        memcpy(&addr, data.data() + 16, hostLength);
+        /* Copy the addresses, a unix socket's do not fit and are not reported anyway */
+        if (addressLength && addressLength <= sizeof(proxy_addr)) {
+            memcpy(&addr, data.data() + 16, addressLength);
+        }
+
+        /* Copy whole TLVs as long as they fit */
+        tlvsLength = 0;
+        remaining = hostLength - addressLength;
+        while (remaining) {
+            size_t length = 3 + (((size_t) tlv[1] << 8) | tlv[2]);
+            if (tlv[0] != PP2_TYPE_NOOP && tlvsLength + length <= UWS_PROXY_TLV_CAPACITY) {
+                memcpy(tlvs + tlvsLength, tlv, length);
+                tlvsLength += (uint16_t) length;
+            }
+            tlv += length;
+            remaining -= length;
+        }
 
         /* We consumed everything */
-        return {true, 16 + hostLength};
+        return {true, 16u + hostLength};
     }
 };
 
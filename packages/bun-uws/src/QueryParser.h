@@ -22,8 +22,64 @@
 
 #include <string_view>
 
+/* Statements beyond this many are not indexed, only scanned */
+#ifndef UWS_QUERY_MAX_PARAMETERS
+#define UWS_QUERY_MAX_PARAMETERS 32
+#endif
+
 namespace uWS {
 
+    /* Decodes a query component in place, returns the decoded length or -1 on a truncated '%' sequence.
+     * Puts null at end if before length of original, to stop next read */
+    static inline long decodeQueryComponentInPlace(char *in, unsigned int length) {
+        /* Write offset */
+        unsigned int out = 0;
+
+        /* Walk over all chars until end or null char, decoding in place */
+        for (unsigned int i = 0; i < length && in[i]; i++) {
+                /* Only bother with '%' */
+                if (in[i] == '%') {
+                    /* Do we have enough data for two bytes hex? */
+                    if (i + 2 >= length) {
+                        return -1;
+                    }
+
+                    /* Two bytes hex */
+                    int hex1 = in[i + 1] - '0';
+                    if (hex1 > 9) {
+                        hex1 &= 223;
+                        hex1 -= 7;
+                    }
+
+                    int hex2 = in[i + 2] - '0';
+                    if (hex2 > 9) {
+                        hex2 &= 223;
+                        hex2 -= 7;
+                    }
+
+                    *((unsigned char *) &in[out]) = (unsigned char) (hex1 * 16 + hex2);
+                    i += 2;
+                } else {
+                    /* Is this even a rule? */
+                    if (in[i] == '+') {
+                        in[out] = ' ';
+                    } else {
+                        in[out] = in[i];
+                    }
+                }
+
+                /* We always only write one char */
+                out++;
+        }
+
+        /* If decoded string is shorter than original, put null char to stop next read */
+        if (out < length) {
+            in[out] = 0;
+        }
+
+        return out;
+    }
+
     /* Takes raw query including initial '?' sign. Will inplace decode, so input will mutate */
     static inline std::string_view getDecodedQueryValue(std::string_view key, std::string_view rawQuery) {
 
@@ -35,7 +91,6 @@ namespace uWS {
         /* Start with the whole querystring including initial '?' */
         std::string_view queryString = rawQuery;
 
-        /* List of key, value could be cached for repeated fetches similar to how headers are, todo! */
         while (queryString.length()) {
             /* Find boundaries of this statement */
             std::string_view statement = queryString.substr(1, queryString.find('&', 1) - 1);
@@ -51,56 +106,11 @@ namespace uWS {
 
                     /* String comparison */
                     if (key == statementKey) {
-
-                        /* Decode value inplace, put null at end if before length of original */
-                        char *in = (char *) statementValue.data();
-
-                        /* Write offset */
-                        unsigned int out = 0;
-
-                        /* Walk over all chars until end or null char, decoding in place */
-                        for (unsigned int i = 0; i < statementValue.length() && in[i]; i++) {
-                                /* Only bother with '%' */
-                                if (in[i] == '%') {
-                                    /* Do we have enough data for two bytes hex? */
-                                    if (i + 2 >= statementValue.length()) {
-                                        return {};
-                                    }
-
-                                    /* Two bytes hex */
-                                    int hex1 = in[i + 1] - '0';
-                                    if (hex1 > 9) {
-                                        hex1 &= 223;
-                                        hex1 -= 7;
-                                    }
-
-                                    int hex2 = in[i + 2] - '0';
-                                    if (hex2 > 9) {
-                                        hex2 &= 223;
-                                        hex2 -= 7;
-                                    }
-
-                                    *((unsigned char *) &in[out]) = (unsigned char) (hex1 * 16 + hex2);
-                                    i += 2;
-                                } else {
-                                    /* Is this even a rule? */
-                                    if (in[i] == '+') {
-                                        in[out] = ' ';
-                                    } else {
-                                        in[out] = in[i];
-                                    }
-                                }
-
-                                /* We always only write one char */
-                                out++;
+                        long decodedLength = decodeQueryComponentInPlace((char *) statementValue.data(), (unsigned int) statementValue.length());
+                        if (decodedLength < 0) {
+                            return {};
                         }
-
-                        /* If decoded string is shorter than original, put null char to stop next read */
-                        if (out < statementValue.length()) {
-                            in[out] = 0;
-                        }
-
-                        return statementValue.substr(0, out);
+                        return statementValue.substr(0, (size_t) decodedLength);
                     }
                 } else {
                     /* This querystring is invalid, cannot parse it */
@@ -115,6 +125,118 @@ namespace uWS {
         return {nullptr, 0};
     }
 
+    /* List of key, value spans cached for repeated fetches similar to how headers are. Built in one pass
+     * on first lookup, values are decoded in place lazily and only once. Queries with more statements
+     * than fit fall back to scanning the remainder */
+    struct QueryIndex {
+        struct Parameter {
+            /* Raw key and value as found in the query, value.data() is nullptr when there is no '=' */
+            std::string_view key, value;
+            /* Set once value has been decoded in place, value then holds the decoded span */
+            bool decoded;
+        };
+
+    private:
+        Parameter parameters[UWS_QUERY_MAX_PARAMETERS];
+        unsigned int count = 0;
+        bool built = false;
+        /* Part of the query (starting with '&') not covered by parameters */
+        std::string_view remainder;
+
+    public:
+        /* Forget the previous query, next lookup rebuilds the index */
+        void reset() {
+            built = false;
+        }
+
+        bool isBuilt() {
+            return built;
+        }
+
+        /* Takes raw query including initial '?' sign */
+        void build(std::string_view rawQuery) {
+            count = 0;
+            remainder = {};
+            built = true;
+
+            std::string_view queryString = rawQuery;
+            while (queryString.length()) {
+                if (count == UWS_QUERY_MAX_PARAMETERS) {
+                    remainder = queryString;
+                    break;
+                }
+
+                std::string_view statement = queryString.substr(1, queryString.find('&', 1) - 1);
+                queryString.remove_prefix(statement.length() + 1);
+
+                /* Empty statements never match anything */
+                if (!statement.length()) {
+                    continue;
+                }
+
+                auto equality = statement.find('=');
+                if (equality != std::string_view::npos) {
+                    parameters[count++] = {statement.substr(0, equality), statement.substr(equality + 1), false};
+                } else {
+                    parameters[count++] = {statement, {nullptr, 0}, false};
+                }
+            }
+        }
+
+        /* Same semantics as getDecodedQueryValue, only without rescanning the query */
+        std::string_view get(std::string_view key) {
+            /* Can't have a value without a key */
+            if (!key.length()) {
+                return {};
+            }
+
+            for (unsigned int i = 0; i < count; i++) {
+                Parameter &p = parameters[i];
+
+                /* Only bother if first char of key match (early exit) */
+                if (!p.key.length() || p.key[0] != key[0]) {
+                    continue;
+                }
+
+                /* This querystring is invalid, cannot parse it */
+                if (!p.value.data()) {
+                    return {nullptr, 0};
+                }
+
+                if (key == p.key) {
+                    if (!p.decoded) {
+                        long decodedLength = decodeQueryComponentInPlace((char *) p.value.data(), (unsigned int) p.value.length());
+                        p.value = decodedLength < 0 ? std::string_view() : p.value.substr(0, (size_t) decodedLength);
+                        p.decoded = true;
+                    }
+                    return p.value;
+                }
+            }
+
+            if (remainder.length()) {
+                return getDecodedQueryValue(key, remainder);
+            }
+
+            /* Nothing found is given as nullptr, while empty string is given as some pointer to the given buffer */
+            return {nullptr, 0};
+        }
+
+        /* Number of indexed parameters, not counting any remainder */
+        unsigned int size() {
+            return count;
+        }
+
+        /* Raw (undecoded unless previously fetched by get) parameter at index */
+        Parameter &operator[](unsigned int i) {
+            return parameters[i];
+        }
+
+        /* What was left unindexed, including initial '&' sign */
+        std::string_view getRemainder() {
+            return remainder;
+        }
+    };
+
 }
 
 #endif
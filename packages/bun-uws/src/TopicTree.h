@@ -21,32 +21,56 @@
 #include <map>
 #include <list>
 #include <iostream>
-#include <unordered_set>
 #include <utility>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string_view>
 #include <functional>
-#include <set>
+#include <algorithm>
 #include <string>
 
 namespace uWS {
 
 struct Subscriber;
 
-struct Topic : std::unordered_set<Subscriber *> {
+struct Topic {
 
-    Topic(std::string_view topic) : name(topic) {
+    template <typename, typename> friend struct TopicTree;
+
+    Topic(std::string_view topic, size_t hash, uint32_t id) : name(topic), hash(hash), id(id) {
 
     }
 
     std::string name;
+
+    /* Number of subscribers */
+    size_t size() {
+        return subscribers.size();
+    }
+
+    /* Returns 1 if s subscribes to this topic, 0 otherwise */
+    inline size_t count(Subscriber *s);
+
+private:
+    /* Hash of name, cached for the open addressed topic index */
+    size_t hash;
+
+    /* Interned id, the slot of this topic in TopicTree */
+    uint32_t id;
+
+    /* Compact list of subscribers, each with the position of this topic in its list of topics */
+    struct Entry {
+        Subscriber *subscriber;
+        uint32_t topicIndex;
+    };
+    std::vector<Entry> subscribers;
 };
 
 struct Subscriber {
 
     template <typename, typename> friend struct TopicTree;
+    friend struct Topic;
 
 private:
     /* We use a factory */
@@ -62,10 +86,16 @@ private:
     /* This one matters the most, if it is 0 we are not in the list of drainableSubscribers */
     unsigned char numMessageIndices = 0;
 
+    /* Our position in the subscriber list of every topic in topics, so both sides swap-remove in O(1) */
+    std::vector<uint32_t> topicPositions;
+
+    /* Last publish we were handed, so overlapping wildcard topics deliver only once */
+    uint64_t lastPublishSerial = 0;
+
 public:
 
-    /* We have a list of topics we subscribe to (read by WebSocket::iterateTopics) */
-    std::set<Topic *> topics;
+    /* We have a list of topics we subscribe to (read by WebSocket::iterateTopics), in no particular order */
+    std::vector<Topic *> topics;
 
     /* User data */
     void *user;
@@ -75,6 +105,34 @@ public:
     }
 };
 
+inline size_t Topic::count(Subscriber *s) {
+    /* Scan whichever side is shorter */
+    if (s->topics.size() <= subscribers.size()) {
+        return std::find(s->topics.begin(), s->topics.end(), this) != s->topics.end();
+    }
+    for (Entry &e : subscribers) {
+        if (e.subscriber == s) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Segment trie of wildcard topics. Topics are split in segments by '/', where a whole segment of '+'
+ * matches any one segment and a last segment of '#' matches any number of segments (MQTT style) */
+struct WildcardTopicNode {
+    std::map<std::string, std::unique_ptr<WildcardTopicNode>, std::less<>> children;
+    /* Child for a '+' segment */
+    std::unique_ptr<WildcardTopicNode> anySegment;
+    /* Topic ending here, and topic ending here with a '#' segment */
+    Topic *topic = nullptr;
+    Topic *anyRemaining = nullptr;
+
+    bool empty() {
+        return children.empty() && !anySegment && !topic && !anyRemaining;
+    }
+};
+
 template <typename T, typename B>
 struct TopicTree {
 
@@ -92,8 +150,22 @@ private:
      * It must only cork, uncork, send, write */
     std::function<bool(Subscriber *, T &, IteratorFlags)> cb;
 
-    /* The topics */
-    std::unordered_map<std::string_view, std::unique_ptr<Topic>> topics;
+    /* Topics by interned id, ids of removed topics are reused */
+    std::vector<std::unique_ptr<Topic>> topicsById;
+    std::vector<uint32_t> freeTopicIds;
+
+    /* Open addressed (linear probing) index of topic id + 1 by name, 0 marks an empty slot.
+     * Kept at most half full */
+    std::vector<uint32_t> topicIndex;
+    size_t numTopics = 0;
+
+    /* Only topics with wildcards go in here */
+    WildcardTopicNode wildcardTopics;
+    size_t numWildcardTopics = 0;
+
+    /* Topics matching the one being published to */
+    std::vector<Topic *> matchedTopics;
+    uint64_t publishSerial = 0;
 
     /* List of subscribers that needs drainage */
     Subscriber *drainableSubscribers = nullptr;
@@ -129,6 +201,291 @@ private:
         }
     }
 
+    /* Returns the slot of topic, or of the empty slot where it would go */
+    size_t findSlot(std::string_view topic, size_t hash) {
+        size_t mask = topicIndex.size() - 1;
+        for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            uint32_t id = topicIndex[slot];
+            if (!id) {
+                return slot;
+            }
+            Topic *topicPtr = topicsById[id - 1].get();
+            if (topicPtr->hash == hash && topicPtr->name == topic) {
+                return slot;
+            }
+        }
+    }
+
+    void growTopicIndex() {
+        topicIndex.assign(topicIndex.size() ? topicIndex.size() * 2 : 16, 0);
+        size_t mask = topicIndex.size() - 1;
+        for (auto &topicPtr : topicsById) {
+            if (topicPtr) {
+                size_t slot = topicPtr->hash & mask;
+                while (topicIndex[slot]) {
+                    slot = (slot + 1) & mask;
+                }
+                topicIndex[slot] = topicPtr->id + 1;
+            }
+        }
+    }
+
+    Topic *createTopic(std::string_view topic, size_t hash) {
+        if ((numTopics + 1) * 2 > topicIndex.size()) {
+            growTopicIndex();
+        }
+
+        uint32_t id;
+        if (freeTopicIds.size()) {
+            id = freeTopicIds.back();
+            freeTopicIds.pop_back();
+        } else {
+            id = (uint32_t) topicsById.size();
+            topicsById.emplace_back();
+        }
+
+        Topic *topicPtr = new Topic(topic, hash, id);
+        topicsById[id].reset(topicPtr);
+        topicIndex[findSlot(topic, hash)] = id + 1;
+        numTopics++;
+
+        if (isWildcardTopic(topicPtr->name)) {
+            insertWildcardTopic(topicPtr);
+        }
+        return topicPtr;
+    }
+
+    /* Any '+' segment, or a '#' last segment, makes a wildcard topic. Anything else is matched as is */
+    static bool isWildcardTopic(std::string_view topic) {
+        bool wildcard = false;
+        for (size_t pos = 0; ; ) {
+            size_t end = topic.find('/', pos);
+            std::string_view segment = topic.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+            if (segment == "+") {
+                wildcard = true;
+            } else if (segment == "#") {
+                /* '#' anywhere else but last is not a wildcard, and neither is the topic */
+                return end == std::string_view::npos;
+            }
+            if (end == std::string_view::npos) {
+                return wildcard;
+            }
+            pos = end + 1;
+        }
+    }
+
+    void insertWildcardTopic(Topic *topicPtr) {
+        std::string_view topic = topicPtr->name;
+        WildcardTopicNode *node = &wildcardTopics;
+        for (size_t pos = 0; ; ) {
+            size_t end = topic.find('/', pos);
+            std::string_view segment = topic.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+            if (segment == "#") {
+                node->anyRemaining = topicPtr;
+                break;
+            }
+
+            std::unique_ptr<WildcardTopicNode> *child;
+            if (segment == "+") {
+                child = &node->anySegment;
+            } else {
+                auto it = node->children.find(segment);
+                if (it == node->children.end()) {
+                    it = node->children.emplace(std::string(segment), nullptr).first;
+                }
+                child = &it->second;
+            }
+            if (!*child) {
+                child->reset(new WildcardTopicNode);
+            }
+            node = child->get();
+
+            if (end == std::string_view::npos) {
+                node->topic = topicPtr;
+                break;
+            }
+            pos = end + 1;
+        }
+        numWildcardTopics++;
+    }
+
+    /* Removes topic below node, returns whether node is left empty */
+    bool removeWildcardTopic(WildcardTopicNode *node, std::string_view topic, size_t pos) {
+        size_t end = topic.find('/', pos);
+        std::string_view segment = topic.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        if (segment == "#") {
+            node->anyRemaining = nullptr;
+            return node->empty();
+        }
+
+        std::map<std::string, std::unique_ptr<WildcardTopicNode>, std::less<>>::iterator it;
+        WildcardTopicNode *child;
+        if (segment == "+") {
+            child = node->anySegment.get();
+        } else {
+            it = node->children.find(segment);
+            child = it->second.get();
+        }
+
+        bool childEmpty;
+        if (end == std::string_view::npos) {
+            child->topic = nullptr;
+            childEmpty = child->empty();
+        } else {
+            childEmpty = removeWildcardTopic(child, topic, end + 1);
+        }
+
+        /* Prune on the way back up */
+        if (childEmpty) {
+            if (segment == "+") {
+                node->anySegment.reset();
+            } else {
+                node->children.erase(it);
+            }
+        }
+        return node->empty();
+    }
+
+    /* Collects wildcard topics matching topic from its segment at pos (npos when all are consumed) */
+    void matchWildcardTopics(WildcardTopicNode *node, std::string_view topic, size_t pos) {
+        if (node->anyRemaining) {
+            matchedTopics.push_back(node->anyRemaining);
+        }
+        if (pos == std::string_view::npos) {
+            if (node->topic) {
+                matchedTopics.push_back(node->topic);
+            }
+            return;
+        }
+
+        size_t end = topic.find('/', pos);
+        std::string_view segment = topic.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        size_t next = end == std::string_view::npos ? std::string_view::npos : end + 1;
+
+        if (node->anySegment) {
+            matchWildcardTopics(node->anySegment.get(), topic, next);
+        }
+        auto it = node->children.find(segment);
+        if (it != node->children.end()) {
+            matchWildcardTopics(it->second.get(), topic, next);
+        }
+    }
+
+    /* Calls cb for every subscriber of topic, and of any wildcard topic matching it, except sender.
+     * Subscribers of several matching topics are called once. Returns false if no topic matched */
+    template <typename F>
+    bool forEachRecipient(Subscriber *sender, std::string_view topic, F cb) {
+        Topic *topicPtr = lookupTopic(topic);
+
+        if (!numWildcardTopics) {
+            if (!topicPtr) {
+                return false;
+            }
+            for (Topic::Entry &e : topicPtr->subscribers) {
+                /* If we are sender then ignore us */
+                if (sender != e.subscriber) {
+                    cb(e.subscriber);
+                }
+            }
+            return true;
+        }
+
+        matchedTopics.clear();
+        if (topicPtr) {
+            matchedTopics.push_back(topicPtr);
+        }
+        matchWildcardTopics(&wildcardTopics, topic, 0);
+        if (matchedTopics.empty()) {
+            return false;
+        }
+
+        uint64_t serial = ++publishSerial;
+        for (Topic *matchedTopic : matchedTopics) {
+            for (Topic::Entry &e : matchedTopic->subscribers) {
+                Subscriber *s = e.subscriber;
+                if (sender != s && s->lastPublishSerial != serial) {
+                    s->lastPublishSerial = serial;
+                    cb(s);
+                }
+            }
+        }
+        return true;
+    }
+
+    /* Deletes the topic (which must have no subscribers) */
+    void removeTopic(Topic *topicPtr) {
+        if (isWildcardTopic(topicPtr->name)) {
+            removeWildcardTopic(&wildcardTopics, topicPtr->name, 0);
+            numWildcardTopics--;
+        }
+
+        size_t mask = topicIndex.size() - 1;
+        size_t slot = topicPtr->hash & mask;
+        while (topicIndex[slot] != topicPtr->id + 1) {
+            slot = (slot + 1) & mask;
+        }
+
+        /* Backward shift deletion; move back every following entry not already at or after its home slot */
+        for (size_t next = (slot + 1) & mask; topicIndex[next]; next = (next + 1) & mask) {
+            size_t home = topicsById[topicIndex[next] - 1]->hash & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                topicIndex[slot] = topicIndex[next];
+                slot = next;
+            }
+        }
+        topicIndex[slot] = 0;
+
+        freeTopicIds.push_back(topicPtr->id);
+        numTopics--;
+        /* Unique_ptr deletes the topic */
+        topicsById[topicPtr->id].reset();
+    }
+
+    /* Finds index of topicPtr in s->topics and of s in topicPtr->subscribers, scanning the shorter list */
+    bool findSubscription(Subscriber *s, Topic *topicPtr, uint32_t &topicIndex, uint32_t &position) {
+        if (s->topics.size() <= topicPtr->subscribers.size()) {
+            for (uint32_t i = 0; i < s->topics.size(); i++) {
+                if (s->topics[i] == topicPtr) {
+                    topicIndex = i;
+                    position = s->topicPositions[i];
+                    return true;
+                }
+            }
+        } else {
+            for (uint32_t i = 0; i < topicPtr->subscribers.size(); i++) {
+                if (topicPtr->subscribers[i].subscriber == s) {
+                    topicIndex = topicPtr->subscribers[i].topicIndex;
+                    position = i;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /* Swap-removes s from the topic at topicIndex in s->topics, and that topic from s */
+    void removeSubscription(Subscriber *s, uint32_t topicIndex, uint32_t position) {
+        Topic *topicPtr = s->topics[topicIndex];
+
+        /* The last subscriber of the topic takes our place */
+        Topic::Entry moved = topicPtr->subscribers.back();
+        topicPtr->subscribers[position] = moved;
+        topicPtr->subscribers.pop_back();
+        if (position < topicPtr->subscribers.size()) {
+            moved.subscriber->topicPositions[moved.topicIndex] = position;
+        }
+
+        /* Our last topic takes the place of this one */
+        uint32_t last = (uint32_t) s->topics.size() - 1;
+        if (topicIndex != last) {
+            s->topics[topicIndex] = s->topics[last];
+            s->topicPositions[topicIndex] = s->topicPositions[last];
+            s->topics[topicIndex]->subscribers[s->topicPositions[topicIndex]].topicIndex = topicIndex;
+        }
+        s->topics.pop_back();
+        s->topicPositions.pop_back();
+    }
+
     void unlinkDrainableSubscriber(Subscriber *s) {
         if (s->prev) {
             s->prev->next = s->next;
@@ -150,11 +507,11 @@ public:
 
     /* Returns nullptr if not found */
     Topic *lookupTopic(std::string_view topic) {
-        auto it = topics.find(topic);
-        if (it == topics.end()) {
+        if (!numTopics) {
             return nullptr;
         }
-        return it->second.get();
+        uint32_t id = topicIndex[findSlot(topic, std::hash<std::string_view>()(topic))];
+        return id ? topicsById[id - 1].get() : nullptr;
     }
 
     /* Subscribe fails if we already are subscribed */
@@ -165,17 +522,18 @@ public:
         /* Lookup or create new topic */
         Topic *topicPtr = lookupTopic(topic);
         if (!topicPtr) {
-            Topic *newTopic = new Topic(topic);
-            topics.insert({std::string_view(newTopic->name.data(), newTopic->name.length()), std::unique_ptr<Topic>(newTopic)});
-            topicPtr = newTopic;
+            topicPtr = createTopic(topic, std::hash<std::string_view>()(topic));
+        } else {
+            uint32_t topicIndex, position;
+            if (findSubscription(s, topicPtr, topicIndex, position)) {
+                return nullptr;
+            }
         }
 
         /* Insert us in topic, insert topic in us */
-        auto [it, inserted] = s->topics.insert(topicPtr);
-        if (!inserted) {
-            return nullptr;
-        }
-        topicPtr->insert(s);
+        s->topics.push_back(topicPtr);
+        s->topicPositions.push_back((uint32_t) topicPtr->subscribers.size());
+        topicPtr->subscribers.push_back({s, (uint32_t) s->topics.size() - 1});
 
         /* Success */
         return topicPtr;
@@ -193,20 +551,19 @@ public:
             return {false, false, -1};
         }
 
-        /* Erase from our list first */
-        if (s->topics.erase(topicPtr) == 0) {
+        uint32_t topicIndex, position;
+        if (!findSubscription(s, topicPtr, topicIndex, position)) {
             return {false, false, -1};
         }
 
-        /* Remove us from topic */
-        topicPtr->erase(s);
+        /* Remove us from topic and topic from us */
+        removeSubscription(s, topicIndex, position);
 
-        int newCount = topicPtr->size();
+        int newCount = (int) topicPtr->size();
 
         /* If there is no subscriber to this topic, remove it */
         if (!topicPtr->size()) {
-            /* Unique_ptr deletes the topic */
-            topics.erase(topic);
+            removeTopic(topicPtr);
         }
 
         /* If we don't hold any topics we are to be freed altogether */
@@ -226,14 +583,15 @@ public:
             return;
         }
 
-        /* For all topics, unsubscribe */
-        for (Topic *topicPtr : s->topics) {
-            /* If we are the last subscriber, simply remove the whole topic */
-            if (topicPtr->size() == 1) {
-                topics.erase(topicPtr->name);
-            } else {
-                /* Otherwise just remove us */
-                topicPtr->erase(s);
+        /* For all topics, unsubscribe (the last one first, which avoids any moving on our side) */
+        while (s->topics.size()) {
+            uint32_t topicIndex = (uint32_t) s->topics.size() - 1;
+            Topic *topicPtr = s->topics[topicIndex];
+            removeSubscription(s, topicIndex, s->topicPositions[topicIndex]);
+
+            /* If we were the last subscriber, remove the whole topic */
+            if (!topicPtr->size()) {
+                removeTopic(topicPtr);
             }
         }
 
@@ -283,31 +641,13 @@ public:
     template <typename F>
     bool publishBig(Subscriber *sender, std::string_view topic, B &&bigMessage, F cb) {
         /* Do we even have this topic? */
-        auto it = topics.find(topic);
-        if (it == topics.end()) {
-            return false;
-        }
-
-        /* For all subscribers in topic */
-        for (Subscriber *s : *it->second) {
-
-            /* If we are sender then ignore us */
-            if (sender != s) {
-                cb(s, bigMessage);
-            }
-        }
-
-        return true;
+        return forEachRecipient(sender, topic, [&](Subscriber *s) {
+            cb(s, bigMessage);
+        });
     }
 
     /* Linear in number of affected subscribers */
     bool publish(Subscriber *sender, std::string_view topic, T &&message) {
-        /* Do we even have this topic? */
-        auto it = topics.find(topic);
-        if (it == topics.end()) {
-            return false;
-        }
-
         /* If we have more than 65k messages we need to drain every socket. */
         if (outgoingMessages.size() == UINT16_MAX) {
             /* If there is a socket that is currently corked, this will be ugly as all sockets will drain
@@ -318,35 +658,30 @@ public:
         /* If nobody references this message, don't buffer it */
         bool referencedMessage = false;
 
-        /* For all subscribers in topic */
-        for (Subscriber *s : *it->second) {
-
-            /* If we are sender then ignore us */
-            if (sender != s) {
+        /* For all subscribers in topic (or matching wildcard topics) */
+        forEachRecipient(sender, topic, [&](Subscriber *s) {
+            /* At least one subscriber wants this message */
+            referencedMessage = true;
 
-                /* At least one subscriber wants this message */
-                referencedMessage = true;
-
-                /* If we already have too many outgoing messages on this subscriber, drain it now */
-                if (s->numMessageIndices == 32) {
-                    /* This one does not need to check needsDrainage here but still does. */
-                    drain(s);
-                }
+            /* If we already have too many outgoing messages on this subscriber, drain it now */
+            if (s->numMessageIndices == 32) {
+                /* This one does not need to check needsDrainage here but still does. */
+                drain(s);
+            }
 
-                /* Finally we can continue */
-                s->messageIndices[s->numMessageIndices++] = (uint16_t)outgoingMessages.size();
-                /* First message adds subscriber to list of drainable subscribers */
-                if (s->numMessageIndices == 1) {
-                    /* Insert us in the head of drainable subscribers */
-                    s->next = drainableSubscribers;
-                    s->prev = nullptr;
-                    if (s->next) {
-                        s->next->prev = s;
-                    }
-                    drainableSubscribers = s;
+            /* Finally we can continue */
+            s->messageIndices[s->numMessageIndices++] = (uint16_t)outgoingMessages.size();
+            /* First message adds subscriber to list of drainable subscribers */
+            if (s->numMessageIndices == 1) {
+                /* Insert us in the head of drainable subscribers */
+                s->next = drainableSubscribers;
+                s->prev = nullptr;
+                if (s->next) {
+                    s->next->prev = s;
                 }
+                drainableSubscribers = s;
             }
-        }
+        });
 
         /* Push this message and return with success */
         if (referencedMessage) {
@@ -35,7 +35,7 @@ private:
     typedef AsyncSocket<SSL> Super;
 
     void *init(bool perMessageDeflate, CompressOptions compressOptions, BackPressure &&backpressure) {
-        new (us_socket_ext(SSL, (us_socket_t *) this)) WebSocketData(perMessageDeflate, compressOptions, std::move(backpressure));
+        new (us_socket_ext(SSL, (us_socket_t *) this)) WebSocketData(perMessageDeflate, compressOptions, std::move(backpressure), Super::getLoopData());
         return this;
     }
 public:
@@ -95,11 +95,7 @@ public:
         );
 
         /* Skip sending and report success if we are over the limit of maxBackpressure */
-        if (webSocketContextData->maxBackpressure && webSocketContextData->maxBackpressure < getBufferedAmount()) {
-            /* Also defer a close if we should */
-            if (webSocketContextData->closeOnBackpressureLimit) {
-                us_socket_shutdown_read(SSL, (us_socket_t *) this);
-            }
+        if (isOverBackpressureLimit(webSocketContextData)) {
             return DROPPED;
         }
 
@@ -126,54 +122,124 @@ public:
                 Super::uncorkWithoutSending();
                 return BACKPRESSURE;
             }
-        } else {
 
-            if (webSocketData->subscriber) {
-                /* This will call back into us, send. */
-                webSocketContextData->topicTree->drain(webSocketData->subscriber);
-            }
+            return sent(webSocketContextData);
+        }
 
-            /* Transform the message to compressed domain if requested */
-            if (compress) {
-                WebSocketData *webSocketData = (WebSocketData *) Super::getAsyncSocketData();
-
-                /* Check and correct the compress hint. It is never valid to compress 0 bytes */
-                if (message.length() && opCode < 3 && webSocketData->compressionStatus == WebSocketData::ENABLED) {
-                    LoopData *loopData = Super::getLoopData();
-                    /* Compress using either shared or dedicated deflationStream */
-                    if (webSocketData->deflationStream) {
-                        message = webSocketData->deflationStream->deflate(loopData->zlibContext, message, false);
-                    } else {
-                        message = loopData->deflationStream->deflate(loopData->zlibContext, message, true);
-                    }
+        if (webSocketData->subscriber) {
+            /* This will call back into us, send. */
+            webSocketContextData->topicTree->drain(webSocketData->subscriber);
+        }
+
+        /* Transform the message to compressed domain if requested */
+        if (compress) {
+            /* Check and correct the compress hint. It is never valid to compress 0 bytes */
+            if (message.length() && opCode < 3 && webSocketData->compressionStatus == WebSocketData::ENABLED) {
+                LoopData *loopData = Super::getLoopData();
+                /* Compress using either shared or dedicated deflationStream */
+                if (webSocketData->hasDedicatedCompressor()) {
+                    message = webSocketData->getDeflationStream()->deflate(loopData->zlibContext, message, false);
                 } else {
-                    compress = false;
+                    message = loopData->deflationStream->deflate(loopData->zlibContext, message, true);
                 }
+            } else {
+                compress = false;
             }
+        }
 
-            /* Get size, allocate size, write if needed */
-            size_t messageFrameSize = protocol::messageFrameSize(message.length());
-            auto [sendBuffer, sendBufferAttribute] = Super::getSendBuffer(messageFrameSize);
-            protocol::formatMessage<isServer>(sendBuffer, message.data(), message.length(), opCode, message.length(), compress, fin);
-
-            /* Depending on size of message we have different paths */
-            if (sendBufferAttribute == SendBufferAttribute::NEEDS_DRAIN) {
-                /* This is a drain */
-                auto[written, failed] = Super::write(nullptr, 0);
-                if (failed) {
-                    /* Return false for failure, skipping to reset the timeout below */
-                    return BACKPRESSURE;
-                }
-            } else if (sendBufferAttribute == SendBufferAttribute::NEEDS_UNCORK) {
-                /* Uncork if we came here uncorked */
-                auto [written, failed] = Super::uncork();
-                if (failed) {
-                    return BACKPRESSURE;
-                }
+        /* Get size, allocate size, write if needed */
+        size_t messageFrameSize = protocol::messageFrameSize(message.length());
+        auto [sendBuffer, sendBufferAttribute] = Super::getSendBuffer(messageFrameSize);
+        protocol::formatMessage<isServer>(sendBuffer, message.data(), message.length(), opCode, message.length(), compress, fin);
+
+        return commitSendBuffer(sendBufferAttribute, webSocketContextData);
+    }
+
+    /* Send a message published to many sockets. The frame (compressed by the shared compressor if requested)
+     * is formatted once, on first use, and kept in the message for all other subscribers. Sockets with a
+     * dedicated compressor still need their own compression */
+    template <typename PublishedMessage>
+    SendStatus sendPublished(PublishedMessage &message) {
+        WebSocketData *webSocketData = (WebSocketData *) Super::getAsyncSocketData();
+        std::string_view data = message.message;
+        OpCode opCode = (OpCode) message.opCode;
+
+        /* Same corrections of the compress hint as in send */
+        bool compress = message.compress && data.length() && opCode < 3 && webSocketData->compressionStatus == WebSocketData::ENABLED;
+        if (compress && webSocketData->hasDedicatedCompressor()) {
+            return send(data, opCode, true);
+        }
+
+        std::string &frame = compress ? message.compressedFrame : message.frame;
+        if (!frame.length()) {
+            if (compress) {
+                LoopData *loopData = Super::getLoopData();
+                data = loopData->deflationStream->deflate(loopData->zlibContext, data, true);
+            }
+            frame.resize(protocol::messageFrameSize(data.length()));
+            frame.resize(protocol::formatMessage<isServer>(frame.data(), data.data(), data.length(), opCode, data.length(), compress, true));
+        }
+
+        return sendFrame(frame);
+    }
+
+    /* Send or buffer an already formatted frame as is */
+    SendStatus sendFrame(std::string_view frame) {
+        WebSocketContextData<SSL, USERDATA> *webSocketContextData = (WebSocketContextData<SSL, USERDATA> *) us_socket_context_ext(SSL,
+            (us_socket_context_t *) us_socket_context(SSL, (us_socket_t *) this)
+        );
+
+        /* Skip sending and report success if we are over the limit of maxBackpressure */
+        if (isOverBackpressureLimit(webSocketContextData)) {
+            return DROPPED;
+        }
+
+        /* If we are subscribers and have messages to drain we need to drain them here to stay synced */
+        WebSocketData *webSocketData = (WebSocketData *) Super::getAsyncSocketData();
+        if (webSocketData->subscriber) {
+            webSocketContextData->topicTree->drain(webSocketData->subscriber);
+        }
+
+        auto [sendBuffer, sendBufferAttribute] = Super::getSendBuffer(frame.length());
+        memcpy(sendBuffer, frame.data(), frame.length());
+
+        return commitSendBuffer(sendBufferAttribute, webSocketContextData);
+    }
+
+private:
+    /* Also defers a close if we should */
+    bool isOverBackpressureLimit(WebSocketContextData<SSL, USERDATA> *webSocketContextData) {
+        if (webSocketContextData->maxBackpressure && webSocketContextData->maxBackpressure < getBufferedAmount()) {
+            if (webSocketContextData->closeOnBackpressureLimit) {
+                us_socket_shutdown_read(SSL, (us_socket_t *) this);
             }
+            return true;
+        }
+        return false;
+    }
 
+    /* Writes what getSendBuffer returned if needed */
+    SendStatus commitSendBuffer(SendBufferAttribute sendBufferAttribute, WebSocketContextData<SSL, USERDATA> *webSocketContextData) {
+        /* Depending on size of message we have different paths */
+        if (sendBufferAttribute == SendBufferAttribute::NEEDS_DRAIN) {
+            /* This is a drain */
+            auto[written, failed] = Super::write(nullptr, 0);
+            if (failed) {
+                /* Return false for failure, skipping to reset the timeout below */
+                return BACKPRESSURE;
+            }
+        } else if (sendBufferAttribute == SendBufferAttribute::NEEDS_UNCORK) {
+            /* Uncork if we came here uncorked */
+            auto [written, failed] = Super::uncork();
+            if (failed) {
+                return BACKPRESSURE;
+            }
         }
 
+        return sent(webSocketContextData);
+    }
+
+    SendStatus sent(WebSocketContextData<SSL, USERDATA> *webSocketContextData) {
         /* Every successful send resets the timeout */
         if (webSocketContextData->resetIdleTimeoutOnSend) {
             Super::timeout(webSocketContextData->idleTimeoutComponents.first);
@@ -185,6 +251,7 @@ public:
         return SUCCESS;
     }
 
+public:
     /* Send websocket close frame, emit close event, send FIN if successful.
      * Will not append a close reason if code is 0 or 1005. */
     void end(int code = 0, std::string_view message = {}) {
@@ -237,6 +304,17 @@ public:
         }
     }
 
+    /* Hands over ownership of the buffer holding the message being emitted, if it was assembled from
+     * fragments (and not inflated). May only be called from within the message handler, with the message
+     * it was given. Returns nullptr if there is nothing to take, the message must then be copied */
+    std::string *takeMessageBuffer(std::string_view message) {
+        WebSocketData *webSocketData = (WebSocketData *) Super::getAsyncSocketData();
+        if (!message.length() || message.data() != webSocketData->fragmentBuffer.data() || message.length() != webSocketData->fragmentBuffer.length()) {
+            return nullptr;
+        }
+        return new std::string(std::move(webSocketData->fragmentBuffer));
+    }
+
     /* Corks the response if possible. Leaves already corked socket be. */
     void cork(MoveOnlyFunction<void()> &&handler) {
         if (!Super::isCorked() && Super::canCork()) {
@@ -366,7 +444,7 @@ public:
             return webSocketContextData->topicTree->publishBig(webSocketData->subscriber, topic, {message, opCode, compress}, [](Subscriber *s, TopicTreeBigMessage &message) {
                 auto *ws = (WebSocket<SSL, true, int> *) s->user;
 
-                ws->send(message.message, (OpCode)message.opCode, message.compress);
+                ws->sendPublished(message);
             });
         } else {
             return webSocketContextData->topicTree->publish(webSocketData->subscriber, topic, {std::string(message), opCode, compress});
@@ -52,7 +52,23 @@ private:
         }
     }
 
+    /* Emits any batched messages, returns true if we are closed or shut down when returning */
+    static bool flushMessageBatch(void *s) {
+        WebSocketContextData<SSL, USERDATA> *webSocketContextData = (WebSocketContextData<SSL, USERDATA> *) us_socket_context_ext(SSL, us_socket_context(SSL, (us_socket_t *) s));
+        WebSocketData *webSocketData = (WebSocketData *) us_socket_ext(SSL, (us_socket_t *) s);
+
+        if (!webSocketContextData->messageBatch.size()) {
+            return false;
+        }
+
+        webSocketContextData->messagesHandler((WebSocket<SSL, isServer, USERDATA> *) s, webSocketContextData->messageBatch);
+        webSocketContextData->messageBatch.clear();
+        return us_socket_is_closed(SSL, (us_socket_t *) s) || webSocketData->isShuttingDown;
+    }
+
     static void forceClose(WebSocketState<isServer> */*wState*/, void *s, std::string_view reason = {}) {
+        /* Messages before the offending frame were valid, deliver them before the close */
+        flushMessageBatch(s);
         us_socket_close(SSL, (us_socket_t *) s, (int) reason.length(), (void *) reason.data());
     }
 
@@ -96,7 +112,9 @@ private:
                 }
 
                 /* Emit message event & break if we are closed or shut down when returning */
-                if (webSocketContextData->messageHandler) {
+                if (webSocketContextData->messagesHandler) {
+                    webSocketContextData->messageBatch.append(std::string_view(data, length), (OpCode) opCode);
+                } else if (webSocketContextData->messageHandler) {
                     webSocketContextData->messageHandler((WebSocket<SSL, isServer, USERDATA> *) s, std::string_view(data, length), (OpCode) opCode);
                     if (us_socket_is_closed(SSL, (us_socket_t *) s) || webSocketData->isShuttingDown) {
                         return true;
@@ -161,7 +179,9 @@ private:
                     }
 
                     /* Emit message and check for shutdown or close */
-                    if (webSocketContextData->messageHandler) {
+                    if (webSocketContextData->messagesHandler) {
+                        webSocketContextData->messageBatch.append(std::string_view(data, length), (OpCode) opCode);
+                    } else if (webSocketContextData->messageHandler) {
                         webSocketContextData->messageHandler((WebSocket<SSL, isServer, USERDATA> *) s, std::string_view(data, length), (OpCode) opCode);
                         if (us_socket_is_closed(SSL, (us_socket_t *) s) || webSocketData->isShuttingDown) {
                             return true;
@@ -173,6 +193,11 @@ private:
                 }
             }
         } else {
+            /* Batched messages come before any control frame handler */
+            if (flushMessageBatch(s)) {
+                return true;
+            }
+
             /* Control frames need the websocket to send pings, pongs and close */
             WebSocket<SSL, isServer, USERDATA> *webSocket = (WebSocket<SSL, isServer, USERDATA> *) s;
 
@@ -305,6 +330,9 @@ private:
             /* This parser has virtually no overhead */
             WebSocketProtocol<isServer, WebSocketContext<SSL, isServer, USERDATA>>::consume(data, (unsigned int) length, (WebSocketState<isServer> *) webSocketData, s);
 
+            /* Deliver everything this read completed in one go */
+            flushMessageBatch(s);
+
             /* Uncorking a closed socekt is fine, in fact it is needed */
             asyncSocket->uncork();
 
@@ -32,15 +32,58 @@
 namespace uWS {
 
 /* Type queued up when publishing */
+/* Published messages keep their formatted frames, uncompressed and compressed by the shared compressor,
+ * built once by the first subscriber that needs them (see WebSocket::sendPublished) */
 struct TopicTreeMessage {
     std::string message;
     /*OpCode*/ int opCode;
     bool compress;
+    std::string frame = {}, compressedFrame = {};
 };
 struct TopicTreeBigMessage {
     std::string_view message;
     /*OpCode*/ int opCode;
     bool compress;
+    std::string frame = {}, compressedFrame = {};
+};
+
+/* Messages parsed from one read, copied back to back into one buffer for the batched
+ * messages handler. Entries are laid out like the C API's uws_websocket_batch_entry_t */
+struct WebSocketMessageBatch {
+    struct Entry {
+        size_t offset;
+        size_t length;
+        int32_t opCode;
+    };
+
+    std::string data;
+    std::vector<Entry> entries;
+
+    void append(std::string_view message, OpCode opCode) {
+        entries.push_back({data.length(), message.length(), (int32_t) opCode});
+        data.append(message.data(), message.length());
+    }
+
+    std::string_view message(size_t index) {
+        return std::string_view(data.data() + entries[index].offset, entries[index].length);
+    }
+
+    OpCode opCode(size_t index) {
+        return (OpCode) entries[index].opCode;
+    }
+
+    size_t size() {
+        return entries.size();
+    }
+
+    /* Keeps the capacity for the next read, unless some big message blew it up */
+    void clear() {
+        if (data.capacity() > 256 * 1024) {
+            data = std::string();
+        }
+        data.clear();
+        entries.clear();
+    }
 };
 
 template <bool, bool, typename> struct WebSocket;
@@ -64,6 +107,11 @@ public:
     MoveOnlyFunction<void(WebSocket<SSL, true, USERDATA> *, int, std::string_view)> closeHandler = nullptr;
     MoveOnlyFunction<void(WebSocket<SSL, true, USERDATA> *, std::string_view)> pingHandler = nullptr;
     MoveOnlyFunction<void(WebSocket<SSL, true, USERDATA> *, std::string_view)> pongHandler = nullptr;
+    /* Takes over from messageHandler if set, called once per read with every message it completed */
+    MoveOnlyFunction<void(WebSocket<SSL, true, USERDATA> *, WebSocketMessageBatch &)> messagesHandler = nullptr;
+
+    /* Reused by all sockets of this context, only ever filled during one read */
+    WebSocketMessageBatch messageBatch;
 
     /* Settings for this context */
     size_t maxPayloadLength = 0;
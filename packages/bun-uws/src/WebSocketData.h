@@ -22,6 +22,7 @@
 #include "AsyncSocketData.h"
 #include "PerMessageDeflate.h"
 #include "TopicTree.h"
+#include "LoopData.h"
 
 #include <string>
 
@@ -46,19 +47,28 @@ private:
 
     /* We might have a dedicated compressor */
     DeflationStream *deflationStream = nullptr;
+    /* Or borrow one from the loop's pool, whenever we send */
+    DeflationStreamPool *deflationStreamPool = nullptr;
+    DeflationStreamPool::Lease deflationStreamLease;
+    CompressOptions pooledCompressOptions = CompressOptions::DISABLED;
     /* And / or a dedicated decompressor */
     InflationStream *inflationStream = nullptr;
 
     /* We could be a subscriber */
     Subscriber *subscriber = nullptr;
 public:
-    WebSocketData(bool perMessageDeflate, CompressOptions compressOptions, BackPressure &&backpressure) : AsyncSocketData<false>(std::move(backpressure)), WebSocketState<true>() {
+    WebSocketData(bool perMessageDeflate, CompressOptions compressOptions, BackPressure &&backpressure, LoopData *loopData) : AsyncSocketData<false>(std::move(backpressure)), WebSocketState<true>() {
         compressionStatus = perMessageDeflate ? ENABLED : DISABLED;
 
         /* Initialize the dedicated sliding window(s) */
         if (perMessageDeflate) {
             if ((compressOptions & CompressOptions::_COMPRESSOR_MASK) != CompressOptions::SHARED_COMPRESSOR) {
-                deflationStream = new DeflationStream(compressOptions);
+                if ((compressOptions & CompressOptions::POOLED_COMPRESSOR) && loopData->deflationStreamPool) {
+                    deflationStreamPool = loopData->deflationStreamPool;
+                    pooledCompressOptions = compressOptions;
+                } else {
+                    deflationStream = new DeflationStream(compressOptions);
+                }
             }
             if ((compressOptions & CompressOptions::_DECOMPRESSOR_MASK) != CompressOptions::SHARED_DECOMPRESSOR) {
                 inflationStream = new InflationStream(compressOptions);
@@ -66,11 +76,27 @@ public:
         }
     }
 
+    /* Our dedicated compressor, if any, borrowed from the pool if need be */
+    DeflationStream *getDeflationStream() {
+        if (deflationStreamPool) {
+            return deflationStreamPool->get(deflationStreamLease, pooledCompressOptions);
+        }
+        return deflationStream;
+    }
+
+    bool hasDedicatedCompressor() {
+        return deflationStream || deflationStreamPool;
+    }
+
     ~WebSocketData() {
         if (deflationStream) {
             delete deflationStream;
         }
 
+        if (deflationStreamPool) {
+            deflationStreamPool->release(deflationStreamLease);
+        }
+
         if (inflationStream) {
             delete inflationStream;
         }
@@ -251,6 +251,59 @@ static inline std::tuple<bool, int, int, std::string_view> negotiateCompression(
     return {compression, compressionWindow, inflationWindow, response};
 }
 
+/* What we (the client) offer. Without context takeover both peers are asked to reset their sliding window per message */
+static inline std::string_view clientCompressionOffer(bool contextTakeover) {
+    if (contextTakeover) {
+        return "permessage-deflate; client_max_window_bits";
+    }
+    return "permessage-deflate; client_no_context_takeover; server_no_context_takeover; client_max_window_bits";
+}
+
+/* Takes the response of the server to our offer, returns whether it is valid, whether we got compression
+ * and the windowBits of our compressor and decompressor (0 for no context takeover). An invalid response
+ * must fail the connection */
+static inline std::tuple<bool, bool, int, int> negotiateClientCompression(bool contextTakeover, std::string_view response) {
+    ExtensionsParser ep(response.data(), response.length());
+
+    /* Declining is fine, anything but what we offered is not */
+    if (!ep.perMessageDeflate) {
+        return {!ep.xWebKitDeflateFrame, false, 0, 0};
+    }
+
+    /* Values without a number are not allowed in a response */
+    if (ep.serverMaxWindowBits == 1 || ep.clientMaxWindowBits == 1) {
+        return {false, false, 0, 0};
+    }
+
+    int compressionWindow = 15;
+    if (!contextTakeover || ep.clientNoContextTakeover) {
+        compressionWindow = 0;
+    } else if (ep.clientMaxWindowBits) {
+        compressionWindow = ep.clientMaxWindowBits;
+#ifndef UWS_ALLOW_8_WINDOW_BITS
+        /* Zlib cannot do windowBits=8, memLevel=1 so we raise it up to 9 minimum (same as the server does) */
+        if (compressionWindow == 8) {
+            compressionWindow = 9;
+        }
+#endif
+    }
+
+    /* Their compression window is our inflation window */
+    int inflationWindow = 15;
+    if (ep.serverNoContextTakeover) {
+        inflationWindow = 0;
+    } else if (ep.serverMaxWindowBits) {
+        inflationWindow = ep.serverMaxWindowBits;
+    }
+
+    /* Same sanity check as for the server */
+    if ((compressionWindow && compressionWindow < 8) || compressionWindow > 15 || (inflationWindow && inflationWindow < 8) || inflationWindow > 15) {
+        return {false, false, 0, 0};
+    }
+
+    return {true, true, compressionWindow, inflationWindow};
+}
+
 }
 
 #endif // UWS_WEBSOCKETEXTENSIONS_H
@@ -28,6 +28,15 @@
 // bun-specific
 #include "simdutf.h"
 
+/* Vector widths follow the target we are compiled for (baseline and haswell builds differ) */
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace uWS {
 
 /* We should not overcomplicate these */
@@ -93,6 +102,48 @@ T bit_cast(char *c) {
     return val;
 }
 
+/* XORs length bytes of src with the repeating 4 byte mask into dst. Works in place, and with dst trailing
+ * src (dst < src) since every vector is loaded before anything behind it is stored */
+static inline void xorMask(char *dst, const char *src, size_t length, const char *mask) {
+    uint32_t mask32;
+    memcpy(&mask32, mask, 4);
+
+    /* Every vector width is a multiple of 4 so the mask stays in phase from one loop to the next */
+    size_t i = 0;
+#if defined(__AVX512BW__)
+    __m512i mask512 = _mm512_set1_epi32((int) mask32);
+    for (; i + 64 <= length; i += 64) {
+        _mm512_storeu_si512((void *) (dst + i), _mm512_xor_si512(_mm512_loadu_si512((const void *) (src + i)), mask512));
+    }
+#endif
+#if defined(__AVX2__)
+    __m256i mask256 = _mm256_set1_epi32((int) mask32);
+    for (; i + 32 <= length; i += 32) {
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (src + i)), mask256));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128i mask128 = _mm_set1_epi32((int) mask32);
+    for (; i + 16 <= length; i += 16) {
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + i)), mask128));
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t mask128 = vreinterpretq_u8_u32(vdupq_n_u32(mask32));
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8((uint8_t *) (dst + i), veorq_u8(vld1q_u8((const uint8_t *) (src + i)), mask128));
+    }
+#endif
+    for (; i + 4 <= length; i += 4) {
+        uint32_t word;
+        memcpy(&word, src + i, 4);
+        word ^= mask32;
+        memcpy(dst + i, &word, 4);
+    }
+    for (; i < length; i++) {
+        dst[i] = src[i] ^ mask[i % 4];
+    }
+}
+
 /* Byte swap for little-endian systems */
 template <typename T>
 T cond_byte_swap(T value) {
@@ -200,20 +251,12 @@ static inline size_t formatMessage(char *dst, const char *src, size_t length, Op
     }
 
     messageLength = headerLength + length;
-    memcpy(dst + headerLength, src, length);
 
     if (!isServer) {
-
-        // overwrites up to 3 bytes outside of the given buffer!
-        //WebSocketProtocol<isServer>::unmaskInplace(dst + headerLength, dst + headerLength + length, mask);
-
-        // this is not optimal
-        char *start = dst + headerLength;
-        char *stop = start + length;
-        int i = 0;
-        while (start != stop) {
-            (*start++) ^= mask[i++ % 4];
-        }
+        /* Mask while copying */
+        xorMask(dst + headerLength, src, length, mask);
+    } else {
+        memcpy(dst + headerLength, src, length);
     }
     return messageLength;
 }
@@ -235,21 +278,9 @@ protected:
     static inline bool rsv23(char *frame) {return *((unsigned char *) frame) & 48;}
     static inline bool rsv1(char *frame) {return *((unsigned char *) frame) & 64;}
 
-    template <int N>
-    static inline void UnrolledXor(char * __restrict data, char * __restrict mask) {
-        if constexpr (N != 1) {
-            UnrolledXor<N - 1>(data, mask);
-        }
-        data[N - 1] ^= mask[(N - 1) % 4];
-    }
-
+    /* Unmasks whole 4 byte groups, up to 3 bytes past length (dst may trail src) */
     static inline void unmaskImprecise(char *dst, char *src, char *mask, unsigned int length) {
-        for (unsigned int n = (length >> 2) + 1; n; n--) {
-            *(dst++) = *(src++) ^ mask[0];
-            *(dst++) = *(src++) ^ mask[1];
-            *(dst++) = *(src++) ^ mask[2];
-            *(dst++) = *(src++) ^ mask[3];
-        }
+        protocol::xorMask(dst, src, ((size_t) (length >> 2) + 1) * 4, mask);
     }
 
     static inline void unmaskImpreciseCopyMask(char *src, unsigned int length) {
@@ -265,12 +296,10 @@ protected:
         mask[(3 + offset) % 4] = originalMask[3];
     }
 
+    /* Unmasks whole 4 byte groups until reaching stop */
     static inline void unmaskInplace(char *data, char *stop, char *mask) {
-        while (data < stop) {
-            *(data++) ^= mask[0];
-            *(data++) ^= mask[1];
-            *(data++) ^= mask[2];
-            *(data++) ^= mask[3];
+        if (data < stop) {
+            protocol::xorMask(data, data, ((size_t) (stop - data) + 3) & ~(size_t) 3, mask);
         }
     }
 
@@ -330,21 +359,14 @@ protected:
         }
     }
 
-    /* This one is nicely vectorized on both ARM64 and X64 - especially with -mavx */
     static inline void unmaskAll(char * __restrict data, char * __restrict mask) {
-        for (int i = 0; i < LIBUS_RECV_BUFFER_LENGTH; i += 16) {
-            UnrolledXor<16>(data + i, mask);
-        }
+        protocol::xorMask(data, data, LIBUS_RECV_BUFFER_LENGTH, mask);
     }
 
     static inline bool consumeContinuation(char *&src, unsigned int &length, WebSocketState<isServer> *wState, void *user) {
         if (wState->remainingBytes <= length) {
             if (isServer) {
-                unsigned int n = wState->remainingBytes >> 2;
-                unmaskInplace(src, src + n * 4, wState->mask);
-                for (unsigned int i = 0, s = wState->remainingBytes % 4; i < s; i++) {
-                    src[n * 4 + i] ^= wState->mask[i];
-                }
+                protocol::xorMask(src, src, wState->remainingBytes, wState->mask);
             }
 
             if (Impl::handleFragment(src, wState->remainingBytes, 0, wState->state.opCode[wState->state.opStack], wState->state.lastFin, wState, user)) {
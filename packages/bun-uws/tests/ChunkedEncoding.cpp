@@ -211,10 +211,50 @@ void testWithoutTrailer() {
     }
 }
 
+void testCoalesced(unsigned int maxConsume) {
+    /* Chunk extensions and upper case hex are fine too */
+    std::string buffer = "5\r\nHello\r\n1;name=value\r\n \r\nA\r\nthere I am\r\n0\r\n\r\n";
+
+    std::string received;
+    bool gotEnd = false;
+    uint64_t state = uWS::STATE_IS_CHUNKED;
+    std::string_view chunkEncoded = buffer;
+
+    while (chunkEncoded.length()) {
+        std::string_view data = chunkEncoded.substr(0, std::min<size_t>(maxConsume, chunkEncoded.length()));
+        unsigned int data_length_before_parsing = data.length();
+
+        /* Whatever fits in one call, and is not the end, comes as one piece */
+        unsigned int calls = 0;
+        uWS::forEachCoalescedChunk(data, state, [&](std::string_view chunk) {
+            if (!chunk.length()) {
+                gotEnd = true;
+            } else {
+                received.append(chunk);
+                calls++;
+            }
+        });
+
+        if (calls > 1 || uWS::isParsingInvalidChunkedEncoding(state)) {
+            std::abort();
+        }
+
+        chunkEncoded.remove_prefix(data_length_before_parsing - data.length());
+    }
+
+    if (!gotEnd || state || received != "Hello there I am") {
+        std::abort();
+    }
+}
+
 int main() {
 
     testWithoutTrailer();
 
+    for (int i = 1; i < 100; i++) {
+        testCoalesced(i);
+    }
+
     for (int i = 1; i < 1000; i++) {
         runBetterTest(i);
     }
@@ -21,6 +21,17 @@ void testNegotiation(bool wantCompression, int wantedCompressionWindow, int want
 
 }
 
+void testClientNegotiation(bool contextTakeover, std::string_view response, bool negValid, bool negCompression, int negCompressionWindow, int negInflationWindow) {
+
+    auto [valid, compression, compressionWindow, inflationWindow] = uWS::negotiateClientCompression(contextTakeover, response);
+
+    if (valid == negValid && compression == negCompression && compressionWindow == negCompressionWindow && inflationWindow == negInflationWindow) {
+        std::cout << "PASS" << std::endl;
+    } else {
+        std::cout << "FAIL: <" << response << "> gave " << valid << compression << " " << compressionWindow << " " << inflationWindow << std::endl;
+    }
+}
+
 int main() {
 
     /* Both parties must indicate compression for it to negotiate */
@@ -63,5 +74,24 @@ int main() {
     testNegotiation(true, 15, 15, "permessage-deflate; server_max_window_bits=17", true, 15, 15, "permessage-deflate");
     testNegotiation(true, 15, 15, "permessage-deflate; client_max_window_bits=17", true, 15, 15, "permessage-deflate");
 
+    /* Client side: the server may decline, but not answer with something we did not offer */
+    testClientNegotiation(true, "", true, false, 0, 0);
+    testClientNegotiation(true, "x-webkit-deflate-frame", false, false, 0, 0);
+    testClientNegotiation(true, "permessage-deflate", true, true, 15, 15);
+    testClientNegotiation(false, "permessage-deflate; client_no_context_takeover; server_no_context_takeover", true, true, 0, 0);
+    testClientNegotiation(false, "permessage-deflate", true, true, 0, 15);
+    testClientNegotiation(true, "permessage-deflate; client_no_context_takeover", true, true, 0, 15);
+    testClientNegotiation(true, "permessage-deflate; client_max_window_bits=11; server_max_window_bits=10", true, true, 11, 10);
+    testClientNegotiation(true, "permessage-deflate; client_max_window_bits=8", true, true, 8, 15);
+    testClientNegotiation(true, "permessage-deflate; client_max_window_bits", false, false, 0, 0);
+    testClientNegotiation(true, "permessage-deflate; server_max_window_bits=3", false, false, 0, 0);
+    testClientNegotiation(true, "permessage-deflate; server_max_window_bits=16", false, false, 0, 0);
+
+    /* Whatever the server answers to our own offer must be accepted */
+    auto [offerCompression, offerCompressionWindow, offerInflationWindow, offerResponse] = uWS::negotiateCompression(true, 15, 15, uWS::clientCompressionOffer(false));
+    testClientNegotiation(false, offerResponse, true, true, 0, 0);
+    auto [offerCompression2, offerCompressionWindow2, offerInflationWindow2, offerResponse2] = uWS::negotiateCompression(true, 11, 15, uWS::clientCompressionOffer(true));
+    testClientNegotiation(true, offerResponse2, true, true, 15, 11);
+
     std::cout << "ALL PASS" << std::endl;
 }
\ No newline at end of file
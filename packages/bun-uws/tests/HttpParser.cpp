@@ -23,6 +23,12 @@ int main() {
         /* Since we did proper whitespace trimming this thing is there, but empty */
         assert(httpRequest->getHeader("utf8").data());
 
+        /* Lookups go through the header index */
+        assert(httpRequest->getHeaderCount() == 4);
+        assert(httpRequest->getHeader("host") == "127.0.0.1");
+        assert(httpRequest->getHeader("connection") == "close");
+        assert(!httpRequest->getHeader("content-length").data());
+
         /* Return ok */
         return s;
 
@@ -376,10 +376,90 @@ void testParameters() {
     assert(result == "GLWGPW");
 }
 
+void testFrozen() {
+    std::cout << "TestFrozen" << std::endl;
+    uWS::HttpRouter<int> r;
+    std::string result;
+
+    /* Enough static siblings to need more than one hash bucket */
+    for (int i = 0; i < 3000; i++) {
+        r.add({"GET"}, "/api/v1/route" + std::to_string(i), [&result, i](auto *) {
+            result += "S" + std::to_string(i);
+            return true;
+        });
+    }
+
+    r.add({"GET"}, "/api/v1/:id", [&result](auto *h) {
+        auto [paramsTop, params] = h->getParameters();
+
+        assert(paramsTop == 0);
+
+        result += "P" + std::string(params[0]);
+        return false;
+    });
+
+    r.add({"GET"}, "/api/*", [&result](auto *) {
+        result += "W";
+        return true;
+    });
+
+    r.add({"POST"}, "/api/v1/route7", [&result](auto *) {
+        result += "POST";
+        return true;
+    });
+
+    r.add(r.upperCasedMethods, "/api/v1/route7", [&result](auto *) {
+        result += "ANY";
+        return true;
+    }, r.LOW_PRIORITY);
+
+    std::vector<std::pair<std::string, std::string>> requests = {
+        {"GET", "/api/v1/route0"},
+        {"GET", "/api/v1/route2999"},
+        {"GET", "/api/v1/route3000"},
+        {"GET", "/api/v1/"},
+        {"GET", "/api/other"},
+        {"GET", "/nothing"},
+        {"POST", "/api/v1/route7"},
+        {"PUT", "/api/v1/route7"},
+        {"nonsense", "/api/v1/route7"}
+    };
+
+    /* The frozen router has to behave exactly like the tree did */
+    std::vector<std::pair<bool, std::string>> expected;
+    for (auto &[method, url] : requests) {
+        result.clear();
+        bool handled = r.route(method, url);
+        expected.push_back({handled, result});
+    }
+
+    r.freeze();
+    assert(r.isFrozen());
+
+    for (unsigned int i = 0; i < requests.size(); i++) {
+        result.clear();
+        assert(r.route(requests[i].first, requests[i].second) == expected[i].first);
+        assert(result == expected[i].second);
+    }
+
+    result.clear();
+    r.route("GET", "/api/v1/route3000");
+    assert(result == "Proute3000W");
+
+    /* Changing routes goes back to the tree */
+    r.remove("GET", "/api/*", r.MEDIUM_PRIORITY);
+    assert(!r.isFrozen());
+    result.clear();
+    assert(r.route("GET", "/api/other") == false);
+    assert(r.route("GET", "/api/v1/route42"));
+    assert(result == "S42");
+}
+
 int main() {
     testPatternPriority();
     testMethodPriority();
     testUpgrade();
     testBugReports();
     testParameters();
+    testFrozen();
 }
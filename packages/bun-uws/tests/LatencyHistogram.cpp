@@ -0,0 +1,45 @@
+#include "../src/LatencyHistogram.h"
+
+#include <cassert>
+#include <iostream>
+
+int main() {
+    uWS::LatencyHistogram histogram;
+
+    /* Empty histogram */
+    assert(histogram.count() == 0);
+    assert(histogram.percentile(99) == 0);
+    assert(histogram.min() == 0);
+
+    /* Small values are exact */
+    for (uint64_t i = 1; i <= 10; i++) {
+        histogram.record(i);
+    }
+    assert(histogram.count() == 10);
+    assert(histogram.min() == 1);
+    assert(histogram.max() == 10);
+    assert(histogram.mean() == 5);
+    assert(histogram.percentile(50) == 5);
+    assert(histogram.percentile(100) == 10);
+
+    /* Larger values are within 12.5% */
+    histogram.reset();
+    for (uint64_t i = 1; i <= 100000; i++) {
+        histogram.record(i * 1000);
+    }
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        double expected = p / 100.0 * 100000 * 1000;
+        double got = (double) histogram.percentile(p);
+        assert(got >= expected * 0.99 && got <= expected * 1.125);
+    }
+    assert(histogram.percentile(100) == histogram.max());
+
+    /* Huge values are clamped but max is kept */
+    histogram.reset();
+    histogram.record(1ull << 50);
+    assert(histogram.max() == 1ull << 50);
+    assert(histogram.percentile(50) <= 1ull << 50);
+
+    std::cout << "ALL LATENCY HISTOGRAM DONE" << std::endl;
+    return 0;
+}
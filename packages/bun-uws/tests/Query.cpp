@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cassert>
+#include <string>
 
 #include "../src/QueryParser.h"
 
@@ -38,5 +39,40 @@ int main() {
         assert(uWS::getDecodedQueryValue("test2", (char *) buf.data()) == "some Value");
     }
 
+    {
+        std::string buf = "?Kest1=&test2=some%20Value&&test3=a+b";
+        uWS::QueryIndex index;
+        index.build(buf);
+        assert(index.size() == 3);
+        assert(index.get("test2") == "some Value");
+        /* Decoded only once, fetching again must not decode twice */
+        assert(index.get("test2") == "some Value");
+        assert(index.get("test3") == "a b");
+        assert(index.get("Kest1") == "");
+        assert(index.get("Kest1").data() != nullptr);
+        assert(index.get("sdfsdf").data() == nullptr);
+    }
+
+    {
+        std::string buf = "?test1=100%25";
+        uWS::QueryIndex index;
+        index.build(buf);
+        assert(index.get("test1") == "100%");
+        assert(index.get("test1") == "100%");
+    }
+
+    {
+        /* More statements than are indexed fall back to scanning the rest */
+        std::string buf = "?";
+        for (int i = 0; i < UWS_QUERY_MAX_PARAMETERS + 5; i++) {
+            buf += "k" + std::to_string(i) + "=v" + std::to_string(i) + "&";
+        }
+        uWS::QueryIndex index;
+        index.build(buf);
+        assert(index.size() == UWS_QUERY_MAX_PARAMETERS);
+        assert(index.get("k0") == "v0");
+        assert(index.get("k" + std::to_string(UWS_QUERY_MAX_PARAMETERS + 4)) == "v" + std::to_string(UWS_QUERY_MAX_PARAMETERS + 4));
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include <cassert>
 #include <iostream>
+#include <map>
+#include <set>
+#include <vector>
 
 /* Modifying the topicTree inside callback is not allowed, we had
  * tests for this before but we never need this to work anyways.
@@ -192,8 +195,129 @@ void testReorderingv19() {
     delete topicTree;
 }
 
+/* Random subscribe, unsubscribe and free against a simple model of who subscribes to what */
+void testRandomSubscriptions() {
+    std::cout << "TestRandomSubscriptions" << std::endl;
+
+    uWS::TopicTree<std::string, std::string_view> topicTree([](uWS::Subscriber *, std::string &, auto) {
+        return false;
+    });
+
+    std::vector<uWS::Subscriber *> subscribers;
+    std::map<uWS::Subscriber *, std::set<std::string>> model;
+    for (int i = 0; i < 50; i++) {
+        subscribers.push_back(topicTree.createSubscriber());
+    }
+
+    srand(1234);
+    for (int i = 0; i < 200000; i++) {
+        int which = rand() % (int) subscribers.size();
+        uWS::Subscriber *s = subscribers[which];
+        std::string topic = "topic" + std::to_string(rand() % 300);
+
+        switch (rand() % 8) {
+        case 0: case 1: case 2: case 3: {
+            bool expected = model[s].insert(topic).second;
+            assert((topicTree.subscribe(s, topic) != nullptr) == expected);
+        }
+        break;
+        case 4: case 5: case 6: {
+            bool expected = model[s].erase(topic);
+            auto [ok, last, newCount] = topicTree.unsubscribe(s, topic);
+            assert(ok == expected);
+        }
+        break;
+        case 7: {
+            topicTree.freeSubscriber(s);
+            model.erase(s);
+            subscribers[which] = topicTree.createSubscriber();
+        }
+        break;
+        }
+
+        /* Every now and then, verify everything */
+        if (i % 1000 == 0) {
+            std::map<std::string, size_t> counts;
+            for (auto &p : model) {
+                assert(p.first->topics.size() == p.second.size());
+                for (auto &t : p.second) {
+                    counts[t]++;
+                    uWS::Topic *topicPtr = topicTree.lookupTopic(t);
+                    assert(topicPtr && topicPtr->name == t && topicPtr->count(p.first) == 1);
+                }
+            }
+            for (int j = 0; j < 300; j++) {
+                std::string t = "topic" + std::to_string(j);
+                uWS::Topic *topicPtr = topicTree.lookupTopic(t);
+                assert(counts[t] == (topicPtr ? topicPtr->size() : 0));
+            }
+        }
+    }
+
+    for (uWS::Subscriber *s : subscribers) {
+        topicTree.freeSubscriber(s);
+    }
+    for (int j = 0; j < 300; j++) {
+        assert(!topicTree.lookupTopic("topic" + std::to_string(j)));
+    }
+}
+
+/* Wildcard topics match MQTT style, and overlapping ones deliver only once */
+void testWildcards() {
+    std::cout << "TestWildcards" << std::endl;
+
+    std::map<void *, std::string> actualResult;
+    uWS::TopicTree<std::string, std::string_view> topicTree([&actualResult](uWS::Subscriber *s, std::string &message, auto) {
+        actualResult[s] += message;
+        return false;
+    });
+
+    uWS::Subscriber *s1 = topicTree.createSubscriber();
+    uWS::Subscriber *s2 = topicTree.createSubscriber();
+    uWS::Subscriber *s3 = topicTree.createSubscriber();
+    uWS::Subscriber *s4 = topicTree.createSubscriber();
+
+    topicTree.subscribe(s1, "room/+/chat");
+    topicTree.subscribe(s2, "room/#");
+    topicTree.subscribe(s2, "room/42/chat");
+    topicTree.subscribe(s3, "#");
+    /* Not a wildcard, '#' is not the last segment */
+    topicTree.subscribe(s4, "room/#/chat");
+
+    assert(topicTree.publish(nullptr, "room/42/chat", "a,"));
+    assert(topicTree.publish(nullptr, "room", "b,"));
+    assert(topicTree.publish(nullptr, "room/42/chat/x", "c,"));
+    assert(topicTree.publish(nullptr, "other", "d,"));
+    assert(topicTree.publish(nullptr, "room/#/chat", "e,"));
+    /* Sender is excluded from wildcard topics as well */
+    assert(!topicTree.publish(s3, "nothing", "f,"));
+    topicTree.drain();
+
+    assert(actualResult[s1] == "a,e,");
+    assert(actualResult[s2] == "a,b,c,e,");
+    assert(actualResult[s3] == "a,b,c,d,e,");
+    assert(actualResult[s4] == "e,");
+
+    /* Unsubscribing prunes the trie, others still match */
+    topicTree.unsubscribe(s3, "#");
+    topicTree.unsubscribe(s2, "room/#");
+    actualResult.clear();
+    assert(!topicTree.publish(nullptr, "other", "g,"));
+    assert(topicTree.publish(nullptr, "room/1/chat", "h,"));
+    topicTree.drain();
+    assert(actualResult[s1] == "h," && actualResult[s2] == "" && actualResult[s3] == "");
+
+    topicTree.freeSubscriber(s1);
+    topicTree.freeSubscriber(s2);
+    topicTree.freeSubscriber(s3);
+    topicTree.freeSubscriber(s4);
+    assert(!topicTree.publish(nullptr, "room/1/chat", "i,"));
+}
+
 int main() {
     testCorrectness();
     testBugReport();
     testReorderingv19();
+    testRandomSubscriptions();
+    testWildcards();
 }
\ No newline at end of file
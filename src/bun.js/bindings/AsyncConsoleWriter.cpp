@@ -0,0 +1,280 @@
+#include "root.h"
+#include "AsyncConsoleWriter.h"
+
+#if !OS(WINDOWS)
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <mutex>
+
+extern "C" void Bun__atexit(void (*func)(void));
+
+namespace Bun {
+
+#if !OS(WINDOWS)
+
+// Like IOV_MAX, which some platforms only define as a sysconf().
+static constexpr int maxChunksPerWrite = 1024;
+
+AsyncConsoleWriter::AsyncConsoleWriter(int fd, size_t capacity, Policy policy)
+    : m_fd(fd)
+    , m_policy(policy)
+{
+    capacity = roundUpToPowerOfTwo(std::max<size_t>(capacity, 2));
+    m_mask = capacity - 1;
+    m_cells = std::make_unique<Cell[]>(capacity);
+    for (size_t i = 0; i < capacity; i++)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_thread = Thread::create(fd == 2 ? "Console stderr"_s : "Console stdout"_s, [this] {
+        run();
+    });
+    m_thread->detach();
+}
+
+bool AsyncConsoleWriter::tryPush(uint8_t* data, size_t length)
+{
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = m_cells[position & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (!difference) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.data = data;
+                cell.length = length;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncConsoleWriter::tryPop(uint8_t*& data, size_t& length)
+{
+    size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = m_cells[position & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (!difference) {
+            // A flush from the crash handler may race the writer thread.
+            if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                data = cell.data;
+                length = cell.length;
+                cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncConsoleWriter::write(std::span<const uint8_t> bytes)
+{
+    if (bytes.empty())
+        return true;
+
+    auto* data = static_cast<uint8_t*>(fastMalloc(bytes.size()));
+    memcpy(data, bytes.data(), bytes.size());
+
+    while (!tryPush(data, bytes.size())) {
+        if (m_policy == Policy::Drop) {
+            fastFree(data);
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Thread::yield();
+    }
+
+    // Pairs with run(): either it sees the chunk before it sleeps or we see
+    // that it is sleeping.
+    if (m_isSleeping.load(std::memory_order_seq_cst)) {
+        Locker locker { m_sleepLock };
+        m_wake.notifyOne();
+    }
+    return true;
+}
+
+void AsyncConsoleWriter::writeAll(struct iovec* chunks, int count)
+{
+    while (count) {
+        ssize_t written = ::writev(m_fd, chunks, count);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pollFD { m_fd, POLLOUT, 0 };
+                ::poll(&pollFD, 1, -1);
+                continue;
+            }
+            // The other end is gone; there is no one left to tell.
+            return;
+        }
+
+        size_t remaining = static_cast<size_t>(written);
+        while (count && remaining >= chunks->iov_len) {
+            remaining -= chunks->iov_len;
+            chunks++;
+            count--;
+        }
+        if (count) {
+            chunks->iov_base = static_cast<uint8_t*>(chunks->iov_base) + remaining;
+            chunks->iov_len -= remaining;
+        }
+    }
+}
+
+bool AsyncConsoleWriter::writeBatch()
+{
+    struct iovec chunks[maxChunksPerWrite + 1];
+    uint8_t* data[maxChunksPerWrite];
+    int count = 0;
+
+    char droppedMessage[64];
+    if (size_t dropped = m_dropped.exchange(0, std::memory_order_relaxed)) {
+        int length = snprintf(droppedMessage, sizeof(droppedMessage), "[%zu console message%s dropped]\n", dropped, dropped == 1 ? "" : "s");
+        chunks[count++] = { droppedMessage, static_cast<size_t>(length) };
+    }
+
+    int taken = 0;
+    size_t length;
+    while (taken < maxChunksPerWrite && tryPop(data[taken], length)) {
+        chunks[count++] = { data[taken], length };
+        taken++;
+    }
+
+    if (!count)
+        return false;
+
+    writeAll(chunks, count);
+    for (int i = 0; i < taken; i++)
+        fastFree(data[i]);
+    return true;
+}
+
+void AsyncConsoleWriter::run()
+{
+    while (true) {
+        bool wroteAny;
+        {
+            Locker locker { m_writeLock };
+            wroteAny = writeBatch();
+        }
+        if (wroteAny)
+            continue;
+
+        Locker locker { m_sleepLock };
+        m_isSleeping.store(true, std::memory_order_seq_cst);
+        size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        bool isEmpty = m_cells[position & m_mask].sequence.load(std::memory_order_seq_cst) != position + 1;
+        if (isEmpty && !m_dropped.load(std::memory_order_relaxed))
+            m_wake.waitFor(m_sleepLock, 100_ms);
+        m_isSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AsyncConsoleWriter::flush()
+{
+    Locker locker { m_writeLock };
+    while (writeBatch()) { }
+}
+
+void AsyncConsoleWriter::flushFromCrashHandler()
+{
+    bool locked = m_writeLock.tryLock();
+    while (writeBatch()) { }
+    if (locked)
+        m_writeLock.unlock();
+}
+
+#else
+
+// Windows has no writev() and its console writes are not done here.
+AsyncConsoleWriter::AsyncConsoleWriter(int fd, size_t, Policy policy)
+    : m_fd(fd)
+    , m_policy(policy)
+    , m_mask(0)
+{
+}
+
+bool AsyncConsoleWriter::write(std::span<const uint8_t>) { return false; }
+void AsyncConsoleWriter::flush() { }
+void AsyncConsoleWriter::flushFromCrashHandler() { }
+
+#endif
+
+// One for stdout and one for stderr. They live until the process exits.
+static std::atomic<AsyncConsoleWriter*> s_consoleWriters[2];
+
+static void flushConsoleWriters()
+{
+    for (auto& writer : s_consoleWriters) {
+        if (auto* consoleWriter = writer.load(std::memory_order_acquire))
+            consoleWriter->flush();
+    }
+}
+
+}
+
+// `policy` is 0 to drop output while the queue is full, 1 to wait.
+extern "C" bool AsyncConsoleWriter__enable(int fd, size_t capacity, uint8_t policy)
+{
+#if OS(WINDOWS)
+    return false;
+#else
+    if (fd != 1 && fd != 2)
+        return false;
+
+    static Lock enableLock;
+    Locker locker { enableLock };
+    auto& slot = Bun::s_consoleWriters[fd - 1];
+    if (!slot.load(std::memory_order_relaxed))
+        slot.store(new Bun::AsyncConsoleWriter(fd, capacity, static_cast<Bun::AsyncConsoleWriter::Policy>(policy)), std::memory_order_release);
+
+    static std::once_flag registerOnce;
+    std::call_once(registerOnce, [] {
+        Bun__atexit(Bun::flushConsoleWriters);
+    });
+    return true;
+#endif
+}
+
+// Returns false if `fd` is written synchronously, in which case the caller
+// writes the bytes itself.
+extern "C" bool AsyncConsoleWriter__write(int fd, const uint8_t* bytes, size_t length)
+{
+    if (fd != 1 && fd != 2)
+        return false;
+    auto* writer = Bun::s_consoleWriters[fd - 1].load(std::memory_order_acquire);
+    if (!writer)
+        return false;
+    writer->write({ bytes, length });
+    return true;
+}
+
+// Before anything that has to come after what was already logged, such as
+// a synchronous write to the same fd.
+extern "C" void AsyncConsoleWriter__flush()
+{
+    Bun::flushConsoleWriters();
+}
+
+extern "C" void AsyncConsoleWriter__flushFromCrashHandler()
+{
+    for (auto& writer : Bun::s_consoleWriters) {
+        if (auto* consoleWriter = writer.load(std::memory_order_acquire))
+            consoleWriter->flushFromCrashHandler();
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/Condition.h>
+#include <wtf/Lock.h>
+#include <wtf/Threading.h>
+
+struct iovec;
+
+namespace Bun {
+
+// The opt-in asynchronous console: formatted output for stdout or stderr is
+// queued and written by a thread of its own, so a slow pipe on the other
+// end does not block the thread that logs.
+//
+// The queue is a bounded multi-producer queue of copied chunks (Vyukov's
+// bounded MPMC queue; the writer is its only consumer), so workers can log
+// too without taking a lock. The writer takes as many chunks as writev()
+// accepts in one call. When the queue is full, the Drop policy discards the
+// chunk and later reports how many were lost; the Block policy waits for
+// the writer to make room.
+//
+// Everything still queued is written on exit, and as far as possible from
+// the crash handler.
+class AsyncConsoleWriter {
+    WTF_MAKE_NONCOPYABLE(AsyncConsoleWriter);
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    enum class Policy : uint8_t {
+        Drop,
+        Block,
+    };
+
+    AsyncConsoleWriter(int fd, size_t capacity, Policy);
+
+    // Returns false if nothing was queued because the queue was full and
+    // the policy is Drop.
+    bool write(std::span<const uint8_t>);
+
+    // Writes everything queued so far on the calling thread.
+    void flush();
+
+    // From the crash handler: like flush(), but without waiting for the
+    // writer thread, which may be the one that crashed.
+    void flushFromCrashHandler();
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        uint8_t* data;
+        size_t length;
+    };
+
+    bool tryPush(uint8_t* data, size_t length);
+    bool tryPop(uint8_t*& data, size_t& length);
+    // Writes up to a writev() worth of chunks; returns false if there were
+    // none. Called with m_writeLock held, except from the crash handler.
+    bool writeBatch();
+    void writeAll(struct iovec*, int count);
+    void run();
+
+    int m_fd;
+    Policy m_policy;
+    size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<size_t> m_enqueuePosition { 0 };
+    alignas(64) std::atomic<size_t> m_dequeuePosition { 0 };
+    std::atomic<size_t> m_dropped { 0 };
+
+    // Held while chunks are taken and written, so that a flush() from
+    // another thread does not interleave with the writer thread.
+    Lock m_writeLock;
+    Lock m_sleepLock;
+    Condition m_wake;
+    std::atomic<bool> m_isSleeping { false };
+    RefPtr<Thread> m_thread;
+};
+
+}
@@ -2,6 +2,7 @@
 #include "ZigGlobalObject.h"
 #include "AsyncContextFrame.h"
 #include <JavaScriptCore/InternalFieldTuple.h>
+#include <bit>
 
 using namespace JSC;
 using namespace WebCore;
@@ -43,13 +44,29 @@ JSValue AsyncContextFrame::withAsyncContextIfNeeded(JSGlobalObject* globalObject
         return callback;
     }
 
-    // Construct a low-overhead wrapper
+    // A frame never changes once created, so the one made for the same
+    // callback under the same context is handed out again. With tracing
+    // on, the same handler is scheduled over and over in the same context
+    // (a socket's, a request's), and this keeps that from allocating a
+    // frame every time. The cache is direct-mapped and small, so what it
+    // keeps alive is bounded.
     auto& vm = globalObject->vm();
-    return AsyncContextFrame::create(
+    auto* zigGlobalObject = jsCast<Zig::GlobalObject*>(globalObject);
+    uint64_t key = JSValue::encode(callback) ^ std::rotl(static_cast<uint64_t>(JSValue::encode(context)), 32);
+    auto& cached = zigGlobalObject->m_asyncContextFrameCache[WTF::intHash(key) % Zig::GlobalObject::asyncContextFrameCacheSize];
+    if (JSValue cachedFrame = cached.get()) {
+        auto* frame = jsCast<AsyncContextFrame*>(cachedFrame);
+        if (frame->callback.get() == callback && frame->context.get() == context)
+            return frame;
+    }
+
+    auto* frame = AsyncContextFrame::create(
         vm,
-        jsCast<Zig::GlobalObject*>(globalObject)->AsyncContextFrameStructure(),
+        zigGlobalObject->AsyncContextFrameStructure(),
         callback,
         context);
+    cached.set(vm, zigGlobalObject, frame);
+    return frame;
 }
 
 template<typename Visitor>
@@ -0,0 +1,84 @@
+#include "root.h"
+#include "AtomStringCache.h"
+
+#include "ZigGlobalObject.h"
+#include "BunClientData.h"
+#include <JavaScriptCore/ObjectConstructor.h>
+
+namespace Bun {
+
+using namespace JSC;
+
+static thread_local AtomStringCache* s_currentAtomStringCache = nullptr;
+
+AtomStringCache::AtomStringCache()
+{
+    s_currentAtomStringCache = this;
+}
+
+AtomStringCache::~AtomStringCache()
+{
+    if (s_currentAtomStringCache == this)
+        s_currentAtomStringCache = nullptr;
+}
+
+AtomStringCache* AtomStringCache::current()
+{
+    return s_currentAtomStringCache;
+}
+
+static ALWAYS_INLINE uint64_t loadPrefix(const LChar* characters, size_t length)
+{
+    uint64_t word = 0;
+    memcpy(&word, characters, std::min<size_t>(length, sizeof(word)));
+    return word;
+}
+
+static ALWAYS_INLINE size_t slotFor(std::span<const LChar> characters)
+{
+    size_t length = characters.size();
+    uint64_t key = loadPrefix(characters.data(), length);
+    if (length > sizeof(uint64_t))
+        key ^= loadPrefix(characters.data() + length - sizeof(uint64_t), sizeof(uint64_t)) >> 7;
+    key = (key ^ length) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(key >> 55) & (AtomStringCache::capacity - 1);
+}
+
+AtomString AtomStringCache::make(std::span<const LChar> characters)
+{
+    if (characters.empty() || characters.size() > maxLength)
+        return AtomString(characters);
+
+    auto& entry = m_entries[slotFor(characters)];
+    if (entry && entry->length() == characters.size() && entry->is8Bit()
+        && !memcmp(entry->span8().data(), characters.data(), characters.size())) {
+        m_statistics.hits++;
+        return AtomString(entry.get());
+    }
+
+    m_statistics.misses++;
+    AtomString atom(characters);
+    entry = atom.impl();
+    return atom;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionAtomStringCacheStatistics, (JSGlobalObject * globalObject, CallFrame*))
+{
+    auto& vm = globalObject->vm();
+    auto statistics = WebCore::clientData(vm)->atomStringCache.statistics();
+
+    auto* object = constructEmptyObject(globalObject);
+    object->putDirect(vm, Identifier::fromString(vm, "hits"_s), jsNumber(statistics.hits));
+    object->putDirect(vm, Identifier::fromString(vm, "misses"_s), jsNumber(statistics.misses));
+    uint64_t total = statistics.hits + statistics.misses;
+    object->putDirect(vm, Identifier::fromString(vm, "hitRate"_s), jsNumber(total ? static_cast<double>(statistics.hits) / total : 0));
+    return JSValue::encode(object);
+}
+
+JSValue createAtomStringCacheStatisticsFunction(Zig::GlobalObject* globalObject)
+{
+    auto& vm = globalObject->vm();
+    return JSFunction::create(vm, globalObject, 0, "atomStringCacheStatistics"_s, jsFunctionAtomStringCacheStatistics, ImplementationVisibility::Public);
+}
+
+}
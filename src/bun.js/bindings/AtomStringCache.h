@@ -0,0 +1,46 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/text/AtomString.h>
+
+namespace Bun {
+
+// A small direct-mapped memo in front of the thread's AtomString table.
+//
+// Header names, JSON keys and column names repeat constantly, and every
+// trip through the table rehashes the whole string. Here a slot is picked
+// from the length and the first and last few bytes, and a hit is confirmed
+// with a memcmp against the cached atom, so the common case never hashes.
+//
+// One cache lives in each VM's client data. JS for a VM only runs on that
+// VM's thread, so the cache needs no locking.
+class AtomStringCache {
+    WTF_MAKE_NONCOPYABLE(AtomStringCache);
+
+public:
+    static constexpr size_t capacity = 512;
+    // Longer strings are rare as keys and cost more to compare than to hash.
+    static constexpr size_t maxLength = 64;
+
+    struct Statistics {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+    };
+
+    AtomStringCache();
+    ~AtomStringCache();
+
+    // The cache of the VM running on this thread, if there is one.
+    static AtomStringCache* current();
+
+    // `characters` are Latin-1; callers must not pass UTF-8.
+    AtomString make(std::span<const LChar> characters);
+
+    Statistics statistics() const { return m_statistics; }
+
+private:
+    std::array<RefPtr<AtomStringImpl>, capacity> m_entries;
+    Statistics m_statistics;
+};
+
+}
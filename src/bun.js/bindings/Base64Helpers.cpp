@@ -48,6 +48,76 @@ ExceptionOr<String> atob(const String& encodedString)
     }
 
     return outString;
+
+EncodingChunkResult encodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output, bool url, bool final)
+{
+    auto options = url ? simdutf::base64_url : simdutf::base64_default;
+
+    size_t length = input.size();
+    if (!final || simdutf::base64_length_from_binary(length, options) > output.size())
+        length = std::min(length / 3, output.size() / 4) * 3;
+
+    size_t written = simdutf::binary_to_base64(reinterpret_cast<const char*>(input.data()), length, reinterpret_cast<char*>(output.data()), options);
+    return { length, written, false };
+}
+
+EncodingChunkResult decodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output, bool url, bool final)
+{
+    auto options = url ? simdutf::base64_url : simdutf::base64_default;
+
+    size_t length = input.size();
+    if (!final) {
+        // Hold back characters that do not complete a group of four.
+        size_t significant = 0;
+        for (auto c : input)
+            significant += !isASCIIWhitespace(c);
+        for (size_t excess = significant % 4; excess && length; length--) {
+            if (!isASCIIWhitespace(input[length - 1]))
+                excess--;
+        }
+    }
+
+    size_t written = output.size();
+    auto result = simdutf::base64_to_binary_safe(reinterpret_cast<const char*>(input.data()), length, reinterpret_cast<char*>(output.data()), written, options);
+    switch (result.error) {
+    case simdutf::error_code::SUCCESS:
+        return { length, written, false };
+    case simdutf::error_code::OUTPUT_BUFFER_TOO_SMALL:
+        return { result.count, written, false };
+    default:
+        return { 0, 0, true };
+    }
+}
+
+}
+
+namespace Hex {
+
+EncodingChunkResult encodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+
+    size_t length = std::min(input.size(), output.size() / 2);
+    for (size_t i = 0; i < length; i++) {
+        output[i * 2] = digits[input[i] >> 4];
+        output[i * 2 + 1] = digits[input[i] & 0xF];
+    }
+    return { length, length * 2, false };
+}
+
+EncodingChunkResult decodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+    size_t length = std::min(input.size() / 2, output.size());
+    for (size_t i = 0; i < length; i++) {
+        uint8_t high = input[i * 2];
+        uint8_t low = input[i * 2 + 1];
+        if (UNLIKELY(!isASCIIHexDigit(high) || !isASCIIHexDigit(low)))
+            return { i * 2, i, true };
+        output[i] = static_cast<uint8_t>(toASCIIHexValue(high, low));
+    }
+    return { length * 2, length, false };
+}
+
 }
 }
 }
\ No newline at end of file
@@ -2,9 +2,34 @@
 
 namespace Bun {
 
+// How far a chunked encode or decode call got. `read` input bytes produced
+// `written` output bytes; the caller continues from input + read.
+struct EncodingChunkResult {
+    size_t read { 0 };
+    size_t written { 0 };
+    bool invalidInput { false };
+};
+
 namespace Base64 {
 
 WebCore::ExceptionOr<WTF::String> atob(const WTF::String& encodedString);
 
+// Binary to base64 text. Unless `final` is set, only whole 3 byte groups are
+// consumed, so chunks can be concatenated without padding in between.
+EncodingChunkResult encodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output, bool url, bool final);
+
+// Base64 text (ASCII whitespace is skipped) to binary. Unless `final` is set,
+// a trailing partial group of characters is left for the next call.
+EncodingChunkResult decodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output, bool url, bool final);
+
+}
+
+namespace Hex {
+
+EncodingChunkResult encodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output);
+
+// Stops at the first pair that is not valid hex, like Buffer.from(string, "hex").
+EncodingChunkResult decodeChunk(std::span<const uint8_t> input, std::span<uint8_t> output);
+
 }
 }
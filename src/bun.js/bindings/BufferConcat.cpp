@@ -0,0 +1,101 @@
+#include "root.h"
+#include "BufferConcat.h"
+
+#include <wtf/WorkQueue.h>
+
+#if CPU(X86_64)
+#include <emmintrin.h>
+#endif
+
+namespace Bun {
+
+namespace BufferConcat {
+
+// Outputs this large would evict everything else from the cache on their way
+// through, and are rarely read back right away.
+static constexpr size_t nonTemporalThreshold = 4 * MB;
+
+// Below this the cost of waking up worker threads outweighs the copy itself.
+static constexpr size_t parallelThreshold = 64 * MB;
+static constexpr size_t parallelChunkSize = 16 * MB;
+
+static void copyNonTemporal(uint8_t* destination, const uint8_t* source, size_t length)
+{
+#if CPU(X86_64)
+    size_t head = std::min(length, (16 - (reinterpret_cast<uintptr_t>(destination) & 15)) & 15);
+    memcpy(destination, source, head);
+    destination += head;
+    source += head;
+    length -= head;
+
+    size_t body = length & ~static_cast<size_t>(63);
+    for (size_t i = 0; i < body; i += 64) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(destination + i), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(destination + i + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(destination + i + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(destination + i + 48), d);
+    }
+    // Streaming stores are weakly ordered, make them visible before returning.
+    _mm_sfence();
+
+    memcpy(destination + body, source + body, length - body);
+#else
+    memcpy(destination, source, length);
+#endif
+}
+
+// Copies output bytes [begin, end). segmentStart is the index of the segment
+// containing begin and segmentOffset is where that segment starts in the output.
+static void copyRange(uint8_t* destination, std::span<const std::span<const uint8_t>> segments, size_t segmentStart, size_t segmentOffset, size_t begin, size_t end, bool nonTemporal)
+{
+    size_t position = begin;
+    for (size_t i = segmentStart; i < segments.size() && position < end; i++) {
+        const auto& segment = segments[i];
+        size_t skip = position - segmentOffset;
+        size_t length = std::min(segment.size() - skip, end - position);
+        if (nonTemporal)
+            copyNonTemporal(destination + position, segment.data() + skip, length);
+        else
+            memcpy(destination + position, segment.data() + skip, length);
+        position += length;
+        segmentOffset += segment.size();
+    }
+}
+
+void copySegments(uint8_t* destination, std::span<const std::span<const uint8_t>> segments, size_t totalLength)
+{
+    if (totalLength < parallelThreshold) {
+        copyRange(destination, segments, 0, 0, 0, totalLength, totalLength >= nonTemporalThreshold);
+        return;
+    }
+
+    // Find where each chunk of the output starts in the list of segments, so
+    // every worker can start copying right away.
+    size_t chunkCount = (totalLength + parallelChunkSize - 1) / parallelChunkSize;
+    Vector<std::pair<size_t, size_t>> chunkStarts;
+    chunkStarts.reserveInitialCapacity(chunkCount);
+
+    size_t segmentOffset = 0;
+    size_t segmentIndex = 0;
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        size_t begin = chunk * parallelChunkSize;
+        while (segmentIndex < segments.size() && segmentOffset + segments[segmentIndex].size() <= begin) {
+            segmentOffset += segments[segmentIndex].size();
+            segmentIndex++;
+        }
+        chunkStarts.append({ segmentIndex, segmentOffset });
+    }
+
+    WorkQueue::concurrentApply(chunkCount, [&](size_t chunk) {
+        size_t begin = chunk * parallelChunkSize;
+        size_t end = std::min(totalLength, begin + parallelChunkSize);
+        copyRange(destination, segments, chunkStarts[chunk].first, chunkStarts[chunk].second, begin, end, true);
+    });
+}
+
+}
+}
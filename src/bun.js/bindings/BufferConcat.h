@@ -0,0 +1,25 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+namespace BufferConcat {
+
+// Copies every segment back to back into destination, which must have room
+// for the sum of their lengths. Large outputs bypass the cache and very large
+// ones are split across worker threads; the call returns once all bytes are
+// copied.
+void copySegments(uint8_t* destination, std::span<const std::span<const uint8_t>> segments, size_t totalLength);
+
+// Reads array[index] without going through the generic getter path when the
+// element is stored inline, which is almost always the case for lists of chunks.
+ALWAYS_INLINE JSC::JSValue getElement(JSC::JSGlobalObject* lexicalGlobalObject, JSC::JSArray* array, unsigned index)
+{
+    if (LIKELY(array->canGetIndexQuickly(index)))
+        return array->getIndexQuickly(index);
+    return array->getIndex(lexicalGlobalObject, index);
+}
+
+}
+}
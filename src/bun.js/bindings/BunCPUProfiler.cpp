@@ -0,0 +1,240 @@
+#include "root.h"
+#include "BunCPUProfiler.h"
+
+#include "ScriptExecutionContext.h"
+#include <JavaScriptCore/SamplingProfiler.h>
+#include <JavaScriptCore/VM.h>
+#include <wtf/JSONValues.h>
+#include <wtf/Stopwatch.h>
+#include <wtf/WallTime.h>
+#include <wtf/text/StringBuilder.h>
+
+#if !OS(WINDOWS)
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace Bun {
+
+using namespace JSC;
+
+// Only the thread running the VM starts and stops it.
+static thread_local bool s_isCPUProfilerRunning = false;
+
+void startCPUProfiler(VM& vm, Seconds interval)
+{
+    auto& samplingProfiler = vm.ensureSamplingProfiler(WTF::Stopwatch::create());
+    samplingProfiler.setTimingInterval(interval);
+    samplingProfiler.noticeCurrentThreadAsJSCExecutionThread();
+    samplingProfiler.start();
+    s_isCPUProfilerRunning = true;
+}
+
+bool isCPUProfilerRunning(VM&)
+{
+    return s_isCPUProfilerRunning;
+}
+
+// The profile is a call tree: one node per distinct stack prefix, with each
+// sample pointing at the node of its innermost frame.
+// https://chromedevtools.github.io/devtools-protocol/tot/Profiler/#type-Profile
+class CPUProfileBuilder {
+public:
+    CPUProfileBuilder()
+    {
+        addNode(0, "(root)"_s, emptyString(), 0, 0, 0);
+    }
+
+    void addSample(VM& vm, SamplingProfiler::StackTrace& stackTrace)
+    {
+        unsigned nodeId = rootId;
+        // Frames are innermost first.
+        for (size_t i = stackTrace.frames.size(); i--;) {
+            auto& frame = stackTrace.frames[i];
+            nodeId = child(nodeId, frame.displayName(vm), frame.url(), frame.sourceID(), frame.functionStartLine(), frame.functionStartColumn());
+        }
+        m_nodes[nodeId - 1].hitCount++;
+
+        Seconds timestamp = stackTrace.timestamp;
+        if (m_samples.isEmpty())
+            m_startTime = timestamp;
+        m_samples.append(nodeId);
+        m_timeDeltas.append(static_cast<int>((timestamp - (m_samples.size() > 1 ? m_endTime : m_startTime)).microseconds()));
+        m_endTime = timestamp;
+    }
+
+    String toJSON() const
+    {
+        auto nodes = JSON::Array::create();
+        for (size_t i = 0; i < m_nodes.size(); i++) {
+            auto& node = m_nodes[i];
+            auto callFrame = JSON::Object::create();
+            callFrame->setString("functionName"_s, node.functionName);
+            callFrame->setString("scriptId"_s, String::number(node.scriptId));
+            callFrame->setString("url"_s, node.url);
+            // The protocol counts from 0, JSC from 1.
+            callFrame->setInteger("lineNumber"_s, node.line ? node.line - 1 : 0);
+            callFrame->setInteger("columnNumber"_s, node.column ? node.column - 1 : 0);
+
+            auto object = JSON::Object::create();
+            object->setInteger("id"_s, i + 1);
+            object->setObject("callFrame"_s, WTFMove(callFrame));
+            object->setInteger("hitCount"_s, node.hitCount);
+            auto children = JSON::Array::create();
+            for (unsigned childId : node.children)
+                children->pushInteger(childId);
+            object->setArray("children"_s, WTFMove(children));
+            nodes->pushObject(WTFMove(object));
+        }
+
+        auto samples = JSON::Array::create();
+        for (unsigned nodeId : m_samples)
+            samples->pushInteger(nodeId);
+        auto timeDeltas = JSON::Array::create();
+        for (int delta : m_timeDeltas)
+            timeDeltas->pushInteger(delta);
+
+        auto profile = JSON::Object::create();
+        profile->setArray("nodes"_s, WTFMove(nodes));
+        profile->setDouble("startTime"_s, m_startTime.microseconds());
+        profile->setDouble("endTime"_s, m_endTime.microseconds());
+        profile->setArray("samples"_s, WTFMove(samples));
+        profile->setArray("timeDeltas"_s, WTFMove(timeDeltas));
+        return profile->toJSONString();
+    }
+
+private:
+    static constexpr unsigned rootId = 1;
+
+    struct Node {
+        String functionName;
+        String url;
+        intptr_t scriptId;
+        int line;
+        unsigned column;
+        unsigned hitCount { 0 };
+        Vector<unsigned> children;
+    };
+
+    unsigned addNode(unsigned parentId, const String& functionName, const String& url, intptr_t scriptId, int line, unsigned column)
+    {
+        m_nodes.append({ functionName, url, scriptId, line, column });
+        unsigned id = m_nodes.size();
+        if (parentId)
+            m_nodes[parentId - 1].children.append(id);
+        return id;
+    }
+
+    unsigned child(unsigned parentId, const String& functionName, const String& url, intptr_t scriptId, int line, unsigned column)
+    {
+        StringBuilder key;
+        key.append(parentId, '\0', scriptId, '\0', line, '\0', column, '\0', functionName);
+        auto result = m_children.ensure(key.toString(), [&] {
+            return addNode(parentId, functionName, url, scriptId, line, column);
+        });
+        return result.iterator->value;
+    }
+
+    Vector<Node> m_nodes;
+    HashMap<String, unsigned> m_children;
+    Vector<unsigned> m_samples;
+    Vector<int> m_timeDeltas;
+    Seconds m_startTime;
+    Seconds m_endTime;
+};
+
+String stopCPUProfiler(VM& vm)
+{
+    auto* samplingProfiler = vm.samplingProfiler();
+    if (!s_isCPUProfilerRunning || !samplingProfiler)
+        return String();
+    s_isCPUProfilerRunning = false;
+
+    JSLockHolder lock(vm);
+    DeferGC deferGC(vm);
+    Vector<SamplingProfiler::StackTrace> stackTraces;
+    {
+        Locker locker { samplingProfiler->getLock() };
+        samplingProfiler->pause();
+        stackTraces = samplingProfiler->releaseStackTraces();
+    }
+
+    CPUProfileBuilder builder;
+    for (auto& stackTrace : stackTraces)
+        builder.addSample(vm, stackTrace);
+    return builder.toJSON();
+}
+
+#if !OS(WINDOWS)
+
+static const char* s_cpuProfileDirectory = nullptr;
+
+static void writeCPUProfile(const String& profile)
+{
+    time_t now = time(nullptr);
+    struct tm local;
+    localtime_r(&now, &local);
+    char name[64];
+    snprintf(name, sizeof(name), "/CPU.%04d%02d%02d.%02d%02d%02d.%d.cpuprofile",
+        local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec, getpid());
+    auto path = makeString(String::fromUTF8(s_cpuProfileDirectory), String::fromLatin1(name)).utf8();
+
+    int fd = open(path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return;
+    auto json = profile.utf8();
+    size_t written = 0;
+    while (written < json.length()) {
+        ssize_t result = write(fd, json.data() + written, json.length() - written);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        written += result;
+    }
+    close(fd);
+}
+
+static void cpuProfilerSignalHandler(int)
+{
+    auto* context = WebCore::ScriptExecutionContext::getMainThreadScriptExecutionContext();
+    if (UNLIKELY(!context))
+        return;
+
+    // Like process.on("SIGxxx"), the work happens on the JS thread.
+    context->postTaskConcurrently([](WebCore::ScriptExecutionContext& context) {
+        auto& vm = context.vm();
+        if (!isCPUProfilerRunning(vm)) {
+            startCPUProfiler(vm);
+            return;
+        }
+        writeCPUProfile(stopCPUProfiler(vm));
+    });
+}
+
+#endif
+
+void installCPUProfilerSignalHandler()
+{
+#if !OS(WINDOWS)
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        const char* directory = getenv("BUN_CPU_PROFILE_DIR");
+        if (!directory || !*directory)
+            return;
+        s_cpuProfileDirectory = directory;
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(struct sigaction));
+        action.sa_handler = cpuProfilerSignalHandler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGUSR2, &action, nullptr);
+    });
+#endif
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// JSC's SamplingProfiler, with its samples written out as a Chrome
+// .cpuprofile (what `node --cpu-prof` writes, and what Chrome DevTools,
+// speedscope and pprof's importers read).
+//
+// Host functions from the bindings show up as frames of their own, under
+// the name they were given, so time spent in native code is not charged to
+// the JS function that called it.
+//
+// The profiler thread wakes every `interval` to suspend the JS thread and
+// walk its stack. At the default 10ms that costs well under a percent, which
+// is why it can stay on in production; the 1ms that node uses is closer to
+// a few percent.
+static constexpr Seconds defaultCPUProfilerInterval = 10_ms;
+
+void startCPUProfiler(JSC::VM&, Seconds interval = defaultCPUProfilerInterval);
+bool isCPUProfilerRunning(JSC::VM&);
+// The samples taken since startCPUProfiler, as JSON. A null string if it
+// was not running.
+String stopCPUProfiler(JSC::VM&);
+
+// With BUN_CPU_PROFILE_DIR set, SIGUSR2 starts the profiler, and the next
+// SIGUSR2 stops it and writes CPU.<date>.<time>.<pid>.cpuprofile there, so
+// a running process can be profiled without the inspector.
+void installCPUProfilerSignalHandler();
+
+}
@@ -24,6 +24,11 @@ class DOMWrapperWorld;
 #include <wtf/StdLibExtras.h>
 #include "WebCoreJSBuiltins.h"
 #include "JSCTaskScheduler.h"
+#include "AtomStringCache.h"
+#include "ParsedURLCache.h"
+#include "SerializedShapeDictionary.h"
+#include "Strong.h"
+#include "TimestampCache.h"
 
 namespace Zig {
 }
@@ -109,6 +114,11 @@ public:
 
     void* bunVM;
     Bun::JSCTaskScheduler deferredWorkTimer;
+    Bun::AtomStringCache atomStringCache;
+    Bun::ParsedURLCache parsedURLCache;
+    SerializedShapeCache serializedShapeCache;
+    Bun::StrongRefPool strongRefPool;
+    Bun::TimestampCache timestampCache;
 
 private:
     BunBuiltinNames m_builtinNames;
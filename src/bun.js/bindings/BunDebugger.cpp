@@ -11,6 +11,13 @@
 #include "debug-helpers.h"
 #include "BunInjectedScriptHost.h"
 #include <JavaScriptCore/JSGlobalObjectInspectorController.h>
+#include <wtf/Threading.h>
+
+#if !OS(WINDOWS)
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 extern "C" void Bun__tickWhilePaused(bool*);
 extern "C" void Bun__eventLoop__incrementRefConcurrently(void* bunVM, int delta);
@@ -20,6 +27,7 @@ using namespace JSC;
 using namespace WebCore;
 
 class BunInspectorConnection;
+static bool hasConnectedFrontend(ScriptExecutionContextIdentifier);
 
 static WebCore::ScriptExecutionContext* debuggerScriptExecutionContext = nullptr;
 static WTF::Lock inspectorConnectionsLock = WTF::Lock();
@@ -159,6 +167,11 @@ public:
                 connection->unrefOnDisconnect = false;
                 Bun__eventLoop__incrementRefConcurrently(reinterpret_cast<Zig::GlobalObject*>(context.jsGlobalObject())->bunVM(), -1);
             }
+
+            // With the last frontend gone, go back to being armed but
+            // detached, so console calls stop going through the inspector.
+            if (!hasConnectedFrontend(context.identifier()) && !waitingForConnection)
+                context.jsGlobalObject()->setInspectable(false);
         });
     }
 
@@ -451,10 +464,13 @@ extern "C" void Bun__ensureDebugger(ScriptExecutionContextIdentifier scriptId, b
     globalObject->m_inspectorController = makeUnique<Inspector::JSGlobalObjectInspectorController>(*globalObject, Bun::BunInjectedScriptHost::create());
     globalObject->m_inspectorDebuggable = makeUnique<BunJSGlobalObjectDebuggable>(*globalObject);
 
-    globalObject->setInspectable(true);
-
-    auto& inspector = globalObject->inspectorDebuggable();
-    inspector.setInspectable(true);
+    // Until a frontend connects, the global is only armed: it is not
+    // inspectable and no debugger is attached, so nothing runs slower.
+    // doConnect() makes it inspectable.
+    if (pauseOnStart) {
+        globalObject->setInspectable(true);
+        waitingForConnection = true;
+    }
 
     Inspector::JSGlobalObjectDebugger* debugger = reinterpret_cast<Inspector::JSGlobalObjectDebugger*>(globalObject->debugger());
     if (debugger) {
@@ -462,9 +478,68 @@ extern "C" void Bun__ensureDebugger(ScriptExecutionContextIdentifier scriptId, b
             BunInspectorConnection::runWhilePaused(globalObject, isDoneProcessingEvents);
         };
     }
-    if (pauseOnStart) {
-        waitingForConnection = true;
+}
+
+static bool hasConnectedFrontend(ScriptExecutionContextIdentifier identifier)
+{
+    Locker<Lock> locker(inspectorConnectionsLock);
+    if (!inspectorConnections)
+        return false;
+
+    for (auto* connection : inspectorConnections->get(identifier)) {
+        if (connection->status == ConnectionStatus::Connected)
+            return true;
     }
+    return false;
+}
+
+#if !OS(WINDOWS)
+static int debuggerActivationPipe[2] = { -1, -1 };
+
+static void onDebuggerActivationSignal(int)
+{
+    int savedErrno = errno;
+    char byte = 0;
+    (void)!write(debuggerActivationPipe[1], &byte, 1);
+    errno = savedErrno;
+}
+#endif
+
+// Lets `kill -USR1 <pid>` start the inspector in a process that was run
+// without it, like node does. The handler only wakes a thread, which calls
+// `onActivate` with `context`; starting the debugger thread is up to the
+// caller. Returns false when the signal cannot be used.
+extern "C" bool Bun__installDebuggerActivationSignal(void (*onActivate)(void*), void* context)
+{
+#if OS(WINDOWS)
+    UNUSED_PARAM(onActivate);
+    UNUSED_PARAM(context);
+    return false;
+#else
+    if (debuggerActivationPipe[0] != -1)
+        return true;
+
+    if (pipe(debuggerActivationPipe) != 0)
+        return false;
+
+    Thread::create("Debugger Activation"_s, [onActivate, context] {
+        char byte;
+        while (true) {
+            ssize_t result = read(debuggerActivationPipe[0], &byte, 1);
+            if (result == 1)
+                onActivate(context);
+            else if (result == 0 || errno != EINTR)
+                return;
+        }
+    })->detach();
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sa.sa_handler = onDebuggerActivationSignal;
+    return sigaction(SIGUSR1, &sa, nullptr) == 0;
+#endif
 }
 
 extern "C" void BunDebugger__willHotReload()
@@ -0,0 +1,223 @@
+#include "root.h"
+#include "BunGCController.h"
+
+#include "BunProcess.h"
+#include "ZigGlobalObject.h"
+#include "libusockets.h"
+#include "_libusockets.h"
+#include <JavaScriptCore/HeapInlines.h>
+#include <JavaScriptCore/Options.h>
+#include <wtf/MemoryFootprint.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/RAMSize.h>
+#include <wtf/text/StringToIntegerConversion.h>
+#include <string>
+
+#if OS(LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Bun {
+
+using namespace JSC;
+
+// Idle collections start only once this much was allocated since the last
+// collection, so an idle server does not keep collecting an unchanged heap.
+static constexpr size_t idleCollectionThreshold = 1 * MB;
+static constexpr Seconds idleCollectionInterval = 100_ms;
+static constexpr Seconds pressureCheckInterval = 250_ms;
+static constexpr double pressureThreshold = 0.85;
+static constexpr double pressureReliefThreshold = 0.70;
+
+#if OS(LINUX)
+static std::optional<uint64_t> readMemoryLimit(const char* path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return std::nullopt;
+    char buffer[32];
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0)
+        return std::nullopt;
+    while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == ' '))
+        length--;
+    // cgroup v2 writes "max" when there is no limit.
+    return parseInteger<uint64_t>(StringView { std::span { reinterpret_cast<const LChar*>(buffer), static_cast<size_t>(length) } });
+}
+
+static std::optional<uint64_t> cgroupMemoryLimit()
+{
+    // cgroup v2, where /proc/self/cgroup is the single line "0::<path>".
+    // Inside a container's cgroup namespace the path is usually "/".
+    int fd = open("/proc/self/cgroup", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        char buffer[512];
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length > 3 && !memcmp(buffer, "0::", 3)) {
+            std::string_view path { buffer + 3, static_cast<size_t>(length - 3) };
+            path = path.substr(0, path.find('\n'));
+            std::string file = "/sys/fs/cgroup";
+            file += path;
+            file += path.ends_with('/') ? "memory.max" : "/memory.max";
+            if (auto limit = readMemoryLimit(file.c_str()))
+                return limit;
+        }
+    }
+    if (auto limit = readMemoryLimit("/sys/fs/cgroup/memory.max"))
+        return limit;
+    // cgroup v1 writes a number close to 2^63 when there is no limit, which
+    // the comparison with the RAM size takes care of.
+    return readMemoryLimit("/sys/fs/cgroup/memory/memory.limit_in_bytes");
+}
+#endif
+
+size_t constrainedMemory()
+{
+    static size_t memory = [] {
+        size_t ramSize = WTF::ramSize();
+#if OS(LINUX)
+        if (auto limit = cgroupMemoryLimit(); limit && *limit && *limit < ramSize)
+            return static_cast<size_t>(*limit);
+#endif
+        return ramSize;
+    }();
+    return memory;
+}
+
+static std::optional<size_t> parseByteSize(const char* string)
+{
+    if (!string || !*string)
+        return std::nullopt;
+    char* end = nullptr;
+    unsigned long long value = strtoull(string, &end, 10);
+    if (end == string)
+        return std::nullopt;
+    switch (*end) {
+    case 'k':
+    case 'K':
+        value *= KB;
+        end++;
+        break;
+    case 'm':
+    case 'M':
+        value *= MB;
+        end++;
+        break;
+    case 'g':
+    case 'G':
+        value *= GB;
+        end++;
+        break;
+    default:
+        break;
+    }
+    if (*end || !value)
+        return std::nullopt;
+    return static_cast<size_t>(value);
+}
+
+static std::optional<size_t> s_maxHeapSize;
+
+void configureHeapLimits()
+{
+    size_t memory = constrainedMemory();
+    if (memory < WTF::ramSize()) {
+        // forceRAMSize is 32 bits wide, and a limit that large is not one
+        // the growth policy needs to hear about.
+        if (memory <= std::numeric_limits<unsigned>::max())
+            Options::forceRAMSize() = static_cast<unsigned>(memory);
+    }
+
+    s_maxHeapSize = parseByteSize(getenv("BUN_MAX_HEAP_SIZE"));
+    if (s_maxHeapSize)
+        Options::gcMaxHeapSize() = *s_maxHeapSize;
+}
+
+struct GCController {
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    Zig::GlobalObject* globalObject;
+    MonotonicTime lastIdleCollection;
+    MonotonicTime lastPressureCheck;
+    bool underPressure { false };
+};
+
+static thread_local GCController* s_gcController = nullptr;
+
+static size_t memoryLimit()
+{
+    size_t limit = constrainedMemory();
+    // A heap cap well under the limit should still be noticed, but the
+    // footprint includes more than the heap, so leave room for the rest.
+    if (s_maxHeapSize)
+        limit = std::min(limit, *s_maxHeapSize * 2);
+    return limit;
+}
+
+static void checkMemoryPressure(GCController& controller, MonotonicTime now)
+{
+    if (now - controller.lastPressureCheck < pressureCheckInterval)
+        return;
+    controller.lastPressureCheck = now;
+
+    size_t limit = memoryLimit();
+    size_t footprint = WTF::memoryFootprint();
+    if (controller.underPressure) {
+        if (footprint < limit * pressureReliefThreshold)
+            controller.underPressure = false;
+        return;
+    }
+    if (footprint < limit * pressureThreshold)
+        return;
+    controller.underPressure = true;
+
+    auto* globalObject = controller.globalObject;
+    auto& vm = globalObject->vm();
+    JSLockHolder lock(vm);
+    vm.heap.collectNow(Sync, CollectionScope::Full);
+    controller.lastIdleCollection = now;
+
+    if (!globalObject->hasProcessObject())
+        return;
+    auto* process = jsCast<Process*>(globalObject->processObject());
+    auto ident = Identifier::fromString(vm, "memorypressure"_s);
+    if (!process->wrapped().hasEventListeners(ident))
+        return;
+    MarkedArgumentBuffer args;
+    args.append(jsNumber(WTF::memoryFootprint()));
+    args.append(jsNumber(limit));
+    process->wrapped().emit(ident, args);
+    // The loop is about to sleep, so nothing else would run these.
+    globalObject->drainMicrotasks();
+}
+
+static void onLoopIdle(us_loop_t*)
+{
+    auto* controller = s_gcController;
+    if (!controller)
+        return;
+
+    auto& vm = controller->globalObject->vm();
+    auto now = MonotonicTime::now();
+    if (now - controller->lastIdleCollection >= idleCollectionInterval && vm.heap.totalBytesAllocatedThisCycle() >= idleCollectionThreshold) {
+        controller->lastIdleCollection = now;
+        JSLockHolder lock(vm);
+        vm.heap.collectAsync(CollectionScope::Eden);
+    }
+
+    checkMemoryPressure(*controller, now);
+}
+
+void installGCController(Zig::GlobalObject* globalObject)
+{
+    if (s_gcController)
+        return;
+    s_gcController = new GCController { globalObject, MonotonicTime::now(), MonotonicTime::now() };
+    us_loop_on_idle(uws_get_loop(), onLoopIdle);
+}
+
+}
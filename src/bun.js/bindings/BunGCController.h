@@ -0,0 +1,40 @@
+#pragma once
+
+#include "root.h"
+#include <optional>
+
+namespace Zig {
+class GlobalObject;
+}
+
+namespace Bun {
+
+// Keeps the GC in step with the memory the process may actually use.
+//
+// JSC sizes its heap off the machine's RAM. In a container that is often
+// many times the cgroup's limit, so the heap keeps growing and the kernel
+// OOM-kills the process before the GC sees any pressure. Here three things
+// help:
+//
+// - JSCInitialize gives JSC the cgroup's limit as its RAM size, and
+//   BUN_MAX_HEAP_SIZE (bytes, or with a k, m or g suffix) caps the heap,
+//   like node's --max-old-space-size. BUN_JSC_ options still win.
+// - When the event loop is about to sleep, an eden collection is started if
+//   enough was allocated since the last one, so the work is done while
+//   nothing is waiting on it rather than in the middle of a request.
+// - While idle, the footprint is checked against the limit. Past 85% a full
+//   collection runs and process emits 'memorypressure' (footprint, limit)
+//   so caches can be dropped. It is emitted again only after the footprint
+//   falls below 70%.
+
+// The cgroup memory limit, or the machine's RAM if there is none.
+size_t constrainedMemory();
+
+// Called from JSCInitialize, before options are frozen.
+void configureHeapLimits();
+
+// The event loop of the calling thread runs idle-time collection for this
+// global object.
+void installGCController(Zig::GlobalObject*);
+
+}
@@ -0,0 +1,111 @@
+#include "root.h"
+#include "BunHashMany.h"
+
+#include "BufferConcat.h"
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSArrayBufferView.h>
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
+#include <wtf/NumberOfCores.h>
+#include <wtf/WorkQueue.h>
+
+namespace Bun {
+
+using namespace JSC;
+
+// Below this many bytes in total, waking up worker threads costs more than
+// the hashing.
+static constexpr size_t parallelThreshold = 1 * MB;
+
+static std::optional<std::span<const uint8_t>> messageBytes(JSGlobalObject* globalObject, JSValue value, Vector<CString>& utf8Strings)
+{
+    if (auto* view = jsDynamicCast<JSArrayBufferView*>(value)) {
+        if (view->isDetached())
+            return std::nullopt;
+        return std::span { static_cast<const uint8_t*>(view->vector()), view->byteLength() };
+    }
+    if (auto* arrayBuffer = jsDynamicCast<JSArrayBuffer*>(value)) {
+        if (auto* impl = arrayBuffer->impl())
+            return std::span { static_cast<const uint8_t*>(impl->data()), impl->byteLength() };
+        return std::nullopt;
+    }
+    if (value.isString()) {
+        auto string = value.toWTFString(globalObject);
+        utf8Strings.append(string.utf8());
+        auto& utf8 = utf8Strings.last();
+        return std::span { reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length() };
+    }
+    return std::nullopt;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionSHA256Many, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* array = jsDynamicCast<JSArray*>(callFrame->argument(0));
+    if (UNLIKELY(!array)) {
+        throwTypeError(globalObject, scope, "sha256Many expects an array of Buffers or strings"_s);
+        return {};
+    }
+
+    Vector<CString> utf8Strings;
+    std::optional<std::span<const uint8_t>> key;
+    JSValue keyValue = callFrame->argument(1);
+    if (!keyValue.isUndefinedOrNull()) {
+        key = messageBytes(globalObject, keyValue, utf8Strings);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!key) {
+            throwTypeError(globalObject, scope, "hmacKey must be a Buffer or string"_s);
+            return {};
+        }
+    }
+
+    // The strings' UTF-8 copies live in utf8Strings; the typed arrays are
+    // kept alive by `array`, and no JS runs while they are hashed.
+    unsigned length = array->length();
+    Vector<std::span<const uint8_t>> messages;
+    messages.reserveInitialCapacity(length);
+    size_t totalLength = 0;
+    for (unsigned i = 0; i < length; i++) {
+        JSValue element = BufferConcat::getElement(globalObject, array, i);
+        RETURN_IF_EXCEPTION(scope, {});
+        auto bytes = messageBytes(globalObject, element, utf8Strings);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (UNLIKELY(!bytes)) {
+            throwTypeError(globalObject, scope, "sha256Many expects an array of Buffers or strings"_s);
+            return {};
+        }
+        messages.append(*bytes);
+        totalLength += bytes->size();
+    }
+
+    auto* output = JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint8, false), static_cast<size_t>(length) * SHA256_DIGEST_LENGTH);
+    RETURN_IF_EXCEPTION(scope, {});
+    uint8_t* digests = output->typedVector();
+
+    auto hashRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto message = messages[i];
+            uint8_t* digest = digests + i * SHA256_DIGEST_LENGTH;
+            if (key) {
+                unsigned digestLength;
+                HMAC(EVP_sha256(), key->data(), key->size(), message.data(), message.size(), digest, &digestLength);
+            } else
+                SHA256(message.data(), message.size(), digest);
+        }
+    };
+
+    size_t sliceCount = std::min<size_t>(length, WTF::numberOfProcessorCores());
+    if (totalLength < parallelThreshold || sliceCount < 2)
+        hashRange(0, length);
+    else {
+        WorkQueue::concurrentApply(sliceCount, [&](size_t slice) {
+            hashRange(slice * length / sliceCount, (slice + 1) * length / sliceCount);
+        });
+    }
+
+    return JSValue::encode(output);
+}
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// Bun.hash.sha256Many(messages, hmacKey?): the SHA-256 (or HMAC-SHA256) of
+// each message, packed back to back into one Uint8Array of 32 * N bytes.
+//
+// Messages are Buffers, ArrayBuffers or strings (hashed as UTF-8). The whole
+// batch is one native call, and large batches are spread over the cores.
+JSC_DECLARE_HOST_FUNCTION(jsFunctionSHA256Many);
+
+}
@@ -0,0 +1,316 @@
+#include "root.h"
+#include "BunHeapProfiler.h"
+
+#include <JavaScriptCore/HeapInlines.h>
+#include <JavaScriptCore/SamplingProfiler.h>
+#include <JavaScriptCore/VM.h>
+#include <wtf/Lock.h>
+#include <wtf/Stopwatch.h>
+#include <wtf/Threading.h>
+#include <wtf/WallTime.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
+
+namespace Bun {
+
+using namespace JSC;
+
+// The allocation counter over time, as read by the heap sampler thread.
+class AllocationTimeline : public ThreadSafeRefCounted<AllocationTimeline> {
+public:
+    static Ref<AllocationTimeline> create(VM& vm, Ref<Stopwatch>&& stopwatch) { return adoptRef(*new AllocationTimeline(vm, WTFMove(stopwatch))); }
+
+    struct Point {
+        Seconds time;
+        uint64_t allocatedBytes;
+    };
+
+    void start()
+    {
+        m_thread = Thread::create("Heap Sampler"_s, [protectedThis = Ref { *this }] {
+            while (!protectedThis->m_shouldStop.load(std::memory_order_relaxed)) {
+                protectedThis->record();
+                sleep(1_ms);
+            }
+        });
+    }
+
+    Vector<Point> stop()
+    {
+        m_shouldStop.store(true, std::memory_order_relaxed);
+        if (m_thread)
+            m_thread->waitForCompletion();
+        m_thread = nullptr;
+        record();
+        Locker locker { m_lock };
+        return WTFMove(m_points);
+    }
+
+private:
+    AllocationTimeline(VM& vm, Ref<Stopwatch>&& stopwatch)
+        : m_vm(vm)
+        , m_stopwatch(WTFMove(stopwatch))
+    {
+    }
+
+    void record()
+    {
+        // A racy read of a counter the mutator bumps, which is all this
+        // needs. It starts over from zero after each collection.
+        uint64_t thisCycle = m_vm.heap.totalBytesAllocatedThisCycle();
+        m_allocatedBytes += thisCycle >= m_lastCycleBytes ? thisCycle - m_lastCycleBytes : thisCycle;
+        m_lastCycleBytes = thisCycle;
+
+        Locker locker { m_lock };
+        m_points.append({ m_stopwatch->elapsedTime(), m_allocatedBytes });
+    }
+
+    VM& m_vm;
+    Ref<Stopwatch> m_stopwatch;
+    RefPtr<Thread> m_thread;
+    std::atomic<bool> m_shouldStop { false };
+    uint64_t m_lastCycleBytes { 0 };
+    uint64_t m_allocatedBytes { 0 };
+    Lock m_lock;
+    Vector<Point> m_points WTF_GUARDED_BY_LOCK(m_lock);
+};
+
+struct HeapProfilerState {
+    RefPtr<AllocationTimeline> timeline;
+    size_t sampleInterval { 0 };
+};
+
+// Only the thread running the VM starts and stops it.
+static thread_local HeapProfilerState* s_heapProfiler = nullptr;
+
+void startHeapProfiler(VM& vm, size_t sampleInterval, Seconds stackInterval)
+{
+    if (s_heapProfiler)
+        return;
+
+    auto stopwatch = Stopwatch::create();
+    auto& samplingProfiler = vm.ensureSamplingProfiler(stopwatch.copyRef());
+    samplingProfiler.setTimingInterval(stackInterval);
+    samplingProfiler.noticeCurrentThreadAsJSCExecutionThread();
+    samplingProfiler.start();
+
+    s_heapProfiler = new HeapProfilerState { AllocationTimeline::create(vm, WTFMove(stopwatch)), std::max<size_t>(sampleInterval, 1) };
+    s_heapProfiler->timeline->start();
+}
+
+bool isHeapProfilerRunning(VM&)
+{
+    return s_heapProfiler;
+}
+
+// Just enough of protobuf for profile.proto.
+// https://github.com/google/pprof/blob/main/proto/profile.proto
+class ProtobufWriter {
+public:
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            m_buffer.append(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        m_buffer.append(static_cast<uint8_t>(value));
+    }
+
+    void writeVarintField(unsigned field, uint64_t value)
+    {
+        writeVarint(field << 3);
+        writeVarint(value);
+    }
+
+    void writeBytesField(unsigned field, std::span<const uint8_t> bytes)
+    {
+        writeVarint((field << 3) | 2);
+        writeVarint(bytes.size());
+        m_buffer.append(bytes);
+    }
+
+    void writeMessageField(unsigned field, const ProtobufWriter& message) { writeBytesField(field, message.m_buffer.span()); }
+
+    void writePackedField(unsigned field, const Vector<uint64_t>& values)
+    {
+        ProtobufWriter packed;
+        for (uint64_t value : values)
+            packed.writeVarint(value);
+        writeMessageField(field, packed);
+    }
+
+    Vector<uint8_t> take() { return WTFMove(m_buffer); }
+
+private:
+    Vector<uint8_t> m_buffer;
+};
+
+class HeapProfileBuilder {
+public:
+    HeapProfileBuilder()
+    {
+        m_strings.append(emptyString());
+        m_stringIndices.add(emptyString(), 0);
+    }
+
+    void addSample(VM& vm, SamplingProfiler::StackTrace& stackTrace, uint64_t count)
+    {
+        Vector<uint64_t> locations;
+        // Innermost first, as pprof wants them.
+        for (auto& frame : stackTrace.frames)
+            locations.append(location(frame.displayName(vm), frame.url(), frame.functionStartLine()));
+
+        StringBuilder key;
+        for (uint64_t location : locations)
+            key.append(location, ',');
+        auto result = m_sampleIndices.ensure(key.toString(), [&] {
+            m_samples.append({ WTFMove(locations), 0 });
+            return m_samples.size() - 1;
+        });
+        m_samples[result.iterator->value].count += count;
+    }
+
+    Vector<uint8_t> serialize(size_t sampleInterval, Seconds duration)
+    {
+        ProtobufWriter profile;
+
+        const auto valueType = [&](const String& type, const String& unit) {
+            ProtobufWriter valueType;
+            valueType.writeVarintField(1, string(type));
+            valueType.writeVarintField(2, string(unit));
+            return valueType;
+        };
+
+        // sample_type
+        profile.writeMessageField(1, valueType("samples"_s, "count"_s));
+        profile.writeMessageField(1, valueType("alloc_space"_s, "bytes"_s));
+
+        // sample
+        for (auto& sample : m_samples) {
+            ProtobufWriter message;
+            message.writePackedField(1, sample.locations);
+            message.writePackedField(2, { sample.count, sample.count * sampleInterval });
+            profile.writeMessageField(2, message);
+        }
+
+        // location, one line each
+        for (size_t i = 0; i < m_locations.size(); i++) {
+            ProtobufWriter line;
+            line.writeVarintField(1, m_locations[i].functionId);
+            line.writeVarintField(2, m_locations[i].line);
+            ProtobufWriter message;
+            message.writeVarintField(1, i + 1);
+            message.writeMessageField(4, line);
+            profile.writeMessageField(4, message);
+        }
+
+        // function
+        for (size_t i = 0; i < m_functions.size(); i++) {
+            ProtobufWriter message;
+            message.writeVarintField(1, i + 1);
+            message.writeVarintField(2, m_functions[i].name);
+            message.writeVarintField(4, m_functions[i].filename);
+            message.writeVarintField(5, m_functions[i].startLine);
+            profile.writeMessageField(5, message);
+        }
+
+        auto periodType = valueType("space"_s, "bytes"_s);
+
+        // string_table, after everything that adds to it.
+        for (auto& string : m_strings) {
+            auto utf8 = string.utf8();
+            profile.writeBytesField(6, std::span { reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length() });
+        }
+
+        profile.writeVarintField(9, static_cast<uint64_t>(WallTime::now().secondsSinceEpoch().nanoseconds() - duration.nanoseconds()));
+        profile.writeVarintField(10, static_cast<uint64_t>(duration.nanoseconds()));
+        profile.writeMessageField(11, periodType);
+        profile.writeVarintField(12, sampleInterval);
+        return profile.take();
+    }
+
+private:
+    struct Sample {
+        Vector<uint64_t> locations;
+        uint64_t count;
+    };
+
+    struct Function {
+        uint64_t name;
+        uint64_t filename;
+        uint64_t startLine;
+    };
+
+    struct Location {
+        uint64_t functionId;
+        uint64_t line;
+    };
+
+    uint64_t string(const String& string)
+    {
+        return m_stringIndices.ensure(string, [&] {
+            m_strings.append(string);
+            return m_strings.size() - 1;
+        }).iterator->value;
+    }
+
+    uint64_t location(const String& name, const String& url, int line)
+    {
+        uint64_t lineNumber = std::max(line, 0);
+        StringBuilder key;
+        key.append(lineNumber, '\0', url, '\0', name);
+        return m_locationIds.ensure(key.toString(), [&] {
+            m_functions.append({ string(name), string(url), lineNumber });
+            m_locations.append({ m_functions.size(), lineNumber });
+            return m_locations.size();
+        }).iterator->value;
+    }
+
+    Vector<String> m_strings;
+    HashMap<String, uint64_t> m_stringIndices;
+    Vector<Function> m_functions;
+    Vector<Location> m_locations;
+    HashMap<String, uint64_t> m_locationIds;
+    Vector<Sample> m_samples;
+    HashMap<String, size_t> m_sampleIndices;
+};
+
+std::optional<Vector<uint8_t>> stopHeapProfiler(VM& vm)
+{
+    auto* samplingProfiler = vm.samplingProfiler();
+    if (!s_heapProfiler || !samplingProfiler)
+        return std::nullopt;
+    std::unique_ptr<HeapProfilerState> state { std::exchange(s_heapProfiler, nullptr) };
+
+    JSLockHolder lock(vm);
+    DeferGC deferGC(vm);
+    Vector<SamplingProfiler::StackTrace> stackTraces;
+    {
+        Locker locker { samplingProfiler->getLock() };
+        samplingProfiler->pause();
+        stackTraces = samplingProfiler->releaseStackTraces();
+    }
+    auto timeline = state->timeline->stop();
+
+    // Walk the stacks and the counter together. Each stack gets the
+    // multiples of sampleInterval the counter crossed since the stack before.
+    HeapProfileBuilder builder;
+    size_t point = 0;
+    uint64_t creditedSamples = 0;
+    for (auto& stackTrace : stackTraces) {
+        while (point + 1 < timeline.size() && timeline[point + 1].time <= stackTrace.timestamp)
+            point++;
+        if (timeline.isEmpty())
+            break;
+        uint64_t samples = timeline[point].allocatedBytes / state->sampleInterval;
+        if (samples > creditedSamples) {
+            builder.addSample(vm, stackTrace, samples - creditedSamples);
+            creditedSamples = samples;
+        }
+    }
+
+    Seconds duration = timeline.isEmpty() ? 0_s : timeline.last().time - timeline.first().time;
+    return builder.serialize(state->sampleInterval, duration);
+}
+
+}
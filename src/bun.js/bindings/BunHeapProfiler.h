@@ -0,0 +1,29 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/Vector.h>
+
+namespace Bun {
+
+// A sampling heap profiler: which JS stacks the allocated bytes came from,
+// written as a pprof profile (`go tool pprof`, Speedscope, Pyroscope).
+//
+// JSC has no hook on allocation, so this reads the heap's allocation counter
+// from a thread of its own every millisecond, while the SamplingProfiler
+// records the JS stack every `stackInterval`. For every `sampleInterval`
+// bytes allocated, one sample is credited to the stack that was running when
+// the counter crossed it. Without stopping the process, that finds which
+// code the growth comes from. It is not exact to the allocation: bytes are
+// charged to the stack seen at the end of each stack interval.
+//
+// It shares the VM's SamplingProfiler with the CPU profiler, so only one of
+// the two can run at a time.
+static constexpr size_t defaultHeapProfilerSampleInterval = 512 * 1024;
+static constexpr Seconds defaultHeapProfilerStackInterval = 5_ms;
+
+void startHeapProfiler(JSC::VM&, size_t sampleInterval = defaultHeapProfilerSampleInterval, Seconds stackInterval = defaultHeapProfilerStackInterval);
+bool isHeapProfilerRunning(JSC::VM&);
+// The serialized profile.proto, or std::nullopt if it was not running.
+std::optional<Vector<uint8_t>> stopHeapProfiler(JSC::VM&);
+
+}
@@ -30,6 +30,11 @@
 #include "JSDOMConvert.h"
 #include "wtf/Compiler.h"
 #include "PathInlines.h"
+#include "BufferConcat.h"
+#include "BunHashMany.h"
+#include "EscapeHTML.h"
+#include "Serialization.h"
+#include "Worker.h"
 
 namespace Bun {
 
@@ -71,8 +76,6 @@ static inline JSC::EncodedJSValue flattenArrayOfBuffersIntoArrayBufferOrUint8Arr
     }
 
     size_t byteLength = 0;
-    bool any_buffer = false;
-    bool any_typed = false;
 
     // Use an argument buffer to avoid calling `getIndex` more than once per element.
     // This is a small optimization
@@ -84,7 +87,7 @@ static inline JSC::EncodedJSValue flattenArrayOfBuffersIntoArrayBufferOrUint8Arr
     }
 
     for (size_t i = 0; i < arrayLength; i++) {
-        auto element = array->getIndex(lexicalGlobalObject, i);
+        auto element = BufferConcat::getElement(lexicalGlobalObject, array, i);
         RETURN_IF_EXCEPTION(throwScope, {});
 
         if (auto* typedArray = JSC::jsDynamicCast<JSC::JSArrayBufferView*>(element)) {
@@ -93,7 +96,6 @@ static inline JSC::EncodedJSValue flattenArrayOfBuffersIntoArrayBufferOrUint8Arr
                 return JSValue::encode(jsUndefined());
             }
             size_t current = typedArray->byteLength();
-            any_typed = true;
             byteLength += current;
 
             if (current > 0) {
@@ -107,7 +109,6 @@ static inline JSC::EncodedJSValue flattenArrayOfBuffersIntoArrayBufferOrUint8Arr
             }
 
             size_t current = impl->byteLength();
-            any_buffer = true;
 
             if (current > 0) {
                 args.append(arrayBuffer);
@@ -132,47 +133,25 @@ static inline JSC::EncodedJSValue flattenArrayOfBuffersIntoArrayBufferOrUint8Arr
     }
 
     size_t remain = byteLength;
-    auto* head = reinterpret_cast<char*>(buffer->data());
-
-    if (!any_buffer) {
-        for (size_t i = 0; i < args.size(); i++) {
-            auto element = args.at(i);
-            RETURN_IF_EXCEPTION(throwScope, {});
+    Vector<std::span<const uint8_t>, 16> segments;
+    segments.reserveInitialCapacity(args.size());
+    for (size_t i = 0; i < args.size() && remain > 0; i++) {
+        auto element = args.at(i);
+        std::span<const uint8_t> segment;
+        if (auto* arrayBuffer = JSC::jsDynamicCast<JSC::JSArrayBuffer*>(element)) {
+            segment = { static_cast<const uint8_t*>(arrayBuffer->impl()->data()), arrayBuffer->impl()->byteLength() };
+        } else {
             auto* view = JSC::jsCast<JSC::JSArrayBufferView*>(element);
-            size_t length = std::min(remain, view->byteLength());
-            memcpy(head, view->vector(), length);
-            remain -= length;
-            head += length;
+            segment = { static_cast<const uint8_t*>(view->vector()), view->byteLength() };
         }
-    } else if (!any_typed) {
-        for (size_t i = 0; i < args.size(); i++) {
-            auto element = args.at(i);
-            RETURN_IF_EXCEPTION(throwScope, {});
-            auto* view = JSC::jsCast<JSC::JSArrayBuffer*>(element);
-            size_t length = std::min(remain, view->impl()->byteLength());
-            memcpy(head, view->impl()->data(), length);
-            remain -= length;
-            head += length;
-        }
-    } else {
-        for (size_t i = 0; i < args.size(); i++) {
-            auto element = args.at(i);
-            RETURN_IF_EXCEPTION(throwScope, {});
-            size_t length = 0;
-            if (auto* view = JSC::jsDynamicCast<JSC::JSArrayBuffer*>(element)) {
-                length = std::min(remain, view->impl()->byteLength());
-                memcpy(head, view->impl()->data(), length);
-            } else {
-                auto* typedArray = JSC::jsCast<JSC::JSArrayBufferView*>(element);
-                length = std::min(remain, typedArray->byteLength());
-                memcpy(head, typedArray->vector(), length);
-            }
 
-            remain -= length;
-            head += length;
-        }
+        segment = segment.first(std::min(remain, segment.size()));
+        segments.append(segment);
+        remain -= segment.size();
     }
 
+    BufferConcat::copySegments(static_cast<uint8_t*>(buffer->data()), std::span { segments.data(), segments.size() }, byteLength - remain);
+
     if (asUint8Array) {
         auto uint8array = JSC::JSUint8Array::create(lexicalGlobalObject, lexicalGlobalObject->m_typedArrayUint8.get(lexicalGlobalObject), WTFMove(buffer), 0, byteLength);
         return JSValue::encode(uint8array);
@@ -370,9 +349,6 @@ JSC_DEFINE_HOST_FUNCTION(functionBunSleep,
     return JSC::JSValue::encode(promise);
 }
 
-extern "C" JSC::EncodedJSValue Bun__escapeHTML8(JSGlobalObject* globalObject, JSC::EncodedJSValue input, const LChar* ptr, size_t length);
-extern "C" JSC::EncodedJSValue Bun__escapeHTML16(JSGlobalObject* globalObject, JSC::EncodedJSValue input, const UChar* ptr, size_t length);
-
 JSC_DEFINE_HOST_FUNCTION(functionBunEscapeHTML, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
     JSC::VM& vm = JSC::getVM(lexicalGlobalObject);
@@ -385,19 +361,23 @@ JSC_DEFINE_HOST_FUNCTION(functionBunEscapeHTML, (JSC::JSGlobalObject * lexicalGl
     auto scope = DECLARE_THROW_SCOPE(vm);
     auto string = argument.toString(lexicalGlobalObject);
     RETURN_IF_EXCEPTION(scope, {});
-    size_t length = string->length();
-    if (!length)
+    if (!string->length())
         RELEASE_AND_RETURN(scope, JSValue::encode(string));
 
-    auto resolvedString = string->value(lexicalGlobalObject);
-    JSC::EncodedJSValue encodedInput = JSValue::encode(string);
-    if (!resolvedString.is8Bit()) {
-        const auto span = resolvedString.span16();
-        RELEASE_AND_RETURN(scope, Bun__escapeHTML16(lexicalGlobalObject, encodedInput, span.data(), span.size()));
-    } else {
-        const auto span = resolvedString.span8();
-        RELEASE_AND_RETURN(scope, Bun__escapeHTML8(lexicalGlobalObject, encodedInput, span.data(), span.size()));
-    }
+    RELEASE_AND_RETURN(scope, JSValue::encode(Bun::escapeHTML(lexicalGlobalObject, string)));
+}
+
+JSC_DEFINE_JIT_OPERATION(functionBunEscapeHTMLWithoutTypeCheck, JSC::EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSObject* castedThis, JSString* string))
+{
+    JSC::VM& vm = JSC::getVM(lexicalGlobalObject);
+    IGNORE_WARNINGS_BEGIN("frame-address")
+    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
+    IGNORE_WARNINGS_END
+    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+    if (!string->length())
+        return JSValue::encode(string);
+
+    return JSValue::encode(Bun::escapeHTML(lexicalGlobalObject, string));
 }
 
 JSC_DEFINE_HOST_FUNCTION(functionBunDeepEquals, (JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
@@ -530,6 +510,7 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     FFI                                            BunObject_getter_wrap_FFI                                           DontDelete|PropertyCallback
     FileSystemRouter                               BunObject_getter_wrap_FileSystemRouter                              DontDelete|PropertyCallback
     Glob                                           BunObject_getter_wrap_Glob                                          DontDelete|PropertyCallback
+    Logger                                         constructLoggerConstructor                                          DontDelete|PropertyCallback
     MD4                                            BunObject_getter_wrap_MD4                                           DontDelete|PropertyCallback
     MD5                                            BunObject_getter_wrap_MD5                                           DontDelete|PropertyCallback
     SHA1                                           BunObject_getter_wrap_SHA1                                          DontDelete|PropertyCallback
@@ -538,8 +519,10 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     SHA384                                         BunObject_getter_wrap_SHA384                                        DontDelete|PropertyCallback
     SHA512                                         BunObject_getter_wrap_SHA512                                        DontDelete|PropertyCallback
     SHA512_256                                     BunObject_getter_wrap_SHA512_256                                    DontDelete|PropertyCallback
+    SharedRing                                     constructSharedRingConstructor                                      DontDelete|PropertyCallback
     TOML                                           BunObject_getter_wrap_TOML                                          DontDelete|PropertyCallback
     Transpiler                                     BunObject_getter_wrap_Transpiler                                    DontDelete|PropertyCallback
+    WorkerPool                                     constructWorkerPoolConstructor                                      DontDelete|PropertyCallback
     allocUnsafe                                    BunObject_callback_allocUnsafe                                      DontDelete|Function 1
     argv                                           BunObject_getter_wrap_argv                                          DontDelete|PropertyCallback
     build                                          BunObject_callback_build                                            DontDelete|Function 1
@@ -549,10 +532,11 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     deepEquals                                     functionBunDeepEquals                                               DontDelete|Function 2
     deepMatch                                      functionBunDeepMatch                                                DontDelete|Function 2
     deflateSync                                    BunObject_callback_deflateSync                                      DontDelete|Function 1
+    deserialize                                    functionBunDeserialize                                              DontDelete|Function 1
     dns                                            constructDNSObject                                                  ReadOnly|DontDelete|PropertyCallback
     enableANSIColors                               BunObject_getter_wrap_enableANSIColors                              DontDelete|PropertyCallback
     env                                            constructEnvObject                                                  ReadOnly|DontDelete|PropertyCallback
-    escapeHTML                                     functionBunEscapeHTML                                               DontDelete|Function 2
+    escapeHTML                                     constructBunEscapeHTMLFunction                                      DontDelete|PropertyCallback
     fetch                                          Bun__fetch                                                          ReadOnly|DontDelete|Function 1
     file                                           BunObject_callback_file                                             DontDelete|Function 1
     fileURLToPath                                  functionFileURLToPath                                               DontDelete|Function 1
@@ -560,7 +544,7 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     generateHeapSnapshot                           BunObject_callback_generateHeapSnapshot                             DontDelete|Function 1
     gunzipSync                                     BunObject_callback_gunzipSync                                       DontDelete|Function 1
     gzipSync                                       BunObject_callback_gzipSync                                         DontDelete|Function 1
-    hash                                           BunObject_getter_wrap_hash                                          DontDelete|PropertyCallback
+    hash                                           constructBunHashObject                                              DontDelete|PropertyCallback
     indexOfLine                                    BunObject_callback_indexOfLine                                      DontDelete|Function 1
     inflateSync                                    BunObject_callback_inflateSync                                      DontDelete|Function 1
     inspect                                        BunObject_getter_wrap_inspect                                       DontDelete|PropertyCallback
@@ -571,12 +555,14 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     main                                           BunObject_getter_wrap_main                                          DontDelete|PropertyCallback
     mmap                                           BunObject_callback_mmap                                             DontDelete|Function 1
     nanoseconds                                    functionBunNanoseconds                                              DontDelete|Function 0
+    nowISO                                         functionBunNowISO                                                   DontDelete|Function 0
     openInEditor                                   BunObject_callback_openInEditor                                     DontDelete|Function 1
     origin                                         BunObject_getter_wrap_origin                                        DontDelete|PropertyCallback
     password                                       constructPasswordObject                                             DontDelete|PropertyCallback
     pathToFileURL                                  functionPathToFileURL                                               DontDelete|Function 1
     peek                                           constructBunPeekObject                                              DontDelete|PropertyCallback
     plugin                                         constructPluginObject                                               ReadOnly|DontDelete|PropertyCallback
+    prewarmWorkers                                 jsFunctionPrewarmWorkers                                            DontDelete|Function 1
     readableStreamToArray                          JSBuiltin                                                           Builtin|Function 1
     readableStreamToArrayBuffer                    JSBuiltin                                                           Builtin|Function 1
     readableStreamToBytes                          JSBuiltin                                                           Builtin|Function 1
@@ -589,6 +575,7 @@ JSC_DEFINE_HOST_FUNCTION(functionFileURLToPath, (JSC::JSGlobalObject * globalObj
     resolveSync                                    BunObject_callback_resolveSync                                      DontDelete|Function 1
     revision                                       constructBunRevision                                                ReadOnly|DontDelete|PropertyCallback
     semver                                         BunObject_getter_wrap_semver                                        ReadOnly|DontDelete|PropertyCallback
+    serialize                                      functionBunSerialize                                                DontDelete|Function 2
     serve                                          BunObject_callback_serve                                            DontDelete|Function 1
     sha                                            BunObject_callback_sha                                              DontDelete|Function 1
     shrink                                         BunObject_callback_shrink                                           DontDelete|Function 1
@@ -647,6 +634,49 @@ public:
     }
 };
 
+static const JSC::DOMJIT::Signature DOMJITSignatureForBunEscapeHTML(
+    functionBunEscapeHTMLWithoutTypeCheck,
+    JSBunObject::info(),
+    JSC::DOMJIT::Effect {},
+    WebCore::DOMJIT::IDLResultTypeFilter<IDLDOMString>::value,
+    WebCore::DOMJIT::IDLArgumentTypeFilter<IDLDOMString>::value);
+
+// Bun.escapeHTML(string) from optimized code calls straight into the
+// string overload instead of going through the generic host function.
+static JSValue constructBunEscapeHTMLFunction(VM& vm, JSObject* bunObject)
+{
+    return JSFunction::create(vm, bunObject->globalObject(), 2, "escapeHTML"_s,
+        functionBunEscapeHTML, ImplementationVisibility::Public, NoIntrinsic, functionBunEscapeHTML,
+        &DOMJITSignatureForBunEscapeHTML);
+}
+
+// Bun.hash comes from Zig; the batch hashers are native and hung off it here.
+static JSValue constructBunHashObject(VM& vm, JSObject* bunObject)
+{
+    JSValue hash = BunObject_getter_wrap_hash(vm, bunObject);
+    if (auto* object = hash.getObject()) {
+        object->putDirect(vm, Identifier::fromString(vm, "sha256Many"_s),
+            JSFunction::create(vm, bunObject->globalObject(), 2, "sha256Many"_s, jsFunctionSHA256Many, ImplementationVisibility::Public),
+            PropertyAttribute::DontDelete | 0);
+    }
+    return hash;
+}
+
+static JSValue constructLoggerConstructor(VM&, JSObject* bunObject)
+{
+    return jsCast<Zig::GlobalObject*>(bunObject->globalObject())->JSLogger();
+}
+
+static JSValue constructSharedRingConstructor(VM&, JSObject* bunObject)
+{
+    return jsCast<Zig::GlobalObject*>(bunObject->globalObject())->JSSharedRing();
+}
+
+static JSValue constructWorkerPoolConstructor(VM&, JSObject* bunObject)
+{
+    return jsCast<Zig::GlobalObject*>(bunObject->globalObject())->JSWorkerPool();
+}
+
 #define bunObjectReadableStreamToArrayCodeGenerator WebCore::readableStreamReadableStreamToArrayCodeGenerator
 #define bunObjectReadableStreamToArrayBufferCodeGenerator WebCore::readableStreamReadableStreamToArrayBufferCodeGenerator
 #define bunObjectReadableStreamToBytesCodeGenerator WebCore::readableStreamReadableStreamToBytesCodeGenerator
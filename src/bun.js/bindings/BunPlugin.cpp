@@ -351,6 +351,7 @@ extern "C" JSC::EncodedJSValue jsFunctionBunPlugin(JSC::JSGlobalObject* globalOb
 void BunPlugin::Group::append(JSC::VM& vm, JSC::RegExp* filter, JSC::JSFunction* func)
 {
     filters.append(JSC::Strong<JSC::RegExp> { vm, filter });
+    affixes.append(Bun::PluginFilterAffixes(StringView(filter->pattern()), filter->flags()));
     callbacks.append(JSC::Strong<JSC::JSFunction> { vm, func });
 }
 
@@ -372,7 +373,7 @@ JSFunction* BunPlugin::Group::find(JSC::JSGlobalObject* globalObject, String& pa
 {
     size_t count = filters.size();
     for (size_t i = 0; i < count; i++) {
-        if (filters[i].get()->match(globalObject, path, 0)) {
+        if (affixes[i].mayMatch(path) && filters[i].get()->match(globalObject, path, 0)) {
             return callbacks[i].get();
         }
     }
@@ -782,10 +783,11 @@ EncodedJSValue BunPlugin::OnResolve::run(JSC::JSGlobalObject* globalObject, BunS
     }
 
     auto& callbacks = group.callbacks;
+    auto& affixes = group.affixes;
 
     WTF::String pathString = path->toWTFString(BunString::ZeroCopy);
     for (size_t i = 0; i < filters.size(); i++) {
-        if (!filters[i].get()->match(globalObject, pathString, 0)) {
+        if (!affixes[i].mayMatch(pathString) || !filters[i].get()->match(globalObject, pathString, 0)) {
             continue;
         }
         JSC::JSFunction* function = callbacks[i].get();
@@ -5,6 +5,7 @@
 #include <JavaScriptCore/JSGlobalObject.h>
 #include <JavaScriptCore/Strong.h>
 #include "helpers.h"
+#include "PluginFilter.h"
 
 extern "C" JSC_DECLARE_HOST_FUNCTION(jsFunctionBunPlugin);
 extern "C" JSC_DECLARE_HOST_FUNCTION(jsFunctionBunPluginClear);
@@ -25,6 +26,8 @@ public:
         // We want JIT!
         // TODO: evaluate if using JSInternalFieldImpl(2) is faster
         Vector<JSC::Strong<JSC::RegExp>> filters = {};
+        // Checked before each filter, so most paths never reach Yarr.
+        Vector<Bun::PluginFilterAffixes> affixes = {};
         Vector<JSC::Strong<JSC::JSFunction>> callbacks = {};
         BunPluginTarget target { BunPluginTargetBun };
 
@@ -33,6 +36,7 @@ public:
         void clear()
         {
             filters.clear();
+            affixes.clear();
             callbacks.clear();
         }
     };
@@ -58,6 +62,8 @@ public:
             return nullptr;
         }
 
+        bool isEmpty() const { return fileNamespace.callbacks.isEmpty() && groups.isEmpty(); }
+
         void append(JSC::VM& vm, JSC::RegExp* filter, JSC::JSFunction* func, String& namespaceString);
     };
 
@@ -14,6 +14,7 @@
 #include "headers-handwritten.h"
 #include "node_api.h"
 #include "ZigGlobalObject.h"
+#include "BunClientData.h"
 #include "headers.h"
 #include "JSEnvironmentVariableMap.h"
 #include "ImportMetaObject.h"
@@ -48,6 +49,11 @@
 typedef int mode_t;
 #endif
 #include "JSNextTickQueue.h"
+#include "BunGCController.h"
+#include "MemoryAccounting.h"
+#include "libusockets.h"
+#include "_libusockets.h"
+#include <wtf/MemoryFootprint.h>
 #include "ProcessBindingUV.h"
 #include "ProcessBindingNatives.h"
 
@@ -73,6 +79,14 @@ typedef int mode_t;
 #include <unistd.h> // setuid, getuid
 #endif
 
+namespace WebCore {
+size_t sqlitePageCacheMemory();
+}
+
+namespace Napi {
+napi_module* takeRegisteredModule();
+}
+
 namespace Bun {
 
 using namespace JSC;
@@ -256,6 +270,49 @@ extern "C" bool Bun__resolveEmbeddedNodeFile(void*, BunString*);
 extern "C" HMODULE Bun__LoadLibraryBunString(BunString*);
 #endif
 
+using NapiRegisterModuleV1 = JSC::EncodedJSValue (*)(JSC::JSGlobalObject*, JSC::EncodedJSValue);
+
+// A .node file stays loaded for the life of the process, and loading it
+// again returns the same handle without running its static constructors.
+// Older addons call napi_module_register() from one of those, so a Worker,
+// or a require() after the cache was cleared, would find nothing to
+// register. The first load of each path is kept here: later loads skip
+// dlopen() and dlsym() and register the module again on their own global.
+struct NativeAddon {
+    void* handle { nullptr };
+    napi_module* module { nullptr };
+    NapiRegisterModuleV1 registerModule { nullptr };
+    // Of the first load, from dlopen() to the end of registration.
+    Seconds loadTime;
+    unsigned loads { 0 };
+};
+
+static Lock s_nativeAddonsLock;
+
+static HashMap<String, NativeAddon>& nativeAddons() WTF_REQUIRES_LOCK(s_nativeAddonsLock)
+{
+    static NeverDestroyed<HashMap<String, NativeAddon>> addons;
+    return addons;
+}
+
+static void rememberNativeAddon(const String& path, NativeAddon addon, MonotonicTime loadStart)
+{
+    Locker locker { s_nativeAddonsLock };
+    auto result = nativeAddons().add(path.isolatedCopy(), addon);
+    if (result.isNewEntry)
+        result.iterator->value.loadTime = MonotonicTime::now() - loadStart;
+    result.iterator->value.loads++;
+}
+
+Vector<NativeAddonLoad> nativeAddonLoads()
+{
+    Locker locker { s_nativeAddonsLock };
+    Vector<NativeAddonLoad> loads;
+    for (auto& entry : nativeAddons())
+        loads.append({ entry.key.isolatedCopy(), entry.value.loadTime, entry.value.loads });
+    return loads;
+}
+
 JSC_DEFINE_HOST_FUNCTION(Process_functionDlopen,
     (JSC::JSGlobalObject * globalObject_, JSC::CallFrame* callFrame))
 {
@@ -325,35 +382,68 @@ JSC_DEFINE_HOST_FUNCTION(Process_functionDlopen,
     }
 
     RETURN_IF_EXCEPTION(scope, {});
+
+    auto loadStart = MonotonicTime::now();
+    NativeAddon addon;
+    {
+        Locker locker { s_nativeAddonsLock };
+        auto it = nativeAddons().find(filename);
+        if (it != nativeAddons().end())
+            addon = it->value;
+    }
+    bool wasLoaded = !!addon.handle;
+
+    if (!wasLoaded) {
 #if OS(WINDOWS)
-    BunString filename_str = Bun::toString(filename);
-    HMODULE handle = Bun__LoadLibraryBunString(&filename_str);
+        BunString filename_str = Bun::toString(filename);
+        HMODULE handle = Bun__LoadLibraryBunString(&filename_str);
 #else
-    CString utf8 = filename.utf8();
-    void* handle = dlopen(utf8.data(), RTLD_LAZY);
+        CString utf8 = filename.utf8();
+        void* handle = dlopen(utf8.data(), RTLD_LAZY);
 #endif
 
-    if (!handle) {
+        if (!handle) {
 #if OS(WINDOWS)
-        DWORD errorId = GetLastError();
-        LPWSTR messageBuffer = nullptr;
-        size_t size = FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-            NULL, errorId, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPWSTR)&messageBuffer, 0, NULL);
-        WTF::String msg = makeString("LoadLibrary failed: ", WTF::StringView(std::span { (UCHAR*)messageBuffer, size }));
-        LocalFree(messageBuffer);
+            DWORD errorId = GetLastError();
+            LPWSTR messageBuffer = nullptr;
+            size_t size = FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                NULL, errorId, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPWSTR)&messageBuffer, 0, NULL);
+            WTF::String msg = makeString("LoadLibrary failed: ", WTF::StringView(std::span { (UCHAR*)messageBuffer, size }));
+            LocalFree(messageBuffer);
 #else
-        WTF::String msg = WTF::String::fromUTF8(dlerror());
+            WTF::String msg = WTF::String::fromUTF8(dlerror());
 #endif
-        JSC::throwTypeError(globalObject, scope, msg);
-        return JSC::JSValue::encode(JSC::JSValue {});
+            JSC::throwTypeError(globalObject, scope, msg);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+
+        addon.handle = reinterpret_cast<void*>(handle);
+        if (callCountAtStart != globalObject->napiModuleRegisterCallCount) {
+            addon.module = Napi::takeRegisteredModule();
+        } else {
+            // The same file under another path, like through a symlink.
+            Locker locker { s_nativeAddonsLock };
+            for (auto& entry : nativeAddons()) {
+                if (entry.value.handle == addon.handle) {
+                    addon.module = entry.value.module;
+                    addon.registerModule = entry.value.registerModule;
+                    wasLoaded = true;
+                    break;
+                }
+            }
+        }
     }
 
+    if (wasLoaded && addon.module)
+        napi_module_register(addon.module);
+
     if (callCountAtStart != globalObject->napiModuleRegisterCallCount) {
         JSValue resultValue = globalObject->pendingNapiModule;
         globalObject->pendingNapiModule = JSValue {};
         globalObject->napiModuleRegisterCallCount = 0;
 
         RETURN_IF_EXCEPTION(scope, {});
+        rememberNativeAddon(filename, addon, loadStart);
 
         if (resultValue && resultValue != strongModule.get()) {
             if (resultValue.isCell() && resultValue.getObject()->isErrorInstance()) {
@@ -365,34 +455,40 @@ JSC_DEFINE_HOST_FUNCTION(Process_functionDlopen,
         return JSValue::encode(jsUndefined());
     }
 
-    JSC::EncodedJSValue (*napi_register_module_v1)(JSC::JSGlobalObject* globalObject,
-        JSC::EncodedJSValue exports);
 #if OS(WINDOWS)
 #define dlsym GetProcAddress
 #endif
 
-    napi_register_module_v1 = reinterpret_cast<JSC::EncodedJSValue (*)(JSC::JSGlobalObject*,
-        JSC::EncodedJSValue)>(
-        dlsym(handle, "napi_register_module_v1"));
+    if (!addon.registerModule) {
+        addon.registerModule = reinterpret_cast<NapiRegisterModuleV1>(
+#if OS(WINDOWS)
+            dlsym(reinterpret_cast<HMODULE>(addon.handle), "napi_register_module_v1"));
+#else
+            dlsym(addon.handle, "napi_register_module_v1"));
+#endif
+    }
 
 #if OS(WINDOWS)
 #undef dlsym
 #endif
 
-    if (!napi_register_module_v1) {
+    if (!addon.registerModule) {
+        if (!wasLoaded) {
 #if OS(WINDOWS)
-        FreeLibrary(handle);
+            FreeLibrary(reinterpret_cast<HMODULE>(addon.handle));
 #else
-        dlclose(handle);
+            dlclose(addon.handle);
 #endif
+        }
         JSC::throwTypeError(globalObject, scope, "symbol 'napi_register_module_v1' not found in native module. Is this a Node API (napi) module?"_s);
         return JSC::JSValue::encode(JSC::JSValue {});
     }
 
     EncodedJSValue exportsValue = JSC::JSValue::encode(exports);
-    JSC::JSValue resultValue = JSValue::decode(napi_register_module_v1(globalObject, exportsValue));
+    JSC::JSValue resultValue = JSValue::decode(addon.registerModule(globalObject, exportsValue));
 
     RETURN_IF_EXCEPTION(scope, {});
+    rememberNativeAddon(filename, addon, loadStart);
 
     // https://github.com/nodejs/node/blob/2eff28fb7a93d3f672f80b582f664a7c701569fb/src/node_api.cc#L734-L742
     // https://github.com/oven-sh/bun/issues/1288
@@ -1494,9 +1590,7 @@ static JSValue constructReportObjectComplete(VM& vm, Zig::GlobalObject* globalOb
         }
 
         double time = WTF::jsCurrentTime();
-        char timeBuf[64] = { 0 };
-        Bun::toISOString(vm, time, timeBuf);
-        auto timeStamp = WTF::String::fromLatin1(timeBuf);
+        auto timeStamp = WebCore::clientData(vm)->timestampCache.iso(vm, time);
 
         header->putDirect(vm, JSC::Identifier::fromString(vm, "dumpEventTime"_s), JSC::numberToString(vm, time, 10), 0);
         header->putDirect(vm, JSC::Identifier::fromString(vm, "dumpEventTimeStamp"_s), JSC::jsString(vm, timeStamp, 0));
@@ -1583,6 +1677,27 @@ static JSValue constructReportObjectComplete(VM& vm, Zig::GlobalObject* globalOb
         return heap;
     };
 
+    // Not part of node's report: where memory outside the JS heap went.
+    // The socket and backpressure buffers are this thread's only.
+    auto constructMemory = [&]() -> JSC::JSValue {
+        JSC::JSObject* memory = JSC::constructEmptyObject(globalObject, globalObject->objectPrototype(), 10);
+        const auto put = [&](ASCIILiteral name, size_t bytes) {
+            memory->putDirect(vm, JSC::Identifier::fromString(vm, name), JSC::jsDoubleNumber(static_cast<double>(bytes)), 0);
+        };
+
+        put("rss"_s, WTF::memoryFootprint());
+        put("javascriptHeap"_s, vm.heap.size());
+        put("javascriptExternal"_s, vm.heap.externalMemorySize());
+        put("socketBuffers"_s, us_loop_buffer_memory(uws_get_loop()));
+        put("backpressure"_s, uws_backpressure_memory());
+        put("sqlitePageCache"_s, WebCore::sqlitePageCacheMemory());
+        put("messagePortMessages"_s, Bun::memoryInUse(Bun::MemorySubsystem::MessagePortMessages));
+        put("moduleSources"_s, Bun::memoryInUse(Bun::MemorySubsystem::ModuleSources));
+        put("napiExternalMemory"_s, Bun::memoryInUse(Bun::MemorySubsystem::NapiExternalMemory));
+
+        return memory;
+    };
+
     auto constructUVThreadResourceUsage = [&]() -> JSC::JSValue {
         JSC::JSObject* uvthreadResourceUsage = JSC::constructEmptyObject(globalObject, globalObject->objectPrototype(), 6);
 
@@ -1645,7 +1760,10 @@ static JSValue constructReportObjectComplete(VM& vm, Zig::GlobalObject* globalOb
     auto constructSharedObjects = [&]() -> JSC::JSValue {
         JSC::JSObject* sharedObjects = JSC::constructEmptyArray(globalObject, nullptr);
 
-        // TODO:
+        // TODO: everything else the process has mapped, not only addons.
+        unsigned index = 0;
+        for (auto& load : nativeAddonLoads())
+            sharedObjects->putDirectIndex(globalObject, index++, JSC::jsString(vm, load.path));
 
         return sharedObjects;
     };
@@ -1695,11 +1813,12 @@ static JSValue constructReportObjectComplete(VM& vm, Zig::GlobalObject* globalOb
     };
 
     {
-        JSC::JSObject* report = JSC::constructEmptyObject(globalObject, globalObject->objectPrototype(), 19);
+        JSC::JSObject* report = JSC::constructEmptyObject(globalObject, globalObject->objectPrototype(), 20);
 
         report->putDirect(vm, JSC::Identifier::fromString(vm, "header"_s), constructHeader(), 0);
         report->putDirect(vm, JSC::Identifier::fromString(vm, "javascriptStack"_s), constructJavaScriptStack(), 0);
         report->putDirect(vm, JSC::Identifier::fromString(vm, "javascriptHeap"_s), constructJavaScriptHeap(), 0);
+        report->putDirect(vm, JSC::Identifier::fromString(vm, "memory"_s), constructMemory(), 0);
         report->putDirect(vm, JSC::Identifier::fromString(vm, "nativeStack"_s), constructNativeStack(), 0);
         report->putDirect(vm, JSC::Identifier::fromString(vm, "resourceUsage"_s), constructResourceUsage(), 0);
         report->putDirect(vm, JSC::Identifier::fromString(vm, "uvthreadResourceUsage"_s), constructUVThreadResourceUsage(), 0);
@@ -2245,7 +2364,7 @@ JSC_DEFINE_HOST_FUNCTION(Process_functionConstrainedMemory,
     (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
 #if OS(LINUX) || OS(FREEBSD)
-    return JSValue::encode(jsDoubleNumber(static_cast<double>(WTF::ramSize())));
+    return JSValue::encode(jsDoubleNumber(static_cast<double>(Bun::constrainedMemory())));
 #else
     return JSValue::encode(jsUndefined());
 #endif
@@ -2546,40 +2665,14 @@ static JSValue constructMemoryUsage(VM& vm, JSObject* processObject)
     return memoryUsage;
 }
 
-JSC_DEFINE_HOST_FUNCTION(jsFunctionReportUncaughtException, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
-{
-    JSValue arg0 = callFrame->argument(0);
-    Bun__reportUnhandledError(globalObject, JSValue::encode(arg0));
-    return JSValue::encode(jsUndefined());
-}
-
-JSC_DEFINE_HOST_FUNCTION(jsFunctionDrainMicrotaskQueue, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
-{
-    globalObject->vm().drainMicrotasks();
-    return JSValue::encode(jsUndefined());
-}
-
 static JSValue constructProcessNextTickFn(VM& vm, JSObject* processObject)
 {
     JSGlobalObject* lexicalGlobalObject = processObject->globalObject();
     Zig::GlobalObject* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
-    JSValue nextTickQueueObject;
-    if (!globalObject->m_nextTickQueue) {
-        nextTickQueueObject = Bun::JSNextTickQueue::create(globalObject);
-        globalObject->m_nextTickQueue.set(vm, globalObject, nextTickQueueObject);
-    } else {
-        nextTickQueueObject = jsCast<Bun::JSNextTickQueue*>(globalObject->m_nextTickQueue.get());
-    }
-
-    JSC::JSFunction* initializer = JSC::JSFunction::create(vm, processObjectInternalsInitializeNextTickQueueCodeGenerator(vm), lexicalGlobalObject);
-
-    JSC::MarkedArgumentBuffer args;
-    args.append(processObject);
-    args.append(nextTickQueueObject);
-    args.append(JSC::JSFunction::create(vm, globalObject, 1, String(), jsFunctionDrainMicrotaskQueue, ImplementationVisibility::Private));
-    args.append(JSC::JSFunction::create(vm, globalObject, 1, String(), jsFunctionReportUncaughtException, ImplementationVisibility::Private));
+    if (!globalObject->m_nextTickQueue)
+        globalObject->m_nextTickQueue.set(vm, globalObject, Bun::JSNextTickQueue::create(globalObject));
 
-    return JSC::call(globalObject, initializer, JSC::getCallData(initializer), globalObject->globalThis(), args);
+    return JSC::JSFunction::create(vm, globalObject, 1, String("nextTick"_s), Bun::jsFunctionNextTick, ImplementationVisibility::Public);
 }
 
 static JSValue constructFeatures(VM& vm, JSObject* processObject)
@@ -11,6 +11,16 @@ namespace Bun {
 // TODO: find a better place for this
 int getRSS(size_t* rss);
 
+// A .node file loaded by process.dlopen(), for startup profiling.
+struct NativeAddonLoad {
+    String path;
+    // How long the first load took, registration included.
+    Seconds loadTime;
+    unsigned loads;
+};
+
+Vector<NativeAddonLoad> nativeAddonLoads();
+
 using namespace JSC;
 
 class Process : public WebCore::JSEventEmitter {
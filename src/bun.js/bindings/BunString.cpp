@@ -8,6 +8,7 @@
 #include "JavaScriptCore/PutPropertySlot.h"
 
 #include "simdutf.h"
+#include "AtomStringCache.h"
 #include "JSDOMURL.h"
 #include "DOMURL.h"
 #include "ZigGlobalObject.h"
@@ -61,10 +62,17 @@ extern "C" bool BunString__fromJS(JSC::JSGlobalObject* globalObject, JSC::Encode
     return bunString->tag != BunStringTag::Dead;
 }
 
+static AtomString makeASCIIAtom(const char* bytes, size_t length)
+{
+    if (auto* cache = Bun::AtomStringCache::current())
+        return cache->make({ reinterpret_cast<const LChar*>(bytes), length });
+    return tryMakeAtomString(String(StringImpl::createWithoutCopying({ bytes, length })));
+}
+
 extern "C" BunString BunString__createAtom(const char* bytes, size_t length)
 {
     ASSERT(simdutf::validate_ascii(bytes, length));
-    auto atom = tryMakeAtomString(String(StringImpl::createWithoutCopying({ bytes, length })));
+    auto atom = makeASCIIAtom(bytes, length);
     atom.impl()->ref();
     return { BunStringTag::WTFStringImpl, { .wtf = atom.impl() } };
 }
@@ -72,7 +80,7 @@ extern "C" BunString BunString__createAtom(const char* bytes, size_t length)
 extern "C" BunString BunString__tryCreateAtom(const char* bytes, size_t length)
 {
     if (simdutf::validate_ascii(bytes, length)) {
-        auto atom = tryMakeAtomString(String(StringImpl::createWithoutCopying({ bytes, length })));
+        auto atom = makeASCIIAtom(bytes, length);
         if (atom.isNull())
             return { BunStringTag::Dead, {} };
         atom.impl()->ref();
@@ -0,0 +1,446 @@
+#include "root.h"
+#include "CipherStreams.h"
+
+#include "webcrypto/CryptoKeyAES.h"
+#include "webcrypto/JSCryptoKey.h"
+#include "webcrypto/OpenSSLCryptoUniquePtr.h"
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSArrayBufferView.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/ObjectConstructor.h>
+#include <openssl/evp.h>
+
+namespace Bun {
+
+using namespace JSC;
+using namespace WebCore;
+
+static constexpr uint8_t maximumTagLength = 16;
+
+static const EVP_CIPHER* aesGCMAlgorithm(size_t keySize)
+{
+    if (keySize * 8 == 128)
+        return EVP_aes_128_gcm();
+
+    if (keySize * 8 == 192)
+        return EVP_aes_192_gcm();
+
+    if (keySize * 8 == 256)
+        return EVP_aes_256_gcm();
+
+    return nullptr;
+}
+
+class StreamingCipher : public RefCounted<StreamingCipher> {
+public:
+    static RefPtr<StreamingCipher> create(std::span<const uint8_t> key, bool decrypt, uint8_t tagLength);
+
+    bool isDecrypting() const { return m_decrypt; }
+    uint8_t tagLength() const { return m_tagLength; }
+
+    // Starts a new message under the same key. The IV must not repeat.
+    bool reset(std::span<const uint8_t> iv, std::span<const uint8_t> additionalData);
+    // `output` may be `input` itself, or at least as long.
+    bool update(std::span<const uint8_t> input, uint8_t* output);
+    bool setAuthTag(std::span<const uint8_t>);
+    // The tag when encrypting, empty when decrypting. nullopt if the message
+    // fails to authenticate.
+    std::optional<Vector<uint8_t>> final();
+
+    // For decrypting as a TransformStream: the last tagLength bytes seen so
+    // far may be the tag, so they stay here until the next chunk or flush.
+    // Decrypts in place and returns how many leading bytes of `chunk` are
+    // now plaintext.
+    std::optional<size_t> decryptHoldingBackTag(std::span<uint8_t> chunk);
+    bool finishHoldingBackTag();
+
+private:
+    StreamingCipher(EvpCipherCtxPtr&& context, bool decrypt, uint8_t tagLength)
+        : m_context(WTFMove(context))
+        , m_decrypt(decrypt)
+        , m_tagLength(tagLength)
+    {
+    }
+
+    EvpCipherCtxPtr m_context;
+    bool m_decrypt;
+    uint8_t m_tagLength;
+    bool m_started { false };
+    uint8_t m_heldBackLength { 0 };
+    uint8_t m_heldBack[maximumTagLength];
+};
+
+RefPtr<StreamingCipher> StreamingCipher::create(std::span<const uint8_t> key, bool decrypt, uint8_t tagLength)
+{
+    const EVP_CIPHER* algorithm = aesGCMAlgorithm(key.size());
+    if (!algorithm || tagLength > maximumTagLength)
+        return nullptr;
+
+    auto context = EvpCipherCtxPtr(EVP_CIPHER_CTX_new());
+    if (!context)
+        return nullptr;
+
+    // The key schedule is set up once here; reset() only changes the IV.
+    int encrypt = decrypt ? 0 : 1;
+    if (1 != EVP_CipherInit_ex(context.get(), algorithm, nullptr, nullptr, nullptr, encrypt))
+        return nullptr;
+    if (1 != EVP_CIPHER_CTX_set_padding(context.get(), 0))
+        return nullptr;
+    if (1 != EVP_CipherInit_ex(context.get(), nullptr, nullptr, key.data(), nullptr, encrypt))
+        return nullptr;
+
+    return adoptRef(*new StreamingCipher(WTFMove(context), decrypt, tagLength));
+}
+
+bool StreamingCipher::reset(std::span<const uint8_t> iv, std::span<const uint8_t> additionalData)
+{
+    m_started = false;
+    m_heldBackLength = 0;
+
+    if (iv.empty())
+        return false;
+    if (1 != EVP_CIPHER_CTX_ctrl(m_context.get(), EVP_CTRL_GCM_SET_IVLEN, iv.size(), nullptr))
+        return false;
+    if (1 != EVP_CipherInit_ex(m_context.get(), nullptr, nullptr, nullptr, iv.data(), m_decrypt ? 0 : 1))
+        return false;
+
+    int length;
+    if (!additionalData.empty() && 1 != EVP_CipherUpdate(m_context.get(), nullptr, &length, additionalData.data(), additionalData.size()))
+        return false;
+
+    m_started = true;
+    return true;
+}
+
+bool StreamingCipher::update(std::span<const uint8_t> input, uint8_t* output)
+{
+    if (!m_started)
+        return false;
+
+    // EVP_CipherUpdate takes an int length.
+    constexpr size_t maximumUpdateSize = 1 << 30;
+    while (!input.empty()) {
+        size_t size = std::min(input.size(), maximumUpdateSize);
+        int length;
+        if (1 != EVP_CipherUpdate(m_context.get(), output, &length, input.data(), size))
+            return false;
+        // GCM is a stream mode, so output never lags the input.
+        ASSERT(static_cast<size_t>(length) == size);
+        input = input.subspan(size);
+        output += size;
+    }
+    return true;
+}
+
+bool StreamingCipher::setAuthTag(std::span<const uint8_t> tag)
+{
+    if (!m_started || !m_decrypt || tag.size() != m_tagLength)
+        return false;
+    return 1 == EVP_CIPHER_CTX_ctrl(m_context.get(), EVP_CTRL_GCM_SET_TAG, tag.size(), const_cast<uint8_t*>(tag.data()));
+}
+
+std::optional<Vector<uint8_t>> StreamingCipher::final()
+{
+    if (!m_started)
+        return std::nullopt;
+    m_started = false;
+
+    // Nothing is written here in GCM mode, but the buffer must be valid.
+    uint8_t unused[EVP_MAX_BLOCK_LENGTH];
+    int length;
+    if (1 != EVP_CipherFinal_ex(m_context.get(), unused, &length))
+        return std::nullopt;
+
+    if (m_decrypt)
+        return Vector<uint8_t> {};
+
+    Vector<uint8_t> tag(m_tagLength);
+    if (m_tagLength && 1 != EVP_CIPHER_CTX_ctrl(m_context.get(), EVP_CTRL_GCM_GET_TAG, m_tagLength, tag.data()))
+        return std::nullopt;
+    return tag;
+}
+
+std::optional<size_t> StreamingCipher::decryptHoldingBackTag(std::span<uint8_t> chunk)
+{
+    ASSERT(m_decrypt);
+    size_t heldBack = m_heldBackLength;
+    size_t total = heldBack + chunk.size();
+    if (total <= m_tagLength) {
+        memcpy(m_heldBack + heldBack, chunk.data(), chunk.size());
+        m_heldBackLength = total;
+        return 0;
+    }
+
+    // The ciphertext to decrypt is the first `ready` bytes of heldBack ++
+    // chunk, and since heldBack is no longer than the tag, it fits in chunk.
+    size_t ready = total - m_tagLength;
+    size_t fromHeldBack = std::min(heldBack, ready);
+
+    uint8_t nextHeldBack[maximumTagLength];
+    for (size_t i = 0; i < m_tagLength; i++) {
+        size_t index = ready + i;
+        nextHeldBack[i] = index < heldBack ? m_heldBack[index] : chunk[index - heldBack];
+    }
+
+    uint8_t head[maximumTagLength];
+    if (!update({ m_heldBack, fromHeldBack }, head))
+        return std::nullopt;
+    // Make room for the held back bytes at the front, then decrypt the rest
+    // where it now sits.
+    memmove(chunk.data() + fromHeldBack, chunk.data(), ready - fromHeldBack);
+    if (!update({ chunk.data() + fromHeldBack, ready - fromHeldBack }, chunk.data() + fromHeldBack))
+        return std::nullopt;
+    memcpy(chunk.data(), head, fromHeldBack);
+
+    memcpy(m_heldBack, nextHeldBack, m_tagLength);
+    m_heldBackLength = m_tagLength;
+    return ready;
+}
+
+bool StreamingCipher::finishHoldingBackTag()
+{
+    ASSERT(m_decrypt);
+    if (m_heldBackLength != m_tagLength || !setAuthTag({ m_heldBack, m_heldBackLength }))
+        return false;
+    return !!final();
+}
+
+static std::optional<std::span<uint8_t>> bytesOf(JSValue value)
+{
+    if (auto* view = jsDynamicCast<JSArrayBufferView*>(value)) {
+        if (view->isDetached())
+            return std::nullopt;
+        return std::span { static_cast<uint8_t*>(view->vector()), view->byteLength() };
+    }
+    if (auto* arrayBuffer = jsDynamicCast<JSArrayBuffer*>(value)) {
+        if (auto* impl = arrayBuffer->impl())
+            return std::span { static_cast<uint8_t*>(impl->data()), impl->byteLength() };
+    }
+    return std::nullopt;
+}
+
+static bool enqueueChunk(JSGlobalObject* globalObject, JSValue controller, JSValue chunk)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue enqueue = controller.get(globalObject, Identifier::fromString(vm, "enqueue"_s));
+    RETURN_IF_EXCEPTION(scope, false);
+    auto callData = JSC::getCallData(enqueue);
+    if (UNLIKELY(callData.type == CallData::Type::None)) {
+        throwTypeError(globalObject, scope, "controller.enqueue is not a function"_s);
+        return false;
+    }
+
+    MarkedArgumentBuffer args;
+    args.append(chunk);
+    JSC::call(globalObject, enqueue, callData, controller, args);
+    RETURN_IF_EXCEPTION(scope, false);
+    return true;
+}
+
+static JSUint8Array* createUint8Array(JSGlobalObject* globalObject, std::span<const uint8_t> bytes)
+{
+    auto* array = JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint8, false), bytes.size());
+    if (array)
+        memcpy(array->typedVector(), bytes.data(), bytes.size());
+    return array;
+}
+
+static JSValue cipherTransform(JSGlobalObject* globalObject, StreamingCipher& cipher, JSValue chunk, JSValue controller)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* view = jsDynamicCast<JSArrayBufferView*>(chunk);
+    auto bytes = bytesOf(chunk);
+    if (!view || !bytes) {
+        throwTypeError(globalObject, scope, "The chunk must be an ArrayBufferView"_s);
+        return {};
+    }
+
+    if (!cipher.isDecrypting()) {
+        if (!cipher.update(*bytes, bytes->data())) {
+            throwTypeError(globalObject, scope, "Cipher operation failed"_s);
+            return {};
+        }
+        enqueueChunk(globalObject, controller, chunk);
+        RETURN_IF_EXCEPTION(scope, {});
+        return jsUndefined();
+    }
+
+    auto ready = cipher.decryptHoldingBackTag(*bytes);
+    if (!ready) {
+        throwTypeError(globalObject, scope, "Cipher operation failed"_s);
+        return {};
+    }
+    if (!*ready)
+        return jsUndefined();
+
+    JSValue output = chunk;
+    if (*ready != bytes->size()) {
+        output = JSUint8Array::create(globalObject, globalObject->typedArrayStructure(TypeUint8, false), view->possiblySharedBuffer(), view->byteOffset(), *ready);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+    enqueueChunk(globalObject, controller, output);
+    RETURN_IF_EXCEPTION(scope, {});
+    return jsUndefined();
+}
+
+static JSValue cipherFlush(JSGlobalObject* globalObject, StreamingCipher& cipher, JSValue controller)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (cipher.isDecrypting()) {
+        if (!cipher.finishHoldingBackTag()) {
+            throwTypeError(globalObject, scope, "Unsupported state or unable to authenticate data"_s);
+            return {};
+        }
+        return jsUndefined();
+    }
+
+    auto tag = cipher.final();
+    if (!tag) {
+        throwTypeError(globalObject, scope, "Cipher operation failed"_s);
+        return {};
+    }
+    auto* output = createUint8Array(globalObject, *tag);
+    RETURN_IF_EXCEPTION(scope, {});
+    enqueueChunk(globalObject, controller, output);
+    RETURN_IF_EXCEPTION(scope, {});
+    return jsUndefined();
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionCreateCipherStream, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    std::optional<std::span<uint8_t>> key;
+    if (auto* cryptoKey = jsDynamicCast<JSCryptoKey*>(callFrame->argument(0))) {
+        auto& wrapped = cryptoKey->wrapped();
+        if (wrapped.keyClass() == CryptoKeyClass::AES) {
+            auto& bytes = downcast<CryptoKeyAES>(wrapped).key();
+            key = std::span { const_cast<uint8_t*>(bytes.data()), bytes.size() };
+        }
+    } else
+        key = bytesOf(callFrame->argument(0));
+    if (!key) {
+        throwTypeError(globalObject, scope, "key must be an AES CryptoKey or a Buffer"_s);
+        return {};
+    }
+
+    auto iv = bytesOf(callFrame->argument(1));
+    if (!iv || iv->empty()) {
+        throwTypeError(globalObject, scope, "iv must be a non-empty Buffer"_s);
+        return {};
+    }
+
+    std::span<uint8_t> additionalData;
+    JSValue additionalDataValue = callFrame->argument(2);
+    if (!additionalDataValue.isUndefinedOrNull()) {
+        auto bytes = bytesOf(additionalDataValue);
+        if (!bytes) {
+            throwTypeError(globalObject, scope, "additionalData must be a Buffer"_s);
+            return {};
+        }
+        additionalData = *bytes;
+    }
+
+    uint8_t tagLength = maximumTagLength;
+    JSValue tagLengthValue = callFrame->argument(3);
+    if (!tagLengthValue.isUndefined()) {
+        uint32_t value = tagLengthValue.toUInt32(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (value < 4 || value > maximumTagLength) {
+            throwRangeError(globalObject, scope, "tagLength must be between 4 and 16 bytes"_s);
+            return {};
+        }
+        tagLength = value;
+    }
+
+    bool decrypt = callFrame->argument(4).toBoolean(globalObject);
+
+    RefPtr cipher = StreamingCipher::create(*key, decrypt, tagLength);
+    if (!cipher) {
+        throwTypeError(globalObject, scope, "Invalid key length"_s);
+        return {};
+    }
+    if (!cipher->reset(*iv, additionalData)) {
+        throwTypeError(globalObject, scope, "Invalid iv"_s);
+        return {};
+    }
+
+    auto* object = constructEmptyObject(globalObject);
+    object->putDirect(vm, Identifier::fromString(vm, "transform"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "transform"_s, [cipher](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            return JSValue::encode(cipherTransform(globalObject, *cipher, callFrame->argument(0), callFrame->argument(1)));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "flush"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "flush"_s, [cipher](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            return JSValue::encode(cipherFlush(globalObject, *cipher, callFrame->argument(0)));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "update"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "update"_s, [cipher](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            auto input = bytesOf(callFrame->argument(0));
+            auto output = callFrame->argument(1).isUndefined() ? input : bytesOf(callFrame->argument(1));
+            if (!input || !output) {
+                throwTypeError(globalObject, scope, "input and output must be Buffers"_s);
+                return {};
+            }
+            if (output->size() < input->size()) {
+                throwRangeError(globalObject, scope, "output is smaller than input"_s);
+                return {};
+            }
+            if (!cipher->update(*input, output->data())) {
+                throwTypeError(globalObject, scope, "Cipher operation failed"_s);
+                return {};
+            }
+            return JSValue::encode(jsNumber(input->size()));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "setAuthTag"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "setAuthTag"_s, [cipher](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            auto tag = bytesOf(callFrame->argument(0));
+            if (!tag || !cipher->setAuthTag(*tag)) {
+                throwTypeError(globalObject, scope, "Invalid authentication tag"_s);
+                return {};
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "final"_s),
+        JSNativeStdFunction::create(vm, globalObject, 0, "final"_s, [cipher](JSGlobalObject* globalObject, CallFrame*) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            auto tag = cipher->final();
+            if (!tag) {
+                throwTypeError(globalObject, scope, "Unsupported state or unable to authenticate data"_s);
+                return {};
+            }
+            if (cipher->isDecrypting())
+                return JSValue::encode(jsUndefined());
+            RELEASE_AND_RETURN(scope, JSValue::encode(createUint8Array(globalObject, *tag)));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "reset"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "reset"_s, [cipher](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            auto iv = bytesOf(callFrame->argument(0));
+            std::optional<std::span<uint8_t>> additionalData = std::span<uint8_t> {};
+            if (!callFrame->argument(1).isUndefinedOrNull())
+                additionalData = bytesOf(callFrame->argument(1));
+            if (!iv || !additionalData || !cipher->reset(*iv, *additionalData)) {
+                throwTypeError(globalObject, scope, "Invalid iv"_s);
+                return {};
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+
+    return JSValue::encode(object);
+}
+
+}
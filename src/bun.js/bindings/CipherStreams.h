@@ -0,0 +1,22 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// createCipherStream(key, iv, additionalData, tagLength, decrypt): an AES-GCM
+// cipher that is fed a chunk at a time and works in place.
+//
+// The returned object has `transform` and `flush`, so it can be handed to
+// `new TransformStream()` as is, plus `update(input, output = input)`,
+// `setAuthTag(tag)`, `final()` and `reset(iv, additionalData)` for callers
+// driving it by hand. Chunks are written over in place, so encrypting a
+// 1GB file allocates nothing per chunk, and one EVP_CIPHER_CTX (key
+// schedule included) serves every message that reset() starts.
+//
+// As a TransformStream it uses the WebCrypto layout: encrypting appends the
+// tag after the last chunk, decrypting holds back the last `tagLength`
+// bytes it saw and checks them as the tag in flush.
+JSC_DECLARE_HOST_FUNCTION(jsFunctionCreateCipherStream);
+
+}
@@ -1,9 +1,113 @@
 #include "root.h"
+#include "CodeCoverage.h"
 #include "ZigSourceProvider.h"
+#include "headers-handwritten.h"
 #include <JavaScriptCore/ControlFlowProfiler.h>
+#include <JavaScriptCore/FunctionExecutable.h>
+#include <JavaScriptCore/HeapIterationScope.h>
+#include <JavaScriptCore/VMInlines.h>
+#include <wtf/text/StringBuilder.h>
 
 using namespace JSC;
 
+static bool s_isFunctionCoverageEnabled = false;
+
+// Set by the test runner instead of enabling the ControlFlowProfiler.
+extern "C" void CodeCoverage__setFunctionCoverage(bool enabled)
+{
+    s_isFunctionCoverageEnabled = enabled;
+}
+
+namespace Bun {
+
+bool isCodeCoverageEnabled(JSC::VM& vm)
+{
+    return s_isFunctionCoverageEnabled || vm.controlFlowProfiler();
+}
+
+// Which functions of each source have run, by their
+// typeProfilingStartOffset/EndOffset, the same ranges the
+// FunctionHasExecutedCache hands out. A FunctionExecutable (and the
+// CodeBlock that says it ran) can be collected once nothing refers to the
+// function, so what each scan finds is kept here for good. Source IDs are
+// unique across VMs, so test workers, each with a VM of its own, record
+// into the same map under the lock and the report sees all of them.
+using FunctionRanges = HashMap<uint64_t, bool, DefaultHash<uint64_t>, WTF::UnsignedWithZeroKeyHashTraits<uint64_t>>;
+static HashMap<intptr_t, FunctionRanges>& executedFunctions()
+{
+    static NeverDestroyed<HashMap<intptr_t, FunctionRanges>> functions;
+    return functions;
+}
+
+static Lock s_executedFunctionsLock;
+
+static ALWAYS_INLINE uint64_t rangeKey(unsigned startOffset, unsigned endOffset)
+{
+    return (static_cast<uint64_t>(startOffset) << 32) | endOffset;
+}
+
+static void recordFunctions(VM& vm)
+{
+    Locker locker { s_executedFunctionsLock };
+    auto& functions = executedFunctions();
+    vm.forEachScriptExecutableSpace([&](auto& spaceAndSet) {
+        HeapIterationScope heapIterationScope(vm.heap);
+        spaceAndSet.set.forEachLiveCell([&](HeapCell* cell, HeapCell::Kind) {
+            auto* executable = jsDynamicCast<FunctionExecutable*>(static_cast<JSCell*>(cell));
+            if (!executable || executable->isBuiltinFunction() || executable->sourceID() <= 0)
+                return;
+            bool hasRun = executable->codeBlockForCall() || executable->codeBlockForConstruct();
+            auto& ranges = functions.ensure(executable->sourceID(), [] { return FunctionRanges(); }).iterator->value;
+            auto result = ranges.add(rangeKey(executable->typeProfilingStartOffset(), executable->typeProfilingEndOffset()), hasRun);
+            if (!result.isNewEntry && hasRun)
+                result.iterator->value = true;
+        });
+    });
+}
+
+}
+
+// Function coverage can lose functions that were collected since the last
+// scan, so the test runner calls this after each file as well as before
+// reporting.
+extern "C" void CodeCoverage__recordFunctions(JSC::VM* vmPtr)
+{
+    Bun::recordFunctions(*vmPtr);
+}
+
+// Like CodeCoverage__withBlocksAndFunctions, but every range is a function
+// (functionOffset is 0), for function coverage.
+extern "C" bool CodeCoverage__withFunctions(
+    JSC::VM* vmPtr,
+    JSC::SourceID sourceID,
+    void* ctx,
+    bool ignoreSourceMap,
+    void (*blockCallback)(void* ctx, JSC::BasicBlockRange* range, size_t len, size_t functionOffset, bool ignoreSourceMap))
+{
+    Bun::recordFunctions(*vmPtr);
+
+    Vector<BasicBlockRange> functionRanges;
+    Locker locker { Bun::s_executedFunctionsLock };
+    auto it = Bun::executedFunctions().find(sourceID);
+    if (it != Bun::executedFunctions().end()) {
+        functionRanges.reserveInitialCapacity(it->value.size());
+        for (auto& [key, hasRun] : it->value) {
+            BasicBlockRange range;
+            range.m_hasExecuted = hasRun;
+            range.m_startOffset = static_cast<int>(key >> 32);
+            range.m_endOffset = static_cast<int>(key & 0xffffffff);
+            // JSC counts calls only for tiering; like the function ranges
+            // above, this is 1 for "ran".
+            range.m_executionCount = hasRun ? 1 : 0;
+            functionRanges.append(range);
+        }
+    }
+    locker.unlockEarly();
+
+    blockCallback(ctx, functionRanges.data(), functionRanges.size(), 0, ignoreSourceMap);
+    return true;
+}
+
 extern "C" bool CodeCoverage__withBlocksAndFunctions(
     JSC::VM* vmPtr,
     JSC::SourceID sourceID,
@@ -42,3 +146,101 @@ extern "C" bool CodeCoverage__withBlocksAndFunctions(
     blockCallback(ctx, basicBlocks.data(), basicBlocks.size(), functionStartOffset, ignoreSourceMap);
     return true;
 }
+
+// Merges the lcov reports of test shards into one. Each source file's DA
+// (line) and FNDA (function) hit counts are summed, and its LF/LH/FNF/FNH
+// totals recomputed from the sums.
+extern "C" BunString CodeCoverage__mergeLCOV(const BunString* reports, size_t count)
+{
+    struct FileCoverage {
+        Vector<unsigned> lineOrder;
+        HashMap<unsigned, uint64_t> lines;
+        Vector<String> functionOrder;
+        HashMap<String, unsigned> functionLines;
+        HashMap<String, uint64_t> functionHits;
+    };
+    Vector<String> fileOrder;
+    HashMap<String, FileCoverage> files;
+
+    for (size_t i = 0; i < count; i++) {
+        auto report = reports[i].toWTFString();
+        FileCoverage* file = nullptr;
+        for (auto line : StringView(report).splitAllowingEmptyEntries('\n')) {
+            if (line.startsWith("SF:"_s)) {
+                auto path = line.substring(3).toString();
+                auto result = files.add(path, FileCoverage());
+                if (result.isNewEntry)
+                    fileOrder.append(path);
+                file = &result.iterator->value;
+                continue;
+            }
+            if (!file)
+                continue;
+            if (line == "end_of_record"_s) {
+                file = nullptr;
+                continue;
+            }
+
+            auto colon = line.find(':');
+            if (colon == notFound)
+                continue;
+            auto tag = line.left(colon);
+            auto fields = line.substring(colon + 1);
+            auto comma = fields.find(',');
+            if (comma == notFound)
+                continue;
+            auto first = fields.left(comma);
+            auto rest = fields.substring(comma + 1);
+
+            if (tag == "DA"_s) {
+                // DA:<line>,<hits>[,<checksum>]
+                auto lineNumber = parseInteger<unsigned>(first);
+                auto hits = parseInteger<uint64_t>(rest.left(rest.find(',')));
+                if (!lineNumber || !*lineNumber || !hits)
+                    continue;
+                auto result = file->lines.add(*lineNumber, 0);
+                if (result.isNewEntry)
+                    file->lineOrder.append(*lineNumber);
+                result.iterator->value += *hits;
+            } else if (tag == "FN"_s) {
+                // FN:<line>,<name>
+                auto lineNumber = parseInteger<unsigned>(first);
+                auto name = rest.toString();
+                if (lineNumber && !name.isEmpty() && file->functionLines.add(name, *lineNumber).isNewEntry)
+                    file->functionOrder.append(name);
+            } else if (tag == "FNDA"_s) {
+                // FNDA:<hits>,<name>
+                auto hits = parseInteger<uint64_t>(first);
+                if (hits && !rest.isEmpty())
+                    file->functionHits.add(rest.toString(), 0).iterator->value += *hits;
+            }
+        }
+    }
+
+    StringBuilder merged;
+    for (auto& path : fileOrder) {
+        auto& file = files.find(path)->value;
+        merged.append("TN:\nSF:"_s, path, '\n');
+
+        unsigned functionsHit = 0;
+        for (auto& name : file.functionOrder)
+            merged.append("FN:"_s, file.functionLines.get(name), ',', name, '\n');
+        for (auto& name : file.functionOrder) {
+            uint64_t hits = file.functionHits.get(name);
+            functionsHit += !!hits;
+            merged.append("FNDA:"_s, hits, ',', name, '\n');
+        }
+        merged.append("FNF:"_s, file.functionOrder.size(), "\nFNH:"_s, functionsHit, '\n');
+
+        std::sort(file.lineOrder.begin(), file.lineOrder.end());
+        unsigned linesHit = 0;
+        for (unsigned lineNumber : file.lineOrder) {
+            uint64_t hits = file.lines.get(lineNumber);
+            linesHit += !!hits;
+            merged.append("DA:"_s, lineNumber, ',', hits, '\n');
+        }
+        merged.append("LF:"_s, file.lineOrder.size(), "\nLH:"_s, linesHit, "\nend_of_record\n"_s);
+    }
+
+    return Bun::toStringRef(merged.toString());
+}
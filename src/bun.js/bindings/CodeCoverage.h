@@ -0,0 +1,16 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// Coverage comes in two modes:
+//
+// - Block coverage instruments every basic block through JSC's
+//   ControlFlowProfiler. It is exact, but it makes tests 2-5x slower.
+// - Function coverage only looks at which functions JSC has compiled.
+//   Every function is compiled before its first run, so this adds nothing
+//   to the running code. It reports functions, not lines within them.
+bool isCodeCoverageEnabled(JSC::VM&);
+
+}
@@ -80,6 +80,9 @@ using namespace JSC;
 
 JSC_DECLARE_HOST_FUNCTION(jsFunctionRequireCommonJS);
 
+// Whether every own property of an object with this structure is in the
+// structure's property table. Accessors are fine: appendExportsFromStructure
+// calls them by name.
 static bool canPerformFastEnumeration(Structure* s)
 {
     if (s->typeInfo().overridesGetOwnPropertySlot())
@@ -88,8 +91,6 @@ static bool canPerformFastEnumeration(Structure* s)
         return false;
     if (hasIndexedProperties(s->indexingType()))
         return false;
-    if (s->hasAnyKindOfGetterSetterProperties())
-        return false;
     if (s->isUncacheableDictionary())
         return false;
     if (s->hasUnderscoreProtoPropertyExcludingOriginalProto())
@@ -97,6 +98,52 @@ static bool canPerformFastEnumeration(Structure* s)
     return true;
 }
 
+// Appends the enumerable, string-keyed own properties of `exports` that
+// `shouldSkip` lets through, walking its structure rather than asking for
+// property names and then looking each one up. Data properties are read
+// straight out of their slots. Accessors (bundlers' `__export` helper
+// makes every export a getter) are called after the walk, since a getter
+// can add or delete properties; once the structure has changed, the rest
+// are read by name too.
+template<typename ShouldSkip>
+static void appendExportsFromStructure(JSC::JSGlobalObject* globalObject, JSObject* exports, const ShouldSkip& shouldSkip, Vector<JSC::Identifier, 4>& exportNames, JSC::MarkedArgumentBuffer& exportValues)
+{
+    auto& vm = globalObject->vm();
+    auto* structure = exports->structure();
+
+    struct Export {
+        Identifier name;
+        PropertyOffset offset;
+        bool isAccessor;
+    };
+    Vector<Export, 16> exportsToRead;
+    structure->forEachProperty(vm, [&](const PropertyTableEntry& entry) -> bool {
+        auto key = entry.key();
+        if (key->isSymbol() || entry.attributes() & PropertyAttribute::DontEnum || shouldSkip(key))
+            return true;
+        exportsToRead.append({ Identifier::fromUid(vm, key), entry.offset(), !!(entry.attributes() & PropertyAttribute::AccessorOrCustomAccessorOrValue) });
+        return true;
+    });
+
+    auto catchScope = DECLARE_CATCH_SCOPE(vm);
+    for (auto& entry : exportsToRead) {
+        JSValue value;
+        if (!entry.isAccessor && exports->structure() == structure) {
+            value = exports->getDirect(entry.offset);
+        } else {
+            value = exports->get(globalObject, entry.name);
+            // If it throws, we keep it in the exports list, but mark it as undefined
+            // This is consistent with what Node.js does.
+            if (catchScope.exception()) {
+                catchScope.clearException();
+                value = jsUndefined();
+            }
+        }
+        exportNames.append(entry.name);
+        exportValues.append(value);
+    }
+}
+
 extern "C" bool Bun__VM__specifierIsEvalEntryPoint(void*, EncodedJSValue);
 extern "C" void Bun__VM__setEntryPointEvalResultCJS(void*, EncodedJSValue);
 
@@ -769,18 +816,14 @@ void populateESMExports(
 
         if (hasESModuleMarker) {
             if (canPerformFastEnumeration(structure)) {
-                exports->structure()->forEachProperty(vm, [&](const PropertyTableEntry& entry) -> bool {
-                    auto key = entry.key();
-                    if (key->isSymbol() || entry.attributes() & PropertyAttribute::DontEnum || key == esModuleMarker)
-                        return true;
-
-                    needsToAssignDefault = needsToAssignDefault && key != vm.propertyNames->defaultKeyword;
-
-                    JSValue value = exports->getDirect(entry.offset());
-                    exportNames.append(Identifier::fromUid(vm, key));
-                    exportValues.append(value);
-                    return true;
-                });
+                appendExportsFromStructure(
+                    globalObject, exports, [&](auto key) {
+                        if (key == esModuleMarker)
+                            return true;
+                        needsToAssignDefault = needsToAssignDefault && key != vm.propertyNames->defaultKeyword;
+                        return false;
+                    },
+                    exportNames, exportValues);
             } else {
                 JSC::PropertyNameArray properties(vm, JSC::PropertyNameMode::Strings, JSC::PrivateSymbolMode::Exclude);
                 exports->methodTable()->getOwnPropertyNames(exports, globalObject, properties, DontEnumPropertiesMode::Exclude);
@@ -819,17 +862,9 @@ void populateESMExports(
             }
 
         } else if (canPerformFastEnumeration(structure)) {
-            exports->structure()->forEachProperty(vm, [&](const PropertyTableEntry& entry) -> bool {
-                auto key = entry.key();
-                if (key->isSymbol() || entry.attributes() & PropertyAttribute::DontEnum || key == vm.propertyNames->defaultKeyword)
-                    return true;
-
-                JSValue value = exports->getDirect(entry.offset());
-
-                exportNames.append(Identifier::fromUid(vm, key));
-                exportValues.append(value);
-                return true;
-            });
+            appendExportsFromStructure(
+                globalObject, exports, [&](auto key) { return key == vm.propertyNames->defaultKeyword; },
+                exportNames, exportValues);
         } else {
             JSC::PropertyNameArray properties(vm, JSC::PropertyNameMode::Strings, JSC::PrivateSymbolMode::Exclude);
             exports->methodTable()->getOwnPropertyNames(exports, globalObject, properties, DontEnumPropertiesMode::Exclude);
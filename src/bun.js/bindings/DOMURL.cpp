@@ -27,6 +27,7 @@
 #include "DOMURL.h"
 
 #include "ActiveDOMObject.h"
+#include "ParsedURLCache.h"
 // #include "Blob.h"
 // #include "BlobURL.h"
 // #include "MemoryCache.h"
@@ -61,11 +62,29 @@ inline DOMURL::DOMURL(URL&& completeURL)
     ASSERT(m_url.isValid());
 }
 
+// `base` is null when there is none.
+static std::optional<URL> findParsedURL(const String& url, const String& base)
+{
+    if (auto* cache = Bun::ParsedURLCache::current())
+        return cache->find(url, base);
+    return std::nullopt;
+}
+
+static void addParsedURL(const String& url, const String& base, const URL& completeURL)
+{
+    if (auto* cache = Bun::ParsedURLCache::current())
+        cache->add(url, base, completeURL);
+}
+
 ExceptionOr<Ref<DOMURL>> DOMURL::create(const String& url)
 {
+    if (auto cached = findParsedURL(url, String()))
+        return adoptRef(*new DOMURL(WTFMove(*cached)));
+
     URL completeURL { url };
     if (!completeURL.isValid())
         return Exception { TypeError, makeString(redact(url), " cannot be parsed as a URL.") };
+    addParsedURL(url, String(), completeURL);
     return adoptRef(*new DOMURL(WTFMove(completeURL)));
 }
 
@@ -80,20 +99,31 @@ ExceptionOr<Ref<DOMURL>> DOMURL::create(const String& url, const URL& base)
 
 ExceptionOr<Ref<DOMURL>> DOMURL::create(const String& url, const String& base)
 {
+    if (auto cached = findParsedURL(url, base))
+        return adoptRef(*new DOMURL(WTFMove(*cached)));
+
     URL baseURL { base };
     if (!base.isNull() && !baseURL.isValid())
         return Exception { TypeError, makeString(redact(url), " cannot be parsed as a URL against "_s, redact(base)) };
-    return create(url, baseURL);
+    auto result = create(url, baseURL);
+    if (!result.hasException())
+        addParsedURL(url, base, result.returnValue()->href());
+    return result;
 }
 
 DOMURL::~DOMURL() = default;
 
 static URL parseInternal(const String& url, const String& base)
 {
+    if (auto cached = findParsedURL(url, base))
+        return WTFMove(*cached);
+
     URL baseURL { base };
     if (!base.isNull() && !baseURL.isValid())
         return {};
-    return { baseURL, url };
+    URL completeURL { baseURL, url };
+    addParsedURL(url, base, completeURL);
+    return completeURL;
 }
 
 RefPtr<DOMURL> DOMURL::parse(const String& url, const String& base)
@@ -111,11 +141,14 @@ bool DOMURL::canParse(const String& url, const String& base)
 
 ExceptionOr<void> DOMURL::setHref(const String& url)
 {
-    URL completeURL { URL {}, url };
+    auto cached = findParsedURL(url, String());
+    URL completeURL = cached ? WTFMove(*cached) : URL { URL {}, url };
     if (!completeURL.isValid()) {
 
         return Exception { TypeError, makeString(redact(url), " cannot be parsed as a URL.") };
     }
+    if (!cached)
+        addParsedURL(url, String(), completeURL);
     m_url = WTFMove(completeURL);
     if (m_searchParams)
         m_searchParams->updateFromAssociatedURL();
@@ -72,15 +72,11 @@ static bool isImplementationVisibilityPrivate(JSC::StackVisitor& visitor)
     return implementationVisibility != ImplementationVisibility::Public;
 }
 
-JSCStackTrace JSCStackTrace::captureCurrentJSStackTrace(Zig::GlobalObject* globalObject, JSC::CallFrame* callFrame, size_t frameLimit, JSC::JSValue caller)
+// How many frames from the top belong to `caller` (and what it called), and
+// in framesCount, how many public frames there are in all.
+static int32_t countFramesToSkip(JSC::VM& vm, JSC::CallFrame* callFrame, JSC::JSValue caller, size_t& framesCount)
 {
-    JSC::VM& vm = globalObject->vm();
-    if (!callFrame) {
-        return JSCStackTrace();
-    }
-
-    WTF::Vector<JSCStackFrame> stackFrames;
-    size_t framesCount = 0;
+    framesCount = 0;
 
     bool belowCaller = false;
     int32_t skipFrames = 0;
@@ -156,6 +152,20 @@ JSCStackTrace JSCStackTrace::captureCurrentJSStackTrace(Zig::GlobalObject* globa
         });
     }
 
+    return skipFrames;
+}
+
+JSCStackTrace JSCStackTrace::captureCurrentJSStackTrace(Zig::GlobalObject* globalObject, JSC::CallFrame* callFrame, size_t frameLimit, JSC::JSValue caller)
+{
+    JSC::VM& vm = globalObject->vm();
+    if (!callFrame) {
+        return JSCStackTrace();
+    }
+
+    WTF::Vector<JSCStackFrame> stackFrames;
+    size_t framesCount = 0;
+    int32_t skipFrames = countFramesToSkip(vm, callFrame, caller, framesCount);
+
     framesCount = std::min(frameLimit, framesCount);
 
     // Create the actual stack frames
@@ -182,6 +192,47 @@ JSCStackTrace JSCStackTrace::captureCurrentJSStackTrace(Zig::GlobalObject* globa
     return JSCStackTrace(stackFrames);
 }
 
+void JSCStackTrace::captureCurrentStackFrames(Zig::GlobalObject* globalObject, JSC::CallFrame* callFrame, size_t frameLimit, JSC::JSValue caller, JSC::JSCell* owner, WTF::Vector<JSC::StackFrame>& stackFrames)
+{
+    JSC::VM& vm = globalObject->vm();
+    if (!callFrame) {
+        return;
+    }
+
+    size_t framesCount = 0;
+    int32_t skipFrames = countFramesToSkip(vm, callFrame, caller, framesCount);
+
+    framesCount = std::min(frameLimit, framesCount);
+
+    // The same frames as captureCurrentJSStackTrace, as JSCStackFrame(vm, visitor) sees them.
+    stackFrames.reserveInitialCapacity(framesCount);
+    JSC::StackVisitor::visit(callFrame, vm, [&](JSC::StackVisitor& visitor) -> WTF::IterationStatus {
+        if (isImplementationVisibilityPrivate(visitor)) {
+            return WTF::IterationStatus::Continue;
+        }
+
+        if (skipFrames > 0) {
+            skipFrames--;
+            return WTF::IterationStatus::Continue;
+        }
+
+        if (visitor->isNativeCalleeFrame()) {
+            auto* nativeCallee = visitor->callee().asNativeCallee();
+            // Inline cache stubs have no callee to name.
+            if (nativeCallee->category() != NativeCallee::Category::Wasm) {
+                return WTF::IterationStatus::Continue;
+            }
+            stackFrames.append(JSC::StackFrame(visitor->wasmFunctionIndexOrName()));
+        } else if (!!visitor->codeBlock() && !visitor->codeBlock()->unlinkedCodeBlock()->isBuiltinFunction()) {
+            stackFrames.append(JSC::StackFrame(vm, owner, visitor->callee().asCell(), visitor->codeBlock(), visitor->bytecodeIndex()));
+        } else {
+            stackFrames.append(JSC::StackFrame(vm, owner, visitor->callee().asCell()));
+        }
+
+        return (stackFrames.size() == framesCount) ? WTF::IterationStatus::Done : WTF::IterationStatus::Continue;
+    });
+}
+
 JSCStackTrace JSCStackTrace::getStackTraceForThrownValue(JSC::VM& vm, JSC::JSValue thrownValue)
 {
     const WTF::Vector<JSC::StackFrame>* jscStackTrace = nullptr;
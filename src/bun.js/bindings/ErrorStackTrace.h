@@ -146,6 +146,11 @@ public:
      * Return value must remain stack allocated. */
     static JSCStackTrace captureCurrentJSStackTrace(Zig::GlobalObject* globalObject, JSC::CallFrame* callFrame, size_t frameLimit, JSC::JSValue caller);
 
+    /* The same frames, as JSC::StackFrames owned by `owner`, so they can outlive the call. Source
+     * positions and names wait until they go through fromExisting. They keep no CallFrame, so their
+     * CallSites have no "this". */
+    static void captureCurrentStackFrames(Zig::GlobalObject* globalObject, JSC::CallFrame* callFrame, size_t frameLimit, JSC::JSValue caller, JSC::JSCell* owner, WTF::Vector<JSC::StackFrame>& stackFrames);
+
     /* In JSC, JSC::Exception points to the actual value that was thrown, usually
      * a JSC::ErrorInstance (but could be any JSValue). In v8, on the other hand,
      * TryCatch::Exception returns the thrown value, and we follow the same rule in jscshim.
@@ -0,0 +1,183 @@
+#include "root.h"
+#include "EscapeHTML.h"
+
+#include <wtf/text/StringImpl.h>
+
+#if CPU(X86_64)
+#include <emmintrin.h>
+#elif CPU(ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Bun {
+
+using namespace JSC;
+
+template<typename CharType> static constexpr size_t charactersPerBlock = 16 / sizeof(CharType);
+
+// Bit i is set when block[i] is one of the five characters we escape.
+static ALWAYS_INLINE uint32_t specialCharacterMask(const LChar* block)
+{
+#if CPU(X86_64)
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('&')), _mm_cmpeq_epi8(input, _mm_set1_epi8('<'))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('>')), _mm_cmpeq_epi8(input, _mm_set1_epi8('"'))),
+            _mm_cmpeq_epi8(input, _mm_set1_epi8('\''))));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#elif CPU(ARM64)
+    static constexpr uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t input = vld1q_u8(block);
+    uint8x16_t matches = vorrq_u8(
+        vorrq_u8(vceqq_u8(input, vdupq_n_u8('&')), vceqq_u8(input, vdupq_n_u8('<'))),
+        vorrq_u8(vorrq_u8(vceqq_u8(input, vdupq_n_u8('>')), vceqq_u8(input, vdupq_n_u8('"'))),
+            vceqq_u8(input, vdupq_n_u8('\''))));
+    uint8x16_t bits = vandq_u8(matches, vld1q_u8(weights));
+    return static_cast<uint32_t>(vaddv_u8(vget_low_u8(bits))) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < charactersPerBlock<LChar>; i++) {
+        LChar c = block[i];
+        if (c == '&' || c == '<' || c == '>' || c == '"' || c == '\'')
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static ALWAYS_INLINE uint32_t specialCharacterMask(const UChar* block)
+{
+#if CPU(X86_64)
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi16(input, _mm_set1_epi16('&')), _mm_cmpeq_epi16(input, _mm_set1_epi16('<'))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(input, _mm_set1_epi16('>')), _mm_cmpeq_epi16(input, _mm_set1_epi16('"'))),
+            _mm_cmpeq_epi16(input, _mm_set1_epi16('\''))));
+    // Narrow each 16-bit lane to one byte so the mask has a bit per character.
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(matches, _mm_setzero_si128())));
+#elif CPU(ARM64)
+    static constexpr uint8_t weights[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint16x8_t input = vld1q_u16(reinterpret_cast<const uint16_t*>(block));
+    uint16x8_t matches = vorrq_u16(
+        vorrq_u16(vceqq_u16(input, vdupq_n_u16('&')), vceqq_u16(input, vdupq_n_u16('<'))),
+        vorrq_u16(vorrq_u16(vceqq_u16(input, vdupq_n_u16('>')), vceqq_u16(input, vdupq_n_u16('"'))),
+            vceqq_u16(input, vdupq_n_u16('\''))));
+    return static_cast<uint32_t>(vaddv_u8(vand_u8(vmovn_u16(matches), vld1_u8(weights))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < charactersPerBlock<UChar>; i++) {
+        UChar c = block[i];
+        if (c == '&' || c == '<' || c == '>' || c == '"' || c == '\'')
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static ALWAYS_INLINE std::string_view entityFor(UChar character)
+{
+    switch (character) {
+    case '&':
+        return "&amp;";
+    case '<':
+        return "&lt;";
+    case '>':
+        return "&gt;";
+    case '"':
+        return "&quot;";
+    case '\'':
+        return "&#x27;";
+    default:
+        return {};
+    }
+}
+
+// How many characters escaping adds, i.e. the entity length minus one.
+template<typename CharType>
+static size_t escapedExtraLength(std::span<const CharType> input)
+{
+    const CharType* characters = input.data();
+    size_t length = input.size();
+    size_t extra = 0;
+    size_t i = 0;
+
+    for (; i + charactersPerBlock<CharType> <= length; i += charactersPerBlock<CharType>) {
+        for (uint32_t mask = specialCharacterMask(characters + i); mask; mask &= mask - 1)
+            extra += entityFor(characters[i + std::countr_zero(mask)]).length() - 1;
+    }
+
+    for (; i < length; i++) {
+        if (auto entity = entityFor(characters[i]); !entity.empty())
+            extra += entity.length() - 1;
+    }
+
+    return extra;
+}
+
+template<typename CharType>
+static void writeEscaped(std::span<const CharType> input, CharType* output)
+{
+    const CharType* characters = input.data();
+    size_t length = input.size();
+    size_t runStart = 0;
+
+    auto emit = [&](size_t position) {
+        size_t runLength = position - runStart;
+        memcpy(output, characters + runStart, runLength * sizeof(CharType));
+        output += runLength;
+        for (char c : entityFor(characters[position]))
+            *output++ = c;
+        runStart = position + 1;
+    };
+
+    size_t i = 0;
+    for (; i + charactersPerBlock<CharType> <= length; i += charactersPerBlock<CharType>) {
+        for (uint32_t mask = specialCharacterMask(characters + i); mask; mask &= mask - 1)
+            emit(i + std::countr_zero(mask));
+    }
+
+    for (; i < length; i++) {
+        if (!entityFor(characters[i]).empty())
+            emit(i);
+    }
+
+    memcpy(output, characters + runStart, (length - runStart) * sizeof(CharType));
+}
+
+template<typename CharType>
+static JSString* escapeHTML(JSGlobalObject* globalObject, JSString* string, std::span<const CharType> input)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    size_t extra = escapedExtraLength(input);
+    if (!extra)
+        return string;
+
+    CharType* output = nullptr;
+    RefPtr<StringImpl> impl;
+    if (input.size() + extra <= StringImpl::MaxLength)
+        impl = StringImpl::tryCreateUninitialized(input.size() + extra, output);
+    if (UNLIKELY(!impl)) {
+        throwOutOfMemoryError(globalObject, scope);
+        return nullptr;
+    }
+
+    writeEscaped(input, output);
+    return jsNontrivialString(vm, String(impl.releaseNonNull()));
+}
+
+JSString* escapeHTML(JSGlobalObject* globalObject, JSString* string)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    const String& value = string->value(globalObject);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+
+    if (value.is8Bit())
+        RELEASE_AND_RETURN(scope, escapeHTML(globalObject, string, value.span8()));
+    RELEASE_AND_RETURN(scope, escapeHTML(globalObject, string, value.span16()));
+}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// Escapes `&`, `<`, `>`, `"` and `'` for use in HTML text and attributes.
+//
+// One vectorized pass measures the escaped length, so the result is
+// allocated exactly once at its final size; a second pass copies the runs
+// between special characters. Latin-1 input stays 8-bit. When nothing
+// needs escaping the input string itself is returned.
+JSC::JSString* escapeHTML(JSC::JSGlobalObject*, JSC::JSString*);
+
+}
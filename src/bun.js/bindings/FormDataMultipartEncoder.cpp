@@ -0,0 +1,160 @@
+#include "root.h"
+#include "FormDataMultipartEncoder.h"
+
+#include "headers-handwritten.h"
+#include "helpers.h"
+
+namespace WebCore {
+
+extern "C" uint64_t Bun__Blob__getSizeForBindings(void* blob);
+// Exported by the Zig Blob, like Blob__getFileNameString.
+extern "C" BunString Blob__getContentTypeString(void* impl);
+
+FormDataMultipartEncoder::FormDataMultipartEncoder(const DOMFormData& form, const String& boundary)
+    : m_items(form.items())
+    , m_boundary(boundary.utf8())
+{
+}
+
+static void appendBytes(Vector<uint8_t>& buffer, const char* characters, size_t length)
+{
+    buffer.append(std::span { reinterpret_cast<const uint8_t*>(characters), length });
+}
+
+static void appendBytes(Vector<uint8_t>& buffer, const CString& string)
+{
+    appendBytes(buffer, string.data(), string.length());
+}
+
+static void appendLiteral(Vector<uint8_t>& buffer, ASCIILiteral literal)
+{
+    appendBytes(buffer, literal.characters(), literal.length());
+}
+
+// https://html.spec.whatwg.org/multipage/form-control-infrastructure.html#multipart/form-data-encoding-algorithm
+static void appendEscapedFieldValue(Vector<uint8_t>& buffer, const String& value)
+{
+    auto utf8 = value.utf8();
+    for (size_t i = 0; i < utf8.length(); i++) {
+        char c = utf8.data()[i];
+        switch (c) {
+        case '\n':
+            appendLiteral(buffer, "%0A"_s);
+            break;
+        case '\r':
+            appendLiteral(buffer, "%0D"_s);
+            break;
+        case '"':
+            appendLiteral(buffer, "%22"_s);
+            break;
+        default:
+            buffer.append(static_cast<uint8_t>(c));
+        }
+    }
+}
+
+void FormDataMultipartEncoder::appendPart(Vector<uint8_t>& buffer, size_t index) const
+{
+    auto& item = m_items[index];
+    // The CRLF ending the previous part's body is part of this delimiter.
+    appendLiteral(buffer, index ? "\r\n--"_s : "--"_s);
+    appendBytes(buffer, m_boundary);
+    appendLiteral(buffer, "\r\nContent-Disposition: form-data; name=\""_s);
+    appendEscapedFieldValue(buffer, item.name);
+    appendLiteral(buffer, "\""_s);
+
+    if (auto* value = std::get_if<String>(&item.data)) {
+        appendLiteral(buffer, "\r\n\r\n"_s);
+        appendBytes(buffer, value->utf8());
+        return;
+    }
+
+    auto& blob = *std::get<RefPtr<Blob>>(item.data);
+    appendLiteral(buffer, "; filename=\""_s);
+    auto fileName = blob.fileName();
+    appendEscapedFieldValue(buffer, fileName.isEmpty() ? String("blob"_s) : fileName);
+    appendLiteral(buffer, "\"\r\nContent-Type: "_s);
+    auto contentType = Blob__getContentTypeString(blob.impl()).toWTFString(BunString::ZeroCopy);
+    if (contentType.isEmpty())
+        appendLiteral(buffer, "application/octet-stream"_s);
+    else
+        appendBytes(buffer, contentType.utf8());
+    appendLiteral(buffer, "\r\n\r\n"_s);
+}
+
+void FormDataMultipartEncoder::appendClosingBoundary(Vector<uint8_t>& buffer) const
+{
+    appendLiteral(buffer, m_items.isEmpty() ? "--"_s : "\r\n--"_s);
+    appendBytes(buffer, m_boundary);
+    appendLiteral(buffer, "--\r\n"_s);
+}
+
+auto FormDataMultipartEncoder::next() -> Chunk
+{
+    m_buffer.shrink(0);
+
+    if (m_blobPending) {
+        m_blobPending = false;
+        auto& blob = *std::get<RefPtr<Blob>>(m_items[m_index++].data);
+        return { Chunk::Type::Blob, {}, blob.impl() };
+    }
+
+    while (m_index < m_items.size()) {
+        appendPart(m_buffer, m_index);
+        if (std::holds_alternative<RefPtr<Blob>>(m_items[m_index].data)) {
+            m_blobPending = true;
+            return { Chunk::Type::Bytes, m_buffer.span(), nullptr };
+        }
+        m_index++;
+    }
+
+    if (m_finished)
+        return {};
+    m_finished = true;
+    appendClosingBoundary(m_buffer);
+    return { Chunk::Type::Bytes, m_buffer.span(), nullptr };
+}
+
+uint64_t FormDataMultipartEncoder::contentLength() const
+{
+    uint64_t length = 0;
+    Vector<uint8_t> scratch;
+    for (size_t i = 0; i < m_items.size(); i++) {
+        scratch.shrink(0);
+        appendPart(scratch, i);
+        length += scratch.size();
+        if (auto* blob = std::get_if<RefPtr<Blob>>(&m_items[i].data))
+            length += Bun__Blob__getSizeForBindings((*blob)->impl());
+    }
+    scratch.shrink(0);
+    appendClosingBoundary(scratch);
+    return length + scratch.size();
+}
+
+extern "C" FormDataMultipartEncoder* FormDataMultipartEncoder__create(DOMFormData* form, const ZigString* boundary)
+{
+    return new FormDataMultipartEncoder(*form, Zig::toString(*boundary));
+}
+
+// Returns the Chunk::Type. `bytes` and `length` are set for Bytes, `blob`
+// for Blob.
+extern "C" uint8_t FormDataMultipartEncoder__next(FormDataMultipartEncoder* encoder, const uint8_t** bytes, size_t* length, void** blob)
+{
+    auto chunk = encoder->next();
+    *bytes = chunk.bytes.data();
+    *length = chunk.bytes.size();
+    *blob = chunk.blob;
+    return static_cast<uint8_t>(chunk.type);
+}
+
+extern "C" uint64_t FormDataMultipartEncoder__contentLength(FormDataMultipartEncoder* encoder)
+{
+    return encoder->contentLength();
+}
+
+extern "C" void FormDataMultipartEncoder__destroy(FormDataMultipartEncoder* encoder)
+{
+    delete encoder;
+}
+
+} // namespace WebCore
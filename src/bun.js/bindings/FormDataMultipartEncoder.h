@@ -0,0 +1,58 @@
+#pragma once
+
+#include "root.h"
+#include "DOMFormData.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// Writes a FormData as multipart/form-data one piece at a time, so a fetch
+// body never has to hold the files it uploads.
+//
+// Boundaries, part headers and string values come out as byte chunks,
+// coalesced up to the next Blob. Each Blob comes out on its own, as its
+// Zig impl pointer, so the sender can write a file-backed one with
+// sendfile (HttpResponse::sendFile on the server side) and a memory-backed
+// one straight from its store.
+//
+// The entries are snapshotted when the encoder is created, as the spec's
+// "entry list" is; changes to the FormData afterwards do not show up.
+class FormDataMultipartEncoder {
+    WTF_MAKE_NONCOPYABLE(FormDataMultipartEncoder);
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    FormDataMultipartEncoder(const DOMFormData&, const String& boundary);
+
+    struct Chunk {
+        enum class Type : uint8_t {
+            Done,
+            Bytes,
+            Blob,
+        };
+        Type type { Type::Done };
+        // Valid until the next call to next().
+        std::span<const uint8_t> bytes;
+        void* blob { nullptr };
+    };
+
+    Chunk next();
+
+    // The length of the whole body, for a Content-Length header.
+    uint64_t contentLength() const;
+
+private:
+    // All of a string entry's part, or a Blob entry's up to its bytes.
+    void appendPart(Vector<uint8_t>&, size_t index) const;
+    void appendClosingBoundary(Vector<uint8_t>&) const;
+
+    Vector<DOMFormData::Item> m_items;
+    CString m_boundary;
+    Vector<uint8_t> m_buffer;
+    size_t m_index { 0 };
+    // The headers of m_items[m_index] went out; its Blob is next.
+    bool m_blobPending { false };
+    bool m_finished { false };
+};
+
+} // namespace WebCore
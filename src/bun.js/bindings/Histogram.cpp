@@ -0,0 +1,101 @@
+#include "root.h"
+#include "Histogram.h"
+
+namespace Bun {
+
+static constexpr uint64_t subBucketCount = 1 << Histogram::subBucketBits;
+
+size_t Histogram::bucketIndex(uint64_t value)
+{
+    if (value < subBucketCount)
+        return value;
+    unsigned exponent = 63 - __builtin_clzll(value);
+    unsigned shift = exponent - subBucketBits;
+    return subBucketCount + shift * subBucketCount + ((value >> shift) - subBucketCount);
+}
+
+uint64_t Histogram::highestEquivalentValue(size_t index)
+{
+    if (index < subBucketCount)
+        return index;
+    uint64_t shift = (index - subBucketCount) / subBucketCount;
+    uint64_t subBucket = (index - subBucketCount) % subBucketCount;
+    return ((subBucketCount + subBucket) << shift) + (1ull << shift) - 1;
+}
+
+Histogram::Histogram()
+    : m_counts(bucketIndex(highestTrackableValue) + 1, 0)
+{
+}
+
+void Histogram::record(uint64_t value)
+{
+    if (value > highestTrackableValue) {
+        m_exceeds++;
+        return;
+    }
+
+    m_counts[bucketIndex(value)]++;
+    if (!m_count || value < m_min)
+        m_min = value;
+    m_max = std::max(m_max, value);
+
+    m_count++;
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+void Histogram::reset()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_exceeds = 0;
+    m_min = 0;
+    m_max = 0;
+    m_mean = 0;
+    m_m2 = 0;
+}
+
+double Histogram::stddev() const
+{
+    if (!m_count)
+        return 0;
+    return std::sqrt(m_m2 / m_count);
+}
+
+uint64_t Histogram::valueAtPercentile(double percentile) const
+{
+    if (!m_count)
+        return 0;
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * m_count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        seen += m_counts[i];
+        if (seen >= target)
+            return std::min(highestEquivalentValue(i), m_max);
+    }
+    return m_max;
+}
+
+Vector<std::pair<double, uint64_t>> Histogram::percentiles() const
+{
+    Vector<std::pair<double, uint64_t>> percentiles;
+    if (!m_count)
+        return percentiles;
+
+    percentiles.append(std::make_pair(0.0, min()));
+    double percentile = 50;
+    for (double step = 50; step > 1e-9; step /= 2, percentile += step) {
+        uint64_t value = valueAtPercentile(percentile);
+        if (value >= m_max)
+            break;
+        percentiles.append(std::make_pair(percentile, value));
+    }
+    percentiles.append(std::make_pair(100.0, m_max));
+    return percentiles;
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/Vector.h>
+
+namespace Bun {
+
+// A log-linear histogram in the spirit of HdrHistogram, for durations in
+// nanoseconds.
+//
+// Values below 64 get a bucket each. Above that, every power of two is split
+// into 64 buckets, so a value is never off by more than about 1.5% and the
+// whole range up to an hour fits in under 20KB. Recording is a shift and an
+// add, which matters when it is done on every turn of the event loop.
+class Histogram {
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    static constexpr unsigned subBucketBits = 6;
+    static constexpr uint64_t highestTrackableValue = 3600ull * 1000 * 1000 * 1000;
+
+    Histogram();
+
+    // Values above highestTrackableValue are only counted in exceeds().
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t count() const { return m_count; }
+    uint64_t exceeds() const { return m_exceeds; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? m_mean : 0; }
+    double stddev() const;
+
+    // `percentile` is in (0, 100].
+    uint64_t valueAtPercentile(double percentile) const;
+
+    // Like HdrHistogram's percentile iterator and Node's
+    // histogram.percentiles: 0, 50, 75, 87.5 and so on, closing at 100.
+    Vector<std::pair<double, uint64_t>> percentiles() const;
+
+private:
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t highestEquivalentValue(size_t index);
+
+    Vector<uint64_t> m_counts;
+    uint64_t m_count { 0 };
+    uint64_t m_exceeds { 0 };
+    uint64_t m_min { 0 };
+    uint64_t m_max { 0 };
+    // Welford's running mean and sum of squared differences.
+    double m_mean { 0 };
+    double m_m2 { 0 };
+};
+
+}
@@ -272,7 +272,7 @@ extern "C" JSC::EncodedJSValue functionImportMeta__resolveSync(JSC::JSGlobalObje
 
 extern "C" bool Bun__isBunMain(JSC::JSGlobalObject* global, const BunString*);
 
-extern "C" JSC::EncodedJSValue functionImportMeta__resolveSyncPrivate(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame)
+static JSC::EncodedJSValue resolveSyncPrivate(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame)
 {
     JSC::VM& vm = lexicalGlobalObject->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
@@ -327,8 +327,29 @@ extern "C" JSC::EncodedJSValue functionImportMeta__resolveSyncPrivate(JSC::JSGlo
         }
     }
 
+    bool canUseCache = LIKELY(globalObject) && moduleName.isString() && from.isString() && globalObject->onResolvePlugins.isEmpty();
+    String moduleString, fromString;
+    if (canUseCache) {
+        moduleString = moduleName.toWTFString(globalObject);
+        RETURN_IF_EXCEPTION(scope, JSC::JSValue::encode(JSC::JSValue {}));
+        fromString = from.toWTFString(globalObject);
+        RETURN_IF_EXCEPTION(scope, JSC::JSValue::encode(JSC::JSValue {}));
+
+        bool failed = false;
+        if (JSValue cached = globalObject->requireResolveCache.find(isESM, moduleString, fromString, failed)) {
+            if (failed) {
+                JSC::throwException(lexicalGlobalObject, scope, cached);
+                return JSC::JSValue::encode(JSC::JSValue {});
+            }
+            return JSC::JSValue::encode(cached);
+        }
+    }
+
     auto result = Bun__resolveSync(lexicalGlobalObject, JSC::JSValue::encode(moduleName), JSValue::encode(from), isESM);
 
+    if (canUseCache && JSC::JSValue::decode(result) && !scope.exception())
+        globalObject->requireResolveCache.add(vm, isESM, moduleString, fromString, JSC::JSValue::decode(result));
+
     if (!JSC::JSValue::decode(result).isString()) {
         JSC::throwException(lexicalGlobalObject, scope, JSC::JSValue::decode(result));
         return JSC::JSValue::encode(JSC::JSValue {});
@@ -338,6 +359,23 @@ extern "C" JSC::EncodedJSValue functionImportMeta__resolveSyncPrivate(JSC::JSGlo
     return result;
 }
 
+extern "C" JSC::EncodedJSValue functionImportMeta__resolveSyncPrivate(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame)
+{
+    JSC::EncodedJSValue result = resolveSyncPrivate(lexicalGlobalObject, callFrame);
+
+    // require() resolves through here, so this is where --hot sees which
+    // module a CommonJS module depends on.
+    auto* globalObject = jsDynamicCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    if (UNLIKELY(globalObject && globalObject->moduleGraph.isEnabled())) {
+        JSValue resolved = JSValue::decode(result);
+        JSValue from = callFrame->argument(1);
+        if (resolved && resolved.isString() && from.isString())
+            globalObject->moduleGraph.addImport(asString(resolved)->value(globalObject), asString(from)->value(globalObject));
+    }
+
+    return result;
+}
+
 JSC_DEFINE_HOST_FUNCTION(functionImportMeta__resolve,
     (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
@@ -1,6 +1,7 @@
 #include "InternalModuleRegistry.h"
 
 #include "ZigGlobalObject.h"
+#include "CodeCoverage.h"
 #include <JavaScriptCore/BuiltinUtils.h>
 #include <JavaScriptCore/JSFunction.h>
 #include <JavaScriptCore/LazyProperty.h>
@@ -20,7 +21,7 @@ extern "C" void ByteRangeMapping__generate(BunString sourceURL, BunString code,
 static void maybeAddCodeCoverage(JSC::VM& vm, const JSC::SourceCode& code)
 {
 #if ASSERT_ENABLED
-    bool isCodeCoverageEnabled = !!vm.controlFlowProfiler();
+    bool isCodeCoverageEnabled = Bun::isCodeCoverageEnabled(vm);
     bool shouldGenerateCodeCoverage = isCodeCoverageEnabled && BunTest__shouldGenerateCodeCoverage(Bun::toString(code.provider()->sourceURL()));
     if (shouldGenerateCodeCoverage) {
         ByteRangeMapping__generate(Bun::toString(code.provider()->sourceURL()), Bun::toString(code.provider()->source().toStringWithoutCopying()), code.provider()->asID());
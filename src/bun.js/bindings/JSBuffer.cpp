@@ -43,6 +43,11 @@
 #include <JavaScriptCore/BuiltinNames.h>
 
 #include "JSBufferEncodingType.h"
+#include "BufferConcat.h"
+#include "JSBufferCodec.h"
+#include "Base64Helpers.h"
+#include "RopeStringUTF8.h"
+#include "simdutf.h"
 #include "wtf/Assertions.h"
 #include <JavaScriptCore/JSBase.h>
 #if ENABLE(MEDIA_SOURCE)
@@ -84,10 +89,13 @@ static JSC_DECLARE_HOST_FUNCTION(jsBufferConstructorFunction_isEncoding);
 
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_compare);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_copy);
+static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_decodeInto);
+static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_encodeInto);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_equals);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_fill);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_includes);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_indexOf);
+static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_indexOfAny);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_lastIndexOf);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_swap16);
 static JSC_DECLARE_HOST_FUNCTION(jsBufferPrototypeFunction_swap32);
@@ -116,7 +124,37 @@ static JSUint8Array* allocBuffer(JSC::JSGlobalObject* lexicalGlobalObject, size_
 
     return uint8Array;
 }
-static JSUint8Array* allocBufferUnsafe(JSC::JSGlobalObject* lexicalGlobalObject, size_t byteLength)
+// Slices small allocations out of the global object's shared slab, like
+// Node's Buffer.poolSize pool. Returns nullptr when the request should get its
+// own ArrayBuffer instead. Only requests smaller than half the pool are pooled,
+// so a single Buffer never takes up most of a slab.
+static JSUint8Array* allocBufferFromPool(JSC::JSGlobalObject* lexicalGlobalObject, size_t byteLength)
+{
+    auto* globalObject = reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject);
+    const size_t poolSize = globalObject->bufferPoolSize;
+
+    if (byteLength == 0 || byteLength >= (poolSize >> 1))
+        return nullptr;
+
+    if (!globalObject->bufferPool || globalObject->bufferPool->byteLength() - globalObject->bufferPoolOffset < byteLength) {
+        auto slab = JSC::ArrayBuffer::tryCreateUninitialized(poolSize, 1);
+        if (UNLIKELY(!slab))
+            return nullptr;
+        globalObject->bufferPool = WTFMove(slab);
+        globalObject->bufferPoolOffset = 0;
+    }
+
+    const size_t offset = globalObject->bufferPoolOffset;
+    auto* uint8Array = JSC::JSUint8Array::create(lexicalGlobalObject, globalObject->JSBufferSubclassStructure(), globalObject->bufferPool.copyRef(), offset, byteLength);
+    if (UNLIKELY(!uint8Array))
+        return nullptr;
+
+    // Keep every slice 8 byte aligned so wider typed array views over it work.
+    globalObject->bufferPoolOffset = std::min(roundUpToMultipleOf<8>(offset + byteLength), globalObject->bufferPool->byteLength());
+    return uint8Array;
+}
+
+static JSUint8Array* allocBufferUnsafeSlow(JSC::JSGlobalObject* lexicalGlobalObject, size_t byteLength)
 {
 
 #if ASSERT_ENABLED
@@ -136,6 +174,25 @@ static JSUint8Array* allocBufferUnsafe(JSC::JSGlobalObject* lexicalGlobalObject,
     return result;
 }
 
+static JSUint8Array* allocBufferUnsafe(JSC::JSGlobalObject* lexicalGlobalObject, size_t byteLength)
+{
+    if (auto* pooled = allocBufferFromPool(lexicalGlobalObject, byteLength))
+        return pooled;
+
+    return allocBufferUnsafeSlow(lexicalGlobalObject, byteLength);
+}
+
+// Buffer.from(string) results are copied in, so they can come from the pool too.
+static JSUint8Array* createPooledBuffer(JSC::JSGlobalObject* lexicalGlobalObject, const uint8_t* ptr, size_t length)
+{
+    auto* buffer = allocBufferUnsafe(lexicalGlobalObject, length);
+
+    if (LIKELY(ptr && length > 0 && buffer))
+        memcpy(buffer->typedVector(), ptr, length);
+
+    return buffer;
+}
+
 // Normalize val to be an integer in the range of [1, -1] since
 // implementations of memcmp() can vary by platform.
 static int normalizeCompareVal(int val, size_t a_length, size_t b_length)
@@ -243,6 +300,12 @@ static inline JSC::EncodedJSValue writeToBuffer(JSC::JSGlobalObject* lexicalGlob
     if (UNLIKELY(str->length() == 0))
         return JSC::JSValue::encode(JSC::jsNumber(0));
 
+    // Encode a rope fiber by fiber rather than flattening it first.
+    if (encoding == WebCore::BufferEncodingType::utf8 && str->isRope()) {
+        size_t written = Bun::writeStringAsUTF8(lexicalGlobalObject, str, { reinterpret_cast<uint8_t*>(castedThis->vector()) + offset, length });
+        return JSC::JSValue::encode(JSC::jsNumber(written));
+    }
+
     const auto& view = str->tryGetValue(lexicalGlobalObject);
     size_t written = 0;
 
@@ -332,6 +395,7 @@ extern "C" JSC::EncodedJSValue JSBuffer__bufferFromLength(JSC::JSGlobalObject* l
     return JSC::JSValue::encode(JSBuffer__bufferFromLengthAsArray(lexicalGlobalObject, length));
 }
 
+template<bool usePool>
 static inline JSC::EncodedJSValue jsBufferConstructorFunction_allocUnsafeBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame)
 {
 
@@ -357,7 +421,11 @@ static inline JSC::EncodedJSValue jsBufferConstructorFunction_allocUnsafeBody(JS
 
     size_t length = static_cast<size_t>(lengthDouble);
 
-    RELEASE_AND_RETURN(throwScope, JSValue::encode(allocBufferUnsafe(lexicalGlobalObject, length)));
+    if constexpr (usePool) {
+        RELEASE_AND_RETURN(throwScope, JSValue::encode(allocBufferUnsafe(lexicalGlobalObject, length)));
+    } else {
+        RELEASE_AND_RETURN(throwScope, JSValue::encode(allocBufferUnsafeSlow(lexicalGlobalObject, length)));
+    }
 }
 
 // new Buffer()
@@ -371,6 +439,14 @@ static JSC::EncodedJSValue constructFromEncoding(JSGlobalObject* lexicalGlobalOb
     auto& vm = JSC::getVM(lexicalGlobalObject);
     auto scope = DECLARE_THROW_SCOPE(vm);
 
+    if (encoding == WebCore::BufferEncodingType::utf8 && str->isRope()) {
+        size_t byteLength = Bun::utf8LengthOfString(lexicalGlobalObject, str);
+        auto* buffer = allocBufferUnsafe(lexicalGlobalObject, byteLength);
+        RETURN_IF_EXCEPTION(scope, {});
+        Bun::writeStringAsUTF8(lexicalGlobalObject, str, { buffer->typedVector(), byteLength });
+        return JSValue::encode(buffer);
+    }
+
     const auto& view = str->tryGetValue(lexicalGlobalObject);
     JSC::EncodedJSValue result;
 
@@ -390,7 +466,7 @@ static JSC::EncodedJSValue constructFromEncoding(JSGlobalObject* lexicalGlobalOb
         }
         case WebCore::BufferEncodingType::ascii: // ascii is a noop for latin1
         case WebCore::BufferEncodingType::latin1: { // The native encoding is latin1, so we don't need to do any conversion.
-            result = JSValue::encode(createBuffer(lexicalGlobalObject, span.data(), span.size()));
+            result = JSValue::encode(createPooledBuffer(lexicalGlobalObject, span.data(), span.size()));
             break;
         }
         default: {
@@ -414,7 +490,7 @@ static JSC::EncodedJSValue constructFromEncoding(JSGlobalObject* lexicalGlobalOb
         case WebCore::BufferEncodingType::utf16le: {
             // The native encoding is UTF-16
             // so we don't need to do any conversion.
-            result = JSValue::encode(createBuffer(lexicalGlobalObject, reinterpret_cast<const unsigned char*>(span.data()), span.size() * 2));
+            result = JSValue::encode(createPooledBuffer(lexicalGlobalObject, reinterpret_cast<const unsigned char*>(span.data()), span.size() * 2));
             break;
         }
         default: {
@@ -564,7 +640,7 @@ static inline JSC::EncodedJSValue jsBufferConstructorFunction_allocBody(JSC::JSG
 
 static inline JSC::EncodedJSValue jsBufferConstructorFunction_allocUnsafeSlowBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame)
 {
-    return jsBufferConstructorFunction_allocUnsafeBody(lexicalGlobalObject, callFrame);
+    return jsBufferConstructorFunction_allocUnsafeBody<false>(lexicalGlobalObject, callFrame);
 }
 
 // new SlowBuffer(size)
@@ -632,6 +708,11 @@ static inline JSC::EncodedJSValue jsBufferByteLengthFromStringAndEncoding(JSC::J
     }
 
     case WebCore::BufferEncodingType::utf8: {
+        if (str->isRope()) {
+            written = Bun::utf8LengthOfString(lexicalGlobalObject, str);
+            break;
+        }
+
         const auto& view = str->tryGetValue(lexicalGlobalObject);
         if (view.is8Bit()) {
             const auto span = view.span8();
@@ -803,7 +884,7 @@ static inline JSC::EncodedJSValue jsBufferConstructorFunction_concatBody(JSC::JS
     }
 
     for (unsigned i = 0; i < arrayLength; i++) {
-        auto element = array->getIndex(lexicalGlobalObject, i);
+        auto element = Bun::BufferConcat::getElement(lexicalGlobalObject, array, i);
         RETURN_IF_EXCEPTION(throwScope, {});
 
         auto* typedArray = JSC::jsDynamicCast<JSC::JSUint8Array*>(element);
@@ -856,9 +937,9 @@ static inline JSC::EncodedJSValue jsBufferConstructorFunction_concatBody(JSC::JS
     }
 
     size_t remain = byteLength;
-    auto* head = outBuffer->typedVector();
-    const int arrayLengthI = arrayLength;
-    for (int i = 0; i < arrayLengthI && remain > 0; i++) {
+    Vector<std::span<const uint8_t>, 16> segments;
+    segments.reserveInitialCapacity(args.size());
+    for (size_t i = 0; i < args.size() && remain > 0; i++) {
         auto* typedArray = JSC::jsCast<JSC::JSUint8Array*>(args.at(i));
         size_t length = std::min(remain, typedArray->length());
 
@@ -866,12 +947,13 @@ static inline JSC::EncodedJSValue jsBufferConstructorFunction_concatBody(JSC::JS
 
         auto* source = typedArray->typedVector();
         ASSERT(source);
-        memcpy(head, source, length);
+        segments.append(std::span { source, length });
 
         remain -= length;
-        head += length;
     }
 
+    Bun::BufferConcat::copySegments(outBuffer->typedVector(), std::span { segments.data(), segments.size() }, byteLength - remain);
+
     RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(JSC::JSValue(outBuffer)));
 }
 
@@ -1250,14 +1332,100 @@ static int64_t indexOf(const uint8_t* thisPtr, int64_t thisLength, const uint8_t
     return -1;
 }
 
+// Reverse memchr. Scans a word at a time from the end, using the carry-free
+// zero byte test so the highest matching byte in a word is exact.
+static int64_t reverseFindByte(const uint8_t* ptr, int64_t length, uint8_t byte)
+{
+    constexpr uint64_t lowBits = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t pattern = 0x0101010101010101ULL * byte;
+    int64_t i = length;
+
+    while (i >= 8) {
+        uint64_t word;
+        memcpy(&word, ptr + i - 8, sizeof(word));
+        uint64_t v = word ^ pattern;
+        uint64_t zeros = ~(((v & lowBits) + lowBits) | v | lowBits);
+        if (zeros) {
+            return i - 8 + static_cast<int64_t>((63 - __builtin_clzll(zeros)) / 8);
+        }
+        i -= 8;
+    }
+
+    while (i > 0) {
+        --i;
+        if (ptr[i] == byte) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 static int64_t lastIndexOf(const uint8_t* thisPtr, int64_t thisLength, const uint8_t* valuePtr, int64_t valueLength, int64_t byteOffset)
 {
-    auto start = thisPtr;
-    auto end = thisPtr + std::min(thisLength, byteOffset + valueLength);
-    auto it = std::find_end(start, end, valuePtr, valuePtr + valueLength);
-    if (it != end) {
-        return it - thisPtr;
+    if (valueLength <= 0 || thisLength < valueLength)
+        return -1;
+
+    // Find the last byte of the needle scanning backwards, then verify the
+    // rest of it in place. Every candidate start is at most byteOffset.
+    const int64_t tail = valueLength - 1;
+    const uint8_t lastByte = valuePtr[tail];
+    int64_t limit = std::min(thisLength, byteOffset + valueLength);
+
+    while (limit > tail) {
+        int64_t start = reverseFindByte(thisPtr + tail, limit - tail, lastByte);
+        if (start < 0)
+            return -1;
+        if (!tail || memcmp(thisPtr + start, valuePtr, static_cast<size_t>(tail)) == 0)
+            return start;
+        limit = start + tail;
     }
+
+    return -1;
+}
+
+// Earliest position at or after byteOffset where any of the needles starts.
+// Candidates are filtered on the needles' first bytes in a single pass, so the
+// haystack is read once instead of once per needle.
+static int64_t indexOfAny(const uint8_t* thisPtr, int64_t thisLength, const Vector<Vector<uint8_t>>& needles, int64_t byteOffset)
+{
+    std::array<bool, 256> firstBytes {};
+    unsigned distinctFirstBytes = 0;
+    size_t shortest = std::numeric_limits<size_t>::max();
+    uint8_t onlyFirstByte = 0;
+
+    for (auto& needle : needles) {
+        if (needle.isEmpty())
+            return byteOffset <= thisLength ? byteOffset : -1;
+        shortest = std::min(shortest, needle.size());
+        if (!firstBytes[needle[0]]) {
+            firstBytes[needle[0]] = true;
+            onlyFirstByte = needle[0];
+            distinctFirstBytes++;
+        }
+    }
+
+    if (!distinctFirstBytes || thisLength - byteOffset < static_cast<int64_t>(shortest))
+        return -1;
+
+    const int64_t lastStart = thisLength - static_cast<int64_t>(shortest);
+    for (int64_t i = byteOffset; i <= lastStart; i++) {
+        if (distinctFirstBytes == 1) {
+            auto* found = static_cast<const uint8_t*>(memchr(thisPtr + i, onlyFirstByte, static_cast<size_t>(lastStart - i + 1)));
+            if (!found)
+                return -1;
+            i = found - thisPtr;
+        } else if (!firstBytes[thisPtr[i]]) {
+            continue;
+        }
+
+        const int64_t remaining = thisLength - i;
+        for (auto& needle : needles) {
+            if (needle[0] == thisPtr[i] && static_cast<int64_t>(needle.size()) <= remaining && memcmp(thisPtr + i, needle.data(), needle.size()) == 0)
+                return i;
+        }
+    }
+
     return -1;
 }
 
@@ -1337,11 +1505,7 @@ static int64_t indexOf(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame*
         RETURN_IF_EXCEPTION(scope, -1);
 
         if (last) {
-            for (int64_t i = byteOffset; i >= 0; --i) {
-                if (byteValue == typedVector[i]) {
-                    return i;
-                }
-            }
+            return reverseFindByte(typedVector, byteOffset + 1, byteValue);
         } else {
             const void* offset = memchr(reinterpret_cast<const void*>(typedVector + byteOffset), byteValue, length - byteOffset);
             if (offset != NULL) {
@@ -1366,6 +1530,154 @@ static int64_t indexOf(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame*
     return -1;
 }
 
+static inline JSC::EncodedJSValue jsBufferPrototypeFunction_indexOfAnyBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
+{
+    auto& vm = JSC::getVM(lexicalGlobalObject);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* array = JSC::jsDynamicCast<JSC::JSArray*>(callFrame->argument(0));
+    if (!array) {
+        throwTypeError(lexicalGlobalObject, scope, "Argument must be an array"_s);
+        return JSValue::encode(jsUndefined());
+    }
+
+    int64_t length = static_cast<int64_t>(castedThis->byteLength());
+    int64_t byteOffset = 0;
+    WebCore::BufferEncodingType encoding = WebCore::BufferEncodingType::utf8;
+
+    if (callFrame->argumentCount() > 1) {
+        EnsureStillAliveScope arg1 = callFrame->uncheckedArgument(1);
+        if (arg1.value().isString()) {
+            encoding = parseEncoding(lexicalGlobalObject, scope, arg1.value());
+            RETURN_IF_EXCEPTION(scope, {});
+        } else if (!arg1.value().isUndefined()) {
+            auto byteOffset_ = arg1.value().toNumber(lexicalGlobalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+
+            if (!std::isnan(byteOffset_) && !std::isinf(byteOffset_)) {
+                byteOffset = byteOffset_ < 0 ? length + static_cast<int64_t>(byteOffset_) : static_cast<int64_t>(byteOffset_);
+            }
+
+            if (byteOffset < 0) {
+                byteOffset = 0;
+            } else if (byteOffset > length) {
+                return JSValue::encode(jsNumber(-1));
+            }
+
+            if (callFrame->argumentCount() > 2) {
+                EnsureStillAliveScope encodingValue = callFrame->uncheckedArgument(2);
+                if (!encodingValue.value().isUndefined()) {
+                    encoding = parseEncoding(lexicalGlobalObject, scope, encodingValue.value());
+                    RETURN_IF_EXCEPTION(scope, {});
+                }
+            }
+        }
+    }
+
+    // The needles are copied out so that encoding a later string needle can
+    // not collect the buffers of the earlier ones.
+    size_t arrayLength = array->length();
+    Vector<Vector<uint8_t>> needles;
+    needles.reserveInitialCapacity(arrayLength);
+
+    for (unsigned i = 0; i < arrayLength; i++) {
+        auto element = array->getIndex(lexicalGlobalObject, i);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        if (element.isString()) {
+            auto* str = element.toStringOrNull(lexicalGlobalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+
+            JSC::EncodedJSValue encodedBuffer = constructFromEncoding(lexicalGlobalObject, str, encoding);
+            RETURN_IF_EXCEPTION(scope, {});
+            auto* encoded = JSC::jsCast<JSC::JSUint8Array*>(JSC::JSValue::decode(encodedBuffer));
+            needles.append(std::span { encoded->typedVector(), encoded->byteLength() });
+        } else if (element.isNumber()) {
+            uint8_t byteValue = static_cast<uint8_t>((element.toInt32(lexicalGlobalObject)) % 256);
+            RETURN_IF_EXCEPTION(scope, {});
+            needles.append(Vector<uint8_t> { byteValue });
+        } else if (auto* typedArray = JSC::jsDynamicCast<JSC::JSUint8Array*>(element)) {
+            needles.append(std::span { typedArray->typedVector(), typedArray->byteLength() });
+        } else {
+            throwTypeError(lexicalGlobalObject, scope, "Invalid value type"_s);
+            return JSValue::encode(jsUndefined());
+        }
+    }
+
+    // Reading the array elements can run getters which may shrink this buffer.
+    length = std::min(length, static_cast<int64_t>(castedThis->byteLength()));
+    if (byteOffset > length) {
+        return JSValue::encode(jsNumber(-1));
+    }
+
+    return JSValue::encode(jsNumber(indexOfAny(castedThis->typedVector(), length, needles, byteOffset)));
+}
+// Shared by encodeInto() and decodeInto(): the receiver is the source, the
+// first argument the caller-provided target. Only base64, base64url and hex
+// have a fixed ratio between input and output, which is what makes chunking
+// without intermediate strings possible.
+template<bool isDecode>
+static inline JSC::EncodedJSValue jsBufferTranscodeInto(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
+{
+    auto& vm = JSC::getVM(lexicalGlobalObject);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* target = JSC::jsDynamicCast<JSC::JSArrayBufferView*>(callFrame->argument(0));
+    if (UNLIKELY(!target)) {
+        throwTypeError(lexicalGlobalObject, scope, "target must be a TypedArray or DataView"_s);
+        return {};
+    }
+
+    auto encoding = parseEncoding(lexicalGlobalObject, scope, callFrame->argument(1));
+    RETURN_IF_EXCEPTION(scope, {});
+
+    bool final = callFrame->argument(2).isUndefined() || callFrame->argument(2).toBoolean(lexicalGlobalObject);
+
+    if (UNLIKELY(target->isDetached() || castedThis->isDetached())) {
+        throwTypeError(lexicalGlobalObject, scope, "ArrayBufferView is detached"_s);
+        return {};
+    }
+
+    std::span<const uint8_t> input { castedThis->typedVector(), castedThis->byteLength() };
+    std::span<uint8_t> output { static_cast<uint8_t*>(target->vector()), target->byteLength() };
+
+    Bun::EncodingChunkResult result;
+    switch (encoding) {
+    case WebCore::BufferEncodingType::base64:
+    case WebCore::BufferEncodingType::base64url: {
+        bool url = encoding == WebCore::BufferEncodingType::base64url;
+        result = isDecode ? Bun::Base64::decodeChunk(input, output, url, final) : Bun::Base64::encodeChunk(input, output, url, final);
+        if (UNLIKELY(result.invalidInput)) {
+            throwTypeError(lexicalGlobalObject, scope, "Invalid base64 input"_s);
+            return {};
+        }
+        break;
+    }
+    case WebCore::BufferEncodingType::hex:
+        // Invalid hex stops the decode early, the way Buffer.from(string, "hex") does.
+        result = isDecode ? Bun::Hex::decodeChunk(input, output) : Bun::Hex::encodeChunk(input, output);
+        break;
+    default:
+        throwTypeError(lexicalGlobalObject, scope, "encoding must be \"base64\", \"base64url\" or \"hex\""_s);
+        return {};
+    }
+
+    auto* object = JSC::constructEmptyObject(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), 2);
+    object->putDirect(vm, JSC::Identifier::fromString(vm, "read"_s), jsNumber(result.read), 0);
+    object->putDirect(vm, JSC::Identifier::fromString(vm, "written"_s), jsNumber(result.written), 0);
+    return JSValue::encode(object);
+}
+
+static inline JSC::EncodedJSValue jsBufferPrototypeFunction_decodeIntoBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
+{
+    return jsBufferTranscodeInto<true>(lexicalGlobalObject, callFrame, castedThis);
+}
+
+static inline JSC::EncodedJSValue jsBufferPrototypeFunction_encodeIntoBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
+{
+    return jsBufferTranscodeInto<false>(lexicalGlobalObject, callFrame, castedThis);
+}
+
 static inline JSC::EncodedJSValue jsBufferPrototypeFunction_includesBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
 {
     auto index = indexOf(lexicalGlobalObject, callFrame, castedThis, false);
@@ -1521,10 +1833,29 @@ static inline JSC::EncodedJSValue jsBufferToString(JSC::VM& vm, JSC::JSGlobalObj
         return JSC::JSValue::encode(JSC::jsString(vm, WTFMove(str)));
     }
 
+    case WebCore::BufferEncodingType::base64:
+    case WebCore::BufferEncodingType::base64url: {
+        // Encode straight into the string's own storage.
+        auto options = encoding == WebCore::BufferEncodingType::base64url ? simdutf::base64_url : simdutf::base64_default;
+        size_t encodedLength = simdutf::base64_length_from_binary(length, options);
+        if (UNLIKELY(encodedLength > WTF::String::MaxLength)) {
+            throwOutOfMemoryError(lexicalGlobalObject, scope);
+            return JSC::JSValue::encode(jsUndefined());
+        }
+
+        LChar* data = nullptr;
+        auto impl = StringImpl::tryCreateUninitialized(encodedLength, data);
+        if (UNLIKELY(!impl)) {
+            throwOutOfMemoryError(lexicalGlobalObject, scope);
+            return JSC::JSValue::encode(jsUndefined());
+        }
+
+        simdutf::binary_to_base64(reinterpret_cast<const char*>(castedThis->typedVector() + offset), length, reinterpret_cast<char*>(data), options);
+        return JSC::JSValue::encode(JSC::jsString(vm, String(impl.releaseNonNull())));
+    }
+
     case WebCore::BufferEncodingType::buffer:
     case WebCore::BufferEncodingType::utf8:
-    case WebCore::BufferEncodingType::base64:
-    case WebCore::BufferEncodingType::base64url:
     case WebCore::BufferEncodingType::hex: {
         ret = Bun__encoding__toString(castedThis->typedVector() + offset, length, lexicalGlobalObject, static_cast<uint8_t>(encoding));
         break;
@@ -1591,29 +1922,55 @@ static inline JSC::EncodedJSValue jsBufferPrototypeFunction_toStringBody(JSC::JS
     return jsBufferToString(vm, lexicalGlobalObject, castedThis, start, end > start ? end - start : 0, encoding);
 }
 
-// DOMJIT makes it slower! TODO: investigate why
-// JSC_DECLARE_JIT_OPERATION_WITHOUT_WTF_INTERNAL(jsBufferPrototypeToStringWithoutTypeChecks, JSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::JSUint8Array* thisValue, JSC::JSString* encodingValue));
+// buffer.toString(encoding) and buffer.write(string) are what protocol
+// parsers call in their hot loops, so optimized code calls these directly
+// for exactly those shapes. Anything else goes through the host functions.
+static JSC_DECLARE_JIT_OPERATION_WITHOUT_WTF_INTERNAL(jsBufferPrototypeToStringWithoutTypeChecks, JSC::EncodedJSValue, (JSC::JSGlobalObject*, JSC::JSUint8Array*, JSC::JSString*));
+static JSC_DECLARE_JIT_OPERATION_WITHOUT_WTF_INTERNAL(jsBufferPrototypeWriteWithoutTypeChecks, JSC::EncodedJSValue, (JSC::JSGlobalObject*, JSC::JSUint8Array*, JSC::JSString*));
 
-// JSC_DEFINE_JIT_OPERATION(jsBufferPrototypeToStringWithoutTypeChecks, JSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSUint8Array* thisValue, JSString* encodingValue))
-// {
-//     VM& vm = JSC::getVM(lexicalGlobalObject);
-//     IGNORE_WARNINGS_BEGIN("frame-address")
-//     CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
-//     IGNORE_WARNINGS_END
-//     JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+JSC_DEFINE_JIT_OPERATION(jsBufferPrototypeToStringWithoutTypeChecks, JSC::EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::JSUint8Array* thisValue, JSC::JSString* encodingValue))
+{
+    VM& vm = JSC::getVM(lexicalGlobalObject);
+    IGNORE_WARNINGS_BEGIN("frame-address")
+    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
+    IGNORE_WARNINGS_END
+    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+    auto scope = DECLARE_THROW_SCOPE(vm);
 
-//     std::optional<BufferEncodingType> encoded = parseEnumeration<BufferEncodingType>(*lexicalGlobalObject, encodingValue);
-//     if (!encoded) {
-//         auto scope = DECLARE_THROW_SCOPE(vm);
+    size_t length = thisValue->length();
+    if (length == 0)
+        return JSC::JSValue::encode(JSC::jsEmptyString(vm));
 
-//         throwTypeError(lexicalGlobalObject, scope, "Invalid encoding"_s);
-//         return {};
-//     }
+    auto encoding = parseEncoding(lexicalGlobalObject, scope, encodingValue);
+    RETURN_IF_EXCEPTION(scope, {});
 
-//     auto encoding = encoded.value();
+    RELEASE_AND_RETURN(scope, jsBufferToString(vm, lexicalGlobalObject, thisValue, 0, length, encoding));
+}
 
-//     return JSValue::decode(jsBufferToString(vm, lexicalGlobalObject, thisValue, 0, thisValue->byteLength(), encoding));
-// }
+JSC_DEFINE_JIT_OPERATION(jsBufferPrototypeWriteWithoutTypeChecks, JSC::EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::JSUint8Array* thisValue, JSC::JSString* string))
+{
+    VM& vm = JSC::getVM(lexicalGlobalObject);
+    IGNORE_WARNINGS_BEGIN("frame-address")
+    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
+    IGNORE_WARNINGS_END
+    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+
+    return writeToBuffer(lexicalGlobalObject, thisValue, string, 0, thisValue->byteLength(), WebCore::BufferEncodingType::utf8);
+}
+
+static const JSC::DOMJIT::Signature DOMJITSignatureForJSBufferPrototypeToString(
+    jsBufferPrototypeToStringWithoutTypeChecks,
+    JSC::JSUint8Array::info(),
+    JSC::DOMJIT::Effect::forRead(JSC::DOMJIT::HeapRange::top()),
+    JSC::SpecString,
+    JSC::SpecString);
+
+static const JSC::DOMJIT::Signature DOMJITSignatureForJSBufferPrototypeWrite(
+    jsBufferPrototypeWriteWithoutTypeChecks,
+    JSC::JSUint8Array::info(),
+    JSC::DOMJIT::Effect::forDef(JSC::DOMJIT::HeapRange::top(), JSC::DOMJIT::HeapRange::top(), JSC::DOMJIT::HeapRange::top()),
+    JSC::SpecBytecodeNumber,
+    JSC::SpecString);
 
 static inline JSC::EncodedJSValue jsBufferPrototypeFunction_writeBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSArrayBufferView>::ClassParameter castedThis)
 {
@@ -1739,7 +2096,7 @@ JSC_DEFINE_HOST_FUNCTION(jsBufferConstructorFunction_alloc, (JSGlobalObject * le
 }
 JSC_DEFINE_HOST_FUNCTION(jsBufferConstructorFunction_allocUnsafe, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
 {
-    return jsBufferConstructorFunction_allocUnsafeBody(lexicalGlobalObject, callFrame);
+    return jsBufferConstructorFunction_allocUnsafeBody<true>(lexicalGlobalObject, callFrame);
 }
 JSC_DEFINE_HOST_FUNCTION(jsBufferConstructorFunction_allocUnsafeSlow, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
 {
@@ -1834,7 +2191,7 @@ JSC_DEFINE_JIT_OPERATION(jsBufferConstructorAllocUnsafeSlowWithoutTypeChecks, JS
     CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
     IGNORE_WARNINGS_END
     JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
-    return allocBufferUnsafe(lexicalGlobalObject, byteLength);
+    return allocBufferUnsafeSlow(lexicalGlobalObject, byteLength);
 }
 
 JSC_ANNOTATE_HOST_FUNCTION(JSBufferConstructorConstruct, JSBufferConstructor::construct);
@@ -1862,6 +2219,14 @@ JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_copy, (JSGlobalObject * lexic
 {
     return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_copyBody>(*lexicalGlobalObject, *callFrame, "copy");
 }
+JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_decodeInto, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_decodeIntoBody>(*lexicalGlobalObject, *callFrame, "decodeInto");
+}
+JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_encodeInto, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_encodeIntoBody>(*lexicalGlobalObject, *callFrame, "encodeInto");
+}
 JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_equals, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
 {
     return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_equalsBody>(*lexicalGlobalObject, *callFrame, "equals");
@@ -1878,6 +2243,10 @@ JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_indexOf, (JSGlobalObject * le
 {
     return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_indexOfBody>(*lexicalGlobalObject, *callFrame, "indexOf");
 }
+JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_indexOfAny, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_indexOfAnyBody>(*lexicalGlobalObject, *callFrame, "indexOfAny");
+}
 JSC_DEFINE_HOST_FUNCTION(jsBufferPrototypeFunction_lastIndexOf, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
 {
     return IDLOperation<JSArrayBufferView>::call<jsBufferPrototypeFunction_lastIndexOfBody>(*lexicalGlobalObject, *callFrame, "lastIndexOf");
@@ -1917,12 +2286,15 @@ static const HashTableValue JSBufferPrototypeTableValues[]
           { "base64urlWrite"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeBase64urlWriteCodeGenerator, 1 } },
           { "compare"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_compare, 5 } },
           { "copy"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_copy, 4 } },
+          { "decodeInto"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_decodeInto, 3 } },
+          { "encodeInto"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_encodeInto, 3 } },
           { "equals"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_equals, 1 } },
           { "fill"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_fill, 4 } },
           { "hexSlice"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeHexSliceCodeGenerator, 2 } },
           { "hexWrite"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeHexWriteCodeGenerator, 1 } },
           { "includes"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_includes, 3 } },
           { "indexOf"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_indexOf, 3 } },
+          { "indexOfAny"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_indexOfAny, 3 } },
           { "inspect"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeInspectCodeGenerator, 2 } },
           { "lastIndexOf"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_lastIndexOf, 3 } },
           { "latin1Slice"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeLatin1SliceCodeGenerator, 2 } },
@@ -1975,14 +2347,12 @@ static const HashTableValue JSBufferPrototypeTableValues[]
           { "swap64"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_swap64, 0 } },
           { "toJSON"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeToJSONCodeGenerator, 1 } },
           { "toLocaleString"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_toString, 4 } },
-          { "toString"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_toString, 4 } },
           { "ucs2Slice"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUcs2SliceCodeGenerator, 2 } },
           { "ucs2Write"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUcs2WriteCodeGenerator, 1 } },
           { "utf16leSlice"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUtf16leSliceCodeGenerator, 2 } },
           { "utf16leWrite"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUtf16leWriteCodeGenerator, 1 } },
           { "utf8Slice"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUtf8SliceCodeGenerator, 2 } },
           { "utf8Write"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeUtf8WriteCodeGenerator, 1 } },
-          { "write"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBufferPrototypeFunction_write, 4 } },
           { "writeBigInt64BE"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeWriteBigInt64BECodeGenerator, 1 } },
           { "writeBigInt64LE"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeWriteBigInt64LECodeGenerator, 1 } },
           { "writeBigUInt64BE"_s, static_cast<unsigned>(JSC::PropertyAttribute::Builtin), NoIntrinsic, { HashTableValue::BuiltinGeneratorType, jsBufferPrototypeWriteBigUInt64BECodeGenerator, 1 } },
@@ -2028,6 +2398,14 @@ void JSBufferPrototype::finishCreation(VM& vm, JSC::JSGlobalObject* globalThis)
     Base::finishCreation(vm);
     JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
     reifyStaticProperties(vm, JSBuffer::info(), JSBufferPrototypeTableValues, *this);
+
+    // Not in the table: a DOMJIT entry there would take its length from the signature.
+    putDirect(vm, vm.propertyNames->toString,
+        JSC::JSFunction::create(vm, globalThis, 4, "toString"_s, jsBufferPrototypeFunction_toString, ImplementationVisibility::Public, NoIntrinsic, jsBufferPrototypeFunction_toString, &DOMJITSignatureForJSBufferPrototypeToString),
+        static_cast<unsigned>(JSC::PropertyAttribute::Function));
+    putDirect(vm, Identifier::fromString(vm, "write"_s),
+        JSC::JSFunction::create(vm, globalThis, 4, "write"_s, jsBufferPrototypeFunction_write, ImplementationVisibility::Public, NoIntrinsic, jsBufferPrototypeFunction_write, &DOMJITSignatureForJSBufferPrototypeWrite),
+        static_cast<unsigned>(JSC::PropertyAttribute::Function));
 }
 
 const ClassInfo JSBufferPrototype::s_info = {
@@ -2046,6 +2424,7 @@ const ClassInfo JSBufferPrototype::s_info = {
     byteLength      jsBufferConstructorFunction_byteLength         Function 2
     compare         jsBufferConstructorFunction_compare            Function 2
     concat          jsBufferConstructorFunction_concat             Function 2
+    defineCodec     jsBufferConstructorFunction_defineCodec        Function 1
     from            JSBuiltin                                      Builtin|Function 1
     isBuffer        JSBuiltin                                      Builtin|Function 1
     isEncoding      jsBufferConstructorFunction_isEncoding         Function 1
@@ -2055,10 +2434,34 @@ const ClassInfo JSBufferPrototype::s_info = {
 
 const ClassInfo JSBufferConstructor::s_info = { "Buffer"_s, &Base::s_info, &jsBufferConstructorTable, nullptr, CREATE_METHOD_TABLE(JSBufferConstructor) };
 
+static JSC_DEFINE_CUSTOM_GETTER(jsBufferConstructorGetter_poolSize, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, JSC::PropertyName))
+{
+    auto* globalObject = reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject);
+    return JSValue::encode(jsNumber(globalObject->bufferPoolSize));
+}
+
+static JSC_DEFINE_CUSTOM_SETTER(jsBufferConstructorSetter_poolSize, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, JSC::EncodedJSValue encodedValue, JSC::PropertyName))
+{
+    auto& vm = JSC::getVM(lexicalGlobalObject);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject);
+
+    double poolSize = JSValue::decode(encodedValue).toIntegerOrInfinity(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, false);
+
+    // Anything that is not a sane size turns pooling off. The current slab is
+    // kept; the new size applies from the next slab on.
+    globalObject->bufferPoolSize = poolSize > 0 && poolSize <= static_cast<double>(UINT32_MAX) ? static_cast<size_t>(poolSize) : 0;
+    return true;
+}
+
 void JSBufferConstructor::finishCreation(VM& vm, JSGlobalObject* globalObject, JSC::JSObject* prototype)
 {
     Base::finishCreation(vm, 3, "Buffer"_s, PropertyAdditionMode::WithoutStructureTransition);
     putDirectWithoutTransition(vm, vm.propertyNames->prototype, prototype, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+    putDirectCustomAccessor(vm, JSC::Identifier::fromString(vm, "poolSize"_s),
+        JSC::CustomGetterSetter::create(vm, jsBufferConstructorGetter_poolSize, jsBufferConstructorSetter_poolSize),
+        JSC::PropertyAttribute::CustomValue);
     prototype->putDirect(vm, vm.propertyNames->speciesSymbol, this, PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
 }
 
@@ -0,0 +1,475 @@
+#include "root.h"
+#include "JSBufferCodec.h"
+
+#include "ZigGlobalObject.h"
+#include <JavaScriptCore/JSArrayBufferView.h>
+#include <JavaScriptCore/JSBigInt.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/ObjectConstructor.h>
+#include <JavaScriptCore/StructureCache.h>
+#include <wtf/FlipBytes.h>
+
+namespace WebCore {
+
+using namespace JSC;
+
+enum class BufferCodecType : uint8_t {
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64,
+    BigInt64,
+    BigUInt64,
+};
+
+struct BufferCodecTypeName {
+    ASCIILiteral name;
+    BufferCodecType type;
+    uint8_t size;
+    bool bigEndian;
+};
+
+static constexpr BufferCodecTypeName bufferCodecTypeNames[] = {
+    { "i8"_s, BufferCodecType::Int8, 1, false },
+    { "u8"_s, BufferCodecType::UInt8, 1, false },
+    { "i16le"_s, BufferCodecType::Int16, 2, false },
+    { "i16be"_s, BufferCodecType::Int16, 2, true },
+    { "u16le"_s, BufferCodecType::UInt16, 2, false },
+    { "u16be"_s, BufferCodecType::UInt16, 2, true },
+    { "i32le"_s, BufferCodecType::Int32, 4, false },
+    { "i32be"_s, BufferCodecType::Int32, 4, true },
+    { "u32le"_s, BufferCodecType::UInt32, 4, false },
+    { "u32be"_s, BufferCodecType::UInt32, 4, true },
+    { "f32le"_s, BufferCodecType::Float32, 4, false },
+    { "f32be"_s, BufferCodecType::Float32, 4, true },
+    { "f64le"_s, BufferCodecType::Float64, 8, false },
+    { "f64be"_s, BufferCodecType::Float64, 8, true },
+    { "i64le"_s, BufferCodecType::BigInt64, 8, false },
+    { "i64be"_s, BufferCodecType::BigInt64, 8, true },
+    { "u64le"_s, BufferCodecType::BigUInt64, 8, false },
+    { "u64be"_s, BufferCodecType::BigUInt64, 8, true },
+};
+
+struct BufferCodecField {
+    Identifier name;
+    uint32_t offset;
+    BufferCodecType type;
+    uint8_t size;
+    bool bigEndian;
+};
+
+class BufferCodec : public RefCounted<BufferCodec> {
+public:
+    static Ref<BufferCodec> create() { return adoptRef(*new BufferCodec); }
+
+    Vector<BufferCodecField> fields;
+    size_t byteLength { 0 };
+
+    // Structure every decoded record starts out with, holding all the fields in
+    // order. Null when the fields can not all be inline properties, in which
+    // case records are built with putDirect instead.
+    Strong<Structure> structure;
+};
+
+template<typename T>
+static ALWAYS_INLINE T loadField(const uint8_t* ptr, bool bigEndian)
+{
+    T value;
+    memcpy(&value, ptr, sizeof(T));
+#if CPU(BIG_ENDIAN)
+    bool needsFlip = !bigEndian;
+#else
+    bool needsFlip = bigEndian;
+#endif
+    return needsFlip ? flipBytes(value) : value;
+}
+
+template<typename T>
+static ALWAYS_INLINE void storeField(uint8_t* ptr, T value, bool bigEndian)
+{
+#if CPU(BIG_ENDIAN)
+    bool needsFlip = !bigEndian;
+#else
+    bool needsFlip = bigEndian;
+#endif
+    if (needsFlip)
+        value = flipBytes(value);
+    memcpy(ptr, &value, sizeof(T));
+}
+
+static JSValue decodeField(JSGlobalObject* globalObject, const BufferCodecField& field, const uint8_t* record)
+{
+    const uint8_t* ptr = record + field.offset;
+    switch (field.type) {
+    case BufferCodecType::Int8:
+        return jsNumber(static_cast<int8_t>(*ptr));
+    case BufferCodecType::UInt8:
+        return jsNumber(*ptr);
+    case BufferCodecType::Int16:
+        return jsNumber(static_cast<int16_t>(loadField<uint16_t>(ptr, field.bigEndian)));
+    case BufferCodecType::UInt16:
+        return jsNumber(loadField<uint16_t>(ptr, field.bigEndian));
+    case BufferCodecType::Int32:
+        return jsNumber(static_cast<int32_t>(loadField<uint32_t>(ptr, field.bigEndian)));
+    case BufferCodecType::UInt32:
+        return jsNumber(loadField<uint32_t>(ptr, field.bigEndian));
+    case BufferCodecType::Float32:
+        return jsNumber(purifyNaN(bitwise_cast<float>(loadField<uint32_t>(ptr, field.bigEndian))));
+    case BufferCodecType::Float64:
+        return jsNumber(purifyNaN(bitwise_cast<double>(loadField<uint64_t>(ptr, field.bigEndian))));
+    case BufferCodecType::BigInt64:
+        return JSBigInt::createFrom(globalObject, static_cast<int64_t>(loadField<uint64_t>(ptr, field.bigEndian)));
+    case BufferCodecType::BigUInt64:
+        return JSBigInt::createFrom(globalObject, loadField<uint64_t>(ptr, field.bigEndian));
+    }
+
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+static JSObject* decodeRecord(JSGlobalObject* globalObject, const BufferCodec& codec, const uint8_t* record)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (Structure* structure = codec.structure.get()) {
+        JSObject* object = constructEmptyObject(vm, structure);
+        for (unsigned i = 0; i < codec.fields.size(); i++) {
+            JSValue value = decodeField(globalObject, codec.fields[i], record);
+            RETURN_IF_EXCEPTION(scope, nullptr);
+            object->putDirectOffset(vm, i, value);
+        }
+        return object;
+    }
+
+    JSObject* object = constructEmptyObject(globalObject, globalObject->objectPrototype(), std::min(static_cast<unsigned>(codec.fields.size()), JSFinalObject::maxInlineCapacity));
+    for (const auto& field : codec.fields) {
+        JSValue value = decodeField(globalObject, field, record);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+        object->putDirect(vm, field.name, value, 0);
+    }
+    return object;
+}
+
+// Resolves the buffer argument and a record offset into it, checking that at
+// least one whole record fits. Returns nullptr after throwing otherwise.
+static JSArrayBufferView* codecBufferArgument(JSGlobalObject* globalObject, ThrowScope& scope, const BufferCodec& codec, JSValue bufferValue, JSValue offsetValue, size_t& offset)
+{
+    auto* view = jsDynamicCast<JSArrayBufferView*>(bufferValue);
+    if (UNLIKELY(!view)) {
+        throwTypeError(globalObject, scope, "Expected a Buffer, TypedArray or DataView"_s);
+        return nullptr;
+    }
+
+    double offsetDouble = 0;
+    if (!offsetValue.isUndefined()) {
+        offsetDouble = offsetValue.toIntegerOrInfinity(globalObject);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+    }
+
+    // Converting the offset may have run user code, so check the view after.
+    if (UNLIKELY(view->isDetached())) {
+        throwTypeError(globalObject, scope, "ArrayBufferView is detached"_s);
+        return nullptr;
+    }
+
+    if (UNLIKELY(offsetDouble < 0 || offsetDouble > static_cast<double>(view->byteLength()))) {
+        throwRangeError(globalObject, scope, "Offset is out of bounds"_s);
+        return nullptr;
+    }
+    offset = static_cast<size_t>(offsetDouble);
+
+    if (UNLIKELY(view->byteLength() - offset < codec.byteLength)) {
+        throwRangeError(globalObject, scope, "Attempt to access memory outside buffer bounds"_s);
+        return nullptr;
+    }
+
+    return view;
+}
+
+static EncodedJSValue codecDecode(const BufferCodec& codec, JSGlobalObject* globalObject, CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    size_t offset = 0;
+    auto* view = codecBufferArgument(globalObject, scope, codec, callFrame->argument(0), callFrame->argument(1), offset);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    const uint8_t* record = static_cast<const uint8_t*>(view->vector()) + offset;
+    RELEASE_AND_RETURN(scope, JSValue::encode(decodeRecord(globalObject, codec, record)));
+}
+
+static EncodedJSValue codecDecodeMany(const BufferCodec& codec, JSGlobalObject* globalObject, CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue countValue = callFrame->argument(1);
+    JSValue offsetValue = callFrame->argument(2);
+
+    auto* view = jsDynamicCast<JSArrayBufferView*>(callFrame->argument(0));
+    if (UNLIKELY(!view)) {
+        throwTypeError(globalObject, scope, "Expected a Buffer, TypedArray or DataView"_s);
+        return {};
+    }
+
+    double offsetDouble = 0;
+    if (!offsetValue.isUndefined()) {
+        offsetDouble = offsetValue.toIntegerOrInfinity(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    double countDouble = std::numeric_limits<double>::infinity();
+    if (!countValue.isUndefined()) {
+        countDouble = countValue.toIntegerOrInfinity(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    // The conversions above may have run user code, so the view is only
+    // measured from here on.
+    if (UNLIKELY(view->isDetached())) {
+        throwTypeError(globalObject, scope, "ArrayBufferView is detached"_s);
+        return {};
+    }
+
+    if (UNLIKELY(offsetDouble < 0 || offsetDouble > static_cast<double>(view->byteLength()))) {
+        throwRangeError(globalObject, scope, "Offset is out of bounds"_s);
+        return {};
+    }
+
+    size_t offset = static_cast<size_t>(offsetDouble);
+    size_t available = (view->byteLength() - offset) / codec.byteLength;
+    size_t count = available;
+    if (!countValue.isUndefined()) {
+        if (UNLIKELY(countDouble < 0 || countDouble > static_cast<double>(available))) {
+            throwRangeError(globalObject, scope, "Attempt to access memory outside buffer bounds"_s);
+            return {};
+        }
+        count = static_cast<size_t>(countDouble);
+    }
+
+    JSArray* result = constructEmptyArray(globalObject, nullptr, count);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    // Decoding never runs user code, so the view can not change size while the
+    // records are read.
+    const uint8_t* record = static_cast<const uint8_t*>(view->vector()) + offset;
+    for (size_t i = 0; i < count; i++, record += codec.byteLength) {
+        JSObject* object = decodeRecord(globalObject, codec, record);
+        RETURN_IF_EXCEPTION(scope, {});
+        result->putDirectIndex(globalObject, i, object);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    return JSValue::encode(result);
+}
+
+static EncodedJSValue codecEncode(const BufferCodec& codec, JSGlobalObject* globalObject, CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* object = callFrame->argument(0).getObject();
+    if (UNLIKELY(!object)) {
+        throwTypeError(globalObject, scope, "Expected an object to encode"_s);
+        return {};
+    }
+
+    // Read every field before touching the buffer, since property getters and
+    // valueOf() may detach or shrink it.
+    Vector<uint64_t, 16> values;
+    values.reserveInitialCapacity(codec.fields.size());
+    for (const auto& field : codec.fields) {
+        JSValue value = object->get(globalObject, field.name);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        uint64_t bits = 0;
+        switch (field.type) {
+        case BufferCodecType::Int8:
+        case BufferCodecType::UInt8:
+        case BufferCodecType::Int16:
+        case BufferCodecType::UInt16:
+        case BufferCodecType::Int32:
+        case BufferCodecType::UInt32:
+            bits = value.toUInt32(globalObject);
+            break;
+        case BufferCodecType::Float32:
+            bits = bitwise_cast<uint32_t>(static_cast<float>(value.toNumber(globalObject)));
+            break;
+        case BufferCodecType::Float64:
+            bits = bitwise_cast<uint64_t>(value.toNumber(globalObject));
+            break;
+        case BufferCodecType::BigInt64:
+            bits = static_cast<uint64_t>(value.toBigInt64(globalObject));
+            break;
+        case BufferCodecType::BigUInt64:
+            bits = value.toBigUInt64(globalObject);
+            break;
+        }
+        RETURN_IF_EXCEPTION(scope, {});
+        values.append(bits);
+    }
+
+    size_t offset = 0;
+    auto* view = codecBufferArgument(globalObject, scope, codec, callFrame->argument(1), callFrame->argument(2), offset);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    uint8_t* record = static_cast<uint8_t*>(view->vector()) + offset;
+    for (unsigned i = 0; i < codec.fields.size(); i++) {
+        const auto& field = codec.fields[i];
+        uint8_t* ptr = record + field.offset;
+        switch (field.size) {
+        case 1:
+            *ptr = static_cast<uint8_t>(values[i]);
+            break;
+        case 2:
+            storeField<uint16_t>(ptr, static_cast<uint16_t>(values[i]), field.bigEndian);
+            break;
+        case 4:
+            storeField<uint32_t>(ptr, static_cast<uint32_t>(values[i]), field.bigEndian);
+            break;
+        case 8:
+            storeField<uint64_t>(ptr, values[i], field.bigEndian);
+            break;
+        }
+    }
+
+    return JSValue::encode(jsNumber(offset + codec.byteLength));
+}
+
+static Structure* createCodecStructure(JSGlobalObject* globalObject, const BufferCodec& codec)
+{
+    auto& vm = globalObject->vm();
+
+    if (codec.fields.size() > JSFinalObject::maxInlineCapacity)
+        return nullptr;
+
+    for (const auto& field : codec.fields) {
+        // Index-like names are elements, not structure properties.
+        if (parseIndex(field.name))
+            return nullptr;
+    }
+
+    Structure* structure = globalObject->structureCache().emptyObjectStructureForPrototype(globalObject, globalObject->objectPrototype(), codec.fields.size());
+    PropertyOffset offset;
+    for (const auto& field : codec.fields) {
+        structure = Structure::addPropertyTransition(vm, structure, field.name, 0, offset);
+    }
+    return structure;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsBufferConstructorFunction_defineCodec, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* array = jsDynamicCast<JSArray*>(callFrame->argument(0));
+    if (UNLIKELY(!array)) {
+        throwTypeError(globalObject, scope, "Buffer.defineCodec expects an array of fields"_s);
+        return {};
+    }
+
+    auto codec = BufferCodec::create();
+    size_t byteLength = 0;
+    HashSet<RefPtr<UniquedStringImpl>> seenNames;
+
+    for (unsigned i = 0, length = array->length(); i < length; i++) {
+        JSValue entry = array->getIndex(globalObject, i);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        auto* entryObject = entry.getObject();
+        if (UNLIKELY(!entryObject)) {
+            throwTypeError(globalObject, scope, "Each field must be an object like { u32le: \"name\" }"_s);
+            return {};
+        }
+
+        PropertyNameArray properties(vm, PropertyNameMode::Strings, PrivateSymbolMode::Exclude);
+        entryObject->getPropertyNames(globalObject, properties, DontEnumPropertiesMode::Exclude);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        if (UNLIKELY(properties.size() != 1)) {
+            throwTypeError(globalObject, scope, "Each field must have exactly one type key"_s);
+            return {};
+        }
+
+        const Identifier& typeName = properties[0];
+        JSValue value = entryObject->get(globalObject, typeName);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        if (typeName.string() == "pad"_s) {
+            double padding = value.toIntegerOrInfinity(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (UNLIKELY(padding < 0 || padding > static_cast<double>(UINT32_MAX))) {
+                throwRangeError(globalObject, scope, "pad must be a non-negative byte count"_s);
+                return {};
+            }
+            byteLength += static_cast<size_t>(padding);
+            continue;
+        }
+
+        const BufferCodecTypeName* type = nullptr;
+        for (const auto& candidate : bufferCodecTypeNames) {
+            if (typeName.string() == candidate.name) {
+                type = &candidate;
+                break;
+            }
+        }
+
+        if (UNLIKELY(!type)) {
+            throwTypeError(globalObject, scope, makeString("Unknown field type \""_s, typeName.string(), "\""_s));
+            return {};
+        }
+
+        if (UNLIKELY(!value.isString())) {
+            throwTypeError(globalObject, scope, "Field names must be strings"_s);
+            return {};
+        }
+
+        auto name = value.toString(globalObject)->toIdentifier(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+
+        if (UNLIKELY(!seenNames.add(name.impl()).isNewEntry)) {
+            throwTypeError(globalObject, scope, makeString("Duplicate field name \""_s, name.string(), "\""_s));
+            return {};
+        }
+
+        codec->fields.append({ WTFMove(name), static_cast<uint32_t>(byteLength), type->type, type->size, type->bigEndian });
+        byteLength += type->size;
+    }
+
+    if (UNLIKELY(codec->fields.isEmpty() || byteLength > UINT32_MAX)) {
+        throwTypeError(globalObject, scope, "Buffer.defineCodec expects at least one field and a record smaller than 4 GB"_s);
+        return {};
+    }
+
+    codec->byteLength = byteLength;
+    if (auto* structure = createCodecStructure(globalObject, codec))
+        codec->structure.set(vm, structure);
+
+    JSObject* result = constructEmptyObject(globalObject, globalObject->objectPrototype(), 4);
+    result->putDirect(vm, Identifier::fromString(vm, "byteLength"_s), jsNumber(byteLength), PropertyAttribute::ReadOnly | 0);
+
+    result->putDirect(vm, Identifier::fromString(vm, "decode"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "decode"_s, [codec = RefPtr { codec.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            return codecDecode(*codec, globalObject, callFrame);
+        }),
+        0);
+    result->putDirect(vm, Identifier::fromString(vm, "decodeMany"_s),
+        JSNativeStdFunction::create(vm, globalObject, 3, "decodeMany"_s, [codec = RefPtr { codec.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            return codecDecodeMany(*codec, globalObject, callFrame);
+        }),
+        0);
+    result->putDirect(vm, Identifier::fromString(vm, "encode"_s),
+        JSNativeStdFunction::create(vm, globalObject, 3, "encode"_s, [codec = RefPtr { codec.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            return codecEncode(*codec, globalObject, callFrame);
+        }),
+        0);
+
+    return JSValue::encode(result);
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "root.h"
+
+namespace WebCore {
+
+// Buffer.defineCodec(fields)
+//
+// Compiles a fixed layout binary record description, e.g.
+//
+//     Buffer.defineCodec([{ u32be: "id" }, { pad: 4 }, { f64le: "price" }])
+//
+// into an object with `byteLength`, `decode(buffer, offset)`,
+// `decodeMany(buffer, count, offset)` and `encode(object, buffer, offset)`.
+// Decoded records all share one Structure, so each record is a single
+// allocation plus direct slot stores.
+JSC_DECLARE_HOST_FUNCTION(jsBufferConstructorFunction_defineCodec);
+
+}
@@ -33,6 +33,22 @@ void JSBufferList::finishCreation(JSC::VM& vm, JSC::JSGlobalObject* globalObject
         JSC::PropertyAttribute::DontDelete | JSC::PropertyAttribute::ReadOnly);
 }
 
+bool JSBufferList::materializeFirst(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject)
+{
+    if (LIKELY(!m_firstOffset))
+        return true;
+
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto* array = JSC::jsCast<JSC::JSUint8Array*>(m_deque.first().get());
+    const size_t byteLength = array->byteLength();
+    const size_t offset = std::min(std::exchange(m_firstOffset, 0), byteLength);
+    auto* subclassStructure = reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject)->JSBufferSubclassStructure();
+    JSC::JSUint8Array* rest = JSC::JSUint8Array::create(lexicalGlobalObject, subclassStructure, array->possiblySharedBuffer(), array->byteOffset() + offset, byteLength - offset);
+    RETURN_IF_EXCEPTION(throwScope, false);
+    m_deque.first().set(vm, this, rest);
+    return true;
+}
+
 JSC::JSValue JSBufferList::concat(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, size_t n)
 {
     auto throwScope = DECLARE_THROW_SCOPE(vm);
@@ -44,6 +60,10 @@ JSC::JSValue JSBufferList::concat(JSC::VM& vm, JSC::JSGlobalObject* lexicalGloba
 
     auto iter = m_deque.begin();
     if (len == 1) {
+        if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject))) {
+            ASSERT(throwScope.exception());
+            return {};
+        }
         auto array = JSC::jsDynamicCast<JSC::JSUint8Array*>(iter->get());
         if (UNLIKELY(!array)) {
             return throwTypeError(lexicalGlobalObject, throwScope, "concat can only be called when all buffers are Uint8Array"_s);
@@ -61,19 +81,23 @@ JSC::JSValue JSBufferList::concat(JSC::VM& vm, JSC::JSGlobalObject* lexicalGloba
     }
 
     size_t i = 0;
+    size_t sourceOffset = m_firstOffset;
     for (const auto end = m_deque.end(); iter != end; ++iter) {
         auto array = JSC::jsDynamicCast<JSC::JSUint8Array*>(iter->get());
         if (UNLIKELY(!array)) {
             return throwTypeError(lexicalGlobalObject, throwScope, "concat can only be called when all buffers are Uint8Array"_s);
         }
-        const size_t length = array->byteLength();
+        const size_t byteLength = array->byteLength();
+        sourceOffset = std::min(sourceOffset, byteLength);
+        const size_t length = byteLength - sourceOffset;
         if (UNLIKELY(i + length > n)) {
             return throwRangeError(lexicalGlobalObject, throwScope, "specified size too small to fit all buffers"_s);
         }
-        if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, i, array, 0, length, JSC::CopyType::Unobservable))) {
+        if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, i, array, sourceOffset, length, JSC::CopyType::Unobservable))) {
             return throwOutOfMemoryError(lexicalGlobalObject, throwScope);
         }
         i += length;
+        sourceOffset = 0;
     }
 
     memset(uint8Array->typedVector() + i, 0, n - i);
@@ -87,6 +111,10 @@ JSC::JSValue JSBufferList::join(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalO
     if (length() == 0) {
         RELEASE_AND_RETURN(throwScope, JSC::jsEmptyString(vm));
     }
+    if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject))) {
+        ASSERT(throwScope.exception());
+        return {};
+    }
     const bool needSeq = seq->length() != 0;
     const auto end = m_deque.end();
     JSRopeString::RopeBuilder<RecordOverflow> ropeBuilder(vm);
@@ -117,6 +145,10 @@ JSC::JSValue JSBufferList::_getString(JSC::VM& vm, JSC::JSGlobalObject* lexicalG
     if (total <= 0 || length() == 0) {
         RELEASE_AND_RETURN(throwScope, JSC::jsEmptyString(vm));
     }
+    if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject))) {
+        ASSERT(throwScope.exception());
+        return {};
+    }
 
     JSC::JSString* str = JSC::jsDynamicCast<JSC::JSString*>(m_deque.first().get());
     if (UNLIKELY(!str)) {
@@ -174,19 +206,23 @@ JSC::JSValue JSBufferList::_getBuffer(JSC::VM& vm, JSC::JSGlobalObject* lexicalG
     if (UNLIKELY(!array)) {
         return throwTypeError(lexicalGlobalObject, throwScope, "_getBuffer can only be called when all buffers are Uint8Array"_s);
     }
-    const size_t len = array->byteLength();
+    const size_t byteLength = array->byteLength();
+    const size_t start = std::min(m_firstOffset, byteLength);
+    const size_t len = byteLength - start;
     size_t n = total;
 
-    if (n == len) {
-        m_deque.removeFirst();
+    if (n == len && !start) {
+        removeFirst();
         RELEASE_AND_RETURN(throwScope, array);
     }
-    if (n < len) {
-        auto buffer = array->possiblySharedBuffer();
-        auto off = array->byteOffset();
-        JSC::JSUint8Array* retArray = JSC::JSUint8Array::create(lexicalGlobalObject, subclassStructure, buffer, off, n);
-        JSC::JSUint8Array* newArray = JSC::JSUint8Array::create(lexicalGlobalObject, subclassStructure, buffer, off + n, len - n);
-        m_deque.first().set(vm, this, newArray);
+    if (n <= len) {
+        // Within the first chunk: a view, and the rest stays where it is.
+        JSC::JSUint8Array* retArray = JSC::JSUint8Array::create(lexicalGlobalObject, subclassStructure, array->possiblySharedBuffer(), array->byteOffset() + start, n);
+        RETURN_IF_EXCEPTION(throwScope, {});
+        if (n == len)
+            removeFirst();
+        else
+            m_firstOffset = start + n;
         RELEASE_AND_RETURN(throwScope, retArray);
     }
 
@@ -197,6 +233,7 @@ JSC::JSValue JSBufferList::_getBuffer(JSC::VM& vm, JSC::JSGlobalObject* lexicalG
         return {};
     }
 
+    // Only the bytes that span chunk boundaries are copied.
     size_t offset = 0;
     while (m_deque.size() > 0) {
         auto& element = m_deque.first();
@@ -204,22 +241,21 @@ JSC::JSValue JSBufferList::_getBuffer(JSC::VM& vm, JSC::JSGlobalObject* lexicalG
         if (UNLIKELY(!array)) {
             return throwTypeError(lexicalGlobalObject, throwScope, "_getBuffer can only be called when all buffers are Uint8Array"_s);
         }
-        const size_t len = array->byteLength();
+        const size_t byteLength = array->byteLength();
+        const size_t start = std::min(m_firstOffset, byteLength);
+        const size_t len = byteLength - start;
         if (n < len) {
-            if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, offset, array, 0, n, JSC::CopyType::Unobservable))) {
+            if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, offset, array, start, n, JSC::CopyType::Unobservable))) {
                 return throwOutOfMemoryError(lexicalGlobalObject, throwScope);
             }
-            auto buffer = array->possiblySharedBuffer();
-            auto off = array->byteOffset();
-            JSC::JSUint8Array* newArray = JSC::JSUint8Array::create(lexicalGlobalObject, subclassStructure, buffer, off + n, len - n);
-            element.set(vm, this, newArray);
+            m_firstOffset = start + n;
             offset += n;
             break;
         }
-        if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, offset, array, 0, len, JSC::CopyType::Unobservable))) {
+        if (UNLIKELY(!uint8Array->setFromTypedArray(lexicalGlobalObject, offset, array, start, len, JSC::CopyType::Unobservable))) {
             return throwOutOfMemoryError(lexicalGlobalObject, throwScope);
         }
-        m_deque.removeFirst();
+        removeFirst();
         if (n == len) {
             offset += len;
             break;
@@ -281,14 +317,14 @@ static inline JSC::EncodedJSValue jsBufferListPrototypeFunction_unshiftBody(JSC:
     }
 
     auto v = callFrame->uncheckedArgument(0);
-    castedThis->unshift(vm, v);
+    castedThis->unshift(vm, lexicalGlobalObject, v);
     RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(JSC::jsUndefined()));
 }
 static inline JSC::EncodedJSValue jsBufferListPrototypeFunction_shiftBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSBufferList>::ClassParameter castedThis)
 {
     auto& vm = JSC::getVM(lexicalGlobalObject);
     auto throwScope = DECLARE_THROW_SCOPE(vm);
-    RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(castedThis->shift()));
+    RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(castedThis->shift(vm, lexicalGlobalObject)));
 }
 static inline JSC::EncodedJSValue jsBufferListPrototypeFunction_clearBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSBufferList>::ClassParameter castedThis)
 {
@@ -301,7 +337,7 @@ static inline JSC::EncodedJSValue jsBufferListPrototypeFunction_firstBody(JSC::J
 {
     auto& vm = JSC::getVM(lexicalGlobalObject);
     auto throwScope = DECLARE_THROW_SCOPE(vm);
-    RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(castedThis->first()));
+    RELEASE_AND_RETURN(throwScope, JSC::JSValue::encode(castedThis->first(vm, lexicalGlobalObject)));
 }
 static inline JSC::EncodedJSValue jsBufferListPrototypeFunction_concatBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSBufferList>::ClassParameter castedThis)
 {
@@ -53,15 +53,20 @@ public:
         m_deque.append(WriteBarrier<JSC::Unknown>());
         m_deque.last().set(vm, this, v);
     }
-    void unshift(JSC::VM& vm, JSC::JSValue v)
+    bool unshift(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSC::JSValue v)
     {
+        if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject)))
+            return false;
         m_deque.prepend(WriteBarrier<JSC::Unknown>());
         m_deque.first().set(vm, this, v);
+        return true;
     }
-    JSC::JSValue shift()
+    JSC::JSValue shift(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject)
     {
         if (UNLIKELY(length() == 0))
             return JSC::jsUndefined();
+        if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject)))
+            return {};
         auto v = m_deque.first().get();
         m_deque.removeFirst();
         return v;
@@ -69,11 +74,14 @@ public:
     void clear()
     {
         m_deque.clear();
+        m_firstOffset = 0;
     }
-    JSC::JSValue first()
+    JSC::JSValue first(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject)
     {
         if (UNLIKELY(length() == 0))
             return JSC::jsUndefined();
+        if (UNLIKELY(!materializeFirst(vm, lexicalGlobalObject)))
+            return {};
         return JSC::JSValue(m_deque.first().get());
     }
 
@@ -84,7 +92,20 @@ public:
     JSC::JSValue _getString(JSC::VM&, JSC::JSGlobalObject*, size_t);
 
 private:
+    // Replaces the first chunk with a view of its unconsumed bytes, for
+    // callers that hand it out or look at it as a whole. False on exception.
+    bool materializeFirst(JSC::VM&, JSC::JSGlobalObject*);
+    void removeFirst()
+    {
+        m_deque.removeFirst();
+        m_firstOffset = 0;
+    }
+
     Deque<WriteBarrier<JSC::Unknown>> m_deque;
+    // Bytes of the first chunk (a Uint8Array) that _getBuffer() already
+    // returned. Deferring the view over the rest means a consume() that
+    // ends inside a chunk allocates only the view it returns.
+    size_t m_firstOffset { 0 };
 };
 
 class JSBufferListPrototype : public JSC::JSNonFinalObject {
@@ -23,6 +23,12 @@
 #include <JavaScriptCore/LazyPropertyInlines.h>
 #include <JavaScriptCore/VMTrapsInlines.h>
 #include <JavaScriptCore/YarrMatchingContextHolder.h>
+#include <JavaScriptCore/YarrFlags.h>
+
+#if !OS(WINDOWS)
+#include <dlfcn.h>
+#endif
+
 namespace Bun {
 
 #define WRAP_BUNDLER_PLUGIN(argName) jsNumber(bitwise_cast<double>(reinterpret_cast<uintptr_t>(argName)))
@@ -37,73 +43,182 @@ JSC_DECLARE_HOST_FUNCTION(jsBundlerPluginFunction_addFilter);
 JSC_DECLARE_HOST_FUNCTION(jsBundlerPluginFunction_addError);
 JSC_DECLARE_HOST_FUNCTION(jsBundlerPluginFunction_onLoadAsync);
 JSC_DECLARE_HOST_FUNCTION(jsBundlerPluginFunction_onResolveAsync);
+JSC_DECLARE_HOST_FUNCTION(jsBundlerPluginFunction_addNativePlugin);
+
+#if OS(WINDOWS)
+extern "C" HMODULE Bun__LoadLibraryBunString(BunString*);
+#endif
+
+void BundlerPlugin::FilterGroup::append(StringView pattern, OptionSet<Yarr::Flags> flags)
+{
+    filters.append(Yarr::RegularExpression(pattern, flags));
+    affixes.append(PluginFilterAffixes(pattern, flags));
+
+    if (filters.size() == 1)
+        combinedFlags = flags;
+    canCombine = canCombine && flags == combinedFlags && canCombinePluginFilter(pattern);
+    if (!canCombine) {
+        combined = std::nullopt;
+        combinedPattern = String();
+        return;
+    }
+
+    combinedPattern = filters.size() == 1
+        ? makeString("(?:"_s, pattern, ')')
+        : makeString(combinedPattern, "|(?:"_s, pattern, ')');
+    if (filters.size() == 1)
+        return;
+
+    combined.emplace(combinedPattern, combinedFlags);
+    if (!combined->isValid()) {
+        combined = std::nullopt;
+        combinedPattern = String();
+        canCombine = false;
+    }
+}
+
+bool BundlerPlugin::FilterGroup::anyMatchesCrossThread(JSC::VM& vm, const String& path) const
+{
+    constexpr bool usesPatternContextBuffer = false;
+
+    size_t candidates = 0;
+    size_t lastCandidate = 0;
+    for (size_t i = 0; i < affixes.size(); i++) {
+        if (affixes[i].mayMatch(path)) {
+            candidates++;
+            lastCandidate = i;
+        }
+    }
+    if (!candidates)
+        return false;
+
+    Yarr::MatchingContextHolder regExpContext(vm, usesPatternContextBuffer, nullptr, Yarr::MatchFrom::CompilerThread);
+    if (candidates == 1)
+        return filters[lastCandidate].match(path) > -1;
+    if (combined)
+        return combined->match(path) > -1;
+
+    for (size_t i = 0; i < filters.size(); i++) {
+        if (affixes[i].mayMatch(path) && filters[i].match(path) > -1)
+            return true;
+    }
+    return false;
+}
 
 void BundlerPlugin::NamespaceList::append(JSC::VM& vm, JSC::RegExp* filter, String& namespaceString)
+{
+    append(StringView(filter->pattern()), filter->flags(), namespaceString);
+}
+
+void BundlerPlugin::NamespaceList::append(StringView pattern, OptionSet<Yarr::Flags> flags, String& namespaceString)
 {
     auto* nsGroup = group(namespaceString);
 
     if (nsGroup == nullptr) {
         namespaces.append(namespaceString);
-        groups.append(Vector<Yarr::RegularExpression> {});
+        groups.append(FilterGroup {});
         nsGroup = &groups.last();
     }
 
-    Yarr::RegularExpression regex(
-        StringView(filter->pattern()),
-        filter->flags());
-
-    nsGroup->append(WTFMove(regex));
+    nsGroup->append(pattern, flags);
 }
 
 bool BundlerPlugin::anyMatchesCrossThread(JSC::VM& vm, const BunString* namespaceStr, const BunString* path, bool isOnLoad)
 {
-    constexpr bool usesPatternContextBuffer = false;
-    if (isOnLoad) {
-        if (this->onLoad.fileNamespace.isEmpty() && this->onLoad.namespaces.isEmpty())
-            return false;
+    auto& list = isOnLoad ? this->onLoad : this->onResolve;
+    if (list.fileNamespace.isEmpty() && list.namespaces.isEmpty())
+        return false;
 
-        // Avoid unnecessary string copies
-        auto namespaceString = namespaceStr ? namespaceStr->toWTFString(BunString::ZeroCopy) : String();
+    // Avoid unnecessary string copies
+    auto namespaceString = namespaceStr ? namespaceStr->toWTFString(BunString::ZeroCopy) : String();
 
-        auto* group = this->onLoad.group(namespaceString);
-        if (group == nullptr) {
-            return false;
-        }
-
-        auto& filters = *group;
-        auto pathString = path->toWTFString(BunString::ZeroCopy);
+    auto* group = list.group(namespaceString);
+    if (group == nullptr) {
+        return false;
+    }
 
-        for (auto& filter : filters) {
-            Yarr::MatchingContextHolder regExpContext(vm, usesPatternContextBuffer, nullptr, Yarr::MatchFrom::CompilerThread);
-            if (filter.match(pathString) > -1) {
-                return true;
-            }
-        }
+    auto pathString = path->toWTFString(BunString::ZeroCopy);
+    return group->anyMatchesCrossThread(vm, pathString);
+}
 
-    } else {
-        if (this->onResolve.fileNamespace.isEmpty() && this->onResolve.namespaces.isEmpty())
-            return false;
+static bun_native_plugin_string toNativePluginString(const CString& string)
+{
+    return { string.data(), string.length() };
+}
 
-        // Avoid unnecessary string copies
-        auto namespaceString = namespaceStr ? namespaceStr->toWTFString(BunString::ZeroCopy) : String();
+// Native plugins see "file" where the filters keep an empty namespace.
+static String nativePluginNamespace(const BunString* namespaceStr)
+{
+    auto namespaceString = namespaceStr ? namespaceStr->toWTFString(BunString::ZeroCopy) : String();
+    if (namespaceString == "file"_s)
+        return String();
+    return namespaceString;
+}
 
-        auto* group = this->onResolve.group(namespaceString);
-        if (group == nullptr) {
-            return false;
+bun_native_plugin_status BundlerPlugin::runNativeOnResolveCrossThread(JSC::VM& vm, const BunString* namespaceStr, const BunString* path, const BunString* importer, uint8_t kind, bun_native_plugin_resolve_result* result, const bun_native_plugin** owner)
+{
+    if (nativePlugins.isEmpty())
+        return BUN_NATIVE_PLUGIN_SKIP;
+
+    auto namespaceString = nativePluginNamespace(namespaceStr);
+    auto pathString = path->toWTFString(BunString::ZeroCopy);
+    // Only converted once some plugin's filter matches.
+    std::optional<CString> pathUTF8, importerUTF8, namespaceUTF8;
+
+    for (auto& plugin : nativePlugins) {
+        if (!plugin.descriptor->on_resolve)
+            continue;
+        auto* group = plugin.onResolve.group(namespaceString);
+        if (!group || !group->anyMatchesCrossThread(vm, pathString))
+            continue;
+
+        if (!pathUTF8) {
+            pathUTF8 = pathString.utf8();
+            importerUTF8 = importer ? importer->toWTFString(BunString::ZeroCopy).utf8() : CString("");
+            namespaceUTF8 = namespaceString.isEmpty() ? CString("file") : namespaceString.utf8();
         }
+        bun_native_plugin_resolve_args args { toNativePluginString(*pathUTF8), toNativePluginString(*importerUTF8), toNativePluginString(*namespaceUTF8), kind };
+        *result = {};
+        auto status = plugin.descriptor->on_resolve(plugin.descriptor->data, &args, result);
+        if (status != BUN_NATIVE_PLUGIN_SKIP) {
+            *owner = plugin.descriptor;
+            return status;
+        }
+    }
 
-        auto pathString = path->toWTFString(BunString::ZeroCopy);
-        auto& filters = *group;
+    return BUN_NATIVE_PLUGIN_SKIP;
+}
 
-        for (auto& filter : filters) {
-            Yarr::MatchingContextHolder regExpContext(vm, usesPatternContextBuffer, nullptr, Yarr::MatchFrom::CompilerThread);
-            if (filter.match(pathString) > -1) {
-                return true;
-            }
+bun_native_plugin_status BundlerPlugin::runNativeOnLoadCrossThread(JSC::VM& vm, const BunString* namespaceStr, const BunString* path, bun_native_plugin_load_result* result, const bun_native_plugin** owner)
+{
+    if (nativePlugins.isEmpty())
+        return BUN_NATIVE_PLUGIN_SKIP;
+
+    auto namespaceString = nativePluginNamespace(namespaceStr);
+    auto pathString = path->toWTFString(BunString::ZeroCopy);
+    std::optional<CString> pathUTF8, namespaceUTF8;
+
+    for (auto& plugin : nativePlugins) {
+        if (!plugin.descriptor->on_load)
+            continue;
+        auto* group = plugin.onLoad.group(namespaceString);
+        if (!group || !group->anyMatchesCrossThread(vm, pathString))
+            continue;
+
+        if (!pathUTF8) {
+            pathUTF8 = pathString.utf8();
+            namespaceUTF8 = namespaceString.isEmpty() ? CString("file") : namespaceString.utf8();
+        }
+        bun_native_plugin_load_args args { toNativePluginString(*pathUTF8), toNativePluginString(*namespaceUTF8) };
+        *result = {};
+        auto status = plugin.descriptor->on_load(plugin.descriptor->data, &args, result);
+        if (status != BUN_NATIVE_PLUGIN_SKIP) {
+            *owner = plugin.descriptor;
+            return status;
         }
     }
 
-    return false;
+    return BUN_NATIVE_PLUGIN_SKIP;
 }
 
 static const HashTableValue JSBundlerPluginHashTable[] = {
@@ -111,6 +226,7 @@ static const HashTableValue JSBundlerPluginHashTable[] = {
     { "addError"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::DontDelete), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBundlerPluginFunction_addError, 3 } },
     { "onLoadAsync"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::DontDelete), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBundlerPluginFunction_onLoadAsync, 3 } },
     { "onResolveAsync"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::DontDelete), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBundlerPluginFunction_onResolveAsync, 4 } },
+    { "addNativePlugin"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::DontDelete), NoIntrinsic, { HashTableValue::NativeFunctionType, jsBundlerPluginFunction_addNativePlugin, 1 } },
 };
 
 class JSBundlerPlugin final : public JSC::JSNonFinalObject {
@@ -249,6 +365,84 @@ JSC_DEFINE_HOST_FUNCTION(jsBundlerPluginFunction_onResolveAsync, (JSC::JSGlobalO
     return JSC::JSValue::encode(JSC::jsUndefined());
 }
 
+static bool addNativePluginFilters(JSC::JSGlobalObject* globalObject, JSC::ThrowScope& scope, const bun_native_plugin_filter* filters, size_t count, BundlerPlugin::NamespaceList& list)
+{
+    for (size_t i = 0; i < count; i++) {
+        auto& filter = filters[i];
+        if (!filter.filter) {
+            JSC::throwTypeError(globalObject, scope, "native plugin filters must have a pattern"_s);
+            return false;
+        }
+        auto pattern = String::fromUTF8(filter.filter);
+        auto flags = Yarr::parseFlags(filter.flags ? String::fromUTF8(filter.flags) : String(""_s));
+        if (!flags || !Yarr::RegularExpression(pattern, *flags).isValid()) {
+            JSC::throwTypeError(globalObject, scope, makeString("native plugin filter is not a valid RegExp: "_s, pattern));
+            return false;
+        }
+        auto namespaceString = filter.namespace_ ? String::fromUTF8(filter.namespace_) : String();
+        if (namespaceString == "file"_s)
+            namespaceString = String();
+        list.append(pattern, *flags, namespaceString);
+    }
+    return true;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsBundlerPluginFunction_addNativePlugin, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    JSBundlerPlugin* thisObject = jsCast<JSBundlerPlugin*>(callFrame->thisValue());
+    if (thisObject->plugin.tombstoned) {
+        return JSC::JSValue::encode(JSC::jsUndefined());
+    }
+
+    WTF::String filename = callFrame->argument(0).toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (filename.isEmpty()) {
+        JSC::throwTypeError(globalObject, scope, "loadNativePlugin() expects the path to a shared library"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    // Never unloaded: a bundler thread may be in one of its callbacks
+    // until the process exits.
+#if OS(WINDOWS)
+    BunString filenameStr = Bun::toString(filename);
+    HMODULE handle = Bun__LoadLibraryBunString(&filenameStr);
+    if (!handle) {
+        JSC::throwTypeError(globalObject, scope, makeString("LoadLibrary failed with error "_s, static_cast<unsigned>(GetLastError())));
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    auto init = reinterpret_cast<bun_native_plugin_init_func>(GetProcAddress(handle, "bun_native_plugin_init"));
+#else
+    void* handle = dlopen(filename.utf8().data(), RTLD_LAZY | RTLD_LOCAL);
+    if (!handle) {
+        JSC::throwTypeError(globalObject, scope, WTF::String::fromUTF8(dlerror()));
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    auto init = reinterpret_cast<bun_native_plugin_init_func>(dlsym(handle, "bun_native_plugin_init"));
+#endif
+    if (!init) {
+        JSC::throwTypeError(globalObject, scope, "symbol 'bun_native_plugin_init' not found in native plugin"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    const bun_native_plugin* descriptor = init(BUN_NATIVE_PLUGIN_ABI_VERSION);
+    if (!descriptor || descriptor->abi_version != BUN_NATIVE_PLUGIN_ABI_VERSION) {
+        JSC::throwTypeError(globalObject, scope, makeString("native plugin does not support ABI version "_s, BUN_NATIVE_PLUGIN_ABI_VERSION));
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    BundlerPlugin::NativePlugin nativePlugin;
+    nativePlugin.descriptor = descriptor;
+    if (!addNativePluginFilters(globalObject, scope, descriptor->on_resolve_filters, descriptor->on_resolve ? descriptor->on_resolve_filter_count : 0, nativePlugin.onResolve))
+        return JSC::JSValue::encode(JSC::JSValue {});
+    if (!addNativePluginFilters(globalObject, scope, descriptor->on_load_filters, descriptor->on_load ? descriptor->on_load_filter_count : 0, nativePlugin.onLoad))
+        return JSC::JSValue::encode(JSC::JSValue {});
+
+    thisObject->plugin.nativePlugins.append(WTFMove(nativePlugin));
+    return JSC::JSValue::encode(JSC::jsUndefined());
+}
+
 void JSBundlerPlugin::finishCreation(JSC::VM& vm)
 {
     Base::finishCreation(vm);
@@ -290,6 +484,28 @@ extern "C" bool JSBundlerPlugin__anyMatches(Bun::JSBundlerPlugin* pluginObject,
     return pluginObject->plugin.anyMatchesCrossThread(pluginObject->vm(), namespaceString, path, isOnLoad);
 }
 
+extern "C" bool JSBundlerPlugin__hasNativePlugins(Bun::JSBundlerPlugin* pluginObject)
+{
+    return !pluginObject->plugin.nativePlugins.isEmpty();
+}
+
+extern "C" bun_native_plugin_status JSBundlerPlugin__runNativeOnResolve(Bun::JSBundlerPlugin* pluginObject, const BunString* namespaceString, const BunString* path, const BunString* importer, uint8_t kindId, bun_native_plugin_resolve_result* result, const bun_native_plugin** owner)
+{
+    return pluginObject->plugin.runNativeOnResolveCrossThread(pluginObject->vm(), namespaceString, path, importer, kindId, result, owner);
+}
+
+extern "C" bun_native_plugin_status JSBundlerPlugin__runNativeOnLoad(Bun::JSBundlerPlugin* pluginObject, const BunString* namespaceString, const BunString* path, bun_native_plugin_load_result* result, const bun_native_plugin** owner)
+{
+    return pluginObject->plugin.runNativeOnLoadCrossThread(pluginObject->vm(), namespaceString, path, result, owner);
+}
+
+// Called once the bundler has copied what it needs out of a HANDLED or ERROR result.
+extern "C" void JSBundlerPlugin__freeNativeResult(const bun_native_plugin* owner, void* freeData)
+{
+    if (owner && owner->free_result)
+        owner->free_result(owner->data, freeData);
+}
+
 extern "C" void JSBundlerPlugin__matchOnLoad(JSC::JSGlobalObject* globalObject, Bun::JSBundlerPlugin* plugin, const BunString* namespaceString, const BunString* path, void* context, uint8_t defaultLoaderId)
 {
     WTF::String namespaceStringStr = namespaceString ? namespaceString->toWTFString(BunString::ZeroCopy) : WTF::String();
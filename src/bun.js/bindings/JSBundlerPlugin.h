@@ -6,6 +6,8 @@
 #include <JavaScriptCore/Strong.h>
 #include <JavaScriptCore/RegularExpression.h>
 #include "helpers.h"
+#include "PluginFilter.h"
+#include "bun_native_plugin.h"
 #include <JavaScriptCore/Yarr.h>
 #include <JavaScriptCore/Strong.h>
 
@@ -19,14 +21,33 @@ using namespace JSC;
 
 class BundlerPlugin final {
 public:
+    // The filters of one namespace. Besides each filter on its own, they are
+    // kept joined into a single RegularExpression when their flags agree, so
+    // that a path which gets past the affixes of several costs one match.
+    class FilterGroup final {
+    public:
+        Vector<Yarr::RegularExpression> filters = {};
+        Vector<PluginFilterAffixes> affixes = {};
+        std::optional<Yarr::RegularExpression> combined = std::nullopt;
+
+        bool isEmpty() const { return filters.isEmpty(); }
+        void append(StringView pattern, OptionSet<Yarr::Flags>);
+        bool anyMatchesCrossThread(JSC::VM&, const String& path) const;
+
+    private:
+        String combinedPattern = {};
+        OptionSet<Yarr::Flags> combinedFlags = {};
+        bool canCombine { true };
+    };
+
     class NamespaceList final {
     public:
-        Vector<Yarr::RegularExpression> fileNamespace = {};
+        FilterGroup fileNamespace = {};
         Vector<String> namespaces = {};
-        Vector<Vector<Yarr::RegularExpression>> groups = {};
+        Vector<FilterGroup> groups = {};
         BunPluginTarget target { BunPluginTargetBun };
 
-        Vector<Yarr::RegularExpression>* group(const String& namespaceStr)
+        FilterGroup* group(const String& namespaceStr)
         {
             if (namespaceStr.isEmpty()) {
                 return &fileNamespace;
@@ -43,10 +64,25 @@ public:
         }
 
         void append(JSC::VM& vm, JSC::RegExp* filter, String& namespaceString);
+        void append(StringView pattern, OptionSet<Yarr::Flags>, String& namespaceString);
+    };
+
+    // A shared library loaded with build.loadNativePlugin(); see
+    // bun_native_plugin.h. Its callbacks are called on whichever bundler
+    // thread has the file, with no JavaScript involved.
+    class NativePlugin final {
+    public:
+        const bun_native_plugin* descriptor { nullptr };
+        NamespaceList onLoad = {};
+        NamespaceList onResolve = {};
     };
 
 public:
     bool anyMatchesCrossThread(JSC::VM&, const BunString* namespaceStr, const BunString* path, bool isOnLoad);
+    // The first native plugin to handle the file wins. On HANDLED or ERROR,
+    // `owner` is the plugin to give the result back to.
+    bun_native_plugin_status runNativeOnResolveCrossThread(JSC::VM&, const BunString* namespaceStr, const BunString* path, const BunString* importer, uint8_t kind, bun_native_plugin_resolve_result*, const bun_native_plugin** owner);
+    bun_native_plugin_status runNativeOnLoadCrossThread(JSC::VM&, const BunString* namespaceStr, const BunString* path, bun_native_plugin_load_result*, const bun_native_plugin** owner);
     void tombstone() { tombstoned = true; }
 
     BundlerPlugin(void* config, BunPluginTarget target, JSBundlerPluginAddErrorCallback addError, JSBundlerPluginOnLoadAsyncCallback onLoadAsync, JSBundlerPluginOnResolveAsyncCallback onResolveAsync)
@@ -60,6 +96,8 @@ public:
 
     NamespaceList onLoad = {};
     NamespaceList onResolve = {};
+    // Only added to during setup, before any bundler thread looks at them.
+    Vector<NativePlugin> nativePlugins = {};
     BunPluginTarget target { BunPluginTargetBrowser };
 
     JSBundlerPluginAddErrorCallback addError;
@@ -0,0 +1,43 @@
+#include "root.h"
+#include "JSCapturedStackTrace.h"
+
+#include <JavaScriptCore/JSCInlines.h>
+
+using namespace JSC;
+
+namespace Zig {
+
+const ClassInfo JSCapturedStackTrace::s_info = { "CapturedStackTrace"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSCapturedStackTrace) };
+
+JSCapturedStackTrace* JSCapturedStackTrace::create(VM& vm, Structure* structure)
+{
+    auto* stackTrace = new (NotNull, allocateCell<JSCapturedStackTrace>(vm)) JSCapturedStackTrace(vm, structure);
+    stackTrace->finishCreation(vm);
+    return stackTrace;
+}
+
+void JSCapturedStackTrace::setFrames(VM& vm, Vector<StackFrame>&& frames)
+{
+    {
+        // The concurrent marker may be reading m_frames.
+        Locker locker { cellLock() };
+        m_frames = WTFMove(frames);
+    }
+    vm.writeBarrier(this);
+}
+
+template<typename Visitor>
+void JSCapturedStackTrace::visitChildrenImpl(JSCell* cell, Visitor& visitor)
+{
+    auto* thisObject = jsCast<JSCapturedStackTrace*>(cell);
+    ASSERT_GC_OBJECT_INHERITS(thisObject, info());
+    Base::visitChildren(thisObject, visitor);
+
+    Locker locker { thisObject->cellLock() };
+    for (auto& frame : thisObject->m_frames)
+        frame.visitAggregate(visitor);
+}
+
+DEFINE_VISIT_CHILDREN(JSCapturedStackTrace);
+
+}
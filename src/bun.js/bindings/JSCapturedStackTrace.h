@@ -0,0 +1,57 @@
+#pragma once
+
+#include "root.h"
+#include <JavaScriptCore/JSDestructibleObject.h>
+#include <JavaScriptCore/StackFrame.h>
+
+namespace Zig {
+
+// The frames Error.captureStackTrace() walked, kept until the object's
+// `stack` is first read.
+//
+// Plenty of errors are created for control flow (aborted fetches, timeouts)
+// and never printed. Building their CallSites, source-mapping every frame
+// and formatting the string is most of what captureStackTrace costs, so
+// that waits for someone to ask. Like ErrorInstance's own stack, frames
+// only hold the CodeBlock and bytecode index until then.
+class JSCapturedStackTrace final : public JSC::JSDestructibleObject {
+public:
+    using Base = JSC::JSDestructibleObject;
+    static constexpr unsigned StructureFlags = Base::StructureFlags;
+    static constexpr bool needsDestruction = true;
+
+    static JSCapturedStackTrace* create(JSC::VM&, JSC::Structure*);
+
+    static void destroy(JSC::JSCell* cell)
+    {
+        static_cast<JSCapturedStackTrace*>(cell)->~JSCapturedStackTrace();
+    }
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+    template<typename CellType, JSC::SubspaceAccess>
+    static JSC::CompleteSubspace* subspaceFor(JSC::VM& vm)
+    {
+        return &vm.destructibleObjectSpace();
+    }
+
+    const Vector<JSC::StackFrame>& frames() const { return m_frames; }
+    // The frames must have been created with this cell as their owner.
+    void setFrames(JSC::VM&, Vector<JSC::StackFrame>&&);
+
+    DECLARE_INFO;
+    DECLARE_VISIT_CHILDREN;
+
+private:
+    JSCapturedStackTrace(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    Vector<JSC::StackFrame> m_frames;
+};
+
+}
@@ -168,7 +168,10 @@ JSC_DEFINE_CUSTOM_GETTER(jsNodeTLSRejectUnauthorizedGetter, (JSGlobalObject * gl
         return JSValue::encode(jsUndefined());
     }
 
-    return JSValue::encode(jsString(vm, Zig::toStringCopy(value)));
+    // Kept where the setter puts its value, so later reads skip the lookup.
+    result = jsString(vm, Zig::toStringCopy(value));
+    thisObject->putDirect(vm, privateName, result, 0);
+    return JSValue::encode(result);
 }
 
 JSC_DEFINE_CUSTOM_SETTER(jsNodeTLSRejectUnauthorizedSetter, (JSGlobalObject * globalObject, JSC::EncodedJSValue thisValue, JSC::EncodedJSValue value, PropertyName propertyName))
@@ -222,7 +225,9 @@ JSC_DEFINE_CUSTOM_GETTER(jsBunConfigVerboseFetchGetter, (JSGlobalObject * global
         return JSValue::encode(jsUndefined());
     }
 
-    return JSValue::encode(jsString(vm, Zig::toStringCopy(value)));
+    result = jsString(vm, Zig::toStringCopy(value));
+    thisObject->putDirect(vm, privateName, result, 0);
+    return JSValue::encode(result);
 }
 
 JSC_DEFINE_CUSTOM_SETTER(jsBunConfigVerboseFetchSetter, (JSGlobalObject * globalObject, JSC::EncodedJSValue thisValue, JSC::EncodedJSValue value, PropertyName propertyName))
@@ -279,6 +284,11 @@ JSValue createEnvironmentVariablesMap(Zig::GlobalObject* globalObject)
     bool hasNodeTLSRejectUnauthorized = false;
     bool hasBunConfigVerboseFetch = false;
 
+    // Every ordinary variable shares one accessor. Its getter replaces itself
+    // with the value on the first read, so from then on a read is a plain
+    // property load, and set and delete need no cache to invalidate.
+    auto* variableAccessor = JSC::CustomGetterSetter::create(vm, jsGetterEnvironmentVariable, jsSetterEnvironmentVariable);
+
     for (size_t i = 0; i < count; i++) {
         unsigned char* chars;
         size_t len = Bun__getEnvKey(list, i, &chars);
@@ -320,7 +330,7 @@ JSValue createEnvironmentVariablesMap(Zig::GlobalObject* globalObject)
             }
         }
 
-        object->putDirectCustomAccessor(vm, identifier, JSC::CustomGetterSetter::create(vm, jsGetterEnvironmentVariable, jsSetterEnvironmentVariable), JSC::PropertyAttribute::CustomAccessor | 0);
+        object->putDirectCustomAccessor(vm, identifier, variableAccessor, JSC::PropertyAttribute::CustomAccessor | 0);
     }
 
     unsigned int TZAttrs = JSC::PropertyAttribute::CustomAccessor | 0;
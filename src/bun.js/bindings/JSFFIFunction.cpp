@@ -31,6 +31,7 @@
 #include "ZigGlobalObject.h"
 
 #include <JavaScriptCore/DOMJITAbstractHeap.h>
+#include <JavaScriptCore/DOMJITSignature.h>
 #include "DOMJITIDLConvert.h"
 #include "DOMJITIDLType.h"
 #include "DOMJITIDLTypeFilter.h"
@@ -90,6 +91,64 @@ extern "C" Zig::JSFFIFunction* Bun__CreateFFIFunction(Zig::GlobalObject* globalO
     return Bun__CreateFFIFunctionWithData(globalObject, symbolName, argCount, functionPointer, strong, nullptr);
 }
 
+static JSC::SpeculatedType speculationForFFIFastPathArgument(Zig::FFIFastPathArgument argument)
+{
+    switch (argument) {
+    case Zig::FFIFastPathArgument::Int32:
+        return JSC::SpecInt32Only;
+    case Zig::FFIFastPathArgument::Boolean:
+        return JSC::SpecBoolean;
+    case Zig::FFIFastPathArgument::Uint8Array:
+        return JSC::SpecUint8Array;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+// The signature has to outlive the NativeExecutable, which the VM keeps in
+// its host function cache, so it is never freed: a few words per symbol.
+static const JSC::DOMJIT::Signature* createFFIFastPathSignature(Zig::FFIFastPathFunction fastPath, unsigned argCount, const Zig::FFIFastPathArgument* arguments)
+{
+    // `this` is the plain `symbols` object dlopen() returns, so calls written
+    // as lib.symbols.fn() qualify. Others take the host function.
+    const JSC::ClassInfo* classInfo = JSC::JSFinalObject::info();
+    // A native symbol can read and write anything.
+    auto effect = JSC::DOMJIT::Effect::forDef(JSC::DOMJIT::HeapRange::top(), JSC::DOMJIT::HeapRange::top(), JSC::DOMJIT::HeapRange::top());
+    switch (argCount) {
+    case 0:
+        return new JSC::DOMJIT::Signature(fastPath, classInfo, effect, JSC::SpecHeapTop);
+    case 1:
+        return new JSC::DOMJIT::Signature(fastPath, classInfo, effect, JSC::SpecHeapTop,
+            speculationForFFIFastPathArgument(arguments[0]));
+    case 2:
+        return new JSC::DOMJIT::Signature(fastPath, classInfo, effect, JSC::SpecHeapTop,
+            speculationForFFIFastPathArgument(arguments[0]),
+            speculationForFFIFastPathArgument(arguments[1]));
+    case 3:
+        return new JSC::DOMJIT::Signature(fastPath, classInfo, effect, JSC::SpecHeapTop,
+            speculationForFFIFastPathArgument(arguments[0]),
+            speculationForFFIFastPathArgument(arguments[1]),
+            speculationForFFIFastPathArgument(arguments[2]));
+    }
+    return nullptr;
+}
+
+// Like Bun__CreateFFIFunctionWithData, for a symbol compiled with both
+// entry points. Without a fastPath, or with too many arguments for a DOMJIT
+// signature, this is a plain JSFFIFunction.
+extern "C" JSC::EncodedJSValue Bun__CreateFFIFunctionWithFastPath(Zig::GlobalObject* globalObject, const ZigString* symbolName, unsigned argCount, Zig::FFIFunction functionPointer, Zig::FFIFastPathFunction fastPath, const Zig::FFIFastPathArgument* arguments, bool strong, void* data)
+{
+    if (!fastPath || argCount > Zig::maxFFIFastPathArguments)
+        return JSC::JSValue::encode(Bun__CreateFFIFunctionWithData(globalObject, symbolName, argCount, functionPointer, strong, data));
+
+    JSC::VM& vm = globalObject->vm();
+    auto* signature = createFFIFastPathSignature(fastPath, argCount, arguments);
+    Zig::JSFFIFunction* function = Zig::JSFFIFunction::create(vm, globalObject, argCount, symbolName != nullptr ? Zig::toStringCopy(*symbolName) : String(), functionPointer, JSC::NoIntrinsic, JSC::callHostFunctionAsConstructor, signature);
+    if (strong)
+        globalObject->trackFFIFunction(function);
+    function->dataPtr = data;
+    return JSC::JSValue::encode(function);
+}
+
 extern "C" void* Bun__FFIFunction_getDataPtr(JSC::EncodedJSValue jsValue)
 {
 
@@ -155,10 +214,10 @@ void JSFFIFunction::finishCreation(VM& vm, NativeExecutable* executable, unsigne
     ASSERT(inherits(info()));
 }
 
-JSFFIFunction* JSFFIFunction::create(VM& vm, Zig::GlobalObject* globalObject, unsigned length, const String& name, FFIFunction FFIFunction, Intrinsic intrinsic, NativeFunction nativeConstructor)
+JSFFIFunction* JSFFIFunction::create(VM& vm, Zig::GlobalObject* globalObject, unsigned length, const String& name, FFIFunction FFIFunction, Intrinsic intrinsic, NativeFunction nativeConstructor, const JSC::DOMJIT::Signature* signature)
 {
 
-    NativeExecutable* executable = vm.getHostFunction(FFIFunction, ImplementationVisibility::Public, intrinsic, FFIFunction, nullptr, name);
+    NativeExecutable* executable = vm.getHostFunction(FFIFunction, ImplementationVisibility::Public, intrinsic, FFIFunction, signature, name);
 
     Structure* structure = globalObject->FFIFunctionStructure();
     JSFFIFunction* function = new (NotNull, allocateCell<JSFFIFunction>(vm)) JSFFIFunction(vm, executable, globalObject, structure, WTFMove(FFIFunction));
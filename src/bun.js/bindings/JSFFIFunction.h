@@ -14,6 +14,9 @@ class GlobalObject;
 
 namespace JSC {
 class JSGlobalObject;
+namespace DOMJIT {
+class Signature;
+}
 }
 
 namespace Zig {
@@ -22,6 +25,24 @@ using namespace JSC;
 
 using FFIFunction = JSC::EncodedJSValue (*)(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame);
 
+// A second entry point for a compiled symbol that the DFG and FTL call
+// directly, skipping the host function prologue and the JSValue decoding.
+// It is called as fastPath(globalObject, thisObject, arguments...), each
+// argument already unboxed as its FFIFastPathArgument says, and returns the
+// same JSValue the FFIFunction would.
+using FFIFastPathFunction = JSC::EncodedJSValue (*)(JSC::JSGlobalObject* globalObject, void* thisObject);
+
+// What optimized code can hand a fast path without a conversion. Anything
+// else (doubles and pointers as numbers included) goes through FFIFunction.
+enum class FFIFastPathArgument : uint8_t {
+    Int32 = 0, // int32_t
+    Boolean = 1, // bool
+    Uint8Array = 2, // JSC::JSUint8Array*, as FFI.ptr's fast path takes it
+};
+
+// DOMJIT signatures hold at most this many arguments.
+static constexpr unsigned maxFFIFastPathArguments = 3;
+
 /**
  * Call a C function with low overhead, modeled after JSC::JSNativeStdFunction
  *
@@ -63,7 +84,7 @@ public:
 
     DECLARE_EXPORT_INFO;
 
-    JS_EXPORT_PRIVATE static JSFFIFunction* create(VM&, Zig::GlobalObject*, unsigned length, const String& name, FFIFunction, Intrinsic = NoIntrinsic, NativeFunction nativeConstructor = callHostFunctionAsConstructor);
+    JS_EXPORT_PRIVATE static JSFFIFunction* create(VM&, Zig::GlobalObject*, unsigned length, const String& name, FFIFunction, Intrinsic = NoIntrinsic, NativeFunction nativeConstructor = callHostFunctionAsConstructor, const JSC::DOMJIT::Signature* = nullptr);
 
     static Structure* createStructure(VM& vm, JSGlobalObject* globalObject, JSValue prototype)
     {
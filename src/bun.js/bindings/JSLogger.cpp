@@ -0,0 +1,321 @@
+#include "root.h"
+#include "JSLogger.h"
+
+#include "ZigGlobalObject.h"
+#include <JavaScriptCore/JSCInlines.h>
+#include <JavaScriptCore/JSONObject.h>
+#include <JavaScriptCore/Lookup.h>
+#include <wtf/dtoa.h>
+#include <wtf/text/StringBuilder.h>
+
+#if OS(WINDOWS)
+#include <io.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+extern "C" bool AsyncConsoleWriter__write(int fd, const uint8_t* bytes, size_t length);
+
+namespace Bun {
+
+using namespace JSC;
+
+const ClassInfo JSLogger::s_info = { "Logger"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSLogger) };
+
+JSLogger* JSLogger::create(VM& vm, Structure* structure, Vector<Identifier>&& fields, Vector<String>&& fieldPrefixes, String&& head, int fd)
+{
+    JSLogger* logger = new (NotNull, allocateCell<JSLogger>(vm)) JSLogger(vm, structure);
+    logger->finishCreation(vm);
+    logger->m_fields = WTFMove(fields);
+    logger->m_fieldPrefixes = WTFMove(fieldPrefixes);
+    logger->m_head = WTFMove(head);
+    logger->m_fd = fd;
+    return logger;
+}
+
+// Appends `value` as JSON. Returns false, having appended nothing, if
+// JSON.stringify would leave it out; check for an exception after.
+static bool appendLogValue(JSGlobalObject* globalObject, StringBuilder& builder, JSValue value)
+{
+    if (value.isString()) {
+        auto string = asString(value)->value(globalObject);
+        if (string.isNull())
+            return false;
+        builder.appendQuotedJSONString(string);
+        return true;
+    }
+    if (value.isInt32()) {
+        builder.append(value.asInt32());
+        return true;
+    }
+    if (value.isNumber()) {
+        double number = value.asNumber();
+        if (!std::isfinite(number)) {
+            builder.append("null"_s);
+            return true;
+        }
+        NumberToStringBuffer buffer;
+        builder.append(WTF::numberToString(number, buffer));
+        return true;
+    }
+    if (value.isBoolean()) {
+        builder.append(value.asBoolean() ? "true"_s : "false"_s);
+        return true;
+    }
+    if (value.isNull()) {
+        builder.append("null"_s);
+        return true;
+    }
+    if (value.isUndefined() || value.isSymbol() || value.isCallable())
+        return false;
+
+    // toJSON, nested objects, and the TypeError for a BigInt.
+    auto json = JSONStringify(globalObject, value, 0);
+    if (json.isNull())
+        return false;
+    builder.append(json);
+    return true;
+}
+
+template<typename ValueAt>
+String JSLogger::format(JSGlobalObject* globalObject, const ValueAt& valueAt)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    StringBuilder builder;
+    builder.reserveCapacity(m_lastLength);
+    builder.append(m_head);
+    bool needsComma = m_head.length() > 1;
+
+    for (size_t i = 0; i < m_fields.size(); i++) {
+        JSValue value = valueAt(i);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (value.isUndefined() || value.isSymbol() || value.isCallable())
+            continue;
+
+        unsigned rollback = builder.length();
+        if (needsComma)
+            builder.append(',');
+        builder.append(m_fieldPrefixes[i]);
+        bool appended = appendLogValue(globalObject, builder, value);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!appended) {
+            builder.shrink(rollback);
+            continue;
+        }
+        needsComma = true;
+    }
+
+    builder.append("}\n"_s);
+    m_lastLength = builder.length();
+    return builder.toString();
+}
+
+void JSLogger::write(const String& line)
+{
+    auto utf8 = line.utf8();
+    auto* bytes = reinterpret_cast<const uint8_t*>(utf8.data());
+    size_t length = utf8.length();
+    if (AsyncConsoleWriter__write(m_fd, bytes, length))
+        return;
+
+    while (length) {
+#if OS(WINDOWS)
+        int written = _write(m_fd, bytes, static_cast<unsigned>(std::min<size_t>(length, INT_MAX)));
+        if (written < 0)
+            return;
+#else
+        ssize_t written = ::write(m_fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return;
+        }
+#endif
+        bytes += written;
+        length -= written;
+    }
+}
+
+static JSLogger* jsLoggerCast(JSGlobalObject* globalObject, ThrowScope& scope, JSValue thisValue, ASCIILiteral methodName)
+{
+    if (auto* logger = jsDynamicCast<JSLogger*>(thisValue))
+        return logger;
+    throwTypeError(globalObject, scope, makeString("Logger.prototype."_s, methodName, " called on an object that is not a Logger"_s));
+    return nullptr;
+}
+
+static String formatRecord(JSGlobalObject* globalObject, ThrowScope& scope, JSLogger* logger, JSValue recordValue, ASCIILiteral methodName)
+{
+    if (UNLIKELY(!recordValue.isObject())) {
+        throwTypeError(globalObject, scope, makeString("Logger.prototype."_s, methodName, " expects an object"_s));
+        return {};
+    }
+    JSObject* record = asObject(recordValue);
+    RELEASE_AND_RETURN(scope, logger->format(globalObject, [&](size_t i) {
+        return record->get(globalObject, logger->fields()[i]);
+    }));
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsLoggerPrototypeFunction_write, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* logger = jsLoggerCast(globalObject, scope, callFrame->thisValue(), "write"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto line = formatRecord(globalObject, scope, logger, callFrame->argument(0), "write"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    logger->write(line);
+    return JSValue::encode(jsUndefined());
+}
+
+// log(...values): the values of the fields in order, without a record
+// object to read them from.
+JSC_DEFINE_HOST_FUNCTION(jsLoggerPrototypeFunction_log, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* logger = jsLoggerCast(globalObject, scope, callFrame->thisValue(), "log"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto line = logger->format(globalObject, [&](size_t i) {
+        return callFrame->argument(i);
+    });
+    RETURN_IF_EXCEPTION(scope, {});
+    logger->write(line);
+    return JSValue::encode(jsUndefined());
+}
+
+// format(record): the line write(record) would write, newline included.
+JSC_DEFINE_HOST_FUNCTION(jsLoggerPrototypeFunction_format, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* logger = jsLoggerCast(globalObject, scope, callFrame->thisValue(), "format"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto line = formatRecord(globalObject, scope, logger, callFrame->argument(0), "format"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    return JSValue::encode(jsString(vm, line));
+}
+
+static const HashTableValue JSLoggerPrototypeTableValues[] = {
+    { "write"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsLoggerPrototypeFunction_write, 1 } },
+    { "log"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsLoggerPrototypeFunction_log, 0 } },
+    { "format"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsLoggerPrototypeFunction_format, 1 } },
+};
+
+const ClassInfo JSLoggerPrototype::s_info = { "Logger"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSLoggerPrototype) };
+
+void JSLoggerPrototype::finishCreation(VM& vm, JSGlobalObject*)
+{
+    Base::finishCreation(vm);
+    reifyStaticProperties(vm, JSLogger::info(), JSLoggerPrototypeTableValues, *this);
+    JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
+}
+
+const ClassInfo JSLoggerConstructor::s_info = { "Logger"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSLoggerConstructor) };
+
+JSLoggerConstructor* JSLoggerConstructor::create(VM& vm, Structure* structure, JSLoggerPrototype* prototype)
+{
+    JSLoggerConstructor* constructor = new (NotNull, allocateCell<JSLoggerConstructor>(vm)) JSLoggerConstructor(vm, structure);
+    constructor->finishCreation(vm, prototype);
+    return constructor;
+}
+
+void JSLoggerConstructor::finishCreation(VM& vm, JSLoggerPrototype* prototype)
+{
+    Base::finishCreation(vm, 1, "Logger"_s, PropertyAdditionMode::WithoutStructureTransition);
+    putDirectWithoutTransition(vm, vm.propertyNames->prototype, prototype, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+    prototype->putDirectWithoutTransition(vm, vm.propertyNames->constructor, this, static_cast<unsigned>(PropertyAttribute::DontEnum));
+}
+
+EncodedJSValue JSLoggerConstructor::call(JSGlobalObject* globalObject, CallFrame*)
+{
+    auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+    throwTypeError(globalObject, scope, "Class constructor Logger cannot be invoked without 'new'"_s);
+    return {};
+}
+
+// new Logger(fields, { base, fd }): `fields` is an array of field names,
+// `base` an object serialized into every line ahead of them and `fd` 1 for
+// stdout (the default) or 2 for stderr.
+EncodedJSValue JSLoggerConstructor::construct(JSGlobalObject* lexicalGlobalObject, CallFrame* callFrame)
+{
+    auto& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+
+    auto* fieldsArray = jsDynamicCast<JSArray*>(callFrame->argument(0));
+    if (UNLIKELY(!fieldsArray)) {
+        throwTypeError(globalObject, scope, "Logger expects an array of field names"_s);
+        return {};
+    }
+
+    Vector<Identifier> fields;
+    Vector<String> fieldPrefixes;
+    unsigned length = fieldsArray->length();
+    fields.reserveInitialCapacity(length);
+    fieldPrefixes.reserveInitialCapacity(length);
+    for (unsigned i = 0; i < length; i++) {
+        JSValue field = fieldsArray->getIndex(globalObject, i);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (UNLIKELY(!field.isString())) {
+            throwTypeError(globalObject, scope, "Logger field names must be strings"_s);
+            return {};
+        }
+        auto name = asString(field)->value(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        StringBuilder prefix;
+        prefix.appendQuotedJSONString(name);
+        prefix.append(':');
+        fields.append(Identifier::fromString(vm, name));
+        fieldPrefixes.append(prefix.toString());
+    }
+
+    String head = "{"_s;
+    int fd = 1;
+    JSValue options = callFrame->argument(1);
+    if (options.isObject()) {
+        JSValue base = asObject(options)->get(globalObject, Identifier::fromString(vm, "base"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!base.isUndefinedOrNull()) {
+            if (UNLIKELY(!base.isObject() || isArray(globalObject, base))) {
+                RETURN_IF_EXCEPTION(scope, {});
+                throwTypeError(globalObject, scope, "Logger base must be an object"_s);
+                return {};
+            }
+            // Everything up to its closing brace.
+            auto json = JSONStringify(globalObject, base, 0);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (!json.isNull() && json.length() > 2)
+                head = json.left(json.length() - 1);
+        }
+
+        JSValue fdValue = asObject(options)->get(globalObject, Identifier::fromString(vm, "fd"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!fdValue.isUndefined()) {
+            if (UNLIKELY(!fdValue.isInt32() || (fdValue.asInt32() != 1 && fdValue.asInt32() != 2))) {
+                throwRangeError(globalObject, scope, "Logger fd must be 1 or 2"_s);
+                return {};
+            }
+            fd = fdValue.asInt32();
+        }
+    }
+
+    Structure* structure = globalObject->JSLoggerStructure();
+    JSValue newTarget = callFrame->newTarget();
+    if (UNLIKELY(globalObject->JSLogger() != newTarget)) {
+        auto* functionGlobalObject = jsCast<Zig::GlobalObject*>(getFunctionRealm(globalObject, newTarget.getObject()));
+        RETURN_IF_EXCEPTION(scope, {});
+        structure = InternalFunction::createSubclassStructure(globalObject, newTarget.getObject(), functionGlobalObject->JSLoggerStructure());
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    return JSValue::encode(JSLogger::create(vm, structure, WTFMove(fields), WTFMove(fieldPrefixes), WTFMove(head), fd));
+}
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "root.h"
+#include <JavaScriptCore/InternalFunction.h>
+
+namespace Bun {
+
+// Bun.Logger: JSON log lines with a fixed set of fields.
+//
+//     const log = new Bun.Logger(["level", "msg", "status"], { base: { service: "api" } });
+//     log.write({ level: "info", msg: "done", status: 200 });
+//     log.log("info", "done", 200);
+//     // {"service":"api","level":"info","msg":"done","status":200}
+//
+// The constructor serializes the base fields and every `"field":` once.
+// A line is then those pieces with the values in between: strings go
+// through JSC's JSON quoting, numbers through the same dtoa as
+// JSON.stringify, and only objects fall back to JSON.stringify itself.
+// Undefined, functions and symbols leave their field out, as they do in
+// JSON.stringify. Lines go through the asynchronous console writer when
+// that is enabled for the fd, and are written directly otherwise.
+class JSLogger final : public JSC::JSNonFinalObject {
+public:
+    using Base = JSC::JSNonFinalObject;
+    static constexpr bool needsDestruction = true;
+
+    static JSLogger* create(JSC::VM&, JSC::Structure*, Vector<JSC::Identifier>&& fields, Vector<String>&& fieldPrefixes, String&& head, int fd);
+
+    static void destroy(JSC::JSCell* cell)
+    {
+        static_cast<JSLogger*>(cell)->~JSLogger();
+    }
+
+    DECLARE_INFO;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+    template<typename CellType, JSC::SubspaceAccess>
+    static JSC::CompleteSubspace* subspaceFor(JSC::VM& vm)
+    {
+        return &vm.destructibleObjectSpace();
+    }
+
+    const Vector<JSC::Identifier>& fields() const { return m_fields; }
+
+    // The line for `values`, one per field, with its newline. Returns a
+    // null string with an exception on the VM if serializing a value threw.
+    template<typename ValueAt>
+    String format(JSC::JSGlobalObject*, const ValueAt& valueAt);
+    void write(const String& line);
+
+private:
+    JSLogger(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    Vector<JSC::Identifier> m_fields;
+    // `"field":` for each field, already quoted.
+    Vector<String> m_fieldPrefixes;
+    // `{` and the serialized base fields.
+    String m_head;
+    int m_fd { 1 };
+    unsigned m_lastLength { 64 };
+};
+
+class JSLoggerPrototype final : public JSC::JSNonFinalObject {
+public:
+    using Base = JSC::JSNonFinalObject;
+
+    static JSLoggerPrototype* create(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::Structure* structure)
+    {
+        JSLoggerPrototype* prototype = new (NotNull, JSC::allocateCell<JSLoggerPrototype>(vm)) JSLoggerPrototype(vm, structure);
+        prototype->finishCreation(vm, globalObject);
+        return prototype;
+    }
+
+    DECLARE_INFO;
+    template<typename CellType, JSC::SubspaceAccess>
+    static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        STATIC_ASSERT_ISO_SUBSPACE_SHARABLE(JSLoggerPrototype, Base);
+        return &vm.plainObjectSpace();
+    }
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+private:
+    JSLoggerPrototype(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSC::JSGlobalObject*);
+};
+
+class JSLoggerConstructor final : public JSC::InternalFunction {
+public:
+    using Base = JSC::InternalFunction;
+    static JSLoggerConstructor* create(JSC::VM&, JSC::Structure*, JSLoggerPrototype*);
+
+    static constexpr unsigned StructureFlags = Base::StructureFlags;
+    static constexpr bool needsDestruction = false;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::InternalFunctionType, StructureFlags), info());
+    }
+
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES construct(JSC::JSGlobalObject*, JSC::CallFrame*);
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES call(JSC::JSGlobalObject*, JSC::CallFrame*);
+    DECLARE_EXPORT_INFO;
+
+private:
+    JSLoggerConstructor(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure, call, construct)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSLoggerPrototype*);
+};
+
+}
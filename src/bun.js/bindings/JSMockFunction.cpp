@@ -58,6 +58,7 @@ JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockRestore);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockImplementation);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockImplementationOnce);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockName);
+JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockCountOnly);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockReturnThis);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockReturnValue);
 JSC_DECLARE_HOST_FUNCTION(jsMockFunctionMockReturnValueOnce);
@@ -221,6 +222,17 @@ enum class CallbackKind : uint8_t {
     GetterSetter,
 };
 
+// What mock.results says about a call. None is a call recorded by
+// mockCountOnly(), whose result is undefined.
+enum class MockResultKind : uint8_t {
+    None,
+    Incomplete,
+    Return,
+    Throw,
+};
+
+static JSValue createMockResult(JSC::VM& vm, Zig::GlobalObject* globalObject, const WTF::String& type, JSC::JSValue value);
+
 const ClassInfo JSMockImplementation::s_info = { "MockImpl"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSMockImplementation) };
 
 class JSMockFunction : public JSC::InternalFunction {
@@ -262,6 +274,32 @@ public:
     mutable JSC::WriteBarrier<JSC::JSArray> instances;
     mutable JSC::WriteBarrier<JSC::JSArray> returnValues;
 
+    // Calls made since the arrays above were last handed out. Building an
+    // arguments array and a result object on every call is most of what a
+    // spy on a hot function costs, so until something asks for `calls`,
+    // `contexts`, `results` or `invocationCallOrder` the values are only
+    // appended here, and the array is built from them when it is asked for.
+    // From then on the array is live, as in Jest, and calls are pushed onto
+    // it directly until the next mockClear().
+    //
+    // The GC visits these vectors concurrently, so anything that can
+    // reallocate them holds the cell lock.
+    struct LoggedResult {
+        MockResultKind kind;
+        JSC::WriteBarrier<JSC::Unknown> value;
+    };
+    static constexpr unsigned NotRecorded = std::numeric_limits<unsigned>::max();
+    mutable Vector<JSC::WriteBarrier<JSC::Unknown>> loggedArguments;
+    // The end of each call's arguments in loggedArguments, or NotRecorded.
+    mutable Vector<unsigned> loggedArgumentEnds;
+    mutable Vector<JSC::WriteBarrier<JSC::Unknown>> loggedContexts;
+    mutable Vector<LoggedResult> loggedResults;
+    mutable Vector<double> loggedInvocationIds;
+
+    // Set by mockCountOnly(): only the number and order of calls is kept,
+    // and their entries in calls, contexts and results are undefined.
+    bool countOnly = false;
+
     JSC::Weak<JSObject> spyTarget;
     JSC::Identifier spyIdentifier;
     unsigned spyAttributes = 0;
@@ -326,6 +364,13 @@ public:
         this->instances.clear();
         this->returnValues.clear();
         this->contexts.clear();
+        {
+            Locker locker { cellLock() };
+            this->loggedArguments.clear();
+            this->loggedArgumentEnds.clear();
+            this->loggedContexts.clear();
+            this->loggedResults.clear();
+        }
 
         if (this->mock.isInitialized()) {
             this->initMock();
@@ -364,21 +409,66 @@ public:
         this->spyAttributes = 0;
     }
 
-    JSArray* getCalls() const
+    void logCall(JSC::VM& vm, const JSC::ArgList& args, JSValue thisValue, double invocationId)
+    {
+        Locker locker { cellLock() };
+        if (!calls) {
+            if (countOnly) {
+                loggedArgumentEnds.append(NotRecorded);
+            } else {
+                for (size_t i = 0; i < args.size(); i++)
+                    loggedArguments.append(JSC::WriteBarrier<JSC::Unknown>(vm, this, args.at(i)));
+                loggedArgumentEnds.append(loggedArguments.size());
+            }
+        }
+        if (!contexts)
+            loggedContexts.append(JSC::WriteBarrier<JSC::Unknown>(vm, this, countOnly ? jsUndefined() : thisValue));
+        if (!invocationCallOrder)
+            loggedInvocationIds.append(invocationId);
+    }
+
+    JSArray* getCalls()
     {
         JSArray* val = calls.get();
         if (!val) {
-            val = JSC::constructEmptyArray(globalObject(), nullptr, 0);
+            auto* globalObject = this->globalObject();
+            auto* structure = globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous);
+            MarkedArgumentBuffer values;
+            values.ensureCapacity(loggedArgumentEnds.size());
+            unsigned start = 0;
+            for (unsigned end : loggedArgumentEnds) {
+                if (end == NotRecorded) {
+                    values.append(jsUndefined());
+                    continue;
+                }
+                MarkedArgumentBuffer arguments;
+                arguments.ensureCapacity(end - start);
+                for (unsigned i = start; i < end; i++)
+                    arguments.append(loggedArguments[i].get());
+                values.append(JSC::constructArray(globalObject, structure, arguments));
+                start = end;
+            }
+            val = JSC::constructArray(globalObject, structure, values);
             this->calls.set(vm(), this, val);
+            Locker locker { cellLock() };
+            loggedArguments.clear();
+            loggedArgumentEnds.clear();
         }
         return val;
     }
-    JSArray* getContexts() const
+    JSArray* getContexts()
     {
         JSArray* val = contexts.get();
         if (!val) {
-            val = JSC::constructEmptyArray(globalObject(), nullptr, 0);
+            MarkedArgumentBuffer values;
+            values.ensureCapacity(loggedContexts.size());
+            for (auto& context : loggedContexts)
+                values.append(context.get());
+            auto* globalObject = this->globalObject();
+            val = JSC::constructArray(globalObject, globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous), values);
             this->contexts.set(vm(), this, val);
+            Locker locker { cellLock() };
+            loggedContexts.clear();
         }
         return val;
     }
@@ -391,25 +481,83 @@ public:
         }
         return val;
     }
-    JSArray* getReturnValues() const
+    JSArray* getReturnValues()
     {
         JSArray* val = returnValues.get();
         if (!val) {
-            val = JSC::constructEmptyArray(globalObject(), nullptr, 0);
-            this->returnValues.set(vm(), this, val);
+            auto& vm = this->vm();
+            auto* globalObject = jsCast<Zig::GlobalObject*>(this->globalObject());
+            MarkedArgumentBuffer values;
+            values.ensureCapacity(loggedResults.size());
+            for (auto& result : loggedResults)
+                values.append(materializeResult(vm, globalObject, result.kind, result.value.get()));
+            val = JSC::constructArray(globalObject, globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous), values);
+            this->returnValues.set(vm, this, val);
+            Locker locker { cellLock() };
+            loggedResults.clear();
         }
         return val;
     }
-    JSArray* getInvocationCallOrder() const
+    JSArray* getInvocationCallOrder()
     {
         JSArray* val = invocationCallOrder.get();
         if (!val) {
-            val = JSC::constructEmptyArray(globalObject(), nullptr, 0);
+            MarkedArgumentBuffer values;
+            values.ensureCapacity(loggedInvocationIds.size());
+            for (double invocationId : loggedInvocationIds)
+                values.append(jsNumber(invocationId));
+            auto* globalObject = this->globalObject();
+            val = JSC::constructArray(globalObject, globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous), values);
             this->invocationCallOrder.set(vm(), this, val);
+            loggedInvocationIds.clear();
         }
         return val;
     }
 
+    static JSValue materializeResult(JSC::VM& vm, Zig::GlobalObject* globalObject, MockResultKind kind, JSValue value)
+    {
+        switch (kind) {
+        case MockResultKind::None:
+            return jsUndefined();
+        case MockResultKind::Incomplete:
+            return createMockResult(vm, globalObject, "incomplete"_s, jsUndefined());
+        case MockResultKind::Return:
+            return createMockResult(vm, globalObject, "return"_s, value);
+        case MockResultKind::Throw:
+            return createMockResult(vm, globalObject, "throw"_s, value);
+        }
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    // Returns where the result went, for setResult() to fill in once the
+    // call finishes.
+    unsigned appendResult(JSC::VM& vm, Zig::GlobalObject* globalObject, MockResultKind kind, JSValue value)
+    {
+        if (auto* returnValuesArray = returnValues.get()) {
+            returnValuesArray->push(globalObject, materializeResult(vm, globalObject, kind, value));
+            return returnValuesArray->length() - 1;
+        }
+        Locker locker { cellLock() };
+        loggedResults.append(LoggedResult { kind, JSC::WriteBarrier<JSC::Unknown>(vm, this, value) });
+        return loggedResults.size() - 1;
+    }
+
+    // The results array is built in the order of the log, so an index
+    // into the log is still right if it was built during the call. After a
+    // mockClear() during the call there is nothing to fill in.
+    void setResult(JSC::VM& vm, Zig::GlobalObject* globalObject, unsigned index, MockResultKind kind, JSValue value)
+    {
+        if (auto* returnValuesArray = returnValues.get()) {
+            if (index < returnValuesArray->length())
+                returnValuesArray->putDirectIndex(globalObject, index, materializeResult(vm, globalObject, kind, value));
+            return;
+        }
+        if (index < loggedResults.size()) {
+            loggedResults[index].kind = kind;
+            loggedResults[index].value.set(vm, this, value);
+        }
+    }
+
     template<typename, JSC::SubspaceAccess mode>
     static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
     {
@@ -446,6 +594,13 @@ void JSMockFunction::visitChildrenImpl(JSCell* cell, Visitor& visitor)
     visitor.append(fn->returnValues);
     visitor.append(fn->invocationCallOrder);
     visitor.append(fn->spyOriginal);
+    {
+        Locker locker { fn->cellLock() };
+        visitor.appendValues(fn->loggedArguments.data(), fn->loggedArguments.size());
+        visitor.appendValues(fn->loggedContexts.data(), fn->loggedContexts.size());
+        for (auto& result : fn->loggedResults)
+            visitor.append(result.value);
+    }
     fn->mock.visit(visitor);
 }
 DEFINE_VISIT_CHILDREN(JSMockFunction);
@@ -535,6 +690,7 @@ static const HashTableValue JSMockFunctionPrototypeTableValues[] = {
     { "mockImplementationOnce"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockImplementationOnce, 1 } },
     { "withImplementation"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionWithImplementation, 1 } },
     { "mockName"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockName, 1 } },
+    { "mockCountOnly"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockCountOnly, 1 } },
     { "mockReturnThis"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockReturnThis, 1 } },
     { "mockReturnValue"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockReturnValue, 1 } },
     { "mockReturnValueOnce"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly), NoIntrinsic, { HashTableValue::NativeFunctionType, jsMockFunctionMockReturnValueOnce, 1 } },
@@ -902,72 +1058,42 @@ JSC_DEFINE_HOST_FUNCTION(jsMockFunctionCall, (JSGlobalObject * lexicalGlobalObje
 
     JSC::ArgList args = JSC::ArgList(callframe);
     JSValue thisValue = callframe->thisValue();
-    JSC::JSArray* argumentsArray = nullptr;
-    {
-        JSC::ObjectInitializationScope object(vm);
-        argumentsArray = JSC::JSArray::tryCreateUninitializedRestricted(
-            object,
-            globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
-            callframe->argumentCount());
-        for (size_t i = 0; i < args.size(); i++) {
-            argumentsArray->initializeIndex(object, i, args.at(i));
+    bool countOnly = fn->countOnly;
+    auto invocationId = JSMockModule::nextInvocationId();
+
+    // Until the arrays are asked for, the call only goes into the log.
+    fn->logCall(vm, args, thisValue, invocationId);
+
+    if (JSC::JSArray* calls = fn->calls.get()) {
+        if (countOnly) {
+            calls->push(globalObject, jsUndefined());
+        } else {
+            JSC::JSArray* argumentsArray = nullptr;
+            {
+                JSC::ObjectInitializationScope object(vm);
+                argumentsArray = JSC::JSArray::tryCreateUninitializedRestricted(
+                    object,
+                    globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
+                    callframe->argumentCount());
+                for (size_t i = 0; i < args.size(); i++) {
+                    argumentsArray->initializeIndex(object, i, args.at(i));
+                }
+            }
+            calls->push(globalObject, argumentsArray);
         }
     }
 
-    JSC::JSArray* calls = fn->calls.get();
-    if (calls) {
-        calls->push(globalObject, argumentsArray);
-    } else {
-        JSC::ObjectInitializationScope object(vm);
-        calls = JSC::JSArray::tryCreateUninitializedRestricted(
-            object,
-            globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
-            1);
-        calls->initializeIndex(object, 0, argumentsArray);
-        fn->calls.set(vm, fn, calls);
-    }
-
-    JSC::JSArray* contexts = fn->contexts.get();
-    if (contexts) {
-        contexts->push(globalObject, thisValue);
-    } else {
-        JSC::ObjectInitializationScope object(vm);
-        contexts = JSC::JSArray::tryCreateUninitializedRestricted(
-            object,
-            globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
-            1);
-        contexts->initializeIndex(object, 0, thisValue);
-        fn->contexts.set(vm, fn, contexts);
+    if (JSC::JSArray* contexts = fn->contexts.get()) {
+        contexts->push(globalObject, countOnly ? jsUndefined() : thisValue);
     }
 
-    auto invocationId = JSMockModule::nextInvocationId();
-    JSC::JSArray* invocationCallOrder = fn->invocationCallOrder.get();
-    if (invocationCallOrder) {
+    if (JSC::JSArray* invocationCallOrder = fn->invocationCallOrder.get()) {
         invocationCallOrder->push(globalObject, jsNumber(invocationId));
-    } else {
-        JSC::ObjectInitializationScope object(vm);
-        invocationCallOrder = JSC::JSArray::tryCreateUninitializedRestricted(
-            object,
-            globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
-            1);
-        invocationCallOrder->initializeIndex(object, 0, jsNumber(invocationId));
-        fn->invocationCallOrder.set(vm, fn, invocationCallOrder);
     }
 
     unsigned int returnValueIndex = 0;
-    auto setReturnValue = [&](JSC::JSValue value) -> void {
-        if (auto* returnValuesArray = fn->returnValues.get()) {
-            returnValuesArray->push(globalObject, value);
-            returnValueIndex = returnValuesArray->length() - 1;
-        } else {
-            JSC::ObjectInitializationScope object(vm);
-            returnValuesArray = JSC::JSArray::tryCreateUninitializedRestricted(
-                object,
-                globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
-                1);
-            returnValuesArray->initializeIndex(object, 0, value);
-            fn->returnValues.set(vm, fn, returnValuesArray);
-        }
+    auto setReturnValue = [&](MockResultKind kind, JSC::JSValue value) -> void {
+        returnValueIndex = fn->appendResult(vm, globalObject, countOnly ? MockResultKind::None : kind, value);
     };
 
     if (auto* impl = tryJSDynamicCast<JSMockImplementation*>(fn->implementation.get())) {
@@ -988,39 +1114,35 @@ JSC_DEFINE_HOST_FUNCTION(jsMockFunctionCall, (JSGlobalObject * lexicalGlobalObje
                 return {};
             }
 
-            setReturnValue(createMockResult(vm, globalObject, "incomplete"_s, jsUndefined()));
+            setReturnValue(MockResultKind::Incomplete, jsUndefined());
 
             WTF::NakedPtr<JSC::Exception> exception;
 
             JSValue returnValue = call(globalObject, result, callData, thisValue, args, exception);
 
             if (auto* exc = exception.get()) {
-                if (auto* returnValuesArray = fn->returnValues.get()) {
-                    returnValuesArray->putDirectIndex(globalObject, returnValueIndex, createMockResult(vm, globalObject, "throw"_s, exc->value()));
-                    fn->returnValues.set(vm, fn, returnValuesArray);
-                    JSC::throwException(globalObject, scope, exc);
-                    return {};
-                }
+                if (!countOnly)
+                    fn->setResult(vm, globalObject, returnValueIndex, MockResultKind::Throw, exc->value());
+                JSC::throwException(globalObject, scope, exc);
+                return {};
             }
 
             if (UNLIKELY(!returnValue)) {
                 returnValue = jsUndefined();
             }
 
-            if (auto* returnValuesArray = fn->returnValues.get()) {
-                returnValuesArray->putDirectIndex(globalObject, returnValueIndex, createMockResult(vm, globalObject, "return"_s, returnValue));
-                fn->returnValues.set(vm, fn, returnValuesArray);
-            }
+            if (!countOnly)
+                fn->setResult(vm, globalObject, returnValueIndex, MockResultKind::Return, returnValue);
 
             return JSValue::encode(returnValue);
         }
         case JSMockImplementation::Kind::ReturnValue: {
             JSValue returnValue = impl->underlyingValue.get();
-            setReturnValue(createMockResult(vm, globalObject, "return"_s, returnValue));
+            setReturnValue(MockResultKind::Return, returnValue);
             return JSValue::encode(returnValue);
         }
         case JSMockImplementation::Kind::ReturnThis: {
-            setReturnValue(createMockResult(vm, globalObject, "return"_s, thisValue));
+            setReturnValue(MockResultKind::Return, thisValue);
             return JSValue::encode(thisValue);
         }
         default: {
@@ -1029,7 +1151,7 @@ JSC_DEFINE_HOST_FUNCTION(jsMockFunctionCall, (JSGlobalObject * lexicalGlobalObje
         }
     }
 
-    setReturnValue(createMockResult(vm, globalObject, "return"_s, jsUndefined()));
+    setReturnValue(MockResultKind::Return, jsUndefined());
     return JSValue::encode(jsUndefined());
 }
 
@@ -1281,6 +1403,23 @@ JSC_DEFINE_HOST_FUNCTION(jsMockFunctionMockName, (JSC::JSGlobalObject * globalOb
 
     RELEASE_AND_RETURN(scope, JSValue::encode(jsString(vm, thisObject->calculatedDisplayName(vm))));
 }
+// mockCountOnly(enabled = true): record how many times, and in what order,
+// the mock is called, but not the arguments, `this` or results.
+JSC_DEFINE_HOST_FUNCTION(jsMockFunctionMockCountOnly, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callframe))
+{
+    JSMockFunction* thisObject = jsDynamicCast<JSMockFunction*>(callframe->thisValue().toThis(globalObject, JSC::ECMAMode::strict()));
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    if (UNLIKELY(!thisObject)) {
+        throwTypeError(globalObject, scope, "Expected Mock"_s);
+        return {};
+    }
+
+    JSValue enabled = callframe->argument(0);
+    thisObject->countOnly = enabled.isUndefined() || enabled.toBoolean(globalObject);
+
+    RELEASE_AND_RETURN(scope, JSValue::encode(thisObject));
+}
 JSC_DEFINE_HOST_FUNCTION(jsMockFunctionMockReturnThis, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callframe))
 {
     JSMockFunction* thisObject = jsDynamicCast<JSMockFunction*>(callframe->thisValue().toThis(globalObject, JSC::ECMAMode::strict()));
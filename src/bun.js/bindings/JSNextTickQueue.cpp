@@ -7,6 +7,7 @@
 #include <JavaScriptCore/GetterSetter.h>
 
 #include "JSNextTickQueue.h"
+#include "ZigGlobalObject.h"
 #include <JavaScriptCore/JSGlobalObject.h>
 #include <JavaScriptCore/Structure.h>
 #include <JavaScriptCore/JSInternalFieldObjectImplInlines.h>
@@ -58,6 +59,14 @@ void JSNextTickQueue::visitChildrenImpl(JSCell* cell, Visitor& visitor)
     auto* thisObject = jsCast<JSNextTickQueue*>(cell);
     ASSERT_GC_OBJECT_INHERITS(thisObject, info());
     Base::visitChildren(thisObject, visitor);
+
+    Locker locker { thisObject->cellLock() };
+    for (auto& tick : thisObject->m_ticks) {
+        visitor.appendUnbarriered(tick.callback);
+        visitor.appendUnbarriered(tick.asyncContext);
+        for (auto argument : tick.arguments)
+            visitor.appendUnbarriered(argument);
+    }
 }
 
 DEFINE_VISIT_CHILDREN(JSNextTickQueue);
@@ -69,29 +78,100 @@ JSNextTickQueue* JSNextTickQueue::create(JSC::JSGlobalObject* globalObject)
     return obj;
 }
 
+void JSNextTickQueue::enqueue(VM& vm, JSValue callback, JSValue asyncContext, std::span<const JSValue> arguments)
+{
+    {
+        Locker locker { cellLock() };
+        m_ticks.append({ callback, asyncContext, Vector<JSValue, 2>(arguments) });
+    }
+    vm.writeBarrier(this);
+}
+
 bool JSNextTickQueue::isEmpty()
 {
-    return !internalField(0) || internalField(0).get().asNumber() == 0;
+    return m_ticks.isEmpty();
+}
+
+void JSNextTickQueue::runTicks(VM& vm, JSGlobalObject* globalObject)
+{
+    auto* asyncContextData = jsCast<Zig::GlobalObject*>(globalObject)->m_asyncContextData.get();
+    JSValue restoreAsyncContext = asyncContextData->getInternalField(0);
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+
+    while (!m_ticks.isEmpty()) {
+        JSValue callback;
+        MarkedArgumentBuffer arguments;
+        {
+            Locker locker { cellLock() };
+            auto tick = m_ticks.takeFirst();
+            callback = tick.callback;
+            asyncContextData->putInternalField(vm, 0, tick.asyncContext);
+            arguments.ensureCapacity(tick.arguments.size());
+            for (auto argument : tick.arguments)
+                arguments.append(argument);
+        }
+
+        JSC::profiledCall(globalObject, ProfilingReason::API, callback, JSC::getCallData(callback), jsUndefined(), arguments);
+
+        if (UNLIKELY(scope.exception())) {
+            auto* exception = scope.exception();
+            if (vm.isTerminationException(exception))
+                break;
+            scope.clearException();
+            Bun__reportUnhandledError(globalObject, JSValue::encode(exception));
+        }
+    }
+
+    asyncContextData->putInternalField(vm, 0, restoreAsyncContext);
 }
 
 void JSNextTickQueue::drain(JSC::VM& vm, JSC::JSGlobalObject* globalObject)
 {
-    bool mustResetContext = false;
     if (isEmpty()) {
         vm.drainMicrotasks();
-        mustResetContext = true;
+        if (isEmpty())
+            return;
     }
 
-    if (!isEmpty()) {
-        if (mustResetContext) {
-            globalObject->m_asyncContextData.get()->putInternalField(vm, 0, jsUndefined());
-        }
-        auto* drainFn = internalField(2).get().getObject();
+    // A tick that drains the microtask queue itself gets here again.
+    if (m_isDraining)
+        return;
+    m_isDraining = true;
 
-        auto throwScope = DECLARE_THROW_SCOPE(vm);
-        MarkedArgumentBuffer drainArgs;
-        JSC::call(globalObject, drainFn, drainArgs, "Failed to drain next tick queue"_s);
+    // Node's order: every tick, then every microtask, until both are empty.
+    while (!isEmpty()) {
+        runTicks(vm, globalObject);
+        if (UNLIKELY(vm.hasPendingTerminationException()))
+            break;
+        vm.drainMicrotasks();
     }
+
+    m_isDraining = false;
 }
 
-}
\ No newline at end of file
+JSC_DEFINE_HOST_FUNCTION(jsFunctionNextTick, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue callback = callFrame->argument(0);
+    if (UNLIKELY(!callback.isCallable())) {
+        auto* error = createTypeError(globalObject, "The \"callback\" argument must be of type function"_s);
+        error->putDirect(vm, Identifier::fromString(vm, "code"_s), jsString(vm, String("ERR_INVALID_ARG_TYPE"_s)), 0);
+        throwException(globalObject, scope, error);
+        return JSValue::encode(jsUndefined());
+    }
+
+    auto* queue = jsCast<JSNextTickQueue*>(globalObject->m_nextTickQueue.get());
+    size_t argumentCount = callFrame->argumentCount();
+    Vector<JSValue, 8> arguments;
+    for (size_t i = 1; i < argumentCount; i++)
+        arguments.append(callFrame->uncheckedArgument(i));
+
+    JSValue asyncContext = globalObject->m_asyncContextData.get()->getInternalField(0);
+    queue->enqueue(vm, callback, asyncContext, arguments.span());
+    return JSValue::encode(jsUndefined());
+}
+
+}
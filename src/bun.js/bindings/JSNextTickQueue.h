@@ -3,29 +3,34 @@
 
 #include "JavaScriptCore/JSCInlines.h"
 #include "BunClientData.h"
-#include <JavaScriptCore/JSInternalFieldObjectImpl.h>
+#include <JavaScriptCore/JSDestructibleObject.h>
+#include <wtf/Deque.h>
 
 namespace Bun {
 using namespace JSC;
 
-class JSNextTickQueue : public JSC::JSInternalFieldObjectImpl<3> {
+// process.nextTick()'s queue, kept natively.
+//
+// Stream-heavy code queues millions of ticks, and each used to go through
+// a queue written in JS and a drain function that bounced between native
+// code and JS for every batch of microtasks. Ticks now go into a ring
+// buffer of (callback, arguments, async context) and are run in one native
+// loop; the microtask queue is drained once the ring buffer is empty, the
+// same order node runs them in.
+class JSNextTickQueue : public JSC::JSDestructibleObject {
 public:
-    using Base = JSC::JSInternalFieldObjectImpl<3>;
+    using Base = JSC::JSDestructibleObject;
+    static constexpr bool needsDestruction = true;
 
     template<typename, JSC::SubspaceAccess mode> static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm);
 
     JS_EXPORT_PRIVATE static JSNextTickQueue* create(VM&, Structure*);
     static JSNextTickQueue* create(JSC::JSGlobalObject* globalObject);
-    static JSNextTickQueue* createWithInitialValues(VM&, Structure*);
     static Structure* createStructure(VM&, JSGlobalObject*, JSValue);
 
-    static std::array<JSValue, numberOfInternalFields> initialValues()
+    static void destroy(JSC::JSCell* cell)
     {
-        return { {
-            jsNumber(-1),
-            jsUndefined(),
-            jsUndefined(),
-        } };
+        static_cast<JSNextTickQueue*>(cell)->~JSNextTickQueue();
     }
 
     DECLARE_EXPORT_INFO;
@@ -34,7 +39,25 @@ public:
     JSNextTickQueue(JSC::VM&, JSC::Structure*);
     void finishCreation(JSC::VM&);
 
+    void enqueue(JSC::VM&, JSC::JSValue callback, JSC::JSValue asyncContext, std::span<const JSC::JSValue> arguments);
     bool isEmpty();
     void drain(JSC::VM& vm, JSC::JSGlobalObject* globalObject);
+
+private:
+    struct Tick {
+        JSC::JSValue callback;
+        JSC::JSValue asyncContext;
+        Vector<JSC::JSValue, 2> arguments;
+    };
+
+    // Runs every queued tick, including any queued while running them.
+    void runTicks(JSC::VM&, JSC::JSGlobalObject*);
+
+    // Guarded by cellLock(), for the concurrent marker.
+    Deque<Tick> m_ticks;
+    bool m_isDraining { false };
 };
-}
\ No newline at end of file
+
+JSC_DECLARE_HOST_FUNCTION(jsFunctionNextTick);
+
+}
@@ -0,0 +1,282 @@
+#include "root.h"
+#include "JSNodeHTTPRequestHeaders.h"
+
+#include "AtomStringCache.h"
+#include <JavaScriptCore/JSArray.h>
+#include <JavaScriptCore/JSCInlines.h>
+#include <JavaScriptCore/PropertyNameArray.h>
+#include <bun-uws/src/App.h>
+
+namespace Bun {
+
+using namespace JSC;
+using namespace WebCore;
+
+const ClassInfo JSNodeHTTPRequestHeaders::s_info = { "Object"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSNodeHTTPRequestHeaders) };
+
+JSNodeHTTPRequestHeaders* JSNodeHTTPRequestHeaders::create(VM& vm, Structure* structure, uWS::HttpRequest* request)
+{
+    auto* headers = new (NotNull, allocateCell<JSNodeHTTPRequestHeaders>(vm)) JSNodeHTTPRequestHeaders(vm, structure);
+    headers->finishCreation(vm);
+
+    size_t byteLength = 0;
+    size_t count = 0;
+    for (auto it = request->begin(); it != request->end(); ++it) {
+        auto pair = *it;
+        byteLength += pair.first.length() + pair.second.length();
+        count++;
+    }
+
+    headers->m_bytes.reserveInitialCapacity(byteLength);
+    headers->m_headers.reserveInitialCapacity(count);
+    for (auto it = request->begin(); it != request->end(); ++it) {
+        auto pair = *it;
+        Header header;
+        header.nameOffset = headers->m_bytes.size();
+        header.nameLength = pair.first.length();
+        headers->m_bytes.append(std::span { reinterpret_cast<const LChar*>(pair.first.data()), pair.first.length() });
+        header.valueOffset = headers->m_bytes.size();
+        header.valueLength = pair.second.length();
+        headers->m_bytes.append(std::span { reinterpret_cast<const LChar*>(pair.second.data()), pair.second.length() });
+
+        HTTPHeaderName commonName;
+        if (findHTTPHeaderName(StringView(headers->name(header)), commonName))
+            header.commonName = commonName;
+        headers->m_headers.append(header);
+    }
+
+    headers->m_values.grow(count);
+    headers->m_names.grow(count);
+    return headers;
+}
+
+void JSNodeHTTPRequestHeaders::destroy(JSCell* cell)
+{
+    static_cast<JSNodeHTTPRequestHeaders*>(cell)->~JSNodeHTTPRequestHeaders();
+}
+
+template<typename Visitor>
+void JSNodeHTTPRequestHeaders::visitChildrenImpl(JSCell* cell, Visitor& visitor)
+{
+    auto* thisObject = jsCast<JSNodeHTTPRequestHeaders*>(cell);
+    ASSERT_GC_OBJECT_INHERITS(thisObject, info());
+    Base::visitChildren(thisObject, visitor);
+    for (auto& value : thisObject->m_values)
+        visitor.append(value);
+    for (auto& name : thisObject->m_names)
+        visitor.append(name);
+    visitor.append(thisObject->m_setCookies);
+    visitor.append(thisObject->m_rawHeaders);
+}
+
+DEFINE_VISIT_CHILDREN(JSNodeHTTPRequestHeaders);
+
+JSString* JSNodeHTTPRequestHeaders::valueString(VM& vm, size_t index)
+{
+    if (auto* string = m_values[index].get())
+        return string;
+
+    auto* string = jsString(vm, String(value(m_headers[index])));
+    m_values[index].set(vm, this, string);
+    return string;
+}
+
+JSString* JSNodeHTTPRequestHeaders::nameString(VM& vm, size_t index)
+{
+    if (auto* string = m_names[index].get())
+        return string;
+
+    auto& header = m_headers[index];
+    auto* string = header.commonName
+        ? jsString(vm, String(WTF::httpHeaderNameStringImpl(*header.commonName)))
+        : jsString(vm, String(name(header)));
+    m_names[index].set(vm, this, string);
+    return string;
+}
+
+Identifier JSNodeHTTPRequestHeaders::propertyName(VM& vm, size_t index)
+{
+    auto& header = m_headers[index];
+    if (header.commonName)
+        return Identifier::fromString(vm, WTF::httpHeaderNameStringImpl(*header.commonName));
+
+    auto characters = name(header);
+    if (characters.size() <= AtomStringCache::maxLength) {
+        // Custom header names repeat on every request, so skip
+        // rehashing them by going through the atom memo.
+        std::array<LChar, AtomStringCache::maxLength> lowercased;
+        for (size_t j = 0; j < characters.size(); j++)
+            lowercased[j] = toASCIILower(characters[j]);
+        return Identifier::fromString(vm, clientData(vm)->atomStringCache.make({ lowercased.data(), characters.size() }));
+    }
+    return Identifier::fromString(vm, String(characters).convertToASCIILowercase());
+}
+
+JSArray* JSNodeHTTPRequestHeaders::setCookieArray(JSGlobalObject* globalObject)
+{
+    if (auto* array = m_setCookies.get())
+        return array;
+
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* array = constructEmptyArray(globalObject, nullptr);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    for (size_t i = 0; i < m_headers.size(); i++) {
+        if (m_headers[i].commonName == HTTPHeaderName::SetCookie) {
+            array->push(globalObject, valueString(vm, i));
+            RETURN_IF_EXCEPTION(scope, nullptr);
+        }
+    }
+    m_setCookies.set(vm, this, array);
+    return array;
+}
+
+JSValue JSNodeHTTPRequestHeaders::lookUp(JSGlobalObject* globalObject, const StringImpl& propertyName)
+{
+    if (!propertyName.is8Bit())
+        return {};
+
+    auto characters = propertyName.span8();
+    // Later duplicates overwrite earlier ones, as putting them in order would.
+    for (size_t i = m_headers.size(); i-- > 0;) {
+        auto& header = m_headers[i];
+        auto headerName = name(header);
+        if (headerName.size() != characters.size())
+            continue;
+
+        bool matches = true;
+        for (size_t j = 0; j < characters.size(); j++) {
+            if (toASCIILower(headerName[j]) != characters[j]) {
+                matches = false;
+                break;
+            }
+        }
+        if (!matches)
+            continue;
+
+        if (header.commonName == HTTPHeaderName::SetCookie)
+            return setCookieArray(globalObject);
+        return valueString(globalObject->vm(), i);
+    }
+    return {};
+}
+
+void JSNodeHTTPRequestHeaders::reify(JSGlobalObject* globalObject)
+{
+    if (m_reified)
+        return;
+    m_reified = true;
+
+    VM& vm = globalObject->vm();
+    bool sawSetCookie = false;
+    for (size_t i = 0; i < m_headers.size(); i++) {
+        if (m_headers[i].commonName == HTTPHeaderName::SetCookie) {
+            if (sawSetCookie)
+                continue;
+            sawSetCookie = true;
+            if (auto* array = setCookieArray(globalObject))
+                putDirect(vm, propertyName(vm, i), array, 0);
+            continue;
+        }
+        putDirect(vm, propertyName(vm, i), valueString(vm, i), 0);
+    }
+
+    // The properties hold everything now; rawHeaders needs the rest.
+    if (m_rawHeaders) {
+        m_bytes.clear();
+        m_headers.clear();
+        m_values.clear();
+        m_names.clear();
+    }
+}
+
+JSArray* JSNodeHTTPRequestHeaders::rawHeaders(JSGlobalObject* globalObject)
+{
+    if (auto* array = m_rawHeaders.get())
+        return array;
+
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* array = constructEmptyArray(globalObject, nullptr, m_headers.size() * 2);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    unsigned index = 0;
+    for (size_t i = 0; i < m_headers.size(); i++) {
+        array->putDirectIndex(globalObject, index++, nameString(vm, i));
+        array->putDirectIndex(globalObject, index++, valueString(vm, i));
+        RETURN_IF_EXCEPTION(scope, nullptr);
+    }
+    m_rawHeaders.set(vm, this, array);
+
+    if (m_reified) {
+        m_bytes.clear();
+        m_headers.clear();
+        m_values.clear();
+        m_names.clear();
+    }
+    return array;
+}
+
+bool JSNodeHTTPRequestHeaders::getOwnPropertySlot(JSObject* object, JSGlobalObject* globalObject, PropertyName propertyName, PropertySlot& slot)
+{
+    auto* thisObject = jsCast<JSNodeHTTPRequestHeaders*>(object);
+    if (!thisObject->m_reified) {
+        auto* uid = propertyName.uid();
+        if (uid && !uid->isSymbol()) {
+            if (JSValue value = thisObject->lookUp(globalObject, *uid)) {
+                slot.setValue(thisObject, static_cast<unsigned>(PropertyAttribute::None), value);
+                return true;
+            }
+        }
+    }
+    return Base::getOwnPropertySlot(object, globalObject, propertyName, slot);
+}
+
+bool JSNodeHTTPRequestHeaders::getOwnPropertySlotByIndex(JSObject* object, JSGlobalObject* globalObject, unsigned index, PropertySlot& slot)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(object)->reify(globalObject);
+    return Base::getOwnPropertySlotByIndex(object, globalObject, index, slot);
+}
+
+void JSNodeHTTPRequestHeaders::getOwnPropertyNames(JSObject* object, JSGlobalObject* globalObject, PropertyNameArray& propertyNames, DontEnumPropertiesMode mode)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(object)->reify(globalObject);
+    Base::getOwnPropertyNames(object, globalObject, propertyNames, mode);
+}
+
+bool JSNodeHTTPRequestHeaders::put(JSCell* cell, JSGlobalObject* globalObject, PropertyName propertyName, JSValue value, PutPropertySlot& slot)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(cell)->reify(globalObject);
+    return Base::put(cell, globalObject, propertyName, value, slot);
+}
+
+bool JSNodeHTTPRequestHeaders::putByIndex(JSCell* cell, JSGlobalObject* globalObject, unsigned index, JSValue value, bool shouldThrow)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(cell)->reify(globalObject);
+    return Base::putByIndex(cell, globalObject, index, value, shouldThrow);
+}
+
+bool JSNodeHTTPRequestHeaders::deleteProperty(JSCell* cell, JSGlobalObject* globalObject, PropertyName propertyName, DeletePropertySlot& slot)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(cell)->reify(globalObject);
+    return Base::deleteProperty(cell, globalObject, propertyName, slot);
+}
+
+bool JSNodeHTTPRequestHeaders::deletePropertyByIndex(JSCell* cell, JSGlobalObject* globalObject, unsigned index)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(cell)->reify(globalObject);
+    return Base::deletePropertyByIndex(cell, globalObject, index);
+}
+
+bool JSNodeHTTPRequestHeaders::defineOwnProperty(JSObject* object, JSGlobalObject* globalObject, PropertyName propertyName, const PropertyDescriptor& descriptor, bool shouldThrow)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(object)->reify(globalObject);
+    return Base::defineOwnProperty(object, globalObject, propertyName, descriptor, shouldThrow);
+}
+
+bool JSNodeHTTPRequestHeaders::preventExtensions(JSObject* object, JSGlobalObject* globalObject)
+{
+    jsCast<JSNodeHTTPRequestHeaders*>(object)->reify(globalObject);
+    return Base::preventExtensions(object, globalObject);
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "root.h"
+#include "BunClientData.h"
+#include "HTTPHeaderNames.h"
+
+namespace uWS {
+struct HttpRequest;
+}
+
+namespace Bun {
+
+// `IncomingMessage#headers` for a request served by uWebSockets.
+//
+// The uWS::HttpRequest is only valid while the request handler runs, so
+// its header bytes are copied once, in one allocation, when the object is
+// created. Reading a header then creates just that header's string; the
+// object turns into an ordinary one with every header as a property the
+// first time anything else happens to it (enumeration, assignment,
+// deletion and so on), so it behaves like the plain object it replaces.
+class JSNodeHTTPRequestHeaders final : public JSC::JSDestructibleObject {
+public:
+    using Base = JSC::JSDestructibleObject;
+    static constexpr unsigned StructureFlags = Base::StructureFlags | JSC::OverridesGetOwnPropertySlot | JSC::OverridesGetOwnPropertyNames | JSC::OverridesPut | JSC::GetOwnPropertySlotIsImpure;
+
+    static JSNodeHTTPRequestHeaders* create(JSC::VM&, JSC::Structure*, uWS::HttpRequest*);
+
+    static void destroy(JSC::JSCell*);
+
+    DECLARE_INFO;
+    DECLARE_VISIT_CHILDREN;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+    template<typename, JSC::SubspaceAccess mode> static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        if constexpr (mode == JSC::SubspaceAccess::Concurrently)
+            return nullptr;
+
+        return WebCore::subspaceForImpl<JSNodeHTTPRequestHeaders, WebCore::UseCustomHeapCellType::No>(
+            vm,
+            [](auto& spaces) { return spaces.m_clientSubspaceForNodeHTTPRequestHeaders.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_clientSubspaceForNodeHTTPRequestHeaders = std::forward<decltype(space)>(space); },
+            [](auto& spaces) { return spaces.m_subspaceForNodeHTTPRequestHeaders.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_subspaceForNodeHTTPRequestHeaders = std::forward<decltype(space)>(space); });
+    }
+
+    // `IncomingMessage#rawHeaders`: names and values, alternating, in the
+    // order they arrived. Built on first call and kept.
+    JSC::JSArray* rawHeaders(JSC::JSGlobalObject*);
+
+    static bool getOwnPropertySlot(JSC::JSObject*, JSC::JSGlobalObject*, JSC::PropertyName, JSC::PropertySlot&);
+    static bool getOwnPropertySlotByIndex(JSC::JSObject*, JSC::JSGlobalObject*, unsigned, JSC::PropertySlot&);
+    static void getOwnPropertyNames(JSC::JSObject*, JSC::JSGlobalObject*, JSC::PropertyNameArray&, JSC::DontEnumPropertiesMode);
+    static bool put(JSC::JSCell*, JSC::JSGlobalObject*, JSC::PropertyName, JSC::JSValue, JSC::PutPropertySlot&);
+    static bool putByIndex(JSC::JSCell*, JSC::JSGlobalObject*, unsigned, JSC::JSValue, bool shouldThrow);
+    static bool deleteProperty(JSC::JSCell*, JSC::JSGlobalObject*, JSC::PropertyName, JSC::DeletePropertySlot&);
+    static bool deletePropertyByIndex(JSC::JSCell*, JSC::JSGlobalObject*, unsigned);
+    static bool defineOwnProperty(JSC::JSObject*, JSC::JSGlobalObject*, JSC::PropertyName, const JSC::PropertyDescriptor&, bool shouldThrow);
+    static bool preventExtensions(JSC::JSObject*, JSC::JSGlobalObject*);
+
+private:
+    struct Header {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+        std::optional<WebCore::HTTPHeaderName> commonName;
+    };
+
+    JSNodeHTTPRequestHeaders(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    std::span<const LChar> name(const Header& header) const { return { m_bytes.data() + header.nameOffset, header.nameLength }; }
+    std::span<const LChar> value(const Header& header) const { return { m_bytes.data() + header.valueOffset, header.valueLength }; }
+    JSC::JSString* valueString(JSC::VM&, size_t index);
+    JSC::JSString* nameString(JSC::VM&, size_t index);
+    JSC::Identifier propertyName(JSC::VM&, size_t index);
+
+    // What reading `propertyName` would give, or an empty value if no header
+    // has that (lowercased) name.
+    JSC::JSValue lookUp(JSC::JSGlobalObject*, const StringImpl& propertyName);
+    JSC::JSArray* setCookieArray(JSC::JSGlobalObject*);
+    // Puts every header on the object as a plain property.
+    void reify(JSC::JSGlobalObject*);
+
+    Vector<LChar> m_bytes;
+    Vector<Header> m_headers;
+    // Strings created so far, indexed like m_headers, shared between the
+    // properties and rawHeaders.
+    Vector<JSC::WriteBarrier<JSC::JSString>> m_values;
+    Vector<JSC::WriteBarrier<JSC::JSString>> m_names;
+    JSC::WriteBarrier<JSC::JSArray> m_setCookies;
+    JSC::WriteBarrier<JSC::JSArray> m_rawHeaders;
+    bool m_reified { false };
+};
+
+}
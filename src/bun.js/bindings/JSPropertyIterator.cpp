@@ -8,6 +8,9 @@
 #include "JavaScriptCore/JSCJSValue.h"
 #include "JavaScriptCore/JSGlobalObject.h"
 #include "JavaScriptCore/PropertyNameArray.h"
+#include "JavaScriptCore/Strong.h"
+#include "JavaScriptCore/StrongInlines.h"
+#include "JavaScriptCore/StructureInlines.h"
 #include "wtf/Assertions.h"
 #include "wtf/FastMalloc.h"
 #include "headers-handwritten.h"
@@ -25,6 +28,12 @@ public:
 
     RefPtr<JSC::PropertyNameArrayData> properties;
     JSC::VM& vm;
+    // For an object whose structure could be walked, where each property is
+    // stored in it. While the object keeps that structure, the values are
+    // read straight from those offsets instead of through get().
+    JSC::Strong<JSC::Structure> structure;
+    Vector<JSC::PropertyOffset> offsets;
+
     static JSPropertyIterator* create(JSC::VM& vm, RefPtr<JSC::PropertyNameArrayData> data)
     {
         return new JSPropertyIterator(vm, data);
@@ -33,6 +42,57 @@ public:
     WTF_MAKE_FAST_ALLOCATED;
 };
 
+// Plain objects with data properties only, like the headers given to
+// Bun.serve() and fetch(): everything enumerable is in the structure, and
+// reading a value cannot run any code. Dictionaries are left out because
+// they change in place, without a new structure.
+static bool canReadPropertiesFromStructure(JSC::Structure* structure)
+{
+    if (structure->isDictionary())
+        return false;
+    if (structure->hasNonReifiedStaticProperties())
+        return false;
+    if (structure->typeInfo().overridesGetOwnPropertySlot())
+        return false;
+    if (structure->typeInfo().overridesAnyFormOfGetOwnPropertyNames())
+        return false;
+    if (hasIndexedProperties(structure->indexingType()))
+        return false;
+    if (structure->hasAnyKindOfGetterSetterProperties())
+        return false;
+    return true;
+}
+
+static JSPropertyIterator* createFromStructure(JSC::VM& vm, JSC::Structure* structure, size_t* count)
+{
+    JSC::PropertyNameArray array(vm, PropertyNameMode::StringsAndSymbols, PrivateSymbolMode::Exclude);
+    Vector<JSC::PropertyOffset> offsets;
+
+    // Strings before symbols, as getPropertyNames() would have them.
+    for (bool symbols : { false, true }) {
+        structure->forEachProperty(vm, [&](const PropertyTableEntry& entry) -> bool {
+            if (entry.attributes() & PropertyAttribute::DontEnum)
+                return true;
+            if (entry.key()->isSymbol() != symbols || PropertyName(entry.key()).isPrivateName())
+                return true;
+
+            array.add(entry.key());
+            offsets.append(entry.offset());
+            return true;
+        });
+    }
+
+    *count = array.size();
+    if (array.size() == 0) {
+        return nullptr;
+    }
+
+    auto* iter = JSPropertyIterator::create(vm, array.releaseData());
+    iter->structure.set(vm, structure);
+    iter->offsets = WTFMove(offsets);
+    return iter;
+}
+
 extern "C" JSPropertyIterator* Bun__JSPropertyIterator__create(JSC::JSGlobalObject* globalObject, JSC::EncodedJSValue encodedValue, size_t* count)
 {
     JSC::VM& vm = globalObject->vm();
@@ -40,6 +100,11 @@ extern "C" JSPropertyIterator* Bun__JSPropertyIterator__create(JSC::JSGlobalObje
     JSC::JSObject* object = value.getObject();
     ASSERT(object != NULL);
 
+    JSC::Structure* structure = object->structure();
+    if (canReadPropertiesFromStructure(structure)) {
+        return createFromStructure(vm, structure, count);
+    }
+
     auto scope = DECLARE_THROW_SCOPE(vm);
     JSC::PropertyNameArray array(vm, PropertyNameMode::StringsAndSymbols, PrivateSymbolMode::Exclude);
     object->getPropertyNames(globalObject, array, DontEnumPropertiesMode::Exclude);
@@ -57,6 +122,11 @@ extern "C" EncodedJSValue Bun__JSPropertyIterator__getNameAndValue(JSPropertyIte
 {
     const auto& prop = iter->properties->propertyNameVector()[i];
 
+    if (iter->structure && object->structure() == iter->structure.get()) {
+        *propertyName = Bun::toString(prop.impl());
+        return JSValue::encode(object->getDirect(iter->offsets[i]));
+    }
+
     auto scope = DECLARE_THROW_SCOPE(iter->vm);
     JSValue result = object->get(globalObject, prop);
 
@@ -0,0 +1,419 @@
+#include "root.h"
+#include "JSSharedRing.h"
+
+#include "ZigGlobalObject.h"
+#include <JavaScriptCore/JSCInlines.h>
+#include <JavaScriptCore/Lookup.h>
+#include <JavaScriptCore/WaiterListManager.h>
+
+namespace Bun {
+
+using namespace JSC;
+
+// The start of the buffer. Only the producer writes `tail` and `signal` and
+// only the consumer writes `head`; positions count bytes ever pushed and
+// popped, so `tail - head` is the number of bytes in use.
+struct SharedRingHeader {
+    std::atomic<uint64_t> tail;
+    std::atomic<int32_t> signal;
+    uint32_t capacity;
+    uint32_t magic;
+    uint8_t producerPadding[44];
+    std::atomic<uint64_t> head;
+    uint8_t consumerPadding[56];
+};
+
+static_assert(sizeof(SharedRingHeader) == JSSharedRing::headerSize);
+static_assert(offsetof(SharedRingHeader, signal) == JSSharedRing::signalOffset);
+static_assert(offsetof(SharedRingHeader, head) == 64);
+
+static constexpr uint32_t sharedRingMagic = 0x31525342; // "BSR1"
+static constexpr size_t recordHeaderSize = sizeof(uint32_t);
+
+static SharedRingHeader* ringHeader(ArrayBuffer* buffer)
+{
+    return static_cast<SharedRingHeader*>(buffer->data());
+}
+
+static uint8_t* ringData(ArrayBuffer* buffer)
+{
+    return static_cast<uint8_t*>(buffer->data()) + JSSharedRing::headerSize;
+}
+
+// Copies to and from position `position`, splitting the copy where it wraps.
+static void copyIntoRing(uint8_t* data, size_t capacity, uint64_t position, const uint8_t* source, size_t length)
+{
+    size_t index = position % capacity;
+    size_t first = std::min(length, capacity - index);
+    memcpy(data + index, source, first);
+    memcpy(data, source + first, length - first);
+}
+
+static void copyFromRing(const uint8_t* data, size_t capacity, uint64_t position, uint8_t* destination, size_t length)
+{
+    size_t index = position % capacity;
+    size_t first = std::min(length, capacity - index);
+    memcpy(destination, data + index, first);
+    memcpy(destination + first, data, length - first);
+}
+
+const ClassInfo JSSharedRing::s_info = { "SharedRing"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSSharedRing) };
+
+JSSharedRing* JSSharedRing::create(VM& vm, Structure* structure, JSArrayBuffer* buffer)
+{
+    JSSharedRing* ring = new (NotNull, allocateCell<JSSharedRing>(vm)) JSSharedRing(vm, structure);
+    ring->finishCreation(vm, buffer);
+    return ring;
+}
+
+JSSharedRing* JSSharedRing::tryCreateFromBuffer(VM& vm, Structure* structure, JSArrayBuffer* buffer)
+{
+    auto* impl = buffer->impl();
+    if (!impl || !impl->isShared() || impl->isResizableOrGrowableShared())
+        return nullptr;
+
+    size_t byteLength = impl->byteLength();
+    if (byteLength < headerSize + minimumCapacity || byteLength > headerSize + maximumCapacity)
+        return nullptr;
+
+    auto* header = ringHeader(impl);
+    if (header->magic != sharedRingMagic || header->capacity != byteLength - headerSize)
+        return nullptr;
+
+    return create(vm, structure, buffer);
+}
+
+void JSSharedRing::finishCreation(VM& vm, JSArrayBuffer* buffer)
+{
+    Base::finishCreation(vm);
+    m_buffer.set(vm, this, buffer);
+}
+
+template<typename Visitor>
+void JSSharedRing::visitChildrenImpl(JSCell* cell, Visitor& visitor)
+{
+    JSSharedRing* thisObject = jsCast<JSSharedRing*>(cell);
+    ASSERT_GC_OBJECT_INHERITS(thisObject, info());
+    Base::visitChildren(thisObject, visitor);
+    visitor.append(thisObject->m_buffer);
+    visitor.append(thisObject->m_signal);
+}
+
+DEFINE_VISIT_CHILDREN(JSSharedRing);
+
+JSInt32Array* JSSharedRing::signal(JSGlobalObject* globalObject)
+{
+    if (m_signal)
+        return m_signal.get();
+
+    auto* array = JSInt32Array::create(globalObject, globalObject->typedArrayStructure(TypeInt32, false), impl(), signalOffset, 1);
+    if (array)
+        m_signal.set(globalObject->vm(), this, array);
+    return array;
+}
+
+uint32_t JSSharedRing::capacity() const
+{
+    // Never trust the header's copy: the buffer's length cannot change.
+    return impl()->byteLength() - headerSize;
+}
+
+std::optional<bool> JSSharedRing::push(std::span<const uint8_t> record)
+{
+    auto* header = ringHeader(impl());
+    uint8_t* data = ringData(impl());
+    size_t capacity = this->capacity();
+
+    uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    uint64_t head = header->head.load(std::memory_order_acquire);
+    if (head > tail || tail - head > capacity)
+        return std::nullopt;
+
+    size_t recordSize = recordHeaderSize + record.size();
+    if (capacity - (tail - head) < recordSize)
+        return false;
+
+    uint32_t length = record.size();
+    copyIntoRing(data, capacity, tail, reinterpret_cast<const uint8_t*>(&length), recordHeaderSize);
+    copyIntoRing(data, capacity, tail + recordHeaderSize, record.data(), record.size());
+    header->tail.store(tail + recordSize, std::memory_order_seq_cst);
+    header->signal.fetch_add(1, std::memory_order_seq_cst);
+
+    // A consumer only waits after finding the ring empty. If it has popped
+    // everything before this record it may be waiting now; otherwise it has
+    // records left and will see this one without being woken. Reading head
+    // after publishing tail means one of us always sees the other's write.
+    if (header->head.load(std::memory_order_seq_cst) == tail)
+        WaiterListManager::singleton().notifyWaiter(&header->signal, 1);
+
+    return true;
+}
+
+JSSharedRing::PopResult JSSharedRing::nextRecordLength(size_t& length) const
+{
+    auto* header = ringHeader(impl());
+    size_t capacity = this->capacity();
+
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    uint64_t tail = header->tail.load(std::memory_order_acquire);
+    if (head > tail || tail - head > capacity)
+        return PopResult::Corrupted;
+    if (head == tail)
+        return PopResult::Empty;
+
+    uint64_t available = tail - head;
+    if (available < recordHeaderSize)
+        return PopResult::Corrupted;
+
+    uint32_t recordLength;
+    copyFromRing(ringData(impl()), capacity, head, reinterpret_cast<uint8_t*>(&recordLength), recordHeaderSize);
+    if (recordLength > available - recordHeaderSize)
+        return PopResult::Corrupted;
+
+    length = recordLength;
+    return PopResult::Popped;
+}
+
+JSSharedRing::PopResult JSSharedRing::pop(std::span<uint8_t> destination, size_t& length)
+{
+    auto result = nextRecordLength(length);
+    if (result != PopResult::Popped)
+        return result;
+    if (destination.size() < length)
+        return PopResult::TooSmall;
+
+    auto* header = ringHeader(impl());
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    copyFromRing(ringData(impl()), capacity(), head + recordHeaderSize, destination.data(), length);
+    // Sequentially consistent for the same reason as the tail store in push().
+    header->head.store(head + recordHeaderSize + length, std::memory_order_seq_cst);
+    return PopResult::Popped;
+}
+
+static JSSharedRing* jsSharedRingCast(JSGlobalObject* globalObject, ThrowScope& scope, JSValue thisValue, ASCIILiteral methodName)
+{
+    if (auto* ring = jsDynamicCast<JSSharedRing*>(thisValue))
+        return ring;
+    throwTypeError(globalObject, scope, makeString("SharedRing.prototype."_s, methodName, " called on an object that is not a SharedRing"_s));
+    return nullptr;
+}
+
+static void throwCorruptedRing(JSGlobalObject* globalObject, ThrowScope& scope)
+{
+    throwException(globalObject, scope, createError(globalObject, "SharedRing positions are corrupted; was its SharedArrayBuffer written to directly?"_s));
+}
+
+static std::optional<std::span<uint8_t>> bytesOfView(JSGlobalObject* globalObject, ThrowScope& scope, JSValue value, ASCIILiteral methodName)
+{
+    if (auto* view = jsDynamicCast<JSArrayBufferView*>(value)) {
+        if (UNLIKELY(view->isDetached())) {
+            throwTypeError(globalObject, scope, makeString("SharedRing."_s, methodName, " cannot use a detached buffer"_s));
+            return std::nullopt;
+        }
+        return std::span { static_cast<uint8_t*>(view->vector()), view->byteLength() };
+    }
+    if (auto* arrayBuffer = jsDynamicCast<JSArrayBuffer*>(value)) {
+        auto* impl = arrayBuffer->impl();
+        if (UNLIKELY(!impl || impl->isDetached())) {
+            throwTypeError(globalObject, scope, makeString("SharedRing."_s, methodName, " cannot use a detached buffer"_s));
+            return std::nullopt;
+        }
+        return std::span { static_cast<uint8_t*>(impl->data()), impl->byteLength() };
+    }
+    throwTypeError(globalObject, scope, makeString("SharedRing."_s, methodName, " expects a TypedArray, DataView or ArrayBuffer"_s));
+    return std::nullopt;
+}
+
+static JSC_DECLARE_HOST_FUNCTION(jsSharedRingPrototypeFunction_push);
+static JSC_DECLARE_HOST_FUNCTION(jsSharedRingPrototypeFunction_pop);
+static JSC_DECLARE_HOST_FUNCTION(jsSharedRingPrototypeFunction_popInto);
+static JSC_DECLARE_CUSTOM_GETTER(jsSharedRing_buffer);
+static JSC_DECLARE_CUSTOM_GETTER(jsSharedRing_capacity);
+static JSC_DECLARE_CUSTOM_GETTER(jsSharedRing_signal);
+
+JSC_DEFINE_HOST_FUNCTION(jsSharedRingPrototypeFunction_push, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, callFrame->thisValue(), "push"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto record = bytesOfView(globalObject, scope, callFrame->argument(0), "push"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    if (UNLIKELY(record->size() > ring->capacity() - recordHeaderSize)) {
+        throwRangeError(globalObject, scope, makeString("SharedRing.push record of "_s, record->size(), " bytes can never fit in a ring of "_s, ring->capacity(), " bytes"_s));
+        return {};
+    }
+
+    auto pushed = ring->push(*record);
+    if (UNLIKELY(!pushed)) {
+        throwCorruptedRing(globalObject, scope);
+        return {};
+    }
+    return JSValue::encode(jsBoolean(*pushed));
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsSharedRingPrototypeFunction_pop, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, callFrame->thisValue(), "pop"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    size_t length = 0;
+    auto result = ring->nextRecordLength(length);
+    if (result == JSSharedRing::PopResult::Empty)
+        return JSValue::encode(jsNull());
+
+    if (result == JSSharedRing::PopResult::Popped) {
+        auto* array = JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint8, false), length);
+        RETURN_IF_EXCEPTION(scope, {});
+        result = ring->pop(std::span { array->typedVector(), length }, length);
+        if (result == JSSharedRing::PopResult::Popped)
+            return JSValue::encode(array);
+    }
+
+    throwCorruptedRing(globalObject, scope);
+    return {};
+}
+
+// popInto(view) copies the next record into `view` and returns its length,
+// or null if the ring is empty, so a consumer can drain it without
+// allocating.
+JSC_DEFINE_HOST_FUNCTION(jsSharedRingPrototypeFunction_popInto, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, callFrame->thisValue(), "popInto"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto destination = bytesOfView(globalObject, scope, callFrame->argument(0), "popInto"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    size_t length = 0;
+    switch (ring->pop(*destination, length)) {
+    case JSSharedRing::PopResult::Empty:
+        return JSValue::encode(jsNull());
+    case JSSharedRing::PopResult::Popped:
+        return JSValue::encode(jsNumber(length));
+    case JSSharedRing::PopResult::TooSmall:
+        throwRangeError(globalObject, scope, makeString("SharedRing.popInto buffer of "_s, destination->size(), " bytes is smaller than the next record of "_s, length, " bytes"_s));
+        return {};
+    case JSSharedRing::PopResult::Corrupted:
+        break;
+    }
+
+    throwCorruptedRing(globalObject, scope);
+    return {};
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsSharedRing_buffer, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, JSValue::decode(thisValue), "buffer"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    return JSValue::encode(ring->buffer());
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsSharedRing_capacity, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, JSValue::decode(thisValue), "capacity"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    return JSValue::encode(jsNumber(ring->capacity()));
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsSharedRing_signal, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* ring = jsSharedRingCast(globalObject, scope, JSValue::decode(thisValue), "signal"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    RELEASE_AND_RETURN(scope, JSValue::encode(ring->signal(globalObject)));
+}
+
+static const HashTableValue JSSharedRingPrototypeTableValues[] = {
+    { "buffer"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsSharedRing_buffer, 0 } },
+    { "capacity"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsSharedRing_capacity, 0 } },
+    { "signal"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsSharedRing_signal, 0 } },
+    { "push"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSharedRingPrototypeFunction_push, 1 } },
+    { "pop"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSharedRingPrototypeFunction_pop, 0 } },
+    { "popInto"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSharedRingPrototypeFunction_popInto, 1 } },
+};
+
+const ClassInfo JSSharedRingPrototype::s_info = { "SharedRing"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSSharedRingPrototype) };
+
+void JSSharedRingPrototype::finishCreation(VM& vm, JSGlobalObject*)
+{
+    Base::finishCreation(vm);
+    reifyStaticProperties(vm, JSSharedRing::info(), JSSharedRingPrototypeTableValues, *this);
+    JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
+}
+
+const ClassInfo JSSharedRingConstructor::s_info = { "SharedRing"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSSharedRingConstructor) };
+
+JSSharedRingConstructor* JSSharedRingConstructor::create(VM& vm, Structure* structure, JSSharedRingPrototype* prototype)
+{
+    JSSharedRingConstructor* constructor = new (NotNull, allocateCell<JSSharedRingConstructor>(vm)) JSSharedRingConstructor(vm, structure);
+    constructor->finishCreation(vm, prototype);
+    return constructor;
+}
+
+void JSSharedRingConstructor::finishCreation(VM& vm, JSSharedRingPrototype* prototype)
+{
+    Base::finishCreation(vm, 1, "SharedRing"_s, PropertyAdditionMode::WithoutStructureTransition);
+    putDirectWithoutTransition(vm, vm.propertyNames->prototype, prototype, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+    prototype->putDirectWithoutTransition(vm, vm.propertyNames->constructor, this, static_cast<unsigned>(PropertyAttribute::DontEnum));
+}
+
+EncodedJSValue JSSharedRingConstructor::call(JSGlobalObject* globalObject, CallFrame*)
+{
+    auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+    throwTypeError(globalObject, scope, "Class constructor SharedRing cannot be invoked without 'new'"_s);
+    return {};
+}
+
+// new SharedRing(byteSize) allocates a SharedArrayBuffer with room for
+// byteSize bytes of records, each of which also takes a 4-byte length.
+EncodedJSValue JSSharedRingConstructor::construct(JSGlobalObject* lexicalGlobalObject, CallFrame* callFrame)
+{
+    auto& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+
+    JSValue byteSizeValue = callFrame->argument(0);
+    double byteSize = byteSizeValue.isNumber() ? byteSizeValue.asNumber() : 0;
+    if (!byteSizeValue.isNumber() || byteSize != std::trunc(byteSize) || byteSize < JSSharedRing::minimumCapacity || byteSize > JSSharedRing::maximumCapacity) {
+        throwRangeError(globalObject, scope, makeString("SharedRing byteSize must be an integer from "_s, JSSharedRing::minimumCapacity, " to "_s, JSSharedRing::maximumCapacity));
+        return {};
+    }
+
+    Structure* structure = globalObject->JSSharedRingStructure();
+    JSValue newTarget = callFrame->newTarget();
+    if (UNLIKELY(globalObject->JSSharedRing() != newTarget)) {
+        auto* functionGlobalObject = jsCast<Zig::GlobalObject*>(getFunctionRealm(globalObject, newTarget.getObject()));
+        RETURN_IF_EXCEPTION(scope, {});
+        structure = InternalFunction::createSubclassStructure(globalObject, newTarget.getObject(), functionGlobalObject->JSSharedRingStructure());
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    size_t capacity = static_cast<size_t>(byteSize);
+    auto buffer = ArrayBuffer::tryCreate(JSSharedRing::headerSize + capacity, 1);
+    if (UNLIKELY(!buffer)) {
+        throwOutOfMemoryError(globalObject, scope);
+        return {};
+    }
+    buffer->makeShared();
+
+    auto* header = ringHeader(buffer.get());
+    header->capacity = capacity;
+    header->magic = sharedRingMagic;
+
+    auto* arrayBuffer = JSArrayBuffer::create(vm, globalObject->arrayBufferStructure(ArrayBufferSharingMode::Shared), WTFMove(buffer));
+    return JSValue::encode(JSSharedRing::create(vm, structure, arrayBuffer));
+}
+
+}
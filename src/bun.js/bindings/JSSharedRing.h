@@ -0,0 +1,162 @@
+#pragma once
+
+#include "root.h"
+#include "BunClientData.h"
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSTypedArrays.h>
+#include <JavaScriptCore/InternalFunction.h>
+
+namespace Bun {
+
+// Bun.SharedRing: a byte queue in a SharedArrayBuffer for handing records
+// from one thread to another without a postMessage per record.
+//
+// The ring is cloned into a Worker like any SharedArrayBuffer, so both ends
+// see the same memory. One thread pushes and one thread pops; a record is a
+// length word followed by its bytes, copied straight into and out of the
+// ring. push() bumps the `signal` word after every record and wakes
+// Atomics.waitAsync() waiters when the ring had been drained, so an idle
+// consumer costs nothing until the next record lands:
+//
+//     while (true) {
+//         const seen = Atomics.load(ring.signal, 0);
+//         const record = ring.pop();
+//         if (record) handle(record);
+//         else await Atomics.waitAsync(ring.signal, 0, seen).value;
+//     }
+//
+// Anyone holding the SharedArrayBuffer can write to it, so the positions
+// are checked on every call and a ring with impossible ones throws rather
+// than reading or writing outside its data.
+class JSSharedRing final : public JSC::JSNonFinalObject {
+public:
+    using Base = JSC::JSNonFinalObject;
+
+    // The header takes two cache lines so the producer's and consumer's
+    // positions do not share one.
+    static constexpr size_t headerSize = 128;
+    static constexpr size_t minimumCapacity = 16;
+    static constexpr size_t maximumCapacity = 1 << 30;
+    // Where the signal word lives in the buffer.
+    static constexpr size_t signalOffset = 8;
+
+    static JSSharedRing* create(JSC::VM&, JSC::Structure*, JSC::JSArrayBuffer*);
+
+    // Wraps a buffer that already holds a ring, or returns nullptr if its
+    // header does not describe one that fits the buffer.
+    static JSSharedRing* tryCreateFromBuffer(JSC::VM&, JSC::Structure*, JSC::JSArrayBuffer*);
+
+    DECLARE_INFO;
+    DECLARE_VISIT_CHILDREN;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+    template<typename, JSC::SubspaceAccess mode> static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        if constexpr (mode == JSC::SubspaceAccess::Concurrently)
+            return nullptr;
+
+        return WebCore::subspaceForImpl<JSSharedRing, WebCore::UseCustomHeapCellType::No>(
+            vm,
+            [](auto& spaces) { return spaces.m_clientSubspaceForSharedRing.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_clientSubspaceForSharedRing = std::forward<decltype(space)>(space); },
+            [](auto& spaces) { return spaces.m_subspaceForSharedRing.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_subspaceForSharedRing = std::forward<decltype(space)>(space); });
+    }
+
+    JSC::JSArrayBuffer* buffer() const { return m_buffer.get(); }
+    // An Int32Array over the signal word, created on first use.
+    JSC::JSInt32Array* signal(JSC::JSGlobalObject*);
+    JSC::ArrayBuffer* impl() const { return m_buffer->impl(); }
+    uint32_t capacity() const;
+
+    // Only the producer may call this. Returns false when the record does
+    // not fit in the free space, and nullopt when the ring is corrupted.
+    std::optional<bool> push(std::span<const uint8_t>);
+
+    enum class PopResult : uint8_t {
+        Empty,
+        Popped,
+        TooSmall,
+        Corrupted,
+    };
+
+    // Only the consumer may call these. nextRecordLength() reports the
+    // length of the record pop() would return without taking it.
+    PopResult nextRecordLength(size_t& length) const;
+    PopResult pop(std::span<uint8_t> destination, size_t& length);
+
+private:
+    JSSharedRing(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSC::JSArrayBuffer*);
+
+    JSC::WriteBarrier<JSC::JSArrayBuffer> m_buffer;
+    JSC::WriteBarrier<JSC::JSInt32Array> m_signal;
+};
+
+class JSSharedRingPrototype final : public JSC::JSNonFinalObject {
+public:
+    using Base = JSC::JSNonFinalObject;
+
+    static JSSharedRingPrototype* create(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::Structure* structure)
+    {
+        JSSharedRingPrototype* prototype = new (NotNull, JSC::allocateCell<JSSharedRingPrototype>(vm)) JSSharedRingPrototype(vm, structure);
+        prototype->finishCreation(vm, globalObject);
+        return prototype;
+    }
+
+    DECLARE_INFO;
+    template<typename CellType, JSC::SubspaceAccess>
+    static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        STATIC_ASSERT_ISO_SUBSPACE_SHARABLE(JSSharedRingPrototype, Base);
+        return &vm.plainObjectSpace();
+    }
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+private:
+    JSSharedRingPrototype(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSC::JSGlobalObject*);
+};
+
+class JSSharedRingConstructor final : public JSC::InternalFunction {
+public:
+    using Base = JSC::InternalFunction;
+    static JSSharedRingConstructor* create(JSC::VM&, JSC::Structure*, JSSharedRingPrototype*);
+
+    static constexpr unsigned StructureFlags = Base::StructureFlags;
+    static constexpr bool needsDestruction = false;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::InternalFunctionType, StructureFlags), info());
+    }
+
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES construct(JSC::JSGlobalObject*, JSC::CallFrame*);
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES call(JSC::JSGlobalObject*, JSC::CallFrame*);
+    DECLARE_EXPORT_INFO;
+
+private:
+    JSSharedRingConstructor(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure, call, construct)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSSharedRingPrototype*);
+};
+
+}
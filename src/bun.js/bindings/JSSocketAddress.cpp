@@ -45,19 +45,54 @@ Structure* createStructure(VM& vm, JSGlobalObject* globalObject)
 } // namespace JSSocketAddress
 } // namespace Bun
 
-extern "C" JSObject* JSSocketAddress__create(JSGlobalObject* globalObject, JSString* value, int32_t port, bool isIPv6)
+static const String& familyName(bool isIPv6)
 {
     static const NeverDestroyed<String> IPv4 = MAKE_STATIC_STRING_IMPL("IPv4");
     static const NeverDestroyed<String> IPv6 = MAKE_STATIC_STRING_IMPL("IPv6");
+    return isIPv6 ? IPv6 : IPv4;
+}
 
+extern "C" JSObject* JSSocketAddress__create(JSGlobalObject* globalObject, JSString* value, int32_t port, bool isIPv6)
+{
     VM& vm = globalObject->vm();
 
     auto* global = jsCast<Zig::GlobalObject*>(globalObject);
 
     JSObject* thisObject = constructEmptyObject(vm, global->JSSocketAddressStructure());
     thisObject->putDirectOffset(vm, 0, value);
-    thisObject->putDirectOffset(vm, 1, isIPv6 ? jsString(vm, IPv6) : jsString(vm, IPv4));
+    thisObject->putDirectOffset(vm, 1, jsString(vm, familyName(isIPv6)));
     thisObject->putDirectOffset(vm, 2, jsNumber(port));
 
     return thisObject;
 }
+
+static bool isStringEqual(JSValue value, StringView expected)
+{
+    if (!value.isString() || asString(value)->isRope())
+        return false;
+    return StringView(asString(value)->tryGetValue()) == expected;
+}
+
+// Rate limiters and loggers ask for the same request's address several times,
+// and every request on a keep-alive connection has the same one. The last
+// object is handed out again while it still holds exactly the address, family
+// and port asked for; one that was changed or extended gets replaced.
+extern "C" JSObject* JSSocketAddress__createFromText(JSGlobalObject* globalObject, const LChar* address, size_t length, int32_t port, bool isIPv6)
+{
+    VM& vm = globalObject->vm();
+    auto* global = jsCast<Zig::GlobalObject*>(globalObject);
+    StringView text { std::span<const LChar> { address, length } };
+
+    if (JSObject* last = global->m_lastSocketAddress.get()) {
+        JSValue lastPort = last->getDirectOffset(2);
+        if (last->structure() == global->JSSocketAddressStructure()
+            && lastPort.isInt32() && lastPort.asInt32() == port
+            && isStringEqual(last->getDirectOffset(0), text)
+            && isStringEqual(last->getDirectOffset(1), familyName(isIPv6)))
+            return last;
+    }
+
+    JSObject* thisObject = JSSocketAddress__create(globalObject, jsString(vm, text.toString()), port, isIPv6);
+    global->m_lastSocketAddress.set(vm, global, thisObject);
+    return thisObject;
+}
@@ -14,3 +14,4 @@ Structure* createStructure(VM& vm, JSGlobalObject* globalObject);
 } // namespace Bun
 
 extern "C" JSObject* JSSocketAddress__create(JSGlobalObject* globalObject, JSString* value, int port, bool isIPv6);
+extern "C" JSObject* JSSocketAddress__createFromText(JSGlobalObject* globalObject, const LChar* address, size_t length, int32_t port, bool isIPv6);
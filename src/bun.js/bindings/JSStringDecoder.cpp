@@ -11,6 +11,7 @@
 #include "BunClientData.h"
 #include "wtf/text/StringImpl.h"
 #include "wtf/unicode/CharacterNames.h"
+#include "simdutf.h"
 
 namespace WebCore {
 
@@ -30,6 +31,44 @@ static WTF::String replacementString()
     return WTF::String(std::span<const UChar> { u"\uFFFD", 1 });
 }
 
+// Decodes a run of UTF-8 that contains no incomplete trailing sequence.
+// Pure ASCII and text that fits in Latin-1 become 8-bit strings; other valid
+// input is transcoded straight into a 16-bit StringImpl. Malformed input is
+// left to the generic decoder so replacement characters match Buffer#toString.
+JSC::JSValue decodeCompleteUTF8(JSC::VM& vm, JSC::JSGlobalObject* globalObject, const uint8_t* bufPtr, size_t length)
+{
+    if (length == 0)
+        return JSC::jsEmptyString(vm);
+
+    const char* input = reinterpret_cast<const char*>(bufPtr);
+    if (simdutf::validate_ascii(input, length))
+        return JSC::jsString(vm, WTF::String(std::span<const LChar> { bufPtr, length }));
+
+    if (!simdutf::validate_utf8(input, length))
+        return JSC::JSValue::decode(Bun__encoding__toString(bufPtr, length, globalObject, static_cast<uint8_t>(BufferEncodingType::utf8)));
+
+    size_t utf16Length = simdutf::utf16_length_from_utf8(input, length);
+
+    // Every non-ASCII Latin-1 character is exactly two bytes of UTF-8, so
+    // anything longer than that must contain a character above U+00FF.
+    if (length <= utf16Length * 2) {
+        LChar* latin1 = nullptr;
+        auto impl = WTF::StringImpl::tryCreateUninitialized(utf16Length, latin1);
+        if (UNLIKELY(!impl))
+            return JSC::JSValue::decode(Bun__encoding__toString(bufPtr, length, globalObject, static_cast<uint8_t>(BufferEncodingType::utf8)));
+        if (simdutf::convert_utf8_to_latin1(input, length, reinterpret_cast<char*>(latin1)) == utf16Length)
+            return JSC::jsString(vm, WTF::String(impl.releaseNonNull()));
+    }
+
+    UChar* utf16 = nullptr;
+    auto impl = WTF::StringImpl::tryCreateUninitialized(utf16Length, utf16);
+    if (UNLIKELY(!impl))
+        return JSC::JSValue::decode(Bun__encoding__toString(bufPtr, length, globalObject, static_cast<uint8_t>(BufferEncodingType::utf8)));
+    size_t written = simdutf::convert_valid_utf8_to_utf16le(input, length, reinterpret_cast<char16_t*>(utf16));
+    ASSERT_UNUSED(written, written == utf16Length);
+    return JSC::jsString(vm, WTF::String(impl.releaseNonNull()));
+}
+
 static inline JSC::EncodedJSValue jsStringDecoderCast(JSGlobalObject* globalObject, JSValue stringDecoderValue)
 {
     if (LIKELY(jsDynamicCast<JSStringDecoder*>(stringDecoderValue)))
@@ -101,6 +140,8 @@ JSC::JSValue JSStringDecoder::fillLast(JSC::VM& vm, JSC::JSGlobalObject* globalO
 
     if (m_lastNeed <= length) {
         memmove(m_lastChar + m_lastTotal - m_lastNeed, bufPtr, m_lastNeed);
+        if (m_encoding == BufferEncodingType::utf8)
+            RELEASE_AND_RETURN(throwScope, decodeCompleteUTF8(vm, globalObject, m_lastChar, m_lastTotal));
         RELEASE_AND_RETURN(throwScope, JSC::JSValue::decode(Bun__encoding__toString(m_lastChar, m_lastTotal, globalObject, static_cast<uint8_t>(m_encoding))));
     }
     memmove(m_lastChar + m_lastTotal - m_lastNeed, bufPtr, length);
@@ -189,12 +230,12 @@ JSC::JSValue JSStringDecoder::text(JSC::VM& vm, JSC::JSGlobalObject* globalObjec
     case BufferEncodingType::utf8: {
         uint32_t total = utf8CheckIncomplete(bufPtr, length, offset);
         if (!m_lastNeed)
-            RELEASE_AND_RETURN(throwScope, JSC::JSValue::decode(Bun__encoding__toString(bufPtr + offset, length - offset, globalObject, static_cast<uint8_t>(m_encoding))));
+            RELEASE_AND_RETURN(throwScope, decodeCompleteUTF8(vm, globalObject, bufPtr + offset, length - offset));
         m_lastTotal = total;
         uint32_t end = length - (total - m_lastNeed);
         if (end < length)
             memmove(m_lastChar, bufPtr + end, std::min(4U, length - end));
-        RELEASE_AND_RETURN(throwScope, JSC::JSValue::decode(Bun__encoding__toString(bufPtr + offset, end - offset, globalObject, static_cast<uint8_t>(m_encoding))));
+        RELEASE_AND_RETURN(throwScope, decodeCompleteUTF8(vm, globalObject, bufPtr + offset, end - offset));
     }
     case BufferEncodingType::base64:
     case BufferEncodingType::base64url: {
@@ -6,6 +6,10 @@
 namespace WebCore {
 using namespace JSC;
 
+// Decodes UTF-8 that does not end in an incomplete sequence, returning 8-bit
+// strings for ASCII and Latin-1 input. Malformed input gets U+FFFD.
+JSC::JSValue decodeCompleteUTF8(JSC::VM&, JSC::JSGlobalObject*, const uint8_t*, size_t);
+
 class JSStringDecoder : public JSC::JSDestructibleObject {
     using Base = JSC::JSDestructibleObject;
 
@@ -0,0 +1,139 @@
+// The batch handed to a UDP socket's "data" handler when it was opened with
+// { batch: true }: every datagram of one receive copied into a single
+// buffer, so JavaScript is called once per receive instead of once per
+// datagram.
+//
+//   {
+//     data: Uint8Array,       // the datagrams back to back
+//     offsets: Uint32Array,   // datagram i is data[offsets[i], offsets[i + 1])
+//     addresses: string[],    // the sender of each datagram
+//     ports: Uint16Array,
+//   }
+#include "root.h"
+#include "ZigGlobalObject.h"
+#include "libusockets.h"
+
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSTypedArrays.h>
+#include <JavaScriptCore/ObjectConstructor.h>
+
+#if OS(WINDOWS)
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace Bun {
+using namespace JSC;
+
+struct UDPDatagram {
+    const char* payload;
+    size_t length;
+    const sockaddr* peer;
+};
+
+// Datagrams coalesced by UDP_GRO come as one packet; they are split back up
+// here so that offsets has one entry per datagram.
+template<typename Functor>
+static void forEachDatagram(struct us_udp_packet_buffer_t* buffer, int count, const Functor& functor)
+{
+    for (int i = 0; i < count; i++) {
+        const char* payload = us_udp_packet_buffer_payload(buffer, i);
+        size_t length = static_cast<size_t>(us_udp_packet_buffer_payload_length(buffer, i));
+        size_t segmentSize = static_cast<size_t>(us_udp_packet_buffer_segment_size(buffer, i));
+        auto* peer = reinterpret_cast<const sockaddr*>(us_udp_packet_buffer_peer(buffer, i));
+        if (!segmentSize || segmentSize >= length) {
+            functor(UDPDatagram { payload, length, peer });
+            continue;
+        }
+
+        for (size_t offset = 0; offset < length; offset += segmentSize)
+            functor(UDPDatagram { payload + offset, std::min(segmentSize, length - offset), peer });
+    }
+}
+
+static bool samePeer(const sockaddr* a, const sockaddr* b)
+{
+    if (a->sa_family != b->sa_family)
+        return false;
+    if (a->sa_family == AF_INET6)
+        return !memcmp(a, b, sizeof(sockaddr_in6));
+    return !memcmp(a, b, sizeof(sockaddr_in));
+}
+
+static uint16_t peerPort(const sockaddr* peer)
+{
+    if (peer->sa_family == AF_INET6)
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(peer)->sin6_port);
+    return ntohs(reinterpret_cast<const sockaddr_in*>(peer)->sin_port);
+}
+
+static JSString* peerAddress(VM& vm, const sockaddr* peer)
+{
+    char text[INET6_ADDRSTRLEN] = {};
+    if (peer->sa_family == AF_INET6)
+        inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(peer)->sin6_addr, text, sizeof(text));
+    else
+        inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(peer)->sin_addr, text, sizeof(text));
+    return jsString(vm, String::fromLatin1(text));
+}
+
+} // namespace Bun
+
+extern "C" JSC::EncodedJSValue UDPSocket__createPacketBatch(Zig::GlobalObject* globalObject, struct us_udp_packet_buffer_t* buffer, int count)
+{
+    using namespace JSC;
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    size_t datagrams = 0;
+    size_t totalLength = 0;
+    Bun::forEachDatagram(buffer, count, [&](const Bun::UDPDatagram& datagram) {
+        datagrams++;
+        totalLength += datagram.length;
+    });
+
+    auto* data = JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint8, false), totalLength);
+    RETURN_IF_EXCEPTION(scope, {});
+    auto* offsets = JSUint32Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint32, false), datagrams + 1);
+    RETURN_IF_EXCEPTION(scope, {});
+    auto* ports = JSUint16Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint16, false), datagrams);
+    RETURN_IF_EXCEPTION(scope, {});
+    auto* addresses = constructEmptyArray(globalObject, nullptr, datagrams);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    uint8_t* bytes = data->typedVector();
+    uint32_t* offsetValues = offsets->typedVector();
+    uint16_t* portValues = ports->typedVector();
+
+    // Senders tend to repeat within a batch, so the last one's string is reused.
+    const sockaddr* lastPeer = nullptr;
+    JSString* lastAddress = nullptr;
+    size_t index = 0;
+    size_t position = 0;
+    Bun::forEachDatagram(buffer, count, [&](const Bun::UDPDatagram& datagram) {
+        if (datagram.length)
+            memcpy(bytes + position, datagram.payload, datagram.length);
+        offsetValues[index] = static_cast<uint32_t>(position);
+        position += datagram.length;
+
+        if (!lastPeer || !Bun::samePeer(lastPeer, datagram.peer)) {
+            lastPeer = datagram.peer;
+            lastAddress = Bun::peerAddress(vm, datagram.peer);
+        }
+        portValues[index] = Bun::peerPort(datagram.peer);
+        addresses->putDirectIndex(globalObject, index, lastAddress);
+        index++;
+    });
+    RETURN_IF_EXCEPTION(scope, {});
+    offsetValues[datagrams] = static_cast<uint32_t>(position);
+
+    JSObject* batch = constructEmptyObject(globalObject, globalObject->objectPrototype(), 4);
+    batch->putDirect(vm, Identifier::fromString(vm, "data"_s), data);
+    batch->putDirect(vm, Identifier::fromString(vm, "offsets"_s), offsets);
+    batch->putDirect(vm, Identifier::fromString(vm, "addresses"_s), addresses);
+    batch->putDirect(vm, Identifier::fromString(vm, "ports"_s), ports);
+    return JSValue::encode(batch);
+}
@@ -0,0 +1,457 @@
+#include "root.h"
+#include "JSWorkerPool.h"
+
+#include "JSDOMExceptionHandling.h"
+#include "ScriptExecutionContext.h"
+#include "Worker.h"
+#include "ZigGlobalObject.h"
+#include <JavaScriptCore/JSCInlines.h>
+#include <JavaScriptCore/JSMap.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/Lookup.h>
+#include <wtf/NumberOfCores.h>
+
+namespace Bun {
+
+using namespace JSC;
+using namespace WebCore;
+
+using Task = WorkerPoolScheduler::Task;
+
+static void drainWorkerPool(Zig::GlobalObject*, RefPtr<WorkerPoolScheduler>, size_t workerIndex);
+
+// Worker side. Sends a task's outcome back to the pool's thread.
+static void settleWorkerPoolTask(Zig::GlobalObject* globalObject, WorkerPoolScheduler& scheduler, Strong<JSPromise>* promise, bool fulfilled, JSValue value)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+
+    auto result = SerializedScriptValue::create(*globalObject, value, SerializationForStorage::No, SerializationErrorMode::NonThrowing, SerializationContext::WorkerPostMessage);
+    scope.clearException();
+    if (!result) {
+        fulfilled = false;
+        result = SerializedScriptValue::create(*globalObject, createTypeError(globalObject, "WorkerPool task result could not be cloned"_s), SerializationForStorage::No, SerializationErrorMode::NonThrowing, SerializationContext::WorkerPostMessage);
+        scope.clearException();
+    }
+
+    ScriptExecutionContext::postTaskTo(scheduler.owner(), [scheduler = Ref { scheduler }, promise, fulfilled, result = WTFMove(result)](ScriptExecutionContext& context) mutable {
+        // terminate() has already rejected it.
+        if (!scheduler->willSettle(promise))
+            return;
+
+        context.unrefEventLoop();
+        std::unique_ptr<Strong<JSPromise>> protectedPromise(promise);
+        auto* globalObject = context.jsGlobalObject();
+        JSValue value = result ? result->deserialize(*globalObject, globalObject, SerializationErrorMode::NonThrowing) : jsUndefined();
+        if (fulfilled)
+            protectedPromise->get()->resolve(globalObject, value);
+        else
+            protectedPromise->get()->reject(globalObject, value);
+
+        if (scheduler->isOrphaned() && !scheduler->outstandingTaskCount())
+            scheduler->terminate();
+    });
+}
+
+// Worker side. A function's source is compiled the first time this worker
+// sees it and reused after that; a name is looked up on the global object.
+static JSValue workerPoolFunction(Zig::GlobalObject* globalObject, bool isName, JSValue nameOrSource)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* string = nameOrSource.toString(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (isName) {
+        auto identifier = string->toIdentifier(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        RELEASE_AND_RETURN(scope, globalObject->get(globalObject, identifier));
+    }
+
+    auto& cacheName = builtinNames(vm).workerPoolFunctionsPrivateName();
+    auto* cache = jsDynamicCast<JSMap*>(globalObject->getDirect(vm, cacheName));
+    if (!cache) {
+        cache = JSMap::create(vm, globalObject->mapStructure());
+        globalObject->putDirect(vm, cacheName, cache, PropertyAttribute::DontEnum | 0);
+    }
+
+    JSValue function = cache->get(globalObject, string);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (!function.isUndefined())
+        return function;
+
+    auto source = string->value(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    NakedPtr<Exception> exception;
+    function = JSC::evaluate(globalObject, makeSource(makeString("("_s, source, "\n)"_s), SourceOrigin(), SourceTaintedOrigin::Untainted, "[WorkerPool task]"_s), jsUndefined(), exception);
+    if (exception) {
+        throwException(globalObject, scope, exception.get());
+        return {};
+    }
+
+    cache->set(globalObject, string, function);
+    RETURN_IF_EXCEPTION(scope, {});
+    return function;
+}
+
+// Worker side. Returns false if the task returned a pending promise; its
+// reactions settle it and carry on draining.
+static bool runWorkerPoolTask(Zig::GlobalObject* globalObject, const RefPtr<WorkerPoolScheduler>& scheduler, size_t workerIndex, Task&& task)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    auto* promise = task.promise;
+
+    auto settleWithException = [&] {
+        JSValue error = scope.exception()->value();
+        scope.clearException();
+        settleWorkerPoolTask(globalObject, *scheduler, promise, false, error);
+        return true;
+    };
+
+    JSValue payload = task.payload->deserialize(*globalObject, globalObject, SerializationErrorMode::NonThrowing);
+    if (scope.exception())
+        return settleWithException();
+    auto* array = jsDynamicCast<JSArray*>(payload);
+    if (!array || array->length() != 3) {
+        settleWorkerPoolTask(globalObject, *scheduler, promise, false, createError(globalObject, "WorkerPool task could not be read"_s));
+        return true;
+    }
+
+    bool isName = array->getIndex(globalObject, 0).toBoolean(globalObject);
+    JSValue nameOrSource = array->getIndex(globalObject, 1);
+    JSValue argumentsValue = array->getIndex(globalObject, 2);
+    if (scope.exception())
+        return settleWithException();
+
+    JSValue function = workerPoolFunction(globalObject, isName, nameOrSource);
+    if (scope.exception())
+        return settleWithException();
+    if (!function.isCallable()) {
+        String name = isName ? nameOrSource.toWTFString(globalObject) : String("<source>"_s);
+        scope.clearException();
+        settleWorkerPoolTask(globalObject, *scheduler, promise, false, createTypeError(globalObject, makeString("WorkerPool task function "_s, name, " is not a function in the worker"_s)));
+        return true;
+    }
+
+    MarkedArgumentBuffer arguments;
+    if (auto* argumentsArray = jsDynamicCast<JSArray*>(argumentsValue)) {
+        for (unsigned i = 0; i < argumentsArray->length(); i++) {
+            arguments.append(argumentsArray->getIndex(globalObject, i));
+            if (scope.exception())
+                return settleWithException();
+        }
+    }
+
+    JSValue result = JSC::call(globalObject, function, arguments, "WorkerPool task is not a function"_s);
+    if (scope.exception())
+        return settleWithException();
+
+    auto* resultPromise = jsDynamicCast<JSPromise*>(result);
+    if (!resultPromise) {
+        settleWorkerPoolTask(globalObject, *scheduler, promise, true, result);
+        return true;
+    }
+
+    switch (resultPromise->status(vm)) {
+    case JSPromise::Status::Fulfilled:
+        settleWorkerPoolTask(globalObject, *scheduler, promise, true, resultPromise->result(vm));
+        return true;
+    case JSPromise::Status::Rejected:
+        resultPromise->markAsHandled(globalObject);
+        settleWorkerPoolTask(globalObject, *scheduler, promise, false, resultPromise->result(vm));
+        return true;
+    case JSPromise::Status::Pending:
+        break;
+    }
+
+    auto reaction = [&](bool fulfilled) {
+        return JSNativeStdFunction::create(vm, globalObject, 1, String(), [scheduler, workerIndex, promise, fulfilled](JSGlobalObject* lexicalGlobalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+            settleWorkerPoolTask(globalObject, *scheduler, promise, fulfilled, callFrame->argument(0));
+            drainWorkerPool(globalObject, scheduler, workerIndex);
+            return JSValue::encode(jsUndefined());
+        });
+    };
+
+    JSFunction* performPromiseThenFunction = globalObject->performPromiseThenFunction();
+    auto callData = JSC::getCallData(performPromiseThenFunction);
+    MarkedArgumentBuffer thenArguments;
+    thenArguments.append(resultPromise);
+    thenArguments.append(reaction(true));
+    thenArguments.append(reaction(false));
+    thenArguments.append(jsUndefined());
+    thenArguments.append(jsUndefined());
+    ASSERT(!thenArguments.hasOverflowed());
+    JSC::profiledCall(globalObject, ProfilingReason::Microtask, performPromiseThenFunction, callData, jsUndefined(), thenArguments);
+    if (scope.exception())
+        return settleWithException();
+    return false;
+}
+
+// Worker side. Runs tasks until there are none left anywhere in the pool.
+static void drainWorkerPool(Zig::GlobalObject* globalObject, RefPtr<WorkerPoolScheduler> scheduler, size_t workerIndex)
+{
+    while (true) {
+        auto task = scheduler->take(workerIndex);
+        if (!task) {
+            if (scheduler->becomeIdle(workerIndex))
+                continue;
+            return;
+        }
+        if (!runWorkerPoolTask(globalObject, scheduler, workerIndex, WTFMove(*task)))
+            return;
+    }
+}
+
+static void wakeWorker(WorkerPoolScheduler& scheduler, size_t workerIndex)
+{
+    scheduler.worker(workerIndex).postTaskToWorkerGlobalScope([scheduler = RefPtr { &scheduler }, workerIndex](ScriptExecutionContext& context) mutable {
+        drainWorkerPool(jsCast<Zig::GlobalObject*>(context.jsGlobalObject()), WTFMove(scheduler), workerIndex);
+    });
+}
+
+static void terminateWorkerPool(JSGlobalObject* globalObject, WorkerPoolScheduler& scheduler)
+{
+    auto* context = jsCast<Zig::GlobalObject*>(globalObject)->scriptExecutionContext();
+    for (auto* promise : scheduler.terminate()) {
+        std::unique_ptr<Strong<JSPromise>> protectedPromise(promise);
+        protectedPromise->get()->reject(globalObject, createError(globalObject, "WorkerPool was terminated"_s));
+        context->unrefEventLoop();
+    }
+}
+
+const ClassInfo JSWorkerPool::s_info = { "WorkerPool"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSWorkerPool) };
+
+void JSWorkerPool::destroy(JSCell* cell)
+{
+    auto* thisObject = static_cast<JSWorkerPool*>(cell);
+    // Let tasks already submitted finish; the workers stop after the last one.
+    thisObject->m_scheduler->orphan();
+    thisObject->~JSWorkerPool();
+}
+
+static JSWorkerPool* jsWorkerPoolCast(JSGlobalObject* globalObject, ThrowScope& scope, JSValue thisValue, ASCIILiteral methodName)
+{
+    if (auto* pool = jsDynamicCast<JSWorkerPool*>(thisValue))
+        return pool;
+    throwTypeError(globalObject, scope, makeString("WorkerPool.prototype."_s, methodName, " called on an object that is not a WorkerPool"_s));
+    return nullptr;
+}
+
+static JSC_DECLARE_HOST_FUNCTION(jsWorkerPoolPrototypeFunction_run);
+static JSC_DECLARE_HOST_FUNCTION(jsWorkerPoolPrototypeFunction_terminate);
+static JSC_DECLARE_CUSTOM_GETTER(jsWorkerPool_size);
+static JSC_DECLARE_CUSTOM_GETTER(jsWorkerPool_pending);
+static JSC_DECLARE_CUSTOM_GETTER(jsWorkerPool_queueDepths);
+
+JSC_DEFINE_HOST_FUNCTION(jsWorkerPoolPrototypeFunction_run, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    auto& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    auto* pool = jsWorkerPoolCast(globalObject, scope, callFrame->thisValue(), "run"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto& scheduler = pool->scheduler();
+    if (UNLIKELY(scheduler.isTerminated())) {
+        throwTypeError(globalObject, scope, "WorkerPool has been terminated"_s);
+        return {};
+    }
+
+    JSValue function = callFrame->argument(0);
+    bool isName = function.isString();
+    if (UNLIKELY(!isName && !function.isCallable())) {
+        throwTypeError(globalObject, scope, "WorkerPool.run expects a function or the name of a global function in the worker"_s);
+        return {};
+    }
+    JSString* nameOrSource = function.toString(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    JSValue arguments = callFrame->argument(1);
+    if (arguments.isUndefined()) {
+        arguments = constructEmptyArray(globalObject, nullptr);
+        RETURN_IF_EXCEPTION(scope, {});
+    } else if (UNLIKELY(!isArray(globalObject, arguments))) {
+        RETURN_IF_EXCEPTION(scope, {});
+        throwTypeError(globalObject, scope, "WorkerPool.run expects its arguments as an array"_s);
+        return {};
+    }
+
+    MarkedArgumentBuffer payloadValues;
+    payloadValues.append(jsBoolean(isName));
+    payloadValues.append(nameOrSource);
+    payloadValues.append(arguments);
+    auto* payloadArray = constructArray(globalObject, static_cast<ArrayAllocationProfile*>(nullptr), payloadValues);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto payload = SerializedScriptValue::create(*globalObject, payloadArray, SerializationForStorage::No, SerializationErrorMode::Throwing, SerializationContext::WorkerPostMessage);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(!payload)) {
+        throwTypeError(globalObject, scope, "WorkerPool.run arguments could not be cloned"_s);
+        return {};
+    }
+
+    auto* promise = JSPromise::create(vm, globalObject->promiseStructure());
+    auto* strongPromise = new Strong<JSPromise>(vm, promise);
+    scheduler.didSubmit(strongPromise);
+    globalObject->scriptExecutionContext()->refEventLoop();
+
+    if (auto workerIndex = scheduler.submit({ strongPromise, payload.releaseNonNull() }))
+        wakeWorker(scheduler, *workerIndex);
+
+    return JSValue::encode(promise);
+}
+
+// Rejects every task that has not settled and stops the workers.
+JSC_DEFINE_HOST_FUNCTION(jsWorkerPoolPrototypeFunction_terminate, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* pool = jsWorkerPoolCast(globalObject, scope, callFrame->thisValue(), "terminate"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    terminateWorkerPool(globalObject, pool->scheduler());
+    return JSValue::encode(jsUndefined());
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsWorkerPool_size, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* pool = jsWorkerPoolCast(globalObject, scope, JSValue::decode(thisValue), "size"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    return JSValue::encode(jsNumber(pool->scheduler().workerCount()));
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsWorkerPool_pending, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* pool = jsWorkerPoolCast(globalObject, scope, JSValue::decode(thisValue), "pending"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+    return JSValue::encode(jsNumber(pool->scheduler().outstandingTaskCount()));
+}
+
+// A snapshot of how many tasks wait in each worker's deque.
+JSC_DEFINE_CUSTOM_GETTER(jsWorkerPool_queueDepths, (JSGlobalObject * globalObject, EncodedJSValue thisValue, PropertyName))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* pool = jsWorkerPoolCast(globalObject, scope, JSValue::decode(thisValue), "queueDepths"_s);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto& scheduler = pool->scheduler();
+    auto* depths = constructEmptyArray(globalObject, nullptr, scheduler.workerCount());
+    RETURN_IF_EXCEPTION(scope, {});
+    for (size_t i = 0; i < scheduler.workerCount(); i++) {
+        depths->putDirectIndex(globalObject, i, jsNumber(scheduler.queueDepth(i)));
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+    return JSValue::encode(depths);
+}
+
+static const HashTableValue JSWorkerPoolPrototypeTableValues[] = {
+    { "pending"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWorkerPool_pending, 0 } },
+    { "queueDepths"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWorkerPool_queueDepths, 0 } },
+    { "size"_s, static_cast<unsigned>(PropertyAttribute::ReadOnly | PropertyAttribute::CustomAccessor | PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWorkerPool_size, 0 } },
+    { "run"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWorkerPoolPrototypeFunction_run, 2 } },
+    { "terminate"_s, static_cast<unsigned>(PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWorkerPoolPrototypeFunction_terminate, 0 } },
+};
+
+const ClassInfo JSWorkerPoolPrototype::s_info = { "WorkerPool"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSWorkerPoolPrototype) };
+
+void JSWorkerPoolPrototype::finishCreation(VM& vm, JSGlobalObject*)
+{
+    Base::finishCreation(vm);
+    reifyStaticProperties(vm, JSWorkerPool::info(), JSWorkerPoolPrototypeTableValues, *this);
+    JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
+}
+
+const ClassInfo JSWorkerPoolConstructor::s_info = { "WorkerPool"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSWorkerPoolConstructor) };
+
+JSWorkerPoolConstructor* JSWorkerPoolConstructor::create(VM& vm, Structure* structure, JSWorkerPoolPrototype* prototype)
+{
+    JSWorkerPoolConstructor* constructor = new (NotNull, allocateCell<JSWorkerPoolConstructor>(vm)) JSWorkerPoolConstructor(vm, structure);
+    constructor->finishCreation(vm, prototype);
+    return constructor;
+}
+
+void JSWorkerPoolConstructor::finishCreation(VM& vm, JSWorkerPoolPrototype* prototype)
+{
+    Base::finishCreation(vm, 1, "WorkerPool"_s, PropertyAdditionMode::WithoutStructureTransition);
+    putDirectWithoutTransition(vm, vm.propertyNames->prototype, prototype, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+    prototype->putDirectWithoutTransition(vm, vm.propertyNames->constructor, this, static_cast<unsigned>(PropertyAttribute::DontEnum));
+}
+
+EncodedJSValue JSWorkerPoolConstructor::call(JSGlobalObject* globalObject, CallFrame*)
+{
+    auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+    throwTypeError(globalObject, scope, "Class constructor WorkerPool cannot be invoked without 'new'"_s);
+    return {};
+}
+
+// new WorkerPool({ module, size = number of cores }) starts the workers
+// right away. They do not keep the process alive by themselves; each task
+// does until it settles.
+EncodedJSValue JSWorkerPoolConstructor::construct(JSGlobalObject* lexicalGlobalObject, CallFrame* callFrame)
+{
+    auto& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+
+    auto* options = jsDynamicCast<JSObject*>(callFrame->argument(0));
+    if (UNLIKELY(!options)) {
+        throwTypeError(globalObject, scope, "WorkerPool expects an options object with a module"_s);
+        return {};
+    }
+
+    JSValue moduleValue = options->get(globalObject, Identifier::fromString(vm, "module"_s));
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(moduleValue.isUndefinedOrNull())) {
+        throwTypeError(globalObject, scope, "WorkerPool options.module must be a path or URL"_s);
+        return {};
+    }
+    String module = moduleValue.toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    size_t size = WTF::numberOfProcessorCores();
+    JSValue sizeValue = options->get(globalObject, Identifier::fromString(vm, "size"_s));
+    RETURN_IF_EXCEPTION(scope, {});
+    if (!sizeValue.isUndefined()) {
+        double requested = sizeValue.isNumber() ? sizeValue.asNumber() : 0;
+        if (!sizeValue.isNumber() || requested != std::trunc(requested) || requested < 1 || requested > JSWorkerPool::maximumSize) {
+            throwRangeError(globalObject, scope, makeString("WorkerPool options.size must be an integer from 1 to "_s, JSWorkerPool::maximumSize));
+            return {};
+        }
+        size = static_cast<size_t>(requested);
+    }
+    size = std::clamp<size_t>(size, 1, JSWorkerPool::maximumSize);
+
+    Structure* structure = globalObject->JSWorkerPoolStructure();
+    JSValue newTarget = callFrame->newTarget();
+    if (UNLIKELY(globalObject->JSWorkerPool() != newTarget)) {
+        auto* functionGlobalObject = jsCast<Zig::GlobalObject*>(getFunctionRealm(globalObject, newTarget.getObject()));
+        RETURN_IF_EXCEPTION(scope, {});
+        structure = InternalFunction::createSubclassStructure(globalObject, newTarget.getObject(), functionGlobalObject->JSWorkerPoolStructure());
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    auto* context = globalObject->scriptExecutionContext();
+    auto scheduler = WorkerPoolScheduler::create(context->identifier(), size);
+    for (size_t i = 0; i < size; i++) {
+        WorkerOptions workerOptions;
+        workerOptions.name = makeString("WorkerPool "_s, i);
+        workerOptions.bun.unref = true;
+        auto worker = Worker::create(*context, module, WTFMove(workerOptions));
+        if (UNLIKELY(worker.hasException())) {
+            scheduler->terminate();
+            propagateException(*globalObject, scope, worker.releaseException());
+            return {};
+        }
+        scheduler->addWorker(worker.releaseReturnValue());
+    }
+
+    return JSValue::encode(JSWorkerPool::create(vm, structure, WTFMove(scheduler)));
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "root.h"
+#include "BunClientData.h"
+#include "WorkerPoolScheduler.h"
+#include <JavaScriptCore/InternalFunction.h>
+
+namespace Bun {
+
+// Bun.WorkerPool({ size, module }): `size` Workers running `module`, fed
+// from per-worker deques with work stealing (see WorkerPoolScheduler).
+//
+// pool.run(fn, args) runs fn(...args) on whichever worker gets to it and
+// returns a promise for its (structured-cloned) result. `fn` is either a
+// function, whose source is compiled once per worker and so must not close
+// over anything, or the name of a global function `module` defined.
+class JSWorkerPool final : public JSC::JSDestructibleObject {
+public:
+    using Base = JSC::JSDestructibleObject;
+
+    static constexpr size_t maximumSize = 256;
+
+    static JSWorkerPool* create(JSC::VM& vm, JSC::Structure* structure, Ref<WebCore::WorkerPoolScheduler>&& scheduler)
+    {
+        JSWorkerPool* pool = new (NotNull, JSC::allocateCell<JSWorkerPool>(vm)) JSWorkerPool(vm, structure, WTFMove(scheduler));
+        pool->finishCreation(vm);
+        return pool;
+    }
+
+    static void destroy(JSC::JSCell*);
+
+    DECLARE_INFO;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+    template<typename, JSC::SubspaceAccess mode> static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        if constexpr (mode == JSC::SubspaceAccess::Concurrently)
+            return nullptr;
+
+        return WebCore::subspaceForImpl<JSWorkerPool, WebCore::UseCustomHeapCellType::No>(
+            vm,
+            [](auto& spaces) { return spaces.m_clientSubspaceForWorkerPool.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_clientSubspaceForWorkerPool = std::forward<decltype(space)>(space); },
+            [](auto& spaces) { return spaces.m_subspaceForWorkerPool.get(); },
+            [](auto& spaces, auto&& space) { spaces.m_subspaceForWorkerPool = std::forward<decltype(space)>(space); });
+    }
+
+    WebCore::WorkerPoolScheduler& scheduler() { return m_scheduler.get(); }
+
+private:
+    JSWorkerPool(JSC::VM& vm, JSC::Structure* structure, Ref<WebCore::WorkerPoolScheduler>&& scheduler)
+        : Base(vm, structure)
+        , m_scheduler(WTFMove(scheduler))
+    {
+    }
+
+    Ref<WebCore::WorkerPoolScheduler> m_scheduler;
+};
+
+class JSWorkerPoolPrototype final : public JSC::JSNonFinalObject {
+public:
+    using Base = JSC::JSNonFinalObject;
+
+    static JSWorkerPoolPrototype* create(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::Structure* structure)
+    {
+        JSWorkerPoolPrototype* prototype = new (NotNull, JSC::allocateCell<JSWorkerPoolPrototype>(vm)) JSWorkerPoolPrototype(vm, structure);
+        prototype->finishCreation(vm, globalObject);
+        return prototype;
+    }
+
+    DECLARE_INFO;
+    template<typename CellType, JSC::SubspaceAccess>
+    static JSC::GCClient::IsoSubspace* subspaceFor(JSC::VM& vm)
+    {
+        STATIC_ASSERT_ISO_SUBSPACE_SHARABLE(JSWorkerPoolPrototype, Base);
+        return &vm.plainObjectSpace();
+    }
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::ObjectType, StructureFlags), info());
+    }
+
+private:
+    JSWorkerPoolPrototype(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSC::JSGlobalObject*);
+};
+
+class JSWorkerPoolConstructor final : public JSC::InternalFunction {
+public:
+    using Base = JSC::InternalFunction;
+    static JSWorkerPoolConstructor* create(JSC::VM&, JSC::Structure*, JSWorkerPoolPrototype*);
+
+    static constexpr unsigned StructureFlags = Base::StructureFlags;
+    static constexpr bool needsDestruction = false;
+
+    static JSC::Structure* createStructure(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSValue prototype)
+    {
+        return JSC::Structure::create(vm, globalObject, prototype, JSC::TypeInfo(JSC::InternalFunctionType, StructureFlags), info());
+    }
+
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES construct(JSC::JSGlobalObject*, JSC::CallFrame*);
+    static JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES call(JSC::JSGlobalObject*, JSC::CallFrame*);
+    DECLARE_EXPORT_INFO;
+
+private:
+    JSWorkerPoolConstructor(JSC::VM& vm, JSC::Structure* structure)
+        : Base(vm, structure, call, construct)
+    {
+    }
+
+    void finishCreation(JSC::VM&, JSWorkerPoolPrototype*);
+};
+
+}
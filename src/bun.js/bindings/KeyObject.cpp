@@ -22,6 +22,7 @@
 // IN THE SOFTWARE.
 
 #include "KeyObject.h"
+#include "CipherStreams.h"
 #include "JavaScriptCore/JSArrayBufferView.h"
 #include "JavaScriptCore/JSCJSValue.h"
 #include "JavaScriptCore/JSCast.h"
@@ -53,8 +54,12 @@
 #include "CryptoAlgorithmEcdsaParams.h"
 #include "CryptoAlgorithmRsaPssParams.h"
 #include "CryptoAlgorithmRegistry.h"
+#include "PBKDF2Batch.h"
+#include "ParsedKeyCache.h"
 #include "wtf/ForbidHeapAllocation.h"
 #include "wtf/Noncopyable.h"
+#include <wtf/NumberOfCores.h>
+#include <wtf/WorkQueue.h>
 using namespace JSC;
 using namespace Bun;
 using JSGlobalObject
@@ -304,6 +309,29 @@ AsymmetricKeyValueWithDER KeyObject__ParsePublicKeyPEM(const char* key_pem,
     return result;
 }
 
+// Parses with `parse` unless the same bytes were imported recently. Only
+// keys the caller goes on to use as is are kept: RSA keys, and EC keys read
+// as private keys (the public EC paths re-import from the DER).
+template<typename Parse>
+static EvpPKeyPtr KeyObject__ParseCached(ParsedKeyCache::Source source, const void* data, size_t byteLength, const Parse& parse)
+{
+    auto& cache = ParsedKeyCache::singleton();
+    auto digest = ParsedKeyCache::digest(source, std::span { static_cast<const uint8_t*>(data), byteLength });
+    if (digest) {
+        if (auto key = cache.find(*digest))
+            return key;
+    }
+
+    EvpPKeyPtr key = parse();
+    if (!digest || !key)
+        return key;
+    auto id = EVP_PKEY_id(key.get());
+    bool isPrivateSource = source < ParsedKeyCache::Source::PublicPEM;
+    if (id == EVP_PKEY_RSA || id == EVP_PKEY_RSA_PSS || (id == EVP_PKEY_EC && isPrivateSource))
+        cache.add(*digest, key.get());
+    return key;
+}
+
 JSC::EncodedJSValue KeyObject__createPrivateKey(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
 {
 
@@ -473,7 +501,12 @@ JSC::EncodedJSValue KeyObject__createPrivateKey(JSC::JSGlobalObject* globalObjec
     if (format == "pem"_s) {
         ASSERT(data);
         auto bio = BIOPtr(BIO_new_mem_buf(const_cast<char*>((char*)data), byteLength));
-        auto pkey = EvpPKeyPtr(PEM_read_bio_PrivateKey(bio.get(), nullptr, PasswordCallback, &passphrase));
+        auto parse = [&] {
+            return EvpPKeyPtr(PEM_read_bio_PrivateKey(bio.get(), nullptr, PasswordCallback, &passphrase));
+        };
+        // An encrypted key must be decrypted every time, or a wrong
+        // passphrase would be let through.
+        auto pkey = passphrase.hasPassphrase() ? parse() : KeyObject__ParseCached(ParsedKeyCache::Source::PrivatePEM, data, byteLength, parse);
 
         if (!pkey) {
             throwException(globalObject, scope, createTypeError(globalObject, "Invalid private key pem file"_s));
@@ -550,8 +583,10 @@ JSC::EncodedJSValue KeyObject__createPrivateKey(JSC::JSGlobalObject* globalObjec
 
         if (type == "pkcs1"_s) {
             // must be RSA
-            const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
-            auto pkey = EvpPKeyPtr(d2i_PrivateKey(EVP_PKEY_RSA, nullptr, &p, byteLength));
+            auto pkey = KeyObject__ParseCached(ParsedKeyCache::Source::PrivatePKCS1, data, byteLength, [&] {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+                return EvpPKeyPtr(d2i_PrivateKey(EVP_PKEY_RSA, nullptr, &p, byteLength));
+            });
             if (!pkey) {
                 throwException(globalObject, scope, createTypeError(globalObject, "Invalid use of PKCS#1 as private key"_s));
                 return JSValue::encode(JSC::jsUndefined());
@@ -569,12 +604,21 @@ JSC::EncodedJSValue KeyObject__createPrivateKey(JSC::JSGlobalObject* globalObjec
                     PasswordCallback,
                     &passphrase));
             } else {
-                auto* p8inf = d2i_PKCS8_PRIV_KEY_INFO_bio(bio.get(), nullptr);
-                if (!p8inf) {
+                bool isValidPKCS8 = true;
+                pkey = KeyObject__ParseCached(ParsedKeyCache::Source::PrivatePKCS8, data, byteLength, [&] {
+                    auto* p8inf = d2i_PKCS8_PRIV_KEY_INFO_bio(bio.get(), nullptr);
+                    if (!p8inf) {
+                        isValidPKCS8 = false;
+                        return EvpPKeyPtr();
+                    }
+                    auto key = EvpPKeyPtr(EVP_PKCS82PKEY(p8inf));
+                    PKCS8_PRIV_KEY_INFO_free(p8inf);
+                    return key;
+                });
+                if (!isValidPKCS8) {
                     throwException(globalObject, scope, createTypeError(globalObject, "Invalid PKCS8 data"_s));
                     return JSValue::encode(JSC::jsUndefined());
                 }
-                pkey = EvpPKeyPtr(EVP_PKCS82PKEY(p8inf));
             }
             if (!pkey) {
                 throwException(globalObject, scope, createTypeError(globalObject, "Invalid private key"_s));
@@ -643,8 +687,10 @@ JSC::EncodedJSValue KeyObject__createPrivateKey(JSC::JSGlobalObject* globalObjec
                 return JSValue::encode(JSC::jsUndefined());
             }
         } else if (type == "sec1"_s) {
-            const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
-            auto pkey = EvpPKeyPtr(d2i_PrivateKey(EVP_PKEY_EC, nullptr, &p, byteLength));
+            auto pkey = KeyObject__ParseCached(ParsedKeyCache::Source::PrivateSEC1, data, byteLength, [&] {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+                return EvpPKeyPtr(d2i_PrivateKey(EVP_PKEY_EC, nullptr, &p, byteLength));
+            });
             auto pKeyID = EVP_PKEY_id(pkey.get());
 
             if (pKeyID == EVP_PKEY_EC) {
@@ -1024,7 +1070,16 @@ JSC::EncodedJSValue KeyObject__createPublicKey(JSC::JSGlobalObject* globalObject
     }
 
     if (format == "pem"_s) {
-        auto pem = KeyObject__ParsePublicKeyPEM((const char*)data, byteLength);
+        // `cachedKey` owns the key and pem.key only points at it. Only RSA
+        // keys are cached here, and their branch has no use for the DER, so
+        // a hit can leave it out.
+        AsymmetricKeyValueWithDER pem { .key = nullptr, .der_data = nullptr, .der_len = 0 };
+        auto cachedKey = KeyObject__ParseCached(ParsedKeyCache::Source::PublicPEM, data, byteLength, [&] {
+            pem = KeyObject__ParsePublicKeyPEM((const char*)data, byteLength);
+            return EvpPKeyPtr(pem.key);
+        });
+        if (cachedKey && !pem.key)
+            pem.key = cachedKey.get();
         if (!pem.key) {
             // maybe is a private pem
             auto bio = BIOPtr(BIO_new_mem_buf(const_cast<char*>((char*)data), byteLength));
@@ -1038,7 +1093,7 @@ JSC::EncodedJSValue KeyObject__createPublicKey(JSC::JSGlobalObject* globalObject
             }
             return KeyObject__createPublicFromPrivate(globalObject, pkey.get());
         }
-        auto pkey = EvpPKeyPtr(pem.key);
+        auto pkey = WTFMove(cachedKey);
         auto pKeyID = EVP_PKEY_id(pem.key);
         if (pKeyID == EVP_PKEY_RSA || pKeyID == EVP_PKEY_RSA_PSS) {
             if (pem.der_data) {
@@ -1138,8 +1193,10 @@ JSC::EncodedJSValue KeyObject__createPublicKey(JSC::JSGlobalObject* globalObject
 
         if (type == "pkcs1"_s) {
             // must be RSA
-            const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
-            auto pkey = EvpPKeyPtr(d2i_PublicKey(EVP_PKEY_RSA, nullptr, &p, byteLength));
+            auto pkey = KeyObject__ParseCached(ParsedKeyCache::Source::PublicPKCS1, data, byteLength, [&] {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+                return EvpPKeyPtr(d2i_PublicKey(EVP_PKEY_RSA, nullptr, &p, byteLength));
+            });
             if (!pkey) {
                 // maybe is a private RSA key
                 const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
@@ -1158,8 +1215,10 @@ JSC::EncodedJSValue KeyObject__createPublicKey(JSC::JSGlobalObject* globalObject
             return JSC::JSValue::encode(JSCryptoKey::create(structure, zigGlobalObject, WTFMove(impl)));
         } else if (type == "spki"_s) {
             // We use d2i_PUBKEY() to import a public key.
-            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
-            auto pkey = EvpPKeyPtr(d2i_PUBKEY(nullptr, &ptr, byteLength));
+            auto pkey = KeyObject__ParseCached(ParsedKeyCache::Source::PublicSPKI, data, byteLength, [&] {
+                const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+                return EvpPKeyPtr(d2i_PUBKEY(nullptr, &ptr, byteLength));
+            });
             if (!pkey) {
                 throwException(globalObject, scope, createTypeError(globalObject, "Invalid public key"_s));
                 return JSValue::encode(JSC::jsUndefined());
@@ -1556,6 +1615,61 @@ JSC::EncodedJSValue KeyObject__Sign(JSC::JSGlobalObject* globalObject, JSC::Call
     }
 }
 
+// The digest verify() hashes with: SHA-256 unless `algorithm` names
+// another SHA. Throws and returns nullopt for anything else.
+static std::optional<CryptoAlgorithmIdentifier> KeyObject__VerifyDigest(JSC::JSGlobalObject* globalObject, JSC::ThrowScope& scope, JSValue algorithm)
+{
+    if (algorithm.isUndefinedOrNull() || algorithm.isEmpty())
+        return WebCore::CryptoAlgorithmIdentifier::SHA_256;
+
+    if (!algorithm.isString()) {
+        JSC::throwTypeError(globalObject, scope, "algorithm is expected to be a string"_s);
+        return std::nullopt;
+    }
+    auto algorithm_str = algorithm.toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, std::nullopt);
+
+    auto identifier = CryptoAlgorithmRegistry::singleton().identifier(algorithm_str);
+    if (UNLIKELY(!identifier)) {
+        JSC::throwTypeError(globalObject, scope, "digest not allowed"_s);
+        return std::nullopt;
+    }
+
+    switch (*identifier) {
+    case WebCore::CryptoAlgorithmIdentifier::SHA_1:
+    case WebCore::CryptoAlgorithmIdentifier::SHA_224:
+    case WebCore::CryptoAlgorithmIdentifier::SHA_256:
+    case WebCore::CryptoAlgorithmIdentifier::SHA_384:
+    case WebCore::CryptoAlgorithmIdentifier::SHA_512:
+        return *identifier;
+    default:
+        JSC::throwTypeError(globalObject, scope, "digest not allowed"_s);
+        return std::nullopt;
+    }
+}
+
+// The dsaEncoding option, DER by default. Throws and returns nullopt if it
+// is not one of the two.
+static std::optional<CryptoAlgorithmECDSAEncoding> KeyObject__DSAEncoding(JSC::JSGlobalObject* globalObject, JSC::ThrowScope& scope, JSValue encoding)
+{
+    if (encoding.isUndefinedOrNull() || encoding.isEmpty())
+        return CryptoAlgorithmECDSAEncoding::DER;
+
+    if (!encoding.isString()) {
+        JSC::throwTypeError(globalObject, scope, "dsaEncoding is expected to be a string"_s);
+        return std::nullopt;
+    }
+    auto encoding_str = encoding.toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, std::nullopt);
+
+    if (encoding_str == "ieee-p1363"_s)
+        return CryptoAlgorithmECDSAEncoding::IeeeP1363;
+    if (encoding_str == "der"_s)
+        return CryptoAlgorithmECDSAEncoding::DER;
+    JSC::throwTypeError(globalObject, scope, "invalid dsaEncoding"_s);
+    return std::nullopt;
+}
+
 JSC::EncodedJSValue KeyObject__Verify(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
 {
     auto count = callFrame->argumentCount();
@@ -1592,41 +1706,12 @@ JSC::EncodedJSValue KeyObject__Verify(JSC::JSGlobalObject* globalObject, JSC::Ca
     auto& wrapped = key->wrapped();
     auto id = wrapped.keyClass();
 
-    auto hash = WebCore::CryptoAlgorithmIdentifier::SHA_256;
-    auto customHash = false;
-
     auto algorithm = callFrame->argument(3);
-    if (!algorithm.isUndefinedOrNull() && !algorithm.isEmpty()) {
-        customHash = true;
-        if (!algorithm.isString()) {
-            JSC::throwTypeError(globalObject, scope, "algorithm is expected to be a string"_s);
-            return JSC::JSValue::encode(JSC::JSValue {});
-        }
-        auto algorithm_str = algorithm.toWTFString(globalObject);
-        RETURN_IF_EXCEPTION(scope, encodedJSValue());
-
-        auto identifier = CryptoAlgorithmRegistry::singleton().identifier(algorithm_str);
-        if (UNLIKELY(!identifier)) {
-            JSC::throwTypeError(globalObject, scope, "digest not allowed"_s);
-            return JSC::JSValue::encode(JSC::JSValue {});
-        }
-
-        switch (*identifier) {
-        case WebCore::CryptoAlgorithmIdentifier::SHA_1:
-        case WebCore::CryptoAlgorithmIdentifier::SHA_224:
-        case WebCore::CryptoAlgorithmIdentifier::SHA_256:
-        case WebCore::CryptoAlgorithmIdentifier::SHA_384:
-        case WebCore::CryptoAlgorithmIdentifier::SHA_512: {
-
-            hash = *identifier;
-            break;
-        }
-        default: {
-            JSC::throwTypeError(globalObject, scope, "digest not allowed"_s);
-            return JSC::JSValue::encode(JSC::JSValue {});
-        }
-        }
-    }
+    auto customHash = !algorithm.isUndefinedOrNull() && !algorithm.isEmpty();
+    auto verifyDigest = KeyObject__VerifyDigest(globalObject, scope, algorithm);
+    if (!verifyDigest)
+        return JSC::JSValue::encode(JSC::JSValue {});
+    auto hash = *verifyDigest;
 
     switch (id) {
     case CryptoKeyClass::HMAC: {
@@ -1652,28 +1737,11 @@ JSC::EncodedJSValue KeyObject__Verify(JSC::JSGlobalObject* globalObject, JSC::Ca
         CryptoAlgorithmEcdsaParams params;
         params.identifier = CryptoAlgorithmIdentifier::ECDSA;
         params.hashIdentifier = hash;
-        params.encoding = CryptoAlgorithmECDSAEncoding::DER;
-
-        if (count > 4) {
-            auto encoding = callFrame->argument(4);
-            if (!encoding.isUndefinedOrNull() && !encoding.isEmpty()) {
-                if (!encoding.isString()) {
-                    JSC::throwTypeError(globalObject, scope, "dsaEncoding is expected to be a string"_s);
-                    return JSC::JSValue::encode(JSC::JSValue {});
-                }
-                auto encoding_str = encoding.toWTFString(globalObject);
-                RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        auto encoding = KeyObject__DSAEncoding(globalObject, scope, callFrame->argument(4));
+        if (!encoding)
+            return JSC::JSValue::encode(JSC::JSValue {});
+        params.encoding = *encoding;
 
-                if (encoding_str == "ieee-p1363"_s) {
-                    params.encoding = CryptoAlgorithmECDSAEncoding::IeeeP1363;
-                } else if (encoding_str == "der"_s) {
-                    params.encoding = CryptoAlgorithmECDSAEncoding::DER;
-                } else {
-                    JSC::throwTypeError(globalObject, scope, "invalid dsaEncoding"_s);
-                    return JSC::JSValue::encode(JSC::JSValue {});
-                }
-            }
-        }
         auto result = WebCore::CryptoAlgorithmECDSA::platformVerify(params, ec, signatureData, vectorData);
         if (result.hasException()) {
             WebCore::propagateException(*globalObject, scope, result.releaseException());
@@ -1763,6 +1831,249 @@ JSC::EncodedJSValue KeyObject__Verify(JSC::JSGlobalObject* globalObject, JSC::Ca
     }
 }
 
+// verifyBatch(key, [[data, signature], ...], algorithm, dsaEncoding): verify()
+// for many signatures under one EC or Ed25519 key, returning an array of
+// booleans. The checks run in parallel across the cores, which is where a
+// token or webhook checker spends its time.
+JSC::EncodedJSValue KeyObject__VerifyBatch(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (callFrame->argumentCount() < 2) {
+        JSC::throwTypeError(globalObject, scope, "verifyBatch requires 2 arguments"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    auto* key = jsDynamicCast<JSCryptoKey*>(callFrame->argument(0));
+    if (!key) {
+        JSC::throwTypeError(globalObject, scope, "expected CryptoKey as first argument"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    auto* entries = jsDynamicCast<JSC::JSArray*>(callFrame->argument(1));
+    if (!entries) {
+        JSC::throwTypeError(globalObject, scope, "expected an array of [data, signature] pairs as second argument"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    auto& wrapped = key->wrapped();
+    auto id = wrapped.keyClass();
+    if (id != CryptoKeyClass::EC && id != CryptoKeyClass::OKP) {
+        JSC::throwTypeError(globalObject, scope, "ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE: verifyBatch only supports EC and Ed25519 keys"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    CryptoAlgorithmEcdsaParams params;
+    if (id == CryptoKeyClass::EC) {
+        auto hash = KeyObject__VerifyDigest(globalObject, scope, callFrame->argument(2));
+        if (!hash)
+            return JSC::JSValue::encode(JSC::JSValue {});
+        auto encoding = KeyObject__DSAEncoding(globalObject, scope, callFrame->argument(3));
+        if (!encoding)
+            return JSC::JSValue::encode(JSC::JSValue {});
+        params.identifier = CryptoAlgorithmIdentifier::ECDSA;
+        params.hashIdentifier = *hash;
+        params.encoding = *encoding;
+    }
+
+    // Copied out up front: nothing below may touch the heap off this thread.
+    unsigned length = entries->length();
+    Vector<std::pair<Vector<uint8_t>, Vector<uint8_t>>> pairs;
+    pairs.reserveInitialCapacity(length);
+    for (unsigned i = 0; i < length; i++) {
+        auto* entry = jsDynamicCast<JSC::JSArray*>(entries->getIndex(globalObject, i));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        if (!entry || entry->length() != 2) {
+            JSC::throwTypeError(globalObject, scope, "each entry must be a [data, signature] pair"_s);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        auto data = KeyObject__GetBuffer(entry->getIndex(globalObject, 0));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        auto signature = KeyObject__GetBuffer(entry->getIndex(globalObject, 1));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        if (data.hasException() || signature.hasException()) {
+            JSC::throwTypeError(globalObject, scope, "expected data and signature to be Buffer or array-like objects"_s);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        pairs.append({ data.releaseReturnValue(), signature.releaseReturnValue() });
+    }
+
+    Vector<ExceptionOr<bool>> results;
+    results.reserveInitialCapacity(length);
+    for (unsigned i = 0; i < length; i++)
+        results.append(false);
+
+    auto verify = [&](size_t i) {
+        auto& [data, signature] = pairs[i];
+        if (id == CryptoKeyClass::EC)
+            results[i] = WebCore::CryptoAlgorithmECDSA::platformVerify(params, downcast<WebCore::CryptoKeyEC>(wrapped), signature, data);
+        else
+            results[i] = WebCore::CryptoAlgorithmEd25519::platformVerify(downcast<WebCore::CryptoKeyOKP>(wrapped), signature, data);
+    };
+    // A handful of signatures verify faster than the threads can be woken.
+    static constexpr unsigned minimumParallelBatch = 8;
+    if (length < minimumParallelBatch) {
+        for (unsigned i = 0; i < length; i++)
+            verify(i);
+    } else {
+        size_t sliceCount = std::min<size_t>(length, WTF::numberOfProcessorCores());
+        WorkQueue::concurrentApply(sliceCount, [&](size_t slice) {
+            for (size_t i = slice * length / sliceCount; i < (slice + 1) * length / sliceCount; i++)
+                verify(i);
+        });
+    }
+
+    auto* array = JSC::constructEmptyArray(globalObject, nullptr, length);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    for (unsigned i = 0; i < length; i++) {
+        if (results[i].hasException()) {
+            WebCore::propagateException(*globalObject, scope, results[i].releaseException());
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        array->putDirectIndex(globalObject, i, jsBoolean(results[i].returnValue()));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+    return JSC::JSValue::encode(array);
+}
+
+namespace {
+
+// Shared by the slices of one pbkdf2Batch(), which each derive their own range.
+class PBKDF2BatchOperation : public ThreadSafeRefCounted<PBKDF2BatchOperation> {
+public:
+    PBKDF2BatchOperation(const EVP_MD* digest, uint32_t iterations, size_t keyLength, Vector<Vector<uint8_t>>&& passwords, Vector<Vector<uint8_t>>&& salts)
+        : batch(digest, iterations, keyLength, WTFMove(passwords), WTFMove(salts))
+    {
+    }
+
+    WebCore::PBKDF2Batch batch;
+};
+
+}
+
+// pbkdf2Batch(passwords, salt or salts, iterations, keylen, digest): pbkdf2()
+// for many passwords at once, resolving to an array of Buffers. Groups of
+// passwords go to the crypto work queues, and within a group SHA-256 is
+// derived several passwords to a core; see PBKDF2Batch.
+JSC::EncodedJSValue KeyObject__Pbkdf2Batch(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (callFrame->argumentCount() < 5) {
+        JSC::throwTypeError(globalObject, scope, "pbkdf2Batch requires 5 arguments"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    auto* passwordArray = jsDynamicCast<JSC::JSArray*>(callFrame->argument(0));
+    if (!passwordArray) {
+        JSC::throwTypeError(globalObject, scope, "expected an array of passwords as first argument"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    unsigned length = passwordArray->length();
+
+    auto iterationsValue = callFrame->argument(2);
+    auto keyLengthValue = callFrame->argument(3);
+    if (!iterationsValue.isNumber() || !keyLengthValue.isNumber()) {
+        JSC::throwTypeError(globalObject, scope, "iterations and keylen are expected to be numbers"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    double iterations = iterationsValue.asNumber();
+    double keyLength = keyLengthValue.asNumber();
+    if (iterations < 1 || iterations > std::numeric_limits<uint32_t>::max() || iterations != std::trunc(iterations)) {
+        JSC::throwRangeError(globalObject, scope, "iterations must be a positive 32-bit integer"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+    if (keyLength < 0 || keyLength > std::numeric_limits<int32_t>::max() || keyLength != std::trunc(keyLength)) {
+        JSC::throwRangeError(globalObject, scope, "keylen must be a non-negative 32-bit integer"_s);
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    auto digestName = callFrame->argument(4).toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    auto* digest = EVP_get_digestbyname(digestName.utf8().data());
+    if (!digest) {
+        JSC::throwTypeError(globalObject, scope, makeString("Invalid digest: "_s, digestName));
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    // Copied out up front: nothing below may touch the heap off this thread.
+    Vector<Vector<uint8_t>> passwords;
+    passwords.reserveInitialCapacity(length);
+    for (unsigned i = 0; i < length; i++) {
+        auto password = KeyObject__GetBuffer(passwordArray->getIndex(globalObject, i));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        if (password.hasException()) {
+            JSC::throwTypeError(globalObject, scope, "expected passwords to be Buffer or array-like objects"_s);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        passwords.append(password.releaseReturnValue());
+    }
+
+    Vector<Vector<uint8_t>> salts;
+    if (auto* saltArray = jsDynamicCast<JSC::JSArray*>(callFrame->argument(1))) {
+        if (saltArray->length() != length) {
+            JSC::throwRangeError(globalObject, scope, "expected one salt for every password"_s);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        salts.reserveInitialCapacity(length);
+        for (unsigned i = 0; i < length; i++) {
+            auto salt = KeyObject__GetBuffer(saltArray->getIndex(globalObject, i));
+            RETURN_IF_EXCEPTION(scope, encodedJSValue());
+            if (salt.hasException()) {
+                JSC::throwTypeError(globalObject, scope, "expected salts to be Buffer or array-like objects"_s);
+                return JSC::JSValue::encode(JSC::JSValue {});
+            }
+            salts.append(salt.releaseReturnValue());
+        }
+    } else {
+        auto salt = KeyObject__GetBuffer(callFrame->argument(1));
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        if (salt.hasException()) {
+            JSC::throwTypeError(globalObject, scope, "expected salt to be a Buffer, an array-like object or an array of them"_s);
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+        salts.append(salt.releaseReturnValue());
+    }
+
+    auto operation = adoptRef(*new PBKDF2BatchOperation(digest, static_cast<uint32_t>(iterations), static_cast<size_t>(keyLength), WTFMove(passwords), WTFMove(salts)));
+    auto* promise = JSC::JSPromise::create(vm, globalObject->promiseStructure());
+    JSC::Strong<JSC::JSPromise> strongPromise(vm, promise);
+
+    size_t grain = operation->batch.grain();
+    size_t groups = (length + grain - 1) / grain;
+    auto* context = reinterpret_cast<Zig::GlobalObject*>(globalObject)->scriptExecutionContext();
+    WebCore::CryptoAlgorithm::dispatchBatchOperation(
+        *context, groups,
+        [operation = operation.copyRef(), strongPromise](Vector<bool>&&) mutable {
+            auto* globalObject = strongPromise.get()->globalObject();
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_CATCH_SCOPE(vm);
+            auto keys = operation->batch.takeResults();
+            auto* array = JSC::constructEmptyArray(globalObject, nullptr, keys.size());
+            for (size_t i = 0; array && !scope.exception() && i < keys.size(); i++)
+                array->putDirectIndex(globalObject, i, WebCore::createBuffer(globalObject, keys[i]));
+            if (auto* exception = scope.exception()) {
+                scope.clearException();
+                strongPromise.get()->reject(globalObject, exception->value());
+                return;
+            }
+            strongPromise.get()->resolve(globalObject, array);
+        },
+        [strongPromise](ExceptionCode code) mutable {
+            auto* globalObject = strongPromise.get()->globalObject();
+            strongPromise.get()->reject(globalObject, WebCore::createDOMException(globalObject, code));
+        },
+        [operation = operation.copyRef(), grain, length](size_t group) -> ExceptionOr<bool> {
+            size_t begin = group * grain;
+            if (!operation->batch.derive(begin, std::min<size_t>(length, begin + grain)))
+                return Exception { OperationError };
+            return true;
+        });
+
+    return JSC::JSValue::encode(promise);
+}
+
 JSC::EncodedJSValue KeyObject__Exports(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
 {
 
@@ -2956,6 +3267,9 @@ JSValue createNodeCryptoBinding(Zig::GlobalObject* globalObject)
 
     obj->putDirect(vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "sign"_s)), JSC::JSFunction::create(vm, globalObject, 3, "sign"_s, KeyObject__Sign, ImplementationVisibility::Public, NoIntrinsic), 0);
     obj->putDirect(vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "verify"_s)), JSC::JSFunction::create(vm, globalObject, 4, "verify"_s, KeyObject__Verify, ImplementationVisibility::Public, NoIntrinsic), 0);
+    obj->putDirect(vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "verifyBatch"_s)), JSC::JSFunction::create(vm, globalObject, 4, "verifyBatch"_s, KeyObject__VerifyBatch, ImplementationVisibility::Public, NoIntrinsic), 0);
+    obj->putDirect(vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "pbkdf2Batch"_s)), JSC::JSFunction::create(vm, globalObject, 5, "pbkdf2Batch"_s, KeyObject__Pbkdf2Batch, ImplementationVisibility::Public, NoIntrinsic), 0);
+    obj->putDirect(vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "createCipherStream"_s)), JSC::JSFunction::create(vm, globalObject, 5, "createCipherStream"_s, Bun::jsFunctionCreateCipherStream, ImplementationVisibility::Public, NoIntrinsic), 0);
 
     return obj;
 }
@@ -0,0 +1,28 @@
+#include "root.h"
+#include "MemoryAccounting.h"
+
+namespace Bun {
+
+// Process-wide, so a message counted when one thread posts it can be
+// uncounted when another receives it.
+static std::atomic<size_t> s_memoryInUse[memorySubsystemCount];
+
+void reportMemoryAllocated(MemorySubsystem subsystem, size_t bytes)
+{
+    s_memoryInUse[static_cast<unsigned>(subsystem)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void reportMemoryFreed(MemorySubsystem subsystem, size_t bytes)
+{
+    // Addons may report more freed than they ever reported allocated.
+    auto& inUse = s_memoryInUse[static_cast<unsigned>(subsystem)];
+    size_t current = inUse.load(std::memory_order_relaxed);
+    while (!inUse.compare_exchange_weak(current, current - std::min(current, bytes), std::memory_order_relaxed)) { }
+}
+
+size_t memoryInUse(MemorySubsystem subsystem)
+{
+    return s_memoryInUse[static_cast<unsigned>(subsystem)].load(std::memory_order_relaxed);
+}
+
+}
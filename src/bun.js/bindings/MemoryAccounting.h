@@ -0,0 +1,28 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// Memory held outside the JS heap, by what holds it, for process.report.
+//
+// RSS alone says how much memory there is, not whose it is, and the usual
+// suspects (socket buffers, queued writes, SQLite, messages between
+// Workers, module sources, native addons) are all invisible to a heap
+// snapshot. Subsystems whose memory comes and goes from several threads
+// count it here as it does; the rest are asked when the report is built.
+enum class MemorySubsystem : uint8_t {
+    // SerializedScriptValues queued on a MessagePort and not yet received.
+    MessagePortMessages,
+    // The sources shared by every VM through SharedSourceCache.
+    ModuleSources,
+    // What addons reported through napi_adjust_external_memory().
+    NapiExternalMemory,
+};
+static constexpr unsigned memorySubsystemCount = 3;
+
+void reportMemoryAllocated(MemorySubsystem, size_t);
+void reportMemoryFreed(MemorySubsystem, size_t);
+size_t memoryInUse(MemorySubsystem);
+
+}
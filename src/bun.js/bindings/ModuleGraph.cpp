@@ -0,0 +1,59 @@
+#include "root.h"
+#include "ModuleGraph.h"
+
+namespace Bun {
+
+void ModuleGraph::addImport(const String& imported, const String& importer)
+{
+    if (imported.isEmpty() || importer.isEmpty() || imported == importer)
+        return;
+
+    m_importers.ensure(imported, [] { return HashSet<String>(); }).iterator->value.add(importer);
+    m_imports.ensure(importer, [] { return HashSet<String>(); }).iterator->value.add(imported);
+}
+
+Vector<String> ModuleGraph::invalidate(const Vector<String>& changed)
+{
+    HashSet<String> seen;
+    Vector<String> pending;
+    for (auto& key : changed) {
+        if (seen.add(key).isNewEntry)
+            pending.append(key);
+    }
+
+    Vector<String> invalidated;
+    while (!pending.isEmpty()) {
+        String key = pending.takeLast();
+        invalidated.append(key);
+
+        auto it = m_importers.find(key);
+        if (it == m_importers.end())
+            continue;
+        for (auto& importer : it->value) {
+            if (seen.add(importer).isNewEntry)
+                pending.append(importer);
+        }
+    }
+
+    for (auto& key : invalidated)
+        forget(key);
+
+    return invalidated;
+}
+
+// Drops what `key` imports. Everything that imports `key` is invalidated
+// along with it, so those edges go when each of them is forgotten.
+void ModuleGraph::forget(const String& key)
+{
+    auto imports = m_imports.take(key);
+    for (auto& imported : imports) {
+        auto it = m_importers.find(imported);
+        if (it == m_importers.end())
+            continue;
+        it->value.remove(key);
+        if (it->value.isEmpty())
+            m_importers.remove(it);
+    }
+}
+
+}
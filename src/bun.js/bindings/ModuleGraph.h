@@ -0,0 +1,57 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace Bun {
+
+// Who imports whom, by module key, for --hot.
+//
+// A full reload throws away every ES module record and CommonJS module and
+// evaluates the whole graph again. With this graph, a reload only drops the
+// modules that changed and the ones that import them, directly or not. The
+// rest stay in the registry and the require map, already evaluated, and the
+// importers link against them again when they are re-evaluated.
+//
+// Edges are added as specifiers are resolved: by the module loader for
+// import, and by require()'s resolveSync for CommonJS. A module that is
+// re-evaluated resolves its imports again, so its old edges are dropped when
+// it is invalidated. Extra edges only make a reload do more than it needs to.
+//
+// One graph lives on each global object. It is off until --hot turns it on.
+class ModuleGraph {
+    WTF_MAKE_NONCOPYABLE(ModuleGraph);
+
+public:
+    ModuleGraph() = default;
+
+    bool isEnabled() const { return m_enabled; }
+    void enable() { m_enabled = true; }
+
+    void addImport(const String& imported, const String& importer);
+
+    // The keys in `changed` and every module that imports one of them,
+    // directly or not. Their edges are forgotten, since they are about to be
+    // evaluated again.
+    Vector<String> invalidate(const Vector<String>& changed);
+
+    void clear()
+    {
+        m_importers.clear();
+        m_imports.clear();
+    }
+
+    unsigned size() const { return m_imports.size(); }
+
+private:
+    void forget(const String& key);
+
+    HashMap<String, HashSet<String>> m_importers;
+    HashMap<String, HashSet<String>> m_imports;
+    bool m_enabled { false };
+};
+
+}
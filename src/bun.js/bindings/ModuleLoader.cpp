@@ -36,6 +36,8 @@
 
 #include "../modules/ObjectModule.h"
 #include "wtf/Assertions.h"
+#include "ImportMetaObject.h"
+#include "PathInlines.h"
 
 namespace Bun {
 using namespace JSC;
@@ -389,6 +391,179 @@ static JSValue handleVirtualModuleResult(
     }
 }
 
+static constexpr size_t maxPrefetchedImports = 256;
+
+static bool isIdentifierPart(UChar c)
+{
+    return isASCIIAlphanumeric(c) || c == '_' || c == '$';
+}
+
+static void skipWhitespaceAndComments(StringView source, unsigned& i)
+{
+    while (i < source.length()) {
+        UChar c = source[i];
+        if (isASCIIWhitespace(c)) {
+            i++;
+        } else if (c == '/' && i + 1 < source.length() && source[i + 1] == '/') {
+            size_t end = source.find('\n', i);
+            i = end == notFound ? source.length() : end + 1;
+        } else if (c == '/' && i + 1 < source.length() && source[i + 1] == '*') {
+            size_t end = source.find("*/"_s, i + 2);
+            i = end == notFound ? source.length() : end + 2;
+        } else {
+            return;
+        }
+    }
+}
+
+static bool consumeWord(StringView source, unsigned& i, ASCIILiteral word)
+{
+    unsigned length = word.length();
+    if (i + length > source.length() || source.substring(i, length) != StringView(word))
+        return false;
+    if (i + length < source.length() && isIdentifierPart(source[i + length]))
+        return false;
+    i += length;
+    return true;
+}
+
+// A quoted module specifier. Ones with escapes are left to the loader.
+static std::optional<StringView> consumeSpecifier(StringView source, unsigned& i)
+{
+    if (i >= source.length() || (source[i] != '"' && source[i] != '\''))
+        return std::nullopt;
+    size_t end = source.find(source[i], i + 1);
+    if (end == notFound)
+        return std::nullopt;
+    auto specifier = source.substring(i + 1, end - i - 1);
+    if (specifier.isEmpty() || specifier.contains('\\') || specifier.contains('\n'))
+        return std::nullopt;
+    i = end + 1;
+    return specifier;
+}
+
+// The specifiers of the `import "x"`, `import ... from "x"`, `export * from
+// "x"` and `export { ... } from "x"` declarations at the top of transpiled
+// ESM, which is where the transpiler prints them. Scanning stops at the
+// first statement that is anything else, and declarations with import
+// attributes are skipped, since those are fetched differently.
+static Vector<StringView> staticImportSpecifiers(StringView source)
+{
+    Vector<StringView> specifiers;
+    unsigned i = 0;
+    if (source.startsWith("#!"_s)) {
+        size_t end = source.find('\n');
+        i = end == notFound ? source.length() : end + 1;
+    }
+
+    while (specifiers.size() < maxPrefetchedImports) {
+        skipWhitespaceAndComments(source, i);
+        // "use strict"; and other directives.
+        if (consumeSpecifier(source, i)) {
+            skipWhitespaceAndComments(source, i);
+            if (i < source.length() && source[i] == ';')
+                i++;
+            continue;
+        }
+
+        bool isImport = consumeWord(source, i, "import"_s);
+        if (!isImport && !consumeWord(source, i, "export"_s))
+            break;
+        skipWhitespaceAndComments(source, i);
+
+        std::optional<StringView> specifier;
+        if (isImport)
+            specifier = consumeSpecifier(source, i);
+        else if (i >= source.length() || (source[i] != '*' && source[i] != '{'))
+            break;
+
+        // The bindings, then `from`. Anything unexpected (`import(`,
+        // `import.meta`, `export const`) means the declarations are over.
+        while (!specifier) {
+            skipWhitespaceAndComments(source, i);
+            if (i >= source.length())
+                return specifiers;
+            UChar c = source[i];
+            if (c == '{') {
+                size_t end = source.find('}', i);
+                if (end == notFound)
+                    return specifiers;
+                i = end + 1;
+            } else if (c == '*' || c == ',') {
+                i++;
+            } else if (isIdentifierPart(c)) {
+                bool isFrom = consumeWord(source, i, "from"_s);
+                if (isFrom) {
+                    skipWhitespaceAndComments(source, i);
+                    if ((specifier = consumeSpecifier(source, i)))
+                        break;
+                    continue;
+                }
+                while (i < source.length() && isIdentifierPart(source[i]))
+                    i++;
+            } else {
+                return specifiers;
+            }
+        }
+
+        skipWhitespaceAndComments(source, i);
+        if (consumeWord(source, i, "with"_s) || consumeWord(source, i, "assert"_s)) {
+            size_t end = source.find('}', i);
+            if (end == notFound)
+                return specifiers;
+            i = end + 1;
+        } else {
+            specifiers.append(*specifier);
+        }
+        skipWhitespaceAndComments(source, i);
+        if (i < source.length() && source[i] == ';')
+            i++;
+    }
+
+    return specifiers;
+}
+
+// Starts loading the static imports of a module as soon as its source is
+// in, rather than once JSC has parsed it and asks for them. Their reads and
+// transpiles, which the async fetch path runs on the transpiler's thread
+// pool, then overlap with each other and with this module's parse; a deep
+// graph is discovered one fetch at a time instead of one parse at a time.
+//
+// The loader fetches each module once, whoever asks first, so nothing is
+// loaded twice. A prefetch that fails is ignored: the loader's own request
+// for that module gets the same failure and reports it.
+static void prefetchStaticImports(Zig::GlobalObject* globalObject, const WTF::String& referrer, StringView source)
+{
+    if (!isAbsolutePath(referrer))
+        return;
+
+    auto specifiers = staticImportSpecifiers(source);
+    if (specifiers.isEmpty())
+        return;
+
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    auto from = Bun::toString(referrer);
+    for (auto specifier : specifiers) {
+        auto specifierString = Bun::toString(specifier.toString());
+        JSValue resolved = JSValue::decode(Bun__resolveSyncWithStrings(globalObject, &specifierString, &from, true));
+        if (UNLIKELY(scope.exception())) {
+            scope.clearException();
+            continue;
+        }
+        if (!resolved.isString())
+            continue;
+
+        auto* promise = globalObject->moduleLoader()->loadModule(globalObject, resolved, jsUndefined(), jsUndefined());
+        if (UNLIKELY(scope.exception())) {
+            scope.clearException();
+            continue;
+        }
+        if (promise)
+            promise->markAsHandled(globalObject);
+    }
+}
+
 extern "C" void Bun__onFulfillAsyncModule(
     Zig::GlobalObject* globalObject,
     JSC::EncodedJSValue encodedPromiseValue,
@@ -440,6 +615,7 @@ extern "C" void Bun__onFulfillAsyncModule(
             }
         } else {
             auto&& provider = Zig::SourceProvider::create(jsDynamicCast<Zig::GlobalObject*>(globalObject), res->result.value);
+            prefetchStaticImports(globalObject, specifier->toWTFString(BunString::ZeroCopy), provider->source());
             promise->resolve(globalObject, JSC::JSSourceCode::create(vm, JSC::SourceCode(provider)));
         }
     } else {
@@ -840,8 +1016,10 @@ static JSValue fetchESMSourceCode(
         return rejectOrResolve(JSSourceCode::create(globalObject->vm(), WTFMove(source)));
     }
 
-    return rejectOrResolve(JSC::JSSourceCode::create(vm,
-        JSC::SourceCode(Zig::SourceProvider::create(globalObject, res->result.value))));
+    auto&& provider = Zig::SourceProvider::create(globalObject, res->result.value);
+    if constexpr (allowPromise)
+        prefetchStaticImports(globalObject, specifier->toWTFString(BunString::ZeroCopy), provider->source());
+    return rejectOrResolve(JSC::JSSourceCode::create(vm, JSC::SourceCode(provider)));
 }
 
 extern "C" JSC::EncodedJSValue jsFunctionOnLoadObjectResultResolve(JSC::JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
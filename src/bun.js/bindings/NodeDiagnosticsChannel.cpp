@@ -0,0 +1,88 @@
+#include "config.h"
+#include "NodeDiagnosticsChannel.h"
+
+#include "JavaScriptCore/ArrayConstructor.h"
+#include "JavaScriptCore/JSArray.h"
+
+#include "ZigGlobalObject.h"
+
+namespace Bun {
+
+using namespace JSC;
+
+// Indexed by DiagnosticsChannel.
+static constexpr ASCIILiteral diagnosticsChannelNames[diagnosticsChannelCount] = {
+    "http.server.request.start"_s,
+    "http.server.response.finish"_s,
+    "undici:request:create"_s,
+    "bun:sqlite:query"_s,
+    "worker_threads"_s,
+};
+
+void publishDiagnosticsChannel(Zig::GlobalObject* globalObject, DiagnosticsChannel channel, JSValue message)
+{
+    JSObject* publish = globalObject->diagnosticsChannelPublisher(channel);
+    if (!publish)
+        return;
+
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    auto callData = JSC::getCallData(publish);
+    if (callData.type == CallData::Type::None)
+        return;
+
+    MarkedArgumentBuffer arguments;
+    arguments.append(message);
+    NakedPtr<JSC::Exception> exceptionPtr;
+    JSC::call(globalObject, publish, callData, jsUndefined(), arguments, exceptionPtr);
+    if (auto* exception = exceptionPtr.get()) {
+        scope.clearException();
+        Bun__reportUnhandledError(globalObject, JSValue::encode(exception));
+    }
+}
+
+// setNativeChannel(index, publish) is called by node:diagnostics_channel with
+// the publish function of a channel when it gets its first subscriber, and
+// with null when it loses its last one.
+JSC_DEFINE_HOST_FUNCTION(jsSetNativeDiagnosticsChannel, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    JSValue indexValue = callFrame->argument(0);
+    if (!indexValue.isUInt32() || indexValue.asUInt32() >= diagnosticsChannelCount)
+        return JSValue::encode(jsUndefined());
+
+    auto channel = static_cast<DiagnosticsChannel>(indexValue.asUInt32());
+    JSValue publish = callFrame->argument(1);
+    globalObject->setDiagnosticsChannelPublisher(channel, publish.isCallable() ? asObject(publish) : nullptr);
+    return JSValue::encode(jsUndefined());
+}
+
+JSC::JSValue createDiagnosticsChannelBinding(Zig::GlobalObject* globalObject)
+{
+    VM& vm = globalObject->vm();
+    auto* names = constructEmptyArray(globalObject, nullptr, diagnosticsChannelCount);
+    for (unsigned i = 0; i < diagnosticsChannelCount; i++)
+        names->putDirectIndex(globalObject, i, jsString(vm, String(diagnosticsChannelNames[i])));
+
+    auto binding = constructEmptyArray(globalObject, nullptr, 2);
+    binding->putByIndexInline(globalObject, (unsigned)0, names, false);
+    binding->putByIndexInline(
+        globalObject,
+        (unsigned)1,
+        JSC::JSFunction::create(vm, globalObject, 2, "setNativeChannel"_s, jsSetNativeDiagnosticsChannel, ImplementationVisibility::Public),
+        false);
+    return binding;
+}
+
+}
+
+extern "C" bool Bun__DiagnosticsChannel__hasSubscribers(Zig::GlobalObject* globalObject, uint8_t channel)
+{
+    return channel < Bun::diagnosticsChannelCount && globalObject->diagnosticsChannelPublisher(static_cast<Bun::DiagnosticsChannel>(channel));
+}
+
+extern "C" void Bun__DiagnosticsChannel__publish(Zig::GlobalObject* globalObject, uint8_t channel, JSC::EncodedJSValue message)
+{
+    if (channel < Bun::diagnosticsChannelCount)
+        Bun::publishDiagnosticsChannel(globalObject, static_cast<Bun::DiagnosticsChannel>(channel), JSC::JSValue::decode(message));
+}
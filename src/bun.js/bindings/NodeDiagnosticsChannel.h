@@ -0,0 +1,34 @@
+#pragma once
+
+#include "root.h"
+
+namespace Zig {
+class GlobalObject;
+}
+
+namespace Bun {
+
+// Channels of node:diagnostics_channel that native code publishes to.
+//
+// node:diagnostics_channel hands the native side a publish function for a
+// channel when it gets its first subscriber and takes it back when the last
+// one unsubscribes, so checking for subscribers is a load from the global
+// object and a channel nobody listens to costs nothing more than that.
+enum class DiagnosticsChannel : uint8_t {
+    HTTPServerRequestStart,
+    HTTPServerResponseFinish,
+    UndiciRequestCreate,
+    SQLiteQuery,
+    WorkerThreads,
+};
+
+static constexpr size_t diagnosticsChannelCount = static_cast<size_t>(DiagnosticsChannel::WorkerThreads) + 1;
+
+// Calls the subscribers of `channel`. An exception thrown by one of them is
+// reported as uncaught rather than thrown at the publisher, like
+// Channel.prototype.publish does with its subscribers.
+void publishDiagnosticsChannel(Zig::GlobalObject*, DiagnosticsChannel channel, JSC::JSValue message);
+
+JSC::JSValue createDiagnosticsChannelBinding(Zig::GlobalObject*);
+
+}
@@ -11,6 +11,7 @@
 #include "JavaScriptCore/JSFunction.h"
 #include "wtf/URL.h"
 #include "JSFetchHeaders.h"
+#include "JSNodeHTTPRequestHeaders.h"
 #include "JSDOMExceptionHandling.h"
 #include <bun-uws/src/App.h>
 #include "ZigGeneratedClasses.h"
@@ -92,7 +93,9 @@ static EncodedJSValue assignHeadersFromFetchHeaders(FetchHeaders& impl, JSObject
 }
 
 // This is an 8% speedup.
-static EncodedJSValue assignHeadersFromUWebSockets(uWS::HttpRequest* request, JSObject* prototype, JSObject* objectValue, JSC::InternalFieldTuple* tuple, JSC::JSGlobalObject* globalObject, JSC::VM& vm)
+// With lazyRawHeaders, rawHeaders is left undefined for getRawHeaders() to
+// build if it is ever read.
+static EncodedJSValue assignHeadersFromUWebSockets(uWS::HttpRequest* request, bool lazyRawHeaders, JSObject* objectValue, JSC::InternalFieldTuple* tuple, JSC::JSGlobalObject* globalObject, JSC::VM& vm)
 {
     auto scope = DECLARE_THROW_SCOPE(vm);
     auto& builtinNames = WebCore::builtinNames(vm);
@@ -193,64 +196,16 @@ static EncodedJSValue assignHeadersFromUWebSockets(uWS::HttpRequest* request, JS
         RETURN_IF_EXCEPTION(scope, {});
     }
 
-    size_t size = 0;
-    for (auto it = request->begin(); it != request->end(); ++it) {
-        size++;
-    }
-
-    JSC::JSObject* headersObject = JSC::constructEmptyObject(globalObject, prototype, std::min(size, static_cast<size_t>(JSFinalObject::maxInlineCapacity)));
-    RETURN_IF_EXCEPTION(scope, {});
-    JSC::JSArray* array = constructEmptyArray(globalObject, nullptr, size * 2);
-    JSC::JSArray* setCookiesHeaderArray = nullptr;
-    JSC::JSString* setCookiesHeaderString = nullptr;
-
-    unsigned i = 0;
-
-    for (auto it = request->begin(); it != request->end(); ++it) {
-        auto pair = *it;
-        StringView nameView = StringView(std::span { reinterpret_cast<const LChar*>(pair.first.data()), pair.first.length() });
-        LChar* data = nullptr;
-        auto value = String::createUninitialized(pair.second.length(), data);
-        if (pair.second.length() > 0)
-            memcpy(data, pair.second.data(), pair.second.length());
-
-        HTTPHeaderName name;
-        WTF::String nameString;
-        WTF::String lowercasedNameString;
-
-        if (WebCore::findHTTPHeaderName(nameView, name)) {
-            nameString = WTF::httpHeaderNameStringImpl(name);
-            lowercasedNameString = nameString;
-        } else {
-            nameString = nameView.toString();
-            lowercasedNameString = nameString.convertToASCIILowercase();
-        }
-
-        JSString* jsValue = jsString(vm, value);
-
-        if (name == WebCore::HTTPHeaderName::SetCookie) {
-            if (!setCookiesHeaderArray) {
-                setCookiesHeaderArray = constructEmptyArray(globalObject, nullptr);
-                setCookiesHeaderString = jsString(vm, nameString);
-                headersObject->putDirect(vm, Identifier::fromString(vm, lowercasedNameString), setCookiesHeaderArray, 0);
-                RETURN_IF_EXCEPTION(scope, {});
-            }
-            array->putDirectIndex(globalObject, i++, setCookiesHeaderString);
-            array->putDirectIndex(globalObject, i++, jsValue);
-            setCookiesHeaderArray->push(globalObject, jsValue);
-            RETURN_IF_EXCEPTION(scope, {});
-
-        } else {
-            headersObject->putDirect(vm, Identifier::fromString(vm, lowercasedNameString), jsValue, 0);
-            array->putDirectIndex(globalObject, i++, jsString(vm, nameString));
-            array->putDirectIndex(globalObject, i++, jsValue);
-            RETURN_IF_EXCEPTION(scope, {});
-        }
+    auto* headers = JSNodeHTTPRequestHeaders::create(vm, reinterpret_cast<Zig::GlobalObject*>(globalObject)->JSNodeHTTPRequestHeadersStructure(), request);
+    tuple->putInternalField(vm, 0, headers);
+    if (lazyRawHeaders) {
+        tuple->putInternalField(vm, 1, jsUndefined());
+    } else {
+        auto* rawHeaders = headers->rawHeaders(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        tuple->putInternalField(vm, 1, rawHeaders);
     }
 
-    tuple->putInternalField(vm, 0, headersObject);
-    tuple->putInternalField(vm, 1, array);
-
     return JSValue::encode(tuple);
 }
 
@@ -268,7 +223,8 @@ JSC_DEFINE_HOST_FUNCTION(jsHTTPAssignHeaders, (JSGlobalObject * globalObject, Ca
     JSValue urlValue = JSValue();
     if (auto* jsRequest = jsDynamicCast<WebCore::JSRequest*>(requestValue)) {
         if (uWS::HttpRequest* request = Request__getUWSRequest(jsRequest->wrapped())) {
-            return assignHeadersFromUWebSockets(request, globalObject->objectPrototype(), objectValue, tuple, globalObject, vm);
+            bool lazyRawHeaders = callFrame->argument(2).toBoolean(globalObject);
+            return assignHeadersFromUWebSockets(request, lazyRawHeaders, objectValue, tuple, globalObject, vm);
         }
 
         if (jsRequest->m_headers) {
@@ -320,6 +276,20 @@ JSC_DEFINE_HOST_FUNCTION(jsHTTPAssignHeaders, (JSGlobalObject * globalObject, Ca
     return JSValue::encode(jsNull());
 }
 
+JSC_DEFINE_HOST_FUNCTION(jsHTTPGetRawHeaders, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (auto* headers = jsDynamicCast<JSNodeHTTPRequestHeaders*>(callFrame->argument(0))) {
+        auto* rawHeaders = headers->rawHeaders(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        return JSValue::encode(rawHeaders);
+    }
+
+    return JSValue::encode(jsUndefined());
+}
+
 JSC_DEFINE_HOST_FUNCTION(jsHTTPGetHeader, (JSGlobalObject * globalObject, CallFrame* callFrame))
 {
     auto& vm = globalObject->vm();
@@ -416,6 +386,9 @@ JSValue createNodeHTTPInternalBinding(Zig::GlobalObject* globalObject)
     obj->putDirect(
         vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "assignHeaders"_s)),
         JSC::JSFunction::create(vm, globalObject, 2, "assignHeaders"_s, jsHTTPAssignHeaders, ImplementationVisibility::Public), NoIntrinsic);
+    obj->putDirect(
+        vm, JSC::PropertyName(JSC::Identifier::fromString(vm, "getRawHeaders"_s)),
+        JSC::JSFunction::create(vm, globalObject, 1, "getRawHeaders"_s, jsHTTPGetRawHeaders, ImplementationVisibility::Public), NoIntrinsic);
     return obj;
 }
 
@@ -0,0 +1,204 @@
+#include "root.h"
+#include "NodePerfHooks.h"
+
+#include "Histogram.h"
+#include "libusockets.h"
+#include "_libusockets.h"
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/ObjectConstructor.h>
+#include <wtf/MonotonicTime.h>
+
+extern "C" uint64_t Bun__readOriginTimer(void*);
+
+namespace Bun {
+
+using namespace JSC;
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionEventLoopUtilization, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* zigGlobalObject = jsCast<Zig::GlobalObject*>(globalObject);
+
+    double elapsed = Bun__readOriginTimer(zigGlobalObject->bunVM()) / 1e6;
+    double idle = us_loop_idle_time(uws_get_loop()) / 1e6;
+    double active = std::max(elapsed - idle, 0.0);
+
+    const auto read = [&](JSValue utilization, double& idle, double& active) -> bool {
+        auto* object = utilization.getObject();
+        if (!object)
+            return false;
+        idle = object->get(globalObject, Identifier::fromString(vm, "idle"_s)).toNumber(globalObject);
+        RETURN_IF_EXCEPTION(scope, false);
+        active = object->get(globalObject, Identifier::fromString(vm, "active"_s)).toNumber(globalObject);
+        RETURN_IF_EXCEPTION(scope, false);
+        return true;
+    };
+
+    double previousIdle, previousActive;
+    if (read(callFrame->argument(0), previousIdle, previousActive)) {
+        double laterIdle, laterActive;
+        if (read(callFrame->argument(1), laterIdle, laterActive)) {
+            // Both are earlier results; the first one is the later of the two.
+            idle = previousIdle - laterIdle;
+            active = previousActive - laterActive;
+        } else {
+            RETURN_IF_EXCEPTION(scope, {});
+            idle -= previousIdle;
+            active -= previousActive;
+        }
+    }
+    RETURN_IF_EXCEPTION(scope, {});
+
+    double total = idle + active;
+    auto* result = constructEmptyObject(globalObject);
+    result->putDirect(vm, Identifier::fromString(vm, "idle"_s), jsNumber(idle));
+    result->putDirect(vm, Identifier::fromString(vm, "active"_s), jsNumber(active));
+    result->putDirect(vm, Identifier::fromString(vm, "utilization"_s), jsNumber(total > 0 ? active / total : 0));
+    return JSValue::encode(result);
+}
+
+static uint64_t monotonicTimeInNanoseconds()
+{
+    return static_cast<uint64_t>(MonotonicTime::now().secondsSinceEpoch().nanoseconds());
+}
+
+class EventLoopDelayMonitor : public RefCounted<EventLoopDelayMonitor> {
+public:
+    static Ref<EventLoopDelayMonitor> create(unsigned resolution) { return adoptRef(*new EventLoopDelayMonitor(resolution)); }
+
+    ~EventLoopDelayMonitor() { disable(); }
+
+    bool enable()
+    {
+        if (m_timer)
+            return false;
+
+        // Like Node's, the timer does not keep the process alive.
+        m_timer = us_create_timer(uws_get_loop(), 1, sizeof(EventLoopDelayMonitor*));
+        if (!m_timer)
+            return false;
+        *static_cast<EventLoopDelayMonitor**>(us_timer_ext(m_timer)) = this;
+        m_previousTick = monotonicTimeInNanoseconds();
+        us_timer_set(m_timer, onTimer, m_resolution, m_resolution);
+        return true;
+    }
+
+    bool disable()
+    {
+        if (!m_timer)
+            return false;
+        us_timer_close(m_timer, 1);
+        m_timer = nullptr;
+        return true;
+    }
+
+    Histogram& histogram() { return m_histogram; }
+
+private:
+    explicit EventLoopDelayMonitor(unsigned resolution)
+        : m_resolution(resolution)
+    {
+    }
+
+    static void onTimer(us_timer_t* timer)
+    {
+        auto* monitor = *static_cast<EventLoopDelayMonitor**>(us_timer_ext(timer));
+        uint64_t now = monotonicTimeInNanoseconds();
+        // The whole interval, resolution included, as Node records it.
+        monitor->m_histogram.record(now - monitor->m_previousTick);
+        monitor->m_previousTick = now;
+    }
+
+    Histogram m_histogram;
+    us_timer_t* m_timer { nullptr };
+    unsigned m_resolution;
+    uint64_t m_previousTick { 0 };
+};
+
+static JSObject* histogramStatistics(JSGlobalObject* globalObject, const Histogram& histogram)
+{
+    auto& vm = globalObject->vm();
+    auto* object = constructEmptyObject(globalObject);
+    object->putDirect(vm, Identifier::fromString(vm, "min"_s), jsNumber(histogram.min()));
+    object->putDirect(vm, Identifier::fromString(vm, "max"_s), jsNumber(histogram.max()));
+    object->putDirect(vm, Identifier::fromString(vm, "mean"_s), jsNumber(histogram.count() ? histogram.mean() : std::numeric_limits<double>::quiet_NaN()));
+    object->putDirect(vm, Identifier::fromString(vm, "stddev"_s), jsNumber(histogram.count() ? histogram.stddev() : std::numeric_limits<double>::quiet_NaN()));
+    object->putDirect(vm, Identifier::fromString(vm, "count"_s), jsNumber(histogram.count()));
+    object->putDirect(vm, Identifier::fromString(vm, "exceeds"_s), jsNumber(histogram.exceeds()));
+
+    // [percentile, value] pairs, for the JS side to turn into a Map.
+    auto percentiles = histogram.percentiles();
+    MarkedArgumentBuffer pairs;
+    for (auto& [percentile, value] : percentiles) {
+        MarkedArgumentBuffer pair;
+        pair.append(jsNumber(percentile));
+        pair.append(jsNumber(value));
+        pairs.append(constructArray(globalObject, static_cast<ArrayAllocationProfile*>(nullptr), pair));
+    }
+    object->putDirect(vm, Identifier::fromString(vm, "percentiles"_s), constructArray(globalObject, static_cast<ArrayAllocationProfile*>(nullptr), pairs));
+    return object;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionMonitorEventLoopDelay, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    double resolution = 10;
+    if (!callFrame->argument(0).isUndefined()) {
+        resolution = callFrame->argument(0).toNumber(globalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+    if (!(resolution >= 1 && resolution <= std::numeric_limits<int32_t>::max())) {
+        throwRangeError(globalObject, scope, "resolution must be a positive integer"_s);
+        return {};
+    }
+
+    Ref monitor = EventLoopDelayMonitor::create(static_cast<unsigned>(resolution));
+
+    auto* object = constructEmptyObject(globalObject);
+    object->putDirect(vm, Identifier::fromString(vm, "enable"_s),
+        JSNativeStdFunction::create(vm, globalObject, 0, "enable"_s, [monitor](JSGlobalObject*, CallFrame*) -> EncodedJSValue {
+            return JSValue::encode(jsBoolean(monitor->enable()));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "disable"_s),
+        JSNativeStdFunction::create(vm, globalObject, 0, "disable"_s, [monitor](JSGlobalObject*, CallFrame*) -> EncodedJSValue {
+            return JSValue::encode(jsBoolean(monitor->disable()));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "reset"_s),
+        JSNativeStdFunction::create(vm, globalObject, 0, "reset"_s, [monitor](JSGlobalObject*, CallFrame*) -> EncodedJSValue {
+            monitor->histogram().reset();
+            return JSValue::encode(jsUndefined());
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "percentile"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "percentile"_s, [monitor](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            double percentile = callFrame->argument(0).toNumber(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (!(percentile > 0 && percentile <= 100)) {
+                throwRangeError(globalObject, scope, "percentile must be > 0 and <= 100"_s);
+                return {};
+            }
+            return JSValue::encode(jsNumber(monitor->histogram().valueAtPercentile(percentile)));
+        }));
+    object->putDirect(vm, Identifier::fromString(vm, "statistics"_s),
+        JSNativeStdFunction::create(vm, globalObject, 0, "statistics"_s, [monitor](JSGlobalObject* globalObject, CallFrame*) -> EncodedJSValue {
+            return JSValue::encode(histogramStatistics(globalObject, monitor->histogram()));
+        }));
+    return JSValue::encode(object);
+}
+
+JSC::JSValue createNodePerfHooksBinding(Zig::GlobalObject* globalObject)
+{
+    VM& vm = globalObject->vm();
+    auto* binding = constructEmptyObject(globalObject);
+    binding->putDirect(vm, Identifier::fromString(vm, "monitorEventLoopDelay"_s),
+        JSC::JSFunction::create(vm, globalObject, 1, "monitorEventLoopDelay"_s, jsFunctionMonitorEventLoopDelay, ImplementationVisibility::Public));
+    binding->putDirect(vm, Identifier::fromString(vm, "eventLoopUtilization"_s),
+        JSC::JSFunction::create(vm, globalObject, 2, "eventLoopUtilization"_s, jsFunctionEventLoopUtilization, ImplementationVisibility::Public));
+    return binding;
+}
+
+}
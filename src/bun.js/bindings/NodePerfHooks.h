@@ -0,0 +1,20 @@
+#pragma once
+
+#include "root.h"
+#include "ZigGlobalObject.h"
+
+namespace Bun {
+
+// performance.eventLoopUtilization(utilization1, utilization2), as in Node:
+// how much of the time since the process started (or between two earlier
+// results) the event loop spent running rather than waiting for polls.
+JSC_DECLARE_HOST_FUNCTION(jsFunctionEventLoopUtilization);
+
+// For node:perf_hooks. monitorEventLoopDelay(resolution) wakes up every
+// `resolution` milliseconds from a timer on the loop itself and records how
+// long it really took into a histogram, so measuring the delay does not add
+// any work to JS. It returns `enable()`, `disable()`, `reset()`,
+// `percentile(p)` and `statistics()`.
+JSC::JSValue createNodePerfHooksBinding(Zig::GlobalObject*);
+
+}
@@ -4,6 +4,32 @@
 
 namespace Bun {
 
+// https://url.spec.whatwg.org/#forbidden-host-code-point
+// Checked in one pass over the characters rather than one per code point.
+static constexpr std::array<bool, 128> forbiddenHostCodePoints = [] {
+    std::array<bool, 128> table {};
+    for (char c : { '\0', '\t', '\n', '\r', ' ', '#', '/', ':', '<', '>', '?', '@', '[', '\\', ']', '^', '|' })
+        table[static_cast<uint8_t>(c)] = true;
+    return table;
+}();
+
+template<typename CharacterType>
+static bool containsForbiddenHostCodePoint(std::span<const CharacterType> characters)
+{
+    for (auto character : characters) {
+        if (character < 128 && forbiddenHostCodePoints[character])
+            return true;
+    }
+    return false;
+}
+
+static bool containsForbiddenHostCodePoint(const String& domain)
+{
+    if (domain.is8Bit())
+        return containsForbiddenHostCodePoint(domain.span8());
+    return containsForbiddenHostCodePoint(domain.span16());
+}
+
 JSC_DEFINE_HOST_FUNCTION(jsDomainToASCII, (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
     auto& vm = globalObject->vm();
@@ -28,26 +54,7 @@ JSC_DEFINE_HOST_FUNCTION(jsDomainToASCII, (JSC::JSGlobalObject * globalObject, J
     if (domain.isNull())
         return JSC::JSValue::encode(jsUndefined());
 
-    // https://url.spec.whatwg.org/#forbidden-host-code-point
-    if (
-        domain.contains(0x0000) || // U+0000 NULL
-        domain.contains(0x0009) || // U+0009 TAB
-        domain.contains(0x000A) || // U+000A LF
-        domain.contains(0x000D) || // U+000D CR
-        domain.contains(0x0020) || // U+0020 SPACE
-        domain.contains(0x0023) || // U+0023 (#)
-        domain.contains(0x002F) || // U+002F (/)
-        domain.contains(0x003A) || // U+003A (:)
-        domain.contains(0x003C) || // U+003C (<)
-        domain.contains(0x003E) || // U+003E (>)
-        domain.contains(0x003F) || // U+003F (?)
-        domain.contains(0x0040) || // U+0040 (@)
-        domain.contains(0x005B) || // U+005B ([)
-        domain.contains(0x005C) || // U+005C (\)
-        domain.contains(0x005D) || // U+005D (])
-        domain.contains(0x005E) || // U+005E (^)
-        domain.contains(0x007C) // // U+007C (|).
-    )
+    if (containsForbiddenHostCodePoint(domain))
         return JSC::JSValue::encode(jsEmptyString(vm));
 
     if (domain.containsOnlyASCII())
@@ -96,26 +103,7 @@ JSC_DEFINE_HOST_FUNCTION(jsDomainToUnicode, (JSC::JSGlobalObject * globalObject,
     if (domain.isNull())
         return JSC::JSValue::encode(jsUndefined());
 
-    // https://url.spec.whatwg.org/#forbidden-host-code-point
-    if (
-        domain.contains(0x0000) || // U+0000 NULL
-        domain.contains(0x0009) || // U+0009 TAB
-        domain.contains(0x000A) || // U+000A LF
-        domain.contains(0x000D) || // U+000D CR
-        domain.contains(0x0020) || // U+0020 SPACE
-        domain.contains(0x0023) || // U+0023 (#)
-        domain.contains(0x002F) || // U+002F (/)
-        domain.contains(0x003A) || // U+003A (:)
-        domain.contains(0x003C) || // U+003C (<)
-        domain.contains(0x003E) || // U+003E (>)
-        domain.contains(0x003F) || // U+003F (?)
-        domain.contains(0x0040) || // U+0040 (@)
-        domain.contains(0x005B) || // U+005B ([)
-        domain.contains(0x005C) || // U+005C (\)
-        domain.contains(0x005D) || // U+005D (])
-        domain.contains(0x005E) || // U+005E (^)
-        domain.contains(0x007C) // // U+007C (|).
-    )
+    if (containsForbiddenHostCodePoint(domain))
         return JSC::JSValue::encode(jsEmptyString(vm));
 
     if (!domain.is8Bit())
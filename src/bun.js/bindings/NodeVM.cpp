@@ -18,6 +18,8 @@
 #include "JavaScriptCore/PropertyNameArray.h"
 #include "JavaScriptCore/JSWeakMap.h"
 #include "JavaScriptCore/JSWeakMapInlines.h"
+#include "JavaScriptCore/JSMap.h"
+#include "JavaScriptCore/JSMapInlines.h"
 #include "JavaScriptCore/JSWithScope.h"
 #include "JavaScriptCore/JSGlobalProxyInlines.h"
 #include "GCDefferalContext.h"
@@ -87,13 +89,62 @@ public:
     }
 };
 
+// Sandboxes and SSR renderers run the same few sources in many contexts.
+// A DirectEvalExecutable does not depend on the context it runs in, so
+// each source is parsed and compiled once per global and kept here as an
+// internal Script, keyed by the source string. It is thrown away whole
+// once it holds maxCachedScripts sources, which only code that builds a
+// new source every time gets to.
+static constexpr unsigned maxCachedScripts = 64;
+
+static NodeVMScript* compiledScript(Zig::GlobalObject* globalObject, JSString* sourceString, const ScriptOptions& options)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    JSMap* cache = globalObject->vmModuleScriptCache();
+
+    JSValue cachedValue = cache->get(globalObject, sourceString);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    if (auto* cached = jsDynamicCast<NodeVMScript*>(cachedValue)) {
+        // Stack traces and sourceURL come from the filename and offsets.
+        const SourceCode& source = cached->source();
+        if (source.provider()->sourceURL() == options.filename && source.firstLine() == options.lineOffset && source.startColumn() == options.columnOffset)
+            return cached;
+    }
+
+    auto sourceText = sourceString->value(globalObject);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    SourceCode source(
+        JSC::StringSourceProvider::create(sourceText, JSC::SourceOrigin(WTF::URL::fileURLWithFileSystemPath(options.filename)), options.filename, JSC::SourceTaintedOrigin::Untainted, TextPosition(options.lineOffset, options.columnOffset)),
+        options.lineOffset.zeroBasedInt(), options.columnOffset.zeroBasedInt());
+
+    // Note: it accepts a JSGlobalObject, but it just reads stuff from JSC::VM.
+    auto* executable = JSC::DirectEvalExecutable::create(
+        globalObject, source, DerivedContextType::None, NeedsClassFieldInitializer::No, PrivateBrandRequirement::None,
+        false, false, EvalContextType::None, nullptr, nullptr, ECMAMode::sloppy());
+    RETURN_IF_EXCEPTION(scope, nullptr);
+
+    NodeVMScript* script = NodeVMScript::create(vm, globalObject, globalObject->NodeVMScriptStructure(), source);
+    script->m_cachedDirectExecutable.set(vm, script, executable);
+
+    if (cache->size() >= maxCachedScripts) {
+        cache->clear(globalObject);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+    }
+    cache->set(globalObject, sourceString, script);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    return script;
+}
+
 static EncodedJSValue
 constructScript(JSGlobalObject* globalObject, CallFrame* callFrame, JSValue newTarget = JSValue())
 {
     VM& vm = globalObject->vm();
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
     ArgList args(callFrame);
     JSValue sourceArg = args.at(0);
-    String sourceString = sourceArg.isUndefined() ? emptyString() : sourceArg.toWTFString(globalObject);
+    JSString* sourceString = sourceArg.isUndefined() ? jsEmptyString(vm) : sourceArg.toString(globalObject);
+    RETURN_IF_EXCEPTION(throwScope, {});
 
     JSValue optionsArg = args.at(1);
     bool didThrow = false;
@@ -121,12 +172,12 @@ constructScript(JSGlobalObject* globalObject, CallFrame* callFrame, JSValue newT
         scope.release();
     }
 
-    auto scope = DECLARE_THROW_SCOPE(vm);
-    SourceCode source(
-        JSC::StringSourceProvider::create(sourceString, JSC::SourceOrigin(WTF::URL::fileURLWithFileSystemPath(options.filename)), options.filename, JSC::SourceTaintedOrigin::Untainted, TextPosition(options.lineOffset, options.columnOffset)),
-        options.lineOffset.zeroBasedInt(), options.columnOffset.zeroBasedInt());
-    RETURN_IF_EXCEPTION(scope, {});
-    NodeVMScript* script = NodeVMScript::create(vm, globalObject, structure, source);
+    // Compiling up front is what reports a SyntaxError from the constructor,
+    // as Node does, and lets Scripts of the same source share the result.
+    NodeVMScript* compiled = compiledScript(zigGlobalObject, sourceString, options);
+    RETURN_IF_EXCEPTION(throwScope, {});
+    NodeVMScript* script = NodeVMScript::create(vm, globalObject, structure, compiled->source());
+    script->m_cachedDirectExecutable.set(vm, script, compiled->m_cachedDirectExecutable.get());
     return JSValue::encode(JSValue(script));
 }
 
@@ -240,7 +291,8 @@ JSC_DEFINE_HOST_FUNCTION(vmModuleRunInNewContext, (JSGlobalObject * globalObject
         return JSValue::encode({});
     }
 
-    auto sourceString = sourceStringValue.toWTFString(globalObject);
+    JSString* sourceString = sourceStringValue.toString(globalObject);
+    RETURN_IF_EXCEPTION(throwScope, {});
 
     if (!contextObjectValue || contextObjectValue.isUndefinedOrNull()) {
         contextObjectValue = JSC::constructEmptyObject(globalObject);
@@ -264,38 +316,21 @@ JSC_DEFINE_HOST_FUNCTION(vmModuleRunInNewContext, (JSGlobalObject * globalObject
             return JSValue::encode({});
         }
     }
-    SourceCode source(
-        JSC::StringSourceProvider::create(sourceString, JSC::SourceOrigin(WTF::URL::fileURLWithFileSystemPath(options.filename)), options.filename, JSC::SourceTaintedOrigin::Untainted, TextPosition(options.lineOffset, options.columnOffset)),
-        options.lineOffset.zeroBasedInt(), options.columnOffset.zeroBasedInt());
-
     auto* zigGlobal = reinterpret_cast<Zig::GlobalObject*>(globalObject);
+    NodeVMScript* script = compiledScript(zigGlobal, sourceString, options);
+    RETURN_IF_EXCEPTION(throwScope, {});
+
     JSObject* context = asObject(contextObjectValue);
     auto* targetContext = JSC::JSGlobalObject::create(
         vm, zigGlobal->globalObjectStructure());
 
-    auto* executable = JSC::DirectEvalExecutable::create(
-        targetContext, source, DerivedContextType::None, NeedsClassFieldInitializer::No, PrivateBrandRequirement::None,
-        false, false, EvalContextType::None, nullptr, nullptr, ECMAMode::sloppy());
-    RETURN_IF_EXCEPTION(throwScope, {});
-
     auto proxyStructure = JSGlobalProxy::createStructure(vm, globalObject, JSC::jsNull());
     auto proxy = JSGlobalProxy::create(vm, proxyStructure);
     proxy->setTarget(vm, targetContext);
     context->setPrototypeDirect(vm, proxy);
 
     JSScope* contextScope = JSWithScope::create(vm, targetContext, targetContext->globalScope(), context);
-
-    auto catchScope = DECLARE_CATCH_SCOPE(vm);
-    JSValue result = vm.interpreter.executeEval(executable, targetContext, contextScope);
-    if (UNLIKELY(catchScope.exception())) {
-        auto returnedException = catchScope.exception();
-        catchScope.clearException();
-        JSC::throwException(globalObject, throwScope, returnedException);
-    }
-
-    RETURN_IF_EXCEPTION(throwScope, {});
-
-    return JSValue::encode(result);
+    RELEASE_AND_RETURN(throwScope, runInContext(targetContext, script, context, contextScope, optionsObjectValue));
 }
 
 JSC_DEFINE_HOST_FUNCTION(vmModuleRunInThisContext, (JSGlobalObject * globalObject, CallFrame* callFrame))
@@ -311,7 +346,8 @@ JSC_DEFINE_HOST_FUNCTION(vmModuleRunInThisContext, (JSGlobalObject * globalObjec
         return JSValue::encode({});
     }
 
-    auto sourceString = sourceStringValue.toWTFString(globalObject);
+    JSString* sourceString = sourceStringValue.toString(globalObject);
+    RETURN_IF_EXCEPTION(throwScope, {});
 
     if (!contextObjectValue || contextObjectValue.isUndefinedOrNull()) {
         contextObjectValue = JSC::constructEmptyObject(globalObject);
@@ -333,10 +369,10 @@ JSC_DEFINE_HOST_FUNCTION(vmModuleRunInThisContext, (JSGlobalObject * globalObjec
             return JSValue::encode({});
         }
     }
-    SourceCode source(
-        JSC::StringSourceProvider::create(sourceString, JSC::SourceOrigin(WTF::URL::fileURLWithFileSystemPath(options.filename)), options.filename, JSC::SourceTaintedOrigin::Untainted, TextPosition(options.lineOffset, options.columnOffset)),
-        options.lineOffset.zeroBasedInt(), options.columnOffset.zeroBasedInt());
     auto* zigGlobal = reinterpret_cast<Zig::GlobalObject*>(globalObject);
+    NodeVMScript* script = compiledScript(zigGlobal, sourceString, options);
+    RETURN_IF_EXCEPTION(throwScope, {});
+
     JSObject* context = asObject(contextObjectValue);
 
     auto proxyStructure = zigGlobal->globalProxyStructure();
@@ -344,23 +380,8 @@ JSC_DEFINE_HOST_FUNCTION(vmModuleRunInThisContext, (JSGlobalObject * globalObjec
     proxy->setTarget(vm, globalObject);
     context->setPrototypeDirect(vm, proxy);
 
-    auto* executable = JSC::DirectEvalExecutable::create(
-        globalObject, source, DerivedContextType::None, NeedsClassFieldInitializer::No, PrivateBrandRequirement::None,
-        false, false, EvalContextType::None, nullptr, nullptr, ECMAMode::sloppy());
-    RETURN_IF_EXCEPTION(throwScope, {});
-
     JSScope* contextScope = JSWithScope::create(vm, globalObject, globalObject->globalScope(), context);
-    auto catchScope = DECLARE_CATCH_SCOPE(vm);
-    JSValue result = vm.interpreter.executeEval(executable, globalObject, contextScope);
-    if (UNLIKELY(catchScope.exception())) {
-        auto returnedException = catchScope.exception();
-        catchScope.clearException();
-        JSC::throwException(globalObject, throwScope, returnedException);
-    }
-
-    RETURN_IF_EXCEPTION(throwScope, {});
-
-    return JSValue::encode(result);
+    RELEASE_AND_RETURN(throwScope, runInContext(globalObject, script, context, contextScope, optionsObjectValue));
 }
 
 JSC_DEFINE_HOST_FUNCTION(scriptRunInNewContext, (JSGlobalObject * globalObject, CallFrame* callFrame))
@@ -460,12 +481,33 @@ JSC_DEFINE_HOST_FUNCTION(vmModule_createContext, (JSGlobalObject * globalObject,
     }
     JSObject* context = asObject(contextArg);
     auto* zigGlobalObject = reinterpret_cast<Zig::GlobalObject*>(globalObject);
-    auto* targetContext = JSC::JSGlobalObject::create(
-        vm, zigGlobalObject->globalObjectStructure());
 
-    auto proxyStructure = zigGlobalObject->globalProxyStructure();
-    auto proxy = JSGlobalProxy::create(vm, proxyStructure);
-    proxy->setTarget(vm, targetContext);
+    // { sharedGlobal: true } puts the context in front of a global that every
+    // such context shares, instead of creating a whole global object for it,
+    // which is most of what a context costs. The context's own properties
+    // still come first, but builtins are shared, and so is anything a
+    // script puts on the global: top-level var and function declarations
+    // included.
+    bool sharedGlobal = false;
+    JSValue optionsArg = callFrame->argument(1);
+    if (optionsArg.isObject()) {
+        JSValue sharedGlobalValue = asObject(optionsArg)->get(globalObject, Identifier::fromString(vm, "sharedGlobal"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        sharedGlobal = sharedGlobalValue.toBoolean(globalObject);
+    }
+
+    JSGlobalProxy* proxy;
+    if (sharedGlobal) {
+        proxy = zigGlobalObject->vmModuleSharedContextProxy();
+    } else {
+        auto* targetContext = JSC::JSGlobalObject::create(
+            vm, zigGlobalObject->globalObjectStructure());
+
+        auto proxyStructure = zigGlobalObject->globalProxyStructure();
+        proxy = JSGlobalProxy::create(vm, proxyStructure);
+        proxy->setTarget(vm, targetContext);
+    }
+    JSC::JSGlobalObject* targetContext = proxy->target();
     context->setPrototypeDirect(vm, proxy);
 
     JSScope* contextScope = JSWithScope::create(vm, targetContext, targetContext->globalScope(), context);
@@ -0,0 +1,57 @@
+#include "root.h"
+#include "ParsedURLCache.h"
+
+namespace Bun {
+
+static thread_local ParsedURLCache* s_currentParsedURLCache = nullptr;
+
+ParsedURLCache::ParsedURLCache()
+{
+    s_currentParsedURLCache = this;
+}
+
+ParsedURLCache::~ParsedURLCache()
+{
+    if (s_currentParsedURLCache == this)
+        s_currentParsedURLCache = nullptr;
+}
+
+ParsedURLCache* ParsedURLCache::current()
+{
+    return s_currentParsedURLCache;
+}
+
+static ALWAYS_INLINE bool matches(const String& cached, const String& string)
+{
+    return cached.isNull() == string.isNull() && cached == string;
+}
+
+std::optional<URL> ParsedURLCache::find(const String& input, const String& base)
+{
+    if (input.length() > maxLength)
+        return std::nullopt;
+
+    for (size_t i = 0; i < m_size; i++) {
+        auto& entry = m_entries[i];
+        if (!matches(entry.input, input) || !matches(entry.base, base))
+            continue;
+        if (i)
+            std::rotate(m_entries.begin(), m_entries.begin() + i, m_entries.begin() + i + 1);
+        return m_entries[0].url;
+    }
+    return std::nullopt;
+}
+
+void ParsedURLCache::add(const String& input, const String& base, const URL& url)
+{
+    if (!url.isValid() || input.length() > maxLength || base.length() > maxLength)
+        return;
+
+    if (m_size < capacity)
+        m_size++;
+    // Drops the least recently used entry once full.
+    std::move_backward(m_entries.begin(), m_entries.begin() + m_size - 1, m_entries.begin() + m_size);
+    m_entries[0] = { input, base, url };
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/URL.h>
+
+namespace Bun {
+
+// The last few URLs `new URL()` parsed, most recent first.
+//
+// A server tends to parse the same handful of URLs (its own origin, the
+// upstreams it proxies to) on every request. WTF::URL is a string plus
+// component offsets, so a hit hands back a copy that shares the string and
+// skips URLParser entirely.
+//
+// One cache lives in each VM's client data, like AtomStringCache, so it
+// needs no locking.
+class ParsedURLCache {
+    WTF_MAKE_NONCOPYABLE(ParsedURLCache);
+
+public:
+    static constexpr size_t capacity = 16;
+    // Long inputs (data: URLs, mostly) rarely repeat and would just be
+    // kept alive here.
+    static constexpr unsigned maxLength = 2048;
+
+    ParsedURLCache();
+    ~ParsedURLCache();
+
+    // The cache of the VM running on this thread, if there is one.
+    static ParsedURLCache* current();
+
+    // `base` is null when the input was parsed without one, which is not
+    // the same as an empty base: that one fails to parse.
+    std::optional<URL> find(const String& input, const String& base);
+    // Only valid results are kept.
+    void add(const String& input, const String& base, const URL&);
+
+private:
+    struct Entry {
+        String input;
+        String base;
+        URL url;
+    };
+
+    std::array<Entry, capacity> m_entries;
+    size_t m_size { 0 };
+};
+
+}
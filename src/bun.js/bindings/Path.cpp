@@ -7,6 +7,10 @@
 #include <JavaScriptCore/JSFunction.h>
 #include <JavaScriptCore/JSMicrotask.h>
 #include <JavaScriptCore/ObjectConstructor.h>
+#include "DOMJITIDLConvert.h"
+#include "DOMJITIDLType.h"
+#include "DOMJITIDLTypeFilter.h"
+#include "IDLTypes.h"
 
 #pragma mark - Node.js Path
 
@@ -80,18 +84,290 @@ JSC_DEFINE_HOST_FUNCTION(Path_functionIsAbsolute,
     DEFINE_CALLBACK_FUNCTION_BODY(Bun__Path__isAbsolute);
 }
 
+#pragma mark - POSIX fast paths
+
+// join, normalize and resolve on posix with Latin-1 arguments, which is
+// nearly every call a bundler or resolver makes, are done here instead of
+// converting every argument to a BunString for Zig. The work happens in
+// scratch buffers kept per thread (so per VM) and a result that is the same
+// as its argument returns the argument itself. Anything else, including
+// the errors for arguments that are not strings, is still Zig's.
+
+// Node's normalizeString for POSIX separators, appending to `out`.
+static void normalizePosixPathSegments(std::span<const LChar> path, bool allowAboveRoot, Vector<LChar>& out)
+{
+    size_t start = out.size();
+    size_t lastSegmentLength = 0;
+    intptr_t lastSlash = -1;
+    int dots = 0;
+    LChar code = 0;
+    for (size_t i = 0; i <= path.size(); ++i) {
+        if (i < path.size())
+            code = path[i];
+        else if (code == '/')
+            break;
+        else
+            code = '/';
+
+        if (code == '/') {
+            if (lastSlash == static_cast<intptr_t>(i) - 1 || dots == 1) {
+                // An empty segment or ".".
+            } else if (dots == 2) {
+                size_t length = out.size() - start;
+                if (length < 2 || lastSegmentLength != 2 || out[out.size() - 1] != '.' || out[out.size() - 2] != '.') {
+                    if (length > 2) {
+                        size_t lastSlashIndex = notFound;
+                        for (size_t j = out.size(); j-- > start;) {
+                            if (out[j] == '/') {
+                                lastSlashIndex = j;
+                                break;
+                            }
+                        }
+                        if (lastSlashIndex == notFound) {
+                            out.shrink(start);
+                            lastSegmentLength = 0;
+                        } else {
+                            out.shrink(lastSlashIndex);
+                            size_t previousSlash = start;
+                            for (size_t j = out.size(); j-- > start;) {
+                                if (out[j] == '/') {
+                                    previousSlash = j + 1;
+                                    break;
+                                }
+                            }
+                            lastSegmentLength = out.size() - previousSlash;
+                        }
+                        lastSlash = i;
+                        dots = 0;
+                        continue;
+                    }
+                    if (length) {
+                        out.shrink(start);
+                        lastSegmentLength = 0;
+                        lastSlash = i;
+                        dots = 0;
+                        continue;
+                    }
+                }
+                if (allowAboveRoot) {
+                    if (out.size() > start)
+                        out.append('/');
+                    out.append('.');
+                    out.append('.');
+                    lastSegmentLength = 2;
+                }
+            } else {
+                if (out.size() > start)
+                    out.append('/');
+                out.append(path.subspan(lastSlash + 1, i - lastSlash - 1));
+                lastSegmentLength = i - lastSlash - 1;
+            }
+            lastSlash = i;
+            dots = 0;
+        } else if (code == '.' && dots != -1) {
+            ++dots;
+        } else {
+            dots = -1;
+        }
+    }
+}
+
+// path.posix.normalize.
+static void normalizePosixPath(std::span<const LChar> path, Vector<LChar>& out)
+{
+    if (path.empty()) {
+        out.append('.');
+        return;
+    }
+    bool isAbsolute = path[0] == '/';
+    bool trailingSeparator = path[path.size() - 1] == '/';
+    if (isAbsolute)
+        out.append('/');
+    size_t start = out.size();
+    normalizePosixPathSegments(path, !isAbsolute, out);
+    if (out.size() == start) {
+        if (isAbsolute)
+            return;
+        out.append('.');
+    }
+    if (trailingSeparator && !(isAbsolute && out.size() == start))
+        out.append('/');
+}
+
+static Vector<LChar>& pathScratchBuffer(unsigned index)
+{
+    static thread_local Vector<LChar> buffers[2];
+    auto& buffer = buffers[index];
+    buffer.shrink(0);
+    return buffer;
+}
+
+// Gives a buffer that grew past what paths need back to the allocator.
+static void releasePathScratchBuffer(Vector<LChar>& buffer)
+{
+    if (buffer.capacity() > 64 * 1024)
+        buffer.clear();
+}
+
+// The characters of a Latin-1 string argument, or nullopt for anything
+// else. Check for an exception after: resolving a rope can throw.
+static std::optional<String> latin1PathArgument(JSGlobalObject* globalObject, JSValue value)
+{
+    if (!value.isString())
+        return std::nullopt;
+    String string = asString(value)->value(globalObject);
+    if (string.isNull() || !string.is8Bit())
+        return std::nullopt;
+    return string;
+}
+
+static JSValue pathResult(JSC::VM& vm, JSValue input, const String& inputString, Vector<LChar>& output)
+{
+    JSValue result;
+    if (input && inputString.span8().size() == output.size() && !memcmp(inputString.span8().data(), output.data(), output.size()))
+        result = input;
+    else
+        result = jsString(vm, String(output.span()));
+    releasePathScratchBuffer(output);
+    return result;
+}
+
+// An empty JSValue when the fast path does not apply.
+static JSValue posixNormalize(JSGlobalObject* globalObject, JSValue pathValue)
+{
+    auto path = latin1PathArgument(globalObject, pathValue);
+    if (!path)
+        return {};
+    auto& output = pathScratchBuffer(0);
+    normalizePosixPath(path->span8(), output);
+    return pathResult(globalObject->vm(), pathValue, *path, output);
+}
+
+static JSValue posixJoin(JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    size_t count = callFrame->argumentCount();
+    if (count == 1)
+        RELEASE_AND_RETURN(scope, posixNormalize(globalObject, callFrame->uncheckedArgument(0)));
+
+    auto& joined = pathScratchBuffer(1);
+    for (size_t i = 0; i < count; i++) {
+        auto path = latin1PathArgument(globalObject, callFrame->uncheckedArgument(i));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!path)
+            return {};
+        if (path->isEmpty())
+            continue;
+        if (!joined.isEmpty())
+            joined.append('/');
+        joined.append(path->span8());
+    }
+
+    auto& output = pathScratchBuffer(0);
+    normalizePosixPath(joined.span(), output);
+    releasePathScratchBuffer(joined);
+    return pathResult(vm, {}, {}, output);
+}
+
+// Only when one of the arguments is absolute, so that the cwd is not needed.
+static JSValue posixResolve(JSGlobalObject* globalObject, JSC::CallFrame* callFrame)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    size_t count = callFrame->argumentCount();
+
+    // Like Node, from the last argument back to the last absolute one, and
+    // arguments before that are not looked at.
+    Vector<String, 8> paths;
+    bool isAbsolute = false;
+    for (size_t i = count; i-- > 0 && !isAbsolute;) {
+        auto path = latin1PathArgument(globalObject, callFrame->uncheckedArgument(i));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!path)
+            return {};
+        if (path->isEmpty())
+            continue;
+        isAbsolute = (*path)[0] == '/';
+        paths.append(WTFMove(*path));
+    }
+    if (!isAbsolute)
+        return {};
+
+    auto& joined = pathScratchBuffer(1);
+    for (size_t i = paths.size(); i-- > 0;) {
+        joined.append(paths[i].span8());
+        joined.append('/');
+    }
+
+    auto& output = pathScratchBuffer(0);
+    output.append('/');
+    normalizePosixPathSegments(joined.span(), false, output);
+    releasePathScratchBuffer(joined);
+    return pathResult(vm, paths.size() == 1 ? callFrame->uncheckedArgument(count - 1) : JSValue(), paths.size() == 1 ? paths[0] : String(), output);
+}
+
+static bool isPosixPathObject(JSC::VM& vm, JSC::JSObject* thisObject)
+{
+    JSValue isWindows = thisObject->getDirect(vm, WebCore::clientData(vm)->builtinNames().isWindowsPrivateName());
+    return isWindows && !isWindows.asBoolean();
+}
+
 JSC_DEFINE_HOST_FUNCTION(Path_functionJoin,
     (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
+    if (auto* thisObject = JSC::jsDynamicCast<JSC::JSFinalObject*>(callFrame->thisValue()); thisObject && callFrame->argumentCount() && isPosixPathObject(globalObject->vm(), thisObject)) {
+        auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+        JSValue result = posixJoin(globalObject, callFrame);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (result)
+            return JSValue::encode(result);
+    }
     DEFINE_CALLBACK_FUNCTION_BODY(Bun__Path__join);
 }
 
 JSC_DEFINE_HOST_FUNCTION(Path_functionNormalize,
     (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
+    if (auto* thisObject = JSC::jsDynamicCast<JSC::JSFinalObject*>(callFrame->thisValue()); thisObject && callFrame->argumentCount() && isPosixPathObject(globalObject->vm(), thisObject)) {
+        auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+        JSValue result = posixNormalize(globalObject, callFrame->uncheckedArgument(0));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (result)
+            return JSValue::encode(result);
+    }
     DEFINE_CALLBACK_FUNCTION_BODY(Bun__Path__normalize);
 }
 
+// path.normalize(string) from optimized code.
+JSC_DEFINE_JIT_OPERATION(Path_functionNormalizeWithoutTypeCheck, JSC::EncodedJSValue, (JSC::JSGlobalObject * globalObject, JSC::JSObject* thisObject, JSC::JSString* path))
+{
+    JSC::VM& vm = JSC::getVM(globalObject);
+    IGNORE_WARNINGS_BEGIN("frame-address")
+    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
+    IGNORE_WARNINGS_END
+    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    bool isPosix = isPosixPathObject(vm, thisObject);
+    if (isPosix) {
+        JSValue result = posixNormalize(globalObject, path);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (result)
+            return JSValue::encode(result);
+    }
+
+    JSC::EncodedJSValue argument = JSValue::encode(path);
+    RELEASE_AND_RETURN(scope, Bun__Path__normalize(globalObject, !isPosix, reinterpret_cast<JSC__JSValue*>(&argument), 1));
+}
+
+static const JSC::DOMJIT::Signature DOMJITSignatureForPathNormalize(
+    Path_functionNormalizeWithoutTypeCheck,
+    JSC::JSFinalObject::info(),
+    JSC::DOMJIT::Effect {},
+    WebCore::DOMJIT::IDLResultTypeFilter<WebCore::IDLDOMString>::value,
+    WebCore::DOMJIT::IDLArgumentTypeFilter<WebCore::IDLDOMString>::value);
+
 JSC_DEFINE_HOST_FUNCTION(Path_functionParse,
     (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
@@ -107,6 +383,13 @@ JSC_DEFINE_HOST_FUNCTION(Path_functionRelative,
 JSC_DEFINE_HOST_FUNCTION(Path_functionResolve,
     (JSC::JSGlobalObject * globalObject, JSC::CallFrame* callFrame))
 {
+    if (auto* thisObject = JSC::jsDynamicCast<JSC::JSFinalObject*>(callFrame->thisValue()); thisObject && isPosixPathObject(globalObject->vm(), thisObject)) {
+        auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+        JSValue result = posixResolve(globalObject, callFrame);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (result)
+            return JSValue::encode(result);
+    }
     DEFINE_CALLBACK_FUNCTION_BODY(Bun__Path__resolve);
 }
 
@@ -152,7 +435,8 @@ static JSC::JSObject* createPath(JSGlobalObject* globalThis, bool isWindows)
         0);
     path->putDirect(vm, clientData->builtinNames().normalizePublicName(),
         JSC::JSFunction::create(vm, JSC::jsCast<JSC::JSGlobalObject*>(globalThis), 0,
-            "normalize"_s, Path_functionNormalize, ImplementationVisibility::Public),
+            "normalize"_s, Path_functionNormalize, ImplementationVisibility::Public, NoIntrinsic, Path_functionNormalize,
+            &DOMJITSignatureForPathNormalize),
         0);
     path->putDirect(vm, clientData->builtinNames().parsePublicName(),
         JSC::JSFunction::create(vm, JSC::jsCast<JSC::JSGlobalObject*>(globalThis), 0,
@@ -0,0 +1,188 @@
+#include "root.h"
+#include "PluginFilter.h"
+
+#include <wtf/ASCIICType.h>
+#include <wtf/Vector.h>
+
+namespace Bun {
+
+namespace {
+
+enum class TokenType : uint8_t {
+    Literal,
+    Quantifier,
+    Start,
+    End,
+    Other,
+};
+
+struct Token {
+    TokenType type;
+    LChar character { 0 };
+};
+
+}
+
+static bool isSyntaxCharacter(UChar c)
+{
+    switch (c) {
+    case '^':
+    case '$':
+    case '\\':
+    case '.':
+    case '*':
+    case '+':
+    case '?':
+    case '(':
+    case ')':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case '|':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Moves past a class, with `i` just after its [.
+static bool skipClass(StringView pattern, unsigned& i)
+{
+    while (i < pattern.length()) {
+        UChar c = pattern[i++];
+        if (c == '\\')
+            i++;
+        else if (c == ']')
+            return true;
+    }
+    return false;
+}
+
+// Splits the top level of a pattern into atoms, with groups and classes as
+// one atom each. Returns false for a top-level alternative, which leaves no
+// affix, or for anything it does not follow.
+static bool tokenize(StringView pattern, Vector<Token, 32>& tokens)
+{
+    unsigned length = pattern.length();
+    unsigned i = 0;
+    while (i < length) {
+        UChar c = pattern[i++];
+        switch (c) {
+        case '\\': {
+            if (i == length)
+                return false;
+            UChar escaped = pattern[i++];
+            if (isSyntaxCharacter(escaped) || escaped == '/' || escaped == '-') {
+                tokens.append({ TokenType::Literal, static_cast<LChar>(escaped) });
+                break;
+            }
+            // \d, \x2e, \u{1F600}, \p{L}, \k<name> and backreferences. What
+            // follows may belong to them, so it goes too: at worst an affix
+            // comes out shorter.
+            while (i < length && (isASCIIAlphanumeric(pattern[i]) || pattern[i] == '{' || pattern[i] == '}' || pattern[i] == '<' || pattern[i] == '>' || pattern[i] == '_'))
+                i++;
+            tokens.append({ TokenType::Other });
+            break;
+        }
+        case '[':
+            if (!skipClass(pattern, i))
+                return false;
+            tokens.append({ TokenType::Other });
+            break;
+        case '(': {
+            unsigned depth = 1;
+            while (i < length && depth) {
+                UChar inner = pattern[i++];
+                if (inner == '\\')
+                    i++;
+                else if (inner == '[') {
+                    if (!skipClass(pattern, i))
+                        return false;
+                } else if (inner == '(')
+                    depth++;
+                else if (inner == ')')
+                    depth--;
+            }
+            if (depth)
+                return false;
+            tokens.append({ TokenType::Other });
+            break;
+        }
+        case '{':
+            while (i < length && pattern[i++] != '}') { }
+            tokens.append({ TokenType::Quantifier });
+            break;
+        case '*':
+        case '+':
+        case '?':
+            tokens.append({ TokenType::Quantifier });
+            break;
+        case '|':
+            return false;
+        case '^':
+            tokens.append({ TokenType::Start });
+            break;
+        case '$':
+            tokens.append({ TokenType::End });
+            break;
+        default:
+            if (isASCIIPrintable(c) && !isSyntaxCharacter(c))
+                tokens.append({ TokenType::Literal, static_cast<LChar>(c) });
+            else
+                tokens.append({ TokenType::Other });
+            break;
+        }
+    }
+    return true;
+}
+
+PluginFilterAffixes::PluginFilterAffixes(StringView pattern, OptionSet<JSC::Yarr::Flags> flags)
+{
+    if (flags.containsAny({ JSC::Yarr::Flags::IgnoreCase, JSC::Yarr::Flags::Multiline, JSC::Yarr::Flags::UnicodeSets }))
+        return;
+
+    Vector<Token, 32> tokens;
+    if (!tokenize(pattern, tokens) || tokens.isEmpty())
+        return;
+
+    // A literal followed by a quantifier may not be there at all, so each
+    // affix stops at the first one.
+    if (tokens.first().type == TokenType::Start) {
+        Vector<LChar, 32> prefix;
+        for (size_t i = 1; i < tokens.size() && tokens[i].type == TokenType::Literal; i++) {
+            if (i + 1 < tokens.size() && tokens[i + 1].type == TokenType::Quantifier)
+                break;
+            prefix.append(tokens[i].character);
+        }
+        m_prefix = String(std::span<const LChar> { prefix.data(), prefix.size() });
+    }
+
+    if (tokens.last().type == TokenType::End) {
+        size_t begin = tokens.size() - 1;
+        while (begin > 0 && tokens[begin - 1].type == TokenType::Literal)
+            begin--;
+        Vector<LChar, 32> suffix;
+        for (size_t i = begin; i < tokens.size() - 1; i++)
+            suffix.append(tokens[i].character);
+        m_suffix = String(std::span<const LChar> { suffix.data(), suffix.size() });
+    }
+}
+
+bool canCombinePluginFilter(StringView pattern)
+{
+    unsigned length = pattern.length();
+    for (unsigned i = 0; i + 1 < length; i++) {
+        UChar c = pattern[i];
+        UChar next = pattern[i + 1];
+        if (c == '\\') {
+            if ((next >= '1' && next <= '9') || next == 'k')
+                return false;
+            i++;
+        } else if (c == '(' && next == '?' && i + 3 < length && pattern[i + 2] == '<' && pattern[i + 3] != '=' && pattern[i + 3] != '!')
+            return false;
+    }
+    return true;
+}
+
+} // namespace Bun
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "root.h"
+#include <JavaScriptCore/YarrFlags.h>
+#include <wtf/OptionSet.h>
+#include <wtf/text/StringView.h>
+#include <wtf/text/WTFString.h>
+
+namespace Bun {
+
+// What every match of a plugin's filter has to start and end with, read
+// off the pattern once when the filter is added. Most plugins filter on an
+// extension, like /\.svg$/, so most paths are turned down by comparing a
+// few characters instead of running the filter.
+//
+// Only ASCII literals next to a ^ or $ are used, and none at all for
+// ignoreCase, multiline and unicodeSets patterns or ones with a top-level
+// alternative, so mayMatch() never turns down a path the filter matches.
+class PluginFilterAffixes {
+public:
+    PluginFilterAffixes() = default;
+    PluginFilterAffixes(StringView pattern, OptionSet<JSC::Yarr::Flags>);
+
+    // Safe to call from any thread.
+    bool mayMatch(StringView path) const
+    {
+        return (m_prefix.isEmpty() || path.startsWith(StringView(m_prefix)))
+            && (m_suffix.isEmpty() || path.endsWith(StringView(m_suffix)));
+    }
+
+    const String& prefix() const { return m_prefix; }
+    const String& suffix() const { return m_suffix; }
+
+private:
+    String m_prefix;
+    String m_suffix;
+};
+
+// Whether a pattern can be joined with others as (?:a)|(?:b) and still
+// match the same paths: its groups must not be referred to by number or
+// by name, which would change or clash once they share a pattern.
+bool canCombinePluginFilter(StringView pattern);
+
+} // namespace Bun
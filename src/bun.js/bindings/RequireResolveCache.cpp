@@ -0,0 +1,71 @@
+#include "root.h"
+#include "RequireResolveCache.h"
+
+#include <wtf/text/StringBuilder.h>
+
+namespace Bun {
+
+// Resolving only looks at the directory of the importing file, so every file
+// in a directory shares its entries.
+static StringView directoryOf(const String& from)
+{
+    size_t separator = from.reverseFind('/');
+#if OS(WINDOWS)
+    size_t backslash = from.reverseFind('\\');
+    if (backslash != notFound && (separator == notFound || backslash > separator))
+        separator = backslash;
+#endif
+    // Not a path (bun:main, a data: URL, ...): keep it whole.
+    if (separator == notFound)
+        return from;
+    return StringView(from).left(separator + 1);
+}
+
+static String makeKey(bool isESM, const String& specifier, const String& from)
+{
+    StringBuilder key;
+    key.append(isESM ? 'i' : 'r');
+    key.append(directoryOf(from));
+    key.append('\0');
+    key.append(specifier);
+    return key.toString();
+}
+
+JSC::JSValue RequireResolveCache::find(bool isESM, const String& specifier, const String& from, bool& failed)
+{
+    auto it = m_entries.find(makeKey(isESM, specifier, from));
+    if (it == m_entries.end()) {
+        m_statistics.misses++;
+        return {};
+    }
+
+    auto& entry = it->value;
+    if (entry.failed) {
+        if (entry.expiresAt <= MonotonicTime::now()) {
+            m_entries.remove(it);
+            m_statistics.misses++;
+            return {};
+        }
+        m_statistics.failureHits++;
+    } else {
+        m_statistics.hits++;
+    }
+
+    failed = entry.failed;
+    return entry.value.get();
+}
+
+void RequireResolveCache::add(JSC::VM& vm, bool isESM, const String& specifier, const String& from, JSC::JSValue result)
+{
+    if (m_entries.size() >= maxSize)
+        m_entries.clear();
+
+    bool failed = !result.isString();
+    m_entries.set(makeKey(isESM, specifier, from), Entry {
+                                                       JSC::Strong<JSC::Unknown> { vm, result },
+                                                       failed,
+                                                       failed ? MonotonicTime::now() + failureLifetime : MonotonicTime::infinity(),
+                                                   });
+}
+
+}
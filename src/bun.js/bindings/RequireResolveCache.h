@@ -0,0 +1,64 @@
+#pragma once
+
+#include "root.h"
+#include <JavaScriptCore/Strong.h>
+#include <wtf/HashMap.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/WTFString.h>
+
+namespace Bun {
+
+// What require() and require.resolve() resolved each specifier to, keyed by
+// the directory it was resolved from, like Node's Module._pathCache.
+//
+// Every file in a package tends to require the same handful of packages, and
+// each miss walks the node_modules directories up to the root, so most of the
+// stat() calls at startup answer a question that was already answered.
+//
+// Failures are kept too, as the value that was thrown, since optional
+// dependencies are probed with try { require() } over and over. Unlike a
+// resolved path, a missing file may show up at any moment, so those entries
+// only last `failureLifetime`.
+//
+// One cache lives on each global object, so it needs no locking. It is only
+// used while there are no onResolve plugins, whose answers may change from
+// one call to the next.
+class RequireResolveCache {
+    WTF_MAKE_NONCOPYABLE(RequireResolveCache);
+
+public:
+    static constexpr Seconds failureLifetime = 1_s;
+    // Past this the cache starts over, rather than tracking recency.
+    static constexpr unsigned maxSize = 16384;
+
+    RequireResolveCache() = default;
+
+    struct Statistics {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t failureHits { 0 };
+    };
+
+    // The resolved path, or what was thrown when `failed` is set. Empty on a
+    // miss.
+    JSC::JSValue find(bool isESM, const String& specifier, const String& from, bool& failed);
+    void add(JSC::VM&, bool isESM, const String& specifier, const String& from, JSC::JSValue result);
+    void clear() { m_entries.clear(); }
+
+    const Statistics& statistics() const { return m_statistics; }
+    unsigned size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        // The resolved path as a JSString, so hits do not allocate one, or
+        // what was thrown.
+        JSC::Strong<JSC::Unknown> value;
+        bool failed { false };
+        MonotonicTime expiresAt;
+    };
+
+    HashMap<String, Entry> m_entries;
+    Statistics m_statistics;
+};
+
+}
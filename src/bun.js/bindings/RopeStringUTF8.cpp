@@ -0,0 +1,270 @@
+#include "root.h"
+#include "RopeStringUTF8.h"
+
+#include "simdutf.h"
+
+namespace Bun {
+
+static constexpr uint8_t replacementCharacter[] = { 0xEF, 0xBF, 0xBD };
+
+static size_t utf8LengthOfUTF16(const char16_t* characters, size_t length)
+{
+    if (simdutf::validate_utf16le(characters, length))
+        return simdutf::utf8_length_from_utf16le(characters, length);
+
+    size_t total = 0;
+    for (size_t i = 0; i < length; i++) {
+        char16_t c = characters[i];
+        if (c < 0x80) {
+            total += 1;
+        } else if (c < 0x800) {
+            total += 2;
+        } else if (U16_IS_LEAD(c) && i + 1 < length && U16_IS_TRAIL(characters[i + 1])) {
+            total += 4;
+            i++;
+        } else {
+            total += 3;
+        }
+    }
+    return total;
+}
+
+size_t utf8LengthOfFibers(std::span<const StringFiber> fibers)
+{
+    size_t total = 0;
+    bool pendingLead = false;
+
+    for (const auto& fiber : fibers) {
+        if (!fiber.length)
+            continue;
+
+        if (fiber.is8Bit) {
+            pendingLead = false;
+            total += simdutf::utf8_length_from_latin1(static_cast<const char*>(fiber.characters), fiber.length);
+            continue;
+        }
+
+        const char16_t* characters = static_cast<const char16_t*>(fiber.characters);
+        size_t start = 0;
+        size_t end = fiber.length;
+
+        // A lead surrogate ending the previous fiber was counted as U+FFFD (3
+        // bytes). Paired with this trail it is one 4 byte character instead.
+        if (pendingLead && U16_IS_TRAIL(characters[0])) {
+            total += 1;
+            start = 1;
+        }
+        pendingLead = false;
+
+        bool endsWithLead = end > start && U16_IS_LEAD(characters[end - 1]);
+        if (endsWithLead)
+            end--;
+
+        total += utf8LengthOfUTF16(characters + start, end - start);
+
+        if (endsWithLead) {
+            total += 3;
+            pendingLead = true;
+        }
+    }
+
+    return total;
+}
+
+class UTF8Writer {
+public:
+    explicit UTF8Writer(std::span<uint8_t> output)
+        : m_output(output)
+    {
+    }
+
+    size_t written() const { return m_position; }
+    size_t remaining() const { return m_output.size() - m_position; }
+    uint8_t* head() { return m_output.data() + m_position; }
+    void advance(size_t length) { m_position += length; }
+
+    // Returns false once a character does not fit; nothing after it is written.
+    bool append(UChar32 codePoint)
+    {
+        uint8_t bytes[4];
+        size_t length = 0;
+        if (codePoint < 0x80) {
+            bytes[length++] = static_cast<uint8_t>(codePoint);
+        } else if (codePoint < 0x800) {
+            bytes[length++] = static_cast<uint8_t>(0xC0 | (codePoint >> 6));
+            bytes[length++] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            bytes[length++] = static_cast<uint8_t>(0xE0 | (codePoint >> 12));
+            bytes[length++] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+            bytes[length++] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+        } else {
+            bytes[length++] = static_cast<uint8_t>(0xF0 | (codePoint >> 18));
+            bytes[length++] = static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+            bytes[length++] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+            bytes[length++] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+        }
+
+        if (length > remaining())
+            return false;
+        memcpy(head(), bytes, length);
+        advance(length);
+        return true;
+    }
+
+    bool appendReplacement()
+    {
+        if (remaining() < sizeof(replacementCharacter))
+            return false;
+        memcpy(head(), replacementCharacter, sizeof(replacementCharacter));
+        advance(sizeof(replacementCharacter));
+        return true;
+    }
+
+    bool appendLatin1(const LChar* characters, size_t length)
+    {
+        if (simdutf::utf8_length_from_latin1(reinterpret_cast<const char*>(characters), length) <= remaining()) {
+            advance(simdutf::convert_latin1_to_utf8(reinterpret_cast<const char*>(characters), length, reinterpret_cast<char*>(head())));
+            return true;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            if (!append(characters[i]))
+                return false;
+        }
+        return true;
+    }
+
+    bool appendUTF16(const char16_t* characters, size_t length)
+    {
+        if (simdutf::validate_utf16le(characters, length) && simdutf::utf8_length_from_utf16le(characters, length) <= remaining()) {
+            advance(simdutf::convert_valid_utf16le_to_utf8(characters, length, reinterpret_cast<char*>(head())));
+            return true;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            char16_t c = characters[i];
+            bool fits;
+            if (U16_IS_LEAD(c) && i + 1 < length && U16_IS_TRAIL(characters[i + 1])) {
+                fits = append(U16_GET_SUPPLEMENTARY(c, characters[i + 1]));
+                i++;
+            } else if (U16_IS_SURROGATE(c)) {
+                fits = appendReplacement();
+            } else {
+                fits = append(c);
+            }
+
+            if (!fits)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    std::span<uint8_t> m_output;
+    size_t m_position { 0 };
+};
+
+size_t writeFibersAsUTF8(std::span<const StringFiber> fibers, std::span<uint8_t> output)
+{
+    UTF8Writer writer(output);
+    std::optional<char16_t> pendingLead;
+
+    for (const auto& fiber : fibers) {
+        if (!fiber.length)
+            continue;
+
+        if (fiber.is8Bit) {
+            if (pendingLead && !writer.appendReplacement())
+                return writer.written();
+            pendingLead.reset();
+
+            if (!writer.appendLatin1(static_cast<const LChar*>(fiber.characters), fiber.length))
+                return writer.written();
+            continue;
+        }
+
+        const char16_t* characters = static_cast<const char16_t*>(fiber.characters);
+        size_t start = 0;
+        size_t end = fiber.length;
+
+        if (pendingLead) {
+            bool fits;
+            if (U16_IS_TRAIL(characters[0])) {
+                fits = writer.append(U16_GET_SUPPLEMENTARY(*pendingLead, characters[0]));
+                start = 1;
+            } else {
+                fits = writer.appendReplacement();
+            }
+            if (!fits)
+                return writer.written();
+            pendingLead.reset();
+        }
+
+        // Hold a trailing lead surrogate back until we know what follows it.
+        if (end > start && U16_IS_LEAD(characters[end - 1]))
+            pendingLead = characters[--end];
+
+        if (!writer.appendUTF16(characters + start, end - start))
+            return writer.written();
+    }
+
+    if (pendingLead)
+        writer.appendReplacement();
+
+    return writer.written();
+}
+
+static void appendFiber8(jsstring_iterator* iterator, const LChar* characters, uint32_t length, uint32_t offset)
+{
+    static_cast<Vector<StringFiber, 16>*>(iterator->data)->append({ offset, length, characters, true });
+}
+
+static void appendFiber16(jsstring_iterator* iterator, const UChar* characters, uint32_t length, uint32_t offset)
+{
+    static_cast<Vector<StringFiber, 16>*>(iterator->data)->append({ offset, length, characters, false });
+}
+
+// Lists the flat pieces of the string without resolving it. The pointers stay
+// valid as long as the string does and nothing allocates.
+static void collectFibers(JSC::JSGlobalObject* globalObject, JSC::JSString* string, Vector<StringFiber, 16>& fibers)
+{
+    if (!string->isRope()) {
+        const auto& view = string->tryGetValue(globalObject);
+        if (view.is8Bit())
+            fibers.append({ 0, view.length(), view.span8().data(), true });
+        else
+            fibers.append({ 0, view.length(), view.span16().data(), false });
+        return;
+    }
+
+    jsstring_iterator iterator {
+        &fibers,
+        0,
+        [](jsstring_iterator* iterator, const LChar* characters, uint32_t length) { appendFiber8(iterator, characters, length, 0); },
+        [](jsstring_iterator* iterator, const UChar* characters, uint32_t length) { appendFiber16(iterator, characters, length, 0); },
+        appendFiber8,
+        appendFiber16,
+    };
+    string->value(&iterator);
+
+    // Fibers are reported with their offset, not necessarily in order.
+    std::sort(fibers.begin(), fibers.end(), [](const StringFiber& a, const StringFiber& b) {
+        return a.offset < b.offset;
+    });
+}
+
+size_t utf8LengthOfString(JSC::JSGlobalObject* globalObject, JSC::JSString* string)
+{
+    Vector<StringFiber, 16> fibers;
+    collectFibers(globalObject, string, fibers);
+    return utf8LengthOfFibers(std::span { fibers.data(), fibers.size() });
+}
+
+size_t writeStringAsUTF8(JSC::JSGlobalObject* globalObject, JSC::JSString* string, std::span<uint8_t> output)
+{
+    Vector<StringFiber, 16> fibers;
+    collectFibers(globalObject, string, fibers);
+    return writeFibersAsUTF8(std::span { fibers.data(), fibers.size() }, output);
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// One flat piece of a string, `offset` code units from its start.
+struct StringFiber {
+    uint32_t offset;
+    uint32_t length;
+    const void* characters;
+    bool is8Bit;
+};
+
+// UTF-8 over a list of fibers sorted by offset, treating them as one string.
+// Surrogate pairs split across fibers are joined, lone surrogates become
+// U+FFFD, matching what encoding the flattened string would produce.
+size_t utf8LengthOfFibers(std::span<const StringFiber> fibers);
+
+// Writes as many whole characters as fit and returns the bytes written.
+size_t writeFibersAsUTF8(std::span<const StringFiber> fibers, std::span<uint8_t> output);
+
+// Convenience wrappers that walk a rope's fibers in place instead of
+// resolving it into one flat string first. They work on flat strings too.
+size_t utf8LengthOfString(JSC::JSGlobalObject*, JSC::JSString*);
+size_t writeStringAsUTF8(JSC::JSGlobalObject*, JSC::JSString*, std::span<uint8_t> output);
+
+}
@@ -4,6 +4,7 @@
 #include "MessagePort.h"
 
 #include "webcore/WebSocket.h"
+#include "webcore/Worker.h"
 #include "libusockets.h"
 #include "_libusockets.h"
 #include "BunClientData.h"
@@ -88,12 +89,22 @@ ScriptExecutionContext::~ScriptExecutionContext()
         ASSERT_WITH_MESSAGE(!allScriptExecutionContextsMap().contains(m_identifier), "A ScriptExecutionContext subclass instance implementing postTask should have already removed itself from the map");
     }
 
+    Worker::discardPrewarmed(m_identifier);
+
     auto postMessageCompletionHandlers = WTFMove(m_processMessageWithMessagePortsSoonHandlers);
     for (auto& completionHandler : postMessageCompletionHandlers)
         completionHandler();
 
     while (auto* destructionObserver = m_destructionObservers.takeAny())
         destructionObserver->contextDestroyed();
+
+    // Nothing is left to run these on.
+    auto* task = m_concurrentTasks.exchange(nullptr, std::memory_order_acquire);
+    while (task) {
+        auto* next = task->m_nextConcurrentTask;
+        delete task;
+        task = next;
+    }
 }
 
 bool ScriptExecutionContext::postTaskTo(ScriptExecutionContextIdentifier identifier, Function<void(ScriptExecutionContext&)>&& task)
@@ -312,8 +323,43 @@ ScriptExecutionContext* executionContext(JSC::JSGlobalObject* globalObject)
 
 void ScriptExecutionContext::postTaskConcurrently(Function<void(ScriptExecutionContext&)>&& lambda)
 {
-    auto* task = new EventLoopTask(WTFMove(lambda));
-    reinterpret_cast<Zig::GlobalObject*>(m_globalObject)->queueTaskConcurrently(task);
+    postTaskConcurrently(new EventLoopTask(WTFMove(lambda)));
+}
+
+void ScriptExecutionContext::postTaskConcurrently(EventLoopTask* task)
+{
+    auto* head = m_concurrentTasks.load(std::memory_order_relaxed);
+    do {
+        task->m_nextConcurrentTask = head;
+    } while (!m_concurrentTasks.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+
+    // Only the task that finds the inbox empty wakes the loop. Until the
+    // drain takes the inbox, the tasks after it just join the batch.
+    if (!head) {
+        reinterpret_cast<Zig::GlobalObject*>(m_globalObject)->queueTaskConcurrently(new EventLoopTask([](ScriptExecutionContext& context) {
+            context.drainConcurrentTasks();
+        }));
+    }
+}
+
+void ScriptExecutionContext::drainConcurrentTasks()
+{
+    auto* task = m_concurrentTasks.exchange(nullptr, std::memory_order_acquire);
+
+    // Newest first, so turned around to run them in the order they came.
+    EventLoopTask* oldest = nullptr;
+    while (task) {
+        auto* next = task->m_nextConcurrentTask;
+        task->m_nextConcurrentTask = oldest;
+        oldest = task;
+        task = next;
+    }
+
+    while (oldest) {
+        auto* next = oldest->m_nextConcurrentTask;
+        oldest->performTask(*this);
+        oldest = next;
+    }
 }
 // Executes the task on context's thread asynchronously.
 void ScriptExecutionContext::postTask(Function<void(ScriptExecutionContext&)>&& lambda)
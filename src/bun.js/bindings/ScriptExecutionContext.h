@@ -13,6 +13,7 @@
 #include <wtf/CompletionHandler.h>
 #include "CachedScript.h"
 #include <wtf/URL.h>
+#include <atomic>
 
 namespace uWS {
 template<bool isServer, bool isClient, typename UserData>
@@ -66,6 +67,11 @@ public:
 protected:
     Function<void(ScriptExecutionContext&)> m_task;
     bool m_isCleanupTask;
+
+private:
+    friend class ScriptExecutionContext;
+    // Link in the inbox of postTaskConcurrently().
+    EventLoopTask* m_nextConcurrentTask { nullptr };
 };
 
 using ScriptExecutionContextIdentifier = uint32_t;
@@ -165,7 +171,11 @@ public:
     void addToContextsMap();
     void removeFromContextsMap();
 
+    // Executes the task on context's thread asynchronously. Safe to call from
+    // any thread: tasks queue up in an inbox, and the context's thread is
+    // woken once for however many arrive before it gets to them.
     void postTaskConcurrently(Function<void(ScriptExecutionContext&)>&& lambda);
+    void postTaskConcurrently(EventLoopTask* task);
     // Executes the task on context's thread asynchronously.
     void postTask(Function<void(ScriptExecutionContext&)>&& lambda);
     // Executes the task on context's thread asynchronously.
@@ -210,6 +220,11 @@ private:
 
     bool m_willProcessMessageWithMessagePortsSoon { false };
 
+    void drainConcurrentTasks();
+    // Pushed to by any thread, newest first, and taken whole by the
+    // context's thread.
+    std::atomic<EventLoopTask*> m_concurrentTasks { nullptr };
+
     us_socket_context_t* webSocketContextSSL();
     us_socket_context_t* webSocketContextNoSSL();
     us_socket_context_t* connectedWebSocketKindClientSSL();
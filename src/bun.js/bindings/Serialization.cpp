@@ -1,9 +1,14 @@
 #include "root.h"
+#include "Serialization.h"
 #include "headers-handwritten.h"
 #include "ExceptionOr.h"
 #include "MessagePort.h"
 #include "SerializedScriptValue.h"
 #include "JSDOMExceptionHandling.h"
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSArrayBufferView.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/ObjectConstructor.h>
 
 using namespace JSC;
 using namespace WebCore;
@@ -56,4 +61,253 @@ extern "C" EncodedJSValue Bun__JSValue__deserialize(JSGlobalObject* globalObject
     /// ?! did i just give ownership of these bytes to JSC?
     auto scriptValue = SerializedScriptValue::createFromWireBytes(WTFMove(vector));
     return JSValue::encode(scriptValue->deserialize(*globalObject, globalObject));
-}
\ No newline at end of file
+}
+
+namespace Bun {
+
+// Lazy array: <magic:uint32_t> <count:uint32_t> <offsets:uint64_t[count + 1]>
+// followed by the wire bytes of each element back to back; element i spans
+// [offsets[i], offsets[i + 1]) counted from the end of the table. Little
+// endian, like the wire format itself. The magic can never be mistaken for a
+// wire format version.
+static constexpr uint32_t lazyArrayMagic = 0x31415342; // "BSA1"
+
+static size_t lazyArrayHeaderSize(size_t count)
+{
+    return 2 * sizeof(uint32_t) + (count + 1) * sizeof(uint64_t);
+}
+
+static RefPtr<SerializedScriptValue> serializeForStorage(JSGlobalObject* globalObject, ThrowScope& scope, JSValue value)
+{
+    Vector<RefPtr<MessagePort>> dummyPorts;
+    auto serialized = SerializedScriptValue::create(*globalObject, value, {}, dummyPorts, SerializationForStorage::Yes);
+    if (serialized.hasException()) {
+        WebCore::propagateException(*globalObject, scope, serialized.releaseException());
+        return nullptr;
+    }
+    return serialized.releaseReturnValue();
+}
+
+static RefPtr<SerializedScriptValue> serializeLazyArray(JSGlobalObject* globalObject, ThrowScope& scope, JSArray* array)
+{
+    unsigned length = array->length();
+    Vector<Ref<SerializedScriptValue>> elements;
+    elements.reserveInitialCapacity(length);
+    size_t payloadSize = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        JSValue element = array->getIndex(globalObject, i);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+        auto serialized = serializeForStorage(globalObject, scope, element);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+        payloadSize += serialized->wireBytes().size();
+        elements.append(serialized.releaseNonNull());
+    }
+
+    Vector<uint8_t> bytes;
+    bytes.reserveInitialCapacity(lazyArrayHeaderSize(length) + payloadSize);
+    auto append = [&](auto value) {
+        bytes.append(std::span { reinterpret_cast<const uint8_t*>(&value), sizeof(value) });
+    };
+    append(lazyArrayMagic);
+    append(static_cast<uint32_t>(length));
+    uint64_t offset = 0;
+    append(offset);
+    for (auto& element : elements) {
+        offset += element->wireBytes().size();
+        append(offset);
+    }
+    for (auto& element : elements)
+        bytes.appendVector(element->wireBytes());
+
+    return SerializedScriptValue::createFromWireBytes(WTFMove(bytes));
+}
+
+// Writes the bytes a piece at a time into buffers the caller hands over.
+class SerializedValueReader : public RefCounted<SerializedValueReader> {
+public:
+    static Ref<SerializedValueReader> create(Ref<SerializedScriptValue>&& value) { return adoptRef(*new SerializedValueReader(WTFMove(value))); }
+
+    size_t byteLength() const { return m_value->wireBytes().size(); }
+
+    size_t readInto(std::span<uint8_t> destination)
+    {
+        auto remaining = m_value->wireBytes().span().subspan(m_offset);
+        size_t count = std::min(remaining.size(), destination.size());
+        memcpy(destination.data(), remaining.data(), count);
+        m_offset += count;
+        return count;
+    }
+
+private:
+    explicit SerializedValueReader(Ref<SerializedScriptValue>&& value)
+        : m_value(WTFMove(value))
+    {
+    }
+
+    Ref<SerializedScriptValue> m_value;
+    size_t m_offset { 0 };
+};
+
+static JSObject* createSerializedValueStream(JSGlobalObject* globalObject, Ref<SerializedScriptValue>&& value)
+{
+    auto& vm = globalObject->vm();
+    auto reader = SerializedValueReader::create(WTFMove(value));
+
+    JSObject* result = constructEmptyObject(globalObject, globalObject->objectPrototype(), 2);
+    result->putDirect(vm, Identifier::fromString(vm, "byteLength"_s), jsNumber(reader->byteLength()), PropertyAttribute::ReadOnly | 0);
+    result->putDirect(vm, Identifier::fromString(vm, "readInto"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "readInto"_s, [reader = RefPtr { reader.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+            auto* view = jsDynamicCast<JSArrayBufferView*>(callFrame->argument(0));
+            if (UNLIKELY(!view)) {
+                throwTypeError(globalObject, scope, "readInto expects a TypedArray or DataView"_s);
+                return {};
+            }
+            if (UNLIKELY(view->isDetached())) {
+                throwTypeError(globalObject, scope, "readInto cannot write into a detached buffer"_s);
+                return {};
+            }
+            return JSValue::encode(jsNumber(reader->readInto({ static_cast<uint8_t*>(view->vector()), view->byteLength() })));
+        }),
+        0);
+    return result;
+}
+
+JSC_DEFINE_HOST_FUNCTION(functionBunSerialize, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue value = callFrame->argument(0);
+    bool stream = false;
+    bool lazy = false;
+    if (auto* options = callFrame->argument(1).getObject()) {
+        JSValue streamValue = options->get(globalObject, Identifier::fromString(vm, "stream"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        stream = streamValue.toBoolean(globalObject);
+        JSValue lazyValue = options->get(globalObject, Identifier::fromString(vm, "lazy"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        lazy = lazyValue.toBoolean(globalObject);
+    } else if (!callFrame->argument(1).isUndefined()) {
+        throwTypeError(globalObject, scope, "Bun.serialize expects options to be an object"_s);
+        return {};
+    }
+
+    RefPtr<SerializedScriptValue> serialized;
+    if (lazy) {
+        auto* array = jsDynamicCast<JSArray*>(value);
+        if (UNLIKELY(!array)) {
+            throwTypeError(globalObject, scope, "Bun.serialize with lazy: true expects an array"_s);
+            return {};
+        }
+        serialized = serializeLazyArray(globalObject, scope, array);
+    } else
+        serialized = serializeForStorage(globalObject, scope, value);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    if (stream)
+        return JSValue::encode(createSerializedValueStream(globalObject, serialized.releaseNonNull()));
+
+    auto& bytes = serialized->wireBytes();
+    auto* result = JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(TypeUint8, false), bytes.size());
+    RETURN_IF_EXCEPTION(scope, {});
+    memcpy(result->typedVector(), bytes.data(), bytes.size());
+    return JSValue::encode(result);
+}
+
+static JSValue deserializeLazyArray(JSGlobalObject* globalObject, ThrowScope& scope, Ref<ArrayBuffer>&& buffer, size_t byteOffset, size_t byteLength)
+{
+    auto& vm = globalObject->vm();
+    auto invalid = [&] {
+        throwTypeError(globalObject, scope, "Bun.deserialize was given a corrupt lazy array"_s);
+        return JSValue();
+    };
+
+    std::span<const uint8_t> bytes { static_cast<const uint8_t*>(buffer->data()) + byteOffset, byteLength };
+    if (bytes.size() < lazyArrayHeaderSize(0))
+        return invalid();
+    uint32_t count;
+    memcpy(&count, bytes.data() + sizeof(uint32_t), sizeof(count));
+    size_t headerSize = lazyArrayHeaderSize(count);
+    if (bytes.size() < headerSize)
+        return invalid();
+    uint64_t payloadSize;
+    memcpy(&payloadSize, bytes.data() + headerSize - sizeof(uint64_t), sizeof(payloadSize));
+    if (payloadSize != bytes.size() - headerSize)
+        return invalid();
+
+    JSObject* result = constructEmptyObject(globalObject, globalObject->objectPrototype(), 2);
+    result->putDirect(vm, vm.propertyNames->length, jsNumber(count), PropertyAttribute::ReadOnly | 0);
+    result->putDirect(vm, Identifier::fromString(vm, "at"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "at"_s, [buffer = RefPtr { buffer.ptr() }, byteOffset, headerSize, count](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
+            double index = callFrame->argument(0).toIntegerOrInfinity(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (index < 0)
+                index += count;
+            if (index < 0 || index >= count)
+                return JSValue::encode(jsUndefined());
+            if (UNLIKELY(buffer->isDetached())) {
+                throwTypeError(globalObject, scope, "Cannot deserialize a detached ArrayBuffer"_s);
+                return {};
+            }
+
+            // The table was checked against the end when this was created,
+            // but the bytes can change under us since then.
+            uint64_t start, end;
+            const uint8_t* table = static_cast<const uint8_t*>(buffer->data()) + byteOffset + 2 * sizeof(uint32_t);
+            memcpy(&start, table + static_cast<size_t>(index) * sizeof(uint64_t), sizeof(start));
+            memcpy(&end, table + (static_cast<size_t>(index) + 1) * sizeof(uint64_t), sizeof(end));
+            uint64_t payloadSize;
+            memcpy(&payloadSize, table + static_cast<size_t>(count) * sizeof(uint64_t), sizeof(payloadSize));
+            if (UNLIKELY(start > end || end > payloadSize)) {
+                throwTypeError(globalObject, scope, "Bun.deserialize was given a corrupt lazy array"_s);
+                return {};
+            }
+
+            RELEASE_AND_RETURN(scope, JSValue::encode(SerializedScriptValue::fromArrayBuffer(*globalObject, globalObject, buffer.get(), byteOffset + headerSize + start, end - start)));
+        }),
+        0);
+    return result;
+}
+
+JSC_DEFINE_HOST_FUNCTION(functionBunDeserialize, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue input = callFrame->argument(0);
+    RefPtr<ArrayBuffer> buffer;
+    size_t byteOffset = 0;
+    size_t byteLength = 0;
+    if (auto* view = jsDynamicCast<JSArrayBufferView*>(input)) {
+        if (!view->isDetached()) {
+            buffer = view->possiblySharedBuffer();
+            byteOffset = view->byteOffset();
+            byteLength = view->byteLength();
+        }
+    } else if (auto* arrayBuffer = jsDynamicCast<JSArrayBuffer*>(input)) {
+        buffer = arrayBuffer->impl();
+        byteLength = buffer ? buffer->byteLength() : 0;
+    } else {
+        throwTypeError(globalObject, scope, "Bun.deserialize expects an ArrayBuffer, TypedArray or DataView"_s);
+        return {};
+    }
+
+    if (UNLIKELY(!buffer || buffer->isDetached())) {
+        throwTypeError(globalObject, scope, "Cannot deserialize a detached ArrayBuffer"_s);
+        return {};
+    }
+
+    if (byteLength >= sizeof(uint32_t)) {
+        uint32_t magic;
+        memcpy(&magic, static_cast<const uint8_t*>(buffer->data()) + byteOffset, sizeof(magic));
+        if (magic == lazyArrayMagic)
+            RELEASE_AND_RETURN(scope, JSValue::encode(deserializeLazyArray(globalObject, scope, buffer.releaseNonNull(), byteOffset, byteLength)));
+    }
+
+    // Reads straight out of the caller's memory.
+    RELEASE_AND_RETURN(scope, JSValue::encode(SerializedScriptValue::fromArrayBuffer(*globalObject, globalObject, buffer.get(), byteOffset, byteLength)));
+}
+
+}
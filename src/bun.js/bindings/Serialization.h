@@ -0,0 +1,17 @@
+#pragma once
+
+#include "root.h"
+
+namespace Bun {
+
+// Bun.serialize(value, { stream, lazy }) and Bun.deserialize(bytes).
+//
+// The bytes are the structured clone wire format in its storage flavour, so
+// they carry no pointers into this process and start with the format
+// version; a newer Bun reads what an older one wrote. With `lazy`, an array
+// is written as an index followed by one payload per element, and
+// Bun.deserialize() hands back an accessor that decodes elements on demand.
+JSC_DECLARE_HOST_FUNCTION(functionBunSerialize);
+JSC_DECLARE_HOST_FUNCTION(functionBunDeserialize);
+
+}
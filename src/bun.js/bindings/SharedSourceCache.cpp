@@ -0,0 +1,91 @@
+#include "root.h"
+#include "SharedSourceCache.h"
+
+#include "MemoryAccounting.h"
+
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/text/ExternalStringImpl.h>
+
+namespace Bun {
+
+// The characters of one source, owned by no StringImpl: StringImpl's
+// reference count is not atomic, so a string cannot be shared across
+// threads, but any number of ExternalStringImpls can point here.
+class SharedSourceCache::Buffer : public ThreadSafeRefCounted<Buffer> {
+public:
+    static Ref<Buffer> create(StringView source)
+    {
+        return adoptRef(*new Buffer(source));
+    }
+
+    ~Buffer()
+    {
+        reportMemoryFreed(MemorySubsystem::ModuleSources, sizeInBytes());
+    }
+
+    bool equals(StringView source) const
+    {
+        if (m_is8Bit)
+            return source == StringView(m_characters8.span());
+        return source == StringView(m_characters16.span());
+    }
+
+    // Each string holds a reference until the VM using it frees it.
+    String toString()
+    {
+        ref();
+        auto release = [](void* buffer, void*, unsigned) {
+            static_cast<Buffer*>(buffer)->deref();
+        };
+        if (m_is8Bit)
+            return String(ExternalStringImpl::create(m_characters8.span(), this, WTFMove(release)));
+        return String(ExternalStringImpl::create(m_characters16.span(), this, WTFMove(release)));
+    }
+
+private:
+    explicit Buffer(StringView source)
+        : m_is8Bit(source.is8Bit())
+    {
+        if (m_is8Bit)
+            m_characters8.append(source.span8());
+        else
+            m_characters16.append(source.span16());
+        reportMemoryAllocated(MemorySubsystem::ModuleSources, sizeInBytes());
+    }
+
+    size_t sizeInBytes() const { return m_characters8.size() + m_characters16.size() * sizeof(UChar); }
+
+    bool m_is8Bit;
+    Vector<LChar> m_characters8;
+    Vector<UChar> m_characters16;
+};
+
+SharedSourceCache& SharedSourceCache::singleton()
+{
+    static LazyNeverDestroyed<SharedSourceCache> cache;
+    static std::once_flag onceKey;
+    std::call_once(onceKey, [&] {
+        cache.construct();
+    });
+    return cache;
+}
+
+String SharedSourceCache::share(const String& path, const String& source)
+{
+    if (path.isEmpty() || source.isEmpty())
+        return source;
+
+    Locker locker { m_lock };
+    auto it = m_entries.find(path);
+    if (it != m_entries.end() && it->value->equals(source))
+        return it->value->toString();
+
+    auto buffer = Buffer::create(source);
+    if (it != m_entries.end())
+        it->value = buffer.copyRef();
+    else
+        m_entries.add(path.isolatedCopy(), buffer.copyRef());
+    return buffer->toString();
+}
+
+} // namespace Bun
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/text/StringHash.h>
+
+namespace Bun {
+
+// The transpiled source of every file a SourceProvider was made for,
+// shared by every VM in the process.
+//
+// Each Worker loads modules through its own VM, and each used to keep its
+// own copy of every source for as long as the module lived. The first VM
+// to load a file now leaves its source here, in a buffer no thread owns,
+// and every VM that loads the same text for the same path gets a string
+// pointing into that buffer instead. A pool of 32 Workers importing the
+// same dependency tree holds it once.
+//
+// Entries are matched on content as well as path, so an edited file or a
+// Worker that transpiles differently simply replaces the entry; nothing
+// is ever served stale. Bytecode needs no such table: the files the
+// bytecode cache maps are shared through the page cache already.
+class SharedSourceCache {
+    WTF_MAKE_NONCOPYABLE(SharedSourceCache);
+
+public:
+    static SharedSourceCache& singleton();
+
+    // A string equal to `source`, backed by the shared copy for `path`.
+    String share(const String& path, const String& source);
+
+private:
+    friend class LazyNeverDestroyed<SharedSourceCache>;
+    SharedSourceCache() = default;
+
+    class Buffer;
+
+    Lock m_lock;
+    HashMap<String, RefPtr<Buffer>> m_entries WTF_GUARDED_BY_LOCK(m_lock);
+};
+
+} // namespace Bun
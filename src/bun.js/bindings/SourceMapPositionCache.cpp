@@ -0,0 +1,129 @@
+#include "root.h"
+#include "SourceMapPositionCache.h"
+
+#include "ZigGlobalObject.h"
+
+namespace Bun {
+
+static bool isSameString(const BunString& a, const BunString& b)
+{
+    if (a.tag != b.tag)
+        return false;
+    switch (a.tag) {
+    case BunStringTag::WTFStringImpl:
+        return a.impl.wtf == b.impl.wtf;
+    case BunStringTag::Empty:
+        return true;
+    default:
+        // A Zig string may not outlive the call.
+        return false;
+    }
+}
+
+Vector<SourceMapPositionCache::Position>* SourceMapPositionCache::positionsFor(const String& sourceURL)
+{
+    auto it = m_sources.find(sourceURL);
+    if (it == m_sources.end())
+        return nullptr;
+    m_recentlyUsed.appendOrMoveToLast(sourceURL);
+    return &it->value;
+}
+
+void SourceMapPositionCache::add(const String& sourceURL, const ZigStackFramePosition& generated, const ZigStackFrame& remapped)
+{
+    auto result = m_sources.add(sourceURL, Vector<Position>());
+    if (result.isNewEntry && m_sources.size() > maxSources)
+        m_sources.remove(m_recentlyUsed.takeFirst());
+    m_recentlyUsed.appendOrMoveToLast(sourceURL);
+
+    auto& positions = result.iterator->value;
+    if (positions.size() >= maxPositionsPerSource)
+        return;
+
+    auto* position = std::lower_bound(positions.begin(), positions.end(), generated, [](const Position& position, const ZigStackFramePosition& generated) {
+        return position.isBefore(generated.line_zero_based, generated.column_zero_based);
+    });
+    if (position != positions.end() && position->line == generated.line_zero_based && position->column == generated.column_zero_based)
+        return;
+    positions.insert(position - positions.begin(), Position { generated.line_zero_based, generated.column_zero_based, remapped.position, remapped.remapped });
+}
+
+void SourceMapPositionCache::remap(JSC::JSGlobalObject* globalObject, ZigStackFrame* frames, size_t count)
+{
+    Vector<size_t, 16> misses;
+    Vector<String, 16> missURLs;
+
+    for (size_t i = 0; i < count; i++) {
+        auto& frame = frames[i];
+        if (frame.position.line_zero_based < 0 || frame.source_url.tag != BunStringTag::WTFStringImpl) {
+            misses.append(i);
+            missURLs.append(String());
+            continue;
+        }
+
+        String sourceURL = frame.source_url.impl.wtf;
+        if (auto* positions = positionsFor(sourceURL)) {
+            int32_t line = frame.position.line_zero_based;
+            int32_t column = frame.position.column_zero_based;
+            auto* position = std::lower_bound(positions->begin(), positions->end(), frame.position, [](const Position& position, const ZigStackFramePosition& generated) {
+                return position.isBefore(generated.line_zero_based, generated.column_zero_based);
+            });
+            if (position != positions->end() && position->line == line && position->column == column) {
+                frame.position = position->remappedPosition;
+                frame.remapped = position->remapped;
+                continue;
+            }
+        }
+        misses.append(i);
+        missURLs.append(WTFMove(sourceURL));
+    }
+
+    if (misses.isEmpty())
+        return;
+
+    if (misses.size() == count) {
+        Vector<ZigStackFramePosition, 16> generated;
+        generated.reserveInitialCapacity(count);
+        Vector<BunString, 16> sourceURLs;
+        sourceURLs.reserveInitialCapacity(count);
+        for (size_t i = 0; i < count; i++) {
+            generated.append(frames[i].position);
+            sourceURLs.append(frames[i].source_url);
+        }
+        Bun__remapStackFramePositions(globalObject, frames, count);
+        for (size_t i = 0; i < count; i++) {
+            if (!missURLs[i].isNull() && isSameString(sourceURLs[i], frames[i].source_url))
+                add(missURLs[i], generated[i], frames[i]);
+        }
+        return;
+    }
+
+    Vector<ZigStackFrame, 16> missedFrames;
+    missedFrames.reserveInitialCapacity(misses.size());
+    for (size_t index : misses)
+        missedFrames.append(frames[index]);
+    Bun__remapStackFramePositions(globalObject, missedFrames.data(), missedFrames.size());
+    for (size_t i = 0; i < misses.size(); i++) {
+        auto& frame = frames[misses[i]];
+        if (!missURLs[i].isNull() && isSameString(frame.source_url, missedFrames[i].source_url))
+            add(missURLs[i], frame.position, missedFrames[i]);
+        frame = missedFrames[i];
+    }
+}
+
+void SourceMapPositionCache::invalidate(const String& sourceURL)
+{
+    if (m_sources.remove(sourceURL))
+        m_recentlyUsed.remove(sourceURL);
+}
+
+void remapStackFramePositions(JSC::JSGlobalObject* globalObject, ZigStackFrame* frames, size_t count)
+{
+    if (auto* zigGlobalObject = jsDynamicCast<Zig::GlobalObject*>(globalObject)) {
+        zigGlobalObject->sourceMapPositionCache.remap(globalObject, frames, count);
+        return;
+    }
+    Bun__remapStackFramePositions(globalObject, frames, count);
+}
+
+}
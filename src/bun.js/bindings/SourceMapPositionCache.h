@@ -0,0 +1,61 @@
+#pragma once
+
+#include "root.h"
+#include "headers-handwritten.h"
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/text/StringHash.h>
+
+namespace Bun {
+
+// Source-mapped positions already looked up, per source URL.
+//
+// Bun__remapStackFramePositions goes to the source map for every frame of
+// every Error.stack. Services log the same few errors from the same few
+// throw sites over and over, so most of those lookups have been done before.
+// Each source keeps its generated positions in a sorted array and finds
+// them by binary search. Sources are dropped least recently used first, and
+// only frames whose URL the source map did not change are kept, so a hit
+// never has to keep a string alive.
+//
+// One cache lives on each global object, so it needs no locking.
+class SourceMapPositionCache {
+    WTF_MAKE_NONCOPYABLE(SourceMapPositionCache);
+
+public:
+    static constexpr unsigned maxSources = 64;
+    static constexpr unsigned maxPositionsPerSource = 1024;
+
+    SourceMapPositionCache() = default;
+
+    // Like Bun__remapStackFramePositions, which is only called for the
+    // frames not found here, all at once.
+    void remap(JSC::JSGlobalObject*, ZigStackFrame* frames, size_t count);
+
+    // A new SourceProvider for `sourceURL` comes with its own source map.
+    void invalidate(const String& sourceURL);
+
+private:
+    struct Position {
+        int32_t line;
+        int32_t column;
+        ZigStackFramePosition remappedPosition;
+        bool remapped;
+
+        bool isBefore(int32_t otherLine, int32_t otherColumn) const
+        {
+            return line < otherLine || (line == otherLine && column < otherColumn);
+        }
+    };
+
+    Vector<Position>* positionsFor(const String& sourceURL);
+    void add(const String& sourceURL, const ZigStackFramePosition& generated, const ZigStackFrame& remapped);
+
+    HashMap<String, Vector<Position>> m_sources;
+    ListHashSet<String> m_recentlyUsed;
+};
+
+// Remaps through the global object's SourceMapPositionCache when it has one.
+void remapStackFramePositions(JSC::JSGlobalObject*, ZigStackFrame* frames, size_t count);
+
+}
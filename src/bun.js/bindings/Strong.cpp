@@ -6,16 +6,57 @@ namespace Bun {
 
 WTF_MAKE_ISO_ALLOCATED_IMPL(StrongRef);
 
+StrongRefPool::~StrongRefPool()
+{
+    for (auto* strongRef : m_free)
+        delete strongRef;
+}
+
+StrongRef* StrongRefPool::take(JSC::VM& vm, JSC::JSValue value)
+{
+    m_liveCount++;
+    if (m_free.isEmpty()) {
+        auto* strongRef = new StrongRef(vm, value);
+        strongRef->m_vm = &vm;
+        return strongRef;
+    }
+
+    auto* strongRef = m_free.takeLast();
+    strongRef->m_cell.set(vm, value);
+    return strongRef;
+}
+
+void StrongRefPool::give(StrongRef* strongRef)
+{
+    ASSERT(m_liveCount);
+    m_liveCount--;
+    if (m_free.size() >= maxPooled) {
+        delete strongRef;
+        return;
+    }
+
+    // Unlike clear(), storing an empty value through set() moves the slot
+    // off the strong list.
+    strongRef->m_cell.set(*strongRef->m_vm, JSC::JSValue());
+    m_free.append(strongRef);
+}
+
 }
 
 extern "C" void Bun__StrongRef__delete(Bun::StrongRef* strongRef)
 {
+    if (auto* vm = strongRef->m_vm) {
+        WebCore::clientData(*vm)->strongRefPool.give(strongRef);
+        return;
+    }
+
     delete strongRef;
 }
 
 extern "C" Bun::StrongRef* Bun__StrongRef__new(JSC::JSGlobalObject* globalObject, JSC::EncodedJSValue encodedValue)
 {
-    return new Bun::StrongRef(globalObject->vm(), JSC::JSValue::decode(encodedValue));
+    auto& vm = globalObject->vm();
+    return WebCore::clientData(vm)->strongRefPool.take(vm, JSC::JSValue::decode(encodedValue));
 }
 
 extern "C" JSC::EncodedJSValue Bun__StrongRef__get(Bun::StrongRef* strongRef)
@@ -2,11 +2,10 @@
 
 #include "root.h"
 #include <JavaScriptCore/Strong.h>
+#include <wtf/Vector.h>
 
 namespace Bun {
 
-// We tried to pool these
-// But it was very complicated
 class StrongRef {
     WTF_MAKE_ISO_ALLOCATED(StrongRef);
 
@@ -22,6 +21,34 @@ public:
     }
 
     JSC::Strong<JSC::Unknown> m_cell;
+    // Set on the ones made by Bun__StrongRef__new(), which go back to this
+    // VM's StrongRefPool when deleted.
+    JSC::VM* m_vm { nullptr };
 };
 
-}
\ No newline at end of file
+// The StrongRefs that Zig let go of, cleared but still holding their handle
+// slot, so that the next Bun__StrongRef__new() on this VM only has to store
+// a value. A cleared one is off the HandleSet's strong list and costs GC
+// nothing. Only touched on the VM's own thread.
+class StrongRefPool {
+    WTF_MAKE_NONCOPYABLE(StrongRefPool);
+
+public:
+    StrongRefPool() = default;
+    ~StrongRefPool();
+
+    StrongRef* take(JSC::VM&, JSC::JSValue);
+    void give(StrongRef*);
+
+    // StrongRefs handed out and not yet given back.
+    size_t liveCount() const { return m_liveCount; }
+    size_t pooledCount() const { return m_free.size(); }
+
+private:
+    static constexpr size_t maxPooled = 1024;
+
+    Vector<StrongRef*> m_free;
+    size_t m_liveCount { 0 };
+};
+
+}
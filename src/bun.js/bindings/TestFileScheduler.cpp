@@ -0,0 +1,144 @@
+#include "root.h"
+#include "TestFileScheduler.h"
+
+namespace Bun {
+
+TestFileScheduler::TestFileScheduler(size_t workerCount)
+{
+    workerCount = std::max<size_t>(workerCount, 1);
+    m_slots.reserveInitialCapacity(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+        m_slots.append(makeUnique<Slot>());
+}
+
+void TestFileScheduler::add(uint32_t fileIndex, double expectedMs)
+{
+    m_pending.append(std::make_pair(fileIndex, expectedMs));
+}
+
+void TestFileScheduler::start()
+{
+    double knownMs = 0;
+    size_t knownCount = 0;
+    for (auto& [index, expectedMs] : m_pending) {
+        if (expectedMs >= 0) {
+            knownMs += expectedMs;
+            knownCount++;
+        }
+    }
+    // With no history at all every file weighs the same and this is plain
+    // round robin.
+    double unknownMs = knownCount ? knownMs / knownCount : 1;
+
+    Vector<File> files;
+    files.reserveInitialCapacity(m_pending.size());
+    for (auto& [index, expectedMs] : m_pending) {
+        double ms = expectedMs >= 0 ? expectedMs : unknownMs;
+        files.append(File { index, static_cast<uint64_t>(ms * 1000) + 1 });
+    }
+    m_pending.clear();
+
+    // Stable so files of equal weight keep the order they were given in.
+    std::stable_sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.expectedUs > b.expectedUs;
+    });
+
+    for (auto& file : files) {
+        Slot* lightest = m_slots[0].get();
+        for (auto& slot : m_slots) {
+            if (slot->remainingUs.load(std::memory_order_relaxed) < lightest->remainingUs.load(std::memory_order_relaxed))
+                lightest = slot.get();
+        }
+        Locker locker { lightest->lock };
+        lightest->files.append(file);
+        lightest->remainingUs.fetch_add(file.expectedUs, std::memory_order_relaxed);
+    }
+}
+
+std::optional<TestFileScheduler::File> TestFileScheduler::takeFrom(Slot& slot, bool fromBack)
+{
+    Locker locker { slot.lock };
+    if (slot.files.isEmpty())
+        return std::nullopt;
+    auto file = fromBack ? slot.files.takeLast() : slot.files.takeFirst();
+    slot.remainingUs.fetch_sub(file.expectedUs, std::memory_order_relaxed);
+    return file;
+}
+
+std::optional<uint32_t> TestFileScheduler::take(size_t workerIndex)
+{
+    if (auto file = takeFrom(*m_slots[workerIndex], false))
+        return file->index;
+
+    // Like WorkerPoolScheduler, the totals are read without the victim's
+    // lock, so look again if it emptied in the meantime.
+    while (true) {
+        Slot* victim = nullptr;
+        uint64_t mostUs = 0;
+        for (size_t i = 0; i < m_slots.size(); i++) {
+            if (i == workerIndex)
+                continue;
+            uint64_t remainingUs = m_slots[i]->remainingUs.load(std::memory_order_relaxed);
+            if (remainingUs > mostUs) {
+                mostUs = remainingUs;
+                victim = m_slots[i].get();
+            }
+        }
+        if (!victim)
+            return std::nullopt;
+        if (auto file = takeFrom(*victim, true))
+            return file->index;
+    }
+}
+
+void TestFileScheduler::finish(uint32_t fileIndex, double actualMs)
+{
+    Locker locker { m_durationsLock };
+    m_durations.set(fileIndex, actualMs);
+}
+
+double TestFileScheduler::duration(uint32_t fileIndex) const
+{
+    Locker locker { m_durationsLock };
+    auto it = m_durations.find(fileIndex);
+    return it != m_durations.end() ? it->value : -1;
+}
+
+}
+
+extern "C" Bun::TestFileScheduler* TestFileScheduler__create(size_t workerCount)
+{
+    return new Bun::TestFileScheduler(workerCount);
+}
+
+extern "C" void TestFileScheduler__add(Bun::TestFileScheduler* scheduler, uint32_t fileIndex, double expectedMs)
+{
+    scheduler->add(fileIndex, expectedMs);
+}
+
+extern "C" void TestFileScheduler__start(Bun::TestFileScheduler* scheduler)
+{
+    scheduler->start();
+}
+
+// -1 once there is nothing left for the worker to run.
+extern "C" int64_t TestFileScheduler__take(Bun::TestFileScheduler* scheduler, size_t workerIndex)
+{
+    auto fileIndex = scheduler->take(workerIndex);
+    return fileIndex ? static_cast<int64_t>(*fileIndex) : -1;
+}
+
+extern "C" void TestFileScheduler__finish(Bun::TestFileScheduler* scheduler, uint32_t fileIndex, double actualMs)
+{
+    scheduler->finish(fileIndex, actualMs);
+}
+
+extern "C" double TestFileScheduler__duration(Bun::TestFileScheduler* scheduler, uint32_t fileIndex)
+{
+    return scheduler->duration(fileIndex);
+}
+
+extern "C" void TestFileScheduler__destroy(Bun::TestFileScheduler* scheduler)
+{
+    delete scheduler;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+
+namespace Bun {
+
+// Hands test files to the workers of a parallel `bun test` run, each of
+// which runs them in a global object of its own.
+//
+// Files are dealt out longest first, by how long they took last time, each
+// to the worker with the least expected work so far; files with no history
+// count as the average of the ones that have it. A worker runs its own
+// files from the front of its deque, the longest ones first, and once that
+// is empty steals from the back of the worker with the most time left, so
+// what it takes is short and the run still ends at about the same time on
+// every worker.
+//
+// add() and start() are called on the runner's thread before any worker
+// starts; everything else may be called from any worker.
+class TestFileScheduler {
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    explicit TestFileScheduler(size_t workerCount);
+
+    // `expectedMs` is negative when the file has no recorded duration.
+    void add(uint32_t fileIndex, double expectedMs);
+    void start();
+
+    // The next file for `workerIndex`, stolen from another worker when its
+    // own deque is empty, or nothing once every file has been taken.
+    std::optional<uint32_t> take(size_t workerIndex);
+
+    // Records how long a file took, for the runner to save as the next
+    // run's history.
+    void finish(uint32_t fileIndex, double actualMs);
+    double duration(uint32_t fileIndex) const;
+
+    size_t workerCount() const { return m_slots.size(); }
+
+private:
+    struct File {
+        uint32_t index;
+        uint64_t expectedUs;
+    };
+
+    struct Slot {
+        Lock lock;
+        Deque<File> files WTF_GUARDED_BY_LOCK(lock);
+        // Expected time of the files still queued, read without the lock
+        // to pick whom to steal from.
+        std::atomic<uint64_t> remainingUs { 0 };
+    };
+
+    std::optional<File> takeFrom(Slot&, bool fromBack);
+
+    Vector<std::unique_ptr<Slot>> m_slots;
+    Vector<std::pair<uint32_t, double>> m_pending;
+    mutable Lock m_durationsLock;
+    HashMap<uint32_t, double, DefaultHash<uint32_t>, WTF::UnsignedWithZeroKeyHashTraits<uint32_t>> m_durations WTF_GUARDED_BY_LOCK(m_durationsLock);
+};
+
+}
@@ -0,0 +1,378 @@
+#include "root.h"
+#include "TextCodecStreams.h"
+
+#include "JSStringDecoder.h"
+#include "RopeStringUTF8.h"
+#include "simdutf.h"
+#include <JavaScriptCore/ArrayBuffer.h>
+#include <JavaScriptCore/JSArrayBuffer.h>
+#include <JavaScriptCore/JSArrayBufferView.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
+#include <JavaScriptCore/ObjectConstructor.h>
+#include <wtf/text/StringImpl.h>
+
+namespace Bun {
+
+using namespace JSC;
+using namespace WebCore;
+
+static constexpr uint8_t replacementCharacterUTF8[] = { 0xEF, 0xBF, 0xBD };
+
+static bool enqueueChunk(JSGlobalObject* globalObject, JSValue controller, JSValue chunk)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue enqueue = controller.get(globalObject, Identifier::fromString(vm, "enqueue"_s));
+    RETURN_IF_EXCEPTION(scope, false);
+    auto callData = JSC::getCallData(enqueue);
+    if (UNLIKELY(callData.type == CallData::Type::None)) {
+        throwTypeError(globalObject, scope, "controller.enqueue is not a function"_s);
+        return false;
+    }
+
+    MarkedArgumentBuffer args;
+    args.append(chunk);
+    JSC::call(globalObject, enqueue, callData, controller, args);
+    RETURN_IF_EXCEPTION(scope, false);
+    return true;
+}
+
+// Encoded chunks are bump allocated out of a shared slab, so a stream of
+// small writes shares one ArrayBuffer instead of allocating one per chunk.
+// Bytes are never handed out twice, so the views downstream stay valid.
+class TextEncoderStreamEncoder : public RefCounted<TextEncoderStreamEncoder> {
+public:
+    static constexpr size_t slabSize = 16 * 1024;
+
+    static Ref<TextEncoderStreamEncoder> create() { return adoptRef(*new TextEncoderStreamEncoder); }
+
+    JSValue encode(JSGlobalObject*, JSString*);
+    JSValue flush(JSGlobalObject*);
+
+private:
+    TextEncoderStreamEncoder() = default;
+
+    JSUint8Array* allocate(JSGlobalObject*, size_t byteLength);
+
+    RefPtr<ArrayBuffer> m_slab;
+    size_t m_slabOffset { 0 };
+    UChar m_pendingHighSurrogate { 0 };
+};
+
+JSUint8Array* TextEncoderStreamEncoder::allocate(JSGlobalObject* globalObject, size_t byteLength)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* structure = globalObject->typedArrayStructure(TypeUint8, false);
+
+    if (byteLength > slabSize / 4) {
+        auto buffer = ArrayBuffer::tryCreateUninitialized(byteLength, 1);
+        if (UNLIKELY(!buffer)) {
+            throwOutOfMemoryError(globalObject, scope);
+            return nullptr;
+        }
+        RELEASE_AND_RETURN(scope, JSUint8Array::create(globalObject, structure, buffer.releaseNonNull(), 0, byteLength));
+    }
+
+    if (!m_slab || m_slabOffset + byteLength > slabSize) {
+        m_slab = ArrayBuffer::tryCreateUninitialized(slabSize, 1);
+        m_slabOffset = 0;
+        if (UNLIKELY(!m_slab)) {
+            throwOutOfMemoryError(globalObject, scope);
+            return nullptr;
+        }
+    }
+
+    size_t offset = m_slabOffset;
+    m_slabOffset += byteLength;
+    RELEASE_AND_RETURN(scope, JSUint8Array::create(globalObject, structure, Ref { *m_slab }, offset, byteLength));
+}
+
+JSValue TextEncoderStreamEncoder::encode(JSGlobalObject* globalObject, JSString* string)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    const String& value = string->value(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    // The previous chunk's trailing high surrogate goes in front as its own
+    // fiber; the fiber writer joins it with a leading low surrogate here or
+    // turns it into U+FFFD.
+    UChar carried = std::exchange(m_pendingHighSurrogate, 0);
+    StringFiber fibers[2];
+    size_t fiberCount = 0;
+    uint32_t offset = 0;
+    if (carried) {
+        fibers[fiberCount++] = { offset, 1, &carried, false };
+        offset++;
+    }
+
+    uint32_t length = value.length();
+    if (!value.is8Bit() && length && U16_IS_LEAD(value[length - 1])) {
+        m_pendingHighSurrogate = value[length - 1];
+        length--;
+    }
+
+    if (length) {
+        if (value.is8Bit())
+            fibers[fiberCount++] = { offset, length, value.span8().data(), true };
+        else
+            fibers[fiberCount++] = { offset, length, value.span16().data(), false };
+    }
+
+    std::span<const StringFiber> pieces { fibers, fiberCount };
+    size_t byteLength = utf8LengthOfFibers(pieces);
+    if (!byteLength)
+        return jsUndefined();
+
+    auto* output = allocate(globalObject, byteLength);
+    RETURN_IF_EXCEPTION(scope, {});
+    writeFibersAsUTF8(pieces, { output->typedVector(), byteLength });
+    return output;
+}
+
+JSValue TextEncoderStreamEncoder::flush(JSGlobalObject* globalObject)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!m_pendingHighSurrogate)
+        return jsUndefined();
+    m_pendingHighSurrogate = 0;
+
+    auto* output = allocate(globalObject, sizeof(replacementCharacterUTF8));
+    RETURN_IF_EXCEPTION(scope, {});
+    memcpy(output->typedVector(), replacementCharacterUTF8, sizeof(replacementCharacterUTF8));
+    return output;
+}
+
+class TextDecoderStreamDecoder : public RefCounted<TextDecoderStreamDecoder> {
+public:
+    static Ref<TextDecoderStreamDecoder> create(bool fatal, bool ignoreBOM) { return adoptRef(*new TextDecoderStreamDecoder(fatal, ignoreBOM)); }
+
+    JSValue decode(JSGlobalObject*, std::span<const uint8_t>);
+    JSValue flush(JSGlobalObject*);
+
+private:
+    TextDecoderStreamDecoder(bool fatal, bool ignoreBOM)
+        : m_fatal(fatal)
+        , m_sawBOM(ignoreBOM)
+    {
+    }
+
+    JSString* decodeComplete(JSGlobalObject*, std::span<const uint8_t>);
+
+    uint8_t m_pending[4];
+    uint8_t m_pendingLength { 0 };
+    uint8_t m_pendingNeed { 0 };
+    bool m_fatal;
+    // Set once the first character has been produced (or BOM sniffing is off).
+    bool m_sawBOM;
+};
+
+static uint8_t utf8SequenceLength(uint8_t lead)
+{
+    if (lead >= 0xC2 && lead <= 0xDF)
+        return 2;
+    if (lead >= 0xE0 && lead <= 0xEF)
+        return 3;
+    if (lead >= 0xF0 && lead <= 0xF4)
+        return 4;
+    return 1;
+}
+
+static bool isContinuationByte(uint8_t byte)
+{
+    return (byte & 0xC0) == 0x80;
+}
+
+JSString* TextDecoderStreamDecoder::decodeComplete(JSGlobalObject* globalObject, std::span<const uint8_t> bytes)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!m_sawBOM && !bytes.empty()) {
+        m_sawBOM = true;
+        if (bytes.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+            bytes = bytes.subspan(3);
+    }
+
+    if (bytes.empty())
+        return jsEmptyString(vm);
+
+    if (m_fatal && !simdutf::validate_utf8(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {
+        throwTypeError(globalObject, scope, "The encoded data was not valid for encoding utf-8"_s);
+        return nullptr;
+    }
+
+    JSValue result = decodeCompleteUTF8(vm, globalObject, bytes.data(), bytes.size());
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    return result.toString(globalObject);
+}
+
+JSValue TextDecoderStreamDecoder::decode(JSGlobalObject* globalObject, std::span<const uint8_t> bytes)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSString* head = nullptr;
+
+    // Finish the sequence left over from the previous chunk in the scratch
+    // area. It ends early at the first byte that cannot continue it, in
+    // which case the decoder below reports it as malformed.
+    if (m_pendingLength) {
+        size_t taken = 0;
+        while (m_pendingLength < m_pendingNeed && taken < bytes.size() && isContinuationByte(bytes[taken]))
+            m_pending[m_pendingLength++] = bytes[taken++];
+        bytes = bytes.subspan(taken);
+
+        if (m_pendingLength < m_pendingNeed && bytes.empty())
+            return jsEmptyString(vm);
+
+        head = decodeComplete(globalObject, { m_pending, m_pendingLength });
+        RETURN_IF_EXCEPTION(scope, {});
+        m_pendingLength = 0;
+        m_pendingNeed = 0;
+    }
+
+    // Hold back a trailing sequence that the next chunk may complete.
+    size_t end = bytes.size();
+    for (size_t back = 1; back <= 3 && back <= bytes.size(); back++) {
+        uint8_t byte = bytes[bytes.size() - back];
+        if (isContinuationByte(byte))
+            continue;
+        uint8_t need = utf8SequenceLength(byte);
+        if (need > back) {
+            end = bytes.size() - back;
+            m_pendingNeed = need;
+            m_pendingLength = back;
+            memcpy(m_pending, bytes.data() + end, back);
+        }
+        break;
+    }
+
+    JSString* body = decodeComplete(globalObject, bytes.first(end));
+    RETURN_IF_EXCEPTION(scope, {});
+
+    if (!head)
+        return body;
+    if (!body->length())
+        return head;
+    RELEASE_AND_RETURN(scope, jsString(globalObject, head, body));
+}
+
+JSValue TextDecoderStreamDecoder::flush(JSGlobalObject* globalObject)
+{
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!m_pendingLength)
+        return jsEmptyString(vm);
+
+    m_pendingLength = 0;
+    m_pendingNeed = 0;
+    if (m_fatal) {
+        throwTypeError(globalObject, scope, "The encoded data was not valid for encoding utf-8"_s);
+        return {};
+    }
+    return jsString(vm, String(std::span<const UChar> { u"\uFFFD", 1 }));
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionCreateTextEncoderStreamEncoder, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    Ref encoder = TextEncoderStreamEncoder::create();
+
+    auto* transformer = constructEmptyObject(globalObject);
+    transformer->putDirect(vm, Identifier::fromString(vm, "transform"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "transform"_s, [encoder = RefPtr { encoder.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            JSString* chunk = callFrame->argument(0).toString(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            JSValue output = encoder->encode(globalObject, chunk);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (!output.isUndefined()) {
+                enqueueChunk(globalObject, callFrame->argument(1), output);
+                RETURN_IF_EXCEPTION(scope, {});
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+    transformer->putDirect(vm, Identifier::fromString(vm, "flush"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "flush"_s, [encoder = RefPtr { encoder.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            JSValue output = encoder->flush(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (!output.isUndefined()) {
+                enqueueChunk(globalObject, callFrame->argument(0), output);
+                RETURN_IF_EXCEPTION(scope, {});
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+
+    return JSValue::encode(transformer);
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsFunctionCreateTextDecoderStreamDecoder, (JSGlobalObject * globalObject, CallFrame* callFrame))
+{
+    auto& vm = globalObject->vm();
+    Ref decoder = TextDecoderStreamDecoder::create(callFrame->argument(0).toBoolean(globalObject), callFrame->argument(1).toBoolean(globalObject));
+
+    auto* transformer = constructEmptyObject(globalObject);
+    transformer->putDirect(vm, Identifier::fromString(vm, "transform"_s),
+        JSNativeStdFunction::create(vm, globalObject, 2, "transform"_s, [decoder = RefPtr { decoder.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+
+            JSValue chunk = callFrame->argument(0);
+            std::span<const uint8_t> bytes;
+            if (auto* view = jsDynamicCast<JSArrayBufferView*>(chunk)) {
+                if (!view->isDetached())
+                    bytes = { static_cast<const uint8_t*>(view->vector()), view->byteLength() };
+            } else if (auto* arrayBuffer = jsDynamicCast<JSArrayBuffer*>(chunk)) {
+                if (auto* impl = arrayBuffer->impl())
+                    bytes = { static_cast<const uint8_t*>(impl->data()), impl->byteLength() };
+            } else {
+                throwTypeError(globalObject, scope, "The \"input\" argument must be an ArrayBuffer or ArrayBufferView"_s);
+                return {};
+            }
+
+            JSValue output = decoder->decode(globalObject, bytes);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (asString(output)->length()) {
+                enqueueChunk(globalObject, callFrame->argument(1), output);
+                RETURN_IF_EXCEPTION(scope, {});
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+    transformer->putDirect(vm, Identifier::fromString(vm, "flush"_s),
+        JSNativeStdFunction::create(vm, globalObject, 1, "flush"_s, [decoder = RefPtr { decoder.ptr() }](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            JSValue output = decoder->flush(globalObject);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (asString(output)->length()) {
+                enqueueChunk(globalObject, callFrame->argument(0), output);
+                RETURN_IF_EXCEPTION(scope, {});
+            }
+            return JSValue::encode(jsUndefined());
+        }));
+
+    return JSValue::encode(transformer);
+}
+
+JSC::JSValue createTextCodecStreamsBinding(Zig::GlobalObject* globalObject)
+{
+    auto& vm = globalObject->vm();
+    auto* binding = constructEmptyObject(globalObject);
+    binding->putDirect(vm, Identifier::fromString(vm, "createEncoder"_s),
+        JSFunction::create(vm, globalObject, 0, "createEncoder"_s, jsFunctionCreateTextEncoderStreamEncoder, ImplementationVisibility::Public));
+    binding->putDirect(vm, Identifier::fromString(vm, "createDecoder"_s),
+        JSFunction::create(vm, globalObject, 2, "createDecoder"_s, jsFunctionCreateTextDecoderStreamDecoder, ImplementationVisibility::Public));
+    return binding;
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "root.h"
+#include "ZigGlobalObject.h"
+
+namespace Bun {
+
+// Native transformers for TextEncoderStream and TextDecoderStream.
+//
+// The binding exposes `createEncoder()` and `createDecoder(fatal, ignoreBOM)`,
+// each returning a `{ transform, flush }` object that can be handed to
+// `new TransformStream()` as is. Both keep their carry-over state (a pending
+// high surrogate, or up to three bytes of an unfinished UTF-8 sequence) in
+// native code, so no JS closure runs per chunk.
+JSC::JSValue createTextCodecStreamsBinding(Zig::GlobalObject*);
+
+}
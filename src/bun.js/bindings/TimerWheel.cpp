@@ -0,0 +1,144 @@
+#include "root.h"
+#include "TimerWheel.h"
+
+#include "ZigGlobalObject.h"
+#include "AbortSignal.h"
+#include <wtf/MonotonicTime.h>
+
+namespace Bun {
+
+static constexpr uint64_t slotMask = TimerWheel::slotsPerLevel - 1;
+
+uint64_t TimerWheel::now()
+{
+    return static_cast<uint64_t>(MonotonicTime::now().secondsSinceEpoch().milliseconds());
+}
+
+void TimerWheel::schedule(Node& node, uint64_t now, uint64_t expiresAt)
+{
+    if (node.isScheduled())
+        unlink(node);
+
+    // An empty wheel has not been turned for a while.
+    if (!m_count)
+        m_currentTime = now;
+
+    node.expiresAt = std::max(expiresAt, m_currentTime);
+    insert(node);
+    m_count++;
+    m_statistics.scheduled++;
+}
+
+void TimerWheel::cancel(Node& node)
+{
+    if (!node.isScheduled())
+        return;
+    unlink(node);
+    m_statistics.cancelled++;
+}
+
+void TimerWheel::insert(Node& node)
+{
+    uint64_t expiresAt = node.expiresAt;
+    uint64_t delay = expiresAt - m_currentTime;
+    if (delay > maxDelay)
+        expiresAt = m_currentTime + maxDelay;
+
+    unsigned level = 0;
+    while (level < levels - 1 && delay >= (1ull << (levelBits * (level + 1))))
+        level++;
+
+    Node*& slot = m_slots[level][(expiresAt >> (levelBits * level)) & slotMask];
+    node.next = slot;
+    if (slot)
+        slot->previous = &node.next;
+    node.previous = &slot;
+    slot = &node;
+}
+
+void TimerWheel::unlink(Node& node)
+{
+    *node.previous = node.next;
+    if (node.next)
+        node.next->previous = node.previous;
+    node.next = nullptr;
+    node.previous = nullptr;
+    m_count--;
+}
+
+void TimerWheel::cascade(unsigned level, unsigned slot)
+{
+    Node* node = m_slots[level][slot];
+    m_slots[level][slot] = nullptr;
+    while (node) {
+        Node* next = node->next;
+        insert(*node);
+        node = next;
+    }
+}
+
+void TimerWheel::takeDue()
+{
+    uint64_t time = m_currentTime;
+
+    // At the start of each block of a level, the matching slot of the level
+    // above holds the timers due within it.
+    for (unsigned level = 1; level < levels; level++) {
+        if ((time >> (levelBits * (level - 1))) & slotMask)
+            break;
+        cascade(level, (time >> (levelBits * level)) & slotMask);
+    }
+
+    Node*& slot = m_slots[0][time & slotMask];
+    m_due = slot;
+    if (m_due)
+        m_due->previous = &m_due;
+    slot = nullptr;
+
+    // Timers scheduled from a callback go to the next millisecond.
+    m_currentTime = time + 1;
+}
+
+std::optional<uint64_t> TimerWheel::nextExpiration() const
+{
+    if (!m_count)
+        return std::nullopt;
+
+    uint64_t nextBlock = (m_currentTime | slotMask) + 1;
+    for (uint64_t time = m_currentTime; time < nextBlock; time++) {
+        if (m_slots[0][time & slotMask])
+            return time;
+    }
+    return nextBlock;
+}
+
+}
+
+using Bun::TimerWheel;
+
+extern "C" void Bun__TimerWheel__schedule(Zig::GlobalObject* globalObject, TimerWheel::Node* node, uint64_t now, uint64_t expiresAt)
+{
+    globalObject->timerWheel.schedule(*node, now, expiresAt);
+}
+
+extern "C" void Bun__TimerWheel__cancel(Zig::GlobalObject* globalObject, TimerWheel::Node* node)
+{
+    globalObject->timerWheel.cancel(*node);
+}
+
+extern "C" void Bun__TimerWheel__advance(Zig::GlobalObject* globalObject, uint64_t now, void* context, void (*fired)(void* context, TimerWheel::Node*))
+{
+    globalObject->timerWheel.advance(now, [&](TimerWheel::Node& node) {
+        fired(context, &node);
+    });
+    globalObject->abortSignalTimers.advance(now, WebCore::AbortSignal::timeoutFired);
+}
+
+// -1 when there are no timers.
+extern "C" int64_t Bun__TimerWheel__nextExpiration(Zig::GlobalObject* globalObject)
+{
+    auto next = globalObject->timerWheel.nextExpiration();
+    if (auto abortSignalNext = globalObject->abortSignalTimers.nextExpiration())
+        next = next ? std::min(*next, *abortSignalNext) : *abortSignalNext;
+    return next ? static_cast<int64_t>(*next) : -1;
+}
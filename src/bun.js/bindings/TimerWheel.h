@@ -0,0 +1,100 @@
+#pragma once
+
+#include "root.h"
+#include <optional>
+
+namespace Bun {
+
+// A hashed hierarchical timing wheel for setTimeout() and setInterval().
+//
+// Servers keep one timeout per request, so there are often 100k timers live
+// and nearly all of them are cleared before they fire. Here scheduling and
+// cancelling are O(1): a timer goes into the slot for its expiry, in the
+// first of four 256-slot levels whose span it fits in, and its node unlinks
+// itself. Timers are kept to the millisecond, so those due in the same
+// millisecond share a slot and fire together. When the lowest level wraps
+// around, the next slot of the level above is spread out over the levels
+// below it.
+//
+// Nodes are embedded in the timer objects, so the wheel never allocates. One
+// wheel lives on each global object, so it needs no locking.
+class TimerWheel {
+    WTF_MAKE_NONCOPYABLE(TimerWheel);
+
+public:
+    static constexpr unsigned levelBits = 8;
+    static constexpr unsigned slotsPerLevel = 1 << levelBits;
+    static constexpr unsigned levels = 4;
+    // About 49 days. Later timers wait in the last level and are placed again
+    // each time it comes around.
+    static constexpr uint64_t maxDelay = (1ull << (levelBits * levels)) - 1;
+
+    struct Node {
+        Node* next { nullptr };
+        // Whatever points to this node, so it can unlink itself.
+        Node** previous { nullptr };
+        // In milliseconds, on the same clock as advance().
+        uint64_t expiresAt { 0 };
+
+        bool isScheduled() const { return previous; }
+    };
+
+    struct Statistics {
+        uint64_t scheduled { 0 };
+        uint64_t cancelled { 0 };
+        uint64_t fired { 0 };
+    };
+
+    TimerWheel() = default;
+
+    // The monotonic clock, in milliseconds, that the wheels on the global
+    // object are scheduled and advanced with.
+    static uint64_t now();
+
+    // A timer that is already scheduled is moved. Timers due before the
+    // current time fire on the next advance().
+    void schedule(Node&, uint64_t now, uint64_t expiresAt);
+    void cancel(Node&);
+
+    // Fires, in order, every timer due at or before `now`. The callback may
+    // schedule or cancel any timer, including the one it was called for.
+    template<typename Callback>
+    void advance(uint64_t now, const Callback& fired)
+    {
+        while (m_currentTime <= now) {
+            if (!m_count) {
+                m_currentTime = now + 1;
+                return;
+            }
+            takeDue();
+            while (Node* node = m_due) {
+                unlink(*node);
+                m_statistics.fired++;
+                fired(*node);
+            }
+        }
+    }
+
+    // When to call advance() next. Exact for timers due within the current
+    // 256ms, otherwise the point at which the wheel has to be turned.
+    std::optional<uint64_t> nextExpiration() const;
+
+    const Statistics& statistics() const { return m_statistics; }
+    size_t size() const { return m_count; }
+
+private:
+    void insert(Node&);
+    void unlink(Node&);
+    void cascade(unsigned level, unsigned slot);
+    void takeDue();
+
+    Node* m_slots[levels][slotsPerLevel] {};
+    // The timers of the millisecond being fired, as moved out of their slot.
+    Node* m_due { nullptr };
+    // The next millisecond that has not been fired.
+    uint64_t m_currentTime { 0 };
+    size_t m_count { 0 };
+    Statistics m_statistics;
+};
+
+}
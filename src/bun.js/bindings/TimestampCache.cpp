@@ -0,0 +1,58 @@
+#include "root.h"
+#include "TimestampCache.h"
+
+#include "BunClientData.h"
+#include "ZigGlobalObject.h"
+#include "headers-handwritten.h"
+#include "wtf-bindings.h"
+#include <wtf/CurrentTime.h>
+
+namespace Bun {
+
+using namespace JSC;
+
+const String& TimestampCache::iso(VM& vm, double now)
+{
+    if (UNLIKELY(!std::isfinite(now)))
+        return emptyString();
+
+    int64_t millisecond = static_cast<int64_t>(std::floor(now));
+    if (millisecond == m_millisecond)
+        return m_string;
+
+    int64_t second = millisecond >= 0 ? millisecond / 1000 : (millisecond - 999) / 1000;
+    if (second == m_second) {
+        // "...:SS.mmmZ": only the three digits before the Z change.
+        unsigned ms = static_cast<unsigned>(millisecond - second * 1000);
+        m_buffer[m_length - 4] = '0' + ms / 100;
+        m_buffer[m_length - 3] = '0' + ms / 10 % 10;
+        m_buffer[m_length - 2] = '0' + ms % 10;
+    } else {
+        m_length = toISOString(vm, static_cast<double>(millisecond), m_buffer);
+        m_second = m_length ? second : std::numeric_limits<int64_t>::min();
+    }
+
+    m_millisecond = millisecond;
+    m_string = String(std::span<const LChar> { reinterpret_cast<const LChar*>(m_buffer), m_length });
+    return m_string;
+}
+
+const String& TimestampCache::nowISO(VM& vm)
+{
+    return iso(vm, WTF::jsCurrentTime());
+}
+
+JSC_DEFINE_HOST_FUNCTION(functionBunNowISO, (JSGlobalObject * globalObject, CallFrame*))
+{
+    auto& vm = globalObject->vm();
+    return JSValue::encode(jsString(vm, WebCore::clientData(vm)->timestampCache.nowISO(vm)));
+}
+
+}
+
+// For native loggers that stamp their lines the way Bun.nowISO() does.
+extern "C" BunString Bun__nowISOString(JSC::JSGlobalObject* globalObject)
+{
+    auto& vm = globalObject->vm();
+    return Bun::toStringRef(WebCore::clientData(vm)->timestampCache.nowISO(vm));
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/text/WTFString.h>
+#include <limits>
+
+namespace Bun {
+
+// The current time as an ISO 8601 string, formatted at most once per
+// millisecond.
+//
+// Loggers stamp every line, and most lines written in a burst land in the
+// same millisecond, or at least the same second. A repeat within the
+// millisecond returns the last string. Within the second only the
+// milliseconds are rewritten, so the calendar conversion runs once a second.
+//
+// One cache lives in each VM's client data and is only used on its thread.
+class TimestampCache {
+    WTF_MAKE_NONCOPYABLE(TimestampCache);
+
+public:
+    TimestampCache() = default;
+
+    // `now` is milliseconds since the epoch, as from WTF::jsCurrentTime().
+    const String& iso(JSC::VM&, double now);
+    const String& nowISO(JSC::VM&);
+
+private:
+    String m_string;
+    char m_buffer[64] {};
+    size_t m_length { 0 };
+    int64_t m_millisecond { std::numeric_limits<int64_t>::min() };
+    int64_t m_second { std::numeric_limits<int64_t>::min() };
+};
+
+// Bun.nowISO()
+JSC_DECLARE_HOST_FUNCTION(functionBunNowISO);
+
+}
@@ -28,9 +28,13 @@
 #include <wtf/URLParser.h>
 #include "helpers.h"
 #include "JSURLSearchParams.h"
+#include <wtf/ASCIICType.h>
+#include <bun-uws/src/App.h>
 
 namespace WebCore {
 
+WTF_MAKE_ISO_ALLOCATED_IMPL(URLSearchParams);
+
 extern "C" JSC::EncodedJSValue URLSearchParams__create(JSDOMGlobalObject* globalObject, const ZigString* input)
 {
     String str = Zig::toString(*input);
@@ -38,6 +42,52 @@ extern "C" JSC::EncodedJSValue URLSearchParams__create(JSDOMGlobalObject* global
     return JSC::JSValue::encode(WebCore::toJSNewlyCreated(globalObject, globalObject, WTFMove(result)));
 }
 
+// application/x-www-form-urlencoded decoding of one component. Values uWS already decoded in place
+// (fetched by key before) only need the UTF-8 conversion.
+static String decodeFormComponent(std::string_view component, bool alreadyDecoded)
+{
+    if (alreadyDecoded || component.find_first_of("%+") == std::string_view::npos)
+        return String::fromUTF8ReplacingInvalidSequences({ reinterpret_cast<const LChar*>(component.data()), component.length() });
+
+    Vector<LChar, 64> bytes;
+    bytes.reserveInitialCapacity(component.length());
+    for (size_t i = 0; i < component.length(); i++) {
+        LChar c = component[i];
+        if (c == '+') {
+            c = ' ';
+        } else if (c == '%' && i + 2 < component.length() && isASCIIHexDigit(component[i + 1]) && isASCIIHexDigit(component[i + 2])) {
+            c = toASCIIHexValue(component[i + 1], component[i + 2]);
+            i += 2;
+        }
+        bytes.append(c);
+    }
+    return String::fromUTF8ReplacingInvalidSequences(bytes.span());
+}
+
+// Builds the list from the query index of a uWS request, so the query string is split only once
+extern "C" JSC::EncodedJSValue URLSearchParams__createFromUWS(JSDOMGlobalObject* globalObject, void* uwsRequest)
+{
+    uWS::HttpRequest& req = *reinterpret_cast<uWS::HttpRequest*>(uwsRequest);
+    uWS::QueryIndex& index = req.getQueryIndex();
+
+    Vector<KeyValuePair<String, String>> pairs;
+    pairs.reserveInitialCapacity(index.size());
+    for (unsigned int i = 0; i < index.size(); i++) {
+        auto& parameter = index[i];
+        pairs.append({ decodeFormComponent(parameter.key, false), parameter.value.data() ? decodeFormComponent(parameter.value, parameter.decoded) : emptyString() });
+    }
+
+    // Statements that did not fit in the index
+    std::string_view remainder = req.getQueryIndex().getRemainder();
+    if (remainder.length() > 1) {
+        String rest = String::fromUTF8ReplacingInvalidSequences({ reinterpret_cast<const LChar*>(remainder.data() + 1), remainder.length() - 1 });
+        pairs.appendVector(WTF::URLParser::parseURLEncodedForm(rest));
+    }
+
+    auto result = URLSearchParams::create(WTFMove(pairs));
+    return JSC::JSValue::encode(WebCore::toJSNewlyCreated(globalObject, globalObject, result.releaseReturnValue()));
+}
+
 extern "C" WebCore::URLSearchParams* URLSearchParams__fromJS(JSC::EncodedJSValue value)
 {
     return WebCoreCast<WebCore::JSURLSearchParams, WebCore::URLSearchParams>(value);
@@ -53,10 +103,44 @@ extern "C" void URLSearchParams__toString(WebCore::URLSearchParams* urlSearchPar
     callback(ctx, &zig);
 }
 
+// Whether serializing what `query` parses to gives `query` back, so it can
+// serve as toString() until the list changes. This only accepts the common
+// shape: every `&`-separated piece has exactly one `=` and only characters
+// the serializer leaves alone, plus `+`, which parses to a space and
+// serializes back to `+`.
+template<typename CharacterType>
+static bool serializesToItself(std::span<const CharacterType> query)
+{
+    if (query.empty())
+        return true;
+
+    bool sawEquals = false;
+    for (auto character : query) {
+        if (character == '&') {
+            if (!sawEquals)
+                return false;
+            sawEquals = false;
+        } else if (character == '=') {
+            if (sawEquals)
+                return false;
+            sawEquals = true;
+        } else if (!isASCIIAlphanumeric(character) && character != '*' && character != '-' && character != '.' && character != '_' && character != '+')
+            return false;
+    }
+    return sawEquals;
+}
+
+static bool serializesToItself(StringView query)
+{
+    if (query.is8Bit())
+        return serializesToItself(query.span8());
+    return serializesToItself(query.span16());
+}
+
 URLSearchParams::URLSearchParams(const String& init, DOMURL* associatedURL)
     : m_associatedURL(associatedURL)
-    , m_pairs(init.startsWith('?') ? WTF::URLParser::parseURLEncodedForm(StringView(init).substring(1)) : WTF::URLParser::parseURLEncodedForm(init))
 {
+    setQuery(init);
 }
 
 URLSearchParams::URLSearchParams(const Vector<KeyValuePair<String, String>>& pairs)
@@ -79,18 +163,67 @@ ExceptionOr<Ref<URLSearchParams>> URLSearchParams::create(std::variant<Vector<Ve
     return std::visit(visitor, variant);
 }
 
-String URLSearchParams::get(const String& name) const
+void URLSearchParams::setQuery(const String& query)
 {
-    for (const auto& pair : m_pairs) {
-        if (pair.key == name)
-            return pair.value;
+    m_unparsedQuery = query.startsWith('?') ? query.substring(1) : query;
+    m_needsParsing = true;
+    m_pairs.clear();
+    m_firstIndexByName.clear();
+    m_serialization = serializesToItself(m_unparsedQuery) ? m_unparsedQuery : String();
+}
+
+const Vector<KeyValuePair<String, String>>& URLSearchParams::pairs() const
+{
+    if (m_needsParsing) {
+        m_pairs = WTF::URLParser::parseURLEncodedForm(m_unparsedQuery);
+        m_unparsedQuery = String();
+        m_needsParsing = false;
     }
+    return m_pairs;
+}
+
+Vector<KeyValuePair<String, String>>& URLSearchParams::mutablePairs()
+{
+    pairs();
+    m_serialization = String();
+    m_firstIndexByName.clear();
+    return m_pairs;
+}
+
+std::optional<size_t> URLSearchParams::findFirst(const String& name) const
+{
+    auto& pairs = this->pairs();
+    if (pairs.size() <= maximumScannedPairs || name.isNull()) {
+        for (size_t i = 0; i < pairs.size(); i++) {
+            if (pairs[i].key == name)
+                return i;
+        }
+        return std::nullopt;
+    }
+
+    if (m_firstIndexByName.isEmpty()) {
+        for (size_t i = 0; i < pairs.size(); i++)
+            m_firstIndexByName.add(pairs[i].key, i);
+    }
+    auto it = m_firstIndexByName.find(name);
+    if (it == m_firstIndexByName.end())
+        return std::nullopt;
+    return it->value;
+}
+
+String URLSearchParams::get(const String& name) const
+{
+    if (auto index = findFirst(name))
+        return pairs()[*index].value;
     return String();
 }
 
 bool URLSearchParams::has(const String& name, const String& value) const
 {
-    for (const auto& pair : m_pairs) {
+    if (value.isNull())
+        return !!findFirst(name);
+
+    for (const auto& pair : pairs()) {
         if (pair.key == name && (value.isNull() || pair.value == value))
             return true;
     }
@@ -99,7 +232,8 @@ bool URLSearchParams::has(const String& name, const String& value) const
 
 void URLSearchParams::sort()
 {
-    std::stable_sort(m_pairs.begin(), m_pairs.end(), [](const auto& a, const auto& b) {
+    auto& pairs = mutablePairs();
+    std::stable_sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
         return WTF::codePointCompareLessThan(a.key, b.key);
     });
     updateURL();
@@ -108,13 +242,14 @@ void URLSearchParams::sort()
 
 void URLSearchParams::set(const String& name, const String& value)
 {
-    for (auto& pair : m_pairs) {
+    auto& pairs = mutablePairs();
+    for (auto& pair : pairs) {
         if (pair.key != name)
             continue;
         if (pair.value != value)
             pair.value = value;
         bool skippedFirstMatch = false;
-        m_pairs.removeAllMatching([&](const auto& pair) {
+        pairs.removeAllMatching([&](const auto& pair) {
             if (pair.key == name) {
                 if (skippedFirstMatch)
                     return true;
@@ -126,23 +261,24 @@ void URLSearchParams::set(const String& name, const String& value)
         needsSorting = true;
         return;
     }
-    m_pairs.append({ name, value });
+    pairs.append({ name, value });
     needsSorting = true;
     updateURL();
 }
 
 void URLSearchParams::append(const String& name, const String& value)
 {
-    m_pairs.append({ name, value });
+    mutablePairs().append({ name, value });
     updateURL();
     needsSorting = true;
 }
 
 Vector<String> URLSearchParams::getAll(const String& name) const
 {
+    auto& pairs = this->pairs();
     Vector<String> values;
-    values.reserveInitialCapacity(m_pairs.size());
-    for (const auto& pair : m_pairs) {
+    values.reserveInitialCapacity(pairs.size());
+    for (const auto& pair : pairs) {
         if (pair.key == name)
             values.unsafeAppendWithoutCapacityCheck(pair.value);
     }
@@ -152,7 +288,7 @@ Vector<String> URLSearchParams::getAll(const String& name) const
 
 void URLSearchParams::remove(const String& name, const String& value)
 {
-    m_pairs.removeAllMatching([&](const auto& pair) {
+    mutablePairs().removeAllMatching([&](const auto& pair) {
         return pair.key == name && (value.isNull() || pair.value == value);
     });
     updateURL();
@@ -161,20 +297,21 @@ void URLSearchParams::remove(const String& name, const String& value)
 
 String URLSearchParams::toString() const
 {
-    return WTF::URLParser::serialize(m_pairs);
+    if (m_serialization.isNull())
+        m_serialization = WTF::URLParser::serialize(pairs());
+    return m_serialization;
 }
 
 void URLSearchParams::updateURL()
 {
     if (m_associatedURL)
-        m_associatedURL->setSearch(WTF::URLParser::serialize(m_pairs));
+        m_associatedURL->setSearch(toString());
 }
 
 void URLSearchParams::updateFromAssociatedURL()
 {
     ASSERT(m_associatedURL);
-    String search = m_associatedURL->search();
-    m_pairs = search.startsWith('?') ? WTF::URLParser::parseURLEncodedForm(StringView(search).substring(1)) : WTF::URLParser::parseURLEncodedForm(search);
+    setQuery(m_associatedURL->search());
 }
 
 std::optional<KeyValuePair<String, String>> URLSearchParams::Iterator::next()
@@ -26,6 +26,7 @@
 #include "root.h"
 
 #include "ExceptionOr.h"
+#include <wtf/HashMap.h>
 #include <wtf/Vector.h>
 #include <wtf/WeakPtr.h>
 #include <wtf/text/WTFString.h>
@@ -36,6 +37,8 @@ namespace WebCore {
 class DOMURL;
 
 class URLSearchParams : public RefCounted<URLSearchParams> {
+    WTF_MAKE_ISO_ALLOCATED(URLSearchParams);
+
 public:
     ~URLSearchParams();
 
@@ -54,7 +57,7 @@ public:
     String toString() const;
     void updateFromAssociatedURL();
     void sort();
-    size_t size() const { return m_pairs.size(); }
+    size_t size() const { return pairs().size(); }
 
     class Iterator {
     public:
@@ -67,14 +70,31 @@ public:
     };
     Iterator createIterator() { return Iterator { *this }; }
 
+    // Lists longer than this build a name index for get() and has().
+    static constexpr size_t maximumScannedPairs = 16;
+
 private:
-    const Vector<KeyValuePair<String, String>>& pairs() const { return m_pairs; }
+    // Parses the query on first use.
+    const Vector<KeyValuePair<String, String>>& pairs() const;
+    // Parses too, and forgets the serialization and the index.
+    Vector<KeyValuePair<String, String>>& mutablePairs();
+    std::optional<size_t> findFirst(const String& name) const;
+    void setQuery(const String&);
+
     URLSearchParams(const String&, DOMURL*);
     URLSearchParams(const Vector<KeyValuePair<String, String>>&);
     void updateURL();
 
     WeakPtr<DOMURL> m_associatedURL;
-    Vector<KeyValuePair<String, String>> m_pairs;
+    // Routers create one of these per request and often never look at it,
+    // so a query string is only split once something reads the pairs.
+    mutable String m_unparsedQuery;
+    mutable bool m_needsParsing { false };
+    mutable Vector<KeyValuePair<String, String>> m_pairs;
+    // What toString() returns, or null until it is next needed.
+    mutable String m_serialization;
+    // The first index of each name; built only for long lists.
+    mutable HashMap<String, size_t> m_firstIndexByName;
     bool needsSorting { true };
 };
 
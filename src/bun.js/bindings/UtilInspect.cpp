@@ -7,6 +7,7 @@
 #include "JavaScriptCore/JSGlobalObject.h"
 #include "ZigGlobalObject.h"
 #include "JavaScriptCore/ObjectConstructor.h"
+#include "wtf/dtoa.h"
 
 namespace Bun {
 
@@ -68,4 +69,270 @@ extern "C" JSC::EncodedJSValue JSC__JSValue__callCustomInspectFunction(
     RELEASE_AND_RETURN(scope, JSValue::encode(inspectRet));
 }
 
-}
\ No newline at end of file
+// Buffers what is written and hands it to `write` a buffer's worth at a
+// time, so that nothing the size of the whole output is ever built.
+class ChunkedInspectWriter {
+public:
+    using WriteFunction = void (*)(void* ctx, const uint8_t* bytes, size_t length);
+
+    ChunkedInspectWriter(void* ctx, WriteFunction write)
+        : m_ctx(ctx)
+        , m_write(write)
+    {
+    }
+
+    ~ChunkedInspectWriter() { flush(); }
+
+    void append(char c)
+    {
+        if (m_length == sizeof(m_buffer))
+            flush();
+        m_buffer[m_length++] = static_cast<uint8_t>(c);
+    }
+
+    void append(ASCIILiteral literal)
+    {
+        for (size_t i = 0; i < literal.length(); i++)
+            append(literal.characters()[i]);
+    }
+
+    void append(const char* characters)
+    {
+        while (*characters)
+            append(*characters++);
+    }
+
+    // `"` + the string with JSON's escapes + `"`, in UTF-8.
+    template<typename CharacterType>
+    void appendQuoted(std::span<const CharacterType> characters)
+    {
+        append('"');
+        for (size_t i = 0; i < characters.size(); i++) {
+            char32_t c = characters[i];
+            switch (c) {
+            case '"':
+                append("\\\""_s);
+                continue;
+            case '\\':
+                append("\\\\"_s);
+                continue;
+            case '\n':
+                append("\\n"_s);
+                continue;
+            case '\r':
+                append("\\r"_s);
+                continue;
+            case '\t':
+                append("\\t"_s);
+                continue;
+            default:
+                break;
+            }
+            if (c < 0x20) {
+                static constexpr char hex[] = "0123456789abcdef";
+                append("\\u00"_s);
+                append(hex[c >> 4]);
+                append(hex[c & 0xf]);
+                continue;
+            }
+            if constexpr (sizeof(CharacterType) == 2) {
+                if (U16_IS_LEAD(c) && i + 1 < characters.size() && U16_IS_TRAIL(characters[i + 1]))
+                    c = U16_GET_SUPPLEMENTARY(c, characters[++i]);
+                else if (U16_IS_SURROGATE(c))
+                    c = 0xFFFD;
+            }
+            appendUTF8(c);
+        }
+        append('"');
+    }
+
+    void flush()
+    {
+        if (m_length)
+            m_write(m_ctx, m_buffer, m_length);
+        m_length = 0;
+    }
+
+private:
+    void appendUTF8(char32_t c)
+    {
+        if (c < 0x80) {
+            append(static_cast<char>(c));
+        } else if (c < 0x800) {
+            append(static_cast<char>(0xC0 | (c >> 6)));
+            append(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            append(static_cast<char>(0xE0 | (c >> 12)));
+            append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            append(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            append(static_cast<char>(0xF0 | (c >> 18)));
+            append(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+
+    void* m_ctx;
+    WriteFunction m_write;
+    uint8_t m_buffer[4096];
+    size_t m_length { 0 };
+};
+
+static bool isInspectIdentifier(StringImpl* key)
+{
+    if (!key->length())
+        return false;
+    for (unsigned i = 0; i < key->length(); i++) {
+        UChar c = (*key)[i];
+        if (!(isASCIIAlpha(c) || c == '_' || c == '$' || (i && isASCIIDigit(c))))
+            return false;
+    }
+    return true;
+}
+
+// The colors are util.inspect.defaultStyles.
+static void writeInspectPrimitive(ChunkedInspectWriter& writer, JSValue value, const String& string, bool colors)
+{
+    if (value.isString()) {
+        if (colors)
+            writer.append("\x1b[32m"_s);
+        if (string.is8Bit())
+            writer.appendQuoted(string.span8());
+        else
+            writer.appendQuoted(string.span16());
+    } else if (value.isNumber()) {
+        if (colors)
+            writer.append("\x1b[33m"_s);
+        double number = value.asNumber();
+        if (!number && std::signbit(number)) {
+            writer.append("-0"_s);
+        } else {
+            NumberToStringBuffer buffer;
+            writer.append(WTF::numberToString(number, buffer));
+        }
+    } else if (value.isBoolean()) {
+        if (colors)
+            writer.append("\x1b[33m"_s);
+        writer.append(value.asBoolean() ? "true"_s : "false"_s);
+    } else if (value.isNull()) {
+        if (colors)
+            writer.append("\x1b[1m"_s);
+        writer.append("null"_s);
+        if (colors)
+            writer.append("\x1b[22m"_s);
+        return;
+    } else {
+        if (colors)
+            writer.append("\x1b[90m"_s);
+        writer.append("undefined"_s);
+    }
+    if (colors)
+        writer.append("\x1b[39m"_s);
+}
+
+// console.log and util.inspect of a plain object whose own properties are
+// all primitives, written without calling into util.inspect and without
+// building the whole string first, the way the formatter would print it:
+//
+//   {
+//     a: 1,
+//     "b-c": "d",
+//   }
+//
+// Returns false, having written nothing, for anything else: other kinds of
+// objects, symbol keys (which include a custom inspect function), accessors,
+// nested objects, or more than `maxProperties` properties (0 for no limit),
+// so that how long the loop stalls here is bounded. No exception is left on
+// the VM.
+extern "C" bool Bun__inspectFlatObject(
+    Zig::GlobalObject* globalObject,
+    JSC::EncodedJSValue encodedValue,
+    bool colors,
+    size_t maxProperties,
+    void* ctx,
+    void (*write)(void* ctx, const uint8_t* bytes, size_t length))
+{
+    JSValue value = JSValue::decode(encodedValue);
+    if (!value.isObject())
+        return false;
+
+    JSObject* object = asObject(value);
+    Structure* structure = object->structure();
+    if (object->type() != FinalObjectType
+        || structure->storedPrototype() != globalObject->objectPrototype()
+        || structure->hasNonReifiedStaticProperties()
+        || structure->typeInfo().overridesGetOwnPropertySlot()
+        || structure->typeInfo().overridesAnyFormOfGetOwnPropertyNames()
+        || hasIndexedProperties(structure->indexingType())
+        || structure->hasAnyKindOfGetterSetterProperties()
+        || structure->isUncacheableDictionary())
+        return false;
+
+    JSC::VM& vm = globalObject->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+
+    // Collected first, so that nothing is written for an object the
+    // formatter has to print after all. Resolving a rope string can run
+    // out of memory, nothing else here can throw.
+    Vector<std::pair<StringImpl*, JSValue>, 16> properties;
+    bool eligible = true;
+    structure->forEachProperty(vm, [&](const PropertyTableEntry& entry) -> bool {
+        if (entry.key()->isSymbol()) {
+            eligible = false;
+            return false;
+        }
+        if (entry.attributes() & PropertyAttribute::DontEnum)
+            return true;
+        if (maxProperties && properties.size() == maxProperties) {
+            eligible = false;
+            return false;
+        }
+        JSValue propertyValue = object->getDirect(entry.offset());
+        if ((propertyValue.isCell() && !propertyValue.isString()) || propertyValue.isBigInt()) {
+            eligible = false;
+            return false;
+        }
+        properties.append({ entry.key(), propertyValue });
+        return true;
+    });
+    if (!eligible)
+        return false;
+
+    Vector<String, 16> strings;
+    strings.reserveInitialCapacity(properties.size());
+    for (auto& [key, propertyValue] : properties) {
+        strings.append(propertyValue.isString() ? asString(propertyValue)->value(globalObject) : String());
+        if (UNLIKELY(scope.exception())) {
+            scope.clearException();
+            return false;
+        }
+    }
+
+    ChunkedInspectWriter writer(ctx, write);
+    if (properties.isEmpty()) {
+        writer.append("{}"_s);
+        return true;
+    }
+
+    writer.append("{\n"_s);
+    for (size_t i = 0; i < properties.size(); i++) {
+        auto* key = properties[i].first;
+        writer.append("  "_s);
+        if (isInspectIdentifier(key)) {
+            for (unsigned j = 0; j < key->length(); j++)
+                writer.append(static_cast<char>((*key)[j]));
+        } else if (key->is8Bit()) {
+            writer.appendQuoted(key->span8());
+        } else {
+            writer.appendQuoted(key->span16());
+        }
+        writer.append(": "_s);
+        writeInspectPrimitive(writer, properties[i].second, strings[i], colors);
+        writer.append(",\n"_s);
+    }
+    writer.append('}');
+    return true;
+}
+
+}
@@ -47,6 +47,7 @@
 #include "JavaScriptCore/JSSourceCode.h"
 #include "JavaScriptCore/JSString.h"
 #include "JavaScriptCore/JSWeakMap.h"
+#include "JavaScriptCore/JSWeakMapInlines.h"
 #include "JavaScriptCore/LazyClassStructure.h"
 #include "JavaScriptCore/LazyClassStructureInlines.h"
 #include "JavaScriptCore/ObjectConstructor.h"
@@ -61,11 +62,14 @@
 #include "AsyncContextFrame.h"
 #include "BunClientData.h"
 #include "BunClientData.h"
+#include "BunCPUProfiler.h"
+#include "BunGCController.h"
 #include "BunObject.h"
 #include "BunPlugin.h"
 #include "BunProcess.h"
 #include "BunWorkerGlobalScope.h"
 #include "CallSite.h"
+#include "JSCapturedStackTrace.h"
 #include "CallSitePrototype.h"
 #include "CommonJSModuleRecord.h"
 #include "ConsoleObject.h"
@@ -118,6 +122,10 @@
 #include "JSSocketAddress.h"
 #include "JSSQLStatement.h"
 #include "JSStringDecoder.h"
+#include "JSSharedRing.h"
+#include "JSLogger.h"
+#include "JSNodeHTTPRequestHeaders.h"
+#include "JSWorkerPool.h"
 #include "JSTextEncoder.h"
 #include "JSTransformStream.h"
 #include "JSTransformStreamDefaultController.h"
@@ -148,6 +156,8 @@
 #include "UtilInspect.h"
 #include "Base64Helpers.h"
 #include "wtf/text/OrdinalNumber.h"
+#include "wtf/PageBlock.h"
+#include "wtf/NumberOfCores.h"
 
 #if ENABLE(REMOTE_INSPECTOR)
 #include "JavaScriptCore/RemoteInspectorServer.h"
@@ -227,6 +237,16 @@ extern "C" void JSCInitialize(const char* envp[], size_t envc, void (*onCrash)(c
         JSC::Options::showPrivateScriptsInStackTraces() = true;
 #endif
         JSC::Options::useSetMethods() = true;
+        Bun::configureHeapLimits();
+
+        // Wasm compiles a module's functions in parallel, on its own
+        // worklist. Give that worklist every core so that a large module
+        // is ready sooner. BUN_JSC_numberOfWasmCompilerThreads below still
+        // wins. setOption() leaves things alone on a JSC without the option.
+        {
+            auto wasmCompilerThreads = makeString("numberOfWasmCompilerThreads="_s, WTF::numberOfProcessorCores());
+            JSC::Options::setOption(wasmCompilerThreads.utf8().data());
+        }
 
         if (LIKELY(envc > 0)) {
             while (envc--) {
@@ -402,7 +422,7 @@ WTF::String Bun::formatStackTrace(
                     }
 
                     // This ensures the lifetime of the sourceURL is accounted for correctly
-                    Bun__remapStackFramePositions(globalObject, &remappedFrame, 1);
+                    Bun::remapStackFramePositions(globalObject, &remappedFrame, 1);
                 }
 
                 // there is always a newline before each stack frame line, ensuring that the name + message
@@ -505,7 +525,7 @@ WTF::String Bun::formatStackTrace(
                 }
 
                 // This ensures the lifetime of the sourceURL is accounted for correctly
-                Bun__remapStackFramePositions(globalObject, &remappedFrame, 1);
+                Bun::remapStackFramePositions(globalObject, &remappedFrame, 1);
             }
 
             if (!hasSet) {
@@ -571,6 +591,39 @@ static String computeErrorInfoWithoutPrepareStackTrace(
     return Bun::formatStackTrace(vm, globalObject, name, message, line, column, sourceURL, stackTrace, errorInstance);
 }
 
+// Moves each CallSite to where its frame is in the original source.
+static void remapCallSites(JSC::JSGlobalObject* lexicalGlobalObject, JSCStackTrace& stackTrace, JSC::JSArray* callSites)
+{
+    size_t framesCount = stackTrace.size();
+    Vector<ZigStackFrame, 64> remappedFrames(framesCount);
+    for (size_t i = 0; i < framesCount; i++) {
+        remappedFrames[i] = {};
+        remappedFrames[i].source_url = Bun::toString(lexicalGlobalObject, stackTrace.at(i).sourceURL());
+        if (JSCStackFrame::SourcePositions* sourcePositions = stackTrace.at(i).getSourcePositions()) {
+            remappedFrames[i].position.line_zero_based = sourcePositions->line.zeroBasedInt();
+            remappedFrames[i].position.column_zero_based = sourcePositions->column.zeroBasedInt();
+        } else {
+            remappedFrames[i].position.line_zero_based = -1;
+            remappedFrames[i].position.column_zero_based = -1;
+        }
+    }
+
+    // remap line and column start to original source
+    // XXX: this function does not fully populate the fields of ZigStackFrame,
+    // be careful reading the fields below.
+    Bun::remapStackFramePositions(lexicalGlobalObject, remappedFrames.data(), framesCount);
+
+    // write the remapped lines back to the CallSites
+    for (size_t i = 0; i < framesCount; i++) {
+        JSC::JSValue callSiteValue = callSites->getIndex(lexicalGlobalObject, i);
+        CallSite* callSite = JSC::jsDynamicCast<CallSite*>(callSiteValue);
+        if (remappedFrames[i].remapped) {
+            callSite->setColumnNumber(remappedFrames[i].position.column());
+            callSite->setLineNumber(remappedFrames[i].position.line());
+        }
+    }
+}
+
 static String computeErrorInfoWithPrepareStackTrace(JSC::VM& vm, Zig::GlobalObject* globalObject, JSC::JSGlobalObject* lexicalGlobalObject, Vector<StackFrame>& stackFrames, OrdinalNumber& line, OrdinalNumber& column, String& sourceURL, JSObject* errorObject, JSObject* prepareStackTrace)
 {
     auto scope = DECLARE_THROW_SCOPE(vm);
@@ -586,32 +639,8 @@ static String computeErrorInfoWithPrepareStackTrace(JSC::VM& vm, Zig::GlobalObje
     GlobalObject::createCallSitesFromFrames(globalObject, lexicalGlobalObject, stackTrace, callSites);
 
     // We need to sourcemap it if it's a GlobalObject.
-    if (globalObject == lexicalGlobalObject) {
-        size_t framesCount = stackTrace.size();
-        ZigStackFrame remappedFrames[framesCount];
-        for (int i = 0; i < framesCount; i++) {
-            remappedFrames[i] = {};
-            remappedFrames[i].source_url = Bun::toString(lexicalGlobalObject, stackTrace.at(i).sourceURL());
-            if (JSCStackFrame::SourcePositions* sourcePositions = stackTrace.at(i).getSourcePositions()) {
-                remappedFrames[i].position.line_zero_based = sourcePositions->line.zeroBasedInt();
-                remappedFrames[i].position.column_zero_based = sourcePositions->column.zeroBasedInt();
-            } else {
-                remappedFrames[i].position.line_zero_based = -1;
-                remappedFrames[i].position.column_zero_based = -1;
-            }
-        }
-
-        Bun__remapStackFramePositions(globalObject, remappedFrames, framesCount);
-
-        for (size_t i = 0; i < framesCount; i++) {
-            JSC::JSValue callSiteValue = callSites->getIndex(lexicalGlobalObject, i);
-            CallSite* callSite = JSC::jsDynamicCast<CallSite*>(callSiteValue);
-            if (remappedFrames[i].remapped) {
-                callSite->setColumnNumber(remappedFrames[i].position.column());
-                callSite->setLineNumber(remappedFrames[i].position.line());
-            }
-        }
-    }
+    if (globalObject == lexicalGlobalObject)
+        remapCallSites(lexicalGlobalObject, stackTrace, callSites);
 
     JSValue value = formatStackTraceToJSValue(vm, jsDynamicCast<Zig::GlobalObject*>(lexicalGlobalObject), lexicalGlobalObject, errorObject, callSites, prepareStackTrace);
 
@@ -770,6 +799,10 @@ extern "C" JSC__JSGlobalObject* Zig__GlobalObject__create(void* console_client,
     globalObject->setStackTraceLimit(DEFAULT_ERROR_STACK_TRACE_LIMIT); // Node.js defaults to 10
     vm.setOnComputeErrorInfo(computeErrorInfoWrapper);
 
+    if (!worker_ptr)
+        Bun::installCPUProfilerSignalHandler();
+    Bun::installGCController(globalObject);
+
     JSC::gcProtect(globalObject);
 
     vm.setOnEachMicrotaskTick([](JSC::VM& vm) -> void {
@@ -1611,6 +1644,55 @@ extern "C" JSC__JSValue ArrayBuffer__fromSharedMemfd(int64_t fd, JSC::JSGlobalOb
 #endif
 }
 
+// Bun.file(path).arrayBuffer() and bytes() for a large file that is only
+// read: the buffer is a private, copy-on-write mapping of the file, so it
+// shares the page cache with every other mapping and read of that file,
+// and costs no copy until the buffer is written to. Each call maps again,
+// since writes to one buffer must not show up in another. The file must
+// not shrink while the buffer is alive, as touching pages past its end
+// raises SIGBUS. Returns an empty value, for the caller to read the file
+// instead, when the range can not be mapped.
+extern "C" JSC__JSValue ArrayBuffer__fromFileMapping(JSC::JSGlobalObject* globalObject, int64_t fd, size_t byteOffset, size_t byteLength, JSC::JSType type)
+{
+#if !OS(WINDOWS)
+    if (byteLength == 0) {
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    size_t pageSize = WTF::pageSize();
+    size_t mappingOffset = byteOffset & ~(pageSize - 1);
+    size_t mappingLength = byteLength + (byteOffset - mappingOffset);
+    auto ptr = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(mappingOffset));
+
+    if (ptr == MAP_FAILED) {
+        return JSC::JSValue::encode(JSC::JSValue {});
+    }
+
+    auto buffer = ArrayBuffer::createFromBytes(reinterpret_cast<char*>(ptr) + (byteOffset - mappingOffset), byteLength, createSharedTask<void(void*)>([ptr, mappingLength](void* p) {
+        munmap(ptr, mappingLength);
+    }));
+
+    if (type == JSC::Uint8ArrayType) {
+        auto uint8array = JSC::JSUint8Array::create(globalObject, globalObject->m_typedArrayUint8.get(globalObject), WTFMove(buffer), 0, byteLength);
+        return JSValue::encode(uint8array);
+    }
+
+    if (type == JSC::ArrayBufferType) {
+        Structure* structure = globalObject->arrayBufferStructure(JSC::ArrayBufferSharingMode::Default);
+
+        if (UNLIKELY(!structure)) {
+            return JSC::JSValue::encode(JSC::JSValue {});
+        }
+
+        return JSValue::encode(JSC::JSArrayBuffer::create(globalObject->vm(), structure, WTFMove(buffer)));
+    } else {
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+#else
+    return JSC::JSValue::encode(JSC::JSValue {});
+#endif
+}
+
 extern "C" JSC__JSValue Bun__createArrayBufferForCopy(JSC::JSGlobalObject* globalObject, const void* ptr, size_t len)
 {
     auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
@@ -1787,6 +1869,7 @@ JSC_DECLARE_HOST_FUNCTION(makeDOMExceptionForBuiltins);
 JSC_DECLARE_HOST_FUNCTION(createWritableStreamFromInternal);
 JSC_DECLARE_HOST_FUNCTION(getInternalWritableStream);
 JSC_DECLARE_HOST_FUNCTION(isAbortSignal);
+JSC_DECLARE_HOST_FUNCTION(isNativeSink);
 
 JSC_DEFINE_HOST_FUNCTION(makeThisTypeErrorForBuiltins, (JSGlobalObject * globalObject, CallFrame* callFrame))
 {
@@ -1903,6 +1986,13 @@ JSC_DEFINE_HOST_FUNCTION(isAbortSignal, (JSGlobalObject*, CallFrame* callFrame))
     return JSValue::encode(jsBoolean(callFrame->uncheckedArgument(0).inherits<JSAbortSignal>()));
 }
 
+JSC_DEFINE_HOST_FUNCTION(isNativeSink, (JSGlobalObject*, CallFrame* callFrame))
+{
+    ASSERT(callFrame->argumentCount() == 1);
+    JSValue value = callFrame->uncheckedArgument(0);
+    return JSValue::encode(jsBoolean(value.inherits<JSFileSink>() || value.inherits<JSHTTPResponseSink>() || value.inherits<JSHTTPSResponseSink>() || value.inherits<JSArrayBufferSink>()));
+}
+
 extern "C" void ReadableStream__cancel(JSC__JSValue possibleReadableStream, Zig::GlobalObject* globalObject);
 extern "C" void ReadableStream__cancel(JSC__JSValue possibleReadableStream, Zig::GlobalObject* globalObject)
 {
@@ -2452,6 +2542,60 @@ JSC_DEFINE_HOST_FUNCTION(jsFunctionDefaultErrorPrepareStackTrace, (JSGlobalObjec
     return JSC::JSValue::encode(result);
 }
 
+static Zig::GlobalObject* globalObjectForCapturedStackTraces(JSC::JSGlobalObject* lexicalGlobalObject)
+{
+    if (auto* globalObject = jsDynamicCast<Zig::GlobalObject*>(lexicalGlobalObject))
+        return globalObject;
+    // node:vm will use a different JSGlobalObject
+    return Bun__getDefaultGlobal();
+}
+
+JSC_DEFINE_CUSTOM_GETTER(capturedStackTraceGetter, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, JSC::PropertyName))
+{
+    auto* globalObject = globalObjectForCapturedStackTraces(lexicalGlobalObject);
+    JSC::VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSC::JSObject* errorObject = JSC::JSValue::decode(thisValue).getObject();
+    if (!errorObject)
+        return JSC::JSValue::encode(jsUndefined());
+    auto* captured = jsDynamicCast<JSCapturedStackTrace*>(globalObject->capturedStackTraces()->get(errorObject));
+    if (!captured)
+        return JSC::JSValue::encode(jsUndefined());
+    globalObject->capturedStackTraces()->remove(errorObject);
+
+    JSCStackTrace stackTrace = JSCStackTrace::fromExisting(vm, captured->frames());
+
+    // Note: we cannot use tryCreateUninitializedRestricted here because we cannot allocate memory inside initializeIndex()
+    JSC::JSArray* callSites = JSC::JSArray::create(vm,
+        globalObject->arrayStructureForIndexingTypeDuringAllocation(JSC::ArrayWithContiguous),
+        stackTrace.size());
+
+    GlobalObject::createCallSitesFromFrames(globalObject, lexicalGlobalObject, stackTrace, callSites);
+    remapCallSites(lexicalGlobalObject, stackTrace, callSites);
+
+    // Replaces this accessor with the value, as if it had been there all along.
+    globalObject->formatStackTrace(vm, lexicalGlobalObject, errorObject, callSites, JSC::JSValue());
+    RETURN_IF_EXCEPTION(scope, JSC::JSValue::encode({}));
+
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(errorObject->getDirect(vm, vm.propertyNames->stack)));
+}
+
+JSC_DEFINE_CUSTOM_SETTER(capturedStackTraceSetter, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, JSC::EncodedJSValue value, JSC::PropertyName))
+{
+    auto* globalObject = globalObjectForCapturedStackTraces(lexicalGlobalObject);
+    JSC::VM& vm = globalObject->vm();
+
+    JSC::JSObject* errorObject = JSC::JSValue::decode(thisValue).getObject();
+    if (!errorObject)
+        return false;
+    globalObject->capturedStackTraces()->remove(errorObject);
+
+    errorObject->deleteProperty(lexicalGlobalObject, vm.propertyNames->stack);
+    errorObject->putDirect(vm, vm.propertyNames->stack, JSC::JSValue::decode(value), 0);
+    return true;
+}
+
 JSC_DEFINE_HOST_FUNCTION(errorConstructorFuncCaptureStackTrace, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
     GlobalObject* globalObject = reinterpret_cast<GlobalObject*>(lexicalGlobalObject);
@@ -2471,6 +2615,29 @@ JSC_DEFINE_HOST_FUNCTION(errorConstructorFuncCaptureStackTrace, (JSC::JSGlobalOb
         stackTraceLimit = DEFAULT_ERROR_STACK_TRACE_LIMIT;
     }
 
+    /* Like v8, only walk the stack here, and format it on the first read of
+     * "stack". Error.prepareStackTrace may want each CallSite's "this", which
+     * is gone once we return, so with one installed it is all done now. */
+    JSValue prepareStackTrace = globalObject->m_errorConstructorPrepareStackTraceValue.get();
+    if (!prepareStackTrace || !prepareStackTrace.isCallable()) {
+        auto* captured = JSCapturedStackTrace::create(vm, globalObject->capturedStackTraceStructure());
+        Vector<JSC::StackFrame> frames;
+        JSCStackTrace::captureCurrentStackFrames(globalObject, callFrame, stackTraceLimit, caller, captured, frames);
+        captured->setFrames(vm, WTFMove(frames));
+
+        bool originalSkipNextComputeErrorInfo = skipNextComputeErrorInfo;
+        skipNextComputeErrorInfo = true;
+        errorObject->deleteProperty(lexicalGlobalObject, vm.propertyNames->stack);
+        skipNextComputeErrorInfo = originalSkipNextComputeErrorInfo;
+        RETURN_IF_EXCEPTION(scope, JSC::JSValue::encode({}));
+
+        errorObject->putDirectCustomAccessor(vm, vm.propertyNames->stack,
+            JSC::CustomGetterSetter::create(vm, capturedStackTraceGetter, capturedStackTraceSetter),
+            JSC::PropertyAttribute::CustomAccessor | 0);
+        globalObject->capturedStackTraces()->set(vm, errorObject, captured);
+        return JSC::JSValue::encode(JSC::jsUndefined());
+    }
+
     JSCStackTrace stackTrace = JSCStackTrace::captureCurrentJSStackTrace(globalObject, callFrame, stackTraceLimit, caller);
 
     // Note: we cannot use tryCreateUninitializedRestricted here because we cannot allocate memory inside initializeIndex()
@@ -2480,43 +2647,7 @@ JSC_DEFINE_HOST_FUNCTION(errorConstructorFuncCaptureStackTrace, (JSC::JSGlobalOb
 
     // Create the call sites (one per frame)
     GlobalObject::createCallSitesFromFrames(globalObject, lexicalGlobalObject, stackTrace, callSites);
-
-    /* Format the stack trace.
-     * Note that v8 won't actually format the stack trace here, but will create a "stack" accessor
-     * on the error object, which will format the stack trace on the first access. For now, since
-     * we're not being used internally by JSC, we can assume callers of Error.captureStackTrace in
-     * node are interested in the (formatted) stack. */
-
-    size_t framesCount = stackTrace.size();
-    ZigStackFrame remappedFrames[64];
-    framesCount = framesCount > 64 ? 64 : framesCount;
-
-    for (int i = 0; i < framesCount; i++) {
-        memset(remappedFrames + i, 0, sizeof(ZigStackFrame));
-        remappedFrames[i].source_url = Bun::toString(lexicalGlobalObject, stackTrace.at(i).sourceURL());
-        if (JSCStackFrame::SourcePositions* sourcePositions = stackTrace.at(i).getSourcePositions()) {
-            remappedFrames[i].position.line_zero_based = sourcePositions->line.zeroBasedInt();
-            remappedFrames[i].position.column_zero_based = sourcePositions->column.zeroBasedInt();
-        } else {
-            remappedFrames[i].position.line_zero_based = -1;
-            remappedFrames[i].position.column_zero_based = -1;
-        }
-    }
-
-    // remap line and column start to original source
-    // XXX: this function does not fully populate the fields of ZigStackFrame,
-    // be careful reading the fields below.
-    Bun__remapStackFramePositions(lexicalGlobalObject, remappedFrames, framesCount);
-
-    // write the remapped lines back to the CallSites
-    for (size_t i = 0; i < framesCount; i++) {
-        JSC::JSValue callSiteValue = callSites->getIndex(lexicalGlobalObject, i);
-        CallSite* callSite = JSC::jsDynamicCast<CallSite*>(callSiteValue);
-        if (remappedFrames[i].remapped) {
-            callSite->setColumnNumber(remappedFrames[i].position.column());
-            callSite->setLineNumber(remappedFrames[i].position.line());
-        }
-    }
+    remapCallSites(lexicalGlobalObject, stackTrace, callSites);
 
     globalObject->formatStackTrace(vm, lexicalGlobalObject, errorObject, callSites, JSC::JSValue());
     RETURN_IF_EXCEPTION(scope, JSC::JSValue::encode({}));
@@ -2608,6 +2739,11 @@ void GlobalObject::finishCreation(VM& vm)
             init.set(JSSocketAddress::createStructure(init.vm, init.owner));
         });
 
+    m_JSNodeHTTPRequestHeadersStructure.initLater(
+        [](const Initializer<Structure>& init) {
+            init.set(Bun::JSNodeHTTPRequestHeaders::createStructure(init.vm, init.owner, init.owner->objectPrototype()));
+        });
+
     m_errorConstructorPrepareStackTraceInternalValue.initLater(
         [](const Initializer<JSFunction>& init) {
             init.set(JSFunction::create(init.vm, init.owner, 2, "ErrorPrepareStackTrace"_s, jsFunctionDefaultErrorPrepareStackTrace, ImplementationVisibility::Public));
@@ -2624,6 +2760,30 @@ void GlobalObject::finishCreation(VM& vm)
             init.set(JSWeakMap::create(init.vm, init.owner->weakMapStructure()));
         });
 
+    m_vmModuleScriptCache.initLater(
+        [](const Initializer<JSMap>& init) {
+            init.set(JSMap::create(init.vm, init.owner->mapStructure()));
+        });
+
+    m_vmModuleSharedContextProxy.initLater(
+        [](const Initializer<JSGlobalProxy>& init) {
+            auto* owner = reinterpret_cast<Zig::GlobalObject*>(init.owner);
+            auto* target = JSC::JSGlobalObject::create(init.vm, owner->globalObjectStructure());
+            auto* proxy = JSGlobalProxy::create(init.vm, owner->globalProxyStructure());
+            proxy->setTarget(init.vm, target);
+            init.set(proxy);
+        });
+
+    m_capturedStackTraces.initLater(
+        [](const Initializer<JSWeakMap>& init) {
+            init.set(JSWeakMap::create(init.vm, init.owner->weakMapStructure()));
+        });
+
+    m_capturedStackTraceStructure.initLater(
+        [](const Initializer<Structure>& init) {
+            init.set(Zig::JSCapturedStackTrace::createStructure(init.vm, init.owner, jsNull()));
+        });
+
     m_JSBufferSubclassStructure.initLater(
         [](const Initializer<Structure>& init) {
             auto* globalObject = reinterpret_cast<Zig::GlobalObject*>(init.owner);
@@ -3016,6 +3176,42 @@ void GlobalObject::finishCreation(VM& vm)
             init.setConstructor(constructor);
         });
 
+    m_JSLoggerClassStructure.initLater(
+        [](LazyClassStructure::Initializer& init) {
+            auto* prototype = Bun::JSLoggerPrototype::create(
+                init.vm, init.global, Bun::JSLoggerPrototype::createStructure(init.vm, init.global, init.global->objectPrototype()));
+            auto* structure = Bun::JSLogger::createStructure(init.vm, init.global, prototype);
+            auto* constructor = Bun::JSLoggerConstructor::create(
+                init.vm, Bun::JSLoggerConstructor::createStructure(init.vm, init.global, init.global->functionPrototype()), prototype);
+            init.setPrototype(prototype);
+            init.setStructure(structure);
+            init.setConstructor(constructor);
+        });
+
+    m_JSSharedRingClassStructure.initLater(
+        [](LazyClassStructure::Initializer& init) {
+            auto* prototype = Bun::JSSharedRingPrototype::create(
+                init.vm, init.global, Bun::JSSharedRingPrototype::createStructure(init.vm, init.global, init.global->objectPrototype()));
+            auto* structure = Bun::JSSharedRing::createStructure(init.vm, init.global, prototype);
+            auto* constructor = Bun::JSSharedRingConstructor::create(
+                init.vm, Bun::JSSharedRingConstructor::createStructure(init.vm, init.global, init.global->functionPrototype()), prototype);
+            init.setPrototype(prototype);
+            init.setStructure(structure);
+            init.setConstructor(constructor);
+        });
+
+    m_JSWorkerPoolClassStructure.initLater(
+        [](LazyClassStructure::Initializer& init) {
+            auto* prototype = Bun::JSWorkerPoolPrototype::create(
+                init.vm, init.global, Bun::JSWorkerPoolPrototype::createStructure(init.vm, init.global, init.global->objectPrototype()));
+            auto* structure = Bun::JSWorkerPool::createStructure(init.vm, init.global, prototype);
+            auto* constructor = Bun::JSWorkerPoolConstructor::create(
+                init.vm, Bun::JSWorkerPoolConstructor::createStructure(init.vm, init.global, init.global->functionPrototype()), prototype);
+            init.setPrototype(prototype);
+            init.setStructure(structure);
+            init.setConstructor(constructor);
+        });
+
     m_JSFFIFunctionStructure.initLater(
         [](LazyClassStructure::Initializer& init) {
             init.setStructure(Zig::JSFFIFunction::createStructure(init.vm, init.global, init.global->functionPrototype()));
@@ -3289,6 +3485,7 @@ void GlobalObject::addBuiltinGlobals(JSC::VM& vm)
         GlobalPropertyInfo(builtinNames.cloneArrayBufferPrivateName(), JSFunction::create(vm, this, 3, String(), cloneArrayBuffer, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
         GlobalPropertyInfo(builtinNames.structuredCloneForStreamPrivateName(), JSFunction::create(vm, this, 1, String(), structuredCloneForStream, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
         GlobalPropertyInfo(builtinNames.isAbortSignalPrivateName(), JSFunction::create(vm, this, 1, String(), isAbortSignal, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
+        GlobalPropertyInfo(builtinNames.isNativeSinkPrivateName(), JSFunction::create(vm, this, 1, String(), isNativeSink, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
         GlobalPropertyInfo(builtinNames.getInternalWritableStreamPrivateName(), JSFunction::create(vm, this, 1, String(), getInternalWritableStream, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
         GlobalPropertyInfo(builtinNames.createWritableStreamFromInternalPrivateName(), JSFunction::create(vm, this, 1, String(), createWritableStreamFromInternal, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
         GlobalPropertyInfo(builtinNames.fulfillModuleSyncPrivateName(), JSFunction::create(vm, this, 1, String(), functionFulfillModuleSync, ImplementationVisibility::Public), PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly),
@@ -3471,6 +3668,11 @@ void GlobalObject::visitChildrenImpl(JSCell* cell, Visitor& visitor)
     thisObject->m_JSHTTPSResponseControllerPrototype.visit(visitor);
     thisObject->m_JSHTTPSResponseSinkClassStructure.visit(visitor);
     thisObject->m_JSSocketAddressStructure.visit(visitor);
+    visitor.append(thisObject->m_lastSocketAddress);
+    thisObject->m_JSNodeHTTPRequestHeadersStructure.visit(visitor);
+    thisObject->m_JSSharedRingClassStructure.visit(visitor);
+    thisObject->m_JSLoggerClassStructure.visit(visitor);
+    thisObject->m_JSWorkerPoolClassStructure.visit(visitor);
     thisObject->m_JSSQLStatementStructure.visit(visitor);
     thisObject->m_JSStringDecoderClassStructure.visit(visitor);
     thisObject->m_lazyPreloadTestModuleObject.visit(visitor);
@@ -3501,6 +3703,10 @@ void GlobalObject::visitChildrenImpl(JSCell* cell, Visitor& visitor)
     thisObject->m_utilInspectStylizeColorFunction.visit(visitor);
     thisObject->m_utilInspectStylizeNoColorFunction.visit(visitor);
     thisObject->m_vmModuleContextMap.visit(visitor);
+    thisObject->m_vmModuleScriptCache.visit(visitor);
+    thisObject->m_vmModuleSharedContextProxy.visit(visitor);
+    thisObject->m_capturedStackTraces.visit(visitor);
+    thisObject->m_capturedStackTraceStructure.visit(visitor);
     thisObject->mockModule.activeSpySetStructure.visit(visitor);
     thisObject->mockModule.mockFunctionStructure.visit(visitor);
     thisObject->mockModule.mockImplementationStructure.visit(visitor);
@@ -3514,6 +3720,14 @@ void GlobalObject::visitChildrenImpl(JSCell* cell, Visitor& visitor)
         visitor.append(barrier);
     }
 
+    for (auto& barrier : thisObject->m_asyncContextFrameCache) {
+        visitor.append(barrier);
+    }
+
+    for (auto& barrier : thisObject->m_diagnosticsChannelPublishers) {
+        visitor.append(barrier);
+    }
+
     thisObject->visitGeneratedLazyClasses<Visitor>(thisObject, visitor);
     thisObject->visitAdditionalChildren<Visitor>(visitor);
 }
@@ -3659,6 +3873,7 @@ void GlobalObject::reload()
 
     registry->clear(this->vm());
     this->requireMap()->clear(this->vm());
+    this->moduleGraph.clear();
 
     // If we run the GC every time, we will never get the SourceProvider cache hit.
     // So we run the GC every other time.
@@ -3673,6 +3888,44 @@ extern "C" void JSC__JSGlobalObject__reload(JSC__JSGlobalObject* arg0)
     globalObject->reload();
 }
 
+bool GlobalObject::reloadModules(const Vector<String>& changed)
+{
+    if (!this->moduleGraph.isEnabled())
+        return false;
+
+    auto& vm = this->vm();
+    JSModuleLoader* moduleLoader = this->moduleLoader();
+    JSC::JSMap* registry = jsCast<JSC::JSMap*>(moduleLoader->get(
+        this,
+        Identifier::fromString(vm, "registry"_s)));
+    JSC::JSMap* requireMap = this->requireMap();
+
+    for (auto& key : this->moduleGraph.invalidate(changed)) {
+        JSValue keyValue = jsString(vm, key);
+        registry->remove(this, keyValue);
+        requireMap->remove(this, keyValue);
+    }
+
+    return true;
+}
+
+extern "C" void JSC__JSGlobalObject__enableModuleGraph(JSC__JSGlobalObject* arg0)
+{
+    reinterpret_cast<Zig::GlobalObject*>(arg0)->moduleGraph.enable();
+}
+
+// Called by --hot with the paths the watcher saw change, before it imports
+// the entry point again. On false it has to reload() instead.
+extern "C" bool JSC__JSGlobalObject__reloadModules(JSC__JSGlobalObject* arg0, const BunString* paths, size_t count)
+{
+    Vector<String> changed;
+    changed.reserveInitialCapacity(count);
+    for (size_t i = 0; i < count; i++)
+        changed.append(paths[i].toWTFString());
+
+    return reinterpret_cast<Zig::GlobalObject*>(arg0)->reloadModules(changed);
+}
+
 extern "C" void JSC__JSGlobalObject__queueMicrotaskCallback(Zig::GlobalObject* globalObject, void* ptr, MicrotaskCallback callback)
 {
     JSFunction* function = globalObject->nativeMicrotaskTrampoline();
@@ -3727,7 +3980,10 @@ JSC::Identifier GlobalObject::moduleLoaderResolve(JSGlobalObject* jsGlobalObject
             return JSC::Identifier::fromString(globalObject->vm(), makeString(res.result.value.toWTFString(BunString::ZeroCopy), Zig::toString(queryString)));
         }
 
-        return Identifier::fromString(globalObject->vm(), res.result.value.toWTFString(BunString::ZeroCopy));
+        auto resolved = Identifier::fromString(globalObject->vm(), res.result.value.toWTFString(BunString::ZeroCopy));
+        if (UNLIKELY(globalObject->moduleGraph.isEnabled()) && referrer.isString())
+            globalObject->moduleGraph.addImport(resolved.string(), jsCast<JSString*>(referrer)->value(globalObject));
+        return resolved;
     } else {
         auto scope = DECLARE_THROW_SCOPE(globalObject->vm());
         throwException(scope, res.result.err, globalObject);
@@ -10,6 +10,7 @@
 #define ZIG_GLOBAL_OBJECT
 
 namespace JSC {
+class ArrayBuffer;
 class Structure;
 class Identifier;
 class LazyClassStructure;
@@ -44,6 +45,11 @@ class InternalModuleRegistry;
 #include "WebCoreJSBuiltins.h"
 #include "headers-handwritten.h"
 #include "BunCommonStrings.h"
+#include "RequireResolveCache.h"
+#include "ModuleGraph.h"
+#include "SourceMapPositionCache.h"
+#include "TimerWheel.h"
+#include "NodeDiagnosticsChannel.h"
 
 namespace WebCore {
 class GlobalScope;
@@ -233,6 +239,15 @@ public:
     JSC::JSObject* JSStringDecoder() const { return m_JSStringDecoderClassStructure.constructorInitializedOnMainThread(this); }
     JSC::JSValue JSStringDecoderPrototype() const { return m_JSStringDecoderClassStructure.prototypeInitializedOnMainThread(this); }
 
+    JSC::Structure* JSLoggerStructure() const { return m_JSLoggerClassStructure.getInitializedOnMainThread(this); }
+    JSC::JSObject* JSLogger() const { return m_JSLoggerClassStructure.constructorInitializedOnMainThread(this); }
+
+    JSC::Structure* JSSharedRingStructure() const { return m_JSSharedRingClassStructure.getInitializedOnMainThread(this); }
+    JSC::JSObject* JSSharedRing() const { return m_JSSharedRingClassStructure.constructorInitializedOnMainThread(this); }
+
+    JSC::Structure* JSWorkerPoolStructure() const { return m_JSWorkerPoolClassStructure.getInitializedOnMainThread(this); }
+    JSC::JSObject* JSWorkerPool() const { return m_JSWorkerPoolClassStructure.constructorInitializedOnMainThread(this); }
+
     JSC::Structure* NodeVMScriptStructure() const { return m_NodeVMScriptClassStructure.getInitializedOnMainThread(this); }
     JSC::JSObject* NodeVMScript() const { return m_NodeVMScriptClassStructure.constructorInitializedOnMainThread(this); }
     JSC::JSValue NodeVMScriptPrototype() const { return m_NodeVMScriptClassStructure.prototypeInitializedOnMainThread(this); }
@@ -271,8 +286,17 @@ public:
     Structure* AsyncContextFrameStructure() const { return m_asyncBoundFunctionStructure.getInitializedOnMainThread(this); }
 
     Structure* JSSocketAddressStructure() const { return m_JSSocketAddressStructure.getInitializedOnMainThread(this); }
+    Structure* JSNodeHTTPRequestHeadersStructure() const { return m_JSNodeHTTPRequestHeadersStructure.getInitializedOnMainThread(this); }
 
     JSWeakMap* vmModuleContextMap() const { return m_vmModuleContextMap.getInitializedOnMainThread(this); }
+    // Source strings run by node:vm, to the internal Script compiled for them.
+    JSMap* vmModuleScriptCache() const { return m_vmModuleScriptCache.getInitializedOnMainThread(this); }
+    // The one global behind every createContext(object, { sharedGlobal: true }).
+    JSGlobalProxy* vmModuleSharedContextProxy() const { return m_vmModuleSharedContextProxy.getInitializedOnMainThread(this); }
+    // Objects given to Error.captureStackTrace whose `stack` was never read,
+    // to their JSCapturedStackTrace.
+    JSWeakMap* capturedStackTraces() const { return m_capturedStackTraces.getInitializedOnMainThread(this); }
+    Structure* capturedStackTraceStructure() const { return m_capturedStackTraceStructure.getInitializedOnMainThread(this); }
 
     Structure* NapiExternalStructure() const { return m_NapiExternalStructure.getInitializedOnMainThread(this); }
     Structure* NapiPrototypeStructure() const { return m_NapiPrototypeStructure.getInitializedOnMainThread(this); }
@@ -391,6 +415,18 @@ public:
     // mutable WriteBarrier<Unknown> m_JSBunDebuggerValue;
     mutable WriteBarrier<JSFunction> m_thenables[promiseFunctionsSize + 1];
 
+    // AsyncContextFrames handed out recently, by their callback and
+    // context. See AsyncContextFrame::withAsyncContextIfNeeded().
+    static constexpr size_t asyncContextFrameCacheSize = 64;
+    mutable WriteBarrier<JSC::Unknown> m_asyncContextFrameCache[asyncContextFrameCacheSize];
+
+    // The publish function of each native diagnostics channel, or null while
+    // the channel has no subscribers. See NodeDiagnosticsChannel.h.
+    JSC::JSObject* diagnosticsChannelPublisher(Bun::DiagnosticsChannel channel) const { return m_diagnosticsChannelPublishers[static_cast<size_t>(channel)].get(); }
+    bool hasDiagnosticsChannelSubscribers(Bun::DiagnosticsChannel channel) const { return !!m_diagnosticsChannelPublishers[static_cast<size_t>(channel)]; }
+    void setDiagnosticsChannelPublisher(Bun::DiagnosticsChannel channel, JSC::JSObject* publish) { m_diagnosticsChannelPublishers[static_cast<size_t>(channel)].setMayBeNull(vm(), this, publish); }
+    mutable WriteBarrier<JSC::JSObject> m_diagnosticsChannelPublishers[Bun::diagnosticsChannelCount];
+
     // Error.prepareStackTrace
     mutable WriteBarrier<JSC::Unknown> m_errorConstructorPrepareStackTraceValue;
 
@@ -431,6 +467,13 @@ public:
 
     BunPlugin::OnLoad onLoadPlugins {};
     BunPlugin::OnResolve onResolvePlugins {};
+    Bun::RequireResolveCache requireResolveCache;
+    Bun::ModuleGraph moduleGraph;
+    Bun::SourceMapPositionCache sourceMapPositionCache;
+    Bun::TimerWheel timerWheel;
+    // AbortSignal.timeout()'s timers, kept apart because the nodes of
+    // timerWheel belong to the Zig timers. Both are advanced together.
+    Bun::TimerWheel abortSignalTimers;
 
     // This increases the cache hit rate for JSC::VM's SourceProvider cache
     // It also avoids an extra allocation for the SourceProvider
@@ -439,6 +482,9 @@ public:
     size_t reloadCount = 0;
 
     void reload();
+    // Drops the changed modules and their importers and keeps the rest. False
+    // when the graph is not being tracked, and a full reload() is needed.
+    bool reloadModules(const Vector<String>& changed);
 
     JSC::Structure* pendingVirtualModuleResultStructure() { return m_pendingVirtualModuleResultStructure.get(this); }
 
@@ -458,6 +504,12 @@ public:
 
     Bun::JSMockModule mockModule;
 
+    // Slab that small Buffer.allocUnsafe() results are sliced from. Each slice
+    // holds a reference to it, so a slab lives until its last Buffer is collected.
+    RefPtr<JSC::ArrayBuffer> bufferPool;
+    size_t bufferPoolOffset = 0;
+    size_t bufferPoolSize = 8 * 1024;
+
     LazyProperty<JSGlobalObject, JSObject> m_processEnvObject;
 
     JSObject* cryptoObject() const { return m_cryptoObject.getInitializedOnMainThread(this); }
@@ -500,6 +552,9 @@ public:
     LazyClassStructure m_JSHTTPResponseSinkClassStructure;
     LazyClassStructure m_JSHTTPSResponseSinkClassStructure;
     LazyClassStructure m_JSStringDecoderClassStructure;
+    LazyClassStructure m_JSSharedRingClassStructure;
+    LazyClassStructure m_JSLoggerClassStructure;
+    LazyClassStructure m_JSWorkerPoolClassStructure;
     LazyClassStructure m_NapiClassStructure;
     LazyClassStructure m_callSiteStructure;
     LazyClassStructure m_JSBufferClassStructure;
@@ -534,6 +589,10 @@ public:
     LazyProperty<JSGlobalObject, Structure> m_JSHTTPResponseController;
     LazyProperty<JSGlobalObject, Structure> m_JSBufferSubclassStructure;
     LazyProperty<JSGlobalObject, JSWeakMap> m_vmModuleContextMap;
+    LazyProperty<JSGlobalObject, JSMap> m_vmModuleScriptCache;
+    LazyProperty<JSGlobalObject, JSGlobalProxy> m_vmModuleSharedContextProxy;
+    LazyProperty<JSGlobalObject, JSWeakMap> m_capturedStackTraces;
+    LazyProperty<JSGlobalObject, Structure> m_capturedStackTraceStructure;
     LazyProperty<JSGlobalObject, JSObject> m_lazyRequireCacheObject;
     LazyProperty<JSGlobalObject, JSObject> m_lazyTestModuleObject;
     LazyProperty<JSGlobalObject, JSObject> m_lazyPreloadTestModuleObject;
@@ -542,6 +601,9 @@ public:
     LazyProperty<JSGlobalObject, Structure> m_cachedGlobalProxyStructure;
     LazyProperty<JSGlobalObject, Structure> m_commonJSModuleObjectStructure;
     LazyProperty<JSGlobalObject, Structure> m_JSSocketAddressStructure;
+    // The last object JSSocketAddress__createFromText() returned. See JSSocketAddress.cpp.
+    mutable WriteBarrier<JSC::JSObject> m_lastSocketAddress;
+    LazyProperty<JSGlobalObject, Structure> m_JSNodeHTTPRequestHeadersStructure;
     LazyProperty<JSGlobalObject, Structure> m_memoryFootprintStructure;
     LazyProperty<JSGlobalObject, JSObject> m_requireFunctionUnbound;
     LazyProperty<JSGlobalObject, JSObject> m_requireResolveFunctionUnbound;
@@ -3,15 +3,25 @@
 #include "helpers.h"
 
 #include "ZigSourceProvider.h"
+#include "SharedSourceCache.h"
+#include "CodeCoverage.h"
 
 #include <JavaScriptCore/BytecodeCacheError.h>
 #include "ZigGlobalObject.h"
 #include "wtf/Assertions.h"
 
 #include <JavaScriptCore/Completion.h>
+#include <wtf/FileSystem.h>
+#include <wtf/HashSet.h>
+#include <wtf/Lock.h>
 #include <wtf/Scope.h>
 #include <wtf/text/StringHash.h>
+#include <openssl/sha.h>
 #include <sys/stat.h>
+#if !OS(WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 extern "C" void RefString__free(void*, void*, unsigned);
 
@@ -65,6 +75,79 @@ JSC::SourceID sourceIDForSourceURL(const WTF::String& sourceURL)
     return ByteRangeMapping__getSourceID(mappings, Bun::toString(sourceURL));
 }
 
+extern "C" void Bun__atexit(void (*func)(void));
+
+// Guards every SourceProvider's m_cachedBytecode and the set below.
+static Lock bytecodeCacheLock;
+
+static HashSet<const SourceProvider*>& providersWithUncommittedBytecode()
+{
+    static NeverDestroyed<HashSet<const SourceProvider*>> providers;
+    return providers;
+}
+
+// BUN_BYTECODE_CACHE_DIR turns on the bytecode cache: the code JSC compiles
+// for each file is kept there between runs, so the next process skips
+// parsing and bytecode generation for everything it loads again.
+static const CString& bytecodeCacheDirectory()
+{
+    static LazyNeverDestroyed<CString> directory;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+#if OS(WINDOWS)
+        directory.construct();
+#else
+        const char* path = getenv("BUN_BYTECODE_CACHE_DIR");
+        directory.construct(path && *path ? CString(path) : CString());
+        if (directory->isNull())
+            return;
+        mkdir(directory->data(), 0755);
+        // Functions compiled after the top-level code are only written here.
+        Bun__atexit([] {
+            Locker locker { bytecodeCacheLock };
+            auto providers = copyToVector(providersWithUncommittedBytecode());
+            for (auto* provider : providers)
+                provider->writeBytecodeCache();
+        });
+#endif
+    });
+    return directory.get();
+}
+
+// One file per source, named for a hash of what it holds: a changed file
+// gets a new cache entry instead of a stale one, and two copies of the
+// same package in different places do not share one.
+static CString bytecodeCachePath(const CString& directory, JSC::SourceProviderSourceType sourceType, const String& sourceURL, StringView source)
+{
+    SHA256_CTX context;
+    SHA256_Init(&context);
+    uint8_t type = static_cast<uint8_t>(sourceType);
+    SHA256_Update(&context, &type, 1);
+    auto url = sourceURL.utf8();
+    // With its NUL, so the URL and source cannot run into each other.
+    SHA256_Update(&context, url.data(), url.length() + 1);
+    uint8_t is8Bit = source.is8Bit();
+    SHA256_Update(&context, &is8Bit, 1);
+    if (source.is8Bit())
+        SHA256_Update(&context, source.span8().data(), source.length());
+    else
+        SHA256_Update(&context, source.span16().data(), source.length() * sizeof(UChar));
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &context);
+
+    static constexpr char hexDigits[] = "0123456789abcdef";
+    Vector<char> path;
+    path.append(std::span { directory.data(), directory.length() });
+    path.append('/');
+    for (uint8_t byte : digest) {
+        path.append(hexDigits[byte >> 4]);
+        path.append(hexDigits[byte & 0xf]);
+    }
+    path.append(std::span { ".jsc", 4 });
+    path.append('\0');
+    return CString(path.data());
+}
+
 extern "C" bool BunTest__shouldGenerateCodeCoverage(BunString sourceURL);
 extern "C" void Bun__addSourceProviderSourceMap(void* bun_vm, SourceProvider* opaque_source_provider, BunString* specifier);
 extern "C" void Bun__removeSourceProviderSourceMap(void* bun_vm, SourceProvider* opaque_source_provider, BunString* specifier);
@@ -77,8 +160,13 @@ Ref<SourceProvider> SourceProvider::create(
 ) {
     auto string = resolvedSource.source_code.toWTFString(BunString::ZeroCopy);
     auto sourceURLString = resolvedSource.source_url.toWTFString(BunString::ZeroCopy);
+    // Another VM (usually a Worker's) may already hold this same source.
+    if (!isBuiltin) {
+        string = Bun::SharedSourceCache::singleton().share(sourceURLString, string);
+        globalObject->sourceMapPositionCache.invalidate(sourceURLString);
+    }
 
-    bool isCodeCoverageEnabled = !!globalObject->vm().controlFlowProfiler();
+    bool isCodeCoverageEnabled = Bun::isCodeCoverageEnabled(globalObject->vm());
 
     bool shouldGenerateCodeCoverage = isCodeCoverageEnabled && !isBuiltin && BunTest__shouldGenerateCodeCoverage(resolvedSource.source_url);
 
@@ -108,6 +196,10 @@ Ref<SourceProvider> SourceProvider::create(
         Bun__addSourceProviderSourceMap(globalObject->bunVM(), provider.ptr(), &resolvedSource.source_url);
     }
 
+    // ESM comes in as Module, CommonJS as Program.
+    if (!isBuiltin && !shouldGenerateCodeCoverage)
+        provider->loadBytecodeCache();
+
     return provider;
 }
 
@@ -116,6 +208,9 @@ SourceProvider::~SourceProvider() {
         BunString str = Bun::toString(sourceURL());
         Bun__removeSourceProviderSourceMap(m_globalObject->bunVM(), this, &str);
     }
+
+    if (isBytecodeCacheEnabled())
+        commitCachedBytecode();
 }
 
 unsigned SourceProvider::hash() const
@@ -133,116 +228,120 @@ void SourceProvider::freeSourceCode()
 
 void SourceProvider::updateCache(const UnlinkedFunctionExecutable* executable, const SourceCode&,
     CodeSpecializationKind kind,
-    const UnlinkedFunctionCodeBlock* codeBlock)
+    const UnlinkedFunctionCodeBlock* codeBlock) const
 {
-    // if (!m_resolvedSource.bytecodecache_fd || !m_cachedBytecode)
-    return;
+    if (!isBytecodeCacheEnabled())
+        return;
 
     JSC::BytecodeCacheError error;
     RefPtr<JSC::CachedBytecode> cachedBytecode = JSC::encodeFunctionCodeBlock(executable->vm(), codeBlock, error);
-    if (cachedBytecode && !error.isValid())
-        m_cachedBytecode->addFunctionUpdate(executable, kind, *cachedBytecode);
+    if (!cachedBytecode || error.isValid())
+        return;
+
+    Locker locker { bytecodeCacheLock };
+    if (!m_cachedBytecode)
+        return;
+    m_cachedBytecode->addFunctionUpdate(executable, kind, *cachedBytecode);
+    if (!m_hasUncommittedBytecode) {
+        m_hasUncommittedBytecode = true;
+        providersWithUncommittedBytecode().add(this);
+    }
 }
 
-void SourceProvider::cacheBytecode(const BytecodeCacheGenerator& generator)
+void SourceProvider::cacheBytecode(const BytecodeCacheGenerator& generator) const
 {
-    // if (!m_resolvedSource.bytecodecache_fd)
-    return;
+    if (!isBytecodeCacheEnabled())
+        return;
 
-    if (!m_cachedBytecode)
-        m_cachedBytecode = JSC::CachedBytecode::create();
     auto update = generator();
-    if (update)
+    if (!update)
+        return;
+
+    {
+        Locker locker { bytecodeCacheLock };
+        // JSC only generates top-level code it could not decode, so whatever
+        // was on disk is stale (a different JSC, say) and is replaced.
+        if (!m_cachedBytecode || m_cachedBytecode->size())
+            m_cachedBytecode = JSC::CachedBytecode::create();
         m_cachedBytecode->addGlobalUpdate(*update);
-}
+        m_hasUncommittedBytecode = true;
+        providersWithUncommittedBytecode().add(this);
+    }
 
+    // Written now rather than at exit, so a process that is killed instead of
+    // exiting still leaves its top-level code cached. Functions compiled later
+    // are written at exit.
+    commitCachedBytecode();
+}
 
-void SourceProvider::commitCachedBytecode()
+void SourceProvider::commitCachedBytecode() const
 {
-    // if (!m_resolvedSource.bytecodecache_fd || !m_cachedBytecode || !m_cachedBytecode->hasUpdates())
-    return;
-
-    // auto clearBytecode = WTF::makeScopeExit([&] { m_cachedBytecode = nullptr; });
-    // const auto fd = m_resolvedSource.bytecodecache_fd;
-
-    // auto fileSize = FileSystem::fileSize(fd);
-    // if (!fileSize)
-    //     return;
-
-    // size_t cacheFileSize;
-    // if (!WTF::convertSafely(*fileSize, cacheFileSize) || cacheFileSize != m_cachedBytecode->size()) {
-    //     // The bytecode cache has already been updated
-    //     return;
-    // }
+    Locker locker { bytecodeCacheLock };
+    writeBytecodeCache();
+}
 
-    // if (!FileSystem::truncateFile(fd, m_cachedBytecode->sizeForUpdate()))
-    //     return;
+void SourceProvider::writeBytecodeCache() const
+{
+#if !OS(WINDOWS)
+    if (!m_hasUncommittedBytecode)
+        return;
+    m_hasUncommittedBytecode = false;
+    providersWithUncommittedBytecode().remove(this);
+    if (!m_cachedBytecode || !m_cachedBytecode->hasUpdates())
+        return;
+
+    // Written beside the cache and renamed over it, so no other process ever
+    // maps a half-written file. The updates are laid out relative to what
+    // was loaded, so that is copied over first.
+    auto temporaryPath = makeString(String::fromUTF8(m_bytecodeCachePath.data()), ".tmp"_s, getpid()).utf8();
+    int fd = open(temporaryPath.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return;
+
+    bool ok = !ftruncate(fd, m_cachedBytecode->sizeForUpdate());
+    if (ok && m_cachedBytecode->size())
+        ok = pwrite(fd, m_cachedBytecode->data(), m_cachedBytecode->size(), 0) == static_cast<ssize_t>(m_cachedBytecode->size());
+    if (ok) {
+        m_cachedBytecode->commitUpdates([&](off_t offset, const void* data, size_t size) {
+            if (ok && pwrite(fd, data, size, offset) != static_cast<ssize_t>(size))
+                ok = false;
+        });
+    }
+    close(fd);
 
-    // m_cachedBytecode->commitUpdates([&](off_t offset, const void* data, size_t size) {
-    //     long long result = FileSystem::seekFile(fd, offset, FileSystem::FileSeekOrigin::Beginning);
-    //     ASSERT_UNUSED(result, result != -1);
-    //     size_t bytesWritten = static_cast<size_t>(FileSystem::writeToFile(fd, data, size));
-    //     ASSERT_UNUSED(bytesWritten, bytesWritten == size);
-    // });
+    if (!ok || rename(temporaryPath.data(), m_bytecodeCachePath.data()))
+        unlink(temporaryPath.data());
+#endif
 }
 
 bool SourceProvider::isBytecodeCacheEnabled() const
 {
-    // return m_resolvedSource.bytecodecache_fd > 0;
-    return false;
+    return !m_bytecodeCachePath.isNull();
 }
 
-void SourceProvider::readOrGenerateByteCodeCache(JSC::VM& vm, const JSC::SourceCode& sourceCode)
-{
-    // auto status = this->readCache(vm, sourceCode);
-    // switch (status) {
-    // case -1: {
-    //     m_resolvedSource.bytecodecache_fd = 0;
-    //     break;
-    // }
-    // case 0: {
-    //     JSC::BytecodeCacheError err;
-    //     m_cachedBytecode = JSC::generateModuleBytecode(vm, sourceCode, m_resolvedSource.bytecodecache_fd, err);
-
-    //     if (err.isValid()) {
-    //         m_resolvedSource.bytecodecache_fd = 0;
-    //         m_cachedBytecode = JSC::CachedBytecode::create();
-    //     }
-    // }
-    // // TODO: read the bytecode into a JSC::SourceCode object here
-    // case 1: {
-    // }
-    // }
-}
-int SourceProvider::readCache(JSC::VM& vm, const JSC::SourceCode& sourceCode)
+void SourceProvider::loadBytecodeCache()
 {
-    return -1;
-    // if (m_resolvedSource.bytecodecache_fd == 0)
-    //     return -1;
-    // if (!FileSystem::isHandleValid(m_resolvedSource.bytecodecache_fd))
-    //     return -1;
-    // const auto fd = m_resolvedSource.bytecodecache_fd;
-
-    // bool success;
-    // FileSystem::MappedFileData mappedFile(fd, FileSystem::MappedFileMode::Shared, success);
-    // if (!success)
-    //     return -1;
-
-    // const uint8_t* fileData = reinterpret_cast<const uint8_t*>(mappedFile.data());
-    // unsigned fileTotalSize = mappedFile.size();
-    // if (fileTotalSize == 0)
-    //     return 0;
-
-    // Ref<JSC::CachedBytecode> cachedBytecode = JSC::CachedBytecode::create(WTFMove(mappedFile));
-    // // auto key = JSC::sourceCodeKeyForSerializedModule(vm, sourceCode);
-    // // if (isCachedBytecodeStillValid(vm, cachedBytecode.copyRef(), key,
-    // //                                JSC::SourceCodeType::ModuleType)) {
-    // m_cachedBytecode = WTFMove(cachedBytecode);
-    // return 1;
-    // } else {
-    //   FileSystem::truncateFile(fd, 0);
-    //   return 0;
-    // }
+#if !OS(WINDOWS)
+    const auto& directory = bytecodeCacheDirectory();
+    if (directory.isNull())
+        return;
+
+    m_bytecodeCachePath = bytecodeCachePath(directory, sourceType(), sourceURL(), source());
+
+    // Not there yet: cacheBytecode() starts one the first time this runs.
+    int fd = open(m_bytecodeCachePath.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    bool success = false;
+    FileSystem::MappedFileData mappedFile(fd, FileSystem::MappedFileMode::Shared, success);
+    close(fd);
+    if (!success || !mappedFile.size())
+        return;
+
+    // JSC checks the cached code against this source before using any of it.
+    m_cachedBytecode = JSC::CachedBytecode::create(WTFMove(mappedFile));
+#endif
 }
 
 extern "C" BunString ZigSourceProvider__getSourceSlice(SourceProvider* provider) {
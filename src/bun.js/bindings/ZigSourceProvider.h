@@ -45,19 +45,20 @@ public:
     unsigned hash() const override;
     StringView source() const override { return StringView(m_source.get()); }
 
-    RefPtr<JSC::CachedBytecode> cachedBytecode()
+    RefPtr<JSC::CachedBytecode> cachedBytecode() const final
     {
-        return nullptr;
+        return m_cachedBytecode;
     };
 
     void updateCache(const UnlinkedFunctionExecutable* executable, const SourceCode&,
-        CodeSpecializationKind kind, const UnlinkedFunctionCodeBlock* codeBlock);
-    void cacheBytecode(const BytecodeCacheGenerator& generator);
-    void commitCachedBytecode();
+        CodeSpecializationKind kind, const UnlinkedFunctionCodeBlock* codeBlock) const final;
+    void cacheBytecode(const BytecodeCacheGenerator& generator) const final;
+    void commitCachedBytecode() const final;
+    // Whether BUN_BYTECODE_CACHE_DIR is set and this source is cached there.
     bool isBytecodeCacheEnabled() const;
-    void readOrGenerateByteCodeCache(JSC::VM& vm, const JSC::SourceCode& sourceCode);
+    // commitCachedBytecode() with bytecodeCacheLock already held.
+    void writeBytecodeCache() const;
     ResolvedSource m_resolvedSource;
-    int readCache(JSC::VM& vm, const JSC::SourceCode& sourceCode);
     void freeSourceCode();
 
 private:
@@ -72,8 +73,13 @@ private:
         m_resolvedSource = resolvedSource;
     }
 
+    // Maps what a previous run left in the cache, if anything.
+    void loadBytecodeCache();
+
     Zig::GlobalObject* m_globalObject;
-    RefPtr<JSC::CachedBytecode> m_cachedBytecode;
+    mutable RefPtr<JSC::CachedBytecode> m_cachedBytecode;
+    CString m_bytecodeCachePath;
+    mutable bool m_hasUncommittedBytecode { false };
     Ref<WTF::StringImpl> m_source;
     unsigned m_hash = 0;
 };
@@ -7,6 +7,7 @@
 #include "headers.h"
 
 #include "BunClientData.h"
+#include "AtomStringCache.h"
 #include "GCDefferalContext.h"
 
 #include "JavaScriptCore/AggregateError.h"
@@ -500,6 +501,165 @@ JSValue getIndexWithoutAccessors(JSGlobalObject* globalObject, JSObject* obj, ui
     return JSValue();
 }
 
+static inline uint64_t mixDeepEqualsHash(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    return value ^ (value >> 33);
+}
+
+// What a primitive property value adds to the hash of its object. Undefined
+// adds nothing, since toEqual treats it like a missing property.
+static std::optional<uint64_t> primitiveDeepEqualsHash(JSGlobalObject* globalObject, JSValue value)
+{
+    if (value.isNumber()) {
+        // sameValue: 1 and 1.0 are equal, 0 and -0 are not.
+        double number = value.asNumber();
+        return mixDeepEqualsHash(number != number ? 1 : WTF::bitwise_cast<uint64_t>(number));
+    }
+    if (value.isString()) {
+        auto string = asString(value)->value(globalObject);
+        if (string.isNull())
+            return std::nullopt;
+        return mixDeepEqualsHash(static_cast<uint64_t>(string.impl()->hash()) << 8 | 2);
+    }
+    if (value.isBoolean())
+        return value.isTrue() ? 3 : 4;
+    if (value.isNull())
+        return 5;
+    return std::nullopt;
+}
+
+// A hash shared by all the values that Bun__deepEquals can find equal to a
+// given object, used to match up the Set and Map keys that are not the same
+// value. Objects whose equality depends on something it cannot see without
+// side effects (proxies, getters, asymmetric matchers and other DOM wrappers,
+// exotic property storage) get none and have to be compared with everything.
+static std::optional<uint64_t> deepEqualsHash(JSGlobalObject* globalObject, JSObject* object, bool isStrict)
+{
+    uint8_t type = object->type();
+    switch (type) {
+    case ProxyObjectType:
+    case JSDOMWrapperType:
+        return std::nullopt;
+    case JSSetType:
+        return mixDeepEqualsHash(static_cast<uint64_t>(jsCast<JSSet*>(object)->size()) << 8 | type);
+    case JSMapType:
+        return mixDeepEqualsHash(static_cast<uint64_t>(jsCast<JSMap*>(object)->size()) << 8 | type);
+    case JSDateType:
+        return mixDeepEqualsHash(WTF::bitwise_cast<uint64_t>(jsCast<DateInstance*>(object)->internalNumber()) ^ type);
+    case ArrayBufferType:
+        return mixDeepEqualsHash(static_cast<uint64_t>(jsCast<JSArrayBuffer*>(object)->impl()->byteLength()) << 8 | type);
+    case RegExpObjectType:
+    case StringObjectType:
+        return mixDeepEqualsHash(type);
+    default:
+        break;
+    }
+
+    if (isTypedArrayType(static_cast<JSType>(type)))
+        return mixDeepEqualsHash(static_cast<uint64_t>(jsCast<JSArrayBufferView*>(object)->byteLength()) << 8 | type);
+
+    // Without toStrictEqual, trailing holes and undefined do not count.
+    if (type == ArrayType || type == DerivedArrayType)
+        return mixDeepEqualsHash(isStrict ? static_cast<uint64_t>(jsCast<JSArray*>(object)->length()) << 8 | ArrayType : ArrayType);
+
+    // Any other object, by its enumerable properties with primitive values, in
+    // any order. Object values would have to be hashed deeply and are left out.
+    Structure* structure = object->structure();
+    if (!canPerformFastPropertyEnumerationForIterationBun(structure))
+        return std::nullopt;
+
+    uint64_t hash = 0;
+    bool hashable = true;
+    structure->forEachProperty(globalObject->vm(), [&](const PropertyTableEntry& entry) -> bool {
+        if (entry.attributes() & PropertyAttribute::DontEnum || PropertyName(entry.key()).isPrivateName())
+            return true;
+
+        JSValue value = object->getDirect(entry.offset());
+        if (value.isCell() && value.asCell()->type() == JSDOMWrapperType) {
+            // An asymmetric matcher can equal a primitive on the other side.
+            hashable = false;
+            return false;
+        }
+        if (auto valueHash = primitiveDeepEqualsHash(globalObject, value))
+            hash += mixDeepEqualsHash((static_cast<uint64_t>(entry.key()->hash()) << 32) ^ *valueHash);
+        return true;
+    });
+    if (!hashable)
+        return std::nullopt;
+
+    return mixDeepEqualsHash(hash ^ ObjectType);
+}
+
+// The keys of a Set or Map that have no same-value match in the other one are
+// looked up here, so that only keys of the same hash are deeply compared
+// instead of every key of the other one in turn.
+template<typename Bucket>
+class DeepEqualsKeyIndex {
+public:
+    // Sets and Maps smaller than this are scanned.
+    static constexpr size_t minimumSize = 32;
+
+    template<typename HashMapType>
+    DeepEqualsKeyIndex(JSGlobalObject* globalObject, HashMapType* map, bool isStrict)
+    {
+        size_t position = 0;
+        for (Bucket* bucket = map->head(); bucket; bucket = bucket->next()) {
+            if (bucket->deleted())
+                continue;
+
+            JSValue key = bucket->key();
+            // A primitive key without a same-value match can only equal an
+            // asymmetric matcher, which is always a candidate.
+            if (key.isObject()) {
+                if (auto hash = deepEqualsHash(globalObject, asObject(key), isStrict))
+                    m_byHash.add(sanitize(*hash), Vector<std::pair<size_t, Bucket*>>()).iterator->value.append({ position, bucket });
+                else
+                    m_unhashable.append({ position, bucket });
+            }
+            position++;
+        }
+    }
+
+    // Calls `matches` with the possible matches of `key` in insertion order
+    // until it returns true, and returns the bucket it did that for, or null.
+    // Returns std::nullopt for keys without a hash, these have to be compared
+    // with every key.
+    template<typename Matches>
+    std::optional<Bucket*> find(JSGlobalObject* globalObject, JSValue key, bool isStrict, const Matches& matches)
+    {
+        static const Vector<std::pair<size_t, Bucket*>> none;
+        const Vector<std::pair<size_t, Bucket*>>* hashed = &none;
+        if (key.isObject()) {
+            auto hash = deepEqualsHash(globalObject, asObject(key), isStrict);
+            if (!hash)
+                return std::nullopt;
+            auto it = m_byHash.find(sanitize(*hash));
+            if (it != m_byHash.end())
+                hashed = &it->value;
+        }
+
+        size_t i = 0, j = 0;
+        while (i < hashed->size() || j < m_unhashable.size()) {
+            bool takeHashed = j == m_unhashable.size() || (i < hashed->size() && hashed->at(i).first < m_unhashable[j].first);
+            Bucket* bucket = takeHashed ? hashed->at(i++).second : m_unhashable[j++].second;
+            if (!bucket->deleted() && matches(bucket))
+                return bucket;
+        }
+        return static_cast<Bucket*>(nullptr);
+    }
+
+private:
+    // The two highest values are the empty and deleted keys.
+    static uint64_t sanitize(uint64_t hash) { return hash >> 1; }
+
+    HashMap<uint64_t, Vector<std::pair<size_t, Bucket*>>, DefaultHash<uint64_t>, WTF::UnsignedWithZeroKeyHashTraits<uint64_t>> m_byHash;
+    Vector<std::pair<size_t, Bucket*>> m_unhashable;
+};
+
 template<bool isStrict, bool enableAsymmetricMatchers>
 bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2, MarkedArgumentBuffer& gcBuffer, Vector<std::pair<JSC::JSValue, JSC::JSValue>, 16>& stack, ThrowScope* scope, bool addToStack)
 {
@@ -595,6 +755,7 @@ bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2,
         // This code is loosely based on
         // https://github.com/oven-sh/WebKit/blob/657558d4d4c9c33f41b9670e72d96a5a39fe546e/Source/JavaScriptCore/runtime/HashMapImplInlines.h#L203-L211
         if (canPerformFastSet && set1->isIteratorProtocolFastAndNonObservable() && set2->isIteratorProtocolFastAndNonObservable()) {
+            std::unique_ptr<DeepEqualsKeyIndex<JSSet::BucketType>> set2Index;
             auto* bucket = set1->head();
             while (bucket) {
                 if (!bucket->deleted()) {
@@ -608,6 +769,16 @@ bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2,
 
                     if (!bucket2ptr) {
                         auto findDeepEqualKey = [&]() -> bool {
+                            if (set2->size() >= DeepEqualsKeyIndex<JSSet::BucketType>::minimumSize) {
+                                if (!set2Index)
+                                    set2Index = makeUnique<DeepEqualsKeyIndex<JSSet::BucketType>>(globalObject, set2, isStrict);
+                                auto found = set2Index->find(globalObject, key, isStrict, [&](JSSet::BucketType* bucket) {
+                                    return Bun__deepEquals<isStrict, enableAsymmetricMatchers>(globalObject, key, bucket->key(), gcBuffer, stack, scope, false);
+                                });
+                                if (found)
+                                    return *found != nullptr;
+                            }
+
                             auto* bucket = set2->head();
                             while (bucket) {
                                 if (!bucket->deleted()) {
@@ -703,6 +874,7 @@ bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2,
         // This code is loosely based on
         // https://github.com/oven-sh/WebKit/blob/657558d4d4c9c33f41b9670e72d96a5a39fe546e/Source/JavaScriptCore/runtime/HashMapImplInlines.h#L203-L211
         if (canPerformFastSet && map1->isIteratorProtocolFastAndNonObservable() && map2->isIteratorProtocolFastAndNonObservable()) {
+            std::unique_ptr<DeepEqualsKeyIndex<JSMap::BucketType>> map2Index;
             auto* bucket = map1->head();
             while (bucket) {
                 if (!bucket->deleted()) {
@@ -722,6 +894,16 @@ bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2,
 
                     if (!bucket2) {
                         auto findDeepEqualKey = [&]() -> JSMap::BucketType* {
+                            if (map2->size() >= DeepEqualsKeyIndex<JSMap::BucketType>::minimumSize) {
+                                if (!map2Index)
+                                    map2Index = makeUnique<DeepEqualsKeyIndex<JSMap::BucketType>>(globalObject, map2, isStrict);
+                                auto found = map2Index->find(globalObject, key, isStrict, [&](JSMap::BucketType* bucket) {
+                                    return Bun__deepEquals<isStrict, enableAsymmetricMatchers>(globalObject, key, bucket->key(), gcBuffer, stack, scope, false);
+                                });
+                                if (found)
+                                    return *found;
+                            }
+
                             auto* bucket = map2->head();
                             while (bucket) {
                                 if (!bucket->deleted()) {
@@ -1009,6 +1191,20 @@ bool Bun__deepEquals(JSC__JSGlobalObject* globalObject, JSValue v1, JSValue v2,
         }
 
         uint64_t i = 0;
+
+        // Arrays of numbers are compared straight from their storage. Holes are
+        // empty values in int32 storage and NaN in double storage, where no
+        // other NaN is kept, so equal bits are exactly what sameValue and the
+        // hole handling below would find equal.
+        IndexingType shape = array1->indexingType() & IndexingShapeMask;
+        if (array1Length == array2Length && shape == (array2->indexingType() & IndexingShapeMask) && (shape == Int32Shape || shape == DoubleShape)) {
+            const void* left = shape == Int32Shape ? static_cast<const void*>(array1->butterfly()->contiguousInt32().data()) : static_cast<const void*>(array1->butterfly()->contiguousDouble().data());
+            const void* right = shape == Int32Shape ? static_cast<const void*>(array2->butterfly()->contiguousInt32().data()) : static_cast<const void*>(array2->butterfly()->contiguousDouble().data());
+            if (memcmp(left, right, array1Length * sizeof(EncodedJSValue)))
+                return false;
+            i = array1Length;
+        }
+
         for (; i < array1Length; i++) {
             JSValue left = getIndexWithoutAccessors(globalObject, o1, i);
             RETURN_IF_EXCEPTION(*scope, false);
@@ -1472,63 +1668,18 @@ bool WebCore__FetchHeaders__fastHas_(WebCore__FetchHeaders* arg0, unsigned char
 
 void WebCore__FetchHeaders__copyTo(WebCore__FetchHeaders* headers, StringPointer* names, StringPointer* values, unsigned char* buf)
 {
-    auto iter = headers->createIterator();
-    unsigned int i = 0;
-
-    for (auto pair = iter.next(); pair; pair = iter.next()) {
-        const auto name = pair->key;
-        const auto value = pair->value;
-
-        ASSERT_WITH_MESSAGE(name.length(), "Header name must not be empty");
-
-        if (name.is8Bit() && name.containsOnlyASCII()) {
-            const auto nameSpan = name.span8();
-            memcpy(&buf[i], nameSpan.data(), nameSpan.size());
-            *names = { i, name.length() };
-            i += name.length();
-        } else {
-            ASSERT_WITH_MESSAGE(name.containsOnlyASCII(), "Header name must be ASCII. This should already be validated before calling this function.");
-            WTF::CString nameCString = name.utf8();
-            memcpy(&buf[i], nameCString.data(), nameCString.length());
-            *names = { i, static_cast<uint32_t>(nameCString.length()) };
-            i += static_cast<uint32_t>(nameCString.length());
-        }
-
-        if (value.length() > 0) {
-            if (value.is8Bit() && value.containsOnlyASCII()) {
-                const auto valueSpan = value.span8();
-                memcpy(&buf[i], valueSpan.data(), valueSpan.size());
-                *values = { i, value.length() };
-                i += value.length();
-            } else {
-                ASSERT_WITH_MESSAGE(value.containsOnlyASCII(), "Header value must be ASCII. This should already be validated before calling this function.");
-                WTF::CString valueCString = value.utf8();
-                memcpy(&buf[i], valueCString.data(), valueCString.length());
-                *values = { i, static_cast<uint32_t>(valueCString.length()) };
-                i += static_cast<uint32_t>(valueCString.length());
-            }
-        } else {
-            *values = { i, 0 };
-        }
-
-        names++;
-        values++;
+    const auto& wire = headers->wireHeaders();
+    memcpy(buf, wire.bytes.data(), wire.bytes.size());
+    for (size_t i = 0; i < wire.names.size(); ++i) {
+        names[i] = { wire.names[i].first, wire.names[i].second };
+        values[i] = { wire.values[i].first, wire.values[i].second };
     }
 }
 void WebCore__FetchHeaders__count(WebCore__FetchHeaders* headers, uint32_t* count, uint32_t* buf_len)
 {
-    auto iter = headers->createIterator();
-    size_t i = 0;
-    for (auto pair = iter.next(); pair; pair = iter.next()) {
-        // UTF8 byteLength is not strictly necessary here
-        // They should always be ASCII.
-        // However, we can still do this out of an abundance of caution
-        i += BunString::utf8ByteLength(pair->key);
-        i += BunString::utf8ByteLength(pair->value);
-    }
-
-    *count = headers->size();
-    *buf_len = i;
+    const auto& wire = headers->wireHeaders();
+    *count = wire.names.size();
+    *buf_len = wire.bytes.size();
 }
 
 typedef struct ZigSliceString {
@@ -1575,6 +1726,10 @@ WebCore::FetchHeaders* WebCore__FetchHeaders__createFromPicoHeaders_(const void*
             // isolatedCopy() doesn't actually clone, it's only for threadlocal isolation
             if (WebCore::findHTTPHeaderName(nameView, name)) {
                 map.add(name, value);
+            } else if (auto* atomStringCache = Bun::AtomStringCache::current()) {
+                // The same uncommon names come back on every response from a
+                // server, so they share one string instead of a copy each.
+                map.setUncommonHeader(atomStringCache->make(nameView.span8()).string(), value);
             } else {
                 // the case where we do not need to clone the name
                 // when the header name is already present in the list
@@ -1589,7 +1744,7 @@ WebCore::FetchHeaders* WebCore__FetchHeaders__createFromPicoHeaders_(const void*
 }
 WebCore::FetchHeaders* WebCore__FetchHeaders__createFromUWS(JSC__JSGlobalObject* arg0, void* arg1)
 {
-    uWS::HttpRequest req = *reinterpret_cast<uWS::HttpRequest*>(arg1);
+    uWS::HttpRequest& req = *reinterpret_cast<uWS::HttpRequest*>(arg1);
 
     auto* headers = new WebCore::FetchHeaders({ WebCore::FetchHeaders::Guard::None, {} });
     headers->relaxAdoptionRequirement(); // This prevents an assertion later, but may not be the proper approach.
@@ -5340,6 +5495,13 @@ extern "C" void WebCore__AbortSignal__cleanNativeBindings(WebCore__AbortSignal*
     abortSignal->cleanNativeBindings(arg1);
 }
 
+// Called once a request that was given the signal has completed.
+extern "C" void WebCore__AbortSignal__unfollow(WebCore__AbortSignal* arg0)
+{
+    WebCore::AbortSignal* abortSignal = reinterpret_cast<WebCore::AbortSignal*>(arg0);
+    abortSignal->unfollow();
+}
+
 extern "C" WebCore__AbortSignal* WebCore__AbortSignal__addListener(WebCore__AbortSignal* arg0, void* ctx, void (*callback)(void* ctx, JSC__JSValue reason))
 {
     WebCore::AbortSignal* abortSignal = reinterpret_cast<WebCore::AbortSignal*>(arg0);
@@ -1105,6 +1105,46 @@ pub const DOMFormData = opaque {
         DOMFormData__forEach(this, ctx, Wrap.forEachWrapper);
     }
 
+    /// Encodes the form as multipart/form-data piece by piece, handing
+    /// Blobs back whole so file-backed ones can be sent with sendfile.
+    pub const MultipartEncoder = opaque {
+        extern fn FormDataMultipartEncoder__create(*DOMFormData, *const ZigString) *MultipartEncoder;
+        extern fn FormDataMultipartEncoder__next(*MultipartEncoder, *?[*]const u8, *usize, *?*anyopaque) u8;
+        extern fn FormDataMultipartEncoder__contentLength(*MultipartEncoder) u64;
+        extern fn FormDataMultipartEncoder__destroy(*MultipartEncoder) void;
+
+        pub const Chunk = union(enum) {
+            done: void,
+            /// Valid until the next call to `next`.
+            bytes: []const u8,
+            blob: *JSC.WebCore.Blob,
+        };
+
+        pub fn create(form: *DOMFormData, boundary: ZigString) *MultipartEncoder {
+            JSC.markBinding(@src());
+            return FormDataMultipartEncoder__create(form, &boundary);
+        }
+
+        pub fn next(this: *MultipartEncoder) Chunk {
+            var ptr: ?[*]const u8 = null;
+            var len: usize = 0;
+            var blob: ?*anyopaque = null;
+            return switch (FormDataMultipartEncoder__next(this, &ptr, &len, &blob)) {
+                1 => .{ .bytes = if (ptr) |bytes| bytes[0..len] else "" },
+                2 => .{ .blob = bun.cast(*JSC.WebCore.Blob, blob.?) },
+                else => .{ .done = {} },
+            };
+        }
+
+        pub fn contentLength(this: *MultipartEncoder) u64 {
+            return FormDataMultipartEncoder__contentLength(this);
+        }
+
+        pub fn destroy(this: *MultipartEncoder) void {
+            FormDataMultipartEncoder__destroy(this);
+        }
+    };
+
     pub const Extern = [_][]const u8{
         "create",
         "fromJS",
@@ -6102,6 +6142,17 @@ const private = struct {
         add_ptr_field: bool,
     ) JSValue;
 
+    pub extern fn Bun__CreateFFIFunctionWithFastPath(
+        globalObject: *JSGlobalObject,
+        symbolName: ?*const ZigString,
+        argCount: u32,
+        functionPointer: *const anyopaque,
+        fastPath: ?*const anyopaque,
+        arguments: [*]const FFIFastPathArgument,
+        strong: bool,
+        data: ?*anyopaque,
+    ) JSValue;
+
     pub extern fn Bun__untrackFFIFunction(
         globalObject: *JSGlobalObject,
         function: JSValue,
@@ -6116,6 +6167,29 @@ pub fn NewFunctionPtr(globalObject: *JSGlobalObject, symbolName: ?*const ZigStri
     return private.Bun__CreateFFIFunction(globalObject, symbolName, argCount, @as(*const anyopaque, @ptrCast(&functionPointer)), strong);
 }
 
+/// Matches Zig::FFIFastPathArgument in JSFFIFunction.h.
+pub const FFIFastPathArgument = enum(u8) {
+    int32 = 0,
+    boolean = 1,
+    uint8array = 2,
+};
+
+/// Like NewFunctionWithData, plus an entry point optimized code calls with
+/// unboxed `arguments` (at most 3; with more, or no fast_path, it is not
+/// used). See Zig::FFIFastPathFunction for its C signature.
+pub fn NewFunctionWithFastPath(
+    globalObject: *JSGlobalObject,
+    symbolName: ?*const ZigString,
+    functionPointer: *const anyopaque,
+    fast_path: ?*const anyopaque,
+    arguments: []const FFIFastPathArgument,
+    strong: bool,
+    data: ?*anyopaque,
+) JSValue {
+    JSC.markBinding(@src());
+    return private.Bun__CreateFFIFunctionWithFastPath(globalObject, symbolName, @intCast(arguments.len), functionPointer, fast_path, arguments.ptr, strong, data);
+}
+
 pub fn NewFunction(
     globalObject: *JSGlobalObject,
     symbolName: ?*const ZigString,
@@ -1,7 +1,6 @@
 #include "blob.h"
 #include "ZigGeneratedClasses.h"
 
-extern "C" JSC::EncodedJSValue Blob__create(JSC::JSGlobalObject* globalObject, void* impl);
 extern "C" void* Blob__setAsFile(void* impl, BunString* filename);
 
 namespace WebCore {
@@ -9,6 +9,12 @@ namespace WebCore {
 extern "C" void* Blob__dupeFromJS(JSC::EncodedJSValue impl);
 extern "C" void* Blob__dupe(void* impl);
 extern "C" void Blob__destroy(void* impl);
+// A copy of the Blob that another thread can own. It shares the store (an
+// fd or path with offset and length, an mmap'd region, or the bytes) by
+// reference; the name and content type are copied. Null if the store can
+// not be shared, in which case the Blob is cloned by value.
+extern "C" void* Blob__dupeForThread(void* impl);
+extern "C" JSC::EncodedJSValue Blob__create(JSC::JSGlobalObject* globalObject, void* impl);
 
 class Blob : public RefCounted<Blob> {
 public:
@@ -35,6 +41,15 @@ public:
         return adoptRef(*new Blob(implPtr));
     }
 
+    static RefPtr<Blob> createForThread(void* ptr)
+    {
+        void* implPtr = Blob__dupeForThread(ptr);
+        if (!implPtr)
+            return nullptr;
+
+        return adoptRef(*new Blob(implPtr));
+    }
+
     ~Blob()
     {
         Blob__destroy(m_impl);
@@ -47,7 +47,7 @@ typedef struct bun_spawn_request_t {
     bun_spawn_file_action_list_t actions;
 } bun_spawn_request_t;
 
-extern "C" ssize_t posix_spawn_bun(
+static ssize_t spawnLocally(
     int* pid,
     const char* path,
     const bun_spawn_request_t* request,
@@ -201,4 +201,710 @@ extern "C" ssize_t posix_spawn_bun(
     return res;
 }
 
-#endif
\ No newline at end of file
+// The spawn server
+//
+// vfork() is cheap, but not free: the parent's page tables are still shared
+// and every signal is blocked while the child runs up to execve(). With a
+// large heap and many threads, that makes spawn rate depend on how big the
+// parent has grown.
+//
+// With BUN_SPAWN_SERVER=1, a helper is forked at startup, while the process
+// is still small, and every spawn goes through it instead. Requests travel
+// over a Unix socket with the file descriptors as SCM_RIGHTS, and several
+// spawns can be sent in one message.
+//
+// For each message, the helper forks an intermediate process which makes the
+// parent's descriptors and working directory its own, calls spawnLocally()
+// for each request and exits. The parent is a child subreaper, so the new
+// processes are reparented to it and it can wait on them as usual. That
+// also means orphaned grandchildren of anything it spawns end up as its
+// children, which is why this is opt-in.
+//
+// If the helper goes away, spawns fall back to spawnLocally().
+
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+
+typedef struct bun_spawn_batch_item_t {
+    const char* path;
+    const bun_spawn_request_t* request;
+    char* const* argv;
+    char* const* envp;
+} bun_spawn_batch_item_t;
+
+namespace SpawnServer {
+
+static constexpr size_t maxBatchSize = 64;
+// SCM_MAX_FD in the kernel.
+static constexpr size_t maxFileDescriptors = 253;
+
+// The working directory and stdio come first in every message.
+static constexpr uint32_t cwdIndex = 0;
+static constexpr uint32_t stdioIndex = 1;
+static constexpr uint32_t firstActionFdIndex = 4;
+
+struct MessageHeader {
+    uint32_t payloadSize;
+    uint32_t requestCount;
+};
+
+struct SpawnResult {
+    int32_t pid;
+    int32_t error;
+};
+
+static WTF::Lock s_lock;
+static int s_socket = -1;
+
+static bool sendAll(int fd, const void* data, size_t size, const int* fds = nullptr, size_t fdCount = 0)
+{
+    const char* bytes = static_cast<const char*>(data);
+    union {
+        char buffer[CMSG_SPACE(sizeof(int) * maxFileDescriptors)];
+        struct cmsghdr align;
+    } control;
+
+    while (size > 0) {
+        struct iovec iov = { const_cast<char*>(bytes), size };
+        struct msghdr message = {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+
+        if (fdCount) {
+            memset(&control, 0, sizeof(control));
+            message.msg_control = control.buffer;
+            message.msg_controllen = CMSG_SPACE(sizeof(int) * fdCount);
+            struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * fdCount);
+            memcpy(CMSG_DATA(header), fds, sizeof(int) * fdCount);
+        }
+
+        ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // The descriptors go with the first byte.
+        fdCount = 0;
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// Returns 0 on a clean EOF before anything was read.
+static ssize_t receiveAll(int fd, void* data, size_t size, Vector<int>* fds = nullptr)
+{
+    char* bytes = static_cast<char*>(data);
+    size_t received = 0;
+    union {
+        char buffer[CMSG_SPACE(sizeof(int) * maxFileDescriptors)];
+        struct cmsghdr align;
+    } control;
+
+    while (received < size) {
+        struct iovec iov = { bytes + received, size - received };
+        struct msghdr message = {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        if (fds) {
+            message.msg_control = control.buffer;
+            message.msg_controllen = sizeof(control.buffer);
+        }
+
+        ssize_t result = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        if (result == 0)
+            return received ? -1 : 0;
+
+        if (fds) {
+            for (struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+                if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+                    continue;
+                size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                const int* passed = reinterpret_cast<const int*>(CMSG_DATA(header));
+                for (size_t i = 0; i < count; i++)
+                    fds->append(passed[i]);
+            }
+            fds = nullptr;
+        }
+        received += result;
+    }
+    return received;
+}
+
+class MessageWriter {
+public:
+    void appendInt(int32_t value) { m_buffer.append(std::span { reinterpret_cast<const char*>(&value), sizeof(value) }); }
+
+    void appendString(const char* string)
+    {
+        if (!string) {
+            appendInt(-1);
+            return;
+        }
+        size_t length = strlen(string);
+        appendInt(length);
+        m_buffer.append(std::span { string, length + 1 });
+    }
+
+    void appendStringList(char* const* list)
+    {
+        int32_t count = 0;
+        while (list && list[count])
+            count++;
+        appendInt(count);
+        for (int32_t i = 0; i < count; i++)
+            appendString(list[i]);
+    }
+
+    const Vector<char>& buffer() const { return m_buffer; }
+
+private:
+    Vector<char> m_buffer;
+};
+
+class MessageReader {
+public:
+    MessageReader(const char* data, size_t size)
+        : m_position(data)
+        , m_end(data + size)
+    {
+    }
+
+    bool readInt(int32_t& value)
+    {
+        if (static_cast<size_t>(m_end - m_position) < sizeof(value))
+            return false;
+        memcpy(&value, m_position, sizeof(value));
+        m_position += sizeof(value);
+        return true;
+    }
+
+    // The string points into the message, which is NUL terminated.
+    bool readString(const char*& string)
+    {
+        int32_t length;
+        if (!readInt(length))
+            return false;
+        if (length == -1) {
+            string = nullptr;
+            return true;
+        }
+        if (length < 0 || m_end - m_position < length + 1 || m_position[length])
+            return false;
+        string = m_position;
+        m_position += length + 1;
+        return true;
+    }
+
+    bool readStringList(Vector<char*>& list)
+    {
+        int32_t count;
+        if (!readInt(count) || count < 0)
+            return false;
+        for (int32_t i = 0; i < count; i++) {
+            const char* string;
+            if (!readString(string) || !string)
+                return false;
+            list.append(const_cast<char*>(string));
+        }
+        list.append(nullptr);
+        return true;
+    }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
+struct DecodedRequest {
+    const char* path = nullptr;
+    bun_spawn_request_t request = {};
+    Vector<bun_spawn_request_file_action_t> actions;
+    Vector<char*> argv;
+    Vector<char*> envp;
+};
+
+// Action descriptors are sent as indices into the message's descriptors.
+static bool encodeRequest(MessageWriter& writer, const bun_spawn_batch_item_t& item, Vector<int>& fds)
+{
+    const auto indexOf = [&](int fd) -> int32_t {
+        for (size_t i = firstActionFdIndex; i < fds.size(); i++) {
+            if (fds[i] == fd)
+                return i;
+        }
+        if (fds.size() >= maxFileDescriptors || fcntl(fd, F_GETFD) == -1)
+            return -1;
+        fds.append(fd);
+        return fds.size() - 1;
+    };
+
+    writer.appendString(item.path);
+    writer.appendString(item.request->chdir);
+    writer.appendInt(item.request->detached);
+    writer.appendStringList(item.argv);
+    writer.appendStringList(item.envp ? item.envp : environ);
+
+    const auto& actions = item.request->actions;
+    writer.appendInt(actions.len);
+    for (size_t i = 0; i < actions.len; i++) {
+        const auto& action = actions.ptr[i];
+        int32_t source = action.fds[0];
+        if (action.type == FileActionType::Close || action.type == FileActionType::Dup2) {
+            source = indexOf(action.fds[0]);
+            // Let spawnLocally() report the bad descriptor.
+            if (source == -1)
+                return false;
+        }
+        writer.appendInt(action.type);
+        writer.appendInt(source);
+        writer.appendInt(action.fds[1]);
+        writer.appendInt(action.flags);
+        writer.appendInt(action.mode);
+        writer.appendString(action.type == FileActionType::Open ? action.path : nullptr);
+    }
+    return true;
+}
+
+static bool decodeRequest(MessageReader& reader, DecodedRequest& decoded, size_t fdCount)
+{
+    int32_t detached, actionCount;
+    if (!reader.readString(decoded.path) || !decoded.path
+        || !reader.readString(decoded.request.chdir)
+        || !reader.readInt(detached)
+        || !reader.readStringList(decoded.argv)
+        || !reader.readStringList(decoded.envp)
+        || !reader.readInt(actionCount) || actionCount < 0)
+        return false;
+
+    decoded.request.detached = detached;
+    for (int32_t i = 0; i < actionCount; i++) {
+        int32_t type, source, target, flags, mode;
+        const char* path;
+        if (!reader.readInt(type) || !reader.readInt(source) || !reader.readInt(target)
+            || !reader.readInt(flags) || !reader.readInt(mode) || !reader.readString(path))
+            return false;
+
+        switch (type) {
+        case FileActionType::Close:
+        case FileActionType::Dup2:
+            if (source < static_cast<int32_t>(firstActionFdIndex) || static_cast<size_t>(source) >= fdCount)
+                return false;
+            break;
+        case FileActionType::Open:
+            if (!path)
+                return false;
+            break;
+        default:
+            return false;
+        }
+
+        bun_spawn_request_file_action_t action = { static_cast<FileActionType>(type), path, { source, target }, flags, mode };
+        decoded.actions.append(action);
+    }
+    decoded.request.actions = { decoded.actions.data(), decoded.actions.size() };
+    return true;
+}
+
+// Runs in the intermediate process, which exits right after.
+static void spawnInIntermediate(Vector<DecodedRequest>& requests, Vector<int>& fds, SpawnResult* results)
+{
+    if (fchdir(fds[cwdIndex]) != 0) {
+        for (size_t i = 0; i < requests.size(); i++)
+            results[i] = { 0, errno };
+        return;
+    }
+    for (int fd = 0; fd < 3; fd++)
+        dup2(fds[stdioIndex + fd], fd);
+
+    // A received descriptor may have the same number as a descriptor an action
+    // creates, so move them all out of the way first.
+    int lowestFd = 3;
+    for (auto& decoded : requests) {
+        for (auto& action : decoded.actions) {
+            if (action.type == FileActionType::Dup2)
+                lowestFd = std::max(lowestFd, action.fds[1] + 1);
+            else if (action.type == FileActionType::Open)
+                lowestFd = std::max(lowestFd, action.fds[0] + 1);
+        }
+    }
+    for (size_t i = firstActionFdIndex; i < fds.size(); i++)
+        fds[i] = fcntl(fds[i], F_DUPFD_CLOEXEC, lowestFd);
+
+    for (size_t i = 0; i < requests.size(); i++) {
+        auto& decoded = requests[i];
+        for (auto& action : decoded.actions) {
+            if (action.type != FileActionType::Open)
+                action.fds[0] = fds[action.fds[0]];
+        }
+
+        int pid = 0;
+        int error = spawnLocally(&pid, decoded.path, &decoded.request, decoded.argv.data(), decoded.envp.data());
+        results[i] = { error ? 0 : pid, error };
+    }
+}
+
+static void handleMessage(int socket, const MessageHeader& header, Vector<char>& payload, Vector<int>& fds)
+{
+    Vector<SpawnResult> results(header.requestCount, SpawnResult { 0, EINVAL });
+    Vector<DecodedRequest> requests(header.requestCount);
+
+    bool valid = fds.size() >= firstActionFdIndex;
+    MessageReader reader(payload.data(), payload.size());
+    for (size_t i = 0; valid && i < requests.size(); i++)
+        valid = decodeRequest(reader, requests[i], fds.size());
+
+    int resultPipe[2];
+    if (valid && pipe2(resultPipe, O_CLOEXEC) == 0) {
+        pid_t intermediate = fork();
+        if (intermediate == 0) {
+            close(resultPipe[0]);
+            spawnInIntermediate(requests, fds, results.data());
+            ssize_t unused = write(resultPipe[1], results.data(), results.size() * sizeof(SpawnResult));
+            UNUSED_PARAM(unused);
+            _exit(0);
+        }
+
+        close(resultPipe[1]);
+        if (intermediate == -1) {
+            for (auto& result : results)
+                result = { 0, errno };
+        } else {
+            // The result pipe only closes once the intermediate has exited, and
+            // by then its children belong to the parent.
+            char* bytes = reinterpret_cast<char*>(results.data());
+            size_t size = results.size() * sizeof(SpawnResult);
+            size_t received = 0;
+            while (received < size) {
+                ssize_t result = read(resultPipe[0], bytes + received, size - received);
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                    break;
+                received += result;
+            }
+            while (waitpid(intermediate, nullptr, 0) == -1 && errno == EINTR) { }
+            if (received < size) {
+                for (auto& result : results)
+                    result = { 0, ECHILD };
+            }
+        }
+        close(resultPipe[0]);
+    }
+
+    for (int fd : fds)
+        close(fd);
+
+    sendAll(socket, results.data(), results.size() * sizeof(SpawnResult));
+}
+
+[[noreturn]] static void run(int socket, pid_t parent)
+{
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent)
+        _exit(0);
+
+    struct sigaction sa = { 0 };
+    sa.sa_handler = SIG_DFL;
+    for (int i = 1; i < NSIG; i++)
+        sigaction(i, &sa, 0);
+    sigset_t emptyMask;
+    sigemptyset(&emptyMask);
+    sigprocmask(SIG_SETMASK, &emptyMask, 0);
+
+    if (socket > 3)
+        bun_close_range(3, socket - 1, 0);
+    bun_close_range(socket + 1, ~0U, 0);
+
+    for (;;) {
+        MessageHeader header;
+        Vector<int> fds;
+        ssize_t received = receiveAll(socket, &header, sizeof(header), &fds);
+        if (received <= 0 || header.requestCount > maxBatchSize)
+            _exit(0);
+
+        Vector<char> payload(header.payloadSize);
+        if (receiveAll(socket, payload.data(), payload.size()) != static_cast<ssize_t>(payload.size()))
+            _exit(0);
+
+        handleMessage(socket, header, payload, fds);
+    }
+}
+
+// Returns false if the batch could not be sent, in which case nothing was spawned.
+static bool spawnBatch(const bun_spawn_batch_item_t* items, size_t count, int* pids, int* errors)
+{
+    Vector<int> fds;
+    int cwd = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (cwd == -1)
+        return false;
+    fds.append(cwd);
+    for (int fd = 0; fd < 3; fd++)
+        fds.append(fd);
+
+    MessageWriter writer;
+    bool encoded = true;
+    for (size_t i = 0; encoded && i < count; i++)
+        encoded = encodeRequest(writer, items[i], fds);
+
+    for (size_t i = 0; encoded && i < 3; i++)
+        encoded = fcntl(fds[stdioIndex + i], F_GETFD) != -1;
+
+    if (!encoded) {
+        close(cwd);
+        return false;
+    }
+
+    MessageHeader header = { static_cast<uint32_t>(writer.buffer().size()), static_cast<uint32_t>(count) };
+    Vector<SpawnResult> results(count);
+    bool sent, replied = false;
+    {
+        Locker locker { s_lock };
+        if (s_socket == -1) {
+            close(cwd);
+            return false;
+        }
+
+        sent = sendAll(s_socket, &header, sizeof(header), fds.data(), fds.size())
+            && sendAll(s_socket, writer.buffer().data(), writer.buffer().size());
+        if (sent)
+            replied = receiveAll(s_socket, results.data(), count * sizeof(SpawnResult)) == static_cast<ssize_t>(count * sizeof(SpawnResult));
+
+        if (!replied) {
+            close(s_socket);
+            s_socket = -1;
+        }
+    }
+    close(cwd);
+
+    if (!sent)
+        return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!replied) {
+            // The helper is gone and we cannot know what it got to.
+            pids[i] = 0;
+            errors[i] = EPIPE;
+            continue;
+        }
+        pids[i] = results[i].pid;
+        errors[i] = results[i].error;
+    }
+    return true;
+}
+
+}
+
+// Called once from bun_initialize_process(), before any threads exist.
+extern "C" void bun_spawn_server_start_if_enabled()
+{
+    const char* enabled = getenv("BUN_SPAWN_SERVER");
+    if (!enabled || strcmp(enabled, "1") != 0)
+        return;
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+        return;
+
+    if (prctl(PR_SET_CHILD_SUBREAPER, 1) != 0) {
+        close(sockets[0]);
+        close(sockets[1]);
+        return;
+    }
+
+    pid_t parent = getpid();
+    pid_t helper = fork();
+    if (helper == 0) {
+        close(sockets[0]);
+        SpawnServer::run(sockets[1], parent);
+    }
+
+    close(sockets[1]);
+    if (helper == -1) {
+        close(sockets[0]);
+        prctl(PR_SET_CHILD_SUBREAPER, 0);
+        return;
+    }
+
+    Locker locker { SpawnServer::s_lock };
+    SpawnServer::s_socket = sockets[0];
+}
+
+extern "C" ssize_t posix_spawn_bun(
+    int* pid,
+    const char* path,
+    const bun_spawn_request_t* request,
+    char* const argv[],
+    char* const envp[])
+{
+    if (SpawnServer::s_socket != -1) {
+        bun_spawn_batch_item_t item = { path, request, argv, envp };
+        int childPid = 0, error = 0;
+        if (SpawnServer::spawnBatch(&item, 1, &childPid, &error)) {
+            if (!error && pid)
+                *pid = childPid;
+            return error;
+        }
+    }
+
+    return spawnLocally(pid, path, request, argv, envp);
+}
+
+// Spawns `count` processes with one round trip to the spawn server. Each
+// item gets its own pid or errno, as from posix_spawn_bun().
+extern "C" void posix_spawn_bun_batch(
+    const bun_spawn_batch_item_t* items,
+    size_t count,
+    int* pids,
+    int* errors)
+{
+    size_t offset = 0;
+    while (offset < count) {
+        size_t batchSize = std::min(count - offset, SpawnServer::maxBatchSize);
+        if (SpawnServer::s_socket == -1 || !SpawnServer::spawnBatch(items + offset, batchSize, pids + offset, errors + offset)) {
+            for (size_t i = offset; i < offset + batchSize; i++) {
+                pids[i] = 0;
+                errors[i] = spawnLocally(&pids[i], items[i].path, items[i].request, items[i].argv, items[i].envp);
+            }
+        }
+        offset += batchSize;
+    }
+}
+
+// pidfds
+//
+// A pidfd becomes readable when its process exits, so children can be watched
+// from the event loop (us_create_process_poll) one poll per child, instead of
+// SIGCHLD waking up the loop to waitpid() each of them in turn.
+//
+// clone3(CLONE_PIDFD) would need its own stack to be used like vfork(), so
+// the pidfd is opened right after spawning. Nothing can reap the child before
+// we return its pid, so it still refers to the right process. That also works
+// for children from the spawn server, once they are reparented to us.
+
+#ifndef P_PIDFD
+#define P_PIDFD 3
+#endif
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+// Returns the errno; *pidfd is -1 when the kernel has no pidfd_open (before 5.3).
+extern "C" ssize_t posix_spawn_bun_pidfd(
+    int* pid,
+    int* pidfd,
+    const char* path,
+    const bun_spawn_request_t* request,
+    char* const argv[],
+    char* const envp[])
+{
+    int childPid = 0;
+    *pidfd = -1;
+    ssize_t error = posix_spawn_bun(&childPid, path, request, argv, envp);
+    if (error)
+        return error;
+
+    if (pid)
+        *pid = childPid;
+
+    int fd = syscall(SYS_pidfd_open, childPid, 0);
+    if (fd >= 0) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        *pidfd = fd;
+    }
+    return 0;
+}
+
+// Reaps the process behind a readable pidfd. Returns 0 with a waitpid()
+// style status, 1 if it has not exited yet, or -errno.
+extern "C" int bun_pidfd_wait(int pidfd, int* status)
+{
+    siginfo_t info;
+    memset(&info, 0, sizeof(info));
+
+    int result;
+    do {
+        result = waitid(static_cast<idtype_t>(P_PIDFD), pidfd, &info, WEXITED | WNOHANG);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1)
+        return -errno;
+    if (info.si_pid == 0)
+        return 1;
+
+    switch (info.si_code) {
+    case CLD_EXITED:
+        *status = (info.si_status & 0xff) << 8;
+        break;
+    case CLD_DUMPED:
+        *status = (info.si_status & 0x7f) | 0x80;
+        break;
+    default:
+        *status = info.si_status & 0x7f;
+        break;
+    }
+    return 0;
+}
+
+// Pipelines
+//
+// When one child's stdout is another child's stdin, the pipe can be passed
+// straight to the second child as a Dup2 action and the data never comes
+// near us. When something in between also wants to see the bytes, they are
+// moved with splice() and copied into the tap with tee(), which only takes
+// references to the pipe's pages.
+
+typedef struct bun_splice_state_t {
+    // Bytes already teed into the tap but not yet spliced into `to`.
+    size_t pending;
+} bun_splice_state_t;
+
+// Moves up to `length` bytes from the pipe `from` into `to`, and into the pipe
+// `tap` too unless it is -1. Never blocks. Returns the number of bytes moved
+// into `to`, 0 at the end of `from` or -errno; -EAGAIN means waiting for `from`
+// to be readable, or `to` or `tap` to be writable.
+extern "C" ssize_t bun_splice_pipe(int from, int to, int tap, size_t length, bun_splice_state_t* state)
+{
+    const auto spliceIntoTarget = [&](size_t size) -> ssize_t {
+        ssize_t moved;
+        do {
+            moved = splice(from, nullptr, to, nullptr, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        } while (moved == -1 && errno == EINTR);
+        return moved == -1 ? -errno : moved;
+    };
+
+    if (tap == -1)
+        return spliceIntoTarget(length);
+
+    if (!state->pending) {
+        ssize_t teed;
+        do {
+            teed = tee(from, tap, length, SPLICE_F_NONBLOCK);
+        } while (teed == -1 && errno == EINTR);
+        if (teed <= 0)
+            return teed == -1 ? -errno : 0;
+        state->pending = teed;
+    }
+
+    // With the tap, `from` may only give up what was teed, or the tap would
+    // miss bytes that arrived in between.
+    ssize_t moved = spliceIntoTarget(state->pending);
+    if (moved > 0)
+        state->pending -= moved;
+    // The tee'd bytes are still in `from`, so this is not the end.
+    return moved == 0 ? -EAGAIN : moved;
+}
+
+#endif
@@ -426,6 +426,10 @@ extern "C" void Bun__setCTRLHandler(BOOL add)
 
 extern "C" int32_t bun_is_stdio_null[3] = { 0, 0, 0 };
 
+#if OS(LINUX)
+extern "C" void bun_spawn_server_start_if_enabled();
+#endif
+
 extern "C" void bun_initialize_process()
 {
     // Disable printf() buffering. We buffer it ourselves.
@@ -546,6 +550,10 @@ extern "C" void bun_initialize_process()
     Bun__setCTRLHandler(1);
 #endif
 
+#if OS(LINUX)
+    bun_spawn_server_start_if_enabled();
+#endif
+
 #if OS(DARWIN)
     atexit(Bun__onExit);
 #else
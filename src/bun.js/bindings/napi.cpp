@@ -21,6 +21,7 @@
 #include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
 #include "BufferEncodingType.h"
+#include "MemoryAccounting.h"
 #include <JavaScriptCore/AggregateError.h>
 #include <JavaScriptCore/BytecodeIndex.h>
 #include <JavaScriptCore/CallFrame.h>
@@ -220,17 +221,24 @@ static uint32_t getPropertyAttributes(napi_property_descriptor prop)
     return result;
 }
 
+#define ADDRESS_OF_THIS_VALUE_IN_CALLFRAME(callframe) callframe->addressOfArgumentsStart() - 1
+
+// What napi_get_cb_info reads during a call into an addon. It points
+// straight at `this` and the arguments in the JSC call frame, which is on
+// the stack for the whole call, so nothing is copied or registered with the
+// GC per call.
 class NAPICallFrame {
 public:
-    NAPICallFrame(const JSC::ArgList args, void* dataPtr)
-        : m_args(args)
+    NAPICallFrame(JSC::CallFrame* callFrame, void* dataPtr)
+        : m_thisAndArguments(reinterpret_cast<const JSC::JSValue*>(ADDRESS_OF_THIS_VALUE_IN_CALLFRAME(callFrame)))
+        , m_argumentCount(callFrame->argumentCount())
         , m_dataPtr(dataPtr)
     {
     }
 
     JSC::JSValue thisValue() const
     {
-        return m_args.at(0);
+        return m_thisAndArguments[0];
     }
 
     static constexpr uintptr_t NAPICallFramePtrTag = static_cast<uint64_t>(1) << 63;
@@ -261,9 +269,14 @@ public:
         return { reinterpret_cast<NAPICallFrame*>(ptr) };
     }
 
-    ALWAYS_INLINE const JSC::ArgList& args() const
+    ALWAYS_INLINE size_t argumentCount() const
+    {
+        return m_argumentCount;
+    }
+
+    ALWAYS_INLINE const JSC::JSValue* arguments() const
     {
-        return m_args;
+        return m_thisAndArguments + 1;
     }
 
     ALWAYS_INLINE void* dataPtr() const
@@ -288,17 +301,17 @@ public:
         size_t maxArgc = 0;
         if (argc != nullptr) {
             maxArgc = *argc;
-            *argc = callframe.args().size() - 1;
+            *argc = callframe.argumentCount();
         }
 
         if (argv != nullptr) {
-            size_t realArgCount = callframe.args().size() - 1;
+            size_t realArgCount = callframe.argumentCount();
 
             size_t overflow = maxArgc > realArgCount ? maxArgc - realArgCount : 0;
             realArgCount = realArgCount < maxArgc ? realArgCount : maxArgc;
 
             if (realArgCount > 0) {
-                memcpy(argv, callframe.args().data() + 1, sizeof(napi_value) * realArgCount);
+                memcpy(argv, callframe.arguments(), sizeof(napi_value) * realArgCount);
                 argv += realArgCount;
             }
 
@@ -314,12 +327,11 @@ public:
     JSC::JSValue newTarget;
 
 private:
-    const JSC::ArgList m_args;
+    const JSC::JSValue* m_thisAndArguments;
+    size_t m_argumentCount;
     void* m_dataPtr;
 };
 
-#define ADDRESS_OF_THIS_VALUE_IN_CALLFRAME(callframe) callframe->addressOfArgumentsStart() - 1
-
 class NAPIFunction : public JSC::JSFunction {
 
 public:
@@ -334,12 +346,7 @@ public:
         auto* callback = reinterpret_cast<napi_callback>(function->m_method.get());
         JSC::VM& vm = globalObject->vm();
 
-        MarkedArgumentBufferWithSize<12> args;
-        size_t argc = callframe->argumentCount() + 1;
-        args.fill(vm, argc, [&](auto* slot) {
-            memcpy(slot, ADDRESS_OF_THIS_VALUE_IN_CALLFRAME(callframe), sizeof(JSC::JSValue) * argc);
-        });
-        NAPICallFrame frame(JSC::ArgList(args), function->m_dataPtr);
+        NAPICallFrame frame(callframe, function->m_dataPtr);
 
         auto scope = DECLARE_THROW_SCOPE(vm);
 
@@ -654,6 +661,13 @@ extern "C" napi_status napi_has_own_property(napi_env env, napi_value object,
     return napi_ok;
 }
 
+// ASCII names, which is nearly all of them, are looked up in the atom table
+// straight from the addon's buffer; a name seen before allocates nothing.
+// The atom owns its characters, so this is also safe for setting a property.
+#define PROPERTY_NAME_FROM_UTF8(identifierName) \
+    size_t utf8Len = strlen(utf8name);          \
+    JSC::Identifier identifierName = LIKELY(charactersAreAllASCII(std::span { reinterpret_cast<const LChar*>(utf8name), utf8Len })) ? JSC::Identifier::fromString(vm, std::span { reinterpret_cast<const LChar*>(utf8name), utf8Len }) : JSC::Identifier::fromString(vm, WTF::String::fromUTF8({ utf8name, utf8Len }));
+
 extern "C" napi_status napi_set_named_property(napi_env env, napi_value object,
     const char* utf8name,
     napi_value value)
@@ -675,8 +689,7 @@ extern "C" napi_status napi_set_named_property(napi_env env, napi_value object,
     JSC::EnsureStillAliveScope ensureAlive(jsValue);
     JSC::EnsureStillAliveScope ensureAlive2(target);
 
-    auto nameStr = WTF::String::fromUTF8({ utf8name, strlen(utf8name) });
-    auto identifier = JSC::Identifier::fromString(vm, WTFMove(nameStr));
+    PROPERTY_NAME_FROM_UTF8(identifier);
 
     auto scope = DECLARE_CATCH_SCOPE(vm);
     PutPropertySlot slot(target, true);
@@ -721,14 +734,6 @@ extern "C" napi_status napi_create_arraybuffer(napi_env env,
     return napi_ok;
 }
 
-// This is more efficient than using WTF::String::FromUTF8
-// it doesn't copy the string
-// but it's only safe to use if we are not setting a property
-// because we can't guarantee the lifetime of it
-#define PROPERTY_NAME_FROM_UTF8(identifierName) \
-    size_t utf8Len = strlen(utf8name);          \
-    JSC::PropertyName identifierName = LIKELY(charactersAreAllASCII(std::span { reinterpret_cast<const LChar*>(utf8name), utf8Len })) ? JSC::PropertyName(JSC::Identifier::fromString(vm, WTF::String(WTF::StringImpl::createWithoutCopying({ utf8name, utf8Len })))) : JSC::PropertyName(JSC::Identifier::fromString(vm, WTF::String::fromUTF8(utf8name)));
-
 extern "C" napi_status napi_has_named_property(napi_env env, napi_value object,
     const char* utf8name,
     bool* result)
@@ -820,6 +825,9 @@ node_api_create_external_string_latin1(napi_env env,
     ensureStillAliveHere(out);
     *result = toNapi(out);
     ensureStillAliveHere(out);
+    if (copied) {
+        *copied = false;
+    }
 
     return napi_ok;
 }
@@ -862,12 +870,81 @@ node_api_create_external_string_utf16(napi_env env,
     ensureStillAliveHere(out);
     *result = toNapi(out);
     ensureStillAliveHere(out);
+    if (copied) {
+        *copied = false;
+    }
 
     return napi_ok;
 }
 
+// Not part of Node-API: the UTF-8 counterpart of the two above, for addons
+// that hold their text as UTF-8. ASCII is valid Latin-1, so ASCII-only data
+// is wrapped in place like node_api_create_external_string_latin1 does.
+// Anything else has to be transcoded to UTF-16; then the string is copied,
+// `*copied` is set and finalize_callback has run by the time this returns,
+// as Node does when it cannot use an external string.
+#if !COMPILER(MSVC)
+__attribute__((visibility("default")))
+#endif
+extern "C" napi_status
+node_api_create_external_string_utf8(napi_env env,
+    char* str,
+    size_t length,
+    napi_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied)
+{
+    if (UNLIKELY(!str || !result)) {
+        return napi_invalid_arg;
+    }
+
+    length = length == NAPI_AUTO_LENGTH ? strlen(str) : length;
+    if (UNLIKELY(length > std::numeric_limits<unsigned>::max())) {
+        return napi_invalid_arg;
+    }
+
+    std::span<const LChar> bytes { reinterpret_cast<const LChar*>(str), length };
+    if (charactersAreAllASCII(bytes)) {
+        return node_api_create_external_string_latin1(env, str, length, finalize_callback, finalize_hint, result, copied);
+    }
+
+    JSGlobalObject* globalObject = toJS(env);
+    // globalObject is allowed to be null here
+    if (UNLIKELY(!globalObject)) {
+        globalObject = Bun__getDefaultGlobal();
+    }
+
+    JSString* out = JSC::jsString(globalObject->vm(), WTF::String::fromUTF8ReplacingInvalidSequences(bytes));
+    ensureStillAliveHere(out);
+    *result = toNapi(out);
+    if (finalize_callback) {
+        finalize_callback(env, str, finalize_hint);
+    }
+    if (copied) {
+        *copied = true;
+    }
+
+    return napi_ok;
+}
+
+namespace Napi {
+
+static thread_local napi_module* s_lastRegisteredModule = nullptr;
+
+// The module napi_module_register() was last called with on this thread.
+// process.dlopen() keeps it, since the static constructor that called it
+// does not run again when the same addon is loaded a second time.
+napi_module* takeRegisteredModule()
+{
+    return std::exchange(s_lastRegisteredModule, nullptr);
+}
+
+}
+
 extern "C" void napi_module_register(napi_module* mod)
 {
+    Napi::s_lastRegisteredModule = mod;
     auto* globalObject = Bun__getDefaultGlobal();
     JSC::VM& vm = globalObject->vm();
     auto keyStr = WTF::String::fromUTF8(mod->nm_modname);
@@ -1407,6 +1484,9 @@ extern "C" napi_status napi_adjust_external_memory(napi_env env,
 
     if (change_in_bytes > 0) {
         toJS(env)->vm().heap.deprecatedReportExtraMemory(change_in_bytes);
+        Bun::reportMemoryAllocated(Bun::MemorySubsystem::NapiExternalMemory, change_in_bytes);
+    } else if (change_in_bytes < 0) {
+        Bun::reportMemoryFreed(Bun::MemorySubsystem::NapiExternalMemory, -static_cast<uint64_t>(change_in_bytes));
     }
     *adjusted_value = toJS(env)->vm().heap.extraMemorySize();
     return napi_ok;
@@ -1780,12 +1860,7 @@ JSC_DEFINE_HOST_FUNCTION(NapiClass_ConstructorFunction,
     RETURN_IF_EXCEPTION(scope, {});
     callFrame->setThisValue(subclass);
 
-    MarkedArgumentBufferWithSize<12> args;
-    size_t argc = callFrame->argumentCount() + 1;
-    args.fill(vm, argc, [&](auto* slot) {
-        memcpy(slot, ADDRESS_OF_THIS_VALUE_IN_CALLFRAME(callFrame), sizeof(JSC::JSValue) * argc);
-    });
-    NAPICallFrame frame(JSC::ArgList(args), nullptr);
+    NAPICallFrame frame(callFrame, nullptr);
     frame.newTarget = newTarget;
 
     napi->constructor()(globalObject, reinterpret_cast<JSC::CallFrame*>(NAPICallFrame::toNapiCallbackInfo(frame)));
@@ -5,6 +5,8 @@
 #include "JavaScriptCore/Error.h"
 #include "JavaScriptCore/JSBigInt.h"
 #include "JavaScriptCore/Structure.h"
+#include "JavaScriptCore/Strong.h"
+#include "JavaScriptCore/StrongInlines.h"
 #include "JavaScriptCore/ThrowScope.h"
 
 #include "JavaScriptCore/JSArray.h"
@@ -50,6 +52,10 @@
 #include "wtf/LazyRef.h"
 #include "wtf/text/StringToIntegerConversion.h"
 #include <JavaScriptCore/InternalFieldTuple.h>
+#include <JavaScriptCore/JSPromise.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/WorkQueue.h>
+#include "ScriptExecutionContext.h"
 
 static constexpr int32_t kSafeIntegersFlag = 1 << 1;
 static constexpr int32_t kStrictFlag = 1 << 2;
@@ -193,6 +199,118 @@ static inline JSC::JSValue jsBigIntFromSQLite(JSC::JSGlobalObject* globalObject,
         return JSValue::encode(jsUndefined());                                                                     \
     }
 
+// Statements handed back by SQLStatement objects that were finalized or garbage collected, so that
+// preparing the same SQL (with the same flags) on this connection again skips sqlite3_prepare_v3.
+// Least recently returned entries come first and are finalized when the cache is full.
+class SQLiteStatementCache {
+public:
+    static constexpr unsigned defaultCapacity = 64;
+
+    ~SQLiteStatementCache()
+    {
+        clear();
+    }
+
+    sqlite3_stmt* take(const WTF::String& sql, unsigned int flags)
+    {
+        for (size_t i = entries.size(); i-- > 0;) {
+            auto& entry = entries[i];
+            if (entry.flags == flags && entry.sql == sql) {
+                sqlite3_stmt* stmt = entry.stmt;
+                entries.remove(i);
+                hits++;
+                return stmt;
+            }
+        }
+
+        misses++;
+        return nullptr;
+    }
+
+    // Takes ownership of the statement
+    void give(WTF::String&& sql, unsigned int flags, sqlite3_stmt* stmt)
+    {
+        // Reset right away so an idle statement neither holds a read transaction open nor
+        // keeps (possibly large) bound values alive
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+
+        if (!capacity || sql.isNull()) {
+            sqlite3_finalize(stmt);
+            return;
+        }
+
+        for (auto& entry : entries) {
+            if (entry.flags == flags && entry.sql == sql) {
+                sqlite3_finalize(stmt);
+                return;
+            }
+        }
+
+        if (entries.size() >= capacity) {
+            sqlite3_finalize(entries[0].stmt);
+            entries.remove(0);
+        }
+        entries.append({ WTFMove(sql), flags, stmt });
+    }
+
+    void setCapacity(unsigned newCapacity)
+    {
+        capacity = newCapacity;
+        while (entries.size() > capacity) {
+            sqlite3_finalize(entries[0].stmt);
+            entries.remove(0);
+        }
+    }
+
+    // Must run before closing the connection, sqlite3_close fails on unfinalized statements
+    void clear()
+    {
+        for (auto& entry : entries)
+            sqlite3_finalize(entry.stmt);
+        entries.clear();
+    }
+
+    size_t size() const { return entries.size(); }
+
+    unsigned capacity = defaultCapacity;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+private:
+    struct Entry {
+        WTF::String sql;
+        unsigned int flags;
+        sqlite3_stmt* stmt;
+    };
+    Vector<Entry> entries;
+};
+
+// A read-only connection to the same file as its database, driven by its own serial work queue so
+// that allAsync() can run long queries without blocking the JS thread
+class SQLiteReadConnection : public ThreadSafeRefCounted<SQLiteReadConnection> {
+public:
+    static Ref<SQLiteReadConnection> create(sqlite3* db)
+    {
+        return adoptRef(*new SQLiteReadConnection(db));
+    }
+
+    ~SQLiteReadConnection()
+    {
+        sqlite3_close_v2(db);
+    }
+
+    sqlite3* db;
+    Ref<WorkQueue> queue;
+
+private:
+    explicit SQLiteReadConnection(sqlite3* db)
+        : db(db)
+        , queue(WorkQueue::create("bun.sqlite.ReadPool"_s))
+    {
+    }
+};
+
 class VersionSqlite3 {
 public:
     explicit VersionSqlite3(sqlite3* db)
@@ -202,6 +320,24 @@ public:
     }
     sqlite3* db;
     std::atomic<uint64_t> version;
+    SQLiteStatementCache statementCache;
+    // Connections used by allAsync(), empty unless openReadPool() was called
+    Vector<Ref<SQLiteReadConnection>> readPool;
+    unsigned nextReadConnection = 0;
+    // Handles returned by openBlob(), closed slots are nullptr and get reused
+    Vector<sqlite3_blob*> blobs;
+
+    // Everything that has to go before the connection itself can be closed
+    void closeDependents()
+    {
+        statementCache.clear();
+        readPool.clear();
+        for (auto* blob : blobs) {
+            if (blob)
+                sqlite3_blob_close(blob);
+        }
+        blobs.clear();
+    }
 };
 
 class SQLiteSingleton {
@@ -232,8 +368,11 @@ extern "C" void Bun__closeAllSQLiteDatabasesForTermination()
     auto& dbs = _instance->databases;
 
     for (auto& db : dbs) {
-        if (db->db)
-            sqlite3_close(db->db);
+        if (db->db) {
+            db->closeDependents();
+            if (sqlite3_close(db->db) == SQLITE_OK)
+                db->db = nullptr;
+        }
     }
 }
 
@@ -246,12 +385,24 @@ JSC_DECLARE_HOST_FUNCTION(jsSQLStatementOpenStatementFunction);
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementIsInTransactionFunction);
 
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementLoadExtensionFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementStatementCacheStatsFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementSetStatementCacheSizeFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementOpenReadPoolFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementOpenBlobFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementReadBlobFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementCloseBlobFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementDatabaseStatsFunction);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementCreateFunctionFunction);
 
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunction);
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRun);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRunMany);
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionGet);
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAllAsync);
 JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRows);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionColumnar);
+JSC_DECLARE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionNextBatch);
 
 JSC_DECLARE_CUSTOM_GETTER(jsSqlStatementGetColumnNames);
 JSC_DECLARE_CUSTOM_GETTER(jsSqlStatementGetColumnCount);
@@ -270,13 +421,9 @@ JSC_DECLARE_CUSTOM_GETTER(jsSqlStatementGetParamCount);
 JSC_DECLARE_CUSTOM_GETTER(jsSqlStatementGetSafeIntegers);
 JSC_DECLARE_CUSTOM_SETTER(jsSqlStatementSetSafeIntegers);
 
-static JSValue createSQLiteError(JSC::JSGlobalObject* globalObject, sqlite3* db)
+static JSValue createSQLiteError(JSC::JSGlobalObject* globalObject, int code, int byteOffset, const char* msg)
 {
     auto& vm = globalObject->vm();
-    int code = sqlite3_extended_errcode(db);
-    int byteOffset = sqlite3_error_offset(db);
-
-    const char* msg = sqlite3_errmsg(db);
     WTF::String str = WTF::String::fromUTF8(msg);
     JSC::JSObject* object = JSC::createError(globalObject, str);
     auto& builtinNames = WebCore::builtinNames(vm);
@@ -303,6 +450,11 @@ static JSValue createSQLiteError(JSC::JSGlobalObject* globalObject, sqlite3* db)
     return object;
 }
 
+static JSValue createSQLiteError(JSC::JSGlobalObject* globalObject, sqlite3* db)
+{
+    return createSQLiteError(globalObject, sqlite3_extended_errcode(db), sqlite3_error_offset(db), sqlite3_errmsg(db));
+}
+
 class SQLiteBindingsMap {
 public:
     SQLiteBindingsMap() = default;
@@ -319,6 +471,7 @@ public:
         if (this->count != count) {
             hasLoadedNames = false;
             bindingNames.clear();
+            cachedStructure.clear();
         }
         this->count = count;
     }
@@ -330,6 +483,7 @@ public:
 
         hasLoadedNames = true;
         hasOutOfOrderNames = false;
+        cachedStructure.clear();
 
         size_t count = this->count;
         size_t prefixOffset = trimLeadingPrefix ? 1 : 0;
@@ -373,6 +527,10 @@ public:
     }
 
     Vector<Identifier> bindingNames;
+    // Where each of bindingNames is stored in objects of cachedStructure, so
+    // that binding objects of the same shape again skips the lookups.
+    JSC::Strong<JSC::Structure> cachedStructure;
+    Vector<JSC::PropertyOffset> cachedOffsets;
     uint16_t count = 0;
     bool hasLoadedNames : 1 = false;
     bool isOnlyIndexed : 1 = false;
@@ -427,6 +585,9 @@ public:
 
     ~JSSQLStatement();
 
+    // Finalizes stmt, or returns it to the statement cache of its connection
+    void releaseStatement();
+
     sqlite3_stmt* stmt;
     VersionSqlite3* version_db;
     uint64_t version = 0;
@@ -439,8 +600,15 @@ public:
     mutable JSC::WriteBarrier<JSC::JSObject> userPrototype;
     size_t extraMemorySize = 0;
     SQLiteBindingsMap m_bindingNames = { 0, false };
+    // Per result column type toJSSpecialized() expects, see expectedColumnType()
+    Vector<uint8_t> columnTypes;
+    // Key under which stmt goes back to the connection's statement cache
+    WTF::String sql;
+    unsigned int prepareFlags = 0;
     bool hasExecuted : 1 = false;
     bool useBigInt64 : 1 = false;
+    // nextBatch() stopped on a row it has not returned yet
+    bool isIterating : 1 = false;
 
 protected:
     JSSQLStatement(JSC::Structure* structure, JSDOMGlobalObject& globalObject, sqlite3_stmt* stmt, VersionSqlite3* version_db, int64_t memorySizeChange = 0)
@@ -502,6 +670,101 @@ static JSValue toJS(JSC::VM& vm, JSC::JSGlobalObject* globalObject, sqlite3_stmt
 
     return jsNull();
 }
+// SQLite type a column is expected to keep for every row, from the first row (or the declared
+// type when that was NULL). SQLITE_NULL means the column always takes the generic toJS path.
+static uint8_t expectedColumnType(sqlite3_stmt* stmt, int i)
+{
+    int type = sqlite3_column_type(stmt, i);
+    if (type == SQLITE_INTEGER || type == SQLITE_FLOAT || type == SQLITE3_TEXT)
+        return static_cast<uint8_t>(type);
+    if (type != SQLITE_NULL)
+        return SQLITE_NULL;
+
+    // Same rules as SQLite's column affinity
+    const char* declared = sqlite3_column_decltype(stmt, i);
+    if (!declared)
+        return SQLITE_NULL;
+    auto declaredType = WTF::String::fromLatin1(declared);
+    auto contains = [&](ASCIILiteral affinity) {
+        return declaredType.findIgnoringASCIICase(affinity) != notFound;
+    };
+    if (contains("INT"_s))
+        return SQLITE_INTEGER;
+    if (contains("CHAR"_s) || contains("CLOB"_s) || contains("TEXT"_s))
+        return SQLITE3_TEXT;
+    if (contains("REAL"_s) || contains("FLOA"_s) || contains("DOUB"_s))
+        return SQLITE_FLOAT;
+    return SQLITE_NULL;
+}
+
+// Decodes a column that is expected to have expectedType with a single sqlite3_column_value()
+// call instead of sqlite3_column_type() plus one or two value getters, each of which takes the
+// connection mutex. The caller holds that mutex for the whole row, which is what makes the
+// unprotected sqlite3_value safe to read. A cell of another type demotes the column to toJS.
+template<bool useBigInt64>
+static inline JSValue toJSSpecialized(JSC::VM& vm, JSC::JSGlobalObject* globalObject, sqlite3_stmt* stmt, int i, uint8_t& expectedType)
+{
+    if (expectedType != SQLITE_NULL) {
+        sqlite3_value* value = sqlite3_column_value(stmt, i);
+        if (LIKELY(sqlite3_value_type(value) == expectedType)) {
+            switch (expectedType) {
+            case SQLITE_INTEGER: {
+                int64_t num = sqlite3_value_int64(value);
+                if constexpr (!useBigInt64) {
+                    return num > INT_MAX || num < INT_MIN ? JSC::jsDoubleNumber(static_cast<double>(num)) : JSC::jsNumber(static_cast<int>(num));
+                } else {
+                    return JSC::JSBigInt::createFrom(globalObject, num);
+                }
+            }
+            case SQLITE_FLOAT:
+                return jsDoubleNumber(sqlite3_value_double(value));
+            default: {
+                const unsigned char* text = sqlite3_value_text(value);
+                size_t len = sqlite3_value_bytes(value);
+                if (UNLIKELY(text == nullptr || len == 0)) {
+                    return jsEmptyString(vm);
+                }
+
+                return len < 64 ? jsString(vm, WTF::String::fromUTF8({ text, len })) : JSC::JSValue::decode(Bun__encoding__toStringUTF8(text, len, globalObject));
+            }
+            }
+        }
+
+        expectedType = SQLITE_NULL;
+    }
+
+    return toJS<useBigInt64>(vm, globalObject, stmt, i);
+}
+
+// Holds the connection mutex while one row is decoded
+class SQLiteRowLocker {
+public:
+    explicit SQLiteRowLocker(sqlite3* db)
+        : m_mutex(sqlite3_db_mutex(db))
+    {
+        sqlite3_mutex_enter(m_mutex);
+    }
+
+    ~SQLiteRowLocker()
+    {
+        sqlite3_mutex_leave(m_mutex);
+    }
+
+private:
+    sqlite3_mutex* m_mutex;
+};
+
+static inline void ensureColumnTypes(JSSQLStatement* castedThis, size_t columnCount)
+{
+    auto& columnTypes = castedThis->columnTypes;
+    if (LIKELY(columnTypes.size() == columnCount))
+        return;
+
+    columnTypes.resize(columnCount);
+    for (size_t i = 0; i < columnCount; i++)
+        columnTypes[i] = expectedColumnType(castedThis->stmt, i);
+}
+
 extern "C" {
 static JSC_DECLARE_JIT_OPERATION_WITHOUT_WTF_INTERNAL(jsSQLStatementExecuteStatementFunctionGetWithoutTypeChecking, JSC::EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSSQLStatement* castedThis));
 }
@@ -516,10 +779,14 @@ static const JSC::DOMJIT::Signature DOMJITSignatureForjsSQLStatementExecuteState
 
 static const HashTableValue JSSQLStatementPrototypeTableValues[] = {
     { "run"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionRun, 1 } },
+    { "runMany"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionRunMany, 2 } },
     { "get"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function | JSC::PropertyAttribute::DOMJITFunction), NoIntrinsic, { HashTableValue::DOMJITFunctionType, jsSQLStatementExecuteStatementFunctionGet, &DOMJITSignatureForjsSQLStatementExecuteStatementFunctionGet } },
     { "all"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionAll, 1 } },
+    { "allAsync"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionAllAsync, 1 } },
     { "as"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSetPrototypeFunction, 1 } },
     { "values"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionRows, 1 } },
+    { "columnar"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionColumnar, 1 } },
+    { "nextBatch"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteStatementFunctionNextBatch, 2 } },
     { "finalize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementFunctionFinalize, 0 } },
     { "toString"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementToStringFunction, 0 } },
     { "columns"_s, static_cast<unsigned>(JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::CustomAccessor), NoIntrinsic, { HashTableValue::GetterSetterType, jsSqlStatementGetColumnNames, 0 } },
@@ -587,6 +854,7 @@ static void initializeColumnNames(JSC::JSGlobalObject* lexicalGlobalObject, JSSQ
             castedThis->columnNames->privateSymbolMode()));
     }
     castedThis->validColumns.clearAll();
+    castedThis->columnTypes.clear();
     castedThis->update_version();
 
     JSC::VM& vm = lexicalGlobalObject->vm();
@@ -627,8 +895,10 @@ static void initializeColumnNames(JSC::JSGlobalObject* lexicalGlobalObject, JSSQ
             // columnNames de-dupes property names internally
             // We can't have two properties with the same name, so we use validColumns to track this.
             auto preCount = columnNames->size();
-            columnNames->add(
-                Identifier::fromString(vm, WTF::String::fromUTF8({ name, len })));
+            if (simdutf::validate_ascii(name, len))
+                columnNames->add(Identifier::fromString(vm, clientData(vm)->atomStringCache.make({ reinterpret_cast<const LChar*>(name), len })));
+            else
+                columnNames->add(Identifier::fromString(vm, WTF::String::fromUTF8({ name, len })));
             auto curCount = columnNames->size();
 
             if (preCount != curCount) {
@@ -908,9 +1178,27 @@ static JSC::JSValue rebindObject(JSC::JSGlobalObject* globalObject, SQLiteBindin
     // { foo: "bar", baz: "qux" }
     //
     else if (target->canUseFastGetOwnProperty(structure)) {
+        // A dictionary changes without getting a new structure, so its
+        // offsets cannot be kept.
+        if (bindings.cachedStructure.get() != &structure && !structure.isDictionary()) {
+            bindings.cachedOffsets.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                const auto& property = bindingNames[i];
+                bindings.cachedOffsets[i] = property.isEmpty() ? invalidOffset : structure.get(vm, property);
+            }
+            bindings.cachedStructure.set(vm, &structure);
+        }
+        const bool useCachedOffsets = bindings.cachedStructure.get() == &structure;
+
         for (size_t i = 0; i < size; i++) {
             const auto& property = bindingNames[i];
-            JSValue value = property.isEmpty() ? target->getDirectIndex(globalObject, i) : target->fastGetOwnProperty(vm, structure, bindingNames[i]);
+            JSValue value;
+            if (property.isEmpty())
+                value = target->getDirectIndex(globalObject, i);
+            else if (useCachedOffsets)
+                value = isValidOffset(bindings.cachedOffsets[i]) ? target->getDirect(bindings.cachedOffsets[i]) : JSValue();
+            else
+                value = target->fastGetOwnProperty(vm, structure, bindingNames[i]);
             if (!value && !scope.exception()) {
                 if (throwOnMissing) {
                     throwException(globalObject, scope, createError(globalObject, makeString("Missing parameter \""_s, property.isEmpty() ? String::number(i) : property.string(), "\""_s)));
@@ -1487,32 +1775,37 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementPrepareStatementFunction, (JSC::JSGlobalO
         flags = static_cast<unsigned int>(prepareFlags);
     }
 
-    sqlite3_stmt* statement = nullptr;
+    auto* version_db = databases()[handle];
+    sqlite3_stmt* statement = version_db->statementCache.take(sqlString, flags);
 
     // This is inherently somewhat racy if using Worker
     // but that should be okay.
     int64_t currentMemoryUsage = sqlite_malloc_amount;
 
-    int rc = SQLITE_OK;
-    if (
-        // fast path: ascii latin1 string is utf8
-        sqlString.is8Bit() && simdutf::validate_ascii(reinterpret_cast<const char*>(sqlString.span8().data()), sqlString.length())) {
-        rc = sqlite3_prepare_v3(db, reinterpret_cast<const char*>(sqlString.span8().data()), sqlString.length(), flags, &statement, nullptr);
-    } else {
-        // slow path: utf16 or latin1 string with supplemental characters
-        CString utf8 = sqlString.utf8();
-        rc = sqlite3_prepare_v3(db, utf8.data(), utf8.length(), flags, &statement, nullptr);
-    }
+    if (!statement) {
+        int rc = SQLITE_OK;
+        if (
+            // fast path: ascii latin1 string is utf8
+            sqlString.is8Bit() && simdutf::validate_ascii(reinterpret_cast<const char*>(sqlString.span8().data()), sqlString.length())) {
+            rc = sqlite3_prepare_v3(db, reinterpret_cast<const char*>(sqlString.span8().data()), sqlString.length(), flags, &statement, nullptr);
+        } else {
+            // slow path: utf16 or latin1 string with supplemental characters
+            CString utf8 = sqlString.utf8();
+            rc = sqlite3_prepare_v3(db, utf8.data(), utf8.length(), flags, &statement, nullptr);
+        }
 
-    if (rc != SQLITE_OK) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
-        return JSValue::encode(JSC::jsUndefined());
+        if (rc != SQLITE_OK) {
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+            return JSValue::encode(JSC::jsUndefined());
+        }
     }
 
     int64_t memoryChange = sqlite_malloc_amount - currentMemoryUsage;
 
     JSSQLStatement* sqlStatement = JSSQLStatement::create(
-        reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject), statement, databases()[handle], memoryChange);
+        reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject), statement, version_db, memoryChange);
+    sqlStatement->sql = WTFMove(sqlString);
+    sqlStatement->prepareFlags = flags;
 
     if (internalFlagsValue.isInt32()) {
         const int32_t internalFlags = internalFlagsValue.asInt32();
@@ -1536,6 +1829,74 @@ JSSQLStatementConstructor* JSSQLStatementConstructor::create(JSC::VM& vm, JSC::J
     return ptr;
 }
 
+// Applies the tuning options object passed to open(): mmapSize, cacheSize (pages, or KiB when
+// negative, like PRAGMA cache_size), walAutocheckpoint (pages, 0 disables) and lookaside
+// ({ slotSize, slotCount }, the connection's own small-allocation pool)
+static bool applySQLiteOpenOptions(JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, sqlite3* db, JSC::JSObject* options)
+{
+    auto& vm = lexicalGlobalObject->vm();
+
+    auto getInteger = [&](ASCIILiteral name, std::optional<int64_t>& out) -> bool {
+        JSValue value = options->get(lexicalGlobalObject, Identifier::fromString(vm, name));
+        RETURN_IF_EXCEPTION(scope, false);
+        if (value.isUndefined())
+            return true;
+        if (UNLIKELY(!value.isAnyInt())) {
+            throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, makeString("Expected "_s, name, " to be an integer"_s)));
+            return false;
+        }
+        out = value.asAnyInt();
+        return true;
+    };
+
+    auto execPragma = [&](ASCIILiteral pragma, int64_t value) -> bool {
+        auto sql = makeString("PRAGMA "_s, pragma, '=', value).utf8();
+        if (sqlite3_exec(db, sql.data(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+            return false;
+        }
+        return true;
+    };
+
+    std::optional<int64_t> mmapSize, cacheSize, walAutocheckpoint;
+    if (!getInteger("mmapSize"_s, mmapSize) || !getInteger("cacheSize"_s, cacheSize) || !getInteger("walAutocheckpoint"_s, walAutocheckpoint))
+        return false;
+
+    JSValue lookasideValue = options->get(lexicalGlobalObject, Identifier::fromString(vm, "lookaside"_s));
+    RETURN_IF_EXCEPTION(scope, false);
+    if (lookasideValue.isObject()) {
+        auto* lookaside = lookasideValue.getObject();
+        JSValue slotSize = lookaside->get(lexicalGlobalObject, Identifier::fromString(vm, "slotSize"_s));
+        RETURN_IF_EXCEPTION(scope, false);
+        JSValue slotCount = lookaside->get(lexicalGlobalObject, Identifier::fromString(vm, "slotCount"_s));
+        RETURN_IF_EXCEPTION(scope, false);
+        if (UNLIKELY(!slotSize.isUInt32() || !slotCount.isUInt32())) {
+            throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected lookaside.slotSize and lookaside.slotCount to be integers"_s));
+            return false;
+        }
+
+        // With a null buffer SQLite allocates the pool itself
+        if (sqlite3_db_config(db, SQLITE_DBCONFIG_LOOKASIDE, nullptr, static_cast<int>(slotSize.asUInt32()), static_cast<int>(slotCount.asUInt32())) != SQLITE_OK) {
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+            return false;
+        }
+    } else if (UNLIKELY(!lookasideValue.isUndefined())) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected lookaside to be an object"_s));
+        return false;
+    }
+
+    if (mmapSize && !execPragma("mmap_size"_s, *mmapSize))
+        return false;
+    if (cacheSize && !execPragma("cache_size"_s, *cacheSize))
+        return false;
+    if (walAutocheckpoint && sqlite3_wal_autocheckpoint(db, static_cast<int>(*walAutocheckpoint)) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        return false;
+    }
+
+    return true;
+}
+
 JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenStatementFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
     JSC::VM& vm = lexicalGlobalObject->vm();
@@ -1585,6 +1946,18 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenStatementFunction, (JSC::JSGlobalObje
 
     JSValue finalizationTarget = callFrame->argument(2);
 
+    // Connections to the same file that all ask for the shared cache, from any thread (so any
+    // Worker) in this process, use a single page cache instead of one each
+    JSValue optionsValue = callFrame->argument(3);
+    if (optionsValue.isObject()) {
+        JSValue sharedCache = optionsValue.getObject()->get(lexicalGlobalObject, Identifier::fromString(vm, "sharedCache"_s));
+        RETURN_IF_EXCEPTION(scope, {});
+        if (sharedCache.toBoolean(lexicalGlobalObject)) {
+            openFlags |= SQLITE_OPEN_SHAREDCACHE;
+            openFlags &= ~SQLITE_OPEN_PRIVATECACHE;
+        }
+    }
+
     sqlite3* db = nullptr;
     int statusCode = sqlite3_open_v2(path.utf8().data(), &db, openFlags, nullptr);
 
@@ -1605,6 +1978,14 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenStatementFunction, (JSC::JSGlobalObje
     if (status != SQLITE_OK) {
         // TODO: log a warning here that defensive mode is unsupported.
     }
+
+    if (optionsValue.isObject()) {
+        if (!applySQLiteOpenOptions(lexicalGlobalObject, scope, db, optionsValue.getObject())) {
+            sqlite3_close_v2(db);
+            return JSValue::encode(jsUndefined());
+        }
+    }
+
     auto index = databases().size();
 
     databases().append(new VersionSqlite3(db));
@@ -1614,6 +1995,7 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenStatementFunction, (JSC::JSGlobalObje
             if (!db->db) {
                 return;
             }
+            db->closeDependents();
             sqlite3_close_v2(db->db);
             databases()[index]->db = nullptr;
         });
@@ -1663,6 +2045,8 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementCloseStatementFunction, (JSC::JSGlobalObj
         return JSValue::encode(jsUndefined());
     }
 
+    databases()[dbIndex]->closeDependents();
+
     // sqlite3_close_v2 is used for automatic GC cleanup
     int statusCode = shouldThrowOnError ? sqlite3_close(db) : sqlite3_close_v2(db);
     if (statusCode != SQLITE_OK) {
@@ -1759,186 +2143,1500 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementFcntlFunction, (JSC::JSGlobalObject * lex
     return JSValue::encode(jsNumber(statusCode));
 }
 
-/* Hash table for constructor */
-static const HashTableValue JSSQLStatementConstructorTableValues[] = {
-    { "open"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementOpenStatementFunction, 2 } },
-    { "close"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementCloseStatementFunction, 1 } },
-    { "prepare"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementPrepareStatementFunction, 2 } },
-    { "run"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteFunction, 3 } },
-    { "isInTransaction"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementIsInTransactionFunction, 1 } },
-    { "loadExtension"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementLoadExtensionFunction, 2 } },
-    { "setCustomSQLite"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSetCustomSQLite, 1 } },
-    { "serialize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSerialize, 1 } },
-    { "deserialize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementDeserialize, 2 } },
-    { "fcntl"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementFcntlFunction, 2 } },
-};
-
-const ClassInfo JSSQLStatementConstructor::s_info = { "SQLStatement"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSSQLStatementConstructor) };
-
-void JSSQLStatementConstructor::finishCreation(VM& vm)
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementStatementCacheStatsFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
-    Base::finishCreation(vm);
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
 
-    // TODO: use LazyClassStructure?
-    auto* instanceObject = JSSQLStatement::create(reinterpret_cast<Zig::GlobalObject*>(globalObject()), nullptr, nullptr);
-    JSValue proto = instanceObject->getPrototype(vm, globalObject());
+    JSValue thisValue = callFrame->thisValue();
+    JSSQLStatementConstructor* thisObject = jsDynamicCast<JSSQLStatementConstructor*>(thisValue.getObject());
+    if (UNLIKELY(!thisObject)) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Expected SQLStatement"_s));
+        return JSValue::encode(jsUndefined());
+    }
 
-    this->putDirect(vm, vm.propertyNames->prototype, proto, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
 
-    reifyStaticProperties(vm, JSSQLStatementConstructor::info(), JSSQLStatementConstructorTableValues, *this);
-    JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
+    const auto& cache = databases()[dbIndex]->statementCache;
+    JSC::JSObject* stats = JSC::constructEmptyObject(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), 4);
+    stats->putDirect(vm, Identifier::fromString(vm, "hits"_s), jsNumber(cache.hits), 0);
+    stats->putDirect(vm, Identifier::fromString(vm, "misses"_s), jsNumber(cache.misses), 0);
+    stats->putDirect(vm, Identifier::fromString(vm, "size"_s), jsNumber(cache.size()), 0);
+    stats->putDirect(vm, Identifier::fromString(vm, "capacity"_s), jsNumber(cache.capacity), 0);
 
-    ASSERT(inherits(info()));
+    RELEASE_AND_RETURN(scope, JSValue::encode(stats));
 }
 
-template<bool useBigInt64>
-static inline JSC::JSValue constructResultObject(JSC::JSGlobalObject* lexicalGlobalObject, JSSQLStatement* castedThis)
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementSetStatementCacheSizeFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
-    auto& columnNames = castedThis->columnNames->data()->propertyNameVector();
-    int count = columnNames.size();
-    auto& vm = lexicalGlobalObject->vm();
-
-    // 64 is the maximum we can preallocate here
-    // see https://github.com/oven-sh/bun/issues/987
-    JSC::JSObject* result;
-
-    auto* stmt = castedThis->stmt;
-
-    if (auto* structure = castedThis->_structure.get()) {
-        result = JSC::constructEmptyObject(vm, structure);
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
 
-        // i: the index of columns returned from SQLite
-        // j: the index of object property
-        for (int i = 0, j = 0; j < count; i++, j++) {
-            if (!castedThis->validColumns.get(i)) {
-                // this column is duplicate, skip
-                j -= 1;
-                continue;
-            }
-            result->putDirectOffset(vm, j, toJS<useBigInt64>(vm, lexicalGlobalObject, stmt, i));
-        }
+    JSValue thisValue = callFrame->thisValue();
+    JSSQLStatementConstructor* thisObject = jsDynamicCast<JSSQLStatementConstructor*>(thisValue.getObject());
+    if (UNLIKELY(!thisObject)) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Expected SQLStatement"_s));
+        return JSValue::encode(jsUndefined());
+    }
 
-    } else {
-        if (count <= JSFinalObject::maxInlineCapacity) {
-            result = JSC::JSFinalObject::create(vm, castedThis->_prototype.get()->structure());
-        } else {
-            JSObject* prototype = castedThis->userPrototype ? castedThis->userPrototype.get() : lexicalGlobalObject->objectPrototype();
-            result = JSC::JSFinalObject::create(vm, JSC::JSFinalObject::createStructure(vm, lexicalGlobalObject, prototype, JSFinalObject::maxInlineCapacity));
-        }
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
 
-        for (int i = 0, j = 0; j < count; i++, j++) {
-            if (!castedThis->validColumns.get(i)) {
-                j -= 1;
-                continue;
-            }
-            const auto& name = columnNames[j];
-            result->putDirect(vm, name, toJS<useBigInt64>(vm, lexicalGlobalObject, stmt, i), 0);
-        }
+    JSValue sizeValue = callFrame->argument(1);
+    if (UNLIKELY(!sizeValue.isNumber() || sizeValue.asNumber() < 0 || sizeValue.asNumber() > std::numeric_limits<uint16_t>::max())) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Expected statement cache size to be a number between 0 and 65535"_s));
+        return JSValue::encode(jsUndefined());
     }
 
-    return JSValue(result);
+    databases()[dbIndex]->statementCache.setCapacity(static_cast<unsigned>(sizeValue.asNumber()));
+    return JSValue::encode(jsUndefined());
 }
 
-static inline JSC::JSArray* constructResultRow(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSSQLStatement* castedThis, size_t columnCount)
+// Opens size read-only connections to the database file for allAsync(). The database is switched
+// to WAL mode so that the pool can keep reading while this connection writes.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenReadPoolFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
-    auto throwScope = DECLARE_THROW_SCOPE(vm);
-    auto* stmt = castedThis->stmt;
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
 
-    MarkedArgumentBuffer arguments;
+    JSValue thisValue = callFrame->thisValue();
+    JSSQLStatementConstructor* thisObject = jsDynamicCast<JSSQLStatementConstructor*>(thisValue.getObject());
+    if (UNLIKELY(!thisObject)) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Expected SQLStatement"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    auto* version_db = databases()[dbIndex];
+    sqlite3* db = version_db->db;
+    if (UNLIKELY(!db)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Cannot use a closed database"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue sizeValue = callFrame->argument(1);
+    if (UNLIKELY(!sizeValue.isNumber() || sizeValue.asNumber() < 1 || sizeValue.asNumber() > 64)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Expected read pool size to be a number between 1 and 64"_s));
+        return JSValue::encode(jsUndefined());
+    }
+    unsigned size = static_cast<unsigned>(sizeValue.asNumber());
+
+    const char* filename = sqlite3_db_filename(db, "main");
+    if (UNLIKELY(!filename || !*filename)) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "A read pool needs a database file, not an in-memory database"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    if (sqlite3_exec(db, "PRAGMA journal_mode=WAL", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    Vector<Ref<SQLiteReadConnection>> readPool;
+    for (unsigned i = 0; i < size; i++) {
+        sqlite3* reader = nullptr;
+        int statusCode = sqlite3_open_v2(filename, &reader, SQLITE_OPEN_READONLY, nullptr);
+        if (statusCode != SQLITE_OK) {
+            throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, WTF::String::fromUTF8(sqlite3_errstr(statusCode))));
+            if (reader)
+                sqlite3_close(reader);
+            return JSValue::encode(jsUndefined());
+        }
+        sqlite3_extended_result_codes(reader, 1);
+        // Checkpoints briefly lock out readers
+        sqlite3_busy_timeout(reader, 5000);
+        readPool.append(SQLiteReadConnection::create(reader));
+    }
+
+    version_db->readPool = WTFMove(readPool);
+    version_db->nextReadConnection = 0;
+    return JSValue::encode(jsUndefined());
+}
+
+static sqlite3_blob* blobFromArguments(JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, JSC::CallFrame* callFrame, VersionSqlite3*& version_db, unsigned& blobIndex)
+{
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return nullptr;
+    }
+    version_db = databases()[dbIndex];
+
+    JSValue blobValue = callFrame->argument(1);
+    if (UNLIKELY(!blobValue.isUInt32() || blobValue.asUInt32() >= version_db->blobs.size() || !version_db->blobs[blobValue.asUInt32()])) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid or closed blob handle"_s));
+        return nullptr;
+    }
+
+    blobIndex = blobValue.asUInt32();
+    return version_db->blobs[blobIndex];
+}
+
+// openBlob(handle, table, column, rowid, writable = false, schema = "main") opens the value for
+// incremental I/O and returns { handle, size }, so large BLOBs can be read one window at a time
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementOpenBlobFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    auto* version_db = databases()[dbIndex];
+    sqlite3* db = version_db->db;
+    if (UNLIKELY(!db)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Cannot use a closed database"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue tableValue = callFrame->argument(1);
+    JSValue columnValue = callFrame->argument(2);
+    if (UNLIKELY(!tableValue.isString() || !columnValue.isString())) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected table and column names to be strings"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue rowidValue = callFrame->argument(3);
+    int64_t rowid;
+    if (rowidValue.isAnyInt()) {
+        rowid = rowidValue.asAnyInt();
+    } else if (rowidValue.isHeapBigInt()) {
+        rowid = JSBigInt::toBigInt64(rowidValue);
+    } else {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected rowid to be an integer or bigint"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    bool writable = callFrame->argument(4).toBoolean(lexicalGlobalObject);
+    CString schema = "main";
+    if (!callFrame->argument(5).isUndefined()) {
+        schema = callFrame->argument(5).toWTFString(lexicalGlobalObject).utf8();
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    CString table = tableValue.toWTFString(lexicalGlobalObject).utf8();
+    RETURN_IF_EXCEPTION(scope, {});
+    CString column = columnValue.toWTFString(lexicalGlobalObject).utf8();
+    RETURN_IF_EXCEPTION(scope, {});
+
+    sqlite3_blob* blob = nullptr;
+    if (sqlite3_blob_open(db, schema.data(), table.data(), column.data(), rowid, writable ? 1 : 0, &blob) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        if (blob)
+            sqlite3_blob_close(blob);
+        return JSValue::encode(jsUndefined());
+    }
+
+    auto& blobs = version_db->blobs;
+    size_t blobIndex = blobs.find(nullptr);
+    if (blobIndex == notFound) {
+        blobIndex = blobs.size();
+        blobs.append(blob);
+    } else {
+        blobs[blobIndex] = blob;
+    }
+
+    JSC::JSObject* result = JSC::constructEmptyObject(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), 2);
+    result->putDirect(vm, Identifier::fromString(vm, "handle"_s), jsNumber(blobIndex), 0);
+    result->putDirect(vm, Identifier::fromString(vm, "size"_s), jsNumber(sqlite3_blob_bytes(blob)), 0);
+    RELEASE_AND_RETURN(scope, JSValue::encode(result));
+}
+
+// readBlob(handle, blob, target, offset) fills target (any ArrayBufferView) starting at offset
+// and returns the number of bytes read, which is less than its length only at the end
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementReadBlobFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    VersionSqlite3* version_db = nullptr;
+    unsigned blobIndex = 0;
+    sqlite3_blob* blob = blobFromArguments(lexicalGlobalObject, scope, callFrame, version_db, blobIndex);
+    if (!blob)
+        return JSValue::encode(jsUndefined());
+
+    auto* target = jsDynamicCast<JSC::JSArrayBufferView*>(callFrame->argument(2));
+    if (UNLIKELY(!target || target->isDetached())) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected target to be a TypedArray or DataView"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int size = sqlite3_blob_bytes(blob);
+    JSValue offsetValue = callFrame->argument(3);
+    if (UNLIKELY(!offsetValue.isNumber() || offsetValue.asNumber() < 0 || offsetValue.asNumber() > size)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Expected offset to be within the blob"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int offset = static_cast<int>(offsetValue.asNumber());
+    int length = static_cast<int>(std::min<size_t>(target->byteLength(), static_cast<size_t>(size - offset)));
+    if (length > 0 && sqlite3_blob_read(blob, target->vector(), length, offset) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, version_db->db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    return JSValue::encode(jsNumber(length));
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementCloseBlobFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    VersionSqlite3* version_db = nullptr;
+    unsigned blobIndex = 0;
+    sqlite3_blob* blob = blobFromArguments(lexicalGlobalObject, scope, callFrame, version_db, blobIndex);
+    if (!blob)
+        return JSValue::encode(jsUndefined());
+
+    version_db->blobs[blobIndex] = nullptr;
+    sqlite3_blob_close(blob);
+    return JSValue::encode(jsUndefined());
+}
+
+// stats(handle, reset = false) returns the page cache and memory counters of one connection,
+// plus the process-wide memory used by SQLite. reset clears the resettable highwater marks.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementDatabaseStatsFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    sqlite3* db = databases()[dbIndex]->db;
+    if (UNLIKELY(!db)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Cannot use a closed database"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int reset = callFrame->argument(1).toBoolean(lexicalGlobalObject) ? 1 : 0;
+
+    JSC::JSObject* stats = JSC::constructEmptyObject(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), 12);
+    auto putStatus = [&](ASCIILiteral name, int op, bool highwater) {
+        int current = 0;
+        int highest = 0;
+        sqlite3_db_status(db, op, &current, &highest, reset);
+        stats->putDirect(vm, Identifier::fromString(vm, name), jsNumber(highwater ? highest : current), 0);
+    };
+
+    putStatus("cacheHit"_s, SQLITE_DBSTATUS_CACHE_HIT, false);
+    putStatus("cacheMiss"_s, SQLITE_DBSTATUS_CACHE_MISS, false);
+    putStatus("cacheWrite"_s, SQLITE_DBSTATUS_CACHE_WRITE, false);
+    putStatus("cacheSpill"_s, SQLITE_DBSTATUS_CACHE_SPILL, false);
+    putStatus("cacheUsed"_s, SQLITE_DBSTATUS_CACHE_USED, false);
+    putStatus("schemaUsed"_s, SQLITE_DBSTATUS_SCHEMA_USED, false);
+    putStatus("stmtUsed"_s, SQLITE_DBSTATUS_STMT_USED, false);
+    putStatus("lookasideUsed"_s, SQLITE_DBSTATUS_LOOKASIDE_USED, false);
+    putStatus("lookasideHit"_s, SQLITE_DBSTATUS_LOOKASIDE_HIT, true);
+    putStatus("lookasideMissFull"_s, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, true);
+
+    sqlite3_int64 memoryUsed = 0;
+    sqlite3_int64 memoryHighwater = 0;
+    sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &memoryUsed, &memoryHighwater, reset);
+    stats->putDirect(vm, Identifier::fromString(vm, "memoryUsed"_s), jsNumber(memoryUsed), 0);
+    stats->putDirect(vm, Identifier::fromString(vm, "memoryHighwater"_s), jsNumber(memoryHighwater), 0);
+
+    RELEASE_AND_RETURN(scope, JSValue::encode(stats));
+}
+
+// A JS function registered with createFunction(). Owned by SQLite, freed by its xDestroy when
+// the function is replaced or the connection closes, both of which happen on the JS thread.
+struct SQLiteJSFunction {
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    SQLiteJSFunction(JSC::VM& vm, JSC::JSGlobalObject* globalObject, JSC::JSObject* callback, int argCount, bool useBigInt64)
+        : globalObject(vm, globalObject)
+        , callback(vm, callback)
+        , argCount(argCount)
+        , useBigInt64(useBigInt64)
+    {
+    }
+
+    JSC::Strong<JSC::JSGlobalObject> globalObject;
+    JSC::Strong<JSC::JSObject> callback;
+    int argCount;
+    bool useBigInt64;
+};
+
+// Argument column of a batched aggregate. Stays a Float64Array (NULL as NaN) until a non numeric
+// value shows up, from then on every value is kept for a plain array.
+struct SQLiteBatchColumn {
+    Vector<double> numbers;
+    std::optional<Vector<SQLiteAsyncBinding>> values;
+};
+
+struct SQLiteBatchAggregate {
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    explicit SQLiteBatchAggregate(int argc)
+        : columns(argc)
+    {
+    }
+
+    Vector<SQLiteBatchColumn> columns;
+};
+
+template<bool useBigInt64>
+static JSValue sqliteValueToJS(JSC::VM& vm, JSC::JSGlobalObject* globalObject, sqlite3_value* value)
+{
+    switch (sqlite3_value_type(value)) {
+    case SQLITE_INTEGER: {
+        int64_t num = sqlite3_value_int64(value);
+        if constexpr (!useBigInt64) {
+            return num > INT_MAX || num < INT_MIN ? JSC::jsDoubleNumber(static_cast<double>(num)) : JSC::jsNumber(static_cast<int>(num));
+        } else {
+            return JSC::JSBigInt::createFrom(globalObject, num);
+        }
+    }
+    case SQLITE_FLOAT:
+        return jsDoubleNumber(sqlite3_value_double(value));
+    case SQLITE3_TEXT: {
+        const unsigned char* text = sqlite3_value_text(value);
+        size_t len = sqlite3_value_bytes(value);
+        if (!text || !len)
+            return jsEmptyString(vm);
+        return len < 64 ? jsString(vm, WTF::String::fromUTF8({ text, len })) : JSC::JSValue::decode(Bun__encoding__toStringUTF8(text, len, globalObject));
+    }
+    case SQLITE_BLOB: {
+        const void* blob = sqlite3_value_blob(value);
+        size_t len = sqlite3_value_bytes(value);
+        auto* array = JSC::JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(JSC::TypeUint8, false), len);
+        if (array && len)
+            memcpy(array->vector(), blob, len);
+        return array;
+    }
+    default:
+        return jsNull();
+    }
+}
+
+static JSValue asyncBindingToJS(JSC::JSGlobalObject* globalObject, const SQLiteAsyncBinding& value, bool useBigInt64)
+{
+    auto& vm = globalObject->vm();
+    switch (value.type) {
+    case SQLITE_INTEGER:
+        if (useBigInt64)
+            return JSC::JSBigInt::createFrom(globalObject, value.integer);
+        return value.integer > INT_MAX || value.integer < INT_MIN ? JSC::jsDoubleNumber(static_cast<double>(value.integer)) : JSC::jsNumber(static_cast<int>(value.integer));
+    case SQLITE_FLOAT:
+        return jsDoubleNumber(value.number);
+    case SQLITE3_TEXT:
+        return jsString(vm, WTF::String::fromUTF8({ value.bytes.data(), value.bytes.size() }));
+    case SQLITE_BLOB: {
+        auto* array = JSC::JSUint8Array::createUninitialized(globalObject, globalObject->typedArrayStructure(JSC::TypeUint8, false), value.bytes.size());
+        if (array && value.bytes.size())
+            memcpy(array->vector(), value.bytes.data(), value.bytes.size());
+        return array;
+    }
+    default:
+        return jsNull();
+    }
+}
+
+static void setSQLiteResult(sqlite3_context* context, JSC::JSGlobalObject* globalObject, JSC::ThrowScope& scope, JSValue value)
+{
+    if (value.isUndefinedOrNull()) {
+        sqlite3_result_null(context);
+    } else if (value.isBoolean()) {
+        sqlite3_result_int64(context, value.asBoolean() ? 1 : 0);
+    } else if (value.isAnyInt()) {
+        sqlite3_result_int64(context, value.asAnyInt());
+    } else if (value.isNumber()) {
+        sqlite3_result_double(context, value.asNumber());
+    } else if (value.isString()) {
+        auto string = value.toWTFString(globalObject);
+        RETURN_IF_EXCEPTION(scope, );
+        auto utf8 = string.utf8();
+        sqlite3_result_text(context, utf8.data(), utf8.length(), SQLITE_TRANSIENT);
+    } else if (value.isHeapBigInt()) {
+        sqlite3_result_int64(context, JSBigInt::toBigInt64(value));
+    } else if (auto* buffer = JSC::jsDynamicCast<JSC::JSArrayBufferView*>(value)) {
+        sqlite3_result_blob(context, buffer->vector(), buffer->byteLength(), SQLITE_TRANSIENT);
+    } else {
+        sqlite3_result_error(context, "User-defined function returned an unsupported value, expected string, TypedArray, boolean, number, bigint or null", -1);
+    }
+}
+
+// Calls into JS from inside sqlite3_step. An exception becomes the SQLite error of the
+// statement, the error currently being returned to JS is an SQLiteError with its message.
+static void callSQLiteJSFunction(sqlite3_context* context, SQLiteJSFunction* function, const MarkedArgumentBuffer& arguments)
+{
+    auto* globalObject = function->globalObject.get();
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSObject* callback = function->callback.get();
+    JSValue result = JSC::call(globalObject, callback, JSC::getCallData(callback), jsUndefined(), arguments);
+    if (auto* exception = scope.exception()) {
+        if (vm.isTerminationException(exception)) {
+            sqlite3_result_error(context, "Terminated", -1);
+            return;
+        }
+
+        JSValue error = exception->value();
+        scope.clearException();
+        auto message = error.isObject() ? error.getObject()->get(globalObject, vm.propertyNames->message) : error;
+        WTF::String messageString = scope.exception() ? WTF::String() : message.toWTFString(globalObject);
+        scope.clearException();
+        auto utf8 = messageString.utf8();
+        sqlite3_result_error(context, utf8.data(), utf8.length());
+        return;
+    }
+
+    setSQLiteResult(context, globalObject, scope, result);
+    if (UNLIKELY(scope.exception())) {
+        scope.clearException();
+        sqlite3_result_error(context, "User-defined function returned a value that could not be converted", -1);
+    }
+}
+
+static void sqliteScalarFunction(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+    auto* function = static_cast<SQLiteJSFunction*>(sqlite3_user_data(context));
+    auto* globalObject = function->globalObject.get();
+    auto& vm = globalObject->vm();
+
+    MarkedArgumentBuffer arguments;
+    arguments.ensureCapacity(argc);
+    for (int i = 0; i < argc; i++) {
+        arguments.append(function->useBigInt64 ? sqliteValueToJS<true>(vm, globalObject, argv[i]) : sqliteValueToJS<false>(vm, globalObject, argv[i]));
+    }
+
+    callSQLiteJSFunction(context, function, arguments);
+}
+
+// Batched aggregates only buffer the arguments in xStep and call into JS once, from xFinal
+static void sqliteBatchAggregateStep(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+    auto** state = static_cast<SQLiteBatchAggregate**>(sqlite3_aggregate_context(context, sizeof(SQLiteBatchAggregate*)));
+    if (UNLIKELY(!state)) {
+        sqlite3_result_error_nomem(context);
+        return;
+    }
+    if (!*state)
+        *state = new SQLiteBatchAggregate(argc);
+
+    auto& columns = (*state)->columns;
+    for (int i = 0; i < argc && i < static_cast<int>(columns.size()); i++) {
+        auto& column = columns[i];
+        int type = sqlite3_value_type(argv[i]);
+        if (!column.values) {
+            if (type == SQLITE_INTEGER || type == SQLITE_FLOAT) {
+                column.numbers.append(sqlite3_value_double(argv[i]));
+                continue;
+            }
+            if (type == SQLITE_NULL) {
+                column.numbers.append(PNaN);
+                continue;
+            }
+
+            Vector<SQLiteAsyncBinding> values(column.numbers.size());
+            for (size_t j = 0; j < column.numbers.size(); j++) {
+                if (std::isnan(column.numbers[j])) {
+                    values[j].type = SQLITE_NULL;
+                } else {
+                    values[j].type = SQLITE_FLOAT;
+                    values[j].number = column.numbers[j];
+                }
+            }
+            column.numbers.clear();
+            column.values = WTFMove(values);
+        }
+
+        SQLiteAsyncBinding value;
+        value.type = type;
+        switch (type) {
+        case SQLITE_INTEGER:
+            value.integer = sqlite3_value_int64(argv[i]);
+            break;
+        case SQLITE_FLOAT:
+            value.number = sqlite3_value_double(argv[i]);
+            break;
+        case SQLITE3_TEXT:
+        case SQLITE_BLOB: {
+            const void* data = type == SQLITE_BLOB ? sqlite3_value_blob(argv[i]) : static_cast<const void*>(sqlite3_value_text(argv[i]));
+            size_t length = sqlite3_value_bytes(argv[i]);
+            if (length)
+                value.bytes.append(std::span { reinterpret_cast<const uint8_t*>(data), length });
+            break;
+        }
+        default:
+            break;
+        }
+        column.values->append(WTFMove(value));
+    }
+}
+
+static void sqliteBatchAggregateFinal(sqlite3_context* context)
+{
+    auto* function = static_cast<SQLiteJSFunction*>(sqlite3_user_data(context));
+    auto* globalObject = function->globalObject.get();
+    auto& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto** state = static_cast<SQLiteBatchAggregate**>(sqlite3_aggregate_context(context, 0));
+    std::unique_ptr<SQLiteBatchAggregate> aggregate(state ? *state : nullptr);
+    // An empty group never ran xStep, the callback still gets one (empty) array per argument
+    if (!aggregate)
+        aggregate = makeUnique<SQLiteBatchAggregate>(function->argCount);
+
+    MarkedArgumentBuffer arguments;
+    {
+        for (auto& column : aggregate->columns) {
+            if (!column.values) {
+                auto* array = JSC::JSFloat64Array::createUninitialized(globalObject, globalObject->typedArrayStructure(JSC::TypeFloat64, false), column.numbers.size());
+                if (UNLIKELY(!array)) {
+                    scope.clearException();
+                    sqlite3_result_error_nomem(context);
+                    return;
+                }
+                if (column.numbers.size())
+                    memcpy(array->typedVector(), column.numbers.data(), column.numbers.size() * sizeof(double));
+                arguments.append(array);
+                continue;
+            }
+
+            JSC::JSArray* array = JSC::constructEmptyArray(globalObject, nullptr, column.values->size());
+            if (UNLIKELY(!array)) {
+                scope.clearException();
+                sqlite3_result_error_nomem(context);
+                return;
+            }
+            for (size_t i = 0; i < column.values->size(); i++) {
+                array->putDirectIndex(globalObject, i, asyncBindingToJS(globalObject, column.values->at(i), function->useBigInt64));
+            }
+            arguments.append(array);
+        }
+    }
+
+    callSQLiteJSFunction(context, function, arguments);
+}
+
+static void destroySQLiteJSFunction(void* data)
+{
+    delete static_cast<SQLiteJSFunction*>(data);
+}
+
+// createFunction(handle, name, callback, argCount, options) registers a function for SQL on this
+// connection. By default callback is called once per row with the arguments. With
+// options.batch it becomes an aggregate: callback is called once per group with one array per
+// argument holding every row's value, a Float64Array while the values are numbers (NULL as NaN).
+// options.deterministic and options.safeIntegers work as for statements.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementCreateFunctionFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    int32_t dbIndex = callFrame->argument(0).toInt32(lexicalGlobalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+    if (UNLIKELY(dbIndex < 0 || dbIndex >= databases().size())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "Invalid database handle"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    sqlite3* db = databases()[dbIndex]->db;
+    if (UNLIKELY(!db)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Cannot use a closed database"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue nameValue = callFrame->argument(1);
+    if (UNLIKELY(!nameValue.isString())) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected function name to be a string"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue callbackValue = callFrame->argument(2);
+    if (UNLIKELY(!callbackValue.isCallable())) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected a function"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSValue argCountValue = callFrame->argument(3);
+    int argCount = -1;
+    if (!argCountValue.isUndefined()) {
+        if (UNLIKELY(!argCountValue.isInt32() || argCountValue.asInt32() < -1 || argCountValue.asInt32() > 127)) {
+            throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Expected argument count to be between -1 (variadic) and 127"_s));
+            return JSValue::encode(jsUndefined());
+        }
+        argCount = argCountValue.asInt32();
+    }
+
+    bool batch = false;
+    bool deterministic = false;
+    bool useBigInt64 = false;
+    if (auto* options = callFrame->argument(4).getObject()) {
+        batch = options->get(lexicalGlobalObject, Identifier::fromString(vm, "batch"_s)).toBoolean(lexicalGlobalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        deterministic = options->get(lexicalGlobalObject, Identifier::fromString(vm, "deterministic"_s)).toBoolean(lexicalGlobalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+        useBigInt64 = options->get(lexicalGlobalObject, Identifier::fromString(vm, "safeIntegers"_s)).toBoolean(lexicalGlobalObject);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    if (UNLIKELY(batch && argCount < 0)) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Batched functions need a fixed argument count"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    auto name = nameValue.toWTFString(lexicalGlobalObject).utf8();
+    RETURN_IF_EXCEPTION(scope, {});
+
+    auto* function = new SQLiteJSFunction(vm, lexicalGlobalObject, callbackValue.getObject(), argCount, useBigInt64);
+    int flags = SQLITE_UTF8 | (deterministic ? SQLITE_DETERMINISTIC : 0);
+    // On failure SQLite has already called destroySQLiteJSFunction
+    int statusCode = batch
+        ? sqlite3_create_function_v2(db, name.data(), argCount, flags, function, nullptr, sqliteBatchAggregateStep, sqliteBatchAggregateFinal, destroySQLiteJSFunction)
+        : sqlite3_create_function_v2(db, name.data(), argCount, flags, function, sqliteScalarFunction, nullptr, nullptr, destroySQLiteJSFunction);
+    if (statusCode != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    // Compiled statements may have resolved the old definition of this name
+    databases()[dbIndex]->version++;
+    return JSValue::encode(jsUndefined());
+}
+
+/* Hash table for constructor */
+static const HashTableValue JSSQLStatementConstructorTableValues[] = {
+    { "open"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementOpenStatementFunction, 2 } },
+    { "close"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementCloseStatementFunction, 1 } },
+    { "prepare"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementPrepareStatementFunction, 2 } },
+    { "run"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementExecuteFunction, 3 } },
+    { "isInTransaction"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementIsInTransactionFunction, 1 } },
+    { "loadExtension"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementLoadExtensionFunction, 2 } },
+    { "setCustomSQLite"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSetCustomSQLite, 1 } },
+    { "serialize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSerialize, 1 } },
+    { "deserialize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementDeserialize, 2 } },
+    { "fcntl"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementFcntlFunction, 2 } },
+    { "statementCacheStats"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementStatementCacheStatsFunction, 1 } },
+    { "setStatementCacheSize"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementSetStatementCacheSizeFunction, 2 } },
+    { "openReadPool"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementOpenReadPoolFunction, 2 } },
+    { "openBlob"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementOpenBlobFunction, 4 } },
+    { "readBlob"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementReadBlobFunction, 4 } },
+    { "closeBlob"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementCloseBlobFunction, 2 } },
+    { "stats"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementDatabaseStatsFunction, 2 } },
+    { "createFunction"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsSQLStatementCreateFunctionFunction, 5 } },
+};
+
+const ClassInfo JSSQLStatementConstructor::s_info = { "SQLStatement"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSSQLStatementConstructor) };
+
+void JSSQLStatementConstructor::finishCreation(VM& vm)
+{
+    Base::finishCreation(vm);
+
+    // TODO: use LazyClassStructure?
+    auto* instanceObject = JSSQLStatement::create(reinterpret_cast<Zig::GlobalObject*>(globalObject()), nullptr, nullptr);
+    JSValue proto = instanceObject->getPrototype(vm, globalObject());
+
+    this->putDirect(vm, vm.propertyNames->prototype, proto, PropertyAttribute::DontEnum | PropertyAttribute::DontDelete | PropertyAttribute::ReadOnly);
+
+    reifyStaticProperties(vm, JSSQLStatementConstructor::info(), JSSQLStatementConstructorTableValues, *this);
+    JSC_TO_STRING_TAG_WITHOUT_TRANSITION();
+
+    ASSERT(inherits(info()));
+}
+
+template<bool useBigInt64>
+static inline JSC::JSValue constructResultObject(JSC::JSGlobalObject* lexicalGlobalObject, JSSQLStatement* castedThis)
+{
+    auto& columnNames = castedThis->columnNames->data()->propertyNameVector();
+    int count = columnNames.size();
+    auto& vm = lexicalGlobalObject->vm();
+
+    // 64 is the maximum we can preallocate here
+    // see https://github.com/oven-sh/bun/issues/987
+    JSC::JSObject* result;
+
+    auto* stmt = castedThis->stmt;
+
+    if (auto* structure = castedThis->_structure.get()) {
+        result = JSC::constructEmptyObject(vm, structure);
+
+        ensureColumnTypes(castedThis, sqlite3_column_count(stmt));
+        auto* columnTypes = castedThis->columnTypes.data();
+        SQLiteRowLocker locker(castedThis->version_db->db);
+
+        // i: the index of columns returned from SQLite
+        // j: the index of object property
+        for (int i = 0, j = 0; j < count; i++, j++) {
+            if (!castedThis->validColumns.get(i)) {
+                // this column is duplicate, skip
+                j -= 1;
+                continue;
+            }
+            result->putDirectOffset(vm, j, toJSSpecialized<useBigInt64>(vm, lexicalGlobalObject, stmt, i, columnTypes[i]));
+        }
+
+    } else {
+        if (count <= JSFinalObject::maxInlineCapacity) {
+            result = JSC::JSFinalObject::create(vm, castedThis->_prototype.get()->structure());
+        } else {
+            JSObject* prototype = castedThis->userPrototype ? castedThis->userPrototype.get() : lexicalGlobalObject->objectPrototype();
+            result = JSC::JSFinalObject::create(vm, JSC::JSFinalObject::createStructure(vm, lexicalGlobalObject, prototype, JSFinalObject::maxInlineCapacity));
+        }
+
+        for (int i = 0, j = 0; j < count; i++, j++) {
+            if (!castedThis->validColumns.get(i)) {
+                j -= 1;
+                continue;
+            }
+            const auto& name = columnNames[j];
+            result->putDirect(vm, name, toJS<useBigInt64>(vm, lexicalGlobalObject, stmt, i), 0);
+        }
+    }
+
+    return JSValue(result);
+}
+
+static inline JSC::JSArray* constructResultRow(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSSQLStatement* castedThis, size_t columnCount)
+{
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto* stmt = castedThis->stmt;
+
+    MarkedArgumentBuffer arguments;
     arguments.ensureCapacity(columnCount);
-    if (castedThis->useBigInt64) {
+    ensureColumnTypes(castedThis, columnCount);
+    auto* columnTypes = castedThis->columnTypes.data();
+    {
+        SQLiteRowLocker locker(castedThis->version_db->db);
+        if (castedThis->useBigInt64) {
+            for (size_t i = 0; i < columnCount; i++) {
+                JSValue value = toJSSpecialized<true>(vm, lexicalGlobalObject, stmt, i, columnTypes[i]);
+                RETURN_IF_EXCEPTION(throwScope, nullptr);
+                arguments.append(value);
+            }
+        } else {
+            for (size_t i = 0; i < columnCount; i++) {
+                JSValue value = toJSSpecialized<false>(vm, lexicalGlobalObject, stmt, i, columnTypes[i]);
+                RETURN_IF_EXCEPTION(throwScope, nullptr);
+                arguments.append(value);
+            }
+        }
+    }
+
+    JSC::ObjectInitializationScope initializationScope(vm);
+    Structure* arrayStructure = lexicalGlobalObject->arrayStructureForIndexingTypeDuringAllocation(ArrayWithContiguous);
+    JSC::JSArray* result;
+
+    if (LIKELY(result = JSC::JSArray::tryCreateUninitializedRestricted(initializationScope, arrayStructure, columnCount))) {
         for (size_t i = 0; i < columnCount; i++) {
-            JSValue value = toJS<true>(vm, lexicalGlobalObject, stmt, i);
-            RETURN_IF_EXCEPTION(throwScope, nullptr);
-            arguments.append(value);
+            result->initializeIndex(initializationScope, i, arguments.at(i));
+        }
+    } else {
+        RETURN_IF_EXCEPTION(throwScope, nullptr);
+        result = JSC::constructArray(lexicalGlobalObject, arrayStructure, arguments);
+    }
+
+    return result;
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementSetPrototypeFunction, (JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto* castedThis = jsCast<JSSQLStatement*>(callFrame->thisValue());
+
+    CHECK_THIS
+
+    JSValue classValue = callFrame->argument(0);
+
+    if (classValue.isObject()) {
+        JSObject* classObject = classValue.getObject();
+        if (classObject == lexicalGlobalObject->objectConstructor()) {
+            castedThis->userPrototype.clear();
+
+            // Force the prototypes to be re-created
+            if (castedThis->version_db) {
+                castedThis->version_db->version++;
+            }
+
+            return JSValue::encode(jsUndefined());
+        }
+
+        if (!classObject->isConstructor()) {
+            throwTypeError(lexicalGlobalObject, scope, "Expected a constructor"_s);
+            return JSValue::encode(jsUndefined());
+        }
+
+        JSValue prototype = classObject->getIfPropertyExists(lexicalGlobalObject, vm.propertyNames->prototype);
+        if (UNLIKELY(!prototype && !scope.exception())) {
+            throwTypeError(lexicalGlobalObject, scope, "Expected constructor to have a prototype"_s);
+        }
+
+        RETURN_IF_EXCEPTION(scope, JSValue::encode(jsUndefined()));
+
+        if (!prototype.isObject()) {
+            throwTypeError(lexicalGlobalObject, scope, "Expected a constructor prototype to be an object"_s);
+            return {};
+        }
+
+        castedThis->userPrototype.set(vm, classObject, prototype.getObject());
+
+        // Force the prototypes to be re-created
+        if (castedThis->version_db) {
+            castedThis->version_db->version++;
+        }
+    } else if (classValue.isUndefined()) {
+        castedThis->userPrototype.clear();
+
+        // Force the prototypes to be re-created
+        if (castedThis->version_db) {
+            castedThis->version_db->version++;
+        }
+    } else {
+        throwTypeError(lexicalGlobalObject, scope, "Expected class to be a constructor or undefined"_s);
+        return JSValue::encode(jsUndefined());
+    }
+
+    return JSValue::encode(jsUndefined());
+}
+
+// Publishes { statement, sql, method } to the bun:sqlite:query diagnostics channel. Only called
+// when the channel has subscribers.
+static void publishSQLiteQuery(JSC::JSGlobalObject* lexicalGlobalObject, JSSQLStatement* castedThis, ASCIILiteral method)
+{
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    auto& vm = globalObject->vm();
+    JSC::JSObject* message = JSC::constructEmptyObject(globalObject, globalObject->objectPrototype(), 3);
+    message->putDirect(vm, JSC::Identifier::fromString(vm, "statement"_s), castedThis);
+    message->putDirect(vm, JSC::Identifier::fromString(vm, "sql"_s), jsString(vm, WTF::String::fromUTF8(sqlite3_sql(castedThis->stmt))));
+    message->putDirect(vm, JSC::Identifier::fromString(vm, "method"_s), jsString(vm, WTF::String(method)));
+    Bun::publishDiagnosticsChannel(globalObject, Bun::DiagnosticsChannel::SQLiteQuery, message);
+}
+
+#define PUBLISH_SQLITE_QUERY(method)                                                                                                         \
+    if (UNLIKELY(jsCast<Zig::GlobalObject*>(lexicalGlobalObject)->hasDiagnosticsChannelSubscribers(Bun::DiagnosticsChannel::SQLiteQuery))) { \
+        publishSQLiteQuery(lexicalGlobalObject, castedThis, method);                                                                         \
+        RETURN_IF_EXCEPTION(scope, {});                                                                                                      \
+        CHECK_PREPARED                                                                                                                       \
+        stmt = castedThis->stmt;                                                                                                             \
+    }
+
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
+
+    CHECK_THIS
+
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
+    PUBLISH_SQLITE_QUERY("all"_s)
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
+
+    if (UNLIKELY(statusCode != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int64_t currentMemoryUsage = sqlite_malloc_amount;
+
+    if (callFrame->argumentCount() > 0) {
+        auto arg0 = callFrame->argument(0);
+        DO_REBIND(arg0);
+    }
+
+    int status = sqlite3_step(stmt);
+    if (!sqlite3_stmt_readonly(stmt)) {
+        castedThis->version_db->version++;
+    }
+
+    if (!castedThis->hasExecuted || castedThis->need_update()) {
+        initializeColumnNames(lexicalGlobalObject, castedThis);
+    }
+
+    size_t columnCount = castedThis->columnNames->size();
+    JSValue result = jsUndefined();
+    if (status == SQLITE_ROW) {
+        // this is a count from UPDATE or another query like that
+        if (columnCount == 0) {
+            result = jsNumber(sqlite3_changes(castedThis->version_db->db));
+
+            while (status == SQLITE_ROW) {
+                status = sqlite3_step(stmt);
+            }
+        } else {
+            bool useBigInt64 = castedThis->useBigInt64;
+            JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+            if (useBigInt64) {
+                do {
+                    JSC::JSValue result = constructResultObject<true>(lexicalGlobalObject, castedThis);
+                    resultArray->push(lexicalGlobalObject, result);
+                    status = sqlite3_step(stmt);
+                } while (status == SQLITE_ROW);
+            } else {
+                do {
+                    JSC::JSValue result = constructResultObject<false>(lexicalGlobalObject, castedThis);
+                    resultArray->push(lexicalGlobalObject, result);
+                    status = sqlite3_step(stmt);
+                } while (status == SQLITE_ROW);
+            }
+            result = resultArray;
+        }
+    } else if (status == SQLITE_DONE) {
+        result = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+    }
+
+    if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+
+    int64_t memoryChange = sqlite_malloc_amount - currentMemoryUsage;
+    if (memoryChange > 255) {
+        vm.heap.deprecatedReportExtraMemory(memoryChange);
+    }
+
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(result));
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionGet, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
+
+    CHECK_THIS
+
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
+    PUBLISH_SQLITE_QUERY("get"_s)
+
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
+    if (UNLIKELY(statusCode != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    if (callFrame->argumentCount() > 0) {
+        auto arg0 = callFrame->argument(0);
+        DO_REBIND(arg0);
+    }
+
+    int status = sqlite3_step(stmt);
+    if (!sqlite3_stmt_readonly(stmt)) {
+        castedThis->version_db->version++;
+    }
+
+    if (!castedThis->hasExecuted || castedThis->need_update()) {
+        initializeColumnNames(lexicalGlobalObject, castedThis);
+    }
+
+    JSValue result = jsNull();
+    if (status == SQLITE_ROW) {
+        bool useBigInt64 = castedThis->useBigInt64;
+
+        result = useBigInt64 ? constructResultObject<true>(lexicalGlobalObject, castedThis)
+                             : constructResultObject<false>(lexicalGlobalObject, castedThis);
+        while (status == SQLITE_ROW) {
+            status = sqlite3_step(stmt);
+        }
+    }
+
+    if (status == SQLITE_DONE || status == SQLITE_OK) {
+        RELEASE_AND_RETURN(scope, JSValue::encode(result));
+    } else {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+}
+
+JSC_DEFINE_JIT_OPERATION(jsSQLStatementExecuteStatementFunctionGetWithoutTypeChecking, EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSSQLStatement* castedThis))
+{
+    VM& vm = JSC::getVM(lexicalGlobalObject);
+    IGNORE_WARNINGS_BEGIN("frame-address")
+    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
+    IGNORE_WARNINGS_END
+    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
+
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
+    if (UNLIKELY(statusCode != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        return JSValue::encode(jsUndefined());
+    }
+
+    int status = sqlite3_step(stmt);
+    if (!sqlite3_stmt_readonly(stmt)) {
+        castedThis->version_db->version++;
+    }
+
+    if (!castedThis->hasExecuted || castedThis->need_update()) {
+        initializeColumnNames(lexicalGlobalObject, castedThis);
+    }
+
+    JSValue result = jsNull();
+    if (status == SQLITE_ROW) {
+        bool useBigInt64 = castedThis->useBigInt64;
+
+        result = useBigInt64 ? constructResultObject<true>(lexicalGlobalObject, castedThis)
+                             : constructResultObject<false>(lexicalGlobalObject, castedThis);
+        while (status == SQLITE_ROW) {
+            status = sqlite3_step(stmt);
+        }
+    }
+
+    if (status == SQLITE_DONE || status == SQLITE_OK) {
+        RELEASE_AND_RETURN(scope, JSValue::encode(result));
+    } else {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRows, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
+
+    CHECK_THIS;
+
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
+    PUBLISH_SQLITE_QUERY("values"_s)
+
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
+    if (UNLIKELY(statusCode != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+
+    int count = callFrame->argumentCount();
+    if (count > 0) {
+        auto arg0 = callFrame->argument(0);
+        DO_REBIND(arg0);
+    }
+
+    int status = sqlite3_step(stmt);
+    if (!sqlite3_stmt_readonly(stmt)) {
+        castedThis->version_db->version++;
+    }
+
+    if (!castedThis->hasExecuted || castedThis->need_update()) {
+        initializeColumnNames(lexicalGlobalObject, castedThis);
+    }
+
+    size_t columnCount = castedThis->columnNames->size();
+    JSValue result = jsNull();
+    if (status == SQLITE_ROW) {
+        // this is a count from UPDATE or another query like that
+        if (columnCount == 0) {
+            while (status == SQLITE_ROW) {
+                status = sqlite3_step(stmt);
+            }
+
+            result = jsNumber(sqlite3_column_count(stmt));
+
+        } else {
+
+            JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+            {
+                size_t columnCount = sqlite3_column_count(stmt);
+
+                do {
+                    JSC::JSArray* row = constructResultRow(vm, lexicalGlobalObject, castedThis, columnCount);
+                    if (UNLIKELY(!row || scope.exception())) {
+                        sqlite3_reset(stmt);
+                        RELEASE_AND_RETURN(scope, {});
+                    }
+                    resultArray->push(lexicalGlobalObject, row);
+                    status = sqlite3_step(stmt);
+                } while (status == SQLITE_ROW);
+            }
+
+            result = resultArray;
+        }
+    } else if (status == SQLITE_DONE && columnCount != 0) {
+        // breaking change in Bun v0.6.8
+        result = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+    }
+
+    if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+
+    // sqlite3_reset(stmt);
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(result));
+}
+
+// One column of a columnar() result. Values are collected natively while stepping so numeric
+// columns become a single typed array instead of one JSValue per cell. A column switches to a
+// plain array as soon as it sees a value that does not fit its typed array.
+class SQLiteColumnBuffer {
+public:
+    enum class Kind : uint8_t {
+        // only NULLs so far
+        Empty,
+        Number,
+        BigInt,
+        Generic,
+    };
+
+    template<bool useBigInt64>
+    bool append(JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, JSC::JSArray* valuesArray, sqlite3_stmt* stmt, unsigned column, size_t row)
+    {
+        int type = sqlite3_column_type(stmt, column);
+        if (type == SQLITE_NULL) {
+            while (nulls.size() <= row / 8)
+                nulls.append(0);
+            nulls[row / 8] |= 1 << (row % 8);
+            hasNulls = true;
+        } else if (kind == Kind::Empty) {
+            if (type == SQLITE_INTEGER)
+                kind = useBigInt64 ? Kind::BigInt : Kind::Number;
+            else if (type == SQLITE_FLOAT)
+                kind = Kind::Number;
+            else
+                kind = Kind::Generic;
+
+            if (kind == Kind::Generic) {
+                generic = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+                RETURN_IF_EXCEPTION(scope, false);
+                valuesArray->putDirectIndex(lexicalGlobalObject, column, generic);
+            }
+            for (size_t i = 0; i < row; i++) {
+                switch (kind) {
+                case Kind::Number:
+                    numbers.append(PNaN);
+                    break;
+                case Kind::BigInt:
+                    integers.append(0);
+                    break;
+                default:
+                    generic->putDirectIndex(lexicalGlobalObject, i, jsNull());
+                    RETURN_IF_EXCEPTION(scope, false);
+                    break;
+                }
+            }
+        } else if ((kind == Kind::Number && type != SQLITE_INTEGER && type != SQLITE_FLOAT) || (kind == Kind::BigInt && type != SQLITE_INTEGER)) {
+            if (!toGeneric(lexicalGlobalObject, scope, valuesArray, column, row))
+                return false;
+        }
+
+        switch (kind) {
+        case Kind::Empty:
+            break;
+        case Kind::Number:
+            numbers.append(type == SQLITE_NULL ? PNaN : sqlite3_column_double(stmt, column));
+            break;
+        case Kind::BigInt:
+            integers.append(type == SQLITE_NULL ? 0 : sqlite3_column_int64(stmt, column));
+            break;
+        case Kind::Generic: {
+            JSValue value = toJS<useBigInt64>(vm, lexicalGlobalObject, stmt, column);
+            RETURN_IF_EXCEPTION(scope, false);
+            generic->putDirectIndex(lexicalGlobalObject, row, value);
+            RETURN_IF_EXCEPTION(scope, false);
+            break;
         }
-    } else {
-        for (size_t i = 0; i < columnCount; i++) {
-            JSValue value = toJS<false>(vm, lexicalGlobalObject, stmt, i);
-            RETURN_IF_EXCEPTION(throwScope, nullptr);
-            arguments.append(value);
         }
+
+        return true;
     }
 
-    JSC::ObjectInitializationScope initializationScope(vm);
-    Structure* arrayStructure = lexicalGlobalObject->arrayStructureForIndexingTypeDuringAllocation(ArrayWithContiguous);
-    JSC::JSArray* result;
+    // Returns the value array and the null bitmap (or null when the column has no NULLs)
+    std::pair<JSValue, JSValue> finish(JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, size_t rowCount)
+    {
+        JSValue values;
+        switch (kind) {
+        case Kind::Empty:
+        case Kind::Number: {
+            if (kind == Kind::Empty)
+                numbers.fill(PNaN, rowCount);
+            auto* array = JSC::JSFloat64Array::createUninitialized(lexicalGlobalObject, lexicalGlobalObject->typedArrayStructure(JSC::TypeFloat64, false), rowCount);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (rowCount)
+                memcpy(array->typedVector(), numbers.data(), rowCount * sizeof(double));
+            values = array;
+            break;
+        }
+        case Kind::BigInt: {
+            auto* array = JSC::JSBigInt64Array::createUninitialized(lexicalGlobalObject, lexicalGlobalObject->typedArrayStructure(JSC::TypeBigInt64, false), rowCount);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (rowCount)
+                memcpy(array->typedVector(), integers.data(), rowCount * sizeof(int64_t));
+            values = array;
+            break;
+        }
+        case Kind::Generic:
+            values = generic;
+            break;
+        }
 
-    if (LIKELY(result = JSC::JSArray::tryCreateUninitializedRestricted(initializationScope, arrayStructure, columnCount))) {
-        for (size_t i = 0; i < columnCount; i++) {
-            result->initializeIndex(initializationScope, i, arguments.at(i));
+        if (!hasNulls)
+            return { values, jsNull() };
+
+        size_t byteLength = (rowCount + 7) / 8;
+        auto* bitmap = JSC::JSUint8Array::create(lexicalGlobalObject, lexicalGlobalObject->typedArrayStructure(JSC::TypeUint8, false), byteLength);
+        RETURN_IF_EXCEPTION(scope, {});
+        memcpy(bitmap->typedVector(), nulls.data(), nulls.size());
+        return { values, bitmap };
+    }
+
+private:
+    bool toGeneric(JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, JSC::JSArray* valuesArray, unsigned column, size_t row)
+    {
+        generic = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, row);
+        RETURN_IF_EXCEPTION(scope, false);
+        valuesArray->putDirectIndex(lexicalGlobalObject, column, generic);
+        RETURN_IF_EXCEPTION(scope, false);
+
+        for (size_t i = 0; i < row; i++) {
+            JSValue value;
+            if (i / 8 < nulls.size() && (nulls[i / 8] & (1 << (i % 8))))
+                value = jsNull();
+            else if (kind == Kind::Number)
+                value = jsNumber(numbers[i]);
+            else
+                value = JSC::JSBigInt::createFrom(lexicalGlobalObject, integers[i]);
+            RETURN_IF_EXCEPTION(scope, false);
+            generic->putDirectIndex(lexicalGlobalObject, i, value);
+            RETURN_IF_EXCEPTION(scope, false);
         }
-    } else {
-        RETURN_IF_EXCEPTION(throwScope, nullptr);
-        result = JSC::constructArray(lexicalGlobalObject, arrayStructure, arguments);
+
+        kind = Kind::Generic;
+        numbers.clear();
+        integers.clear();
+        return true;
     }
 
-    return result;
-}
+    Kind kind = Kind::Empty;
+    Vector<double> numbers;
+    Vector<int64_t> integers;
+    // Kept alive by the values array of the result, which is on the stack
+    JSC::JSArray* generic = nullptr;
+    Vector<uint8_t> nulls;
+    bool hasNulls = false;
+};
 
-JSC_DEFINE_HOST_FUNCTION(jsSQLStatementSetPrototypeFunction, (JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+// Steps through every row and returns { names, values, nulls, length }, one entry per result
+// column: values[i] is a Float64Array (BigInt64Array with safeIntegers) for numeric columns and a
+// plain array otherwise, nulls[i] is a bitmap with bit (row % 8) of byte (row / 8) set for NULLs
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionColumnar, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
     JSC::VM& vm = lexicalGlobalObject->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
-    auto* castedThis = jsCast<JSSQLStatement*>(callFrame->thisValue());
+    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
 
     CHECK_THIS
 
-    JSValue classValue = callFrame->argument(0);
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
 
-    if (classValue.isObject()) {
-        JSObject* classObject = classValue.getObject();
-        if (classObject == lexicalGlobalObject->objectConstructor()) {
-            castedThis->userPrototype.clear();
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
+    if (UNLIKELY(statusCode != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        return JSValue::encode(jsUndefined());
+    }
 
-            // Force the prototypes to be re-created
-            if (castedThis->version_db) {
-                castedThis->version_db->version++;
-            }
+    int64_t currentMemoryUsage = sqlite_malloc_amount;
 
-            return JSValue::encode(jsUndefined());
+    if (callFrame->argumentCount() > 0) {
+        auto arg0 = callFrame->argument(0);
+        DO_REBIND(arg0);
+    }
+
+    int status = sqlite3_step(stmt);
+    if (!sqlite3_stmt_readonly(stmt)) {
+        castedThis->version_db->version++;
+    }
+
+    if (!castedThis->hasExecuted || castedThis->need_update()) {
+        initializeColumnNames(lexicalGlobalObject, castedThis);
+    }
+
+    unsigned columnCount = static_cast<unsigned>(sqlite3_column_count(stmt));
+    JSC::JSArray* valuesArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, columnCount);
+    RETURN_IF_EXCEPTION(scope, {});
+    Vector<SQLiteColumnBuffer> columns(columnCount);
+
+    size_t rowCount = 0;
+    bool useBigInt64 = castedThis->useBigInt64;
+    while (status == SQLITE_ROW) {
+        for (unsigned i = 0; i < columnCount; i++) {
+            bool ok = useBigInt64 ? columns[i].append<true>(vm, lexicalGlobalObject, scope, valuesArray, stmt, i, rowCount)
+                                  : columns[i].append<false>(vm, lexicalGlobalObject, scope, valuesArray, stmt, i, rowCount);
+            if (UNLIKELY(!ok)) {
+                sqlite3_reset(stmt);
+                return JSValue::encode(jsUndefined());
+            }
         }
+        rowCount++;
+        status = sqlite3_step(stmt);
+    }
 
-        if (!classObject->isConstructor()) {
-            throwTypeError(lexicalGlobalObject, scope, "Expected a constructor"_s);
+    if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        sqlite3_reset(stmt);
+        return JSValue::encode(jsUndefined());
+    }
+
+    JSC::JSArray* namesArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, columnCount);
+    RETURN_IF_EXCEPTION(scope, {});
+    JSC::JSArray* nullsArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, columnCount);
+    RETURN_IF_EXCEPTION(scope, {});
+    for (unsigned i = 0; i < columnCount; i++) {
+        namesArray->putDirectIndex(lexicalGlobalObject, i, jsString(vm, sqliteString(sqlite3_column_name(stmt, i))));
+        RETURN_IF_EXCEPTION(scope, {});
+
+        auto [values, nulls] = columns[i].finish(lexicalGlobalObject, scope, rowCount);
+        RETURN_IF_EXCEPTION(scope, {});
+        valuesArray->putDirectIndex(lexicalGlobalObject, i, values);
+        RETURN_IF_EXCEPTION(scope, {});
+        nullsArray->putDirectIndex(lexicalGlobalObject, i, nulls);
+        RETURN_IF_EXCEPTION(scope, {});
+    }
+
+    JSC::JSObject* result = JSC::constructEmptyObject(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), 4);
+    result->putDirect(vm, Identifier::fromString(vm, "names"_s), namesArray, 0);
+    result->putDirect(vm, Identifier::fromString(vm, "values"_s), valuesArray, 0);
+    result->putDirect(vm, Identifier::fromString(vm, "nulls"_s), nullsArray, 0);
+    result->putDirect(vm, vm.propertyNames->length, jsNumber(rowCount), 0);
+
+    int64_t memoryChange = sqlite_malloc_amount - currentMemoryUsage;
+    if (memoryChange > 255) {
+        vm.heap.deprecatedReportExtraMemory(memoryChange);
+    }
+
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(result));
+}
+
+// Returns up to batchSize rows (as objects, like all()) and leaves the statement positioned after
+// the last one, so that huge result sets can be consumed without materializing them at once.
+// The first call, or any call passing bindings, starts from the beginning. An array shorter
+// than batchSize means the rows are exhausted and the statement has been reset.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionNextBatch, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+{
+    JSC::VM& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
+
+    CHECK_THIS
+
+    auto* stmt = castedThis->stmt;
+    CHECK_PREPARED
+
+    JSValue batchSizeValue = callFrame->argument(0);
+    if (UNLIKELY(!batchSizeValue.isNumber() || batchSizeValue.asNumber() < 1 || batchSizeValue.asNumber() > std::numeric_limits<int32_t>::max())) {
+        throwException(lexicalGlobalObject, scope, createRangeError(lexicalGlobalObject, "Expected batchSize to be a positive integer"_s));
+        return JSValue::encode(jsUndefined());
+    }
+    size_t batchSize = static_cast<size_t>(batchSizeValue.asNumber());
+
+    bool hasBindings = callFrame->argumentCount() > 1 && !callFrame->argument(1).isUndefined();
+    int status;
+    if (!castedThis->isIterating || hasBindings) {
+        int statusCode = sqlite3_reset(stmt);
+        if (UNLIKELY(statusCode != SQLITE_OK)) {
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
             return JSValue::encode(jsUndefined());
         }
 
-        JSValue prototype = classObject->getIfPropertyExists(lexicalGlobalObject, vm.propertyNames->prototype);
-        if (UNLIKELY(!prototype && !scope.exception())) {
-            throwTypeError(lexicalGlobalObject, scope, "Expected constructor to have a prototype"_s);
+        if (hasBindings) {
+            auto arg1 = callFrame->argument(1);
+            DO_REBIND(arg1);
         }
 
-        RETURN_IF_EXCEPTION(scope, JSValue::encode(jsUndefined()));
+        status = sqlite3_step(stmt);
+        if (!sqlite3_stmt_readonly(stmt)) {
+            castedThis->version_db->version++;
+        }
 
-        if (!prototype.isObject()) {
-            throwTypeError(lexicalGlobalObject, scope, "Expected a constructor prototype to be an object"_s);
-            return {};
+        if (!castedThis->hasExecuted || castedThis->need_update()) {
+            initializeColumnNames(lexicalGlobalObject, castedThis);
         }
+        castedThis->isIterating = true;
+    } else {
+        // The previous batch stopped on a row that has not been returned yet
+        status = SQLITE_ROW;
+    }
 
-        castedThis->userPrototype.set(vm, classObject, prototype.getObject());
+    JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+    RETURN_IF_EXCEPTION(scope, {});
 
-        // Force the prototypes to be re-created
-        if (castedThis->version_db) {
-            castedThis->version_db->version++;
+    if (status == SQLITE_ROW && castedThis->columnNames->size() > 0) {
+        bool useBigInt64 = castedThis->useBigInt64;
+        size_t count = 0;
+        do {
+            JSC::JSValue row = useBigInt64 ? constructResultObject<true>(lexicalGlobalObject, castedThis)
+                                           : constructResultObject<false>(lexicalGlobalObject, castedThis);
+            resultArray->push(lexicalGlobalObject, row);
+            if (UNLIKELY(scope.exception())) {
+                castedThis->isIterating = false;
+                sqlite3_reset(stmt);
+                return JSValue::encode(jsUndefined());
+            }
+            status = sqlite3_step(stmt);
+        } while (status == SQLITE_ROW && ++count < batchSize);
+    } else {
+        while (status == SQLITE_ROW) {
+            status = sqlite3_step(stmt);
         }
-    } else if (classValue.isUndefined()) {
-        castedThis->userPrototype.clear();
+    }
 
-        // Force the prototypes to be re-created
-        if (castedThis->version_db) {
-            castedThis->version_db->version++;
+    if (status != SQLITE_ROW) {
+        castedThis->isIterating = false;
+        if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+            sqlite3_reset(stmt);
+            return JSValue::encode(jsUndefined());
         }
-    } else {
-        throwTypeError(lexicalGlobalObject, scope, "Expected class to be a constructor or undefined"_s);
-        return JSValue::encode(jsUndefined());
+        sqlite3_reset(stmt);
     }
 
-    return JSValue::encode(jsUndefined());
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(resultArray));
 }
 
-JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRun, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
+
     JSC::VM& vm = lexicalGlobalObject->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
     auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
@@ -1947,20 +3645,24 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll, (JSC::JSGlob
 
     auto* stmt = castedThis->stmt;
     CHECK_PREPARED
-    int statusCode = sqlite3_reset(stmt);
+    PUBLISH_SQLITE_QUERY("run"_s)
 
+    castedThis->isIterating = false;
+    int statusCode = sqlite3_reset(stmt);
     if (UNLIKELY(statusCode != SQLITE_OK)) {
         throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
         return JSValue::encode(jsUndefined());
     }
 
-    int64_t currentMemoryUsage = sqlite_malloc_amount;
+    JSValue diffValue = callFrame->argument(0);
 
-    if (callFrame->argumentCount() > 0) {
-        auto arg0 = callFrame->argument(0);
+    if (callFrame->argumentCount() > 1) {
+        auto arg0 = callFrame->argument(1);
         DO_REBIND(arg0);
     }
 
+    int total_changes_before = sqlite3_total_changes(castedThis->version_db->db);
+
     int status = sqlite3_step(stmt);
     if (!sqlite3_stmt_readonly(stmt)) {
         castedThis->version_db->version++;
@@ -1970,36 +3672,8 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll, (JSC::JSGlob
         initializeColumnNames(lexicalGlobalObject, castedThis);
     }
 
-    size_t columnCount = castedThis->columnNames->size();
-    JSValue result = jsUndefined();
-    if (status == SQLITE_ROW) {
-        // this is a count from UPDATE or another query like that
-        if (columnCount == 0) {
-            result = jsNumber(sqlite3_changes(castedThis->version_db->db));
-
-            while (status == SQLITE_ROW) {
-                status = sqlite3_step(stmt);
-            }
-        } else {
-            bool useBigInt64 = castedThis->useBigInt64;
-            JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
-            if (useBigInt64) {
-                do {
-                    JSC::JSValue result = constructResultObject<true>(lexicalGlobalObject, castedThis);
-                    resultArray->push(lexicalGlobalObject, result);
-                    status = sqlite3_step(stmt);
-                } while (status == SQLITE_ROW);
-            } else {
-                do {
-                    JSC::JSValue result = constructResultObject<false>(lexicalGlobalObject, castedThis);
-                    resultArray->push(lexicalGlobalObject, result);
-                    status = sqlite3_step(stmt);
-                } while (status == SQLITE_ROW);
-            }
-            result = resultArray;
-        }
-    } else if (status == SQLITE_DONE) {
-        result = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+    while (status == SQLITE_ROW) {
+        status = sqlite3_step(stmt);
     }
 
     if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
@@ -2008,17 +3682,25 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAll, (JSC::JSGlob
         return JSValue::encode(jsUndefined());
     }
 
-    int64_t memoryChange = sqlite_malloc_amount - currentMemoryUsage;
-    if (memoryChange > 255) {
-        vm.heap.deprecatedReportExtraMemory(memoryChange);
+    if (auto* diff = JSC::jsDynamicCast<JSC::InternalFieldTuple*>(diffValue)) {
+        auto* db = castedThis->version_db->db;
+        const int total_changes_after = sqlite3_total_changes(db);
+        int64_t last_insert_rowid = sqlite3_last_insert_rowid(db);
+        diff->putInternalField(vm, 0, JSC::jsNumber(total_changes_after - total_changes_before));
+        if (castedThis->useBigInt64) {
+            diff->putInternalField(vm, 1, JSBigInt::createFrom(lexicalGlobalObject, last_insert_rowid));
+        } else {
+            diff->putInternalField(vm, 1, JSC::jsNumber(last_insert_rowid));
+        }
     }
 
-    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(result));
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(jsUndefined()));
 }
 
-JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionGet, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+// Runs the statement once per element of rows (each an array or object of bindings) without
+// returning to JS in between, optionally inside one transaction. Returns the number of changes.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRunMany, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
-
     JSC::VM& vm = lexicalGlobalObject->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
     auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
@@ -2028,175 +3710,319 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionGet, (JSC::JSGlob
     auto* stmt = castedThis->stmt;
     CHECK_PREPARED
 
+    JSC::JSArray* rows = jsDynamicCast<JSC::JSArray*>(callFrame->argument(0));
+    if (UNLIKELY(!rows)) {
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected an array of bindings"_s));
+        return JSValue::encode(jsUndefined());
+    }
+
+    bool useTransaction = callFrame->argument(1).toBoolean(lexicalGlobalObject);
+    auto* db = castedThis->version_db->db;
+
+    castedThis->isIterating = false;
     int statusCode = sqlite3_reset(stmt);
     if (UNLIKELY(statusCode != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
         return JSValue::encode(jsUndefined());
     }
 
-    if (callFrame->argumentCount() > 0) {
-        auto arg0 = callFrame->argument(0);
-        DO_REBIND(arg0);
+    // Nested inside a transaction the caller already started, the statements simply join it
+    bool ownsTransaction = useTransaction && sqlite3_get_autocommit(db);
+    if (ownsTransaction && sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        return JSValue::encode(jsUndefined());
     }
 
-    int status = sqlite3_step(stmt);
-    if (!sqlite3_stmt_readonly(stmt)) {
-        castedThis->version_db->version++;
-    }
+    auto fail = [&](bool isSQLiteError) -> JSC::EncodedJSValue {
+        if (isSQLiteError)
+            throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (ownsTransaction)
+            sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return JSValue::encode(jsUndefined());
+    };
 
-    if (!castedThis->hasExecuted || castedThis->need_update()) {
-        initializeColumnNames(lexicalGlobalObject, castedThis);
-    }
+    int total_changes_before = sqlite3_total_changes(db);
+    bool isReadOnly = sqlite3_stmt_readonly(stmt);
+    unsigned length = rows->length();
+    for (unsigned i = 0; i < length; i++) {
+        JSValue row = rows->getIndex(lexicalGlobalObject, i);
+        RETURN_IF_EXCEPTION(scope, fail(false));
+        if (UNLIKELY(!row.isObject())) {
+            throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Expected object or array"_s));
+            return fail(false);
+        }
 
-    JSValue result = jsNull();
-    if (status == SQLITE_ROW) {
-        bool useBigInt64 = castedThis->useBigInt64;
+        // The row stays alive until sqlite3_step() is done with it, so strings and buffers can
+        // be bound without copying. Bindings are cleared again before returning.
+        JSC::JSValue reb = castedThis->rebind(lexicalGlobalObject, row, false, db);
+        if (UNLIKELY(!reb.isNumber() || scope.exception()))
+            return fail(false);
 
-        result = useBigInt64 ? constructResultObject<true>(lexicalGlobalObject, castedThis)
-                             : constructResultObject<false>(lexicalGlobalObject, castedThis);
+        int status = sqlite3_step(stmt);
         while (status == SQLITE_ROW) {
             status = sqlite3_step(stmt);
         }
-    }
+        if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK))
+            return fail(true);
 
-    if (status == SQLITE_DONE || status == SQLITE_OK) {
-        RELEASE_AND_RETURN(scope, JSValue::encode(result));
-    } else {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
         sqlite3_reset(stmt);
-        return JSValue::encode(jsUndefined());
-    }
-}
-
-JSC_DEFINE_JIT_OPERATION(jsSQLStatementExecuteStatementFunctionGetWithoutTypeChecking, EncodedJSValue, (JSC::JSGlobalObject * lexicalGlobalObject, JSSQLStatement* castedThis))
-{
-    VM& vm = JSC::getVM(lexicalGlobalObject);
-    IGNORE_WARNINGS_BEGIN("frame-address")
-    CallFrame* callFrame = DECLARE_CALL_FRAME(vm);
-    IGNORE_WARNINGS_END
-    JSC::JITOperationPrologueCallFrameTracer tracer(vm, callFrame);
-    auto scope = DECLARE_THROW_SCOPE(vm);
-
-    auto* stmt = castedThis->stmt;
-    CHECK_PREPARED
-
-    int statusCode = sqlite3_reset(stmt);
-    if (UNLIKELY(statusCode != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
-        return JSValue::encode(jsUndefined());
     }
 
-    int status = sqlite3_step(stmt);
-    if (!sqlite3_stmt_readonly(stmt)) {
+    if (!isReadOnly) {
         castedThis->version_db->version++;
     }
 
+    sqlite3_clear_bindings(stmt);
     if (!castedThis->hasExecuted || castedThis->need_update()) {
         initializeColumnNames(lexicalGlobalObject, castedThis);
     }
 
-    JSValue result = jsNull();
-    if (status == SQLITE_ROW) {
-        bool useBigInt64 = castedThis->useBigInt64;
-
-        result = useBigInt64 ? constructResultObject<true>(lexicalGlobalObject, castedThis)
-                             : constructResultObject<false>(lexicalGlobalObject, castedThis);
-        while (status == SQLITE_ROW) {
-            status = sqlite3_step(stmt);
-        }
+    int changes = sqlite3_total_changes(db) - total_changes_before;
+    if (ownsTransaction && sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, db));
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return JSValue::encode(jsUndefined());
     }
 
-    if (status == SQLITE_DONE || status == SQLITE_OK) {
-        RELEASE_AND_RETURN(scope, JSValue::encode(result));
+    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(jsNumber(changes)));
+}
+
+// A binding value copied out of the JS heap so allAsync() can bind it on a read pool thread
+struct SQLiteAsyncBinding {
+    int type = SQLITE_NULL;
+    int64_t integer = 0;
+    double number = 0;
+    // UTF-8 for SQLITE_TEXT, raw bytes for SQLITE_BLOB
+    Vector<uint8_t> bytes;
+};
+
+// Rows produced on a read pool thread, encoded as one type tag per cell followed by its payload:
+// nothing for NULL, 8 bytes for INTEGER and FLOAT, a 32-bit length and the bytes for TEXT and BLOB
+struct SQLiteAsyncResult {
+    int errorCode = SQLITE_OK;
+    int errorOffset = -1;
+    CString errorMessage;
+    Vector<CString> columnNames;
+    Vector<uint8_t> rows;
+    size_t rowCount = 0;
+};
+
+static bool toAsyncBinding(JSC::JSGlobalObject* lexicalGlobalObject, JSC::ThrowScope& scope, JSC::JSValue value, SQLiteAsyncBinding& binding)
+{
+    if (value.isUndefinedOrNull()) {
+        binding.type = SQLITE_NULL;
+    } else if (value.isBoolean()) {
+        binding.type = SQLITE_INTEGER;
+        binding.integer = value.asBoolean() ? 1 : 0;
+    } else if (value.isAnyInt()) {
+        binding.type = SQLITE_INTEGER;
+        binding.integer = value.asAnyInt();
+    } else if (value.isNumber()) {
+        binding.type = SQLITE_FLOAT;
+        binding.number = value.asNumber();
+    } else if (value.isString()) {
+        auto string = value.toWTFString(lexicalGlobalObject);
+        RETURN_IF_EXCEPTION(scope, false);
+        auto utf8 = string.utf8();
+        binding.type = SQLITE3_TEXT;
+        binding.bytes.append(std::span { reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length() });
+    } else if (value.isHeapBigInt()) {
+        binding.type = SQLITE_INTEGER;
+        binding.integer = JSBigInt::toBigInt64(value);
+    } else if (auto* buffer = JSC::jsDynamicCast<JSC::JSArrayBufferView*>(value)) {
+        binding.type = SQLITE_BLOB;
+        binding.bytes.append(std::span { reinterpret_cast<const uint8_t*>(buffer->vector()), buffer->byteLength() });
     } else {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
-        sqlite3_reset(stmt);
-        return JSValue::encode(jsUndefined());
+        throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "Binding expected string, TypedArray, boolean, number, bigint or null"_s));
+        return false;
     }
+
+    return true;
 }
 
-JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRows, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+template<typename T>
+static inline void appendAsyncValue(Vector<uint8_t>& rows, T value)
 {
+    rows.append(std::span { reinterpret_cast<const uint8_t*>(&value), sizeof(T) });
+}
 
-    JSC::VM& vm = lexicalGlobalObject->vm();
-    auto scope = DECLARE_THROW_SCOPE(vm);
-    auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
-
-    CHECK_THIS;
+// Runs on the read pool thread that owns db, must not touch the JS heap
+static void runAsyncQuery(sqlite3* db, const CString& sql, const Vector<SQLiteAsyncBinding>& bindings, SQLiteAsyncResult& result)
+{
+    sqlite3_stmt* stmt = nullptr;
+    auto fail = [&]() {
+        result.errorCode = sqlite3_extended_errcode(db);
+        result.errorOffset = sqlite3_error_offset(db);
+        result.errorMessage = CString(sqlite3_errmsg(db));
+        result.rows.clear();
+        result.rowCount = 0;
+        sqlite3_finalize(stmt);
+    };
 
-    auto* stmt = castedThis->stmt;
-    CHECK_PREPARED
+    if (sqlite3_prepare_v3(db, sql.data(), sql.length(), 0, &stmt, nullptr) != SQLITE_OK)
+        return fail();
 
-    int statusCode = sqlite3_reset(stmt);
-    if (UNLIKELY(statusCode != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
-        sqlite3_reset(stmt);
-        return JSValue::encode(jsUndefined());
+    for (size_t i = 0; i < bindings.size(); i++) {
+        const auto& binding = bindings[i];
+        int index = static_cast<int>(i + 1);
+        int rc = SQLITE_OK;
+        switch (binding.type) {
+        case SQLITE_INTEGER:
+            rc = sqlite3_bind_int64(stmt, index, binding.integer);
+            break;
+        case SQLITE_FLOAT:
+            rc = sqlite3_bind_double(stmt, index, binding.number);
+            break;
+        case SQLITE3_TEXT:
+            rc = sqlite3_bind_text(stmt, index, reinterpret_cast<const char*>(binding.bytes.data()), binding.bytes.size(), SQLITE_STATIC);
+            break;
+        case SQLITE_BLOB:
+            rc = sqlite3_bind_blob(stmt, index, binding.bytes.data(), binding.bytes.size(), SQLITE_STATIC);
+            break;
+        default:
+            rc = sqlite3_bind_null(stmt, index);
+            break;
+        }
+        if (rc != SQLITE_OK)
+            return fail();
     }
 
-    int count = callFrame->argumentCount();
-    if (count > 0) {
-        auto arg0 = callFrame->argument(0);
-        DO_REBIND(arg0);
+    int columnCount = sqlite3_column_count(stmt);
+    result.columnNames.reserveInitialCapacity(columnCount);
+    for (int i = 0; i < columnCount; i++) {
+        const char* name = sqlite3_column_name(stmt, i);
+        result.columnNames.append(CString(name ? name : ""));
     }
 
     int status = sqlite3_step(stmt);
-    if (!sqlite3_stmt_readonly(stmt)) {
-        castedThis->version_db->version++;
+    while (status == SQLITE_ROW) {
+        for (int i = 0; i < columnCount; i++) {
+            int type = sqlite3_column_type(stmt, i);
+            result.rows.append(static_cast<uint8_t>(type));
+            switch (type) {
+            case SQLITE_INTEGER:
+                appendAsyncValue<int64_t>(result.rows, sqlite3_column_int64(stmt, i));
+                break;
+            case SQLITE_FLOAT:
+                appendAsyncValue<double>(result.rows, sqlite3_column_double(stmt, i));
+                break;
+            case SQLITE3_TEXT:
+            case SQLITE_BLOB: {
+                const void* data = type == SQLITE_BLOB ? sqlite3_column_blob(stmt, i) : static_cast<const void*>(sqlite3_column_text(stmt, i));
+                uint32_t length = static_cast<uint32_t>(sqlite3_column_bytes(stmt, i));
+                appendAsyncValue<uint32_t>(result.rows, length);
+                if (length)
+                    result.rows.append(std::span { reinterpret_cast<const uint8_t*>(data), length });
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        result.rowCount++;
+        status = sqlite3_step(stmt);
     }
 
-    if (!castedThis->hasExecuted || castedThis->need_update()) {
-        initializeColumnNames(lexicalGlobalObject, castedThis);
-    }
+    if (status != SQLITE_DONE)
+        return fail();
 
-    size_t columnCount = castedThis->columnNames->size();
-    JSValue result = jsNull();
-    if (status == SQLITE_ROW) {
-        // this is a count from UPDATE or another query like that
-        if (columnCount == 0) {
-            while (status == SQLITE_ROW) {
-                status = sqlite3_step(stmt);
-            }
+    sqlite3_finalize(stmt);
+}
 
-            result = jsNumber(sqlite3_column_count(stmt));
+template<typename T>
+static inline T readAsyncValue(const uint8_t*& cursor)
+{
+    T value;
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
 
-        } else {
+// Turns the rows of a finished allAsync() query into objects, on the thread of the database
+static JSC::JSValue materializeAsyncResult(JSC::JSGlobalObject* lexicalGlobalObject, const SQLiteAsyncResult& result, bool useBigInt64)
+{
+    auto& vm = lexicalGlobalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
 
-            JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
-            {
-                size_t columnCount = sqlite3_column_count(stmt);
+    size_t columnCount = result.columnNames.size();
 
-                do {
-                    JSC::JSArray* row = constructResultRow(vm, lexicalGlobalObject, castedThis, columnCount);
-                    if (UNLIKELY(!row || scope.exception())) {
-                        sqlite3_reset(stmt);
-                        RELEASE_AND_RETURN(scope, {});
-                    }
-                    resultArray->push(lexicalGlobalObject, row);
-                    status = sqlite3_step(stmt);
-                } while (status == SQLITE_ROW);
+    // Like initializeColumnNames, the last of several columns with the same name wins
+    PropertyNameArray names(vm, PropertyNameMode::Strings, PrivateSymbolMode::Exclude);
+    Vector<bool> isValidColumn(columnCount, false);
+    for (size_t i = columnCount; i-- > 0;) {
+        auto preCount = names.size();
+        names.add(Identifier::fromString(vm, WTF::String::fromUTF8(result.columnNames[i].data())));
+        isValidColumn[i] = names.size() != preCount;
+    }
+    names.data()->propertyNameVector().reverse();
+
+    Structure* structure = lexicalGlobalObject->structureCache().emptyObjectStructureForPrototype(lexicalGlobalObject, lexicalGlobalObject->objectPrototype(), names.size());
+    PropertyOffset offset;
+    for (const auto& propertyName : names) {
+        structure = Structure::addPropertyTransition(vm, structure, propertyName, 0, offset);
+    }
+
+    JSC::JSArray* resultArray = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    const uint8_t* cursor = result.rows.data();
+    for (size_t row = 0; row < result.rowCount; row++) {
+        JSC::JSObject* object = JSC::constructEmptyObject(vm, structure);
+        for (size_t i = 0, j = 0; i < columnCount; i++) {
+            JSValue value = jsNull();
+            switch (*cursor++) {
+            case SQLITE_INTEGER: {
+                int64_t integer = readAsyncValue<int64_t>(cursor);
+                if (useBigInt64)
+                    value = JSC::JSBigInt::createFrom(lexicalGlobalObject, integer);
+                else
+                    value = integer > INT_MAX || integer < INT_MIN ? JSC::jsDoubleNumber(static_cast<double>(integer)) : JSC::jsNumber(static_cast<int>(integer));
+                break;
+            }
+            case SQLITE_FLOAT:
+                value = jsDoubleNumber(readAsyncValue<double>(cursor));
+                break;
+            case SQLITE3_TEXT: {
+                uint32_t length = readAsyncValue<uint32_t>(cursor);
+                if (!length)
+                    value = jsEmptyString(vm);
+                else
+                    value = length < 64 ? jsString(vm, WTF::String::fromUTF8({ cursor, length })) : JSC::JSValue::decode(Bun__encoding__toStringUTF8(cursor, length, lexicalGlobalObject));
+                cursor += length;
+                break;
+            }
+            case SQLITE_BLOB: {
+                uint32_t length = readAsyncValue<uint32_t>(cursor);
+                auto* array = JSC::JSUint8Array::createUninitialized(lexicalGlobalObject, lexicalGlobalObject->typedArrayStructure(JSC::TypeUint8, false), length);
+                RETURN_IF_EXCEPTION(scope, {});
+                if (length)
+                    memcpy(array->vector(), cursor, length);
+                cursor += length;
+                value = array;
+                break;
+            }
+            default:
+                break;
             }
+            RETURN_IF_EXCEPTION(scope, {});
 
-            result = resultArray;
+            if (isValidColumn[i])
+                object->putDirectOffset(vm, j++, value);
         }
-    } else if (status == SQLITE_DONE && columnCount != 0) {
-        // breaking change in Bun v0.6.8
-        result = JSC::constructEmptyArray(lexicalGlobalObject, nullptr, 0);
-    }
 
-    if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
-        sqlite3_reset(stmt);
-        return JSValue::encode(jsUndefined());
+        resultArray->push(lexicalGlobalObject, object);
+        RETURN_IF_EXCEPTION(scope, {});
     }
 
-    // sqlite3_reset(stmt);
-    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(result));
+    RELEASE_AND_RETURN(scope, resultArray);
 }
 
-JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRun, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
+// Runs the statement on one of the connections opened by openReadPool() and resolves with the
+// same rows all() would return. Only read-only statements with positional bindings are supported.
+JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionAllAsync, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
 {
-
     JSC::VM& vm = lexicalGlobalObject->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
     auto castedThis = jsDynamicCast<JSSQLStatement*>(callFrame->thisValue());
@@ -2206,53 +4032,80 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementExecuteStatementFunctionRun, (JSC::JSGlob
     auto* stmt = castedThis->stmt;
     CHECK_PREPARED
 
-    int statusCode = sqlite3_reset(stmt);
-    if (UNLIKELY(statusCode != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
+    auto* version_db = castedThis->version_db;
+    if (UNLIKELY(version_db->readPool.isEmpty())) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "allAsync() requires a read pool, call openReadPool() first"_s));
         return JSValue::encode(jsUndefined());
     }
 
-    JSValue diffValue = callFrame->argument(0);
-
-    if (callFrame->argumentCount() > 1) {
-        auto arg0 = callFrame->argument(1);
-        DO_REBIND(arg0);
+    if (UNLIKELY(!sqlite3_stmt_readonly(stmt))) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, "allAsync() only runs read-only statements"_s));
+        return JSValue::encode(jsUndefined());
     }
 
-    int total_changes_before = sqlite3_total_changes(castedThis->version_db->db);
+    Vector<SQLiteAsyncBinding> bindings;
+    JSValue bindingsValue = callFrame->argument(0);
+    if (!bindingsValue.isUndefined()) {
+        auto* array = jsDynamicCast<JSC::JSArray*>(bindingsValue);
+        if (UNLIKELY(!array)) {
+            throwException(lexicalGlobalObject, scope, createTypeError(lexicalGlobalObject, "allAsync() expects an array of positional bindings"_s));
+            return JSValue::encode(jsUndefined());
+        }
 
-    int status = sqlite3_step(stmt);
-    if (!sqlite3_stmt_readonly(stmt)) {
-        castedThis->version_db->version++;
+        unsigned length = array->length();
+        bindings.grow(length);
+        for (unsigned i = 0; i < length; i++) {
+            JSValue value = array->getIndex(lexicalGlobalObject, i);
+            RETURN_IF_EXCEPTION(scope, {});
+            if (!toAsyncBinding(lexicalGlobalObject, scope, value, bindings[i]))
+                return JSValue::encode(jsUndefined());
+        }
     }
 
-    if (!castedThis->hasExecuted || castedThis->need_update()) {
-        initializeColumnNames(lexicalGlobalObject, castedThis);
+    int required = sqlite3_bind_parameter_count(stmt);
+    if (UNLIKELY(static_cast<int>(bindings.size()) != required)) {
+        throwException(lexicalGlobalObject, scope, createError(lexicalGlobalObject, makeString("SQLite query expected "_s, required, " values, received "_s, bindings.size())));
+        return JSValue::encode(jsUndefined());
     }
 
-    while (status == SQLITE_ROW) {
-        status = sqlite3_step(stmt);
-    }
+    Ref<SQLiteReadConnection> connection = version_db->readPool[version_db->nextReadConnection++ % version_db->readPool.size()];
+    auto* context = reinterpret_cast<Zig::GlobalObject*>(lexicalGlobalObject)->scriptExecutionContext();
+    JSC::JSPromise* promise = JSC::JSPromise::create(vm, lexicalGlobalObject->promiseStructure());
 
-    if (UNLIKELY(status != SQLITE_DONE && status != SQLITE_OK)) {
-        throwException(lexicalGlobalObject, scope, createSQLiteError(lexicalGlobalObject, castedThis->version_db->db));
-        sqlite3_reset(stmt);
-        return JSValue::encode(jsUndefined());
-    }
+    // Only created and destroyed on this thread, the read pool thread just carries the pointer
+    auto* strongPromise = new JSC::Strong<JSC::JSPromise>(vm, promise);
 
-    if (auto* diff = JSC::jsDynamicCast<JSC::InternalFieldTuple*>(diffValue)) {
-        auto* db = castedThis->version_db->db;
-        const int total_changes_after = sqlite3_total_changes(db);
-        int64_t last_insert_rowid = sqlite3_last_insert_rowid(db);
-        diff->putInternalField(vm, 0, JSC::jsNumber(total_changes_after - total_changes_before));
-        if (castedThis->useBigInt64) {
-            diff->putInternalField(vm, 1, JSBigInt::createFrom(lexicalGlobalObject, last_insert_rowid));
-        } else {
-            diff->putInternalField(vm, 1, JSC::jsNumber(last_insert_rowid));
-        }
-    }
+    context->refEventLoop();
+    auto& queue = connection->queue.get();
+    queue.dispatch([connection = WTFMove(connection), sql = castedThis->sql.utf8(), bindings = WTFMove(bindings), strongPromise, useBigInt64 = castedThis->useBigInt64, contextIdentifier = context->identifier()]() mutable {
+        SQLiteAsyncResult result;
+        runAsyncQuery(connection->db, sql, bindings, result);
 
-    RELEASE_AND_RETURN(scope, JSC::JSValue::encode(jsUndefined()));
+        ScriptExecutionContext::postTaskTo(contextIdentifier, [result = WTFMove(result), strongPromise, useBigInt64](ScriptExecutionContext& context) mutable {
+            context.unrefEventLoop();
+            std::unique_ptr<JSC::Strong<JSC::JSPromise>> protectedPromise(strongPromise);
+            auto* promise = protectedPromise->get();
+            auto* globalObject = context.jsGlobalObject();
+            auto& vm = globalObject->vm();
+            auto scope = DECLARE_CATCH_SCOPE(vm);
+
+            if (result.errorCode != SQLITE_OK) {
+                promise->reject(globalObject, createSQLiteError(globalObject, result.errorCode, result.errorOffset, result.errorMessage.data()));
+                return;
+            }
+
+            JSValue rows = materializeAsyncResult(globalObject, result, useBigInt64);
+            if (auto* exception = scope.exception()) {
+                scope.clearException();
+                promise->reject(globalObject, exception->value());
+                return;
+            }
+
+            promise->resolve(globalObject, rows);
+        });
+    });
+
+    RELEASE_AND_RETURN(scope, JSValue::encode(promise));
 }
 
 JSC_DEFINE_HOST_FUNCTION(jsSQLStatementToStringFunction, (JSC::JSGlobalObject * lexicalGlobalObject, JSC::CallFrame* callFrame))
@@ -2357,10 +4210,7 @@ JSC_DEFINE_HOST_FUNCTION(jsSQLStatementFunctionFinalize, (JSC::JSGlobalObject *
     auto scope = DECLARE_THROW_SCOPE(vm);
     CHECK_THIS
 
-    if (castedThis->stmt) {
-        sqlite3_finalize(castedThis->stmt);
-        castedThis->stmt = nullptr;
-    }
+    castedThis->releaseStatement();
 
     RELEASE_AND_RETURN(scope, JSValue::encode(jsUndefined()));
 }
@@ -2377,11 +4227,21 @@ void JSSQLStatement::finishCreation(VM& vm)
     vm.heap.reportExtraMemoryAllocated(this, this->extraMemorySize);
 }
 
+void JSSQLStatement::releaseStatement()
+{
+    auto* stmt = std::exchange(this->stmt, nullptr);
+    if (!stmt)
+        return;
+
+    if (this->version_db && this->version_db->db)
+        this->version_db->statementCache.give(WTFMove(this->sql), this->prepareFlags, stmt);
+    else
+        sqlite3_finalize(stmt);
+}
+
 JSSQLStatement::~JSSQLStatement()
 {
-    if (this->stmt) {
-        sqlite3_finalize(this->stmt);
-    }
+    releaseStatement();
 
     if (auto* columnNames = this->columnNames.get()) {
         columnNames->releaseData();
@@ -2451,6 +4311,24 @@ void JSSQLStatement::visitOutputConstraints(JSCell* cell, Visitor& visitor)
 template void JSSQLStatement::visitOutputConstraints(JSCell*, AbstractSlotVisitor&);
 template void JSSQLStatement::visitOutputConstraints(JSCell*, SlotVisitor&);
 
+size_t sqlitePageCacheMemory()
+{
+    // Nothing was opened, so SQLite may not even be loaded.
+    if (!_instance)
+        return 0;
+
+    size_t bytes = 0;
+    for (auto* database : databases()) {
+        if (!database->db)
+            continue;
+        int current = 0;
+        int highwater = 0;
+        if (sqlite3_db_status(database->db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0) == SQLITE_OK)
+            bytes += current;
+    }
+    return bytes;
+}
+
 JSValue createJSSQLStatementConstructor(Zig::GlobalObject* globalObject)
 {
     VM& vm = globalObject->vm();
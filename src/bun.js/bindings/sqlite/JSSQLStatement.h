@@ -86,4 +86,7 @@ Structure* createJSSQLStatementStructure(JSGlobalObject* globalObject);
 
 JSValue createJSSQLStatementConstructor(Zig::GlobalObject* globalObject);
 
+// The page cache of every open database, in bytes.
+size_t sqlitePageCacheMemory();
+
 } // namespace WebCore
@@ -92,6 +92,36 @@ typedef int (*lazy_sqlite3_deserialize_type)(
 typedef int (*lazy_sqlite3_stmt_readonly_type)(sqlite3_stmt* pStmt);
 typedef int (*lazy_sqlite3_compileoption_used_type)(const char* zOptName);
 typedef int64_t (*lazy_sqlite3_last_insert_rowid_type)(sqlite3* db);
+typedef void (*lazy_sqlite3_result_error_nomem_type)(sqlite3_context*);
+typedef void (*lazy_sqlite3_result_error_type)(sqlite3_context*, const char*, int);
+typedef void (*lazy_sqlite3_result_blob_type)(sqlite3_context*, const void*, int, void (*)(void*));
+typedef void (*lazy_sqlite3_result_text_type)(sqlite3_context*, const char*, int, void (*)(void*));
+typedef void (*lazy_sqlite3_result_double_type)(sqlite3_context*, double);
+typedef void (*lazy_sqlite3_result_int64_type)(sqlite3_context*, sqlite3_int64);
+typedef void (*lazy_sqlite3_result_null_type)(sqlite3_context*);
+typedef const void* (*lazy_sqlite3_value_blob_type)(sqlite3_value*);
+typedef void* (*lazy_sqlite3_aggregate_context_type)(sqlite3_context*, int nBytes);
+typedef void* (*lazy_sqlite3_user_data_type)(sqlite3_context*);
+typedef int (*lazy_sqlite3_create_function_v2_type)(sqlite3*, const char* zFunctionName, int nArg, int eTextRep, void* pApp, void (*xFunc)(sqlite3_context*, int, sqlite3_value**), void (*xStep)(sqlite3_context*, int, sqlite3_value**), void (*xFinal)(sqlite3_context*), void (*xDestroy)(void*));
+typedef void (*lazy_sqlite3_mutex_leave_type)(sqlite3_mutex*);
+typedef void (*lazy_sqlite3_mutex_enter_type)(sqlite3_mutex*);
+typedef sqlite3_mutex* (*lazy_sqlite3_db_mutex_type)(sqlite3*);
+typedef int (*lazy_sqlite3_value_bytes_type)(sqlite3_value*);
+typedef const unsigned char* (*lazy_sqlite3_value_text_type)(sqlite3_value*);
+typedef double (*lazy_sqlite3_value_double_type)(sqlite3_value*);
+typedef sqlite3_int64 (*lazy_sqlite3_value_int64_type)(sqlite3_value*);
+typedef int (*lazy_sqlite3_value_type_type)(sqlite3_value*);
+typedef sqlite3_value* (*lazy_sqlite3_column_value_type)(sqlite3_stmt*, int iCol);
+typedef int (*lazy_sqlite3_wal_autocheckpoint_type)(sqlite3*, int N);
+typedef int (*lazy_sqlite3_status64_type)(int op, sqlite3_int64* pCurrent, sqlite3_int64* pHighwater, int resetFlag);
+typedef int (*lazy_sqlite3_db_status_type)(sqlite3*, int op, int* pCur, int* pHiwtr, int resetFlg);
+typedef int (*lazy_sqlite3_blob_close_type)(sqlite3_blob*);
+typedef int (*lazy_sqlite3_blob_bytes_type)(sqlite3_blob*);
+typedef int (*lazy_sqlite3_blob_read_type)(sqlite3_blob*, void* Z, int N, int iOffset);
+typedef int (*lazy_sqlite3_blob_open_type)(sqlite3*, const char* zDb, const char* zTable, const char* zColumn, sqlite3_int64 iRow, int flags, sqlite3_blob** ppBlob);
+typedef int (*lazy_sqlite3_busy_timeout_type)(sqlite3*, int ms);
+typedef const char* (*lazy_sqlite3_db_filename_type)(sqlite3*, const char* zDbName);
+typedef int (*lazy_sqlite3_exec_type)(sqlite3*, const char* sql, int (*callback)(void*, int, char**, char**), void*, char** errmsg);
 
 static lazy_sqlite3_bind_blob_type lazy_sqlite3_bind_blob;
 static lazy_sqlite3_bind_double_type lazy_sqlite3_bind_double;
@@ -144,6 +174,36 @@ static lazy_sqlite3_memory_used_type lazy_sqlite3_memory_used;
 static lazy_sqlite3_bind_parameter_name_type lazy_sqlite3_bind_parameter_name;
 static lazy_sqlite3_total_changes_type lazy_sqlite3_total_changes;
 static lazy_sqlite3_last_insert_rowid_type lazy_sqlite3_last_insert_rowid;
+static lazy_sqlite3_result_error_nomem_type lazy_sqlite3_result_error_nomem;
+static lazy_sqlite3_result_error_type lazy_sqlite3_result_error;
+static lazy_sqlite3_result_blob_type lazy_sqlite3_result_blob;
+static lazy_sqlite3_result_text_type lazy_sqlite3_result_text;
+static lazy_sqlite3_result_double_type lazy_sqlite3_result_double;
+static lazy_sqlite3_result_int64_type lazy_sqlite3_result_int64;
+static lazy_sqlite3_result_null_type lazy_sqlite3_result_null;
+static lazy_sqlite3_value_blob_type lazy_sqlite3_value_blob;
+static lazy_sqlite3_aggregate_context_type lazy_sqlite3_aggregate_context;
+static lazy_sqlite3_user_data_type lazy_sqlite3_user_data;
+static lazy_sqlite3_create_function_v2_type lazy_sqlite3_create_function_v2;
+static lazy_sqlite3_mutex_leave_type lazy_sqlite3_mutex_leave;
+static lazy_sqlite3_mutex_enter_type lazy_sqlite3_mutex_enter;
+static lazy_sqlite3_db_mutex_type lazy_sqlite3_db_mutex;
+static lazy_sqlite3_value_bytes_type lazy_sqlite3_value_bytes;
+static lazy_sqlite3_value_text_type lazy_sqlite3_value_text;
+static lazy_sqlite3_value_double_type lazy_sqlite3_value_double;
+static lazy_sqlite3_value_int64_type lazy_sqlite3_value_int64;
+static lazy_sqlite3_value_type_type lazy_sqlite3_value_type;
+static lazy_sqlite3_column_value_type lazy_sqlite3_column_value;
+static lazy_sqlite3_wal_autocheckpoint_type lazy_sqlite3_wal_autocheckpoint;
+static lazy_sqlite3_status64_type lazy_sqlite3_status64;
+static lazy_sqlite3_db_status_type lazy_sqlite3_db_status;
+static lazy_sqlite3_blob_close_type lazy_sqlite3_blob_close;
+static lazy_sqlite3_blob_bytes_type lazy_sqlite3_blob_bytes;
+static lazy_sqlite3_blob_read_type lazy_sqlite3_blob_read;
+static lazy_sqlite3_blob_open_type lazy_sqlite3_blob_open;
+static lazy_sqlite3_busy_timeout_type lazy_sqlite3_busy_timeout;
+static lazy_sqlite3_db_filename_type lazy_sqlite3_db_filename;
+static lazy_sqlite3_exec_type lazy_sqlite3_exec;
 
 #define sqlite3_bind_blob lazy_sqlite3_bind_blob
 #define sqlite3_bind_double lazy_sqlite3_bind_double
@@ -195,6 +255,36 @@ static lazy_sqlite3_last_insert_rowid_type lazy_sqlite3_last_insert_rowid;
 #define sqlite3_bind_parameter_name lazy_sqlite3_bind_parameter_name
 #define sqlite3_total_changes lazy_sqlite3_total_changes
 #define sqlite3_last_insert_rowid lazy_sqlite3_last_insert_rowid
+#define sqlite3_result_error_nomem lazy_sqlite3_result_error_nomem
+#define sqlite3_result_error lazy_sqlite3_result_error
+#define sqlite3_result_blob lazy_sqlite3_result_blob
+#define sqlite3_result_text lazy_sqlite3_result_text
+#define sqlite3_result_double lazy_sqlite3_result_double
+#define sqlite3_result_int64 lazy_sqlite3_result_int64
+#define sqlite3_result_null lazy_sqlite3_result_null
+#define sqlite3_value_blob lazy_sqlite3_value_blob
+#define sqlite3_aggregate_context lazy_sqlite3_aggregate_context
+#define sqlite3_user_data lazy_sqlite3_user_data
+#define sqlite3_create_function_v2 lazy_sqlite3_create_function_v2
+#define sqlite3_mutex_leave lazy_sqlite3_mutex_leave
+#define sqlite3_mutex_enter lazy_sqlite3_mutex_enter
+#define sqlite3_db_mutex lazy_sqlite3_db_mutex
+#define sqlite3_value_bytes lazy_sqlite3_value_bytes
+#define sqlite3_value_text lazy_sqlite3_value_text
+#define sqlite3_value_double lazy_sqlite3_value_double
+#define sqlite3_value_int64 lazy_sqlite3_value_int64
+#define sqlite3_value_type lazy_sqlite3_value_type
+#define sqlite3_column_value lazy_sqlite3_column_value
+#define sqlite3_wal_autocheckpoint lazy_sqlite3_wal_autocheckpoint
+#define sqlite3_status64 lazy_sqlite3_status64
+#define sqlite3_db_status lazy_sqlite3_db_status
+#define sqlite3_blob_close lazy_sqlite3_blob_close
+#define sqlite3_blob_bytes lazy_sqlite3_blob_bytes
+#define sqlite3_blob_read lazy_sqlite3_blob_read
+#define sqlite3_blob_open lazy_sqlite3_blob_open
+#define sqlite3_busy_timeout lazy_sqlite3_busy_timeout
+#define sqlite3_db_filename lazy_sqlite3_db_filename
+#define sqlite3_exec lazy_sqlite3_exec
 
 #if !OS(WINDOWS)
 #define HMODULE void*
@@ -279,6 +369,36 @@ static int lazyLoadSQLite()
     lazy_sqlite3_bind_parameter_name = (lazy_sqlite3_bind_parameter_name_type)dlsym(sqlite3_handle, "sqlite3_bind_parameter_name");
     lazy_sqlite3_total_changes = (lazy_sqlite3_total_changes_type)dlsym(sqlite3_handle, "sqlite3_total_changes");
     lazy_sqlite3_last_insert_rowid = (lazy_sqlite3_last_insert_rowid_type)dlsym(sqlite3_handle, "sqlite3_last_insert_rowid");
+    lazy_sqlite3_result_error_nomem = (lazy_sqlite3_result_error_nomem_type)dlsym(sqlite3_handle, "sqlite3_result_error_nomem");
+    lazy_sqlite3_result_error = (lazy_sqlite3_result_error_type)dlsym(sqlite3_handle, "sqlite3_result_error");
+    lazy_sqlite3_result_blob = (lazy_sqlite3_result_blob_type)dlsym(sqlite3_handle, "sqlite3_result_blob");
+    lazy_sqlite3_result_text = (lazy_sqlite3_result_text_type)dlsym(sqlite3_handle, "sqlite3_result_text");
+    lazy_sqlite3_result_double = (lazy_sqlite3_result_double_type)dlsym(sqlite3_handle, "sqlite3_result_double");
+    lazy_sqlite3_result_int64 = (lazy_sqlite3_result_int64_type)dlsym(sqlite3_handle, "sqlite3_result_int64");
+    lazy_sqlite3_result_null = (lazy_sqlite3_result_null_type)dlsym(sqlite3_handle, "sqlite3_result_null");
+    lazy_sqlite3_value_blob = (lazy_sqlite3_value_blob_type)dlsym(sqlite3_handle, "sqlite3_value_blob");
+    lazy_sqlite3_aggregate_context = (lazy_sqlite3_aggregate_context_type)dlsym(sqlite3_handle, "sqlite3_aggregate_context");
+    lazy_sqlite3_user_data = (lazy_sqlite3_user_data_type)dlsym(sqlite3_handle, "sqlite3_user_data");
+    lazy_sqlite3_create_function_v2 = (lazy_sqlite3_create_function_v2_type)dlsym(sqlite3_handle, "sqlite3_create_function_v2");
+    lazy_sqlite3_mutex_leave = (lazy_sqlite3_mutex_leave_type)dlsym(sqlite3_handle, "sqlite3_mutex_leave");
+    lazy_sqlite3_mutex_enter = (lazy_sqlite3_mutex_enter_type)dlsym(sqlite3_handle, "sqlite3_mutex_enter");
+    lazy_sqlite3_db_mutex = (lazy_sqlite3_db_mutex_type)dlsym(sqlite3_handle, "sqlite3_db_mutex");
+    lazy_sqlite3_value_bytes = (lazy_sqlite3_value_bytes_type)dlsym(sqlite3_handle, "sqlite3_value_bytes");
+    lazy_sqlite3_value_text = (lazy_sqlite3_value_text_type)dlsym(sqlite3_handle, "sqlite3_value_text");
+    lazy_sqlite3_value_double = (lazy_sqlite3_value_double_type)dlsym(sqlite3_handle, "sqlite3_value_double");
+    lazy_sqlite3_value_int64 = (lazy_sqlite3_value_int64_type)dlsym(sqlite3_handle, "sqlite3_value_int64");
+    lazy_sqlite3_value_type = (lazy_sqlite3_value_type_type)dlsym(sqlite3_handle, "sqlite3_value_type");
+    lazy_sqlite3_column_value = (lazy_sqlite3_column_value_type)dlsym(sqlite3_handle, "sqlite3_column_value");
+    lazy_sqlite3_wal_autocheckpoint = (lazy_sqlite3_wal_autocheckpoint_type)dlsym(sqlite3_handle, "sqlite3_wal_autocheckpoint");
+    lazy_sqlite3_status64 = (lazy_sqlite3_status64_type)dlsym(sqlite3_handle, "sqlite3_status64");
+    lazy_sqlite3_db_status = (lazy_sqlite3_db_status_type)dlsym(sqlite3_handle, "sqlite3_db_status");
+    lazy_sqlite3_blob_close = (lazy_sqlite3_blob_close_type)dlsym(sqlite3_handle, "sqlite3_blob_close");
+    lazy_sqlite3_blob_bytes = (lazy_sqlite3_blob_bytes_type)dlsym(sqlite3_handle, "sqlite3_blob_bytes");
+    lazy_sqlite3_blob_read = (lazy_sqlite3_blob_read_type)dlsym(sqlite3_handle, "sqlite3_blob_read");
+    lazy_sqlite3_blob_open = (lazy_sqlite3_blob_open_type)dlsym(sqlite3_handle, "sqlite3_blob_open");
+    lazy_sqlite3_busy_timeout = (lazy_sqlite3_busy_timeout_type)dlsym(sqlite3_handle, "sqlite3_busy_timeout");
+    lazy_sqlite3_db_filename = (lazy_sqlite3_db_filename_type)dlsym(sqlite3_handle, "sqlite3_db_filename");
+    lazy_sqlite3_exec = (lazy_sqlite3_exec_type)dlsym(sqlite3_handle, "sqlite3_exec");
 
     if (!lazy_sqlite3_extended_result_codes) {
         lazy_sqlite3_extended_result_codes = [](sqlite3*, int) -> int {
@@ -34,6 +34,7 @@
 #include "JSDOMException.h"
 #include "ScriptExecutionContext.h"
 #include "WebCoreOpaqueRoot.h"
+#include "ZigGlobalObject.h"
 #include <JavaScriptCore/Exception.h>
 #include <JavaScriptCore/JSCast.h>
 #include <wtf/IsoMallocInlines.h>
@@ -56,12 +57,9 @@ Ref<AbortSignal> AbortSignal::abort(JSDOMGlobalObject& globalObject, ScriptExecu
     return adoptRef(*new AbortSignal(&context, Aborted::Yes, reason));
 }
 
-// https://dom.spec.whatwg.org/#dom-abortsignal-timeout
-Ref<AbortSignal> AbortSignal::timeout(ScriptExecutionContext& context, uint64_t milliseconds)
+void AbortSignal::postTimeoutAbort(ScriptExecutionContext& context, Ref<AbortSignal>&& signal)
 {
-    auto signal = adoptRef(*new AbortSignal(&context));
-    signal->setHasActiveTimeoutTimer(true);
-    auto action = [signal](ScriptExecutionContext& context) mutable {
+    context.postTask([signal = WTFMove(signal)](ScriptExecutionContext& context) mutable {
         signal->setHasActiveTimeoutTimer(false);
 
         auto* globalObject = JSC::jsCast<JSDOMGlobalObject*>(context.jsGlobalObject());
@@ -71,18 +69,45 @@ Ref<AbortSignal> AbortSignal::timeout(ScriptExecutionContext& context, uint64_t
         auto& vm = globalObject->vm();
         Locker locker { vm.apiLock() };
         signal->signalAbort(toJS(globalObject, globalObject, DOMException::create(TimeoutError)));
-    };
+    });
+}
+
+// https://dom.spec.whatwg.org/#dom-abortsignal-timeout
+Ref<AbortSignal> AbortSignal::timeout(ScriptExecutionContext& context, uint64_t milliseconds)
+{
+    auto signal = adoptRef(*new AbortSignal(&context));
+    signal->setHasActiveTimeoutTimer(true);
 
     if (milliseconds == 0) {
         // immediately write to task queue
-        context.postTask(WTFMove(action));
-    } else {
-        context.postTaskOnTimeout(WTFMove(action), Seconds::fromMilliseconds(milliseconds));
+        postTimeoutAbort(context, signal.copyRef());
+        return signal;
     }
 
+    // Servers make one of these per request, so rather than a timer each they
+    // go into a timing wheel, where scheduling one is O(1) and allocates
+    // nothing. The reference is released by timeoutFired().
+    auto* globalObject = JSC::jsCast<Zig::GlobalObject*>(context.jsGlobalObject());
+    uint64_t now = Bun::TimerWheel::now();
+    uint64_t expiresAt = milliseconds > std::numeric_limits<uint64_t>::max() - now ? std::numeric_limits<uint64_t>::max() : now + milliseconds;
+    signal->m_timeoutNode.signal = signal.ptr();
+    signal->ref();
+    globalObject->abortSignalTimers.schedule(signal->m_timeoutNode, now, expiresAt);
+
     return signal;
 }
 
+void AbortSignal::timeoutFired(Bun::TimerWheel::Node& node)
+{
+    Ref signal = adoptRef(*static_cast<TimeoutNode&>(node).signal);
+    signal->m_timeoutNode.signal = nullptr;
+
+    // Abort from a task of its own, as the timer used to, rather than in the
+    // middle of turning the wheel.
+    if (auto* context = signal->scriptExecutionContext())
+        postTimeoutAbort(*context, WTFMove(signal));
+}
+
 Ref<AbortSignal> AbortSignal::any(ScriptExecutionContext& context, const Vector<RefPtr<AbortSignal>>& signals)
 {
     Ref resultSignal = AbortSignal::create(&context);
@@ -108,7 +133,10 @@ AbortSignal::AbortSignal(ScriptExecutionContext* context, Aborted aborted, JSC::
     ASSERT(reason);
 }
 
-AbortSignal::~AbortSignal() = default;
+AbortSignal::~AbortSignal()
+{
+    unfollow();
+}
 
 void AbortSignal::addSourceSignal(AbortSignal& signal)
 {
@@ -151,8 +179,10 @@ void AbortSignal::signalAbort(JSC::JSValue reason)
     }
 
     auto algorithms = std::exchange(m_algorithms, {});
-    for (auto& algorithm : algorithms)
-        algorithm.second(reason);
+    auto identifiers = copyToVector(algorithms.keys());
+    std::sort(identifiers.begin(), identifiers.end());
+    for (auto identifier : identifiers)
+        algorithms.take(identifier)(reason);
 
     // 5. Fire an event named abort at signal.
     dispatchEvent(Event::create(eventNames().abortEvent, Event::CanBubble::No, Event::IsCancelable::No));
@@ -187,12 +217,23 @@ void AbortSignal::signalFollow(AbortSignal& signal)
 
     ASSERT(!m_followingSignal);
     m_followingSignal = signal;
-    signal.addAlgorithm([weakThis = WeakPtr { *this }](JSC::JSValue reason) {
+    m_followingAlgorithmIdentifier = signal.addAlgorithm([weakThis = WeakPtr { *this }](JSC::JSValue reason) {
         if (RefPtr signal = weakThis.get())
             signal->signalAbort(reason);
     });
 }
 
+void AbortSignal::unfollow()
+{
+    if (RefPtr followingSignal = m_followingSignal.get())
+        followingSignal->removeAlgorithm(m_followingAlgorithmIdentifier);
+    m_followingSignal = nullptr;
+    m_followingAlgorithmIdentifier = 0;
+
+    for (Ref sourceSignal : std::exchange(m_sourceSignals, {}))
+        sourceSignal->m_dependentSignals.remove(*this);
+}
+
 void AbortSignal::eventListenersDidChange()
 {
     m_hasAbortEventListener = hasEventListeners(eventNames().abortEvent);
@@ -216,15 +257,14 @@ void AbortSignal::removeAbortAlgorithmFromSignal(AbortSignal& signal, uint32_t a
 
 uint32_t AbortSignal::addAlgorithm(Algorithm&& algorithm)
 {
-    m_algorithms.append(std::make_pair(++m_algorithmIdentifier, WTFMove(algorithm)));
+    m_algorithms.add(++m_algorithmIdentifier, WTFMove(algorithm));
     return m_algorithmIdentifier;
 }
 
 void AbortSignal::removeAlgorithm(uint32_t algorithmIdentifier)
 {
-    m_algorithms.removeFirstMatching([algorithmIdentifier](auto& pair) {
-        return pair.first == algorithmIdentifier;
-    });
+    if (algorithmIdentifier)
+        m_algorithms.remove(algorithmIdentifier);
 }
 
 void AbortSignal::throwIfAborted(JSC::JSGlobalObject& lexicalGlobalObject)
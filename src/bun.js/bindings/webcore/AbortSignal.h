@@ -30,7 +30,9 @@
 #include "ContextDestructionObserver.h"
 #include "EventTarget.h"
 #include "JSValueInWrappedObject.h"
+#include "TimerWheel.h"
 #include <wtf/Function.h>
+#include <wtf/HashMap.h>
 #include <wtf/Ref.h>
 #include <wtf/RefCounted.h>
 #include <wtf/WeakListHashSet.h>
@@ -59,6 +61,10 @@ public:
 
     void signalAbort(JSC::JSValue reason);
     void signalFollow(AbortSignal&);
+    // Stops following signalFollow()'s signal and AbortSignal.any()'s
+    // sources, e.g. once the fetch that was given this signal has completed,
+    // so a long-lived source does not keep the signal reachable.
+    void unfollow();
 
     bool aborted() const { return m_aborted; }
     const JSValueInWrappedObject& reason() const { return m_reason; }
@@ -67,6 +73,9 @@ public:
     void addNativeCallback(NativeCallbackTuple callback) { m_native_callbacks.append(callback); }
 
     bool hasActiveTimeoutTimer() const { return m_hasActiveTimeoutTimer; }
+
+    // Called for each node of the global object's abortSignalTimers that is due.
+    static void timeoutFired(Bun::TimerWheel::Node&);
     bool hasAbortEventListener() const { return m_hasAbortEventListener; }
 
     using RefCounted::deref;
@@ -90,6 +99,7 @@ private:
     explicit AbortSignal(ScriptExecutionContext*, Aborted = Aborted::No, JSC::JSValue reason = JSC::jsUndefined());
 
     void setHasActiveTimeoutTimer(bool hasActiveTimeoutTimer) { m_hasActiveTimeoutTimer = hasActiveTimeoutTimer; }
+    static void postTimeoutAbort(ScriptExecutionContext&, Ref<AbortSignal>&&);
 
     bool isDependent() const { return m_isDependent; }
     void markAsDependent() { m_isDependent = true; }
@@ -103,8 +113,18 @@ private:
     void derefEventTarget() final { deref(); }
     void eventListenersDidChange() final;
 
-    Vector<std::pair<uint32_t, Algorithm>> m_algorithms;
+    // The node of AbortSignal.timeout()'s timer. While it is scheduled, the
+    // wheel holds a reference to the signal.
+    struct TimeoutNode : Bun::TimerWheel::Node {
+        AbortSignal* signal { nullptr };
+    };
+
+    // Keyed by identifier, so removing one is O(1). Identifiers increase, so
+    // sorting them gives back the order the algorithms were added in.
+    HashMap<uint32_t, Algorithm> m_algorithms;
     WeakPtr<AbortSignal, WeakPtrImplWithEventTargetData> m_followingSignal;
+    uint32_t m_followingAlgorithmIdentifier { 0 };
+    TimeoutNode m_timeoutNode;
     AbortSignalSet m_sourceSignals;
     AbortSignalSet m_dependentSignals;
     JSValueInWrappedObject m_reason;
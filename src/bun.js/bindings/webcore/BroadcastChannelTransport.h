@@ -0,0 +1,23 @@
+#pragma once
+
+#include "root.h"
+#include <wtf/Forward.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace WebCore {
+
+// Carries BroadcastChannel messages to other processes on the same host.
+// The registry hands it the wire bytes of every message whose contents do
+// not depend on this process; received messages come back through
+// BunBroadcastChannelRegistry::didReceiveRemoteMessage() on the main
+// thread. Delivery is best effort, like the pub/sub it replaces.
+class BroadcastChannelTransport : public ThreadSafeRefCounted<BroadcastChannelTransport> {
+public:
+    virtual ~BroadcastChannelTransport() = default;
+
+    // Main thread only. May hold the message back to send it with others
+    // posted in the same turn of the event loop.
+    virtual void send(const String& name, const Vector<uint8_t>& wireBytes) = 0;
+};
+
+} // namespace WebCore
@@ -3,12 +3,14 @@
 #include "BunBroadcastChannelRegistry.h"
 #include "webcore/BroadcastChannel.h"
 #include "webcore/MessageWithMessagePorts.h"
+#include "webcore/UnixSocketBroadcastChannelTransport.h"
 #include <wtf/CallbackAggregator.h>
 
 namespace WebCore {
 
 void BunBroadcastChannelRegistry::registerChannel(const String& name, BroadcastChannelIdentifier identifier)
 {
+    ensureRemoteTransport();
     auto& channels = m_channelsForName.ensure(name, [] { return Vector<BroadcastChannelIdentifier> {}; }).iterator->value;
     channels.append(identifier);
 }
@@ -25,10 +27,12 @@ void BunBroadcastChannelRegistry::unregisterChannel(const String& name, Broadcas
 
 void BunBroadcastChannelRegistry::postMessage(const String& name, BroadcastChannelIdentifier source, Ref<SerializedScriptValue>&& message)
 {
+    ensureRemoteTransport();
+    postMessageToRemote(name, message.get());
     postMessageLocally(name, source, message.copyRef());
 }
 
-void BunBroadcastChannelRegistry::postMessageLocally(const String& name, BroadcastChannelIdentifier sourceInProcess, Ref<SerializedScriptValue>&& message)
+void BunBroadcastChannelRegistry::postMessageLocally(const String& name, std::optional<BroadcastChannelIdentifier> sourceInProcess, Ref<SerializedScriptValue>&& message)
 {
     auto channels = m_channelsForName.find(name);
     if (channels == m_channelsForName.end())
@@ -43,10 +47,33 @@ void BunBroadcastChannelRegistry::postMessageLocally(const String& name, Broadca
     }
 }
 
-void BunBroadcastChannelRegistry::postMessageToRemote(const String& name, MessageWithMessagePorts&& message)
+void BunBroadcastChannelRegistry::setRemoteTransport(RefPtr<BroadcastChannelTransport>&& transport)
 {
-    // auto callbackAggregator = CallbackAggregator::create(WTFMove(completionHandler));
-    // PartitionedSecurityOrigin origin { clientOrigin.topOrigin.securityOrigin(), clientOrigin.clientOrigin.securityOrigin() };
-    // postMessageLocally(origin, name, std::nullopt, *message.message, callbackAggregator.copyRef());
+    m_didSetUpRemoteTransport = true;
+    m_remoteTransport = WTFMove(transport);
+}
+
+void BunBroadcastChannelRegistry::ensureRemoteTransport()
+{
+    if (m_didSetUpRemoteTransport)
+        return;
+    m_didSetUpRemoteTransport = true;
+
+    if (const char* directory = getenv("BUN_BROADCAST_CHANNEL_DIR"))
+        m_remoteTransport = UnixSocketBroadcastChannelTransport::create(String::fromUTF8(directory));
+}
+
+void BunBroadcastChannelRegistry::postMessageToRemote(const String& name, const SerializedScriptValue& message)
+{
+    // SharedArrayBuffers and shared Blob stores only mean something here.
+    if (!m_remoteTransport || !message.isProcessIndependent())
+        return;
+
+    m_remoteTransport->send(name, message.wireBytes());
+}
+
+void BunBroadcastChannelRegistry::didReceiveRemoteMessage(const String& name, Ref<SerializedScriptValue>&& message)
+{
+    postMessageLocally(name, std::nullopt, WTFMove(message));
 }
 }
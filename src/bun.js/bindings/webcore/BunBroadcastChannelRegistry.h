@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BroadcastChannelRegistry.h"
+#include "BroadcastChannelTransport.h"
 #include <wtf/CallbackAggregator.h>
 #include <wtf/Vector.h>
 #include <wtf/HashMap.h>
@@ -21,13 +22,20 @@ public:
     void unregisterChannel(const String& name, BroadcastChannelIdentifier) final;
     void postMessage(const String& name, BroadcastChannelIdentifier source, Ref<SerializedScriptValue>&&) final;
 
-    // void didReceivedMessage(IPC::Connection&, IPC::Decoder&);
+    // Messages also go to, and come from, other processes through the
+    // transport. Set from BUN_BROADCAST_CHANNEL_DIR unless set first.
+    void setRemoteTransport(RefPtr<BroadcastChannelTransport>&&);
+    void didReceiveRemoteMessage(const String& name, Ref<SerializedScriptValue>&&);
 
     HashMap<String, Vector<BroadcastChannelIdentifier>> m_channelsForName;
 
 private:
-    void postMessageToRemote(const String& name, MessageWithMessagePorts&&);
-    void postMessageLocally(const String& name, BroadcastChannelIdentifier sourceInProgress, Ref<SerializedScriptValue>&&);
+    void ensureRemoteTransport();
+    void postMessageToRemote(const String& name, const SerializedScriptValue&);
+    void postMessageLocally(const String& name, std::optional<BroadcastChannelIdentifier> sourceInProcess, Ref<SerializedScriptValue>&&);
+
+    RefPtr<BroadcastChannelTransport> m_remoteTransport;
+    bool m_didSetUpRemoteTransport { false };
 };
 
 }
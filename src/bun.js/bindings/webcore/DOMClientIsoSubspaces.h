@@ -28,6 +28,9 @@ public:
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForJSSinkController;
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForJSSink;
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForStringDecoder;
+    std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForSharedRing;
+    std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForWorkerPool;
+    std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForNodeHTTPRequestHeaders;
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForReadableState;
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForPendingVirtualModuleResult;
     std::unique_ptr<GCClient::IsoSubspace> m_clientSubspaceForCallSite;
@@ -28,6 +28,9 @@ public:
     std::unique_ptr<IsoSubspace> m_subspaceForJSSinkController;
     std::unique_ptr<IsoSubspace> m_subspaceForJSSink;
     std::unique_ptr<IsoSubspace> m_subspaceForStringDecoder;
+    std::unique_ptr<IsoSubspace> m_subspaceForSharedRing;
+    std::unique_ptr<IsoSubspace> m_subspaceForWorkerPool;
+    std::unique_ptr<IsoSubspace> m_subspaceForNodeHTTPRequestHeaders;
     std::unique_ptr<IsoSubspace> m_subspaceForReadableState;
     std::unique_ptr<IsoSubspace> m_subspaceForPendingVirtualModuleResult;
     std::unique_ptr<IsoSubspace> m_subspaceForCallSite;
@@ -196,9 +196,16 @@ void EventEmitter::fireEventListeners(const Identifier& eventType, const MarkedA
         return;
     }
 
+    Ref<EventEmitter> protectedThis(*this);
     bool prevFiringEventListeners = data->isFiringEventListeners;
     data->isFiringEventListeners = true;
-    innerInvokeEventListeners(eventType, *listenersVector, arguments);
+    // Most emitters have a single listener per event; hold on to it instead
+    // of copying the vector.
+    if (listenersVector->size() == 1) {
+        RefPtr registeredListener = listenersVector->first();
+        innerInvokeEventListener(eventType, *registeredListener, arguments);
+    } else
+        innerInvokeEventListeners(eventType, *listenersVector, arguments);
     data->isFiringEventListeners = prevFiringEventListeners;
 }
 
@@ -207,62 +214,67 @@ void EventEmitter::fireEventListeners(const Identifier& eventType, const MarkedA
 // https://dom.spec.whatwg.org/#concept-event-listener-inner-invoke
 void EventEmitter::innerInvokeEventListeners(const Identifier& eventType, SimpleEventListenerVector listeners, const MarkedArgumentBuffer& arguments)
 {
-    Ref<EventEmitter> protectedThis(*this);
     ASSERT(!listeners.isEmpty());
+
+    for (auto& registeredListener : listeners) {
+        // The below code used to be in here, but it's WRONG. Even if a listener is removed,
+        // if we're in the middle of firing listeners, we still need to call it.
+        // if (UNLIKELY(registeredListener->wasRemoved()))
+        //     continue;
+
+        innerInvokeEventListener(eventType, *registeredListener, arguments);
+    }
+}
+
+void EventEmitter::innerInvokeEventListener(const Identifier& eventType, SimpleRegisteredEventListener& registeredListener, const MarkedArgumentBuffer& arguments)
+{
     ASSERT(scriptExecutionContext());
 
     auto& context = *scriptExecutionContext();
     VM& vm = context.vm();
 
-    auto* thisObject = protectedThis->m_thisObject.get();
+    auto* thisObject = m_thisObject.get();
     JSC::JSValue thisValue = thisObject ? JSC::JSValue(thisObject) : JSC::jsUndefined();
 
-    for (auto& registeredListener : listeners) {
-        // The below code used to be in here, but it's WRONG. Even if a listener is removed,
-        // if we're in the middle of firing listeners, we still need to call it.
-        // if (UNLIKELY(registeredListener->wasRemoved()))
-        //     continue;
+    auto& callback = registeredListener.callback();
+
+    // Make sure the JS wrapper and function stay alive until the end of this scope. Otherwise,
+    // event listeners with 'once' flag may get collected as soon as they get unregistered below,
+    // before we call the js function.
+    JSObject* jsFunction = callback.jsFunction();
+    JSC::EnsureStillAliveScope wrapperProtector(callback.wrapper());
+    JSC::EnsureStillAliveScope jsFunctionProtector(jsFunction);
+
+    // Do this before invocation to avoid reentrancy issues.
+    if (registeredListener.isOnce())
+        removeListener(eventType, callback);
+
+    if (UNLIKELY(!jsFunction))
+        return;
+
+    JSC::JSGlobalObject* lexicalGlobalObject = jsFunction->globalObject();
+    auto callData = JSC::getCallData(jsFunction);
+    if (UNLIKELY(callData.type == JSC::CallData::Type::None))
+        return;
 
-        auto& callback = registeredListener->callback();
-
-        // Make sure the JS wrapper and function stay alive until the end of this scope. Otherwise,
-        // event listeners with 'once' flag may get collected as soon as they get unregistered below,
-        // before we call the js function.
-        JSObject* jsFunction = callback.jsFunction();
-        JSC::EnsureStillAliveScope wrapperProtector(callback.wrapper());
-        JSC::EnsureStillAliveScope jsFunctionProtector(jsFunction);
-
-        // Do this before invocation to avoid reentrancy issues.
-        if (registeredListener->isOnce())
-            removeListener(eventType, callback);
-
-        if (UNLIKELY(!jsFunction))
-            continue;
-
-        JSC::JSGlobalObject* lexicalGlobalObject = jsFunction->globalObject();
-        auto callData = JSC::getCallData(jsFunction);
-        if (UNLIKELY(callData.type == JSC::CallData::Type::None))
-            continue;
-
-        WTF::NakedPtr<JSC::Exception> exceptionPtr;
-        call(lexicalGlobalObject, jsFunction, callData, thisValue, arguments, exceptionPtr);
-        auto* exception = exceptionPtr.get();
-
-        if (UNLIKELY(exception)) {
-            auto errorIdentifier = JSC::Identifier::fromString(vm, eventNames().errorEvent);
-            auto hasErrorListener = this->hasActiveEventListeners(errorIdentifier);
-            if (!hasErrorListener || eventType == errorIdentifier) {
-                // If the event type is error, report the exception to the console.
-                Bun__reportUnhandledError(lexicalGlobalObject, JSValue::encode(JSValue(exception)));
-            } else if (hasErrorListener) {
-                MarkedArgumentBuffer expcep;
-                JSValue errorValue = exception->value();
-                if (!errorValue) {
-                    errorValue = JSC::jsUndefined();
-                }
-                expcep.append(errorValue);
-                fireEventListeners(errorIdentifier, WTFMove(expcep));
+    WTF::NakedPtr<JSC::Exception> exceptionPtr;
+    call(lexicalGlobalObject, jsFunction, callData, thisValue, arguments, exceptionPtr);
+    auto* exception = exceptionPtr.get();
+
+    if (UNLIKELY(exception)) {
+        auto errorIdentifier = JSC::Identifier::fromString(vm, eventNames().errorEvent);
+        auto hasErrorListener = this->hasActiveEventListeners(errorIdentifier);
+        if (!hasErrorListener || eventType == errorIdentifier) {
+            // If the event type is error, report the exception to the console.
+            Bun__reportUnhandledError(lexicalGlobalObject, JSValue::encode(JSValue(exception)));
+        } else if (hasErrorListener) {
+            MarkedArgumentBuffer expcep;
+            JSValue errorValue = exception->value();
+            if (!errorValue) {
+                errorValue = JSC::jsUndefined();
             }
+            expcep.append(errorValue);
+            fireEventListeners(errorIdentifier, WTFMove(expcep));
         }
     }
 }
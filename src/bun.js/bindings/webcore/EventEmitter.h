@@ -110,6 +110,7 @@ private:
     }
 
     void innerInvokeEventListeners(const Identifier&, SimpleEventListenerVector, const MarkedArgumentBuffer& arguments);
+    void innerInvokeEventListener(const Identifier&, SimpleRegisteredEventListener&, const MarkedArgumentBuffer& arguments);
     void invalidateEventListenerRegions();
 
     EventEmitterData m_eventTargetData;
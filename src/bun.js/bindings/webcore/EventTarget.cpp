@@ -242,6 +242,8 @@ ExceptionOr<bool> EventTarget::dispatchEventForBindings(Event& event)
     return event.legacyReturnValue();
 }
 
+// Standalone targets (AbortSignal, MessagePort, WebSocket, ...) have no
+// parent, so the event is only ever at its target and no EventPath is built.
 void EventTarget::dispatchEvent(Event& event)
 {
     // FIXME: We should always use EventDispatcher.
@@ -279,6 +281,19 @@ void EventTarget::fireEventListeners(Event& event, EventInvokePhase phase)
     SetForScope firingEventListenersScope(data->isFiringEventListeners, true);
 
     if (auto* listenersVector = data->eventListenerMap.find(event.type())) {
+        // Nothing to do in this phase; skip copying the vector.
+        bool useCapture = phase == EventInvokePhase::Capturing;
+        if (!listenersVector->containsIf([&](auto& listener) { return listener->useCapture() == useCapture; }))
+            return;
+
+        // Holding the only listener is as good as a snapshot of the vector.
+        if (listenersVector->size() == 1) {
+            Ref<EventTarget> protectedThis(*this);
+            RefPtr registeredListener = listenersVector->first();
+            innerInvokeEventListener(event, *registeredListener, phase);
+            return;
+        }
+
         innerInvokeEventListeners(event, *listenersVector, phase);
         return;
     }
@@ -307,55 +322,65 @@ void EventTarget::innerInvokeEventListeners(Event& event, EventListenerVector li
     ASSERT(!listeners.isEmpty());
     ASSERT(scriptExecutionContext());
 
-    auto& context = *scriptExecutionContext();
     // bool contextIsDocument = is<Document>(context);
     // if (contextIsDocument)
     //     InspectorInstrumentation::willDispatchEvent(downcast<Document>(context), event);
 
     for (auto& registeredListener : listeners) {
-        if (UNLIKELY(registeredListener->wasRemoved()))
-            continue;
+        if (!innerInvokeEventListener(event, *registeredListener, phase))
+            break;
+    }
 
-        if (phase == EventInvokePhase::Capturing && !registeredListener->useCapture())
-            continue;
-        if (phase == EventInvokePhase::Bubbling && registeredListener->useCapture())
-            continue;
+    // if (contextIsDocument)
+    //     InspectorInstrumentation::didDispatchEvent(downcast<Document>(context), event);
+}
 
-        // if (InspectorInstrumentation::isEventListenerDisabled(*this, event.type(), registeredListener->callback(), registeredListener->useCapture()))
-        //     continue;
+// Returns false once listeners on this target should stop running.
+bool EventTarget::innerInvokeEventListener(Event& event, RegisteredEventListener& registeredListener, EventInvokePhase phase)
+{
+    ASSERT(scriptExecutionContext());
+    auto& context = *scriptExecutionContext();
 
-        // If stopImmediatePropagation has been called, we just break out immediately, without
-        // handling any more events on this target.
-        if (event.immediatePropagationStopped())
-            break;
+    if (UNLIKELY(registeredListener.wasRemoved()))
+        return true;
 
-        // Make sure the JS wrapper and function stay alive until the end of this scope. Otherwise,
-        // event listeners with 'once' flag may get collected as soon as they get unregistered below,
-        // before we call the js function.
-        JSC::EnsureStillAliveScope wrapperProtector(registeredListener->callback().wrapper());
-        JSC::EnsureStillAliveScope jsFunctionProtector(registeredListener->callback().jsFunction());
+    if (phase == EventInvokePhase::Capturing && !registeredListener.useCapture())
+        return true;
+    if (phase == EventInvokePhase::Bubbling && registeredListener.useCapture())
+        return true;
+
+    // if (InspectorInstrumentation::isEventListenerDisabled(*this, event.type(), registeredListener.callback(), registeredListener.useCapture()))
+    //     return true;
+
+    // If stopImmediatePropagation has been called, we just break out immediately, without
+    // handling any more events on this target.
+    if (event.immediatePropagationStopped())
+        return false;
 
-        // Do this before invocation to avoid reentrancy issues.
-        if (registeredListener->isOnce())
-            removeEventListener(event.type(), registeredListener->callback(), registeredListener->useCapture());
+    // Make sure the JS wrapper and function stay alive until the end of this scope. Otherwise,
+    // event listeners with 'once' flag may get collected as soon as they get unregistered below,
+    // before we call the js function.
+    JSC::EnsureStillAliveScope wrapperProtector(registeredListener.callback().wrapper());
+    JSC::EnsureStillAliveScope jsFunctionProtector(registeredListener.callback().jsFunction());
 
-        if (registeredListener->isPassive())
-            event.setInPassiveListener(true);
+    // Do this before invocation to avoid reentrancy issues.
+    if (registeredListener.isOnce())
+        removeEventListener(event.type(), registeredListener.callback(), registeredListener.useCapture());
+
+    if (registeredListener.isPassive())
+        event.setInPassiveListener(true);
 
 #if ASSERT_ENABLED
-        registeredListener->callback().checkValidityForEventTarget(*this);
+    registeredListener.callback().checkValidityForEventTarget(*this);
 #endif
 
-        // InspectorInstrumentation::willHandleEvent(context, event, *registeredListener);
-        registeredListener->callback().handleEvent(context, event);
-        // InspectorInstrumentation::didHandleEvent(context, event, *registeredListener);
-
-        // if (registeredListener->isPassive())
-        // event.setInPassiveListener(false);
-    }
+    // InspectorInstrumentation::willHandleEvent(context, event, registeredListener);
+    registeredListener.callback().handleEvent(context, event);
+    // InspectorInstrumentation::didHandleEvent(context, event, registeredListener);
 
-    // if (contextIsDocument)
-    //     InspectorInstrumentation::didDispatchEvent(downcast<Document>(context), event);
+    // if (registeredListener.isPassive())
+    // event.setInPassiveListener(false);
+    return true;
 }
 
 Vector<AtomString> EventTarget::eventTypes()
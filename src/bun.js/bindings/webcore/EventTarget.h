@@ -155,6 +155,7 @@ private:
     virtual void derefEventTarget() = 0;
 
     void innerInvokeEventListeners(Event&, EventListenerVector, EventInvokePhase);
+    bool innerInvokeEventListener(Event&, RegisteredEventListener&, EventInvokePhase);
     void invalidateEventListenerRegions();
 };
 
@@ -34,6 +34,8 @@
 
 namespace WebCore {
 
+WTF_MAKE_ISO_ALLOCATED_IMPL(FetchHeaders);
+
 // https://fetch.spec.whatwg.org/#concept-headers-remove-privileged-no-cors-request-headers
 static void removePrivilegedNoCORSRequestHeaders(HTTPHeaderMap& headers)
 {
@@ -161,21 +163,18 @@ ExceptionOr<Ref<FetchHeaders>> FetchHeaders::create(std::optional<Init>&& header
 
 ExceptionOr<void> FetchHeaders::fill(const Init& headerInit)
 {
+    ++m_updateCounter;
     return fillHeaderMap(m_headers, headerInit, m_guard);
 }
 
 ExceptionOr<void> FetchHeaders::fill(const FetchHeaders& otherHeaders)
 {
     if (this->size() == 0) {
-        HTTPHeaderMap headers;
-        headers.commonHeaders().appendVector(otherHeaders.m_headers.commonHeaders());
-        headers.uncommonHeaders().appendVector(otherHeaders.m_headers.uncommonHeaders());
-        headers.getSetCookieHeaders().appendVector(otherHeaders.m_headers.getSetCookieHeaders());
-        setInternalHeaders(WTFMove(headers));
-        m_updateCounter++;
+        setInternalHeaders(HTTPHeaderMap { otherHeaders.m_headers });
         return {};
     }
 
+    ++m_updateCounter;
     for (auto& header : otherHeaders.m_headers) {
         auto result = appendToHeaderMap(header, m_headers, m_guard);
         if (result.hasException())
@@ -253,6 +252,7 @@ ExceptionOr<void> FetchHeaders::set(const String& name, const String& value)
 
 void FetchHeaders::filterAndFill(const HTTPHeaderMap& headers, Guard guard)
 {
+    ++m_updateCounter;
     for (auto& header : headers) {
         String normalizedValue = header.value.trim(isHTTPSpace);
         auto canWriteResult = canWriteHeader(header.key, normalizedValue, header.value, guard);
@@ -267,6 +267,42 @@ void FetchHeaders::filterAndFill(const HTTPHeaderMap& headers, Guard guard)
     }
 }
 
+static void appendWireString(Vector<uint8_t>& bytes, const String& string, std::pair<uint32_t, uint32_t>& pointer)
+{
+    ASSERT_WITH_MESSAGE(string.containsOnlyASCII(), "Header names and values must be ASCII. This should already be validated before calling this function.");
+    pointer.first = bytes.size();
+    if (string.is8Bit() && string.containsOnlyASCII()) {
+        bytes.append(string.span8());
+        pointer.second = string.length();
+    } else {
+        auto utf8 = string.utf8();
+        bytes.append(std::span { reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length() });
+        pointer.second = utf8.length();
+    }
+}
+
+const FetchHeaders::WireHeaders& FetchHeaders::wireHeaders()
+{
+    if (m_wireHeaders && m_wireHeadersUpdateCounter == m_updateCounter)
+        return *m_wireHeaders;
+
+    auto wire = makeUnique<WireHeaders>();
+    wire->names.reserveInitialCapacity(size());
+    wire->values.reserveInitialCapacity(size());
+    auto iter = createIterator();
+    for (auto pair = iter.next(); pair; pair = iter.next()) {
+        ASSERT_WITH_MESSAGE(pair->key.length(), "Header name must not be empty");
+        wire->names.append({ 0, 0 });
+        appendWireString(wire->bytes, pair->key, wire->names.last());
+        wire->values.append({ 0, 0 });
+        appendWireString(wire->bytes, pair->value, wire->values.last());
+    }
+
+    m_wireHeaders = WTFMove(wire);
+    m_wireHeadersUpdateCounter = m_updateCounter;
+    return *m_wireHeaders;
+}
+
 std::optional<KeyValuePair<String, String>> FetchHeaders::Iterator::next()
 {
     if (m_keys.isEmpty() || m_updateCounter != m_headers->m_updateCounter) {
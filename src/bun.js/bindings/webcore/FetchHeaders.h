@@ -37,6 +37,8 @@
 namespace WebCore {
 
 class FetchHeaders : public RefCounted<FetchHeaders> {
+    WTF_MAKE_ISO_ALLOCATED(FetchHeaders);
+
 public:
     enum class Guard {
         None,
@@ -76,8 +78,16 @@ public:
 
     String fastGet(HTTPHeaderName name) const { return m_headers.get(name); }
     bool fastHas(HTTPHeaderName name) const { return m_headers.contains(name); }
-    bool fastRemove(HTTPHeaderName name) { return m_headers.remove(name); }
-    void fastSet(HTTPHeaderName name, const String& value) { m_headers.set(name, value); }
+    bool fastRemove(HTTPHeaderName name)
+    {
+        ++m_updateCounter;
+        return m_headers.remove(name);
+    }
+    void fastSet(HTTPHeaderName name, const String& value)
+    {
+        ++m_updateCounter;
+        m_headers.set(name, value);
+    }
 
     const Vector<String, 0>& getSetCookieHeaders() const { return m_headers.getSetCookieHeaders(); }
 
@@ -100,9 +110,23 @@ public:
         return Iterator(*this, lowerCaseKeys);
     }
 
-    void setInternalHeaders(HTTPHeaderMap&& headers) { m_headers = WTFMove(headers); }
+    void setInternalHeaders(HTTPHeaderMap&& headers)
+    {
+        ++m_updateCounter;
+        m_headers = WTFMove(headers);
+    }
     const HTTPHeaderMap& internalHeaders() const { return m_headers; }
 
+    // The headers in iteration order, packed into one buffer as
+    // (offset, length) pairs the way they are copied out to Zig. Kept until
+    // the headers change, so forwarding the same Headers is one memcpy.
+    struct WireHeaders {
+        Vector<uint8_t> bytes;
+        Vector<std::pair<uint32_t, uint32_t>> names;
+        Vector<std::pair<uint32_t, uint32_t>> values;
+    };
+    const WireHeaders& wireHeaders();
+
     void setGuard(Guard);
     Guard guard() const { return m_guard; }
 
@@ -114,6 +138,8 @@ public:
 private:
     Guard m_guard;
     HTTPHeaderMap m_headers;
+    std::unique_ptr<WireHeaders> m_wireHeaders;
+    uint64_t m_wireHeadersUpdateCounter { 0 };
 };
 
 inline FetchHeaders::FetchHeaders(Guard guard, HTTPHeaderMap&& headers)
@@ -56,6 +56,7 @@ HTTPHeaderMap HTTPHeaderMap::isolatedCopy() const&
     map.m_commonHeaders = crossThreadCopy(m_commonHeaders);
     map.m_uncommonHeaders = crossThreadCopy(m_uncommonHeaders);
     map.m_setCookieHeaders = crossThreadCopy(m_setCookieHeaders);
+    map.m_commonHeaderSlots = m_commonHeaderSlots;
     return map;
 }
 
@@ -65,9 +66,24 @@ HTTPHeaderMap HTTPHeaderMap::isolatedCopy() &&
     map.m_commonHeaders = crossThreadCopy(WTFMove(m_commonHeaders));
     map.m_uncommonHeaders = crossThreadCopy(WTFMove(m_uncommonHeaders));
     map.m_setCookieHeaders = crossThreadCopy(WTFMove(m_setCookieHeaders));
+    map.m_commonHeaderSlots = std::exchange(m_commonHeaderSlots, {});
     return map;
 }
 
+void HTTPHeaderMap::appendCommonHeader(HTTPHeaderName name, const String& value)
+{
+    ASSERT(findCommonHeader(name) == notFound);
+    m_commonHeaders.append(CommonHeader { name, value });
+    m_commonHeaderSlots[static_cast<uint8_t>(name)] = m_commonHeaders.size();
+}
+
+void HTTPHeaderMap::rebuildCommonHeaderSlots()
+{
+    m_commonHeaderSlots.fill(0);
+    for (size_t i = 0; i < m_commonHeaders.size(); ++i)
+        m_commonHeaderSlots[static_cast<uint8_t>(m_commonHeaders[i].key)] = i + 1;
+}
+
 String HTTPHeaderMap::get(const String& name) const
 {
     HTTPHeaderName headerName;
@@ -186,7 +202,7 @@ void HTTPHeaderMap::append(const String& name, const String& value)
         if (headerName == HTTPHeaderName::SetCookie)
             m_setCookieHeaders.append(value);
         else
-            m_commonHeaders.append(CommonHeader { headerName, value });
+            appendCommonHeader(headerName, value);
     } else {
         m_uncommonHeaders.append(UncommonHeader { name, value });
     }
@@ -197,7 +213,7 @@ bool HTTPHeaderMap::addIfNotPresent(HTTPHeaderName headerName, const String& val
     if (contains(headerName))
         return false;
 
-    m_commonHeaders.append(CommonHeader { headerName, value });
+    appendCommonHeader(headerName, value);
     return true;
 }
 
@@ -246,9 +262,7 @@ String HTTPHeaderMap::get(HTTPHeaderName name) const
         }
     }
 
-    auto index = m_commonHeaders.findIf([&](auto& header) {
-        return header.key == name;
-    });
+    auto index = findCommonHeader(name);
     return index != notFound ? m_commonHeaders[index].value : String();
 }
 
@@ -260,11 +274,9 @@ void HTTPHeaderMap::set(HTTPHeaderName name, const String& value)
         return;
     }
 
-    auto index = m_commonHeaders.findIf([&](auto& header) {
-        return header.key == name;
-    });
+    auto index = findCommonHeader(name);
     if (index == notFound)
-        m_commonHeaders.append(CommonHeader { name, value });
+        appendCommonHeader(name, value);
     else
         m_commonHeaders[index].value = value;
 }
@@ -274,9 +286,7 @@ bool HTTPHeaderMap::contains(HTTPHeaderName name) const
     if (name == HTTPHeaderName::SetCookie)
         return !m_setCookieHeaders.isEmpty();
 
-    return m_commonHeaders.findIf([&](auto& header) {
-        return header.key == name;
-    }) != notFound;
+    return findCommonHeader(name) != notFound;
 }
 
 bool HTTPHeaderMap::remove(HTTPHeaderName name)
@@ -287,9 +297,15 @@ bool HTTPHeaderMap::remove(HTTPHeaderName name)
         return any;
     }
 
-    return m_commonHeaders.removeFirstMatching([&](auto& header) {
-        return header.key == name;
-    });
+    auto index = findCommonHeader(name);
+    if (index == notFound)
+        return false;
+
+    m_commonHeaders.remove(index);
+    m_commonHeaderSlots[static_cast<uint8_t>(name)] = 0;
+    for (size_t i = index; i < m_commonHeaders.size(); ++i)
+        m_commonHeaderSlots[static_cast<uint8_t>(m_commonHeaders[i].key)] = i + 1;
+    return true;
 }
 
 void HTTPHeaderMap::add(HTTPHeaderName name, const String& value)
@@ -299,13 +315,11 @@ void HTTPHeaderMap::add(HTTPHeaderName name, const String& value)
         return;
     }
 
-    auto index = m_commonHeaders.findIf([&](auto& header) {
-        return header.key == name;
-    });
+    auto index = findCommonHeader(name);
     if (index != notFound)
         m_commonHeaders[index].value = makeString(m_commonHeaders[index].value, ", ", value);
     else
-        m_commonHeaders.append(CommonHeader { name, value });
+        appendCommonHeader(name, value);
 }
 
 } // namespace WebCore
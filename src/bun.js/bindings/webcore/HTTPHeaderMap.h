@@ -27,6 +27,7 @@
 #pragma once
 
 #include "HTTPHeaderNames.h"
+#include <array>
 #include <utility>
 #include <wtf/text/WTFString.h>
 
@@ -167,6 +168,7 @@ public:
     {
         m_commonHeaders.clear();
         m_uncommonHeaders.clear();
+        m_commonHeaderSlots.fill(0);
     }
 
     void shrinkToFit()
@@ -211,7 +213,6 @@ public:
 
     const CommonHeadersVector &commonHeaders() const { return m_commonHeaders; }
     const UncommonHeadersVector &uncommonHeaders() const { return m_uncommonHeaders; }
-    CommonHeadersVector &commonHeaders() { return m_commonHeaders; }
     UncommonHeadersVector &uncommonHeaders() { return m_uncommonHeaders; }
     Vector<String, 0> &getSetCookieHeaders() { return m_setCookieHeaders; }
 
@@ -254,7 +255,18 @@ public:
 private:
     WEBCORE_EXPORT String getUncommonHeader(const String &name) const;
 
+    size_t findCommonHeader(HTTPHeaderName name) const
+    {
+        auto slot = m_commonHeaderSlots[static_cast<uint8_t>(name)];
+        return slot ? slot - 1 : notFound;
+    }
+    void appendCommonHeader(HTTPHeaderName, const String &value);
+    void rebuildCommonHeaderSlots();
+
     CommonHeadersVector m_commonHeaders;
+    // Index + 1 into m_commonHeaders for each HTTPHeaderName, 0 if absent,
+    // so common headers are found without scanning.
+    std::array<uint8_t, numHTTPHeaderNames> m_commonHeaderSlots {};
     UncommonHeadersVector m_uncommonHeaders;
     Vector<String, 0> m_setCookieHeaders;
 };
@@ -315,6 +327,7 @@ bool HTTPHeaderMap::decode(Decoder &decoder, HTTPHeaderMap &headerMap)
     if (!decoder.decode(headerMap.m_uncommonHeaders))
         return false;
 
+    headerMap.rebuildCommonHeaderSlots();
     return true;
 }
 
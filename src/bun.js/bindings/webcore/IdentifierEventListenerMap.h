@@ -65,6 +65,8 @@ public:
 
 private:
     EntriesVector m_entries;
+    // Where find() last matched; emit() tends to look up the same type repeatedly.
+    unsigned m_lastFoundIndex { 0 };
     Lock m_lock;
 };
 
@@ -51,6 +51,7 @@
 #include "JSPerformanceMeasureOptions.h"
 // #include "JSPerformanceNavigation.h"
 #include "JSPerformanceTiming.h"
+#include "NodePerfHooks.h"
 
 #include "ScriptExecutionContext.h"
 #include "WebCoreJSClientData.h"
@@ -210,6 +211,7 @@ static const HashTableValue JSPerformancePrototypeTableValues[] = {
     { "clearMarks"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsPerformancePrototypeFunction_clearMarks, 0 } },
     { "measure"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsPerformancePrototypeFunction_measure, 1 } },
     { "clearMeasures"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsPerformancePrototypeFunction_clearMeasures, 0 } },
+    { "eventLoopUtilization"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, Bun::jsFunctionEventLoopUtilization, 2 } },
 };
 
 const ClassInfo JSPerformancePrototype::s_info = { "Performance"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSPerformancePrototype) };
@@ -52,6 +52,11 @@ template<> StructuredSerializeOptions convertDictionary<StructuredSerializeOptio
         RETURN_IF_EXCEPTION(throwScope, {});
     } else
         result.transfer = Converter<IDLSequence<IDLObject>>::ReturnType {};
+    if (!isNullOrUndefined) {
+        JSValue lazyValue = object->get(&lexicalGlobalObject, Identifier::fromString(vm, "lazy"_s));
+        RETURN_IF_EXCEPTION(throwScope, {});
+        result.lazy = lazyValue.toBoolean(&lexicalGlobalObject);
+    }
     return result;
 }
 
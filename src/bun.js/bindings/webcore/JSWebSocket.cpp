@@ -49,6 +49,8 @@
 #include "JSDOMOperation.h"
 #include "JSDOMWrapperCache.h"
 #include "JSEventListener.h"
+#include "JSWritableStream.h"
+#include "ReadableStream.h"
 #include "ScriptExecutionContext.h"
 #include "WebCoreJSClientData.h"
 #include <JavaScriptCore/HeapAnalyzer.h>
@@ -74,6 +76,7 @@ static JSC_DECLARE_HOST_FUNCTION(jsWebSocketPrototypeFunction_close);
 static JSC_DECLARE_HOST_FUNCTION(jsWebSocketPrototypeFunction_ping);
 static JSC_DECLARE_HOST_FUNCTION(jsWebSocketPrototypeFunction_pong);
 static JSC_DECLARE_HOST_FUNCTION(jsWebSocketPrototypeFunction_terminate);
+static JSC_DECLARE_HOST_FUNCTION(jsWebSocketPrototypeFunction_cork);
 
 // Attributes
 
@@ -94,6 +97,8 @@ static JSC_DECLARE_CUSTOM_GETTER(jsWebSocket_protocol);
 static JSC_DECLARE_CUSTOM_GETTER(jsWebSocket_extensions);
 static JSC_DECLARE_CUSTOM_GETTER(jsWebSocket_binaryType);
 static JSC_DECLARE_CUSTOM_SETTER(setJSWebSocket_binaryType);
+static JSC_DECLARE_CUSTOM_GETTER(jsWebSocket_readable);
+static JSC_DECLARE_CUSTOM_GETTER(jsWebSocket_writable);
 
 class JSWebSocketPrototype final : public JSC::JSNonFinalObject {
 public:
@@ -210,6 +215,7 @@ static inline JSC::EncodedJSValue constructJSWebSocket3(JSGlobalObject* lexicalG
 
     Vector<String> protocols;
     int rejectUnauthorized = -1;
+    auto perMessageDeflate = WebSocket::PerMessageDeflate::Disabled;
     auto headersInit = std::optional<Converter<IDLUnion<IDLSequence<IDLSequence<IDLByteString>>, IDLRecord<IDLByteString, IDLByteString>>>::ReturnType>();
     if (JSC::JSObject* options = optionsObjectValue.getObject()) {
         if (JSValue headersValue = options->getIfPropertyExists(globalObject, PropertyName(Identifier::fromString(vm, "headers"_s)))) {
@@ -231,6 +237,20 @@ static inline JSC::EncodedJSValue constructJSWebSocket3(JSGlobalObject* lexicalG
             }
         }
 
+        // perMessageDeflate: boolean | { contextTakeover?: boolean }
+        if (JSValue perMessageDeflateValue = options->getIfPropertyExists(globalObject, PropertyName(Identifier::fromString(vm, "perMessageDeflate"_s)))) {
+            if (perMessageDeflateValue.isObject()) {
+                perMessageDeflate = WebSocket::PerMessageDeflate::ContextTakeover;
+                if (JSValue contextTakeoverValue = perMessageDeflateValue.getObject()->getIfPropertyExists(globalObject, PropertyName(Identifier::fromString(vm, "contextTakeover"_s)))) {
+                    if (!contextTakeoverValue.isUndefinedOrNull() && !contextTakeoverValue.toBoolean(globalObject))
+                        perMessageDeflate = WebSocket::PerMessageDeflate::NoContextTakeover;
+                }
+            } else if (perMessageDeflateValue.toBoolean(globalObject)) {
+                perMessageDeflate = WebSocket::PerMessageDeflate::ContextTakeover;
+            }
+            RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+        }
+
         if (JSValue tlsOptionsValue = options->getIfPropertyExists(globalObject, PropertyName(Identifier::fromString(vm, "tls"_s)))) {
             if (!tlsOptionsValue.isUndefinedOrNull() && tlsOptionsValue.isObject()) {
                 if (JSC::JSObject* tlsOptions = tlsOptionsValue.getObject()) {
@@ -246,7 +266,7 @@ static inline JSC::EncodedJSValue constructJSWebSocket3(JSGlobalObject* lexicalG
     }
 
     RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
-    auto object = (rejectUnauthorized == -1) ? WebSocket::create(*context, WTFMove(url), protocols, WTFMove(headersInit)) : WebSocket::create(*context, WTFMove(url), protocols, WTFMove(headersInit), rejectUnauthorized ? true : false);
+    auto object = WebSocket::create(*context, WTFMove(url), protocols, WTFMove(headersInit), rejectUnauthorized == -1 ? std::nullopt : std::optional<bool> { rejectUnauthorized ? true : false }, perMessageDeflate);
 
     if constexpr (IsExceptionOr<decltype(object)>)
         RETURN_IF_EXCEPTION(throwScope, {});
@@ -321,11 +341,14 @@ static const HashTableValue JSWebSocketPrototypeTableValues[] = {
     { "protocol"_s, static_cast<unsigned>(JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::CustomAccessor | JSC::PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWebSocket_protocol, 0 } },
     { "extensions"_s, static_cast<unsigned>(JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::CustomAccessor | JSC::PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWebSocket_extensions, 0 } },
     { "binaryType"_s, static_cast<unsigned>(JSC::PropertyAttribute::CustomAccessor | JSC::PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWebSocket_binaryType, setJSWebSocket_binaryType } },
+    { "readable"_s, static_cast<unsigned>(JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::CustomAccessor | JSC::PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWebSocket_readable, 0 } },
+    { "writable"_s, static_cast<unsigned>(JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::CustomAccessor | JSC::PropertyAttribute::DOMAttribute), NoIntrinsic, { HashTableValue::GetterSetterType, jsWebSocket_writable, 0 } },
     { "send"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_send, 1 } },
     { "close"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_close, 0 } },
     { "ping"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_ping, 1 } },
     { "pong"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_pong, 1 } },
     { "terminate"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_terminate, 0 } },
+    { "cork"_s, static_cast<unsigned>(JSC::PropertyAttribute::Function), NoIntrinsic, { HashTableValue::NativeFunctionType, jsWebSocketPrototypeFunction_cork, 1 } },
     { "CONNECTING"_s, JSC::PropertyAttribute::DontDelete | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::ConstantInteger, NoIntrinsic, { HashTableValue::ConstantType, 0 } },
     { "OPEN"_s, JSC::PropertyAttribute::DontDelete | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::ConstantInteger, NoIntrinsic, { HashTableValue::ConstantType, 1 } },
     { "CLOSING"_s, JSC::PropertyAttribute::DontDelete | JSC::PropertyAttribute::ReadOnly | JSC::PropertyAttribute::ConstantInteger, NoIntrinsic, { HashTableValue::ConstantType, 2 } },
@@ -563,6 +586,32 @@ JSC_DEFINE_CUSTOM_GETTER(jsWebSocket_extensions, (JSGlobalObject * lexicalGlobal
     return IDLAttribute<JSWebSocket>::get<jsWebSocket_extensionsGetter, CastedThisErrorBehavior::Assert>(*lexicalGlobalObject, thisValue, attributeName);
 }
 
+static inline JSValue jsWebSocket_readableGetter(JSGlobalObject& lexicalGlobalObject, JSWebSocket& thisObject)
+{
+    auto& vm = JSC::getVM(&lexicalGlobalObject);
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto& impl = thisObject.wrapped();
+    RELEASE_AND_RETURN(throwScope, (toJS<IDLInterface<ReadableStream>>(lexicalGlobalObject, *thisObject.globalObject(), throwScope, impl.readable(*thisObject.globalObject()))));
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsWebSocket_readable, (JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, PropertyName attributeName))
+{
+    return IDLAttribute<JSWebSocket>::get<jsWebSocket_readableGetter, CastedThisErrorBehavior::Assert>(*lexicalGlobalObject, thisValue, attributeName);
+}
+
+static inline JSValue jsWebSocket_writableGetter(JSGlobalObject& lexicalGlobalObject, JSWebSocket& thisObject)
+{
+    auto& vm = JSC::getVM(&lexicalGlobalObject);
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto& impl = thisObject.wrapped();
+    RELEASE_AND_RETURN(throwScope, (toJS<IDLInterface<WritableStream>>(lexicalGlobalObject, *thisObject.globalObject(), throwScope, impl.writable(*thisObject.globalObject()))));
+}
+
+JSC_DEFINE_CUSTOM_GETTER(jsWebSocket_writable, (JSGlobalObject * lexicalGlobalObject, JSC::EncodedJSValue thisValue, PropertyName attributeName))
+{
+    return IDLAttribute<JSWebSocket>::get<jsWebSocket_writableGetter, CastedThisErrorBehavior::Assert>(*lexicalGlobalObject, thisValue, attributeName);
+}
+
 static inline JSValue jsWebSocket_binaryTypeGetter(JSGlobalObject& lexicalGlobalObject, JSWebSocket& thisObject)
 {
     auto& vm = JSC::getVM(&lexicalGlobalObject);
@@ -885,6 +934,29 @@ JSC_DEFINE_HOST_FUNCTION(jsWebSocketPrototypeFunction_terminate, (JSGlobalObject
     return IDLOperation<JSWebSocket>::call<jsWebSocketPrototypeFunction_terminateBody>(*lexicalGlobalObject, *callFrame, "terminate");
 }
 
+static inline JSC::EncodedJSValue jsWebSocketPrototypeFunction_corkBody(JSC::JSGlobalObject* lexicalGlobalObject, JSC::CallFrame* callFrame, typename IDLOperation<JSWebSocket>::ClassParameter castedThis)
+{
+    auto& vm = JSC::getVM(lexicalGlobalObject);
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto& impl = castedThis->wrapped();
+    JSValue callback = callFrame->argument(0);
+    auto callData = JSC::getCallData(callback);
+    if (callData.type == JSC::CallData::Type::None)
+        return throwArgumentTypeError(*lexicalGlobalObject, throwScope, 0, "callback"_s, "WebSocket"_s, "cork"_s, "function"_s);
+
+    // Everything sent from the callback leaves in as few packets as possible, even if it throws
+    impl.cork();
+    JSValue result = JSC::call(lexicalGlobalObject, callback, callData, castedThis, ArgList());
+    impl.uncork();
+    RETURN_IF_EXCEPTION(throwScope, {});
+    return JSValue::encode(result);
+}
+
+JSC_DEFINE_HOST_FUNCTION(jsWebSocketPrototypeFunction_cork, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    return IDLOperation<JSWebSocket>::call<jsWebSocketPrototypeFunction_corkBody>(*lexicalGlobalObject, *callFrame, "cork");
+}
+
 JSC::GCClient::IsoSubspace* JSWebSocket::subspaceForImpl(JSC::VM& vm)
 {
     return WebCore::subspaceForImpl<JSWebSocket, UseCustomHeapCellType::No>(
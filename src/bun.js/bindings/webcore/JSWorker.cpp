@@ -50,6 +50,7 @@
 #include <JavaScriptCore/JSArray.h>
 #include <JavaScriptCore/JSCInlines.h>
 #include <JavaScriptCore/JSDestructibleObjectHeapCellType.h>
+#include <JavaScriptCore/ObjectConstructor.h>
 #include <JavaScriptCore/SlotVisitorMacros.h>
 #include <JavaScriptCore/SubspaceInlines.h>
 #include <wtf/GetPtr.h>
@@ -111,6 +112,46 @@ STATIC_ASSERT_ISO_SUBSPACE_SHARABLE(JSWorkerPrototype, JSWorkerPrototype::Base);
 
 using JSWorkerDOMConstructor = JSDOMConstructor<JSWorker>;
 
+static std::unique_ptr<HashMap<String, String>> copyWorkerEnvironment(JSGlobalObject* lexicalGlobalObject, JSObject* envObject)
+{
+    VM& vm = lexicalGlobalObject->vm();
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+
+    if (!envObject->staticPropertiesReified()) {
+        envObject->reifyAllStaticProperties(lexicalGlobalObject);
+        RETURN_IF_EXCEPTION(throwScope, {});
+    }
+
+    JSC::PropertyNameArray keys(vm, JSC::PropertyNameMode::Strings, JSC::PrivateSymbolMode::Exclude);
+    envObject->methodTable()->getOwnPropertyNames(envObject, lexicalGlobalObject, keys, JSC::DontEnumPropertiesMode::Exclude);
+    RETURN_IF_EXCEPTION(throwScope, {});
+
+    HashMap<String, String> env;
+
+    for (const auto& key : keys) {
+        JSValue value = envObject->get(lexicalGlobalObject, key);
+        RETURN_IF_EXCEPTION(throwScope, {});
+        String str = value.toWTFString(lexicalGlobalObject).isolatedCopy();
+        RETURN_IF_EXCEPTION(throwScope, {});
+        env.add(key.impl()->isolatedCopy(), str);
+    }
+
+    return std::make_unique<HashMap<String, String>>(WTFMove(env));
+}
+
+// Like Node, publishes { worker } to the worker_threads diagnostics channel for every new Worker.
+static inline void publishWorkerCreated(JSGlobalObject* lexicalGlobalObject, JSValue worker)
+{
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    if (LIKELY(!globalObject->hasDiagnosticsChannelSubscribers(Bun::DiagnosticsChannel::WorkerThreads)))
+        return;
+
+    auto& vm = globalObject->vm();
+    JSObject* message = constructEmptyObject(globalObject, globalObject->objectPrototype(), 1);
+    message->putDirect(vm, Identifier::fromString(vm, "worker"_s), worker);
+    Bun::publishDiagnosticsChannel(globalObject, Bun::DiagnosticsChannel::WorkerThreads, message);
+}
+
 template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::construct(JSGlobalObject* lexicalGlobalObject, CallFrame* callFrame)
 {
     VM& vm = lexicalGlobalObject->vm();
@@ -129,6 +170,9 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
 
     auto options = WorkerOptions {};
     options.bun.unref = false;
+    // A prewarmed worker was started with only a name, smol and the
+    // inherited environment.
+    bool canAdoptPrewarmedWorker = true;
 
     if (JSObject* optionsObject = JSC::jsDynamicCast<JSC::JSObject*>(argument1.value())) {
         if (auto nameValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "name"_s))) {
@@ -154,6 +198,7 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
         }
 
         if (workerData) {
+            canAdoptPrewarmedWorker = false;
             Vector<RefPtr<MessagePort>> ports;
             Vector<JSC::Strong<JSC::JSObject>> transferList;
 
@@ -200,36 +245,20 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
 
         if (envValue && envValue.isCell()) {
             envObject = jsDynamicCast<JSC::JSObject*>(envValue);
+            canAdoptPrewarmedWorker = false;
         } else if (globalObject->m_processEnvObject.isInitialized()) {
             envObject = globalObject->processEnvObject();
         }
 
         if (envObject) {
-            if (!envObject->staticPropertiesReified()) {
-                envObject->reifyAllStaticProperties(globalObject);
-                RETURN_IF_EXCEPTION(throwScope, {});
-            }
-
-            JSC::PropertyNameArray keys(vm, JSC::PropertyNameMode::Strings, JSC::PrivateSymbolMode::Exclude);
-            envObject->methodTable()->getOwnPropertyNames(envObject, lexicalGlobalObject, keys, JSC::DontEnumPropertiesMode::Exclude);
+            options.bun.env = copyWorkerEnvironment(globalObject, envObject);
             RETURN_IF_EXCEPTION(throwScope, {});
-
-            HashMap<String, String> env;
-
-            for (const auto& key : keys) {
-                JSValue value = envObject->get(lexicalGlobalObject, key);
-                RETURN_IF_EXCEPTION(throwScope, {});
-                String str = value.toWTFString(lexicalGlobalObject).isolatedCopy();
-                RETURN_IF_EXCEPTION(throwScope, {});
-                env.add(key.impl()->isolatedCopy(), str);
-            }
-
-            options.bun.env = std::make_unique<HashMap<String, String>>(WTFMove(env));
         }
 
         JSValue argvValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "argv"_s));
         RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
         if (argvValue && argvValue.isCell() && argvValue.asCell()->type() == JSC::JSType::ArrayType) {
+            canAdoptPrewarmedWorker = false;
             Vector<String> argv;
             forEachInIterable(lexicalGlobalObject, argvValue, [&argv](JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSC::JSValue nextValue) {
                 auto scope = DECLARE_THROW_SCOPE(vm);
@@ -244,6 +273,7 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
         JSValue execArgvValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "execArgv"_s));
         RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
         if (execArgvValue && execArgvValue.isCell() && execArgvValue.asCell()->type() == JSC::JSType::ArrayType) {
+            canAdoptPrewarmedWorker = false;
             Vector<String> execArgv;
             forEachInIterable(lexicalGlobalObject, execArgvValue, [&execArgv](JSC::VM& vm, JSC::JSGlobalObject* lexicalGlobalObject, JSC::JSValue nextValue) {
                 auto scope = DECLARE_THROW_SCOPE(vm);
@@ -257,6 +287,20 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
     }
 
     RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+
+    if (canAdoptPrewarmedWorker) {
+        if (auto worker = Worker::takePrewarmed(*context, scriptUrl, options)) {
+            // Its thread is already running, so there is no updatePtr() to do.
+            auto jsValue = toJSNewlyCreated<IDLInterface<Worker>>(*lexicalGlobalObject, *castedThis->globalObject(), throwScope, worker.releaseNonNull());
+            RETURN_IF_EXCEPTION(throwScope, {});
+            setSubclassStructureIfNeeded<Worker>(lexicalGlobalObject, callFrame, asObject(jsValue));
+            RETURN_IF_EXCEPTION(throwScope, {});
+            publishWorkerCreated(lexicalGlobalObject, jsValue);
+            RETURN_IF_EXCEPTION(throwScope, {});
+            return JSValue::encode(jsValue);
+        }
+    }
+
     auto object = Worker::create(*context, WTFMove(scriptUrl), WTFMove(options));
     if constexpr (IsExceptionOr<decltype(object)>)
         RETURN_IF_EXCEPTION(throwScope, {});
@@ -274,10 +318,71 @@ template<> JSC::EncodedJSValue JSC_HOST_CALL_ATTRIBUTES JSWorkerDOMConstructor::
     setSubclassStructureIfNeeded<Worker>(lexicalGlobalObject, callFrame, asObject(jsValue));
     RETURN_IF_EXCEPTION(throwScope, {});
 
+    publishWorkerCreated(lexicalGlobalObject, jsValue);
+    RETURN_IF_EXCEPTION(throwScope, {});
+
     return JSValue::encode(jsValue);
 }
 JSC_ANNOTATE_HOST_FUNCTION(JSWorkerDOMConstructorConstruct, JSWorkerDOMConstructor::construct);
 
+// Bun.prewarmWorkers(url, { count = 1, name, smol })
+JSC_DEFINE_HOST_FUNCTION(jsFunctionPrewarmWorkers, (JSGlobalObject * lexicalGlobalObject, CallFrame* callFrame))
+{
+    VM& vm = lexicalGlobalObject->vm();
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = jsCast<Zig::GlobalObject*>(lexicalGlobalObject);
+    auto* context = globalObject->scriptExecutionContext();
+    if (UNLIKELY(!context))
+        return JSValue::encode(jsUndefined());
+
+    if (UNLIKELY(callFrame->argumentCount() < 1))
+        return throwVMError(lexicalGlobalObject, throwScope, createNotEnoughArgumentsError(lexicalGlobalObject));
+    auto scriptUrl = convert<IDLUSVString>(*lexicalGlobalObject, callFrame->uncheckedArgument(0));
+    RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+
+    unsigned count = 1;
+    String name;
+    bool mini = false;
+    if (JSObject* optionsObject = JSC::jsDynamicCast<JSC::JSObject*>(callFrame->argument(1))) {
+        if (auto countValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "count"_s))) {
+            double requested = countValue.toNumber(lexicalGlobalObject);
+            RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+            if (UNLIKELY(!(requested >= 0 && requested <= Worker::maximumPrewarmedCount) || requested != std::trunc(requested)))
+                return throwVMRangeError(lexicalGlobalObject, throwScope, makeString("count must be an integer from 0 to "_s, Worker::maximumPrewarmedCount));
+            count = static_cast<unsigned>(requested);
+        }
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+
+        if (auto nameValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "name"_s))) {
+            if (nameValue.isString()) {
+                name = nameValue.toWTFString(lexicalGlobalObject);
+                RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+            }
+        }
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+
+        if (auto miniModeValue = optionsObject->getIfPropertyExists(lexicalGlobalObject, Identifier::fromString(vm, "smol"_s))) {
+            mini = miniModeValue.toBoolean(lexicalGlobalObject);
+            RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+        }
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+    }
+
+    // Snapshot the environment the way `new Worker()` without `env` does.
+    std::unique_ptr<HashMap<String, String>> env;
+    if (globalObject->m_processEnvObject.isInitialized()) {
+        env = copyWorkerEnvironment(globalObject, globalObject->processEnvObject());
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+    }
+
+    auto result = Worker::prewarm(*context, scriptUrl, name, mini, WTFMove(env), count);
+    if (result.hasException()) {
+        WebCore::propagateException(*lexicalGlobalObject, throwScope, result.releaseException());
+        return encodedJSValue();
+    }
+    return JSValue::encode(jsUndefined());
+}
+
 template<> const ClassInfo JSWorkerDOMConstructor::s_info = { "Worker"_s, &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(JSWorkerDOMConstructor) };
 
 template<> JSValue JSWorkerDOMConstructor::prototypeForStructure(JSC::VM& vm, const JSDOMGlobalObject& globalObject)
@@ -498,6 +603,9 @@ static inline JSC::EncodedJSValue jsWorkerPrototypeFunction_postMessage2Body(JSC
             RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
             options.transfer = WTFMove(transferList);
         }
+        JSValue lazyValue = optionsObject->get(lexicalGlobalObject, Identifier::fromString(vm, "lazy"_s));
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+        options.lazy = lazyValue.toBoolean(lexicalGlobalObject);
     }
 
     RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
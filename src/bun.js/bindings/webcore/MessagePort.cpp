@@ -178,7 +178,7 @@ ExceptionOr<void> MessagePort::postMessage(JSC::JSGlobalObject& state, JSC::JSVa
     // LOG(MessagePorts, "Attempting to post message to port %s (to be received by port %s)", m_identifier.logString().utf8().data(), m_remoteIdentifier.logString().utf8().data());
 
     Vector<RefPtr<MessagePort>> ports;
-    auto messageData = SerializedScriptValue::create(state, messageValue, WTFMove(options.transfer), ports, SerializationForStorage::No, SerializationContext::WorkerPostMessage);
+    auto messageData = SerializedScriptValue::create(state, messageValue, WTFMove(options.transfer), ports, SerializationForStorage::No, SerializationContext::WorkerPostMessage, m_shapeDictionary.get(), options.lazy ? SerializationLaziness::Lazy : SerializationLaziness::Eager);
     if (messageData.hasException())
         return messageData.releaseException();
 
@@ -204,6 +204,17 @@ ExceptionOr<void> MessagePort::postMessage(JSC::JSGlobalObject& state, JSC::JSVa
 
     // LOG(MessagePorts, "Actually posting message to port %s (to be received by port %s)", m_identifier.logString().utf8().data(), m_remoteIdentifier.logString().utf8().data());
 
+    // The channel's queue for the remote port takes messages without a lock
+    // and only asks for a wakeup for the first of a burst, so the port and
+    // context maps below are only consulted once per burst.
+    if (!m_channel)
+        m_channel = MessagePortChannelProvider::fromContext(*scriptExecutionContext()).channelForPort(m_identifier);
+    if (m_channel) {
+        if (m_channel->postMessageToRemote(WTFMove(message), m_remoteIdentifier))
+            MessagePort::notifyMessageAvailable(m_remoteIdentifier);
+        return {};
+    }
+
     ScriptExecutionContextIdentifier contextId = contextIdForMessagePortId(m_remoteIdentifier);
 
     MessagePortChannelProvider::fromContext(*ScriptExecutionContext::getScriptExecutionContext(contextId)).postMessageToRemote(WTFMove(message), m_remoteIdentifier);
@@ -215,6 +226,7 @@ TransferredMessagePort MessagePort::disentangle()
 {
     ASSERT(m_entangled);
     m_entangled = false;
+    m_channel = nullptr;
 
     auto& context = *scriptExecutionContext();
     MessagePortChannelProvider::fromContext(context).messagePortDisentangled(m_identifier);
@@ -261,6 +273,7 @@ void MessagePort::close()
     if (m_isDetached)
         return;
     m_isDetached = true;
+    m_channel = nullptr;
 
     MessagePortChannelProvider::singleton().messagePortClosed(m_identifier);
 
@@ -301,7 +314,7 @@ void MessagePort::dispatchMessages()
             //     dispatchEvent(event.event);
             // });
 
-            ScriptExecutionContext::postTaskTo(contextIdForMessagePortId(m_identifier), [protectedThis = Ref { *this }, ports = WTFMove(ports), message = WTFMove(message)](ScriptExecutionContext& context) mutable {
+            context->postTask([protectedThis = Ref { *this }, ports = WTFMove(ports), message = WTFMove(message)](ScriptExecutionContext& context) mutable {
                 auto event = MessageEvent::create(*context.jsGlobalObject(), message.message.releaseNonNull(), {}, {}, {}, WTFMove(ports));
                 protectedThis->dispatchEvent(event.event);
             });
@@ -457,6 +470,14 @@ WebCoreOpaqueRoot root(MessagePort* port)
     return WebCoreOpaqueRoot { port };
 }
 
+void MessagePort::enableSharedShapes()
+{
+    if (m_shapeDictionary || !isEntangled())
+        return;
+
+    m_shapeDictionary = MessagePortChannelProvider::fromContext(*scriptExecutionContext()).shapeDictionaryForPort(m_identifier);
+}
+
 void MessagePort::jsRef(JSGlobalObject* lexicalGlobalObject)
 {
     if (!m_hasRef) {
@@ -109,6 +109,12 @@ public:
     void jsUnref(JSGlobalObject*);
     bool jsHasRef() { return m_hasRef; }
 
+    // Messages this port posts from now on name plain objects' properties
+    // through the channel's SerializedShapeDictionary. The receiving port
+    // needs no setup, and the mode does not follow the port if it is
+    // transferred.
+    void enableSharedShapes();
+
 private:
     explicit MessagePort(ScriptExecutionContext&, const MessagePortIdentifier& local, const MessagePortIdentifier& remote);
 
@@ -142,6 +148,10 @@ private:
 
     bool m_hasRef { false };
 
+    RefPtr<SerializedShapeDictionary> m_shapeDictionary;
+    // Set once this port has posted, until it is closed or transferred.
+    RefPtr<MessagePortChannel> m_channel;
+
     uint32_t m_messageEventCount { 0 };
     static void onDidChangeListenerImpl(EventTarget& self, const AtomString& eventType, OnDidChangeListenerKind kind);
 };
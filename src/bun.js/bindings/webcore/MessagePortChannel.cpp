@@ -113,7 +113,6 @@ void MessagePortChannel::closePort(const MessagePortIdentifier& port)
 
     m_pendingMessages[i].clear();
     m_pendingMessagePortTransfers[i].clear();
-    m_pendingMessageProtectors[i] = nullptr;
     m_entangledToProcessProtectors[i] = nullptr;
 }
 
@@ -122,16 +121,13 @@ bool MessagePortChannel::postMessageToRemote(MessageWithMessagePorts&& message,
     ASSERT(remoteTarget == m_ports[0] || remoteTarget == m_ports[1]);
     size_t i = remoteTarget == m_ports[0] ? 0 : 1;
 
-    m_pendingMessages[i].append(WTFMove(message));
-    // LOG(MessagePorts, "MessagePortChannel %s (%p) now has %zu messages pending on port %s", logString().utf8().data(), this, m_pendingMessages[i].size(), remoteTarget.logString().utf8().data());
+    // Nothing will ever take it.
+    if (m_isClosed[i])
+        return false;
 
-    if (m_pendingMessages[i].size() == 1) {
-        m_pendingMessageProtectors[i] = this;
-        return true;
-    }
+    // LOG(MessagePorts, "MessagePortChannel %s (%p) now has messages pending on port %s", logString().utf8().data(), this, remoteTarget.logString().utf8().data());
 
-    ASSERT(m_pendingMessageProtectors[i] == this);
-    return false;
+    return m_pendingMessages[i].append(WTFMove(message));
 }
 
 void MessagePortChannel::takeAllMessagesForPort(const MessagePortIdentifier& port, CompletionHandler<void(Vector<MessageWithMessagePorts>&&, CompletionHandler<void()>&&)>&& callback)
@@ -141,38 +137,36 @@ void MessagePortChannel::takeAllMessagesForPort(const MessagePortIdentifier& por
     ASSERT(port == m_ports[0] || port == m_ports[1]);
     size_t i = port == m_ports[0] ? 0 : 1;
 
-    if (m_pendingMessages[i].isEmpty()) {
+    auto result = m_pendingMessages[i].takeAll();
+    if (result.isEmpty()) {
         callback({}, [] {});
         return;
     }
 
-    ASSERT(m_pendingMessageProtectors[i]);
-
-    Vector<MessageWithMessagePorts> result;
-    result.swap(m_pendingMessages[i]);
-
     ++m_messageBatchesInFlight;
 
     // LOG(MessagePorts, "There are %zu messages to take for port %s. Taking them now, messages in flight is now %" PRIu64, result.size(), port.logString().utf8().data(), m_messageBatchesInFlight);
 
-    callback(WTFMove(result), [this, port, protectedThis = WTFMove(m_pendingMessageProtectors[i])] {
+    callback(WTFMove(result), [this, port, protectedThis = Ref { *this }] {
         UNUSED_PARAM(port);
         --m_messageBatchesInFlight;
         // LOG(MessagePorts, "Message port channel %s was notified that a batch of %zu message port messages targeted for port %s just completed dispatch, in flight is now %" PRIu64, logString().utf8().data(), size, port.logString().utf8().data(), m_messageBatchesInFlight);
     });
 }
 
+SerializedShapeDictionary& MessagePortChannel::shapeDictionary()
+{
+    if (!m_shapeDictionary)
+        m_shapeDictionary = SerializedShapeDictionary::create();
+    return *m_shapeDictionary;
+}
+
 std::optional<MessageWithMessagePorts> MessagePortChannel::tryTakeMessageForPort(const MessagePortIdentifier port)
 {
     ASSERT(port == m_ports[0] || port == m_ports[1]);
     size_t i = port == m_ports[0] ? 0 : 1;
 
-    if (m_pendingMessages[i].isEmpty())
-        return std::nullopt;
-
-    auto message = m_pendingMessages[i].first();
-    m_pendingMessages[i].remove(0);
-    return WTFMove(message);
+    return m_pendingMessages[i].takeFirst();
 }
 
 } // namespace WebCore
@@ -27,17 +27,19 @@
 
 #include "MessagePortChannelProvider.h"
 #include "MessagePortIdentifier.h"
+#include "MessagePortQueue.h"
 #include "MessageWithMessagePorts.h"
 #include "ProcessIdentifier.h"
+#include "SerializedShapeDictionary.h"
 #include <wtf/HashSet.h>
-#include <wtf/RefCounted.h>
+#include <wtf/ThreadSafeRefCounted.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
 class MessagePortChannelRegistry;
 
-class MessagePortChannel : public RefCounted<MessagePortChannel> {
+class MessagePortChannel : public ThreadSafeRefCounted<MessagePortChannel> {
 public:
     static Ref<MessagePortChannel> create(MessagePortChannelRegistry&, const MessagePortIdentifier& port1, const MessagePortIdentifier& port2);
 
@@ -51,6 +53,7 @@ public:
     void entanglePortWithProcess(const MessagePortIdentifier&, ProcessIdentifier);
     void disentanglePort(const MessagePortIdentifier&);
     void closePort(const MessagePortIdentifier&);
+    // Returns true if the port receiving the message has to be told about it.
     bool postMessageToRemote(MessageWithMessagePorts&&, const MessagePortIdentifier& remoteTarget);
 
     void takeAllMessagesForPort(const MessagePortIdentifier&, CompletionHandler<void(Vector<MessageWithMessagePorts>&&, CompletionHandler<void()>&&)>&&);
@@ -58,6 +61,9 @@ public:
 
     WEBCORE_EXPORT bool hasAnyMessagesPendingOrInFlight() const;
 
+    // Shared by both directions, created the first time either port asks.
+    SerializedShapeDictionary& shapeDictionary();
+
     uint64_t beingTransferredCount();
 
 #if !LOG_DISABLED
@@ -71,13 +77,13 @@ private:
     MessagePortChannel(MessagePortChannelRegistry&, const MessagePortIdentifier& port1, const MessagePortIdentifier& port2);
 
     MessagePortIdentifier m_ports[2];
-    bool m_isClosed[2] { false, false };
+    std::atomic<bool> m_isClosed[2] { false, false };
     std::optional<ProcessIdentifier> m_processes[2];
     RefPtr<MessagePortChannel> m_entangledToProcessProtectors[2];
-    Vector<MessageWithMessagePorts> m_pendingMessages[2];
+    MessagePortQueue m_pendingMessages[2];
     HashSet<RefPtr<MessagePortChannel>> m_pendingMessagePortTransfers[2];
-    RefPtr<MessagePortChannel> m_pendingMessageProtectors[2];
-    uint64_t m_messageBatchesInFlight { 0 };
+    std::atomic<uint64_t> m_messageBatchesInFlight { 0 };
+    RefPtr<SerializedShapeDictionary> m_shapeDictionary;
 
     MessagePortChannelRegistry& m_registry;
 };
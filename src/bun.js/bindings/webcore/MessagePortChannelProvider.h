@@ -33,7 +33,9 @@
 
 namespace WebCore {
 
+class MessagePortChannel;
 class ScriptExecutionContext;
+class SerializedShapeDictionary;
 struct MessagePortIdentifier;
 struct MessageWithMessagePorts;
 
@@ -55,6 +57,11 @@ public:
     virtual std::optional<MessageWithMessagePorts> tryTakeMessageForPort(const MessagePortIdentifier&) = 0;
 
     virtual void postMessageToRemote(MessageWithMessagePorts&&, const MessagePortIdentifier& remoteTarget) = 0;
+
+    virtual RefPtr<SerializedShapeDictionary> shapeDictionaryForPort(const MessagePortIdentifier&) = 0;
+
+    // Lets a port post straight into its channel without a registry lookup per message.
+    virtual RefPtr<MessagePortChannel> channelForPort(const MessagePortIdentifier&) = 0;
 };
 
 } // namespace WebCore
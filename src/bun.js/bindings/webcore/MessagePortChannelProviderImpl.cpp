@@ -83,4 +83,14 @@ std::optional<MessageWithMessagePorts> MessagePortChannelProviderImpl::tryTakeMe
     return m_registry.tryTakeMessageForPort(port);
 }
 
+RefPtr<SerializedShapeDictionary> MessagePortChannelProviderImpl::shapeDictionaryForPort(const MessagePortIdentifier& port)
+{
+    return m_registry.shapeDictionaryForPort(port);
+}
+
+RefPtr<MessagePortChannel> MessagePortChannelProviderImpl::channelForPort(const MessagePortIdentifier& port)
+{
+    return m_registry.existingChannelContainingPort(port);
+}
+
 } // namespace WebCore
@@ -44,6 +44,8 @@ private:
     void postMessageToRemote(MessageWithMessagePorts&&, const MessagePortIdentifier& remoteTarget) final;
     void takeAllMessagesForPort(const MessagePortIdentifier&, CompletionHandler<void(Vector<MessageWithMessagePorts>&&, CompletionHandler<void()>&&)>&&) final;
     std::optional<MessageWithMessagePorts> tryTakeMessageForPort(const MessagePortIdentifier&) final;
+    RefPtr<SerializedShapeDictionary> shapeDictionaryForPort(const MessagePortIdentifier&) final;
+    RefPtr<MessagePortChannel> channelForPort(const MessagePortIdentifier&) final;
 
     MessagePortChannelRegistry m_registry;
 };
@@ -171,6 +171,15 @@ std::optional<MessageWithMessagePorts> MessagePortChannelRegistry::tryTakeMessag
     return channel->tryTakeMessageForPort(port);
 }
 
+RefPtr<SerializedShapeDictionary> MessagePortChannelRegistry::shapeDictionaryForPort(const MessagePortIdentifier& port)
+{
+    auto* channel = m_openChannels.get(port);
+    if (!channel)
+        return nullptr;
+
+    return &channel->shapeDictionary();
+}
+
 MessagePortChannel* MessagePortChannelRegistry::existingChannelContainingPort(const MessagePortIdentifier& port)
 {
     // ASSERT(isMainThread());
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "MemoryAccounting.h"
+#include "MessageWithMessagePorts.h"
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// The messages waiting for one end of a MessagePortChannel.
+//
+// Only the remote port ever appends and only the local port ever takes, so
+// this is a single-producer/single-consumer queue that needs no lock: an
+// unbounded list of fixed-size segments where the producer publishes each
+// slot with a release store of the segment's count, and the consumer frees a
+// segment once it has read all of it and the producer has moved on.
+//
+// append() also reports whether the consumer has to be woken up. It says so
+// for the first message after the consumer last started draining, and a
+// message appended before it finishes is either drained by it or wakes it
+// again, so a burst of messages costs a single wakeup.
+class MessagePortQueue {
+    WTF_MAKE_NONCOPYABLE(MessagePortQueue);
+    WTF_MAKE_FAST_ALLOCATED;
+
+public:
+    MessagePortQueue()
+        : m_head(new Segment)
+        , m_tail(m_head)
+    {
+    }
+
+    ~MessagePortQueue()
+    {
+        clear();
+        while (m_head) {
+            auto* next = m_head->next.load(std::memory_order_relaxed);
+            delete m_head;
+            m_head = next;
+        }
+    }
+
+    // Producer only. Returns true if the consumer needs to be woken up.
+    bool append(MessageWithMessagePorts&& message)
+    {
+        Bun::reportMemoryAllocated(Bun::MemorySubsystem::MessagePortMessages, memoryCost(message));
+        uint32_t written = m_tail->written.load(std::memory_order_relaxed);
+        if (written == segmentSize) {
+            auto* segment = new Segment;
+            segment->messages[0] = WTFMove(message);
+            segment->written.store(1, std::memory_order_relaxed);
+            m_tail->next.store(segment, std::memory_order_release);
+            m_tail = segment;
+        } else {
+            m_tail->messages[written] = WTFMove(message);
+            m_tail->written.store(written + 1, std::memory_order_release);
+        }
+
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in takeAll(): either the consumer sees this
+        // message or we see that it re-armed the wakeup.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !m_wakeupPending.exchange(true, std::memory_order_acq_rel);
+    }
+
+    // Consumer only.
+    std::optional<MessageWithMessagePorts> takeFirst()
+    {
+        while (true) {
+            if (m_head->read < m_head->written.load(std::memory_order_acquire)) {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                auto message = WTFMove(m_head->messages[m_head->read++]);
+                Bun::reportMemoryFreed(Bun::MemorySubsystem::MessagePortMessages, memoryCost(message));
+                return message;
+            }
+            if (m_head->read < segmentSize)
+                return std::nullopt;
+            auto* next = m_head->next.load(std::memory_order_acquire);
+            if (!next)
+                return std::nullopt;
+            delete std::exchange(m_head, next);
+        }
+    }
+
+    // Consumer only. Re-arms the wakeup before draining, see append().
+    Vector<MessageWithMessagePorts> takeAll()
+    {
+        m_wakeupPending.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        Vector<MessageWithMessagePorts> messages;
+        while (auto message = takeFirst())
+            messages.append(WTFMove(*message));
+        return messages;
+    }
+
+    // Consumer only.
+    void clear()
+    {
+        while (takeFirst()) { }
+    }
+
+    // Safe from any thread, but only a snapshot.
+    bool isEmpty() const { return !m_size.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t segmentSize = 32;
+
+    static size_t memoryCost(const MessageWithMessagePorts& message)
+    {
+        return message.message ? message.message->memoryCost() : 0;
+    }
+
+    struct Segment {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+        std::atomic<Segment*> next { nullptr };
+        std::atomic<uint32_t> written { 0 };
+        uint32_t read { 0 };
+        std::array<MessageWithMessagePorts, segmentSize> messages;
+    };
+
+    Segment* m_head; // Consumer side.
+    Segment* m_tail; // Producer side.
+    std::atomic<size_t> m_size { 0 };
+    std::atomic<bool> m_wakeupPending { false };
+};
+
+} // namespace WebCore
@@ -78,18 +78,67 @@ PerformanceUserTiming::PerformanceUserTiming(Performance& performance)
 {
 }
 
-static void clearPerformanceEntries(PerformanceEntryMap& map, const String& name)
+void PerformanceEntryBuffer::add(PerformanceEntry& entry)
 {
-    if (name.isNull())
-        map.clear();
-    else
-        map.remove(name);
+    while (m_ring.size() >= capacity) {
+        auto oldest = m_ring.takeFirst();
+        auto iterator = m_entriesByName.find(oldest.entry->name());
+        if (iterator == m_entriesByName.end() || iterator->value.first().sequence != oldest.sequence)
+            continue;
+        iterator->value.removeFirst();
+        if (iterator->value.isEmpty())
+            m_entriesByName.remove(iterator);
+    }
+
+    BufferedEntry buffered { m_nextSequence++, &entry };
+    m_entriesByName.ensure(entry.name(), [] { return Deque<BufferedEntry>(); }).iterator->value.append(buffered);
+    m_ring.append(WTFMove(buffered));
+}
+
+void PerformanceEntryBuffer::clear(const String& name)
+{
+    if (name.isNull()) {
+        m_ring.clear();
+        m_entriesByName.clear();
+    } else
+        m_entriesByName.remove(name);
+}
+
+bool PerformanceEntryBuffer::isBuffered(const BufferedEntry& buffered) const
+{
+    auto iterator = m_entriesByName.find(buffered.entry->name());
+    return iterator != m_entriesByName.end() && iterator->value.first().sequence <= buffered.sequence;
 }
 
-static void addPerformanceEntry(PerformanceEntryMap& map, const String& name, PerformanceEntry& entry)
+PerformanceEntry* PerformanceEntryBuffer::last(const String& name) const
 {
-    auto& performanceEntryList = map.ensure(name, [] { return Vector<RefPtr<PerformanceEntry>>(); }).iterator->value;
-    performanceEntryList.append(&entry);
+    auto iterator = m_entriesByName.find(name);
+    if (iterator == m_entriesByName.end())
+        return nullptr;
+    return iterator->value.last().entry.get();
+}
+
+Vector<RefPtr<PerformanceEntry>> PerformanceEntryBuffer::entries() const
+{
+    Vector<RefPtr<PerformanceEntry>> entries;
+    entries.reserveInitialCapacity(m_ring.size());
+    for (auto& buffered : m_ring) {
+        if (isBuffered(buffered))
+            entries.append(buffered.entry);
+    }
+    return entries;
+}
+
+Vector<RefPtr<PerformanceEntry>> PerformanceEntryBuffer::entries(const String& name) const
+{
+    Vector<RefPtr<PerformanceEntry>> entries;
+    auto iterator = m_entriesByName.find(name);
+    if (iterator == m_entriesByName.end())
+        return entries;
+    entries.reserveInitialCapacity(iterator->value.size());
+    for (auto& buffered : iterator->value)
+        entries.append(buffered.entry);
+    return entries;
 }
 
 ExceptionOr<Ref<PerformanceMark>> PerformanceUserTiming::mark(JSC::JSGlobalObject& globalObject, const String& markName, std::optional<PerformanceMarkOptions>&& markOptions)
@@ -106,15 +155,13 @@ ExceptionOr<Ref<PerformanceMark>> PerformanceUserTiming::mark(JSC::JSGlobalObjec
     if (mark.hasException())
         return mark.releaseException();
 
-    addPerformanceEntry(m_marksMap, markName, mark.returnValue().get());
-    m_markCounter += 1;
+    m_marks.add(mark.returnValue().get());
     return mark.releaseReturnValue();
 }
 
 void PerformanceUserTiming::clearMarks(const String& markName)
 {
-    clearPerformanceEntries(m_marksMap, markName);
-    m_markCounter = 0;
+    m_marks.clear(markName);
 }
 
 ExceptionOr<double> PerformanceUserTiming::convertMarkToTimestamp(const std::variant<String, double>& mark) const
@@ -145,9 +192,8 @@ ExceptionOr<double> PerformanceUserTiming::convertMarkToTimestamp(const String&
     //     }
     // }
 
-    auto iterator = m_marksMap.find(mark);
-    if (iterator != m_marksMap.end())
-        return iterator->value.last()->startTime();
+    if (auto* entry = m_marks.last(mark))
+        return entry->startTime();
 
     return Exception { SyntaxError, makeString("No mark named '", mark, "' exists") };
 }
@@ -183,8 +229,7 @@ ExceptionOr<Ref<PerformanceMeasure>> PerformanceUserTiming::measure(const String
     if (measure.hasException())
         return measure.releaseException();
 
-    addPerformanceEntry(m_measuresMap, measureName, measure.returnValue().get());
-    m_measureCounter += 1;
+    m_measures.add(measure.returnValue().get());
     return measure.releaseReturnValue();
 }
 
@@ -238,16 +283,14 @@ ExceptionOr<Ref<PerformanceMeasure>> PerformanceUserTiming::measure(JSC::JSGloba
         if (measure.hasException())
             return measure.releaseException();
 
-        addPerformanceEntry(m_measuresMap, measureName, measure.returnValue().get());
-        m_measureCounter += 1;
+        m_measures.add(measure.returnValue().get());
         return measure.releaseReturnValue();
     } else {
         auto measure = PerformanceMeasure::create(measureName, startTime, endTime, nullptr);
         if (measure.hasException())
             return measure.releaseException();
 
-        addPerformanceEntry(m_measuresMap, measureName, measure.returnValue().get());
-        m_measureCounter += 1;
+        m_measures.add(measure.returnValue().get());
         return measure.releaseReturnValue();
     }
 }
@@ -284,42 +327,27 @@ ExceptionOr<Ref<PerformanceMeasure>> PerformanceUserTiming::measure(JSC::JSGloba
 
 void PerformanceUserTiming::clearMeasures(const String& measureName)
 {
-    clearPerformanceEntries(m_measuresMap, measureName);
-    m_measureCounter = 0;
-}
-
-static Vector<RefPtr<PerformanceEntry>> convertToEntrySequence(const PerformanceEntryMap& map, int64_t initialCapacity)
-{
-    Vector<RefPtr<PerformanceEntry>> entries;
-    size_t safeInitialCapacity = initialCapacity > 0 && initialCapacity <= std::numeric_limits<int32_t>::max() ? static_cast<size_t>(initialCapacity) : 0;
-    if (safeInitialCapacity)
-        entries.reserveInitialCapacity(safeInitialCapacity);
-
-    for (auto& entry : map.values())
-        entries.appendVector(entry);
-
-    ASSERT(entries.size() <= safeInitialCapacity);
-    return entries;
+    m_measures.clear(measureName);
 }
 
 Vector<RefPtr<PerformanceEntry>> PerformanceUserTiming::getMarks() const
 {
-    return convertToEntrySequence(m_marksMap, m_markCounter);
+    return m_marks.entries();
 }
 
 Vector<RefPtr<PerformanceEntry>> PerformanceUserTiming::getMarks(const String& name) const
 {
-    return m_marksMap.get(name);
+    return m_marks.entries(name);
 }
 
 Vector<RefPtr<PerformanceEntry>> PerformanceUserTiming::getMeasures() const
 {
-    return convertToEntrySequence(m_measuresMap, m_measureCounter);
+    return m_measures.entries();
 }
 
 Vector<RefPtr<PerformanceEntry>> PerformanceUserTiming::getMeasures(const String& name) const
 {
-    return m_measuresMap.get(name);
+    return m_measures.entries(name);
 }
 
 } // namespace WebCore
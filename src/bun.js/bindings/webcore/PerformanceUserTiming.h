@@ -28,6 +28,7 @@
 #include "ExceptionOr.h"
 #include "PerformanceMark.h"
 #include "PerformanceMeasure.h"
+#include <wtf/Deque.h>
 #include <wtf/HashMap.h>
 #include <wtf/text/StringHash.h>
 
@@ -39,7 +40,37 @@ namespace WebCore {
 
 class Performance;
 
-using PerformanceEntryMap = HashMap<String, Vector<RefPtr<PerformanceEntry>>>;
+// Marks or measures, in the order they were made and by name.
+//
+// Instrumented servers mark every request and never clear them, so once
+// `capacity` entries are buffered each new one drops the oldest, like any
+// other trace ring buffer. Entries cleared by name stay in the ring until
+// they reach the front; an entry is still buffered while the oldest entry
+// left under its name is no newer than it.
+class PerformanceEntryBuffer {
+public:
+    static constexpr size_t capacity = 65536;
+
+    void add(PerformanceEntry&);
+    // A null name clears everything.
+    void clear(const String& name);
+
+    PerformanceEntry* last(const String& name) const;
+    Vector<RefPtr<PerformanceEntry>> entries() const;
+    Vector<RefPtr<PerformanceEntry>> entries(const String& name) const;
+
+private:
+    struct BufferedEntry {
+        uint64_t sequence;
+        RefPtr<PerformanceEntry> entry;
+    };
+
+    bool isBuffered(const BufferedEntry&) const;
+
+    Deque<BufferedEntry> m_ring;
+    HashMap<String, Deque<BufferedEntry>> m_entriesByName;
+    uint64_t m_nextSequence { 0 };
+};
 
 class PerformanceUserTiming {
     WTF_MAKE_FAST_ALLOCATED;
@@ -71,10 +102,8 @@ private:
     ExceptionOr<Ref<PerformanceMeasure>> measure(JSC::JSGlobalObject&, const String& measureName, const PerformanceMeasureOptions&);
 
     Performance& m_performance;
-    PerformanceEntryMap m_marksMap;
-    int64_t m_markCounter { 0 };
-    PerformanceEntryMap m_measuresMap;
-    int64_t m_measureCounter { 0 };
+    PerformanceEntryBuffer m_marks;
+    PerformanceEntryBuffer m_measures;
 };
 
 }
@@ -82,6 +82,7 @@
 #include <JavaScriptCore/JSDataView.h>
 #include <JavaScriptCore/JSMapInlines.h>
 #include <JavaScriptCore/JSMapIterator.h>
+#include <JavaScriptCore/JSNativeStdFunction.h>
 #include <JavaScriptCore/JSSetInlines.h>
 #include <JavaScriptCore/JSSetIterator.h>
 #include <JavaScriptCore/JSTypedArrays.h>
@@ -90,6 +91,7 @@
 #include <JavaScriptCore/NumberObject.h>
 #include <JavaScriptCore/ObjectConstructor.h>
 #include <JavaScriptCore/PropertyNameArray.h>
+#include <JavaScriptCore/ProxyObject.h>
 #include <JavaScriptCore/RegExp.h>
 #include <JavaScriptCore/RegExpObject.h>
 #include <JavaScriptCore/TypedArrayInlines.h>
@@ -105,7 +107,11 @@
 #include <wtf/threads/BinarySemaphore.h>
 
 #include "blob.h"
+#include "BunClientData.h"
+#include "JSSharedRing.h"
+#include "SerializedShapeDictionary.h"
 #include "ZigGeneratedClasses.h"
+#include "ZigGlobalObject.h"
 
 #if USE(CG)
 #include <CoreGraphics/CoreGraphics.h>
@@ -156,7 +162,9 @@ enum WalkerState { StateUnknown,
     MapDataEndVisitKey,
     MapDataEndVisitValue,
     SetDataStartVisitEntry,
-    SetDataEndVisitKey };
+    SetDataEndVisitKey,
+    SharedShapeObjectStartVisitMember,
+    SharedShapeObjectEndVisitMember };
 
 // These can't be reordered, and any new types must be added to the end of the list
 // When making changes to these lists please cover your new type(s) in the API test "IndexedDB.StructuredCloneBackwardCompatibility"
@@ -230,6 +238,13 @@ enum SerializationTag {
 #endif
     ResizableArrayBufferTag = 54,
     ErrorInstanceTag = 55,
+    SharedShapeDefinitionTag = 56,
+    SharedShapeObjectTag = 57,
+    SharedShapeHoleTag = 58,
+    DictionaryShapeObjectTag = 59,
+    SharedRingTag = 60,
+    SharedBlobTag = 61,
+    LazyValueTag = 62,
 
     Bun__BlobTag = 254,
     // bun types start at 254 and decrease with each addition
@@ -538,8 +553,13 @@ const uint8_t cryptoKeyOKPOpNameTagMaximumValue = 1;
  * Version 11. added support for Blob's memory cost.
  * Version 12. added support for agent cluster ID.
  * Version 13. added support for ErrorInstance objects.
+ * Version 14. added SharedShapeDefinitionTag and SharedShapeObjectTag for plain objects that share a Structure.
+ * Version 15. added DictionaryShapeObjectTag for shapes stored in a channel's SerializedShapeDictionary.
+ * Version 16. added SharedRingTag for Bun.SharedRing.
+ * Version 17. added SharedBlobTag for Blobs whose store is shared with the receiving thread.
+ * Version 18. added LazyValueTag for values decoded on first access.
  */
-[[maybe_unused]] static constexpr unsigned CurrentVersion = 13;
+[[maybe_unused]] static constexpr unsigned CurrentVersion = 18;
 [[maybe_unused]] static constexpr unsigned TerminatorTag = 0xFFFFFFFF;
 [[maybe_unused]] static constexpr unsigned StringPoolTag = 0xFFFFFFFE;
 [[maybe_unused]] static constexpr unsigned NonIndexPropertiesTag = 0xFFFFFFFD;
@@ -557,7 +577,7 @@ static constexpr unsigned StringDataIs8BitFlag = 0x80000000;
  * in the constant pool.
  *
  * SerializedValue :- <CurrentVersion:uint32_t> Value
- * Value :- Array | Object | Map | Set | Terminal
+ * Value :- Array | Object | SharedShapeObject | Map | Set | LazyValue | Terminal
  *
  * Array :-
  *     ArrayTag <length:uint32_t>(<index:uint32_t><value:Value>)* TerminatorTag
@@ -565,6 +585,13 @@ static constexpr unsigned StringDataIs8BitFlag = 0x80000000;
  * Object :-
  *     ObjectTag (<name:StringData><value:Value>)* TerminatorTag
  *
+ * SharedShapeObject :- (ordinary objects whose Structure holds all of their properties)
+ *     SharedShapeDefinitionTag <count:uint32_t> <name:StringData>{count} SharedShapeValues // Defines the next shape index
+ *   | SharedShapeObjectTag <shapeIndex:IndexType> SharedShapeValues
+ *   | DictionaryShapeObjectTag <dictionaryIndex:uint32_t> SharedShapeValues // Defines the next shape index with names from the SerializedShapeDictionary
+ *
+ * SharedShapeValues :- (<value:Value> | SharedShapeHoleTag){count} // A hole is a property deleted mid-serialization
+ *
  * Map :- MapObjectTag MapData
  *
  * Set :- SetObjectTag SetData
@@ -666,6 +693,15 @@ static constexpr unsigned StringDataIs8BitFlag = 0x80000000;
  *    ArrayBufferTransferTag <value:uint32_t>
  *    SharedArrayBufferTag <value:uint32_t>
  *
+ * SharedRing :-
+ *    SharedRingTag <sharedBufferIndex:uint32_t> // The ring's SharedArrayBuffer, shared like SharedArrayBufferTag
+ *
+ * SharedBlob :-
+ *    SharedBlobTag <sharedBlobIndex:uint32_t> // A Blob holding a reference to the sender's store
+ *
+ * LazyValue :-
+ *    LazyValueTag <isArray:uint8_t> <length:uint64_t> <value:SerializedValue{length}> // Decoded on first access; object references do not cross it
+ *
  * CryptoKeyHMAC :-
  *    <keySize:uint32_t> <keyData:byte{keySize}> CryptoAlgorithmIdentifierTag // Algorithm tag inner hash function.
  *
@@ -811,6 +847,10 @@ template<> bool writeLittleEndian<uint8_t>(Vector<uint8_t>& buffer, const uint8_
     return true;
 }
 
+// With SerializationLaziness::Lazy, arrays with at least this many elements
+// and plain objects with at least this many properties become LazyValues.
+static constexpr unsigned lazyValueThreshold = 1024;
+
 class CloneSerializer : CloneBase {
     WTF_FORBID_HEAP_ALLOCATION;
 
@@ -874,7 +914,7 @@ public:
         WasmMemoryHandleArray& wasmMemoryHandles,
 #endif
         Vector<uint8_t>& out, SerializationContext context, ArrayBufferContentsArray& sharedBuffers,
-        SerializationForStorage forStorage)
+        Vector<RefPtr<Blob>>& sharedBlobs, SerializationForStorage forStorage, SerializedShapeDictionary* shapeDictionary, SerializationLaziness laziness)
     {
         CloneSerializer serializer(lexicalGlobalObject, messagePorts, arrayBuffers,
 #if ENABLE(OFFSCREEN_CANVAS_IN_WORKERS)
@@ -891,7 +931,7 @@ public:
             wasmModules,
             wasmMemoryHandles,
 #endif
-            out, context, sharedBuffers, forStorage);
+            out, context, sharedBuffers, sharedBlobs, forStorage, shapeDictionary, laziness);
         return serializer.serialize(value);
     }
 
@@ -976,12 +1016,13 @@ private:
         WasmModuleArray& wasmModules,
         WasmMemoryHandleArray& wasmMemoryHandles,
 #endif
-        Vector<uint8_t>& out, SerializationContext context, ArrayBufferContentsArray& sharedBuffers, SerializationForStorage forStorage)
+        Vector<uint8_t>& out, SerializationContext context, ArrayBufferContentsArray& sharedBuffers, Vector<RefPtr<Blob>>& sharedBlobs, SerializationForStorage forStorage, SerializedShapeDictionary* shapeDictionary, SerializationLaziness laziness)
         : CloneBase(lexicalGlobalObject)
         , m_buffer(out)
         , m_emptyIdentifier(Identifier::fromString(lexicalGlobalObject->vm(), emptyString()))
         , m_context(context)
         , m_sharedBuffers(sharedBuffers)
+        , m_sharedBlobs(sharedBlobs)
 #if ENABLE(WEBASSEMBLY)
         , m_wasmModules(wasmModules)
         , m_wasmMemoryHandles(wasmMemoryHandles)
@@ -991,6 +1032,9 @@ private:
         , m_serializedVideoFrames(serializedVideoFrames)
 #endif
         , m_forStorage(forStorage)
+        , m_shapeDictionary(shapeDictionary)
+        // A lazy value is decoded after the transferred objects are gone.
+        , m_laziness(messagePorts.isEmpty() && arrayBuffers.isEmpty() ? laziness : SerializationLaziness::Eager)
     {
         write(CurrentVersion);
         fillTransferMap(messagePorts, m_transferredMessagePorts);
@@ -1093,6 +1137,67 @@ private:
         return true;
     }
 
+    static bool canUseSharedShape(JSObject* object)
+    {
+        if (object->classInfo() != JSFinalObject::info())
+            return false;
+        if (hasIndexedProperties(object->indexingType()))
+            return false;
+        // Dictionary Structures are mutated in place, so they don't pin down
+        // the property names.
+        return !object->structure()->isDictionary();
+    }
+
+    // Writes the shape header for `object` and returns its shape, or nullptr
+    // if the object was already serialized and a reference was written.
+    const SharedShape* startSharedShapeObject(JSObject* object)
+    {
+        if (!startObjectInternal(object))
+            return nullptr;
+
+        Structure* structure = object->structure();
+        auto found = m_sharedShapeIndices.find(structure);
+        if (found != m_sharedShapeIndices.end()) {
+            SharedShape& shape = *m_sharedShapes[found->value];
+            if (shape.owner->structure() == structure) {
+                write(SharedShapeObjectTag);
+                writeConstantPoolIndex(m_sharedShapes, shape.index);
+                return &shape;
+            }
+            m_sharedShapeIndices.remove(found);
+        }
+
+        PropertyNameArray properties(m_lexicalGlobalObject->vm(), PropertyNameMode::Strings, PrivateSymbolMode::Exclude);
+        object->methodTable()->getOwnPropertyNames(object, m_lexicalGlobalObject, properties, DontEnumPropertiesMode::Exclude);
+
+        auto shape = makeUnique<SharedShape>();
+        shape->index = m_sharedShapes.size();
+        shape->owner = object;
+        shape->names.reserveInitialCapacity(properties.size());
+        for (auto& name : properties)
+            shape->names.append(name);
+
+        // Either way this defines the next shape index, so later objects in
+        // this message refer to it with SharedShapeObjectTag.
+        std::optional<uint32_t> dictionaryIndex;
+        if (m_shapeDictionary)
+            dictionaryIndex = m_shapeDictionary->indexOf(shape->names.span());
+
+        if (dictionaryIndex) {
+            write(DictionaryShapeObjectTag);
+            write(*dictionaryIndex);
+        } else {
+            write(SharedShapeDefinitionTag);
+            write(static_cast<uint32_t>(shape->names.size()));
+            for (auto& name : shape->names)
+                write(name);
+        }
+
+        m_sharedShapeIndices.set(structure, shape->index);
+        m_sharedShapes.append(WTFMove(shape));
+        return m_sharedShapes.last().get();
+    }
+
     bool startArray(JSArray* array)
     {
         if (!startObjectInternal(array))
@@ -1122,6 +1227,86 @@ private:
         return true;
     }
 
+    // Writes a large array or plain object as a SerializedValue of its own,
+    // which the receiver decodes on first access. std::nullopt means it is
+    // small, or holds something that cannot outlive this message, and should
+    // be serialized in place.
+    std::optional<SerializationReturnCode> dumpLazily(JSObject* object)
+    {
+        bool objectIsArray = isArray(object);
+        unsigned size = 0;
+        if (objectIsArray)
+            size = asArray(object)->length();
+        else if (object->classInfo() == JSFinalObject::info())
+            size = object->structure()->inlineSize() + object->structure()->outOfLineSize();
+        if (size < lazyValueThreshold)
+            return std::nullopt;
+
+        if (checkForDuplicate(object))
+            return SerializationReturnCode::SuccessfullyCompleted;
+
+        size_t start = m_buffer.size();
+        write(LazyValueTag);
+        write(static_cast<uint8_t>(objectIsArray));
+        size_t lengthOffset = m_buffer.size();
+        write(static_cast<uint64_t>(0));
+
+        Vector<RefPtr<MessagePort>> messagePorts;
+        Vector<RefPtr<JSC::ArrayBuffer>> arrayBuffers;
+#if ENABLE(OFFSCREEN_CANVAS_IN_WORKERS)
+        Vector<RefPtr<OffscreenCanvas>> offscreenCanvases;
+#endif
+#if ENABLE(WEB_RTC)
+        Vector<Ref<RTCDataChannel>> rtcDataChannels;
+#endif
+#if ENABLE(WEB_CODECS)
+        Vector<RefPtr<WebCodecsEncodedVideoChunkStorage>> serializedVideoChunks;
+        Vector<RefPtr<WebCodecsVideoFrame>> serializedVideoFrames;
+#endif
+#if ENABLE(WEBASSEMBLY)
+        WasmModuleArray wasmModules;
+        WasmMemoryHandleArray wasmMemoryHandles;
+#endif
+        ArrayBufferContentsArray sharedBuffers;
+        Vector<RefPtr<Blob>> sharedBlobs;
+        auto code = serialize(m_lexicalGlobalObject, object, messagePorts, arrayBuffers,
+#if ENABLE(OFFSCREEN_CANVAS_IN_WORKERS)
+            offscreenCanvases,
+#endif
+#if ENABLE(WEB_RTC)
+            rtcDataChannels,
+#endif
+#if ENABLE(WEB_CODECS)
+            serializedVideoChunks,
+            serializedVideoFrames,
+#endif
+#if ENABLE(WEBASSEMBLY)
+            wasmModules,
+            wasmMemoryHandles,
+#endif
+            m_buffer, m_context, sharedBuffers, sharedBlobs, m_forStorage, nullptr, SerializationLaziness::Eager);
+        if (code != SerializationReturnCode::SuccessfullyCompleted)
+            return code;
+
+        bool holdsHandles = !sharedBuffers.isEmpty() || !sharedBlobs.isEmpty();
+#if ENABLE(WEBASSEMBLY)
+        holdsHandles |= !wasmModules.isEmpty() || !wasmMemoryHandles.isEmpty();
+#endif
+#if ENABLE(WEB_CODECS)
+        holdsHandles |= !serializedVideoChunks.isEmpty() || !serializedVideoFrames.isEmpty();
+#endif
+        if (holdsHandles) {
+            m_buffer.shrink(start);
+            return std::nullopt;
+        }
+
+        uint64_t length = m_buffer.size() - lengthOffset - sizeof(uint64_t);
+        for (unsigned i = 0; i < sizeof(length); ++i)
+            m_buffer[lengthOffset + i] = static_cast<uint8_t>(length >> (i * 8));
+        recordObject(object);
+        return SerializationReturnCode::SuccessfullyCompleted;
+    }
+
     void endObject()
     {
         write(TerminatorTag);
@@ -1608,6 +1793,19 @@ private:
             //     return true;
             // }
 
+            // Within the process, a Blob only needs another reference to its
+            // store (file or mmap'd region, or bytes) rather than a copy.
+            if (m_context == SerializationContext::WorkerPostMessage) {
+                if (auto* jsBlob = jsDynamicCast<JSBlob*>(obj)) {
+                    if (auto blob = Blob::createForThread(jsBlob->wrapped())) {
+                        write(SharedBlobTag);
+                        write(static_cast<uint32_t>(m_sharedBlobs.size()));
+                        m_sharedBlobs.append(WTFMove(blob));
+                        return true;
+                    }
+                }
+            }
+
             // write bun types
             if (auto _cloneable = StructuredCloneableSerialize::fromJS(value)) {
                 StructuredCloneableSerialize cloneable = WTFMove(_cloneable.value());
@@ -1711,6 +1909,23 @@ private:
                 writeNullableString(stack);
                 return true;
             }
+            if (auto* ring = jsDynamicCast<Bun::JSSharedRing*>(obj)) {
+                if (m_context != SerializationContext::WorkerPostMessage || !JSC::Options::useSharedArrayBuffer()) {
+                    code = SerializationReturnCode::DataCloneError;
+                    return true;
+                }
+                if (!startObjectInternal(obj)) // handle duplicates
+                    return true;
+                ArrayBufferContents contents;
+                if (!ring->impl()->shareWith(contents)) {
+                    code = SerializationReturnCode::DataCloneError;
+                    return true;
+                }
+                write(SharedRingTag);
+                write(static_cast<uint32_t>(m_sharedBuffers.size()));
+                m_sharedBuffers.append(WTFMove(contents));
+                return true;
+            }
             if (obj->inherits<JSMessagePort>()) {
                 auto index = m_transferredMessagePorts.find(obj);
                 if (index != m_transferredMessagePorts.end()) {
@@ -2393,6 +2608,18 @@ private:
 #endif
     // Vector<URLKeepingBlobAlive>& m_blobHandles;
     ObjectPool m_objectPool;
+    // Plain objects with the same Structure have the same property names in
+    // the same order, so the names are written once per Structure. `owner`
+    // is the first object seen with it; it is kept alive by m_gcBuffer, and
+    // while it still has this Structure the Structure pointer can't be reused.
+    struct SharedShape {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+        uint32_t index;
+        JSObject* owner;
+        Vector<Identifier> names;
+    };
+    HashMap<Structure*, uint32_t> m_sharedShapeIndices;
+    Vector<std::unique_ptr<SharedShape>> m_sharedShapes;
     ObjectPool m_transferredMessagePorts;
     ObjectPool m_transferredArrayBuffers;
     ObjectPool m_transferredImageBitmaps;
@@ -2409,6 +2636,7 @@ private:
     Identifier m_emptyIdentifier;
     SerializationContext m_context;
     ArrayBufferContentsArray& m_sharedBuffers;
+    Vector<RefPtr<Blob>>& m_sharedBlobs;
 #if ENABLE(WEBASSEMBLY)
     WasmModuleArray& m_wasmModules;
     WasmMemoryHandleArray& m_wasmMemoryHandles;
@@ -2418,6 +2646,8 @@ private:
     Vector<RefPtr<WebCodecsVideoFrame>>& m_serializedVideoFrames;
 #endif
     SerializationForStorage m_forStorage;
+    SerializedShapeDictionary* m_shapeDictionary;
+    SerializationLaziness m_laziness;
 };
 
 void SerializedScriptValue::writeBytesForBun(CloneSerializer* ctx, const uint8_t* data, uint32_t size)
@@ -2431,6 +2661,7 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
     Vector<uint32_t, 16> indexStack;
     Vector<uint32_t, 16> lengthStack;
     Vector<PropertyNameArray, 16> propertyStack;
+    Vector<const SharedShape*, 16> sharedShapeStack;
     Vector<JSObject*, 32> inputObjectStack;
     Vector<JSMapIterator*, 4> mapIteratorStack;
     Vector<JSSetIterator*, 4> setIteratorStack;
@@ -2508,6 +2739,17 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
             if (inputObjectStack.size() > maximumFilterRecursion)
                 return SerializationReturnCode::StackOverflowError;
             JSObject* inObject = asObject(inValue);
+            if (canUseSharedShape(inObject)) {
+                const SharedShape* shape = startSharedShapeObject(inObject);
+                if (UNLIKELY(scope.exception()))
+                    return SerializationReturnCode::ExistingExceptionError;
+                if (!shape)
+                    break;
+                inputObjectStack.append(inObject);
+                indexStack.append(0);
+                sharedShapeStack.append(shape);
+                goto sharedShapeObjectStartVisitMember;
+            }
             if (!startObject(inObject))
                 break;
             // At this point, all supported objects other than Object
@@ -2566,6 +2808,44 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
             indexStack.last()++;
             goto objectStartVisitMember;
         }
+        sharedShapeObjectStartVisitMember:
+        case SharedShapeObjectStartVisitMember: {
+            JSObject* object = inputObjectStack.last();
+            uint32_t index = indexStack.last();
+            const auto& names = sharedShapeStack.last()->names;
+            if (index == names.size()) {
+                inputObjectStack.removeLast();
+                indexStack.removeLast();
+                sharedShapeStack.removeLast();
+                break;
+            }
+            inValue = getProperty(object, names[index]);
+            if (UNLIKELY(scope.exception()))
+                return SerializationReturnCode::ExistingExceptionError;
+
+            if (!inValue) {
+                // Property was removed during serialisation
+                write(SharedShapeHoleTag);
+                indexStack.last()++;
+                goto sharedShapeObjectStartVisitMember;
+            }
+
+            auto terminalCode = SerializationReturnCode::SuccessfullyCompleted;
+            if (!dumpIfTerminal(inValue, terminalCode)) {
+                stateStack.append(SharedShapeObjectEndVisitMember);
+                goto stateUnknown;
+            }
+            if (terminalCode != SerializationReturnCode::SuccessfullyCompleted)
+                return terminalCode;
+            FALLTHROUGH;
+        }
+        case SharedShapeObjectEndVisitMember: {
+            if (UNLIKELY(scope.exception()))
+                return SerializationReturnCode::ExistingExceptionError;
+
+            indexStack.last()++;
+            goto sharedShapeObjectStartVisitMember;
+        }
         mapStartState : {
             ASSERT(inValue.isObject());
             if (inputObjectStack.size() > maximumFilterRecursion)
@@ -2659,6 +2939,14 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
                 break;
             }
 
+            if (m_laziness == SerializationLaziness::Lazy) {
+                if (auto lazyCode = dumpLazily(asObject(inValue))) {
+                    if (*lazyCode != SerializationReturnCode::SuccessfullyCompleted)
+                        return *lazyCode;
+                    break;
+                }
+            }
+
             if (isArray(inValue))
                 goto arrayStartState;
             if (isMap(inValue))
@@ -2680,6 +2968,171 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
     return SerializationReturnCode::SuccessfullyCompleted;
 }
 
+// The receiving end of a LazyValue. It is a Proxy over an empty array or
+// object; the first trap to run decodes the value into that target and
+// removes every trap from the handler, so later operations go straight to
+// the target.
+class LazyValue : public RefCounted<LazyValue> {
+public:
+    enum class Trap : uint8_t {
+        Get,
+        Set,
+        Has,
+        DeleteProperty,
+        OwnKeys,
+        GetOwnPropertyDescriptor,
+        DefineProperty,
+        PreventExtensions,
+    };
+    static constexpr std::array<ASCIILiteral, 8> trapNames { "get"_s, "set"_s, "has"_s, "deleteProperty"_s, "ownKeys"_s, "getOwnPropertyDescriptor"_s, "defineProperty"_s, "preventExtensions"_s };
+
+    static Ref<LazyValue> create(Ref<SerializedScriptValue>&& value) { return adoptRef(*new LazyValue(WTFMove(value))); }
+
+    EncodedJSValue performTrap(Trap, JSGlobalObject*, CallFrame*);
+
+private:
+    explicit LazyValue(Ref<SerializedScriptValue>&& value)
+        : m_value(WTFMove(value))
+    {
+    }
+
+    void materialize(JSGlobalObject*, JSObject* handler, JSObject* target);
+
+    // Null once decoded.
+    RefPtr<SerializedScriptValue> m_value;
+};
+
+void LazyValue::materialize(JSGlobalObject* globalObject, JSObject* handler, JSObject* target)
+{
+    if (!m_value)
+        return;
+
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    JSValue value = m_value->deserialize(*globalObject, globalObject);
+    RETURN_IF_EXCEPTION(scope, void());
+    JSObject* source = value.getObject();
+    if (UNLIKELY(!source || isJSArray(source) != isJSArray(target))) {
+        throwTypeError(globalObject, scope, "Cannot deserialize a lazily cloned value"_s);
+        return;
+    }
+    m_value = nullptr;
+
+    PropertyNameArray names(vm, PropertyNameMode::StringsAndSymbols, PrivateSymbolMode::Exclude);
+    if (auto* sourceArray = jsDynamicCast<JSArray*>(source)) {
+        unsigned length = sourceArray->length();
+        for (unsigned i = 0; i < length; ++i) {
+            JSValue element = sourceArray->getDirectIndex(globalObject, i);
+            RETURN_IF_EXCEPTION(scope, void());
+            if (!element)
+                continue;
+            target->putDirectIndex(globalObject, i, element);
+            RETURN_IF_EXCEPTION(scope, void());
+        }
+        jsCast<JSArray*>(target)->setLength(globalObject, length, true);
+        RETURN_IF_EXCEPTION(scope, void());
+        sourceArray->getOwnNonIndexPropertyNames(globalObject, names, DontEnumPropertiesMode::Exclude);
+    } else
+        source->methodTable()->getOwnPropertyNames(source, globalObject, names, DontEnumPropertiesMode::Exclude);
+    RETURN_IF_EXCEPTION(scope, void());
+
+    for (auto& name : names) {
+        JSValue propertyValue = source->get(globalObject, name);
+        RETURN_IF_EXCEPTION(scope, void());
+        target->putDirectMayBeIndex(globalObject, name, propertyValue);
+        RETURN_IF_EXCEPTION(scope, void());
+    }
+
+    for (auto trapName : trapNames) {
+        DeletePropertySlot slot;
+        JSObject::deleteProperty(handler, globalObject, Identifier::fromString(vm, trapName), slot);
+        RETURN_IF_EXCEPTION(scope, void());
+    }
+}
+
+EncodedJSValue LazyValue::performTrap(Trap trap, JSGlobalObject* globalObject, CallFrame* callFrame)
+{
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    JSObject* target = callFrame->argument(0).getObject();
+    JSObject* handler = callFrame->thisValue().getObject();
+    if (UNLIKELY(!target || !handler))
+        return throwVMTypeError(globalObject, scope);
+
+    materialize(globalObject, handler, target);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    // From here on, what Reflect[trap] would do.
+    switch (trap) {
+    case Trap::OwnKeys:
+        RELEASE_AND_RETURN(scope, JSValue::encode(ownPropertyKeys(globalObject, target, PropertyNameMode::StringsAndSymbols, DontEnumPropertiesMode::Include)));
+    case Trap::PreventExtensions:
+        RELEASE_AND_RETURN(scope, JSValue::encode(jsBoolean(target->methodTable()->preventExtensions(target, globalObject))));
+    default:
+        break;
+    }
+
+    auto propertyName = callFrame->argument(1).toPropertyKey(globalObject);
+    RETURN_IF_EXCEPTION(scope, {});
+
+    switch (trap) {
+    case Trap::Get: {
+        PropertySlot slot(callFrame->argument(2), PropertySlot::InternalMethodType::Get);
+        bool found = target->getPropertySlot(globalObject, propertyName, slot);
+        RETURN_IF_EXCEPTION(scope, {});
+        if (!found)
+            return JSValue::encode(jsUndefined());
+        RELEASE_AND_RETURN(scope, JSValue::encode(slot.getValue(globalObject, propertyName)));
+    }
+    case Trap::Set: {
+        PutPropertySlot slot(callFrame->argument(3), false);
+        RELEASE_AND_RETURN(scope, JSValue::encode(jsBoolean(target->methodTable()->put(target, globalObject, propertyName, callFrame->argument(2), slot))));
+    }
+    case Trap::Has:
+        RELEASE_AND_RETURN(scope, JSValue::encode(jsBoolean(target->hasProperty(globalObject, propertyName))));
+    case Trap::DeleteProperty: {
+        DeletePropertySlot slot;
+        RELEASE_AND_RETURN(scope, JSValue::encode(jsBoolean(target->methodTable()->deleteProperty(target, globalObject, propertyName, slot))));
+    }
+    case Trap::GetOwnPropertyDescriptor:
+        RELEASE_AND_RETURN(scope, JSValue::encode(objectConstructorGetOwnPropertyDescriptor(globalObject, target, propertyName)));
+    case Trap::DefineProperty: {
+        PropertyDescriptor descriptor;
+        toPropertyDescriptor(globalObject, callFrame->argument(2), descriptor);
+        RETURN_IF_EXCEPTION(scope, {});
+        RELEASE_AND_RETURN(scope, JSValue::encode(jsBoolean(target->methodTable()->defineOwnProperty(target, globalObject, propertyName, descriptor, false))));
+    }
+    case Trap::OwnKeys:
+    case Trap::PreventExtensions:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+static JSObject* createLazyValue(JSGlobalObject* globalObject, Ref<SerializedScriptValue>&& value, bool isArray)
+{
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    JSObject* target = isArray ? static_cast<JSObject*>(constructEmptyArray(globalObject, nullptr)) : constructEmptyObject(globalObject);
+    RETURN_IF_EXCEPTION(scope, nullptr);
+
+    // No prototype, so nothing on Object.prototype is taken for a trap once
+    // the traps are removed.
+    JSObject* handler = constructEmptyObject(vm, globalObject->nullPrototypeObjectStructure());
+    Ref lazyValue = LazyValue::create(WTFMove(value));
+    for (unsigned i = 0; i < LazyValue::trapNames.size(); ++i) {
+        auto trap = static_cast<LazyValue::Trap>(i);
+        auto name = LazyValue::trapNames[i];
+        handler->putDirect(vm, Identifier::fromString(vm, name),
+            JSNativeStdFunction::create(vm, globalObject, 0, name, [lazyValue = RefPtr { lazyValue.ptr() }, trap](JSGlobalObject* globalObject, CallFrame* callFrame) -> EncodedJSValue {
+                return lazyValue->performTrap(trap, globalObject, callFrame);
+            }),
+            0);
+    }
+
+    RELEASE_AND_RETURN(scope, ProxyObject::create(globalObject, target, handler));
+}
+
 class CloneDeserializer : CloneBase {
     WTF_FORBID_HEAP_ALLOCATION;
 
@@ -2763,7 +3216,7 @@ public:
         Vector<std::unique_ptr<DetachedRTCDataChannel>>&& detachedRTCDataChannels
 #endif
         ,
-        ArrayBufferContentsArray* arrayBufferContentsArray, const std::span<uint8_t>& buffer, const Vector<String>& blobURLs, const Vector<String> blobFilePaths, ArrayBufferContentsArray* sharedBuffers
+        ArrayBufferContentsArray* arrayBufferContentsArray, const std::span<uint8_t>& buffer, const Vector<String>& blobURLs, const Vector<String> blobFilePaths, ArrayBufferContentsArray* sharedBuffers, SerializedShapeDictionary* shapeDictionary, const Vector<RefPtr<Blob>>* sharedBlobs
 #if ENABLE(WEBASSEMBLY)
         ,
         WasmModuleArray* wasmModules, WasmMemoryHandleArray* wasmMemoryHandles
@@ -2796,6 +3249,8 @@ public:
         );
         if (!deserializer.isValid())
             return std::make_pair(JSValue(), SerializationReturnCode::ValidationError);
+        deserializer.m_shapeDictionary = shapeDictionary;
+        deserializer.m_sharedBlobs = sharedBlobs;
         return deserializer.deserialize();
     }
 
@@ -3363,6 +3818,54 @@ private:
         object->putDirectMayBeIndex(m_lexicalGlobalObject, property, value);
     }
 
+    // The Structure the last object of a dictionary shape was built with,
+    // if it can be reused for another object in this global object.
+    Structure* cachedStructureForSharedShape(uint32_t shapeIndex)
+    {
+        auto* cachedShape = m_cachedSharedShapes[shapeIndex].get();
+        if (!cachedShape)
+            return nullptr;
+        Structure* structure = cachedShape->structure.get();
+        if (!structure || structure->globalObject() != m_globalObject)
+            return nullptr;
+        return structure;
+    }
+
+    void putSharedShapeProperty(JSObject* object, uint32_t shapeIndex, uint32_t propertyIndex, JSValue value)
+    {
+        // A hole may have moved the object off the cached Structure.
+        if (Structure* structure = cachedStructureForSharedShape(shapeIndex); structure && object->structure() == structure) {
+            object->putDirectOffset(m_lexicalGlobalObject->vm(), m_cachedSharedShapes[shapeIndex]->offsets[propertyIndex], value);
+            return;
+        }
+        putProperty(object, m_sharedShapes[shapeIndex][propertyIndex], value);
+    }
+
+    void rememberStructureForSharedShape(uint32_t shapeIndex, JSObject* object)
+    {
+        auto* cachedShape = m_cachedSharedShapes[shapeIndex].get();
+        if (!cachedShape || cachedStructureForSharedShape(shapeIndex))
+            return;
+
+        // Only a Structure holding exactly these names, all inline, can be
+        // handed to JSFinalObject::create() without a butterfly.
+        VM& vm = m_lexicalGlobalObject->vm();
+        Structure* structure = object->structure();
+        if (structure->isDictionary() || structure->outOfLineCapacity() || structure->inlineSize() != cachedShape->names.size())
+            return;
+
+        Vector<PropertyOffset> offsets;
+        offsets.reserveInitialCapacity(cachedShape->names.size());
+        for (auto& name : cachedShape->names) {
+            PropertyOffset offset = structure->get(vm, name);
+            if (!isValidOffset(offset))
+                return;
+            offsets.append(offset);
+        }
+        cachedShape->offsets = WTFMove(offsets);
+        cachedShape->structure = Weak<Structure>(structure);
+    }
+
     // bool readFile(RefPtr<File>& file)
     // {
     //     CachedStringRef path;
@@ -4842,6 +5345,71 @@ private:
             m_gcBuffer.appendWithCrashOnOverflow(result);
             return result;
         }
+        case SharedRingTag: {
+            uint32_t index = UINT_MAX;
+            bool indexSuccessfullyRead = read(index);
+            if (!indexSuccessfullyRead || !m_sharedBuffers || index >= m_sharedBuffers->size() || !JSC::Options::useSharedArrayBuffer()) {
+                fail();
+                return JSValue();
+            }
+
+            RELEASE_ASSERT(m_sharedBuffers->at(index));
+            auto& vm = m_lexicalGlobalObject->vm();
+            auto* globalObject = jsDynamicCast<Zig::GlobalObject*>(m_globalObject);
+            if (!globalObject) {
+                fail();
+                return JSValue();
+            }
+            auto* buffer = JSArrayBuffer::create(vm, globalObject->arrayBufferStructure(ArrayBufferSharingMode::Shared), ArrayBuffer::create(WTFMove(m_sharedBuffers->at(index))));
+            auto* ring = Bun::JSSharedRing::tryCreateFromBuffer(vm, globalObject->JSSharedRingStructure(), buffer);
+            if (!ring) {
+                fail();
+                return JSValue();
+            }
+            m_gcBuffer.appendWithCrashOnOverflow(ring);
+            return ring;
+        }
+        case SharedBlobTag: {
+            uint32_t index = UINT_MAX;
+            bool indexSuccessfullyRead = read(index);
+            if (!indexSuccessfullyRead || !m_sharedBlobs || index >= m_sharedBlobs->size()) {
+                fail();
+                return JSValue();
+            }
+
+            // The same value can be deserialized more than once, so each
+            // Blob gets its own reference to the store.
+            void* impl = Blob__dupe(m_sharedBlobs->at(index)->impl());
+            if (!impl) {
+                fail();
+                return JSValue();
+            }
+            JSValue blob = JSValue::decode(Blob__create(m_lexicalGlobalObject, impl));
+            if (!blob.isCell()) {
+                fail();
+                return JSValue();
+            }
+            m_gcBuffer.appendWithCrashOnOverflow(blob);
+            return blob;
+        }
+        case LazyValueTag: {
+            uint8_t isArray;
+            uint64_t length;
+            if (!read(isArray) || !read(length) || length > static_cast<uint64_t>(m_end - m_ptr)) {
+                fail();
+                return JSValue();
+            }
+            // Copied out, as the message is freed once this returns.
+            auto value = SerializedScriptValue::createFromWireBytes(Vector<uint8_t>(std::span { m_ptr, static_cast<size_t>(length) }));
+            m_ptr += length;
+            JSObject* lazyValue = createLazyValue(m_lexicalGlobalObject, WTFMove(value), isArray);
+            if (!lazyValue) {
+                fail();
+                return JSValue();
+            }
+            m_gcBuffer.appendWithCrashOnOverflow(lazyValue);
+            return lazyValue;
+        }
         case ArrayBufferViewTag: {
             JSValue arrayBufferView;
             if (!readArrayBufferView(m_lexicalGlobalObject->vm(), arrayBufferView)) {
@@ -4937,6 +5505,11 @@ private:
     const uint8_t* const m_end;
     unsigned m_version;
     Vector<CachedString> m_constantPool;
+    Vector<Vector<Identifier>> m_sharedShapes;
+    // Parallel to m_sharedShapes; set for shapes that came from m_shapeDictionary.
+    Vector<RefPtr<SerializedShapeCache::Shape>> m_cachedSharedShapes;
+    SerializedShapeDictionary* m_shapeDictionary { nullptr };
+    const Vector<RefPtr<Blob>>* m_sharedBlobs { nullptr };
     // Vector<Ref<ImageData>> m_imageDataPool;
     const Vector<RefPtr<MessagePort>>& m_messagePorts;
     ArrayBufferContentsArray* m_arrayBufferContents;
@@ -4983,6 +5556,7 @@ DeserializationResult CloneDeserializer::deserialize()
     auto scope = DECLARE_THROW_SCOPE(vm);
 
     Vector<uint32_t, 16> indexStack;
+    Vector<uint32_t, 16> sharedShapeStack;
     Vector<Identifier, 16> propertyNameStack;
     MarkedVector<JSObject*, 32> outputObjectStack;
     MarkedVector<JSValue, 4> mapKeyStack;
@@ -5076,6 +5650,106 @@ DeserializationResult CloneDeserializer::deserialize()
             propertyNameStack.removeLast();
             goto objectStartVisitMember;
         }
+        sharedShapeDefinitionState : {
+            uint32_t count;
+            if (!read(count) || count > static_cast<size_t>(m_end - m_ptr)) {
+                fail();
+                goto error;
+            }
+            Vector<Identifier> names;
+            names.reserveInitialCapacity(count);
+            for (uint32_t i = 0; i < count; i++) {
+                CachedStringRef cachedString;
+                bool wasTerminator = false;
+                if (!readIdentifierData(vm, cachedString, wasTerminator)) {
+                    fail();
+                    goto error;
+                }
+                names.append(cachedString->identifier(vm));
+            }
+            sharedShapeStack.append(m_sharedShapes.size());
+            m_sharedShapes.append(WTFMove(names));
+            m_cachedSharedShapes.append(nullptr);
+            goto sharedShapeObjectStartState;
+        }
+        dictionaryShapeState : {
+            uint32_t dictionaryIndex;
+            if (!m_shapeDictionary || !read(dictionaryIndex)) {
+                fail();
+                goto error;
+            }
+            auto cachedShape = clientData(vm)->serializedShapeCache.shape(vm, *m_shapeDictionary, dictionaryIndex);
+            if (!cachedShape) {
+                fail();
+                goto error;
+            }
+            sharedShapeStack.append(m_sharedShapes.size());
+            m_sharedShapes.append(cachedShape->names);
+            m_cachedSharedShapes.append(WTFMove(cachedShape));
+            goto sharedShapeObjectStartState;
+        }
+        sharedShapeReferenceState : {
+            auto index = readConstantPoolIndex(m_sharedShapes);
+            if (!index || *index >= m_sharedShapes.size()) {
+                fail();
+                goto error;
+            }
+            sharedShapeStack.append(*index);
+        }
+        sharedShapeObjectStartState : {
+            if (outputObjectStack.size() > maximumFilterRecursion)
+                return std::make_pair(JSValue(), SerializationReturnCode::StackOverflowError);
+            size_t count = m_sharedShapes[sharedShapeStack.last()].size();
+            JSObject* outObject = nullptr;
+            if (Structure* structure = cachedStructureForSharedShape(sharedShapeStack.last())) {
+                // Start out with every property in place so the values can be
+                // stored straight into their slots.
+                outObject = JSFinalObject::create(vm, structure);
+                for (auto offset : m_cachedSharedShapes[sharedShapeStack.last()]->offsets)
+                    outObject->putDirectOffset(vm, offset, jsUndefined());
+            } else
+                outObject = constructEmptyObject(m_lexicalGlobalObject, m_globalObject->objectPrototype(), std::min<size_t>(count, JSFinalObject::maxInlineCapacity));
+            m_gcBuffer.appendWithCrashOnOverflow(outObject);
+            outputObjectStack.append(outObject);
+            indexStack.append(0);
+        }
+        sharedShapeObjectStartVisitMember:
+            FALLTHROUGH;
+        case SharedShapeObjectStartVisitMember: {
+            const auto& names = m_sharedShapes[sharedShapeStack.last()];
+            uint32_t index = indexStack.last();
+            if (index == names.size()) {
+                outValue = outputObjectStack.last();
+                rememberStructureForSharedShape(sharedShapeStack.last(), asObject(outValue));
+                outputObjectStack.removeLast();
+                indexStack.removeLast();
+                sharedShapeStack.removeLast();
+                break;
+            }
+
+            if (m_ptr < m_end && *m_ptr == SharedShapeHoleTag) {
+                m_ptr++;
+                // Only an object that started out on a cached Structure has it.
+                JSObject::deleteProperty(outputObjectStack.last(), m_lexicalGlobalObject, names[index]);
+                indexStack.last()++;
+                goto sharedShapeObjectStartVisitMember;
+            }
+
+            if (JSValue terminal = readTerminal()) {
+                putSharedShapeProperty(outputObjectStack.last(), sharedShapeStack.last(), index, terminal);
+                indexStack.last()++;
+                goto sharedShapeObjectStartVisitMember;
+            }
+            if (m_failed)
+                goto error;
+            stateStack.append(SharedShapeObjectEndVisitMember);
+            goto stateUnknown;
+        }
+        case SharedShapeObjectEndVisitMember: {
+            putSharedShapeProperty(outputObjectStack.last(), sharedShapeStack.last(), indexStack.last(), outValue);
+            indexStack.last()++;
+            goto sharedShapeObjectStartVisitMember;
+        }
         mapObjectStartState : {
             if (outputObjectStack.size() > maximumFilterRecursion)
                 return std::make_pair(JSValue(), SerializationReturnCode::StackOverflowError);
@@ -5140,6 +5814,12 @@ DeserializationResult CloneDeserializer::deserialize()
                 goto arrayStartState;
             if (tag == ObjectTag)
                 goto objectStartState;
+            if (tag == SharedShapeDefinitionTag)
+                goto sharedShapeDefinitionState;
+            if (tag == SharedShapeObjectTag)
+                goto sharedShapeReferenceState;
+            if (tag == DictionaryShapeObjectTag)
+                goto dictionaryShapeState;
             if (tag == MapObjectTag)
                 goto mapObjectStartState;
             if (tag == SetObjectTag)
@@ -5443,13 +6123,13 @@ RefPtr<SerializedScriptValue> SerializedScriptValue::create(JSC::JSGlobalObject&
 //     return create(globalObject, value, WTFMove(transferList), messagePorts, forStorage, SerializationErrorMode::NonThrowing, serializationContext);
 // }
 
-ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalObject& globalObject, JSValue value, Vector<JSC::Strong<JSC::JSObject>>&& transferList, Vector<RefPtr<MessagePort>>& messagePorts, SerializationForStorage forStorage, SerializationContext serializationContext)
+ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalObject& globalObject, JSValue value, Vector<JSC::Strong<JSC::JSObject>>&& transferList, Vector<RefPtr<MessagePort>>& messagePorts, SerializationForStorage forStorage, SerializationContext serializationContext, SerializedShapeDictionary* shapeDictionary, SerializationLaziness laziness)
 {
-    return create(globalObject, value, WTFMove(transferList), messagePorts, forStorage, SerializationErrorMode::Throwing, serializationContext);
+    return create(globalObject, value, WTFMove(transferList), messagePorts, forStorage, SerializationErrorMode::Throwing, serializationContext, shapeDictionary, laziness);
 }
 
 // ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalObject& lexicalGlobalObject, JSValue value, Vector<JSC::Strong<JSC::JSObject>>&& transferList, SerializationForStorage forStorage, SerializationErrorMode throwExceptions, SerializationContext context)
-ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalObject& lexicalGlobalObject, JSValue value, Vector<JSC::Strong<JSC::JSObject>>&& transferList, Vector<RefPtr<MessagePort>>& messagePorts, SerializationForStorage forStorage, SerializationErrorMode throwExceptions, SerializationContext context)
+ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalObject& lexicalGlobalObject, JSValue value, Vector<JSC::Strong<JSC::JSObject>>&& transferList, Vector<RefPtr<MessagePort>>& messagePorts, SerializationForStorage forStorage, SerializationErrorMode throwExceptions, SerializationContext context, SerializedShapeDictionary* shapeDictionary, SerializationLaziness laziness)
 {
     VM& vm = lexicalGlobalObject.vm();
     Vector<RefPtr<JSC::ArrayBuffer>> arrayBuffers;
@@ -5539,6 +6219,7 @@ ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalOb
     WasmMemoryHandleArray wasmMemoryHandles;
 #endif
     std::unique_ptr<ArrayBufferContentsArray> sharedBuffers = makeUnique<ArrayBufferContentsArray>();
+    Vector<RefPtr<Blob>> sharedBlobs;
 #if ENABLE(WEB_CODECS)
     Vector<RefPtr<WebCodecsEncodedVideoChunkStorage>> serializedVideoChunks;
     Vector<RefPtr<WebCodecsVideoFrame>> serializedVideoFrames;
@@ -5575,7 +6256,7 @@ ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalOb
         wasmModules,
         wasmMemoryHandles,
 #endif
-        buffer, context, *sharedBuffers, forStorage);
+        buffer, context, *sharedBuffers, sharedBlobs, forStorage, shapeDictionary, laziness);
 
     if (throwExceptions == SerializationErrorMode::Throwing)
         maybeThrowExceptionIfSerializationFailed(lexicalGlobalObject, code);
@@ -5626,7 +6307,7 @@ ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalOb
     //         WTFMove(serializedVideoChunks), WTFMove(serializedVideoFrameData)
     // #endif
     //             ));
-    return adoptRef(*new SerializedScriptValue(WTFMove(buffer), arrayBufferContentsArray.releaseReturnValue(), context == SerializationContext::WorkerPostMessage ? WTFMove(sharedBuffers) : nullptr
+    auto serializedValue = adoptRef(*new SerializedScriptValue(WTFMove(buffer), arrayBufferContentsArray.releaseReturnValue(), context == SerializationContext::WorkerPostMessage ? WTFMove(sharedBuffers) : nullptr
 #if ENABLE(OFFSCREEN_CANVAS_IN_WORKERS)
         ,
         WTFMove(detachedCanvases)
@@ -5644,6 +6325,24 @@ ExceptionOr<Ref<SerializedScriptValue>> SerializedScriptValue::create(JSGlobalOb
         WTFMove(serializedVideoChunks), WTFMove(serializedVideoFrameData)
 #endif
             ));
+    serializedValue->m_shapeDictionary = shapeDictionary;
+    serializedValue->m_sharedBlobs = WTFMove(sharedBlobs);
+    return serializedValue;
+}
+
+bool SerializedScriptValue::isProcessIndependent() const
+{
+    if (m_arrayBufferContentsArray && !m_arrayBufferContentsArray->isEmpty())
+        return false;
+    if (m_sharedBufferContentsArray && !m_sharedBufferContentsArray->isEmpty())
+        return false;
+#if ENABLE(WEBASSEMBLY)
+    if (m_wasmModulesArray && !m_wasmModulesArray->isEmpty())
+        return false;
+    if (m_wasmMemoryHandlesArray && !m_wasmMemoryHandlesArray->isEmpty())
+        return false;
+#endif
+    return m_sharedBlobs.isEmpty() && !m_shapeDictionary;
 }
 
 RefPtr<SerializedScriptValue> SerializedScriptValue::create(StringView string)
@@ -5721,7 +6420,7 @@ JSC::JSValue SerializedScriptValue::fromArrayBuffer(JSC::JSGlobalObject& domGlob
     auto size = std::min(arrayBuffer->byteLength(), maxByteLength);
     auto span = std::span<uint8_t> { data, size };
 
-    auto result = CloneDeserializer::deserialize(&domGlobal, globalObject, {}, nullptr, span, blobURLs, blobFiles, nullptr
+    auto result = CloneDeserializer::deserialize(&domGlobal, globalObject, {}, nullptr, span, blobURLs, blobFiles, nullptr, nullptr, nullptr
 #if ENABLE(WEBASSEMBLY)
         ,
         nullptr, nullptr
@@ -5777,7 +6476,7 @@ JSValue SerializedScriptValue::deserialize(JSGlobalObject& lexicalGlobalObject,
         WTFMove(m_detachedRTCDataChannels)
 #endif
             ,
-        m_arrayBufferContentsArray.get(), m_data, blobURLs, blobFilePaths, m_sharedBufferContentsArray.get()
+        m_arrayBufferContentsArray.get(), m_data, blobURLs, blobFilePaths, m_sharedBufferContentsArray.get(), m_shapeDictionary.get(), &m_sharedBlobs
 #if ENABLE(WEBASSEMBLY)
                                                                                ,
         m_wasmModulesArray.get(), m_wasmMemoryHandlesArray.get()
@@ -64,6 +64,8 @@ class MessagePort;
 // class ImageBitmapBacking;
 class CloneSerializer;
 class FragmentedSharedBuffer;
+class SerializedShapeDictionary;
+class Blob;
 enum class SerializationReturnCode;
 
 enum class SerializationErrorMode { NonThrowing,
@@ -73,6 +75,11 @@ enum class SerializationContext { Default,
     WindowPostMessage };
 enum class SerializationForStorage : bool { No,
     Yes };
+// Lazy turns large arrays and plain objects into Proxies that decode on first
+// access, for receivers that only read a part of a big message. Messages
+// with a transfer list are always eager.
+enum class SerializationLaziness : bool { Eager,
+    Lazy };
 
 using ArrayBufferContentsArray = Vector<JSC::ArrayBufferContents>;
 #if ENABLE(WEBASSEMBLY)
@@ -87,7 +94,9 @@ class SerializedScriptValue : public ThreadSafeRefCounted<SerializedScriptValue>
 public:
     static void writeBytesForBun(CloneSerializer*, const uint8_t*, uint32_t);
 
-    WEBCORE_EXPORT static ExceptionOr<Ref<SerializedScriptValue>> create(JSC::JSGlobalObject&, JSC::JSValue, Vector<JSC::Strong<JSC::JSObject>>&& transfer, Vector<RefPtr<MessagePort>>&, SerializationForStorage = SerializationForStorage::No, SerializationContext = SerializationContext::Default);
+    // With a `shapeDictionary`, plain objects' property names are written to
+    // it instead of into the message, see SerializedShapeDictionary.
+    WEBCORE_EXPORT static ExceptionOr<Ref<SerializedScriptValue>> create(JSC::JSGlobalObject&, JSC::JSValue, Vector<JSC::Strong<JSC::JSObject>>&& transfer, Vector<RefPtr<MessagePort>>&, SerializationForStorage = SerializationForStorage::No, SerializationContext = SerializationContext::Default, SerializedShapeDictionary* shapeDictionary = nullptr, SerializationLaziness = SerializationLaziness::Eager);
     // WEBCORE_EXPORT static ExceptionOr<Ref<SerializedScriptValue>> create(JSC::JSGlobalObject&, JSC::JSValue, Vector<JSC::Strong<JSC::JSObject>>&& transfer, SerializationForStorage = SerializationForStorage::No, SerializationContext = SerializationContext::Default);
 
     WEBCORE_EXPORT static RefPtr<SerializedScriptValue> create(JSC::JSGlobalObject&, JSC::JSValue, SerializationForStorage = SerializationForStorage::No, SerializationErrorMode = SerializationErrorMode::Throwing, SerializationContext = SerializationContext::Default);
@@ -126,6 +135,9 @@ public:
         return adoptRef(*new SerializedScriptValue(WTFMove(data)));
     }
     const Vector<uint8_t>& wireBytes() const { return m_data; }
+    // The wire bytes are all there is: nothing refers to memory, Blob stores
+    // or objects of this process, so they can be sent to another one.
+    bool isProcessIndependent() const;
 
     template<class Encoder> void encode(Encoder&) const;
     template<class Decoder> static RefPtr<SerializedScriptValue> decode(Decoder&);
@@ -146,7 +158,7 @@ private:
     //         Vector<RefPtr<WebCodecsEncodedVideoChunkStorage>>&& = {}, Vector<WebCodecsVideoFrameData>&& = {}
     // #endif
     //     );
-    static ExceptionOr<Ref<SerializedScriptValue>> create(JSC::JSGlobalObject&, JSC::JSValue, Vector<JSC::Strong<JSC::JSObject>>&& transfer, Vector<RefPtr<MessagePort>>&, SerializationForStorage, SerializationErrorMode, SerializationContext);
+    static ExceptionOr<Ref<SerializedScriptValue>> create(JSC::JSGlobalObject&, JSC::JSValue, Vector<JSC::Strong<JSC::JSObject>>&& transfer, Vector<RefPtr<MessagePort>>&, SerializationForStorage, SerializationErrorMode, SerializationContext, SerializedShapeDictionary* = nullptr, SerializationLaziness = SerializationLaziness::Eager);
     WEBCORE_EXPORT SerializedScriptValue(Vector<unsigned char>&&, std::unique_ptr<ArrayBufferContentsArray>&& = nullptr
 #if ENABLE(WEB_RTC)
         ,
@@ -216,6 +228,9 @@ private:
     Vector<WebCodecsVideoFrameData> m_serializedVideoFrames;
 #endif
     // Vector<URLKeepingBlobAlive> m_blobHandles;
+    RefPtr<SerializedShapeDictionary> m_shapeDictionary;
+    // Blobs posted to another thread, each holding a reference to its store.
+    Vector<RefPtr<Blob>> m_sharedBlobs;
     size_t m_memoryCost { 0 };
 };
 
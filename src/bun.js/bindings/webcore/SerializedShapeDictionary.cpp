@@ -0,0 +1,67 @@
+#include "config.h"
+#include "SerializedShapeDictionary.h"
+
+#include <JavaScriptCore/WeakInlines.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace WebCore {
+
+static std::atomic<uint64_t> s_lastShapeDictionaryIdentifier { 0 };
+
+SerializedShapeDictionary::SerializedShapeDictionary()
+    : m_identifier(++s_lastShapeDictionaryIdentifier)
+{
+}
+
+std::optional<uint32_t> SerializedShapeDictionary::indexOf(std::span<const JSC::Identifier> names)
+{
+    // Length-prefixing each name keeps ["ab", "c"] and ["a", "bc"] apart.
+    StringBuilder key;
+    for (auto& name : names) {
+        key.append(name.length());
+        key.append(':');
+        key.append(name.string());
+    }
+    String keyString = key.toString();
+
+    Locker locker { m_lock };
+    auto found = m_indices.find(keyString);
+    if (found != m_indices.end())
+        return found->value;
+    if (m_names.size() >= maximumShapeCount)
+        return std::nullopt;
+
+    uint32_t index = m_names.size();
+    m_names.append(WTF::map(names, [](auto& name) { return name.string().isolatedCopy(); }));
+    m_indices.add(WTFMove(keyString).isolatedCopy(), index);
+    return index;
+}
+
+std::optional<Vector<String>> SerializedShapeDictionary::namesAt(uint32_t index) const
+{
+    Locker locker { m_lock };
+    if (index >= m_names.size())
+        return std::nullopt;
+    return WTF::map(m_names[index], [](auto& name) { return name.isolatedCopy(); });
+}
+
+RefPtr<SerializedShapeCache::Shape> SerializedShapeCache::shape(JSC::VM& vm, SerializedShapeDictionary& dictionary, uint32_t index)
+{
+    auto key = std::make_pair(dictionary.identifier(), index);
+    if (auto shape = m_shapes.get(key))
+        return shape;
+
+    auto names = dictionary.namesAt(index);
+    if (!names)
+        return nullptr;
+
+    auto shape = adoptRef(*new Shape);
+    shape->names = WTF::map(*names, [&](auto& name) { return JSC::Identifier::fromString(vm, name); });
+
+    if (m_shapes.size() >= maximumCachedShapes)
+        m_shapes.clear();
+    m_shapes.add(key, shape.copyRef());
+    return shape;
+}
+
+} // namespace WebCore
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "root.h"
+#include <JavaScriptCore/Identifier.h>
+#include <JavaScriptCore/PropertyOffset.h>
+#include <JavaScriptCore/Weak.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/RefCounted.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// Property name lists shared by every message sent over one
+// MessagePortChannel once shared shapes are enabled on it.
+//
+// A plain object's names go into the dictionary the first time a message
+// uses them and later messages refer to them by index, so a stream of
+// same-shaped messages carries only values. Entries are never removed or
+// changed, and a sender adds an entry before the message naming it is
+// posted, so either end can look up any index it reads without the two
+// sides having to agree on the order messages are deserialized in.
+class SerializedShapeDictionary : public ThreadSafeRefCounted<SerializedShapeDictionary> {
+public:
+    // Past this, new shapes are written into each message again.
+    static constexpr size_t maximumShapeCount = 4096;
+
+    static Ref<SerializedShapeDictionary> create() { return adoptRef(*new SerializedShapeDictionary); }
+
+    uint64_t identifier() const { return m_identifier; }
+
+    // The index of `names`, adding them if they are new and there is room.
+    std::optional<uint32_t> indexOf(std::span<const JSC::Identifier> names);
+
+    // A copy of the names at `index` that the calling thread can own.
+    std::optional<Vector<String>> namesAt(uint32_t index) const;
+
+private:
+    SerializedShapeDictionary();
+
+    const uint64_t m_identifier;
+    mutable Lock m_lock;
+    HashMap<String, uint32_t> m_indices WTF_GUARDED_BY_LOCK(m_lock);
+    Vector<Vector<String>> m_names WTF_GUARDED_BY_LOCK(m_lock);
+};
+
+// What the receiving VM keeps for each dictionary shape: its names as
+// Identifiers, and the Structure the last object built with it ended up
+// with. Later objects of that shape start out with the Structure and have
+// their values stored at its offsets, skipping the transition lookups.
+class SerializedShapeCache {
+    WTF_MAKE_NONCOPYABLE(SerializedShapeCache);
+
+public:
+    struct Shape : RefCounted<Shape> {
+        Vector<JSC::Identifier> names;
+        JSC::Weak<JSC::Structure> structure;
+        Vector<JSC::PropertyOffset> offsets;
+    };
+
+    SerializedShapeCache() = default;
+
+    RefPtr<Shape> shape(JSC::VM&, SerializedShapeDictionary&, uint32_t index);
+
+private:
+    // Forgets everything once this many shapes are cached, which bounds
+    // the memory held for channels that have since gone away.
+    static constexpr size_t maximumCachedShapes = 4 * SerializedShapeDictionary::maximumShapeCount;
+
+    HashMap<std::pair<uint64_t, uint32_t>, RefPtr<Shape>> m_shapes;
+};
+
+} // namespace WebCore
@@ -39,6 +39,9 @@ struct StructuredSerializeOptions {
     }
 
     Vector<JSC::Strong<JSC::JSObject>> transfer;
+    // Bun extension: decode large arrays and objects on first access, see
+    // SerializationLaziness.
+    bool lazy { false };
 };
 
 } // namespace WebCore
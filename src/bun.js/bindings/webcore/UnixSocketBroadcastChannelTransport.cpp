@@ -0,0 +1,252 @@
+#include "config.h"
+#include "UnixSocketBroadcastChannelTransport.h"
+
+#include "BunBroadcastChannelRegistry.h"
+#include "ScriptExecutionContext.h"
+#include "SerializedScriptValue.h"
+#include <wtf/Threading.h>
+
+#if !OS(WINDOWS)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace WebCore {
+
+// Datagram: <magic:uint32_t> followed by one or more
+//     <nameLength:uint32_t> <name:UTF-8> <messageLength:uint32_t> <message:wire bytes>
+// in host byte order, as both ends are on the same host.
+static constexpr uint32_t batchMagic = 0x31484342; // "BCH1"
+static constexpr Seconds peerRescanInterval = 1_s;
+
+#if OS(WINDOWS)
+
+RefPtr<UnixSocketBroadcastChannelTransport> UnixSocketBroadcastChannelTransport::create(const String&)
+{
+    // No SOCK_DGRAM for AF_UNIX on Windows.
+    return nullptr;
+}
+
+UnixSocketBroadcastChannelTransport::UnixSocketBroadcastChannelTransport(const String& directory, int fd, String&& ownPath)
+    : m_directory(directory)
+    , m_fd(fd)
+    , m_ownPath(WTFMove(ownPath))
+{
+}
+
+void UnixSocketBroadcastChannelTransport::send(const String&, const Vector<uint8_t>&) { }
+void UnixSocketBroadcastChannelTransport::flush() { }
+void UnixSocketBroadcastChannelTransport::refreshPeers() { }
+void UnixSocketBroadcastChannelTransport::sendToPeers(const Vector<uint8_t>&) { }
+void UnixSocketBroadcastChannelTransport::receiveLoop() { }
+
+#else
+
+static bool fillAddress(sockaddr_un& address, const CString& path)
+{
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(address.sun_path))
+        return false;
+    memcpy(address.sun_path, path.data(), path.length());
+    return true;
+}
+
+RefPtr<UnixSocketBroadcastChannelTransport> UnixSocketBroadcastChannelTransport::create(const String& directory)
+{
+    if (directory.isEmpty())
+        return nullptr;
+
+    auto ownPath = makeString(directory, directory.endsWith('/') ? ""_s : "/"_s, getpid(), ".sock"_s);
+    auto ownPathUTF8 = ownPath.utf8();
+    sockaddr_un address;
+    if (!fillAddress(address, ownPathUTF8))
+        return nullptr;
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return nullptr;
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // A socket left behind by an earlier process with the same pid.
+    unlink(ownPathUTF8.data());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // Raise both buffers so batches fit; the kernel caps this at
+    // net.core.{w,r}mem_max.
+    int bufferSize = 4 * maximumMessageSize;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    Ref transport = adoptRef(*new UnixSocketBroadcastChannelTransport(directory.isolatedCopy(), fd, WTFMove(ownPath)));
+    // The thread keeps the transport alive; it lives as long as the process.
+    Thread::create("BroadcastChannel receiver"_s, [transport = transport.copyRef()] {
+        transport->receiveLoop();
+    })->detach();
+    return transport;
+}
+
+UnixSocketBroadcastChannelTransport::UnixSocketBroadcastChannelTransport(const String& directory, int fd, String&& ownPath)
+    : m_directory(directory)
+    , m_fd(fd)
+    , m_ownPath(WTFMove(ownPath))
+{
+}
+
+static void appendUInt32(Vector<uint8_t>& buffer, uint32_t value)
+{
+    buffer.append(std::span { reinterpret_cast<const uint8_t*>(&value), sizeof(value) });
+}
+
+void UnixSocketBroadcastChannelTransport::send(const String& name, const Vector<uint8_t>& wireBytes)
+{
+    auto nameUTF8 = name.utf8();
+    size_t frameSize = 2 * sizeof(uint32_t) + nameUTF8.length() + wireBytes.size();
+    if (frameSize + sizeof(uint32_t) > maximumMessageSize)
+        return;
+
+    if (m_pending.size() + frameSize > maximumMessageSize)
+        flush();
+
+    if (m_pending.isEmpty())
+        appendUInt32(m_pending, batchMagic);
+    appendUInt32(m_pending, nameUTF8.length());
+    m_pending.append(std::span { reinterpret_cast<const uint8_t*>(nameUTF8.data()), nameUTF8.length() });
+    appendUInt32(m_pending, wireBytes.size());
+    m_pending.appendVector(wireBytes);
+
+    if (m_pending.size() >= batchFlushSize) {
+        flush();
+        return;
+    }
+
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        ScriptExecutionContext::ensureOnMainThread([protectedThis = Ref { *this }](auto&) {
+            protectedThis->m_flushScheduled = false;
+            protectedThis->flush();
+        });
+    }
+}
+
+void UnixSocketBroadcastChannelTransport::flush()
+{
+    if (m_pending.isEmpty())
+        return;
+
+    auto datagram = std::exchange(m_pending, {});
+    if (m_peers.isEmpty() || MonotonicTime::now() - m_lastPeerScan >= peerRescanInterval)
+        refreshPeers();
+    sendToPeers(datagram);
+}
+
+void UnixSocketBroadcastChannelTransport::refreshPeers()
+{
+    m_lastPeerScan = MonotonicTime::now();
+    m_peers.clear();
+
+    auto directoryUTF8 = m_directory.utf8();
+    DIR* directory = opendir(directoryUTF8.data());
+    if (!directory)
+        return;
+
+    while (auto* entry = readdir(directory)) {
+        auto fileName = String::fromUTF8(entry->d_name);
+        if (!fileName.endsWith(".sock"_s))
+            continue;
+        auto path = makeString(m_directory, m_directory.endsWith('/') ? ""_s : "/"_s, fileName);
+        if (path != m_ownPath)
+            m_peers.append(WTFMove(path));
+    }
+    closedir(directory);
+}
+
+void UnixSocketBroadcastChannelTransport::sendToPeers(const Vector<uint8_t>& datagram)
+{
+    m_peers.removeAllMatching([&](const String& peer) {
+        auto peerUTF8 = peer.utf8();
+        sockaddr_un address;
+        if (!fillAddress(address, peerUTF8))
+            return true;
+
+        ssize_t sent;
+        do {
+            sent = sendto(m_fd, datagram.data(), datagram.size(), MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        } while (sent < 0 && errno == EINTR);
+
+        if (sent >= 0)
+            return false;
+
+        switch (errno) {
+        case ECONNREFUSED:
+            // Its process is gone.
+            unlink(peerUTF8.data());
+            return true;
+        case ENOENT:
+            return true;
+        default:
+            // EAGAIN: its queue is full, so it misses this batch.
+            return false;
+        }
+    });
+}
+
+void UnixSocketBroadcastChannelTransport::receiveLoop()
+{
+    Vector<uint8_t> buffer(maximumMessageSize);
+
+    while (true) {
+        ssize_t received = recv(m_fd, buffer.data(), buffer.size(), 0);
+        if (received < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        std::span<const uint8_t> remaining { buffer.data(), static_cast<size_t>(received) };
+        auto readUInt32 = [&](uint32_t& value) {
+            if (remaining.size() < sizeof(value))
+                return false;
+            memcpy(&value, remaining.data(), sizeof(value));
+            remaining = remaining.subspan(sizeof(value));
+            return true;
+        };
+
+        uint32_t magic;
+        if (!readUInt32(magic) || magic != batchMagic)
+            continue;
+
+        Vector<std::pair<String, Ref<SerializedScriptValue>>> messages;
+        while (!remaining.empty()) {
+            uint32_t nameLength, messageLength;
+            if (!readUInt32(nameLength) || remaining.size() < nameLength)
+                break;
+            auto name = String::fromUTF8(remaining.first(nameLength));
+            remaining = remaining.subspan(nameLength);
+            if (!readUInt32(messageLength) || remaining.size() < messageLength)
+                break;
+            messages.append({ WTFMove(name), SerializedScriptValue::createFromWireBytes(Vector<uint8_t>(remaining.first(messageLength))) });
+            remaining = remaining.subspan(messageLength);
+        }
+
+        if (messages.isEmpty())
+            continue;
+
+        ScriptExecutionContext::ensureOnMainThread([messages = WTFMove(messages)](ScriptExecutionContext& context) mutable {
+            auto& registry = context.broadcastChannelRegistry();
+            for (auto& [name, message] : messages)
+                registry.didReceiveRemoteMessage(name, WTFMove(message));
+        });
+    }
+}
+
+#endif
+
+} // namespace WebCore
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BroadcastChannelTransport.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// A BroadcastChannelTransport over Unix datagram sockets. Every process
+// that shares the same directory binds `<directory>/<pid>.sock` there and
+// sends each batch to every other socket it finds, so joining is just
+// starting with the same BUN_BROADCAST_CHANNEL_DIR.
+//
+// Messages posted in one turn of the event loop go out as one datagram per
+// peer. A peer whose queue is full misses the batch; a socket nobody is
+// listening on any more is removed.
+class UnixSocketBroadcastChannelTransport final : public BroadcastChannelTransport {
+public:
+    // Null if the socket cannot be set up, e.g. the directory is missing.
+    static RefPtr<UnixSocketBroadcastChannelTransport> create(const String& directory);
+
+    void send(const String& name, const Vector<uint8_t>& wireBytes) final;
+
+    // Larger messages stay in this process. The kernel caps a datagram at
+    // roughly the socket's send buffer, which net.core.wmem_max limits to
+    // about 200 KiB by default.
+    static constexpr size_t maximumMessageSize = 128 * 1024;
+    // A batch is sent early once it grows past this.
+    static constexpr size_t batchFlushSize = 32 * 1024;
+
+private:
+    UnixSocketBroadcastChannelTransport(const String& directory, int fd, String&& ownPath);
+
+    void flush();
+    void refreshPeers();
+    void sendToPeers(const Vector<uint8_t>& datagram);
+    void receiveLoop();
+
+    const String m_directory;
+    const int m_fd;
+    const String m_ownPath;
+
+    // Main thread only.
+    Vector<uint8_t> m_pending;
+    bool m_flushScheduled { false };
+    Vector<String> m_peers;
+    MonotonicTime m_lastPeerScan;
+};
+
+} // namespace WebCore
@@ -71,6 +71,14 @@
 
 #include "JSBuffer.h"
 #include "ErrorEvent.h"
+#include "JSDOMConvertBufferSource.h"
+#include "JSDOMPromiseDeferred.h"
+#include "ReadableStream.h"
+#include "ReadableStreamSource.h"
+#include "WritableStream.h"
+#include "WritableStreamSink.h"
+
+#include <bun-uws/src/WebSocketExtensions.h>
 
 // #if USE(WEB_THREAD)
 // #include "WebCoreThreadRun.h"
@@ -152,6 +160,122 @@ static unsigned saturateAdd(unsigned a, unsigned b)
     return a + b;
 }
 
+// Feeds ws.readable, the controller only pulls while the queue is below its high-water mark so a
+// message arriving without a pending pull means the consumer is behind and the socket is paused
+class WebSocketReadableStreamSource final : public ReadableStreamSource {
+public:
+    static Ref<WebSocketReadableStreamSource> create(WebSocket& webSocket) { return adoptRef(*new WebSocketReadableStreamSource(webSocket)); }
+
+    void enqueue(JSC::JSValue value)
+    {
+        if (m_isCancelled || !hasController())
+            return;
+        controller().enqueue(value);
+        if (isPulling())
+            pullFinished();
+        else if (m_webSocket)
+            m_webSocket->pauseReading();
+    }
+
+    void close(bool wasClean)
+    {
+        if (m_isCancelled || !hasController())
+            return;
+        m_isCancelled = true;
+        if (isPulling())
+            pullFinished();
+        if (wasClean)
+            controller().close();
+        else
+            controller().error(Exception { NetworkError, "WebSocket connection closed abnormally"_s });
+    }
+
+    void detach() { m_webSocket = nullptr; }
+
+private:
+    explicit WebSocketReadableStreamSource(WebSocket& webSocket)
+        : m_webSocket(&webSocket)
+    {
+    }
+
+    void setActive() final {}
+    void setInactive() final {}
+    void doStart() final { startFinished(); }
+    void doPull() final
+    {
+        if (m_webSocket)
+            m_webSocket->resumeReading();
+    }
+    void doCancel() final
+    {
+        m_isCancelled = true;
+        if (m_webSocket)
+            m_webSocket->close(std::nullopt, String());
+    }
+
+    WebSocket* m_webSocket;
+    bool m_isCancelled { false };
+};
+
+// Backs ws.writable, each chunk is sent as one message
+class WebSocketWritableStreamSink final : public WritableStreamSink {
+public:
+    static Ref<WebSocketWritableStreamSink> create(WebSocket& webSocket) { return adoptRef(*new WebSocketWritableStreamSink(webSocket)); }
+
+    void detach() { m_webSocket = nullptr; }
+
+private:
+    explicit WebSocketWritableStreamSink(WebSocket& webSocket)
+        : m_webSocket(&webSocket)
+    {
+    }
+
+    void write(ScriptExecutionContext& context, JSC::JSValue value, DOMPromiseDeferred<void>&& promise) final
+    {
+        if (!m_webSocket) {
+            promise.reject(Exception { InvalidStateError, "WebSocket is closed"_s });
+            return;
+        }
+
+        auto* globalObject = context.jsGlobalObject();
+        auto& vm = globalObject->vm();
+        if (value.isString()) {
+            auto scope = DECLARE_CATCH_SCOPE(vm);
+            auto string = value.toWTFString(globalObject);
+            if (UNLIKELY(scope.exception())) {
+                scope.clearExceptionExceptTermination();
+                promise.reject(Exception { ExistingExceptionError });
+                return;
+            }
+            promise.settle(m_webSocket->send(string));
+            return;
+        }
+        if (auto buffer = toUnsharedArrayBuffer(vm, value)) {
+            promise.settle(m_webSocket->send(*buffer));
+            return;
+        }
+        if (auto view = toUnsharedArrayBufferView(vm, value)) {
+            promise.settle(m_webSocket->send(*view));
+            return;
+        }
+        promise.reject(Exception { TypeError, "Expected a string, ArrayBuffer or ArrayBufferView"_s });
+    }
+
+    void close() final
+    {
+        if (m_webSocket)
+            m_webSocket->close(std::nullopt, String());
+    }
+
+    void error(String&&) final
+    {
+        if (m_webSocket)
+            m_webSocket->close(std::nullopt, String());
+    }
+
+    WebSocket* m_webSocket;
+};
+
 ASCIILiteral WebSocket::subprotocolSeparator()
 {
     return ", "_s;
@@ -169,6 +293,11 @@ WebSocket::WebSocket(ScriptExecutionContext& context)
 
 WebSocket::~WebSocket()
 {
+    if (m_readableSource)
+        m_readableSource->detach();
+    if (m_writableSink)
+        m_writableSink->detach();
+
     if (m_upgradeClient != nullptr) {
         void* upgradeClient = m_upgradeClient;
         if (m_isSecure) {
@@ -228,12 +357,18 @@ ExceptionOr<Ref<WebSocket>> WebSocket::create(ScriptExecutionContext& context, c
     return socket;
 }
 ExceptionOr<Ref<WebSocket>> WebSocket::create(ScriptExecutionContext& context, const String& url, const Vector<String>& protocols, std::optional<FetchHeaders::Init>&& headers, bool rejectUnauthorized)
+{
+    return create(context, url, protocols, WTFMove(headers), std::optional<bool> { rejectUnauthorized }, PerMessageDeflate::Disabled);
+}
+ExceptionOr<Ref<WebSocket>> WebSocket::create(ScriptExecutionContext& context, const String& url, const Vector<String>& protocols, std::optional<FetchHeaders::Init>&& headers, std::optional<bool> rejectUnauthorized, PerMessageDeflate perMessageDeflate)
 {
     if (url.isNull())
         return Exception { SyntaxError };
 
     auto socket = adoptRef(*new WebSocket(context));
-    socket->setRejectUnauthorized(rejectUnauthorized);
+    if (rejectUnauthorized.has_value())
+        socket->setRejectUnauthorized(rejectUnauthorized.value());
+    socket->m_perMessageDeflate = perMessageDeflate;
     // socket->suspendIfNeeded();
 
     auto result = socket->connect(url, protocols, WTFMove(headers));
@@ -410,6 +545,16 @@ ExceptionOr<void> WebSocket::connect(const String& url, const Vector<String>& pr
         headerValues.unsafeAppendWithoutCapacityCheck(Zig::toZigString(value->value));
     }
 
+    // An explicit Sec-WebSocket-Extensions header wins over our own offer
+    String extensionsName = "Sec-WebSocket-Extensions"_s;
+    String extensionsOffer;
+    if (m_perMessageDeflate != PerMessageDeflate::Disabled && !headers.get().fastHas(HTTPHeaderName::SecWebSocketExtensions)) {
+        // The offer is a literal, so it is null terminated
+        extensionsOffer = String::fromLatin1(uWS::clientCompressionOffer(m_perMessageDeflate == PerMessageDeflate::ContextTakeover).data());
+        headerNames.append(Zig::toZigString(extensionsName));
+        headerValues.append(Zig::toZigString(extensionsOffer));
+    }
+
     m_isSecure = is_secure;
     this->incPendingActivityCount();
 
@@ -887,6 +1032,85 @@ String WebSocket::protocol() const
     return m_subprotocol;
 }
 
+void WebSocket::cork()
+{
+    if (m_corkDepth++ || m_connectedWebSocketKind == ConnectedWebSocketKind::None)
+        return;
+    us_socket_descriptor_cork(m_socketDescriptor, 1);
+}
+
+void WebSocket::uncork()
+{
+    ASSERT(m_corkDepth > 0);
+    // A socket closed meanwhile flushes by itself, and its descriptor may be reused already
+    if (--m_corkDepth || m_connectedWebSocketKind == ConnectedWebSocketKind::None)
+        return;
+    us_socket_descriptor_cork(m_socketDescriptor, 0);
+}
+
+ExceptionOr<ReadableStream&> WebSocket::readable(JSDOMGlobalObject& globalObject)
+{
+    if (!m_readable) {
+        auto source = WebSocketReadableStreamSource::create(*this);
+        auto stream = ReadableStream::create(globalObject, source.copyRef());
+        if (stream.hasException())
+            return stream.releaseException();
+        m_readableSource = WTFMove(source);
+        m_readable = stream.releaseReturnValue();
+        if (m_state == CLOSED)
+            m_readableSource->close(true);
+    }
+    return *m_readable;
+}
+
+ExceptionOr<WritableStream&> WebSocket::writable(JSDOMGlobalObject& globalObject)
+{
+    if (!m_writable) {
+        auto sink = WebSocketWritableStreamSink::create(*this);
+        auto stream = WritableStream::create(globalObject, sink.copyRef());
+        if (stream.hasException())
+            return stream.releaseException();
+        m_writableSink = WTFMove(sink);
+        m_writable = stream.releaseReturnValue();
+    }
+    return *m_writable;
+}
+
+void WebSocket::pauseReading()
+{
+    if (m_isReadingPaused)
+        return;
+    m_isReadingPaused = true;
+    switch (m_connectedWebSocketKind) {
+    case ConnectedWebSocketKind::Client:
+        Bun__WebSocketClient__pauseReading(this->m_connectedWebSocket.client);
+        break;
+    case ConnectedWebSocketKind::ClientSSL:
+        Bun__WebSocketClientTLS__pauseReading(this->m_connectedWebSocket.clientSSL);
+        break;
+    default:
+        // Applied in didConnect
+        break;
+    }
+}
+
+void WebSocket::resumeReading()
+{
+    if (!m_isReadingPaused)
+        return;
+    m_isReadingPaused = false;
+    switch (m_connectedWebSocketKind) {
+    case ConnectedWebSocketKind::Client:
+        Bun__WebSocketClient__resumeReading(this->m_connectedWebSocket.client);
+        break;
+    case ConnectedWebSocketKind::ClientSSL:
+        Bun__WebSocketClientTLS__resumeReading(this->m_connectedWebSocket.clientSSL);
+        break;
+    default:
+        break;
+    }
+}
+
 String WebSocket::extensions() const
 {
     return m_extensions;
@@ -1020,6 +1244,11 @@ void WebSocket::didReceiveMessage(String&& message)
     if (m_state != OPEN)
         return;
 
+    if (m_readableSource) {
+        m_readableSource->enqueue(JSC::jsString(scriptExecutionContext()->vm(), message));
+        return;
+    }
+
     // if (UNLIKELY(InspectorInstrumentation::hasFrontends())) {
     //     if (auto* inspector = m_channel->channelInspector()) {
     //         auto utf8Message = message.utf8();
@@ -1058,6 +1287,30 @@ void WebSocket::didReceiveBinaryData(const AtomString& eventName, const std::spa
     //     if (auto* inspector = m_channel->channelInspector())
     //         inspector->didReceiveWebSocketFrame(WebSocketChannelInspector::createFrame(binaryData.data(), binaryData.size(), WebSocketFrame::OpCode::OpCodeBinary));
     // }
+
+    if (m_readableSource && eventName == eventNames().messageEvent) {
+        auto* globalObject = scriptExecutionContext()->jsGlobalObject();
+        auto scope = DECLARE_CATCH_SCOPE(globalObject->vm());
+        JSC::JSValue data;
+        if (m_binaryType == BinaryType::ArrayBuffer) {
+            if (auto buffer = JSC::ArrayBuffer::tryCreate(binaryData.data(), binaryData.size()))
+                data = JSC::JSArrayBuffer::create(globalObject->vm(), globalObject->arrayBufferStructure(), buffer.releaseNonNull());
+        } else {
+            data = createBuffer(globalObject, binaryData);
+        }
+
+        if (UNLIKELY(!data || scope.exception())) {
+            scope.clearExceptionExceptTermination();
+            ErrorEvent::Init errorInit;
+            errorInit.message = "Failed to allocate memory for binary data"_s;
+            dispatchEvent(ErrorEvent::create(eventNames().errorEvent, errorInit));
+            return;
+        }
+
+        m_readableSource->enqueue(data);
+        return;
+    }
+
     switch (m_binaryType) {
     // case BinaryType::Blob:
     //     // FIXME: We just received the data from NetworkProcess, and are sending it back. This is inefficient.
@@ -1152,6 +1405,8 @@ void WebSocket::didReceiveClose(CleanStatus wasClean, unsigned short code, WTF::
         return;
     const bool wasConnecting = m_state == CONNECTING;
     m_state = CLOSED;
+    if (m_readableSource)
+        m_readableSource->close(wasClean == CleanStatus::Clean);
     if (auto* context = scriptExecutionContext()) {
         this->incPendingActivityCount();
         if (wasConnecting && isConnectionError) {
@@ -1213,6 +1468,8 @@ void WebSocket::didClose(unsigned unhandledBufferedAmount, unsigned short code,
     ASSERT(scriptExecutionContext());
     this->m_connectedWebSocketKind = ConnectedWebSocketKind::None;
     this->m_upgradeClient = nullptr;
+    if (m_readableSource)
+        m_readableSource->close(wasClean);
 
     // since we are open and closing now we know that we have at least one pending activity
     // so we just call decPendingActivityCount() after dispatching the event
@@ -1249,6 +1506,7 @@ void WebSocket::didClose(unsigned unhandledBufferedAmount, unsigned short code,
 void WebSocket::didConnect(us_socket_t* socket, char* bufferedData, size_t bufferedDataSize)
 {
     this->m_upgradeClient = nullptr;
+    this->m_socketDescriptor = us_poll_fd(reinterpret_cast<us_poll_t*>(socket));
     if (m_isSecure) {
         us_socket_context_t* ctx = (us_socket_context_t*)this->scriptExecutionContext()->connectedWebSocketContext<true, false>();
         this->m_connectedWebSocket.clientSSL = Bun__WebSocketClientTLS__init(reinterpret_cast<CppWebSocket*>(this), socket, ctx, this->scriptExecutionContext()->jsGlobalObject(), reinterpret_cast<unsigned char*>(bufferedData), bufferedDataSize);
@@ -1259,6 +1517,12 @@ void WebSocket::didConnect(us_socket_t* socket, char* bufferedData, size_t buffe
         this->m_connectedWebSocketKind = ConnectedWebSocketKind::Client;
     }
 
+    // ws.readable filled up before the handshake finished
+    if (m_isReadingPaused) {
+        m_isReadingPaused = false;
+        pauseReading();
+    }
+
     this->didConnect();
 }
 void WebSocket::didFailWithErrorCode(int32_t code)
@@ -1502,6 +1766,16 @@ extern "C" bool WebSocket__rejectUnauthorized(WebCore::WebSocket* webSocket)
     return webSocket->rejectUnauthorized();
 }
 
+// 0 = not offered, 1 = with context takeover, 2 = without (see uws_client_deflate_negotiate)
+extern "C" uint8_t WebSocket__perMessageDeflate(WebCore::WebSocket* webSocket)
+{
+    return static_cast<uint8_t>(webSocket->perMessageDeflate());
+}
+extern "C" void WebSocket__setExtensions(WebCore::WebSocket* webSocket, const ZigString* extensions)
+{
+    webSocket->setExtensions(Zig::toStringCopy(*extensions));
+}
+
 extern "C" void WebSocket__incrementPendingActivity(WebCore::WebSocket* webSocket)
 {
     webSocket->incPendingActivityCount();
@@ -51,6 +51,12 @@ class ArrayBufferView;
 namespace WebCore {
 
 // class Blob;
+class JSDOMGlobalObject;
+class ReadableStream;
+class WritableStream;
+class WebSocketReadableStreamSource;
+class WebSocketWritableStreamSink;
+
 class WebSocket final : public RefCounted<WebSocket>, public EventTargetWithInlineData, public ContextDestructionObserver {
     WTF_MAKE_ISO_ALLOCATED(WebSocket);
 
@@ -62,6 +68,14 @@ public:
     static ExceptionOr<Ref<WebSocket>> create(ScriptExecutionContext&, const String& url, const Vector<String>& protocols);
     static ExceptionOr<Ref<WebSocket>> create(ScriptExecutionContext&, const String& url, const Vector<String>& protocols, std::optional<FetchHeaders::Init>&&);
     static ExceptionOr<Ref<WebSocket>> create(ScriptExecutionContext& context, const String& url, const Vector<String>& protocols, std::optional<FetchHeaders::Init>&& headers, bool rejectUnauthorized);
+
+    // What we offer in Sec-WebSocket-Extensions (non-standard, browsers always offer this)
+    enum class PerMessageDeflate : uint8_t {
+        Disabled = 0,
+        ContextTakeover = 1,
+        NoContextTakeover = 2,
+    };
+    static ExceptionOr<Ref<WebSocket>> create(ScriptExecutionContext& context, const String& url, const Vector<String>& protocols, std::optional<FetchHeaders::Init>&& headers, std::optional<bool> rejectUnauthorized, PerMessageDeflate);
     ~WebSocket();
 
     enum State {
@@ -110,6 +124,19 @@ public:
     ExceptionOr<void> close(std::optional<unsigned short> code, const String& reason);
     ExceptionOr<void> terminate();
 
+    // Coalesces the frames sent until uncork() into full TCP segments, may be nested
+    void cork();
+    void uncork();
+
+    // Once the readable stream exists messages are enqueued there instead of dispatched as events.
+    // Reading from the socket is paused whenever more is queued than the stream wants
+    ExceptionOr<ReadableStream&> readable(JSDOMGlobalObject&);
+    ExceptionOr<WritableStream&> writable(JSDOMGlobalObject&);
+
+    // Stops reading from the socket, frames already received are still delivered
+    void pauseReading();
+    void resumeReading();
+
     const URL& url() const;
     State readyState() const;
     unsigned bufferedAmount() const;
@@ -149,6 +176,17 @@ public:
         return m_rejectUnauthorized;
     }
 
+    PerMessageDeflate perMessageDeflate() const
+    {
+        return m_perMessageDeflate;
+    }
+
+    // The accepted Sec-WebSocket-Extensions, set by the upgrade client before didConnect
+    void setExtensions(const String& extensions)
+    {
+        m_extensions = extensions;
+    }
+
     void incPendingActivityCount()
     {
         m_pendingActivityCount++;
@@ -211,7 +249,16 @@ private:
     void* m_upgradeClient { nullptr };
     bool m_isSecure { false };
     bool m_rejectUnauthorized { false };
+    PerMessageDeflate m_perMessageDeflate { PerMessageDeflate::Disabled };
     AnyWebSocket m_connectedWebSocket { nullptr };
+    // The descriptor survives the socket being adopted by the connected client, only valid while connected
+    LIBUS_SOCKET_DESCRIPTOR m_socketDescriptor {};
+    unsigned m_corkDepth { 0 };
+    bool m_isReadingPaused { false };
+    RefPtr<WebSocketReadableStreamSource> m_readableSource;
+    RefPtr<ReadableStream> m_readable;
+    RefPtr<WebSocketWritableStreamSink> m_writableSink;
+    RefPtr<WritableStream> m_writable;
     ConnectedWebSocketKind m_connectedWebSocketKind { ConnectedWebSocketKind::None };
     size_t m_pendingActivityCount { 0 };
 
@@ -187,6 +187,188 @@ ExceptionOr<Ref<Worker>> Worker::create(ScriptExecutionContext& context, const S
     return worker;
 }
 
+struct PrewarmedWorkers {
+    WTF_MAKE_STRUCT_FAST_ALLOCATED;
+    String url;
+    String name;
+    bool mini;
+    std::unique_ptr<HashMap<String, String>> env;
+    unsigned count;
+    Deque<Ref<Worker>> workers;
+};
+
+static Lock prewarmedWorkersLock;
+static HashMap<ScriptExecutionContextIdentifier, Vector<std::unique_ptr<PrewarmedWorkers>>>& prewarmedWorkers() WTF_REQUIRES_LOCK(prewarmedWorkersLock)
+{
+    static NeverDestroyed<HashMap<ScriptExecutionContextIdentifier, Vector<std::unique_ptr<PrewarmedWorkers>>>> map;
+    return map;
+}
+
+static PrewarmedWorkers* findPrewarmedWorkers(ScriptExecutionContextIdentifier identifier, const String& url, const String& name, bool mini) WTF_REQUIRES_LOCK(prewarmedWorkersLock)
+{
+    auto it = prewarmedWorkers().find(identifier);
+    if (it == prewarmedWorkers().end())
+        return nullptr;
+    for (auto& entry : it->value) {
+        if (entry->url == url && entry->name == name && entry->mini == mini)
+            return entry.get();
+    }
+    return nullptr;
+}
+
+ExceptionOr<Ref<Worker>> Worker::createPrewarmed(ScriptExecutionContext& context, const String& url, const String& name, bool mini, const HashMap<String, String>* env)
+{
+    WorkerOptions options;
+    options.name = name;
+    options.bun.mini = mini;
+    // Whoever adopts it decides whether it keeps the process alive.
+    options.bun.unref = true;
+    if (env) {
+        HashMap<String, String> copy;
+        for (auto& [key, value] : *env)
+            copy.add(key.isolatedCopy(), value.isolatedCopy());
+        options.bun.env = makeUnique<HashMap<String, String>>(WTFMove(copy));
+    }
+
+    auto result = create(context, url, WTFMove(options));
+    if (result.hasException())
+        return result.releaseException();
+
+    auto worker = result.releaseReturnValue();
+    worker->m_isPrewarmed = true;
+    if (!worker->updatePtr())
+        return Exception { TypeError, "Failed to start Worker thread"_s };
+    return worker;
+}
+
+ExceptionOr<void> Worker::prewarm(ScriptExecutionContext& context, const String& url, const String& name, bool mini, std::unique_ptr<HashMap<String, String>>&& env, unsigned count)
+{
+    count = std::min(count, maximumPrewarmedCount);
+    Vector<Ref<Worker>> surplus;
+    {
+        Locker locker { prewarmedWorkersLock };
+        if (auto* entry = findPrewarmedWorkers(context.identifier(), url, name, mini)) {
+            entry->count = count;
+            entry->env = WTFMove(env);
+            while (entry->workers.size() > count)
+                surplus.append(entry->workers.takeLast());
+        } else {
+            auto newEntry = makeUnique<PrewarmedWorkers>();
+            newEntry->url = url.isolatedCopy();
+            newEntry->name = name.isolatedCopy();
+            newEntry->mini = mini;
+            newEntry->env = WTFMove(env);
+            newEntry->count = count;
+            prewarmedWorkers().ensure(context.identifier(), [] { return Vector<std::unique_ptr<PrewarmedWorkers>>(); }).iterator->value.append(WTFMove(newEntry));
+        }
+    }
+    for (auto& worker : surplus)
+        worker->terminate();
+
+    while (true) {
+        const HashMap<String, String>* env = nullptr;
+        {
+            Locker locker { prewarmedWorkersLock };
+            auto* entry = findPrewarmedWorkers(context.identifier(), url, name, mini);
+            if (!entry || entry->workers.size() >= entry->count)
+                return {};
+            // The entry is only ever changed on this thread, so the
+            // environment stays put while the worker is created.
+            env = entry->env.get();
+        }
+
+        auto worker = createPrewarmed(context, url, name, mini, env);
+        if (worker.hasException())
+            return worker.releaseException();
+
+        Locker locker { prewarmedWorkersLock };
+        if (auto* entry = findPrewarmedWorkers(context.identifier(), url, name, mini))
+            entry->workers.append(worker.releaseReturnValue());
+    }
+}
+
+void Worker::refillPrewarmed(ScriptExecutionContext& context, const String& url, const String& name, bool mini)
+{
+    const HashMap<String, String>* env = nullptr;
+    unsigned missing = 0;
+    {
+        Locker locker { prewarmedWorkersLock };
+        auto* entry = findPrewarmedWorkers(context.identifier(), url, name, mini);
+        if (!entry || entry->workers.size() >= entry->count)
+            return;
+        missing = entry->count - entry->workers.size();
+        env = entry->env.get();
+    }
+
+    for (unsigned i = 0; i < missing; i++) {
+        auto worker = createPrewarmed(context, url, name, mini, env);
+        // A failure here shows up again, with its error, on the next
+        // `new Worker()`, which then starts a worker the usual way.
+        if (worker.hasException())
+            return;
+
+        Locker locker { prewarmedWorkersLock };
+        auto* entry = findPrewarmedWorkers(context.identifier(), url, name, mini);
+        if (!entry)
+            return;
+        entry->workers.append(worker.releaseReturnValue());
+    }
+}
+
+RefPtr<Worker> Worker::takePrewarmed(ScriptExecutionContext& context, const String& url, const WorkerOptions& options)
+{
+    RefPtr<Worker> worker;
+    {
+        Locker locker { prewarmedWorkersLock };
+        auto* entry = findPrewarmedWorkers(context.identifier(), url, options.name, options.bun.mini);
+        if (!entry)
+            return nullptr;
+        while (!entry->workers.isEmpty() && !worker) {
+            auto candidate = entry->workers.takeFirst();
+            // It exited while warm, e.g. because the module threw.
+            if (!candidate->m_wasTerminated && !candidate->m_isClosing)
+                worker = WTFMove(candidate);
+        }
+    }
+
+    context.postTask([url = url.isolatedCopy(), name = options.name.isolatedCopy(), mini = options.bun.mini](ScriptExecutionContext& context) {
+        refillPrewarmed(context, url, name, mini);
+    });
+
+    if (worker)
+        worker->adoptPrewarmed(context, options.bun.unref);
+    return worker;
+}
+
+void Worker::adoptPrewarmed(ScriptExecutionContext& context, bool unref)
+{
+    m_options.bun.unref = unref;
+    if (!unref)
+        setKeepAlive(true);
+
+    // Replayed from a task so the caller can add listeners first. Events
+    // that arrive before it runs are still held, which keeps them in order.
+    context.postTask([protectedThis = Ref { *this }](ScriptExecutionContext&) {
+        protectedThis->m_isPrewarmed = false;
+        auto events = std::exchange(protectedThis->m_pendingEvents, {});
+        for (auto& event : events)
+            protectedThis->EventTargetWithInlineData::dispatchEvent(*event);
+    });
+}
+
+void Worker::discardPrewarmed(ScriptExecutionContextIdentifier identifier)
+{
+    Vector<std::unique_ptr<PrewarmedWorkers>> entries;
+    {
+        Locker locker { prewarmedWorkersLock };
+        entries = prewarmedWorkers().take(identifier);
+    }
+    for (auto& entry : entries) {
+        for (auto& worker : entry->workers)
+            worker->terminate();
+    }
+}
+
 Worker::~Worker()
 {
     {
@@ -202,7 +384,7 @@ ExceptionOr<void> Worker::postMessage(JSC::JSGlobalObject& state, JSC::JSValue m
         return Exception { InvalidStateError, "Worker has been terminated"_s };
 
     Vector<RefPtr<MessagePort>> ports;
-    auto serialized = SerializedScriptValue::create(state, messageValue, WTFMove(options.transfer), ports, SerializationForStorage::No, SerializationContext::WorkerPostMessage);
+    auto serialized = SerializedScriptValue::create(state, messageValue, WTFMove(options.transfer), ports, SerializationForStorage::No, SerializationContext::WorkerPostMessage, nullptr, options.lazy ? SerializationLaziness::Lazy : SerializationLaziness::Eager);
     if (serialized.hasException())
         return serialized.releaseException();
 
@@ -268,6 +450,10 @@ bool Worker::hasPendingActivity() const
 
 void Worker::dispatchEvent(Event& event)
 {
+    if (m_isPrewarmed) {
+        m_pendingEvents.append(&event);
+        return;
+    }
     if (!m_wasTerminated)
         EventTargetWithInlineData::dispatchEvent(event);
 }
@@ -276,6 +462,10 @@ void Worker::dispatchEvent(Event& event)
 // This allows new wt.Worker().terminate() to actually resolve
 void Worker::dispatchCloseEvent(Event& event)
 {
+    if (m_isPrewarmed) {
+        m_pendingEvents.append(&event);
+        return;
+    }
     EventTargetWithInlineData::dispatchEvent(event);
 }
 
@@ -305,7 +495,7 @@ void Worker::dispatchOnline(Zig::GlobalObject* workerGlobalObject)
     auto* ctx = scriptExecutionContext();
     if (ctx) {
         ScriptExecutionContext::postTaskTo(ctx->identifier(), [protectedThis = Ref { *this }](ScriptExecutionContext& context) -> void {
-            if (protectedThis->hasEventListeners(eventNames().openEvent)) {
+            if (protectedThis->m_isPrewarmed || protectedThis->hasEventListeners(eventNames().openEvent)) {
                 auto event = Event::create(eventNames().openEvent, Event::CanBubble::No, Event::IsCancelable::No);
                 protectedThis->dispatchEvent(event);
             }
@@ -365,7 +555,7 @@ void Worker::dispatchExit(int32_t exitCode)
         protectedThis->m_isOnline = false;
         protectedThis->m_isClosing = true;
 
-        if (protectedThis->hasEventListeners(eventNames().closeEvent)) {
+        if (protectedThis->m_isPrewarmed || protectedThis->hasEventListeners(eventNames().closeEvent)) {
             auto event = CloseEvent::create(exitCode == 0, static_cast<unsigned short>(exitCode), exitCode == 0 ? "Worker terminated normally"_s : "Worker exited abnormally"_s);
             protectedThis->dispatchCloseEvent(event);
         }
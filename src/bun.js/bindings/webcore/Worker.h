@@ -62,6 +62,15 @@ public:
     static ExceptionOr<Ref<Worker>> create(ScriptExecutionContext&, const String& url, WorkerOptions&&);
     ~Worker();
 
+    // Keeps `count` workers for `url` started ahead of time so that a
+    // `new Worker(url)` with the same name and smol setting adopts one
+    // instead of booting a VM and loading the module while the caller
+    // waits. Each adoption starts a replacement. Parent thread only.
+    static ExceptionOr<void> prewarm(ScriptExecutionContext&, const String& url, const String& name, bool mini, std::unique_ptr<HashMap<String, String>>&& env, unsigned count);
+    static RefPtr<Worker> takePrewarmed(ScriptExecutionContext&, const String& url, const WorkerOptions&);
+    static void discardPrewarmed(ScriptExecutionContextIdentifier);
+    static constexpr unsigned maximumPrewarmedCount = 64;
+
     ExceptionOr<void> postMessage(JSC::JSGlobalObject&, JSC::JSValue message, StructuredSerializeOptions&&);
 
     using ThreadSafeRefCounted::deref;
@@ -120,6 +129,10 @@ private:
 
     static void networkStateChanged(bool isOnLine);
 
+    static ExceptionOr<Ref<Worker>> createPrewarmed(ScriptExecutionContext&, const String& url, const String& name, bool mini, const HashMap<String, String>* env);
+    static void refillPrewarmed(ScriptExecutionContext&, const String& url, const String& name, bool mini);
+    void adoptPrewarmed(ScriptExecutionContext&, bool unref);
+
     // RefPtr<WorkerScriptLoader> m_scriptLoader;
     WorkerOptions m_options;
     String m_identifier;
@@ -136,6 +149,9 @@ private:
     bool m_didStartWorkerGlobalScope { false };
     bool m_isOnline { false };
     bool m_isClosing { false };
+    // Not yet handed to a `new Worker()`: events are held in m_pendingEvents
+    // until someone can be listening for them.
+    bool m_isPrewarmed { false };
     const ScriptExecutionContextIdentifier m_clientIdentifier;
     void* impl_ { nullptr };
 };
@@ -143,5 +159,6 @@ private:
 JSValue createNodeWorkerThreadsBinding(Zig::GlobalObject* globalObject);
 
 JSC_DECLARE_HOST_FUNCTION(jsFunctionPostMessage);
+JSC_DECLARE_HOST_FUNCTION(jsFunctionPrewarmWorkers);
 
 } // namespace WebCore
@@ -0,0 +1,138 @@
+#include "config.h"
+#include "WorkerPoolScheduler.h"
+
+#include "Worker.h"
+
+namespace WebCore {
+
+WorkerPoolScheduler::WorkerPoolScheduler(ScriptExecutionContextIdentifier owner, size_t workerCount)
+    : m_owner(owner)
+{
+    m_slots.reserveInitialCapacity(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+        m_slots.append(makeUnique<Slot>());
+}
+
+std::optional<size_t> WorkerPoolScheduler::submit(Task&& task)
+{
+    // Prefer an idle worker, starting after the last one picked so ties
+    // spread out; otherwise the one with the least queued.
+    size_t count = m_slots.size();
+    size_t chosen = m_nextSlot % count;
+    uint32_t shallowest = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < count; i++) {
+        size_t index = (m_nextSlot + i) % count;
+        auto& slot = *m_slots[index];
+        if (slot.idle.load(std::memory_order_relaxed)) {
+            chosen = index;
+            break;
+        }
+        uint32_t depth = slot.depth.load(std::memory_order_relaxed);
+        if (depth < shallowest) {
+            shallowest = depth;
+            chosen = index;
+        }
+    }
+    m_nextSlot = chosen + 1;
+
+    auto& slot = *m_slots[chosen];
+    {
+        Locker locker { slot.lock };
+        slot.tasks.append(WTFMove(task));
+    }
+    // Pairs with becomeIdle(): either the worker sees this task or we see
+    // that it went idle.
+    slot.depth.fetch_add(1, std::memory_order_seq_cst);
+    if (slot.idle.exchange(false, std::memory_order_seq_cst))
+        return chosen;
+    return std::nullopt;
+}
+
+std::optional<WorkerPoolScheduler::Task> WorkerPoolScheduler::takeFrom(Slot& slot, bool fromBack)
+{
+    Locker locker { slot.lock };
+    if (slot.tasks.isEmpty())
+        return std::nullopt;
+    slot.depth.fetch_sub(1, std::memory_order_relaxed);
+    return fromBack ? slot.tasks.takeLast() : slot.tasks.takeFirst();
+}
+
+std::optional<WorkerPoolScheduler::Task> WorkerPoolScheduler::take(size_t workerIndex)
+{
+    if (m_isClosed.load(std::memory_order_relaxed))
+        return std::nullopt;
+
+    if (auto task = takeFrom(*m_slots[workerIndex], false))
+        return task;
+
+    // Steal the newest task of the most loaded worker. Depths are read
+    // without its lock, so try again if it emptied in the meantime.
+    while (true) {
+        Slot* victim = nullptr;
+        uint32_t deepest = 0;
+        for (size_t i = 0; i < m_slots.size(); i++) {
+            if (i == workerIndex)
+                continue;
+            uint32_t depth = m_slots[i]->depth.load(std::memory_order_relaxed);
+            if (depth > deepest) {
+                deepest = depth;
+                victim = m_slots[i].get();
+            }
+        }
+        if (!victim)
+            return std::nullopt;
+        if (auto task = takeFrom(*victim, true))
+            return task;
+    }
+}
+
+bool WorkerPoolScheduler::becomeIdle(size_t workerIndex)
+{
+    auto& slot = *m_slots[workerIndex];
+    slot.idle.store(true, std::memory_order_seq_cst);
+    if (m_isClosed.load(std::memory_order_relaxed))
+        return false;
+
+    for (auto& other : m_slots) {
+        if (other->depth.load(std::memory_order_seq_cst)) {
+            // Whoever clears the flag first runs the work: us, or a wakeup
+            // that submit() has already posted.
+            return slot.idle.exchange(false, std::memory_order_seq_cst);
+        }
+    }
+    return false;
+}
+
+void WorkerPoolScheduler::addWorker(Ref<Worker>&& worker)
+{
+    m_workers.append(WTFMove(worker));
+}
+
+Vector<JSC::Strong<JSC::JSPromise>*> WorkerPoolScheduler::terminate()
+{
+    if (m_isTerminated)
+        return {};
+    m_isTerminated = true;
+    m_isClosed.store(true, std::memory_order_relaxed);
+
+    for (auto& worker : m_workers)
+        worker->terminate();
+
+    // Queued tasks are in m_outstanding too; only their payloads are left.
+    for (auto& slot : m_slots) {
+        Locker locker { slot->lock };
+        slot->tasks.clear();
+        slot->depth.store(0, std::memory_order_relaxed);
+    }
+
+    return copyToVector(std::exchange(m_outstanding, {}));
+}
+
+void WorkerPoolScheduler::orphan()
+{
+    m_isOrphaned = true;
+    if (m_outstanding.isEmpty())
+        terminate();
+}
+
+} // namespace WebCore
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "root.h"
+#include "SerializedScriptValue.h"
+#include <JavaScriptCore/JSPromise.h>
+#include <JavaScriptCore/Strong.h>
+#include <wtf/Deque.h>
+#include <wtf/HashSet.h>
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace WebCore {
+
+class Worker;
+
+// The queues behind Bun.WorkerPool.
+//
+// Each worker has its own deque. The pool's thread pushes onto the back of
+// an idle worker's deque, or the shortest one if none is idle; a worker
+// takes from the front of its own deque and, once that is empty, steals
+// from the back of the longest other one. A slow task therefore only holds
+// up the tasks queued behind it until another worker runs dry.
+//
+// A worker that finds nothing marks itself idle and is woken by the next
+// submit() that picks it. Every other member is only used on the pool's
+// own thread.
+class WorkerPoolScheduler : public ThreadSafeRefCounted<WorkerPoolScheduler> {
+public:
+    // The promise is only created, settled and deleted on the pool's thread;
+    // workers just carry the pointer back.
+    struct Task {
+        JSC::Strong<JSC::JSPromise>* promise;
+        Ref<SerializedScriptValue> payload;
+    };
+
+    static Ref<WorkerPoolScheduler> create(ScriptExecutionContextIdentifier owner, size_t workerCount)
+    {
+        return adoptRef(*new WorkerPoolScheduler(owner, workerCount));
+    }
+
+    ScriptExecutionContextIdentifier owner() const { return m_owner; }
+    size_t workerCount() const { return m_slots.size(); }
+
+    // Queues a task. Returns the index of a worker that was idle and now
+    // has to be woken up to run it.
+    std::optional<size_t> submit(Task&&);
+
+    // Worker side. The next task for `workerIndex`, stolen from another
+    // worker when its own deque is empty.
+    std::optional<Task> take(size_t workerIndex);
+
+    // Worker side, once take() found nothing. Returns true if work arrived
+    // in the meantime and the worker should keep taking instead of sleeping.
+    bool becomeIdle(size_t workerIndex);
+
+    // Tasks waiting in a worker's deque, not counting the one it is running.
+    uint32_t queueDepth(size_t workerIndex) const { return m_slots[workerIndex]->depth.load(std::memory_order_relaxed); }
+
+    // Pool thread only.
+    void addWorker(Ref<Worker>&&);
+    Worker& worker(size_t workerIndex) { return m_workers[workerIndex].get(); }
+    bool isTerminated() const { return m_isTerminated; }
+    size_t outstandingTaskCount() const { return m_outstanding.size(); }
+    void didSubmit(JSC::Strong<JSC::JSPromise>* promise) { m_outstanding.add(promise); }
+    // Returns false if the task was settled already, by terminate().
+    bool willSettle(JSC::Strong<JSC::JSPromise>* promise) { return m_outstanding.remove(promise); }
+
+    // Pool thread only. Stops the workers and hands back every task that
+    // has not settled so the caller can reject it.
+    Vector<JSC::Strong<JSC::JSPromise>*> terminate();
+
+    // Pool thread only. The pool object is gone: stop the workers once the
+    // last outstanding task settles.
+    void orphan();
+    bool isOrphaned() const { return m_isOrphaned; }
+
+private:
+    WorkerPoolScheduler(ScriptExecutionContextIdentifier owner, size_t workerCount);
+
+    struct Slot {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+        Lock lock;
+        Deque<Task> tasks WTF_GUARDED_BY_LOCK(lock);
+        std::atomic<uint32_t> depth { 0 };
+        std::atomic<bool> idle { true };
+    };
+
+    std::optional<Task> takeFrom(Slot&, bool fromBack);
+
+    const ScriptExecutionContextIdentifier m_owner;
+    Vector<std::unique_ptr<Slot>> m_slots;
+    std::atomic<bool> m_isClosed { false };
+
+    Vector<Ref<Worker>> m_workers;
+    HashSet<JSC::Strong<JSC::JSPromise>*> m_outstanding;
+    size_t m_nextSlot { 0 };
+    bool m_isTerminated { false };
+    bool m_isOrphaned { false };
+};
+
+} // namespace WebCore
@@ -28,6 +28,7 @@
 
 #if ENABLE(WEB_CRYPTO)
 
+#include "CryptoWorkQueuePool.h"
 #include "ScriptExecutionContext.h"
 
 namespace WebCore {
@@ -57,6 +58,11 @@ void CryptoAlgorithm::digest(Vector<uint8_t>&&, VectorCallback&&, ExceptionCallb
     exceptionCallback(NotSupportedError);
 }
 
+void CryptoAlgorithm::verifyBatch(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<SignatureAndData>&&, BoolVectorCallback&&, ExceptionCallback&& exceptionCallback, ScriptExecutionContext&)
+{
+    exceptionCallback(NotSupportedError);
+}
+
 void CryptoAlgorithm::generateKey(const CryptoAlgorithmParameters&, bool, CryptoKeyUsageBitmap, KeyOrKeyPairCallback&&, ExceptionCallback&& exceptionCallback, ScriptExecutionContext&)
 {
     exceptionCallback(NotSupportedError);
@@ -96,9 +102,11 @@ template<typename ResultCallbackType, typename OperationType>
 static void dispatchAlgorithmOperation(WorkQueue& workQueue, ScriptExecutionContext& context, ResultCallbackType&& callback, CryptoAlgorithm::ExceptionCallback&& exceptionCallback, OperationType&& operation)
 {
     context.refEventLoop();
+    CryptoWorkQueuePool::singleton().willDispatch(workQueue);
     workQueue.dispatch(
-        [operation = WTFMove(operation), callback = WTFMove(callback), exceptionCallback = WTFMove(exceptionCallback), contextIdentifier = context.identifier()]() mutable {
+        [protectedQueue = Ref { workQueue }, operation = WTFMove(operation), callback = WTFMove(callback), exceptionCallback = WTFMove(exceptionCallback), contextIdentifier = context.identifier()]() mutable {
             auto result = operation();
+            CryptoWorkQueuePool::singleton().didComplete(protectedQueue);
             ScriptExecutionContext::postTaskTo(contextIdentifier, [result = crossThreadCopy(WTFMove(result)), callback = WTFMove(callback), exceptionCallback = WTFMove(exceptionCallback)](auto& context) mutable {
                 context.unrefEventLoop();
                 if (result.hasException()) {
@@ -110,6 +118,81 @@ static void dispatchAlgorithmOperation(WorkQueue& workQueue, ScriptExecutionCont
         });
 }
 
+namespace {
+
+class BatchOperation : public ThreadSafeRefCounted<BatchOperation> {
+public:
+    BatchOperation(size_t count, size_t sliceCount, Function<ExceptionOr<bool>(size_t)>&& operation, CryptoAlgorithm::BoolVectorCallback&& callback, CryptoAlgorithm::ExceptionCallback&& exceptionCallback)
+        : operation(WTFMove(operation))
+        , callback(WTFMove(callback))
+        , exceptionCallback(WTFMove(exceptionCallback))
+        , results(count, false)
+        , remainingSlices(sliceCount)
+    {
+    }
+
+    // Called from several threads at once, each with its own range.
+    const Function<ExceptionOr<bool>(size_t)> operation;
+    // Only touched on the context's thread.
+    CryptoAlgorithm::BoolVectorCallback callback;
+    CryptoAlgorithm::ExceptionCallback exceptionCallback;
+
+    Vector<bool> results;
+    std::atomic<size_t> remainingSlices;
+    std::atomic<bool> failed { false };
+    ExceptionCode exceptionCode { OperationError };
+};
+
+}
+
+void CryptoAlgorithm::dispatchBatchOperation(ScriptExecutionContext& context, size_t count, BoolVectorCallback&& callback, ExceptionCallback&& exceptionCallback, Function<ExceptionOr<bool>(size_t)>&& operation)
+{
+    if (!count) {
+        callback({});
+        return;
+    }
+
+    auto& pool = CryptoWorkQueuePool::singleton();
+    size_t sliceCount = std::min(count, pool.queueCount());
+    size_t sliceSize = (count + sliceCount - 1) / sliceCount;
+    sliceCount = (count + sliceSize - 1) / sliceSize;
+    auto batch = adoptRef(*new BatchOperation(count, sliceCount, WTFMove(operation), WTFMove(callback), WTFMove(exceptionCallback)));
+
+    context.refEventLoop();
+    for (size_t begin = 0; begin < count; begin += sliceSize) {
+        size_t end = std::min(count, begin + sliceSize);
+        auto& workQueue = pool.leastBusyQueue();
+        pool.willDispatch(workQueue);
+        workQueue.dispatch([batch = batch.copyRef(), protectedQueue = Ref { workQueue }, begin, end, contextIdentifier = context.identifier()]() mutable {
+            for (size_t i = begin; i < end && !batch->failed.load(std::memory_order_relaxed); i++) {
+                auto result = batch->operation(i);
+                if (result.hasException()) {
+                    if (!batch->failed.exchange(true))
+                        batch->exceptionCode = result.releaseException().code();
+                    break;
+                }
+                batch->results[i] = result.releaseReturnValue();
+            }
+            CryptoWorkQueuePool::singleton().didComplete(protectedQueue);
+
+            if (batch->remainingSlices.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            ScriptExecutionContext::postTaskTo(contextIdentifier, [batch = WTFMove(batch)](auto& context) mutable {
+                context.unrefEventLoop();
+                // Take the callbacks so they are destroyed here even if a
+                // worker drops the last reference to the batch.
+                auto callback = std::exchange(batch->callback, nullptr);
+                auto exceptionCallback = std::exchange(batch->exceptionCallback, nullptr);
+                if (batch->failed) {
+                    exceptionCallback(batch->exceptionCode);
+                    return;
+                }
+                callback(WTFMove(batch->results));
+            });
+        });
+    }
+}
+
 void CryptoAlgorithm::dispatchOperationInWorkQueue(WorkQueue& workQueue, ScriptExecutionContext& context, VectorCallback&& callback, ExceptionCallback&& exceptionCallback, Function<ExceptionOr<Vector<uint8_t>>()>&& operation)
 {
     dispatchAlgorithmOperation(workQueue, context, WTFMove(callback), WTFMove(exceptionCallback), WTFMove(operation));
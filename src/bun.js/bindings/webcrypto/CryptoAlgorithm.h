@@ -62,12 +62,16 @@ public:
     using VoidCallback = Function<void()>;
     using ExceptionCallback = Function<void(ExceptionCode)>;
     using KeyDataCallback = Function<void(CryptoKeyFormat, KeyData&&)>;
+    using BoolVectorCallback = Function<void(Vector<bool>&&)>;
+    using SignatureAndData = std::pair<Vector<uint8_t>, Vector<uint8_t>>;
 
     virtual void encrypt(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<uint8_t>&&, VectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
     virtual void decrypt(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<uint8_t>&&, VectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
     virtual void sign(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<uint8_t>&&, VectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
     virtual void verify(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<uint8_t>&& signature, Vector<uint8_t>&&, BoolCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
     virtual void digest(Vector<uint8_t>&&, VectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
+    // Verifies every pair against the one key, spread across the crypto queue pool.
+    virtual void verifyBatch(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, Vector<SignatureAndData>&&, BoolVectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&);
     virtual void generateKey(const CryptoAlgorithmParameters&, bool extractable, CryptoKeyUsageBitmap, KeyOrKeyPairCallback&&, ExceptionCallback&&, ScriptExecutionContext&);
     virtual void deriveBits(const CryptoAlgorithmParameters&, Ref<CryptoKey>&&, size_t length, VectorCallback&&, ExceptionCallback&&, ScriptExecutionContext&, WorkQueue&);
     // FIXME: https://bugs.webkit.org/show_bug.cgi?id=169262
@@ -77,8 +81,16 @@ public:
     virtual void unwrapKey(Ref<CryptoKey>&&, Vector<uint8_t>&&, VectorCallback&&, ExceptionCallback&&);
     virtual ExceptionOr<size_t> getKeyLength(const CryptoAlgorithmParameters&);
 
+    // Digests and HMACs of inputs up to this size run on the calling thread:
+    // the round trip through a WorkQueue and back costs more than the work.
+    static constexpr size_t maximumInlineOperationSize = 1024;
+
     static void dispatchOperationInWorkQueue(WorkQueue&, ScriptExecutionContext&, VectorCallback&&, ExceptionCallback&&, Function<ExceptionOr<Vector<uint8_t>>()>&&);
     static void dispatchOperationInWorkQueue(WorkQueue&, ScriptExecutionContext&, BoolCallback&&, ExceptionCallback&&, Function<ExceptionOr<bool>()>&&);
+    // Calls the operation for every index below `count`, split into one slice
+    // per queue of the pool, and reports all the results at once. The first
+    // exception wins and stops the rest.
+    static void dispatchBatchOperation(ScriptExecutionContext&, size_t count, BoolVectorCallback&&, ExceptionCallback&&, Function<ExceptionOr<bool>(size_t)>&&);
 };
 
 } // namespace WebCore
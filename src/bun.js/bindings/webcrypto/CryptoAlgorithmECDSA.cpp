@@ -81,6 +81,20 @@ void CryptoAlgorithmECDSA::verify(const CryptoAlgorithmParameters& parameters, R
         });
 }
 
+void CryptoAlgorithmECDSA::verifyBatch(const CryptoAlgorithmParameters& parameters, Ref<CryptoKey>&& key, Vector<SignatureAndData>&& pairs, BoolVectorCallback&& callback, ExceptionCallback&& exceptionCallback, ScriptExecutionContext& context)
+{
+    if (key->type() != CryptoKeyType::Public) {
+        exceptionCallback(InvalidAccessError);
+        return;
+    }
+
+    size_t count = pairs.size();
+    dispatchBatchOperation(context, count, WTFMove(callback), WTFMove(exceptionCallback),
+        [parameters = crossThreadCopy(downcast<CryptoAlgorithmEcdsaParams>(parameters)), key = WTFMove(key), pairs = WTFMove(pairs)](size_t index) {
+            return platformVerify(parameters, downcast<CryptoKeyEC>(key.get()), pairs[index].first, pairs[index].second);
+        });
+}
+
 void CryptoAlgorithmECDSA::generateKey(const CryptoAlgorithmParameters& parameters, bool extractable, CryptoKeyUsageBitmap usages, KeyOrKeyPairCallback&& callback, ExceptionCallback&& exceptionCallback, ScriptExecutionContext&)
 {
     const auto& ecParameters = downcast<CryptoAlgorithmEcKeyParams>(parameters);
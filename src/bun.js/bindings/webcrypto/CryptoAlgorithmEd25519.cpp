@@ -111,6 +111,20 @@ void CryptoAlgorithmEd25519::verify(const CryptoAlgorithmParameters&, Ref<Crypto
         });
 }
 
+void CryptoAlgorithmEd25519::verifyBatch(const CryptoAlgorithmParameters&, Ref<CryptoKey>&& key, Vector<SignatureAndData>&& pairs, BoolVectorCallback&& callback, ExceptionCallback&& exceptionCallback, ScriptExecutionContext& context)
+{
+    if (key->type() != CryptoKeyType::Public) {
+        exceptionCallback(InvalidAccessError);
+        return;
+    }
+
+    size_t count = pairs.size();
+    dispatchBatchOperation(context, count, WTFMove(callback), WTFMove(exceptionCallback),
+        [key = WTFMove(key), pairs = WTFMove(pairs)](size_t index) {
+            return platformVerify(downcast<CryptoKeyOKP>(key.get()), pairs[index].first, pairs[index].second);
+        });
+}
+
 void CryptoAlgorithmEd25519::importKey(CryptoKeyFormat format, KeyData&& data, const CryptoAlgorithmParameters&, bool extractable, CryptoKeyUsageBitmap usages, KeyCallback&& callback, ExceptionCallback&& exceptionCallback)
 {
     RefPtr<CryptoKeyOKP> result;
@@ -57,8 +57,23 @@ CryptoAlgorithmIdentifier CryptoAlgorithmHMAC::identifier() const
     return s_identifier;
 }
 
+template<typename ResultType, typename CallbackType>
+static void completeInline(ExceptionOr<ResultType>&& result, CallbackType&& callback, CryptoAlgorithm::ExceptionCallback&& exceptionCallback)
+{
+    if (result.hasException()) {
+        exceptionCallback(result.releaseException().code());
+        return;
+    }
+    callback(result.releaseReturnValue());
+}
+
 void CryptoAlgorithmHMAC::sign(const CryptoAlgorithmParameters&, Ref<CryptoKey>&& key, Vector<uint8_t>&& data, VectorCallback&& callback, ExceptionCallback&& exceptionCallback, ScriptExecutionContext& context, WorkQueue& workQueue)
 {
+    if (data.size() <= maximumInlineOperationSize) {
+        completeInline(platformSign(downcast<CryptoKeyHMAC>(key.get()), data), WTFMove(callback), WTFMove(exceptionCallback));
+        return;
+    }
+
     dispatchOperationInWorkQueue(workQueue, context, WTFMove(callback), WTFMove(exceptionCallback),
         [key = WTFMove(key), data = WTFMove(data)] {
             return platformSign(downcast<CryptoKeyHMAC>(key.get()), data);
@@ -67,6 +82,11 @@ void CryptoAlgorithmHMAC::sign(const CryptoAlgorithmParameters&, Ref<CryptoKey>&
 
 void CryptoAlgorithmHMAC::verify(const CryptoAlgorithmParameters&, Ref<CryptoKey>&& key, Vector<uint8_t>&& signature, Vector<uint8_t>&& data, BoolCallback&& callback, ExceptionCallback&& exceptionCallback, ScriptExecutionContext& context, WorkQueue& workQueue)
 {
+    if (data.size() <= maximumInlineOperationSize) {
+        completeInline(platformVerify(downcast<CryptoKeyHMAC>(key.get()), signature, data), WTFMove(callback), WTFMove(exceptionCallback));
+        return;
+    }
+
     dispatchOperationInWorkQueue(workQueue, context, WTFMove(callback), WTFMove(exceptionCallback),
         [key = WTFMove(key), signature = WTFMove(signature), data = WTFMove(data)] {
             return platformVerify(downcast<CryptoKeyHMAC>(key.get()), signature, data);
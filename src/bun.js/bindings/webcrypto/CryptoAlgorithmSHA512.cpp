@@ -51,13 +51,9 @@ void CryptoAlgorithmSHA512::digest(Vector<uint8_t>&& message, VectorCallback&& c
         return;
     }
 
-    if (message.size() < 64) {
-        auto moved = WTFMove(message);
-        digest->addBytes(moved.data(), moved.size());
-        auto result = digest->computeHash();
-        ScriptExecutionContext::postTaskTo(context.identifier(), [callback = WTFMove(callback), result = WTFMove(result)](auto&) {
-            callback(result);
-        });
+    if (message.size() <= maximumInlineOperationSize) {
+        digest->addBytes(message.data(), message.size());
+        callback(digest->computeHash());
         return;
     }
 
@@ -0,0 +1,77 @@
+#include "config.h"
+#include "CryptoWorkQueuePool.h"
+
+#if ENABLE(WEB_CRYPTO)
+
+#include <wtf/NeverDestroyed.h>
+#include <wtf/NumberOfCores.h>
+
+namespace WebCore {
+
+CryptoWorkQueuePool& CryptoWorkQueuePool::singleton()
+{
+    static LazyNeverDestroyed<CryptoWorkQueuePool> pool;
+    static std::once_flag onceKey;
+    std::call_once(onceKey, [&] {
+        pool.construct();
+    });
+    return pool;
+}
+
+CryptoWorkQueuePool::CryptoWorkQueuePool()
+{
+    // WorkQueue threads are created on first dispatch, so unused queues
+    // cost nothing.
+    size_t count = std::max(1, WTF::numberOfProcessorCores());
+    m_queues.reserveInitialCapacity(count);
+    for (size_t i = 0; i < count; i++)
+        m_queues.append(makeUnique<Queue>(WorkQueue::create("com.apple.WebKit.CryptoQueue"_s)));
+}
+
+WorkQueue& CryptoWorkQueuePool::leastBusyQueue()
+{
+    Queue* leastBusy = m_queues[0].get();
+    size_t leastDepth = leastBusy->depth.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < m_queues.size() && leastDepth; i++) {
+        size_t depth = m_queues[i]->depth.load(std::memory_order_relaxed);
+        if (depth < leastDepth) {
+            leastBusy = m_queues[i].get();
+            leastDepth = depth;
+        }
+    }
+    return leastBusy->queue;
+}
+
+auto CryptoWorkQueuePool::find(WorkQueue& workQueue) -> Queue*
+{
+    for (auto& queue : m_queues) {
+        if (queue->queue.ptr() == &workQueue)
+            return queue.get();
+    }
+    return nullptr;
+}
+
+void CryptoWorkQueuePool::willDispatch(WorkQueue& workQueue)
+{
+    if (auto* queue = find(workQueue)) {
+        queue->depth.fetch_add(1, std::memory_order_relaxed);
+        m_depth.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CryptoWorkQueuePool::didComplete(WorkQueue& workQueue)
+{
+    if (auto* queue = find(workQueue)) {
+        queue->depth.fetch_sub(1, std::memory_order_relaxed);
+        m_depth.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+extern "C" size_t Bun__CryptoWorkQueuePool__queueDepth()
+{
+    return CryptoWorkQueuePool::singleton().queueDepth();
+}
+
+} // namespace WebCore
+
+#endif
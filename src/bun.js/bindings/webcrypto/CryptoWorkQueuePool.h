@@ -0,0 +1,56 @@
+#pragma once
+
+#include <wtf/Forward.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+#include <wtf/WorkQueue.h>
+
+#if ENABLE(WEB_CRYPTO)
+
+namespace WebCore {
+
+// The queues SubtleCrypto runs its operations on, one per core and shared
+// by every SubtleCrypto in the process, Workers included.
+//
+// A WorkQueue runs its tasks one after another, so a queue per SubtleCrypto
+// put every verify of a busy server behind the one before it. Operations now
+// go to whichever queue has the fewest waiting, so independent ones run in
+// parallel while each still runs on an ordinary serial WorkQueue.
+class CryptoWorkQueuePool {
+    WTF_MAKE_NONCOPYABLE(CryptoWorkQueuePool);
+
+public:
+    static CryptoWorkQueuePool& singleton();
+
+    WorkQueue& leastBusyQueue();
+
+    // Bracket each operation run on a pool queue; no-ops for other queues.
+    void willDispatch(WorkQueue&);
+    void didComplete(WorkQueue&);
+
+    size_t queueCount() const { return m_queues.size(); }
+    // Operations dispatched and not yet finished, across all queues.
+    size_t queueDepth() const { return m_depth.load(std::memory_order_relaxed); }
+
+private:
+    friend class LazyNeverDestroyed<CryptoWorkQueuePool>;
+    CryptoWorkQueuePool();
+
+    struct Queue {
+        explicit Queue(Ref<WorkQueue>&& queue)
+            : queue(WTFMove(queue))
+        {
+        }
+
+        Ref<WorkQueue> queue;
+        std::atomic<size_t> depth { 0 };
+    };
+    Queue* find(WorkQueue&);
+
+    Vector<std::unique_ptr<Queue>> m_queues;
+    std::atomic<size_t> m_depth { 0 };
+};
+
+} // namespace WebCore
+
+#endif
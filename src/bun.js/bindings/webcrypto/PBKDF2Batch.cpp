@@ -0,0 +1,257 @@
+#include "config.h"
+#include "PBKDF2Batch.h"
+
+#if ENABLE(WEB_CRYPTO)
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+#if CPU(X86_64) && (COMPILER(GCC) || COMPILER(CLANG))
+#define PBKDF2_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace WebCore {
+
+PBKDF2Batch::PBKDF2Batch(const EVP_MD* digest, uint32_t iterations, size_t keyLength, Vector<Vector<uint8_t>>&& passwords, Vector<Vector<uint8_t>>&& salts)
+    : m_digest(digest)
+    , m_iterations(iterations)
+    , m_keyLength(keyLength)
+    , m_passwords(WTFMove(passwords))
+    , m_salts(WTFMove(salts))
+{
+    ASSERT(m_salts.size() == 1 || m_salts.size() == m_passwords.size());
+    m_results.reserveInitialCapacity(m_passwords.size());
+    for (size_t i = 0; i < m_passwords.size(); i++)
+        m_results.append(Vector<uint8_t>(m_keyLength));
+}
+
+#if PBKDF2_BATCH_AVX2
+
+static constexpr size_t lanes = 8;
+
+static bool useLanes()
+{
+    // Eight lanes outrun even SHA extensions, which BoringSSL's HMAC runs a block at a time.
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+}
+
+static constexpr uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define PBKDF2_AVX2 __attribute__((target("avx2"))) static inline
+
+PBKDF2_AVX2 __m256i rotr(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+// One SHA-256 block in each lane. w is the block, and is used up as the schedule.
+PBKDF2_AVX2 void compress(const __m256i state[8], __m256i w[16], __m256i out[8])
+{
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m256i w15 = w[(i - 15) & 15];
+            __m256i w2 = w[(i - 2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(w15, 7), rotr(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(w2, 17), rotr(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+        }
+
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, _mm256_add_epi32(_mm256_set1_epi32(roundConstants[i]), w[i & 15])));
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(s0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    out[0] = _mm256_add_epi32(state[0], a);
+    out[1] = _mm256_add_epi32(state[1], b);
+    out[2] = _mm256_add_epi32(state[2], c);
+    out[3] = _mm256_add_epi32(state[3], d);
+    out[4] = _mm256_add_epi32(state[4], e);
+    out[5] = _mm256_add_epi32(state[5], f);
+    out[6] = _mm256_add_epi32(state[6], g);
+    out[7] = _mm256_add_epi32(state[7], h);
+}
+
+// A 32 byte digest padded to a block of its own, after the 64 byte HMAC pad.
+PBKDF2_AVX2 void digestBlock(const __m256i digest[8], __m256i w[16])
+{
+    for (int i = 0; i < 8; i++)
+        w[i] = digest[i];
+    w[8] = _mm256_set1_epi32(0x80000000);
+    for (int i = 9; i < 15; i++)
+        w[i] = _mm256_setzero_si256();
+    w[15] = _mm256_set1_epi32((64 + 32) * 8);
+}
+
+// Iterations 2 to c of every lane: U = HMAC(P, U) and T ^= U, where the
+// HMAC is two blocks from the precomputed ipad and opad states. Everything
+// is [word][lane], and a digest is fed back as words, never as bytes.
+__attribute__((target("avx2"))) static void iterate(const uint32_t inner[8][lanes], const uint32_t outer[8][lanes], const uint32_t first[8][lanes], uint32_t result[8][lanes], uint32_t rounds)
+{
+    __m256i innerState[8], outerState[8], u[8], t[8];
+    for (int i = 0; i < 8; i++) {
+        innerState[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inner[i]));
+        outerState[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(outer[i]));
+        u[i] = t[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first[i]));
+    }
+
+    __m256i w[16], innerDigest[8];
+    for (uint32_t round = 0; round < rounds; round++) {
+        digestBlock(u, w);
+        compress(innerState, w, innerDigest);
+        digestBlock(innerDigest, w);
+        compress(outerState, w, u);
+        for (int i = 0; i < 8; i++)
+            t[i] = _mm256_xor_si256(t[i], u[i]);
+    }
+
+    for (int i = 0; i < 8; i++)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result[i]), t[i]);
+}
+
+static uint32_t loadBigEndian(const uint8_t* bytes)
+{
+    return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+}
+
+// Hashes one block of key ^ pad, the start of every HMAC under that key.
+static void padContext(const uint8_t key[SHA256_CBLOCK], uint8_t pad, SHA256_CTX& context, uint32_t* state, size_t lane)
+{
+    uint8_t block[SHA256_CBLOCK];
+    for (size_t i = 0; i < SHA256_CBLOCK; i++)
+        block[i] = key[i] ^ pad;
+    SHA256_Init(&context);
+    SHA256_Update(&context, block, sizeof(block));
+    for (size_t i = 0; i < 8; i++)
+        state[i * lanes + lane] = context.h[i];
+}
+
+bool PBKDF2Batch::deriveWithLanes(size_t begin, size_t end)
+{
+    size_t blocksPerKey = (m_keyLength + SHA256_DIGEST_LENGTH - 1) / SHA256_DIGEST_LENGTH;
+    size_t jobs = (end - begin) * blocksPerKey;
+
+    for (size_t first = 0; first < jobs; first += lanes) {
+        uint32_t inner[8][lanes], outer[8][lanes], u[8][lanes], t[8][lanes];
+        size_t used = std::min(lanes, jobs - first);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            // Spare lanes redo the last job rather than branch in the kernel.
+            size_t job = first + std::min(lane, used - 1);
+            size_t index = begin + job / blocksPerKey;
+            uint32_t block = job % blocksPerKey + 1;
+            auto& password = m_passwords[index];
+            auto& salt = m_salts.size() == 1 ? m_salts[0] : m_salts[index];
+
+            uint8_t key[SHA256_CBLOCK] = {};
+            if (password.size() > SHA256_CBLOCK)
+                SHA256(password.data(), password.size(), key);
+            else if (password.size())
+                memcpy(key, password.data(), password.size());
+            SHA256_CTX innerContext, outerContext;
+            padContext(key, 0x36, innerContext, &inner[0][0], lane);
+            padContext(key, 0x5c, outerContext, &outer[0][0], lane);
+
+            // U1 = HMAC(P, S || INT(i)) is the only HMAC of a message that is not a digest.
+            uint8_t blockIndex[4] = { uint8_t(block >> 24), uint8_t(block >> 16), uint8_t(block >> 8), uint8_t(block) };
+            uint8_t digest[SHA256_DIGEST_LENGTH];
+            SHA256_Update(&innerContext, salt.data(), salt.size());
+            SHA256_Update(&innerContext, blockIndex, sizeof(blockIndex));
+            SHA256_Final(digest, &innerContext);
+            SHA256_Update(&outerContext, digest, sizeof(digest));
+            SHA256_Final(digest, &outerContext);
+            for (size_t i = 0; i < 8; i++)
+                u[i][lane] = loadBigEndian(digest + i * 4);
+        }
+
+        iterate(inner, outer, u, t, m_iterations - 1);
+
+        for (size_t lane = 0; lane < used; lane++) {
+            size_t job = first + lane;
+            auto& result = m_results[begin + job / blocksPerKey];
+            size_t offset = (job % blocksPerKey) * SHA256_DIGEST_LENGTH;
+            size_t length = std::min<size_t>(SHA256_DIGEST_LENGTH, m_keyLength - offset);
+            uint8_t bytes[SHA256_DIGEST_LENGTH];
+            for (size_t i = 0; i < 8; i++) {
+                bytes[i * 4] = t[i][lane] >> 24;
+                bytes[i * 4 + 1] = t[i][lane] >> 16;
+                bytes[i * 4 + 2] = t[i][lane] >> 8;
+                bytes[i * 4 + 3] = t[i][lane];
+            }
+            memcpy(result.data() + offset, bytes, length);
+        }
+    }
+    return true;
+}
+
+#else
+
+static constexpr size_t lanes = 1;
+
+static bool useLanes()
+{
+    return false;
+}
+
+bool PBKDF2Batch::deriveWithLanes(size_t, size_t)
+{
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+#endif
+
+size_t PBKDF2Batch::grain() const
+{
+    if (m_digest != EVP_sha256() || !useLanes())
+        return 1;
+    size_t blocksPerKey = (m_keyLength + SHA256_DIGEST_LENGTH - 1) / SHA256_DIGEST_LENGTH;
+    return std::max<size_t>(1, lanes / std::max<size_t>(1, blocksPerKey));
+}
+
+bool PBKDF2Batch::derive(size_t begin, size_t end)
+{
+    ASSERT(begin <= end && end <= size());
+    if (!m_keyLength)
+        return true;
+
+    // A single iteration is all U1, which the lanes do not compute.
+    if (m_digest == EVP_sha256() && m_iterations > 1 && useLanes())
+        return deriveWithLanes(begin, end);
+
+    for (size_t i = begin; i < end; i++) {
+        auto& password = m_passwords[i];
+        auto& salt = m_salts.size() == 1 ? m_salts[0] : m_salts[i];
+        if (PKCS5_PBKDF2_HMAC(reinterpret_cast<const char*>(password.data()), password.size(), salt.data(), salt.size(), m_iterations, m_digest, m_keyLength, m_results[i].data()) <= 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace WebCore
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <openssl/base.h>
+#include <wtf/Forward.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+#if ENABLE(WEB_CRYPTO)
+
+namespace WebCore {
+
+// PBKDF2 for many passwords at once, as a login endpoint under a credential
+// stuffing attack has to do.
+//
+// Nearly all of the time goes to the iterations, each two SHA-256 blocks
+// that depend on the one before, so one derivation leaves most of a core's
+// vector units idle. With AVX2, SHA-256 derivations run eight to a core,
+// one per 32-bit lane: every password block is its own lane, so a 64 byte
+// key takes two. Other digests, and CPUs without AVX2, go through BoringSSL
+// one at a time.
+class PBKDF2Batch {
+    WTF_MAKE_NONCOPYABLE(PBKDF2Batch);
+
+public:
+    // salts holds one salt for every password, or a single one for all.
+    PBKDF2Batch(const EVP_MD*, uint32_t iterations, size_t keyLength, Vector<Vector<uint8_t>>&& passwords, Vector<Vector<uint8_t>>&& salts);
+
+    size_t size() const { return m_passwords.size(); }
+    // How many derivations to give one call to derive() to keep its lanes busy.
+    size_t grain() const;
+
+    // Derives [begin, end), which may run on any thread alongside other
+    // ranges. Returns false if BoringSSL failed.
+    bool derive(size_t begin, size_t end);
+
+    Vector<Vector<uint8_t>> takeResults() { return WTFMove(m_results); }
+
+private:
+    bool deriveWithLanes(size_t begin, size_t end);
+
+    const EVP_MD* m_digest;
+    uint32_t m_iterations;
+    size_t m_keyLength;
+    Vector<Vector<uint8_t>> m_passwords;
+    Vector<Vector<uint8_t>> m_salts;
+    Vector<Vector<uint8_t>> m_results;
+};
+
+} // namespace WebCore
+
+#endif
@@ -0,0 +1,66 @@
+#include "config.h"
+#include "ParsedKeyCache.h"
+
+#if ENABLE(WEB_CRYPTO)
+
+#include <openssl/sha.h>
+#include <wtf/NeverDestroyed.h>
+
+namespace WebCore {
+
+ParsedKeyCache& ParsedKeyCache::singleton()
+{
+    static LazyNeverDestroyed<ParsedKeyCache> cache;
+    static std::once_flag onceKey;
+    std::call_once(onceKey, [&] {
+        cache.construct();
+    });
+    return cache;
+}
+
+auto ParsedKeyCache::digest(Source source, std::span<const uint8_t> data) -> std::optional<Digest>
+{
+    if (data.size() > maxLength)
+        return std::nullopt;
+
+    Digest digest;
+    SHA256_CTX context;
+    SHA256_Init(&context);
+    auto sourceByte = static_cast<uint8_t>(source);
+    SHA256_Update(&context, &sourceByte, 1);
+    SHA256_Update(&context, data.data(), data.size());
+    SHA256_Final(digest.data(), &context);
+    return digest;
+}
+
+EvpPKeyPtr ParsedKeyCache::find(const Digest& digest)
+{
+    Locker locker { m_lock };
+    for (size_t i = 0; i < m_size; i++) {
+        if (m_entries[i].digest != digest)
+            continue;
+        if (i)
+            std::rotate(m_entries.begin(), m_entries.begin() + i, m_entries.begin() + i + 1);
+        EVP_PKEY_up_ref(m_entries[0].key.get());
+        return EvpPKeyPtr(m_entries[0].key.get());
+    }
+    return nullptr;
+}
+
+void ParsedKeyCache::add(const Digest& digest, EVP_PKEY* key)
+{
+    if (!key)
+        return;
+
+    EVP_PKEY_up_ref(key);
+    Locker locker { m_lock };
+    if (m_size < capacity)
+        m_size++;
+    // Drops the least recently used entry once full.
+    std::move_backward(m_entries.begin(), m_entries.begin() + m_size - 1, m_entries.begin() + m_size);
+    m_entries[0] = { digest, EvpPKeyPtr(key) };
+}
+
+} // namespace WebCore
+
+#endif
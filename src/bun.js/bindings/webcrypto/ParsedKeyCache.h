@@ -0,0 +1,72 @@
+#pragma once
+
+#include "OpenSSLCryptoUniquePtr.h"
+#include <array>
+#include <span>
+#include <wtf/Forward.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+
+#if ENABLE(WEB_CRYPTO)
+
+namespace WebCore {
+
+// The keys createPublicKey/createPrivateKey parsed most recently,
+// keyed by a SHA-256 of the encoded key, most recent first.
+//
+// jsonwebtoken and friends import the same PEM on every request. A hit
+// skips the ASN.1 parse and hands back the same EVP_PKEY, so the Montgomery
+// contexts and blinding state BoringSSL builds on first use are built once.
+// EVP_PKEY is reference counted and these keys are never modified after
+// import, so several CryptoKeys can share one.
+//
+// Shared by every VM in the process, like CryptoWorkQueuePool. Encrypted
+// keys are never looked up or added, so a passphrase is never bypassed.
+class ParsedKeyCache {
+    WTF_MAKE_NONCOPYABLE(ParsedKeyCache);
+
+public:
+    static constexpr size_t capacity = 32;
+    // Past this the hash is most of the cost of a parse.
+    static constexpr size_t maxLength = 16 * 1024;
+
+    // How the bytes were read; the same bytes can mean different keys.
+    enum class Source : uint8_t {
+        PrivatePEM,
+        PrivatePKCS1,
+        PrivatePKCS8,
+        PrivateSEC1,
+        PublicPEM,
+        PublicPKCS1,
+        PublicSPKI,
+    };
+
+    using Digest = std::array<uint8_t, 32>;
+
+    static ParsedKeyCache& singleton();
+
+    // nullopt when the input is too long to be worth caching.
+    static std::optional<Digest> digest(Source, std::span<const uint8_t>);
+
+    // A new reference to the cached key, or null.
+    EvpPKeyPtr find(const Digest&);
+    // Keeps a new reference to `key`.
+    void add(const Digest&, EVP_PKEY*);
+
+private:
+    friend class LazyNeverDestroyed<ParsedKeyCache>;
+    ParsedKeyCache() = default;
+
+    struct Entry {
+        Digest digest;
+        EvpPKeyPtr key;
+    };
+
+    Lock m_lock;
+    std::array<Entry, capacity> m_entries WTF_GUARDED_BY_LOCK(m_lock);
+    size_t m_size WTF_GUARDED_BY_LOCK(m_lock) { 0 };
+};
+
+} // namespace WebCore
+
+#endif
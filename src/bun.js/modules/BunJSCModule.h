@@ -13,12 +13,15 @@
 #include <JavaScriptCore/DeferTermination.h>
 #include <JavaScriptCore/Error.h>
 #include <JavaScriptCore/ErrorInstance.h>
+#include <JavaScriptCore/HeapIterationScope.h>
 #include <JavaScriptCore/HeapSnapshotBuilder.h>
 #include <JavaScriptCore/JIT.h>
 #include <JavaScriptCore/JSBasePrivate.h>
 #include <JavaScriptCore/JSCInlines.h>
 #include <JavaScriptCore/JSONObject.h>
 #include <JavaScriptCore/JavaScript.h>
+#include <JavaScriptCore/MarkedBlockInlines.h>
+#include <JavaScriptCore/MarkedSpaceInlines.h>
 #include <JavaScriptCore/ObjectConstructor.h>
 #include <JavaScriptCore/SamplingProfiler.h>
 #include <JavaScriptCore/TestRunnerUtils.h>
@@ -27,6 +30,8 @@
 #include <wtf/MemoryFootprint.h>
 #include <wtf/text/WTFString.h>
 
+#include "BunCPUProfiler.h"
+#include "BunHeapProfiler.h"
 #include "BunProcess.h"
 #include <JavaScriptCore/SourceProviderCache.h>
 #if ENABLE(REMOTE_INSPECTOR)
@@ -218,6 +223,13 @@ JSC_DEFINE_HOST_FUNCTION(functionMemoryUsageStatistics,
   stats->putDirect(vm,
                    Identifier::fromLatin1(vm, "protectedObjectTypeCounts"_s),
                    protectedCounts);
+
+  // Strong references held from Zig, and the cleared ones kept for reuse
+  auto &strongRefPool = WebCore::clientData(vm)->strongRefPool;
+  stats->putDirect(vm, Identifier::fromLatin1(vm, "strongRefCount"_s),
+                   jsNumber(strongRefPool.liveCount()));
+  stats->putDirect(vm, Identifier::fromLatin1(vm, "pooledStrongRefCount"_s),
+                   jsNumber(strongRefPool.pooledCount()));
   return JSValue::encode(stats);
 }
 
@@ -323,6 +335,94 @@ JSC_DEFINE_HOST_FUNCTION(functionSamplingProfilerStackTraces,
   return result;
 }
 
+JSC_DECLARE_HOST_FUNCTION(functionStartCPUProfiler);
+JSC_DEFINE_HOST_FUNCTION(functionStartCPUProfiler,
+                         (JSGlobalObject * globalObject, CallFrame *callFrame)) {
+  VM &vm = globalObject->vm();
+  Seconds interval = Bun::defaultCPUProfilerInterval;
+  JSValue intervalValue = callFrame->argument(0);
+  if (intervalValue.isNumber() && intervalValue.asNumber() > 0) {
+    interval = Seconds::fromMicroseconds(intervalValue.asNumber());
+  }
+
+  // Both profilers use the VM's one SamplingProfiler.
+  if (Bun::isHeapProfilerRunning(vm)) {
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    throwException(globalObject, scope,
+                   createError(globalObject, "Heap profiler is running"_s));
+    return JSValue::encode(jsUndefined());
+  }
+
+  Bun::startCPUProfiler(vm, interval);
+  return JSValue::encode(jsUndefined());
+}
+
+JSC_DECLARE_HOST_FUNCTION(functionStopCPUProfiler);
+JSC_DEFINE_HOST_FUNCTION(functionStopCPUProfiler,
+                         (JSGlobalObject * globalObject, CallFrame *)) {
+  VM &vm = globalObject->vm();
+  auto scope = DECLARE_THROW_SCOPE(vm);
+
+  String profile = Bun::stopCPUProfiler(vm);
+  if (profile.isNull()) {
+    throwException(globalObject, scope,
+                   createError(globalObject, "CPU profiler is not running"_s));
+    return JSValue::encode(jsUndefined());
+  }
+
+  // A string, so it can go straight to a .cpuprofile file.
+  return JSValue::encode(jsString(vm, profile));
+}
+
+JSC_DECLARE_HOST_FUNCTION(functionStartHeapProfiler);
+JSC_DEFINE_HOST_FUNCTION(functionStartHeapProfiler,
+                         (JSGlobalObject * globalObject, CallFrame *callFrame)) {
+  VM &vm = globalObject->vm();
+  auto scope = DECLARE_THROW_SCOPE(vm);
+  size_t sampleInterval = Bun::defaultHeapProfilerSampleInterval;
+  JSValue intervalValue = callFrame->argument(0);
+  if (intervalValue.isNumber() && intervalValue.asNumber() >= 1) {
+    sampleInterval = static_cast<size_t>(
+        std::min(intervalValue.asNumber(), static_cast<double>(SIZE_MAX)));
+  }
+
+  if (Bun::isCPUProfilerRunning(vm)) {
+    throwException(globalObject, scope,
+                   createError(globalObject, "CPU profiler is running"_s));
+    return JSValue::encode(jsUndefined());
+  }
+
+  Bun::startHeapProfiler(vm, sampleInterval);
+  return JSValue::encode(jsUndefined());
+}
+
+JSC_DECLARE_HOST_FUNCTION(functionStopHeapProfiler);
+JSC_DEFINE_HOST_FUNCTION(functionStopHeapProfiler,
+                         (JSGlobalObject * lexicalGlobalObject, CallFrame *)) {
+  auto *globalObject = jsCast<Zig::GlobalObject *>(lexicalGlobalObject);
+  VM &vm = globalObject->vm();
+  auto scope = DECLARE_THROW_SCOPE(vm);
+
+  auto profile = Bun::stopHeapProfiler(vm);
+  if (!profile) {
+    throwException(globalObject, scope,
+                   createError(globalObject, "Heap profiler is not running"_s));
+    return JSValue::encode(jsUndefined());
+  }
+
+  // A Buffer of the pprof protobuf, ready for a .pb file.
+  size_t byteLength = profile->size();
+  auto arrayBuffer = ArrayBuffer::tryCreate(profile->span());
+  if (!arrayBuffer) {
+    throwOutOfMemoryError(globalObject, scope);
+    return JSValue::encode(jsUndefined());
+  }
+  JSC::JSUint8Array *uint8Array = JSC::JSUint8Array::create(
+      lexicalGlobalObject, globalObject->JSBufferSubclassStructure(),
+      arrayBuffer.releaseNonNull(), 0, byteLength);
+  return JSValue::encode(uint8Array);
+}
+
 JSC_DECLARE_HOST_FUNCTION(functionGetRandomSeed);
 JSC_DEFINE_HOST_FUNCTION(functionGetRandomSeed,
                          (JSGlobalObject * globalObject, CallFrame *)) {
@@ -703,6 +803,166 @@ JSC_DEFINE_HOST_FUNCTION(functionCodeCoverageForFile,
       basicBlocks.size(), functionStartOffset, ignoreSourceMap);
 }
 
+JSC_DECLARE_HOST_FUNCTION(functionResolveCacheStatistics);
+JSC_DEFINE_HOST_FUNCTION(functionResolveCacheStatistics,
+                         (JSGlobalObject * globalObject, CallFrame *callFrame)) {
+  VM &vm = globalObject->vm();
+  auto &cache = jsCast<Zig::GlobalObject *>(globalObject)->requireResolveCache;
+
+  if (callFrame->argument(0).toBoolean(globalObject)) {
+    cache.clear();
+  }
+
+  auto &statistics = cache.statistics();
+  JSObject *object = constructEmptyObject(globalObject);
+  object->putDirect(vm, Identifier::fromString(vm, "hits"_s),
+                    jsNumber(statistics.hits));
+  object->putDirect(vm, Identifier::fromString(vm, "misses"_s),
+                    jsNumber(statistics.misses));
+  object->putDirect(vm, Identifier::fromString(vm, "failureHits"_s),
+                    jsNumber(statistics.failureHits));
+  object->putDirect(vm, Identifier::fromString(vm, "size"_s),
+                    jsNumber(cache.size()));
+  return JSValue::encode(object);
+}
+
+// The .node files process.dlopen() has loaded, how long the first load of
+// each took, and how many times each was loaded, Workers included.
+JSC_DECLARE_HOST_FUNCTION(functionNativeAddonStatistics);
+JSC_DEFINE_HOST_FUNCTION(functionNativeAddonStatistics,
+                         (JSGlobalObject * globalObject, CallFrame *)) {
+  VM &vm = globalObject->vm();
+  auto scope = DECLARE_THROW_SCOPE(vm);
+
+  auto loads = Bun::nativeAddonLoads();
+  JSArray *array = constructEmptyArray(globalObject, nullptr, loads.size());
+  RETURN_IF_EXCEPTION(scope, {});
+  for (size_t i = 0; i < loads.size(); i++) {
+    JSObject *object = constructEmptyObject(globalObject);
+    object->putDirect(vm, Identifier::fromString(vm, "path"_s),
+                      jsString(vm, loads[i].path));
+    object->putDirect(vm, Identifier::fromString(vm, "loadTime"_s),
+                      jsNumber(loads[i].loadTime.milliseconds()));
+    object->putDirect(vm, Identifier::fromString(vm, "loads"_s),
+                      jsNumber(loads[i].loads));
+    array->putDirectIndex(globalObject, i, object);
+    RETURN_IF_EXCEPTION(scope, {});
+  }
+  return JSValue::encode(array);
+}
+
+JSC_DECLARE_HOST_FUNCTION(functionTimerStatistics);
+JSC_DEFINE_HOST_FUNCTION(functionTimerStatistics,
+                         (JSGlobalObject * globalObject, CallFrame *callFrame)) {
+  VM &vm = globalObject->vm();
+  auto &timerWheel = jsCast<Zig::GlobalObject *>(globalObject)->timerWheel;
+
+  auto &statistics = timerWheel.statistics();
+  JSObject *object = constructEmptyObject(globalObject);
+  object->putDirect(vm, Identifier::fromString(vm, "live"_s),
+                    jsNumber(timerWheel.size()));
+  object->putDirect(vm, Identifier::fromString(vm, "scheduled"_s),
+                    jsNumber(statistics.scheduled));
+  object->putDirect(vm, Identifier::fromString(vm, "cancelled"_s),
+                    jsNumber(statistics.cancelled));
+  object->putDirect(vm, Identifier::fromString(vm, "fired"_s),
+                    jsNumber(statistics.fired));
+  return JSValue::encode(object);
+}
+
+// Live cells, their bytes and the blocks they sit in, per subspace. Every
+// binding class has its own IsoSubspace, named after it, so this is what
+// shows which of them hold onto the heap. A block with no live cells is
+// freed by shrinkHeap().
+JSC_DECLARE_HOST_FUNCTION(functionSubspaceStatistics);
+JSC_DEFINE_HOST_FUNCTION(functionSubspaceStatistics,
+                         (JSGlobalObject * globalObject, CallFrame *)) {
+  VM &vm = globalObject->vm();
+  JSLockHolder lock(vm);
+
+  struct Statistics {
+    size_t cells = 0;
+    size_t bytes = 0;
+    size_t blocks = 0;
+    size_t emptyBlocks = 0;
+  };
+  HashMap<Subspace *, Statistics> statistics;
+  HashSet<MarkedBlock *> occupiedBlocks;
+
+  {
+    HeapIterationScope iterationScope(vm.heap);
+    vm.heap.objectSpace().forEachLiveCell(
+        iterationScope, [&](HeapCell *cell, HeapCell::Kind) -> IterationStatus {
+          Subspace *subspace;
+          if (cell->isPreciseAllocation()) {
+            subspace = cell->preciseAllocation().subspace();
+          } else {
+            subspace = cell->markedBlock().handle().subspace();
+            occupiedBlocks.add(&cell->markedBlock());
+          }
+          auto &entry = statistics.add(subspace, Statistics()).iterator->value;
+          entry.cells++;
+          entry.bytes += cell->cellSize();
+          return IterationStatus::Continue;
+        });
+
+    vm.heap.objectSpace().forEachBlock([&](MarkedBlock::Handle *handle) {
+      auto &entry =
+          statistics.add(handle->subspace(), Statistics()).iterator->value;
+      entry.blocks++;
+      if (!occupiedBlocks.contains(&handle->block()))
+        entry.emptyBlocks++;
+    });
+  }
+
+  // Several subspaces can share a name, like the ones JSC makes per size
+  // class, so they are added up by it.
+  HashMap<String, Statistics> byName;
+  for (auto &it : statistics) {
+    auto &entry =
+        byName.add(String::fromUTF8(it.key->name().data()), Statistics())
+            .iterator->value;
+    entry.cells += it.value.cells;
+    entry.bytes += it.value.bytes;
+    entry.blocks += it.value.blocks;
+    entry.emptyBlocks += it.value.emptyBlocks;
+  }
+
+  JSObject *result = constructEmptyObject(globalObject);
+  for (auto &it : byName) {
+    JSObject *entry = constructEmptyObject(globalObject);
+    entry->putDirect(vm, Identifier::fromString(vm, "cells"_s),
+                     jsNumber(it.value.cells));
+    entry->putDirect(vm, Identifier::fromString(vm, "bytes"_s),
+                     jsNumber(it.value.bytes));
+    entry->putDirect(vm, Identifier::fromString(vm, "blocks"_s),
+                     jsNumber(it.value.blocks));
+    entry->putDirect(vm, Identifier::fromString(vm, "emptyBlocks"_s),
+                     jsNumber(it.value.emptyBlocks));
+    result->putDirect(vm, Identifier::fromString(vm, it.key), entry);
+  }
+  return JSValue::encode(result);
+}
+
+// Collects, then gives the blocks left empty back to the OS instead of
+// keeping them around for the next allocation, along with the allocator's
+// free pages. Returns how many bytes the heap shrank by.
+JSC_DECLARE_HOST_FUNCTION(functionShrinkHeap);
+JSC_DEFINE_HOST_FUNCTION(functionShrinkHeap,
+                         (JSGlobalObject * globalObject, CallFrame *)) {
+  VM &vm = globalObject->vm();
+  JSLockHolder lock(vm);
+  size_t capacityBefore = vm.heap.capacity();
+
+  vm.heap.collectNow(Sync, CollectionScope::Full);
+  vm.heap.objectSpace().shrink();
+  WTF::releaseFastMallocFreeMemory();
+
+  size_t capacityAfter = vm.heap.capacity();
+  return JSValue::encode(jsNumber(
+      capacityBefore > capacityAfter ? capacityBefore - capacityAfter : 0));
+}
+
 // clang-format off
 /* Source for BunJSCModuleTable.lut.h
 @begin BunJSCModuleTable
@@ -736,13 +996,22 @@ JSC_DEFINE_HOST_FUNCTION(functionCodeCoverageForFile,
     setTimeZone                         functionSetTimeZone                         Function    0                               
     serialize                           functionSerialize                           Function    0                             
     deserialize                         functionDeserialize                         Function    0                               
+    resolveCacheStatistics              functionResolveCacheStatistics              Function    0
+    startCPUProfiler                    functionStartCPUProfiler                    Function    0
+    stopCPUProfiler                     functionStopCPUProfiler                     Function    0
+    startHeapProfiler                   functionStartHeapProfiler                   Function    0
+    stopHeapProfiler                    functionStopHeapProfiler                    Function    0
+    timerStatistics                     functionTimerStatistics                     Function    0
+    nativeAddonStatistics               functionNativeAddonStatistics               Function    0
+    subspaceStatistics                  functionSubspaceStatistics                  Function    0
+    shrinkHeap                          functionShrinkHeap                          Function    0
 @end
 */
 
 namespace Zig {
 DEFINE_NATIVE_MODULE(BunJSC)
 {
-    INIT_NATIVE_MODULE(34);
+    INIT_NATIVE_MODULE(43);
 
     putNativeFn(Identifier::fromString(vm, "callerSourceOrigin"_s), functionCallerSourceOrigin);
     putNativeFn(Identifier::fromString(vm, "jscDescribe"_s), functionDescribe);
@@ -775,6 +1044,15 @@ DEFINE_NATIVE_MODULE(BunJSC)
     putNativeFn(Identifier::fromString(vm, "setTimeZone"_s), functionSetTimeZone);
     putNativeFn(Identifier::fromString(vm, "serialize"_s), functionSerialize);
     putNativeFn(Identifier::fromString(vm, "deserialize"_s), functionDeserialize);
+    putNativeFn(Identifier::fromString(vm, "resolveCacheStatistics"_s), functionResolveCacheStatistics);
+    putNativeFn(Identifier::fromString(vm, "startCPUProfiler"_s), functionStartCPUProfiler);
+    putNativeFn(Identifier::fromString(vm, "stopCPUProfiler"_s), functionStopCPUProfiler);
+    putNativeFn(Identifier::fromString(vm, "startHeapProfiler"_s), functionStartHeapProfiler);
+    putNativeFn(Identifier::fromString(vm, "stopHeapProfiler"_s), functionStopHeapProfiler);
+    putNativeFn(Identifier::fromString(vm, "timerStatistics"_s), functionTimerStatistics);
+    putNativeFn(Identifier::fromString(vm, "nativeAddonStatistics"_s), functionNativeAddonStatistics);
+    putNativeFn(Identifier::fromString(vm, "subspaceStatistics"_s), functionSubspaceStatistics);
+    putNativeFn(Identifier::fromString(vm, "shrinkHeap"_s), functionShrinkHeap);
     
     // Deprecated
     putNativeFn(Identifier::fromString(vm, "describe"_s), functionDescribe);
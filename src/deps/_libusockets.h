@@ -69,6 +69,17 @@ typedef struct {
   int options;
 } uws_app_listen_config_t;
 
+typedef struct {
+  uint64_t count;
+  uint64_t min;
+  uint64_t max;
+  uint64_t mean;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t p999;
+} uws_latency_summary_t;
+
 struct uws_app_s;
 struct uws_req_s;
 struct uws_res_s;
@@ -85,6 +96,15 @@ typedef void (*uws_websocket_message_handler)(uws_websocket_t *ws,
                                               const char *message,
                                               size_t length,
                                               uws_opcode_t opcode);
+/* One message of a batch, the bytes are at data + offset */
+typedef struct {
+  size_t offset;
+  size_t length;
+  uws_opcode_t opcode;
+} uws_websocket_batch_entry_t;
+typedef void (*uws_websocket_messages_handler)(
+    uws_websocket_t *ws, const char *data,
+    const uws_websocket_batch_entry_t *entries, size_t count);
 typedef void (*uws_websocket_ping_pong_handler)(uws_websocket_t *ws,
                                                 const char *message,
                                                 size_t length);
@@ -119,6 +139,8 @@ typedef struct {
   uws_websocket_ping_pong_handler ping;
   uws_websocket_ping_pong_handler pong;
   uws_websocket_close_handler close;
+  /* If set, replaces message with one call per read for all of its messages */
+  uws_websocket_messages_handler messages;
 } uws_socket_behavior_t;
 
 typedef void (*uws_listen_handler)(struct us_listen_socket_t *listen_socket,
@@ -145,6 +167,10 @@ uws_app_t *uws_create_app(int ssl,
 void uws_app_destroy(int ssl, uws_app_t *app);
 void uws_app_get(int ssl, uws_app_t *app, const char *pattern,
                  uws_method_handler handler, void *user_data);
+void uws_app_static_route(int ssl, uws_app_t *app, const char *pattern,
+                          const char **header_names, const size_t *header_name_lengths,
+                          const char **header_values, const size_t *header_value_lengths,
+                          size_t header_count, const char *body, size_t body_length);
 void uws_app_post(int ssl, uws_app_t *app, const char *pattern,
                   uws_method_handler handler, void *user_data);
 void uws_app_options(int ssl, uws_app_t *app, const char *pattern,
@@ -181,6 +207,15 @@ void uws_app_listen_domain_with_options(int ssl, uws_app_t *app,
                                         uws_listen_domain_handler handler,
                                         void *user_data);
 void uws_app_domain(int ssl, uws_app_t *app, const char *server_name);
+void uws_app_freeze_routes(int ssl, uws_app_t *app);
+void uws_app_set_latency_stats_enabled(int ssl, uws_app_t *app, bool enabled);
+void uws_app_advertise_http3(int ssl, uws_app_t *app, int port, unsigned int max_age);
+void uws_app_drain(int ssl, uws_app_t *app, unsigned int timeout_ms);
+void uws_app_listen_fd(int ssl, uws_app_t *app, int fd,
+                       uws_listen_handler handler, void *user_data);
+bool uws_app_get_latency_summary(int ssl, uws_app_t *app, unsigned int stage,
+                                 uws_latency_summary_t *summary);
+void uws_app_reset_latency_stats(int ssl, uws_app_t *app);
 
 bool uws_constructor_failed(int ssl, uws_app_t *app);
 
@@ -249,6 +284,31 @@ bool uws_ws_publish_with_options(int ssl, uws_websocket_t *ws,
                                  const char *message, size_t message_length,
                                  uws_opcode_t opcode, bool compress);
 unsigned int uws_ws_get_buffered_amount(int ssl, uws_websocket_t *ws);
+/* Takes ownership of the buffer a fragmented message was assembled in (only
+ * from within the message handler). Returns NULL if the message has to be
+ * copied. Free with uws_ws_free_message_buffer(bytes, *ctx) */
+char *uws_ws_take_message_buffer(int ssl, uws_websocket_t *ws,
+                                 const char *message, size_t length,
+                                 void **ctx);
+void uws_ws_free_message_buffer(void *bytes, void *ctx);
+
+/* permessage-deflate for the client role. The offer goes in the upgrade
+ * request, negotiate takes the Sec-WebSocket-Extensions response and returns
+ * 1 and a context if compression is on, 0 if declined and -1 if the
+ * connection must fail. Output is valid until the next call on the context.
+ * Empty messages must not be compressed */
+typedef struct uws_client_deflate_s uws_client_deflate_t;
+const char *uws_client_deflate_offer(bool context_takeover, size_t *length);
+int uws_client_deflate_negotiate(bool context_takeover, const char *response,
+                                 size_t length, uws_client_deflate_t **out);
+size_t uws_client_deflate_compress(uws_client_deflate_t *deflate,
+                                   const char *data, size_t length,
+                                   const char **out);
+bool uws_client_deflate_decompress(uws_client_deflate_t *deflate,
+                                   const char *data, size_t length,
+                                   size_t max_payload_length,
+                                   const char **out, size_t *out_length);
+void uws_client_deflate_destroy(uws_client_deflate_t *deflate);
 size_t uws_ws_get_remote_address(int ssl, uws_websocket_t *ws,
                                  const char **dest);
 size_t uws_ws_get_remote_address_as_text(int ssl, uws_websocket_t *ws,
@@ -270,6 +330,14 @@ void uws_res_write_header_int(int ssl, uws_res_t *res, const char *key,
                               size_t key_length, uint64_t value);
 void uws_res_end_without_body(int ssl, uws_res_t *res, bool close_connection);
 void uws_res_end_stream(int ssl, uws_res_t *res, bool close_connection);
+/* allowed is a mask of uWS::HttpContentEncoding: deflate 1, gzip 2, br 4, zstd 8 */
+bool uws_res_compress(int ssl, uws_res_t *res, const char *accept_encoding,
+                      size_t accept_encoding_length, unsigned int allowed);
+void uws_res_end_cached(int ssl, uws_res_t *res, const char *key,
+                        size_t key_length, const char *data, size_t length,
+                        const char *accept_encoding,
+                        size_t accept_encoding_length, unsigned int allowed,
+                        bool close_connection);
 bool uws_res_write(int ssl, uws_res_t *res, const char *data, size_t length);
 uint64_t uws_res_get_write_offset(int ssl, uws_res_t *res);
 bool uws_res_has_responded(int ssl, uws_res_t *res);
@@ -312,6 +380,8 @@ void uws_req_for_each_header(uws_req_t *res,
 
 struct us_loop_t *uws_get_loop();
 struct us_loop_t *uws_get_loop_with_native(void *existing_native_loop);
+// Bytes held by this thread's queued writes and its pool of write buffers.
+size_t uws_backpressure_memory();
 
 void uws_loop_addPostHandler(us_loop_t *loop, void *ctx_,
                              void (*cb)(void *ctx, us_loop_t *loop));
@@ -324,6 +394,38 @@ void uws_loop_defer(us_loop_t *loop, void *ctx, void (*cb)(void *ctx));
 void uws_res_write_headers(int ssl, uws_res_t *res, const StringPointer *names,
                            const StringPointer *values, size_t count,
                            const char *buf);
+void uws_res_write_headers_batch(int ssl, uws_res_t *res,
+                                 const char *const *names,
+                                 const size_t *name_lengths,
+                                 const char *const *values,
+                                 const size_t *value_lengths, size_t count);
+void uws_res_write_status_and_headers(int ssl, uws_res_t *res,
+                                      const char *status, size_t status_length,
+                                      const StringPointer *names,
+                                      const StringPointer *values,
+                                      size_t count, const char *buf);
+
+// The same, without the ssl branch: _ssl for TLS responses and _tcp for the rest
+void uws_res_write_status_ssl(uws_res_t *res, const char *status, size_t length);
+void uws_res_write_header_ssl(uws_res_t *res, const char *key, size_t key_length, const char *value, size_t value_length);
+void uws_res_write_header_int_ssl(uws_res_t *res, const char *key, size_t key_length, uint64_t value);
+void uws_res_write_headers_ssl(uws_res_t *res, const StringPointer *names, const StringPointer *values, size_t count, const char *buf);
+void uws_res_write_headers_batch_ssl(uws_res_t *res, const char *const *names, const size_t *name_lengths, const char *const *values, const size_t *value_lengths, size_t count);
+void uws_res_write_status_and_headers_ssl(uws_res_t *res, const char *status, size_t status_length, const StringPointer *names, const StringPointer *values, size_t count, const char *buf);
+bool uws_res_write_ssl(uws_res_t *res, const char *data, size_t length);
+void uws_res_end_ssl(uws_res_t *res, const char *data, size_t length, bool close_connection);
+bool uws_res_try_end_ssl(uws_res_t *res, const char *bytes, size_t len, size_t total_len, bool close);
+void uws_res_end_without_body_ssl(uws_res_t *res, bool close_connection);
+void uws_res_write_status_tcp(uws_res_t *res, const char *status, size_t length);
+void uws_res_write_header_tcp(uws_res_t *res, const char *key, size_t key_length, const char *value, size_t value_length);
+void uws_res_write_header_int_tcp(uws_res_t *res, const char *key, size_t key_length, uint64_t value);
+void uws_res_write_headers_tcp(uws_res_t *res, const StringPointer *names, const StringPointer *values, size_t count, const char *buf);
+void uws_res_write_headers_batch_tcp(uws_res_t *res, const char *const *names, const size_t *name_lengths, const char *const *values, const size_t *value_lengths, size_t count);
+void uws_res_write_status_and_headers_tcp(uws_res_t *res, const char *status, size_t status_length, const StringPointer *names, const StringPointer *values, size_t count, const char *buf);
+bool uws_res_write_tcp(uws_res_t *res, const char *data, size_t length);
+void uws_res_end_tcp(uws_res_t *res, const char *data, size_t length, bool close_connection);
+bool uws_res_try_end_tcp(uws_res_t *res, const char *bytes, size_t len, size_t total_len, bool close);
+void uws_res_end_without_body_tcp(uws_res_t *res, bool close_connection);
 
 void *uws_res_get_native_handle(int ssl, uws_res_t *res);
 void uws_res_uncork(int ssl, uws_res_t *res);
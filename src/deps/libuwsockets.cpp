@@ -4,9 +4,159 @@
 #include <bun-uws/src/AsyncSocket.h>
 #include <bun-usockets/src/internal/internal.h>
 #include <string_view>
+#include <cstddef>
 
 extern "C" const char* ares_inet_ntop(int af, const char *src, char *dst, size_t size);
 
+/* Batched messages are handed to C as is */
+static_assert(sizeof(uWS::WebSocketMessageBatch::Entry) == sizeof(uws_websocket_batch_entry_t));
+static_assert(offsetof(uWS::WebSocketMessageBatch::Entry, opCode) == offsetof(uws_websocket_batch_entry_t, opcode));
+
+/* The response calls made for every request. The entry points taking an ssl flag branch into
+   these, and their _ssl and _tcp variants are for callers that know which it is at compile time */
+namespace
+{
+  template <bool SSL>
+  inline uWS::HttpResponse<SSL> *httpResponse(uws_res_t *res)
+  {
+    return (uWS::HttpResponse<SSL> *)res;
+  }
+
+  template <bool SSL>
+  inline void resWriteStatus(uws_res_t *res, const char *status, size_t length)
+  {
+    httpResponse<SSL>(res)->writeStatus(std::string_view(status, length));
+  }
+
+  template <bool SSL>
+  inline void resWriteHeader(uws_res_t *res, const char *key, size_t key_length, const char *value, size_t value_length)
+  {
+    httpResponse<SSL>(res)->writeHeader(std::string_view(key, key_length), std::string_view(value, value_length));
+  }
+
+  template <bool SSL>
+  inline void resWriteHeaderInt(uws_res_t *res, const char *key, size_t key_length, uint64_t value)
+  {
+    httpResponse<SSL>(res)->writeHeader(std::string_view(key, key_length), value);
+  }
+
+  template <bool SSL>
+  inline void resWriteHeaders(uws_res_t *res, const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    uWS::HttpResponse<SSL> *uwsRes = httpResponse<SSL>(res);
+    for (size_t i = 0; i < count; i++)
+    {
+      uwsRes->writeHeader(std::string_view(&buf[names[i].off], names[i].len),
+                          std::string_view(&buf[values[i].off], values[i].len));
+    }
+  }
+
+  template <bool SSL>
+  inline void resWriteHeadersBatch(uws_res_t *res, const char *const *names, const size_t *name_lengths,
+                                   const char *const *values, const size_t *value_lengths, size_t count)
+  {
+    uWS::HttpResponse<SSL> *uwsRes = httpResponse<SSL>(res);
+    for (size_t i = 0; i < count; i++)
+    {
+      uwsRes->writeHeader(std::string_view(names[i], name_lengths[i]), std::string_view(values[i], value_lengths[i]));
+    }
+  }
+
+  template <bool SSL>
+  inline void resWriteStatusAndHeaders(uws_res_t *res, const char *status, size_t status_length,
+                                       const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    resWriteStatus<SSL>(res, status, status_length);
+    resWriteHeaders<SSL>(res, names, values, count, buf);
+  }
+
+  template <bool SSL>
+  inline bool resWrite(uws_res_t *res, const char *data, size_t length)
+  {
+    return httpResponse<SSL>(res)->write(std::string_view(data, length));
+  }
+
+  template <bool SSL>
+  inline void resEnd(uws_res_t *res, const char *data, size_t length, bool close_connection)
+  {
+    uWS::HttpResponse<SSL> *uwsRes = httpResponse<SSL>(res);
+    uwsRes->getHttpResponseData()->onWritable = nullptr;
+    uwsRes->onAborted(nullptr);
+    uwsRes->end(std::string_view(data, length), close_connection);
+  }
+
+  template <bool SSL>
+  inline bool resTryEnd(uws_res_t *res, const char *bytes, size_t len, size_t total_len, bool close)
+  {
+    uWS::HttpResponse<SSL> *uwsRes = httpResponse<SSL>(res);
+    auto pair = uwsRes->tryEnd(std::string_view(bytes, len), total_len, close);
+    if (pair.first) {
+      uwsRes->getHttpResponseData()->onWritable = nullptr;
+      uwsRes->onAborted(nullptr);
+    }
+
+    return pair.first;
+  }
+
+  template <bool SSL>
+  inline void resEndWithoutBody(uws_res_t *res, bool close_connection)
+  {
+    uWS::HttpResponse<SSL> *uwsRes = httpResponse<SSL>(res);
+    auto *data = uwsRes->getHttpResponseData();
+    if (close_connection)
+    {
+      if (!(data->state & uWS::HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE))
+      {
+        uwsRes->writeHeader("Connection", "close");
+      }
+      data->state |= uWS::HttpResponseData<SSL>::HTTP_CONNECTION_CLOSE;
+    }
+    if (!(data->state & uWS::HttpResponseData<SSL>::HTTP_END_CALLED))
+    {
+      // Some HTTP clients require the complete "<header>\r\n\r\n" to be sent.
+      // If not, they may throw a ConnectionError.
+      uwsRes->uWS::AsyncSocket<SSL>::write("\r\n", 2);
+    }
+    data->state |= uWS::HttpResponseData<SSL>::HTTP_END_CALLED;
+    data->markDone();
+    us_socket_timeout(SSL, (us_socket_t *)uwsRes, uWS::HTTP_TIMEOUT_S);
+  }
+
+  // The text is formatted on the first call for a connection and kept in its
+  // HttpResponseData, so *dest stays valid as long as the socket does.
+  template <bool SSL>
+  inline uint64_t resRemoteAddressInfo(uws_res_t *res, const char **dest, int *port, bool *is_ipv6)
+  {
+    auto *data = httpResponse<SSL>(res)->getHttpResponseData();
+    if (!data->remoteAddressCached)
+    {
+      // This is manual inlining + modification of
+      //      us_socket_remote_address
+      //      AsyncSocket::getRemoteAddress
+      //      AsyncSocket::addressAsText
+      // To get { ip, port, is_ipv6 } for Bun.serve().requestIP()
+      char b[16];
+      int ipv6 = 0;
+      auto length = us_get_remote_address_info(b, (us_socket_t *)res, dest, &data->remotePort, &ipv6);
+      data->remoteAddressLength = 0;
+      if (length == 4 || length == 16)
+      {
+        data->remoteAddressIsIPv6 = length == 16;
+        if (ares_inet_ntop(length == 4 ? AF_INET : AF_INET6, b, data->remoteAddress, sizeof(data->remoteAddress)))
+          data->remoteAddressLength = (uint8_t)strlen(data->remoteAddress);
+      }
+      data->remoteAddressCached = true;
+    }
+
+    if (!data->remoteAddressLength)
+      return 0;
+    *dest = data->remoteAddress;
+    *port = data->remotePort;
+    *is_ipv6 = data->remoteAddressIsIPv6;
+    return data->remoteAddressLength;
+  }
+}
+
 extern "C"
 {
 
@@ -49,6 +199,27 @@ extern "C"
     }
   }
 
+  void uws_app_static_route(int ssl, uws_app_t *app, const char *pattern, const char **header_names, const size_t *header_name_lengths,
+                            const char **header_values, const size_t *header_value_lengths, size_t header_count, const char *body, size_t body_length)
+  {
+    std::vector<std::pair<std::string, std::string>> headers;
+    for (size_t i = 0; i < header_count; i++)
+    {
+      headers.emplace_back(std::string(header_names[i], header_name_lengths[i]), std::string(header_values[i], header_value_lengths[i]));
+    }
+
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->staticRoute(pattern, std::move(headers), std::string_view(body, body_length));
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->staticRoute(pattern, std::move(headers), std::string_view(body, body_length));
+    }
+  }
+
   void uws_app_post(int ssl, uws_app_t *app, const char *pattern, uws_method_handler handler, void *user_data)
   {
 
@@ -418,6 +589,107 @@ extern "C"
     }
   }
 
+  void uws_app_freeze_routes(int ssl, uws_app_t *app)
+  {
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->freezeRoutes();
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->freezeRoutes();
+    }
+  }
+
+  void uws_app_set_latency_stats_enabled(int ssl, uws_app_t *app, bool enabled)
+  {
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->setLatencyStatsEnabled(enabled);
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->setLatencyStatsEnabled(enabled);
+    }
+  }
+
+  void uws_app_advertise_http3(int ssl, uws_app_t *app, int port, unsigned int max_age)
+  {
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->advertiseHttp3(port, max_age);
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->advertiseHttp3(port, max_age);
+    }
+  }
+
+  void uws_app_drain(int ssl, uws_app_t *app, unsigned int timeout_ms)
+  {
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->drain(timeout_ms);
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->drain(timeout_ms);
+    }
+  }
+
+  void uws_app_listen_fd(int ssl, uws_app_t *app, int fd, uws_listen_handler handler, void *user_data)
+  {
+    if (ssl)
+    {
+      uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
+      uwsApp->listenFd(fd, [handler, user_data](struct us_listen_socket_t *listen_socket)
+                       { handler((struct us_listen_socket_t *)listen_socket, user_data); });
+    }
+    else
+    {
+      uWS::App *uwsApp = (uWS::App *)app;
+      uwsApp->listenFd(fd, [handler, user_data](struct us_listen_socket_t *listen_socket)
+                       { handler((struct us_listen_socket_t *)listen_socket, user_data); });
+    }
+  }
+
+  bool uws_app_get_latency_summary(int ssl, uws_app_t *app, unsigned int stage, uws_latency_summary_t *summary)
+  {
+    uWS::HttpLatencyStats *latencyStats = ssl ? ((uWS::SSLApp *)app)->getLatencyStats() : ((uWS::App *)app)->getLatencyStats();
+    if (!latencyStats || stage >= uWS::HttpLatencyStats::STAGE_COUNT)
+    {
+      return false;
+    }
+
+    uWS::LatencyHistogram &histogram = latencyStats->histograms[stage];
+    summary->count = histogram.count();
+    summary->min = histogram.min();
+    summary->max = histogram.max();
+    summary->mean = histogram.mean();
+    summary->p50 = histogram.percentile(50);
+    summary->p90 = histogram.percentile(90);
+    summary->p99 = histogram.percentile(99);
+    summary->p999 = histogram.percentile(99.9);
+    return true;
+  }
+
+  void uws_app_reset_latency_stats(int ssl, uws_app_t *app)
+  {
+    uWS::HttpLatencyStats *latencyStats = ssl ? ((uWS::SSLApp *)app)->getLatencyStats() : ((uWS::App *)app)->getLatencyStats();
+    if (latencyStats)
+    {
+      latencyStats->reset();
+    }
+  }
+
   void uws_app_destroy(int ssl, uws_app_t *app)
   {
     if (ssl)
@@ -606,6 +878,13 @@ extern "C"
           behavior.message((uws_websocket_t *)ws, message.data(),
                            message.length(), (uws_opcode_t)opcode);
         };
+      if (behavior.messages)
+        generic_handler.messages = [behavior](auto *ws, auto &batch)
+        {
+          behavior.messages((uws_websocket_t *)ws, batch.data.data(),
+                            (const uws_websocket_batch_entry_t *)batch.entries.data(),
+                            batch.size());
+        };
       if (behavior.drain)
         generic_handler.drain = [behavior](auto *ws)
         {
@@ -664,6 +943,13 @@ extern "C"
           behavior.message((uws_websocket_t *)ws, message.data(),
                            message.length(), (uws_opcode_t)opcode);
         };
+      if (behavior.messages)
+        generic_handler.messages = [behavior](auto *ws, auto &batch)
+        {
+          behavior.messages((uws_websocket_t *)ws, batch.data.data(),
+                            (const uws_websocket_batch_entry_t *)batch.entries.data(),
+                            batch.size());
+        };
       if (behavior.drain)
         generic_handler.drain = [behavior](auto *ws)
         {
@@ -963,6 +1249,114 @@ extern "C"
                         (uWS::OpCode)(unsigned char)opcode, compress);
   }
 
+  char *uws_ws_take_message_buffer(int ssl, uws_websocket_t *ws,
+                                   const char *message, size_t length,
+                                   void **ctx)
+  {
+    std::string *buffer;
+    if (ssl)
+    {
+      uWS::WebSocket<true, true, void *> *uws =
+          (uWS::WebSocket<true, true, void *> *)ws;
+      buffer = uws->takeMessageBuffer(std::string_view(message, length));
+    }
+    else
+    {
+      uWS::WebSocket<false, true, void *> *uws =
+          (uWS::WebSocket<false, true, void *> *)ws;
+      buffer = uws->takeMessageBuffer(std::string_view(message, length));
+    }
+
+    *ctx = buffer;
+    return buffer ? buffer->data() : nullptr;
+  }
+
+  void uws_ws_free_message_buffer(void * /*bytes*/, void *ctx)
+  {
+    delete (std::string *)ctx;
+  }
+
+  struct uws_client_deflate_s
+  {
+    uWS::ZlibContext zlibContext;
+    uWS::DeflationStream deflationStream;
+    uWS::InflationStream inflationStream;
+    bool resetDeflation;
+    bool resetInflation;
+    /* Inflation needs writable padding after the input */
+    std::string input;
+
+    uws_client_deflate_s(int compressionWindow, int inflationWindow)
+        : deflationStream(compressionWindow
+                              ? (uWS::CompressOptions)((compressionWindow << 4) | (compressionWindow - 7))
+                              : uWS::CompressOptions::DEDICATED_COMPRESSOR),
+          inflationStream(uWS::CompressOptions::DEDICATED_DECOMPRESSOR),
+          resetDeflation(!compressionWindow), resetInflation(!inflationWindow) {}
+  };
+
+  const char *uws_client_deflate_offer(bool context_takeover, size_t *length)
+  {
+    std::string_view offer = uWS::clientCompressionOffer(context_takeover);
+    *length = offer.length();
+    return offer.data();
+  }
+
+  int uws_client_deflate_negotiate(bool context_takeover, const char *response,
+                                   size_t length, uws_client_deflate_t **out)
+  {
+    auto [valid, compression, compressionWindow, inflationWindow] =
+        uWS::negotiateClientCompression(context_takeover,
+                                        std::string_view(response, length));
+    *out = nullptr;
+    if (!valid)
+    {
+      return -1;
+    }
+    if (!compression)
+    {
+      return 0;
+    }
+    *out = new uws_client_deflate_t(compressionWindow, inflationWindow);
+    return 1;
+  }
+
+  size_t uws_client_deflate_compress(uws_client_deflate_t *deflate,
+                                     const char *data, size_t length,
+                                     const char **out)
+  {
+    std::string_view compressed = deflate->deflationStream.deflate(
+        &deflate->zlibContext, std::string_view(data, length),
+        deflate->resetDeflation);
+    *out = compressed.data();
+    return compressed.length();
+  }
+
+  bool uws_client_deflate_decompress(uws_client_deflate_t *deflate,
+                                     const char *data, size_t length,
+                                     size_t max_payload_length,
+                                     const char **out, size_t *out_length)
+  {
+    deflate->input.assign(data, length);
+    deflate->input.append(9, '\0');
+    std::optional<std::string_view> inflated =
+        deflate->inflationStream.inflate(
+            &deflate->zlibContext,
+            std::string_view(deflate->input.data(), length),
+            max_payload_length, deflate->resetInflation);
+    if (!inflated.has_value())
+    {
+      return false;
+    }
+    *out = inflated->data();
+    *out_length = inflated->length();
+    return true;
+  }
+
+  void uws_client_deflate_destroy(uws_client_deflate_t *deflate)
+  {
+    delete deflate;
+  }
+
   unsigned int uws_ws_get_buffered_amount(int ssl, uws_websocket_t *ws)
   {
     if (ssl)
@@ -1017,20 +1411,40 @@ extern "C"
 
   void uws_res_end(int ssl, uws_res_t *res, const char *data, size_t length,
                    bool close_connection)
+  {
+    if (ssl)
+      resEnd<true>(res, data, length, close_connection);
+    else
+      resEnd<false>(res, data, length, close_connection);
+  }
+
+  bool uws_res_compress(int ssl, uws_res_t *res, const char *accept_encoding, size_t accept_encoding_length, unsigned int allowed)
+  {
+    if (ssl)
+    {
+      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
+      return uwsRes->compress(std::string_view(accept_encoding, accept_encoding_length), allowed);
+    }
+    uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
+    return uwsRes->compress(std::string_view(accept_encoding, accept_encoding_length), allowed);
+  }
+
+  void uws_res_end_cached(int ssl, uws_res_t *res, const char *key, size_t key_length, const char *data, size_t length,
+                          const char *accept_encoding, size_t accept_encoding_length, unsigned int allowed, bool close_connection)
   {
     if (ssl)
     {
       uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
       uwsRes->getHttpResponseData()->onWritable = nullptr;
       uwsRes->onAborted(nullptr);
-      uwsRes->end(std::string_view(data, length), close_connection);
+      uwsRes->endCached(std::string_view(key, key_length), std::string_view(data, length), std::string_view(accept_encoding, accept_encoding_length), allowed, close_connection);
     }
     else
     {
       uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
       uwsRes->getHttpResponseData()->onWritable = nullptr;
       uwsRes->onAborted(nullptr);
-      uwsRes->end(std::string_view(data, length), close_connection);
+      uwsRes->endCached(std::string_view(key, key_length), std::string_view(data, length), std::string_view(accept_encoding, accept_encoding_length), allowed, close_connection);
     }
   }
 
@@ -1098,15 +1512,9 @@ extern "C"
                             size_t length)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      uwsRes->writeStatus(std::string_view(status, length));
-    }
+      resWriteStatus<true>(res, status, length);
     else
-    {
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      uwsRes->writeStatus(std::string_view(status, length));
-    }
+      resWriteStatus<false>(res, status, length);
   }
 
   void uws_res_write_header(int ssl, uws_res_t *res, const char *key,
@@ -1114,89 +1522,32 @@ extern "C"
                             size_t value_length)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      uwsRes->writeHeader(std::string_view(key, key_length),
-                          std::string_view(value, value_length));
-    }
+      resWriteHeader<true>(res, key, key_length, value, value_length);
     else
-    {
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      uwsRes->writeHeader(std::string_view(key, key_length),
-                          std::string_view(value, value_length));
-    }
+      resWriteHeader<false>(res, key, key_length, value, value_length);
   }
   void uws_res_write_header_int(int ssl, uws_res_t *res, const char *key,
                                 size_t key_length, uint64_t value)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      uwsRes->writeHeader(std::string_view(key, key_length), value);
-    }
+      resWriteHeaderInt<true>(res, key, key_length, value);
     else
-    {
-
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      uwsRes->writeHeader(std::string_view(key, key_length), value);
-    }
+      resWriteHeaderInt<false>(res, key, key_length, value);
   }
 
   void uws_res_end_without_body(int ssl, uws_res_t *res, bool close_connection)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      auto *data = uwsRes->getHttpResponseData();
-      if (close_connection)
-      {
-        if (!(data->state & uWS::HttpResponseData<true>::HTTP_CONNECTION_CLOSE))
-        {
-          uwsRes->writeHeader("Connection", "close");
-        }
-        data->state |= uWS::HttpResponseData<true>::HTTP_CONNECTION_CLOSE;
-      }
-      if (!(data->state & uWS::HttpResponseData<true>::HTTP_END_CALLED))
-      {
-        uwsRes->AsyncSocket<true>::write("\r\n", 2);
-      }
-      data->state |= uWS::HttpResponseData<true>::HTTP_END_CALLED;
-      data->markDone();
-      us_socket_timeout(true, (us_socket_t *)uwsRes, uWS::HTTP_TIMEOUT_S);
-    }
+      resEndWithoutBody<true>(res, close_connection);
     else
-    {
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      auto *data = uwsRes->getHttpResponseData();
-      if (close_connection)
-      {
-        if (!(data->state & uWS::HttpResponseData<false>::HTTP_CONNECTION_CLOSE))
-        {
-          uwsRes->writeHeader("Connection", "close");
-        }
-        data->state |= uWS::HttpResponseData<false>::HTTP_CONNECTION_CLOSE;
-      }
-      if (!(data->state & uWS::HttpResponseData<false>::HTTP_END_CALLED))
-      {
-        // Some HTTP clients require the complete "<header>\r\n\r\n" to be sent.
-        // If not, they may throw a ConnectionError.
-        uwsRes->AsyncSocket<false>::write("\r\n", 2);
-      }
-      data->state |= uWS::HttpResponseData<false>::HTTP_END_CALLED;
-      data->markDone();
-      us_socket_timeout(false, (us_socket_t *)uwsRes, uWS::HTTP_TIMEOUT_S);
-    }
+      resEndWithoutBody<false>(res, close_connection);
   }
 
   bool uws_res_write(int ssl, uws_res_t *res, const char *data, size_t length)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      return uwsRes->write(std::string_view(data, length));
-    }
-    uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-    return uwsRes->write(std::string_view(data, length));
+      return resWrite<true>(res, data, length);
+    return resWrite<false>(res, data, length);
   }
   uint64_t uws_res_get_write_offset(int ssl, uws_res_t *res)
   {
@@ -1425,6 +1776,11 @@ extern "C"
       return (struct us_loop_t *)uWS::Loop::get(existing_native_loop);
   }
 
+  size_t uws_backpressure_memory()
+  {
+    return uWS::BackPressurePool::heldBytes();
+  }
+
   void uws_loop_addPostHandler(us_loop_t *loop, void *ctx_,
                                void (*cb)(void *ctx, us_loop_t *loop))
   {
@@ -1461,23 +1817,129 @@ extern "C"
                              const char *buf)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      for (size_t i = 0; i < count; i++)
-      {
-        uwsRes->writeHeader(std::string_view(&buf[names[i].off], names[i].len),
-                            std::string_view(&buf[values[i].off], values[i].len));
-      }
-    }
+      resWriteHeaders<true>(res, names, values, count, buf);
     else
-    {
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      for (size_t i = 0; i < count; i++)
-      {
-        uwsRes->writeHeader(std::string_view(&buf[names[i].off], names[i].len),
-                            std::string_view(&buf[values[i].off], values[i].len));
-      }
-    }
+      resWriteHeaders<false>(res, names, values, count, buf);
+  }
+
+  void uws_res_write_headers_batch(int ssl, uws_res_t *res, const char *const *names, const size_t *name_lengths,
+                                   const char *const *values, const size_t *value_lengths, size_t count)
+  {
+    if (ssl)
+      resWriteHeadersBatch<true>(res, names, name_lengths, values, value_lengths, count);
+    else
+      resWriteHeadersBatch<false>(res, names, name_lengths, values, value_lengths, count);
+  }
+
+  void uws_res_write_status_and_headers(int ssl, uws_res_t *res, const char *status, size_t status_length,
+                                        const StringPointer *names, const StringPointer *values, size_t count,
+                                        const char *buf)
+  {
+    if (ssl)
+      resWriteStatusAndHeaders<true>(res, status, status_length, names, values, count, buf);
+    else
+      resWriteStatusAndHeaders<false>(res, status, status_length, names, values, count, buf);
+  }
+
+  // Without the ssl branch, for callers that know it at compile time
+  void uws_res_write_status_ssl(uws_res_t *res, const char *status, size_t length)
+  {
+    resWriteStatus<true>(res, status, length);
+  }
+
+  void uws_res_write_status_tcp(uws_res_t *res, const char *status, size_t length)
+  {
+    resWriteStatus<false>(res, status, length);
+  }
+
+  void uws_res_write_header_ssl(uws_res_t *res, const char *key, size_t key_length, const char *value, size_t value_length)
+  {
+    resWriteHeader<true>(res, key, key_length, value, value_length);
+  }
+
+  void uws_res_write_header_tcp(uws_res_t *res, const char *key, size_t key_length, const char *value, size_t value_length)
+  {
+    resWriteHeader<false>(res, key, key_length, value, value_length);
+  }
+
+  void uws_res_write_header_int_ssl(uws_res_t *res, const char *key, size_t key_length, uint64_t value)
+  {
+    resWriteHeaderInt<true>(res, key, key_length, value);
+  }
+
+  void uws_res_write_header_int_tcp(uws_res_t *res, const char *key, size_t key_length, uint64_t value)
+  {
+    resWriteHeaderInt<false>(res, key, key_length, value);
+  }
+
+  void uws_res_write_headers_ssl(uws_res_t *res, const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    resWriteHeaders<true>(res, names, values, count, buf);
+  }
+
+  void uws_res_write_headers_tcp(uws_res_t *res, const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    resWriteHeaders<false>(res, names, values, count, buf);
+  }
+
+  void uws_res_write_headers_batch_ssl(uws_res_t *res, const char *const *names, const size_t *name_lengths, const char *const *values, const size_t *value_lengths, size_t count)
+  {
+    resWriteHeadersBatch<true>(res, names, name_lengths, values, value_lengths, count);
+  }
+
+  void uws_res_write_headers_batch_tcp(uws_res_t *res, const char *const *names, const size_t *name_lengths, const char *const *values, const size_t *value_lengths, size_t count)
+  {
+    resWriteHeadersBatch<false>(res, names, name_lengths, values, value_lengths, count);
+  }
+
+  void uws_res_write_status_and_headers_ssl(uws_res_t *res, const char *status, size_t status_length, const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    resWriteStatusAndHeaders<true>(res, status, status_length, names, values, count, buf);
+  }
+
+  void uws_res_write_status_and_headers_tcp(uws_res_t *res, const char *status, size_t status_length, const StringPointer *names, const StringPointer *values, size_t count, const char *buf)
+  {
+    resWriteStatusAndHeaders<false>(res, status, status_length, names, values, count, buf);
+  }
+
+  bool uws_res_write_ssl(uws_res_t *res, const char *data, size_t length)
+  {
+    return resWrite<true>(res, data, length);
+  }
+
+  bool uws_res_write_tcp(uws_res_t *res, const char *data, size_t length)
+  {
+    return resWrite<false>(res, data, length);
+  }
+
+  void uws_res_end_ssl(uws_res_t *res, const char *data, size_t length, bool close_connection)
+  {
+    resEnd<true>(res, data, length, close_connection);
+  }
+
+  void uws_res_end_tcp(uws_res_t *res, const char *data, size_t length, bool close_connection)
+  {
+    resEnd<false>(res, data, length, close_connection);
+  }
+
+  bool uws_res_try_end_ssl(uws_res_t *res, const char *bytes, size_t len, size_t total_len, bool close)
+  {
+    return resTryEnd<true>(res, bytes, len, total_len, close);
+  }
+
+  bool uws_res_try_end_tcp(uws_res_t *res, const char *bytes, size_t len, size_t total_len, bool close)
+  {
+    return resTryEnd<false>(res, bytes, len, total_len, close);
+  }
+
+  void uws_res_end_without_body_ssl(uws_res_t *res, bool close_connection)
+  {
+    resEndWithoutBody<true>(res, close_connection);
+  }
+
+  void uws_res_end_without_body_tcp(uws_res_t *res, bool close_connection)
+  {
+    resEndWithoutBody<false>(res, close_connection);
   }
 
   void uws_res_uncork(int ssl, uws_res_t *res)
@@ -1557,27 +2019,8 @@ extern "C"
                        size_t total_len, bool close)
   {
     if (ssl)
-    {
-      uWS::HttpResponse<true> *uwsRes = (uWS::HttpResponse<true> *)res;
-      auto pair = uwsRes->tryEnd(std::string_view(bytes, len), total_len, close);
-      if (pair.first) {
-        uwsRes->getHttpResponseData()->onWritable = nullptr;
-        uwsRes->onAborted(nullptr);
-      }
-
-      return pair.first;
-    }
-    else
-    {
-      uWS::HttpResponse<false> *uwsRes = (uWS::HttpResponse<false> *)res;
-      auto pair = uwsRes->tryEnd(std::string_view(bytes, len), total_len, close);
-      if (pair.first) {
-        uwsRes->getHttpResponseData()->onWritable = nullptr;
-        uwsRes->onAborted(nullptr);
-      }
-
-      return pair.first;
-    }
+      return resTryEnd<true>(res, bytes, len, total_len, close);
+    return resTryEnd<false>(res, bytes, len, total_len, close);
   }
 
   int uws_res_state(int ssl, uws_res_t *res)
@@ -1615,27 +2058,10 @@ extern "C"
 
   // Gets the remote address and port
   // Returns 0 if failure / unix socket
-  uint64_t uws_res_get_remote_address_info(uws_res_t *res, const char **dest, int *port, bool *is_ipv6)
-  {
-    // This function is manual inlining + modification of
-    //      us_socket_remote_address
-    //      AsyncSocket::getRemoteAddress
-    //      AsyncSocket::addressAsText
-    // To get { ip, port, is_ipv6 } for Bun.serve().requestIP()
-    static thread_local char b[64];
-    auto length = us_get_remote_address_info(b, (us_socket_t *)res, dest, port, (int*)is_ipv6);
-
-    if (length == 0) return 0;
-    if (length == 4) {
-      ares_inet_ntop(AF_INET, b, &b[4], 64 - 4);
-      *dest = &b[4];
-      *is_ipv6 = false;
-      return strlen(*dest);
-    } else {
-      ares_inet_ntop(AF_INET6, b, &b[16], 64 - 16);
-      *dest = &b[16];
-      *is_ipv6 = true;
-      return strlen(*dest);
-    }
+  uint64_t uws_res_get_remote_address_info(int ssl, uws_res_t *res, const char **dest, int *port, bool *is_ipv6)
+  {
+    if (ssl)
+      return resRemoteAddressInfo<true>(res, dest, port, is_ipv6);
+    return resRemoteAddressInfo<false>(res, dest, port, is_ipv6);
   }
 }
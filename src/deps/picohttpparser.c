@@ -33,6 +33,16 @@
 #else
 #include <x86intrin.h>
 #endif
+#define PICOHTTP_SSE42 1
+#define PICOHTTP_SSE42_TARGET
+#define PICOHTTP_HAS_SSE42() 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+/* Built for a baseline x86 target: the SSE 4.2 scanner is still compiled in
+ * and used when the CPU running us has it. */
+#include <nmmintrin.h>
+#define PICOHTTP_SSE42 1
+#define PICOHTTP_SSE42_TARGET __attribute__((target("sse4.2")))
+#define PICOHTTP_HAS_SSE42() likely(__builtin_cpu_supports("sse4.2"))
 #endif
 #include "picohttpparser.h"
 
@@ -102,10 +112,10 @@ static const char *token_char_map = "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\
                                     "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
                                     "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0";
 
-static const char *findchar_fast(const char *buf, const char *buf_end, const char *ranges, size_t ranges_size, int *found)
+#ifdef PICOHTTP_SSE42
+PICOHTTP_SSE42_TARGET
+static const char *findchar_sse42(const char *buf, const char *buf_end, const char *ranges, size_t ranges_size, int *found)
 {
-    *found = 0;
-#if __SSE4_2__
     if (likely(buf_end - buf >= 16)) {
         __m128i ranges16 = _mm_loadu_si128((const __m128i *)ranges);
 
@@ -122,6 +132,16 @@ static const char *findchar_fast(const char *buf, const char *buf_end, const cha
             left -= 16;
         } while (likely(left != 0));
     }
+    return buf;
+}
+#endif
+
+static const char *findchar_fast(const char *buf, const char *buf_end, const char *ranges, size_t ranges_size, int *found)
+{
+    *found = 0;
+#ifdef PICOHTTP_SSE42
+    if (PICOHTTP_HAS_SSE42())
+        return findchar_sse42(buf, buf_end, ranges, ranges_size, found);
 #else
     /* suppress unused parameter warning */
     (void)buf_end;
@@ -135,15 +155,18 @@ static const char *get_token_to_eol(const char *buf, const char *buf_end, const
 {
     const char *token_start = buf;
 
-#ifdef __SSE4_2__
-    static const char ALIGNED(16) ranges1[16] = "\0\010"    /* allow HT */
-                                                "\012\037"  /* allow SP and up to but not including DEL */
-                                                "\177\177"; /* allow chars w. MSB set */
-    int found;
-    buf = findchar_fast(buf, buf_end, ranges1, 6, &found);
-    if (found)
-        goto FOUND_CTL;
-#else
+#ifdef PICOHTTP_SSE42
+    if (PICOHTTP_HAS_SSE42()) {
+        static const char ALIGNED(16) ranges1[16] = "\0\010"    /* allow HT */
+                                                    "\012\037"  /* allow SP and up to but not including DEL */
+                                                    "\177\177"; /* allow chars w. MSB set */
+        int found = 0;
+        buf = findchar_sse42(buf, buf_end, ranges1, 6, &found);
+        if (found)
+            goto FOUND_CTL;
+    }
+#endif
+#ifndef __SSE4_2__
     /* find non-printable char within the next 8 bytes, this is the hottest code; manually inlined */
     while (likely(buf_end - buf >= 8)) {
 #define DOIT()                                                                                                                     \
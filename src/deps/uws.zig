@@ -408,6 +408,28 @@ pub fn NewSocketHandler(comptime is_ssl: bool) type {
             }
         }
 
+        /// Stop reading until `resumeReading`, so the kernel buffers fill up and the peer is slowed down.
+        pub fn pauseReading(this: ThisSocket) void {
+            switch (this.socket) {
+                .done => |socket| us_socket_pause(comptime ssl_int, socket),
+                .connecting => {},
+            }
+        }
+
+        pub fn resumeReading(this: ThisSocket) void {
+            switch (this.socket) {
+                .done => |socket| us_socket_resume(comptime ssl_int, socket),
+                .connecting => {},
+            }
+        }
+
+        pub fn isPaused(this: ThisSocket) bool {
+            return switch (this.socket) {
+                .done => |socket| us_socket_is_paused(comptime ssl_int, socket) > 0,
+                .connecting => false,
+            };
+        }
+
         pub fn shutdownRead(this: ThisSocket) void {
             switch (this.socket) {
                 .done => |socket| {
@@ -1419,9 +1441,20 @@ extern fn us_socket_context_on_handshake(ssl: i32, context: ?*SocketContext, on_
 
 extern fn us_socket_context_on_timeout(ssl: i32, context: ?*SocketContext, on_timeout: *const fn (*Socket) callconv(.C) ?*Socket) void;
 extern fn us_socket_context_on_long_timeout(ssl: i32, context: ?*SocketContext, on_timeout: *const fn (*Socket) callconv(.C) ?*Socket) void;
+pub extern fn us_socket_context_enable_timer_wheel(ssl: i32, context: ?*SocketContext) void;
+pub extern fn us_socket_context_enable_ktls(ssl: i32, context: ?*SocketContext) void;
+pub const us_ssl_session_stats_t = extern struct {
+    hits: c_ulonglong = 0,
+    misses: c_ulonglong = 0,
+};
+pub extern fn us_socket_context_set_session_store(ssl: i32, context: ?*SocketContext, store: ?*const anyopaque) void;
+pub extern fn us_socket_context_set_ticket_key_ring(ssl: i32, context: ?*SocketContext, ring: ?*anyopaque) void;
+pub extern fn us_socket_context_enable_async_handshake(ssl: i32, context: ?*SocketContext) void;
+pub extern fn us_socket_context_session_stats(ssl: i32, context: ?*SocketContext, stats: *us_ssl_session_stats_t) void;
 extern fn us_socket_context_on_connect_error(ssl: i32, context: ?*SocketContext, on_connect_error: *const fn (*ConnectingSocket, i32) callconv(.C) ?*ConnectingSocket) void;
 extern fn us_socket_context_on_socket_connect_error(ssl: i32, context: ?*SocketContext, on_connect_error: *const fn (*Socket, i32) callconv(.C) ?*Socket) void;
 extern fn us_socket_context_on_end(ssl: i32, context: ?*SocketContext, on_end: *const fn (*Socket) callconv(.C) ?*Socket) void;
+pub extern fn us_socket_context_on_batch(ssl: i32, context: ?*SocketContext, on_batch_begin: ?*const fn (*SocketContext) callconv(.C) void, on_batch_end: ?*const fn (*SocketContext) callconv(.C) void) void;
 extern fn us_socket_context_ext(ssl: i32, context: ?*SocketContext) ?*anyopaque;
 
 pub extern fn us_socket_context_listen(ssl: i32, context: ?*SocketContext, host: ?[*:0]const u8, port: i32, options: i32, socket_ext_size: i32) ?*ListenSocket;
@@ -1521,6 +1554,14 @@ pub const Poll = opaque {
 };
 
 extern fn us_socket_get_native_handle(ssl: i32, s: ?*Socket) ?*anyopaque;
+pub extern fn us_socket_is_ktls(ssl: i32, s: ?*Socket) i32;
+/// Mirrors us_iovec_t, one chunk of a us_socket_writev call.
+pub const IOVec = extern struct {
+    data: [*]const u8,
+    length: usize,
+};
+pub extern fn us_socket_writev(ssl: i32, s: ?*Socket, iov: [*]const IOVec, iovcnt: i32) i32;
+pub extern fn us_socket_sendfile(ssl: i32, s: ?*Socket, file_fd: i32, offset: c_longlong, length: i32) i32;
 extern fn us_connecting_socket_get_native_handle(ssl: i32, s: ?*ConnectingSocket) ?*anyopaque;
 
 extern fn us_socket_timeout(ssl: i32, s: ?*Socket, seconds: c_uint) void;
@@ -1532,6 +1573,9 @@ extern fn us_socket_write(ssl: i32, s: ?*Socket, data: [*c]const u8, length: i32
 extern fn us_socket_raw_write(ssl: i32, s: ?*Socket, data: [*c]const u8, length: i32, msg_more: i32) i32;
 extern fn us_socket_shutdown(ssl: i32, s: ?*Socket) void;
 extern fn us_socket_shutdown_read(ssl: i32, s: ?*Socket) void;
+extern fn us_socket_pause(ssl: i32, s: ?*Socket) void;
+extern fn us_socket_resume(ssl: i32, s: ?*Socket) void;
+extern fn us_socket_is_paused(ssl: i32, s: ?*Socket) i32;
 extern fn us_socket_is_shut_down(ssl: i32, s: ?*Socket) i32;
 extern fn us_socket_is_closed(ssl: i32, s: ?*Socket) i32;
 extern fn us_socket_close(ssl: i32, s: ?*Socket, code: CloseCode, reason: ?*anyopaque) ?*Socket;
@@ -1656,6 +1700,16 @@ pub const AnyWebSocket = union(enum) {
             compress,
         );
     }
+    /// Takes the buffer a fragmented message was assembled in instead of copying it.
+    /// Only valid inside onMessage, with the message it was given.
+    pub fn takeMessageBuffer(this: AnyWebSocket, message: []const u8) ?OwnedWebSocketMessage {
+        var ctx: ?*anyopaque = null;
+        const ptr = switch (this) {
+            .ssl => uws_ws_take_message_buffer(1, this.ssl.raw(), message.ptr, message.len, &ctx),
+            .tcp => uws_ws_take_message_buffer(0, this.tcp.raw(), message.ptr, message.len, &ctx),
+        } orelse return null;
+        return .{ .bytes = ptr[0..message.len], .ctx = ctx.? };
+    }
     pub fn getBufferedAmount(this: AnyWebSocket) u32 {
         return switch (this) {
             .ssl => uws_ws_get_buffered_amount(1, this.ssl.raw()),
@@ -1680,6 +1734,14 @@ pub const uws_websocket_upgrade_handler = ?*const fn (*anyopaque, *uws_res, *Req
 
 pub const uws_websocket_ping_pong_handler = ?*const fn (*RawWebSocket, [*c]const u8, usize) callconv(.C) void;
 
+/// One message of a batch, its bytes are `data[offset..][0..length]`
+pub const WebSocketBatchEntry = extern struct {
+    offset: usize,
+    length: usize,
+    opcode: Opcode,
+};
+pub const uws_websocket_messages_handler = ?*const fn (*RawWebSocket, [*c]const u8, [*c]const WebSocketBatchEntry, usize) callconv(.C) void;
+
 pub const WebSocketBehavior = extern struct {
     compression: uws_compress_options_t = 0,
     maxPayloadLength: c_uint = std.math.maxInt(u32),
@@ -1696,6 +1758,8 @@ pub const WebSocketBehavior = extern struct {
     ping: uws_websocket_ping_pong_handler = null,
     pong: uws_websocket_ping_pong_handler = null,
     close: uws_websocket_close_handler = null,
+    /// Replaces `message` with one call per read, for all the messages it completed
+    messages: uws_websocket_messages_handler = null,
 
     pub fn Wrap(
         comptime ServerType: type,
@@ -1723,6 +1787,16 @@ pub const WebSocketBehavior = extern struct {
                     .{ this, ws, if (length > 0) message[0..length] else "", opcode },
                 );
             }
+            pub fn _messages(raw_ws: *RawWebSocket, data: [*c]const u8, entries: [*c]const WebSocketBatchEntry, count: usize) callconv(.C) void {
+                var ws = @unionInit(AnyWebSocket, active_field_name, @as(*WebSocket, @ptrCast(raw_ws)));
+                const this = ws.as(Type).?;
+                const total = if (count > 0) entries[count - 1].offset + entries[count - 1].length else 0;
+                @call(
+                    .always_inline,
+                    Type.onMessages,
+                    .{ this, ws, if (total > 0) data[0..total] else "", if (count > 0) entries[0..count] else &[_]WebSocketBatchEntry{} },
+                );
+            }
             pub fn _drain(raw_ws: *RawWebSocket) callconv(.C) void {
                 var ws = @unionInit(AnyWebSocket, active_field_name, @as(*WebSocket, @ptrCast(raw_ws)));
                 const this = ws.as(Type).?;
@@ -1788,6 +1862,7 @@ pub const WebSocketBehavior = extern struct {
                     .ping = _ping,
                     .pong = _pong,
                     .close = _close,
+                    .messages = if (@hasDecl(Type, "onMessages")) _messages else null,
                 };
             }
         };
@@ -1828,6 +1903,10 @@ pub const Request = opaque {
         var ptr: [*]const u8 = undefined;
         return ptr[0..req.uws_req_get_query(name.ptr, name.len, &ptr)];
     }
+    /// URLSearchParams built from the query index, without handing the raw query to JS for reparsing
+    pub fn searchParams(req: *Request, globalObject: *bun.JSC.JSGlobalObject) bun.JSC.JSValue {
+        return URLSearchParams__createFromUWS(globalObject, req);
+    }
     pub fn parameter(req: *Request, index: u16) []const u8 {
         var ptr: [*]const u8 = undefined;
         return ptr[0..req.uws_req_get_parameter(@as(c_ushort, @intCast(index)), &ptr)];
@@ -1841,6 +1920,7 @@ pub const Request = opaque {
     extern fn uws_req_get_header(res: *Request, lower_case_header: [*]const u8, lower_case_header_length: usize, dest: *[*]const u8) usize;
     extern fn uws_req_get_query(res: *Request, key: [*c]const u8, key_length: usize, dest: *[*]const u8) usize;
     extern fn uws_req_get_parameter(res: *Request, index: c_ushort, dest: *[*]const u8) usize;
+    extern fn URLSearchParams__createFromUWS(globalObject: *bun.JSC.JSGlobalObject, req: *Request) bun.JSC.JSValue;
 };
 
 pub const ListenSocket = opaque {
@@ -1865,6 +1945,7 @@ pub fn NewApp(comptime ssl: bool) type {
     return opaque {
         const ssl_flag = @as(i32, @intFromBool(ssl));
         const ThisApp = @This();
+        const Specialized = SpecializedResponse(ssl);
 
         pub fn close(this: *ThisApp) void {
             if (comptime is_bindgen) {
@@ -1951,6 +2032,17 @@ pub fn NewApp(comptime ssl: bool) type {
             }
             uws_app_get(ssl_flag, @as(*uws_app_t, @ptrCast(app)), pattern, RouteHandler(UserDataType, handler).handle, user_data);
         }
+        pub fn staticRoute(
+            app: *ThisApp,
+            pattern: [:0]const u8,
+            header_names: []const [*]const u8,
+            header_name_lengths: []const usize,
+            header_values: []const [*]const u8,
+            header_value_lengths: []const usize,
+            body: []const u8,
+        ) void {
+            uws_app_static_route(ssl_flag, @as(*uws_app_t, @ptrCast(app)), pattern, header_names.ptr, header_name_lengths.ptr, header_values.ptr, header_value_lengths.ptr, header_names.len, body.ptr, body.len);
+        }
         pub fn post(
             app: *ThisApp,
             pattern: [:0]const u8,
@@ -2062,6 +2154,21 @@ pub fn NewApp(comptime ssl: bool) type {
         pub fn domain(app: *ThisApp, pattern: [:0]const u8) void {
             uws_app_domain(ssl_flag, @as(*uws_app_t, @ptrCast(app)), pattern);
         }
+        pub fn freezeRoutes(app: *ThisApp) void {
+            uws_app_freeze_routes(ssl_flag, @as(*uws_app_t, @ptrCast(app)));
+        }
+        pub fn setLatencyStatsEnabled(app: *ThisApp, enabled: bool) void {
+            uws_app_set_latency_stats_enabled(ssl_flag, @as(*uws_app_t, @ptrCast(app)), enabled);
+        }
+        /// null unless latency stats are enabled
+        pub fn latencySummary(app: *ThisApp, stage: LatencyStage) ?LatencySummary {
+            var summary: LatencySummary = undefined;
+            if (!uws_app_get_latency_summary(ssl_flag, @as(*uws_app_t, @ptrCast(app)), @intFromEnum(stage), &summary)) return null;
+            return summary;
+        }
+        pub fn resetLatencyStats(app: *ThisApp) void {
+            uws_app_reset_latency_stats(ssl_flag, @as(*uws_app_t, @ptrCast(app)));
+        }
         pub fn run(app: *ThisApp) void {
             if (comptime is_bindgen) {
                 unreachable;
@@ -2189,11 +2296,11 @@ pub fn NewApp(comptime ssl: bool) type {
             }
 
             pub fn end(res: *Response, data: []const u8, close_connection: bool) void {
-                uws_res_end(ssl_flag, res.downcast(), data.ptr, data.len, close_connection);
+                Specialized.end(res.downcast(), data.ptr, data.len, close_connection);
             }
 
             pub fn tryEnd(res: *Response, data: []const u8, total: usize, close_: bool) bool {
-                return uws_res_try_end(ssl_flag, res.downcast(), data.ptr, data.len, total, close_);
+                return Specialized.tryEnd(res.downcast(), data.ptr, data.len, total, close_);
             }
 
             pub fn state(res: *const Response) State {
@@ -2220,19 +2327,19 @@ pub fn NewApp(comptime ssl: bool) type {
                 uws_res_write_continue(ssl_flag, res.downcast());
             }
             pub fn writeStatus(res: *Response, status: []const u8) void {
-                uws_res_write_status(ssl_flag, res.downcast(), status.ptr, status.len);
+                Specialized.writeStatus(res.downcast(), status.ptr, status.len);
             }
             pub fn writeHeader(res: *Response, key: []const u8, value: []const u8) void {
-                uws_res_write_header(ssl_flag, res.downcast(), key.ptr, key.len, value.ptr, value.len);
+                Specialized.writeHeader(res.downcast(), key.ptr, key.len, value.ptr, value.len);
             }
             pub fn writeHeaderInt(res: *Response, key: []const u8, value: u64) void {
-                uws_res_write_header_int(ssl_flag, res.downcast(), key.ptr, key.len, value);
+                Specialized.writeHeaderInt(res.downcast(), key.ptr, key.len, value);
             }
             pub fn endWithoutBody(res: *Response, close_connection: bool) void {
-                uws_res_end_without_body(ssl_flag, res.downcast(), close_connection);
+                Specialized.endWithoutBody(res.downcast(), close_connection);
             }
             pub fn write(res: *Response, data: []const u8) bool {
-                return uws_res_write(ssl_flag, res.downcast(), data.ptr, data.len);
+                return Specialized.write(res.downcast(), data.ptr, data.len);
             }
             pub fn getWriteOffset(res: *Response) u64 {
                 return uws_res_get_write_offset(ssl_flag, res.downcast());
@@ -2272,6 +2379,7 @@ pub fn NewApp(comptime ssl: bool) type {
                 // if len is zero it will not fill in the slots so it is ub to
                 // return the struct in that case.
                 address.ip.len = uws_res_get_remote_address_info(
+                    ssl_flag,
                     res.downcast(),
                     &address.ip.ptr,
                     &address.port,
@@ -2463,7 +2571,29 @@ pub fn NewApp(comptime ssl: bool) type {
                 values: []const Api.StringPointer,
                 buf: []const u8,
             ) void {
-                uws_res_write_headers(ssl_flag, res.downcast(), names.ptr, values.ptr, values.len, buf.ptr);
+                Specialized.writeHeaders(res.downcast(), names.ptr, values.ptr, values.len, buf.ptr);
+            }
+
+            /// The status line and every header in one call
+            pub fn writeStatusAndHeaders(
+                res: *Response,
+                status: []const u8,
+                names: []const Api.StringPointer,
+                values: []const Api.StringPointer,
+                buf: []const u8,
+            ) void {
+                Specialized.writeStatusAndHeaders(res.downcast(), status.ptr, status.len, names.ptr, values.ptr, values.len, buf.ptr);
+            }
+
+            pub fn writeHeadersBatch(
+                res: *Response,
+                names: []const [*]const u8,
+                name_lengths: []const usize,
+                values: []const [*]const u8,
+                value_lengths: []const usize,
+            ) void {
+                bun.assert(names.len == name_lengths.len and names.len == values.len and names.len == value_lengths.len);
+                Specialized.writeHeadersBatch(res.downcast(), names.ptr, name_lengths.ptr, values.ptr, value_lengths.ptr, names.len);
             }
 
             pub fn upgrade(
@@ -2571,6 +2701,7 @@ extern fn uws_res_get_remote_address_as_text(ssl: i32, res: *uws_res, dest: *[*]
 extern fn uws_create_app(ssl: i32, options: us_bun_socket_context_options_t) *uws_app_t;
 extern fn uws_app_destroy(ssl: i32, app: *uws_app_t) void;
 extern fn uws_app_get(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handler: uws_method_handler, user_data: ?*anyopaque) void;
+extern fn uws_app_static_route(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, header_names: [*]const [*]const u8, header_name_lengths: [*]const usize, header_values: [*]const [*]const u8, header_value_lengths: [*]const usize, header_count: usize, body: [*]const u8, body_length: usize) void;
 extern fn uws_app_post(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handler: uws_method_handler, user_data: ?*anyopaque) void;
 extern fn uws_app_options(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handler: uws_method_handler, user_data: ?*anyopaque) void;
 extern fn uws_app_delete(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handler: uws_method_handler, user_data: ?*anyopaque) void;
@@ -2582,6 +2713,34 @@ extern fn uws_app_trace(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handle
 extern fn uws_app_any(ssl: i32, app: *uws_app_t, pattern: [*c]const u8, handler: uws_method_handler, user_data: ?*anyopaque) void;
 extern fn uws_app_run(ssl: i32, *uws_app_t) void;
 extern fn uws_app_domain(ssl: i32, app: *uws_app_t, domain: [*c]const u8) void;
+extern fn uws_app_freeze_routes(ssl: i32, app: *uws_app_t) void;
+extern fn uws_app_set_latency_stats_enabled(ssl: i32, app: *uws_app_t, enabled: bool) void;
+extern fn uws_app_get_latency_summary(ssl: i32, app: *uws_app_t, stage: c_uint, summary: *LatencySummary) bool;
+extern fn uws_app_reset_latency_stats(ssl: i32, app: *uws_app_t) void;
+
+/// Stages of uWS::HttpLatencyStats
+pub const LatencyStage = enum(c_uint) {
+    /// first request bytes read until headers parsed
+    parse = 0,
+    /// headers parsed until the matched handler is called
+    route = 1,
+    /// synchronous part of the handler
+    handler = 2,
+    /// first request bytes read until the first response byte is written
+    first_byte = 3,
+};
+
+/// Nanoseconds, mirrors uws_latency_summary_t
+pub const LatencySummary = extern struct {
+    count: u64,
+    min: u64,
+    max: u64,
+    mean: u64,
+    p50: u64,
+    p90: u64,
+    p99: u64,
+    p999: u64,
+};
 extern fn uws_app_listen(ssl: i32, app: *uws_app_t, port: i32, handler: uws_listen_handler, user_data: ?*anyopaque) void;
 extern fn uws_app_listen_with_config(
     ssl: i32,
@@ -2620,9 +2779,77 @@ extern fn uws_ws_iterate_topics(ssl: i32, ws: ?*RawWebSocket, callback: ?*const
 extern fn uws_ws_publish(ssl: i32, ws: ?*RawWebSocket, topic: [*c]const u8, topic_length: usize, message: [*c]const u8, message_length: usize) bool;
 extern fn uws_ws_publish_with_options(ssl: i32, ws: ?*RawWebSocket, topic: [*c]const u8, topic_length: usize, message: [*c]const u8, message_length: usize, opcode: Opcode, compress: bool) bool;
 extern fn uws_ws_get_buffered_amount(ssl: i32, ws: ?*RawWebSocket) c_uint;
+extern fn uws_ws_take_message_buffer(ssl: i32, ws: ?*RawWebSocket, message: [*c]const u8, length: usize, ctx: *?*anyopaque) ?[*]u8;
+extern fn uws_ws_free_message_buffer(bytes: ?*anyopaque, ctx: ?*anyopaque) callconv(.C) void;
+
+/// permessage-deflate for the client role. Offer `offer()` in the upgrade request, then
+/// `negotiate` the Sec-WebSocket-Extensions of the response.
+pub const ClientDeflate = opaque {
+    pub const Negotiation = union(enum) {
+        declined,
+        accepted: *ClientDeflate,
+        /// The connection must fail
+        invalid,
+    };
+
+    pub fn offer(context_takeover: bool) []const u8 {
+        var len: usize = 0;
+        const ptr = uws_client_deflate_offer(context_takeover, &len);
+        return ptr[0..len];
+    }
+
+    pub fn negotiate(context_takeover: bool, response: []const u8) Negotiation {
+        var out: ?*ClientDeflate = null;
+        return switch (uws_client_deflate_negotiate(context_takeover, response.ptr, response.len, &out)) {
+            1 => .{ .accepted = out.? },
+            0 => .declined,
+            else => .invalid,
+        };
+    }
+
+    /// `data` must not be empty, the result is valid until the next call
+    pub fn compress(this: *ClientDeflate, data: []const u8) []const u8 {
+        var out: [*]const u8 = undefined;
+        const len = uws_client_deflate_compress(this, data.ptr, data.len, &out);
+        return out[0..len];
+    }
+
+    /// Null if corrupt or inflating to more than `max_payload_length`, the result is valid until the next call
+    pub fn decompress(this: *ClientDeflate, data: []const u8, max_payload_length: usize) ?[]const u8 {
+        var out: [*]const u8 = undefined;
+        var len: usize = 0;
+        if (!uws_client_deflate_decompress(this, data.ptr, data.len, max_payload_length, &out, &len)) {
+            return null;
+        }
+        return out[0..len];
+    }
+
+    pub fn deinit(this: *ClientDeflate) void {
+        uws_client_deflate_destroy(this);
+    }
+
+    extern fn uws_client_deflate_offer(context_takeover: bool, length: *usize) [*]const u8;
+    extern fn uws_client_deflate_negotiate(context_takeover: bool, response: [*]const u8, length: usize, out: *?*ClientDeflate) c_int;
+    extern fn uws_client_deflate_compress(deflate: *ClientDeflate, data: [*]const u8, length: usize, out: *[*]const u8) usize;
+    extern fn uws_client_deflate_decompress(deflate: *ClientDeflate, data: [*]const u8, length: usize, max_payload_length: usize, out: *[*]const u8, out_length: *usize) bool;
+    extern fn uws_client_deflate_destroy(deflate: *ClientDeflate) void;
+};
+
+/// A received message owned by the caller. `free` has the signature of a typed array
+/// deallocator, so `bytes` can back an ArrayBuffer as is (pass `ctx` as its context).
+pub const OwnedWebSocketMessage = struct {
+    bytes: []u8,
+    ctx: *anyopaque,
+
+    pub const free = uws_ws_free_message_buffer;
+
+    pub fn deinit(this: OwnedWebSocketMessage) void {
+        uws_ws_free_message_buffer(this.bytes.ptr, this.ctx);
+    }
+};
 extern fn uws_ws_get_remote_address(ssl: i32, ws: ?*RawWebSocket, dest: *[*]u8) usize;
 extern fn uws_ws_get_remote_address_as_text(ssl: i32, ws: ?*RawWebSocket, dest: *[*]u8) usize;
-extern fn uws_res_get_remote_address_info(res: *uws_res, dest: *[*]const u8, port: *i32, is_ipv6: *bool) usize;
+extern fn uws_res_get_remote_address_info(ssl: i32, res: *uws_res, dest: *[*]const u8, port: *i32, is_ipv6: *bool) usize;
 
 const uws_res = opaque {};
 extern fn uws_res_uncork(ssl: i32, res: *uws_res) void;
@@ -2669,6 +2896,56 @@ extern fn uws_res_upgrade(
 ) void;
 extern fn uws_res_cork(i32, res: *uws_res, ctx: *anyopaque, corker: *const (fn (?*anyopaque) callconv(.C) void)) void;
 extern fn uws_res_write_headers(i32, res: *uws_res, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_headers_batch(i32, res: *uws_res, names: [*]const [*]const u8, name_lengths: [*]const usize, values: [*]const [*]const u8, value_lengths: [*]const usize, count: usize) void;
+extern fn uws_res_write_status_and_headers(i32, res: *uws_res, status: [*c]const u8, status_length: usize, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_status_ssl(res: *uws_res, status: [*c]const u8, length: usize) void;
+extern fn uws_res_write_header_ssl(res: *uws_res, key: [*c]const u8, key_length: usize, value: [*c]const u8, value_length: usize) void;
+extern fn uws_res_write_header_int_ssl(res: *uws_res, key: [*c]const u8, key_length: usize, value: u64) void;
+extern fn uws_res_write_headers_ssl(res: *uws_res, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_headers_batch_ssl(res: *uws_res, names: [*]const [*]const u8, name_lengths: [*]const usize, values: [*]const [*]const u8, value_lengths: [*]const usize, count: usize) void;
+extern fn uws_res_write_status_and_headers_ssl(res: *uws_res, status: [*c]const u8, status_length: usize, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_ssl(res: *uws_res, data: [*c]const u8, length: usize) bool;
+extern fn uws_res_end_ssl(res: *uws_res, data: [*c]const u8, length: usize, close_connection: bool) void;
+extern fn uws_res_try_end_ssl(res: *uws_res, data: [*c]const u8, length: usize, total: usize, close: bool) bool;
+extern fn uws_res_end_without_body_ssl(res: *uws_res, close_connection: bool) void;
+extern fn uws_res_write_status_tcp(res: *uws_res, status: [*c]const u8, length: usize) void;
+extern fn uws_res_write_header_tcp(res: *uws_res, key: [*c]const u8, key_length: usize, value: [*c]const u8, value_length: usize) void;
+extern fn uws_res_write_header_int_tcp(res: *uws_res, key: [*c]const u8, key_length: usize, value: u64) void;
+extern fn uws_res_write_headers_tcp(res: *uws_res, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_headers_batch_tcp(res: *uws_res, names: [*]const [*]const u8, name_lengths: [*]const usize, values: [*]const [*]const u8, value_lengths: [*]const usize, count: usize) void;
+extern fn uws_res_write_status_and_headers_tcp(res: *uws_res, status: [*c]const u8, status_length: usize, names: [*]const Api.StringPointer, values: [*]const Api.StringPointer, count: usize, buf: [*]const u8) void;
+extern fn uws_res_write_tcp(res: *uws_res, data: [*c]const u8, length: usize) bool;
+extern fn uws_res_end_tcp(res: *uws_res, data: [*c]const u8, length: usize, close_connection: bool) void;
+extern fn uws_res_try_end_tcp(res: *uws_res, data: [*c]const u8, length: usize, total: usize, close: bool) bool;
+extern fn uws_res_end_without_body_tcp(res: *uws_res, close_connection: bool) void;
+
+/// The Response calls made for every request, picked at compile time instead of branching on the ssl flag in C++
+fn SpecializedResponse(comptime ssl: bool) type {
+    return if (ssl) struct {
+        pub const writeStatus = uws_res_write_status_ssl;
+        pub const writeHeader = uws_res_write_header_ssl;
+        pub const writeHeaderInt = uws_res_write_header_int_ssl;
+        pub const writeHeaders = uws_res_write_headers_ssl;
+        pub const writeHeadersBatch = uws_res_write_headers_batch_ssl;
+        pub const writeStatusAndHeaders = uws_res_write_status_and_headers_ssl;
+        pub const write = uws_res_write_ssl;
+        pub const end = uws_res_end_ssl;
+        pub const tryEnd = uws_res_try_end_ssl;
+        pub const endWithoutBody = uws_res_end_without_body_ssl;
+    } else struct {
+        pub const writeStatus = uws_res_write_status_tcp;
+        pub const writeHeader = uws_res_write_header_tcp;
+        pub const writeHeaderInt = uws_res_write_header_int_tcp;
+        pub const writeHeaders = uws_res_write_headers_tcp;
+        pub const writeHeadersBatch = uws_res_write_headers_batch_tcp;
+        pub const writeStatusAndHeaders = uws_res_write_status_and_headers_tcp;
+        pub const write = uws_res_write_tcp;
+        pub const end = uws_res_end_tcp;
+        pub const tryEnd = uws_res_try_end_tcp;
+        pub const endWithoutBody = uws_res_end_without_body_tcp;
+    };
+}
+
 pub const LIBUS_RECV_BUFFER_LENGTH = 524288;
 pub const LIBUS_TIMEOUT_GRANULARITY = @as(i32, 4);
 pub const LIBUS_RECV_BUFFER_PADDING = @as(i32, 32);
@@ -2697,6 +2974,7 @@ pub const DEDICATED_COMPRESSOR_64KB: i32 = 214;
 pub const DEDICATED_COMPRESSOR_128KB: i32 = 231;
 pub const DEDICATED_COMPRESSOR_256KB: i32 = 248;
 pub const DEDICATED_COMPRESSOR: i32 = 248;
+pub const POOLED_COMPRESSOR: i32 = 4096;
 pub const uws_compress_options_t = i32;
 pub const CONTINUATION: i32 = 0;
 pub const TEXT: i32 = 1;
@@ -2958,6 +3236,14 @@ pub const udp = struct {
         pub fn disconnect(this: *This) c_int {
             return us_udp_socket_disconnect(this);
         }
+
+        pub fn setGSO(this: *This, enabled: bool) c_int {
+            return us_udp_socket_set_gso(this, @intFromBool(enabled));
+        }
+
+        pub fn setGRO(this: *This, enabled: bool) c_int {
+            return us_udp_socket_set_gro(this, @intFromBool(enabled));
+        }
     };
 
     extern fn us_create_udp_socket(loop: ?*Loop, data_cb: *const fn (*udp.Socket, *PacketBuffer, c_int) callconv(.C) void, drain_cb: *const fn (*udp.Socket) callconv(.C) void, close_cb: *const fn (*udp.Socket) callconv(.C) void, host: [*c]const u8, port: c_ushort, user_data: ?*anyopaque) ?*udp.Socket;
@@ -2970,6 +3256,8 @@ pub const udp = struct {
     extern fn us_udp_socket_bound_ip(socket: ?*udp.Socket, buf: [*c]u8, length: [*c]i32) void;
     extern fn us_udp_socket_remote_ip(socket: ?*udp.Socket, buf: [*c]u8, length: [*c]i32) void;
     extern fn us_udp_socket_close(socket: ?*udp.Socket) void;
+    extern fn us_udp_socket_set_gso(socket: ?*udp.Socket, enabled: c_int) c_int;
+    extern fn us_udp_socket_set_gro(socket: ?*udp.Socket, enabled: c_int) c_int;
 
     pub const PacketBuffer = opaque {
         const This = @This();
@@ -2983,9 +3271,15 @@ pub const udp = struct {
             const len = us_udp_packet_buffer_payload_length(this, index);
             return payload[0..@as(usize, @intCast(len))];
         }
+
+        /// Datagram size of a packet coalesced by GRO, 0 if the payload is a single datagram.
+        pub fn getSegmentSize(this: *This, index: c_int) c_int {
+            return us_udp_packet_buffer_segment_size(this, index);
+        }
     };
 
     extern fn us_udp_packet_buffer_peer(buf: ?*PacketBuffer, index: c_int) *std.posix.sockaddr.storage;
     extern fn us_udp_packet_buffer_payload(buf: ?*PacketBuffer, index: c_int) [*]u8;
     extern fn us_udp_packet_buffer_payload_length(buf: ?*PacketBuffer, index: c_int) c_int;
+    extern fn us_udp_packet_buffer_segment_size(buf: ?*PacketBuffer, index: c_int) c_int;
 };
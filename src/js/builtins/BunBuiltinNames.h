@@ -121,6 +121,7 @@ using namespace JSC;
     macro(isAbortSignal) \
     macro(isAbsolute) \
     macro(isDisturbed) \
+    macro(isNativeSink) \
     macro(isPaused) \
     macro(isWindows) \
     macro(join) \
@@ -240,6 +241,7 @@ using namespace JSC;
     macro(version) \
     macro(versions) \
     macro(view) \
+    macro(workerPoolFunctions) \
     macro(writable) \
     macro(WritableStream) \
     macro(WritableStreamDefaultController) \
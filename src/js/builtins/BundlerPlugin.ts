@@ -23,6 +23,7 @@ interface BundlerPlugin {
   onResolveAsync(internalID, a, b, c): void;
   addError(internalID, error, number): void;
   addFilter(filter, namespace, number): void;
+  addNativePlugin(path: string): void;
 }
 
 // Extra types
@@ -45,6 +46,8 @@ interface PluginBuilderExt extends PluginBuilder {
   initialOptions: any;
   // we set this to an empty object
   esbuild: any;
+  // loads a shared library implementing bun_native_plugin.h
+  loadNativePlugin(path: string): void;
 }
 
 export function runSetupFunction(this: BundlerPlugin, setup: Setup, config: BuildConfigExt) {
@@ -99,6 +102,15 @@ export function runSetupFunction(this: BundlerPlugin, setup: Setup, config: Buil
     validate(filterObject, callback, onResolvePlugins);
   }
 
+  var anyNative = false;
+  const loadNativePlugin = (path: string) => {
+    if (typeof path !== "string") {
+      throw new TypeError("loadNativePlugin() expects a path to a shared library");
+    }
+    this.addNativePlugin(path);
+    anyNative = true;
+  };
+
   const processSetupResult = () => {
     var anyOnLoad = false,
       anyOnResolve = false;
@@ -151,7 +163,7 @@ export function runSetupFunction(this: BundlerPlugin, setup: Setup, config: Buil
       }
     }
 
-    return anyOnLoad || anyOnResolve;
+    return anyOnLoad || anyOnResolve || anyNative;
   };
 
   var setupResult = setup({
@@ -160,6 +172,7 @@ export function runSetupFunction(this: BundlerPlugin, setup: Setup, config: Buil
     onEnd: notImplementedIssueFn(2771, "On-end callbacks"),
     onLoad,
     onResolve,
+    loadNativePlugin,
     onStart: notImplementedIssueFn(2771, "On-start callbacks"),
     resolve: notImplementedIssueFn(2771, "build.resolve()"),
     module: () => {
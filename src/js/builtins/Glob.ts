@@ -3,11 +3,20 @@ interface Glob {
   $resolveSync(opts);
 }
 
+// $pull resolves to every match at once, or, for a walk that is still going,
+// to a batch: { values, next }, where next() resumes the walk and resolves to
+// the batch after it (undefined once the walk is done). The walk only runs
+// ahead by one batch, so memory stays bounded however many paths there are.
 export function scan(this: Glob, opts) {
   const valuesPromise = this.$pull(opts);
   async function* iter() {
-    const values = (await valuesPromise) || [];
-    yield* values;
+    let batch = await valuesPromise;
+    while (batch && !$isArray(batch)) {
+      const next = batch.next;
+      for (const value of batch.values) yield value;
+      batch = next ? await next() : undefined;
+    }
+    if (batch) yield* batch;
   }
   return iter();
 }
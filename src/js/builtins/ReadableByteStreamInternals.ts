@@ -132,7 +132,7 @@ export function readableByteStreamControllerClose(controller) {
 
   var first = $getByIdDirectPrivate(controller, "pendingPullIntos")?.peek();
   if (first) {
-    if (first.bytesFilled > 0) {
+    if (first.bytesFilled % first.elementSize !== 0) {
       const e = $makeTypeError("Close requested while there remain pending bytes");
       $readableByteStreamControllerError(controller, e);
       throw e;
@@ -210,6 +210,7 @@ export function readableByteStreamControllerPull(controller) {
       byteLength: $getByIdDirectPrivate(controller, "autoAllocateChunkSize"),
       bytesFilled: 0,
       elementSize: 1,
+      minimumFill: 1,
       ctor: Uint8Array,
       readerType: "default",
     };
@@ -404,7 +405,7 @@ export function readableByteStreamControllerRespondInReadableState(controller, b
   $readableByteStreamControllerInvalidateBYOBRequest(controller);
   pullIntoDescriptor.bytesFilled += bytesWritten;
 
-  if (pullIntoDescriptor.bytesFilled < pullIntoDescriptor.elementSize) return;
+  if (pullIntoDescriptor.bytesFilled < pullIntoDescriptor.minimumFill) return;
 
   $readableByteStreamControllerShiftPendingDescriptor(controller);
   const remainderSize = pullIntoDescriptor.bytesFilled % pullIntoDescriptor.elementSize;
@@ -426,7 +427,9 @@ export function readableByteStreamControllerRespondInReadableState(controller, b
 
 export function readableByteStreamControllerRespondInClosedState(controller, firstDescriptor) {
   firstDescriptor.buffer = $transferBufferToCurrentRealm(firstDescriptor.buffer);
-  $assert(firstDescriptor.bytesFilled === 0);
+  // A readAtLeast() may have whole elements filled when the stream closed;
+  // they are handed back with done: true.
+  $assert(firstDescriptor.bytesFilled % firstDescriptor.elementSize === 0);
 
   if ($readableStreamHasBYOBReader($getByIdDirectPrivate(controller, "controlledReadableStream"))) {
     while (
@@ -462,8 +465,6 @@ export function readableByteStreamControllerProcessPullDescriptors(controller) {
 
 // Spec name: readableByteStreamControllerFillPullIntoDescriptorFromQueue (shortened for readability).
 export function readableByteStreamControllerFillDescriptorFromQueue(controller, pullIntoDescriptor) {
-  const currentAlignedBytes =
-    pullIntoDescriptor.bytesFilled - (pullIntoDescriptor.bytesFilled % pullIntoDescriptor.elementSize);
   const maxBytesToCopy =
     $getByIdDirectPrivate(controller, "queue").size < pullIntoDescriptor.byteLength - pullIntoDescriptor.bytesFilled
       ? $getByIdDirectPrivate(controller, "queue").size
@@ -473,7 +474,7 @@ export function readableByteStreamControllerFillDescriptorFromQueue(controller,
   let totalBytesToCopyRemaining = maxBytesToCopy;
   let ready = false;
 
-  if (maxAlignedBytes > currentAlignedBytes) {
+  if (maxAlignedBytes >= pullIntoDescriptor.minimumFill) {
     totalBytesToCopyRemaining = maxAlignedBytes - pullIntoDescriptor.bytesFilled;
     ready = true;
   }
@@ -512,7 +513,7 @@ export function readableByteStreamControllerFillDescriptorFromQueue(controller,
   if (!ready) {
     $assert($getByIdDirectPrivate(controller, "queue").size === 0);
     $assert(pullIntoDescriptor.bytesFilled > 0);
-    $assert(pullIntoDescriptor.bytesFilled < pullIntoDescriptor.elementSize);
+    $assert(pullIntoDescriptor.bytesFilled < pullIntoDescriptor.minimumFill);
   }
 
   return ready;
@@ -538,7 +539,7 @@ export function readableByteStreamControllerCommitDescriptor(stream, pullIntoDes
   $assert($getByIdDirectPrivate(stream, "state") !== $streamErrored);
   let done = false;
   if ($getByIdDirectPrivate(stream, "state") === $streamClosed) {
-    $assert(!pullIntoDescriptor.bytesFilled);
+    $assert(pullIntoDescriptor.bytesFilled % pullIntoDescriptor.elementSize === 0);
     done = true;
   }
   let filledView = $readableByteStreamControllerConvertDescriptor(pullIntoDescriptor);
@@ -566,7 +567,7 @@ export function readableStreamFulfillReadIntoRequest(stream, chunk, done) {
   $fulfillPromise(readIntoRequest, { value: chunk, done: done });
 }
 
-export function readableStreamBYOBReaderRead(reader, view) {
+export function readableStreamBYOBReaderRead(reader, view, min = 1) {
   const stream = $getByIdDirectPrivate(reader, "ownerReadableStream");
   $assert(!!stream);
 
@@ -574,10 +575,10 @@ export function readableStreamBYOBReaderRead(reader, view) {
   if ($getByIdDirectPrivate(stream, "state") === $streamErrored)
     return Promise.$reject($getByIdDirectPrivate(stream, "storedError"));
 
-  return $readableByteStreamControllerPullInto($getByIdDirectPrivate(stream, "readableStreamController"), view);
+  return $readableByteStreamControllerPullInto($getByIdDirectPrivate(stream, "readableStreamController"), view, min);
 }
 
-export function readableByteStreamControllerPullInto(controller, view) {
+export function readableByteStreamControllerPullInto(controller, view, min) {
   const stream = $getByIdDirectPrivate(controller, "controlledReadableStream");
   let elementSize = 1;
   // Spec describes that in the case where view is a TypedArray, elementSize
@@ -606,6 +607,8 @@ export function readableByteStreamControllerPullInto(controller, view) {
     byteLength: view.byteLength,
     bytesFilled: 0,
     elementSize,
+    // Spec name: minimum fill. Only readAtLeast() asks for more than one element.
+    minimumFill: min * elementSize,
     ctor,
     readerType: "byob",
   };
@@ -312,6 +312,20 @@ export function pipeTo(this, destination) {
 
   if ($isWritableStreamLocked(internalDestination)) return Promise.$reject(new TypeError("WritableStream is locked"));
 
+  // Native source into native sink: skip the reader, writer and queue.
+  if (signal === undefined && $isUnreadNativeReadableStream(this)) {
+    const sink = $nativeSinkForPipe(internalDestination);
+    if (sink)
+      return $pipeNativeStreamToNativeSink(
+        this,
+        internalDestination,
+        sink,
+        preventClose,
+        preventAbort,
+        preventCancel,
+      );
+  }
+
   return $readableStreamPipeToWritableStream(
     this,
     internalDestination,
@@ -325,7 +339,16 @@ export function pipeTo(this, destination) {
 export function tee(this) {
   if (!$isReadableStream(this)) throw $makeThisTypeError("ReadableStream", "tee");
 
-  return $readableStreamTee(this, false);
+  const options = arguments[0];
+  // Bun extension: with maxBufferedBytes, a branch that falls that many bytes
+  // behind the other is errored instead of buffering without bound.
+  let maxBufferedBytes;
+  if ($isObject(options) && options.maxBufferedBytes !== undefined) {
+    maxBufferedBytes = $toNumber(options.maxBufferedBytes);
+    if (!(maxBufferedBytes >= 0)) throw new RangeError("maxBufferedBytes must be a non-negative number");
+  }
+
+  return $readableStreamTee(this, false, maxBufferedBytes);
 }
 
 $getter;
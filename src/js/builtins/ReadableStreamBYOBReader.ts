@@ -60,6 +60,32 @@ export function read(this, view: DataView) {
   return $readableStreamBYOBReaderRead(this, view);
 }
 
+// Resolves once at least `min` elements of `view` are filled, copying from
+// as many enqueued chunks as that takes, instead of once per chunk. The
+// result may be shorter only if the stream closes first.
+export function readAtLeast(this, min: number, view: DataView) {
+  if (!$isReadableStreamBYOBReader(this))
+    return Promise.$reject($makeThisTypeError("ReadableStreamBYOBReader", "readAtLeast"));
+
+  if (!$getByIdDirectPrivate(this, "ownerReadableStream"))
+    return Promise.$reject($makeTypeError("readAtLeast() called on a reader owned by no readable stream"));
+
+  if (!$isObject(view)) return Promise.$reject($makeTypeError("Provided view is not an object"));
+
+  if (!ArrayBuffer.$isView(view)) return Promise.$reject($makeTypeError("Provided view is not an ArrayBufferView"));
+
+  if (view.byteLength === 0) return Promise.$reject($makeTypeError("Provided view cannot have a 0 byteLength"));
+
+  if (typeof min !== "number" || !Number.isInteger(min) || min <= 0)
+    return Promise.$reject(new RangeError("min must be a positive integer"));
+
+  const elementSize = view.BYTES_PER_ELEMENT !== undefined ? view.BYTES_PER_ELEMENT : 1;
+  if (min * elementSize > view.byteLength)
+    return Promise.$reject(new RangeError("min cannot be greater than the length of the provided view"));
+
+  return $readableStreamBYOBReaderRead(this, view, min);
+}
+
 export function releaseLock(this) {
   if (!$isReadableStreamBYOBReader(this)) throw $makeThisTypeError("ReadableStreamBYOBReader", "releaseLock");
 
@@ -490,7 +490,7 @@ export function pipeToFinalize(pipeState) {
   else pipeState.promiseCapability.resolve.$call();
 }
 
-export function readableStreamTee(stream, shouldClone) {
+export function readableStreamTee(stream, shouldClone, maxBufferedBytes) {
   $assert($isReadableStream(stream));
   $assert(typeof shouldClone === "boolean");
 
@@ -502,35 +502,51 @@ export function readableStreamTee(stream, shouldClone) {
 
   const reader = new $ReadableStreamDefaultReader(stream);
 
+  // Chunks that one branch has read and the other has not are kept once, in
+  // a list that each branch walks with its own cursor. A node counts the
+  // branches yet to read it and lets go of its chunk once both have.
+  const head = { value: undefined, clone: undefined, next: undefined, pending: 0, size: 0 };
+  const side1 = { cursor: head, pulling: false, canceled: false, reason: undefined, cloned: false, other: undefined };
+  const side2 = { cursor: head, pulling: false, canceled: false, reason: undefined, cloned: shouldClone, other: side1 };
+  side1.other = side2;
+
   const teeState = {
     closedOrErrored: false,
-    canceled1: false,
-    canceled2: false,
-    reason1: undefined,
-    reason2: undefined,
+    done: false,
+    reading: false,
+    tail: head,
+    bufferedBytes: 0,
+    maxBufferedBytes,
+    side1,
+    side2,
+    stream,
   };
 
   teeState.cancelPromiseCapability = $newPromiseCapability(Promise);
 
-  const pullFunction = $readableStreamTeePullFunction(teeState, reader, shouldClone);
-
   const branch1Source = {};
-  $putByIdDirectPrivate(branch1Source, "pull", pullFunction);
-  $putByIdDirectPrivate(branch1Source, "cancel", $readableStreamTeeBranch1CancelFunction(teeState, stream));
+  $putByIdDirectPrivate(branch1Source, "pull", $readableStreamTeePullFunction(teeState, reader, side1, shouldClone));
+  $putByIdDirectPrivate(branch1Source, "cancel", $readableStreamTeeBranchCancelFunction(teeState, side1));
 
   const branch2Source = {};
-  $putByIdDirectPrivate(branch2Source, "pull", pullFunction);
-  $putByIdDirectPrivate(branch2Source, "cancel", $readableStreamTeeBranch2CancelFunction(teeState, stream));
-
-  const branch1 = new $ReadableStream(branch1Source);
-  const branch2 = new $ReadableStream(branch2Source);
+  $putByIdDirectPrivate(branch2Source, "pull", $readableStreamTeePullFunction(teeState, reader, side2, shouldClone));
+  $putByIdDirectPrivate(branch2Source, "cancel", $readableStreamTeeBranchCancelFunction(teeState, side2));
+
+  // A high water mark of 0 leaves the chunks in the shared list until a
+  // branch is read, instead of also queueing them on each branch.
+  const options = {};
+  $putByIdDirectPrivate(options, "highWaterMark", 0);
+  const branch1 = new $ReadableStream(branch1Source, options);
+  const branch2 = new $ReadableStream(branch2Source, options);
+  side1.stream = branch1;
+  side2.stream = branch2;
 
   $getByIdDirectPrivate(reader, "closedPromiseCapability").promise.$then(undefined, function (e) {
     if (teeState.closedOrErrored) return;
     $readableStreamDefaultControllerError(branch1.$readableStreamController, e);
     $readableStreamDefaultControllerError(branch2.$readableStreamController, e);
     teeState.closedOrErrored = true;
-    if (!teeState.canceled1 || !teeState.canceled2) teeState.cancelPromiseCapability.resolve.$call();
+    if (!side1.canceled || !side2.canceled) teeState.cancelPromiseCapability.resolve.$call();
   });
 
   // Additional fields compared to the spec, as they are needed within pull/cancel functions.
@@ -540,53 +556,113 @@ export function readableStreamTee(stream, shouldClone) {
   return [branch1, branch2];
 }
 
-export function readableStreamTeePullFunction(teeState, reader, shouldClone) {
+export function readableStreamTeePullFunction(teeState, reader, side, shouldClone) {
   return function () {
+    if ($readableStreamTeeDeliver(teeState, side)) return;
+    side.pulling = true;
+    if (teeState.reading || teeState.closedOrErrored) return;
+
+    teeState.reading = true;
     Promise.prototype.$then.$call($readableStreamDefaultReaderRead(reader), function (result) {
       $assert($isObject(result));
       $assert(typeof result.done === "boolean");
-      if (result.done && !teeState.closedOrErrored) {
-        if (!teeState.canceled1) $readableStreamDefaultControllerClose(teeState.branch1.$readableStreamController);
-        if (!teeState.canceled2) $readableStreamDefaultControllerClose(teeState.branch2.$readableStreamController);
+      teeState.reading = false;
+      if (teeState.closedOrErrored) return;
+
+      const { side1, side2 } = teeState;
+      if (result.done) {
         teeState.closedOrErrored = true;
-        if (!teeState.canceled1 || !teeState.canceled2) teeState.cancelPromiseCapability.resolve.$call();
+        teeState.done = true;
+        // A branch still behind closes once it has read the rest.
+        if (!side1.canceled && side1.cursor === teeState.tail)
+          $readableStreamDefaultControllerClose(teeState.branch1.$readableStreamController);
+        if (!side2.canceled && side2.cursor === teeState.tail)
+          $readableStreamDefaultControllerClose(teeState.branch2.$readableStreamController);
+        if (!side1.canceled || !side2.canceled) teeState.cancelPromiseCapability.resolve.$call();
+        return;
       }
-      if (teeState.closedOrErrored) return;
-      if (!teeState.canceled1)
-        $readableStreamDefaultControllerEnqueue(teeState.branch1.$readableStreamController, result.value);
-      if (!teeState.canceled2)
-        $readableStreamDefaultControllerEnqueue(
-          teeState.branch2.$readableStreamController,
-          shouldClone ? $structuredCloneForStream(result.value) : result.value,
+
+      const value = result.value;
+      const node = {
+        value,
+        clone: shouldClone && !side2.canceled ? $structuredCloneForStream(value) : undefined,
+        next: undefined,
+        pending: (side1.canceled ? 0 : 1) + (side2.canceled ? 0 : 1),
+        size: 0,
+      };
+      if (teeState.maxBufferedBytes !== undefined) {
+        if (ArrayBuffer.$isView(value)) node.size = value.byteLength;
+        else if (typeof value === "string") node.size = value.length;
+      }
+      teeState.bufferedBytes += node.size;
+      teeState.tail.next = node;
+      teeState.tail = node;
+
+      if (side1.pulling) $readableStreamTeeDeliver(teeState, side1);
+      if (side2.pulling) $readableStreamTeeDeliver(teeState, side2);
+
+      if (teeState.bufferedBytes > teeState.maxBufferedBytes) {
+        const error = new RangeError(
+          "ReadableStream.tee() branch fell more than " + teeState.maxBufferedBytes + " bytes behind",
         );
+        if (!side1.canceled && side1.cursor !== teeState.tail) $readableStreamTeeErrorBranch(teeState, side1, error);
+        if (!side2.canceled && side2.cursor !== teeState.tail) $readableStreamTeeErrorBranch(teeState, side2, error);
+      }
     });
   };
 }
 
-export function readableStreamTeeBranch1CancelFunction(teeState, stream) {
-  return function (r) {
-    teeState.canceled1 = true;
-    teeState.reason1 = r;
-    if (teeState.canceled2) {
-      $readableStreamCancel(stream, [teeState.reason1, teeState.reason2]).$then(
-        teeState.cancelPromiseCapability.$resolve,
-        teeState.cancelPromiseCapability.$reject,
-      );
-    }
-    return teeState.cancelPromiseCapability.promise;
-  };
+// Enqueues the next chunk this branch has not read, if there is one.
+export function readableStreamTeeDeliver(teeState, side) {
+  if (side.canceled) return true;
+  const node = side.cursor.next;
+  if (node === undefined) return false;
+
+  side.cursor = node;
+  side.pulling = false;
+  const value = side.cloned ? node.clone : node.value;
+  $readableStreamTeeRelease(teeState, node);
+
+  const controller = side.stream.$readableStreamController;
+  $readableStreamDefaultControllerEnqueue(controller, value);
+  if (teeState.done && node === teeState.tail) $readableStreamDefaultControllerClose(controller);
+  return true;
 }
 
-export function readableStreamTeeBranch2CancelFunction(teeState, stream) {
+export function readableStreamTeeRelease(teeState, node) {
+  if (--node.pending > 0) return;
+  teeState.bufferedBytes -= node.size;
+  node.value = undefined;
+  node.clone = undefined;
+}
+
+// Gives up the chunks a canceled or errored branch has not read.
+export function readableStreamTeeDetach(teeState, side) {
+  for (let node = side.cursor.next; node !== undefined; node = node.next) $readableStreamTeeRelease(teeState, node);
+  side.cursor = teeState.tail;
+}
+
+export function readableStreamTeeErrorBranch(teeState, side, error) {
+  $readableStreamDefaultControllerError(side.stream.$readableStreamController, error);
+  $readableStreamTeeCancelBranch(teeState, side, error);
+}
+
+export function readableStreamTeeCancelBranch(teeState, side, reason) {
+  if (side.canceled) return;
+  side.canceled = true;
+  side.reason = reason;
+  $readableStreamTeeDetach(teeState, side);
+  if (side.other.canceled) {
+    $readableStreamCancel(teeState.stream, [teeState.side1.reason, teeState.side2.reason]).$then(
+      teeState.cancelPromiseCapability.resolve,
+      teeState.cancelPromiseCapability.reject,
+    );
+  }
+}
+
+export function readableStreamTeeBranchCancelFunction(teeState, side) {
   return function (r) {
-    teeState.canceled2 = true;
-    teeState.reason2 = r;
-    if (teeState.canceled1) {
-      $readableStreamCancel(stream, [teeState.reason1, teeState.reason2]).$then(
-        teeState.cancelPromiseCapability.$resolve,
-        teeState.cancelPromiseCapability.$reject,
-      );
-    }
+    $readableStreamTeeCancelBranch(teeState, side, r);
     return teeState.cancelPromiseCapability.promise;
   };
 }
@@ -688,6 +764,8 @@ export function assignToStream(stream, sink) {
     }
   }
 
+  if ($isUnreadNativeReadableStream(stream)) return $readNativeStreamIntoSink(stream, sink);
+
   return $readStreamIntoSink(stream, sink, true);
 }
 
@@ -788,6 +866,166 @@ export async function readStreamIntoSink(stream, sink, isNative) {
   }
 }
 
+// A stream over a native source that nothing has started reading. Its
+// handle can be pulled directly, without a controller or reader in between.
+export function isUnreadNativeReadableStream(stream) {
+  const handle = stream.$bunNativePtr;
+  return (
+    !!handle &&
+    handle !== -1 &&
+    !stream.$disturbed &&
+    !$isReadableStreamLocked(stream) &&
+    $getByIdDirectPrivate(stream, "state") === $streamReadable &&
+    $getByIdDirectPrivate(stream, "readableStreamController") === null &&
+    !!$getByIdDirectPrivate(stream, "start")
+  );
+}
+
+// Moves every chunk of an unread native stream into a native sink. Chunks go
+// from the handle's pull() straight to the sink's write(), so the loop only
+// awaits when the source has nothing buffered or the sink returns a promise
+// because it is waiting to become writable again.
+export async function pumpNativeStreamIntoSink(stream, sink, pipe) {
+  const handle = stream.$bunNativePtr;
+  $putByIdDirectPrivate(stream, "start", undefined);
+  $putByIdDirectPrivate(stream, "reader", {});
+  stream.$disturbed = true;
+
+  var closer = [false];
+  handle.onClose = () => {
+    pipe.closed = true;
+  };
+  handle.onDrain = chunk => {
+    if (chunk?.byteLength) sink.write(chunk);
+  };
+
+  async function write(chunk) {
+    var wrote;
+    try {
+      wrote = sink.write(chunk);
+      if ($isPromise(wrote)) await wrote;
+    } catch (e) {
+      pipe.sinkFailed = true;
+      throw e;
+    }
+  }
+
+  var chunkSize = handle.start($getByIdDirectPrivate(stream, "highWaterMark"));
+  var buffered;
+  if ($isTypedArrayView(chunkSize)) {
+    // The whole body was already in memory.
+    buffered = chunkSize;
+    chunkSize = 0;
+  } else {
+    buffered = handle.drain();
+  }
+  if (buffered?.byteLength) await write(buffered);
+
+  while (chunkSize && !pipe.closed && !closer[0]) {
+    var view = new Uint8Array(chunkSize);
+    var result = handle.pull(view, closer);
+    if ($isPromise(result)) result = await result;
+
+    if (typeof result === "number") {
+      if (result > 0) await write(result === chunkSize ? view : view.subarray(0, result));
+    } else if ($isTypedArrayView(result)) {
+      if (result.byteLength) await write(result);
+    } else if (result === false) {
+      break;
+    }
+  }
+
+  handle.onClose = undefined;
+  handle.onDrain = undefined;
+  $putByIdDirectPrivate(stream, "state", $streamClosed);
+}
+
+export async function readNativeStreamIntoSink(stream, sink) {
+  const handle = stream.$bunNativePtr;
+  const pipe = { closed: false, sinkFailed: false };
+  $startDirectStream.$call(
+    sink,
+    stream,
+    undefined,
+    reason => {
+      if (pipe.closed) return;
+      pipe.closed = true;
+      handle.cancel(reason);
+    },
+    stream.$asyncContext,
+  );
+  sink.start({ highWaterMark: $getByIdDirectPrivate(stream, "highWaterMark") || 0 });
+
+  try {
+    await $pumpNativeStreamIntoSink(stream, sink, pipe);
+  } catch (e) {
+    pipe.closed = true;
+    try {
+      handle.cancel(e);
+    } catch (j) {}
+    $putByIdDirectPrivate(stream, "state", $streamErrored);
+    $putByIdDirectPrivate(stream, "storedError", e);
+
+    try {
+      sink.close(e);
+    } catch (j) {
+      throw new globalThis.AggregateError([e, j]);
+    }
+    throw e;
+  }
+
+  pipe.closed = true;
+  return sink.end();
+}
+
+// The native sink behind a WritableStream, if the pipe can write to it
+// directly: nothing is queued on the stream and its start() already ran.
+export function nativeSinkForPipe(destination) {
+  const sink = $getByIdDirectPrivate(destination, "underlyingSink");
+  if (!$isNativeSink(sink)) return undefined;
+  if ($getByIdDirectPrivate(destination, "state") !== "writable") return undefined;
+
+  const controller = $getByIdDirectPrivate(destination, "controller");
+  if (!controller || $getByIdDirectPrivate(controller, "started") === -1) return undefined;
+  if (!$getByIdDirectPrivate(controller, "queue").content.isEmpty()) return undefined;
+  if ($writableStreamHasOperationMarkedInFlight(destination)) return undefined;
+
+  return sink;
+}
+
+export async function pipeNativeStreamToNativeSink(source, destination, sink, preventClose, preventAbort, preventCancel) {
+  const handle = source.$bunNativePtr;
+  const pipe = { closed: false, sinkFailed: false };
+  const writer = $acquireWritableStreamDefaultWriter(destination);
+
+  try {
+    await $pumpNativeStreamIntoSink(source, sink, pipe);
+  } catch (e) {
+    pipe.closed = true;
+    $putByIdDirectPrivate(source, "state", $streamErrored);
+    $putByIdDirectPrivate(source, "storedError", e);
+
+    if (pipe.sinkFailed) {
+      if (!preventCancel) {
+        try {
+          handle.cancel(e);
+        } catch (j) {}
+      }
+    } else if (!preventAbort) {
+      await $writableStreamAbort(destination, e);
+    }
+
+    $writableStreamDefaultWriterRelease(writer);
+    throw e;
+  }
+
+  try {
+    if (!preventClose) await $writableStreamDefaultWriterCloseWithErrorPropagation(writer);
+  } finally {
+    $writableStreamDefaultWriterRelease(writer);
+  }
+}
+
 export function handleDirectStreamError(e) {
   var controller = this;
   var sink = controller.$sink;
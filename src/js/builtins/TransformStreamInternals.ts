@@ -176,22 +176,33 @@ export function setUpTransformStreamDefaultController(stream, controller, transf
 
 export function setUpTransformStreamDefaultControllerFromTransformer(stream, transformer, transformerDict) {
   const controller = new TransformStreamDefaultController();
+  // A transform algorithm returns undefined when it finished synchronously,
+  // so that $transformStreamDefaultControllerPerformTransform can skip the
+  // promises it would otherwise wait on for every chunk.
   let transformAlgorithm = chunk => {
     try {
       $transformStreamDefaultControllerEnqueue(controller, chunk);
     } catch (e) {
       return Promise.$reject(e);
     }
-    return Promise.$resolve();
   };
   let flushAlgorithm = () => {
     return Promise.$resolve();
   };
 
-  if ("transform" in transformerDict)
+  if ("transform" in transformerDict) {
+    const transform = transformerDict["transform"];
     transformAlgorithm = chunk => {
-      return $promiseInvokeOrNoopMethod(transformer, transformerDict["transform"], [chunk, controller]);
+      let result;
+      try {
+        result = transform.$call(transformer, chunk, controller);
+      } catch (e) {
+        return Promise.$reject(e);
+      }
+      if (result === undefined) return;
+      return $shieldingPromiseResolve(result);
     };
+  }
 
   if ("flush" in transformerDict) {
     flushAlgorithm = () => {
@@ -236,9 +247,11 @@ export function transformStreamDefaultControllerError(controller, e) {
 }
 
 export function transformStreamDefaultControllerPerformTransform(controller, chunk) {
-  const promiseCapability = $newPromiseCapability(Promise);
-
   const transformPromise = $getByIdDirectPrivate(controller, "transformAlgorithm").$call(undefined, chunk);
+  // Finished synchronously, so there is nothing to react to.
+  if (transformPromise === undefined) return Promise.$resolve();
+
+  const promiseCapability = $newPromiseCapability(Promise);
   transformPromise.$then(
     () => {
       promiseCapability.resolve();
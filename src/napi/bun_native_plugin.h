@@ -0,0 +1,131 @@
+#ifndef BUN_NATIVE_PLUGIN_H_
+#define BUN_NATIVE_PLUGIN_H_
+
+// Native bundler plugins: a shared library that answers onResolve and
+// onLoad for Bun.build() without calling into JavaScript, so its callbacks
+// can run on the bundler's worker threads, several at once.
+//
+// The library exports bun_native_plugin_init(), which returns a description
+// of the plugin that stays valid until the process exits:
+//
+//   static const bun_native_plugin_filter on_load_filters[] = {
+//     { "\\.svg$", "file", "" },
+//   };
+//
+//   BUN_NATIVE_PLUGIN_EXPORT const bun_native_plugin *
+//   bun_native_plugin_init(uint32_t abi_version) {
+//     static const bun_native_plugin plugin = {
+//       BUN_NATIVE_PLUGIN_ABI_VERSION, "svg", NULL,
+//       NULL, 0, NULL,
+//       on_load_filters, 1, svg_on_load,
+//       svg_free,
+//     };
+//     return abi_version == BUN_NATIVE_PLUGIN_ABI_VERSION ? &plugin : NULL;
+//   }
+//
+// and is loaded from a plugin's setup() with build.loadNativePlugin(path).
+// Callbacks must be safe to call from any thread, at the same time.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#define BUN_NATIVE_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define BUN_NATIVE_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define BUN_NATIVE_PLUGIN_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// UTF-8, not NUL-terminated.
+typedef struct bun_native_plugin_string {
+  const char *ptr;
+  size_t len;
+} bun_native_plugin_string;
+
+typedef enum {
+  // Not this plugin's file: the next plugin gets it.
+  BUN_NATIVE_PLUGIN_SKIP = 0,
+  BUN_NATIVE_PLUGIN_HANDLED = 1,
+  // The build reports result->error for this file.
+  BUN_NATIVE_PLUGIN_ERROR = 2,
+} bun_native_plugin_status;
+
+// Which paths a callback is called for, as a RegExp would take them. The
+// namespace is "file" when NULL or empty, and flags may be NULL.
+typedef struct bun_native_plugin_filter {
+  const char *filter;
+  const char *namespace_;
+  const char *flags;
+} bun_native_plugin_filter;
+
+typedef struct bun_native_plugin_resolve_args {
+  bun_native_plugin_string path;
+  bun_native_plugin_string importer;
+  bun_native_plugin_string namespace_;
+  // ImportRecord.Kind, as in the "kind" of a JavaScript onResolve().
+  uint8_t kind;
+} bun_native_plugin_resolve_args;
+
+typedef struct bun_native_plugin_resolve_result {
+  bun_native_plugin_string path;
+  // Empty keeps the namespace of the import.
+  bun_native_plugin_string namespace_;
+  bool external;
+  bun_native_plugin_string error;
+  // Handed back to free_result() once the bundler is done with the strings.
+  void *free_data;
+} bun_native_plugin_resolve_result;
+
+typedef struct bun_native_plugin_load_args {
+  bun_native_plugin_string path;
+  bun_native_plugin_string namespace_;
+} bun_native_plugin_load_args;
+
+typedef struct bun_native_plugin_load_result {
+  bun_native_plugin_string contents;
+  // A loader name like "js" or "css". Empty keeps the one for the path.
+  bun_native_plugin_string loader;
+  bun_native_plugin_string error;
+  void *free_data;
+} bun_native_plugin_load_result;
+
+typedef bun_native_plugin_status (*bun_native_plugin_on_resolve)(
+    void *plugin_data, const bun_native_plugin_resolve_args *args,
+    bun_native_plugin_resolve_result *result);
+typedef bun_native_plugin_status (*bun_native_plugin_on_load)(
+    void *plugin_data, const bun_native_plugin_load_args *args,
+    bun_native_plugin_load_result *result);
+// Called for every result that was HANDLED or ERROR, with its free_data.
+typedef void (*bun_native_plugin_free_result)(void *plugin_data,
+                                              void *free_data);
+
+typedef struct bun_native_plugin {
+  uint32_t abi_version;
+  const char *name;
+  void *data;
+
+  const bun_native_plugin_filter *on_resolve_filters;
+  size_t on_resolve_filter_count;
+  bun_native_plugin_on_resolve on_resolve;
+
+  const bun_native_plugin_filter *on_load_filters;
+  size_t on_load_filter_count;
+  bun_native_plugin_on_load on_load;
+
+  bun_native_plugin_free_result free_result;
+} bun_native_plugin;
+
+typedef const bun_native_plugin *(*bun_native_plugin_init_func)(
+    uint32_t abi_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUN_NATIVE_PLUGIN_H_
@@ -1279,6 +1279,7 @@ extern fn node_api_symbol_for(napi_env, [*]const c_char, usize, *napi_value) nap
 extern fn node_api_throw_syntax_error(napi_env, [*]const c_char, [*]const c_char) napi_status;
 extern fn node_api_create_external_string_latin1(napi_env, [*:0]u8, usize, napi_finalize, ?*anyopaque, *JSValue, *bool) napi_status;
 extern fn node_api_create_external_string_utf16(napi_env, [*:0]u16, usize, napi_finalize, ?*anyopaque, *JSValue, *bool) napi_status;
+extern fn node_api_create_external_string_utf8(napi_env, [*:0]u8, usize, napi_finalize, ?*anyopaque, *JSValue, *bool) napi_status;
 
 pub export fn napi_create_async_work(
     env: napi_env,
@@ -1430,6 +1431,17 @@ pub const ThreadSafeFunction = struct {
 
     callback: Callback = undefined,
 
+    /// Set while a drain is queued on the event loop. Calls made while it is
+    /// set ride along with that drain instead of each posting a task and
+    /// waking the loop.
+    scheduled: std.atomic.Value(bool) = std.atomic.Value(bool).init(false),
+    concurrent_task: JSC.ConcurrentTask = .{},
+    /// finalize() ran while a drain was still queued; the drain finishes it.
+    finalize_pending: bool = false,
+
+    /// Calls delivered per drain before yielding to the rest of the loop.
+    const max_calls_per_drain = 128;
+
     const ThreadSafeFunctionTask = JSC.AnyTask.New(@This(), call);
     pub const Queue = union(enum) {
         sized: Channel(?*anyopaque, .Slice),
@@ -1498,8 +1510,27 @@ pub const ThreadSafeFunction = struct {
         }
     };
 
+    /// Drains the queue, up to max_calls_per_drain calls at a time.
     pub fn call(this: *ThreadSafeFunction) void {
-        const task = this.channel.tryReadItem() catch null orelse return;
+        // Cleared before reading, so an item written from here on either is
+        // read below or schedules the next drain.
+        this.scheduled.store(false, .seq_cst);
+
+        var remaining: usize = max_calls_per_drain;
+        while (remaining > 0) : (remaining -= 1) {
+            const task = this.channel.tryReadItem() catch null orelse break;
+            this.callOne(task);
+        } else {
+            // There may be more; let timers and I/O run before the rest.
+            this.schedule();
+        }
+
+        if (this.finalize_pending and !this.scheduled.load(.seq_cst)) {
+            finalize(this);
+        }
+    }
+
+    fn callOne(this: *ThreadSafeFunction, task: ?*anyopaque) void {
         switch (this.callback) {
             .js => |js_function| {
                 if (js_function.isEmptyOrUndefinedOrNull()) {
@@ -1516,6 +1547,13 @@ pub const ThreadSafeFunction = struct {
         }
     }
 
+    fn schedule(this: *ThreadSafeFunction) void {
+        if (this.scheduled.swap(true, .seq_cst)) {
+            return;
+        }
+        this.event_loop.enqueueTaskConcurrent(this.concurrent_task.from(this, .manual_deinit));
+    }
+
     pub fn enqueue(this: *ThreadSafeFunction, ctx: ?*anyopaque, block: bool) !void {
         if (block) {
             try this.channel.writeItem(ctx);
@@ -1525,11 +1563,18 @@ pub const ThreadSafeFunction = struct {
             }
         }
 
-        this.event_loop.enqueueTaskConcurrent(JSC.ConcurrentTask.createFrom(this));
+        this.schedule();
     }
 
     pub fn finalize(opaq: *anyopaque) void {
         var this = bun.cast(*ThreadSafeFunction, opaq);
+        // The queued drain holds a pointer into this; it finalizes when it
+        // has run.
+        if (this.scheduled.load(.seq_cst)) {
+            this.finalize_pending = true;
+            return;
+        }
+
         if (this.finalizer.fun) |fun| {
             fun(this.event_loop.global, this.finalizer.data, this.ctx);
         }
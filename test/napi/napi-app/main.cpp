@@ -107,6 +107,19 @@ test_napi_get_value_string_utf8_with_buffer(const Napi::CallbackInfo &info) {
   return ok(env);
 }
 
+// What a typical addon method does on entry: read its arguments, then get
+// and set a named property on the first one. Timed by `main.js bench`.
+static napi_value bench_call_overhead(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  napi_value this_arg;
+  napi_get_cb_info(env, info, &argc, argv, &this_arg, nullptr);
+  napi_value value;
+  napi_get_named_property(env, argv[0], "x", &value);
+  napi_set_named_property(env, argv[0], "y", value);
+  return value;
+}
+
 Napi::Value RunCallback(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   Napi::Function cb = info[0].As<Napi::Function>();
@@ -134,6 +147,11 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports1) {
   exports.Set(
       "test_napi_get_value_string_utf8_with_buffer",
       Napi::Function::New(env, test_napi_get_value_string_utf8_with_buffer));
+
+  napi_value bench_fn;
+  napi_create_function(env, "bench_call_overhead", NAPI_AUTO_LENGTH,
+                       bench_call_overhead, nullptr, &bench_fn);
+  exports.Set("bench_call_overhead", Napi::Value(env, bench_fn));
   return exports;
 }
 
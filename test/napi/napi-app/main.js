@@ -7,6 +7,15 @@ if (process.argv[2] === "self") {
   );
   process.exit(0);
 }
+if (process.argv[2] === "bench") {
+  const iterations = Number(process.argv[3] ?? 1e7);
+  const object = { x: 1 };
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) tests.bench_call_overhead(object, i, "arg");
+  const elapsed = Number(process.hrtime.bigint() - start);
+  console.log(`${(elapsed / iterations).toFixed(1)} ns per call`);
+  process.exit(0);
+}
 const fn = tests[process.argv[2]];
 if (typeof fn !== "function") {
   throw new Error("Unknown test:", process.argv[2]);